@@ -21,19 +21,95 @@
 #define AMAZON_KINESIS_STREAM_NAME_FIELD "stream_name"
 #define AMAZON_KINESIS_SECRET_KEY_FIELD "secret_key"
 #define AMAZON_KINESIS_ACCESS_KEY_FIELD "access_key"
+#define AMAZON_KINESIS_REGION_FIELD "region"
+#define AMAZON_KINESIS_FRAGMENT_DURATION_MSEC_FIELD "fragment_duration_msec"
+#define AMAZON_KINESIS_STORAGE_SIZE_MB_FIELD "storage_size_mb"
+#define AMAZON_KINESIS_BUFFER_DURATION_SEC_FIELD "buffer_duration_sec"
+#define AMAZON_KINESIS_MAX_LATENCY_SEC_FIELD "max_latency_sec"
+#define AMAZON_KINESIS_AVG_BANDWIDTH_BPS_FIELD "avg_bandwidth_bps"
 
 namespace fastocloud {
 namespace amazon_kinesis {
 
+namespace {
+
+void read_positive_int(common::HashValue* hash, const char* name, int* out) {
+  int value;
+  common::Value* field = hash->Find(name);
+  if (field && field->GetAsInteger(&value) && value > 0) {
+    *out = value;
+  }
+}
+
+void read_positive_int(json_object* serialized, const char* name, int* out) {
+  json_object* jvalue = nullptr;
+  json_bool jvalue_exists = json_object_object_get_ex(serialized, name, &jvalue);
+  if (jvalue_exists) {
+    int value = json_object_get_int(jvalue);
+    if (value > 0) {
+      *out = value;
+    }
+  }
+}
+
+}  // namespace
+
 AmazonKinesis::AmazonKinesis() : AmazonKinesis(std::string(), std::string(), std::string()) {}
 
 AmazonKinesis::AmazonKinesis(const std::string& stream_name,
                              const std::string& secret_key,
                              const std::string& access_key)
-    : stream_name_(stream_name), secret_key_(secret_key), access_key_(access_key) {}
+    : stream_name_(stream_name),
+      secret_key_(secret_key),
+      access_key_(access_key),
+      region_(),
+      fragment_duration_msec_(0),
+      storage_size_mb_(0),
+      buffer_duration_sec_(0),
+      max_latency_sec_(0),
+      avg_bandwidth_bps_(0) {}
+
+std::string AmazonKinesis::GetStreamName() const {
+  return stream_name_;
+}
+
+std::string AmazonKinesis::GetSecretKey() const {
+  return secret_key_;
+}
+
+std::string AmazonKinesis::GetAccessKey() const {
+  return access_key_;
+}
+
+std::string AmazonKinesis::GetRegion() const {
+  return region_;
+}
+
+int AmazonKinesis::GetFragmentDurationMsec() const {
+  return fragment_duration_msec_;
+}
+
+int AmazonKinesis::GetStorageSizeMb() const {
+  return storage_size_mb_;
+}
+
+int AmazonKinesis::GetBufferDurationSec() const {
+  return buffer_duration_sec_;
+}
+
+int AmazonKinesis::GetMaxLatencySec() const {
+  return max_latency_sec_;
+}
+
+int AmazonKinesis::GetAvgBandwidthBps() const {
+  return avg_bandwidth_bps_;
+}
 
 bool AmazonKinesis::Equals(const AmazonKinesis& aws) const {
-  return aws.stream_name_ == stream_name_ && aws.secret_key_ == secret_key_ && aws.access_key_ == access_key_;
+  return aws.stream_name_ == stream_name_ && aws.secret_key_ == secret_key_ && aws.access_key_ == access_key_ &&
+         aws.region_ == region_ && aws.fragment_duration_msec_ == fragment_duration_msec_ &&
+         aws.storage_size_mb_ == storage_size_mb_ && aws.buffer_duration_sec_ == buffer_duration_sec_ &&
+         aws.max_latency_sec_ == max_latency_sec_ && aws.avg_bandwidth_bps_ == avg_bandwidth_bps_;
 }
 
 common::Optional<AmazonKinesis> AmazonKinesis::MakeAmazonKinesis(common::HashValue* hash) {
@@ -60,6 +136,17 @@ common::Optional<AmazonKinesis> AmazonKinesis::MakeAmazonKinesis(common::HashVal
     res.access_key_ = access_key;
   }
 
+  common::Value* region_field = hash->Find(AMAZON_KINESIS_REGION_FIELD);
+  std::string region;
+  if (region_field && region_field->GetAsBasicString(&region)) {
+    res.region_ = region;
+  }
+
+  read_positive_int(hash, AMAZON_KINESIS_FRAGMENT_DURATION_MSEC_FIELD, &res.fragment_duration_msec_);
+  read_positive_int(hash, AMAZON_KINESIS_STORAGE_SIZE_MB_FIELD, &res.storage_size_mb_);
+  read_positive_int(hash, AMAZON_KINESIS_BUFFER_DURATION_SEC_FIELD, &res.buffer_duration_sec_);
+  read_positive_int(hash, AMAZON_KINESIS_MAX_LATENCY_SEC_FIELD, &res.max_latency_sec_);
+  read_positive_int(hash, AMAZON_KINESIS_AVG_BANDWIDTH_BPS_FIELD, &res.avg_bandwidth_bps_);
   return res;
 }
 
@@ -84,6 +171,18 @@ common::Error AmazonKinesis::DoDeSerialize(json_object* serialized) {
     res.access_key_ = json_object_get_string(jaccess_key);
   }
 
+  json_object* jregion = nullptr;
+  json_bool jregion_exists = json_object_object_get_ex(serialized, AMAZON_KINESIS_REGION_FIELD, &jregion);
+  if (jregion_exists) {
+    res.region_ = json_object_get_string(jregion);
+  }
+
+  read_positive_int(serialized, AMAZON_KINESIS_FRAGMENT_DURATION_MSEC_FIELD, &res.fragment_duration_msec_);
+  read_positive_int(serialized, AMAZON_KINESIS_STORAGE_SIZE_MB_FIELD, &res.storage_size_mb_);
+  read_positive_int(serialized, AMAZON_KINESIS_BUFFER_DURATION_SEC_FIELD, &res.buffer_duration_sec_);
+  read_positive_int(serialized, AMAZON_KINESIS_MAX_LATENCY_SEC_FIELD, &res.max_latency_sec_);
+  read_positive_int(serialized, AMAZON_KINESIS_AVG_BANDWIDTH_BPS_FIELD, &res.avg_bandwidth_bps_);
+
   *this = res;
   return common::Error();
 }
@@ -92,6 +191,13 @@ common::Error AmazonKinesis::SerializeFields(json_object* out) const {
   json_object_object_add(out, AMAZON_KINESIS_STREAM_NAME_FIELD, json_object_new_string(stream_name_.c_str()));
   json_object_object_add(out, AMAZON_KINESIS_SECRET_KEY_FIELD, json_object_new_string(secret_key_.c_str()));
   json_object_object_add(out, AMAZON_KINESIS_ACCESS_KEY_FIELD, json_object_new_string(access_key_.c_str()));
+  json_object_object_add(out, AMAZON_KINESIS_REGION_FIELD, json_object_new_string(region_.c_str()));
+  json_object_object_add(out, AMAZON_KINESIS_FRAGMENT_DURATION_MSEC_FIELD,
+                         json_object_new_int(fragment_duration_msec_));
+  json_object_object_add(out, AMAZON_KINESIS_STORAGE_SIZE_MB_FIELD, json_object_new_int(storage_size_mb_));
+  json_object_object_add(out, AMAZON_KINESIS_BUFFER_DURATION_SEC_FIELD, json_object_new_int(buffer_duration_sec_));
+  json_object_object_add(out, AMAZON_KINESIS_MAX_LATENCY_SEC_FIELD, json_object_new_int(max_latency_sec_));
+  json_object_object_add(out, AMAZON_KINESIS_AVG_BANDWIDTH_BPS_FIELD, json_object_new_int(avg_bandwidth_bps_));
   return common::Error();
 }
 
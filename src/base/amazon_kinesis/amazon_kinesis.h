@@ -22,11 +22,23 @@
 namespace fastocloud {
 namespace amazon_kinesis {
 
+// kvssink settings, zero tunings keep sdk defaults
 class AmazonKinesis : public common::serializer::JsonSerializer<AmazonKinesis> {
  public:
   AmazonKinesis();
   AmazonKinesis(const std::string& stream_name, const std::string& secret_key, const std::string& access_key);
 
+  std::string GetStreamName() const;
+  std::string GetSecretKey() const;
+  std::string GetAccessKey() const;
+  std::string GetRegion() const;
+
+  int GetFragmentDurationMsec() const;  // fragments batched by duration instead of every key frame
+  int GetStorageSizeMb() const;         // in memory retry buffer
+  int GetBufferDurationSec() const;     // media kept while uploads stall
+  int GetMaxLatencySec() const;         // uploads behind more than this are restarted
+  int GetAvgBandwidthBps() const;       // upload pacing, catch up after blips not bursting
+
   bool Equals(const AmazonKinesis& aws) const;
 
   static common::Optional<AmazonKinesis> MakeAmazonKinesis(common::HashValue* hash);
@@ -39,6 +51,13 @@ class AmazonKinesis : public common::serializer::JsonSerializer<AmazonKinesis> {
   std::string stream_name_;
   std::string secret_key_;
   std::string access_key_;
+  std::string region_;
+
+  int fragment_duration_msec_;
+  int storage_size_mb_;
+  int buffer_duration_sec_;
+  int max_latency_sec_;
+  int avg_bandwidth_bps_;
 };
 
 }  // namespace amazon_kinesis
@@ -14,6 +14,10 @@
 
 #include "base/channel_stats.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include <common/time.h>
 
 namespace fastocloud {
@@ -24,6 +28,10 @@ ChannelStats::ChannelStats(fastotv::channel_id_t cid)
     : id_(cid),
       last_update_time_(0),
       total_bytes_(0),
+      total_packets_(0),
+      total_drops_(0),
+      peers_(),
+      peers_count_(0),
       prev_total_bytes_(0),
       bytes_per_second_(0),
       desire_bytes_per_second_() {}
@@ -44,6 +52,35 @@ size_t ChannelStats::GetTotalBytes() const {
   return total_bytes_;
 }
 
+size_t ChannelStats::GetTotalPackets() const {
+  return total_packets_;
+}
+
+void ChannelStats::SetTotalPackets(size_t packets) {
+  total_packets_ = packets;
+}
+
+size_t ChannelStats::GetPeersCount() const {
+  return peers_count_;
+}
+
+PeerStats ChannelStats::GetPeer(size_t index) const {
+  return peers_[index];
+}
+
+void ChannelStats::SetPeers(const PeerStats* peers, size_t count) {
+  peers_count_ = std::min(count, static_cast<size_t>(CHANNEL_STATS_MAX_PEERS));
+  memcpy(peers_, peers, sizeof(PeerStats) * peers_count_);
+}
+
+size_t ChannelStats::GetTotalDrops() const {
+  return total_drops_;
+}
+
+void ChannelStats::SetTotalDrops(size_t drops) {
+  total_drops_ = drops;
+}
+
 size_t ChannelStats::GetPrevTotalBytes() const {
   return prev_total_bytes_;
 }
@@ -18,8 +18,18 @@
 
 #include "base/types.h"
 
+#define CHANNEL_STATS_MAX_PEERS 8
+#define CHANNEL_STATS_PEER_ADDRESS_SIZE 64
+
 namespace fastocloud {
 
+struct PeerStats {  // caller of srt listener output
+  char address[CHANNEL_STATS_PEER_ADDRESS_SIZE];  // host:port, null terminated
+  int64_t rtt_msec;
+  uint64_t retransmits;  // packets
+  uint64_t drops;        // packets dropped by sender, too late to send
+};
+
 class ChannelStats {  // only compile time size fields
  public:
   ChannelStats();
@@ -33,6 +43,16 @@ class ChannelStats {  // only compile time size fields
   size_t GetTotalBytes() const;
   void SetTotalBytes(size_t bytes);
 
+  size_t GetTotalPackets() const;
+  void SetTotalPackets(size_t packets);
+
+  size_t GetTotalDrops() const;  // inputs kernel socket drops of current udp socket, outputs leaky queue drops
+  void SetTotalDrops(size_t drops);
+
+  size_t GetPeersCount() const;  // srt listener outputs, first CHANNEL_STATS_MAX_PEERS callers
+  PeerStats GetPeer(size_t index) const;
+  void SetPeers(const PeerStats* peers, size_t count);
+
   size_t GetPrevTotalBytes() const;
   void SetPrevTotalBytes(size_t bytes);
 
@@ -52,6 +72,10 @@ class ChannelStats {  // only compile time size fields
 
   fastotv::timestamp_t last_update_time_;  // up_time
   size_t total_bytes_;                     // received bytes
+  size_t total_packets_;                   // received buffers
+  size_t total_drops_;                     // dropped by kernel or output queue
+  PeerStats peers_[CHANNEL_STATS_MAX_PEERS];
+  size_t peers_count_;
   size_t prev_total_bytes_;                // checkpoint received bytes
   size_t bytes_per_second_;                // bps
 
@@ -0,0 +1,218 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/chunks_index.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <common/sprintf.h>
+
+#include "base/types.h"
+
+namespace fastocloud {
+
+static_assert(sizeof(ChunkIndexEntry) == 32, "ChunkIndexEntry is on disk record");
+static_assert(sizeof(ChunkRangeEntry) == 40, "ChunkRangeEntry is on disk record");
+
+template <typename Entry>
+IndexReader<Entry>::IndexReader(const common::file_system::ascii_directory_string_path& dir, const std::string& name)
+    : file_(nullptr), count_(0) {
+  auto path = dir.MakeFileStringPath(name);
+  if (!path) {
+    return;
+  }
+
+  file_ = fopen(path->GetPath().c_str(), "rb");
+  if (!file_) {
+    return;
+  }
+
+  if (fseek(file_, 0, SEEK_END) == 0) {
+    long size = ftell(file_);
+    if (size > 0) {
+      count_ = size / sizeof(Entry);  // tail of partially written record ignored
+    }
+  }
+}
+
+template <typename Entry>
+IndexReader<Entry>::~IndexReader() {
+  if (file_) {
+    fclose(file_);
+  }
+}
+
+template <typename Entry>
+size_t IndexReader<Entry>::GetCount() const {
+  return count_;
+}
+
+template <typename Entry>
+bool IndexReader<Entry>::Read(size_t pos, Entry* entry) const {
+  if (pos >= count_) {
+    return false;
+  }
+
+  if (fseek(file_, pos * sizeof(Entry), SEEK_SET) != 0) {
+    return false;
+  }
+  return fread(entry, sizeof(Entry), 1, file_) == 1;
+}
+
+template <typename Entry>
+bool IndexReader<Entry>::FindByTime(time_t utc, Entry* entry) const {
+  return Read(FindPosByTime(utc), entry);
+}
+
+template <typename Entry>
+size_t IndexReader<Entry>::FindPosByTime(time_t utc) const {
+  // entries sorted by time
+  size_t low = 0;
+  size_t high = count_;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    Entry cur;
+    if (!Read(mid, &cur)) {
+      return count_;
+    }
+
+    if (GetChunkEndMsec(cur) <= static_cast<int64_t>(utc) * 1000) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low;
+}
+
+template <typename Entry>
+bool IndexReader<Entry>::FindByIndex(uint64_t index, Entry* entry) const {
+  // indexes grow with time
+  size_t low = 0;
+  size_t high = count_;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (!Read(mid, entry)) {
+      return false;
+    }
+
+    if (entry->index < index) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return Read(low, entry) && entry->index == index;
+}
+
+template class IndexReader<ChunkIndexEntry>;
+template class IndexReader<ChunkRangeEntry>;
+
+ChunksIndexReader::ChunksIndexReader(const common::file_system::ascii_directory_string_path& dir)
+    : IndexReader<ChunkIndexEntry>(dir, CHUNKS_INDEX_NAME) {}
+
+ChunkRangesReader::ChunkRangesReader(const common::file_system::ascii_directory_string_path& dir)
+    : IndexReader<ChunkRangeEntry>(dir, CHUNK_RANGES_INDEX_NAME) {}
+
+std::string MakeChunkHourFileName(time_t utc) {
+  return common::MemSPrintf("h%lld" CHUNK_EXT, static_cast<long long>(utc - utc % CHUNK_HOUR_FILE_DURATION));
+}
+
+bool ReadChunkRange(const common::file_system::ascii_directory_string_path& dir, uint64_t index, std::string* out) {
+  if (!out) {
+    return false;
+  }
+
+  ChunkRangeEntry entry;
+  const ChunkRangesReader reader(dir);
+  if (!reader.FindByIndex(index, &entry)) {
+    return false;
+  }
+
+  auto path = dir.MakeFileStringPath(MakeChunkHourFileName(entry.start_msec / 1000));
+  if (!path) {
+    return false;
+  }
+
+  FILE* file = fopen(path->GetPath().c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  std::string data(entry.size, 0);
+  bool res = fseeko(file, entry.offset, SEEK_SET) == 0 && fread(&data[0], 1, data.size(), file) == data.size();
+  fclose(file);
+  if (res) {
+    *out = std::move(data);
+  }
+  return res;
+}
+
+namespace {
+template <typename Entry>
+bool make_playlist(const IndexReader<Entry>& reader, time_t utc, time_t delay, size_t length, std::string* out) {
+  const size_t end = reader.FindPosByTime(utc - delay);  // chunks before it closed by then
+  if (end == 0) {
+    return false;
+  }
+
+  const size_t begin = end > length ? end - length : 0;
+  std::string segments;
+  int64_t target_duration_msec = 1000;
+  uint64_t media_sequence = 0;
+  for (size_t i = begin; i < end; ++i) {
+    Entry entry;
+    if (!reader.Read(i, &entry)) {
+      return false;
+    }
+
+    if (i == begin) {
+      media_sequence = entry.index;
+    }
+    target_duration_msec = std::max(target_duration_msec, entry.duration_msec);
+    segments += common::MemSPrintf("#EXTINF:%lld.%03lld,\n%llu" CHUNK_EXT "\n", entry.duration_msec / 1000,
+                                   entry.duration_msec % 1000, entry.index);
+  }
+
+  const int64_t target_duration = (target_duration_msec + 999) / 1000;  // not less than any extinf
+  *out = common::MemSPrintf("#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:%lld\n#EXT-X-MEDIA-SEQUENCE:%llu\n",
+                            target_duration, media_sequence) +
+         segments;
+  return true;
+}
+}  // namespace
+
+bool MakeTimeshiftPlaylist(const common::file_system::ascii_directory_string_path& dir,
+                           time_t utc,
+                           time_t delay,
+                           size_t length,
+                           std::string* out) {
+  if (!out || length == 0) {
+    return false;
+  }
+
+  const ChunksIndexReader reader(dir);
+  if (reader.GetCount() != 0) {
+    return make_playlist(reader, utc, delay, length, out);
+  }
+
+  // hour files, chunks served by index as byte ranges
+  const ChunkRangesReader ranges(dir);
+  return make_playlist(ranges, utc, delay, length, out);
+}
+
+}  // namespace fastocloud
@@ -0,0 +1,102 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <string>
+
+#include <common/file_system/path.h>
+#include <common/macros.h>
+
+#define CHUNKS_INDEX_NAME "chunks2.idx"  // chunks.idx of older versions kept times in sec
+#define CHUNK_RANGES_INDEX_NAME "ranges.idx"  // chunks appended into hour files
+#define CHUNK_HOUR_FILE_DURATION 3600
+#define TIMESHIFT_DELAY_QUERY "delay"  // seconds behind recording
+#define TIMESHIFT_PLAYLIST_LENGTH 6
+
+namespace fastocloud {
+
+// record of append only chunks catalog, written by recorder when chunk closed
+// times from pts of first buffers of fragments, wall clock only if there are no timestamps
+struct ChunkIndexEntry {
+  uint64_t index;
+  int64_t start_msec;     // utc
+  int64_t duration_msec;  // next fragment start minus start
+  uint64_t size;          // bytes
+};
+
+// record of hour files catalog, chunk is byte range of hour file named by start of hour
+struct ChunkRangeEntry {
+  uint64_t index;
+  int64_t start_msec;     // utc
+  int64_t duration_msec;  // next fragment start minus start
+  uint64_t size;          // bytes
+  uint64_t offset;        // bytes in hour file
+};
+
+template <typename Entry>
+int64_t GetChunkEndMsec(const Entry& entry) {
+  return entry.start_msec + entry.duration_msec;
+}
+
+template <typename Entry>
+class IndexReader {
+ public:
+  IndexReader(const common::file_system::ascii_directory_string_path& dir, const std::string& name);
+  ~IndexReader();
+
+  size_t GetCount() const;
+
+  bool Read(size_t pos, Entry* entry) const;
+  bool FindByTime(time_t utc, Entry* entry) const;  // first entry which ends after utc
+  size_t FindPosByTime(time_t utc) const;           // position of it, count if all end before
+  bool FindByIndex(uint64_t index, Entry* entry) const;
+
+ private:
+  FILE* file_;
+  size_t count_;
+
+  DISALLOW_COPY_AND_ASSIGN(IndexReader);
+};
+
+class ChunksIndexReader : public IndexReader<ChunkIndexEntry> {
+ public:
+  explicit ChunksIndexReader(const common::file_system::ascii_directory_string_path& dir);
+};
+
+class ChunkRangesReader : public IndexReader<ChunkRangeEntry> {
+ public:
+  explicit ChunkRangesReader(const common::file_system::ascii_directory_string_path& dir);
+};
+
+std::string MakeChunkHourFileName(time_t utc);  // h<start of hour>.ts
+
+// chunk bytes cut from hour file, false if index not in ranges catalog
+bool ReadChunkRange(const common::file_system::ascii_directory_string_path& dir,
+                    uint64_t index,
+                    std::string* out) WARN_UNUSED_RESULT;
+
+// hls playlist of last closed chunks recorded before utc - delay, chunks named by index next to playlist,
+// hour files catalog used if there is no chunks index, false if nothing recorded by then
+bool MakeTimeshiftPlaylist(const common::file_system::ascii_directory_string_path& dir,
+                           time_t utc,
+                           time_t delay,
+                           size_t length,
+                           std::string* out) WARN_UNUSED_RESULT;
+
+}  // namespace fastocloud
@@ -0,0 +1,165 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/cmaf_manifest.h"
+
+#include <math.h>
+#include <time.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <common/sprintf.h>
+
+namespace fastocloud {
+
+namespace {
+
+std::string msec_to_sec_string(fastotv::timestamp_t msec) {
+  return common::MemSPrintf("%.3f", msec / 1000.0);
+}
+
+std::string msec_to_iso8601_duration(fastotv::timestamp_t msec) {
+  return "PT" + msec_to_sec_string(msec) + "S";
+}
+
+std::string msec_to_iso8601_time(fastotv::timestamp_t msec) {
+  const time_t sec = msec / 1000;
+  struct tm info;
+  gmtime_r(&sec, &info);
+  char buff[32];
+  strftime(buff, sizeof(buff), "%Y-%m-%dT%H:%M:%S", &info);
+  return common::MemSPrintf("%s.%03lluZ", buff, static_cast<unsigned long long>(msec % 1000));
+}
+
+bool is_video_codecs(const std::string& codecs) {
+  return codecs.find("avc") != std::string::npos || codecs.find("hvc") != std::string::npos ||
+         codecs.find("hev") != std::string::npos;
+}
+
+}  // namespace
+
+CmafManifest::CmafManifest(const std::string& prefix, size_t playlist_length)
+    : prefix_(prefix),
+      playlist_length_(std::max<size_t>(playlist_length, 1)),
+      max_files_(playlist_length_ * 2),
+      codecs_(),
+      next_number_(0),
+      next_start_msec_(0),
+      bandwidth_(0),
+      segments_() {}
+
+void CmafManifest::SetCodecs(const std::string& codecs) {
+  codecs_ = codecs;
+}
+
+std::string CmafManifest::GetInitName() const {
+  return prefix_ + CMAF_INIT_NAME;
+}
+
+std::string CmafManifest::GetSegmentName(uint64_t number) const {
+  return prefix_ + common::MemSPrintf(CMAF_SEGMENT_TEMPLATE, static_cast<unsigned long long>(number));
+}
+
+uint64_t CmafManifest::GetNextNumber() const {
+  return next_number_;
+}
+
+std::vector<std::string> CmafManifest::AddSegment(fastotv::timestamp_t duration_msec, size_t size) {
+  segments_.push_back({next_number_, next_start_msec_, duration_msec});
+  next_number_++;
+  next_start_msec_ += duration_msec;
+  if (duration_msec) {
+    bandwidth_ = std::max<uint64_t>(bandwidth_, size * 8 * 1000 / duration_msec);
+  }
+
+  std::vector<std::string> expired;
+  while (segments_.size() > max_files_) {
+    expired.push_back(GetSegmentName(segments_.front().number));
+    segments_.pop_front();
+  }
+  return expired;
+}
+
+std::deque<CmafManifest::Segment> CmafManifest::GetListed() const {
+  if (segments_.size() <= playlist_length_) {
+    return segments_;
+  }
+  return std::deque<Segment>(segments_.end() - playlist_length_, segments_.end());
+}
+
+fastotv::timestamp_t CmafManifest::GetMaxDuration() const {
+  fastotv::timestamp_t max_duration_msec = 0;
+  for (const Segment& segment : GetListed()) {
+    max_duration_msec = std::max(max_duration_msec, segment.duration_msec);
+  }
+  return max_duration_msec;
+}
+
+std::string CmafManifest::RenderHls() const {
+  const std::deque<Segment> listed = GetListed();
+  const long target_duration = std::max<long>(1, static_cast<long>(ceil(GetMaxDuration() / 1000.0)));
+
+  std::stringstream out;
+  out << "#EXTM3U\n";
+  out << "#EXT-X-VERSION:" << CMAF_HLS_VERSION << "\n";
+  out << "#EXT-X-TARGETDURATION:" << target_duration << "\n";
+  out << "#EXT-X-MEDIA-SEQUENCE:" << (listed.empty() ? next_number_ : listed.front().number) << "\n";
+  out << "#EXT-X-INDEPENDENT-SEGMENTS\n";
+  out << "#EXT-X-MAP:URI=\"" << GetInitName() << "\"\n";
+  for (const Segment& segment : listed) {
+    out << "#EXTINF:" << msec_to_sec_string(segment.duration_msec) << ",\n";
+    out << GetSegmentName(segment.number) << "\n";
+  }
+  return out.str();
+}
+
+std::string CmafManifest::RenderDash(fastotv::timestamp_t availability_start_msec,
+                                     fastotv::timestamp_t publish_msec) const {
+  const std::deque<Segment> listed = GetListed();
+  const fastotv::timestamp_t max_duration = std::max<fastotv::timestamp_t>(GetMaxDuration(), 1000);
+  fastotv::timestamp_t depth = 0;
+  for (const Segment& segment : listed) {
+    depth += segment.duration_msec;
+  }
+
+  std::stringstream out;
+  out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  out << "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" profiles=\"urn:mpeg:dash:profile:isoff-live:2011\""
+      << " type=\"dynamic\" availabilityStartTime=\"" << msec_to_iso8601_time(availability_start_msec) << "\""
+      << " publishTime=\"" << msec_to_iso8601_time(publish_msec) << "\""
+      << " minimumUpdatePeriod=\"" << msec_to_iso8601_duration(max_duration) << "\""
+      << " minBufferTime=\"" << msec_to_iso8601_duration(max_duration) << "\""
+      << " suggestedPresentationDelay=\"" << msec_to_iso8601_duration(max_duration * 3) << "\""
+      << " timeShiftBufferDepth=\"" << msec_to_iso8601_duration(depth) << "\">\n";
+  out << "  <Period id=\"0\" start=\"PT0S\">\n";
+  out << "    <AdaptationSet segmentAlignment=\"true\" mimeType=\""
+      << (is_video_codecs(codecs_) ? "video/mp4" : "audio/mp4") << "\">\n";
+  out << "      <Representation id=\"0\" codecs=\"" << codecs_ << "\" bandwidth=\"" << bandwidth_ << "\">\n";
+  out << "        <SegmentTemplate timescale=\"1000\" initialization=\"" << GetInitName() << "\" media=\"" << prefix_
+      << "$Number%05d$.m4s\" startNumber=\"" << (listed.empty() ? next_number_ : listed.front().number) << "\">\n";
+  out << "          <SegmentTimeline>\n";
+  for (const Segment& segment : listed) {
+    out << "            <S t=\"" << segment.start_msec << "\" d=\"" << segment.duration_msec << "\"/>\n";
+  }
+  out << "          </SegmentTimeline>\n";
+  out << "        </SegmentTemplate>\n";
+  out << "      </Representation>\n";
+  out << "    </AdaptationSet>\n";
+  out << "  </Period>\n";
+  out << "</MPD>\n";
+  return out.str();
+}
+
+}  // namespace fastocloud
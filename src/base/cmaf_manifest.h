@@ -0,0 +1,70 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <fastotv/types.h>
+
+#define CMAF_HLS_VERSION 7
+#define CMAF_SEGMENT_MSEC 4000
+#define CMAF_PLAYLIST_LENGTH 5
+#define CMAF_INIT_NAME "init.mp4"
+#define CMAF_SEGMENT_TEMPLATE "%05llu.m4s"
+#define DASH_MANIFEST_EXTENSION "mpd"
+
+namespace fastocloud {
+
+// one set of fmp4 segments referenced by both hls media playlist and dynamic dash mpd
+class CmafManifest {
+ public:
+  CmafManifest(const std::string& prefix, size_t playlist_length);
+
+  void SetCodecs(const std::string& codecs);  // rfc 6381 of init segment
+
+  std::string GetInitName() const;
+  std::string GetSegmentName(uint64_t number) const;
+  uint64_t GetNextNumber() const;
+
+  // returns segments out of both manifests and no longer kept on disk
+  std::vector<std::string> AddSegment(fastotv::timestamp_t duration_msec, size_t size);
+
+  std::string RenderHls() const;
+  // availability start is utc time of first segment begin
+  std::string RenderDash(fastotv::timestamp_t availability_start_msec, fastotv::timestamp_t publish_msec) const;
+
+ private:
+  struct Segment {
+    uint64_t number;
+    fastotv::timestamp_t start_msec;  // since availability start
+    fastotv::timestamp_t duration_msec;
+  };
+
+  std::deque<Segment> GetListed() const;
+  fastotv::timestamp_t GetMaxDuration() const;
+
+  const std::string prefix_;
+  const size_t playlist_length_;
+  const size_t max_files_;  // late clients still get segments just out of playlist
+  std::string codecs_;
+  uint64_t next_number_;
+  fastotv::timestamp_t next_start_msec_;
+  uint64_t bandwidth_;  // max bits per sec
+  std::deque<Segment> segments_;
+};
+
+}  // namespace fastocloud
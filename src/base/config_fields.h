@@ -19,10 +19,48 @@
 #define ID_FIELD "id"      // required
 #define TYPE_FIELD "type"  // required
 #define STREAM_LINK_PATH "stream_link_path"
+#define PIPE_BINARY_FIELD "pipe_binary"  // set by daemon, binary framing of parent-child pipe
+#define START_SLOTS_FIELD "start_slots"          // set by daemon, pipelines built at once on node
+#define START_SLOTS_DIR_FIELD "start_slots_dir"  // set by daemon, lock files of start slots
+#define ASSETS_DIR_FIELD "assets_dir"            // set by daemon, logo pictures shared by streams of node
+#define INGEST_DIR_FIELD "ingest_dir"            // set by daemon, sockets of inputs shared by streams of node
+#define OUTPUT_TRASH_DIR_FIELD "output_trash_dir"  // set by daemon, old vod outputs renamed into it, removed by daemon
+#define ACTIVE_VIDEO_CODEC_FIELD "active_video_codec"  // set by daemon, video_codec or cpu fallback
+#define ACTIVE_GPU_DEVICE_FIELD "active_gpu_device"    // set by daemon, cuda device index, -1 default device
+#define ACTIVE_CPU_SET_FIELD "active_cpu_set"          // set by daemon, logical cpus of encoding stream
+#define ACTIVE_REQUEST_TS_FIELD "active_request_ts"    // set by daemon, utc msec of start request
+#define ACTIVE_FORK_TS_FIELD "active_fork_ts"          // set by daemon, utc msec of stream spawn
+#define ACTIVE_HW_DECODE_FIELD "active_hw_decode"      // set by daemon, hardware decoders first if gpu decode free
+#define ACTIVE_ADOPT_SOCKET_FIELD "active_adopt_socket"  // set by daemon, unix socket of stream in feedback dir
+#define ACTIVE_PRIORITY_CLASS_FIELD "active_priority_class"  // set by daemon, priority_class or default of type
+#define ACTIVE_PACKET_INGEST_FIELD "active_packet_ingest"    // set by daemon, multicast inputs read from its rings
 #define AUTO_EXIT_TIME_FIELD "auto_exit_time"
+#define MEMORY_ACCOUNTING_FIELD "memory_accounting"  // set by daemon, buffers memory counted by allocating element
+#define HEAP_RELEASE_INTERVAL_FIELD "heap_release_interval"  // set by daemon, seconds, free heap returned to system
+#define QUARANTINE_FAILURES_FIELD "quarantine_failures"  // failed short runs in row, then source polled, 0 - never
+#define STREAMING_POOL_THREADS_FIELD "streaming_pool_threads"  // set by daemon, idle streaming threads kept for tasks
+#define STREAMING_POOL_CPUS_FIELD "streaming_pool_cpus"        // set by daemon, logical cpus of streaming threads
+#define CONFIG_HASH_FIELD "hash"  // opaque config version of controller, unchanged streams skipped on sync
 
 #define INPUT_FIELD "input"  // required
 #define OUTPUT_FIELD "output"
+#define SOCKET_FIELD "socket"  // tuning hash of input/output url entry
+#define SOCKET_RECEIVE_BUFFER_FIELD "receive_buffer"
+#define SOCKET_SEND_BUFFER_FIELD "send_buffer"
+#define SOCKET_DSCP_FIELD "dscp"
+#define SOCKET_MULTICAST_IFACE_FIELD "multicast_iface"
+#define HTTP_FIELD "http"  // fetching hash of http/hls input url entry
+#define HTTP_KEEP_ALIVE_FIELD "keep_alive"
+#define HTTP_TIMEOUT_FIELD "timeout"
+#define HTTP_HLS_BITRATE_FIELD "hls_bitrate"
+#define HTTP_HLS_BUFFER_MSEC_FIELD "hls_buffer_msec"
+#define MPTS_FIELD "mpts"  // program hash of multi program udp/srt input url entry
+#define MPTS_PROGRAM_FIELD "program"
+#define TCP_FIELD "tcp"  // clients hash of tcp server output url entry
+#define TCP_CLIENT_BUFFER_FIELD "client_buffer"
+#define TCP_KEYFRAME_RECOVER_FIELD "keyframe_recover"
+#define TCP_KEYFRAME_BURST_FIELD "keyframe_burst"
+#define TCP_TIMEOUT_FIELD "timeout"
 #define HAVE_VIDEO_FIELD "have_video"
 #define HAVE_AUDIO_FIELD "have_audio"
 #define HAVE_SUBTITLE_FIELD "have_subtitle"
@@ -30,36 +68,97 @@
 #define FRAME_RATE_FIELD "framerate"
 #define AUDIO_CHANNELS_FIELD "audio_channels"
 #define VOLUME_FIELD "volume"
+#define AUDIO_DITHERING_FIELD "audio_dithering"  // false quantizes decoded audio without tpdf dither and noise shaping
+#define LOUDNESS_TARGET_FIELD "loudness_target"  // LUFS of ebu r128 short-term loudness kept by gain of decoded audio
 #define VIDEO_PARSER_FIELD "video_parser"
 #define AUDIO_PARSER_FIELD "audio_parser"
 #define VIDEO_CODEC_FIELD "video_codec"
 #define AUDIO_CODEC_FIELD "audio_codec"
 #define AUDIO_SELECT_FIELD "audio_select"
+#define AUDIO_TRACKS_FIELD "audio_tracks"  // [N, ...] more input audio tracks muxed into outputs as own streams
 #define TIMESHIFT_DIR_FIELD "timeshift_dir"  // requeired in timeshift mode
 #define TIMESHIFT_CHUNK_LIFE_TIME_FIELD "timeshift_chunk_life_time"
 #define TIMESHIFT_DELAY_FIELD "timeshift_delay"
+#define TIMESHIFT_START_UTC_FIELD "timeshift_start_utc"  // sec, overrides delay
 #define TIMESHIFT_CHUNK_DURATION_FIELD "timeshift_chunk_duration"
+#define TIMESHIFT_CHUNK_WRITER_FIELD "timeshift_chunk_writer"  // preallocated chunks via aligned buffers, not filesink
+#define TIMESHIFT_DIRECT_IO_FIELD "timeshift_direct_io"        // chunk writer bypasses page cache
+#define TIMESHIFT_HOUR_FILES_FIELD "timeshift_hour_files"  // chunks appended into one file per hour by chunk writer
+#define TIMESHIFT_COLD_DIR_FIELD "timeshift_cold_dir"  // older chunks moved there, symlinks left in timeshift_dir
+#define TIMESHIFT_HOT_TIME_FIELD "timeshift_hot_time"  // sec chunks stay in timeshift_dir
+#define TIMESHIFT_MOVE_RATE_FIELD "timeshift_move_rate"  // in megabytes per second of chunk mover, 0 - unlimited
+#define CATCHUP_RECORDER_DIR_FIELD "catchup_recorder_dir"  // timeshift_dir of recorder, chunks linked if recorded
+#define CATCHUP_STOP_UTC_FIELD "catchup_stop_utc"  // sec, with timeshift_start_utc range taken from recorder
 #define CLEANUP_TS_FIELD "cleanup_ts"
+#define VOD_WORKERS_FIELD "vod_workers"  // vod encode, segment aligned parts of file transcoded in parallel
+#define VOD_OFFLINE_FIELD "vod_offline"  // vod encode, faster than realtime: unsynced sinks, long queues, slow presets
 #define LOGO_FIELD "logo"
 #define RSVG_LOGO_FIELD "rsvg_logo"
 #define LOOP_FIELD "loop"
+#define MMAP_FIELD "mmap"
+#define WARM_STANDBY_FIELD "warm_standby"  // second input kept parsed in pipeline, switched when first has no data
+#define HITLESS_MERGE_FIELD "hitless_merge"  // srt inputs are redundant paths of one ts, merged packet by packet
+#define SOFT_RESTART_FIELD "soft_restart"  // failed source and decodebin rebuilt, encoders and sinks kept
+#define GAPLESS_FIELD "gapless"  // playlist encode, next file demuxed ahead and joined before decoders
+#define TS_PASSTHROUGH_FIELD "ts_passthrough"  // relay, mpegts input forwarded to udp/srt/tcp outputs without demuxing
+#define TS_DROP_PIDS_FIELD "ts_drop_pids"  // relay, ts passthrough only, packets of these pids not forwarded
+#define AUTOPLUG_CACHE_FIELD "autoplug_cache"  // decodebin caps and factories of last start kept in feedback dir
+#define THUMBNAIL_INTERVAL_FIELD "thumbnail_interval"  // sec, relay keyframe decoded into jpeg of feedback dir, 0 off
+#define THUMBNAIL_WIDTH_FIELD "thumbnail_width"        // height keeps aspect ratio
 #define AVFORMAT_FIELD "avformat"
 #define RESTART_ATTEMPTS_FIELD "restart_attempts"
+#define WATCHDOG_MSEC_FIELD "watchdog_msec"            // main timer period, input/output stalls checked each tick
+#define NO_DATA_PANIC_MSEC_FIELD "no_data_panic_msec"  // restart when no buffer passed probes this long
+#define CONTENT_FAILOVER_MSEC_FIELD "content_failover_msec"  // black, frozen or silent input failed after it, 0 off
+#define UDP_BATCH_FIELD "udp_batch"                    // datagrams per recvmmsg, pushed as one buffer list
+#define UDP_RECEIVE_BUFFER_FIELD "udp_receive_buffer"  // SO_RCVBUF of udp inputs, bytes
+#define UDP_BUSY_POLL_FIELD "udp_busy_poll_usec"       // SO_BUSY_POLL of batched udp inputs
+#define RTSP_LATENCY_FIELD "rtsp_latency"                      // jitter buffer of rtsp inputs, msec
+#define RTSP_LATENCY_MIN_FIELD "rtsp_latency_min"              // adaptive latency bounds, msec
+#define RTSP_LATENCY_MAX_FIELD "rtsp_latency_max"
+#define RTSP_TCP_FALLBACK_LOSS_FIELD "rtsp_tcp_fallback_loss"  // percents of lost rtp packets to switch to tcp
+#define UDP_OUT_BATCH_FIELD "udp_out_batch"              // datagrams per sendmmsg of udp outputs
+#define UDP_OUT_SEND_BUFFER_FIELD "udp_out_send_buffer"  // SO_SNDBUF of udp outputs, bytes
+#define UDP_OUT_PACING_FIELD "udp_out_pacing"            // batched udp outputs paced by PCR
+#define UDP_OUT_FANOUT_FIELD "udp_out_fanout"            // udp outputs sent by one multiudpsink
+#define LL_HLS_PART_MSEC_FIELD "ll_hls_part_msec"        // http outputs written as low latency hls parts, 0 off
+#define HLS_MAX_FILES_FIELD "hls_max_files"  // segments kept by live hls outputs, changed live by service retention
+#define HLS_RAM_DIR_FIELD "hls_ram_dir"  // live http outputs kept in this tmpfs dir, linked from http root
+#define CMAF_FIELD "cmaf"  // http outputs as fmp4 segments shared by hls playlist and dash manifest
+#define RTMP_RECONNECT_FIELD "rtmp_reconnect"  // failed rtmp outputs restarted in place, not whole stream
+#define OUTPUT_QUEUE_MSEC_FIELD "output_queue_msec"  // leaky queue per output branch, slow sink drops, 0 blocks
+#define LATENCY_TARGET_MSEC_FIELD "latency_target_msec"  // time shared by pipeline queues, 0 - default
+#define CLOCK_SYNC_FIELD "clock_sync"  // false - pipeline without clock, sinks render on arrival, for remuxing only
+#define NET_CLOCK_FIELD "net_clock"    // ptp://domain, ntp://host:port or net://host:port, running time is clock time
+#define PIPELINE_LATENCY_MSEC_FIELD "pipeline_latency_msec"  // latency of live pipeline, 0 - reported by elements
+#define MUTED_OUTPUTS_FIELD "muted_outputs"  // live outputs send nothing until unmute_stream, migration target
 #define DELAY_TIME_FIELD "delay_time"
 #define SIZE_FIELD "size"
 #define VIDEO_BIT_RATE_FIELD "video_bitrate"
+#define VIDEO_MIN_BIT_RATE_FIELD "video_min_bitrate"  // lower bound of bitrate lowered on static scenes, 0 - fixed
 #define AUDIO_BIT_RATE_FIELD "audio_bitrate"
 #define MAIN_PROFILE_FIELD "mainprofile"
 #define MAIN_PROFILE_EXTERNAL_FIELD "mainprofile_external"
 #define ASPECT_RATIO_FIELD "aspect_ratio"
 #define RELAY_AUDIO_FIELD "relay_audio"
 #define RELAY_VIDEO_FIELD "relay_video"
+#define PASSTHROUGH_FIELD "passthrough"  // mux matching h264/aac input tracks without transcoding
+#define LOW_LATENCY_FIELD "low_latency"  // zero latency encoders, short queues, segments and srt buffer
+#define NETWORK_FEEDBACK_FIELD "network_feedback"  // video bitrate cut while srt or rtmp outputs congested
+#define LATENCY_STATS_FIELD "latency_stats"
+#define RENDITIONS_FIELD "renditions"  // [{"id" : output id, "size" : "WxH", "video_bitrate" : N}]
+#define RENDITION_ID_FIELD "id"
 
 #define DECKLINK_VIDEO_MODE_FIELD "decklink_video_mode"
+#define V4L2_IO_MODE_FIELD "v4l2_io_mode"  // 0 auto .. 5 dmabuf-import, dmabuf by default for vaapi/msdk encoders
+#define PRIORITY_CLASS_FIELD "priority_class"  // 0 live, 1 normal, 2 batch, 3 idle, cpu and io scheduling of child
+#define JOB_PRIORITY_FIELD "job_priority"  // -100 .. 100, offline job queue of daemon starts higher first, 0 default
 
 #if defined(MACHINE_LEARNING)
 #define DEEP_LEARNING_FIELD "deep_learning"
 #define DEEP_LEARNING_OVERLAY_FIELD "deep_learning_overlay"
+#define DEEP_LEARNING_METADATA_FIELD "deep_learning_metadata"  // detections sent as sei of h264/h265, not drawn
+#define ACTIVE_INFERENCE_SHM_FIELD "active_inference_shm"  // set by daemon, segment of shared inference worker
 #endif
 
 #if defined(AMAZON_KINESIS)
@@ -19,11 +19,19 @@
 
 #define DEFAULT_TIMESHIFT_CHUNK_DURATION 120
 #define DEFAULT_CHUNK_LIFE_TIME 12 * 3600
+#define DEFAULT_TIMESHIFT_HOT_TIME 3600
 
 #define DEFAULT_LOOP false
 #define DEFAULT_AVFORMAT false
 
 #define TEST_URL "test"
+#define LOAD_URL "load"  // load://<video pattern>?speed=<pixels per frame>&wave=<audio wave>, synthetic load
 #define DISPLAY_URL "display"
+#define PIPEWIRE_URL "pipewire"  // screen cast of pipewire, pipewire://<target object> for not default node
 
 #define LOGS_FILE_NAME "logs"
+#define AUTOPLUG_CACHE_FILE_NAME "autoplug.cache"
+#define ADOPT_SOCKET_FILE_NAME "adopt.sock"
+#define OUTPUT_TRASH_DIR_NAME ".trash"
+#define THUMBNAIL_FILE_NAME "thumbnail.jpg"
+#define DEFAULT_THUMBNAIL_WIDTH 320
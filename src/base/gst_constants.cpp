@@ -15,13 +15,13 @@
 #include "base/gst_constants.h"
 
 const std::array<const char*, SUPPORTED_VIDEO_PARSERS_COUNT> kSupportedVideoParsers = {
-    {TS_PARSE, H264_PARSE, H265_PARSE}};
+    {TS_PARSE, H264_PARSE, H265_PARSE, AV1_PARSE}};
 
 const std::array<const char*, SUPPORTED_AUDIO_PARSERS_COUNT> kSupportedAudioParsers = {
     {MPEG_AUDIO_PARSE, AAC_PARSE, AC3_PARSE, RAW_AUDIO_PARSE}};
 
 const std::array<const char*, SUPPORTED_VIDEO_ENCODERS_COUNT> kSupportedVideoEncoders = {
     {EAVC_ENC, OPEN_H264_ENC, X264_ENC, NV_H264_ENC, NV_H265_ENC, VAAPI_H264_ENC, VAAPI_MPEG2_ENC, MFX_H264_ENC,
-     X265_ENC, MSDK_H264_ENC}};
+     X265_ENC, MSDK_H264_ENC, NV_AV1_ENC, QSV_AV1_ENC, VA_AV1_ENC, SVT_AV1_ENC}};
 const std::array<const char*, SUPPORTED_AUDIO_ENCODERS_COUNT> kSupportedAudioEncoders = {
     {LAME_MP3_ENC, FAAC, VOAAC_ENC}};
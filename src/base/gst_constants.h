@@ -18,24 +18,32 @@
 
 #define DECODEBIN "decodebin"
 #define FAKE_SINK "fakesink"
+#define IDENTITY "identity"
 #define TEST_SINK "testsink"
 #define VIDEO_TEST_SRC "videotestsrc"
 #define AUDIO_TEST_SRC "audiotestsrc"
 #define DISPLAY_SRC "ximagesrc"
+#define PIPEWIRE_SRC "pipewiresrc"
 #define VIDEO_SCREEN_SINK "autovideosink"
 #define AUDIO_SCREEN_SINK "autoaudiosink"
 #define QUEUE "queue"
 #define QUEUE2 "queue2"
 #define H264_PARSE "h264parse"
 #define H265_PARSE "h265parse"
+#define AV1_PARSE "av1parse"
 #define MPEG_VIDEO_PARSE "mpegvideoparse"
 #define AAC_PARSE "aacparse"
 #define AC3_PARSE "ac3parse"
 #define MPEG_AUDIO_PARSE "mpegaudioparse"
 #define RAW_AUDIO_PARSE "rawaudioparse"
 #define TEE "tee"
+#define FUNNEL "funnel"
+#define INPUT_SELECTOR "input-selector"
+#define PARSEBIN "parsebin"
+#define CONCAT "concat"
 #define FLV_MUX "flvmux"
 #define MPEGTS_MUX "mpegtsmux"
+#define MP4_MUX "mp4mux"
 #define FILE_SINK "filesink"
 #define RTP_MUX "rtpmux"
 #define RTP_MPEG2_PAY "rtpmp2tpay"
@@ -53,6 +61,7 @@
 #define ALSA_SRC "alsasrc"
 #define MULTIFILE_SRC "multifilesrc"
 #define APP_SRC "appsrc"
+#define APP_SINK "appsink"
 #define FILE_SRC "filesrc"
 #define IMAGE_FREEZE "imagefreeze"
 #define CAPS_FILTER "capsfilter"
@@ -68,8 +77,10 @@
 #define DEINTERLACE "deinterlace"
 #define ASPECT_RATIO "aspectratiocrop"
 #define UDP_SINK "udpsink"
+#define MULTIUDP_SINK "multiudpsink"
 #define TCP_SERVER_SINK "tcpserversink"
 #define RTMP_SINK "rtmpsink"
+#define SHOUT2_SINK "shout2send"
 #define HLS_SINK "hlssink"
 #define SOUP_HTTP_SRC "souphttpsrc"
 #define VIDEO_SCALE "videoscale"
@@ -87,6 +98,11 @@
 
 #define MSDK_H264_ENC "msdkh264enc"
 
+#define NV_AV1_ENC "nvav1enc"
+#define QSV_AV1_ENC "qsvav1enc"
+#define VA_AV1_ENC "vaav1enc"
+#define SVT_AV1_ENC "svtav1enc"
+
 #define X264_ENC "x264enc"
 #define X264_ENC_PARAM(x) X264_ENC "." x
 #define X264_ENC_SPEED_PRESET X264_ENC_PARAM("speed-preset")
@@ -165,6 +181,7 @@
 #define VAAPI_MPEG2_ENC "vaapimpeg2enc"
 #define VAAPI_DECODEBIN "vaapidecodebin"
 #define VAAPI_POST_PROC "vaapipostproc"
+#define VAAPI_OVERLAY "vaapioverlay"
 
 #define GDK_PIXBUF_OVERLAY "gdkpixbufoverlay"
 #define RSVG_OVERLAY "rsvgoverlay"
@@ -200,21 +217,31 @@
 #define MFX_VPP "mfxvpp"
 #define MFX_H264_DEC "mfxh264dec"
 
+#define CUDA_UPLOAD "cudaupload"
+#define CUDA_CONVERT "cudaconvert"
+#define CUDA_SCALE "cudascale"
+#define CUDA_COMPOSITOR "cudacompositor"
+
 #define SRT_SRC "srtsrc"
 #define SRT_SINK "srtsink"
 
+#define SHM_SRC "shmsrc"
+#define SHM_SINK "shmsink"
+#define GDP_PAY "gdppay"
+#define GDP_DEPAY "gdpdepay"
+
 // deep learning
 #define TINY_YOLOV2 "tinyyolov2"
 #define TINY_YOLOV3 "tinyyolov3"
 #define DETECTION_OVERLAY "detectionoverlay"
 
-#define SUPPORTED_VIDEO_PARSERS_COUNT 3
+#define SUPPORTED_VIDEO_PARSERS_COUNT 4
 #define SUPPORTED_AUDIO_PARSERS_COUNT 4
 
 extern const std::array<const char*, SUPPORTED_VIDEO_PARSERS_COUNT> kSupportedVideoParsers;
 extern const std::array<const char*, SUPPORTED_AUDIO_PARSERS_COUNT> kSupportedAudioParsers;
 
-#define SUPPORTED_VIDEO_ENCODERS_COUNT 10
+#define SUPPORTED_VIDEO_ENCODERS_COUNT 14
 #define SUPPORTED_AUDIO_ENCODERS_COUNT 3
 
 extern const std::array<const char*, SUPPORTED_VIDEO_ENCODERS_COUNT> kSupportedVideoEncoders;
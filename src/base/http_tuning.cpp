@@ -0,0 +1,61 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/http_tuning.h"
+
+#include "base/config_fields.h"
+
+namespace fastocloud {
+
+HttpTuning::HttpTuning() : keep_alive(false), timeout(0), hls_bitrate(0), hls_buffer_msec(0) {}
+
+bool HttpTuning::IsEmpty() const {
+  return !keep_alive && timeout == 0 && hls_bitrate == 0 && hls_buffer_msec == 0;
+}
+
+bool ReadHttpTuning(common::HashValue* hash, HttpTuning* tuning) {
+  if (!hash || !tuning) {
+    return false;
+  }
+
+  HttpTuning ltuning;
+  bool keep_alive;
+  common::Value* keep_alive_field = hash->Find(HTTP_KEEP_ALIVE_FIELD);
+  if (keep_alive_field && keep_alive_field->GetAsBoolean(&keep_alive)) {
+    ltuning.keep_alive = keep_alive;
+  }
+
+  int timeout;
+  common::Value* timeout_field = hash->Find(HTTP_TIMEOUT_FIELD);
+  if (timeout_field && timeout_field->GetAsInteger(&timeout) && timeout > 0 && timeout <= 3600) {
+    ltuning.timeout = timeout;
+  }
+
+  int hls_bitrate;
+  common::Value* hls_bitrate_field = hash->Find(HTTP_HLS_BITRATE_FIELD);
+  if (hls_bitrate_field && hls_bitrate_field->GetAsInteger(&hls_bitrate) && hls_bitrate > 0) {
+    ltuning.hls_bitrate = hls_bitrate;
+  }
+
+  int hls_buffer_msec;
+  common::Value* hls_buffer_msec_field = hash->Find(HTTP_HLS_BUFFER_MSEC_FIELD);
+  if (hls_buffer_msec_field && hls_buffer_msec_field->GetAsInteger(&hls_buffer_msec) && hls_buffer_msec > 0) {
+    ltuning.hls_buffer_msec = hls_buffer_msec;
+  }
+
+  *tuning = ltuning;
+  return true;
+}
+
+}  // namespace fastocloud
@@ -0,0 +1,41 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+
+#include <common/value.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+
+// http and hls fetching of input, "http" hash of url entry
+struct HttpTuning {
+  HttpTuning();
+
+  bool IsEmpty() const;
+
+  bool keep_alive;                       // persistent connections for playlist and segment requests
+  int timeout;                           // secs, 0 for stream default
+  int hls_bitrate;                       // kbps, variant pinned to best one under it, 0 adaptive
+  fastotv::timestamp_t hls_buffer_msec;  // segments fetched ahead of playback, 0 demuxer default
+};
+
+typedef std::map<fastotv::channel_id_t, HttpTuning> http_tunings_t;
+
+bool ReadHttpTuning(common::HashValue* hash, HttpTuning* tuning);
+
+}  // namespace fastocloud
@@ -14,6 +14,8 @@
 
 #include "base/input_uri.h"
 
+#include <common/convert2string.h>
+
 #include "base/constants.h"
 
 namespace fastocloud {
@@ -26,4 +28,77 @@ bool IsDisplayInputUrl(const InputUri& url) {
   return url.GetInput() == common::uri::Url(DISPLAY_URL);
 }
 
+bool IsPipeWireInputUrl(const InputUri& url) {
+  const std::string input = url.GetInput().GetUrl();
+  return input == PIPEWIRE_URL || input.compare(0, sizeof(PIPEWIRE_URL "://") - 1, PIPEWIRE_URL "://") == 0;
+}
+
+std::string GetPipeWireTarget(const InputUri& url) {
+  const std::string input = url.GetInput().GetUrl();
+  const size_t prefix_len = sizeof(PIPEWIRE_URL "://") - 1;
+  if (input.compare(0, prefix_len, PIPEWIRE_URL "://") != 0) {
+    return std::string();
+  }
+  return input.substr(prefix_len);
+}
+
+LoadGenerator::LoadGenerator() : pattern("ball"), speed(0), wave("sine") {}
+
+bool IsLoadInputUrl(const InputUri& url) {
+  const std::string input = url.GetInput().GetUrl();
+  return input == LOAD_URL || input.compare(0, sizeof(LOAD_URL "://") - 1, LOAD_URL "://") == 0;
+}
+
+bool GetLoadGenerator(const InputUri& url, LoadGenerator* generator) {
+  if (!generator || !IsLoadInputUrl(url)) {
+    return false;
+  }
+
+  LoadGenerator lgenerator;
+  const std::string input = url.GetInput().GetUrl();
+  const size_t prefix_len = sizeof(LOAD_URL "://") - 1;
+  if (input.size() <= prefix_len) {
+    *generator = lgenerator;
+    return true;
+  }
+
+  const std::string body = input.substr(prefix_len);
+  const size_t query_pos = body.find('?');
+  const std::string pattern = body.substr(0, query_pos);
+  if (!pattern.empty()) {
+    lgenerator.pattern = pattern;
+  }
+
+  size_t pos = query_pos == std::string::npos ? body.size() : query_pos + 1;
+  while (pos < body.size()) {
+    size_t end = body.find('&', pos);
+    if (end == std::string::npos) {
+      end = body.size();
+    }
+    const std::string param = body.substr(pos, end - pos);
+    pos = end + 1;
+
+    const size_t eq = param.find('=');
+    if (eq == std::string::npos) {
+      return false;
+    }
+    const std::string key = param.substr(0, eq);
+    const std::string value = param.substr(eq + 1);
+    if (key == "speed") {
+      int speed;
+      if (!common::ConvertFromString(value, &speed) || speed < 0) {
+        return false;
+      }
+      lgenerator.speed = speed;
+    } else if (key == "wave") {
+      lgenerator.wave = value;
+    } else {
+      return false;
+    }
+  }
+
+  *generator = lgenerator;
+  return true;
+}
+
 }  // namespace fastocloud
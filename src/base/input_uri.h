@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <fastotv/types/input_uri.h>
 
 namespace fastocloud {
@@ -22,5 +24,19 @@ typedef fastotv::InputUri InputUri;
 
 bool IsTestInputUrl(const InputUri& url);
 bool IsDisplayInputUrl(const InputUri& url);
+bool IsPipeWireInputUrl(const InputUri& url);
+std::string GetPipeWireTarget(const InputUri& url);  // empty for default node
+
+// generated input of configured size and rate, complexity set by pattern, snow is noise
+struct LoadGenerator {
+  LoadGenerator();
+
+  std::string pattern;  // videotestsrc pattern nick
+  int speed;            // horizontal pixels per frame, 0 - static picture
+  std::string wave;     // audiotestsrc wave nick
+};
+
+bool IsLoadInputUrl(const InputUri& url);
+bool GetLoadGenerator(const InputUri& url, LoadGenerator* generator);
 
 }  // namespace fastocloud
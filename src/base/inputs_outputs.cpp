@@ -17,6 +17,8 @@
 #include <json-c/json_object.h>
 #include <json-c/json_tokener.h>
 
+#include <map>
+
 #include <common/convert2string.h>
 
 #include "base/config_fields.h"
@@ -64,6 +66,46 @@ bool ConvertFromString(common::ArrayValue* input_urls, fastocloud::input_t* out)
   return true;
 }
 
+template <typename T, typename Tuning>
+bool ReadTunings(const StreamConfig& config,
+                 const char* field,
+                 const char* tuning_field,
+                 bool (*reader)(common::HashValue* hash, Tuning* tuning),
+                 std::map<fastotv::channel_id_t, Tuning>* tunings) {
+  if (!config || !tunings) {
+    return false;
+  }
+
+  common::Value* urls_field = config->Find(field);
+  common::ArrayValue* urls = nullptr;
+  if (!urls_field || !urls_field->GetAsList(&urls)) {
+    return false;
+  }
+
+  std::map<fastotv::channel_id_t, Tuning> ltunings;
+  for (size_t i = 0; i < urls->GetSize(); ++i) {
+    common::Value* url = nullptr;
+    common::HashValue* url_hash = nullptr;
+    if (!urls->Get(i, &url) || !url->GetAsHash(&url_hash)) {
+      continue;
+    }
+
+    common::Value* tuning_value = url_hash->Find(tuning_field);
+    common::HashValue* tuning_hash = nullptr;
+    if (!tuning_value || !tuning_value->GetAsHash(&tuning_hash)) {
+      continue;
+    }
+
+    const auto murl = T::MakeUrl(url_hash);
+    Tuning tuning;
+    if (murl && reader(tuning_hash, &tuning) && !tuning.IsEmpty()) {
+      ltunings[murl->GetID()] = tuning;
+    }
+  }
+  *tunings = ltunings;
+  return true;
+}
+
 }  // namespace
 
 bool read_input(const StreamConfig& config, input_t* input) {
@@ -106,4 +148,24 @@ bool read_output(const StreamConfig& config, output_t* output) {
   return true;
 }
 
+bool read_input_sockets(const StreamConfig& config, socket_tunings_t* sockets) {
+  return ReadTunings<InputUri>(config, INPUT_FIELD, SOCKET_FIELD, ReadSocketTuning, sockets);
+}
+
+bool read_output_sockets(const StreamConfig& config, socket_tunings_t* sockets) {
+  return ReadTunings<OutputUri>(config, OUTPUT_FIELD, SOCKET_FIELD, ReadSocketTuning, sockets);
+}
+
+bool read_input_http(const StreamConfig& config, http_tunings_t* http) {
+  return ReadTunings<InputUri>(config, INPUT_FIELD, HTTP_FIELD, ReadHttpTuning, http);
+}
+
+bool read_input_mpts(const StreamConfig& config, mpts_tunings_t* mpts) {
+  return ReadTunings<InputUri>(config, INPUT_FIELD, MPTS_FIELD, ReadMptsTuning, mpts);
+}
+
+bool read_output_tcp(const StreamConfig& config, tcp_tunings_t* tcp) {
+  return ReadTunings<OutputUri>(config, OUTPUT_FIELD, TCP_FIELD, ReadTcpTuning, tcp);
+}
+
 }  // namespace fastocloud
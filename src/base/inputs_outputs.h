@@ -21,6 +21,10 @@
 
 #include "base/input_uri.h"   // for InputUri
 #include "base/output_uri.h"  // for OutputUri
+#include "base/http_tuning.h"
+#include "base/mpts_tuning.h"
+#include "base/socket_tuning.h"
+#include "base/tcp_tuning.h"
 
 namespace fastocloud {
 
@@ -30,4 +34,17 @@ typedef std::vector<OutputUri> output_t;
 bool read_input(const StreamConfig& config, input_t* input);
 bool read_output(const StreamConfig& config, output_t* output);
 
+// socket hashes of url entries by channel id, empty if none
+bool read_input_sockets(const StreamConfig& config, socket_tunings_t* sockets);
+bool read_output_sockets(const StreamConfig& config, socket_tunings_t* sockets);
+
+// http hashes of input url entries by channel id, empty if none
+bool read_input_http(const StreamConfig& config, http_tunings_t* http);
+
+// mpts hashes of input url entries by channel id, empty if none
+bool read_input_mpts(const StreamConfig& config, mpts_tunings_t* mpts);
+
+// tcp hashes of output url entries by channel id, empty if none
+bool read_output_tcp(const StreamConfig& config, tcp_tunings_t* tcp);
+
 }  // namespace fastocloud
@@ -0,0 +1,112 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/latency_histogram.h"
+
+namespace common {
+
+std::string ConvertToString(fastocloud::LatencyStage stage) {
+  static const std::string kLatencyStages[] = {"input", "decode", "encode", "output"};
+  if (stage >= fastocloud::LATENCY_STAGES_COUNT) {
+    return std::string();
+  }
+
+  return kLatencyStages[stage];
+}
+
+}  // namespace common
+
+namespace fastocloud {
+
+LatencyHistogram::LatencyHistogram() : buckets_() {
+  Reset();
+}
+
+size_t LatencyHistogram::GetBucketIndex(fastotv::timestamp_t msec) {
+  if (msec <= 0) {
+    return 0;
+  }
+
+  size_t index = 1;
+  while (msec > 1 && index < buckets_count - 1) {
+    msec >>= 1;
+    index++;
+  }
+  return index;
+}
+
+fastotv::timestamp_t LatencyHistogram::GetBucketUpperBound(size_t index) {
+  if (index >= buckets_count - 1) {
+    return fastotv::timestamp_t(1) << (buckets_count - 2);
+  }
+
+  return fastotv::timestamp_t(1) << index;
+}
+
+void LatencyHistogram::Record(fastotv::timestamp_t msec) {
+  buckets_[GetBucketIndex(msec)]++;
+}
+
+void LatencyHistogram::Add(size_t index, uint64_t count) {
+  if (index >= buckets_count) {
+    return;
+  }
+
+  buckets_[index] += count;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  for (size_t i = 0; i < buckets_count; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+}
+
+void LatencyHistogram::Reset() {
+  buckets_.fill(0);
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+  uint64_t count = 0;
+  for (uint64_t bucket : buckets_) {
+    count += bucket;
+  }
+  return count;
+}
+
+fastotv::timestamp_t LatencyHistogram::GetPercentile(double percent) const {
+  const uint64_t count = GetCount();
+  if (count == 0) {
+    return 0;
+  }
+
+  const double threshold = count * percent / 100.0;
+  uint64_t passed = 0;
+  for (size_t i = 0; i < buckets_count; ++i) {
+    passed += buckets_[i];
+    if (passed >= threshold) {
+      return GetBucketUpperBound(i);
+    }
+  }
+  return GetBucketUpperBound(buckets_count - 1);
+}
+
+const LatencyHistogram::buckets_t& LatencyHistogram::GetBuckets() const {
+  return buckets_;
+}
+
+void LatencyHistogram::SetBuckets(const buckets_t& buckets) {
+  buckets_ = buckets;
+}
+
+}  // namespace fastocloud
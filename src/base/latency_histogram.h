@@ -0,0 +1,65 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "base/types.h"
+
+namespace fastocloud {
+
+enum LatencyStage {
+  INPUT_LATENCY_STAGE = 0,  // input src pad
+  DECODE_LATENCY_STAGE,     // decoder src pad
+  ENCODE_LATENCY_STAGE,     // encoder src pad
+  OUTPUT_LATENCY_STAGE,     // sink pad
+  LATENCY_STAGES_COUNT
+};
+
+// power of two msec buckets: [0, 1), [1, 2), [2, 4) ... [2^(buckets_count - 2), inf)
+class LatencyHistogram {  // only compile time size fields
+ public:
+  enum { buckets_count = 16 };
+  typedef std::array<uint64_t, buckets_count> buckets_t;
+
+  LatencyHistogram();
+
+  static size_t GetBucketIndex(fastotv::timestamp_t msec);
+  static fastotv::timestamp_t GetBucketUpperBound(size_t index);
+
+  void Record(fastotv::timestamp_t msec);
+  void Add(size_t index, uint64_t count);
+  void Merge(const LatencyHistogram& other);
+  void Reset();
+
+  uint64_t GetCount() const;
+  // upper bound of bucket which holds percent (0, 100] of samples, 0 if empty
+  fastotv::timestamp_t GetPercentile(double percent) const;
+
+  const buckets_t& GetBuckets() const;
+  void SetBuckets(const buckets_t& buckets);
+
+ private:
+  buckets_t buckets_;
+};
+
+typedef std::array<LatencyHistogram, LATENCY_STAGES_COUNT> latency_histograms_t;
+
+}  // namespace fastocloud
+
+namespace common {
+std::string ConvertToString(fastocloud::LatencyStage stage);
+}
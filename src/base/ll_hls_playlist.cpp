@@ -0,0 +1,156 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/ll_hls_playlist.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <common/convert2string.h>
+#include <common/sprintf.h>
+
+namespace fastocloud {
+
+namespace {
+const char kExtInf[] = "#EXTINF:";
+const char kExtPart[] = "#EXT-X-PART:";
+const char kExtMediaSequence[] = "#EXT-X-MEDIA-SEQUENCE:";
+
+std::string msec_to_sec_string(fastotv::timestamp_t msec) {
+  return common::MemSPrintf("%.3f", msec / 1000.0);
+}
+
+bool starts_with(const std::string& line, const char* prefix) {
+  return line.compare(0, strlen(prefix), prefix) == 0;
+}
+}  // namespace
+
+LlHlsPlaylist::LlHlsPlaylist(fastotv::timestamp_t part_target_msec, size_t playlist_length)
+    : part_target_msec_(part_target_msec),
+      playlist_length_(std::max<size_t>(playlist_length, 1)),
+      media_sequence_(0),
+      segments_(),
+      open_parts_(),
+      preload_hint_() {}
+
+void LlHlsPlaylist::AddPart(const std::string& uri, fastotv::timestamp_t duration_msec, bool independent) {
+  open_parts_.push_back({uri, duration_msec, independent});
+}
+
+std::vector<std::string> LlHlsPlaylist::CloseSegment(const std::string& uri, fastotv::timestamp_t duration_msec) {
+  segments_.push_back({uri, duration_msec, open_parts_});
+  open_parts_.clear();
+
+  std::vector<std::string> expired;
+  while (segments_.size() > playlist_length_) {
+    const Segment& old = segments_.front();
+    expired.push_back(old.uri);
+    for (const Part& part : old.parts) {
+      expired.push_back(part.uri);
+    }
+    segments_.pop_front();
+    media_sequence_++;
+  }
+  return expired;
+}
+
+void LlHlsPlaylist::SetPreloadHint(const std::string& uri) {
+  preload_hint_ = uri;
+}
+
+uint64_t LlHlsPlaylist::GetMediaSequence() const {
+  return media_sequence_;
+}
+
+uint64_t LlHlsPlaylist::GetNextMediaSequence() const {
+  return media_sequence_ + segments_.size();
+}
+
+size_t LlHlsPlaylist::GetOpenPartsCount() const {
+  return open_parts_.size();
+}
+
+std::string LlHlsPlaylist::Render() const {
+  fastotv::timestamp_t max_duration_msec = 0;
+  for (const Segment& segment : segments_) {
+    max_duration_msec = std::max(max_duration_msec, segment.duration_msec);
+  }
+  const long target_duration = std::max<long>(1, static_cast<long>(ceil(max_duration_msec / 1000.0)));
+
+  std::stringstream out;
+  out << "#EXTM3U\n";
+  out << "#EXT-X-VERSION:" << LL_HLS_VERSION << "\n";
+  out << "#EXT-X-TARGETDURATION:" << target_duration << "\n";
+  out << "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=" << msec_to_sec_string(part_target_msec_ * 3)
+      << "\n";
+  out << "#EXT-X-PART-INF:PART-TARGET=" << msec_to_sec_string(part_target_msec_) << "\n";
+  out << kExtMediaSequence << media_sequence_ << "\n";
+
+  const size_t first_with_parts = segments_.size() > part_segments ? segments_.size() - part_segments : 0;
+  auto render_parts = [&out](const std::vector<Part>& parts) {
+    for (const Part& part : parts) {
+      out << kExtPart << "DURATION=" << msec_to_sec_string(part.duration_msec) << ",URI=\"" << part.uri << "\"";
+      if (part.independent) {
+        out << ",INDEPENDENT=YES";
+      }
+      out << "\n";
+    }
+  };
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    const Segment& segment = segments_[i];
+    if (i >= first_with_parts) {
+      render_parts(segment.parts);
+    }
+    out << kExtInf << msec_to_sec_string(segment.duration_msec) << ",\n";
+    out << segment.uri << "\n";
+  }
+  render_parts(open_parts_);
+  if (!preload_hint_.empty()) {
+    out << "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"" << preload_hint_ << "\"\n";
+  }
+  return out.str();
+}
+
+bool IsLlHlsPlaylistReady(const std::string& playlist, uint64_t msn, int part) {
+  std::istringstream in(playlist);
+  std::string line;
+  uint64_t media_sequence = 0;
+  uint64_t closed = 0;
+  uint64_t open_parts = 0;
+  while (std::getline(in, line)) {
+    if (starts_with(line, kExtMediaSequence)) {
+      common::ConvertFromString(line.substr(strlen(kExtMediaSequence)), &media_sequence);
+    } else if (starts_with(line, kExtInf)) {
+      closed++;
+      open_parts = 0;
+    } else if (starts_with(line, kExtPart)) {
+      open_parts++;
+    }
+  }
+
+  const uint64_t next = media_sequence + closed;
+  if (msn < next) {
+    return true;
+  }
+
+  if (msn == next) {
+    return part >= 0 && static_cast<uint64_t>(part) < open_parts;
+  }
+  return msn > next + 1;  // too far ahead, served as is
+}
+
+}  // namespace fastocloud
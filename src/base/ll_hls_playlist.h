@@ -0,0 +1,73 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <fastotv/types.h>
+
+#define LL_HLS_VERSION 6
+#define LL_HLS_MSN_QUERY "_HLS_msn"
+#define LL_HLS_PART_QUERY "_HLS_part"
+#define LL_HLS_SEGMENT_MSEC 4000
+#define LL_HLS_PLAYLIST_LENGTH 6
+
+namespace fastocloud {
+
+// media playlist with partial segments (EXT-X-PART), preload hint and blocking reload
+class LlHlsPlaylist {
+ public:
+  enum { part_segments = 3 };  // closed segments listed with their parts
+
+  struct Part {
+    std::string uri;
+    fastotv::timestamp_t duration_msec;
+    bool independent;  // starts with keyframe
+  };
+
+  struct Segment {
+    std::string uri;
+    fastotv::timestamp_t duration_msec;
+    std::vector<Part> parts;
+  };
+
+  LlHlsPlaylist(fastotv::timestamp_t part_target_msec, size_t playlist_length);
+
+  void AddPart(const std::string& uri, fastotv::timestamp_t duration_msec, bool independent);  // of open segment
+  // open parts become segment, returns files of segments out of playlist
+  std::vector<std::string> CloseSegment(const std::string& uri, fastotv::timestamp_t duration_msec);
+  void SetPreloadHint(const std::string& uri);
+
+  uint64_t GetMediaSequence() const;
+  uint64_t GetNextMediaSequence() const;  // msn of open segment
+  size_t GetOpenPartsCount() const;
+
+  std::string Render() const;
+
+ private:
+  const fastotv::timestamp_t part_target_msec_;
+  const size_t playlist_length_;
+  uint64_t media_sequence_;
+  std::deque<Segment> segments_;
+  std::vector<Part> open_parts_;
+  std::string preload_hint_;
+};
+
+// blocking reload, true if playlist has segment msn (and its part if part >= 0) or request can't be satisfied later
+bool IsLlHlsPlaylistReady(const std::string& playlist, uint64_t msn, int part);
+
+}  // namespace fastocloud
@@ -23,14 +23,74 @@
 #define DEEP_LEARNING_BACKEND_FIELD "backend"
 #define DEEP_LEARNING_MODEL_PATH_FIELD "model_path"
 #define DEEP_LEARNING_PROPERTIES_FIELD "properties"
+#define DEEP_LEARNING_INFERENCE_INTERVAL_FIELD "inference_interval"
+#define DEEP_LEARNING_INFERENCE_RATE_FIELD "inference_rate"
+#define DEEP_LEARNING_SHARED_FIELD "shared"
+#define DEEP_LEARNING_NOTIFICATION_INTERVAL_FIELD "notification_interval"
+#define DEEP_LEARNING_FALLBACKS_FIELD "fallbacks"
 
 namespace fastocloud {
 namespace machine_learning {
+namespace {
+DeepLearning::properties_t read_properties(common::Value* properties_field) {
+  DeepLearning::properties_t properties;
+  common::ArrayValue* arr = nullptr;
+  if (!properties_field || !properties_field->GetAsList(&arr)) {
+    return properties;
+  }
 
-DeepLearning::DeepLearning() : backend_(fastoml::TENSORFLOW), model_path_(), properties_() {}
+  for (size_t i = 0; i < arr->GetSize(); ++i) {
+    common::Value* prop = nullptr;
+    if (arr->Get(i, &prop)) {
+      common::HashValue* hprop = nullptr;
+      if (prop->GetAsHash(&hprop)) {
+        for (auto it = hprop->begin(); it != hprop->end(); ++it) {
+          std::string value_str;
+          if (it->second->GetAsBasicString(&value_str)) {
+            BackendProperty pr = {it->first.as_string(), value_str};
+            properties.push_back(pr);
+          }
+        }
+      }
+    }
+  }
+  return properties;
+}
+
+DeepLearning::properties_t json_read_properties(json_object* jproperties) {
+  DeepLearning::properties_t properties;
+  size_t len = json_object_array_length(jproperties);
+  // [{"input_layer" : "1234"}, {"output_layer" : "321"}]
+  for (size_t i = 0; i < len; ++i) {
+    json_object* jproperty = json_object_array_get_idx(jproperties, i);
+    json_object_object_foreach(jproperty, key, val) { properties.push_back({key, json_object_get_string(val)}); }
+  }
+  return properties;
+}
+
+json_object* json_make_properties(const DeepLearning::properties_t& properties) {
+  json_object* jproperties = json_object_new_array();
+  for (size_t i = 0; i < properties.size(); ++i) {
+    json_object* jproperty = json_object_new_object();
+    json_object_object_add(jproperty, properties[i].property.c_str(),
+                           json_object_new_string(properties[i].value.c_str()));
+    json_object_array_add(jproperties, jproperty);
+  }
+  return jproperties;
+}
+}  // namespace
+
+DeepLearning::DeepLearning() : DeepLearning(fastoml::TENSORFLOW, file_path_t()) {}
 
 DeepLearning::DeepLearning(fastoml::SupportedBackends backend, const file_path_t& model_path, const properties_t& prop)
-    : backend_(backend), model_path_(model_path), properties_(prop) {}
+    : backend_(backend),
+      model_path_(model_path),
+      properties_(prop),
+      fallbacks_(),
+      inference_interval_(1),
+      inference_rate_(0),
+      shared_(false),
+      notification_interval_(default_notification_interval_msec) {}
 
 DeepLearning::file_path_t DeepLearning::GetModelPath() const {
   return model_path_;
@@ -40,6 +100,20 @@ void DeepLearning::SetModelPath(const file_path_t& path) {
   model_path_ = path;
 }
 
+DeepLearning::backend_models_t DeepLearning::GetFallbacks() const {
+  return fallbacks_;
+}
+
+void DeepLearning::SetFallbacks(const backend_models_t& fallbacks) {
+  fallbacks_ = fallbacks;
+}
+
+DeepLearning::backend_models_t DeepLearning::GetBackendModels() const {
+  backend_models_t models = {{backend_, model_path_, properties_}};
+  models.insert(models.end(), fallbacks_.begin(), fallbacks_.end());
+  return models;
+}
+
 DeepLearning::properties_t DeepLearning::GetProperties() const {
   return properties_;
 }
@@ -48,6 +122,42 @@ void DeepLearning::SetProperties(const properties_t& prop) {
   properties_ = prop;
 }
 
+int DeepLearning::GetInferenceInterval() const {
+  return inference_interval_;
+}
+
+void DeepLearning::SetInferenceInterval(int frames) {
+  inference_interval_ = frames > 1 ? frames : 1;
+}
+
+double DeepLearning::GetInferenceRate() const {
+  return inference_rate_;
+}
+
+void DeepLearning::SetInferenceRate(double rate) {
+  inference_rate_ = rate > 0 ? rate : 0;
+}
+
+bool DeepLearning::IsInferenceScheduled() const {
+  return inference_interval_ > 1 || inference_rate_ > 0;
+}
+
+bool DeepLearning::IsShared() const {
+  return shared_;
+}
+
+void DeepLearning::SetShared(bool shared) {
+  shared_ = shared;
+}
+
+int DeepLearning::GetNotificationInterval() const {
+  return notification_interval_;
+}
+
+void DeepLearning::SetNotificationInterval(int msec) {
+  notification_interval_ = msec > 0 ? msec : 0;
+}
+
 fastoml::SupportedBackends DeepLearning::GetBackend() const {
   return backend_;
 }
@@ -80,26 +190,56 @@ common::Optional<DeepLearning> DeepLearning::MakeDeepLearning(common::HashValue*
   }
   res.SetModelPath(file_path_t(model_path_str));
 
-  common::Value* properties_field = hash->Find(DEEP_LEARNING_PROPERTIES_FIELD);
-  common::ArrayValue* arr = nullptr;
-  if (properties_field && properties_field->GetAsList(&arr)) {
-    properties_t properties;
-    for (size_t i = 0; i < arr->GetSize(); ++i) {
-      common::Value* prop = nullptr;
-      if (arr->Get(i, &prop)) {
-        common::HashValue* hprop = nullptr;
-        if (prop->GetAsHash(&hprop)) {
-          for (auto it = hprop->begin(); it != hprop->end(); ++it) {
-            std::string value_str;
-            if (it->second->GetAsBasicString(&value_str)) {
-              BackendProperty pr = {it->first.as_string(), value_str};
-              properties.push_back(pr);
-            }
-          }
-        }
+  res.SetProperties(read_properties(hash->Find(DEEP_LEARNING_PROPERTIES_FIELD)));
+
+  common::Value* fallbacks_field = hash->Find(DEEP_LEARNING_FALLBACKS_FIELD);
+  common::ArrayValue* fallbacks_arr = nullptr;
+  if (fallbacks_field && fallbacks_field->GetAsList(&fallbacks_arr)) {
+    backend_models_t fallbacks;
+    for (size_t i = 0; i < fallbacks_arr->GetSize(); ++i) {
+      common::Value* fallback = nullptr;
+      common::HashValue* fallback_hash = nullptr;
+      if (!fallbacks_arr->Get(i, &fallback) || !fallback->GetAsHash(&fallback_hash)) {
+        continue;
+      }
+
+      int fallback_backend;
+      std::string fallback_model_path;
+      common::Value* fallback_backend_field = fallback_hash->Find(DEEP_LEARNING_BACKEND_FIELD);
+      common::Value* fallback_model_path_field = fallback_hash->Find(DEEP_LEARNING_MODEL_PATH_FIELD);
+      if (fallback_backend_field && fallback_backend_field->GetAsInteger(&fallback_backend) &&
+          fallback_model_path_field && fallback_model_path_field->GetAsBasicString(&fallback_model_path)) {
+        BackendModel model = {static_cast<fastoml::SupportedBackends>(fallback_backend),
+                              file_path_t(fallback_model_path),
+                              read_properties(fallback_hash->Find(DEEP_LEARNING_PROPERTIES_FIELD))};
+        fallbacks.push_back(model);
       }
     }
-    res.SetProperties(properties);
+    res.SetFallbacks(fallbacks);
+  }
+
+  int interval;
+  common::Value* interval_field = hash->Find(DEEP_LEARNING_INFERENCE_INTERVAL_FIELD);
+  if (interval_field && interval_field->GetAsInteger(&interval)) {
+    res.SetInferenceInterval(interval);
+  }
+
+  double rate;
+  common::Value* rate_field = hash->Find(DEEP_LEARNING_INFERENCE_RATE_FIELD);
+  if (rate_field && rate_field->GetAsDouble(&rate)) {
+    res.SetInferenceRate(rate);
+  }
+
+  bool shared;
+  common::Value* shared_field = hash->Find(DEEP_LEARNING_SHARED_FIELD);
+  if (shared_field && shared_field->GetAsBoolean(&shared)) {
+    res.SetShared(shared);
+  }
+
+  int notification_interval;
+  common::Value* notification_interval_field = hash->Find(DEEP_LEARNING_NOTIFICATION_INTERVAL_FIELD);
+  if (notification_interval_field && notification_interval_field->GetAsInteger(&notification_interval)) {
+    res.SetNotificationInterval(notification_interval);
   }
 
   return res;
@@ -124,14 +264,58 @@ common::Error DeepLearning::DoDeSerialize(json_object* serialized) {
   json_object* jproperties = nullptr;
   json_bool jproperties_exists = json_object_object_get_ex(serialized, DEEP_LEARNING_PROPERTIES_FIELD, &jproperties);
   if (jproperties_exists) {
-    properties_t properties;
-    size_t len = json_object_array_length(jproperties);
-    // [{"input_layer" : "1234"}, {"output_layer" : "321"}]
+    res.SetProperties(json_read_properties(jproperties));
+  }
+
+  json_object* jfallbacks = nullptr;
+  json_bool jfallbacks_exists = json_object_object_get_ex(serialized, DEEP_LEARNING_FALLBACKS_FIELD, &jfallbacks);
+  if (jfallbacks_exists) {
+    backend_models_t fallbacks;
+    size_t len = json_object_array_length(jfallbacks);
     for (size_t i = 0; i < len; ++i) {
-      json_object* jproperty = json_object_array_get_idx(jproperties, i);
-      json_object_object_foreach(jproperty, key, val) { properties.push_back({key, json_object_get_string(val)}); }
+      json_object* jfallback = json_object_array_get_idx(jfallbacks, i);
+      json_object* jfallback_backend = nullptr;
+      json_object* jfallback_model_path = nullptr;
+      if (!json_object_object_get_ex(jfallback, DEEP_LEARNING_BACKEND_FIELD, &jfallback_backend) ||
+          !json_object_object_get_ex(jfallback, DEEP_LEARNING_MODEL_PATH_FIELD, &jfallback_model_path)) {
+        continue;
+      }
+
+      BackendModel model = {static_cast<fastoml::SupportedBackends>(json_object_get_int(jfallback_backend)),
+                            file_path_t(json_object_get_string(jfallback_model_path)), properties_t()};
+      json_object* jfallback_properties = nullptr;
+      if (json_object_object_get_ex(jfallback, DEEP_LEARNING_PROPERTIES_FIELD, &jfallback_properties)) {
+        model.properties = json_read_properties(jfallback_properties);
+      }
+      fallbacks.push_back(model);
     }
-    res.SetProperties(properties);
+    res.SetFallbacks(fallbacks);
+  }
+
+  json_object* jinterval = nullptr;
+  json_bool jinterval_exists =
+      json_object_object_get_ex(serialized, DEEP_LEARNING_INFERENCE_INTERVAL_FIELD, &jinterval);
+  if (jinterval_exists) {
+    res.SetInferenceInterval(json_object_get_int(jinterval));
+  }
+
+  json_object* jrate = nullptr;
+  json_bool jrate_exists = json_object_object_get_ex(serialized, DEEP_LEARNING_INFERENCE_RATE_FIELD, &jrate);
+  if (jrate_exists) {
+    res.SetInferenceRate(json_object_get_double(jrate));
+  }
+
+  json_object* jshared = nullptr;
+  json_bool jshared_exists = json_object_object_get_ex(serialized, DEEP_LEARNING_SHARED_FIELD, &jshared);
+  if (jshared_exists) {
+    res.SetShared(json_object_get_boolean(jshared));
+  }
+
+  json_object* jnotification_interval = nullptr;
+  json_bool jnotification_interval_exists =
+      json_object_object_get_ex(serialized, DEEP_LEARNING_NOTIFICATION_INTERVAL_FIELD, &jnotification_interval);
+  if (jnotification_interval_exists) {
+    res.SetNotificationInterval(json_object_get_int(jnotification_interval));
   }
 
   *this = res;
@@ -143,14 +327,24 @@ common::Error DeepLearning::SerializeFields(json_object* out) const {
   const std::string model_path_str = model_path_.GetPath();
   json_object_object_add(out, DEEP_LEARNING_MODEL_PATH_FIELD, json_object_new_string(model_path_str.c_str()));
 
-  json_object* jproperties = json_object_new_array();
-  for (size_t i = 0; i < properties_.size(); ++i) {
-    json_object* jproperty = json_object_new_object();
-    json_object_object_add(jproperty, properties_[i].property.c_str(),
-                           json_object_new_string(properties_[i].value.c_str()));
-    json_object_array_add(jproperties, jproperty);
+  json_object_object_add(out, DEEP_LEARNING_PROPERTIES_FIELD, json_make_properties(properties_));
+  if (!fallbacks_.empty()) {
+    json_object* jfallbacks = json_object_new_array();
+    for (const BackendModel& model : fallbacks_) {
+      json_object* jfallback = json_object_new_object();
+      const std::string fallback_model_path = model.model_path.GetPath();
+      json_object_object_add(jfallback, DEEP_LEARNING_BACKEND_FIELD, json_object_new_int64(model.backend));
+      json_object_object_add(jfallback, DEEP_LEARNING_MODEL_PATH_FIELD,
+                             json_object_new_string(fallback_model_path.c_str()));
+      json_object_object_add(jfallback, DEEP_LEARNING_PROPERTIES_FIELD, json_make_properties(model.properties));
+      json_object_array_add(jfallbacks, jfallback);
+    }
+    json_object_object_add(out, DEEP_LEARNING_FALLBACKS_FIELD, jfallbacks);
   }
-  json_object_object_add(out, DEEP_LEARNING_PROPERTIES_FIELD, jproperties);
+  json_object_object_add(out, DEEP_LEARNING_INFERENCE_INTERVAL_FIELD, json_object_new_int(inference_interval_));
+  json_object_object_add(out, DEEP_LEARNING_INFERENCE_RATE_FIELD, json_object_new_double(inference_rate_));
+  json_object_object_add(out, DEEP_LEARNING_SHARED_FIELD, json_object_new_boolean(shared_));
+  json_object_object_add(out, DEEP_LEARNING_NOTIFICATION_INTERVAL_FIELD, json_object_new_int(notification_interval_));
   return common::Error();
 }
 
@@ -31,10 +31,19 @@ struct BackendProperty {
   std::string value;
 };
 
+// backend with model built for it, e.g. int8 or fp16 engine of accelerator
+struct BackendModel {
+  fastoml::SupportedBackends backend;
+  common::file_system::ascii_file_string_path model_path;
+  std::vector<BackendProperty> properties;
+};
+
 class DeepLearning : public common::serializer::JsonSerializer<DeepLearning> {
  public:
+  enum { default_notification_interval_msec = 1000 };
   typedef common::file_system::ascii_file_string_path file_path_t;
   typedef std::vector<BackendProperty> properties_t;
+  typedef std::vector<BackendModel> backend_models_t;
 
   DeepLearning();
   DeepLearning(fastoml::SupportedBackends backend,
@@ -52,6 +61,24 @@ class DeepLearning : public common::serializer::JsonSerializer<DeepLearning> {
   file_path_t GetModelPath() const;
   void SetModelPath(const file_path_t& path);
 
+  backend_models_t GetFallbacks() const;  // tried in order if backend not available on node
+  void SetFallbacks(const backend_models_t& fallbacks);
+  backend_models_t GetBackendModels() const;  // configured backend first, then fallbacks
+
+  int GetInferenceInterval() const;  // infer every Nth frame, 1 - every frame
+  void SetInferenceInterval(int frames);
+
+  double GetInferenceRate() const;  // target inferences per second, 0 - frame interval only
+  void SetInferenceRate(double rate);
+
+  bool IsInferenceScheduled() const;  // frames skipped between inferences
+
+  bool IsShared() const;  // model served by inference worker of daemon, one per node
+  void SetShared(bool shared);
+
+  int GetNotificationInterval() const;  // msec, detections coalesced to daemon, 0 - every change
+  void SetNotificationInterval(int msec);
+
   static common::Optional<DeepLearning> MakeDeepLearning(common::HashValue* hash);
 
  protected:
@@ -62,6 +89,11 @@ class DeepLearning : public common::serializer::JsonSerializer<DeepLearning> {
   fastoml::SupportedBackends backend_;
   file_path_t model_path_;
   properties_t properties_;
+  backend_models_t fallbacks_;
+  int inference_interval_;
+  double inference_rate_;
+  bool shared_;
+  int notification_interval_;
 };
 
 }  // namespace machine_learning
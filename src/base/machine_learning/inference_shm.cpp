@@ -0,0 +1,266 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/machine_learning/inference_shm.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <common/sprintf.h>
+
+namespace fastocloud {
+namespace machine_learning {
+
+namespace {
+// answers not taken for so many requests belong to quitted stream
+const uint64_t kStaleRequests = INFERENCE_SHM_SLOTS * 4;
+
+bool ClaimSlot(InferenceSlotShm* slot, uint32_t from, uint32_t to) {
+  uint32_t expected = from;
+  return slot->state.compare_exchange_strong(expected, to, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+uint64_t Fnv1a(const std::string& data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+}  // namespace
+
+std::string MakeInferenceShmName(const DeepLearning& learning) {
+  const std::string key = common::MemSPrintf("%d:%s", static_cast<int>(learning.GetBackend()),
+                                             learning.GetModelPath().GetPath());
+  return common::MemSPrintf(INFERENCE_SHM_NAME_PREFIX "%016llx", static_cast<unsigned long long>(Fnv1a(key)));
+}
+
+common::ErrnoError CreateInferenceShm(const std::string& name, InferenceShm** shm) {
+  if (name.empty() || !shm) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  // truncate to zero first, so slots left by crashed daemon will be free
+  if (ftruncate(fd, 0) == ERROR_RESULT_VALUE || ftruncate(fd, sizeof(InferenceShm)) == ERROR_RESULT_VALUE) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    close(fd);
+    return err;
+  }
+
+  void* ptr = mmap(nullptr, sizeof(InferenceShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return common::make_errno_error(errno);
+  }
+
+  *shm = static_cast<InferenceShm*>(ptr);
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory inference not supported", ENOTSUP);
+#endif
+}
+
+common::ErrnoError OpenInferenceShm(const std::string& name, InferenceShm** shm) {
+  if (name.empty() || !shm) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  int fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  void* ptr = mmap(nullptr, sizeof(InferenceShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return common::make_errno_error(errno);
+  }
+
+  *shm = static_cast<InferenceShm*>(ptr);
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory inference not supported", ENOTSUP);
+#endif
+}
+
+common::ErrnoError CloseInferenceShm(InferenceShm* shm) {
+  if (!shm) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  if (munmap(shm, sizeof(InferenceShm)) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory inference not supported", ENOTSUP);
+#endif
+}
+
+common::ErrnoError UnlinkInferenceShm(const std::string& name) {
+  if (name.empty()) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  if (shm_unlink(name.c_str()) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory inference not supported", ENOTSUP);
+#endif
+}
+
+bool SubmitInferenceFrame(InferenceShm* shm, uint64_t client, const uint8_t* frame, size_t size) {
+  if (!shm || !frame || size != INFERENCE_SHM_FRAME_SIZE) {
+    return false;
+  }
+
+  const uint64_t requests = shm->requests.load(std::memory_order_relaxed);
+  InferenceSlotShm* claimed = nullptr;
+  for (size_t i = 0; i < INFERENCE_SHM_SLOTS && !claimed; ++i) {
+    InferenceSlotShm* slot = &shm->slots[i];
+    if (ClaimSlot(slot, INFERENCE_SLOT_FREE, INFERENCE_SLOT_WRITING)) {
+      claimed = slot;
+    }
+  }
+  for (size_t i = 0; i < INFERENCE_SHM_SLOTS && !claimed; ++i) {
+    InferenceSlotShm* slot = &shm->slots[i];
+    const bool stale = slot->sequence + kStaleRequests < requests;
+    if (stale && slot->state.load(std::memory_order_acquire) == INFERENCE_SLOT_DONE &&
+        ClaimSlot(slot, INFERENCE_SLOT_DONE, INFERENCE_SLOT_WRITING)) {
+      claimed = slot;
+    }
+  }
+
+  if (!claimed) {
+    shm->drops.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  claimed->client = client;
+  claimed->sequence = shm->requests.fetch_add(1, std::memory_order_relaxed);
+  claimed->boxes_count = 0;
+  memcpy(claimed->frame, frame, size);
+  claimed->state.store(INFERENCE_SLOT_PENDING, std::memory_order_release);
+  return true;
+}
+
+bool TakeInferenceResult(InferenceShm* shm, uint64_t client, std::vector<InferenceBoxShm>* boxes) {
+  if (!shm || !boxes) {
+    return false;
+  }
+
+  InferenceSlotShm* oldest = nullptr;
+  for (size_t i = 0; i < INFERENCE_SHM_SLOTS; ++i) {
+    InferenceSlotShm* slot = &shm->slots[i];
+    if (slot->state.load(std::memory_order_acquire) == INFERENCE_SLOT_DONE && slot->client == client &&
+        (!oldest || slot->sequence < oldest->sequence)) {
+      oldest = slot;
+    }
+  }
+
+  if (!oldest || !ClaimSlot(oldest, INFERENCE_SLOT_DONE, INFERENCE_SLOT_WRITING)) {
+    return false;
+  }
+
+  const uint32_t count = std::min(oldest->boxes_count, static_cast<uint32_t>(INFERENCE_SHM_MAX_BOXES));
+  boxes->assign(oldest->boxes, oldest->boxes + count);
+  oldest->state.store(INFERENCE_SLOT_FREE, std::memory_order_release);
+  return true;
+}
+
+void ReleaseInferenceSlots(InferenceShm* shm, uint64_t client) {
+  if (!shm) {
+    return;
+  }
+
+  for (size_t i = 0; i < INFERENCE_SHM_SLOTS; ++i) {
+    InferenceSlotShm* slot = &shm->slots[i];
+    if (slot->client != client) {
+      continue;
+    }
+    // busy slots are answered later and reclaimed as stale
+    if (!ClaimSlot(slot, INFERENCE_SLOT_PENDING, INFERENCE_SLOT_FREE)) {
+      ignore_result(ClaimSlot(slot, INFERENCE_SLOT_DONE, INFERENCE_SLOT_FREE));
+    }
+  }
+}
+
+size_t AcquireInferenceBatch(InferenceShm* shm, size_t* slots, size_t max) {
+  if (!shm || !slots || !max) {
+    return 0;
+  }
+
+  std::vector<size_t> pending;
+  for (size_t i = 0; i < INFERENCE_SHM_SLOTS; ++i) {
+    if (shm->slots[i].state.load(std::memory_order_acquire) == INFERENCE_SLOT_PENDING) {
+      pending.push_back(i);
+    }
+  }
+  std::sort(pending.begin(), pending.end(),
+            [shm](size_t lhs, size_t rhs) { return shm->slots[lhs].sequence < shm->slots[rhs].sequence; });
+
+  size_t count = 0;
+  for (size_t i = 0; i < pending.size() && count < max; ++i) {
+    if (ClaimSlot(&shm->slots[pending[i]], INFERENCE_SLOT_PENDING, INFERENCE_SLOT_BUSY)) {
+      slots[count++] = pending[i];
+    }
+  }
+  return count;
+}
+
+void CompleteInferenceSlot(InferenceShm* shm, size_t slot, const InferenceBoxShm* boxes, size_t count) {
+  if (!shm || slot >= INFERENCE_SHM_SLOTS) {
+    return;
+  }
+
+  InferenceSlotShm* answered = &shm->slots[slot];
+  const size_t boxes_count = boxes ? std::min(count, static_cast<size_t>(INFERENCE_SHM_MAX_BOXES)) : 0;
+  std::copy(boxes, boxes + boxes_count, answered->boxes);
+  answered->boxes_count = boxes_count;
+  answered->state.store(INFERENCE_SLOT_DONE, std::memory_order_release);
+}
+
+void ResetInferenceSlots(InferenceShm* shm) {
+  if (!shm) {
+    return;
+  }
+
+  for (size_t i = 0; i < INFERENCE_SHM_SLOTS; ++i) {
+    ignore_result(ClaimSlot(&shm->slots[i], INFERENCE_SLOT_BUSY, INFERENCE_SLOT_PENDING));
+  }
+}
+
+}  // namespace machine_learning
+}  // namespace fastocloud
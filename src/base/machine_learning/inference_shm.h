@@ -0,0 +1,91 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <common/error.h>
+
+#include "base/machine_learning/deep_learning.h"
+
+#define INFERENCE_SHM_NAME_PREFIX "/fastocloud_ml_"
+#define INFERENCE_SHM_SLOTS 16
+#define INFERENCE_SHM_FRAME_WIDTH 416  // tiny yolo input, frames scaled by streams
+#define INFERENCE_SHM_FRAME_HEIGHT 416
+#define INFERENCE_SHM_FRAME_SIZE (INFERENCE_SHM_FRAME_WIDTH * INFERENCE_SHM_FRAME_HEIGHT * 3)  // RGB
+#define INFERENCE_SHM_MAX_BOXES 32
+
+namespace fastocloud {
+namespace machine_learning {
+
+// slot owned by stream while FREE => WRITING => PENDING, by worker while BUSY => DONE, back to stream
+enum InferenceSlotState : uint32_t {
+  INFERENCE_SLOT_FREE = 0,
+  INFERENCE_SLOT_WRITING,
+  INFERENCE_SLOT_PENDING,
+  INFERENCE_SLOT_BUSY,
+  INFERENCE_SLOT_DONE
+};
+
+struct InferenceBoxShm {
+  int32_t label;
+  double prob;
+  double x;
+  double y;
+  double width;
+  double height;
+};
+
+struct InferenceSlotShm {
+  std::atomic<uint32_t> state;
+  uint64_t client;    // stream side id, results returned to it
+  uint64_t sequence;  // request order
+  uint32_t boxes_count;
+  InferenceBoxShm boxes[INFERENCE_SHM_MAX_BOXES];
+  uint8_t frame[INFERENCE_SHM_FRAME_SIZE];
+};
+
+// one segment per loaded model, created by daemon, served by one inference worker process
+struct InferenceShm {
+  std::atomic<uint64_t> requests;
+  std::atomic<uint64_t> drops;  // frames of streams found no free slot
+  InferenceSlotShm slots[INFERENCE_SHM_SLOTS];
+};
+
+// same model and backend gives same name, so streams of it share one worker
+std::string MakeInferenceShmName(const DeepLearning& learning);
+
+// daemon side, creates (or truncates) segment before worker started
+common::ErrnoError CreateInferenceShm(const std::string& name, InferenceShm** shm) WARN_UNUSED_RESULT;
+// stream and worker side
+common::ErrnoError OpenInferenceShm(const std::string& name, InferenceShm** shm) WARN_UNUSED_RESULT;
+common::ErrnoError CloseInferenceShm(InferenceShm* shm) WARN_UNUSED_RESULT;
+common::ErrnoError UnlinkInferenceShm(const std::string& name) WARN_UNUSED_RESULT;
+
+// stream side, false and counted as drop if all slots used
+bool SubmitInferenceFrame(InferenceShm* shm, uint64_t client, const uint8_t* frame, size_t size);
+// oldest answered request of client, slot freed
+bool TakeInferenceResult(InferenceShm* shm, uint64_t client, std::vector<InferenceBoxShm>* boxes);
+void ReleaseInferenceSlots(InferenceShm* shm, uint64_t client);  // requests of quitting stream
+
+// worker side, pending slots marked busy in request order, at most max
+size_t AcquireInferenceBatch(InferenceShm* shm, size_t* slots, size_t max);
+void CompleteInferenceSlot(InferenceShm* shm, size_t slot, const InferenceBoxShm* boxes, size_t count);
+void ResetInferenceSlots(InferenceShm* shm);  // worker (re)started, busy slots of previous one pending again
+
+}  // namespace machine_learning
+}  // namespace fastocloud
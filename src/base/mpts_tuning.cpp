@@ -0,0 +1,43 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/mpts_tuning.h"
+
+#include "base/config_fields.h"
+
+namespace fastocloud {
+
+MptsTuning::MptsTuning() : program(0) {}
+
+bool MptsTuning::IsEmpty() const {
+  return program == 0;
+}
+
+bool ReadMptsTuning(common::HashValue* hash, MptsTuning* tuning) {
+  if (!hash || !tuning) {
+    return false;
+  }
+
+  MptsTuning ltuning;
+  int program;
+  common::Value* program_field = hash->Find(MPTS_PROGRAM_FIELD);
+  if (program_field && program_field->GetAsInteger(&program) && program > 0 && program <= UINT16_MAX) {
+    ltuning.program = static_cast<uint16_t>(program);
+  }
+
+  *tuning = ltuning;
+  return true;
+}
+
+}  // namespace fastocloud
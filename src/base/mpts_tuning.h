@@ -0,0 +1,40 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+
+#include <common/value.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+
+// program of multi program ts input passed to stream, "mpts" hash of url entry
+struct MptsTuning {
+  MptsTuning();
+
+  bool IsEmpty() const;
+
+  uint16_t program;  // program_number of pat, 0 whole ts
+};
+
+typedef std::map<fastotv::channel_id_t, MptsTuning> mpts_tunings_t;
+
+bool ReadMptsTuning(common::HashValue* hash, MptsTuning* tuning);
+
+}  // namespace fastocloud
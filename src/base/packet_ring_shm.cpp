@@ -0,0 +1,174 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/packet_ring_shm.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include <common/sprintf.h>
+
+namespace fastocloud {
+
+std::string MakePacketRingShmName(const std::string& host, uint16_t port) {
+  return common::MemSPrintf(PACKET_RING_SHM_NAME_PREFIX "%s_%u", host.c_str(), port);
+}
+
+common::ErrnoError CreatePacketRingShm(const std::string& name, PacketRingShm** shm) {
+  if (name.empty() || !shm) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  // truncate to zero first, so readers left by crashed daemon start from empty ring
+  if (ftruncate(fd, 0) == ERROR_RESULT_VALUE || ftruncate(fd, sizeof(PacketRingShm)) == ERROR_RESULT_VALUE) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    close(fd);
+    return err;
+  }
+
+  void* ptr = mmap(nullptr, sizeof(PacketRingShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return common::make_errno_error(errno);
+  }
+
+  *shm = static_cast<PacketRingShm*>(ptr);
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory packet rings not supported", ENOTSUP);
+#endif
+}
+
+common::ErrnoError OpenPacketRingShm(const std::string& name, const PacketRingShm** shm) {
+  if (name.empty() || !shm) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  int fd = shm_open(name.c_str(), O_RDONLY, S_IRUSR | S_IWUSR);
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  void* ptr = mmap(nullptr, sizeof(PacketRingShm), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return common::make_errno_error(errno);
+  }
+
+  *shm = static_cast<const PacketRingShm*>(ptr);
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory packet rings not supported", ENOTSUP);
+#endif
+}
+
+common::ErrnoError ClosePacketRingShm(const PacketRingShm* shm) {
+  if (!shm) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  if (munmap(const_cast<PacketRingShm*>(shm), sizeof(PacketRingShm)) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory packet rings not supported", ENOTSUP);
+#endif
+}
+
+common::ErrnoError UnlinkPacketRingShm(const std::string& name) {
+  if (name.empty()) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  if (shm_unlink(name.c_str()) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory packet rings not supported", ENOTSUP);
+#endif
+}
+
+void WritePacketRing(PacketRingShm* shm, const uint8_t* data, size_t size) {
+  const uint64_t number = shm->written.load(std::memory_order_relaxed);
+  PacketSlotShm* slot = &shm->slots[number % PACKET_RING_SHM_SLOTS];
+  if (size > PACKET_RING_SHM_SLOT_SIZE) {
+    size = PACKET_RING_SHM_SLOT_SIZE;
+    shm->truncated.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  slot->sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->size = static_cast<uint32_t>(size);
+  memcpy(slot->data, data, size);
+  slot->sequence.store(number + 1, std::memory_order_release);
+  shm->written.store(number + 1, std::memory_order_release);
+}
+
+uint64_t GetPacketRingPosition(const PacketRingShm* shm) {
+  return shm->written.load(std::memory_order_acquire);
+}
+
+PacketRingRead ReadPacketRing(const PacketRingShm* shm, uint64_t* position, uint8_t* out, size_t* size) {
+  const uint64_t written = shm->written.load(std::memory_order_acquire);
+  const uint64_t number = *position;
+  if (number >= written) {
+    *position = written;  // ring recreated by restarted daemon
+    return PACKET_RING_EMPTY;
+  }
+
+  const uint64_t resync = written > PACKET_RING_SHM_SLOTS / 2 ? written - PACKET_RING_SHM_SLOTS / 2 : 0;
+  if (written - number > PACKET_RING_SHM_SLOTS) {
+    *position = resync;
+    return PACKET_RING_OVERRUN;
+  }
+
+  const PacketSlotShm* slot = &shm->slots[number % PACKET_RING_SHM_SLOTS];
+  if (slot->sequence.load(std::memory_order_acquire) != number + 1) {
+    *position = resync;  // overwritten while we looked
+    return PACKET_RING_OVERRUN;
+  }
+
+  const size_t lsize = std::min<size_t>(slot->size, PACKET_RING_SHM_SLOT_SIZE);
+  memcpy(out, slot->data, lsize);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot->sequence.load(std::memory_order_relaxed) != number + 1) {
+    *position = resync;
+    return PACKET_RING_OVERRUN;
+  }
+
+  *size = lsize;
+  *position = number + 1;
+  return PACKET_RING_PACKET;
+}
+
+}  // namespace fastocloud
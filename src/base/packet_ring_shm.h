@@ -0,0 +1,63 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+#include <common/error.h>
+
+#define PACKET_RING_SHM_NAME_PREFIX "/fastocloud_pkt_"
+#define PACKET_RING_SHM_SLOTS 4096     // ~4 seconds of 10 mbit ts in 7x188 datagrams
+#define PACKET_RING_SHM_SLOT_SIZE 2048  // longer datagrams truncated
+
+namespace fastocloud {
+
+enum PacketRingRead { PACKET_RING_EMPTY = 0, PACKET_RING_PACKET, PACKET_RING_OVERRUN };
+
+struct PacketSlotShm {
+  std::atomic<uint64_t> sequence;  // number of packet in slot + 1, 0 while written
+  uint32_t size;
+  uint8_t data[PACKET_RING_SHM_SLOT_SIZE];
+};
+
+// datagrams of one udp group and port, written by packet ingest of daemon, read by any number of streams
+struct PacketRingShm {
+  std::atomic<uint64_t> written;  // packets since segment created
+  std::atomic<uint64_t> truncated;
+  PacketSlotShm slots[PACKET_RING_SHM_SLOTS];
+};
+
+// same group and port gives same name in daemon and streams
+std::string MakePacketRingShmName(const std::string& host, uint16_t port);
+
+// daemon side, creates (or truncates) segment read and written
+common::ErrnoError CreatePacketRingShm(const std::string& name, PacketRingShm** shm) WARN_UNUSED_RESULT;
+// stream side, mapped read only
+common::ErrnoError OpenPacketRingShm(const std::string& name, const PacketRingShm** shm) WARN_UNUSED_RESULT;
+common::ErrnoError ClosePacketRingShm(const PacketRingShm* shm) WARN_UNUSED_RESULT;
+common::ErrnoError UnlinkPacketRingShm(const std::string& name) WARN_UNUSED_RESULT;
+
+// single writer, slot reused without waiting for readers
+void WritePacketRing(PacketRingShm* shm, const uint8_t* data, size_t size);
+// position of next packet written, readers start here
+uint64_t GetPacketRingPosition(const PacketRingShm* shm);
+// packet at position copied to out of PACKET_RING_SHM_SLOT_SIZE and position advanced;
+// if reader lapped by writer position moved to oldest half of ring and nothing copied
+PacketRingRead ReadPacketRing(const PacketRingShm* shm, uint64_t* position, uint8_t* out, size_t* size);
+
+}  // namespace fastocloud
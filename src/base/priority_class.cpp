@@ -0,0 +1,90 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/priority_class.h"
+
+#if defined(OS_LINUX)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <common/macros.h>
+
+#if defined(OS_LINUX)
+#define IOPRIO_CLASS_SHIFT 13
+#define IOPRIO_WHO_PROCESS 1
+#define IOPRIO_PRIO_VALUE(klass, data) (((klass) << IOPRIO_CLASS_SHIFT) | (data))
+#else
+#define SCHED_OTHER 0
+#define SCHED_BATCH 3
+#define SCHED_IDLE 5
+#endif
+
+#define IOPRIO_CLASS_BE 2
+#define IOPRIO_CLASS_IDLE 3
+
+namespace fastocloud {
+
+namespace {
+const PriorityTraits kPriorityTraits[] = {
+    {0, SCHED_OTHER, IOPRIO_CLASS_BE, 0, 200},   // LIVE_PRIORITY
+    {0, SCHED_OTHER, IOPRIO_CLASS_BE, 4, 100},   // NORMAL_PRIORITY, as forked from daemon
+    {10, SCHED_BATCH, IOPRIO_CLASS_BE, 7, 25},   // BATCH_PRIORITY
+    {19, SCHED_IDLE, IOPRIO_CLASS_IDLE, 0, 1}};  // IDLE_PRIORITY
+}  // namespace
+
+bool IsValidPriorityClass(int cls) {
+  return cls >= LIVE_PRIORITY && cls <= IDLE_PRIORITY;
+}
+
+PriorityClass GetDefaultPriorityClass(fastotv::StreamType type) {
+  if (type == fastotv::VOD_ENCODE || type == fastotv::VOD_RELAY) {
+    return BATCH_PRIORITY;
+  }
+  if (type == fastotv::TEST_LIFE) {
+    return NORMAL_PRIORITY;
+  }
+  return LIVE_PRIORITY;
+}
+
+PriorityTraits GetPriorityTraits(PriorityClass cls) {
+  if (!IsValidPriorityClass(cls)) {
+    return kPriorityTraits[NORMAL_PRIORITY];
+  }
+  return kPriorityTraits[cls];
+}
+
+bool ApplyPriorityClass(PriorityClass cls) {
+#if defined(OS_LINUX)
+  const PriorityTraits traits = GetPriorityTraits(cls);
+  bool applied = true;
+  if (traits.sched_policy != SCHED_OTHER) {
+    struct sched_param param = {0};
+    applied &= sched_setscheduler(0, traits.sched_policy, &param) == 0;
+  }
+  if (traits.nice) {
+    applied &= setpriority(PRIO_PROCESS, 0, traits.nice) == 0;
+  }
+  const int ioprio = IOPRIO_PRIO_VALUE(traits.io_class, traits.io_level);
+  applied &= syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, ioprio) == 0;
+  return applied;
+#else
+  UNUSED(cls);
+  return false;
+#endif
+}
+
+}  // namespace fastocloud
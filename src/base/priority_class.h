@@ -0,0 +1,39 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+
+// scheduling of stream children, batch vod transcodes yield cpu and disk to live channels
+enum PriorityClass { LIVE_PRIORITY = 0, NORMAL_PRIORITY = 1, BATCH_PRIORITY = 2, IDLE_PRIORITY = 3 };
+
+struct PriorityTraits {
+  int nice;
+  int sched_policy;   // SCHED_OTHER, SCHED_BATCH or SCHED_IDLE
+  int io_class;       // ioprio class, 2 best effort, 3 idle
+  int io_level;       // 0 highest .. 7 lowest, best effort only
+  int cgroup_weight;  // cpu.weight and io.weight, 100 cgroup default
+};
+
+bool IsValidPriorityClass(int cls);
+PriorityClass GetDefaultPriorityClass(fastotv::StreamType type);  // vods batch, everything watched live
+PriorityTraits GetPriorityTraits(PriorityClass cls);
+
+// calling process, before threads started so all of them inherit, false if some part refused, linux only
+bool ApplyPriorityClass(PriorityClass cls);
+
+}  // namespace fastocloud
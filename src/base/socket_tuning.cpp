@@ -0,0 +1,65 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/socket_tuning.h"
+
+#include "base/config_fields.h"
+
+namespace fastocloud {
+
+SocketTuning::SocketTuning() : receive_buffer(0), send_buffer(0), dscp(-1), multicast_iface() {}
+
+bool SocketTuning::IsEmpty() const {
+  return receive_buffer == 0 && send_buffer == 0 && !HaveDscp() && multicast_iface.empty();
+}
+
+bool SocketTuning::HaveDscp() const {
+  return dscp >= 0;
+}
+
+bool ReadSocketTuning(common::HashValue* hash, SocketTuning* tuning) {
+  if (!hash || !tuning) {
+    return false;
+  }
+
+  SocketTuning ltuning;
+  int receive_buffer;
+  common::Value* receive_buffer_field = hash->Find(SOCKET_RECEIVE_BUFFER_FIELD);
+  if (receive_buffer_field && receive_buffer_field->GetAsInteger(&receive_buffer) && receive_buffer > 0) {
+    ltuning.receive_buffer = receive_buffer;
+  }
+
+  int send_buffer;
+  common::Value* send_buffer_field = hash->Find(SOCKET_SEND_BUFFER_FIELD);
+  if (send_buffer_field && send_buffer_field->GetAsInteger(&send_buffer) && send_buffer > 0) {
+    ltuning.send_buffer = send_buffer;
+  }
+
+  int dscp;
+  common::Value* dscp_field = hash->Find(SOCKET_DSCP_FIELD);
+  if (dscp_field && dscp_field->GetAsInteger(&dscp) && dscp >= 0 && dscp < 64) {
+    ltuning.dscp = dscp;
+  }
+
+  std::string multicast_iface;
+  common::Value* multicast_iface_field = hash->Find(SOCKET_MULTICAST_IFACE_FIELD);
+  if (multicast_iface_field && multicast_iface_field->GetAsBasicString(&multicast_iface)) {
+    ltuning.multicast_iface = multicast_iface;
+  }
+
+  *tuning = ltuning;
+  return true;
+}
+
+}  // namespace fastocloud
@@ -0,0 +1,43 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <common/value.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+
+// kernel socket options of udp input or output, "socket" hash of url entry
+struct SocketTuning {
+  SocketTuning();
+
+  bool IsEmpty() const;
+  bool HaveDscp() const;
+
+  int receive_buffer;           // SO_RCVBUF bytes, 0 for default
+  int send_buffer;              // SO_SNDBUF bytes, 0 for default
+  int dscp;                     // 0 - 63, -1 not set
+  std::string multicast_iface;  // interface name, empty for default
+};
+
+typedef std::map<fastotv::channel_id_t, SocketTuning> socket_tunings_t;
+
+bool ReadSocketTuning(common::HashValue* hash, SocketTuning* tuning);
+
+}  // namespace fastocloud
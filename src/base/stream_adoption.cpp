@@ -0,0 +1,169 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/stream_adoption.h"
+
+#if defined(OS_POSIX)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace fastocloud {
+
+#if defined(OS_POSIX)
+namespace {
+
+common::ErrnoError MakeAdoptAddress(const std::string& path, struct sockaddr_un* addr) {
+  if (path.empty() || path.size() >= sizeof(addr->sun_path)) {
+    return common::make_errno_error("Adopt socket path is empty or too long: " + path, ENAMETOOLONG);
+  }
+
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  memcpy(addr->sun_path, path.c_str(), path.size());
+  return common::ErrnoError();
+}
+
+}  // namespace
+
+common::ErrnoError ListenAdoptSocket(const std::string& path, common::net::socket_descr_t* sock) {
+  if (!sock) {
+    return common::make_errno_error_inval();
+  }
+
+  struct sockaddr_un addr;
+  common::ErrnoError err = MakeAdoptAddress(path, &addr);
+  if (err) {
+    return err;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  unlink(path.c_str());  // left by killed process of previous start
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == ERROR_RESULT_VALUE ||
+      listen(fd, 1) == ERROR_RESULT_VALUE) {
+    err = common::make_errno_error(errno);
+    close(fd);
+    return err;
+  }
+
+  *sock = fd;
+  return common::ErrnoError();
+}
+
+common::ErrnoError ConnectAdoptSocket(const std::string& path, common::net::socket_descr_t* sock) {
+  if (!sock) {
+    return common::make_errno_error_inval();
+  }
+
+  struct sockaddr_un addr;
+  common::ErrnoError err = MakeAdoptAddress(path, &addr);
+  if (err) {
+    return err;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  while (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == ERROR_RESULT_VALUE) {
+    if (errno != EINTR) {
+      err = common::make_errno_error(errno);
+      close(fd);
+      return err;
+    }
+  }
+
+  *sock = fd;
+  return common::ErrnoError();
+}
+
+common::ErrnoError SendAdoptMessage(common::net::socket_descr_t sock, const AdoptMessage& msg, const int* fds) {
+  struct iovec iov;
+  iov.iov_base = const_cast<AdoptMessage*>(&msg);
+  iov.iov_len = sizeof(msg);
+
+  char control[CMSG_SPACE(sizeof(int) * 2)] = {0};
+  struct msghdr hdr = {};
+  hdr.msg_iov = &iov;
+  hdr.msg_iovlen = 1;
+  if (fds) {
+    hdr.msg_control = control;
+    hdr.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * 2);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * 2);
+  }
+
+  while (sendmsg(sock, &hdr, MSG_NOSIGNAL) == ERROR_RESULT_VALUE) {
+    if (errno != EINTR) {
+      return common::make_errno_error(errno);
+    }
+  }
+  return common::ErrnoError();
+}
+
+common::ErrnoError ReceiveAdoptMessage(common::net::socket_descr_t sock, AdoptMessage* msg, int fds[2]) {
+  if (!msg || !fds) {
+    return common::make_errno_error_inval();
+  }
+
+  fds[0] = INVALID_DESCRIPTOR;
+  fds[1] = INVALID_DESCRIPTOR;
+  struct iovec iov;
+  iov.iov_base = msg;
+  iov.iov_len = sizeof(*msg);
+
+  char control[CMSG_SPACE(sizeof(int) * 2)] = {0};
+  struct msghdr hdr = {};
+  hdr.msg_iov = &iov;
+  hdr.msg_iovlen = 1;
+  hdr.msg_control = control;
+  hdr.msg_controllen = sizeof(control);
+
+  ssize_t res;
+  while ((res = recvmsg(sock, &hdr, MSG_WAITALL | MSG_CMSG_CLOEXEC)) == ERROR_RESULT_VALUE) {
+    if (errno != EINTR) {
+      return common::make_errno_error(errno);
+    }
+  }
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+  if (cmsg && cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len == CMSG_LEN(sizeof(int) * 2)) {
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * 2);
+  }
+
+  if (res != sizeof(*msg)) {
+    for (int i = 0; i < 2; ++i) {
+      if (fds[i] != INVALID_DESCRIPTOR) {
+        close(fds[i]);
+        fds[i] = INVALID_DESCRIPTOR;
+      }
+    }
+    return common::make_errno_error("Adopt socket closed", ECONNRESET);
+  }
+  return common::ErrnoError();
+}
+#endif
+
+}  // namespace fastocloud
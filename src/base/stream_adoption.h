@@ -0,0 +1,46 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <common/error.h>
+#include <common/net/socket_info.h>
+
+namespace fastocloud {
+
+#if defined(OS_POSIX)
+// daemon side ends of command pipes parked in stream process over restart of service, claimed by next daemon
+enum AdoptCommand : uint32_t { ADOPT_PARK = 1, ADOPT_CLAIM = 2 };
+
+struct AdoptMessage {
+  uint32_t command;
+  int32_t error;  // errno of refused command, 0 if done
+};
+
+common::ErrnoError ListenAdoptSocket(const std::string& path, common::net::socket_descr_t* sock) WARN_UNUSED_RESULT;
+common::ErrnoError ConnectAdoptSocket(const std::string& path, common::net::socket_descr_t* sock) WARN_UNUSED_RESULT;
+
+// fds nullptr if message without descriptors
+common::ErrnoError SendAdoptMessage(common::net::socket_descr_t sock,
+                                    const AdoptMessage& msg,
+                                    const int* fds) WARN_UNUSED_RESULT;
+// fds set to invalid descriptors if message without them
+common::ErrnoError ReceiveAdoptMessage(common::net::socket_descr_t sock,
+                                       AdoptMessage* msg,
+                                       int fds[2]) WARN_UNUSED_RESULT;
+#endif
+
+}  // namespace fastocloud
@@ -16,6 +16,8 @@
 
 #include <string>
 
+#include <common/convert2string.h>
+#include <common/file_system/file_system.h>
 #include <common/uri/url.h>
 
 #include "base/config_fields.h"
@@ -34,6 +36,21 @@ fastotv::stream_id_t GetSid(const StreamConfig& config_args) {
   return sid;
 }
 
+bool IsAudioOnlyStream(const StreamConfig& config_args) {
+  bool have_video = true;
+  common::Value* have_video_field = config_args->Find(HAVE_VIDEO_FIELD);
+  if (!have_video_field || !have_video_field->GetAsBoolean(&have_video) || have_video) {
+    return false;
+  }
+
+  bool have_audio = true;
+  common::Value* have_audio_field = config_args->Find(HAVE_AUDIO_FIELD);
+  if (have_audio_field && have_audio_field->GetAsBoolean(&have_audio)) {
+    return have_audio;
+  }
+  return true;
+}
+
 common::ErrnoError MakeStreamInfo(const StreamConfig& config_args,
                                   bool check_folders,
                                   StreamInfo* sha,
@@ -100,12 +117,23 @@ common::ErrnoError MakeStreamInfo(const StreamConfig& config_args,
         return common::make_errno_error("Define " OUTPUT_FIELD " variable and make it valid", EAGAIN);
       }
 
+      std::string hls_ram_dir;
+      common::Value* hls_ram_dir_field = config_args->Find(HLS_RAM_DIR_FIELD);
+      const bool is_live = type != fastotv::VOD_RELAY && type != fastotv::VOD_ENCODE;
+      const bool use_ram = is_live && hls_ram_dir_field && hls_ram_dir_field->GetAsBasicString(&hls_ram_dir) &&
+                           !hls_ram_dir.empty();
       for (auto out_uri : output) {
         common::uri::Url ouri = out_uri.GetOutput();
         if (ouri.GetScheme() == common::uri::Url::http) {
           const common::file_system::ascii_directory_string_path http_root = out_uri.GetHttpRoot();
           const std::string http_root_str = http_root.GetPath();
-          common::ErrnoError errn = CreateAndCheckDir(http_root_str);
+          common::ErrnoError errn;
+          if (use_ram) {
+            const std::string ram_name = lsha.id + "_" + common::ConvertToString(out_uri.GetID());
+            errn = CreateRamBackedDir(http_root_str, common::file_system::make_path(hls_ram_dir, ram_name));
+          } else {
+            errn = CreateAndCheckDir(http_root_str);
+          }
           if (errn) {
             return errn;
           }
@@ -26,6 +26,7 @@ namespace fastocloud {
 typedef std::shared_ptr<common::HashValue> StreamConfig;
 
 fastotv::stream_id_t GetSid(const StreamConfig& config_args);
+bool IsAudioOnlyStream(const StreamConfig& config_args);  // have_video off, have_audio on or unset, radio
 
 common::ErrnoError MakeStreamInfo(const StreamConfig& config_args,
                                   bool check_folders,
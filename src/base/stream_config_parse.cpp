@@ -14,12 +14,38 @@
 
 #include "base/stream_config_parse.h"
 
+#include <stdint.h>
+
 #include <string>
 
 #include <json-c/json_tokener.h>
 #include <json-c/linkhash.h>
 
 namespace {
+class ThreadTokener {
+ public:
+  ThreadTokener() : tok_(json_tokener_new()) {}
+  ~ThreadTokener() {
+    if (tok_) {
+      json_tokener_free(tok_);
+    }
+  }
+
+  json_tokener* Get() const { return tok_; }
+
+ private:
+  json_tokener* tok_;
+};
+
+// utc seconds and other values out of int range kept whole as time
+common::Value* MakeIntegerValue(json_object* obj) {
+  const int64_t value = json_object_get_int64(obj);
+  if (value < INT32_MIN || value > INT32_MAX) {
+    return common::Value::CreateTimeValue(static_cast<time_t>(value));
+  }
+  return common::Value::CreateIntegerValue(static_cast<int>(value));
+}
+
 common::Value* MakeValueFromJson(json_object* obj) {
   json_type obj_type = json_object_get_type(obj);
   if (obj_type == json_type_null) {
@@ -29,7 +55,7 @@ common::Value* MakeValueFromJson(json_object* obj) {
   } else if (obj_type == json_type_double) {
     return common::Value::CreateDoubleValue(json_object_get_double(obj));
   } else if (obj_type == json_type_int) {
-    return common::Value::CreateIntegerValue(json_object_get_int(obj));
+    return MakeIntegerValue(obj);
   } else if (obj_type == json_type_string) {
     return common::Value::CreateStringValueFromBasicString(json_object_get_string(obj));
   } else if (obj_type == json_type_object) {
@@ -48,7 +74,7 @@ common::Value* MakeValueFromJson(json_object* obj) {
           value = common::Value::CreateDoubleValue(json_object_get_double(val));
           break;
         case json_type_int:
-          value = common::Value::CreateIntegerValue(json_object_get_int(val));
+          value = MakeIntegerValue(val);
           break;
         case json_type_string:
           value = common::Value::CreateStringValueFromBasicString(json_object_get_string(val));
@@ -101,6 +127,11 @@ json_object* MakeJson(const common::Value* value) {
     if (value->GetAsInteger(&rint)) {
       return json_object_new_int(rint);
     }
+  } else if (type == common::Value::TYPE_TIME) {
+    time_t rtime;
+    if (value->GetAsTime(&rtime)) {
+      return json_object_new_int64(rtime);
+    }
   } else if (type == common::Value::TYPE_STRING) {
     common::Value::string_t rstring;
     if (value->GetAsString(&rstring)) {
@@ -142,12 +173,31 @@ json_object* MakeJson(const common::Value* value) {
 
 namespace fastocloud {
 
+json_object* ParseJson(const std::string& json) {
+  static thread_local ThreadTokener holder;
+  json_tokener* tok = holder.Get();
+  if (!tok || json.size() >= INT32_MAX) {
+    return json_tokener_parse(json.c_str());
+  }
+
+  json_tokener_reset(tok);
+  // terminating nul included, ends top level numbers like json_tokener_parse
+  json_object* obj = json_tokener_parse_ex(tok, json.c_str(), static_cast<int>(json.size() + 1));
+  if (json_tokener_get_error(tok) != json_tokener_success) {
+    if (obj) {
+      json_object_put(obj);
+    }
+    return nullptr;
+  }
+  return obj;
+}
+
 std::unique_ptr<common::HashValue> MakeConfigFromJson(const std::string& json) {
   if (json.empty()) {
     return nullptr;
   }
 
-  json_object* obj = json_tokener_parse(json.c_str());
+  json_object* obj = ParseJson(json);
   if (!obj) {
     return nullptr;
   }
@@ -166,6 +216,15 @@ std::unique_ptr<common::HashValue> MakeConfigFromJson(json_object* obj) {
   return nullptr;
 }
 
+bool GetTimeFromValue(const common::Value* value, time_t* time) {
+  int small;
+  if (value->GetAsInteger(&small)) {
+    *time = small;
+    return true;
+  }
+  return value->GetAsTime(time);
+}
+
 bool MakeJsonFromConfig(std::shared_ptr<common::HashValue> config, std::string* json) {
   if (!config || !json) {
     return false;
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <time.h>
+
 #include <string>
 
 #include <common/value.h>
@@ -22,9 +24,15 @@ struct json_object;
 
 namespace fastocloud {
 
+// nullptr if not json, tokener and its buffers reused by calls of same thread, parsed without strlen
+json_object* ParseJson(const std::string& json);
+
 std::unique_ptr<common::HashValue> MakeConfigFromJson(const std::string& json);
 std::unique_ptr<common::HashValue> MakeConfigFromJson(json_object* obj);
 
+// integer field read whole, utc seconds of json beyond int range parsed as time values
+bool GetTimeFromValue(const common::Value* value, time_t* time);
+
 bool MakeJsonFromConfig(std::shared_ptr<common::HashValue> config, std::string* json);
 
 }  // namespace fastocloud
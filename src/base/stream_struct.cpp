@@ -24,12 +24,22 @@ namespace common {
 
 std::string ConvertToString(fastocloud::StreamStatus st) {
   static const std::string kStreamStatuses[] = {
-      "New", "Inited", "Started", "Ready", "Playing", "Frozen", "Waiting",
+      "New", "Inited", "Started", "Ready", "Playing", "Frozen", "Waiting", "Quarantined",
   };
 
   return kStreamStatuses[st];
 }
 
+std::string ConvertToString(fastocloud::StartupStage stage) {
+  static const std::string kStartupStages[] = {"request",  "fork",        "exec",        "init",
+                                               "pipeline", "first_input", "first_output"};
+  if (stage >= fastocloud::STARTUP_STAGES_COUNT) {
+    return std::string();
+  }
+
+  return kStartupStages[stage];
+}
+
 }  // namespace common
 
 namespace fastocloud {
@@ -78,7 +88,25 @@ StreamStruct::StreamStruct(fastotv::stream_id_t sid,
       restarts(rest),
       status(status),
       input(input),
-      output(output) {}
+      output(output),
+      latency(),
+      timer_lag(0),
+      audio_rms(AUDIO_LEVEL_MIN_DB),
+      audio_peak(AUDIO_LEVEL_MIN_DB),
+      audio_silence(0),
+      audio_loudness(AUDIO_LEVEL_MIN_DB),
+      audio_loudness_integrated(AUDIO_LEVEL_MIN_DB),
+      video_black(0),
+      video_freeze(0),
+      queue_fill(0),
+      queue_time(0),
+      qos_events(0),
+      qos_dropped(0),
+      gst_memory(0),
+      heap_memory(0),
+      ml_backend(-1),
+      progress(-1),
+      startup() {}
 
 bool StreamStruct::IsValid() const {
   return !id.empty();
@@ -14,19 +14,34 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 
 #include <common/macros.h>
 
 #include "base/channel_stats.h"
+#include "base/latency_histogram.h"
 #include "base/types.h"
 
 #include "base/stream_info.h"
 
 namespace fastocloud {
 
-enum StreamStatus { NEW = 0, INIT = 1, STARTED = 2, READY = 3, PLAYING = 4, FROZEN = 5, WAITING = 6 };
+enum StreamStatus { NEW = 0, INIT = 1, STARTED = 2, READY = 3, PLAYING = 4, FROZEN = 5, WAITING = 6, QUARANTINED = 7 };
+
+enum StartupStage {
+  REQUEST_STARTUP_STAGE = 0,   // start request received by daemon
+  FORK_STARTUP_STAGE,          // stream process or relay host thread requested by daemon
+  EXEC_STARTUP_STAGE,          // stream_exec entered
+  INIT_STARTUP_STAGE,          // stream controller inited
+  PIPELINE_STARTUP_STAGE,      // pipeline created
+  FIRST_INPUT_STARTUP_STAGE,   // first buffer of input probe
+  FIRST_OUTPUT_STARTUP_STAGE,  // first buffer of output probe
+  STARTUP_STAGES_COUNT
+};
+
+typedef std::array<fastotv::timestamp_t, STARTUP_STAGES_COUNT> startup_timing_t;  // utc msec, 0 - not reached
 
 struct StreamStruct {
   StreamStruct();
@@ -58,10 +73,29 @@ struct StreamStruct {
 
   input_channels_info_t input;
   output_channels_info_t output;
+  latency_histograms_t latency;  // collected only if latency_stats enabled
+  fastotv::timestamp_t timer_lag;  // msec, delay of last main loop timer tick
+  int audio_rms;                     // dBFS of loudest decoded audio channel, AUDIO_LEVEL_MIN_DB if not measured
+  int audio_peak;                    // dBFS
+  fastotv::timestamp_t audio_silence;  // msec, decoded audio below -60 dBFS for
+  double audio_loudness;               // LUFS, ebu r128 momentary loudness of decoded audio
+  double audio_loudness_integrated;    // LUFS, since audio format set
+  fastotv::timestamp_t video_black;    // msec, decoded video black for
+  fastotv::timestamp_t video_freeze;   // msec, decoded video not changed for
+  int queue_fill;                      // percent, most filled queue of pipeline at last tick
+  fastotv::timestamp_t queue_time;     // msec, longest buffered time of pipeline queues at last tick
+  uint64_t qos_events;                 // qos messages of pipeline elements, total
+  uint64_t qos_dropped;                // buffers dropped by elements for qos, total
+  uint64_t gst_memory;                 // bytes of live buffers, 0 if memory accounting not enabled
+  uint64_t heap_memory;                // bytes in use by malloc of stream process
+  int ml_backend;                      // fastoml backend of in-process inference, -1 if none
+  int progress;                        // percent of vod input by pipeline position, -1 if not known
+  startup_timing_t startup;            // first start of stream, restarts not counted
 };
 
 }  // namespace fastocloud
 
 namespace common {
 std::string ConvertToString(fastocloud::StreamStatus st);
+std::string ConvertToString(fastocloud::StartupStage stage);
 }
@@ -0,0 +1,263 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/stream_struct_shm.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <ctype.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace fastocloud {
+
+namespace {
+const int kMaxReadAttempts = 16;
+
+void WriteChannels(const std::vector<ChannelStats>& channels, ChannelStatsShm* out, uint32_t* count) {
+  const size_t size = std::min(channels.size(), static_cast<size_t>(STREAM_SHM_MAX_CHANNELS));
+  for (size_t i = 0; i < size; ++i) {
+    const ChannelStats& chan = channels[i];
+    out[i].id = chan.GetID();
+    out[i].last_update_time = chan.GetLastUpdateTime();
+    out[i].total_bytes = chan.GetTotalBytes();
+    out[i].total_packets = chan.GetTotalPackets();
+    out[i].total_drops = chan.GetTotalDrops();
+    out[i].peers_count = chan.GetPeersCount();
+    for (uint32_t j = 0; j < out[i].peers_count; ++j) {
+      out[i].peers[j] = chan.GetPeer(j);
+    }
+    out[i].prev_total_bytes = chan.GetPrevTotalBytes();
+    out[i].bytes_per_second = chan.GetBps();
+  }
+  *count = size;
+}
+
+std::vector<ChannelStats> ReadChannels(const ChannelStatsShm* in, uint32_t count) {
+  std::vector<ChannelStats> channels;
+  for (uint32_t i = 0; i < count && i < STREAM_SHM_MAX_CHANNELS; ++i) {
+    ChannelStats chan(in[i].id);
+    chan.SetTotalBytes(in[i].total_bytes);
+    chan.SetTotalPackets(in[i].total_packets);
+    chan.SetTotalDrops(in[i].total_drops);
+    chan.SetPeers(in[i].peers, in[i].peers_count);
+    chan.SetLastUpdateTime(in[i].last_update_time);
+    chan.SetPrevTotalBytes(in[i].prev_total_bytes);
+    chan.SetBps(in[i].bytes_per_second);
+    channels.push_back(chan);
+  }
+  return channels;
+}
+}  // namespace
+
+std::string MakeStreamShmName(const fastotv::stream_id_t& sid) {
+  std::string name = STREAM_SHM_NAME_PREFIX;
+  for (char c : sid) {
+    name += isalnum(static_cast<unsigned char>(c)) ? c : '_';
+  }
+  return name;
+}
+
+common::ErrnoError CreateStreamShm(const std::string& name, StreamStructShm** shm) {
+  if (name.empty() || !shm) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  // truncate to zero first, so segment left by crashed process will be zeroed
+  if (ftruncate(fd, 0) == ERROR_RESULT_VALUE || ftruncate(fd, sizeof(StreamStructShm)) == ERROR_RESULT_VALUE) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    close(fd);
+    return err;
+  }
+
+  void* ptr = mmap(nullptr, sizeof(StreamStructShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return common::make_errno_error(errno);
+  }
+
+  *shm = static_cast<StreamStructShm*>(ptr);
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory stats not supported", ENOTSUP);
+#endif
+}
+
+common::ErrnoError OpenStreamShm(const std::string& name, StreamStructShm** shm) {
+  if (name.empty() || !shm) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  int fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  void* ptr = mmap(nullptr, sizeof(StreamStructShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    return common::make_errno_error(errno);
+  }
+
+  *shm = static_cast<StreamStructShm*>(ptr);
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory stats not supported", ENOTSUP);
+#endif
+}
+
+common::ErrnoError CloseStreamShm(StreamStructShm* shm) {
+  if (!shm) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  if (munmap(shm, sizeof(StreamStructShm)) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory stats not supported", ENOTSUP);
+#endif
+}
+
+common::ErrnoError UnlinkStreamShm(const std::string& name) {
+  if (name.empty()) {
+    return common::make_errno_error_inval();
+  }
+
+#if defined(OS_POSIX)
+  if (shm_unlink(name.c_str()) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Shared memory stats not supported", ENOTSUP);
+#endif
+}
+
+void WriteStreamStructShm(const StreamStruct& stats, StreamStructShm* shm) {
+  if (!shm) {
+    return;
+  }
+
+  const uint32_t seq = shm->sequence.load(std::memory_order_relaxed);
+  shm->sequence.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const size_t id_size = std::min(stats.id.size(), static_cast<size_t>(STREAM_SHM_MAX_ID_SIZE - 1));
+  memcpy(shm->id, stats.id.data(), id_size);
+  shm->id[id_size] = 0;
+  shm->type = stats.type;
+  shm->status = stats.status;
+  shm->start_time = stats.start_time;
+  shm->loop_start_time = stats.loop_start_time;
+  shm->idle_time = stats.idle_time;
+  shm->restarts = stats.restarts;
+  WriteChannels(stats.input, shm->input, &shm->input_count);
+  WriteChannels(stats.output, shm->output, &shm->output_count);
+  for (size_t i = 0; i < LATENCY_STAGES_COUNT; ++i) {
+    const LatencyHistogram::buckets_t& buckets = stats.latency[i].GetBuckets();
+    std::copy(buckets.begin(), buckets.end(), shm->latency[i]);
+  }
+  shm->timer_lag = stats.timer_lag;
+  shm->audio_rms = stats.audio_rms;
+  shm->audio_peak = stats.audio_peak;
+  shm->audio_silence = stats.audio_silence;
+  shm->audio_loudness = stats.audio_loudness;
+  shm->audio_loudness_integrated = stats.audio_loudness_integrated;
+  shm->video_black = stats.video_black;
+  shm->video_freeze = stats.video_freeze;
+  shm->queue_fill = stats.queue_fill;
+  shm->queue_time = stats.queue_time;
+  shm->qos_events = stats.qos_events;
+  shm->qos_dropped = stats.qos_dropped;
+  shm->gst_memory = stats.gst_memory;
+  shm->heap_memory = stats.heap_memory;
+  shm->ml_backend = stats.ml_backend;
+  shm->progress = stats.progress;
+  std::copy(stats.startup.begin(), stats.startup.end(), shm->startup);
+
+  shm->sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool ReadStreamStructShm(const StreamStructShm* shm, StreamStruct* stats) {
+  if (!shm || !stats) {
+    return false;
+  }
+
+  for (int i = 0; i < kMaxReadAttempts; ++i) {
+    const uint32_t seq = shm->sequence.load(std::memory_order_acquire);
+    if (seq & 1) {
+      continue;
+    }
+
+    StreamStruct lstats;
+    lstats.id = std::string(shm->id, strnlen(shm->id, STREAM_SHM_MAX_ID_SIZE));
+    lstats.type = static_cast<fastotv::StreamType>(shm->type);
+    lstats.status = static_cast<StreamStatus>(shm->status);
+    lstats.start_time = shm->start_time;
+    lstats.loop_start_time = shm->loop_start_time;
+    lstats.idle_time = shm->idle_time;
+    lstats.restarts = shm->restarts;
+    lstats.input = ReadChannels(shm->input, shm->input_count);
+    lstats.output = ReadChannels(shm->output, shm->output_count);
+    for (size_t j = 0; j < LATENCY_STAGES_COUNT; ++j) {
+      LatencyHistogram::buckets_t buckets;
+      std::copy(shm->latency[j], shm->latency[j] + LatencyHistogram::buckets_count, buckets.begin());
+      lstats.latency[j].SetBuckets(buckets);
+    }
+    lstats.timer_lag = shm->timer_lag;
+    lstats.audio_rms = shm->audio_rms;
+    lstats.audio_peak = shm->audio_peak;
+    lstats.audio_silence = shm->audio_silence;
+    lstats.audio_loudness = shm->audio_loudness;
+    lstats.audio_loudness_integrated = shm->audio_loudness_integrated;
+    lstats.video_black = shm->video_black;
+    lstats.video_freeze = shm->video_freeze;
+    lstats.queue_fill = shm->queue_fill;
+    lstats.queue_time = shm->queue_time;
+    lstats.qos_events = shm->qos_events;
+    lstats.qos_dropped = shm->qos_dropped;
+    lstats.gst_memory = shm->gst_memory;
+    lstats.heap_memory = shm->heap_memory;
+    lstats.ml_backend = shm->ml_backend;
+    lstats.progress = shm->progress;
+    std::copy(shm->startup, shm->startup + STARTUP_STAGES_COUNT, lstats.startup.begin());
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (shm->sequence.load(std::memory_order_relaxed) == seq) {
+      *stats = lstats;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace fastocloud
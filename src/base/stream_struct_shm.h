@@ -0,0 +1,92 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include <common/error.h>
+
+#include "base/stream_struct.h"
+
+#define STREAM_SHM_NAME_PREFIX "/fastocloud_stats_"
+#define STREAM_SHM_MAX_CHANNELS 16
+#define STREAM_SHM_MAX_ID_SIZE 64
+
+namespace fastocloud {
+
+// fixed size layout of StreamStruct, shared between daemon and stream process
+struct ChannelStatsShm {
+  fastotv::channel_id_t id;
+  fastotv::timestamp_t last_update_time;
+  uint64_t total_bytes;
+  uint64_t total_packets;
+  uint64_t total_drops;
+  uint32_t peers_count;
+  PeerStats peers[CHANNEL_STATS_MAX_PEERS];
+  uint64_t prev_total_bytes;
+  uint64_t bytes_per_second;
+};
+
+struct StreamStructShm {
+  std::atomic<uint32_t> sequence;  // seqlock, odd while writer updates block
+
+  char id[STREAM_SHM_MAX_ID_SIZE];
+  int32_t type;
+  int32_t status;
+  fastotv::timestamp_t start_time;
+  fastotv::timestamp_t loop_start_time;
+  fastotv::timestamp_t idle_time;
+  uint64_t restarts;
+
+  uint32_t input_count;
+  uint32_t output_count;
+  ChannelStatsShm input[STREAM_SHM_MAX_CHANNELS];
+  ChannelStatsShm output[STREAM_SHM_MAX_CHANNELS];
+
+  uint64_t latency[LATENCY_STAGES_COUNT][LatencyHistogram::buckets_count];
+  fastotv::timestamp_t timer_lag;
+  int32_t audio_rms;
+  int32_t audio_peak;
+  fastotv::timestamp_t audio_silence;
+  double audio_loudness;
+  double audio_loudness_integrated;
+  fastotv::timestamp_t video_black;
+  fastotv::timestamp_t video_freeze;
+  int32_t queue_fill;
+  fastotv::timestamp_t queue_time;
+  uint64_t qos_events;
+  uint64_t qos_dropped;
+  uint64_t gst_memory;
+  uint64_t heap_memory;
+  int32_t ml_backend;
+  int32_t progress;
+  fastotv::timestamp_t startup[STARTUP_STAGES_COUNT];
+};
+
+std::string MakeStreamShmName(const fastotv::stream_id_t& sid);
+
+// daemon side, creates (or truncates) segment before stream process started
+common::ErrnoError CreateStreamShm(const std::string& name, StreamStructShm** shm) WARN_UNUSED_RESULT;
+// stream side
+common::ErrnoError OpenStreamShm(const std::string& name, StreamStructShm** shm) WARN_UNUSED_RESULT;
+common::ErrnoError CloseStreamShm(StreamStructShm* shm) WARN_UNUSED_RESULT;
+common::ErrnoError UnlinkStreamShm(const std::string& name) WARN_UNUSED_RESULT;
+
+// single writer
+void WriteStreamStructShm(const StreamStruct& stats, StreamStructShm* shm);
+bool ReadStreamStructShm(const StreamStructShm* shm, StreamStruct* stats);
+
+}  // namespace fastocloud
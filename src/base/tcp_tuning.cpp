@@ -0,0 +1,61 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "base/tcp_tuning.h"
+
+#include "base/config_fields.h"
+
+namespace fastocloud {
+
+TcpTuning::TcpTuning() : client_buffer(0), keyframe_recover(false), keyframe_burst(false), timeout(0) {}
+
+bool TcpTuning::IsEmpty() const {
+  return client_buffer == 0 && !keyframe_recover && !keyframe_burst && timeout == 0;
+}
+
+bool ReadTcpTuning(common::HashValue* hash, TcpTuning* tuning) {
+  if (!hash || !tuning) {
+    return false;
+  }
+
+  TcpTuning ltuning;
+  int client_buffer;
+  common::Value* client_buffer_field = hash->Find(TCP_CLIENT_BUFFER_FIELD);
+  if (client_buffer_field && client_buffer_field->GetAsInteger(&client_buffer) && client_buffer > 0) {
+    ltuning.client_buffer = client_buffer;
+  }
+
+  bool keyframe_recover;
+  common::Value* keyframe_recover_field = hash->Find(TCP_KEYFRAME_RECOVER_FIELD);
+  if (keyframe_recover_field && keyframe_recover_field->GetAsBoolean(&keyframe_recover)) {
+    ltuning.keyframe_recover = keyframe_recover;
+  }
+
+  bool keyframe_burst;
+  common::Value* keyframe_burst_field = hash->Find(TCP_KEYFRAME_BURST_FIELD);
+  if (keyframe_burst_field && keyframe_burst_field->GetAsBoolean(&keyframe_burst)) {
+    ltuning.keyframe_burst = keyframe_burst;
+  }
+
+  int timeout;
+  common::Value* timeout_field = hash->Find(TCP_TIMEOUT_FIELD);
+  if (timeout_field && timeout_field->GetAsInteger(&timeout) && timeout > 0 && timeout <= 3600) {
+    ltuning.timeout = timeout;
+  }
+
+  *tuning = ltuning;
+  return true;
+}
+
+}  // namespace fastocloud
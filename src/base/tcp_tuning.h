@@ -0,0 +1,41 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+
+#include <common/value.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+
+// clients of tcp server output, "tcp" hash of url entry
+struct TcpTuning {
+  TcpTuning();
+
+  bool IsEmpty() const;
+
+  int client_buffer;      // bytes queued per client before recovery, twice of it disconnects, 0 unlimited
+  bool keyframe_recover;  // lagging client resumes from latest keyframe, disconnected at hard limit otherwise
+  bool keyframe_burst;    // connected client starts from latest keyframe instead of next buffer
+  int timeout;            // secs without client progress before it is dropped, 0 never
+};
+
+typedef std::map<fastotv::channel_id_t, TcpTuning> tcp_tunings_t;
+
+bool ReadTcpTuning(common::HashValue* hash, TcpTuning* tuning);
+
+}  // namespace fastocloud
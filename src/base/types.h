@@ -24,10 +24,14 @@
 #define CHUNK_EXT "." TS_EXTENSION
 
 #define DUMP_FILE_NAME "dump.html"
+#define PROFILE_FILE_NAME "profile.txt"
+
+#define AUDIO_LEVEL_MIN_DB -100  // dBFS of digital silence and not measured audio
 
 namespace fastocloud {
 
 typedef common::Optional<double> volume_t;
+typedef common::Optional<double> loudness_t;  // LUFS
 typedef double alpha_t;
 typedef common::Optional<int> bit_rate_t;
 
@@ -15,8 +15,15 @@
 #include "base/utils.h"
 
 #include <dirent.h>
+#include <errno.h>
 #include <string.h>
 
+#if defined(OS_POSIX)
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <common/convert2string.h>
 #include <common/file_system/file_system.h>
 #include <common/file_system/string_path_utils.h>
@@ -69,6 +76,100 @@ common::ErrnoError CreateAndCheckDir(const std::string& directory_path) {
   return common::file_system::node_access(directory_path);
 }
 
+#if defined(OS_POSIX)
+namespace {
+std::string StripTrailingSeparator(const std::string& path) {
+  if (path.size() > 1 && path.back() == '/') {
+    return path.substr(0, path.size() - 1);
+  }
+  return path;
+}
+
+bool ReadDirLink(const std::string& link_path, std::string* target) {
+  struct stat sb;
+  if (lstat(link_path.c_str(), &sb) != 0 || !S_ISLNK(sb.st_mode)) {
+    return false;
+  }
+  char buff[PATH_MAX];
+  const ssize_t len = readlink(link_path.c_str(), buff, sizeof(buff) - 1);
+  if (len <= 0) {
+    return false;
+  }
+  *target = std::string(buff, len);
+  return true;
+}
+}  // namespace
+#endif
+
+common::ErrnoError CreateRamBackedDir(const std::string& directory_path, const std::string& ram_path) {
+#if defined(OS_POSIX)
+  common::ErrnoError errn = CreateAndCheckDir(ram_path);
+  if (errn) {
+    return errn;
+  }
+
+  const std::string link_path = StripTrailingSeparator(directory_path);
+  const std::string target = StripTrailingSeparator(ram_path);
+  std::string current;
+  if (ReadDirLink(link_path, &current)) {
+    if (current == target) {
+      return common::ErrnoError();
+    }
+    unlink(link_path.c_str());
+  } else if (common::file_system::is_directory_exist(directory_path)) {  // disk segments of previous runs
+    common::file_system::remove_directory(directory_path, true);
+  }
+
+  const std::string::size_type parent = link_path.find_last_of('/');
+  if (parent != std::string::npos && parent > 0) {
+    errn = CreateAndCheckDir(link_path.substr(0, parent));
+    if (errn) {
+      return errn;
+    }
+  }
+
+  if (symlink(target.c_str(), link_path.c_str()) != 0) {
+    return common::make_errno_error(errno);
+  }
+  return common::file_system::node_access(directory_path);
+#else
+  UNUSED(ram_path);
+  return CreateAndCheckDir(directory_path);
+#endif
+}
+
+void RemoveOutputDir(const std::string& directory_path) {
+#if defined(OS_POSIX)
+  const std::string link_path = StripTrailingSeparator(directory_path);
+  std::string target;
+  if (ReadDirLink(link_path, &target)) {
+    common::file_system::remove_directory(target, true);
+    unlink(link_path.c_str());
+    return;
+  }
+#endif
+  common::file_system::remove_directory(directory_path, true);
+}
+
+bool MoveOutputDirToTrash(const std::string& directory_path, const std::string& trash_path) {
+#if defined(OS_POSIX)
+  const std::string dir = StripTrailingSeparator(directory_path);
+  struct stat sb;
+  if (lstat(dir.c_str(), &sb) != 0 || !S_ISDIR(sb.st_mode)) {  // ram backed links cleaned in place
+    return false;
+  }
+
+  if (rename(dir.c_str(), StripTrailingSeparator(trash_path).c_str()) != 0) {  // EXDEV if other disk
+    return false;
+  }
+  return mkdir(dir.c_str(), sb.st_mode & 07777) == 0 || errno == EEXIST;
+#else
+  UNUSED(directory_path);
+  UNUSED(trash_path);
+  return false;
+#endif
+}
+
 void RemoveFilesByExtension(const common::file_system::ascii_directory_string_path& dir, const char* ext) {
   if (!dir.IsValid()) {
     return;
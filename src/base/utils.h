@@ -23,6 +23,11 @@
 namespace fastocloud {
 
 common::ErrnoError CreateAndCheckDir(const std::string& directory_path);
+// directory_path becomes symlink to ram_path (tmpfs), segments written and served through it never hit disk
+common::ErrnoError CreateRamBackedDir(const std::string& directory_path, const std::string& ram_path);
+void RemoveOutputDir(const std::string& directory_path);  // with ram backing if symlink
+// directory_path renamed to trash_path and created again empty, false if symlink or trash on other filesystem
+bool MoveOutputDirToTrash(const std::string& directory_path, const std::string& trash_path);
 void RemoveOldFilesByTime(const common::file_system::ascii_directory_string_path& dir,
                           common::utctime_t max_life_secs,
                           const char* pattern,
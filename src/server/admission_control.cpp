@@ -0,0 +1,128 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/admission_control.h"
+
+#include <algorithm>
+
+#include <common/sprintf.h>
+
+#include "server/gpu_stats/encoder_pool.h"
+
+namespace fastocloud {
+namespace server {
+
+namespace {
+double ToMbps(uint64_t bytes_per_second) {
+  return static_cast<double>(bytes_per_second) * 8 / (1000 * 1000);
+}
+}  // namespace
+
+AdmissionControl::AdmissionControl(size_t cpus, int max_cpu_load, uint64_t max_bandwidth)
+    : cpus_(std::max<size_t>(cpus, 1)),
+      max_cpu_load_(max_cpu_load),
+      max_bandwidth_(max_bandwidth),
+      reserved_(),
+      measured_() {}
+
+AdmissionControl::Cost AdmissionControl::Estimate(fastotv::stream_id_t sid,
+                                                  fastotv::StreamType type,
+                                                  const std::string& active_codec,
+                                                  const common::draw::Size& size,
+                                                  int video_bitrate,
+                                                  size_t outputs) const {
+  const auto it = measured_.find(sid);
+  if (it != measured_.end()) {
+    return it->second;
+  }
+
+  Cost cost = {relay_cpu_estimate, 0};
+  const bool is_encode = type == fastotv::ENCODE || type == fastotv::VOD_ENCODE || type == fastotv::COD_ENCODE;
+  if (is_encode) {
+    gpu_stats::EncoderPool::Device device;
+    if (gpu_stats::EncoderPool::GetDevice(active_codec, &device)) {
+      cost.cpu = hardware_encode_cpu_estimate;
+    } else {
+      double scale = 1.0;
+      if (size.IsValid()) {
+        scale = std::max(static_cast<double>(size.width) * size.height / (1920 * 1080), 0.25);
+      }
+      cost.cpu = software_encode_cpu_estimate * scale;
+    }
+  }
+
+  const uint64_t output_kbps = video_bitrate > 0 ? video_bitrate + audio_bitrate_estimate : output_bandwidth_estimate;
+  cost.bandwidth = outputs * output_kbps * 1000 / 8;
+  return cost;
+}
+
+common::ErrnoError AdmissionControl::Admit(fastotv::stream_id_t sid,
+                                           const Cost& cost,
+                                           double node_cpu_load,
+                                           uint64_t node_bandwidth) {
+  Release(sid);
+  const Cost reserved = GetReserved();
+  if (max_cpu_load_ != unlimited) {
+    // load of just started streams not yet visible on node
+    const double used = std::max(node_cpu_load * cpus_, reserved.cpu);
+    const double capacity = static_cast<double>(max_cpu_load_) * cpus_;
+    if (used + cost.cpu > capacity) {
+      return common::make_errno_error(
+          common::MemSPrintf("Node cpu overloaded, stream id: %s needs %.0f%% of cpu, used %.0f%% of %.0f%%.", sid,
+                             cost.cpu, used, capacity),
+          EBUSY);
+    }
+  }
+
+  if (max_bandwidth_ != unlimited) {
+    const uint64_t used = std::max(node_bandwidth, reserved.bandwidth);
+    if (used + cost.bandwidth > max_bandwidth_) {
+      return common::make_errno_error(
+          common::MemSPrintf("Node network overloaded, stream id: %s needs %.1f Mbps, used %.1f of %.1f Mbps.", sid,
+                             ToMbps(cost.bandwidth), ToMbps(used), ToMbps(max_bandwidth_)),
+          EBUSY);
+    }
+  }
+
+  reserved_[sid] = cost;
+  return common::ErrnoError();
+}
+
+void AdmissionControl::Measure(fastotv::stream_id_t sid, const Cost& cost) {
+  measured_[sid] = cost;
+  auto it = reserved_.find(sid);
+  if (it != reserved_.end()) {
+    it->second = cost;
+  }
+}
+
+void AdmissionControl::Release(fastotv::stream_id_t sid) {
+  reserved_.erase(sid);
+}
+
+void AdmissionControl::Restore(fastotv::stream_id_t sid, const Cost& cost) {
+  reserved_[sid] = cost;
+}
+
+AdmissionControl::Cost AdmissionControl::GetReserved() const {
+  Cost total = {0, 0};
+  for (auto it = reserved_.begin(); it != reserved_.end(); ++it) {
+    total.cpu += it->second.cpu;
+    total.bandwidth += it->second.bandwidth;
+  }
+  return total;
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,79 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <common/draw/types.h>
+#include <common/error.h>
+#include <common/macros.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+namespace server {
+
+// node resources reserved by started streams, starts which would overload cpu or network are rejected
+class AdmissionControl {
+ public:
+  struct Cost {
+    double cpu;          // percents of one cpu
+    uint64_t bandwidth;  // bytes per second
+  };
+
+  enum {
+    unlimited = 0,
+    relay_cpu_estimate = 10,             // percents, demux and mux only
+    software_encode_cpu_estimate = 200,  // percents, 1080p30 x264
+    hardware_encode_cpu_estimate = 30,   // percents, decode and upload on gpu encoders
+    audio_bitrate_estimate = 128,        // kbps
+    output_bandwidth_estimate = 5000     // kbps per output if bitrate unknown
+  };
+
+  // max_cpu_load in percents of node, max_bandwidth in bytes per second, unlimited - not checked
+  AdmissionControl(size_t cpus, int max_cpu_load, uint64_t max_bandwidth);
+
+  // last measured cost of stream if it was running before, otherwise estimated from config,
+  // video_bitrate in kbps, 0 - unknown
+  Cost Estimate(fastotv::stream_id_t sid,
+                fastotv::StreamType type,
+                const std::string& active_codec,
+                const common::draw::Size& size,
+                int video_bitrate,
+                size_t outputs) const;
+
+  // node_cpu_load in percents of node, node_bandwidth sent bytes per second,
+  // reserves cost if stream fits
+  common::ErrnoError Admit(fastotv::stream_id_t sid, const Cost& cost, double node_cpu_load, uint64_t node_bandwidth);
+  void Measure(fastotv::stream_id_t sid, const Cost& cost);  // from stream statistic, kept after stream quit
+  void Release(fastotv::stream_id_t sid);
+  // running stream adopted from previous service, reserved without checks
+  void Restore(fastotv::stream_id_t sid, const Cost& cost);
+
+  Cost GetReserved() const;
+
+ private:
+  const size_t cpus_;
+  const int max_cpu_load_;
+  const uint64_t max_bandwidth_;
+  std::map<fastotv::stream_id_t, Cost> reserved_;
+  std::map<fastotv::stream_id_t, Cost> measured_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdmissionControl);
+};
+
+}  // namespace server
+}  // namespace fastocloud
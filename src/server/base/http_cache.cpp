@@ -0,0 +1,142 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/base/http_cache.h"
+
+#include <ctype.h>
+
+#include <common/sprintf.h>
+#include <common/string_util.h>
+
+#include "base/types.h"
+
+namespace {
+const char kCorsHeader[] = "Access-Control-Allow-Origin: *";
+const char kPlaylistCacheControl[] = "public, max-age=1";
+const char kImmutableCacheControl[] = "public, max-age=31536000, immutable";
+const char kSegmentCacheControl[] = "public, max-age=3600";
+const char kRevalidateCacheControl[] = "no-cache";
+const char* const kSegmentExtensions[] = {TS_EXTENSION, "m4s", "mp4", "aac", "vtt"};
+
+std::string trim(const std::string& value) {
+  size_t first = 0;
+  size_t last = value.size();
+  while (first < last && isspace(static_cast<unsigned char>(value[first]))) {
+    first++;
+  }
+  while (last > first && isspace(static_cast<unsigned char>(value[last - 1]))) {
+    last--;
+  }
+  return value.substr(first, last - first);
+}
+
+// weak comparison, W/ prefix ignored on both sides
+bool is_etag_listed(const std::string& list, const std::string& etag) {
+  size_t pos = 0;
+  while (pos <= list.size()) {
+    size_t next = list.find(',', pos);
+    if (next == std::string::npos) {
+      next = list.size();
+    }
+    std::string tag = trim(list.substr(pos, next - pos));
+    if (tag == "*") {
+      return true;
+    }
+    if (tag.compare(0, 2, "W/") == 0) {
+      tag = tag.substr(2);
+    }
+    if (tag == etag) {
+      return true;
+    }
+    pos = next + 1;
+  }
+  return false;
+}
+
+const char* get_cache_control(const std::string& file_name, bool immutable_segments) {
+  const size_t dot = file_name.rfind('.');
+  if (dot == std::string::npos) {
+    return kRevalidateCacheControl;
+  }
+
+  const std::string extension = file_name.substr(dot + 1);
+  if (common::EqualsASCII(extension, M3U8_EXTENSION, false)) {
+    return kPlaylistCacheControl;
+  }
+  for (const char* segment_extension : kSegmentExtensions) {
+    if (common::EqualsASCII(extension, segment_extension, false)) {
+      return immutable_segments ? kImmutableCacheControl : kSegmentCacheControl;
+    }
+  }
+  return kRevalidateCacheControl;
+}
+}  // namespace
+
+namespace fastocloud {
+namespace server {
+namespace base {
+
+CacheConditions::CacheConditions() : if_none_match(), if_modified_since(0) {}
+
+CacheConditions GetCacheConditions(const common::http::HttpRequest& request) {
+  CacheConditions conditions;
+  common::http::header_t field;
+  if (request.FindHeaderByKey("If-None-Match", false, &field)) {
+    conditions.if_none_match = trim(field.value);
+  }
+  if (request.FindHeaderByKey("If-Modified-Since", false, &field)) {
+    ParseHttpDate(trim(field.value), &conditions.if_modified_since);
+  }
+  return conditions;
+}
+
+std::string MakeETag(off_t size, time_t mtime) {
+  return common::MemSPrintf("\"%llx-%llx\"", static_cast<unsigned long long>(size),
+                            static_cast<unsigned long long>(mtime));
+}
+
+bool IsNotModified(const CacheConditions& conditions, const std::string& etag, time_t mtime) {
+  if (!conditions.if_none_match.empty()) {
+    return is_etag_listed(conditions.if_none_match, etag);
+  }
+  return conditions.if_modified_since && mtime <= conditions.if_modified_since;
+}
+
+std::string MakeCacheHeaders(const std::string& etag, const std::string& file_name, bool immutable_segments) {
+  return common::MemSPrintf("%s\r\nETag: %s\r\nCache-Control: %s", kCorsHeader, etag.c_str(),
+                            get_cache_control(file_name, immutable_segments));
+}
+
+bool ParseHttpDate(const std::string& date, time_t* out) {
+  if (!out) {
+    return false;
+  }
+
+#if defined(OS_POSIX)
+  struct tm tm = {};
+  const char* end = strptime(date.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+  if (!end || *end != '\0') {
+    return false;
+  }
+  *out = timegm(&tm);
+  return *out != static_cast<time_t>(-1);
+#else
+#pragma message "Please implement"
+  return false;
+#endif
+}
+
+}  // namespace base
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,50 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <sys/types.h>
+#include <time.h>
+
+#include <string>
+
+#include <common/http/http.h>
+
+namespace fastocloud {
+namespace server {
+namespace base {
+
+// validators of conditional GET, If-None-Match wins over If-Modified-Since
+struct CacheConditions {
+  CacheConditions();
+
+  std::string if_none_match;  // raw header value, empty if not sent
+  time_t if_modified_since;   // 0 if not sent or not parsed
+};
+
+CacheConditions GetCacheConditions(const common::http::HttpRequest& request);
+
+// "<size>-<mtime>" in hex like nginx, changed whenever file rewritten
+std::string MakeETag(off_t size, time_t mtime);
+bool IsNotModified(const CacheConditions& conditions, const std::string& etag, time_t mtime);
+
+// extra header of file response: cors, etag and cache-control by extension
+// playlists revalidated every second, segments kept long, forever if names never reused
+std::string MakeCacheHeaders(const std::string& etag, const std::string& file_name, bool immutable_segments);
+
+bool ParseHttpDate(const std::string& date, time_t* out);  // IMF-fixdate, utc
+
+}  // namespace base
+}  // namespace server
+}  // namespace fastocloud
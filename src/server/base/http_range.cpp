@@ -0,0 +1,109 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/base/http_range.h"
+
+#include <common/convert2string.h>
+#include <common/sprintf.h>
+
+#include "server/base/http_cache.h"
+
+namespace {
+const char kBytesUnit[] = "bytes=";
+}
+
+namespace fastocloud {
+namespace server {
+namespace base {
+
+bool ParseRangeHeader(const std::string& value, uint64_t size, ByteRange* range) {
+  const size_t unit_len = sizeof(kBytesUnit) - 1;
+  if (!range || !size || value.compare(0, unit_len, kBytesUnit) != 0) {
+    return false;
+  }
+
+  const std::string spec = value.substr(unit_len);
+  const size_t dash = spec.find('-');
+  if (dash == std::string::npos || spec.find(',') != std::string::npos) {
+    return false;
+  }
+
+  const std::string first = spec.substr(0, dash);
+  const std::string last = spec.substr(dash + 1);
+  uint64_t start = 0;
+  uint64_t end = size - 1;
+  if (first.empty()) {  // suffix of n bytes
+    uint64_t suffix = 0;
+    if (!common::ConvertFromString(last, &suffix) || !suffix) {
+      return false;
+    }
+    start = suffix < size ? size - suffix : 0;
+  } else {
+    if (!common::ConvertFromString(first, &start) || start >= size) {
+      return false;
+    }
+    if (!last.empty()) {
+      if (!common::ConvertFromString(last, &end) || end < start) {
+        return false;
+      }
+      if (end >= size) {
+        end = size - 1;
+      }
+    }
+  }
+
+  range->start = start;
+  range->length = end - start + 1;
+  return true;
+}
+
+bool IsRangeCurrent(const std::string& if_range, const std::string& etag, time_t mtime) {
+  if (if_range.empty()) {
+    return true;
+  }
+  if (if_range[0] == '"') {  // strong comparison only
+    return if_range == etag;
+  }
+
+  time_t date = 0;
+  return ParseHttpDate(if_range, &date) && date == mtime;
+}
+
+bool GetByteRange(const common::http::HttpRequest& request,
+                  uint64_t size,
+                  const std::string& etag,
+                  time_t mtime,
+                  ByteRange* range) {
+  common::http::header_t range_field;
+  if (!request.FindHeaderByKey("Range", false, &range_field)) {
+    return false;
+  }
+
+  common::http::header_t if_range_field;
+  if (request.FindHeaderByKey("If-Range", false, &if_range_field) &&
+      !IsRangeCurrent(if_range_field.value, etag, mtime)) {
+    return false;
+  }
+  return ParseRangeHeader(range_field.value, size, range);
+}
+
+std::string MakeContentRangeHeader(const ByteRange& range, uint64_t size) {
+  return common::MemSPrintf("Content-Range: bytes %llu-%llu/%llu", static_cast<unsigned long long>(range.start),
+                            static_cast<unsigned long long>(range.start + range.length - 1),
+                            static_cast<unsigned long long>(size));
+}
+
+}  // namespace base
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,49 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#include <string>
+
+#include <common/http/http.h>
+
+namespace fastocloud {
+namespace server {
+namespace base {
+
+struct ByteRange {
+  uint64_t start;
+  uint64_t length;
+};
+
+// "bytes=a-b", "bytes=a-" or "bytes=-n" clamped to size, false if not satisfiable or several ranges
+// whole file answered then, ranges may be ignored by server
+bool ParseRangeHeader(const std::string& value, uint64_t size, ByteRange* range);
+// If-Range by etag or by date, empty - always current
+bool IsRangeCurrent(const std::string& if_range, const std::string& etag, time_t mtime);
+// range of request to answer with 206, false if whole file should be sent
+bool GetByteRange(const common::http::HttpRequest& request,
+                  uint64_t size,
+                  const std::string& etag,
+                  time_t mtime,
+                  ByteRange* range);
+
+std::string MakeContentRangeHeader(const ByteRange& range, uint64_t size);  // without line end
+
+}  // namespace base
+}  // namespace server
+}  // namespace fastocloud
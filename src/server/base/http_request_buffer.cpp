@@ -0,0 +1,255 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/base/http_request_buffer.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <algorithm>
+
+#include <common/string_util.h>
+
+namespace {
+const char kHeadersEnd[] = "\r\n\r\n";
+const char kContentLength[] = "content-length:";
+const char kHttp2Preface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+const size_t kHttp2FrameHeaderSize = 9;
+
+bool has_connection_token(const std::string& value, const char* token) {
+  size_t pos = 0;
+  while (pos <= value.size()) {
+    size_t next = value.find(',', pos);
+    if (next == std::string::npos) {
+      next = value.size();
+    }
+    size_t first = pos;
+    size_t last = next;
+    while (first < last && isspace(static_cast<unsigned char>(value[first]))) {
+      first++;
+    }
+    while (last > first && isspace(static_cast<unsigned char>(value[last - 1]))) {
+      last--;
+    }
+    if (common::EqualsASCII(value.substr(first, last - first), token, false)) {
+      return true;
+    }
+    pos = next + 1;
+  }
+  return false;
+}
+
+// false if value is not a plain decimal or exceed max_length, absent field is zero length
+bool parse_content_length(const char* headers, size_t size, size_t max_length, size_t* length) {
+  const size_t field_len = sizeof(kContentLength) - 1;
+  const char* end = headers + size;
+  *length = 0;
+  for (const char* line = headers; line < end;) {
+    const char* line_end = static_cast<const char*>(memchr(line, '\n', end - line));
+    if (!line_end) {
+      line_end = end;
+    }
+    if (static_cast<size_t>(line_end - line) > field_len && strncasecmp(line, kContentLength, field_len) == 0) {
+      const char* value = line + field_len;
+      const char* value_end = line_end;
+      while (value < value_end && (*value == ' ' || *value == '\t')) {
+        value++;
+      }
+      while (value_end > value && isspace(static_cast<unsigned char>(value_end[-1]))) {
+        value_end--;
+      }
+      if (value == value_end) {
+        return false;
+      }
+      size_t result = 0;
+      for (; value < value_end; ++value) {
+        if (!isdigit(static_cast<unsigned char>(*value))) {
+          return false;
+        }
+        result = result * 10 + (*value - '0');
+        if (result > max_length) {
+          return false;
+        }
+      }
+      *length = result;
+      return true;
+    }
+    line = line_end + 1;
+  }
+  return true;
+}
+}  // namespace
+
+namespace fastocloud {
+namespace server {
+namespace base {
+
+HttpRequestBuffer::HttpRequestBuffer()
+    : data_(), start_(0), end_(0), scan_pos_(0), http2_(false), malformed_(false) {}
+
+char* HttpRequestBuffer::PrepareWrite(size_t* free_size) {
+  if (malformed_) {
+    return nullptr;
+  }
+
+  if (end_ == data_.size() && start_ != 0) {
+    memmove(data_.data(), data_.data() + start_, end_ - start_);
+    end_ -= start_;
+    scan_pos_ -= start_;
+    start_ = 0;
+  }
+
+  if (end_ == data_.size()) {
+    if (data_.size() >= max_request_size) {
+      return nullptr;
+    }
+    data_.resize(data_.empty() ? static_cast<size_t>(init_size) : data_.size() * 2);
+  }
+
+  *free_size = data_.size() - end_;
+  return data_.data() + end_;
+}
+
+void HttpRequestBuffer::CommitWrite(size_t size) {
+  end_ += size;
+}
+
+bool HttpRequestBuffer::NextRequest(std::string* request) {
+  if (http2_ || malformed_ || !SkipPreface()) {
+    return false;
+  }
+
+  size_t request_size = 0;
+  if (!FindRequestEnd(&request_size)) {
+    return false;
+  }
+
+  request->assign(data_.data() + start_, request_size);
+  start_ += request_size;
+  scan_pos_ = start_;
+  if (start_ == end_) {
+    Clear();
+  }
+  return true;
+}
+
+bool HttpRequestBuffer::NextFrames(std::string* frames) {
+  if (!http2_) {
+    return false;
+  }
+
+  size_t pos = start_;
+  while (end_ - pos >= kHttp2FrameHeaderSize) {
+    const unsigned char* header = reinterpret_cast<const unsigned char*>(data_.data() + pos);
+    const size_t length = (static_cast<size_t>(header[0]) << 16) | (static_cast<size_t>(header[1]) << 8) | header[2];
+    if (end_ - pos < kHttp2FrameHeaderSize + length) {
+      break;
+    }
+    pos += kHttp2FrameHeaderSize + length;
+  }
+  if (pos == start_) {
+    return false;
+  }
+
+  frames->assign(data_.data() + start_, pos - start_);
+  start_ = pos;
+  scan_pos_ = start_;
+  if (start_ == end_) {
+    Clear();
+  }
+  return true;
+}
+
+bool HttpRequestBuffer::IsHttp2() const {
+  return http2_;
+}
+
+bool HttpRequestBuffer::IsMalformed() const {
+  return malformed_;
+}
+
+bool HttpRequestBuffer::SkipPreface() {
+  const size_t preface_len = sizeof(kHttp2Preface) - 1;
+  const size_t pending = end_ - start_;
+  if (!pending) {
+    return false;
+  }
+  if (memcmp(data_.data() + start_, kHttp2Preface, std::min(pending, preface_len)) != 0) {
+    return true;
+  }
+  if (pending < preface_len) {
+    return false;
+  }
+
+  http2_ = true;
+  start_ += preface_len;
+  scan_pos_ = start_;
+  return false;
+}
+
+bool HttpRequestBuffer::FindRequestEnd(size_t* request_size) {
+  const size_t delim_len = sizeof(kHeadersEnd) - 1;
+  // continue scan from previous call, delimiter can be split between reads
+  size_t pos = scan_pos_ > start_ + delim_len ? scan_pos_ - delim_len : start_;
+  for (; pos + delim_len <= end_; ++pos) {
+    if (memcmp(data_.data() + pos, kHeadersEnd, delim_len) == 0) {
+      break;
+    }
+  }
+  scan_pos_ = end_;
+  if (pos + delim_len > end_) {
+    return false;
+  }
+
+  const size_t headers_size = pos + delim_len - start_;
+  size_t content_length = 0;
+  if (!parse_content_length(data_.data() + start_, headers_size, max_request_size, &content_length)) {
+    malformed_ = true;
+    return false;
+  }
+
+  const size_t total = headers_size + content_length;
+  if (total > end_ - start_) {
+    scan_pos_ = pos + delim_len;
+    return false;
+  }
+
+  *request_size = total;
+  return true;
+}
+
+size_t HttpRequestBuffer::GetSize() const {
+  return end_ - start_;
+}
+
+void HttpRequestBuffer::Clear() {
+  start_ = 0;
+  end_ = 0;
+  scan_pos_ = 0;
+}
+
+bool IsKeepAliveRequest(const common::http::HttpRequest& request) {
+  common::http::header_t connection_field;
+  const bool is_find_connection = request.FindHeaderByKey("Connection", false, &connection_field);
+  if (request.GetProtocol() == common::http::HP_1_0) {
+    return is_find_connection && has_connection_token(connection_field.value, "keep-alive");
+  }
+  return !is_find_connection || !has_connection_token(connection_field.value, "close");
+}
+
+}  // namespace base
+}  // namespace server
+}  // namespace fastocloud
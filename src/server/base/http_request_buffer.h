@@ -0,0 +1,66 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <common/http/http.h>
+
+namespace fastocloud {
+namespace server {
+namespace base {
+
+// per connection storage of received bytes, splits them into complete (pipelined) requests
+// or, after http/2 connection preface, into complete frames
+class HttpRequestBuffer {
+ public:
+  enum { init_size = 4096, max_request_size = 64 * 1024 };
+
+  HttpRequestBuffer();
+
+  // free space for next read, nullptr if pending request exceed max_request_size or buffer is malformed
+  char* PrepareWrite(size_t* free_size);
+  void CommitWrite(size_t size);
+
+  // moves next complete request into request, capacity of request reused between calls
+  bool NextRequest(std::string* request);
+  // moves all complete frames into frames, only after preface
+  bool NextFrames(std::string* frames);
+  bool IsHttp2() const;  // prior knowledge preface received
+  // invalid Content-Length received, no further requests are returned and connection should be closed
+  bool IsMalformed() const;
+
+  size_t GetSize() const;
+  void Clear();
+
+ private:
+  bool FindRequestEnd(size_t* request_size);
+  bool SkipPreface();  // true if pending bytes are http/1 request, preface consumed when complete
+
+  std::vector<char> data_;
+  size_t start_;
+  size_t end_;
+  size_t scan_pos_;
+  bool http2_;
+  bool malformed_;
+};
+
+// HTTP/1.1 connections are persistent unless "close", HTTP/1.0 only with "keep-alive"
+bool IsKeepAliveRequest(const common::http::HttpRequest& request);
+
+}  // namespace base
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,41 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/base/http_worker_loop.h"
+
+namespace fastocloud {
+namespace server {
+namespace base {
+
+HttpWorkerLoop::HttpWorkerLoop(common::libev::IoLoopObserver* observer)
+    : base_class(new common::libev::LibEvLoop, observer) {}
+
+const char* HttpWorkerLoop::ClassName() const {
+  return "HttpWorkerLoop";
+}
+
+common::libev::IoChild* HttpWorkerLoop::CreateChild() {
+  NOTREACHED();
+  return nullptr;
+}
+
+common::libev::IoClient* HttpWorkerLoop::CreateClient(const common::net::socket_info& info) {
+  UNUSED(info);
+  NOTREACHED();
+  return nullptr;
+}
+
+}  // namespace base
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,37 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/libev/io_loop.h>
+
+namespace fastocloud {
+namespace server {
+namespace base {
+
+// loop without listener, serves clients handed off by accepting server
+class HttpWorkerLoop : public common::libev::IoLoop {
+ public:
+  typedef common::libev::IoLoop base_class;
+  explicit HttpWorkerLoop(common::libev::IoLoopObserver* observer = nullptr);
+
+  const char* ClassName() const override;
+
+  common::libev::IoChild* CreateChild() override;
+  common::libev::IoClient* CreateClient(const common::net::socket_info& info) override;
+};
+
+}  // namespace base
+}  // namespace server
+}  // namespace fastocloud
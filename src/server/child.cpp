@@ -16,13 +16,20 @@
 
 #include <common/time.h>
 
+#include "stream_commands/binary_protocol.h"
 #include "stream_commands/commands_factory.h"
+#include "stream_commands/commands_info/profile_info.h"
 
 namespace fastocloud {
 namespace server {
 
 Child::Child(common::libev::IoLoop* server)
-    : IoChild(server), client_(nullptr), request_id_(0), last_update_(common::time::current_utc_mstime()) {}
+    : IoChild(server),
+      client_(nullptr),
+      binary_pipe_(false),
+      request_id_(0),
+      last_update_(common::time::current_utc_mstime()),
+      playing_(false) {}
 
 Child::~Child() {}
 
@@ -34,6 +41,14 @@ void Child::SetClient(client_t* pipe) {
   client_ = pipe;
 }
 
+bool Child::IsBinaryPipe() const {
+  return binary_pipe_;
+}
+
+void Child::SetBinaryPipe(bool binary) {
+  binary_pipe_ = binary;
+}
+
 void Child::UpdateTimestamp() {
   last_update_ = common::time::current_utc_mstime();
 }
@@ -42,13 +57,21 @@ fastotv::timestamp_t Child::GetLastUpdate() const {
   return last_update_;
 }
 
+void Child::SetPlaying(bool playing) {
+  playing_ = playing;
+}
+
+bool Child::IsPlaying() const {
+  return playing_;
+}
+
 common::ErrnoError Child::Stop() {
   if (!client_) {
     return common::make_errno_error_inval();
   }
 
   fastotv::protocol::request_t req = StopStreamRequest(NextRequestID());
-  return client_->WriteRequest(req);
+  return WritePipeRequest(client_, req, binary_pipe_);
 }
 
 common::ErrnoError Child::Restart() {
@@ -57,7 +80,49 @@ common::ErrnoError Child::Restart() {
   }
 
   fastotv::protocol::request_t req = RestartStreamRequest(NextRequestID());
-  return client_->WriteRequest(req);
+  return WritePipeRequest(client_, req, binary_pipe_);
+}
+
+common::ErrnoError Child::UpdateConfig(const std::string& changes_json) {
+  if (!client_) {
+    return common::make_errno_error_inval();
+  }
+
+  fastotv::protocol::request_t req = UpdateConfigStreamRequest(NextRequestID(), changes_json);
+  return WritePipeRequest(client_, req, binary_pipe_);
+}
+
+common::ErrnoError Child::Profile(uint32_t duration_sec) {
+  if (!client_) {
+    return common::make_errno_error_inval();
+  }
+
+  std::string profile_json;
+  common::Error err_ser = ProfileInfo(duration_sec).SerializeToString(&profile_json);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  fastotv::protocol::request_t req = ProfileStreamRequest(NextRequestID(), profile_json);
+  return WritePipeRequest(client_, req, binary_pipe_);
+}
+
+common::ErrnoError Child::UnmuteOutputs() {
+  if (!client_) {
+    return common::make_errno_error_inval();
+  }
+
+  fastotv::protocol::request_t req = UnmuteOutputsStreamRequest(NextRequestID());
+  return WritePipeRequest(client_, req, binary_pipe_);
+}
+
+common::ErrnoError Child::MuteOutputs() {
+  if (!client_) {
+    return common::make_errno_error_inval();
+  }
+
+  fastotv::protocol::request_t req = MuteOutputsStreamRequest(NextRequestID());
+  return WritePipeRequest(client_, req, binary_pipe_);
 }
 
 fastotv::protocol::sequance_id_t Child::NextRequestID() {
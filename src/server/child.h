@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <common/libev/io_child.h>
 
 #include <fastotv/protocol/protocol.h>
@@ -32,14 +34,25 @@ class Child : public common::libev::IoChild {
 
   common::ErrnoError Stop() WARN_UNUSED_RESULT;
   common::ErrnoError Restart() WARN_UNUSED_RESULT;
+  common::ErrnoError UpdateConfig(const std::string& changes_json) WARN_UNUSED_RESULT;  // changed fields only
+  common::ErrnoError Profile(uint32_t duration_sec) WARN_UNUSED_RESULT;  // report into feedback dir of stream
+  common::ErrnoError UnmuteOutputs() WARN_UNUSED_RESULT;
+  common::ErrnoError MuteOutputs() WARN_UNUSED_RESULT;  // gated outputs of cods only
 
   client_t* GetClient() const;
   void SetClient(client_t* pipe);
+
+  bool IsBinaryPipe() const;
+  void SetBinaryPipe(bool binary);
   virtual ~Child();
 
   void UpdateTimestamp();
   fastotv::timestamp_t GetLastUpdate() const;
 
+  // last statistic of stream was playing with input data
+  void SetPlaying(bool playing);
+  bool IsPlaying() const;
+
  protected:
   explicit Child(common::libev::IoLoop* server);
 
@@ -47,9 +60,11 @@ class Child : public common::libev::IoChild {
 
  private:
   client_t* client_;
+  bool binary_pipe_;
   std::atomic<fastotv::protocol::seq_id_t> request_id_;
 
   fastotv::timestamp_t last_update_;
+  bool playing_;
 };
 
 }  // namespace server
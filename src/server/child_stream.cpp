@@ -16,16 +16,97 @@
 
 #include <common/file_system/file_system.h>
 
+#include "base/utils.h"
+
 namespace fastocloud {
 namespace server {
 
-ChildStream::ChildStream(common::libev::IoLoop* server, const StreamInfo& conf) : base_class(server), conf_(conf) {}
+ChildStream::ChildStream(common::libev::IoLoop* server, const StreamInfo& conf)
+    : base_class(server), conf_(conf), shm_(nullptr), pid_(0), hosted_(false), adopted_(false), config_() {}
+
+ChildStream::~ChildStream() {
+  CloseStatsShm();
+}
 
 fastotv::stream_id_t ChildStream::GetStreamID() const {
   return conf_.id;
 }
 
+long ChildStream::GetProcessID() const {
+  return pid_;
+}
+
+void ChildStream::SetProcessID(long pid) {
+  pid_ = pid;
+}
+
+bool ChildStream::IsHosted() const {
+  return hosted_;
+}
+
+void ChildStream::SetHosted(bool hosted) {
+  hosted_ = hosted;
+}
+
+bool ChildStream::IsAdopted() const {
+  return adopted_;
+}
+
+void ChildStream::SetAdopted(bool adopted) {
+  adopted_ = adopted;
+}
+
+StreamConfig ChildStream::GetConfig() const {
+  return config_;
+}
+
+void ChildStream::SetConfig(const StreamConfig& config) {
+  config_ = config;
+}
+
+void ChildStream::Detach() {
+  if (!shm_) {
+    return;
+  }
+
+  common::ErrnoError errn = CloseStreamShm(shm_);
+  if (errn) {
+    DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+  }
+  shm_ = nullptr;
+}
+
+void ChildStream::SetStatsShm(StreamStructShm* shm) {
+  CloseStatsShm();
+  shm_ = shm;
+}
+
+bool ChildStream::ReadStatistic(StreamStruct* stats) const {
+  if (!shm_) {
+    return false;
+  }
+
+  return ReadStreamStructShm(shm_, stats);
+}
+
+void ChildStream::CloseStatsShm() {
+  if (!shm_) {
+    return;
+  }
+
+  common::ErrnoError errn = CloseStreamShm(shm_);
+  if (errn) {
+    DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+  }
+  errn = UnlinkStreamShm(MakeStreamShmName(conf_.id));
+  if (errn) {
+    DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+  }
+  shm_ = nullptr;
+}
+
 void ChildStream::CleanUp() {
+  CloseStatsShm();
   if (conf_.type == fastotv::VOD_ENCODE || conf_.type == fastotv::VOD_RELAY || conf_.type == fastotv::CATCHUP ||
       conf_.type == fastotv::TIMESHIFT_RECORDER || conf_.type == fastotv::TEST_LIFE || conf_.type == fastotv::SCREEN) {
     return;
@@ -35,7 +116,7 @@ void ChildStream::CleanUp() {
     common::uri::Url ouri = out_uri.GetOutput();
     if (ouri.GetScheme() == common::uri::Url::http) {
       const common::file_system::ascii_directory_string_path http_root = out_uri.GetHttpRoot();
-      common::file_system::remove_directory(http_root.GetPath(), true);
+      RemoveOutputDir(http_root.GetPath());
     }
   }
 }
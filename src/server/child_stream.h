@@ -16,7 +16,9 @@
 
 #include "server/child.h"
 
+#include "base/stream_config.h"
 #include "base/stream_info.h"
+#include "base/stream_struct_shm.h"
 
 namespace fastocloud {
 namespace server {
@@ -26,11 +28,38 @@ class ChildStream : public Child {
   typedef Child base_class;
   ChildStream(common::libev::IoLoop* server, const StreamInfo& conf);
 
+  ~ChildStream() override;
+
   fastotv::stream_id_t GetStreamID() const override;
   void CleanUp();
 
+  long GetProcessID() const;  // 0 if not known, gpu processes attributed by it
+  void SetProcessID(long pid);
+
+  bool IsHosted() const;  // thread of relay host, process shared with other streams
+  void SetHosted(bool hosted);
+
+  bool IsAdopted() const;  // spawned by previous service, not waitable, exit noticed by closed pipe
+  void SetAdopted(bool adopted);
+
+  StreamConfig GetConfig() const;  // as spawned, kept for next service
+  void SetConfig(const StreamConfig& config);
+
+  void Detach();  // stream keeps running without service, stats segment left for next one
+
+  // takes ownership of segment
+  void SetStatsShm(StreamStructShm* shm);
+  bool ReadStatistic(StreamStruct* stats) const;
+
  private:
+  void CloseStatsShm();
+
   const StreamInfo conf_;
+  StreamStructShm* shm_;
+  long pid_;
+  bool hosted_;
+  bool adopted_;
+  StreamConfig config_;
   DISALLOW_COPY_AND_ASSIGN(ChildStream);
 };
 
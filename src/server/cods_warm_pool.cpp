@@ -0,0 +1,80 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/cods_warm_pool.h"
+
+#include <math.h>
+
+namespace fastocloud {
+namespace server {
+
+CodsWarmPool::CodsWarmPool(size_t size, fastotv::timestamp_t half_life_msec)
+    : size_(size), half_life_msec_(half_life_msec), popularity_(), parked_() {}
+
+void CodsWarmPool::Hit(fastotv::stream_id_t sid, fastotv::timestamp_t now) {
+  auto it = popularity_.find(sid);
+  if (it == popularity_.end()) {
+    popularity_[sid] = {1, now};
+    return;
+  }
+
+  it->second.score = GetScore(it->second, now) + 1;
+  it->second.ts = now;
+}
+
+bool CodsWarmPool::IsWarm(fastotv::stream_id_t sid, fastotv::timestamp_t now) const {
+  auto it = popularity_.find(sid);
+  if (it == popularity_.end() || !size_) {
+    return false;
+  }
+
+  const double score = GetScore(it->second, now);
+  size_t more_popular = 0;
+  for (const auto& pop : popularity_) {
+    if (pop.first != sid && GetScore(pop.second, now) > score && ++more_popular >= size_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CodsWarmPool::Park(fastotv::stream_id_t sid) {
+  parked_.insert(sid);
+}
+
+bool CodsWarmPool::Unpark(fastotv::stream_id_t sid) {
+  return parked_.erase(sid);
+}
+
+bool CodsWarmPool::IsParked(fastotv::stream_id_t sid) const {
+  return parked_.find(sid) != parked_.end();
+}
+
+void CodsWarmPool::Release(fastotv::stream_id_t sid) {
+  parked_.erase(sid);
+}
+
+size_t CodsWarmPool::GetParkedCount() const {
+  return parked_.size();
+}
+
+double CodsWarmPool::GetScore(const Popularity& pop, fastotv::timestamp_t now) const {
+  if (!half_life_msec_ || now <= pop.ts) {
+    return pop.score;
+  }
+  return pop.score * exp2(-static_cast<double>(now - pop.ts) / half_life_msec_);
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,60 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <set>
+
+#include <common/macros.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+namespace server {
+
+// popularity of cods by playlist requests, most popular kept running with muted outputs after ttl
+class CodsWarmPool {
+ public:
+  CodsWarmPool(size_t size, fastotv::timestamp_t half_life_msec);  // hits weight halves every half life
+
+  void Hit(fastotv::stream_id_t sid, fastotv::timestamp_t now);
+  bool IsWarm(fastotv::stream_id_t sid, fastotv::timestamp_t now) const;  // among size most popular
+
+  // child kept after ttl, promoted by next request
+  void Park(fastotv::stream_id_t sid);
+  bool Unpark(fastotv::stream_id_t sid);  // false if not parked
+  bool IsParked(fastotv::stream_id_t sid) const;
+  void Release(fastotv::stream_id_t sid);  // child quit
+
+  size_t GetParkedCount() const;
+
+ private:
+  struct Popularity {
+    double score;
+    fastotv::timestamp_t ts;
+  };
+
+  double GetScore(const Popularity& pop, fastotv::timestamp_t now) const;
+
+  const size_t size_;
+  const fastotv::timestamp_t half_life_msec_;
+  std::map<fastotv::stream_id_t, Popularity> popularity_;
+  std::set<fastotv::stream_id_t> parked_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodsWarmPool);
+};
+
+}  // namespace server
+}  // namespace fastocloud
@@ -28,11 +28,51 @@
 #define SERVICE_VODS_HOST_FIELD "vods_host"
 #define SERVICE_CODS_HOST_FIELD "cods_host"
 #define SERVICE_CODS_TTL_FIELD "cods_ttl"
+#define SERVICE_CODS_WARM_POOL_FIELD "cods_warm_pool"
 #define SERVICE_FILES_TTL_FIELD "files_ttl"
 #define SERVICE_STREAMLINK_PATH_FIELD "streamlink_path"
+#define SERVICE_ZYGOTE_FIELD "zygote"
+#define SERVICE_PRESTARTED_STREAMS_FIELD "prestarted_streams"
+#define SERVICE_STATS_BATCH_FIELD "stats_batch"
+#define SERVICE_STATS_BATCH_DELTA_FIELD "stats_batch_delta"
+#define SERVICE_PIPE_BINARY_FIELD "pipe_binary"
+#define SERVICE_SEGMENT_CACHE_SIZE_FIELD "segment_cache_size"
+#define SERVICE_VODS_CODS_WORKERS_FIELD "vods_cods_workers"
+#define SERVICE_VODS_VIRTUAL_HLS_FIELD "vods_virtual_hls"
+#define SERVICE_MEMORY_ACCOUNTING_FIELD "memory_accounting"
+#define SERVICE_HEAP_RELEASE_INTERVAL_FIELD "heap_release_interval"
+#define SERVICE_QUARANTINE_FAILURES_FIELD "quarantine_failures"
+#define SERVICE_STREAMING_POOL_THREADS_FIELD "streaming_pool_threads"
+#define SERVICE_STREAMING_POOL_PIN_FIELD "streaming_pool_pin"
+#define SERVICE_NVENC_MAX_SESSIONS_FIELD "nvenc_max_sessions"
+#define SERVICE_GPU_MAX_LOAD_FIELD "gpu_max_load"
+#define SERVICE_ENCODE_CORES_PER_STREAM_FIELD "encode_cores_per_stream"
+#define SERVICE_MAX_PARALLEL_STARTS_FIELD "max_parallel_starts"
+#define SERVICE_CONFIG_WORKERS_FIELD "config_workers"
+#define SERVICE_HTTP_METRICS_FIELD "http_metrics"
+#define SERVICE_STATS_HISTORY_FIELD "stats_history"
+#define SERVICE_CGROUP_ROOT_FIELD "cgroup_root"
+#define SERVICE_CGROUP_CPU_LIMIT_FIELD "cgroup_cpu_limit"
+#define SERVICE_CGROUP_MEMORY_LIMIT_FIELD "cgroup_memory_limit"
+#define SERVICE_ADMISSION_CPU_LIMIT_FIELD "admission_cpu_limit"
+#define SERVICE_ADMISSION_BANDWIDTH_LIMIT_FIELD "admission_bandwidth_limit"
+#define SERVICE_OFFLINE_CPU_JOBS_FIELD "offline_cpu_jobs"
+#define SERVICE_OFFLINE_GPU_JOBS_FIELD "offline_gpu_jobs"
+#define SERVICE_OFFLINE_PAUSE_LOAD_FIELD "offline_pause_load"
+#define SERVICE_HLS_RETENTION_WINDOW_FIELD "hls_retention_window"
+#define SERVICE_HLS_RETENTION_MAX_FILES_FIELD "hls_retention_max_files"
+#define SERVICE_DISK_WRITE_CAPACITY_FIELD "disk_write_capacity"
+#define SERVICE_RELAY_HOST_STREAMS_FIELD "relay_host_streams"
+#define SERVICE_RADIO_HOST_STREAMS_FIELD "radio_host_streams"
+#define SERVICE_LOAD_HOST_STREAMS_FIELD "load_host_streams"
+#define SERVICE_SHARED_INGEST_FIELD "shared_ingest"
+#define SERVICE_PACKET_INGEST_IFACE_FIELD "packet_ingest_iface"
+#define SERVICE_ADOPT_STREAMS_FIELD "adopt_streams"
+#define SERVICE_UPLOAD_COMPRESSION_FIELD "upload_compression"
 #define SERVICE_LICENSE_KEY_FIELD "license_key"
 
 #define DUMMY_LOG_FILE_PATH "/dev/null"
+#define DEFAULT_HLS_RETENTION_MAX_FILES 10  // max files of static live hls outputs
 
 namespace {
 std::pair<std::string, std::string> GetKeyValue(const std::string& line, char separator) {
@@ -81,6 +121,11 @@ common::ErrnoError ReadConfigFile(const std::string& path, common::HashValue** a
       if (common::ConvertFromString(pair.second, &ttl)) {
         options->Insert(pair.first, common::Value::CreateTimeValue(ttl));
       }
+    } else if (pair.first == SERVICE_CODS_WARM_POOL_FIELD) {
+      int pool;
+      if (common::ConvertFromString(pair.second, &pool)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(pool));
+      }
     } else if (pair.first == SERVICE_FILES_TTL_FIELD) {
       time_t ttl;
       if (common::ConvertFromString(pair.second, &ttl)) {
@@ -88,6 +133,169 @@ common::ErrnoError ReadConfigFile(const std::string& path, common::HashValue** a
       }
     } else if (pair.first == SERVICE_STREAMLINK_PATH_FIELD) {
       options->Insert(pair.first, common::Value::CreateStringValueFromBasicString(pair.second));
+    } else if (pair.first == SERVICE_ZYGOTE_FIELD) {
+      bool zygote;
+      if (common::ConvertFromString(pair.second, &zygote)) {
+        options->Insert(pair.first, common::Value::CreateBooleanValue(zygote));
+      }
+    } else if (pair.first == SERVICE_PRESTARTED_STREAMS_FIELD) {
+      int streams;
+      if (common::ConvertFromString(pair.second, &streams)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(streams));
+      }
+    } else if (pair.first == SERVICE_STATS_BATCH_FIELD) {
+      time_t batch;
+      if (common::ConvertFromString(pair.second, &batch)) {
+        options->Insert(pair.first, common::Value::CreateTimeValue(batch));
+      }
+    } else if (pair.first == SERVICE_STATS_BATCH_DELTA_FIELD) {
+      bool delta;
+      if (common::ConvertFromString(pair.second, &delta)) {
+        options->Insert(pair.first, common::Value::CreateBooleanValue(delta));
+      }
+    } else if (pair.first == SERVICE_PIPE_BINARY_FIELD) {
+      bool binary;
+      if (common::ConvertFromString(pair.second, &binary)) {
+        options->Insert(pair.first, common::Value::CreateBooleanValue(binary));
+      }
+    } else if (pair.first == SERVICE_MEMORY_ACCOUNTING_FIELD) {
+      bool accounting;
+      if (common::ConvertFromString(pair.second, &accounting)) {
+        options->Insert(pair.first, common::Value::CreateBooleanValue(accounting));
+      }
+    } else if (pair.first == SERVICE_HEAP_RELEASE_INTERVAL_FIELD) {
+      int interval;
+      if (common::ConvertFromString(pair.second, &interval)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(interval));
+      }
+    } else if (pair.first == SERVICE_QUARANTINE_FAILURES_FIELD) {
+      int failures;
+      if (common::ConvertFromString(pair.second, &failures)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(failures));
+      }
+    } else if (pair.first == SERVICE_STREAMING_POOL_THREADS_FIELD) {
+      int threads;
+      if (common::ConvertFromString(pair.second, &threads)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(threads));
+      }
+    } else if (pair.first == SERVICE_STREAMING_POOL_PIN_FIELD) {
+      bool pin;
+      if (common::ConvertFromString(pair.second, &pin)) {
+        options->Insert(pair.first, common::Value::CreateBooleanValue(pin));
+      }
+    } else if (pair.first == SERVICE_SEGMENT_CACHE_SIZE_FIELD) {
+      int size;
+      if (common::ConvertFromString(pair.second, &size)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(size));
+      }
+    } else if (pair.first == SERVICE_VODS_CODS_WORKERS_FIELD) {
+      int workers;
+      if (common::ConvertFromString(pair.second, &workers)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(workers));
+      }
+    } else if (pair.first == SERVICE_VODS_VIRTUAL_HLS_FIELD) {
+      bool virtual_hls;
+      if (common::ConvertFromString(pair.second, &virtual_hls)) {
+        options->Insert(pair.first, common::Value::CreateBooleanValue(virtual_hls));
+      }
+    } else if (pair.first == SERVICE_NVENC_MAX_SESSIONS_FIELD) {
+      int sessions;
+      if (common::ConvertFromString(pair.second, &sessions)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(sessions));
+      }
+    } else if (pair.first == SERVICE_GPU_MAX_LOAD_FIELD) {
+      int load;
+      if (common::ConvertFromString(pair.second, &load)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(load));
+      }
+    } else if (pair.first == SERVICE_ENCODE_CORES_PER_STREAM_FIELD) {
+      int cores;
+      if (common::ConvertFromString(pair.second, &cores)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(cores));
+      }
+    } else if (pair.first == SERVICE_MAX_PARALLEL_STARTS_FIELD) {
+      int starts;
+      if (common::ConvertFromString(pair.second, &starts)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(starts));
+      }
+    } else if (pair.first == SERVICE_CONFIG_WORKERS_FIELD) {
+      int workers;
+      if (common::ConvertFromString(pair.second, &workers)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(workers));
+      }
+    } else if (pair.first == SERVICE_HTTP_METRICS_FIELD) {
+      bool metrics;
+      if (common::ConvertFromString(pair.second, &metrics)) {
+        options->Insert(pair.first, common::Value::CreateBooleanValue(metrics));
+      }
+    } else if (pair.first == SERVICE_STATS_HISTORY_FIELD) {
+      int minutes;
+      if (common::ConvertFromString(pair.second, &minutes)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(minutes));
+      }
+    } else if (pair.first == SERVICE_CGROUP_ROOT_FIELD) {
+      options->Insert(pair.first, common::Value::CreateStringValueFromBasicString(pair.second));
+    } else if (pair.first == SERVICE_CGROUP_CPU_LIMIT_FIELD) {
+      int limit;
+      if (common::ConvertFromString(pair.second, &limit)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(limit));
+      }
+    } else if (pair.first == SERVICE_CGROUP_MEMORY_LIMIT_FIELD) {
+      int limit;
+      if (common::ConvertFromString(pair.second, &limit)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(limit));
+      }
+    } else if (pair.first == SERVICE_ADMISSION_CPU_LIMIT_FIELD) {
+      int limit;
+      if (common::ConvertFromString(pair.second, &limit)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(limit));
+      }
+    } else if (pair.first == SERVICE_ADMISSION_BANDWIDTH_LIMIT_FIELD) {
+      int limit;
+      if (common::ConvertFromString(pair.second, &limit)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(limit));
+      }
+    } else if (pair.first == SERVICE_OFFLINE_CPU_JOBS_FIELD || pair.first == SERVICE_OFFLINE_GPU_JOBS_FIELD ||
+               pair.first == SERVICE_OFFLINE_PAUSE_LOAD_FIELD || pair.first == SERVICE_HLS_RETENTION_WINDOW_FIELD ||
+               pair.first == SERVICE_HLS_RETENTION_MAX_FILES_FIELD) {
+      int value;
+      if (common::ConvertFromString(pair.second, &value)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(value));
+      }
+    } else if (pair.first == SERVICE_DISK_WRITE_CAPACITY_FIELD) {
+      int capacity;
+      if (common::ConvertFromString(pair.second, &capacity)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(capacity));
+      }
+    } else if (pair.first == SERVICE_RELAY_HOST_STREAMS_FIELD) {
+      int streams;
+      if (common::ConvertFromString(pair.second, &streams)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(streams));
+      }
+    } else if (pair.first == SERVICE_RADIO_HOST_STREAMS_FIELD) {
+      int streams;
+      if (common::ConvertFromString(pair.second, &streams)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(streams));
+      }
+    } else if (pair.first == SERVICE_LOAD_HOST_STREAMS_FIELD) {
+      int streams;
+      if (common::ConvertFromString(pair.second, &streams)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(streams));
+      }
+    } else if (pair.first == SERVICE_SHARED_INGEST_FIELD) {
+      int shared;
+      if (common::ConvertFromString(pair.second, &shared)) {
+        options->Insert(pair.first, common::Value::CreateIntegerValue(shared));
+      }
+    } else if (pair.first == SERVICE_PACKET_INGEST_IFACE_FIELD) {
+      options->Insert(pair.first, common::Value::CreateStringValueFromBasicString(pair.second));
+    } else if (pair.first == SERVICE_ADOPT_STREAMS_FIELD) {
+      bool adopt;
+      if (common::ConvertFromString(pair.second, &adopt)) {
+        options->Insert(pair.first, common::Value::CreateBooleanValue(adopt));
+      }
+    } else if (pair.first == SERVICE_UPLOAD_COMPRESSION_FIELD) {
+      options->Insert(pair.first, common::Value::CreateStringValueFromBasicString(pair.second));
     } else if (pair.first == SERVICE_LICENSE_KEY_FIELD) {
       options->Insert(pair.first, common::Value::CreateStringValueFromBasicString(pair.second));
     }
@@ -107,8 +315,47 @@ Config::Config()
       log_path(DUMMY_LOG_FILE_PATH),
       log_level(common::logging::LOG_LEVEL_INFO),
       cods_ttl(CODS_TTL),
+      cods_warm_pool(0),
       files_ttl(FILES_TTL),
       streamlink_path(STREAMER_SERVICE_STREAMLINK_PATH),
+      zygote(false),
+      prestarted_streams(0),
+      stats_batch(0),
+      stats_batch_delta(false),
+      pipe_binary(false),
+      segment_cache_size(0),
+      vods_cods_workers(1),
+      vods_virtual_hls(false),
+      memory_accounting(false),
+      heap_release_interval(0),
+      quarantine_failures(0),
+      streaming_pool_threads(0),
+      streaming_pool_pin(false),
+      nvenc_max_sessions(3),
+      gpu_max_load(90),
+      encode_cores_per_stream(0),
+      max_parallel_starts(0),
+      config_workers(2),
+      http_metrics(false),
+      stats_history(0),
+      cgroup_root(),
+      cgroup_cpu_limit(0),
+      cgroup_memory_limit(0),
+      admission_cpu_limit(0),
+      admission_bandwidth_limit(0),
+      offline_cpu_jobs(0),
+      offline_gpu_jobs(0),
+      offline_pause_load(0),
+      hls_retention_window(0),
+      hls_retention_max_files(DEFAULT_HLS_RETENTION_MAX_FILES),
+      disk_write_capacity(0),
+      relay_host_streams(0),
+      radio_host_streams(0),
+      load_host_streams(0),
+      shared_ingest(0),
+      packet_ingest_iface(),
+      adopt_streams(false),
+      upload_compression(UPLOAD_COMPRESSION_NONE),
       license_key() {}
 
 common::net::HostAndPort Config::GetDefaultHost() {
@@ -189,6 +436,12 @@ common::ErrnoError load_config_from_file(const std::string& config_absolute_path
     lconfig.cods_ttl = CODS_TTL;
   }
 
+  common::Value* cods_warm_pool_field = slave_config_args->Find(SERVICE_CODS_WARM_POOL_FIELD);
+  if (!cods_warm_pool_field || !cods_warm_pool_field->GetAsInteger(&lconfig.cods_warm_pool) ||
+      lconfig.cods_warm_pool < 0) {
+    lconfig.cods_warm_pool = 0;
+  }
+
   common::Value* files_ttl_field = slave_config_args->Find(SERVICE_FILES_TTL_FIELD);
   if (!files_ttl_field || !files_ttl_field->GetAsTime(&lconfig.files_ttl)) {
     lconfig.files_ttl = FILES_TTL;
@@ -199,6 +452,227 @@ common::ErrnoError load_config_from_file(const std::string& config_absolute_path
     lconfig.streamlink_path = STREAMER_SERVICE_STREAMLINK_PATH;
   }
 
+  common::Value* zygote_field = slave_config_args->Find(SERVICE_ZYGOTE_FIELD);
+  if (!zygote_field || !zygote_field->GetAsBoolean(&lconfig.zygote)) {
+    lconfig.zygote = false;
+  }
+
+  common::Value* prestarted_streams_field = slave_config_args->Find(SERVICE_PRESTARTED_STREAMS_FIELD);
+  if (!prestarted_streams_field || !prestarted_streams_field->GetAsInteger(&lconfig.prestarted_streams) ||
+      lconfig.prestarted_streams < 0) {
+    lconfig.prestarted_streams = 0;
+  }
+
+  common::Value* stats_batch_field = slave_config_args->Find(SERVICE_STATS_BATCH_FIELD);
+  if (!stats_batch_field || !stats_batch_field->GetAsTime(&lconfig.stats_batch)) {
+    lconfig.stats_batch = 0;
+  }
+
+  common::Value* stats_batch_delta_field = slave_config_args->Find(SERVICE_STATS_BATCH_DELTA_FIELD);
+  if (!stats_batch_delta_field || !stats_batch_delta_field->GetAsBoolean(&lconfig.stats_batch_delta)) {
+    lconfig.stats_batch_delta = false;
+  }
+
+  common::Value* pipe_binary_field = slave_config_args->Find(SERVICE_PIPE_BINARY_FIELD);
+  if (!pipe_binary_field || !pipe_binary_field->GetAsBoolean(&lconfig.pipe_binary)) {
+    lconfig.pipe_binary = false;
+  }
+
+  common::Value* segment_cache_size_field = slave_config_args->Find(SERVICE_SEGMENT_CACHE_SIZE_FIELD);
+  if (!segment_cache_size_field || !segment_cache_size_field->GetAsInteger(&lconfig.segment_cache_size) ||
+      lconfig.segment_cache_size < 0) {
+    lconfig.segment_cache_size = 0;
+  }
+
+  common::Value* vods_cods_workers_field = slave_config_args->Find(SERVICE_VODS_CODS_WORKERS_FIELD);
+  if (!vods_cods_workers_field || !vods_cods_workers_field->GetAsInteger(&lconfig.vods_cods_workers) ||
+      lconfig.vods_cods_workers < 1) {
+    lconfig.vods_cods_workers = 1;
+  }
+
+  common::Value* vods_virtual_hls_field = slave_config_args->Find(SERVICE_VODS_VIRTUAL_HLS_FIELD);
+  if (!vods_virtual_hls_field || !vods_virtual_hls_field->GetAsBoolean(&lconfig.vods_virtual_hls)) {
+    lconfig.vods_virtual_hls = false;
+  }
+
+  common::Value* memory_accounting_field = slave_config_args->Find(SERVICE_MEMORY_ACCOUNTING_FIELD);
+  if (!memory_accounting_field || !memory_accounting_field->GetAsBoolean(&lconfig.memory_accounting)) {
+    lconfig.memory_accounting = false;
+  }
+
+  common::Value* heap_release_interval_field = slave_config_args->Find(SERVICE_HEAP_RELEASE_INTERVAL_FIELD);
+  if (!heap_release_interval_field ||
+      !heap_release_interval_field->GetAsInteger(&lconfig.heap_release_interval) ||
+      lconfig.heap_release_interval < 0) {
+    lconfig.heap_release_interval = 0;
+  }
+
+  common::Value* quarantine_failures_field = slave_config_args->Find(SERVICE_QUARANTINE_FAILURES_FIELD);
+  if (!quarantine_failures_field || !quarantine_failures_field->GetAsInteger(&lconfig.quarantine_failures) ||
+      lconfig.quarantine_failures < 0) {
+    lconfig.quarantine_failures = 0;
+  }
+
+  common::Value* streaming_pool_threads_field = slave_config_args->Find(SERVICE_STREAMING_POOL_THREADS_FIELD);
+  if (!streaming_pool_threads_field ||
+      !streaming_pool_threads_field->GetAsInteger(&lconfig.streaming_pool_threads) ||
+      lconfig.streaming_pool_threads < 0) {
+    lconfig.streaming_pool_threads = 0;
+  }
+
+  common::Value* streaming_pool_pin_field = slave_config_args->Find(SERVICE_STREAMING_POOL_PIN_FIELD);
+  if (!streaming_pool_pin_field || !streaming_pool_pin_field->GetAsBoolean(&lconfig.streaming_pool_pin)) {
+    lconfig.streaming_pool_pin = false;
+  }
+
+  common::Value* nvenc_max_sessions_field = slave_config_args->Find(SERVICE_NVENC_MAX_SESSIONS_FIELD);
+  if (!nvenc_max_sessions_field || !nvenc_max_sessions_field->GetAsInteger(&lconfig.nvenc_max_sessions) ||
+      lconfig.nvenc_max_sessions < 0) {
+    lconfig.nvenc_max_sessions = 3;
+  }
+
+  common::Value* gpu_max_load_field = slave_config_args->Find(SERVICE_GPU_MAX_LOAD_FIELD);
+  if (!gpu_max_load_field || !gpu_max_load_field->GetAsInteger(&lconfig.gpu_max_load) || lconfig.gpu_max_load < 0 ||
+      lconfig.gpu_max_load > 100) {
+    lconfig.gpu_max_load = 90;
+  }
+
+  common::Value* encode_cores_field = slave_config_args->Find(SERVICE_ENCODE_CORES_PER_STREAM_FIELD);
+  if (!encode_cores_field || !encode_cores_field->GetAsInteger(&lconfig.encode_cores_per_stream) ||
+      lconfig.encode_cores_per_stream < 0) {
+    lconfig.encode_cores_per_stream = 0;
+  }
+
+  common::Value* max_parallel_starts_field = slave_config_args->Find(SERVICE_MAX_PARALLEL_STARTS_FIELD);
+  if (!max_parallel_starts_field || !max_parallel_starts_field->GetAsInteger(&lconfig.max_parallel_starts) ||
+      lconfig.max_parallel_starts < 0) {
+    lconfig.max_parallel_starts = 0;
+  }
+
+  common::Value* config_workers_field = slave_config_args->Find(SERVICE_CONFIG_WORKERS_FIELD);
+  if (!config_workers_field || !config_workers_field->GetAsInteger(&lconfig.config_workers) ||
+      lconfig.config_workers < 0) {
+    lconfig.config_workers = 2;
+  }
+
+  common::Value* http_metrics_field = slave_config_args->Find(SERVICE_HTTP_METRICS_FIELD);
+  if (!http_metrics_field || !http_metrics_field->GetAsBoolean(&lconfig.http_metrics)) {
+    lconfig.http_metrics = false;
+  }
+
+  common::Value* stats_history_field = slave_config_args->Find(SERVICE_STATS_HISTORY_FIELD);
+  if (!stats_history_field || !stats_history_field->GetAsInteger(&lconfig.stats_history) ||
+      lconfig.stats_history < 0) {
+    lconfig.stats_history = 0;
+  }
+
+  common::Value* cgroup_root_field = slave_config_args->Find(SERVICE_CGROUP_ROOT_FIELD);
+  if (!cgroup_root_field || !cgroup_root_field->GetAsBasicString(&lconfig.cgroup_root)) {
+    lconfig.cgroup_root = std::string();
+  }
+
+  common::Value* cgroup_cpu_limit_field = slave_config_args->Find(SERVICE_CGROUP_CPU_LIMIT_FIELD);
+  if (!cgroup_cpu_limit_field || !cgroup_cpu_limit_field->GetAsInteger(&lconfig.cgroup_cpu_limit) ||
+      lconfig.cgroup_cpu_limit < 0) {
+    lconfig.cgroup_cpu_limit = 0;
+  }
+
+  common::Value* cgroup_memory_limit_field = slave_config_args->Find(SERVICE_CGROUP_MEMORY_LIMIT_FIELD);
+  if (!cgroup_memory_limit_field || !cgroup_memory_limit_field->GetAsInteger(&lconfig.cgroup_memory_limit) ||
+      lconfig.cgroup_memory_limit < 0) {
+    lconfig.cgroup_memory_limit = 0;
+  }
+
+  common::Value* admission_cpu_limit_field = slave_config_args->Find(SERVICE_ADMISSION_CPU_LIMIT_FIELD);
+  if (!admission_cpu_limit_field || !admission_cpu_limit_field->GetAsInteger(&lconfig.admission_cpu_limit) ||
+      lconfig.admission_cpu_limit < 0) {
+    lconfig.admission_cpu_limit = 0;
+  }
+
+  common::Value* admission_bandwidth_limit_field = slave_config_args->Find(SERVICE_ADMISSION_BANDWIDTH_LIMIT_FIELD);
+  if (!admission_bandwidth_limit_field ||
+      !admission_bandwidth_limit_field->GetAsInteger(&lconfig.admission_bandwidth_limit) ||
+      lconfig.admission_bandwidth_limit < 0) {
+    lconfig.admission_bandwidth_limit = 0;
+  }
+
+  common::Value* offline_cpu_jobs_field = slave_config_args->Find(SERVICE_OFFLINE_CPU_JOBS_FIELD);
+  if (!offline_cpu_jobs_field || !offline_cpu_jobs_field->GetAsInteger(&lconfig.offline_cpu_jobs) ||
+      lconfig.offline_cpu_jobs < 0) {
+    lconfig.offline_cpu_jobs = 0;
+  }
+
+  common::Value* offline_gpu_jobs_field = slave_config_args->Find(SERVICE_OFFLINE_GPU_JOBS_FIELD);
+  if (!offline_gpu_jobs_field || !offline_gpu_jobs_field->GetAsInteger(&lconfig.offline_gpu_jobs) ||
+      lconfig.offline_gpu_jobs < 0) {
+    lconfig.offline_gpu_jobs = 0;
+  }
+
+  common::Value* offline_pause_load_field = slave_config_args->Find(SERVICE_OFFLINE_PAUSE_LOAD_FIELD);
+  if (!offline_pause_load_field || !offline_pause_load_field->GetAsInteger(&lconfig.offline_pause_load) ||
+      lconfig.offline_pause_load < 0 || lconfig.offline_pause_load > 100) {
+    lconfig.offline_pause_load = 0;
+  }
+
+  common::Value* hls_retention_window_field = slave_config_args->Find(SERVICE_HLS_RETENTION_WINDOW_FIELD);
+  if (!hls_retention_window_field || !hls_retention_window_field->GetAsInteger(&lconfig.hls_retention_window) ||
+      lconfig.hls_retention_window < 0) {
+    lconfig.hls_retention_window = 0;
+  }
+
+  common::Value* hls_retention_max_files_field = slave_config_args->Find(SERVICE_HLS_RETENTION_MAX_FILES_FIELD);
+  if (!hls_retention_max_files_field ||
+      !hls_retention_max_files_field->GetAsInteger(&lconfig.hls_retention_max_files) ||
+      lconfig.hls_retention_max_files <= 0) {
+    lconfig.hls_retention_max_files = DEFAULT_HLS_RETENTION_MAX_FILES;
+  }
+
+  common::Value* disk_write_capacity_field = slave_config_args->Find(SERVICE_DISK_WRITE_CAPACITY_FIELD);
+  if (!disk_write_capacity_field || !disk_write_capacity_field->GetAsInteger(&lconfig.disk_write_capacity) ||
+      lconfig.disk_write_capacity < 0) {
+    lconfig.disk_write_capacity = 0;
+  }
+
+  common::Value* relay_host_streams_field = slave_config_args->Find(SERVICE_RELAY_HOST_STREAMS_FIELD);
+  if (!relay_host_streams_field || !relay_host_streams_field->GetAsInteger(&lconfig.relay_host_streams) ||
+      lconfig.relay_host_streams < 0) {
+    lconfig.relay_host_streams = 0;
+  }
+
+  common::Value* radio_host_streams_field = slave_config_args->Find(SERVICE_RADIO_HOST_STREAMS_FIELD);
+  if (!radio_host_streams_field || !radio_host_streams_field->GetAsInteger(&lconfig.radio_host_streams) ||
+      lconfig.radio_host_streams < 0) {
+    lconfig.radio_host_streams = 0;
+  }
+
+  common::Value* load_host_streams_field = slave_config_args->Find(SERVICE_LOAD_HOST_STREAMS_FIELD);
+  if (!load_host_streams_field || !load_host_streams_field->GetAsInteger(&lconfig.load_host_streams) ||
+      lconfig.load_host_streams < 0) {
+    lconfig.load_host_streams = 0;
+  }
+
+  common::Value* shared_ingest_field = slave_config_args->Find(SERVICE_SHARED_INGEST_FIELD);
+  if (!shared_ingest_field || !shared_ingest_field->GetAsInteger(&lconfig.shared_ingest) || lconfig.shared_ingest < 0) {
+    lconfig.shared_ingest = 0;
+  }
+
+  common::Value* packet_ingest_iface_field = slave_config_args->Find(SERVICE_PACKET_INGEST_IFACE_FIELD);
+  if (!packet_ingest_iface_field || !packet_ingest_iface_field->GetAsBasicString(&lconfig.packet_ingest_iface)) {
+    lconfig.packet_ingest_iface = std::string();
+  }
+
+  common::Value* adopt_streams_field = slave_config_args->Find(SERVICE_ADOPT_STREAMS_FIELD);
+  if (!adopt_streams_field || !adopt_streams_field->GetAsBoolean(&lconfig.adopt_streams)) {
+    lconfig.adopt_streams = false;
+  }
+
+  common::Value* upload_compression_field = slave_config_args->Find(SERVICE_UPLOAD_COMPRESSION_FIELD);
+  if (!upload_compression_field || !upload_compression_field->GetAsBasicString(&lconfig.upload_compression) ||
+      (lconfig.upload_compression != UPLOAD_COMPRESSION_NONE && lconfig.upload_compression != UPLOAD_COMPRESSION_GZIP &&
+       lconfig.upload_compression != UPLOAD_COMPRESSION_ZSTD)) {
+    lconfig.upload_compression = UPLOAD_COMPRESSION_NONE;
+  }
+
   *config = lconfig;
   delete slave_config_args;
   return common::ErrnoError();
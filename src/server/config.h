@@ -21,6 +21,10 @@
 #include <common/net/types.h>
 #include <common/optional.h>
 
+#define UPLOAD_COMPRESSION_NONE "none"
+#define UPLOAD_COMPRESSION_GZIP "gzip"
+#define UPLOAD_COMPRESSION_ZSTD "zstd"
+
 namespace fastocloud {
 namespace server {
 
@@ -40,8 +44,49 @@ struct Config {
   common::net::HostAndPort vods_host;
   common::net::HostAndPort cods_host;
   time_t cods_ttl;  // in seconds
+  int cods_warm_pool;  // most popular cods kept running with muted outputs after ttl, 0 - stopped
   time_t files_ttl;
   std::string streamlink_path;
+  bool zygote;  // fork streams from preinited helper process
+  int prestarted_streams;  // windows, idle stream processes with gstreamer initialized, 0 - started on request
+  time_t stats_batch;  // in seconds, 0 - broadcast statistic of every stream immediately
+  bool stats_batch_delta;
+  bool pipe_binary;  // binary framing on stream pipes instead of json rpc
+  int segment_cache_size;  // in megabytes, 0 - vods/cods segments always read from disk
+  int vods_cods_workers;   // serving loops per vods/cods server, 1 - clients served by accepting loop
+  bool vods_virtual_hls;   // hls of vods ts files sliced on request by keyframe index, no stream started
+  bool memory_accounting;  // stream children count buffers memory by element in statistic and profile report
+  int heap_release_interval;  // in seconds, stream children return free heap pages to system, 0 - allocator decides
+  int quarantine_failures;    // short failed runs in row before stream only polls source, 0 - restarted forever
+  int streaming_pool_threads;  // idle streaming threads reused by tasks of stream child, 0 - gstreamer default pool
+  bool streaming_pool_pin;     // streaming threads of not pinned stream child on one cpu, round robin by start
+  int nvenc_max_sessions;  // concurrent nvenc streams, 0 - unlimited, over limit streams encoded on cpu
+  int gpu_max_load;        // in percents, 0 - ignore load, at this load new streams encoded on cpu
+  int encode_cores_per_stream;  // physical cores pinned to encoding stream, 0 - streams not pinned
+  int max_parallel_starts;      // pipelines built at once on node, 0 - unlimited
+  int config_workers;           // threads parsing and validating stream configs, 0 - done on daemon loop
+  bool http_metrics;            // node and streams statistic in prometheus text format on http_host /metrics
+  int stats_history;            // in minutes of node and streams metrics kept by daemon, 0 - only last values
+  std::string cgroup_root;      // delegated cgroup v2 directory of stream children, empty - not used, linux only
+                                // windows - name prefix of job objects of children
+  int cgroup_cpu_limit;         // in percents of one cpu per stream, 0 - unlimited
+  int cgroup_memory_limit;      // in megabytes per stream with page cache, 0 - unlimited
+  int admission_cpu_limit;        // in percents of node, starts estimated to exceed it rejected, 0 - unchecked
+  int admission_bandwidth_limit;  // in megabits per second sent by node, 0 - unchecked
+  int offline_cpu_jobs;           // vod transcodes on cpu encoders running at once, queued above it, 0 - unlimited
+  int offline_gpu_jobs;           // vod transcodes on gpu encoders running at once, 0 - unlimited
+  int offline_pause_load;         // in percents of node used by live streams, vod transcodes paused above it
+                                  // posix only, 0 - never; all offline 0 - vod transcodes started on request
+  int hls_retention_window;       // sec of viewer requests sizing segments kept by live hls outputs, 0 - static
+  int hls_retention_max_files;    // segments kept for viewers far behind live edge
+  int disk_write_capacity;        // in megabytes per second of node disks, reported to controller, 0 - unknown
+  int relay_host_streams;         // relay streams sharing one process as threads, 0 - process per stream
+  int radio_host_streams;         // audio only encode streams sharing one process as threads, 0 - process per stream
+  int load_host_streams;          // load:// generated encode streams sharing one process as threads, soak tests
+  int shared_ingest;              // 1 - one upstream connection per live input url on node, 0 - per stream
+  std::string packet_ingest_iface;  // udp multicast of node received from packet ring of it, empty - by streams
+  bool adopt_streams;             // streams survive stop of service, adopted by next one started, posix only
+  std::string upload_compression;  // none, gzip or zstd, codec of logs, pipelines and profiles sent to controller
   license_t license_key;
 };
 
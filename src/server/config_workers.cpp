@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/config_workers.h"
+
+#include <utility>
+
+namespace fastocloud {
+namespace server {
+
+ConfigWorkers::ConfigWorkers(size_t count) : tasks_mutex_(), tasks_cond_(), tasks_(), stop_(false), workers_() {
+  for (size_t i = 0; i < count; ++i) {
+    workers_.push_back(std::thread(&ConfigWorkers::WorkLoop, this));
+  }
+}
+
+ConfigWorkers::~ConfigWorkers() {
+  {
+    std::unique_lock<std::mutex> lock(tasks_mutex_);
+    stop_ = true;
+    tasks_.clear();
+    tasks_cond_.notify_all();
+  }
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i].join();
+  }
+}
+
+void ConfigWorkers::Post(task_t task) {
+  std::unique_lock<std::mutex> lock(tasks_mutex_);
+  tasks_.push_back(std::move(task));
+  tasks_cond_.notify_one();
+}
+
+size_t ConfigWorkers::GetWorkersCount() const {
+  return workers_.size();
+}
+
+void ConfigWorkers::WorkLoop() {
+  while (true) {
+    task_t task;
+    {
+      std::unique_lock<std::mutex> lock(tasks_mutex_);
+      while (!stop_ && tasks_.empty()) {
+        tasks_cond_.wait(lock);
+      }
+      if (stop_) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace server
+}  // namespace fastocloud
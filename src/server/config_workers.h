@@ -0,0 +1,54 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace server {
+
+// threads parsing and validating stream configs, tasks post their results back to daemon loop
+class ConfigWorkers {
+ public:
+  typedef std::function<void()> task_t;
+
+  explicit ConfigWorkers(size_t count);
+  ~ConfigWorkers();  // not started tasks dropped, running joined
+
+  void Post(task_t task);
+
+  size_t GetWorkersCount() const;
+
+ private:
+  void WorkLoop();
+
+  std::mutex tasks_mutex_;
+  std::condition_variable tasks_cond_;
+  std::deque<task_t> tasks_;
+  bool stop_;
+  std::vector<std::thread> workers_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConfigWorkers);
+};
+
+}  // namespace server
+}  // namespace fastocloud
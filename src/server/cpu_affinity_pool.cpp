@@ -0,0 +1,185 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/cpu_affinity_pool.h"
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#define SYSFS_CPU_PATH "/sys/devices/system/cpu/"
+#define SYSFS_NODE_PATH "/sys/devices/system/node/"
+#define MAX_NUMA_NODES 64
+
+namespace {
+
+bool ReadLine(const std::string& path, std::string* line) {
+  std::ifstream file(path);
+  return file.is_open() && std::getline(file, *line);
+}
+
+// "0-3,8,10-11" => 0 1 2 3 8 10 11
+std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> result;
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    int first = 0, last = 0;
+    const size_t dash = range.find('-');
+    std::stringstream first_stream(range.substr(0, dash));
+    if (!(first_stream >> first)) {
+      continue;
+    }
+    last = first;
+    if (dash != std::string::npos) {
+      std::stringstream last_stream(range.substr(dash + 1));
+      if (!(last_stream >> last)) {
+        continue;
+      }
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+namespace fastocloud {
+namespace server {
+
+CpuAffinityPool::CpuAffinityPool(const cores_t& cores, size_t cores_per_stream)
+    : cores_(cores), cores_per_stream_(cores_per_stream), usage_(cores.size(), 0), assigned_() {}
+
+CpuAffinityPool::cores_t CpuAffinityPool::DetectCores() {
+  std::string online;
+  if (!ReadLine(SYSFS_CPU_PATH "online", &online)) {
+    return cores_t();
+  }
+
+  std::map<int, int> node_by_cpu;
+  for (int node = 0; node < MAX_NUMA_NODES; ++node) {
+    std::string node_cpus;
+    if (!ReadLine(SYSFS_NODE_PATH "node" + std::to_string(node) + "/cpulist", &node_cpus)) {
+      continue;
+    }
+    for (int cpu : ParseCpuList(node_cpus)) {
+      node_by_cpu[cpu] = node;
+    }
+  }
+
+  cores_t cores;
+  std::set<int> seen;
+  for (int cpu : ParseCpuList(online)) {
+    if (seen.find(cpu) != seen.end()) {
+      continue;
+    }
+
+    Core core;
+    core.node = node_by_cpu.count(cpu) ? node_by_cpu[cpu] : 0;
+    std::string siblings;
+    const std::string topology = SYSFS_CPU_PATH "cpu" + std::to_string(cpu) + "/topology/";
+    if (ReadLine(topology + "thread_siblings_list", &siblings) ||
+        ReadLine(topology + "core_cpus_list", &siblings)) {
+      core.cpus = ParseCpuList(siblings);
+    }
+    if (core.cpus.empty()) {
+      core.cpus.push_back(cpu);
+    }
+    for (int sibling : core.cpus) {
+      seen.insert(sibling);
+    }
+    cores.push_back(core);
+  }
+  return cores;
+}
+
+bool CpuAffinityPool::Acquire(fastotv::stream_id_t sid, cpus_t* cpus) {
+  if (!cpus || cores_.empty() || !cores_per_stream_) {
+    return false;
+  }
+
+  Release(sid);
+
+  std::map<int, std::vector<size_t>> cores_by_node;
+  for (size_t i = 0; i < cores_.size(); ++i) {
+    cores_by_node[cores_[i].node].push_back(i);
+  }
+
+  // stream never spans nodes, pick node where least used cores are least loaded
+  std::vector<size_t> best;
+  size_t best_usage = 0;
+  for (auto it = cores_by_node.begin(); it != cores_by_node.end(); ++it) {
+    std::vector<size_t> candidates = it->second;
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [this](size_t left, size_t right) { return usage_[left] < usage_[right]; });
+    candidates.resize(std::min(candidates.size(), cores_per_stream_));
+    size_t total_usage = 0;
+    for (size_t core : candidates) {
+      total_usage += usage_[core];
+    }
+    if (best.empty() || candidates.size() > best.size() ||
+        (candidates.size() == best.size() && total_usage < best_usage)) {
+      best = candidates;
+      best_usage = total_usage;
+    }
+  }
+
+  cpus->clear();
+  for (size_t core : best) {
+    usage_[core]++;
+    cpus->insert(cpus->end(), cores_[core].cpus.begin(), cores_[core].cpus.end());
+  }
+  std::sort(cpus->begin(), cpus->end());
+  assigned_[sid] = best;
+  return true;
+}
+
+void CpuAffinityPool::Restore(fastotv::stream_id_t sid, const cpus_t& cpus) {
+  Release(sid);
+  std::vector<size_t> restored;
+  for (size_t i = 0; i < cores_.size(); ++i) {
+    const cpus_t& siblings = cores_[i].cpus;
+    const bool used = std::find_first_of(siblings.begin(), siblings.end(), cpus.begin(), cpus.end()) != siblings.end();
+    if (used) {
+      usage_[i]++;
+      restored.push_back(i);
+    }
+  }
+  if (!restored.empty()) {
+    assigned_[sid] = restored;
+  }
+}
+
+void CpuAffinityPool::Release(fastotv::stream_id_t sid) {
+  auto it = assigned_.find(sid);
+  if (it == assigned_.end()) {
+    return;
+  }
+
+  for (size_t core : it->second) {
+    usage_[core]--;
+  }
+  assigned_.erase(it);
+}
+
+size_t CpuAffinityPool::GetCoresCount() const {
+  return cores_.size();
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,60 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <common/macros.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+namespace server {
+
+// physical cores of host grouped by numa node, assigned to encoding children as cpu sets
+class CpuAffinityPool {
+ public:
+  typedef std::vector<int> cpus_t;  // logical cpus
+
+  struct Core {
+    int node;
+    cpus_t cpus;  // smt siblings of one physical core
+  };
+  typedef std::vector<Core> cores_t;
+
+  CpuAffinityPool(const cores_t& cores, size_t cores_per_stream);
+
+  static cores_t DetectCores();  // linux sysfs, empty if unknown
+
+  // least used cores of one numa node, false if pool empty
+  bool Acquire(fastotv::stream_id_t sid, cpus_t* cpus);
+  void Release(fastotv::stream_id_t sid);
+  void Restore(fastotv::stream_id_t sid, const cpus_t& cpus);  // cores of running stream adopted from previous service
+
+  size_t GetCoresCount() const;
+
+ private:
+  const cores_t cores_;
+  const size_t cores_per_stream_;
+  std::vector<size_t> usage_;                                  // streams by core index
+  std::map<fastotv::stream_id_t, std::vector<size_t>> assigned_;  // core indexes by stream
+
+  DISALLOW_COPY_AND_ASSIGN(CpuAffinityPool);
+};
+
+}  // namespace server
+}  // namespace fastocloud
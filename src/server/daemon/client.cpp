@@ -14,15 +14,21 @@
 
 #include "server/daemon/client.h"
 
+#if defined(OS_POSIX)
+#include <poll.h>
+#endif
+
 #include <string>
 
 #include "server/daemon/commands_factory.h"
 
+#define MAX_QUEUED_REQUESTS 256
+
 namespace fastocloud {
 namespace server {
 
 ProtocoledDaemonClient::ProtocoledDaemonClient(common::libev::IoLoop* server, const common::net::socket_info& info)
-    : base_class(server, info) {}
+    : base_class(server, info), queue_() {}
 
 common::ErrnoError ProtocoledDaemonClient::ActivateMe(const common::license::expire_key_t& license) {
   const common::daemon::commands::ActivateInfo ac_req(license);
@@ -213,6 +219,91 @@ common::ErrnoError ProtocoledDaemonClient::StopStreamSuccess(fastotv::protocol::
   return WriteResponse(resp);
 }
 
+common::ErrnoError ProtocoledDaemonClient::UpdateStreamFail(fastotv::protocol::sequance_id_t id, common::Error err) {
+  const std::string error_str = err->GetDescription();
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = UpdateStreamResponseFail(id, error_str, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::UpdateStreamSuccess(fastotv::protocol::sequance_id_t id) {
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = UpdateStreamResponseSuccess(id, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::ProfileStreamFail(fastotv::protocol::sequance_id_t id, common::Error err) {
+  const std::string error_str = err->GetDescription();
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = ProfileStreamResponseFail(id, error_str, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::ProfileStreamSuccess(fastotv::protocol::sequance_id_t id) {
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = ProfileStreamResponseSuccess(id, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::UnmuteStreamFail(fastotv::protocol::sequance_id_t id, common::Error err) {
+  const std::string error_str = err->GetDescription();
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = UnmuteStreamResponseFail(id, error_str, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::UnmuteStreamSuccess(fastotv::protocol::sequance_id_t id) {
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = UnmuteStreamResponseSuccess(id, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::BatchStreamsFail(fastotv::protocol::sequance_id_t id, common::Error err) {
+  const std::string error_str = err->GetDescription();
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = BatchStreamsResponseFail(id, error_str, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::BatchStreamsSuccess(fastotv::protocol::sequance_id_t id,
+                                                               const std::string& result) {
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = BatchStreamsResponseSuccess(id, result, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
 common::ErrnoError ProtocoledDaemonClient::SyncServiceSuccess(fastotv::protocol::sequance_id_t id) {
   fastotv::protocol::response_t resp;
   common::Error err_ser = SyncServiceResponceSuccess(id, &resp);
@@ -223,5 +314,99 @@ common::ErrnoError ProtocoledDaemonClient::SyncServiceSuccess(fastotv::protocol:
   return WriteResponse(resp);
 }
 
+common::ErrnoError ProtocoledDaemonClient::StreamsStatusServiceSuccess(fastotv::protocol::sequance_id_t id,
+                                                                       const std::string& result) {
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = StreamsStatusServiceResponseSuccess(id, result, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::StatsHistoryServiceSuccess(fastotv::protocol::sequance_id_t id,
+                                                                      const std::string& result) {
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = StatsHistoryServiceResponseSuccess(id, result, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::StatsHistoryServiceFail(fastotv::protocol::sequance_id_t id,
+                                                                   common::Error err) {
+  const std::string error_str = err->GetDescription();
+  fastotv::protocol::response_t resp;
+  common::Error err_ser = StatsHistoryServiceResponseFail(id, error_str, &resp);
+  if (err_ser) {
+    return common::make_errno_error(err_ser->GetDescription(), EAGAIN);
+  }
+
+  return WriteResponse(resp);
+}
+
+common::ErrnoError ProtocoledDaemonClient::QueueRequest(const fastotv::protocol::request_t& req,
+                                                        const std::string& key) {
+  if (queue_.empty() && IsWritable()) {
+    return WriteRequest(req);
+  }
+
+  if (!key.empty()) {
+    for (QueuedRequest& queued : queue_) {
+      if (queued.key == key) {
+        queued.req = req;
+        return common::ErrnoError();
+      }
+    }
+  }
+
+  if (queue_.size() >= MAX_QUEUED_REQUESTS) {
+    auto replaceable = queue_.begin();
+    while (replaceable != queue_.end() && replaceable->key.empty()) {
+      ++replaceable;
+    }
+    if (replaceable == queue_.end()) {
+      return common::make_errno_error("Client not reading, queue full", ENOBUFS);
+    }
+    queue_.erase(replaceable);  // oldest statistic, newer one follows
+  }
+
+  QueuedRequest queued;
+  queued.key = key;
+  queued.req = req;
+  queue_.push_back(queued);
+  return FlushQueue();
+}
+
+common::ErrnoError ProtocoledDaemonClient::FlushQueue() {
+  while (!queue_.empty() && IsWritable()) {
+    common::ErrnoError err = WriteRequest(queue_.front().req);
+    queue_.pop_front();
+    if (err) {
+      return err;
+    }
+  }
+  return common::ErrnoError();
+}
+
+size_t ProtocoledDaemonClient::GetQueueSize() const {
+  return queue_.size();
+}
+
+bool ProtocoledDaemonClient::IsWritable() const {
+#if defined(OS_POSIX)
+  struct pollfd pfd;
+  pfd.fd = GetFd();
+  pfd.events = POLLOUT;
+  pfd.revents = 0;
+  return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLOUT);
+#else
+  return true;
+#endif
+}
+
 }  // namespace server
 }  // namespace fastocloud
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <deque>
 #include <string>
 
 #include <common/daemon/client.h>
@@ -63,7 +64,42 @@ class ProtocoledDaemonClient : public fastotv::protocol::ProtocolClient<common::
   common::ErrnoError StopStreamFail(fastotv::protocol::sequance_id_t id, common::Error err) WARN_UNUSED_RESULT;
   common::ErrnoError StopStreamSuccess(fastotv::protocol::sequance_id_t id) WARN_UNUSED_RESULT;
 
+  common::ErrnoError UpdateStreamFail(fastotv::protocol::sequance_id_t id, common::Error err) WARN_UNUSED_RESULT;
+  common::ErrnoError UpdateStreamSuccess(fastotv::protocol::sequance_id_t id) WARN_UNUSED_RESULT;
+
+  common::ErrnoError ProfileStreamFail(fastotv::protocol::sequance_id_t id, common::Error err) WARN_UNUSED_RESULT;
+  common::ErrnoError ProfileStreamSuccess(fastotv::protocol::sequance_id_t id) WARN_UNUSED_RESULT;
+
+  common::ErrnoError UnmuteStreamFail(fastotv::protocol::sequance_id_t id, common::Error err) WARN_UNUSED_RESULT;
+  common::ErrnoError UnmuteStreamSuccess(fastotv::protocol::sequance_id_t id) WARN_UNUSED_RESULT;
+
+  common::ErrnoError BatchStreamsFail(fastotv::protocol::sequance_id_t id, common::Error err) WARN_UNUSED_RESULT;
+  common::ErrnoError BatchStreamsSuccess(fastotv::protocol::sequance_id_t id,
+                                         const std::string& result) WARN_UNUSED_RESULT;
+
   common::ErrnoError SyncServiceSuccess(fastotv::protocol::sequance_id_t id) WARN_UNUSED_RESULT;
+  common::ErrnoError StreamsStatusServiceSuccess(fastotv::protocol::sequance_id_t id,
+                                                 const std::string& result) WARN_UNUSED_RESULT;
+  common::ErrnoError StatsHistoryServiceSuccess(fastotv::protocol::sequance_id_t id,
+                                                const std::string& result) WARN_UNUSED_RESULT;
+  common::ErrnoError StatsHistoryServiceFail(fastotv::protocol::sequance_id_t id,
+                                             common::Error err) WARN_UNUSED_RESULT;
+
+  // broadcasts kept while socket not writable, newer one replaces still queued with same not empty key,
+  // fails only if queue full of not replaceable requests
+  common::ErrnoError QueueRequest(const fastotv::protocol::request_t& req, const std::string& key) WARN_UNUSED_RESULT;
+  common::ErrnoError FlushQueue() WARN_UNUSED_RESULT;  // sends queued while socket writable
+  size_t GetQueueSize() const;
+
+ private:
+  struct QueuedRequest {
+    std::string key;
+    fastotv::protocol::request_t req;
+  };
+
+  bool IsWritable() const;
+
+  std::deque<QueuedRequest> queue_;
 };
 
 }  // namespace server
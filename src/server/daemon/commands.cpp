@@ -47,6 +47,16 @@ common::Error StatisitcStreamBroadcast(const StatisticInfo& params, fastotv::pro
   return common::Error();
 }
 
+common::Error StatisticStreamsBroadcast(fastotv::protocol::serializet_params_t params,
+                                        fastotv::protocol::request_t* req) {
+  if (!req) {
+    return common::make_error_inval();
+  }
+
+  *req = fastotv::protocol::request_t::MakeNotification(STREAM_STATISTIC_STREAMS, params);
+  return common::Error();
+}
+
 #if defined(MACHINE_LEARNING)
 common::Error MlNotificationStreamBroadcast(const fastotv::commands_info::ml::NotificationInfo& params, fastotv::protocol::request_t* req) {
   if (!req) {
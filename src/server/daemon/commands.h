@@ -32,8 +32,17 @@
 #define DAEMON_START_STREAM "start_stream"  // {"config": {...}, "command_line": {...} }
 #define DAEMON_STOP_STREAM "stop_stream"
 #define DAEMON_RESTART_STREAM "restart_stream"
+#define DAEMON_START_STREAMS "start_streams"      // {"streams": [{...}, ...]}
+#define DAEMON_STOP_STREAMS "stop_streams"        // {"streams": ["id", ...]}
+#define DAEMON_RESTART_STREAMS "restart_streams"  // {"streams": ["id", ...]}
+#define DAEMON_UPDATE_STREAM "update_stream"      // {"id": "...", "config": {changed fields}}
 #define DAEMON_GET_LOG_STREAM "get_log_stream"
 #define DAEMON_GET_PIPELINE_STREAM "get_pipeline_stream"
+#define DAEMON_PROFILE_STREAM "profile_stream"          // {"id": "...", "duration": 10}
+#define DAEMON_GET_PROFILE_STREAM "get_profile_stream"  // same as get_log_stream, report of last profile
+// migration: start_stream on target with "muted_outputs": true, unmute_stream on target until it succeeds,
+// then stop_stream on source, viewers get both nodes for a moment instead of a gap
+#define DAEMON_UNMUTE_STREAM "unmute_stream"  // {"id": "..."}, fails until stream playing with input data
 
 #define DAEMON_ACTIVATE "activate_request"  // {"key": "XXXXXXXXXXXXXXXXXX"}
 #define DAEMON_STOP_SERVICE "stop_service"  // {"delay": 0 }
@@ -43,12 +52,17 @@
 #define DAEMON_SYNC_SERVICE "sync_service"
 #define DAEMON_PING_SERVICE "ping_service"
 #define DAEMON_GET_LOG_SERVICE "get_log_service"  // {"path":"http://localhost/service/id"}
+// last statistic of streams kept by daemon, one pulled response instead of statistic_stream broadcasts
+#define DAEMON_STREAMS_STATUS_SERVICE "streams_status_service"  // {"streams": ["id", ...], "status": [4, ...]}
+// metrics of last stats_history minutes, averaged by step seconds
+#define DAEMON_STATS_HISTORY_SERVICE "stats_history_service"  // {"streams": ["id", ...], "since": 0, "step": 60}
 
 #define DAEMON_SERVER_PING "ping_client"
 
 // Broadcast
 #define STREAM_CHANGED_SOURCES_STREAM "changed_source_stream"
 #define STREAM_STATISTIC_STREAM "statistic_stream"
+#define STREAM_STATISTIC_STREAMS "statistic_streams"  // {"full": true, "streams": [{...}, ...]}
 #define STREAM_QUIT_STATUS_STREAM "quit_status_stream"
 #if defined(MACHINE_LEARNING)
 #define STREAM_ML_NOTIFICATION_STREAM "ml_notification_stream"
@@ -61,6 +75,8 @@ namespace server {
 // Broadcast
 common::Error ChangedSourcesStreamBroadcast(const ChangedSouresInfo& params, fastotv::protocol::request_t* req);
 common::Error StatisitcStreamBroadcast(const StatisticInfo& params, fastotv::protocol::request_t* req);
+common::Error StatisticStreamsBroadcast(fastotv::protocol::serializet_params_t params,
+                                        fastotv::protocol::request_t* req);
 #if defined(MACHINE_LEARNING)
 common::Error MlNotificationStreamBroadcast(const fastotv::commands_info::ml::NotificationInfo& params, fastotv::protocol::request_t* req);
 #endif
@@ -162,6 +162,42 @@ common::Error StateServiceResponse(fastotv::protocol::sequance_id_t id,
   return common::Error();
 }
 
+common::Error StreamsStatusServiceResponseSuccess(fastotv::protocol::sequance_id_t id,
+                                                  const std::string& result,
+                                                  fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp = fastotv::protocol::response_t::MakeMessage(
+      id, common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage(result));
+  return common::Error();
+}
+
+common::Error StatsHistoryServiceResponseSuccess(fastotv::protocol::sequance_id_t id,
+                                                 const std::string& result,
+                                                 fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp = fastotv::protocol::response_t::MakeMessage(
+      id, common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage(result));
+  return common::Error();
+}
+
+common::Error StatsHistoryServiceResponseFail(fastotv::protocol::sequance_id_t id,
+                                              const std::string& error_text,
+                                              fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp = fastotv::protocol::response_t::MakeError(
+      id, common::protocols::json_rpc::JsonRPCError::MakeServerErrorFromText(error_text));
+  return common::Error();
+}
+
 common::Error SyncServiceResponceSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp) {
   if (!resp) {
     return common::make_error_inval();
@@ -238,6 +274,96 @@ common::Error RestartStreamResponseFail(fastotv::protocol::sequance_id_t id,
   return common::Error();
 }
 
+common::Error UpdateStreamResponseSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp =
+      fastotv::protocol::response_t::MakeMessage(id, common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage());
+  return common::Error();
+}
+
+common::Error UpdateStreamResponseFail(fastotv::protocol::sequance_id_t id,
+                                       const std::string& error_text,
+                                       fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp = fastotv::protocol::response_t::MakeError(
+      id, common::protocols::json_rpc::JsonRPCError::MakeServerErrorFromText(error_text));
+  return common::Error();
+}
+
+common::Error ProfileStreamResponseSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp =
+      fastotv::protocol::response_t::MakeMessage(id, common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage());
+  return common::Error();
+}
+
+common::Error ProfileStreamResponseFail(fastotv::protocol::sequance_id_t id,
+                                        const std::string& error_text,
+                                        fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp = fastotv::protocol::response_t::MakeError(
+      id, common::protocols::json_rpc::JsonRPCError::MakeServerErrorFromText(error_text));
+  return common::Error();
+}
+
+common::Error UnmuteStreamResponseSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp =
+      fastotv::protocol::response_t::MakeMessage(id, common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage());
+  return common::Error();
+}
+
+common::Error UnmuteStreamResponseFail(fastotv::protocol::sequance_id_t id,
+                                       const std::string& error_text,
+                                       fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp = fastotv::protocol::response_t::MakeError(
+      id, common::protocols::json_rpc::JsonRPCError::MakeServerErrorFromText(error_text));
+  return common::Error();
+}
+
+common::Error BatchStreamsResponseSuccess(fastotv::protocol::sequance_id_t id,
+                                          const std::string& result,
+                                          fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp = fastotv::protocol::response_t::MakeMessage(
+      id, common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage(result));
+  return common::Error();
+}
+
+common::Error BatchStreamsResponseFail(fastotv::protocol::sequance_id_t id,
+                                       const std::string& error_text,
+                                       fastotv::protocol::response_t* resp) {
+  if (!resp) {
+    return common::make_error_inval();
+  }
+
+  *resp = fastotv::protocol::response_t::MakeError(
+      id, common::protocols::json_rpc::JsonRPCError::MakeServerErrorFromText(error_text));
+  return common::Error();
+}
+
 common::Error GetLogStreamResponseSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp) {
   if (!resp) {
     return common::make_error_inval();
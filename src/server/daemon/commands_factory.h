@@ -62,6 +62,18 @@ common::Error StateServiceResponse(fastotv::protocol::sequance_id_t id,
 
 common::Error SyncServiceResponceSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp);
 
+// {"streams": [{"id": "...", "status": 4, ...}]}
+common::Error StreamsStatusServiceResponseSuccess(fastotv::protocol::sequance_id_t id,
+                                                  const std::string& result,
+                                                  fastotv::protocol::response_t* resp);
+// {"node": {"timestamps": [...], "cpu": [...], ...}, "streams": [{"id": "...", "timestamps": [...], ...}]}
+common::Error StatsHistoryServiceResponseSuccess(fastotv::protocol::sequance_id_t id,
+                                                 const std::string& result,
+                                                 fastotv::protocol::response_t* resp);
+common::Error StatsHistoryServiceResponseFail(fastotv::protocol::sequance_id_t id,
+                                              const std::string& error_text,
+                                              fastotv::protocol::response_t* resp);
+
 common::Error PingServiceResponce(fastotv::protocol::sequance_id_t id,
                                   const common::daemon::commands::ServerPingInfo& ping,
                                   fastotv::protocol::response_t* resp);
@@ -85,6 +97,29 @@ common::Error RestartStreamResponseFail(fastotv::protocol::sequance_id_t id,
                                         const std::string& error_text,
                                         fastotv::protocol::response_t* resp);
 
+common::Error UpdateStreamResponseSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp);
+common::Error UpdateStreamResponseFail(fastotv::protocol::sequance_id_t id,
+                                       const std::string& error_text,
+                                       fastotv::protocol::response_t* resp);
+
+common::Error ProfileStreamResponseSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp);
+common::Error ProfileStreamResponseFail(fastotv::protocol::sequance_id_t id,
+                                        const std::string& error_text,
+                                        fastotv::protocol::response_t* resp);
+
+common::Error UnmuteStreamResponseSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp);
+common::Error UnmuteStreamResponseFail(fastotv::protocol::sequance_id_t id,
+                                       const std::string& error_text,
+                                       fastotv::protocol::response_t* resp);
+
+// {"succeeded": 1, "failed": 0, "streams": [{"id": "..."}]}
+common::Error BatchStreamsResponseSuccess(fastotv::protocol::sequance_id_t id,
+                                          const std::string& result,
+                                          fastotv::protocol::response_t* resp);
+common::Error BatchStreamsResponseFail(fastotv::protocol::sequance_id_t id,
+                                       const std::string& error_text,
+                                       fastotv::protocol::response_t* resp);
+
 common::Error GetLogStreamResponseSuccess(fastotv::protocol::sequance_id_t id, fastotv::protocol::response_t* resp);
 common::Error GetLogStreamResponseFail(fastotv::protocol::sequance_id_t id,
                                        const std::string& error_text,
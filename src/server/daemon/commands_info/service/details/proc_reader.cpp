@@ -0,0 +1,148 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/daemon/commands_info/service/details/proc_reader.h"
+
+#include <string.h>
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fastocloud {
+namespace server {
+namespace service {
+
+namespace {
+bool is_separator(char c) {
+  return c == ' ' || c == '\t' || c == ':';
+}
+}  // namespace
+
+ProcScanner::ProcScanner() : pos_(nullptr), end_(nullptr), line_end_(nullptr) {}
+
+ProcScanner::ProcScanner(const char* data, size_t size) : pos_(data), end_(data + size), line_end_(nullptr) {}
+
+bool ProcScanner::NextLine() {
+  if (line_end_) {
+    pos_ = line_end_ + 1;
+  }
+  if (!pos_ || pos_ >= end_) {
+    return false;
+  }
+
+  line_end_ = static_cast<const char*>(memchr(pos_, '\n', end_ - pos_));
+  if (!line_end_) {
+    pos_ = end_;
+    return false;
+  }
+  return true;
+}
+
+bool ProcScanner::SkipSpaces() {
+  if (!line_end_) {
+    return false;
+  }
+
+  while (pos_ < line_end_ && is_separator(*pos_)) {
+    pos_++;
+  }
+  return pos_ < line_end_;
+}
+
+bool ProcScanner::ReadToken(std::string* token) {
+  if (!SkipSpaces()) {
+    return false;
+  }
+
+  const char* start = pos_;
+  while (pos_ < line_end_ && !is_separator(*pos_)) {
+    pos_++;
+  }
+  token->assign(start, pos_ - start);
+  return true;
+}
+
+bool ProcScanner::SkipTokens(size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    if (!SkipSpaces()) {
+      return false;
+    }
+    while (pos_ < line_end_ && !is_separator(*pos_)) {
+      pos_++;
+    }
+  }
+  return true;
+}
+
+bool ProcScanner::ReadUint64(uint64_t* value) {
+  if (!SkipSpaces() || *pos_ < '0' || *pos_ > '9') {
+    return false;
+  }
+
+  uint64_t result = 0;
+  while (pos_ < line_end_ && *pos_ >= '0' && *pos_ <= '9') {
+    result = result * 10 + (*pos_ - '0');
+    pos_++;
+  }
+  *value = result;
+  return true;
+}
+
+ProcReader::ProcReader(const std::string& path, size_t buffer_size) : path_(path), fd_(-1), buffer_(buffer_size) {}
+
+ProcReader::~ProcReader() {
+#if defined(OS_POSIX)
+  if (fd_ != -1) {
+    close(fd_);
+  }
+#endif
+}
+
+bool ProcReader::Read(ProcScanner* scanner) {
+#if defined(OS_POSIX)
+  if (fd_ == -1) {
+    fd_ = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ == -1) {
+      return false;
+    }
+  }
+
+  // seq files may return less than asked, content larger than buffer truncated to whole lines by scanner
+  size_t readed = 0;
+  while (readed < buffer_.size()) {
+    ssize_t res = pread(fd_, &buffer_[readed], buffer_.size() - readed, readed);
+    if (res < 0) {
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    if (res == 0) {
+      break;
+    }
+    readed += res;
+  }
+
+  *scanner = ProcScanner(buffer_.data(), readed);
+  return true;
+#else
+  UNUSED(scanner);
+  return false;
+#endif
+}
+
+}  // namespace service
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace server {
+namespace service {
+
+// words and numbers of text buffer line by line, not owns data
+class ProcScanner {
+ public:
+  ProcScanner();
+  ProcScanner(const char* data, size_t size);
+
+  bool NextLine();  // first call moves to first line, not terminated last line skipped
+
+  // separated by spaces or ':' (interface and meminfo names), false at end of line
+  bool ReadToken(std::string* token);
+  bool SkipTokens(size_t count);
+  bool ReadUint64(uint64_t* value);
+
+ private:
+  bool SkipSpaces();
+
+  const char* pos_;
+  const char* end_;
+  const char* line_end_;
+};
+
+// file kept open between reads, content reread from start into fixed buffer, posix only
+class ProcReader {
+ public:
+  enum { default_buffer_size = 16 * 1024 };
+
+  explicit ProcReader(const std::string& path, size_t buffer_size = default_buffer_size);
+  ~ProcReader();
+
+  bool Read(ProcScanner* scanner);  // scanner valid until next read, reopened if previous read failed
+
+ private:
+  const std::string path_;
+  int fd_;
+  std::vector<char> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProcReader);
+};
+
+}  // namespace service
+}  // namespace server
+}  // namespace fastocloud
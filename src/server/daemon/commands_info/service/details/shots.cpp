@@ -14,10 +14,10 @@
 
 #include "server/daemon/commands_info/service/details/shots.h"
 
-#include <inttypes.h>
 #include <string.h>
 #include <sys/stat.h>
 
+#include <fstream>
 #include <string>
 
 #if defined(OS_LINUX)
@@ -40,7 +40,13 @@
 #include <common/system_info/system_info.h>
 #include <common/time.h>
 
-#define CPU_FORMAT "cpu %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64
+#define PROC_STAT_PATH "/proc/stat"
+#define PROC_MEMINFO_PATH "/proc/meminfo"
+#define PROC_NET_DEV_PATH "/proc/net/dev"
+#define PROC_DISKSTATS_PATH "/proc/diskstats"
+#define SYSFS_NET_PATH "/sys/class/net/"
+
+#define DISK_SECTOR_SIZE 512  // diskstats sectors are always 512 bytes
 
 #if defined(OS_WIN)
 namespace {
@@ -59,6 +65,128 @@ namespace fastocloud {
 namespace server {
 namespace service {
 
+namespace {
+#if defined(OS_LINUX)
+bool StartsWith(const std::string& str, const char* prefix) {
+  return str.compare(0, strlen(prefix), prefix) == 0;
+}
+
+bool ReadCpuShot(ProcReader* reader, CpuShot* shot) {
+  ProcScanner scanner;
+  if (!reader->Read(&scanner) || !scanner.NextLine()) {
+    return false;
+  }
+
+  std::string name;
+  uint64_t user, nice, system, idle;
+  if (!scanner.ReadToken(&name) || name != "cpu" || !scanner.ReadUint64(&user) || !scanner.ReadUint64(&nice) ||
+      !scanner.ReadUint64(&system) || !scanner.ReadUint64(&idle)) {
+    return false;
+  }
+
+  shot->cpu_usage = user + nice + system;
+  shot->cpu_limit = shot->cpu_usage + idle;
+  return true;
+}
+
+// MemTotal and MemAvailable, kB
+bool ReadMemoryShot(ProcReader* reader, MemoryShot* shot) {
+  ProcScanner scanner;
+  if (!reader->Read(&scanner)) {
+    return false;
+  }
+
+  bool have_total = false, have_avail = false;
+  std::string name;
+  while ((!have_total || !have_avail) && scanner.NextLine()) {
+    uint64_t kbytes;
+    if (!scanner.ReadToken(&name) || !scanner.ReadUint64(&kbytes)) {
+      continue;
+    }
+    if (name == "MemTotal") {
+      shot->ram_bytes_total = kbytes * 1024;
+      have_total = true;
+    } else if (name == "MemAvailable") {
+      shot->ram_bytes_free = kbytes * 1024;
+      have_avail = true;
+    }
+  }
+  return have_total && have_avail;
+}
+
+bool ReadNetShot(ProcReader* reader, NetShot* shot) {
+  ProcScanner scanner;
+  if (!reader->Read(&scanner) || !scanner.NextLine() || !scanner.NextLine()) {  // 2 header lines
+    return false;
+  }
+
+  while (scanner.NextLine()) {
+    // face |bytes    packets errs drop fifo frame compressed multicast|
+    // bytes    packets errs drop fifo colls carrier compressed
+    InterfaceShot interf;
+    uint64_t recv, send;
+    if (!scanner.ReadToken(&interf.name) || !scanner.ReadUint64(&recv) || !scanner.SkipTokens(7) ||
+        !scanner.ReadUint64(&send)) {
+      continue;
+    }
+    if (StartsWith(interf.name, "lo")) {
+      continue;
+    }
+
+    interf.bytes_recv = recv;
+    interf.bytes_send = send;
+    shot->bytes_recv += recv;
+    shot->bytes_send += send;
+    shot->interfaces.push_back(interf);
+  }
+  return true;
+}
+
+// major minor name reads merged sectors ms writes merged sectors ...
+bool ReadDiskIoShot(ProcReader* reader, DiskIoShot* shot) {
+  ProcScanner scanner;
+  if (!reader->Read(&scanner)) {
+    return false;
+  }
+
+  while (scanner.NextLine()) {
+    DiskShot disk;
+    uint64_t sectors_read, sectors_written;
+    if (!scanner.SkipTokens(2) || !scanner.ReadToken(&disk.name) || !scanner.SkipTokens(2) ||
+        !scanner.ReadUint64(&sectors_read) || !scanner.SkipTokens(3) || !scanner.ReadUint64(&sectors_written)) {
+      continue;
+    }
+    if (StartsWith(disk.name, "loop") || StartsWith(disk.name, "ram")) {
+      continue;
+    }
+
+    disk.bytes_read = sectors_read * DISK_SECTOR_SIZE;
+    disk.bytes_written = sectors_written * DISK_SECTOR_SIZE;
+    shot->disks.push_back(disk);
+  }
+  return true;
+}
+#endif
+
+uint64_t GetRate(size_t prev, size_t next, uint64_t secs) {
+  if (next < prev || secs == 0) {  // counter reset
+    return 0;
+  }
+  return (next - prev) / secs;
+}
+
+template <typename T>
+const T* FindDevice(const std::vector<T>& devices, const std::string& name) {
+  for (const T& device : devices) {
+    if (device.name == name) {
+      return &device;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
 long double GetCpuMachineLoad(const CpuShot& prev, const CpuShot& next) {
   long double total = next.cpu_limit - prev.cpu_limit;
   if (total == 0.0l) {
@@ -72,15 +200,12 @@ long double GetCpuMachineLoad(const CpuShot& prev, const CpuShot& next) {
 CpuShot GetMachineCpuShot() {
   uint64_t busy = 0, total = 0;
 #if defined(OS_LINUX)
-  FILE* fp = fopen("/proc/stat", "r");
-  uint64_t user, nice, system, idle;
-  if (fscanf(fp, CPU_FORMAT, &user, &nice, &system, &idle) != 4) {
-    // Something bad happened with the information, so assume it's all invalid
-    user = nice = system = idle = 0;
+  ProcReader reader(PROC_STAT_PATH);
+  CpuShot shot = {0, 0};
+  if (ReadCpuShot(&reader, &shot)) {
+    busy = shot.cpu_usage;
+    total = shot.cpu_limit;
   }
-  fclose(fp);
-  busy = user + nice + system;
-  total = busy + idle;
 #elif defined(OS_MACOSX)
   host_cpu_load_info_data_t cpuinfo;
   mach_msg_type_number_t count = HOST_CPU_LOAD_INFO_COUNT;
@@ -137,41 +262,64 @@ NetShot::NetShot() : bytes_recv(0), bytes_send(0) {}
 NetShot GetMachineNetShot() {
   NetShot shot;
 #if defined(OS_LINUX)
-  FILE* netinfo = fopen("/proc/net/dev", "r");
-  if (!netinfo) {
-    return shot;
+  ProcReader reader(PROC_NET_DEV_PATH);
+  ignore_result(ReadNetShot(&reader, &shot));
+#else
+#pragma message "Please implement"
+#endif
+  return shot;
+}
+
+DiskIoShot GetMachineDiskIoShot() {
+  DiskIoShot shot;
+#if defined(OS_LINUX)
+  ProcReader reader(PROC_DISKSTATS_PATH);
+  ignore_result(ReadDiskIoShot(&reader, &shot));
+#else
+#pragma message "Please implement"
+#endif
+  return shot;
+}
+
+io_rates_t GetInterfacesRates(const NetShot& prev, const NetShot& next, uint64_t secs) {
+  io_rates_t rates;
+  for (const InterfaceShot& interf : next.interfaces) {
+    const InterfaceShot* prev_interf = FindDevice(prev.interfaces, interf.name);
+    if (!prev_interf) {
+      rates.push_back({interf.name, 0, 0});
+      continue;
+    }
+    rates.push_back({interf.name, GetRate(prev_interf->bytes_recv, interf.bytes_recv, secs),
+                     GetRate(prev_interf->bytes_send, interf.bytes_send, secs)});
   }
+  return rates;
+}
 
-  char line[512];
-  char interf[128] = {0};
-  int pos = 0;
-  while (fgets(line, sizeof(line), netinfo)) {
-    // face |bytes    packets errs drop fifo frame compressed multicast|
-    // bytes    packets errs drop fifo colls carrier compressed
-    if (pos > 1) {
-      unsigned long long int r_bytes, r_packets, r_errs, r_drop, r_fifo, r_frame, r_compressed, r_multicast;
-      unsigned long long int s_bytes, s_packets, s_errs, s_drop, s_fifo, s_colls, s_carrier, s_compressed;
-      sscanf(line,
-             "%s %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu "
-             "%16llu %16llu %16llu "
-             "%16llu %16llu %16llu %16llu %16llu",
-             interf, &r_bytes, &r_packets, &r_errs, &r_drop, &r_fifo, &r_frame, &r_compressed, &r_multicast, &s_bytes,
-             &s_packets, &s_errs, &s_drop, &s_fifo, &s_colls, &s_carrier, &s_compressed);
-      if (strncmp(interf, "lo", 2) != 0) {
-        shot.bytes_recv += r_bytes;
-        shot.bytes_send += s_bytes;
-      }
-      memset(interf, 0, sizeof(interf));
+io_rates_t GetDisksRates(const DiskIoShot& prev, const DiskIoShot& next, uint64_t secs) {
+  io_rates_t rates;
+  for (const DiskShot& disk : next.disks) {
+    const DiskShot* prev_disk = FindDevice(prev.disks, disk.name);
+    if (!prev_disk) {
+      rates.push_back({disk.name, 0, 0});
+      continue;
     }
-    pos++;
+    rates.push_back({disk.name, GetRate(prev_disk->bytes_read, disk.bytes_read, secs),
+                     GetRate(prev_disk->bytes_written, disk.bytes_written, secs)});
   }
+  return rates;
+}
 
-  fclose(netinfo);
-  return shot;
+uint64_t GetInterfaceSpeed(const std::string& name) {
+#if defined(OS_LINUX)
+  std::ifstream file(SYSFS_NET_PATH + name + "/speed");
+  long speed = 0;
+  if (file.is_open() && (file >> speed) && speed > 0) {  // -1 for virtual and down links
+    return speed;
+  }
 #else
-#pragma message "Please implement"
-  return shot;
+  UNUSED(name);
 #endif
+  return 0;
 }
 
 SysinfoShot::SysinfoShot() : loads{0}, uptime(0) {}
@@ -211,6 +359,52 @@ SysinfoShot GetMachineSysinfoShot() {
 #endif
 }
 
+MachineShotsReader::MachineShotsReader()
+    : stat_(PROC_STAT_PATH, 4096),
+      meminfo_(PROC_MEMINFO_PATH, 4096),
+      net_dev_(PROC_NET_DEV_PATH),
+      diskstats_(PROC_DISKSTATS_PATH) {}
+
+CpuShot MachineShotsReader::GetCpuShot() {
+#if defined(OS_LINUX)
+  CpuShot shot = {0, 0};
+  ignore_result(ReadCpuShot(&stat_, &shot));
+  return shot;
+#else
+  return GetMachineCpuShot();
+#endif
+}
+
+MemoryShot MachineShotsReader::GetMemoryShot() {
+#if defined(OS_LINUX)
+  MemoryShot shot;
+  if (ReadMemoryShot(&meminfo_, &shot)) {
+    return shot;
+  }
+#endif
+  return GetMachineMemoryShot();
+}
+
+NetShot MachineShotsReader::GetNetShot() {
+#if defined(OS_LINUX)
+  NetShot shot;
+  ignore_result(ReadNetShot(&net_dev_, &shot));
+  return shot;
+#else
+  return GetMachineNetShot();
+#endif
+}
+
+DiskIoShot MachineShotsReader::GetDiskIoShot() {
+#if defined(OS_LINUX)
+  DiskIoShot shot;
+  ignore_result(ReadDiskIoShot(&diskstats_, &shot));
+  return shot;
+#else
+  return GetMachineDiskIoShot();
+#endif
+}
+
 }  // namespace service
 }  // namespace server
 }  // namespace fastocloud
@@ -15,9 +15,12 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <common/error.h>
 
+#include "server/daemon/commands_info/service/details/proc_reader.h"
+
 namespace fastocloud {
 namespace server {
 namespace service {
@@ -48,15 +51,48 @@ struct HddShot {
 
 HddShot GetMachineHddShot();
 
+struct InterfaceShot {
+  std::string name;
+  size_t bytes_recv;
+  size_t bytes_send;
+};
+
 struct NetShot {
   NetShot();
 
   size_t bytes_recv;
   size_t bytes_send;
+  std::vector<InterfaceShot> interfaces;  // without loopback
 };
 
 NetShot GetMachineNetShot();
 
+struct DiskShot {
+  std::string name;
+  size_t bytes_read;
+  size_t bytes_written;
+};
+
+struct DiskIoShot {
+  std::vector<DiskShot> disks;  // without loop and ram devices
+};
+
+DiskIoShot GetMachineDiskIoShot();
+
+struct IoRate {
+  std::string name;
+  uint64_t in_bps;   // received or read
+  uint64_t out_bps;  // sent or written
+};
+
+typedef std::vector<IoRate> io_rates_t;
+
+// devices of next shot, appeared since prev have zero rates
+io_rates_t GetInterfacesRates(const NetShot& prev, const NetShot& next, uint64_t secs);
+io_rates_t GetDisksRates(const DiskIoShot& prev, const DiskIoShot& next, uint64_t secs);
+
+uint64_t GetInterfaceSpeed(const std::string& name);  // link speed in megabits per second, 0 if unknown
+
 struct SysinfoShot {
   SysinfoShot();
 
@@ -66,6 +102,25 @@ struct SysinfoShot {
 
 SysinfoShot GetMachineSysinfoShot();
 
+// periodic shots without reopening /proc files, linux only, other platforms use one time shots
+class MachineShotsReader {
+ public:
+  MachineShotsReader();
+
+  CpuShot GetCpuShot();
+  MemoryShot GetMemoryShot();
+  NetShot GetNetShot();
+  DiskIoShot GetDiskIoShot();
+
+ private:
+  ProcReader stat_;
+  ProcReader meminfo_;
+  ProcReader net_dev_;
+  ProcReader diskstats_;
+
+  DISALLOW_COPY_AND_ASSIGN(MachineShotsReader);
+};
+
 }  // namespace service
 }  // namespace server
 }  // namespace fastocloud
@@ -14,6 +14,8 @@
 
 #include "server/daemon/commands_info/service/server_info.h"
 
+#include <algorithm>
+
 #define STATISTIC_SERVICE_INFO_UPTIME_FIELD "uptime"
 #define STATISTIC_SERVICE_INFO_TIMESTAMP_FIELD "timestamp"
 #define STATISTIC_SERVICE_INFO_CPU_FIELD "cpu"
@@ -30,6 +32,10 @@
 #define STATISTIC_SERVICE_INFO_BANDWIDTH_OUT_FIELD "bandwidth_out"
 
 #define STATISTIC_SERVICE_INFO_ONLINE_USERS_FIELD "online_users"
+#define STATISTIC_SERVICE_INFO_SEGMENT_CACHE_FIELD "segment_cache"
+#define STATISTIC_SERVICE_INFO_GPU_DEVICES_FIELD "gpu_devices"
+#define STATISTIC_SERVICE_INFO_CAPACITY_FIELD "capacity"
+#define STATISTIC_SERVICE_INFO_STARTUP_FIELD "startup"
 
 #define FULL_SERVICE_INFO_OS_FIELD "os"
 #define FULL_SERVICE_INFO_VERSION_FIELD "version"
@@ -43,6 +49,67 @@
 #define ONLINE_USERS_VODS_FIELD "vods"
 #define ONLINE_USERS_CODS_FIELD "cods"
 
+#define SEGMENT_CACHE_SIZE_FIELD "size"
+#define SEGMENT_CACHE_ENTRIES_FIELD "entries"
+#define SEGMENT_CACHE_HITS_FIELD "hits"
+#define SEGMENT_CACHE_MISSES_FIELD "misses"
+#define SEGMENT_CACHE_SERVED_FIELD "served"
+
+#define GPU_DEVICE_ENCODER_FIELD "encoder"
+#define GPU_DEVICE_DECODER_FIELD "decoder"
+#define GPU_DEVICE_COMPUTE_FIELD "compute"
+#define GPU_DEVICE_MEMORY_FIELD "memory"
+#define GPU_DEVICE_MEMORY_TOTAL_FIELD "memory_total"
+#define GPU_DEVICE_MEMORY_USED_FIELD "memory_used"
+#define GPU_DEVICE_PCIE_RX_FIELD "pcie_rx"
+#define GPU_DEVICE_PCIE_TX_FIELD "pcie_tx"
+#define GPU_DEVICE_STREAMS_FIELD "streams"
+#define GPU_DEVICE_STREAM_ID_FIELD "id"
+
+#define CAPACITY_CPU_CORES_FIELD "cpu_cores"
+#define CAPACITY_GPUS_FIELD "gpus"
+#define CAPACITY_ENCODER_SESSIONS_FIELD "encoder_sessions"
+#define CAPACITY_DECODER_FIELD "decoder"
+#define CAPACITY_OUTPUT_MBPS_FIELD "output_mbps"
+#define CAPACITY_DISK_WRITE_MBPS_FIELD "disk_write_mbps"
+#define STARTUP_COUNT_FIELD "count"
+#define STARTUP_P50_FIELD "p50"
+#define STARTUP_P90_FIELD "p90"
+#define STARTUP_P99_FIELD "p99"
+
+#define RESOURCE_CAPACITY_FIELD "capacity"
+#define RESOURCE_REMAINING_FIELD "remaining"
+#define RESOURCE_FREE_FIELD "free"
+
+namespace {
+
+json_object* MakeResource(const fastocloud::server::service::CapacityInfo::Resource& resource) {
+  json_object* jresource = json_object_new_object();
+  json_object_object_add(jresource, RESOURCE_CAPACITY_FIELD, json_object_new_double(resource.capacity));
+  json_object_object_add(jresource, RESOURCE_REMAINING_FIELD, json_object_new_double(resource.remaining));
+  json_object_object_add(jresource, RESOURCE_FREE_FIELD, json_object_new_double(resource.GetFree()));
+  return jresource;
+}
+
+void ParseResource(json_object* serialized,
+                   const char* field,
+                   fastocloud::server::service::CapacityInfo::Resource* resource) {
+  json_object* jresource = nullptr;
+  if (!json_object_object_get_ex(serialized, field, &jresource)) {
+    return;
+  }
+
+  json_object* jfield = nullptr;
+  if (json_object_object_get_ex(jresource, RESOURCE_CAPACITY_FIELD, &jfield)) {
+    resource->capacity = json_object_get_double(jfield);
+  }
+  if (json_object_object_get_ex(jresource, RESOURCE_REMAINING_FIELD, &jfield)) {
+    resource->remaining = json_object_get_double(jfield);
+  }
+}
+
+}  // namespace
+
 namespace fastocloud {
 namespace server {
 namespace service {
@@ -90,6 +157,268 @@ common::Error OnlineUsers::SerializeFields(json_object* out) const {
   return common::Error();
 }
 
+SegmentCacheInfo::SegmentCacheInfo() : SegmentCacheInfo(0, 0, 0, 0, 0) {}
+
+SegmentCacheInfo::SegmentCacheInfo(size_t size, size_t entries, uint64_t hits, uint64_t misses, uint64_t served)
+    : size_(size), entries_(entries), hits_(hits), misses_(misses), served_(served) {}
+
+common::Error SegmentCacheInfo::DoDeSerialize(json_object* serialized) {
+  SegmentCacheInfo inf;
+  json_object* jsize = nullptr;
+  json_bool jsize_exists = json_object_object_get_ex(serialized, SEGMENT_CACHE_SIZE_FIELD, &jsize);
+  if (jsize_exists) {
+    inf.size_ = json_object_get_int64(jsize);
+  }
+
+  json_object* jentries = nullptr;
+  json_bool jentries_exists = json_object_object_get_ex(serialized, SEGMENT_CACHE_ENTRIES_FIELD, &jentries);
+  if (jentries_exists) {
+    inf.entries_ = json_object_get_int64(jentries);
+  }
+
+  json_object* jhits = nullptr;
+  json_bool jhits_exists = json_object_object_get_ex(serialized, SEGMENT_CACHE_HITS_FIELD, &jhits);
+  if (jhits_exists) {
+    inf.hits_ = json_object_get_int64(jhits);
+  }
+
+  json_object* jmisses = nullptr;
+  json_bool jmisses_exists = json_object_object_get_ex(serialized, SEGMENT_CACHE_MISSES_FIELD, &jmisses);
+  if (jmisses_exists) {
+    inf.misses_ = json_object_get_int64(jmisses);
+  }
+
+  json_object* jserved = nullptr;
+  json_bool jserved_exists = json_object_object_get_ex(serialized, SEGMENT_CACHE_SERVED_FIELD, &jserved);
+  if (jserved_exists) {
+    inf.served_ = json_object_get_int64(jserved);
+  }
+
+  *this = inf;
+  return common::Error();
+}
+
+common::Error SegmentCacheInfo::SerializeFields(json_object* out) const {
+  json_object_object_add(out, SEGMENT_CACHE_SIZE_FIELD, json_object_new_int64(size_));
+  json_object_object_add(out, SEGMENT_CACHE_ENTRIES_FIELD, json_object_new_int64(entries_));
+  json_object_object_add(out, SEGMENT_CACHE_HITS_FIELD, json_object_new_int64(hits_));
+  json_object_object_add(out, SEGMENT_CACHE_MISSES_FIELD, json_object_new_int64(misses_));
+  json_object_object_add(out, SEGMENT_CACHE_SERVED_FIELD, json_object_new_int64(served_));
+  return common::Error();
+}
+
+GpuDeviceInfo::GpuDeviceInfo() : device_(), streams_() {}
+
+GpuDeviceInfo::GpuDeviceInfo(const gpu_stats::DeviceStats& device, const streams_t& streams)
+    : device_(device), streams_(streams) {
+  device_.processes.clear();
+}
+
+gpu_stats::DeviceStats GpuDeviceInfo::GetDevice() const {
+  return device_;
+}
+
+GpuDeviceInfo::streams_t GpuDeviceInfo::GetStreams() const {
+  return streams_;
+}
+
+common::Error GpuDeviceInfo::DoDeSerialize(json_object* serialized) {
+  GpuDeviceInfo inf;
+  json_object* jfield = nullptr;
+  if (json_object_object_get_ex(serialized, GPU_DEVICE_ENCODER_FIELD, &jfield)) {
+    inf.device_.encoder_load = json_object_get_int(jfield);
+  }
+  if (json_object_object_get_ex(serialized, GPU_DEVICE_DECODER_FIELD, &jfield)) {
+    inf.device_.decoder_load = json_object_get_int(jfield);
+  }
+  if (json_object_object_get_ex(serialized, GPU_DEVICE_COMPUTE_FIELD, &jfield)) {
+    inf.device_.compute_load = json_object_get_int(jfield);
+  }
+  if (json_object_object_get_ex(serialized, GPU_DEVICE_MEMORY_FIELD, &jfield)) {
+    inf.device_.memory_load = json_object_get_int(jfield);
+  }
+  if (json_object_object_get_ex(serialized, GPU_DEVICE_MEMORY_TOTAL_FIELD, &jfield)) {
+    inf.device_.memory_total = json_object_get_int64(jfield);
+  }
+  if (json_object_object_get_ex(serialized, GPU_DEVICE_MEMORY_USED_FIELD, &jfield)) {
+    inf.device_.memory_used = json_object_get_int64(jfield);
+  }
+  if (json_object_object_get_ex(serialized, GPU_DEVICE_PCIE_RX_FIELD, &jfield)) {
+    inf.device_.pcie_rx_bps = json_object_get_int64(jfield);
+  }
+  if (json_object_object_get_ex(serialized, GPU_DEVICE_PCIE_TX_FIELD, &jfield)) {
+    inf.device_.pcie_tx_bps = json_object_get_int64(jfield);
+  }
+
+  json_object* jstreams = nullptr;
+  if (json_object_object_get_ex(serialized, GPU_DEVICE_STREAMS_FIELD, &jstreams) &&
+      json_object_is_type(jstreams, json_type_array)) {
+    const size_t len = json_object_array_length(jstreams);
+    for (size_t i = 0; i < len; ++i) {
+      json_object* jstream = json_object_array_get_idx(jstreams, i);
+      json_object* jid = nullptr;
+      if (!json_object_object_get_ex(jstream, GPU_DEVICE_STREAM_ID_FIELD, &jid)) {
+        continue;
+      }
+      StreamLoad stream = {json_object_get_string(jid), 0, 0, 0};
+      if (json_object_object_get_ex(jstream, GPU_DEVICE_ENCODER_FIELD, &jfield)) {
+        stream.encoder = json_object_get_int(jfield);
+      }
+      if (json_object_object_get_ex(jstream, GPU_DEVICE_DECODER_FIELD, &jfield)) {
+        stream.decoder = json_object_get_int(jfield);
+      }
+      if (json_object_object_get_ex(jstream, GPU_DEVICE_COMPUTE_FIELD, &jfield)) {
+        stream.compute = json_object_get_int(jfield);
+      }
+      inf.streams_.push_back(stream);
+    }
+  }
+
+  *this = inf;
+  return common::Error();
+}
+
+common::Error GpuDeviceInfo::SerializeFields(json_object* out) const {
+  json_object_object_add(out, GPU_DEVICE_ENCODER_FIELD, json_object_new_int(device_.encoder_load));
+  json_object_object_add(out, GPU_DEVICE_DECODER_FIELD, json_object_new_int(device_.decoder_load));
+  json_object_object_add(out, GPU_DEVICE_COMPUTE_FIELD, json_object_new_int(device_.compute_load));
+  json_object_object_add(out, GPU_DEVICE_MEMORY_FIELD, json_object_new_int(device_.memory_load));
+  json_object_object_add(out, GPU_DEVICE_MEMORY_TOTAL_FIELD, json_object_new_int64(device_.memory_total));
+  json_object_object_add(out, GPU_DEVICE_MEMORY_USED_FIELD, json_object_new_int64(device_.memory_used));
+  json_object_object_add(out, GPU_DEVICE_PCIE_RX_FIELD, json_object_new_int64(device_.pcie_rx_bps));
+  json_object_object_add(out, GPU_DEVICE_PCIE_TX_FIELD, json_object_new_int64(device_.pcie_tx_bps));
+  json_object* jstreams = json_object_new_array();
+  for (const StreamLoad& stream : streams_) {
+    json_object* jstream = json_object_new_object();
+    json_object_object_add(jstream, GPU_DEVICE_STREAM_ID_FIELD, json_object_new_string(stream.id.c_str()));
+    json_object_object_add(jstream, GPU_DEVICE_ENCODER_FIELD, json_object_new_int(stream.encoder));
+    json_object_object_add(jstream, GPU_DEVICE_DECODER_FIELD, json_object_new_int(stream.decoder));
+    json_object_object_add(jstream, GPU_DEVICE_COMPUTE_FIELD, json_object_new_int(stream.compute));
+    json_object_array_add(jstreams, jstream);
+  }
+  json_object_object_add(out, GPU_DEVICE_STREAMS_FIELD, jstreams);
+  return common::Error();
+}
+
+double CapacityInfo::Resource::GetFree() const {
+  if (capacity <= 0) {
+    return 0;
+  }
+  return std::min(std::max(remaining / capacity, 0.0), 1.0);
+}
+
+CapacityInfo::CapacityInfo() : CapacityInfo({0, 0}, gpus_t(), {0, 0}, {0, 0}) {}
+
+CapacityInfo::CapacityInfo(const Resource& cpu_cores,
+                           const gpus_t& gpus,
+                           const Resource& output_mbps,
+                           const Resource& disk_write_mbps)
+    : cpu_cores_(cpu_cores), gpus_(gpus), output_mbps_(output_mbps), disk_write_mbps_(disk_write_mbps) {}
+
+CapacityInfo::Resource CapacityInfo::GetCpuCores() const {
+  return cpu_cores_;
+}
+
+CapacityInfo::gpus_t CapacityInfo::GetGpus() const {
+  return gpus_;
+}
+
+CapacityInfo::Resource CapacityInfo::GetOutputMbps() const {
+  return output_mbps_;
+}
+
+CapacityInfo::Resource CapacityInfo::GetDiskWriteMbps() const {
+  return disk_write_mbps_;
+}
+
+common::Error CapacityInfo::DoDeSerialize(json_object* serialized) {
+  CapacityInfo inf;
+  ParseResource(serialized, CAPACITY_CPU_CORES_FIELD, &inf.cpu_cores_);
+  ParseResource(serialized, CAPACITY_OUTPUT_MBPS_FIELD, &inf.output_mbps_);
+  ParseResource(serialized, CAPACITY_DISK_WRITE_MBPS_FIELD, &inf.disk_write_mbps_);
+
+  json_object* jgpus = nullptr;
+  if (json_object_object_get_ex(serialized, CAPACITY_GPUS_FIELD, &jgpus) &&
+      json_object_is_type(jgpus, json_type_array)) {
+    const size_t len = json_object_array_length(jgpus);
+    for (size_t i = 0; i < len; ++i) {
+      json_object* jgpu = json_object_array_get_idx(jgpus, i);
+      GpuCapacity gpu = {{0, 0}, {0, 0}};
+      ParseResource(jgpu, CAPACITY_ENCODER_SESSIONS_FIELD, &gpu.encoder_sessions);
+      ParseResource(jgpu, CAPACITY_DECODER_FIELD, &gpu.decoder);
+      inf.gpus_.push_back(gpu);
+    }
+  }
+
+  *this = inf;
+  return common::Error();
+}
+
+common::Error CapacityInfo::SerializeFields(json_object* out) const {
+  json_object* jgpus = json_object_new_array();
+  for (const GpuCapacity& gpu : gpus_) {
+    json_object* jgpu = json_object_new_object();
+    json_object_object_add(jgpu, CAPACITY_ENCODER_SESSIONS_FIELD, MakeResource(gpu.encoder_sessions));
+    json_object_object_add(jgpu, CAPACITY_DECODER_FIELD, MakeResource(gpu.decoder));
+    json_object_array_add(jgpus, jgpu);
+  }
+
+  json_object_object_add(out, CAPACITY_CPU_CORES_FIELD, MakeResource(cpu_cores_));
+  json_object_object_add(out, CAPACITY_GPUS_FIELD, jgpus);
+  json_object_object_add(out, CAPACITY_OUTPUT_MBPS_FIELD, MakeResource(output_mbps_));
+  json_object_object_add(out, CAPACITY_DISK_WRITE_MBPS_FIELD, MakeResource(disk_write_mbps_));
+  return common::Error();
+}
+
+StartupInfo::StartupInfo() : StartupInfo(0, 0, 0, 0) {}
+
+StartupInfo::StartupInfo(size_t count, fastotv::timestamp_t p50, fastotv::timestamp_t p90, fastotv::timestamp_t p99)
+    : count_(count), p50_(p50), p90_(p90), p99_(p99) {}
+
+size_t StartupInfo::GetCount() const {
+  return count_;
+}
+
+fastotv::timestamp_t StartupInfo::GetP50() const {
+  return p50_;
+}
+
+fastotv::timestamp_t StartupInfo::GetP90() const {
+  return p90_;
+}
+
+fastotv::timestamp_t StartupInfo::GetP99() const {
+  return p99_;
+}
+
+common::Error StartupInfo::DoDeSerialize(json_object* serialized) {
+  StartupInfo inf;
+  json_object* jfield = nullptr;
+  if (json_object_object_get_ex(serialized, STARTUP_COUNT_FIELD, &jfield)) {
+    inf.count_ = json_object_get_int64(jfield);
+  }
+  if (json_object_object_get_ex(serialized, STARTUP_P50_FIELD, &jfield)) {
+    inf.p50_ = json_object_get_int64(jfield);
+  }
+  if (json_object_object_get_ex(serialized, STARTUP_P90_FIELD, &jfield)) {
+    inf.p90_ = json_object_get_int64(jfield);
+  }
+  if (json_object_object_get_ex(serialized, STARTUP_P99_FIELD, &jfield)) {
+    inf.p99_ = json_object_get_int64(jfield);
+  }
+
+  *this = inf;
+  return common::Error();
+}
+
+common::Error StartupInfo::SerializeFields(json_object* out) const {
+  json_object_object_add(out, STARTUP_COUNT_FIELD, json_object_new_int64(count_));
+  json_object_object_add(out, STARTUP_P50_FIELD, json_object_new_int64(p50_));
+  json_object_object_add(out, STARTUP_P90_FIELD, json_object_new_int64(p90_));
+  json_object_object_add(out, STARTUP_P99_FIELD, json_object_new_int64(p99_));
+  return common::Error();
+}
+
 ServerInfo::ServerInfo()
     : base_class(),
       cpu_load_(),
@@ -101,7 +430,11 @@ ServerInfo::ServerInfo()
       net_bytes_send_(),
       current_ts_(),
       sys_shot_(),
-      online_users_() {}
+      online_users_(),
+      segment_cache_(),
+      gpu_devices_(),
+      capacity_(),
+      startup_() {}
 
 ServerInfo::ServerInfo(cpu_load_t cpu_load,
                        gpu_load_t gpu_load,
@@ -123,7 +456,11 @@ ServerInfo::ServerInfo(cpu_load_t cpu_load,
       net_bytes_send_(net_bytes_send),
       current_ts_(timestamp),
       sys_shot_(sys),
-      online_users_(online_users) {}
+      online_users_(online_users),
+      segment_cache_(),
+      gpu_devices_(),
+      capacity_(),
+      startup_() {}
 
 common::Error ServerInfo::SerializeFields(json_object* out) const {
   json_object* obj = nullptr;
@@ -132,6 +469,45 @@ common::Error ServerInfo::SerializeFields(json_object* out) const {
     return err;
   }
 
+  json_object* jcache = nullptr;
+  err = segment_cache_.Serialize(&jcache);
+  if (err) {
+    json_object_put(obj);
+    return err;
+  }
+
+  json_object* jgpu_devices = json_object_new_array();
+  for (const GpuDeviceInfo& device : gpu_devices_) {
+    json_object* jdevice = nullptr;
+    err = device.Serialize(&jdevice);
+    if (err) {
+      json_object_put(jgpu_devices);
+      json_object_put(jcache);
+      json_object_put(obj);
+      return err;
+    }
+    json_object_array_add(jgpu_devices, jdevice);
+  }
+
+  json_object* jcapacity = nullptr;
+  err = capacity_.Serialize(&jcapacity);
+  if (err) {
+    json_object_put(jgpu_devices);
+    json_object_put(jcache);
+    json_object_put(obj);
+    return err;
+  }
+
+  json_object* jstartup = nullptr;
+  err = startup_.Serialize(&jstartup);
+  if (err) {
+    json_object_put(jcapacity);
+    json_object_put(jgpu_devices);
+    json_object_put(jcache);
+    json_object_put(obj);
+    return err;
+  }
+
   json_object_object_add(out, STATISTIC_SERVICE_INFO_CPU_FIELD, json_object_new_double(cpu_load_));
   json_object_object_add(out, STATISTIC_SERVICE_INFO_GPU_FIELD, json_object_new_double(gpu_load_));
   json_object_object_add(out, STATISTIC_SERVICE_INFO_LOAD_AVERAGE_FIELD, json_object_new_string(uptime_.c_str()));
@@ -146,6 +522,10 @@ common::Error ServerInfo::SerializeFields(json_object* out) const {
   json_object_object_add(out, STATISTIC_SERVICE_INFO_UPTIME_FIELD, json_object_new_int64(sys_shot_.uptime));
   json_object_object_add(out, STATISTIC_SERVICE_INFO_TIMESTAMP_FIELD, json_object_new_int64(current_ts_));
   json_object_object_add(out, STATISTIC_SERVICE_INFO_ONLINE_USERS_FIELD, obj);
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_SEGMENT_CACHE_FIELD, jcache);
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_GPU_DEVICES_FIELD, jgpu_devices);
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_CAPACITY_FIELD, jcapacity);
+  json_object_object_add(out, STATISTIC_SERVICE_INFO_STARTUP_FIELD, jstartup);
   return common::Error();
 }
 
@@ -161,6 +541,48 @@ common::Error ServerInfo::DoDeSerialize(json_object* serialized) {
     }
   }
 
+  json_object* jcache = nullptr;
+  json_bool jcache_exists = json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_SEGMENT_CACHE_FIELD, &jcache);
+  if (jcache_exists) {
+    common::Error err = inf.segment_cache_.DeSerialize(jcache);
+    if (err) {
+      return err;
+    }
+  }
+
+  json_object* jgpu_devices = nullptr;
+  json_bool jgpu_devices_exists =
+      json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_GPU_DEVICES_FIELD, &jgpu_devices);
+  if (jgpu_devices_exists && json_object_is_type(jgpu_devices, json_type_array)) {
+    const size_t len = json_object_array_length(jgpu_devices);
+    for (size_t i = 0; i < len; ++i) {
+      GpuDeviceInfo device;
+      common::Error err = device.DeSerialize(json_object_array_get_idx(jgpu_devices, i));
+      if (err) {
+        return err;
+      }
+      inf.gpu_devices_.push_back(device);
+    }
+  }
+
+  json_object* jcapacity = nullptr;
+  json_bool jcapacity_exists = json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_CAPACITY_FIELD, &jcapacity);
+  if (jcapacity_exists) {
+    common::Error err = inf.capacity_.DeSerialize(jcapacity);
+    if (err) {
+      return err;
+    }
+  }
+
+  json_object* jstartup = nullptr;
+  json_bool jstartup_exists = json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_STARTUP_FIELD, &jstartup);
+  if (jstartup_exists) {
+    common::Error err = inf.startup_.DeSerialize(jstartup);
+    if (err) {
+      return err;
+    }
+  }
+
   json_object* jcpu_load = nullptr;
   json_bool jcpu_load_exists = json_object_object_get_ex(serialized, STATISTIC_SERVICE_INFO_CPU_FIELD, &jcpu_load);
   if (jcpu_load_exists) {
@@ -272,6 +694,38 @@ OnlineUsers ServerInfo::GetOnlineUsers() const {
   return online_users_;
 }
 
+SegmentCacheInfo ServerInfo::GetSegmentCache() const {
+  return segment_cache_;
+}
+
+void ServerInfo::SetSegmentCache(const SegmentCacheInfo& cache) {
+  segment_cache_ = cache;
+}
+
+gpu_devices_t ServerInfo::GetGpuDevices() const {
+  return gpu_devices_;
+}
+
+void ServerInfo::SetGpuDevices(const gpu_devices_t& devices) {
+  gpu_devices_ = devices;
+}
+
+CapacityInfo ServerInfo::GetCapacity() const {
+  return capacity_;
+}
+
+void ServerInfo::SetCapacity(const CapacityInfo& capacity) {
+  capacity_ = capacity;
+}
+
+StartupInfo ServerInfo::GetStartup() const {
+  return startup_;
+}
+
+void ServerInfo::SetStartup(const StartupInfo& startup) {
+  startup_ = startup;
+}
+
 FullServiceInfo::FullServiceInfo()
     : base_class(),
       http_host_(),
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <common/net/types.h>
 #include <common/serializer/json_serializer.h>
@@ -23,6 +24,7 @@
 #include <fastotv/types.h>
 
 #include "server/daemon/commands_info/service/details/shots.h"
+#include "server/gpu_stats/perf_monitor.h"
 
 namespace fastocloud {
 namespace server {
@@ -45,6 +47,115 @@ class OnlineUsers : public common::serializer::JsonSerializer<OnlineUsers> {
   size_t cods_;
 };
 
+class SegmentCacheInfo : public common::serializer::JsonSerializer<SegmentCacheInfo> {
+ public:
+  typedef JsonSerializer<SegmentCacheInfo> base_class;
+  SegmentCacheInfo();
+  SegmentCacheInfo(size_t size, size_t entries, uint64_t hits, uint64_t misses, uint64_t served);
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  size_t size_;
+  size_t entries_;
+  uint64_t hits_;
+  uint64_t misses_;
+  uint64_t served_;
+};
+
+// gpu engines load and its users among streams of node
+class GpuDeviceInfo : public common::serializer::JsonSerializer<GpuDeviceInfo> {
+ public:
+  typedef JsonSerializer<GpuDeviceInfo> base_class;
+  struct StreamLoad {
+    fastotv::stream_id_t id;
+    int encoder;  // percents of device
+    int decoder;
+    int compute;
+  };
+  typedef std::vector<StreamLoad> streams_t;
+
+  GpuDeviceInfo();
+  GpuDeviceInfo(const gpu_stats::DeviceStats& device, const streams_t& streams);
+
+  gpu_stats::DeviceStats GetDevice() const;  // without processes
+  streams_t GetStreams() const;
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  gpu_stats::DeviceStats device_;
+  streams_t streams_;
+};
+
+typedef std::vector<GpuDeviceInfo> gpu_devices_t;  // by device index
+
+// headroom of node for placement of new streams by controller,
+// free is remaining normalized to 0..1 of capacity, capacity 0 - unknown or unlimited
+class CapacityInfo : public common::serializer::JsonSerializer<CapacityInfo> {
+ public:
+  typedef JsonSerializer<CapacityInfo> base_class;
+  struct Resource {
+    double capacity;
+    double remaining;
+
+    double GetFree() const;
+  };
+  struct GpuCapacity {
+    Resource encoder_sessions;
+    Resource decoder;  // percents of engine
+  };
+  typedef std::vector<GpuCapacity> gpus_t;  // by device index
+
+  CapacityInfo();
+  CapacityInfo(const Resource& cpu_cores,
+               const gpus_t& gpus,
+               const Resource& output_mbps,
+               const Resource& disk_write_mbps);  // megabytes per second
+
+  Resource GetCpuCores() const;
+  gpus_t GetGpus() const;
+  Resource GetOutputMbps() const;
+  Resource GetDiskWriteMbps() const;
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  Resource cpu_cores_;
+  gpus_t gpus_;
+  Resource output_mbps_;
+  Resource disk_write_mbps_;
+};
+
+// time to first frame of recent stream starts, msec from start request to first output buffer
+class StartupInfo : public common::serializer::JsonSerializer<StartupInfo> {
+ public:
+  typedef JsonSerializer<StartupInfo> base_class;
+  StartupInfo();
+  StartupInfo(size_t count, fastotv::timestamp_t p50, fastotv::timestamp_t p90, fastotv::timestamp_t p99);
+
+  size_t GetCount() const;
+  fastotv::timestamp_t GetP50() const;
+  fastotv::timestamp_t GetP90() const;
+  fastotv::timestamp_t GetP99() const;
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  size_t count_;
+  fastotv::timestamp_t p50_;
+  fastotv::timestamp_t p90_;
+  fastotv::timestamp_t p99_;
+};
+
 class ServerInfo : public common::serializer::JsonSerializer<ServerInfo> {
  public:
   typedef JsonSerializer<ServerInfo> base_class;
@@ -72,6 +183,18 @@ class ServerInfo : public common::serializer::JsonSerializer<ServerInfo> {
   fastotv::timestamp_t GetTimestamp() const;
   OnlineUsers GetOnlineUsers() const;
 
+  SegmentCacheInfo GetSegmentCache() const;
+  void SetSegmentCache(const SegmentCacheInfo& cache);
+
+  gpu_devices_t GetGpuDevices() const;
+  void SetGpuDevices(const gpu_devices_t& devices);
+
+  CapacityInfo GetCapacity() const;
+  void SetCapacity(const CapacityInfo& capacity);
+
+  StartupInfo GetStartup() const;
+  void SetStartup(const StartupInfo& startup);
+
  protected:
   common::Error DoDeSerialize(json_object* serialized) override;
   common::Error SerializeFields(json_object* out) const override;
@@ -87,6 +210,10 @@ class ServerInfo : public common::serializer::JsonSerializer<ServerInfo> {
   fastotv::timestamp_t current_ts_;
   SysinfoShot sys_shot_;
   OnlineUsers online_users_;
+  SegmentCacheInfo segment_cache_;
+  gpu_devices_t gpu_devices_;
+  CapacityInfo capacity_;
+  StartupInfo startup_;
 };
 
 class FullServiceInfo : public ServerInfo {
@@ -0,0 +1,97 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/daemon/commands_info/service/stats_history_info.h"
+
+#include <string>
+
+#include <common/convert2string.h>
+
+#define STATS_HISTORY_INFO_STREAMS_FIELD "streams"
+#define STATS_HISTORY_INFO_SINCE_FIELD "since"
+#define STATS_HISTORY_INFO_STEP_FIELD "step"
+
+namespace fastocloud {
+namespace server {
+namespace service {
+
+StatsHistoryInfo::StatsHistoryInfo() : base_class(), streams_(), since_(0), step_(0) {}
+
+StatsHistoryInfo::StatsHistoryInfo(const streams_t& streams, fastotv::timestamp_t since, time_t step)
+    : base_class(), streams_(streams), since_(since), step_(step) {}
+
+StatsHistoryInfo::streams_t StatsHistoryInfo::GetStreams() const {
+  return streams_;
+}
+
+fastotv::timestamp_t StatsHistoryInfo::GetSince() const {
+  return since_;
+}
+
+time_t StatsHistoryInfo::GetStep() const {
+  return step_;
+}
+
+common::Error StatsHistoryInfo::DoDeSerialize(json_object* serialized) {
+  StatsHistoryInfo inf;
+  json_object* jstreams = nullptr;
+  if (json_object_object_get_ex(serialized, STATS_HISTORY_INFO_STREAMS_FIELD, &jstreams)) {
+    if (!json_object_is_type(jstreams, json_type_array)) {
+      return common::make_error_inval();
+    }
+
+    size_t len = json_object_array_length(jstreams);
+    for (size_t i = 0; i < len; ++i) {
+      json_object* jid = json_object_array_get_idx(jstreams, i);
+      if (!json_object_is_type(jid, json_type_string)) {
+        return common::make_error("Invalid stream id at index: " + common::ConvertToString(i));
+      }
+      inf.streams_.push_back(json_object_get_string(jid));
+    }
+  }
+
+  json_object* jsince = nullptr;
+  if (json_object_object_get_ex(serialized, STATS_HISTORY_INFO_SINCE_FIELD, &jsince)) {
+    if (!json_object_is_type(jsince, json_type_int) || json_object_get_int64(jsince) < 0) {
+      return common::make_error_inval();
+    }
+    inf.since_ = json_object_get_int64(jsince);
+  }
+
+  json_object* jstep = nullptr;
+  if (json_object_object_get_ex(serialized, STATS_HISTORY_INFO_STEP_FIELD, &jstep)) {
+    if (!json_object_is_type(jstep, json_type_int) || json_object_get_int64(jstep) < 0) {
+      return common::make_error_inval();
+    }
+    inf.step_ = json_object_get_int64(jstep);
+  }
+
+  *this = inf;
+  return common::Error();
+}
+
+common::Error StatsHistoryInfo::SerializeFields(json_object* out) const {
+  json_object* jstreams = json_object_new_array();
+  for (const fastotv::stream_id_t& sid : streams_) {
+    json_object_array_add(jstreams, json_object_new_string(sid.c_str()));
+  }
+  json_object_object_add(out, STATS_HISTORY_INFO_STREAMS_FIELD, jstreams);
+  json_object_object_add(out, STATS_HISTORY_INFO_SINCE_FIELD, json_object_new_int64(since_));
+  json_object_object_add(out, STATS_HISTORY_INFO_STEP_FIELD, json_object_new_int64(step_));
+  return common::Error();
+}
+
+}  // namespace service
+}  // namespace server
+}  // namespace fastocloud
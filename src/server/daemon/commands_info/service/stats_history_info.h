@@ -0,0 +1,53 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <common/serializer/json_serializer.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+namespace server {
+namespace service {
+
+// {"streams": ["id", ...], "since": 0, "step": 60} params of stats_history_service
+// empty or missing streams match all, since in utc msec, step in seconds, 0 - resolution of history
+class StatsHistoryInfo : public common::serializer::JsonSerializer<StatsHistoryInfo> {
+ public:
+  typedef common::serializer::JsonSerializer<StatsHistoryInfo> base_class;
+  typedef std::vector<fastotv::stream_id_t> streams_t;
+
+  StatsHistoryInfo();
+  StatsHistoryInfo(const streams_t& streams, fastotv::timestamp_t since, time_t step);
+
+  streams_t GetStreams() const;
+  fastotv::timestamp_t GetSince() const;
+  time_t GetStep() const;
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  streams_t streams_;
+  fastotv::timestamp_t since_;
+  time_t step_;
+};
+
+}  // namespace service
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,97 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/daemon/commands_info/service/streams_status_info.h"
+
+#include <string>
+
+#include <common/convert2string.h>
+
+#define STREAMS_STATUS_INFO_STREAMS_FIELD "streams"
+#define STREAMS_STATUS_INFO_STATUS_FIELD "status"
+
+namespace fastocloud {
+namespace server {
+namespace service {
+
+StreamsStatusInfo::StreamsStatusInfo() : base_class(), streams_(), statuses_() {}
+
+StreamsStatusInfo::StreamsStatusInfo(const streams_t& streams, const statuses_t& statuses)
+    : base_class(), streams_(streams), statuses_(statuses) {}
+
+StreamsStatusInfo::streams_t StreamsStatusInfo::GetStreams() const {
+  return streams_;
+}
+
+StreamsStatusInfo::statuses_t StreamsStatusInfo::GetStatuses() const {
+  return statuses_;
+}
+
+common::Error StreamsStatusInfo::DoDeSerialize(json_object* serialized) {
+  StreamsStatusInfo inf;
+  json_object* jstreams = nullptr;
+  if (json_object_object_get_ex(serialized, STREAMS_STATUS_INFO_STREAMS_FIELD, &jstreams)) {
+    if (!json_object_is_type(jstreams, json_type_array)) {
+      return common::make_error_inval();
+    }
+
+    size_t len = json_object_array_length(jstreams);
+    for (size_t i = 0; i < len; ++i) {
+      json_object* jid = json_object_array_get_idx(jstreams, i);
+      if (!json_object_is_type(jid, json_type_string)) {
+        return common::make_error("Invalid stream id at index: " + common::ConvertToString(i));
+      }
+      inf.streams_.push_back(json_object_get_string(jid));
+    }
+  }
+
+  json_object* jstatuses = nullptr;
+  if (json_object_object_get_ex(serialized, STREAMS_STATUS_INFO_STATUS_FIELD, &jstatuses)) {
+    if (!json_object_is_type(jstatuses, json_type_array)) {
+      return common::make_error_inval();
+    }
+
+    size_t len = json_object_array_length(jstatuses);
+    for (size_t i = 0; i < len; ++i) {
+      json_object* jstatus = json_object_array_get_idx(jstatuses, i);
+      const int status = json_object_is_type(jstatus, json_type_int) ? json_object_get_int(jstatus) : -1;
+      if (status < NEW || status > QUARANTINED) {
+        return common::make_error("Invalid stream status at index: " + common::ConvertToString(i));
+      }
+      inf.statuses_.push_back(static_cast<StreamStatus>(status));
+    }
+  }
+
+  *this = inf;
+  return common::Error();
+}
+
+common::Error StreamsStatusInfo::SerializeFields(json_object* out) const {
+  json_object* jstreams = json_object_new_array();
+  for (const fastotv::stream_id_t& sid : streams_) {
+    json_object_array_add(jstreams, json_object_new_string(sid.c_str()));
+  }
+  json_object_object_add(out, STREAMS_STATUS_INFO_STREAMS_FIELD, jstreams);
+
+  json_object* jstatuses = json_object_new_array();
+  for (StreamStatus status : statuses_) {
+    json_object_array_add(jstatuses, json_object_new_int(status));
+  }
+  json_object_object_add(out, STREAMS_STATUS_INFO_STATUS_FIELD, jstatuses);
+  return common::Error();
+}
+
+}  // namespace service
+}  // namespace server
+}  // namespace fastocloud
@@ -14,6 +14,7 @@
 
 #include "server/daemon/commands_info/service/sync_info.h"
 
+#include "base/config_fields.h"
 #include "base/stream_config_parse.h"
 
 #define SYNC_INFO_STREAMS_FIELD "streams"
@@ -22,7 +23,9 @@ namespace fastocloud {
 namespace server {
 namespace service {
 
-SyncInfo::SyncInfo() : base_class(), streams_() {}
+SyncInfo::SyncInfo() : base_class(), known_hashes_(), streams_() {}
+
+SyncInfo::SyncInfo(const hashes_t& known_hashes) : base_class(), known_hashes_(known_hashes), streams_() {}
 
 SyncInfo::streams_t SyncInfo::GetStreams() const {
   return streams_;
@@ -34,7 +37,7 @@ common::Error SyncInfo::SerializeFields(json_object*) const {
 }
 
 common::Error SyncInfo::DoDeSerialize(json_object* serialized) {
-  SyncInfo inf;
+  SyncInfo inf(known_hashes_);
   json_object* jstreams = nullptr;
   json_bool jstreams_exists = json_object_object_get_ex(serialized, SYNC_INFO_STREAMS_FIELD, &jstreams);
   if (jstreams_exists) {
@@ -42,9 +45,26 @@ common::Error SyncInfo::DoDeSerialize(json_object* serialized) {
     streams_t streams;
     for (size_t i = 0; i < len; ++i) {
       json_object* jstream = json_object_array_get_idx(jstreams, i);
-      config_t conf = MakeConfigFromJson(jstream);
-      if (conf) {
-        streams.push_back(conf);
+      SyncStream stream;
+      json_object* jid = nullptr;
+      json_object* jhash = nullptr;
+      if (json_object_object_get_ex(jstream, ID_FIELD, &jid) &&
+          json_object_object_get_ex(jstream, CONFIG_HASH_FIELD, &jhash)) {
+        stream.id = json_object_get_string(jid);
+        stream.hash = json_object_get_string(jhash);
+        auto it = known_hashes_.find(stream.id);
+        if (!stream.hash.empty() && it != known_hashes_.end() && it->second == stream.hash) {
+          streams.push_back(stream);  // unchanged, config not parsed
+          continue;
+        }
+      }
+
+      stream.config = MakeConfigFromJson(jstream);
+      if (stream.config) {
+        if (stream.id.empty()) {
+          stream.id = GetSid(stream.config);
+        }
+        streams.push_back(stream);
       }
     }
     inf.streams_ = streams;
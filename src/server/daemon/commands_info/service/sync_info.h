@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <common/serializer/json_serializer.h>
@@ -26,13 +27,22 @@ namespace fastocloud {
 namespace server {
 namespace service {
 
+// {"streams": [{"id": "...", "hash": "...", ...}, ...]}, streams with known hash may be sent as
+// {"id": "...", "hash": "..."}, their configs are not parsed
 class SyncInfo : public common::serializer::JsonSerializer<SyncInfo> {
  public:
   typedef JsonSerializer<SyncInfo> base_class;
   typedef StreamConfig config_t;
-  typedef std::vector<config_t> streams_t;
+  typedef std::unordered_map<fastotv::stream_id_t, std::string> hashes_t;  // hash by stream id
+  struct SyncStream {
+    fastotv::stream_id_t id;
+    std::string hash;  // empty if not versioned
+    config_t config;   // empty if hash is known
+  };
+  typedef std::vector<SyncStream> streams_t;
 
   SyncInfo();
+  explicit SyncInfo(const hashes_t& known_hashes);
 
   streams_t GetStreams() const;
 
@@ -41,6 +51,7 @@ class SyncInfo : public common::serializer::JsonSerializer<SyncInfo> {
   common::Error SerializeFields(json_object* out) const override;
 
  private:
+  hashes_t known_hashes_;
   streams_t streams_;
 };
 
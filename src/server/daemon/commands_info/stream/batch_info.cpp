@@ -0,0 +1,178 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/daemon/commands_info/stream/batch_info.h"
+
+#include <common/convert2string.h>
+
+#include "base/stream_config_parse.h"
+
+#define BATCH_INFO_STREAMS_FIELD "streams"
+#define BATCH_INFO_SUCCEEDED_FIELD "succeeded"
+#define BATCH_INFO_FAILED_FIELD "failed"
+#define BATCH_INFO_ID_FIELD "id"
+#define BATCH_INFO_ERROR_FIELD "error"
+
+namespace fastocloud {
+namespace server {
+namespace stream {
+
+StartStreamsInfo::StartStreamsInfo() : base_class(), configs_() {}
+
+StartStreamsInfo::configs_t StartStreamsInfo::GetConfigs() const {
+  return configs_;
+}
+
+common::Error StartStreamsInfo::DoDeSerialize(json_object* serialized) {
+  json_object* jstreams = nullptr;
+  json_bool jstreams_exists = json_object_object_get_ex(serialized, BATCH_INFO_STREAMS_FIELD, &jstreams);
+  if (!jstreams_exists || !json_object_is_type(jstreams, json_type_array)) {
+    return common::make_error_inval();
+  }
+
+  // whole batch rejected if one of configs is not parsed, nothing started yet
+  configs_t configs;
+  size_t len = json_object_array_length(jstreams);
+  for (size_t i = 0; i < len; ++i) {
+    json_object* jstream = json_object_array_get_idx(jstreams, i);
+    config_t conf = MakeConfigFromJson(jstream);
+    if (!conf) {
+      return common::make_error("Invalid stream config at index: " + common::ConvertToString(i));
+    }
+    configs.push_back(conf);
+  }
+
+  StartStreamsInfo inf;
+  inf.configs_ = configs;
+  *this = inf;
+  return common::Error();
+}
+
+common::Error StartStreamsInfo::SerializeFields(json_object*) const {
+  NOTREACHED() << "Not need";
+  return common::Error();
+}
+
+StreamsInfo::StreamsInfo() : base_class(), streams_() {}
+
+StreamsInfo::streams_t StreamsInfo::GetStreams() const {
+  return streams_;
+}
+
+common::Error StreamsInfo::DoDeSerialize(json_object* serialized) {
+  json_object* jstreams = nullptr;
+  json_bool jstreams_exists = json_object_object_get_ex(serialized, BATCH_INFO_STREAMS_FIELD, &jstreams);
+  if (!jstreams_exists || !json_object_is_type(jstreams, json_type_array)) {
+    return common::make_error_inval();
+  }
+
+  streams_t streams;
+  size_t len = json_object_array_length(jstreams);
+  for (size_t i = 0; i < len; ++i) {
+    json_object* jid = json_object_array_get_idx(jstreams, i);
+    if (!json_object_is_type(jid, json_type_string)) {
+      return common::make_error("Invalid stream id at index: " + common::ConvertToString(i));
+    }
+    streams.push_back(json_object_get_string(jid));
+  }
+
+  StreamsInfo inf;
+  inf.streams_ = streams;
+  *this = inf;
+  return common::Error();
+}
+
+common::Error StreamsInfo::SerializeFields(json_object* out) const {
+  json_object* jstreams = json_object_new_array();
+  for (const fastotv::stream_id_t& sid : streams_) {
+    json_object_array_add(jstreams, json_object_new_string(sid.c_str()));
+  }
+  json_object_object_add(out, BATCH_INFO_STREAMS_FIELD, jstreams);
+  return common::Error();
+}
+
+BatchResultInfo::BatchResultInfo() : base_class(), results_() {}
+
+void BatchResultInfo::AddSuccess(fastotv::stream_id_t sid) {
+  results_.push_back(result_t(sid, std::string()));
+}
+
+void BatchResultInfo::AddFail(fastotv::stream_id_t sid, const std::string& error_text) {
+  results_.push_back(result_t(sid, error_text.empty() ? "Unknown error" : error_text));
+}
+
+BatchResultInfo::results_t BatchResultInfo::GetResults() const {
+  return results_;
+}
+
+size_t BatchResultInfo::GetFailedCount() const {
+  size_t failed = 0;
+  for (const result_t& res : results_) {
+    if (!res.second.empty()) {
+      failed++;
+    }
+  }
+  return failed;
+}
+
+common::Error BatchResultInfo::DoDeSerialize(json_object* serialized) {
+  json_object* jstreams = nullptr;
+  json_bool jstreams_exists = json_object_object_get_ex(serialized, BATCH_INFO_STREAMS_FIELD, &jstreams);
+  if (!jstreams_exists || !json_object_is_type(jstreams, json_type_array)) {
+    return common::make_error_inval();
+  }
+
+  results_t results;
+  size_t len = json_object_array_length(jstreams);
+  for (size_t i = 0; i < len; ++i) {
+    json_object* jresult = json_object_array_get_idx(jstreams, i);
+    json_object* jid = nullptr;
+    if (!json_object_object_get_ex(jresult, BATCH_INFO_ID_FIELD, &jid)) {
+      return common::make_error_inval();
+    }
+
+    std::string error_text;
+    json_object* jerror = nullptr;
+    if (json_object_object_get_ex(jresult, BATCH_INFO_ERROR_FIELD, &jerror)) {
+      error_text = json_object_get_string(jerror);
+    }
+    results.push_back(result_t(json_object_get_string(jid), error_text));
+  }
+
+  BatchResultInfo inf;
+  inf.results_ = results;
+  *this = inf;
+  return common::Error();
+}
+
+common::Error BatchResultInfo::SerializeFields(json_object* out) const {
+  const size_t failed = GetFailedCount();
+  json_object* jstreams = json_object_new_array();
+  for (const result_t& res : results_) {
+    json_object* jresult = json_object_new_object();
+    json_object_object_add(jresult, BATCH_INFO_ID_FIELD, json_object_new_string(res.first.c_str()));
+    if (!res.second.empty()) {
+      json_object_object_add(jresult, BATCH_INFO_ERROR_FIELD, json_object_new_string(res.second.c_str()));
+    }
+    json_object_array_add(jstreams, jresult);
+  }
+  json_object_object_add(out, BATCH_INFO_SUCCEEDED_FIELD, json_object_new_int64(results_.size() - failed));
+  json_object_object_add(out, BATCH_INFO_FAILED_FIELD, json_object_new_int64(failed));
+  json_object_object_add(out, BATCH_INFO_STREAMS_FIELD, jstreams);
+  return common::Error();
+}
+
+}  // namespace stream
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,91 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <common/serializer/json_serializer.h>
+
+#include "base/stream_config.h"
+
+namespace fastocloud {
+namespace server {
+namespace stream {
+
+// {"streams": [{...}, ...]} stream configs of start_streams
+class StartStreamsInfo : public common::serializer::JsonSerializer<StartStreamsInfo> {
+ public:
+  typedef common::serializer::JsonSerializer<StartStreamsInfo> base_class;
+  typedef StreamConfig config_t;
+  typedef std::vector<config_t> configs_t;
+
+  StartStreamsInfo();
+
+  configs_t GetConfigs() const;
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  configs_t configs_;
+};
+
+// {"streams": ["id", ...]} stream ids of stop_streams and restart_streams
+class StreamsInfo : public common::serializer::JsonSerializer<StreamsInfo> {
+ public:
+  typedef common::serializer::JsonSerializer<StreamsInfo> base_class;
+  typedef std::vector<fastotv::stream_id_t> streams_t;
+
+  StreamsInfo();
+
+  streams_t GetStreams() const;
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  streams_t streams_;
+};
+
+// {"succeeded": 1, "failed": 1, "streams": [{"id": "a"}, {"id": "b", "error": "..."}]}
+class BatchResultInfo : public common::serializer::JsonSerializer<BatchResultInfo> {
+ public:
+  typedef common::serializer::JsonSerializer<BatchResultInfo> base_class;
+  typedef std::pair<fastotv::stream_id_t, std::string> result_t;  // empty error if succeeded
+  typedef std::vector<result_t> results_t;
+
+  BatchResultInfo();
+
+  void AddSuccess(fastotv::stream_id_t sid);
+  void AddFail(fastotv::stream_id_t sid, const std::string& error_text);
+
+  results_t GetResults() const;
+  size_t GetFailedCount() const;
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  results_t results_;
+};
+
+}  // namespace stream
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,85 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/daemon/commands_info/stream/update_config_info.h"
+
+#include <string>
+
+#include "base/stream_config_parse.h"
+
+#define UPDATE_CONFIG_INFO_ID_FIELD "id"
+#define UPDATE_CONFIG_INFO_CONFIG_FIELD "config"
+
+namespace fastocloud {
+namespace server {
+namespace stream {
+
+UpdateConfigInfo::UpdateConfigInfo() : base_class(), stream_id_(), changes_() {}
+
+UpdateConfigInfo::UpdateConfigInfo(fastotv::stream_id_t stream_id, config_t changes)
+    : base_class(), stream_id_(stream_id), changes_(changes) {}
+
+fastotv::stream_id_t UpdateConfigInfo::GetStreamID() const {
+  return stream_id_;
+}
+
+UpdateConfigInfo::config_t UpdateConfigInfo::GetChanges() const {
+  return changes_;
+}
+
+common::Error UpdateConfigInfo::DoDeSerialize(json_object* serialized) {
+  if (!serialized) {
+    return common::make_error_inval();
+  }
+
+  json_object* jid = nullptr;
+  json_bool jid_exists = json_object_object_get_ex(serialized, UPDATE_CONFIG_INFO_ID_FIELD, &jid);
+  if (!jid_exists) {
+    return common::make_error_inval();
+  }
+
+  json_object* jconfig = nullptr;
+  json_bool jconfig_exists = json_object_object_get_ex(serialized, UPDATE_CONFIG_INFO_CONFIG_FIELD, &jconfig);
+  if (!jconfig_exists || !json_object_is_type(jconfig, json_type_object)) {
+    return common::make_error_inval();
+  }
+
+  config_t changes = MakeConfigFromJson(jconfig);
+  if (!changes) {
+    return common::make_error_inval();
+  }
+
+  *this = UpdateConfigInfo(json_object_get_string(jid), changes);
+  return common::Error();
+}
+
+common::Error UpdateConfigInfo::SerializeFields(json_object* out) const {
+  std::string changes_json;
+  if (!changes_ || !MakeJsonFromConfig(changes_, &changes_json)) {
+    return common::make_error_inval();
+  }
+
+  json_object* jconfig = json_tokener_parse(changes_json.c_str());
+  if (!jconfig) {
+    return common::make_error_inval();
+  }
+
+  json_object_object_add(out, UPDATE_CONFIG_INFO_ID_FIELD, json_object_new_string(stream_id_.c_str()));
+  json_object_object_add(out, UPDATE_CONFIG_INFO_CONFIG_FIELD, jconfig);
+  return common::Error();
+}
+
+}  // namespace stream
+}  // namespace server
+}  // namespace fastocloud
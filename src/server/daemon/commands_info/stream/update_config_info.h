@@ -0,0 +1,47 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/serializer/json_serializer.h>
+
+#include "base/stream_config.h"
+
+namespace fastocloud {
+namespace server {
+namespace stream {
+
+// changed fields of running stream config, {"id": "...", "config": {...}}
+class UpdateConfigInfo : public common::serializer::JsonSerializer<UpdateConfigInfo> {
+ public:
+  typedef common::serializer::JsonSerializer<UpdateConfigInfo> base_class;
+  typedef StreamConfig config_t;
+  UpdateConfigInfo();
+  UpdateConfigInfo(fastotv::stream_id_t stream_id, config_t changes);
+
+  fastotv::stream_id_t GetStreamID() const;
+  config_t GetChanges() const;
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  fastotv::stream_id_t stream_id_;
+  config_t changes_;
+};
+
+}  // namespace stream
+}  // namespace server
+}  // namespace fastocloud
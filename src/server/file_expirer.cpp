@@ -0,0 +1,222 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/file_expirer.h"
+
+#include <dirent.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(OS_LINUX)
+#include <sys/inotify.h>
+#endif
+
+#include "base/constants.h"
+
+namespace fastocloud {
+namespace server {
+
+namespace {
+#if defined(OS_LINUX)
+const uint32_t kWatchMask = IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW;
+#endif
+
+std::string with_separator(const std::string& path) {
+  if (!path.empty() && path.back() == '/') {
+    return path;
+  }
+  return path + "/";
+}
+}  // namespace
+
+FileExpirer::FileExpirer(const std::string& pattern)
+    : pattern_(pattern), fd_(-1), roots_(), watches_(), expire_queue_(), tracked_() {}
+
+FileExpirer::~FileExpirer() {
+  if (fd_ != -1) {
+    close(fd_);
+  }
+}
+
+bool FileExpirer::Init() {
+#if defined(OS_LINUX)
+  if (fd_ == -1) {
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  }
+#endif
+  return IsValid();
+}
+
+bool FileExpirer::IsValid() const {
+  return fd_ != -1;
+}
+
+bool FileExpirer::AddFolder(const std::string& path) {
+  if (!IsValid() || path.empty()) {
+    return false;
+  }
+
+  const std::string dir = with_separator(path);
+  roots_.push_back(dir);
+  Watch(dir);
+  return true;
+}
+
+void FileExpirer::Clear() {
+#if defined(OS_LINUX)
+  for (const auto& watch : watches_) {
+    inotify_rm_watch(fd_, watch.first);
+  }
+#endif
+  roots_.clear();
+  watches_.clear();
+  tracked_.clear();
+  expire_queue_ = decltype(expire_queue_)();
+}
+
+size_t FileExpirer::ProcessEvents() {
+  size_t registered = 0;
+#if defined(OS_LINUX)
+  if (!IsValid()) {
+    return 0;
+  }
+
+  alignas(struct inotify_event) char buff[16 * 1024];
+  while (true) {
+    const ssize_t len = read(fd_, buff, sizeof(buff));
+    if (len <= 0) {  // EAGAIN, nothing more for now
+      break;
+    }
+
+    for (ssize_t offset = 0; offset < len;) {
+      const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buff + offset);
+      offset += sizeof(struct inotify_event) + event->len;
+      if (event->mask & IN_Q_OVERFLOW) {  // events lost, rescan once
+        for (const std::string& root : roots_) {
+          Watch(root);
+        }
+        continue;
+      }
+
+      if (event->mask & IN_IGNORED) {  // folder removed
+        watches_.erase(event->wd);
+        continue;
+      }
+
+      const auto watch = watches_.find(event->wd);
+      if (watch == watches_.end() || !event->len) {
+        continue;
+      }
+
+      const std::string name = event->name;
+      const std::string path = watch->second + name;
+      if (event->mask & IN_ISDIR) {
+        if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && name != OUTPUT_TRASH_DIR_NAME) {
+          Watch(with_separator(path));
+        }
+      } else if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) && IsMatch(name)) {
+        Register(path);
+        registered++;
+      }
+    }
+  }
+#endif
+  return registered;
+}
+
+size_t FileExpirer::RemoveExpired(time_t max_life_secs) {
+  size_t removed = 0;
+  while (!expire_queue_.empty() && expire_queue_.top().mtime < max_life_secs) {
+    Tracked oldest = expire_queue_.top();
+    expire_queue_.pop();
+
+    struct stat sb;
+    if (stat(oldest.path.c_str(), &sb) != 0) {  // removed by stream
+      tracked_.erase(oldest.path);
+      continue;
+    }
+
+    if (sb.st_mtime >= max_life_secs) {  // rewritten since registered
+      oldest.mtime = sb.st_mtime;
+      expire_queue_.push(oldest);
+      continue;
+    }
+
+    if (unlink(oldest.path.c_str()) == 0) {
+      removed++;
+    }
+    tracked_.erase(oldest.path);
+  }
+  return removed;
+}
+
+size_t FileExpirer::GetTrackedCount() const {
+  return tracked_.size();
+}
+
+void FileExpirer::Watch(const std::string& dir) {
+#if defined(OS_LINUX)
+  const int wd = inotify_add_watch(fd_, dir.c_str(), kWatchMask);
+  if (wd < 0) {
+    return;
+  }
+  watches_[wd] = dir;
+
+  DIR* dirp = opendir(dir.c_str());
+  if (!dirp) {
+    return;
+  }
+
+  struct dirent* dent;
+  while ((dent = readdir(dirp)) != nullptr) {
+    const std::string name = dent->d_name;
+    if (name == "." || name == "..") {
+      continue;
+    }
+
+    const std::string path = dir + name;
+    if (dent->d_type == DT_DIR) {  // symlinked folders not followed, as periodic scans did
+      if (name != OUTPUT_TRASH_DIR_NAME) {  // removed whole by output trash
+        Watch(with_separator(path));
+      }
+    } else if (dent->d_type == DT_REG && IsMatch(name)) {
+      Register(path);
+    }
+  }
+  closedir(dirp);
+#else
+  UNUSED(dir);
+#endif
+}
+
+void FileExpirer::Register(const std::string& path) {
+  if (tracked_.find(path) != tracked_.end()) {  // rewritten files rechecked on expire
+    return;
+  }
+
+  struct stat sb;
+  if (stat(path.c_str(), &sb) != 0) {
+    return;
+  }
+  tracked_.insert(path);
+  expire_queue_.push({sb.st_mtime, path});
+}
+
+bool FileExpirer::IsMatch(const std::string& name) const {
+  return fnmatch(pattern_.c_str(), name.c_str(), 0) == 0;
+}
+
+}  // namespace server
+}  // namespace fastocloud
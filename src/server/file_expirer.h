@@ -0,0 +1,71 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <time.h>
+
+#include <functional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace server {
+
+// removes files matching pattern by age, work proportional to written and expiring files, not to existing ones
+// files registered from inotify events of watched folders and their subfolders, linux only
+class FileExpirer {
+ public:
+  explicit FileExpirer(const std::string& pattern);
+  ~FileExpirer();
+
+  bool Init();  // false if notifications not available, periodic scans should be used
+  bool IsValid() const;
+
+  bool AddFolder(const std::string& path);  // existing files registered once
+  void Clear();
+
+  size_t ProcessEvents();                      // non blocking, returns registered files
+  size_t RemoveExpired(time_t max_life_secs);  // modified before, returns removed files
+  size_t GetTrackedCount() const;
+
+ private:
+  struct Tracked {
+    time_t mtime;
+    std::string path;
+
+    bool operator>(const Tracked& other) const { return mtime > other.mtime; }
+  };
+
+  void Watch(const std::string& dir);
+  void Register(const std::string& path);
+  bool IsMatch(const std::string& name) const;
+
+  const std::string pattern_;
+  int fd_;
+  std::vector<std::string> roots_;
+  std::unordered_map<int, std::string> watches_;  // with trailing separator
+  std::priority_queue<Tracked, std::vector<Tracked>, std::greater<Tracked>> expire_queue_;  // oldest on top
+  std::unordered_set<std::string> tracked_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileExpirer);
+};
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,352 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/file_uploader.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+#include <vector>
+
+#if defined(HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+#if defined(HAVE_OPENSSL)
+#include <netdb.h>
+#include <sys/socket.h>
+
+#include <openssl/ssl.h>
+#endif
+
+#include <common/convert2string.h>
+#include <common/sprintf.h>
+
+#include "base/utils.h"
+#include "server/config.h"
+
+#define UPLOAD_CHUNK_SIZE 65536
+#define GZIP_WINDOW_BITS (15 + 16)
+#define GZIP_MEM_LEVEL 8
+#define ZSTD_UPLOAD_LEVEL 3
+#define HTTPS_DEFAULT_PORT "443"
+
+namespace {
+
+typedef fastocloud::server::FileUploader::file_path_t file_path_t;
+
+common::Error GzipFile(FILE* in, FILE* out) {
+  z_stream strm;
+  memset(&strm, 0, sizeof(strm));
+  if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GZIP_WINDOW_BITS, GZIP_MEM_LEVEL, Z_DEFAULT_STRATEGY) !=
+      Z_OK) {
+    return common::make_error("Gzip init failed");
+  }
+
+  std::vector<unsigned char> in_buf(UPLOAD_CHUNK_SIZE);
+  std::vector<unsigned char> out_buf(UPLOAD_CHUNK_SIZE);
+  int flush = Z_NO_FLUSH;
+  do {
+    size_t readed = fread(in_buf.data(), 1, in_buf.size(), in);
+    if (ferror(in)) {
+      deflateEnd(&strm);
+      return common::make_error("Read file failed");
+    }
+    flush = feof(in) ? Z_FINISH : Z_NO_FLUSH;
+    strm.avail_in = static_cast<uInt>(readed);
+    strm.next_in = in_buf.data();
+    do {
+      strm.avail_out = static_cast<uInt>(out_buf.size());
+      strm.next_out = out_buf.data();
+      deflate(&strm, flush);
+      size_t have = out_buf.size() - strm.avail_out;
+      if (fwrite(out_buf.data(), 1, have, out) != have) {
+        deflateEnd(&strm);
+        return common::make_error("Write compressed file failed");
+      }
+    } while (strm.avail_out == 0);
+  } while (flush != Z_FINISH);
+
+  deflateEnd(&strm);
+  return common::Error();
+}
+
+#if defined(HAVE_ZSTD)
+common::Error ZstdFile(FILE* in, FILE* out) {
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  if (!cctx) {
+    return common::make_error("Zstd init failed");
+  }
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, ZSTD_UPLOAD_LEVEL);
+
+  std::vector<char> in_buf(ZSTD_CStreamInSize());
+  std::vector<char> out_buf(ZSTD_CStreamOutSize());
+  bool last = false;
+  do {
+    size_t readed = fread(in_buf.data(), 1, in_buf.size(), in);
+    if (ferror(in)) {
+      ZSTD_freeCCtx(cctx);
+      return common::make_error("Read file failed");
+    }
+    last = feof(in);
+    const ZSTD_EndDirective mode = last ? ZSTD_e_end : ZSTD_e_continue;
+    ZSTD_inBuffer input = {in_buf.data(), readed, 0};
+    bool finished = false;
+    do {
+      ZSTD_outBuffer output = {out_buf.data(), out_buf.size(), 0};
+      size_t remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+      if (ZSTD_isError(remaining)) {
+        ZSTD_freeCCtx(cctx);
+        return common::make_error(ZSTD_getErrorName(remaining));
+      }
+      if (fwrite(out_buf.data(), 1, output.pos, out) != output.pos) {
+        ZSTD_freeCCtx(cctx);
+        return common::make_error("Write compressed file failed");
+      }
+      finished = last ? (remaining == 0) : (input.pos == input.size);
+    } while (!finished);
+  } while (!last);
+
+  ZSTD_freeCCtx(cctx);
+  return common::Error();
+}
+#endif
+
+common::Error CompressFile(const file_path_t& file, const std::string& compression, file_path_t* out_file) {
+  const bool gzip = compression == UPLOAD_COMPRESSION_GZIP;
+#if !defined(HAVE_ZSTD)
+  if (!gzip) {
+    return common::make_error("Zstd compression not supported by this build");
+  }
+#endif
+
+  const std::string out_path = file.GetPath() + (gzip ? ".gz" : ".zst");
+  FILE* in = fopen(file.GetPath().c_str(), "rb");
+  if (!in) {
+    return common::make_error(common::MemSPrintf("Can't open file: %s", file.GetPath().c_str()));
+  }
+  FILE* out = fopen(out_path.c_str(), "wb");
+  if (!out) {
+    fclose(in);
+    return common::make_error(common::MemSPrintf("Can't create file: %s", out_path.c_str()));
+  }
+
+#if defined(HAVE_ZSTD)
+  common::Error err = gzip ? GzipFile(in, out) : ZstdFile(in, out);
+#else
+  common::Error err = GzipFile(in, out);
+#endif
+  fclose(in);
+  if (fclose(out) != 0 && !err) {
+    err = common::make_error("Write compressed file failed");
+  }
+  if (err) {
+    unlink(out_path.c_str());
+    return err;
+  }
+
+  *out_file = file_path_t(out_path);
+  return common::Error();
+}
+
+#if defined(HAVE_OPENSSL)
+int ConnectTcp(const std::string& host, const std::string& port) {
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* result = nullptr;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0) {
+    return -1;
+  }
+
+  int fd = -1;
+  for (struct addrinfo* rp = result; rp; rp = rp->ai_next) {
+    fd = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
+    if (fd == -1) {
+      continue;
+    }
+    if (connect(fd, rp->ai_addr, rp->ai_addrlen) == 0) {
+      break;
+    }
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(result);
+  return fd;
+}
+
+bool SSLWriteAll(SSL* ssl, const char* data, size_t size) {
+  while (size) {
+    int written = SSL_write(ssl, data, static_cast<int>(size));
+    if (written <= 0) {
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+common::Error SendHttpsFile(SSL* ssl, const std::string& host, const file_path_t& file, const common::uri::Url& url) {
+  FILE* in = fopen(file.GetPath().c_str(), "rb");
+  if (!in) {
+    return common::make_error(common::MemSPrintf("Can't open file: %s", file.GetPath().c_str()));
+  }
+
+  struct stat sb;
+  if (fstat(fileno(in), &sb) != 0) {
+    fclose(in);
+    return common::make_error(common::MemSPrintf("Can't stat file: %s", file.GetPath().c_str()));
+  }
+
+  const auto upath = url.GetPath();
+  const std::string query = upath.GetQuery();
+  const std::string request_path = upath.GetHpath() + upath.GetFileName() + (query.empty() ? query : "?" + query);
+  const std::string header = common::MemSPrintf(
+      "POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: application/octet-stream\r\nContent-Length: %s\r\n"
+      "Connection: close\r\n\r\n",
+      request_path.c_str(), host.c_str(), common::ConvertToString(static_cast<uint64_t>(sb.st_size)).c_str());
+  if (!SSLWriteAll(ssl, header.data(), header.size())) {
+    fclose(in);
+    return common::make_error("Https write failed");
+  }
+
+  std::vector<char> buf(UPLOAD_CHUNK_SIZE);
+  size_t readed;
+  while ((readed = fread(buf.data(), 1, buf.size(), in)) > 0) {
+    if (!SSLWriteAll(ssl, buf.data(), readed)) {
+      fclose(in);
+      return common::make_error("Https write failed");
+    }
+  }
+  fclose(in);
+
+  char status[32] = {0};
+  int readed_status = SSL_read(ssl, status, sizeof(status) - 1);
+  if (readed_status <= 0) {
+    return common::make_error("Https response read failed");
+  }
+  // HTTP/1.1 2xx
+  const char* code = strchr(status, ' ');
+  if (!code || code[1] != '2') {
+    const std::string status_line(status, strcspn(status, "\r\n"));
+    return common::make_error(common::MemSPrintf("Https upload rejected: %s", status_line.c_str()));
+  }
+  return common::Error();
+}
+
+common::Error PostHttpsFile(const file_path_t& file, const common::uri::Url& url) {
+  const std::string host_str = url.GetHost();
+  if (host_str.empty()) {
+    return common::make_error_inval();
+  }
+
+  std::string host = host_str;
+  std::string port = HTTPS_DEFAULT_PORT;
+  size_t del = host_str.find_last_of(':');
+  if (del != std::string::npos) {
+    host = host_str.substr(0, del);
+    port = host_str.substr(del + 1);
+  }
+
+  int fd = ConnectTcp(host, port);
+  if (fd == -1) {
+    return common::make_error(common::MemSPrintf("Can't connect to: %s", host_str.c_str()));
+  }
+
+  SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+  if (!ctx) {
+    close(fd);
+    return common::make_error("Tls init failed");
+  }
+  SSL_CTX_set_default_verify_paths(ctx);
+  SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, nullptr);
+
+  SSL* ssl = SSL_new(ctx);
+  SSL_set_tlsext_host_name(ssl, host.c_str());
+  SSL_set1_host(ssl, host.c_str());
+  SSL_set_fd(ssl, fd);
+
+  common::Error err;
+  if (SSL_connect(ssl) != 1) {
+    err = common::make_error(common::MemSPrintf("Tls handshake with %s failed", host_str.c_str()));
+  } else {
+    err = SendHttpsFile(ssl, host_str, file, url);
+    SSL_shutdown(ssl);
+  }
+
+  SSL_free(ssl);
+  SSL_CTX_free(ctx);
+  close(fd);
+  return err;
+}
+#endif
+
+}  // namespace
+
+namespace fastocloud {
+namespace server {
+
+FileUploader::FileUploader(const std::string& compression) : compression_(compression), worker_(1) {}
+
+FileUploader::~FileUploader() {}
+
+void FileUploader::Upload(const file_path_t& file, const common::uri::Url& url, done_t done) {
+  worker_.Post([this, file, url, done]() {
+    common::Error err = DoUpload(file, url);
+    if (done) {
+      done(file, url, err);
+    }
+  });
+}
+
+common::Error FileUploader::DoUpload(const file_path_t& file, const common::uri::Url& url) const {
+  const auto scheme = url.GetScheme();
+  if (scheme != common::uri::Url::http && scheme != common::uri::Url::https) {
+    return common::make_error_inval();
+  }
+
+#if !defined(HAVE_OPENSSL)
+  if (scheme == common::uri::Url::https) {
+    return common::make_error("Https uploads not supported by this build");
+  }
+#endif
+
+  file_path_t send_file = file;
+  const bool compressed = compression_ != UPLOAD_COMPRESSION_NONE;
+  if (compressed) {
+    common::Error err = CompressFile(file, compression_, &send_file);
+    if (err) {
+      return err;
+    }
+  }
+
+#if defined(HAVE_OPENSSL)
+  common::Error err = scheme == common::uri::Url::https ? PostHttpsFile(send_file, url) : PostHttpFile(send_file, url);
+#else
+  common::Error err = PostHttpFile(send_file, url);
+#endif
+  if (compressed) {
+    unlink(send_file.GetPath().c_str());
+  }
+  return err;
+}
+
+}  // namespace server
+}  // namespace fastocloud
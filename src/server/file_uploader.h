@@ -0,0 +1,51 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include <common/error.h>
+#include <common/file_system/path.h>
+#include <common/uri/url.h>
+
+#include "server/config_workers.h"
+
+namespace fastocloud {
+namespace server {
+
+// logs, pipelines and profiles sent from own thread, slow receivers and big files not block daemon loop,
+// file compressed chunk by chunk to temporary file next to it before send
+class FileUploader {
+ public:
+  typedef common::file_system::ascii_file_string_path file_path_t;
+  typedef std::function<void(const file_path_t& file, const common::uri::Url& url, common::Error err)> done_t;
+
+  explicit FileUploader(const std::string& compression);  // none, gzip or zstd
+  ~FileUploader();  // not started uploads dropped, running joined
+
+  void Upload(const file_path_t& file, const common::uri::Url& url, done_t done);  // done called on uploader thread
+
+ private:
+  common::Error DoUpload(const file_path_t& file, const common::uri::Url& url) const;
+
+  const std::string compression_;
+  ConfigWorkers worker_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileUploader);
+};
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,164 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/gpu_stats/encoder_pool.h"
+
+#include <algorithm>
+
+#include "base/gst_constants.h"
+
+namespace fastocloud {
+namespace server {
+namespace gpu_stats {
+
+EncoderPool::EncoderPool(size_t max_nvenc_sessions, int max_load)
+    : max_nvenc_sessions_(max_nvenc_sessions), max_load_(max_load), sessions_() {}
+
+std::string EncoderPool::Acquire(fastotv::stream_id_t sid,
+                                 const std::string& video_codec,
+                                 int gpu_load,
+                                 const devices_stats_t& devices,
+                                 int* device_index) {
+  Release(sid);
+  if (device_index) {
+    *device_index = invalid_device_index;
+  }
+
+  Device device;
+  if (!GetDevice(video_codec, &device)) {
+    return video_codec;
+  }
+
+  Session session = {device, invalid_device_index};
+  if (device == NVIDIA_DEVICE && !devices.empty()) {
+    session.index = SelectNvidiaDevice(devices);
+    if (session.index == invalid_device_index) {
+      return GetSoftwareEncoder(video_codec);
+    }
+  } else if (!HaveCapacity(device, gpu_load)) {
+    return GetSoftwareEncoder(video_codec);
+  }
+
+  sessions_[sid] = session;
+  if (device_index) {
+    *device_index = session.index;
+  }
+  return video_codec;
+}
+
+void EncoderPool::Release(fastotv::stream_id_t sid) {
+  sessions_.erase(sid);
+}
+
+void EncoderPool::Restore(fastotv::stream_id_t sid, const std::string& active_codec, int device_index) {
+  Release(sid);
+  Device device;
+  if (!GetDevice(active_codec, &device)) {  // fell back to software encoder
+    return;
+  }
+
+  const Session session = {device, device == NVIDIA_DEVICE ? device_index : invalid_device_index};
+  sessions_[sid] = session;
+}
+
+size_t EncoderPool::GetSessions(Device device) const {
+  size_t count = 0;
+  for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
+    if (it->second.device == device) {
+      count++;
+    }
+  }
+  return count;
+}
+
+size_t EncoderPool::GetSessions(Device device, int device_index) const {
+  size_t count = 0;
+  for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
+    if (it->second.device == device && it->second.index == device_index) {
+      count++;
+    }
+  }
+  return count;
+}
+
+bool EncoderPool::GetDevice(const std::string& video_codec, Device* device) {
+  if (!device) {
+    return false;
+  }
+
+  if (video_codec == NV_H264_ENC || video_codec == NV_H265_ENC || video_codec == NV_AV1_ENC) {
+    *device = NVIDIA_DEVICE;
+    return true;
+  } else if (video_codec == MFX_H264_ENC || video_codec == VAAPI_H264_ENC || video_codec == VAAPI_MPEG2_ENC ||
+             video_codec == QSV_AV1_ENC || video_codec == VA_AV1_ENC) {
+    *device = INTEL_DEVICE;
+    return true;
+  }
+
+  return false;
+}
+
+std::string EncoderPool::GetSoftwareEncoder(const std::string& video_codec) {
+  if (video_codec == NV_H265_ENC) {
+    return X265_ENC;
+  } else if (video_codec == VAAPI_MPEG2_ENC) {
+    return MPEG2_ENC;
+  } else if (video_codec == NV_AV1_ENC || video_codec == QSV_AV1_ENC || video_codec == VA_AV1_ENC) {
+    return SVT_AV1_ENC;
+  }
+
+  return X264_ENC;
+}
+
+bool EncoderPool::HaveCapacity(Device device, int gpu_load) const {
+  if (max_load_ && gpu_load >= max_load_) {
+    return false;
+  }
+
+  if (device == NVIDIA_DEVICE && max_nvenc_sessions_ != unlimited_sessions) {
+    return GetSessions(NVIDIA_DEVICE) < max_nvenc_sessions_;
+  }
+
+  return true;
+}
+
+int EncoderPool::SelectNvidiaDevice(const devices_stats_t& devices) const {
+  int selected = invalid_device_index;
+  int selected_score = 0;
+  for (size_t i = 0; i < devices.size(); ++i) {
+    const DeviceStats& stats = devices[i];
+    const int index = static_cast<int>(i);
+    const size_t sessions = GetSessions(NVIDIA_DEVICE, index);
+    if (max_nvenc_sessions_ != unlimited_sessions && sessions >= max_nvenc_sessions_) {
+      continue;
+    }
+
+    const int load = std::max(stats.encoder_load, stats.decoder_load);
+    if (max_load_ && (load >= max_load_ || stats.memory_load >= max_load_)) {
+      continue;
+    }
+
+    const int score = load + stats.memory_load + static_cast<int>(sessions) * session_load_estimate;
+    if (selected == invalid_device_index || score < selected_score) {
+      selected = index;
+      selected_score = score;
+    }
+  }
+
+  return selected;
+}
+
+}  // namespace gpu_stats
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,74 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <fastotv/types.h>
+
+#include "server/gpu_stats/perf_monitor.h"
+
+namespace fastocloud {
+namespace server {
+namespace gpu_stats {
+
+// hardware encoder sessions opened by children, used to pick a gpu or cpu encoder per stream at start
+// and the least loaded gpu if there are several of them
+class EncoderPool {
+ public:
+  enum Device { NVIDIA_DEVICE = 0, INTEL_DEVICE, DEVICES_COUNT };
+  enum {
+    unlimited_sessions = 0,
+    invalid_device_index = -1,
+    session_load_estimate = 10  // percents, load of just started session not yet visible in monitor
+  };
+
+  EncoderPool(size_t max_nvenc_sessions, int max_load);
+
+  // returns encoder which child should use: requested one or software fallback if devices saturated,
+  // device_index is gpu selected for nvidia encoders, invalid_device_index if not placed
+  std::string Acquire(fastotv::stream_id_t sid,
+                      const std::string& video_codec,
+                      int gpu_load,
+                      const devices_stats_t& devices,
+                      int* device_index);
+  void Release(fastotv::stream_id_t sid);
+  // session of running stream adopted from previous service, encoder and device as chosen by Acquire then
+  void Restore(fastotv::stream_id_t sid, const std::string& active_codec, int device_index);
+
+  size_t GetSessions(Device device) const;
+  size_t GetSessions(Device device, int device_index) const;
+
+  static bool GetDevice(const std::string& video_codec, Device* device);
+  static std::string GetSoftwareEncoder(const std::string& video_codec);
+
+ private:
+  struct Session {
+    Device device;
+    int index;
+  };
+
+  bool HaveCapacity(Device device, int gpu_load) const;
+  int SelectNvidiaDevice(const devices_stats_t& devices) const;  // invalid_device_index if all saturated
+
+  const size_t max_nvenc_sessions_;
+  const int max_load_;  // percents
+  std::map<fastotv::stream_id_t, Session> sessions_;
+};
+
+}  // namespace gpu_stats
+}  // namespace server
+}  // namespace fastocloud
@@ -18,13 +18,16 @@
 
 #include <cttmetrics.h>
 
+#include <algorithm>
+
 #define METRIC_TIMEOUT_MSEC 1000
 
 namespace fastocloud {
 namespace server {
 namespace gpu_stats {
 
-IntelMonitor::IntelMonitor(int* load) : load_(load), stop_mutex_(), stop_cond_(), stop_flag_(false) {}
+IntelMonitor::IntelMonitor(int* load, DevicesHolder* devices)
+    : load_(load), devices_(devices), stop_mutex_(), stop_cond_(), stop_flag_(false) {}
 
 IntelMonitor::~IntelMonitor() {}
 
@@ -48,7 +51,7 @@ bool IntelMonitor::Exec() {
     return false;
   }
 
-  cttMetric metrics_ids[] = {CTT_USAGE_RENDER};
+  cttMetric metrics_ids[] = {CTT_USAGE_RENDER, CTT_USAGE_VIDEO};
   static const unsigned int metric_cnt = sizeof(metrics_ids) / sizeof(metrics_ids[0]);
   static const unsigned int num_samples = 100;
   static const unsigned int period_ms = METRIC_TIMEOUT_MSEC;
@@ -93,7 +96,17 @@ bool IntelMonitor::Exec() {
     if (CTT_ERR_NONE != status) {
       break;
     }
-    *load_ = metric_values[0];
+    // qsv codecs run on video box or render engine (vme), busiest of them reported for encoding and decoding
+    const float render = metric_values[0];
+    const float video = metric_values[1];
+    *load_ = std::max(render, video);
+    if (devices_) {
+      DeviceStats device;
+      device.encoder_load = *load_;
+      device.decoder_load = *load_;
+      device.compute_load = render;
+      devices_->Set(devices_stats_t(1, device));
+    }
 
     std::cv_status interrupt_status = stop_cond_.wait_for(lock, std::chrono::seconds(1));
     if (interrupt_status == std::cv_status::no_timeout) {  // if notify
@@ -24,7 +24,7 @@ namespace gpu_stats {
 
 class IntelMonitor : public IPerfMonitor {
  public:
-  explicit IntelMonitor(int* load);
+  IntelMonitor(int* load, DevicesHolder* devices);
   ~IntelMonitor() override;
 
   bool Exec() override;
@@ -34,6 +34,7 @@ class IntelMonitor : public IPerfMonitor {
 
  private:
   int* load_;
+  DevicesHolder* devices_;
   std::mutex stop_mutex_;
   std::condition_variable stop_cond_;
   bool stop_flag_;
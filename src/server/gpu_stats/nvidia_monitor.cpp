@@ -16,11 +16,46 @@
 
 #include <nvml.h>
 
+#include <algorithm>
+
 namespace fastocloud {
 namespace server {
 namespace gpu_stats {
 
-NvidiaMonitor::NvidiaMonitor(int* load) : load_(load), stop_mutex_(), stop_cond_(), stop_flag_(false) {}
+namespace {
+// utilization of processes sampled after last_seen, samples buffer reused between calls
+processes_stats_t GetProcesses(nvmlDevice_t device,
+                               unsigned long long* last_seen,
+                               std::vector<nvmlProcessUtilizationSample_t>* samples) {
+  unsigned count = 0;
+  nvmlReturn_t ret = nvmlDeviceGetProcessUtilization(device, nullptr, &count, *last_seen);
+  if ((ret != NVML_SUCCESS && ret != NVML_ERROR_INSUFFICIENT_SIZE) || count == 0) {
+    return processes_stats_t();
+  }
+
+  samples->resize(count);
+  ret = nvmlDeviceGetProcessUtilization(device, samples->data(), &count, *last_seen);
+  if (ret != NVML_SUCCESS) {
+    return processes_stats_t();
+  }
+
+  processes_stats_t processes;
+  for (unsigned i = 0; i < count; ++i) {
+    const nvmlProcessUtilizationSample_t& sample = (*samples)[i];
+    *last_seen = std::max(*last_seen, sample.timeStamp);
+    ProcessStats process;
+    process.pid = sample.pid;
+    process.encoder_load = sample.encUtil;
+    process.decoder_load = sample.decUtil;
+    process.compute_load = sample.smUtil;
+    processes.push_back(process);
+  }
+  return processes;
+}
+}  // namespace
+
+NvidiaMonitor::NvidiaMonitor(int* load, DevicesHolder* devices)
+    : load_(load), devices_(devices), stop_mutex_(), stop_cond_(), stop_flag_(false) {}
 
 NvidiaMonitor::~NvidiaMonitor() {}
 
@@ -59,9 +94,12 @@ bool NvidiaMonitor::Exec() {
     return false;
   }
 
+  std::vector<unsigned long long> last_seen(devices_num, 0);  // process samples timestamps by device
+  std::vector<nvmlProcessUtilizationSample_t> samples;
   std::unique_lock<std::mutex> lock(stop_mutex_);
   while (!stop_flag_) {
     uint64_t total_enc = 0, total_dec = 0;
+    devices_stats_t stats(devices_num);
     for (unsigned i = 0; i != devices_num; ++i) {
       unsigned enc, dec, enc_sampling, dec_sampling;
       nvmlDevice_t device;
@@ -77,10 +115,34 @@ bool NvidiaMonitor::Exec() {
       if (ret != NVML_SUCCESS) {
         continue;
       }
+      nvmlMemory_t memory;
+      ret = nvmlDeviceGetMemoryInfo(device, &memory);
+      if (ret == NVML_SUCCESS && memory.total) {
+        stats[i].memory_load = memory.used * 100 / memory.total;
+        stats[i].memory_total = memory.total;
+        stats[i].memory_used = memory.used;
+      }
+      nvmlUtilization_t utilization;
+      if (nvmlDeviceGetUtilizationRates(device, &utilization) == NVML_SUCCESS) {
+        stats[i].compute_load = utilization.gpu;
+      }
+      unsigned pcie_kbps = 0;
+      if (nvmlDeviceGetPcieThroughput(device, NVML_PCIE_UTIL_RX_BYTES, &pcie_kbps) == NVML_SUCCESS) {
+        stats[i].pcie_rx_bps = static_cast<uint64_t>(pcie_kbps) * 1024;
+      }
+      if (nvmlDeviceGetPcieThroughput(device, NVML_PCIE_UTIL_TX_BYTES, &pcie_kbps) == NVML_SUCCESS) {
+        stats[i].pcie_tx_bps = static_cast<uint64_t>(pcie_kbps) * 1024;
+      }
+      stats[i].processes = GetProcesses(device, &last_seen[i], &samples);
+      stats[i].encoder_load = enc;
+      stats[i].decoder_load = dec;
       total_dec += dec;
       total_enc += enc;
     }
     *load_ = (total_dec + total_enc) / (devices_num * 2);
+    if (devices_) {
+      devices_->Set(stats);
+    }
 
     std::cv_status interrupt_status = stop_cond_.wait_for(lock, std::chrono::seconds(1));
     if (interrupt_status == std::cv_status::no_timeout) {  // if notify
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <condition_variable>
+#include <vector>
 
 #include "server/gpu_stats/perf_monitor.h"
 
@@ -24,7 +25,7 @@ namespace gpu_stats {
 
 class NvidiaMonitor : public IPerfMonitor {
  public:
-  explicit NvidiaMonitor(int* load);
+  NvidiaMonitor(int* load, DevicesHolder* devices);
   ~NvidiaMonitor() override;
 
   bool Exec() override;
@@ -34,6 +35,7 @@ class NvidiaMonitor : public IPerfMonitor {
 
  private:
   int* load_;
+  DevicesHolder* devices_;
   std::mutex stop_mutex_;
   std::condition_variable stop_cond_;
   bool stop_flag_;
@@ -46,18 +46,43 @@ namespace fastocloud {
 namespace server {
 namespace gpu_stats {
 
+ProcessStats::ProcessStats() : pid(0), encoder_load(0), decoder_load(0), compute_load(0) {}
+
+DeviceStats::DeviceStats()
+    : encoder_load(0),
+      decoder_load(0),
+      compute_load(0),
+      memory_load(0),
+      memory_total(0),
+      memory_used(0),
+      pcie_rx_bps(0),
+      pcie_tx_bps(0),
+      processes() {}
+
+DevicesHolder::DevicesHolder() : mutex_(), devices_() {}
+
+devices_stats_t DevicesHolder::Get() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return devices_;
+}
+
+void DevicesHolder::Set(const devices_stats_t& devices) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  devices_ = devices;
+}
+
 IPerfMonitor::~IPerfMonitor() {}
 
-IPerfMonitor* CreatePerfMonitor(int* load) {
+IPerfMonitor* CreatePerfMonitor(int* load, DevicesHolder* devices) {
   if (IsNvidiaGpuAvailable()) {
 #if defined(HAVE_NVML)
-    return new NvidiaMonitor(load);
+    return new NvidiaMonitor(load, devices);
 #else
     return nullptr;
 #endif
   } else if (IsIntelGpuAvailable()) {
 #if defined(HAVE_CTT_METRICS)
-    return new IntelMonitor(load);
+    return new IntelMonitor(load, devices);
 #else
     return nullptr;
 #endif
@@ -14,10 +14,55 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <mutex>
+#include <vector>
+
 namespace fastocloud {
 namespace server {
 namespace gpu_stats {
 
+struct ProcessStats {
+  ProcessStats();
+
+  long pid;
+  int encoder_load;  // percents of device
+  int decoder_load;  // percents of device
+  int compute_load;  // percents of device
+};
+
+typedef std::vector<ProcessStats> processes_stats_t;
+
+struct DeviceStats {
+  DeviceStats();
+
+  int encoder_load;  // percents
+  int decoder_load;  // percents
+  int compute_load;  // percents, 3d/compute engine
+  int memory_load;   // percents of used memory
+  uint64_t memory_total;  // bytes
+  uint64_t memory_used;   // bytes
+  uint64_t pcie_rx_bps;   // bytes per second
+  uint64_t pcie_tx_bps;   // bytes per second
+  processes_stats_t processes;  // sampled since previous shot, nvidia only
+};
+
+typedef std::vector<DeviceStats> devices_stats_t;  // by device index
+
+// written by monitor thread, read by placement in daemon loop
+class DevicesHolder {
+ public:
+  DevicesHolder();
+
+  devices_stats_t Get() const;
+  void Set(const devices_stats_t& devices);
+
+ private:
+  mutable std::mutex mutex_;
+  devices_stats_t devices_;
+};
+
 class IPerfMonitor {
  public:
   virtual ~IPerfMonitor();
@@ -26,7 +71,7 @@ class IPerfMonitor {
   virtual void Stop() = 0;
 };
 
-IPerfMonitor* CreatePerfMonitor(int* load);
+IPerfMonitor* CreatePerfMonitor(int* load, DevicesHolder* devices);
 
 }  // namespace gpu_stats
 }  // namespace server
@@ -0,0 +1,154 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/hls_retention.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "base/types.h"
+
+#include "utils/m3u8_reader.h"
+
+namespace fastocloud {
+namespace server {
+
+HlsRetention::HlsRetention(size_t max_files, fastotv::timestamp_t window_msec)
+    : max_files_(std::max<size_t>(max_files, playlist_length + margin_files)),
+      window_msec_(window_msec),
+      mutex_(),
+      outputs_(),
+      windows_() {}
+
+void HlsRetention::Track(fastotv::stream_id_t sid, const std::string& dir, const std::string& playlist) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  outputs_[dir] = {sid, playlist, 0, 0, false};
+  windows_.insert(std::make_pair(sid, Window{0, 0}));  // window starts by next update
+}
+
+void HlsRetention::Untrack(fastotv::stream_id_t sid) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  windows_.erase(sid);
+  for (auto it = outputs_.begin(); it != outputs_.end();) {
+    if (it->second.sid == sid) {
+      it = outputs_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void HlsRetention::Record(const std::string& dir, const std::string& file_name) {
+  uint64_t index;
+  if (!GetSegmentIndex(file_name, &index)) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = outputs_.find(dir);
+  if (it == outputs_.end()) {
+    return;
+  }
+
+  Output& output = it->second;
+  if (!output.requested) {
+    output.oldest = output.newest = index;
+    output.requested = true;
+    return;
+  }
+  output.oldest = std::min(output.oldest, index);
+  output.newest = std::max(output.newest, index);
+}
+
+HlsRetention::changes_t HlsRetention::Update(fastotv::timestamp_t now) {
+  std::vector<std::pair<std::string, Output>> ended;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& window : windows_) {
+      if (!window.second.start) {  // tracked since last update
+        window.second.start = now;
+      }
+    }
+    for (auto& output : outputs_) {
+      auto window = windows_.find(output.second.sid);
+      if (window == windows_.end() || now - window->second.start < window_msec_) {
+        continue;
+      }
+      ended.push_back(output);
+      output.second.requested = false;
+    }
+    for (const auto& output : ended) {
+      windows_[output.second.sid].start = now;
+    }
+  }
+
+  // playlists read without lock, viewers keep recording
+  std::map<fastotv::stream_id_t, uint64_t> lags;
+  for (const auto& output : ended) {
+    uint64_t& lag = lags[output.second.sid];
+    if (!output.second.requested) {
+      continue;
+    }
+
+    uint64_t edge = output.second.newest;
+    utils::M3u8Reader reader;
+    if (reader.Parse(output.first + output.second.playlist) && !reader.GetChunks().empty()) {
+      edge = std::max(edge, reader.GetChunks().back().index);
+    }
+    lag = std::max(lag, edge - output.second.oldest);
+  }
+
+  changes_t changes;
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (const auto& lag : lags) {
+    auto window = windows_.find(lag.first);
+    if (window == windows_.end()) {  // stopped meanwhile
+      continue;
+    }
+
+    const uint64_t needed = std::max<uint64_t>(playlist_length, lag.second + 1) + margin_files;
+    const size_t max_files = static_cast<size_t>(std::min<uint64_t>(needed, max_files_));
+    if (window->second.max_files != max_files) {
+      window->second.max_files = max_files;
+      changes.push_back(std::make_pair(lag.first, max_files));
+    }
+  }
+  return changes;
+}
+
+size_t HlsRetention::GetMaxFiles(fastotv::stream_id_t sid) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto it = windows_.find(sid);
+  return it == windows_.end() ? 0 : it->second.max_files;
+}
+
+bool HlsRetention::GetSegmentIndex(const std::string& file_name, uint64_t* index) {
+  const std::string ext = CHUNK_EXT;
+  const size_t sep = file_name.rfind('_');
+  if (!index || sep == std::string::npos || file_name.size() <= ext.size() ||
+      file_name.compare(file_name.size() - ext.size(), ext.size(), ext) != 0) {
+    return false;
+  }
+
+  const std::string digits = file_name.substr(sep + 1, file_name.size() - ext.size() - sep - 1);
+  if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  *index = strtoull(digits.c_str(), nullptr, 10);
+  return true;
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,79 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <common/macros.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+namespace server {
+
+// segments kept by live hls outputs sized by requests of viewers: deepest lag behind live edge seen in window,
+// at least playlist, channels nobody rewinds keep few segments, rewound ones up to max files
+class HlsRetention {
+ public:
+  typedef std::vector<std::pair<fastotv::stream_id_t, size_t>> changes_t;
+  enum {
+    playlist_length = 5,  // of live hls sinks
+    margin_files = 2      // segment being downloaded and one written meanwhile
+  };
+
+  HlsRetention(size_t max_files, fastotv::timestamp_t window_msec);
+
+  // http root of live hls output with playlist name, several outputs of stream share its retention
+  void Track(fastotv::stream_id_t sid, const std::string& dir, const std::string& playlist);
+  void Untrack(fastotv::stream_id_t sid);
+
+  // segment of directory requested by viewer, from any thread
+  void Record(const std::string& dir, const std::string& file_name);
+
+  // streams which window ended and retention changed, live edge read from playlists
+  changes_t Update(fastotv::timestamp_t now);
+  size_t GetMaxFiles(fastotv::stream_id_t sid) const;  // last sent, 0 if not decided yet
+
+  static bool GetSegmentIndex(const std::string& file_name, uint64_t* index);  // <msec>_<index>.ts
+
+ private:
+  struct Output {
+    fastotv::stream_id_t sid;
+    std::string playlist;
+    uint64_t oldest;  // requested in window
+    uint64_t newest;
+    bool requested;
+  };
+
+  struct Window {
+    fastotv::timestamp_t start;
+    size_t max_files;
+  };
+
+  const size_t max_files_;
+  const fastotv::timestamp_t window_msec_;
+  mutable std::mutex mutex_;
+  std::map<std::string, Output> outputs_;  // by directory
+  std::map<fastotv::stream_id_t, Window> windows_;
+
+  DISALLOW_COPY_AND_ASSIGN(HlsRetention);
+};
+
+}  // namespace server
+}  // namespace fastocloud
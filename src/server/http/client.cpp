@@ -18,7 +18,7 @@ namespace fastocloud {
 namespace server {
 
 HttpClient::HttpClient(common::libev::IoLoop* server, const common::net::socket_info& info)
-    : base_class(server, info), is_verified_(false) {}
+    : base_class(server, info), is_verified_(false), request_buffer_() {}
 
 bool HttpClient::IsVerified() const {
   return is_verified_;
@@ -28,6 +28,10 @@ void HttpClient::SetVerified(bool verified) {
   is_verified_ = verified;
 }
 
+base::HttpRequestBuffer* HttpClient::GetRequestBuffer() {
+  return &request_buffer_;
+}
+
 const char* HttpClient::ClassName() const {
   return "HttpClient";
 }
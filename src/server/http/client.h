@@ -16,6 +16,8 @@
 
 #include <common/libev/http/http_client.h>
 
+#include "server/base/http_request_buffer.h"
+
 namespace fastocloud {
 namespace server {
 
@@ -28,10 +30,13 @@ class HttpClient : public common::libev::http::HttpClient {
   bool IsVerified() const;
   void SetVerified(bool verified);
 
+  base::HttpRequestBuffer* GetRequestBuffer();
+
   const char* ClassName() const override;
 
  private:
   bool is_verified_;
+  base::HttpRequestBuffer request_buffer_;
 };
 
 }  // namespace server
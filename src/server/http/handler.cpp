@@ -18,24 +18,150 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include <common/convert2string.h>
+#include <common/file_system/file_system.h>
+#include <common/time.h>
+
+#include "base/chunks_index.h"
+#include "base/ll_hls_playlist.h"
+
+#include "server/base/http_cache.h"
 #include "server/base/ihttp_requests_observer.h"
 #include "server/http/client.h"
+#include "server/metrics_registry.h"
+#include "server/stats_history.h"
+#include "server/utils/utils.h"
 
 namespace fastocloud {
 namespace server {
 
+namespace {
+
+const double blocked_check_sec = 0.1;
+const fastotv::timestamp_t blocked_max_msec = LL_HLS_SEGMENT_MSEC * 3;
+const char kMetricsFileName[] = "metrics";
+const char kMetricsMime[] = "text/plain; version=0.0.4";
+const char kStatsHistoryFileName[] = "metrics_history";
+const char kStatsHistoryMime[] = "application/json";
+const char kTimeshiftDir[] = "/timeshift/";
+const char kTimeshiftPlaylistName[] = "index.m3u8";
+const char kTimeshiftPlaylistMime[] = "application/vnd.apple.mpegurl";
+
+// delay=N in seconds, 0 if not set
+time_t ParseTimeshiftDelay(const std::string& query) {
+  std::istringstream stream(query);
+  std::string param;
+  while (std::getline(stream, param, '&')) {
+    const size_t eq = param.find('=');
+    if (eq == std::string::npos || param.substr(0, eq) != TIMESHIFT_DELAY_QUERY) {
+      continue;
+    }
+    time_t delay;
+    if (common::ConvertFromString(param.substr(eq + 1), &delay) && delay > 0) {
+      return delay;
+    }
+  }
+  return 0;
+}
+
+// since=<msec>&step=<sec>&id=<sid>[&id=<sid>], missing values left untouched
+void ParseStatsHistoryQuery(const std::string& query,
+                            StatsHistory::streams_t* ids,
+                            fastotv::timestamp_t* since,
+                            time_t* step) {
+  std::istringstream stream(query);
+  std::string param;
+  while (std::getline(stream, param, '&')) {
+    const size_t eq = param.find('=');
+    if (eq == std::string::npos) {
+      continue;
+    }
+    const std::string key = param.substr(0, eq);
+    const std::string value = param.substr(eq + 1);
+    if (key == "since") {
+      common::ConvertFromString(value, since);
+    } else if (key == "step") {
+      common::ConvertFromString(value, step);
+    } else if (key == "id" && !value.empty()) {
+      ids->push_back(value);
+    }
+  }
+}
+
+// _HLS_msn=N[&_HLS_part=M], false if not blocking request
+bool ParseBlockingQuery(const std::string& query, uint64_t* msn, int* part) {
+  bool have_msn = false;
+  int lpart = -1;
+  std::istringstream stream(query);
+  std::string param;
+  while (std::getline(stream, param, '&')) {
+    const size_t eq = param.find('=');
+    if (eq == std::string::npos) {
+      continue;
+    }
+    const std::string key = param.substr(0, eq);
+    const std::string value = param.substr(eq + 1);
+    if (key == LL_HLS_MSN_QUERY) {
+      have_msn = common::ConvertFromString(value, msn);
+    } else if (key == LL_HLS_PART_QUERY) {
+      uint64_t part_value;
+      if (common::ConvertFromString(value, &part_value)) {
+        lpart = static_cast<int>(part_value);
+      }
+    }
+  }
+  *part = lpart;
+  return have_msn;
+}
+
+bool ReadPlaylist(const std::string& path, std::string* content) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::ostringstream out;
+  out << file.rdbuf();
+  *content = out.str();
+  return true;
+}
+
+}  // namespace
+
 HttpHandler::HttpHandler(base::IHttpRequestsObserver* observer)
-    : base_class(), http_root_(http_directory_path_t::MakeHomeDir()), observer_(observer) {}
+    : base_class(),
+      http_root_(http_directory_path_t::MakeHomeDir()),
+      timeshift_root_(),
+      observer_(observer),
+      metrics_(nullptr),
+      stats_history_(nullptr),
+      request_(),
+      blocked_(),
+      blocked_timer_(INVALID_TIMER_ID) {}
 
 void HttpHandler::SetHttpRoot(const http_directory_path_t& http_root) {
   http_root_ = http_root;
 }
 
+void HttpHandler::SetTimeshiftRoot(const http_directory_path_t& timeshift_root) {
+  timeshift_root_ = timeshift_root;
+}
+
+void HttpHandler::SetMetrics(const MetricsRegistry* metrics) {
+  metrics_ = metrics;
+}
+
+void HttpHandler::SetStatsHistory(const StatsHistory* history) {
+  stats_history_ = history;
+}
+
 void HttpHandler::PreLooped(common::libev::IoLoop* server) {
-  UNUSED(server);
+  blocked_timer_ = server->CreateTimer(blocked_check_sec, true);
 }
 
 void HttpHandler::Accepted(common::libev::IoClient* client) {
@@ -47,12 +173,39 @@ void HttpHandler::Moved(common::libev::IoLoop* server, common::libev::IoClient*
 }
 
 void HttpHandler::Closed(common::libev::IoClient* client) {
+  for (auto it = blocked_.begin(); it != blocked_.end();) {
+    if (it->client == client) {
+      it = blocked_.erase(it);
+    } else {
+      ++it;
+    }
+  }
   base_class::Closed(client);
 }
 
 void HttpHandler::TimerEmited(common::libev::IoLoop* server, common::libev::timer_id_t id) {
   UNUSED(server);
-  UNUSED(id);
+  if (id != blocked_timer_ || blocked_.empty()) {
+    return;
+  }
+
+  const fastotv::timestamp_t now = common::time::current_utc_mstime();
+  std::vector<BlockedRequest> waiting;
+  std::vector<HttpClient*> to_close;
+  for (const BlockedRequest& blocked : blocked_) {
+    if (!ProcessBlocked(blocked, now)) {
+      waiting.push_back(blocked);
+    } else if (!blocked.keep_alive) {
+      to_close.push_back(blocked.client);
+    }
+  }
+  blocked_ = waiting;
+
+  // closing calls Closed, so after blocked list is consistent
+  for (HttpClient* client : to_close) {
+    ignore_result(client->Close());
+    delete client;
+  }
 }
 
 void HttpHandler::Accepted(common::libev::IoChild* child) {
@@ -71,17 +224,47 @@ void HttpHandler::ChildStatusChanged(common::libev::IoChild* child, int status,
 }
 
 void HttpHandler::DataReceived(common::libev::IoClient* client) {
-  char buff[BUF_SIZE] = {0};
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  HttpClient* hclient = static_cast<server::HttpClient*>(client);
+  base::HttpRequestBuffer* buffer = hclient->GetRequestBuffer();
+  size_t free_size = 0;
+  char* buff = buffer->PrepareWrite(&free_size);
+  if (!buff) {
+    common::ErrnoError err = hclient->SendError(common::http::HP_1_1, common::http::HS_BAD_REQUEST, nullptr,
+                                                "Request too large.", false, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    ignore_result(client->Close());
+    delete client;
+    return;
+  }
+
   size_t nread = 0;
-  common::ErrnoError errn = client->SingleRead(buff, BUF_SIZE - 1, &nread);
+  common::ErrnoError errn = client->SingleRead(buff, free_size, &nread);
   if ((errn && errn->GetErrorCode() != EAGAIN) || nread == 0) {
     ignore_result(client->Close());
     delete client;
     return;
   }
 
-  HttpClient* hclient = static_cast<server::HttpClient*>(client);
-  ProcessReceived(hclient, buff, nread);
+  buffer->CommitWrite(nread);
+  while (buffer->NextRequest(&request_)) {
+    if (!ProcessReceived(hclient, request_)) {
+      ignore_result(client->Close());
+      delete client;
+      return;
+    }
+  }
+  if (buffer->IsMalformed()) {
+    common::ErrnoError err = hclient->SendError(common::http::HP_1_1, common::http::HS_BAD_REQUEST, nullptr,
+                                                "Invalid Content-Length.", false, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    ignore_result(client->Close());
+    delete client;
+  }
 }
 
 void HttpHandler::DataReadyToWrite(common::libev::IoClient* client) {
@@ -89,14 +272,218 @@ void HttpHandler::DataReadyToWrite(common::libev::IoClient* client) {
 }
 
 void HttpHandler::PostLooped(common::libev::IoLoop* server) {
-  UNUSED(server);
+  if (blocked_timer_ != INVALID_TIMER_ID) {
+    server->RemoveTimer(blocked_timer_);
+    blocked_timer_ = INVALID_TIMER_ID;
+  }
+  blocked_.clear();
+}
+
+bool HttpHandler::ProcessBlocked(const BlockedRequest& blocked, fastotv::timestamp_t now) {
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  std::string playlist;
+  if (!ReadPlaylist(blocked.file_path, &playlist) || IsLlHlsPlaylistReady(playlist, blocked.msn, blocked.part)) {
+    SendFile(blocked.client, blocked.protocol, false, blocked.file_path, blocked.mime, base::CacheConditions(), true,
+             blocked.keep_alive);
+    return true;
+  }
+
+  if (now < blocked.deadline) {
+    return false;
+  }
+
+  const char* extra_header = "Access-Control-Allow-Origin: *";
+  common::ErrnoError err = blocked.client->SendError(blocked.protocol, common::http::HS_SERVICE_UNAVAILABLE,
+                                                     extra_header, "Playlist not updated.", blocked.keep_alive, hinf);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+  }
+  return true;
+}
+
+void HttpHandler::SendFile(HttpClient* hclient,
+                           common::http::http_protocol protocol,
+                           bool head_only,
+                           const std::string& file_path_str,
+                           const std::string& mime,
+                           const base::CacheConditions& conditions,
+                           bool immutable_segments,
+                           bool IsKeepAlive) {
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  const char* extra_header = "Access-Control-Allow-Origin: *";
+  int open_flags = O_RDONLY;
+  struct stat sb;
+  if (stat(file_path_str.c_str(), &sb) < 0) {
+    common::ErrnoError err =
+        hclient->SendError(protocol, common::http::HS_NOT_FOUND, extra_header, "File not found.", IsKeepAlive, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    return;
+  }
+
+  if (S_ISDIR(sb.st_mode)) {
+    common::ErrnoError err =
+        hclient->SendError(protocol, common::http::HS_BAD_REQUEST, extra_header, "Bad filename.", IsKeepAlive, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    return;
+  }
+
+  const std::string etag = base::MakeETag(sb.st_size, sb.st_mtime);
+  const std::string cache_headers = base::MakeCacheHeaders(etag, file_path_str, immutable_segments);
+  if (base::IsNotModified(conditions, etag, sb.st_mtime) || head_only) {  // headers only, file not opened
+    const common::http::http_status status = head_only ? common::http::HS_OK : common::http::HS_NOT_MODIFIED;
+    common::ErrnoError err = hclient->SendHeaders(protocol, status, cache_headers.c_str(), mime.c_str(), &sb.st_size,
+                                                  &sb.st_mtime, IsKeepAlive, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    return;
+  }
+
+  int file = open(file_path_str.c_str(), open_flags);
+  if (file == INVALID_DESCRIPTOR) { /* open the file for reading */
+    common::ErrnoError err = hclient->SendError(protocol, common::http::HS_FORBIDDEN, extra_header,
+                                                "File is protected.", IsKeepAlive, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    return;
+  }
+
+  common::ErrnoError err = hclient->SendHeaders(protocol, common::http::HS_OK, cache_headers.c_str(), mime.c_str(),
+                                                &sb.st_size, &sb.st_mtime, IsKeepAlive, hinf);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    ::close(file);
+    return;
+  }
+
+#if defined(OS_LINUX)
+  err = protocol != common::http::HP_2_0 ? SendFileToSocket(hclient->GetFd(), file, sb.st_size)
+                                         : hclient->SendFileByFd(protocol, file, sb.st_size);
+#else
+  err = hclient->SendFileByFd(protocol, file, sb.st_size);
+#endif
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+  } else {
+    DEBUG_LOG() << "Sent file path: " << file_path_str << ", size: " << sb.st_size;
+  }
+
+  ::close(file);
+}
+
+void HttpHandler::SendMetrics(HttpClient* hclient,
+                              common::http::http_protocol protocol,
+                              bool head_only,
+                              bool IsKeepAlive) {
+  SendBody(hclient, protocol, head_only, nullptr, metrics_->Render(), kMetricsMime, IsKeepAlive);
+}
+
+void HttpHandler::SendStatsHistory(HttpClient* hclient,
+                                   common::http::http_protocol protocol,
+                                   bool head_only,
+                                   const std::string& query,
+                                   bool IsKeepAlive) {
+  StatsHistory::streams_t ids;
+  fastotv::timestamp_t since = 0;
+  time_t step = 0;
+  ParseStatsHistoryQuery(query, &ids, &since, &step);
+  SendBody(hclient, protocol, head_only, "Access-Control-Allow-Origin: *", stats_history_->Serialize(ids, since, step),
+           kStatsHistoryMime, IsKeepAlive);
+}
+
+void HttpHandler::SendBody(HttpClient* hclient,
+                           common::http::http_protocol protocol,
+                           bool head_only,
+                           const char* extra_header,
+                           const std::string& body,
+                           const char* mime,
+                           bool IsKeepAlive) {
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  off_t size = body.size();
+  time_t mtime = time(nullptr);
+  common::ErrnoError err =
+      hclient->SendHeaders(protocol, common::http::HS_OK, extra_header, mime, &size, &mtime, IsKeepAlive, hinf);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    return;
+  }
+
+  if (!head_only) {
+    size_t nwrite = 0;
+    err = hclient->Write(body.data(), body.size(), &nwrite);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+  }
+}
+
+bool HttpHandler::ProcessTimeshift(HttpClient* hclient,
+                                   common::http::http_protocol protocol,
+                                   bool head_only,
+                                   const common::uri::Upath& path,
+                                   const base::CacheConditions& conditions,
+                                   bool IsKeepAlive) {
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  const std::string url_dirs = path.GetHpath();
+  const size_t prefix_len = sizeof(kTimeshiftDir) - 1;
+  if (!timeshift_root_.IsValid() || url_dirs.compare(0, prefix_len, kTimeshiftDir) != 0) {
+    return false;
+  }
+
+  const char* extra_header = "Access-Control-Allow-Origin: *";
+  const std::string sub_dirs = url_dirs.substr(prefix_len);
+  const auto dir = sub_dirs.find("..") == std::string::npos ? timeshift_root_.MakeDirectoryStringPath(sub_dirs)
+                                                             : common::Optional<http_directory_path_t>();
+  const auto file_path = dir ? dir->MakeFileStringPath(path.GetFileName())
+                             : common::Optional<common::file_system::ascii_file_string_path>();
+  if (!file_path) {
+    common::ErrnoError err =
+        hclient->SendError(protocol, common::http::HS_NOT_FOUND, extra_header, "File not found.", IsKeepAlive, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    return true;
+  }
+
+  if (path.GetFileName() != kTimeshiftPlaylistName) {  // chunks as is
+    uint64_t index;
+    std::string chunk;
+    if (!common::file_system::is_file_exist(file_path->GetPath()) &&
+        common::ConvertFromString(file_path->GetBaseFileName(), &index) && ReadChunkRange(*dir, index, &chunk)) {
+      SendBody(hclient, protocol, head_only, extra_header, chunk, path.GetMime().c_str(), IsKeepAlive);
+      return true;
+    }
+
+    // chunk indexes restart with recorder, not cached forever
+    SendFile(hclient, protocol, head_only, file_path->GetPath(), path.GetMime(), conditions, false, IsKeepAlive);
+    return true;
+  }
+
+  // any delay without player stream, playlist computed from index of recorder
+  const time_t delay = ParseTimeshiftDelay(path.GetQuery());
+  std::string playlist;
+  if (!MakeTimeshiftPlaylist(*dir, time(nullptr), delay, TIMESHIFT_PLAYLIST_LENGTH, &playlist)) {
+    common::ErrnoError err = hclient->SendError(protocol, common::http::HS_NOT_FOUND, extra_header,
+                                                "Not recorded yet.", IsKeepAlive, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    return true;
+  }
+
+  SendBody(hclient, protocol, head_only, extra_header, playlist, kTimeshiftPlaylistMime, IsKeepAlive);
+  return true;
 }
 
-void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size_t req_len) {
+bool HttpHandler::ProcessReceived(HttpClient* hclient, const std::string& request) {
   static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
   common::http::HttpRequest hrequest;
-  std::string request_str(request, req_len);
-  std::pair<common::http::http_status, common::Error> result = common::http::parse_http_request(request_str, &hrequest);
+  std::pair<common::http::http_status, common::Error> result = common::http::parse_http_request(request, &hrequest);
   DEBUG_LOG() << "Http request:\n" << request;
 
   if (result.second) {
@@ -107,15 +494,10 @@ void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size
     if (err) {
       DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
     }
-    ignore_result(hclient->Close());
-    delete hclient;
-    return;
+    return false;
   }
 
-  // keep alive
-  common::http::header_t connection_field;
-  bool is_find_connection = hrequest.FindHeaderByKey("Connection", false, &connection_field);
-  bool IsKeepAlive = is_find_connection ? common::EqualsASCII(connection_field.value, "Keep-Alive", false) : false;
+  const bool IsKeepAlive = base::IsKeepAliveRequest(hrequest);
   const common::http::http_protocol protocol = hrequest.GetProtocol();
   const char* extra_header = "Access-Control-Allow-Origin: *";
   if (hrequest.GetMethod() == common::http::http_method::HM_GET ||
@@ -131,6 +513,21 @@ void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size
     }
 
     const std::string url_dirs = path.GetHpath();
+    const bool head_only = hrequest.GetMethod() == common::http::http_method::HM_HEAD;
+    if (metrics_ && url_dirs == "/" && path.GetFileName() == kMetricsFileName) {
+      SendMetrics(hclient, protocol, head_only, IsKeepAlive);
+      goto finish;
+    }
+    if (stats_history_ && url_dirs == "/" && path.GetFileName() == kStatsHistoryFileName) {
+      SendStatsHistory(hclient, protocol, head_only, path.GetQuery(), IsKeepAlive);
+      goto finish;
+    }
+
+    const base::CacheConditions conditions = base::GetCacheConditions(hrequest);
+    if (ProcessTimeshift(hclient, protocol, head_only, path, conditions, IsKeepAlive)) {
+      goto finish;
+    }
+
     auto dirs_path = http_root_.MakeDirectoryStringPath(url_dirs.substr(1));
     if (!dirs_path) {
       dirs_path = http_root_;
@@ -152,62 +549,25 @@ void HttpHandler::ProcessReceived(HttpClient* hclient, const char* request, size
     }
 
     const std::string file_path_str = file_path->GetPath();
-    int open_flags = O_RDONLY;
-    struct stat sb;
-    if (stat(file_path_str.c_str(), &sb) < 0) {
-      common::ErrnoError err =
-          hclient->SendError(protocol, common::http::HS_NOT_FOUND, extra_header, "File not found.", IsKeepAlive, hinf);
-      if (err) {
-        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      }
-      goto finish;
-    }
-
-    if (S_ISDIR(sb.st_mode)) {
-      common::ErrnoError err =
-          hclient->SendError(protocol, common::http::HS_BAD_REQUEST, extra_header, "Bad filename.", IsKeepAlive, hinf);
-      if (err) {
-        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      }
-      goto finish;
-    }
-
-    int file = open(file_path_str.c_str(), open_flags);
-    if (file == INVALID_DESCRIPTOR) { /* open the file for reading */
-      common::ErrnoError err = hclient->SendError(protocol, common::http::HS_FORBIDDEN, extra_header,
-                                                  "File is protected.", IsKeepAlive, hinf);
-      if (err) {
-        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      }
-      goto finish;
-    }
-
     const std::string mime = path.GetMime();
-    common::ErrnoError err = hclient->SendHeaders(protocol, common::http::HS_OK, extra_header, mime.c_str(),
-                                                  &sb.st_size, &sb.st_mtime, IsKeepAlive, hinf);
-    if (err) {
-      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      ::close(file);
-      goto finish;
-    }
-
-    if (hrequest.GetMethod() == common::http::http_method::HM_GET) {
-      common::ErrnoError err = hclient->SendFileByFd(protocol, file, sb.st_size);
-      if (err) {
-        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      } else {
-        DEBUG_LOG() << "Sent file path: " << file_path_str << ", size: " << sb.st_size;
+    uint64_t msn;
+    int part;
+    if (!head_only && ParseBlockingQuery(path.GetQuery(), &msn, &part)) {
+      std::string playlist;
+      if (ReadPlaylist(file_path_str, &playlist) && !IsLlHlsPlaylistReady(playlist, msn, part)) {
+        // answered from timer, connection kept until then
+        const fastotv::timestamp_t deadline = common::time::current_utc_mstime() + blocked_max_msec;
+        blocked_.push_back({hclient, protocol, IsKeepAlive, file_path_str, mime, msn, part, deadline});
+        return true;
       }
     }
 
-    ::close(file);
+    // live segment names start with stream start time and never reused
+    SendFile(hclient, protocol, head_only, file_path_str, mime, conditions, true, IsKeepAlive);
   }
 
 finish:
-  if (!IsKeepAlive) {
-    ignore_result(hclient->Close());
-    delete hclient;
-  }
+  return IsKeepAlive;
 }
 
 }  // namespace server
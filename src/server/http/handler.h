@@ -14,7 +14,14 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include <common/file_system/path.h>
+#include <common/http/http.h>
+#include <common/uri/url.h>
+
+#include <fastotv/types.h>
 
 #include "server/base/iserver_handler.h"
 
@@ -22,18 +29,25 @@ namespace fastocloud {
 namespace server {
 
 class HttpClient;
+class MetricsRegistry;
+class StatsHistory;
 namespace base {
 class IHttpRequestsObserver;
+struct CacheConditions;
 }
 
 class HttpHandler : public base::IServerHandler {
  public:
-  enum { BUF_SIZE = 4096 };
   typedef base::IServerHandler base_class;
   typedef common::file_system::ascii_directory_string_path http_directory_path_t;
   explicit HttpHandler(base::IHttpRequestsObserver* observer);
 
   void SetHttpRoot(const http_directory_path_t& http_root);
+  // recorder chunks served on /timeshift/<dir>/, playlist delayed by query built from chunks index
+  void SetTimeshiftRoot(const http_directory_path_t& timeshift_root);
+  void SetMetrics(const MetricsRegistry* metrics);  // served on /metrics, not owned
+  // served on /metrics_history?since=<msec>&step=<sec>&id=<sid>, not owned
+  void SetStatsHistory(const StatsHistory* history);
 
   void PreLooped(common::libev::IoLoop* server) override;
 
@@ -51,10 +65,58 @@ class HttpHandler : public base::IServerHandler {
   void PostLooped(common::libev::IoLoop* server) override;
 
  private:
-  void ProcessReceived(HttpClient* hclient, const char* request, size_t req_len);
+  // ll-hls playlist request waiting for segment/part
+  struct BlockedRequest {
+    HttpClient* client;
+    common::http::http_protocol protocol;
+    bool keep_alive;
+    std::string file_path;
+    std::string mime;
+    uint64_t msn;
+    int part;
+    fastotv::timestamp_t deadline;  // utc msec
+  };
+
+  bool ProcessReceived(HttpClient* hclient, const std::string& request);  // false if connection should be closed
+  // 304 if conditions match, segments cached forever if immutable_segments
+  void SendFile(HttpClient* hclient,
+                common::http::http_protocol protocol,
+                bool head_only,
+                const std::string& file_path,
+                const std::string& mime,
+                const base::CacheConditions& conditions,
+                bool immutable_segments,
+                bool keep_alive);
+  void SendMetrics(HttpClient* hclient, common::http::http_protocol protocol, bool head_only, bool keep_alive);
+  void SendStatsHistory(HttpClient* hclient,
+                        common::http::http_protocol protocol,
+                        bool head_only,
+                        const std::string& query,
+                        bool keep_alive);
+  void SendBody(HttpClient* hclient,
+                common::http::http_protocol protocol,
+                bool head_only,
+                const char* extra_header,
+                const std::string& body,
+                const char* mime,
+                bool keep_alive);
+  // true if request of timeshift directory answered
+  bool ProcessTimeshift(HttpClient* hclient,
+                        common::http::http_protocol protocol,
+                        bool head_only,
+                        const common::uri::Upath& path,
+                        const base::CacheConditions& conditions,
+                        bool keep_alive);
+  bool ProcessBlocked(const BlockedRequest& blocked, fastotv::timestamp_t now);  // true if answered
 
   http_directory_path_t http_root_;
+  http_directory_path_t timeshift_root_;
   base::IHttpRequestsObserver* observer_;
+  const MetricsRegistry* metrics_;
+  const StatsHistory* stats_history_;
+  std::string request_;  // reused between requests
+  std::vector<BlockedRequest> blocked_;
+  common::libev::timer_id_t blocked_timer_;
 };
 
 }  // namespace server
@@ -0,0 +1,206 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/inference_pool.h"
+
+#if defined(OS_LINUX)
+#include <sys/prctl.h>
+#endif
+
+#include <dlfcn.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+#include <common/file_system/file_system.h>
+#include <common/file_system/string_path_utils.h>
+
+#include "base/config_fields.h"
+
+namespace {
+
+typedef int (*inference_exec_t)(const char* process_name, const void* args);
+
+void SetProcessName(int argc, char** argv, const std::string& new_process_name) {
+  const char* new_name = new_process_name.c_str();
+#if defined(OS_LINUX)
+  for (int i = 0; i < argc; ++i) {
+    memset(argv[i], 0, strlen(argv[i]));
+  }
+  char* app_name = argv[0];
+  strncpy(app_name, new_name, new_process_name.length());
+  app_name[new_process_name.length()] = 0;
+  prctl(PR_SET_NAME, new_name);
+#elif defined(OS_FREEBSD)
+  UNUSED(argc);
+  UNUSED(argv);
+  setproctitle(new_name);
+#else
+#pragma message "Please implement"
+#endif
+}
+
+bool IsExited(pid_t pid) {
+  int status;
+  const pid_t res = waitpid(pid, &status, WNOHANG);
+  return res == pid || (res == ERROR_RESULT_VALUE && errno == ECHILD);  // child watchers of loop may reap it first
+}
+
+}  // namespace
+
+namespace fastocloud {
+namespace server {
+
+InferencePool::InferencePool(int argc, char** argv)
+    : process_argc_(argc), process_argv_(argv), workers_(), assigned_() {}
+
+InferencePool::~InferencePool() {
+  for (auto it = workers_.begin(); it != workers_.end(); ++it) {
+    Terminate(it->first, &it->second);
+  }
+}
+
+std::string InferencePool::Acquire(fastotv::stream_id_t sid, const StreamConfig& config_args) {
+  common::HashValue* learning_hash = nullptr;
+  common::Value* learning_field = config_args->Find(DEEP_LEARNING_FIELD);
+  if (!learning_field || !learning_field->GetAsHash(&learning_hash)) {
+    return std::string();
+  }
+
+  const auto learning = machine_learning::DeepLearning::MakeDeepLearning(learning_hash);
+  if (!learning || !learning->IsShared()) {
+    return std::string();
+  }
+
+  Release(sid);
+  const std::string name = machine_learning::MakeInferenceShmName(*learning);
+  auto it = workers_.find(name);
+  if (it == workers_.end()) {
+    Worker worker;
+    worker.pid = 0;
+    worker.shm = nullptr;
+    common::ErrnoError err = machine_learning::CreateInferenceShm(name, &worker.shm);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+      return std::string();
+    }
+
+    worker.args = StreamConfig(new common::HashValue);
+    worker.args->Insert(DEEP_LEARNING_FIELD, learning_hash->DeepCopy());
+    worker.args->Insert(ACTIVE_INFERENCE_SHM_FIELD, common::Value::CreateStringValueFromBasicString(name));
+    err = Spawn(name, &worker);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+      ignore_result(machine_learning::CloseInferenceShm(worker.shm));
+      ignore_result(machine_learning::UnlinkInferenceShm(name));
+      return std::string();
+    }
+    it = workers_.insert(std::make_pair(name, worker)).first;
+  }
+
+  it->second.streams.insert(sid);
+  assigned_[sid] = name;
+  return name;
+}
+
+void InferencePool::Release(fastotv::stream_id_t sid) {
+  auto assigned = assigned_.find(sid);
+  if (assigned == assigned_.end()) {
+    return;
+  }
+
+  auto it = workers_.find(assigned->second);
+  assigned_.erase(assigned);
+  if (it == workers_.end()) {
+    return;
+  }
+
+  it->second.streams.erase(sid);
+  if (it->second.streams.empty()) {
+    Terminate(it->first, &it->second);
+    workers_.erase(it);
+  }
+}
+
+void InferencePool::CheckWorkers() {
+  for (auto it = workers_.begin(); it != workers_.end(); ++it) {
+    Worker* worker = &it->second;
+    if (worker->pid > 0 && !IsExited(worker->pid)) {
+      continue;
+    }
+
+    WARNING_LOG() << "Inference worker of " << it->first << " exited, restarting, streams: " << worker->streams.size();
+    common::ErrnoError err = Spawn(it->first, worker);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+      worker->pid = 0;  // tried again next check
+    }
+  }
+}
+
+size_t InferencePool::GetWorkersCount() const {
+  return workers_.size();
+}
+
+common::ErrnoError InferencePool::Spawn(const std::string& name, Worker* worker) {
+  pid_t pid = fork();
+  if (pid < 0) {
+    return common::make_errno_error(errno);
+  }
+
+  if (pid == 0) {  // child
+    const std::string absolute_source_dir = common::file_system::absolute_path_from_relative(RELATIVE_SOURCE_DIR);
+    const std::string lib_full_path = common::file_system::make_path(absolute_source_dir, CORE_LIBRARY);
+    void* handle = dlopen(lib_full_path.c_str(), RTLD_LAZY);
+    if (!handle) {
+      ERROR_LOG() << "Failed to load " CORE_LIBRARY " path: " << lib_full_path << ", error: " << dlerror();
+      _exit(EXIT_FAILURE);
+    }
+
+    inference_exec_t inference_exec_func = reinterpret_cast<inference_exec_t>(dlsym(handle, "inference_exec"));
+    if (!inference_exec_func) {
+      ERROR_LOG() << "Failed to load inference function error: " << dlerror();
+      dlclose(handle);
+      _exit(EXIT_FAILURE);
+    }
+
+    const std::string new_process_name = STREAMER_NAME "_inference";
+    SetProcessName(process_argc_, process_argv_, new_process_name);
+    int res = inference_exec_func(new_process_name.c_str(), worker->args.get());
+    dlclose(handle);
+    _exit(res);
+  }
+
+  INFO_LOG() << "Inference worker of " << name << " started, pid: " << pid;
+  worker->pid = pid;
+  return common::ErrnoError();
+}
+
+void InferencePool::Terminate(const std::string& name, Worker* worker) {
+  if (worker->pid > 0 && kill(worker->pid, SIGTERM) == 0) {
+    int status;
+    ignore_result(waitpid(worker->pid, &status, 0));
+  }
+  INFO_LOG() << "Inference worker of " << name << " finished, drops: " << worker->shm->drops.load();
+  ignore_result(machine_learning::CloseInferenceShm(worker->shm));
+  ignore_result(machine_learning::UnlinkInferenceShm(name));
+  worker->pid = 0;
+  worker->shm = nullptr;
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <common/error.h>
+#include <common/macros.h>
+
+#include <fastotv/types.h>
+
+#include "base/machine_learning/inference_shm.h"
+#include "base/stream_config.h"
+
+namespace fastocloud {
+namespace server {
+
+// inference worker processes of node, one per model, shared by encoding streams with shared deep learning
+class InferencePool {
+ public:
+  InferencePool(int argc, char** argv);  // process args renamed in workers
+  ~InferencePool();                      // workers terminated, segments unlinked
+
+  // segment name of worker serving model of stream, worker started for first stream;
+  // empty if stream has no shared deep learning or worker can't be started
+  std::string Acquire(fastotv::stream_id_t sid, const StreamConfig& config_args);
+  void Release(fastotv::stream_id_t sid);  // worker of last stream terminated
+
+  void CheckWorkers();  // crashed workers restarted, periodic
+
+  size_t GetWorkersCount() const;
+
+ private:
+  struct Worker {
+    pid_t pid;
+    machine_learning::InferenceShm* shm;
+    StreamConfig args;
+    std::set<fastotv::stream_id_t> streams;
+  };
+
+  common::ErrnoError Spawn(const std::string& name, Worker* worker);
+  void Terminate(const std::string& name, Worker* worker);
+
+  const int process_argc_;
+  char** const process_argv_;
+  std::map<std::string, Worker> workers_;                 // by segment name
+  std::map<fastotv::stream_id_t, std::string> assigned_;  // segment names by stream
+
+  DISALLOW_COPY_AND_ASSIGN(InferencePool);
+};
+
+}  // namespace server
+}  // namespace fastocloud
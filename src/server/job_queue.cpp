@@ -0,0 +1,180 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/job_queue.h"
+
+#include <algorithm>
+
+namespace fastocloud {
+namespace server {
+
+JobQueue::JobQueue(size_t cpus, size_t max_cpu_jobs, size_t max_gpu_jobs, int pause_load)
+    : cpus_(std::max<size_t>(cpus, 1)),
+      max_jobs_{max_cpu_jobs, max_gpu_jobs},
+      pause_load_(pause_load),
+      order_(0),
+      queued_(),
+      started_() {}
+
+void JobQueue::Push(const Job& job) {
+  ignore_result(Remove(job.sid));
+  queued_.push_back({job, order_++});
+}
+
+bool JobQueue::Remove(fastotv::stream_id_t sid) {
+  if (started_.erase(sid)) {
+    return true;
+  }
+
+  for (auto it = queued_.begin(); it != queued_.end(); ++it) {
+    if (it->job.sid == sid) {
+      queued_.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool JobQueue::IsQueued(fastotv::stream_id_t sid) const {
+  for (const Queued& queued : queued_) {
+    if (queued.job.sid == sid) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool JobQueue::IsPaused(fastotv::stream_id_t sid) const {
+  const auto it = started_.find(sid);
+  return it != started_.end() && it->second.paused;
+}
+
+void JobQueue::Schedule(double node_cpu_load,
+                        std::vector<fastotv::stream_id_t>* start,
+                        std::vector<fastotv::stream_id_t>* pause,
+                        std::vector<fastotv::stream_id_t>* resume) {
+  const double live_load = GetLiveLoad(node_cpu_load);
+  if (pause_load_ != unlimited && live_load > pause_load_) {
+    // lowest priority job started last gives way first
+    auto victim = started_.end();
+    for (auto it = started_.begin(); it != started_.end(); ++it) {
+      if (it->second.paused) {
+        continue;
+      }
+      if (victim == started_.end() || it->second.priority < victim->second.priority ||
+          (it->second.priority == victim->second.priority && it->second.order > victim->second.order)) {
+        victim = it;
+      }
+    }
+    if (victim != started_.end() && pause) {
+      victim->second.paused = true;
+      pause->push_back(victim->first);
+    }
+    return;
+  }
+
+  if (pause_load_ != unlimited && live_load >= pause_load_ - resume_hysteresis) {
+    return;
+  }
+
+  auto paused = started_.end();
+  for (auto it = started_.begin(); it != started_.end(); ++it) {
+    if (!it->second.paused) {
+      continue;
+    }
+    if (paused == started_.end() || it->second.priority > paused->second.priority ||
+        (it->second.priority == paused->second.priority && it->second.order < paused->second.order)) {
+      paused = it;
+    }
+  }
+  if (paused != started_.end()) {  // continued before anything new takes the slot
+    if (resume) {
+      paused->second.paused = false;
+      paused->second.cpu_load = 0;
+      resume->push_back(paused->first);
+    }
+    return;
+  }
+
+  for (auto it = FindNext(); it != queued_.end(); it = FindNext()) {
+    started_[it->job.sid] = {it->job.resource, it->job.priority, it->order, 0, false};
+    if (start) {
+      start->push_back(it->job.sid);
+    }
+    queued_.erase(it);
+  }
+}
+
+void JobQueue::Measure(fastotv::stream_id_t sid, double cpu_load) {
+  const auto it = started_.find(sid);
+  if (it != started_.end() && !it->second.paused) {
+    it->second.cpu_load = cpu_load;
+  }
+}
+
+double JobQueue::GetLiveLoad(double node_cpu_load) const {
+  double jobs_load = 0;
+  for (const auto& started : started_) {
+    if (!started.second.paused) {
+      jobs_load += started.second.cpu_load;
+    }
+  }
+  return std::max(node_cpu_load - jobs_load / cpus_, 0.0);
+}
+
+size_t JobQueue::GetQueuedCount() const {
+  return queued_.size();
+}
+
+size_t JobQueue::GetRunningCount() const {
+  return started_.size() - GetPausedCount();
+}
+
+size_t JobQueue::GetPausedCount() const {
+  size_t paused = 0;
+  for (const auto& started : started_) {
+    if (started.second.paused) {
+      paused++;
+    }
+  }
+  return paused;
+}
+
+std::vector<JobQueue::Queued>::iterator JobQueue::FindNext() {
+  auto next = queued_.end();
+  for (auto it = queued_.begin(); it != queued_.end(); ++it) {
+    const size_t max_jobs = max_jobs_[it->job.resource];
+    if (max_jobs != unlimited && GetStartedCount(it->job.resource) >= max_jobs) {
+      continue;
+    }
+    if (next == queued_.end() || it->job.priority > next->job.priority ||
+        (it->job.priority == next->job.priority && it->order < next->order)) {
+      next = it;
+    }
+  }
+  return next;
+}
+
+size_t JobQueue::GetStartedCount(Resource resource) const {
+  size_t count = 0;
+  for (const auto& started : started_) {
+    if (started.second.resource == resource) {
+      count++;
+    }
+  }
+  return count;
+}
+
+}  // namespace server
+}  // namespace fastocloud
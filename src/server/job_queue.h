@@ -0,0 +1,92 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <common/macros.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+namespace server {
+
+// offline work (vod transcodes) started by free node capacity instead of on request,
+// higher priority first, running jobs counted per resource, paused while live load is high
+class JobQueue {
+ public:
+  enum Resource { CPU_RESOURCE = 0, GPU_RESOURCE, RESOURCES_COUNT };
+  enum {
+    unlimited = 0,
+    resume_hysteresis = 10  // percents of node below pause load before paused jobs continue
+  };
+
+  struct Job {
+    fastotv::stream_id_t sid;
+    Resource resource;
+    int priority;  // higher started first, equal ones in submit order
+  };
+
+  // max jobs running or paused per resource, pause_load in percents of node for live streams, unlimited - never
+  JobQueue(size_t cpus, size_t max_cpu_jobs, size_t max_gpu_jobs, int pause_load);
+
+  void Push(const Job& job);
+  bool Remove(fastotv::stream_id_t sid);  // queued or started, false if not a job
+  bool IsQueued(fastotv::stream_id_t sid) const;
+  bool IsPaused(fastotv::stream_id_t sid) const;
+
+  // node_cpu_load in percents of node, load of running jobs taken out of it, others are live,
+  // jobs moved to started state returned in start, one pause or resume step per call
+  void Schedule(double node_cpu_load,
+                std::vector<fastotv::stream_id_t>* start,
+                std::vector<fastotv::stream_id_t>* pause,
+                std::vector<fastotv::stream_id_t>* resume);
+  void Measure(fastotv::stream_id_t sid, double cpu_load);  // percents of one cpu, from stream statistic
+
+  double GetLiveLoad(double node_cpu_load) const;  // percents of node
+  size_t GetQueuedCount() const;
+  size_t GetRunningCount() const;  // started, paused not counted
+  size_t GetPausedCount() const;
+
+ private:
+  struct Queued {
+    Job job;
+    uint64_t order;
+  };
+
+  struct Started {
+    Resource resource;
+    int priority;
+    uint64_t order;
+    double cpu_load;
+    bool paused;
+  };
+
+  std::vector<Queued>::iterator FindNext();  // highest priority with free resource, end if nothing fits
+  size_t GetStartedCount(Resource resource) const;
+
+  const size_t cpus_;
+  const size_t max_jobs_[RESOURCES_COUNT];
+  const int pause_load_;
+  uint64_t order_;
+  std::vector<Queued> queued_;
+  std::map<fastotv::stream_id_t, Started> started_;
+
+  DISALLOW_COPY_AND_ASSIGN(JobQueue);
+};
+
+}  // namespace server
+}  // namespace fastocloud
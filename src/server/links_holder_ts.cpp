@@ -12,17 +12,17 @@
     along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <map>
-
 #include "server/links_holder_ts.h"
 
 namespace fastocloud {
 namespace server {
 
-StreamConfig LinksHolderTS::Find(const common::file_system::ascii_directory_string_path& path) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  auto it = links_.find(path);
-  if (it == links_.end()) {
+LinksHolderTS::LinksHolderTS() : write_mutex_(), links_(std::make_shared<const links_t>()) {}
+
+StreamConfig LinksHolderTS::Find(const common::file_system::ascii_directory_string_path& path) const {
+  const snapshot_t links = GetSnapshot();
+  auto it = links->find(path.GetPath());
+  if (it == links->end()) {
     return StreamConfig();
   }
 
@@ -30,18 +30,39 @@ StreamConfig LinksHolderTS::Find(const common::file_system::ascii_directory_stri
 }
 
 void LinksHolderTS::Insert(const common::file_system::ascii_directory_string_path& path, StreamConfig config) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  links_[path] = config;
+  std::unique_lock<std::mutex> lock(write_mutex_);
+  std::shared_ptr<links_t> links = std::make_shared<links_t>(*GetSnapshot());
+  (*links)[path.GetPath()] = config;
+  Publish(links);
 }
 
 void LinksHolderTS::Clear() {
-  std::unique_lock<std::mutex> lock(mutex_);
-  links_.clear();
+  std::unique_lock<std::mutex> lock(write_mutex_);
+  Publish(std::make_shared<const links_t>());
+}
+
+void LinksHolderTS::Apply(const std::vector<std::string>& removed, const links_t& inserted) {
+  if (removed.empty() && inserted.empty()) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(write_mutex_);
+  std::shared_ptr<links_t> links = std::make_shared<links_t>(*GetSnapshot());
+  for (const std::string& path : removed) {
+    links->erase(path);
+  }
+  for (auto it = inserted.begin(); it != inserted.end(); ++it) {
+    (*links)[it->first] = it->second;
+  }
+  Publish(links);
+}
+
+LinksHolderTS::snapshot_t LinksHolderTS::GetSnapshot() const {
+  return std::atomic_load(&links_);
 }
 
-std::map<common::file_system::ascii_directory_string_path, StreamConfig> LinksHolderTS::Copy() {
-  std::unique_lock<std::mutex> lock(mutex_);
-  return links_;
+void LinksHolderTS::Publish(snapshot_t links) {
+  std::atomic_store(&links_, links);
 }
 
 }  // namespace server
@@ -14,25 +14,37 @@
 
 #pragma once
 
-#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/stream_config.h"
 
 namespace fastocloud {
 namespace server {
 
+// readers take immutable snapshot, writers publish modified copy
 class LinksHolderTS {
  public:
-  StreamConfig Find(const common::file_system::ascii_directory_string_path& path);
+  typedef std::unordered_map<std::string, StreamConfig> links_t;  // key http root path
+  typedef std::shared_ptr<const links_t> snapshot_t;
+
+  LinksHolderTS();
+
+  StreamConfig Find(const common::file_system::ascii_directory_string_path& path) const;
   void Insert(const common::file_system::ascii_directory_string_path& path, StreamConfig config);
   void Clear();
+  void Apply(const std::vector<std::string>& removed, const links_t& inserted);  // one published copy
 
-  std::map<common::file_system::ascii_directory_string_path, StreamConfig> Copy();
+  snapshot_t GetSnapshot() const;
 
  private:
-  std::mutex mutex_;
-  std::map<common::file_system::ascii_directory_string_path, StreamConfig> links_;
+  void Publish(snapshot_t links);
+
+  std::mutex write_mutex_;
+  snapshot_t links_;
 };
 }  // namespace server
 }  // namespace fastocloud
@@ -0,0 +1,231 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/metrics_registry.h"
+
+#include <sstream>
+
+#define METRICS_PREFIX "fastocloud_"
+
+namespace fastocloud {
+namespace server {
+
+namespace {
+void WriteHeader(std::ostream& out, const char* name, const char* type, const char* help) {
+  out << "# HELP " METRICS_PREFIX << name << " " << help << "\n";
+  out << "# TYPE " METRICS_PREFIX << name << " " << type << "\n";
+}
+
+void WriteLabelValue(std::ostream& out, const std::string& value) {
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      out << '\\' << c;
+    } else if (c == '\n') {
+      out << "\\n";
+    } else {
+      out << c;
+    }
+  }
+}
+
+template <typename T>
+void WriteNodeSample(std::ostream& out, const char* name, const char* type, const char* help, T value) {
+  WriteHeader(out, name, type, help);
+  out << METRICS_PREFIX << name << " " << value << "\n";
+}
+
+template <typename T>
+void WriteStreamSample(std::ostream& out, const char* name, fastotv::stream_id_t sid, T value) {
+  out << METRICS_PREFIX << name << "{id=\"";
+  WriteLabelValue(out, sid);
+  out << "\"} " << value << "\n";
+}
+
+template <typename T>
+void WriteChannelSample(std::ostream& out,
+                        const char* name,
+                        fastotv::stream_id_t sid,
+                        fastotv::channel_id_t cid,
+                        T value) {
+  out << METRICS_PREFIX << name << "{id=\"";
+  WriteLabelValue(out, sid);
+  out << "\",channel=\"" << cid << "\"} " << value << "\n";
+}
+
+void WriteDeviceRates(std::ostream& out,
+                      const char* name,
+                      const char* label,
+                      const char* help,
+                      const service::io_rates_t& rates,
+                      bool in) {
+  WriteHeader(out, name, "gauge", help);
+  for (const service::IoRate& rate : rates) {
+    out << METRICS_PREFIX << name << "{" << label << "=\"";
+    WriteLabelValue(out, rate.name);
+    out << "\"} " << (in ? rate.in_bps : rate.out_bps) << "\n";
+  }
+}
+
+typedef std::map<fastotv::stream_id_t, StatisticInfo> streams_t;
+
+void WriteChannels(std::ostream& out, const streams_t& streams, bool input) {
+  const char* bps_name = input ? "stream_input_bytes_per_second" : "stream_output_bytes_per_second";
+  const char* total_name = input ? "stream_input_bytes_total" : "stream_output_bytes_total";
+  const char* drops_name = input ? "stream_input_drops_total" : "stream_output_drops_total";
+  WriteHeader(out, bps_name, "gauge", input ? "Input channel rate." : "Output channel rate.");
+  for (auto it = streams.begin(); it != streams.end(); ++it) {
+    const StreamStruct str = it->second.GetStreamStruct();
+    for (const ChannelStats& chan : input ? str.input : str.output) {
+      WriteChannelSample(out, bps_name, it->first, chan.GetID(), chan.GetBps());
+    }
+  }
+  WriteHeader(out, total_name, "counter", input ? "Input channel bytes." : "Output channel bytes.");
+  for (auto it = streams.begin(); it != streams.end(); ++it) {
+    const StreamStruct str = it->second.GetStreamStruct();
+    for (const ChannelStats& chan : input ? str.input : str.output) {
+      WriteChannelSample(out, total_name, it->first, chan.GetID(), chan.GetTotalBytes());
+    }
+  }
+  WriteHeader(out, drops_name, "counter",
+              input ? "Input socket drops of current udp socket." : "Output leaky queue drops.");
+  for (auto it = streams.begin(); it != streams.end(); ++it) {
+    const StreamStruct str = it->second.GetStreamStruct();
+    for (const ChannelStats& chan : input ? str.input : str.output) {
+      WriteChannelSample(out, drops_name, it->first, chan.GetID(), chan.GetTotalDrops());
+    }
+  }
+}
+}  // namespace
+
+MetricsRegistry::NodeMetrics::NodeMetrics()
+    : cpu_load(0),
+      gpu_load(0),
+      ram_bytes_total(0),
+      ram_bytes_free(0),
+      hdd_bytes_total(0),
+      hdd_bytes_free(0),
+      net_bytes_recv(0),
+      net_bytes_send(0),
+      uptime(0) {}
+
+MetricsRegistry::MetricsRegistry() : mutex_(), node_(), streams_(), cgroups_() {}
+
+MetricsRegistry::~MetricsRegistry() {}
+
+void MetricsRegistry::SetNode(const NodeMetrics& node) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  node_ = node;
+}
+
+void MetricsRegistry::SetStream(const StatisticInfo& stat) {
+  const fastotv::stream_id_t sid = stat.GetStreamStruct().id;
+  std::lock_guard<std::mutex> lock(mutex_);
+  streams_[sid] = stat;
+}
+
+void MetricsRegistry::SetStreamCgroup(fastotv::stream_id_t sid, const StreamCgroups::Stats& stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cgroups_[sid] = stats;
+}
+
+void MetricsRegistry::RemoveStream(fastotv::stream_id_t sid) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  streams_.erase(sid);
+  cgroups_.erase(sid);
+}
+
+std::string MetricsRegistry::Render() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::stringstream out;
+  WriteNodeSample(out, "node_cpu_load", "gauge", "Machine cpu load percent.", node_.cpu_load);
+  WriteNodeSample(out, "node_gpu_load", "gauge", "Gpu load percent.", node_.gpu_load);
+  WriteNodeSample(out, "node_memory_total_bytes", "gauge", "Machine ram.", node_.ram_bytes_total);
+  WriteNodeSample(out, "node_memory_free_bytes", "gauge", "Machine free ram.", node_.ram_bytes_free);
+  WriteNodeSample(out, "node_hdd_total_bytes", "gauge", "Machine disk space.", node_.hdd_bytes_total);
+  WriteNodeSample(out, "node_hdd_free_bytes", "gauge", "Machine free disk space.", node_.hdd_bytes_free);
+  WriteNodeSample(out, "node_network_receive_bytes_per_second", "gauge", "Machine network receive rate.",
+                  node_.net_bytes_recv);
+  WriteNodeSample(out, "node_network_send_bytes_per_second", "gauge", "Machine network send rate.",
+                  node_.net_bytes_send);
+  WriteNodeSample(out, "node_uptime_seconds", "gauge", "Machine uptime.", node_.uptime);
+  WriteDeviceRates(out, "node_interface_receive_bytes_per_second", "interface", "Network interface receive rate.",
+                   node_.interfaces, true);
+  WriteDeviceRates(out, "node_interface_send_bytes_per_second", "interface", "Network interface send rate.",
+                   node_.interfaces, false);
+  WriteDeviceRates(out, "node_disk_read_bytes_per_second", "disk", "Disk read rate.", node_.disks, true);
+  WriteDeviceRates(out, "node_disk_write_bytes_per_second", "disk", "Disk write rate.", node_.disks, false);
+
+  WriteHeader(out, "stream_status", "gauge", "Stream status, 0 new .. 4 playing, 5 frozen, 6 waiting.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_status", it->first, static_cast<int>(it->second.GetStreamStruct().status));
+  }
+  WriteHeader(out, "stream_restarts_total", "counter", "Stream pipeline restarts.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_restarts_total", it->first, it->second.GetStreamStruct().restarts);
+  }
+  WriteHeader(out, "stream_cpu_load", "gauge", "Stream process cpu load percent.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_cpu_load", it->first, it->second.GetCpuLoad());
+  }
+  WriteHeader(out, "stream_rss_bytes", "gauge", "Stream process resident memory.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_rss_bytes", it->first, it->second.GetRssBytes());
+  }
+  WriteHeader(out, "stream_queue_fill", "gauge", "Most filled pipeline queue percent.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_queue_fill", it->first, it->second.GetStreamStruct().queue_fill);
+  }
+  WriteHeader(out, "stream_queue_seconds", "gauge", "Longest buffered time of pipeline queues.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_queue_seconds", it->first, it->second.GetStreamStruct().queue_time / 1000.0);
+  }
+  WriteHeader(out, "stream_qos_events_total", "counter", "Pipeline qos messages.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_qos_events_total", it->first, it->second.GetStreamStruct().qos_events);
+  }
+  WriteHeader(out, "stream_qos_dropped_total", "counter", "Buffers dropped by pipeline elements for qos.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_qos_dropped_total", it->first, it->second.GetStreamStruct().qos_dropped);
+  }
+  WriteHeader(out, "stream_gst_memory_bytes", "gauge", "Live pipeline buffers memory, memory_accounting only.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_gst_memory_bytes", it->first, it->second.GetStreamStruct().gst_memory);
+  }
+  WriteHeader(out, "stream_heap_bytes", "gauge", "Stream process malloc memory in use.");
+  for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+    WriteStreamSample(out, "stream_heap_bytes", it->first, it->second.GetStreamStruct().heap_memory);
+  }
+  WriteHeader(out, "stream_cgroup_cpu_seconds_total", "counter", "Stream cgroup cpu time.");
+  for (auto it = cgroups_.begin(); it != cgroups_.end(); ++it) {
+    WriteStreamSample(out, "stream_cgroup_cpu_seconds_total", it->first, it->second.cpu_usec / 1000000.0);
+  }
+  WriteHeader(out, "stream_cgroup_memory_bytes", "gauge", "Stream cgroup memory with page cache.");
+  for (auto it = cgroups_.begin(); it != cgroups_.end(); ++it) {
+    WriteStreamSample(out, "stream_cgroup_memory_bytes", it->first, it->second.memory_bytes);
+  }
+  WriteHeader(out, "stream_cgroup_io_read_bytes_total", "counter", "Stream cgroup disk reads.");
+  for (auto it = cgroups_.begin(); it != cgroups_.end(); ++it) {
+    WriteStreamSample(out, "stream_cgroup_io_read_bytes_total", it->first, it->second.io_read_bytes);
+  }
+  WriteHeader(out, "stream_cgroup_io_write_bytes_total", "counter", "Stream cgroup disk writes.");
+  for (auto it = cgroups_.begin(); it != cgroups_.end(); ++it) {
+    WriteStreamSample(out, "stream_cgroup_io_write_bytes_total", it->first, it->second.io_write_bytes);
+  }
+  WriteChannels(out, streams_, true);
+  WriteChannels(out, streams_, false);
+  return out.str();
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "server/daemon/commands_info/service/details/shots.h"
+#include "server/stream_cgroups.h"
+
+#include "stream_commands/commands_info/statistic_info.h"
+
+namespace fastocloud {
+namespace server {
+
+// last known node and streams statistic, rendered in prometheus text exposition format
+// updated from daemon loop, rendered from http thread
+class MetricsRegistry {
+ public:
+  struct NodeMetrics {
+    NodeMetrics();
+
+    double cpu_load;
+    int gpu_load;
+    size_t ram_bytes_total;
+    size_t ram_bytes_free;
+    size_t hdd_bytes_total;
+    size_t hdd_bytes_free;
+    uint64_t net_bytes_recv;  // per sec
+    uint64_t net_bytes_send;  // per sec
+    time_t uptime;
+    service::io_rates_t interfaces;
+    service::io_rates_t disks;
+  };
+
+  MetricsRegistry();
+  ~MetricsRegistry();
+
+  void SetNode(const NodeMetrics& node);
+  void SetStream(const StatisticInfo& stat);
+  void SetStreamCgroup(fastotv::stream_id_t sid, const StreamCgroups::Stats& stats);  // kernel accounting
+  void RemoveStream(fastotv::stream_id_t sid);  // stream finished
+
+  std::string Render() const;
+
+ private:
+  mutable std::mutex mutex_;
+  NodeMetrics node_;
+  std::map<fastotv::stream_id_t, StatisticInfo> streams_;
+  std::map<fastotv::stream_id_t, StreamCgroups::Stats> cgroups_;
+
+  DISALLOW_COPY_AND_ASSIGN(MetricsRegistry);
+};
+
+}  // namespace server
+}  // namespace fastocloud
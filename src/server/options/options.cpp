@@ -14,10 +14,12 @@
 
 #include "server/options/options.h"
 
+#include <string.h>
+
 #include <limits>
 #include <string>
+#include <unordered_map>
 #include <utility>
-#include <vector>
 
 #include <common/draw/types.h>
 #include <common/file_system/path.h>
@@ -25,6 +27,8 @@
 
 #include "base/config_fields.h"
 #include "base/gst_constants.h"
+#include "base/priority_class.h"
+#include "base/stream_config_parse.h"
 #include "base/types.h"
 
 namespace fastocloud {
@@ -35,7 +39,10 @@ enum Validity { VALID, INVALID, FATAL };
 
 typedef Validity (*validate_callback_t)(const common::Value*);
 
-typedef std::pair<std::string, validate_callback_t> option_t;
+struct option_t {
+  const char* name;
+  validate_callback_t validate;
+};
 
 Validity dont_validate(const common::Value*) {
   return Validity::VALID;
@@ -99,6 +106,93 @@ Validity validate_restart_attempts(const common::Value* value) {
   return validate_range(value, 1, std::numeric_limits<int>::max(), false);
 }
 
+Validity validate_watchdog_msec(const common::Value* value) {
+  return validate_range(value, 100, 10000, false);
+}
+
+Validity validate_no_data_panic_msec(const common::Value* value) {
+  return validate_range(value, 500, std::numeric_limits<int>::max(), false);
+}
+
+Validity validate_content_failover_msec(const common::Value* value) {
+  return validate_range(value, 0, std::numeric_limits<int>::max(), false);
+}
+
+Validity validate_udp_batch(const common::Value* value) {
+  return validate_range(value, 0, 1024, false);
+}
+
+Validity validate_quarantine_failures(const common::Value* value) {
+  return validate_range(value, 0, 1000, false);
+}
+
+Validity validate_udp_receive_buffer(const common::Value* value) {
+  return validate_range(value, 0, std::numeric_limits<int>::max(), false);
+}
+
+Validity validate_udp_busy_poll(const common::Value* value) {
+  return validate_range(value, 0, 1000000, false);
+}
+
+Validity validate_rtsp_latency(const common::Value* value) {
+  return validate_range(value, 0, 60000, false);
+}
+
+Validity validate_rtsp_tcp_fallback_loss(const common::Value* value) {
+  return validate_range(value, 0, 100, false);
+}
+
+Validity validate_udp_out_batch(const common::Value* value) {
+  return validate_range(value, 0, 1024, false);
+}
+
+Validity validate_udp_out_send_buffer(const common::Value* value) {
+  return validate_range(value, 0, std::numeric_limits<int>::max(), false);
+}
+
+Validity validate_ll_hls_part_msec(const common::Value* value) {
+  return validate_range(value, 0, 5000, false);
+}
+
+Validity validate_hls_max_files(const common::Value* value) {
+  return validate_range(value, 1, 1000, false);
+}
+
+Validity validate_output_queue_msec(const common::Value* value) {
+  return validate_range(value, 0, 60000, false);
+}
+
+Validity validate_thumbnail_interval(const common::Value* value) {
+  return validate_range(value, 0, 3600, false);
+}
+
+Validity validate_thumbnail_width(const common::Value* value) {
+  return validate_range(value, 16, 1920, false);
+}
+
+Validity validate_latency_target_msec(const common::Value* value) {
+  return validate_range(value, 0, 60000, false);
+}
+
+Validity validate_net_clock(const common::Value* value) {
+  std::string url;
+  if (!value->GetAsBasicString(&url)) {
+    return Validity::INVALID;
+  }
+
+  static const char* schemes[] = {"ptp://", "ntp://", "net://"};
+  for (const char* scheme : schemes) {
+    if (url.compare(0, strlen(scheme), scheme) == 0) {
+      return Validity::VALID;
+    }
+  }
+  return Validity::INVALID;
+}
+
+Validity validate_pipeline_latency_msec(const common::Value* value) {
+  return validate_range(value, 0, 60000, false);
+}
+
 Validity validate_feedback_dir(const common::Value* value) {
   std::string path;
   if (!value->GetAsBasicString(&path)) {
@@ -108,6 +202,41 @@ Validity validate_feedback_dir(const common::Value* value) {
   return common::file_system::is_valid_path(path) ? Validity::VALID : Validity::INVALID;
 }
 
+Validity validate_hls_ram_dir(const common::Value* value) {
+  std::string path;
+  if (!value->GetAsBasicString(&path)) {
+    return Validity::INVALID;
+  }
+
+  return common::file_system::is_valid_path(path) ? Validity::VALID : Validity::INVALID;
+}
+
+Validity validate_timeshift_cold_dir(const common::Value* value) {
+  std::string path;
+  if (!value->GetAsBasicString(&path)) {
+    return Validity::INVALID;
+  }
+
+  return common::file_system::is_valid_path(path) ? Validity::VALID : Validity::INVALID;
+}
+
+Validity validate_catchup_recorder_dir(const common::Value* value) {
+  std::string path;
+  if (!value->GetAsBasicString(&path)) {
+    return Validity::INVALID;
+  }
+
+  return common::file_system::is_valid_path(path) ? Validity::VALID : Validity::INVALID;
+}
+
+Validity validate_timeshift_hot_time(const common::Value* value) {
+  return validate_range(value, 1, 365 * 24 * 3600, false);
+}
+
+Validity validate_timeshift_move_rate(const common::Value* value) {
+  return validate_range(value, 0, 10000, false);
+}
+
 Validity validate_timeshift_dir(const common::Value* value) {
   std::string path;
   if (!value->GetAsBasicString(&path)) {
@@ -125,6 +254,15 @@ Validity validate_timeshift_delay(const common::Value* value) {
   return validate_range(value, 0, 12 * 24 * 3600, false);
 }
 
+Validity validate_timeshift_start_utc(const common::Value* value) {
+  time_t utc;
+  if (GetTimeFromValue(value, &utc) && utc >= 0) {
+    return Validity::VALID;
+  }
+
+  return Validity::INVALID;
+}
+
 Validity validate_video_parser(const common::Value* value) {
   std::string parser_str;
   if (!value->GetAsBasicString(&parser_str)) {
@@ -198,6 +336,10 @@ Validity validate_volume(const common::Value* value) {
   return validate_range(value, 0.0, 10.0, false);
 }
 
+Validity validate_loudness_target(const common::Value* value) {
+  return validate_range(value, -70.0, -5.0, false);
+}
+
 Validity validate_delay_time(const common::Value* value) {
   return validate_is_positive(value, false);
 }
@@ -247,10 +389,30 @@ Validity validate_decklink_video_mode(const common::Value* value) {
   return validate_range(value, 0, 30, false);
 }
 
+Validity validate_vod_workers(const common::Value* value) {
+  return validate_range(value, 1, 16, false);
+}
+
+Validity validate_v4l2_io_mode(const common::Value* value) {
+  return validate_range(value, 0, 5, false);
+}
+
+Validity validate_priority_class(const common::Value* value) {
+  return validate_range(value, LIVE_PRIORITY, IDLE_PRIORITY, false);
+}
+
+Validity validate_job_priority(const common::Value* value) {
+  return validate_range(value, -100, 100, false);
+}
+
 Validity validate_video_bitrate(const common::Value* value) {
   return validate_is_positive(value, false);
 }
 
+Validity validate_video_min_bitrate(const common::Value* value) {
+  return validate_range(value, 0, std::numeric_limits<int>::max(), false);
+}
+
 Validity validate_audio_bitrate(const common::Value* value) {
   return validate_is_positive(value, false);
 }
@@ -267,6 +429,56 @@ Validity validate_audio_select(const common::Value* value) {
   return Validity::VALID;
 }
 
+Validity validate_audio_tracks(const common::Value* value) {
+  const common::ArrayValue* tracks = nullptr;
+  if (!value->GetAsList(&tracks)) {
+    return Validity::INVALID;
+  }
+
+  for (size_t i = 0; i < tracks->GetSize(); ++i) {
+    const common::Value* track = nullptr;
+    if (!tracks->Get(i, &track) || validate_audio_select(track) == Validity::INVALID) {
+      return Validity::INVALID;
+    }
+  }
+  return Validity::VALID;
+}
+
+Validity validate_rendition(const common::Value* value) {
+  const common::HashValue* rendition = nullptr;
+  if (!value->GetAsHash(&rendition)) {
+    return Validity::INVALID;
+  }
+
+  const common::Value* id = rendition->Find(RENDITION_ID_FIELD);
+  const common::Value* size = rendition->Find(SIZE_FIELD);
+  if (!id || validate_is_positive(id, false) == Validity::INVALID || !size ||
+      validate_size(size) == Validity::INVALID) {
+    return Validity::INVALID;
+  }
+
+  const common::Value* video_bitrate = rendition->Find(VIDEO_BIT_RATE_FIELD);
+  if (video_bitrate && validate_video_bitrate(video_bitrate) == Validity::INVALID) {
+    return Validity::INVALID;
+  }
+  return Validity::VALID;
+}
+
+Validity validate_renditions(const common::Value* value) {
+  const common::ArrayValue* renditions = nullptr;
+  if (!value->GetAsList(&renditions)) {
+    return Validity::INVALID;
+  }
+
+  for (size_t i = 0; i < renditions->GetSize(); ++i) {
+    const common::Value* rendition = nullptr;
+    if (!renditions->Get(i, &rendition) || validate_rendition(rendition) == Validity::INVALID) {
+      return Validity::INVALID;
+    }
+  }
+  return Validity::VALID;
+}
+
 Validity validate_mfxh264_preset(const common::Value* value) {
   return validate_range(value, 0, 7, false);
 }
@@ -411,140 +623,219 @@ Validity dummy_validator_string(const common::Value* value) {
   return not_empty.empty() ? Validity::INVALID : Validity::VALID;
 }
 
-class ConstantOptions : public std::vector<option_t> {
+const option_t ALLOWED_OPTIONS[] = {
+  {ID_FIELD, validate_id},
+  {TYPE_FIELD, validate_type},
+  {FEEDBACK_DIR_FIELD, validate_feedback_dir},
+  {LOG_LEVEL_FIELD, validate_log_level},
+  {STREAM_LINK_PATH, dont_validate},
+  {PIPE_BINARY_FIELD, dont_validate},
+  {START_SLOTS_FIELD, dont_validate},
+  {MEMORY_ACCOUNTING_FIELD, dont_validate},
+  {HEAP_RELEASE_INTERVAL_FIELD, dont_validate},
+  {QUARANTINE_FAILURES_FIELD, validate_quarantine_failures},
+  {STREAMING_POOL_THREADS_FIELD, dont_validate},
+  {STREAMING_POOL_CPUS_FIELD, dont_validate},
+  {START_SLOTS_DIR_FIELD, dont_validate},
+  {ASSETS_DIR_FIELD, dont_validate},
+  {INGEST_DIR_FIELD, dont_validate},
+  {OUTPUT_TRASH_DIR_FIELD, dont_validate},
+  {ACTIVE_VIDEO_CODEC_FIELD, dont_validate},
+  {ACTIVE_GPU_DEVICE_FIELD, dont_validate},
+  {ACTIVE_CPU_SET_FIELD, dont_validate},
+  {ACTIVE_REQUEST_TS_FIELD, dont_validate},
+  {ACTIVE_FORK_TS_FIELD, dont_validate},
+  {ACTIVE_HW_DECODE_FIELD, dont_validate},
+  {ACTIVE_ADOPT_SOCKET_FIELD, dont_validate},
+  {ACTIVE_PRIORITY_CLASS_FIELD, dont_validate},
+  {ACTIVE_PACKET_INGEST_FIELD, dont_validate},
+  {CONFIG_HASH_FIELD, dont_validate},
+  {INPUT_FIELD, validate_input},
+  {OUTPUT_FIELD, validate_output},
+  {RESTART_ATTEMPTS_FIELD, validate_restart_attempts},
+  {WATCHDOG_MSEC_FIELD, validate_watchdog_msec},
+  {NO_DATA_PANIC_MSEC_FIELD, validate_no_data_panic_msec},
+  {CONTENT_FAILOVER_MSEC_FIELD, validate_content_failover_msec},
+  {UDP_BATCH_FIELD, validate_udp_batch},
+  {UDP_RECEIVE_BUFFER_FIELD, validate_udp_receive_buffer},
+  {UDP_BUSY_POLL_FIELD, validate_udp_busy_poll},
+  {RTSP_LATENCY_FIELD, validate_rtsp_latency},
+  {RTSP_LATENCY_MIN_FIELD, validate_rtsp_latency},
+  {RTSP_LATENCY_MAX_FIELD, validate_rtsp_latency},
+  {RTSP_TCP_FALLBACK_LOSS_FIELD, validate_rtsp_tcp_fallback_loss},
+  {UDP_OUT_BATCH_FIELD, validate_udp_out_batch},
+  {UDP_OUT_SEND_BUFFER_FIELD, validate_udp_out_send_buffer},
+  {UDP_OUT_PACING_FIELD, dont_validate},
+  {UDP_OUT_FANOUT_FIELD, dont_validate},
+  {LL_HLS_PART_MSEC_FIELD, validate_ll_hls_part_msec},
+  {HLS_MAX_FILES_FIELD, validate_hls_max_files},
+  {CMAF_FIELD, dont_validate},
+  {OUTPUT_QUEUE_MSEC_FIELD, validate_output_queue_msec},
+  {LATENCY_TARGET_MSEC_FIELD, validate_latency_target_msec},
+  {CLOCK_SYNC_FIELD, dont_validate},
+  {NET_CLOCK_FIELD, validate_net_clock},
+  {PIPELINE_LATENCY_MSEC_FIELD, validate_pipeline_latency_msec},
+  {MUTED_OUTPUTS_FIELD, dont_validate},
+  {RTMP_RECONNECT_FIELD, dont_validate},
+  {HLS_RAM_DIR_FIELD, validate_hls_ram_dir},
+  {AUTO_EXIT_TIME_FIELD, validate_auto_exit_time},
+  {TIMESHIFT_DIR_FIELD, validate_timeshift_dir},
+  {TIMESHIFT_CHUNK_LIFE_TIME_FIELD, validate_timeshift_chunk_life_time},
+  {TIMESHIFT_DELAY_FIELD, validate_timeshift_delay},
+  {TIMESHIFT_START_UTC_FIELD, validate_timeshift_start_utc},
+  {MAIN_PROFILE_FIELD, dont_validate},
+  {MAIN_PROFILE_EXTERNAL_FIELD, dont_validate},
+  {VOLUME_FIELD, validate_volume},
+  {LOUDNESS_TARGET_FIELD, validate_loudness_target},
+  {DELAY_TIME_FIELD, validate_delay_time},
+  {TIMESHIFT_CHUNK_DURATION_FIELD, validate_timeshift_chunk_duration},
+  {TIMESHIFT_CHUNK_WRITER_FIELD, dont_validate},
+  {TIMESHIFT_DIRECT_IO_FIELD, dont_validate},
+  {TIMESHIFT_HOUR_FILES_FIELD, dont_validate},
+  {TIMESHIFT_COLD_DIR_FIELD, validate_timeshift_cold_dir},
+  {TIMESHIFT_HOT_TIME_FIELD, validate_timeshift_hot_time},
+  {TIMESHIFT_MOVE_RATE_FIELD, validate_timeshift_move_rate},
+  {CATCHUP_RECORDER_DIR_FIELD, validate_catchup_recorder_dir},
+  {CATCHUP_STOP_UTC_FIELD, validate_timeshift_start_utc},
+  {VIDEO_PARSER_FIELD, validate_video_parser},
+  {AUDIO_PARSER_FIELD, validate_audio_parser},
+  {AUDIO_CODEC_FIELD, validate_audio_codec},
+  {VIDEO_CODEC_FIELD, validate_video_codec},
+  {HAVE_VIDEO_FIELD, dont_validate},
+  {HAVE_AUDIO_FIELD, dont_validate},
+  {HAVE_SUBTITLE_FIELD, dont_validate},
+  {DEINTERLACE_FIELD, dont_validate},
+  {RELAY_AUDIO_FIELD, dont_validate},
+  {RELAY_VIDEO_FIELD, dont_validate},
+  {PASSTHROUGH_FIELD, dont_validate},
+  {LOW_LATENCY_FIELD, dont_validate},
+  {NETWORK_FEEDBACK_FIELD, dont_validate},
+  {AUDIO_DITHERING_FIELD, dont_validate},
+  {LOOP_FIELD, dont_validate},
+  {MMAP_FIELD, dont_validate},
+  {WARM_STANDBY_FIELD, dont_validate},
+  {HITLESS_MERGE_FIELD, dont_validate},
+  {SOFT_RESTART_FIELD, dont_validate},
+  {GAPLESS_FIELD, dont_validate},
+  {AUTOPLUG_CACHE_FIELD, dont_validate},
+  {THUMBNAIL_INTERVAL_FIELD, validate_thumbnail_interval},
+  {THUMBNAIL_WIDTH_FIELD, validate_thumbnail_width},
+  {TS_PASSTHROUGH_FIELD, dont_validate},
+  {TS_DROP_PIDS_FIELD, dont_validate},
+  {LATENCY_STATS_FIELD, dont_validate},
+  {AVFORMAT_FIELD, dont_validate},
+  {SIZE_FIELD, validate_size},
+  {CLEANUP_TS_FIELD, validate_cleanupts},
+  {VOD_WORKERS_FIELD, validate_vod_workers},
+  {VOD_OFFLINE_FIELD, dont_validate},
+  {LOGO_FIELD, dont_validate},
+  {RSVG_LOGO_FIELD, dont_validate},
+  {FRAME_RATE_FIELD, validate_framerate},
+  {ASPECT_RATIO_FIELD, validate_aspect_ratio},
+  {VIDEO_BIT_RATE_FIELD, validate_video_bitrate},
+  {VIDEO_MIN_BIT_RATE_FIELD, validate_video_min_bitrate},
+  {AUDIO_BIT_RATE_FIELD, validate_audio_bitrate},
+  {AUDIO_CHANNELS_FIELD, validate_audio_channels},
+  {AUDIO_SELECT_FIELD, validate_audio_select},
+  {AUDIO_TRACKS_FIELD, validate_audio_tracks},
+  {RENDITIONS_FIELD, validate_renditions},
+  {DECKLINK_VIDEO_MODE_FIELD, validate_decklink_video_mode},
+  {V4L2_IO_MODE_FIELD, validate_v4l2_io_mode},
+  {PRIORITY_CLASS_FIELD, validate_priority_class},
+  {JOB_PRIORITY_FIELD, validate_job_priority},
+#if defined(MACHINE_LEARNING)
+  {DEEP_LEARNING_FIELD, dont_validate},
+  {DEEP_LEARNING_OVERLAY_FIELD, dont_validate},
+  {DEEP_LEARNING_METADATA_FIELD, dont_validate},
+  {ACTIVE_INFERENCE_SHM_FIELD, dont_validate},
+#endif
+#if defined(AMAZON_KINESIS)
+  {AMAZON_KINESIS_FIELD, dont_validate},
+#endif
+  {NV_H264_ENC_PRESET, validate_nvh264_preset},
+  {NV_H265_ENC_PRESET, validate_nvh265_preset},
+  {MFX_H264_ENC_PRESET, validate_mfxh264_preset},
+  {MFX_H264_GOP_SIZE, validate_mfxh264_gopsize},
+  {X264_ENC_SPEED_PRESET, validate_x264_speed_preset},
+  {X264_ENC_THREADS, validate_x264_threads},
+  {X264_ENC_TUNE, validate_x264_tune},
+  {X264_ENC_KEY_INT_MAX, validate_x264_key_int_max},
+  {X264_ENC_VBV_BUF_CAPACITY, validate_x264_vbv_buf_capacity},
+  {X264_ENC_RC_LOOKAHED, validate_x264_rc_lookahead},
+  {X264_ENC_QP_MAX, validate_x264_qp_max},
+  {X264_ENC_PASS, validate_x264_pass},
+  {X264_ENC_ME, validate_x264_me},
+  {X264_ENC_PROFILE, dummy_validator_string},
+  {X264_ENC_STREAM_FORMAT, dummy_validator_string},
+  {X264_ENC_OPTION_STRING, dont_validate},
+  {X264_ENC_INTERLACED, dont_validate},
+  {X264_ENC_DCT8X8, dont_validate},
+  {X264_ENC_B_ADAPT, dont_validate},
+  {X264_ENC_BYTE_STREAM, dont_validate},
+  {X264_ENC_CABAC, dont_validate},
+  {X264_ENC_SLICED_THREADS, dont_validate},
+  {X264_ENC_QUANTIZER, dont_validate},
+  {VAAPI_H264_ENC_KEYFRAME_PERIOD, validate_vaapih264_keyframe_period},
+  {VAAPI_H264_ENC_TUNE, validate_vaapih264_tune},
+  {VAAPI_H264_ENC_MAX_BFRAMES, validate_vaapih264_max_bframes},
+  {VAAPI_H264_ENC_NUM_SLICES, validate_vaapih264_num_slices},
+  {VAAPI_H264_ENC_INIT_QP, validate_vaapih264_init_qp},
+  {VAAPI_H264_ENC_MIN_QP, validate_vaapih264_min_qp},
+  {VAAPI_H264_ENC_RATE_CONTROL, validate_vaapih264_rate_control},
+  {VAAPI_H264_ENC_CABAC, dont_validate},
+  {VAAPI_H264_ENC_DCT8X8, dont_validate},
+  {VAAPI_H264_ENC_CPB_LENGTH, validate_vaapih264_cpb_length},
+  {OPEN_H264_ENC_MUTLITHREAD, dont_validate},
+  {OPEN_H264_ENC_COMPLEXITY, dummy_validator_integer},
+  {OPEN_H264_ENC_RATE_CONTROL, dummy_validator_integer},
+  {OPEN_H264_ENC_GOP_SIZE, dummy_validator_integer},
+  {EAVC_ENC_PRESET, dummy_validator_integer},
+  {EAVC_ENC_PROFILE, dummy_validator_integer},
+  {EAVC_ENC_PERFORMANCE, dummy_validator_integer},
+  {EAVC_ENC_BITRATE_MODE, dummy_validator_integer},
+  {EAVC_ENC_BITRATE_PASS, dummy_validator_integer},
+  {EAVC_ENC_BITRATE_MAX, dummy_validator_integer},
+  {EAVC_ENC_VBV_SIZE, dummy_validator_integer},
+  {EAVC_ENC_PICTURE_MODE, dummy_validator_integer},
+  {EAVC_ENC_ENTROPY_MODE, dummy_validator_integer},
+  {EAVC_ENC_GOP_MAX_BCOUNT, dummy_validator_integer},
+  {EAVC_ENC_GOP_MAX_LENGTH, dummy_validator_integer},
+  {EAVC_ENC_GOP_MIN_LENGTH, dummy_validator_integer},
+  {EAVC_ENC_LEVEL, dummy_validator_integer},
+  {EAVC_ENC_DEBLOCK_MODE, dummy_validator_integer},
+  {EAVC_ENC_DEBLOCK_ALPHA, dummy_validator_integer},
+  {EAVC_ENC_DEBLOCK_BETA, dummy_validator_integer},
+  {EAVC_ENC_INITIAL_DELAY, dummy_validator_integer},
+  {EAVC_ENC_FIELD_ORDER, dummy_validator_integer},
+  {EAVC_ENC_GOP_ADAPTIVE, dont_validate}
+};
+
+// built once, validation of config is single pass with constant time lookups
+class OptionsIndex {
  public:
-  ConstantOptions(std::initializer_list<option_t> l) {
-    for (auto it = l.begin(); it != l.end(); ++it) {
-      option_t opt = *it;
-      for (auto jt = begin(); jt != end(); ++jt) {
-        option_t opt2 = *jt;
-        if (opt2.first == opt.first) {
-          NOTREACHED() << "Only unique options, but option with name: '" << opt.first << "' exists!";
-        }
+  OptionsIndex() : index_() {
+    for (const option_t& opt : ALLOWED_OPTIONS) {
+      if (!index_.insert(std::make_pair(std::string(opt.name), opt.validate)).second) {
+        NOTREACHED() << "Only unique options, but option with name: '" << opt.name << "' exists!";
       }
-      push_back(opt);
     }
   }
-};
 
-bool FindOption(const std::string& key, option_t* opt) {
-  if (!opt) {
-    return false;
-  }
-
-  static const ConstantOptions ALLOWED_OPTIONS = {
-    {ID_FIELD, validate_id},
-    {TYPE_FIELD, validate_type},
-    {FEEDBACK_DIR_FIELD, validate_feedback_dir},
-    {LOG_LEVEL_FIELD, validate_log_level},
-    {STREAM_LINK_PATH, dont_validate},
-    {INPUT_FIELD, validate_input},
-    {OUTPUT_FIELD, validate_output},
-    {RESTART_ATTEMPTS_FIELD, validate_restart_attempts},
-    {AUTO_EXIT_TIME_FIELD, validate_auto_exit_time},
-    {TIMESHIFT_DIR_FIELD, validate_timeshift_dir},
-    {TIMESHIFT_CHUNK_LIFE_TIME_FIELD, validate_timeshift_chunk_life_time},
-    {TIMESHIFT_DELAY_FIELD, validate_timeshift_delay},
-    {MAIN_PROFILE_FIELD, dont_validate},
-    {MAIN_PROFILE_EXTERNAL_FIELD, dont_validate},
-    {VOLUME_FIELD, validate_volume},
-    {DELAY_TIME_FIELD, validate_delay_time},
-    {TIMESHIFT_CHUNK_DURATION_FIELD, validate_timeshift_chunk_duration},
-    {VIDEO_PARSER_FIELD, validate_video_parser},
-    {AUDIO_PARSER_FIELD, validate_audio_parser},
-    {AUDIO_CODEC_FIELD, validate_audio_codec},
-    {VIDEO_CODEC_FIELD, validate_video_codec},
-    {HAVE_VIDEO_FIELD, dont_validate},
-    {HAVE_AUDIO_FIELD, dont_validate},
-    {HAVE_SUBTITLE_FIELD, dont_validate},
-    {DEINTERLACE_FIELD, dont_validate},
-    {RELAY_AUDIO_FIELD, dont_validate},
-    {RELAY_VIDEO_FIELD, dont_validate},
-    {LOOP_FIELD, dont_validate},
-    {AVFORMAT_FIELD, dont_validate},
-    {SIZE_FIELD, validate_size},
-    {CLEANUP_TS_FIELD, validate_cleanupts},
-    {LOGO_FIELD, dont_validate},
-    {RSVG_LOGO_FIELD, dont_validate},
-    {FRAME_RATE_FIELD, validate_framerate},
-    {ASPECT_RATIO_FIELD, validate_aspect_ratio},
-    {VIDEO_BIT_RATE_FIELD, validate_video_bitrate},
-    {AUDIO_BIT_RATE_FIELD, validate_audio_bitrate},
-    {AUDIO_CHANNELS_FIELD, validate_audio_channels},
-    {AUDIO_SELECT_FIELD, validate_audio_select},
-    {DECKLINK_VIDEO_MODE_FIELD, validate_decklink_video_mode},
-#if defined(MACHINE_LEARNING)
-    {DEEP_LEARNING_FIELD, dont_validate},
-    {DEEP_LEARNING_OVERLAY_FIELD, dont_validate},
-#endif
-#if defined(AMAZON_KINESIS)
-    {AMAZON_KINESIS_FIELD, dont_validate},
-#endif
-    {NV_H264_ENC_PRESET, validate_nvh264_preset},
-    {NV_H265_ENC_PRESET, validate_nvh265_preset},
-    {MFX_H264_ENC_PRESET, validate_mfxh264_preset},
-    {MFX_H264_GOP_SIZE, validate_mfxh264_gopsize},
-    {X264_ENC_SPEED_PRESET, validate_x264_speed_preset},
-    {X264_ENC_THREADS, validate_x264_threads},
-    {X264_ENC_TUNE, validate_x264_tune},
-    {X264_ENC_KEY_INT_MAX, validate_x264_key_int_max},
-    {X264_ENC_VBV_BUF_CAPACITY, validate_x264_vbv_buf_capacity},
-    {X264_ENC_RC_LOOKAHED, validate_x264_rc_lookahead},
-    {X264_ENC_QP_MAX, validate_x264_qp_max},
-    {X264_ENC_PASS, validate_x264_pass},
-    {X264_ENC_ME, validate_x264_me},
-    {X264_ENC_PROFILE, dummy_validator_string},
-    {X264_ENC_STREAM_FORMAT, dummy_validator_string},
-    {X264_ENC_OPTION_STRING, dont_validate},
-    {X264_ENC_INTERLACED, dont_validate},
-    {X264_ENC_DCT8X8, dont_validate},
-    {X264_ENC_B_ADAPT, dont_validate},
-    {X264_ENC_BYTE_STREAM, dont_validate},
-    {X264_ENC_CABAC, dont_validate},
-    {X264_ENC_SLICED_THREADS, dont_validate},
-    {X264_ENC_QUANTIZER, dont_validate},
-    {VAAPI_H264_ENC_KEYFRAME_PERIOD, validate_vaapih264_keyframe_period},
-    {VAAPI_H264_ENC_TUNE, validate_vaapih264_tune},
-    {VAAPI_H264_ENC_MAX_BFRAMES, validate_vaapih264_max_bframes},
-    {VAAPI_H264_ENC_NUM_SLICES, validate_vaapih264_num_slices},
-    {VAAPI_H264_ENC_INIT_QP, validate_vaapih264_init_qp},
-    {VAAPI_H264_ENC_MIN_QP, validate_vaapih264_min_qp},
-    {VAAPI_H264_ENC_RATE_CONTROL, validate_vaapih264_rate_control},
-    {VAAPI_H264_ENC_CABAC, dont_validate},
-    {VAAPI_H264_ENC_DCT8X8, dont_validate},
-    {VAAPI_H264_ENC_CPB_LENGTH, validate_vaapih264_cpb_length},
-    {OPEN_H264_ENC_MUTLITHREAD, dont_validate},
-    {OPEN_H264_ENC_COMPLEXITY, dummy_validator_integer},
-    {OPEN_H264_ENC_RATE_CONTROL, dummy_validator_integer},
-    {OPEN_H264_ENC_GOP_SIZE, dummy_validator_integer},
-    {EAVC_ENC_PRESET, dummy_validator_integer},
-    {EAVC_ENC_PROFILE, dummy_validator_integer},
-    {EAVC_ENC_PERFORMANCE, dummy_validator_integer},
-    {EAVC_ENC_BITRATE_MODE, dummy_validator_integer},
-    {EAVC_ENC_BITRATE_PASS, dummy_validator_integer},
-    {EAVC_ENC_BITRATE_MAX, dummy_validator_integer},
-    {EAVC_ENC_VBV_SIZE, dummy_validator_integer},
-    {EAVC_ENC_PICTURE_MODE, dummy_validator_integer},
-    {EAVC_ENC_ENTROPY_MODE, dummy_validator_integer},
-    {EAVC_ENC_GOP_MAX_BCOUNT, dummy_validator_integer},
-    {EAVC_ENC_GOP_MAX_LENGTH, dummy_validator_integer},
-    {EAVC_ENC_GOP_MIN_LENGTH, dummy_validator_integer},
-    {EAVC_ENC_LEVEL, dummy_validator_integer},
-    {EAVC_ENC_DEBLOCK_MODE, dummy_validator_integer},
-    {EAVC_ENC_DEBLOCK_ALPHA, dummy_validator_integer},
-    {EAVC_ENC_DEBLOCK_BETA, dummy_validator_integer},
-    {EAVC_ENC_INITIAL_DELAY, dummy_validator_integer},
-    {EAVC_ENC_FIELD_ORDER, dummy_validator_integer},
-    {EAVC_ENC_GOP_ADAPTIVE, dont_validate}
-  };
-  for (const option_t& cur : ALLOWED_OPTIONS) {
-    if (cur.first == key) {
-      *opt = cur;
-      return true;
+  validate_callback_t Find(const std::string& key) const {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return nullptr;
     }
+    return it->second;
   }
 
-  return false;
+ private:
+  std::unordered_map<std::string, validate_callback_t> index_;
+};
+
+validate_callback_t FindOption(const std::string& key) {
+  static const OptionsIndex index;
+  return index.Find(key);
 }
 
 }  // namespace
@@ -558,13 +849,13 @@ common::ErrnoError ValidateConfig(const StreamConfig& config) {
   }
 
   for (auto it = config->begin(); it != config->end(); ++it) {
-    option_t option;
-    std::string key = it->first.as_string();
-    if (!FindOption(key, &option)) {
+    const std::string key = it->first.as_string();
+    validate_callback_t validate = FindOption(key);
+    if (!validate) {
       WARNING_LOG() << "Unknown option: " << key;
     } else {
       common::Value* value = it->second;
-      Validity valid = option.second(value);
+      Validity valid = validate(value);
       if (valid == Validity::INVALID) {
         WARNING_LOG() << "Invalid value '" << value << "' of option '" << key << "'";
       } else if (valid == Validity::FATAL) {
@@ -0,0 +1,113 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/output_trash.h"
+
+#include <dirent.h>
+#include <string.h>
+
+#include <vector>
+
+#include <common/file_system/file_system.h>
+#include <common/file_system/string_path_utils.h>
+
+#include "base/utils.h"
+
+namespace fastocloud {
+namespace server {
+
+OutputTrash::OutputTrash(const std::string& path)
+    : path_(path), mutex_(), cond_(), pending_(false), stop_(false), thread_() {}
+
+OutputTrash::~OutputTrash() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+    cond_.notify_all();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool OutputTrash::Init() {
+  if (thread_.joinable()) {
+    return true;
+  }
+
+  if (CreateAndCheckDir(path_)) {
+    return false;
+  }
+
+  thread_ = std::thread(&OutputTrash::WorkLoop, this);
+  return true;
+}
+
+std::string OutputTrash::GetPath() const {
+  return path_;
+}
+
+void OutputTrash::Collect() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_ = true;
+  cond_.notify_one();
+}
+
+void OutputTrash::WorkLoop() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!stop_ && !pending_) {
+        cond_.wait(lock);
+      }
+      if (stop_) {
+        return;
+      }
+      pending_ = false;
+    }
+    RemoveAll();
+  }
+}
+
+bool OutputTrash::IsStopped() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stop_;
+}
+
+void OutputTrash::RemoveAll() {
+  DIR* dirp = opendir(path_.c_str());
+  if (!dirp) {
+    return;
+  }
+
+  std::vector<std::string> trashed;
+  struct dirent* dent;
+  while ((dent = readdir(dirp)) != nullptr) {
+    if (!strcmp(dent->d_name, ".") || !strcmp(dent->d_name, "..")) {
+      continue;
+    }
+    trashed.push_back(common::file_system::make_path(path_, dent->d_name));
+  }
+  closedir(dirp);
+
+  for (const std::string& path : trashed) {
+    if (IsStopped()) {
+      return;
+    }
+    RemoveOutputDir(path);
+  }
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,55 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace server {
+
+// old http outputs of restarted vods renamed here by streams, removed by own thread
+// new pipeline writes into fresh folder at once, daemon loop never waits for large folders
+class OutputTrash {
+ public:
+  explicit OutputTrash(const std::string& path);
+  ~OutputTrash();  // folder being removed finished, rest left for next service
+
+  bool Init();  // creates trash folder, starts thread
+  std::string GetPath() const;
+
+  void Collect();  // non blocking, everything in trash removed by thread
+
+ private:
+  void WorkLoop();
+  bool IsStopped();
+  void RemoveAll();
+
+  const std::string path_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool pending_;
+  bool stop_;
+  std::thread thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(OutputTrash);
+};
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,399 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/packet_ingest.h"
+
+#if defined(OS_LINUX)
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <common/convert2string.h>
+#include <common/logger.h>
+#include <common/net/types.h>
+
+#include "base/inputs_outputs.h"
+
+namespace fastocloud {
+namespace server {
+
+namespace {
+#if defined(OS_LINUX)
+// udp to multicast groups received from network, everything else stays in kernel
+struct sock_filter kMulticastUdpFilter[] = {
+    {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_PKTTYPE)},
+    {BPF_JMP | BPF_JEQ | BPF_K, 5, 0, PACKET_OUTGOING},
+    {BPF_LD | BPF_B | BPF_ABS, 0, 0, 9},  // ip protocol
+    {BPF_JMP | BPF_JEQ | BPF_K, 0, 3, IPPROTO_UDP},
+    {BPF_LD | BPF_W | BPF_ABS, 0, 0, 16},  // ip destination
+    {BPF_ALU | BPF_AND | BPF_K, 0, 0, 0xF0000000},
+    {BPF_JMP | BPF_JEQ | BPF_K, 1, 0, 0xE0000000},
+    {BPF_RET | BPF_K, 0, 0, 0},
+    {BPF_RET | BPF_K, 0, 0, 0xFFFF}};
+
+int JoinGroup(const struct in_addr& group, int ifindex) {
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    return -1;
+  }
+
+  struct ip_mreqn mreq;
+  memset(&mreq, 0, sizeof(mreq));
+  mreq.imr_multiaddr = group;
+  mreq.imr_address.s_addr = htonl(INADDR_ANY);
+  mreq.imr_ifindex = ifindex;
+  if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == -1) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+#endif
+
+uint16_t ReadUint16(const uint8_t* data) {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+}  // namespace
+
+bool ParseUdpDatagram(const uint8_t* packet,
+                      size_t size,
+                      uint32_t* group,
+                      uint16_t* port,
+                      const uint8_t** payload,
+                      size_t* payload_size) {
+  if (!packet || size < 20 || (packet[0] >> 4) != 4) {
+    return false;
+  }
+
+  const size_t header_size = (packet[0] & 0x0F) * 4;
+  if (header_size < 20 || size < header_size + 8 || packet[9] != 17) {
+    return false;
+  }
+
+  if (ReadUint16(packet + 6) & 0x3FFF) {  // fragments not reassembled, ts datagrams fit mtu
+    return false;
+  }
+
+  const size_t total_size = ReadUint16(packet + 2);
+  const uint8_t* udp = packet + header_size;
+  const size_t udp_size = ReadUint16(udp + 4);
+  if (total_size > size || udp_size < 8 || header_size + udp_size > total_size) {
+    return false;
+  }
+
+  *group = (static_cast<uint32_t>(packet[16]) << 24) | (packet[17] << 16) | (packet[18] << 8) | packet[19];
+  *port = ReadUint16(udp + 2);
+  *payload = udp + 8;
+  *payload_size = udp_size - 8;
+  return true;
+}
+
+PacketIngest::PacketIngest(const std::string& iface)
+    : iface_(iface),
+      fd_(-1),
+      ring_(nullptr),
+      stop_(false),
+      thread_(),
+      dispatched_(0),
+      dropped_(0),
+      channels_mutex_(),
+      channels_(),
+      assigned_() {}
+
+PacketIngest::~PacketIngest() {
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  for (auto& channel : channels_) {
+    RemoveChannel(&channel.second);
+  }
+  channels_.clear();
+  assigned_.clear();
+#if defined(OS_LINUX)
+  if (ring_) {
+    munmap(ring_, ring_block_size * ring_blocks);
+  }
+  if (fd_ != -1) {
+    close(fd_);
+  }
+#endif
+}
+
+common::ErrnoError PacketIngest::Start() {
+#if defined(OS_LINUX)
+  const int ifindex = if_nametoindex(iface_.c_str());
+  if (ifindex == 0) {
+    return common::make_errno_error("Unknown packet ingest interface: " + iface_, ENODEV);
+  }
+
+  int fd = socket(AF_PACKET, SOCK_DGRAM | SOCK_CLOEXEC, htons(ETH_P_IP));
+  if (fd == -1) {
+    return common::make_errno_error(errno);  // CAP_NET_RAW required
+  }
+
+  struct sock_fprog filter;
+  filter.len = sizeof(kMulticastUdpFilter) / sizeof(kMulticastUdpFilter[0]);
+  filter.filter = kMulticastUdpFilter;
+  int version = TPACKET_V3;
+  struct tpacket_req3 req;
+  memset(&req, 0, sizeof(req));
+  req.tp_block_size = ring_block_size;
+  req.tp_block_nr = ring_blocks;
+  req.tp_frame_size = ring_frame_size;
+  req.tp_frame_nr = (ring_block_size / ring_frame_size) * ring_blocks;
+  req.tp_retire_blk_tov = ring_block_timeout_msec;
+  if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) == -1 ||
+      setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == -1 ||
+      setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == -1) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    close(fd);
+    return err;
+  }
+
+  void* ring = mmap(nullptr, ring_block_size * ring_blocks, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ring == MAP_FAILED) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    close(fd);
+    return err;
+  }
+
+  struct sockaddr_ll addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sll_family = AF_PACKET;
+  addr.sll_protocol = htons(ETH_P_IP);
+  addr.sll_ifindex = ifindex;
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    munmap(ring, ring_block_size * ring_blocks);
+    close(fd);
+    return err;
+  }
+
+  fd_ = fd;
+  ring_ = static_cast<uint8_t*>(ring);
+  thread_ = std::thread(&PacketIngest::ReceiveLoop, this);
+  return common::ErrnoError();
+#else
+  return common::make_errno_error("Packet ingest not supported", ENOTSUP);
+#endif
+}
+
+bool PacketIngest::Acquire(fastotv::stream_id_t sid, const StreamConfig& config_args) {
+  input_t input;
+  if (!read_input(config_args, &input)) {
+    return false;
+  }
+
+  socket_tunings_t sockets;
+  ignore_result(read_input_sockets(config_args, &sockets));
+  Release(sid);
+  std::vector<channel_key_t> keys;
+  for (const InputUri& iuri : input) {
+    const common::uri::Url url = iuri.GetInput();
+    if (url.GetScheme() != common::uri::Url::udp) {
+      continue;
+    }
+
+    const auto socket = sockets.find(iuri.GetID());
+    if (socket != sockets.end() && !socket->second.multicast_iface.empty() &&
+        socket->second.multicast_iface != iface_) {
+      continue;  // group joined by stream on other interface
+    }
+
+    common::net::HostAndPort host;
+    struct in_addr group;
+    if (!common::ConvertFromString(url.GetHost(), &host) || inet_pton(AF_INET, host.GetHost().c_str(), &group) != 1 ||
+        !IN_MULTICAST(ntohl(group.s_addr))) {
+      continue;
+    }
+
+    const channel_key_t key(ntohl(group.s_addr), host.GetPort());
+    if (AddChannel(key, host.GetHost(), host.GetPort())) {
+      std::unique_lock<std::mutex> lock(channels_mutex_);
+      channels_[key].streams.insert(sid);
+      keys.push_back(key);
+    }
+  }
+
+  if (keys.empty()) {
+    return false;
+  }
+  assigned_[sid] = keys;
+  return true;
+}
+
+void PacketIngest::Release(fastotv::stream_id_t sid) {
+  const auto it = assigned_.find(sid);
+  if (it == assigned_.end()) {
+    return;
+  }
+
+  for (const channel_key_t& key : it->second) {
+    Channel channel;
+    {
+      std::unique_lock<std::mutex> lock(channels_mutex_);
+      auto cit = channels_.find(key);
+      if (cit == channels_.end()) {
+        continue;
+      }
+      cit->second.streams.erase(sid);
+      if (!cit->second.streams.empty()) {
+        continue;
+      }
+      channel = cit->second;
+      channels_.erase(cit);
+    }
+    RemoveChannel(&channel);
+  }
+  assigned_.erase(it);
+}
+
+size_t PacketIngest::GetChannelsCount() const {
+  std::unique_lock<std::mutex> lock(channels_mutex_);
+  return channels_.size();
+}
+
+uint64_t PacketIngest::GetDispatched() const {
+  return dispatched_;
+}
+
+uint64_t PacketIngest::GetDropped() const {
+  return dropped_;
+}
+
+bool PacketIngest::AddChannel(const channel_key_t& key, const std::string& host, uint16_t port) {
+  {
+    std::unique_lock<std::mutex> lock(channels_mutex_);
+    if (channels_.find(key) != channels_.end()) {
+      return true;
+    }
+  }
+
+#if defined(OS_LINUX)
+  Channel channel;
+  channel.name = MakePacketRingShmName(host, port);
+  channel.ring = nullptr;
+  common::ErrnoError err = CreatePacketRingShm(channel.name, &channel.ring);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    return false;
+  }
+
+  struct in_addr group;
+  group.s_addr = htonl(key.first);
+  channel.join_fd = JoinGroup(group, if_nametoindex(iface_.c_str()));
+  if (channel.join_fd == -1) {
+    WARNING_LOG() << "Packet ingest can't join group: " << host << ":" << port;
+    channel.join_fd = -1;
+    RemoveChannel(&channel);
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(channels_mutex_);
+  channels_[key] = channel;
+  return true;
+#else
+  UNUSED(key);
+  UNUSED(host);
+  UNUSED(port);
+  return false;
+#endif
+}
+
+void PacketIngest::RemoveChannel(Channel* channel) {
+#if defined(OS_LINUX)
+  if (channel->join_fd != -1) {
+    close(channel->join_fd);  // membership dropped with socket
+  }
+#endif
+  if (channel->ring) {
+    ignore_result(ClosePacketRingShm(channel->ring));
+    ignore_result(UnlinkPacketRingShm(channel->name));  // mapping of reading streams stays valid
+  }
+  channel->join_fd = -1;
+  channel->ring = nullptr;
+}
+
+void PacketIngest::ReceiveLoop() {
+#if defined(OS_LINUX)
+  size_t block = 0;
+  while (!stop_) {
+    struct tpacket_block_desc* desc = reinterpret_cast<struct tpacket_block_desc*>(ring_ + block * ring_block_size);
+    if (!(__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+      struct pollfd pfd;
+      pfd.fd = fd_;
+      pfd.events = POLLIN | POLLERR;
+      pfd.revents = 0;
+      poll(&pfd, 1, poll_timeout_msec);  // timeout to check stop
+      continue;
+    }
+
+    DispatchBlock(ring_ + block * ring_block_size);
+    __atomic_store_n(&desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    block = (block + 1) % ring_blocks;
+  }
+#endif
+}
+
+void PacketIngest::DispatchBlock(const uint8_t* block) {
+#if defined(OS_LINUX)
+  const struct tpacket_block_desc* desc = reinterpret_cast<const struct tpacket_block_desc*>(block);
+  const uint32_t count = desc->hdr.bh1.num_pkts;
+  const uint8_t* frame = block + desc->hdr.bh1.offset_to_first_pkt;
+  uint64_t dispatched = 0;
+  uint64_t dropped = 0;
+  std::unique_lock<std::mutex> lock(channels_mutex_);  // once per block, not per datagram
+  for (uint32_t i = 0; i < count; ++i) {
+    const struct tpacket3_hdr* hdr = reinterpret_cast<const struct tpacket3_hdr*>(frame);
+    uint32_t group;
+    uint16_t port;
+    const uint8_t* payload;
+    size_t payload_size;
+    if (ParseUdpDatagram(frame + hdr->tp_net, hdr->tp_snaplen, &group, &port, &payload, &payload_size)) {
+      auto it = channels_.find(channel_key_t(group, port));
+      if (it != channels_.end()) {
+        WritePacketRing(it->second.ring, payload, payload_size);
+        dispatched++;
+      } else {
+        dropped++;
+      }
+    }
+    frame += hdr->tp_next_offset;
+  }
+  lock.unlock();
+
+  dispatched_ += dispatched;
+  dropped_ += dropped;
+#else
+  UNUSED(block);
+#endif
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,103 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <common/error.h>
+#include <common/macros.h>
+
+#include <fastotv/types.h>
+
+#include "base/packet_ring_shm.h"
+#include "base/stream_config.h"
+
+namespace fastocloud {
+namespace server {
+
+// udp multicast inputs of node received once from kernel packet ring of interface, datagrams dispatched by group
+// and port to shared memory rings read by streams instead of own sockets, linux only
+class PacketIngest {
+ public:
+  enum {
+    ring_block_size = 1 << 20,  // kernel retires block to us when full or after timeout
+    ring_blocks = 128,
+    ring_frame_size = 2048,
+    ring_block_timeout_msec = 4,
+    poll_timeout_msec = 100
+  };
+
+  explicit PacketIngest(const std::string& iface);
+  ~PacketIngest();  // thread stopped, groups left, rings unlinked
+
+  common::ErrnoError Start() WARN_UNUSED_RESULT;  // packet socket bound to interface, receiving thread started
+
+  // rings of multicast udp inputs of stream created and groups joined on first stream,
+  // false if stream has none on interface of ingest
+  bool Acquire(fastotv::stream_id_t sid, const StreamConfig& config_args);
+  void Release(fastotv::stream_id_t sid);  // groups of last stream left
+
+  size_t GetChannelsCount() const;
+  uint64_t GetDispatched() const;  // datagrams written to rings
+  uint64_t GetDropped() const;     // udp multicast of interface without stream
+
+ private:
+  typedef std::pair<uint32_t, uint16_t> channel_key_t;  // group and port in host order
+  struct Channel {
+    std::string name;
+    PacketRingShm* ring;
+    int join_fd;  // holds group membership
+    std::set<fastotv::stream_id_t> streams;
+  };
+
+  bool AddChannel(const channel_key_t& key, const std::string& host, uint16_t port);
+  void RemoveChannel(Channel* channel);
+  void ReceiveLoop();
+  void DispatchBlock(const uint8_t* block);
+
+  const std::string iface_;
+  int fd_;
+  uint8_t* ring_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+  std::atomic<uint64_t> dispatched_;
+  std::atomic<uint64_t> dropped_;
+
+  mutable std::mutex channels_mutex_;  // loop thread adds and removes, receiving thread writes
+  std::map<channel_key_t, Channel> channels_;
+  std::map<fastotv::stream_id_t, std::vector<channel_key_t>> assigned_;
+
+  DISALLOW_COPY_AND_ASSIGN(PacketIngest);
+};
+
+// ipv4 udp datagram of not fragmented packet, group and port in host order
+bool ParseUdpDatagram(const uint8_t* packet,
+                      size_t size,
+                      uint32_t* group,
+                      uint16_t* port,
+                      const uint8_t** payload,
+                      size_t* payload_size);
+
+}  // namespace server
+}  // namespace fastocloud
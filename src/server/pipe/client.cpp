@@ -22,7 +22,8 @@ Client::Client(common::libev::IoLoop* server, descriptor_t read_fd, descriptor_t
     : base_class(server),
       pipe_read_client_(new common::libev::PipeReadClient(nullptr, read_fd)),
       pipe_write_client_(new common::libev::PipeWriteClient(nullptr, write_fd)),
-      read_fd_(read_fd) {}
+      read_fd_(read_fd),
+      write_fd_(write_fd) {}
 
 common::ErrnoError Client::SingleWrite(const void* data, size_t size, size_t* nwrite_out) {
   return pipe_write_client_->SingleWrite(data, size, nwrite_out);
@@ -36,6 +37,14 @@ descriptor_t Client::GetFd() const {
   return read_fd_;
 }
 
+descriptor_t Client::GetReadFd() const {
+  return read_fd_;
+}
+
+descriptor_t Client::GetWriteFd() const {
+  return write_fd_;
+}
+
 common::ErrnoError Client::DoClose() {
   ignore_result(pipe_write_client_->Close());
   ignore_result(pipe_read_client_->Close());
@@ -31,6 +31,9 @@ class Client : public fastotv::protocol::protocol_client_t {
 
   Client(common::libev::IoLoop* server, descriptor_t read_fd, descriptor_t write_fd);
 
+  descriptor_t GetReadFd() const;
+  descriptor_t GetWriteFd() const;
+
  protected:
   common::ErrnoError SingleWrite(const void* data, size_t size, size_t* nwrite_out) override;
   common::ErrnoError SingleRead(void* out, size_t max_size, size_t* nread) override;
@@ -43,6 +46,7 @@ class Client : public fastotv::protocol::protocol_client_t {
   common::libev::PipeReadClient* pipe_read_client_;
   common::libev::PipeWriteClient* pipe_write_client_;
   const descriptor_t read_fd_;
+  const descriptor_t write_fd_;
 
   DISALLOW_COPY_AND_ASSIGN(Client);
 };
@@ -14,43 +14,85 @@
 
 #include "server/process_slave_wrapper.h"
 
+#include <algorithm>
 #include <string>
 #include <thread>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <common/convert2string.h>
 #include <common/daemon/commands/activate_info.h>
 #include <common/daemon/commands/stop_info.h>
+#include <common/file_system/file_system.h>
 #include <common/file_system/string_path_utils.h>
 #include <common/license/expire_license.h>
 #include <common/net/net.h>
 
 #include "base/config_fields.h"
 #include "base/constants.h"
+#include "base/input_uri.h"
 #include "base/inputs_outputs.h"
+#include "base/priority_class.h"
+#include "base/stream_config_parse.h"
 #include "base/utils.h"
 
+#include "gpu_stats/encoder_pool.h"
 #include "gpu_stats/perf_monitor.h"
 
+#include "server/admission_control.h"
 #include "server/child_stream.h"
+#include "server/cods_warm_pool.h"
+#include "server/config_workers.h"
+#include "server/cpu_affinity_pool.h"
 #include "server/daemon/client.h"
 #include "server/daemon/commands.h"
 #include "server/daemon/commands_info/service/get_log_info.h"
 #include "server/daemon/commands_info/service/prepare_info.h"
 #include "server/daemon/commands_info/service/server_info.h"
+#include "server/daemon/commands_info/service/stats_history_info.h"
+#include "server/daemon/commands_info/service/streams_status_info.h"
 #include "server/daemon/commands_info/service/sync_info.h"
+#include "server/startup_stats.h"
+#include "server/daemon/commands_info/stream/batch_info.h"
 #include "server/daemon/commands_info/stream/get_log_info.h"
 #include "server/daemon/commands_info/stream/restart_info.h"
 #include "server/daemon/commands_info/stream/start_info.h"
 #include "server/daemon/commands_info/stream/stop_info.h"
+#include "server/daemon/commands_info/stream/stream_info.h"
+#include "server/daemon/commands_info/stream/profile_info.h"
+#include "server/daemon/commands_info/stream/update_config_info.h"
+#include "server/base/http_worker_loop.h"
 #include "server/daemon/server.h"
+#include "server/file_expirer.h"
+#include "server/file_uploader.h"
+#include "server/hls_retention.h"
 #include "server/http/handler.h"
 #include "server/http/server.h"
+#include "server/metrics_registry.h"
 #include "server/options/options.h"
+#include "server/output_trash.h"
+#include "server/segment_cache.h"
+#include "server/statistic_batch.h"
+#include "server/stats_history.h"
+#include "server/stream_cgroups.h"
+#include "server/streams_status.h"
 #include "server/vods/handler.h"
 #include "server/vods/server.h"
+#if defined(OS_POSIX)
+#include "server/zygote.h"
+#endif
+#if defined(MACHINE_LEARNING) && defined(OS_POSIX)
+#include "server/inference_pool.h"
+#endif
+#if defined(OS_LINUX)
+#include "server/packet_ingest.h"
+#endif
+#if defined(OS_WIN)
+#include "server/stream_worker_pool_win.h"
+#endif
 
+#include "stream_commands/binary_protocol.h"
 #include "stream_commands/commands.h"
 
 #include "utils/m3u8_reader.h"
@@ -59,6 +101,10 @@
 #undef SetPort
 #endif
 
+// queue keys of broadcasts replaced by newer ones, statistic of stream keyed by stream id
+#define SERVICE_STATISTIC_KEY "@service"
+#define STREAMS_STATISTIC_KEY "@streams"
+
 namespace {
 
 common::Optional<common::file_system::ascii_file_string_path> MakeStreamLogPath(const std::string& feedback_dir) {
@@ -71,6 +117,11 @@ common::Optional<common::file_system::ascii_file_string_path> MakeStreamPipeline
   return dir.MakeFileStringPath(DUMP_FILE_NAME);
 }
 
+common::Optional<common::file_system::ascii_file_string_path> MakeStreamProfilePath(const std::string& feedback_dir) {
+  common::file_system::ascii_directory_string_path dir(feedback_dir);
+  return dir.MakeFileStringPath(PROFILE_FILE_NAME);
+}
+
 }  // namespace
 
 namespace fastocloud {
@@ -79,15 +130,50 @@ namespace {
 typedef VodsHandler CodsHandler;
 typedef VodsServer CodsServer;
 
+std::vector<common::libev::IoLoop*> MakeWorkers(int count,
+                                                common::libev::IoLoopObserver* handler,
+                                                const std::string& name) {
+  std::vector<common::libev::IoLoop*> workers;
+  if (count < 2) {
+    return workers;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    common::libev::IoLoop* worker = new base::HttpWorkerLoop(handler);
+    worker->SetName(name + "_" + common::ConvertToString(i));
+    workers.push_back(worker);
+  }
+  return workers;
+}
+
+bool IsServerLoop(const common::libev::IoLoop* loop,
+                  const common::libev::IoLoop* server,
+                  const std::vector<common::libev::IoLoop*>& workers) {
+  return loop == server || std::find(workers.begin(), workers.end(), loop) != workers.end();
+}
+
+// least loaded decode engine below limit, hardware decoders of the stream don't starve running ones
+bool HaveGpuDecodeCapacity(const gpu_stats::devices_stats_t& devices, int max_load) {
+  for (const gpu_stats::DeviceStats& device : devices) {
+    if (!max_load || device.decoder_load < max_load) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool CheckIsFullVod(const common::file_system::ascii_file_string_path& file) {
+  if (!utils::M3u8Reader::IsEndList(file)) {  // still generating
+    return false;
+  }
+
   utils::M3u8Reader reader;
-  if (!reader.Parse(file)) {
+  if (!reader.Parse(file) || !reader.IsEnded()) {
     return false;
   }
 
   common::file_system::ascii_directory_string_path dir(file.GetDirectory());
-  const auto chunks = reader.GetChunks();
-  for (const utils::ChunkInfo& chunk : chunks) {
+  for (const utils::ChunkInfo& chunk : reader) {
     const auto chunk_path = dir.MakeFileStringPath(chunk.path);
     if (!chunk_path) {
       return false;
@@ -100,14 +186,48 @@ bool CheckIsFullVod(const common::file_system::ascii_file_string_path& file) {
 
   return true;
 }
+
+AdmissionControl::Cost EstimateStreamCost(const AdmissionControl* admission,
+                                          const serialized_stream_t& config_args,
+                                          const StreamInfo& sha,
+                                          const std::string& active_codec) {
+  common::draw::Size size;
+  common::Value* size_field = config_args->Find(SIZE_FIELD);
+  std::string size_str;
+  if (size_field && size_field->GetAsBasicString(&size_str)) {
+    ignore_result(common::ConvertFromString(size_str, &size));
+  }
+
+  int video_bitrate = 0;
+  common::Value* video_bitrate_field = config_args->Find(VIDEO_BIT_RATE_FIELD);
+  if (video_bitrate_field) {
+    ignore_result(video_bitrate_field->GetAsInteger(&video_bitrate));
+  }
+
+  return admission->Estimate(sha.id, sha.type, active_codec, size, video_bitrate, sha.output.size());
+}
 }  // namespace
 
 struct ProcessSlaveWrapper::NodeStats {
-  NodeStats() : prev(), prev_nshot(), gpu_load(0), timestamp(common::time::current_utc_mstime()) {}
-
+  NodeStats()
+      : reader(),
+        prev(),
+        prev_nshot(),
+        prev_dshot(),
+        gpu_load(0),
+        gpu_devices(),
+        cpu_load(0),
+        bytes_send(0),
+        timestamp(common::time::current_utc_mstime()) {}
+
+  service::MachineShotsReader reader;
   service::CpuShot prev;
   service::NetShot prev_nshot;
+  service::DiskIoShot prev_dshot;
   int gpu_load;
+  gpu_stats::DevicesHolder gpu_devices;
+  double cpu_load;      // percents, last sent statistic
+  uint64_t bytes_send;  // per second, last sent statistic
   fastotv::timestamp_t timestamp;
 };
 
@@ -115,36 +235,163 @@ ProcessSlaveWrapper::ProcessSlaveWrapper(const Config& config)
     : config_(config),
       process_argc_(0),
       process_argv_(nullptr),
+      zygote_(nullptr),
+      relay_hosts_(),
+      radio_hosts_(),
+      load_hosts_(),
       loop_(nullptr),
       http_server_(nullptr),
       http_handler_(nullptr),
       vods_server_(nullptr),
       vods_handler_(nullptr),
+      vods_workers_(),
       cods_server_(nullptr),
       cods_handler_(nullptr),
+      cods_workers_(),
       ping_client_timer_(INVALID_TIMER_ID),
+      daemon_clients_(),
       check_cods_vods_timer_(INVALID_TIMER_ID),
       check_old_files_timer_(INVALID_TIMER_ID),
       node_stats_timer_(INVALID_TIMER_ID),
       quit_cleanup_timer_(INVALID_TIMER_ID),
+      stats_batch_timer_(INVALID_TIMER_ID),
+      flush_clients_timer_(INVALID_TIMER_ID),
       node_stats_(new NodeStats),
+      stats_batch_(config.stats_batch ? new StatisticBatch(config.stats_batch_delta) : nullptr),
+      metrics_(config.http_metrics ? new MetricsRegistry : nullptr),
+      cgroups_(config.cgroup_root.empty() ? nullptr
+                                          : new StreamCgroups(config.cgroup_root, config.cgroup_cpu_limit,
+                                                              config.cgroup_memory_limit)),
+      segment_cache_(config.segment_cache_size
+                         ? new SegmentCache(static_cast<size_t>(config.segment_cache_size) * 1024 * 1024)
+                         : nullptr),
+      file_expirer_(new FileExpirer("*" CHUNK_EXT)),
+      output_trash_(nullptr),
+      encoder_pool_(new gpu_stats::EncoderPool(config.nvenc_max_sessions, config.gpu_max_load)),
+      cpu_pool_(nullptr),
+      streaming_cpu_(0),
+      admission_(config.admission_cpu_limit || config.admission_bandwidth_limit
+                     ? new AdmissionControl(std::thread::hardware_concurrency(), config.admission_cpu_limit,
+                                            static_cast<uint64_t>(config.admission_bandwidth_limit) * 1000 * 1000 / 8)
+                     : nullptr),
+      job_queue_(config.offline_cpu_jobs || config.offline_gpu_jobs || config.offline_pause_load
+                     ? new JobQueue(std::thread::hardware_concurrency(), config.offline_cpu_jobs,
+                                    config.offline_gpu_jobs, config.offline_pause_load)
+                     : nullptr),
+      job_configs_(),
+      hls_retention_(config.hls_retention_window > 0
+                         ? new HlsRetention(config.hls_retention_max_files, config.hls_retention_window * 1000)
+                         : nullptr),
+      startup_stats_(new StartupStats),
+      streams_status_(new StreamsStatus),
+      stats_history_(config.stats_history ? new StatsHistory(config.stats_history * 60, node_stats_send_seconds)
+                                          : nullptr),
+      cods_warm_(config.cods_warm_pool ? new CodsWarmPool(config.cods_warm_pool, config.cods_ttl * 1000) : nullptr),
+      inference_pool_(nullptr),
+      packet_ingest_(nullptr),
+      worker_pool_(nullptr),
+      config_workers_(nullptr),
+      uploader_(new FileUploader(config.upload_compression)),
+      start_slots_dir_(),
+      assets_dir_(),
+      ingest_dir_(),
       vods_links_(),
       cods_links_(),
+      stream_lines_(),
+      children_(),
       folders_for_monitor_() {
+  if (!file_expirer_->Init()) {
+    WARNING_LOG() << "File notifications not available, old files cleaned by periodic scans";
+    destroy(&file_expirer_);
+  }
+  if (cgroups_ && !cgroups_->Init()) {
+    WARNING_LOG() << "Cgroup " << config.cgroup_root << " not available, streams will not be placed in cgroups";
+    destroy(&cgroups_);
+  }
+
   loop_ = new DaemonServer(config.host, this);
   loop_->SetName("client_server");
 
-  http_handler_ = new HttpHandler(this);
+  HttpHandler* http_handler = new HttpHandler(this);
+  http_handler->SetMetrics(metrics_);
+  http_handler->SetStatsHistory(stats_history_);
+  http_handler_ = http_handler;
   http_server_ = new HttpServer(config.http_host, http_handler_);
   http_server_->SetName("http_server");
 
-  vods_handler_ = new VodsHandler(this);
+  VodsHandler* vods_handler = new VodsHandler(this);
+  vods_handler->SetSegmentCache(segment_cache_);
+  vods_handler->SetVirtualHls(config.vods_virtual_hls);
+  vods_handler_ = vods_handler;
   vods_server_ = new VodsServer(config.vods_host, vods_handler_);
   vods_server_->SetName("vods_server");
+  vods_workers_ = MakeWorkers(config.vods_cods_workers, vods_handler_, "vods_worker");
+  vods_handler->SetWorkers(vods_workers_);
 
-  cods_handler_ = new CodsHandler(this);
+  CodsHandler* cods_handler = new CodsHandler(this);
+  cods_handler->SetSegmentCache(segment_cache_);
+  cods_handler_ = cods_handler;
   cods_server_ = new CodsServer(config.cods_host, cods_handler_);
   cods_server_->SetName("cods_server");
+  cods_workers_ = MakeWorkers(config.vods_cods_workers, cods_handler_, "cods_worker");
+  cods_handler->SetWorkers(cods_workers_);
+
+  if (config.encode_cores_per_stream) {
+    const CpuAffinityPool::cores_t cores = CpuAffinityPool::DetectCores();
+    if (!cores.empty()) {
+      cpu_pool_ = new CpuAffinityPool(cores, config.encode_cores_per_stream);
+    } else {
+      WARNING_LOG() << "Cpu topology not detected, encoding streams will not be pinned";
+    }
+  }
+
+  if (config.max_parallel_starts) {
+    const std::string slots_dir =
+        common::file_system::make_path(common::file_system::get_dir_path(PIDFILE_PATH), "start_slots");
+    if (common::file_system::is_directory_exist(slots_dir) || common::file_system::create_directory(slots_dir, true)) {
+      start_slots_dir_ = slots_dir;
+    } else {
+      WARNING_LOG() << "Can't create start slots directory: " << slots_dir << ", parallel starts not limited";
+    }
+  }
+
+  const std::string assets_dir =
+      common::file_system::make_path(common::file_system::get_dir_path(PIDFILE_PATH), "assets");
+  if (common::file_system::is_directory_exist(assets_dir) || common::file_system::create_directory(assets_dir, true)) {
+    assets_dir_ = assets_dir;
+  } else {
+    WARNING_LOG() << "Can't create assets directory: " << assets_dir << ", logos rendered by every stream";
+  }
+
+  if (config.shared_ingest) {
+    const std::string ingest_dir =
+        common::file_system::make_path(common::file_system::get_dir_path(PIDFILE_PATH), "ingest");
+    if (common::file_system::is_directory_exist(ingest_dir) ||
+        common::file_system::create_directory(ingest_dir, true)) {
+      ingest_dir_ = ingest_dir;
+    } else {
+      WARNING_LOG() << "Can't create ingest directory: " << ingest_dir << ", inputs not shared";
+    }
+  }
+
+#if defined(OS_LINUX)
+  if (!config.packet_ingest_iface.empty()) {
+    packet_ingest_ = new PacketIngest(config.packet_ingest_iface);
+    common::ErrnoError err = packet_ingest_->Start();
+    if (err) {
+      WARNING_LOG() << "Packet ingest on " << config.packet_ingest_iface
+                    << " not started, multicast received by streams: " << err->GetDescription();
+      destroy(&packet_ingest_);
+    }
+  }
+#endif
+
+#if defined(OS_POSIX)
+  if (config.adopt_streams) {
+    adopt_registry_ =
+        common::file_system::make_path(common::file_system::get_dir_path(PIDFILE_PATH), "adopted_streams");
+  }
+#endif
 }
 
 int ProcessSlaveWrapper::SendStopDaemonRequest(const Config& config) {
@@ -170,23 +417,104 @@ int ProcessSlaveWrapper::SendStopDaemonRequest(const Config& config) {
 }
 
 ProcessSlaveWrapper::~ProcessSlaveWrapper() {
+  for (size_t i = 0; i < cods_workers_.size(); ++i) {
+    destroy(&cods_workers_[i]);
+  }
   destroy(&cods_server_);
   destroy(&cods_handler_);
+  for (size_t i = 0; i < vods_workers_.size(); ++i) {
+    destroy(&vods_workers_[i]);
+  }
   destroy(&vods_server_);
   destroy(&vods_handler_);
   destroy(&http_server_);
   destroy(&http_handler_);
   destroy(&loop_);
   destroy(&node_stats_);
+  destroy(&stats_batch_);
+  destroy(&metrics_);
+  destroy(&cgroups_);
+  destroy(&segment_cache_);
+  destroy(&file_expirer_);
+  destroy(&output_trash_);
+  destroy(&encoder_pool_);
+  destroy(&cpu_pool_);
+  destroy(&admission_);
+  destroy(&job_queue_);
+  destroy(&hls_retention_);
+  destroy(&startup_stats_);
+  destroy(&streams_status_);
+  destroy(&stats_history_);
+  destroy(&cods_warm_);
+  destroy(&config_workers_);
+  destroy(&uploader_);
+#if defined(MACHINE_LEARNING) && defined(OS_POSIX)
+  destroy(&inference_pool_);
+#endif
+#if defined(OS_LINUX)
+  destroy(&packet_ingest_);
+#endif
+#if defined(OS_WIN)
+  destroy(&worker_pool_);
+#endif
+#if defined(OS_POSIX)
+  destroy(&zygote_);
+  for (Zygote* host : relay_hosts_) {
+    delete host;
+  }
+  relay_hosts_.clear();
+  for (Zygote* host : radio_hosts_) {
+    delete host;
+  }
+  radio_hosts_.clear();
+  for (Zygote* host : load_hosts_) {
+    delete host;
+  }
+  load_hosts_.clear();
+#endif
 }
 
 int ProcessSlaveWrapper::Exec(int argc, char** argv) {
   process_argc_ = argc;
   process_argv_ = argv;
 
+#if defined(OS_POSIX) && !defined(TEST)
+  // should be forked before any thread started
+  const std::string registry_path =
+      common::file_system::make_path(common::file_system::get_dir_path(PIDFILE_PATH), "gst_registry.bin");
+  common::ErrnoError rerr = PrebuildStreamRegistry(registry_path);
+  if (rerr) {
+    DEBUG_MSG_ERROR(rerr, common::logging::LOG_LEVEL_WARNING);
+  } else {
+    INFO_LOG() << "Stream registry cache: " << registry_path;
+  }
+
+  if (config_.zygote) {
+    zygote_ = new Zygote;
+    common::ErrnoError zerr = zygote_->Start(argc, argv);
+    if (zerr) {
+      DEBUG_MSG_ERROR(zerr, common::logging::LOG_LEVEL_WARNING);
+      destroy(&zygote_);
+    }
+  }
+#endif
+#if defined(OS_WIN)
+  if (config_.prestarted_streams) {
+    worker_pool_ = new StreamWorkerPool(config_.prestarted_streams);
+    worker_pool_->Fill();
+  }
+#endif
+#if defined(MACHINE_LEARNING) && defined(OS_POSIX)
+  inference_pool_ = new InferencePool(argc, argv);
+#endif
+  if (config_.config_workers) {
+    config_workers_ = new ConfigWorkers(config_.config_workers);
+  }
+
   // gpu statistic monitor
   std::thread perf_thread;
-  gpu_stats::IPerfMonitor* perf_monitor = gpu_stats::CreatePerfMonitor(&node_stats_->gpu_load);
+  gpu_stats::IPerfMonitor* perf_monitor =
+      gpu_stats::CreatePerfMonitor(&node_stats_->gpu_load, &node_stats_->gpu_devices);
   if (perf_monitor) {
     perf_thread = std::thread([perf_monitor] { perf_monitor->Exec(); });
   }
@@ -245,6 +573,20 @@ int ProcessSlaveWrapper::Exec(int argc, char** argv) {
     UNUSED(res);
   });
 
+  std::vector<std::thread> worker_threads;
+  for (common::libev::IoLoop* worker : vods_workers_) {
+    worker_threads.push_back(std::thread([worker] {
+      int res = worker->Exec();
+      UNUSED(res);
+    }));
+  }
+  for (common::libev::IoLoop* worker : cods_workers_) {
+    worker_threads.push_back(std::thread([worker] {
+      int res = worker->Exec();
+      UNUSED(res);
+    }));
+  }
+
   int res = EXIT_FAILURE;
   DaemonServer* server = static_cast<DaemonServer*>(loop_);
   common::ErrnoError err = server->Bind(true);
@@ -259,8 +601,9 @@ int ProcessSlaveWrapper::Exec(int argc, char** argv) {
     goto finished;
   }
 
-  node_stats_->prev = service::GetMachineCpuShot();
-  node_stats_->prev_nshot = service::GetMachineNetShot();
+  node_stats_->prev = node_stats_->reader.GetCpuShot();
+  node_stats_->prev_nshot = node_stats_->reader.GetNetShot();
+  node_stats_->prev_dshot = node_stats_->reader.GetDiskIoShot();
   node_stats_->timestamp = common::time::current_utc_mstime();
 
   res = server->Exec();
@@ -268,7 +611,11 @@ int ProcessSlaveWrapper::Exec(int argc, char** argv) {
 finished:
   vods_thread.join();
   cods_thread.join();
+  for (size_t i = 0; i < worker_threads.size(); ++i) {
+    worker_threads[i].join();
+  }
   http_thread.join();
+  destroy(&config_workers_);  // before loop, tasks post results to it
   if (perf_monitor) {
     perf_monitor->Stop();
   }
@@ -276,6 +623,20 @@ finished:
     perf_thread.join();
   }
   delete perf_monitor;
+#if defined(OS_POSIX)
+  if (zygote_) {
+    zygote_->Stop();
+  }
+  for (Zygote* host : relay_hosts_) {
+    host->Stop();
+  }
+  for (Zygote* host : radio_hosts_) {
+    host->Stop();
+  }
+  for (Zygote* host : load_hosts_) {
+    host->Stop();
+  }
+#endif
   return res;
 }
 
@@ -284,6 +645,13 @@ void ProcessSlaveWrapper::PreLooped(common::libev::IoLoop* server) {
   check_cods_vods_timer_ = server->CreateTimer(config_.cods_ttl / 2, true);
   check_old_files_timer_ = server->CreateTimer(config_.files_ttl / 10, true);
   node_stats_timer_ = server->CreateTimer(node_stats_send_seconds, true);
+  if (stats_batch_) {
+    stats_batch_timer_ = server->CreateTimer(config_.stats_batch, true);
+  }
+  flush_clients_timer_ = server->CreateTimer(flush_clients_seconds, true);
+#if defined(OS_POSIX)
+  AdoptChildStreams();
+#endif
 }
 
 void ProcessSlaveWrapper::Accepted(common::libev::IoClient* client) {
@@ -292,53 +660,90 @@ void ProcessSlaveWrapper::Accepted(common::libev::IoClient* client) {
 
 void ProcessSlaveWrapper::Moved(common::libev::IoLoop* server, common::libev::IoClient* client) {
   UNUSED(server);
-  UNUSED(client);
+  RemoveDaemonClient(client);
 }
 
 void ProcessSlaveWrapper::Closed(common::libev::IoClient* client) {
-  UNUSED(client);
+  RemoveDaemonClient(client);
+}
+
+void ProcessSlaveWrapper::RemoveDaemonClient(common::libev::IoClient* client) {
+  // only address compared, client may be half destroyed
+  auto it = std::find(daemon_clients_.begin(), daemon_clients_.end(), client);
+  if (it != daemon_clients_.end()) {
+    daemon_clients_.erase(it);
+  }
 }
 
 void ProcessSlaveWrapper::TimerEmited(common::libev::IoLoop* server, common::libev::timer_id_t id) {
   if (ping_client_timer_ == id) {
-    std::vector<common::libev::IoClient*> online_clients = server->GetClients();
-    for (size_t i = 0; i < online_clients.size(); ++i) {
-      common::libev::IoClient* client = online_clients[i];
-      ProtocoledDaemonClient* dclient = dynamic_cast<ProtocoledDaemonClient*>(client);
-      if (dclient && dclient->IsVerified()) {
-        common::ErrnoError err = dclient->Ping();
-        if (err) {
-          DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-          ignore_result(dclient->Close());
-          delete dclient;
-        } else {
-          INFO_LOG() << "Sent ping to client[" << client->GetFormatedName() << "], from server["
-                     << server->GetFormatedName() << "], " << online_clients.size() << " client(s) connected.";
-        }
+    const std::vector<ProtocoledDaemonClient*> online_clients = daemon_clients_;  // closed clients leave list
+    for (ProtocoledDaemonClient* dclient : online_clients) {
+      common::ErrnoError err = dclient->Ping();
+      if (err) {
+        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+        ignore_result(dclient->Close());
+        delete dclient;
+      } else {
+        INFO_LOG() << "Sent ping to client[" << dclient->GetFormatedName() << "], from server["
+                   << server->GetFormatedName() << "], " << online_clients.size() << " client(s) connected.";
       }
     }
   } else if (check_cods_vods_timer_ == id) {
     fastotv::timestamp_t current_time = common::time::current_utc_mstime();
-    const auto copy_cods = cods_links_.Copy();
-    for (auto it = copy_cods.begin(); it != copy_cods.end(); ++it) {
+    const LinksHolderTS::snapshot_t cods = cods_links_.GetSnapshot();
+    for (auto it = cods->begin(); it != cods->end(); ++it) {
       serialized_stream_t conf = it->second;
       fastotv::stream_id_t sid = GetSid(conf);
       Child* cod = FindChildByID(sid);
-      if (cod) {
+      if (cod && cods_warm_ && cods_warm_->IsParked(sid)) {
+        if (!cods_warm_->IsWarm(sid, current_time)) {  // more popular cods expired meanwhile
+          INFO_LOG() << "Cod left warm pool: " << sid;
+          cod->Stop();
+        }
+      } else if (cod) {
         fastotv::timestamp_t cod_last_update = cod->GetLastUpdate();
         fastotv::timestamp_t ts_diff = current_time - cod_last_update;
         if (ts_diff > config_.cods_ttl * 1000) {
-          cod->Stop();
+          // source stays connected, next playlist request skips fork and connect
+          if (cods_warm_ && cod->IsPlaying() && cods_warm_->IsWarm(sid, current_time) && !cod->MuteOutputs()) {
+            cods_warm_->Park(sid);
+            INFO_LOG() << "Cod parked in warm pool: " << sid << ", parked: " << cods_warm_->GetParkedCount();
+          } else {
+            cod->Stop();
+          }
         }
       }
     }
   } else if (check_old_files_timer_ == id) {
-    for (auto it = folders_for_monitor_.begin(); it != folders_for_monitor_.end(); ++it) {
-      const common::file_system::ascii_directory_string_path folder = *it;
-      const time_t max_life_time = common::time::current_utc_mstime() / 1000 - config_.files_ttl;
-      RemoveOldFilesByTime(folder, max_life_time, "*" CHUNK_EXT, true);
+    const time_t max_life_time = common::time::current_utc_mstime() / 1000 - config_.files_ttl;
+    if (output_trash_) {
+      output_trash_->Collect();
+    }
+    if (file_expirer_) {
+      file_expirer_->ProcessEvents();
+      const size_t removed = file_expirer_->RemoveExpired(max_life_time);
+      if (removed) {
+        DEBUG_LOG() << "Removed old files: " << removed << ", tracked: " << file_expirer_->GetTrackedCount();
+      }
+    } else {
+      for (auto it = folders_for_monitor_.begin(); it != folders_for_monitor_.end(); ++it) {
+        const common::file_system::ascii_directory_string_path folder = *it;
+        RemoveOldFilesByTime(folder, max_life_time, "*" CHUNK_EXT, true);
+      }
     }
   } else if (node_stats_timer_ == id) {
+#if defined(MACHINE_LEARNING) && defined(OS_POSIX)
+    if (inference_pool_) {
+      inference_pool_->CheckWorkers();
+    }
+#endif
+    if (job_queue_) {
+      ScheduleJobs();
+    }
+    if (hls_retention_) {
+      UpdateHlsRetention();
+    }
     const std::string node_stats = MakeServiceStats(0);
     fastotv::protocol::request_t req;
     common::Error err_ser = StatisitcServiceBroadcast(node_stats, &req);
@@ -346,17 +751,45 @@ void ProcessSlaveWrapper::TimerEmited(common::libev::IoLoop* server, common::lib
       return;
     }
 
-    BroadcastClients(req);
+    BroadcastClients(req, SERVICE_STATISTIC_KEY);
+  } else if (flush_clients_timer_ == id) {
+    FlushClients();
+  } else if (stats_batch_timer_ == id) {
+    if (stats_batch_->IsEmpty()) {
+      return;
+    }
+
+    std::string batch_json;
+    common::Error err = stats_batch_->Flush(&batch_json);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+      return;
+    }
+
+    fastotv::protocol::request_t req;
+    common::Error err_ser = StatisticStreamsBroadcast(batch_json, &req);
+    if (err_ser) {
+      return;
+    }
+
+    BroadcastClients(req, STREAMS_STATISTIC_KEY);
   } else if (quit_cleanup_timer_ == id) {
     vods_server_->Stop();
+    for (common::libev::IoLoop* worker : vods_workers_) {
+      worker->Stop();
+    }
     cods_server_->Stop();
+    for (common::libev::IoLoop* worker : cods_workers_) {
+      worker->Stop();
+    }
     http_server_->Stop();
     loop_->Stop();
   }
 }
 
 void ProcessSlaveWrapper::Accepted(common::libev::IoChild* child) {
-  UNUSED(child);
+  Child* channel = static_cast<Child*>(child);
+  children_[channel->GetStreamID()] = channel;
 }
 
 void ProcessSlaveWrapper::Moved(common::libev::IoLoop* server, common::libev::IoChild* child) {
@@ -366,13 +799,81 @@ void ProcessSlaveWrapper::Moved(common::libev::IoLoop* server, common::libev::Io
 
 void ProcessSlaveWrapper::ChildStatusChanged(common::libev::IoChild* child, int status, int signal) {
   ChildStream* channel = static_cast<ChildStream*>(child);
+#if defined(OS_POSIX)
+  if (channel->IsHosted()) {
+    // relay or radio host died, every stream of it reported here
+    for (Zygote* host : relay_hosts_) {
+      if (host->GetProcessID() == channel->GetProcessID()) {
+        host->SetExited();
+      }
+    }
+    for (Zygote* host : radio_hosts_) {
+      if (host->GetProcessID() == channel->GetProcessID()) {
+        host->SetExited();
+      }
+    }
+    for (Zygote* host : load_hosts_) {
+      if (host->GetProcessID() == channel->GetProcessID()) {
+        host->SetExited();
+      }
+    }
+  }
+#endif
+  FinishChildStream(channel, status, signal);
+}
+
+void ProcessSlaveWrapper::FinishChildStream(ChildStream* channel, int status, int signal) {
   channel->CleanUp();
   const auto sid = channel->GetStreamID();
 
   INFO_LOG() << "Successful finished children id: " << sid << "\nStream id: " << sid
              << ", exit with status: " << (status ? "FAILURE" : "SUCCESS") << ", signal: " << signal;
 
-  loop_->UnRegisterChild(child);
+  loop_->UnRegisterChild(channel);
+  auto it = children_.find(sid);
+  if (it != children_.end() && it->second == channel) {
+    children_.erase(it);
+  }
+  if (stats_batch_) {
+    stats_batch_->Remove(sid);
+  }
+  if (metrics_) {
+    metrics_->RemoveStream(sid);
+  }
+  if (cgroups_ && !cgroups_->Remove(sid)) {
+    WARNING_LOG() << "Cgroup not removed: " << cgroups_->GetPath(sid);
+  }
+  encoder_pool_->Release(sid);
+  if (cpu_pool_) {
+    cpu_pool_->Release(sid);
+  }
+  if (admission_) {
+    admission_->Release(sid);
+  }
+  if (job_queue_) {
+    ignore_result(job_queue_->Remove(sid));
+  }
+  if (hls_retention_) {
+    hls_retention_->Untrack(sid);
+  }
+  startup_stats_->Release(sid);
+  streams_status_->Remove(sid);
+  if (stats_history_) {
+    stats_history_->RemoveStream(sid);
+  }
+  if (cods_warm_) {
+    cods_warm_->Release(sid);
+  }
+#if defined(MACHINE_LEARNING) && defined(OS_POSIX)
+  if (inference_pool_) {
+    inference_pool_->Release(sid);
+  }
+#endif
+#if defined(OS_LINUX)
+  if (packet_ingest_) {
+    packet_ingest_->Release(sid);
+  }
+#endif
 
   delete channel;
 
@@ -383,32 +884,39 @@ void ProcessSlaveWrapper::ChildStatusChanged(common::libev::IoChild* child, int
     return;
   }
 
-  BroadcastClients(req);
+  BroadcastClients(req, std::string());
 }
 
 Child* ProcessSlaveWrapper::FindChildByID(fastotv::stream_id_t cid) const {
   CHECK(loop_->IsLoopThread());
-  DaemonServer* server = static_cast<DaemonServer*>(loop_);
-  auto childs = server->GetChilds();
-  for (auto* child : childs) {
-    Child* channel = static_cast<Child*>(child);
-    if (channel->GetStreamID() == cid) {
-      return channel;
-    }
+  auto it = children_.find(cid);
+  if (it == children_.end()) {
+    return nullptr;
   }
 
-  return nullptr;
+  return it->second;
 }
 
-void ProcessSlaveWrapper::BroadcastClients(const fastotv::protocol::request_t& req) {
-  std::vector<common::libev::IoClient*> clients = loop_->GetClients();
-  for (size_t i = 0; i < clients.size(); ++i) {
-    ProtocoledDaemonClient* dclient = dynamic_cast<ProtocoledDaemonClient*>(clients[i]);
-    if (dclient && dclient->IsVerified()) {
-      common::ErrnoError err = dclient->WriteRequest(req);
-      if (err) {
-        WARNING_LOG() << "BroadcastClients error: " << err->GetDescription();
-      }
+void ProcessSlaveWrapper::BroadcastClients(const fastotv::protocol::request_t& req, const std::string& key) {
+  const std::vector<ProtocoledDaemonClient*> clients = daemon_clients_;  // closed clients leave list
+  for (ProtocoledDaemonClient* dclient : clients) {
+    common::ErrnoError err = dclient->QueueRequest(req, key);
+    if (err) {
+      WARNING_LOG() << "BroadcastClients error: " << err->GetDescription();
+      ignore_result(dclient->Close());
+      delete dclient;
+    }
+  }
+}
+
+void ProcessSlaveWrapper::FlushClients() {
+  const std::vector<ProtocoledDaemonClient*> clients = daemon_clients_;
+  for (ProtocoledDaemonClient* dclient : clients) {
+    common::ErrnoError err = dclient->FlushQueue();
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+      ignore_result(dclient->Close());
+      delete dclient;
     }
   }
 }
@@ -454,29 +962,22 @@ common::ErrnoError ProcessSlaveWrapper::DaemonDataReceived(ProtocoledDaemonClien
 
 common::ErrnoError ProcessSlaveWrapper::StreamDataReceived(stream_client_t* pipe_client) {
   CHECK(loop_->IsLoopThread());
-  std::string input_command;
-  common::ErrnoError err = pipe_client->ReadCommand(&input_command);
-  if (err) {
-    return err;  // i don't want to handle spam, command must be formated according protocol
-  }
-
   fastotv::protocol::request_t* req = nullptr;
   fastotv::protocol::response_t* resp = nullptr;
-  common::Error err_parse = common::protocols::json_rpc::ParseJsonRPC(input_command, &req, &resp);
-  if (err_parse) {
-    const std::string err_str = err_parse->GetDescription();
-    return common::make_errno_error(err_str, EAGAIN);
+  common::ErrnoError err = ReadPipeCommand(pipe_client, config_.pipe_binary, &req, &resp);
+  if (err) {
+    return err;  // i don't want to handle spam, command must be formated according protocol
   }
 
   if (req) {
-    INFO_LOG() << "Received stream responce: " << input_command;
+    DEBUG_LOG() << "Received stream request: " << req->method;
     err = HandleRequestStreamsCommand(pipe_client, req);
     if (err) {
       DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
     }
     delete req;
   } else if (resp) {
-    INFO_LOG() << "Received stream responce: " << input_command;
+    INFO_LOG() << "Received stream responce";
     err = HandleResponceStreamsCommand(pipe_client, resp);
     if (err) {
       DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
@@ -507,6 +1008,10 @@ void ProcessSlaveWrapper::DataReceived(common::libev::IoClient* client) {
         ChildStream* channel = static_cast<ChildStream*>(child);
         if (pipe_client == channel->GetClient()) {
           channel->SetClient(nullptr);
+          if (channel->IsHosted() || channel->IsAdopted()) {
+            // thread of relay host finished or process spawned by previous service, exit code not known
+            FinishChildStream(channel, EXIT_SUCCESS, 0);
+          }
           break;
         }
       }
@@ -520,7 +1025,14 @@ void ProcessSlaveWrapper::DataReceived(common::libev::IoClient* client) {
 }
 
 void ProcessSlaveWrapper::DataReadyToWrite(common::libev::IoClient* client) {
-  UNUSED(client);
+  if (ProtocoledDaemonClient* dclient = dynamic_cast<ProtocoledDaemonClient*>(client)) {
+    common::ErrnoError err = dclient->FlushQueue();
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+      ignore_result(dclient->Close());
+      delete dclient;
+    }
+  }
 }
 
 void ProcessSlaveWrapper::PostLooped(common::libev::IoLoop* server) {
@@ -543,12 +1055,22 @@ void ProcessSlaveWrapper::PostLooped(common::libev::IoLoop* server) {
     server->RemoveTimer(node_stats_timer_);
     node_stats_timer_ = INVALID_TIMER_ID;
   }
+
+  if (stats_batch_timer_ != INVALID_TIMER_ID) {
+    server->RemoveTimer(stats_batch_timer_);
+    stats_batch_timer_ = INVALID_TIMER_ID;
+  }
+
+  if (flush_clients_timer_ != INVALID_TIMER_ID) {
+    server->RemoveTimer(flush_clients_timer_);
+    flush_clients_timer_ = INVALID_TIMER_ID;
+  }
 }
 
 void ProcessSlaveWrapper::OnHttpRequest(common::libev::http::HttpClient* client,
                                         const file_path_t& file,
                                         common::http::http_status* recommend_status) {
-  if (client->GetServer() == vods_server_) {
+  if (IsServerLoop(client->GetServer(), vods_server_, vods_workers_)) {
     std::string ext = file.GetExtension();
     bool is_m3u8 = common::EqualsASCII(ext, M3U8_EXTENSION, false);
     if (is_m3u8) {
@@ -575,7 +1097,7 @@ void ProcessSlaveWrapper::OnHttpRequest(common::libev::http::HttpClient* client,
       }
       return;
     }
-  } else if (client->GetServer() == cods_server_) {
+  } else if (IsServerLoop(client->GetServer(), cods_server_, cods_workers_)) {
     std::string ext = file.GetExtension();
     bool is_m3u8 = common::EqualsASCII(ext, M3U8_EXTENSION, false);
     bool is_ts = common::EqualsASCII(ext, TS_EXTENSION, false);
@@ -596,6 +1118,13 @@ void ProcessSlaveWrapper::OnHttpRequest(common::libev::http::HttpClient* client,
 
         fastotv::stream_id_t sid = GetSid(config);
         Child* cod = FindChildByID(sid);
+        if (is_m3u8 && cods_warm_) {
+          cods_warm_->Hit(sid, common::time::current_utc_mstime());
+          if (cod && cods_warm_->Unpark(sid)) {
+            INFO_LOG() << "Cod promoted from warm pool: " << sid;
+            ignore_result(cod->UnmuteOutputs());
+          }
+        }
         if (cod) {
           cod->UpdateTimestamp();
         }
@@ -607,6 +1136,11 @@ void ProcessSlaveWrapper::OnHttpRequest(common::libev::http::HttpClient* client,
       }
       return;
     }
+  } else if (hls_retention_ && client->GetServer() == http_server_) {
+    if (common::EqualsASCII(file.GetExtension(), TS_EXTENSION, false)) {
+      const common::file_system::ascii_directory_string_path http_root(file.GetDirectory());
+      hls_retention_->Record(http_root.GetPath(), file.GetFileName());
+    }
   }
 
   if (recommend_status) {
@@ -645,10 +1179,21 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStopService(Protocole
       return dclient->StopFail(req->id, common::make_error("Stop service in progress..."));
     }
 
+#if defined(OS_POSIX)
+    if (!adopt_registry_.empty()) {
+      ParkChildStreams();  // not parked ones stopped
+      quit_cleanup_timer_ = loop_->CreateTimer(cleanup_seconds, false);
+      return dclient->StopSuccess(req->id);
+    }
+#endif
     DaemonServer* server = static_cast<DaemonServer*>(loop_);
     auto childs = server->GetChilds();
     for (auto* child : childs) {
       ChildStream* channel = static_cast<ChildStream*>(child);
+      if (job_queue_ && job_queue_->IsPaused(channel->GetStreamID())) {
+        ignore_result(SignalJob(channel->GetStreamID(), false));
+        ignore_result(job_queue_->Remove(channel->GetStreamID()));
+      }
       ignore_result(channel->Stop());
     }
 
@@ -683,148 +1228,939 @@ common::ErrnoError ProcessSlaveWrapper::HandleResponcePingService(ProtocoledDaem
 }
 
 common::ErrnoError ProcessSlaveWrapper::CreateChildStream(const serialized_stream_t& config_args) {
+  StreamInfo sha;
+  common::ErrnoError err = PrepareChildStream(config_args, &sha);
+  if (err) {
+    return err;
+  }
+
+  // vods and cods configs reused by every on demand start
+  config_args->Insert(ACTIVE_REQUEST_TS_FIELD, common::Value::CreateDoubleValue(common::time::current_utc_mstime()));
+  return SpawnChildStream(config_args, sha);
+}
+
+common::ErrnoError ProcessSlaveWrapper::PrepareChildStream(const serialized_stream_t& config_args, StreamInfo* sha) {
   CHECK(loop_->IsLoopThread());
+  common::ErrnoError err = ValidateStreamConfig(config_args, true, sha);
+  if (err) {
+    return err;
+  }
+
+  Child* stream = FindChildByID(sha->id);
+  if (stream || (job_queue_ && job_queue_->IsQueued(sha->id))) {
+    return MakeStreamExistError(sha->id);
+  }
+
+  return common::ErrnoError();
+}
+
+common::ErrnoError ProcessSlaveWrapper::ValidateStreamConfig(const serialized_stream_t& config_args,
+                                                             bool check_folders,
+                                                             StreamInfo* sha) {
   common::ErrnoError err = options::ValidateConfig(config_args);
   if (err) {
     return err;
   }
 
-  StreamInfo sha;
   std::string feedback_dir;
   common::logging::LOG_LEVEL logs_level;
-  err = MakeStreamInfo(config_args, true, &sha, &feedback_dir, &logs_level);
-  if (err) {
-    return err;
+  return MakeStreamInfo(config_args, check_folders, sha, &feedback_dir, &logs_level);
+}
+
+common::ErrnoError ProcessSlaveWrapper::ParseStartInfo(const std::string& params,
+                                                       serialized_stream_t* config_args,
+                                                       StreamInfo* sha) {
+  json_object* jstart_info = ParseJson(params);
+  if (!jstart_info) {
+    return common::make_errno_error_inval();
   }
 
-  Child* stream = FindChildByID(sha.id);
-  if (stream) {
-    NOTICE_LOG() << "Skip request to start stream id: " << sha.id;
-    return common::make_errno_error(common::MemSPrintf("Stream with id: %s exist, skip request.", sha.id), EEXIST);
+  stream::StartInfo start_info;
+  common::Error err_des = start_info.DeSerialize(jstart_info);
+  json_object_put(jstart_info);
+  if (err_des) {
+    const std::string err_str = err_des->GetDescription();
+    return common::make_errno_error(err_str, EAGAIN);
   }
 
-  config_args->Insert(STREAM_LINK_PATH, common::Value::CreateStringValueFromBasicString(config_.streamlink_path));
-  return CreateChildStreamImpl(config_args, sha);
+  *config_args = start_info.GetConfig();
+  return ValidateStreamConfig(*config_args, true, sha);
 }
 
-common::ErrnoError ProcessSlaveWrapper::StopChildStream(const serialized_stream_t& config_args) {
-  fastotv::stream_id_t sid = GetSid(config_args);
-  return StopChildStreamImpl(sid);
+common::ErrnoError ProcessSlaveWrapper::MakeStreamExistError(fastotv::stream_id_t sid) {
+  NOTICE_LOG() << "Skip request to start stream id: " << sid;
+  return common::make_errno_error(common::MemSPrintf("Stream with id: %s exist, skip request.", sid), EEXIST);
 }
 
-common::ErrnoError ProcessSlaveWrapper::StopChildStreamImpl(fastotv::stream_id_t sid) {
-  CHECK(loop_->IsLoopThread());
-  Child* stream = FindChildByID(sid);
-  if (!stream) {
-    return common::make_errno_error(common::MemSPrintf("Stream with id: %s not exist, skip request.", sid), EINVAL);
+void ProcessSlaveWrapper::PostConfigTask(const std::function<void()>& task) {
+  if (config_workers_) {
+    config_workers_->Post(task);
+    return;
   }
 
-  return stream->Stop();
+  task();
 }
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestChangedSourcesStream(stream_client_t* pclient,
-                                                                          const fastotv::protocol::request_t* req) {
-  UNUSED(pclient);
-  CHECK(loop_->IsLoopThread());
-  if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jrequest_changed_sources = json_tokener_parse(params_ptr);
-    if (!jrequest_changed_sources) {
-      return common::make_errno_error_inval();
-    }
-
-    ChangedSouresInfo ch_sources_info;
-    common::Error err_des = ch_sources_info.DeSerialize(jrequest_changed_sources);
-    json_object_put(jrequest_changed_sources);
-    if (err_des) {
-      const std::string err_str = err_des->GetDescription();
-      return common::make_errno_error(err_str, EAGAIN);
-    }
+void ProcessSlaveWrapper::UploadFile(const common::file_system::ascii_file_string_path& file,
+                                     const common::uri::Url& url) {
+  // request answered at once, result only logged
+  uploader_->Upload(file, url,
+                    [](const common::file_system::ascii_file_string_path& sent, const common::uri::Url& to,
+                       common::Error err) {
+                      if (err) {
+                        WARNING_LOG() << "Upload file: " << sent.GetPath() << " to " << to.GetUrl()
+                                      << " failed: " << err->GetDescription();
+                        return;
+                      }
+                      INFO_LOG() << "Uploaded file: " << sent.GetPath() << " to " << to.GetUrl();
+                    });
+}
 
-    fastotv::protocol::request_t req;
-    common::Error err_ser = ChangedSourcesStreamBroadcast(ch_sources_info, &req);
-    if (err_ser) {
-      const std::string err_str = err_ser->GetDescription();
-      return common::make_errno_error(err_str, EAGAIN);
+bool ProcessSlaveWrapper::IsDaemonClientOnline(ProtocoledDaemonClient* dclient) const {
+  CHECK(loop_->IsLoopThread());
+  std::vector<common::libev::IoClient*> clients = loop_->GetClients();
+  for (size_t i = 0; i < clients.size(); ++i) {
+    if (clients[i] == dclient) {
+      return true;
     }
-
-    BroadcastClients(req);
-    return common::ErrnoError();
+  }
+  return false;
+}
+
+bool ProcessSlaveWrapper::IsHostedStream(const serialized_stream_t& config_args, const StreamInfo& sha) const {
+  if (sha.type == fastotv::RELAY) {
+    return config_.relay_host_streams > 0;
+  }
+  if (IsLoadStream(sha)) {
+    return config_.load_host_streams > 0;
+  }
+  return config_.radio_host_streams && sha.type == fastotv::ENCODE && IsAudioOnlyStream(config_args);
+}
+
+bool ProcessSlaveWrapper::IsLoadStream(const StreamInfo& sha) {
+  return sha.type == fastotv::ENCODE && !sha.input.empty() && IsLoadInputUrl(sha.input[0]);
+}
+
+common::ErrnoError ProcessSlaveWrapper::SpawnChildStream(const serialized_stream_t& config_args,
+                                                         const StreamInfo& sha) {
+  CHECK(loop_->IsLoopThread());
+  JobQueue::Job job;
+  if (job_queue_ && job_configs_.find(sha.id) == job_configs_.end() && MakeOfflineJob(config_args, sha, &job)) {
+    // started by ScheduleJobs once capacity is free, config spawned as is then
+    job_queue_->Push(job);
+    job_configs_[sha.id] = std::make_pair(config_args, sha);
+    INFO_LOG() << "Queued job stream id: " << sha.id << ", priority: " << job.priority
+               << ", queued jobs: " << job_queue_->GetQueuedCount();
+    return common::ErrnoError();
+  }
+
+  config_args->Insert(STREAM_LINK_PATH, common::Value::CreateStringValueFromBasicString(config_.streamlink_path));
+  config_args->Insert(PIPE_BINARY_FIELD, common::Value::CreateBooleanValue(config_.pipe_binary));
+  if (config_.memory_accounting) {
+    config_args->Insert(MEMORY_ACCOUNTING_FIELD, common::Value::CreateBooleanValue(true));
+  }
+  if (config_.heap_release_interval > 0) {
+    config_args->Insert(HEAP_RELEASE_INTERVAL_FIELD, common::Value::CreateIntegerValue(config_.heap_release_interval));
+  }
+  if (config_.quarantine_failures > 0 && !config_args->Find(QUARANTINE_FAILURES_FIELD)) {  // stream own kept
+    config_args->Insert(QUARANTINE_FAILURES_FIELD, common::Value::CreateIntegerValue(config_.quarantine_failures));
+  }
+  if (!start_slots_dir_.empty()) {
+    config_args->Insert(START_SLOTS_FIELD, common::Value::CreateIntegerValue(config_.max_parallel_starts));
+    config_args->Insert(START_SLOTS_DIR_FIELD, common::Value::CreateStringValueFromBasicString(start_slots_dir_));
+  }
+  if (!assets_dir_.empty()) {
+    config_args->Insert(ASSETS_DIR_FIELD, common::Value::CreateStringValueFromBasicString(assets_dir_));
+  }
+  const bool live_input = sha.type == fastotv::RELAY || sha.type == fastotv::ENCODE ||
+                          sha.type == fastotv::TIMESHIFT_RECORDER || sha.type == fastotv::CATCHUP;
+  if (!ingest_dir_.empty() && live_input) {
+    config_args->Insert(INGEST_DIR_FIELD, common::Value::CreateStringValueFromBasicString(ingest_dir_));
+  }
+#if defined(OS_LINUX)
+  if (packet_ingest_ && live_input && packet_ingest_->Acquire(sha.id, config_args)) {
+    config_args->Insert(ACTIVE_PACKET_INGEST_FIELD, common::Value::CreateBooleanValue(true));
+  }
+#endif
+  if (output_trash_ && (sha.type == fastotv::VOD_ENCODE || sha.type == fastotv::VOD_RELAY)) {
+    config_args->Insert(OUTPUT_TRASH_DIR_FIELD,
+                        common::Value::CreateStringValueFromBasicString(output_trash_->GetPath()));
+  }
+  std::string feedback_dir;
+  common::Value* feedback_dir_field = config_args->Find(FEEDBACK_DIR_FIELD);
+  const bool hosted = IsHostedStream(config_args, sha);  // host goes away with service
+  if (!adopt_registry_.empty() && !hosted && feedback_dir_field &&
+      feedback_dir_field->GetAsBasicString(&feedback_dir)) {
+    const std::string adopt_socket = common::file_system::make_path(feedback_dir, ADOPT_SOCKET_FILE_NAME);
+    config_args->Insert(ACTIVE_ADOPT_SOCKET_FIELD, common::Value::CreateStringValueFromBasicString(adopt_socket));
+  }
+
+  std::string video_codec;
+  std::string active_codec;
+  common::Value* video_codec_field = config_args->Find(VIDEO_CODEC_FIELD);
+  if (video_codec_field && video_codec_field->GetAsBasicString(&video_codec)) {
+    int gpu_device = gpu_stats::EncoderPool::invalid_device_index;
+    active_codec = encoder_pool_->Acquire(sha.id, video_codec, node_stats_->gpu_load, node_stats_->gpu_devices.Get(),
+                                          &gpu_device);
+    if (active_codec != video_codec) {
+      WARNING_LOG() << "Encoder " << video_codec << " saturated, stream id: " << sha.id << " encoded by "
+                    << active_codec;
+    }
+    config_args->Insert(ACTIVE_VIDEO_CODEC_FIELD, common::Value::CreateStringValueFromBasicString(active_codec));
+    config_args->Insert(ACTIVE_GPU_DEVICE_FIELD, common::Value::CreateIntegerValue(gpu_device));
+  }
+
+  if (admission_) {
+    // after encoder choice, streams which fell back from saturated gpu cost cpu
+    const AdmissionControl::Cost cost = EstimateStreamCost(admission_, config_args, sha, active_codec);
+    common::ErrnoError err = admission_->Admit(sha.id, cost, node_stats_->cpu_load, node_stats_->bytes_send);
+    if (err) {
+      WARNING_LOG() << err->GetDescription();
+      encoder_pool_->Release(sha.id);
+      return err;
+    }
+  }
+
+  const bool is_encode =
+      sha.type == fastotv::ENCODE || sha.type == fastotv::VOD_ENCODE || sha.type == fastotv::COD_ENCODE;
+  CpuAffinityPool::cpus_t cpus;
+  if (cpu_pool_ && is_encode && cpu_pool_->Acquire(sha.id, &cpus)) {
+    common::ArrayValue* cpus_list = common::Value::CreateArrayValue();
+    for (int cpu : cpus) {
+      cpus_list->Append(common::Value::CreateIntegerValue(cpu));
+    }
+    config_args->Insert(ACTIVE_CPU_SET_FIELD, cpus_list);
+  }
+
+  const gpu_stats::devices_stats_t gpu_devices = node_stats_->gpu_devices.Get();
+  if (is_encode && !gpu_devices.empty()) {  // without monitors plugin ranks kept
+    const bool hw_decode = HaveGpuDecodeCapacity(gpu_devices, config_.gpu_max_load);
+    if (!hw_decode) {
+      WARNING_LOG() << "Gpu decoders saturated, stream id: " << sha.id << " decoded on cpu";
+    }
+    config_args->Insert(ACTIVE_HW_DECODE_FIELD, common::Value::CreateBooleanValue(hw_decode));
+  }
+
+  if (config_.streaming_pool_threads > 0) {
+    config_args->Insert(STREAMING_POOL_THREADS_FIELD,
+                        common::Value::CreateIntegerValue(config_.streaming_pool_threads));
+    if (config_.streaming_pool_pin && cpus.empty()) {
+      // dense relays, streaming of child stays on one core, children spread over cores
+      const size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+      common::ArrayValue* streaming_cpus = common::Value::CreateArrayValue();
+      streaming_cpus->Append(common::Value::CreateIntegerValue(static_cast<int>(streaming_cpu_++ % cores)));
+      config_args->Insert(STREAMING_POOL_CPUS_FIELD, streaming_cpus);
+    }
+  }
+
+#if defined(MACHINE_LEARNING) && defined(OS_POSIX)
+  if (inference_pool_ && (is_encode || sha.type == fastotv::RELAY)) {
+    const std::string inference_shm = inference_pool_->Acquire(sha.id, config_args);
+    if (!inference_shm.empty()) {
+      config_args->Insert(ACTIVE_INFERENCE_SHM_FIELD, common::Value::CreateStringValueFromBasicString(inference_shm));
+    }
+  }
+#endif
+
+  int priority_class;
+  common::Value* priority_class_field = config_args->Find(PRIORITY_CLASS_FIELD);
+  const PriorityClass priority = priority_class_field && priority_class_field->GetAsInteger(&priority_class) &&
+                                         IsValidPriorityClass(priority_class)
+                                     ? static_cast<PriorityClass>(priority_class)
+                                     : GetDefaultPriorityClass(sha.type);
+  config_args->Insert(ACTIVE_PRIORITY_CLASS_FIELD, common::Value::CreateIntegerValue(priority));
+
+  if (cgroups_ && !cgroups_->Create(sha.id, GetPriorityTraits(priority).cgroup_weight)) {
+    WARNING_LOG() << "Cgroup not created: " << cgroups_->GetPath(sha.id);
+  }
+
+  const fastotv::timestamp_t fork_ts = common::time::current_utc_mstime();
+  if (!config_args->Find(ACTIVE_REQUEST_TS_FIELD)) {  // batch starts and restarts, queueing not counted
+    config_args->Insert(ACTIVE_REQUEST_TS_FIELD, common::Value::CreateDoubleValue(fork_ts));
+  }
+  config_args->Insert(ACTIVE_FORK_TS_FIELD, common::Value::CreateDoubleValue(fork_ts));
+  common::ErrnoError err = CreateChildStreamImpl(config_args, sha);
+  if (err) {
+    if (cgroups_) {
+      ignore_result(cgroups_->Remove(sha.id));
+    }
+    encoder_pool_->Release(sha.id);
+    if (cpu_pool_) {
+      cpu_pool_->Release(sha.id);
+    }
+    if (admission_) {
+      admission_->Release(sha.id);
+    }
+#if defined(MACHINE_LEARNING) && defined(OS_POSIX)
+    if (inference_pool_) {
+      inference_pool_->Release(sha.id);
+    }
+#endif
+#if defined(OS_LINUX)
+    if (packet_ingest_) {
+      packet_ingest_->Release(sha.id);
+    }
+#endif
+  } else if (hls_retention_) {
+    TrackHlsOutputs(config_args, sha);
+  }
+  return err;
+}
+
+void ProcessSlaveWrapper::RestoreChildStreamResources(const serialized_stream_t& config_args, const StreamInfo& sha) {
+  // reservations recorded in config by service which spawned stream
+  std::string active_codec;
+  common::Value* active_codec_field = config_args->Find(ACTIVE_VIDEO_CODEC_FIELD);
+  if (active_codec_field && active_codec_field->GetAsBasicString(&active_codec)) {
+    int gpu_device = gpu_stats::EncoderPool::invalid_device_index;
+    common::Value* gpu_device_field = config_args->Find(ACTIVE_GPU_DEVICE_FIELD);
+    if (gpu_device_field) {
+      ignore_result(gpu_device_field->GetAsInteger(&gpu_device));
+    }
+    encoder_pool_->Restore(sha.id, active_codec, gpu_device);
+  }
+
+  if (admission_) {
+    admission_->Restore(sha.id, EstimateStreamCost(admission_, config_args, sha, active_codec));
+  }
+
+  common::ArrayValue* cpus_list = nullptr;
+  common::Value* cpus_field = config_args->Find(ACTIVE_CPU_SET_FIELD);
+  if (cpu_pool_ && cpus_field && cpus_field->GetAsList(&cpus_list)) {
+    CpuAffinityPool::cpus_t cpus;
+    for (size_t i = 0; i < cpus_list->GetSize(); ++i) {
+      common::Value* cpu_field = nullptr;
+      int cpu;
+      if (cpus_list->Get(i, &cpu_field) && cpu_field->GetAsInteger(&cpu)) {
+        cpus.push_back(cpu);
+      }
+    }
+    cpu_pool_->Restore(sha.id, cpus);
+  }
+
+#if defined(OS_LINUX)
+  // rings recreated under same names, input of stream reopens them when rebuilt after no data
+  bool packet_ingest = false;
+  common::Value* packet_ingest_field = config_args->Find(ACTIVE_PACKET_INGEST_FIELD);
+  if (packet_ingest_field && packet_ingest_field->GetAsBoolean(&packet_ingest) && packet_ingest) {
+    if (!packet_ingest_ || !packet_ingest_->Acquire(sha.id, config_args)) {
+      WARNING_LOG() << "Packet ingest not available for adopted stream, id: " << sha.id;
+    }
+  }
+#endif
+}
+
+common::ErrnoError ProcessSlaveWrapper::StopChildStream(const serialized_stream_t& config_args) {
+  fastotv::stream_id_t sid = GetSid(config_args);
+  return StopChildStreamImpl(sid);
+}
+
+common::ErrnoError ProcessSlaveWrapper::StopChildStreamImpl(fastotv::stream_id_t sid) {
+  CHECK(loop_->IsLoopThread());
+  Child* stream = FindChildByID(sid);
+  if (!stream) {
+    if (job_queue_ && job_queue_->IsQueued(sid)) {
+      ignore_result(job_queue_->Remove(sid));
+      job_configs_.erase(sid);
+      INFO_LOG() << "Removed queued job stream id: " << sid;
+      return common::ErrnoError();
+    }
+    return common::make_errno_error(common::MemSPrintf("Stream with id: %s not exist, skip request.", sid), EINVAL);
+  }
+
+  if (job_queue_ && job_queue_->IsPaused(sid)) {  // stopped process doesn't read commands
+    ignore_result(SignalJob(sid, false));
+  }
+  if (job_queue_) {  // not paused again while exiting
+    ignore_result(job_queue_->Remove(sid));
+  }
+  return stream->Stop();
+}
+
+bool ProcessSlaveWrapper::MakeOfflineJob(const serialized_stream_t& config_args,
+                                         const StreamInfo& sha,
+                                         JobQueue::Job* job) const {
+  if (sha.type != fastotv::VOD_ENCODE) {
+    return false;
+  }
+
+  int priority_class;
+  common::Value* priority_class_field = config_args->Find(PRIORITY_CLASS_FIELD);
+  const PriorityClass priority = priority_class_field && priority_class_field->GetAsInteger(&priority_class) &&
+                                         IsValidPriorityClass(priority_class)
+                                     ? static_cast<PriorityClass>(priority_class)
+                                     : GetDefaultPriorityClass(sha.type);
+  if (priority != BATCH_PRIORITY && priority != IDLE_PRIORITY) {  // watched vods started on request
+    return false;
+  }
+
+  std::string video_codec;
+  gpu_stats::EncoderPool::Device device;
+  common::Value* video_codec_field = config_args->Find(VIDEO_CODEC_FIELD);
+  const bool gpu = video_codec_field && video_codec_field->GetAsBasicString(&video_codec) &&
+                   gpu_stats::EncoderPool::GetDevice(video_codec, &device);
+
+  int job_priority = 0;
+  common::Value* job_priority_field = config_args->Find(JOB_PRIORITY_FIELD);
+  if (job_priority_field) {
+    ignore_result(job_priority_field->GetAsInteger(&job_priority));
+  }
+
+  job->sid = sha.id;
+  job->resource = gpu ? JobQueue::GPU_RESOURCE : JobQueue::CPU_RESOURCE;
+  job->priority = job_priority;
+  return true;
+}
+
+void ProcessSlaveWrapper::ScheduleJobs() {
+  std::vector<fastotv::stream_id_t> start, pause, resume;
+  job_queue_->Schedule(node_stats_->cpu_load, &start, &pause, &resume);
+  for (const auto& sid : start) {
+    const auto it = job_configs_.find(sid);
+    if (it == job_configs_.end()) {
+      ignore_result(job_queue_->Remove(sid));
+      continue;
+    }
+
+    const auto config = it->second;
+    INFO_LOG() << "Starting queued job stream id: " << sid;
+    common::ErrnoError err = SpawnChildStream(config.first, config.second);
+    job_configs_.erase(sid);
+    if (err) {
+      WARNING_LOG() << "Queued job stream id: " << sid << " not started: " << err->GetDescription();
+      ignore_result(job_queue_->Remove(sid));
+    }
+  }
+
+  for (const auto& sid : pause) {
+    if (SignalJob(sid, true)) {
+      NOTICE_LOG() << "Paused job stream id: " << sid
+                   << ", live load: " << job_queue_->GetLiveLoad(node_stats_->cpu_load);
+    }
+  }
+  for (const auto& sid : resume) {
+    if (SignalJob(sid, false)) {
+      NOTICE_LOG() << "Resumed job stream id: " << sid
+                   << ", live load: " << job_queue_->GetLiveLoad(node_stats_->cpu_load);
+    }
+  }
+}
+
+void ProcessSlaveWrapper::TrackHlsOutputs(const serialized_stream_t& config_args, const StreamInfo& sha) {
+  const bool is_vod = sha.type == fastotv::VOD_ENCODE || sha.type == fastotv::VOD_RELAY;
+  const bool is_cod = sha.type == fastotv::COD_ENCODE || sha.type == fastotv::COD_RELAY;
+  if (is_vod || is_cod || config_args->Find(HLS_MAX_FILES_FIELD)) {  // retention of stream set by config
+    return;
+  }
+
+  for (const OutputUri& out_uri : sha.output) {
+    const common::uri::Url ouri = out_uri.GetOutput();
+    if (ouri.GetScheme() == common::uri::Url::http) {
+      hls_retention_->Track(sha.id, out_uri.GetHttpRoot().GetPath(), ouri.GetPath().GetFileName());
+    }
+  }
+}
+
+void ProcessSlaveWrapper::UpdateHlsRetention() {
+  const HlsRetention::changes_t changes = hls_retention_->Update(common::time::current_utc_mstime());
+  for (const auto& change : changes) {
+    Child* chan = FindChildByID(change.first);
+    if (!chan) {
+      continue;
+    }
+
+    serialized_stream_t config(new common::HashValue);
+    config->Insert(HLS_MAX_FILES_FIELD, common::Value::CreateIntegerValue(static_cast<int>(change.second)));
+    std::string changes_json;
+    if (!MakeJsonFromConfig(config, &changes_json)) {
+      continue;
+    }
+
+    common::ErrnoError errn = chan->UpdateConfig(changes_json);
+    if (errn) {
+      WARNING_LOG() << "Hls retention of stream id: " << change.first << " not updated: " << errn->GetDescription();
+      continue;
+    }
+    DEBUG_LOG() << "Hls retention of stream id: " << change.first << " sized to: " << change.second << " files";
+  }
+}
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestChangedSourcesStream(stream_client_t* pclient,
+                                                                          const fastotv::protocol::request_t* req) {
+  UNUSED(pclient);
+  CHECK(loop_->IsLoopThread());
+  if (req->params) {
+    const char* params_ptr = req->params->c_str();
+    json_object* jrequest_changed_sources = json_tokener_parse(params_ptr);
+    if (!jrequest_changed_sources) {
+      return common::make_errno_error_inval();
+    }
+
+    ChangedSouresInfo ch_sources_info;
+    common::Error err_des = ch_sources_info.DeSerialize(jrequest_changed_sources);
+    json_object_put(jrequest_changed_sources);
+    if (err_des) {
+      const std::string err_str = err_des->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    fastotv::protocol::request_t req;
+    common::Error err_ser = ChangedSourcesStreamBroadcast(ch_sources_info, &req);
+    if (err_ser) {
+      const std::string err_str = err_ser->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    BroadcastClients(req, std::string());
+    return common::ErrnoError();
+  }
+
+  return common::make_errno_error_inval();
+}
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestStatisticStream(stream_client_t* pclient,
+                                                                     const fastotv::protocol::request_t* req) {
+  UNUSED(pclient);
+  CHECK(loop_->IsLoopThread());
+  if (req->params) {
+    json_object* jrequest_stat = ParseJson(*req->params);
+    if (!jrequest_stat) {
+      return common::make_errno_error_inval();
+    }
+
+    StatisticInfo stat;
+    common::Error err_des = stat.DeSerialize(jrequest_stat);
+    json_object_put(jrequest_stat);
+    if (err_des) {
+      const std::string err_str = err_des->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    const StreamStruct& stat_str = stat.GetStreamStruct();
+    Child* chan = FindChildByID(stat_str.id);
+    if (chan) {
+      size_t input_bps = 0;
+      for (const auto& input : stat_str.input) {
+        input_bps += input.GetBps();
+      }
+      chan->SetPlaying(stat_str.status == PLAYING && input_bps > 0);
+    }
+    startup_stats_->Record(stat_str.id, stat_str.startup);
+    streams_status_->Set(stat);
+    if (stats_history_) {
+      stats_history_->AddStream(stat);
+    }
+
+    if (admission_) {
+      const StreamStruct& str = stat.GetStreamStruct();
+      AdmissionControl::Cost measured = {stat.GetCpuLoad(), 0};
+      for (const auto& output : str.output) {
+        measured.bandwidth += output.GetBps();
+      }
+      admission_->Measure(str.id, measured);
+    }
+    if (job_queue_) {
+      job_queue_->Measure(stat.GetStreamStruct().id, stat.GetCpuLoad());
+    }
+
+    if (metrics_) {
+      metrics_->SetStream(stat);
+      StreamCgroups::Stats cgroup_stats;
+      if (cgroups_ && cgroups_->GetStats(stat.GetStreamStruct().id, &cgroup_stats)) {
+        metrics_->SetStreamCgroup(stat.GetStreamStruct().id, cgroup_stats);
+      }
+    }
+
+    if (stats_batch_) {
+      stats_batch_->Add(stat);
+      return common::ErrnoError();
+    }
+
+    fastotv::protocol::request_t req;
+    common::Error err_ser = StatisitcStreamBroadcast(stat, &req);
+    if (err_ser) {
+      const std::string err_str = err_ser->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    BroadcastClients(req, stat.GetStreamStruct().id);
+    return common::ErrnoError();
+  }
+
+  return common::make_errno_error_inval();
+}
+
+#if defined(MACHINE_LEARNING)
+common::ErrnoError ProcessSlaveWrapper::HandleRequestMlNotificationStream(stream_client_t* pclient,
+                                                                          const fastotv::protocol::request_t* req) {
+  UNUSED(pclient);
+  CHECK(loop_->IsLoopThread());
+  if (req->params) {
+    const char* params_ptr = req->params->c_str();
+    json_object* jrequest_notif = json_tokener_parse(params_ptr);
+    if (!jrequest_notif) {
+      return common::make_errno_error_inval();
+    }
+
+    fastotv::commands_info::ml::NotificationInfo notif;
+    common::Error err_des = notif.DeSerialize(jrequest_notif);
+    json_object_put(jrequest_notif);
+    if (err_des) {
+      const std::string err_str = err_des->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    fastotv::protocol::request_t req;
+    common::Error err_ser = MlNotificationStreamBroadcast(notif, &req);
+    if (err_ser) {
+      const std::string err_str = err_ser->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    BroadcastClients(req, std::string());
+    return common::ErrnoError();
+  }
+
+  return common::make_errno_error_inval();
+}
+#endif
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStartStream(ProtocoledDaemonClient* dclient,
+                                                                       const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  if (!dclient->HaveFullAccess()) {
+    return common::make_errno_error("Don't have permissions", EINTR);
+  }
+
+  if (req->params) {
+    const fastotv::protocol::sequance_id_t id = req->id;
+    const std::string params = *req->params;
+    const fastotv::timestamp_t request_ts = common::time::current_utc_mstime();
+    PostConfigTask([this, dclient, id, params, request_ts]() {
+      serialized_stream_t config;
+      StreamInfo sha;
+      common::ErrnoError err = ParseStartInfo(params, &config, &sha);
+      if (!err) {
+        config->Insert(ACTIVE_REQUEST_TS_FIELD, common::Value::CreateDoubleValue(request_ts));
+      }
+      loop_->ExecInLoopThread([this, dclient, id, config, sha, err]() {
+        common::ErrnoError errn = err;
+        if (!errn) {
+          errn = FindChildByID(sha.id) ? MakeStreamExistError(sha.id) : SpawnChildStream(config, sha);
+        }
+        if (!IsDaemonClientOnline(dclient)) {
+          return;
+        }
+
+        if (errn) {
+          DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+          ignore_result(dclient->StartStreamFail(id, common::make_error_from_errno(errn)));
+          return;
+        }
+        ignore_result(dclient->StartStreamSuccess(id));
+      });
+    });
+    return common::ErrnoError();
+  }
+
+  return common::make_errno_error_inval();
+}
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStopStream(ProtocoledDaemonClient* dclient,
+                                                                      const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  if (!dclient->HaveFullAccess()) {
+    return common::make_errno_error("Don't have permissions", EINTR);
+  }
+
+  if (req->params) {
+    const char* params_ptr = req->params->c_str();
+    json_object* jstop_info = json_tokener_parse(params_ptr);
+    if (!jstop_info) {
+      return common::make_errno_error_inval();
+    }
+
+    stream::StopInfo stop_info;
+    common::Error err_des = stop_info.DeSerialize(jstop_info);
+    json_object_put(jstop_info);
+    if (err_des) {
+      const std::string err_str = err_des->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    common::ErrnoError errn = StopChildStreamImpl(stop_info.GetStreamID());
+    if (errn) {
+      return dclient->StopFail(req->id, common::make_error_from_errno(errn));
+    }
+
+    return dclient->StopStreamSuccess(req->id);
+  }
+
+  return common::make_errno_error_inval();
+}
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientRestartStream(ProtocoledDaemonClient* dclient,
+                                                                         const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  if (!dclient->HaveFullAccess()) {
+    return common::make_errno_error("Don't have permissions", EINTR);
+  }
+
+  if (req->params) {
+    const char* params_ptr = req->params->c_str();
+    json_object* jrestart_info = json_tokener_parse(params_ptr);
+    if (!jrestart_info) {
+      return common::make_errno_error_inval();
+    }
+
+    stream::RestartInfo restart_info;
+    common::Error err_des = restart_info.DeSerialize(jrestart_info);
+    json_object_put(jrestart_info);
+    if (err_des) {
+      const std::string err_str = err_des->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    Child* chan = FindChildByID(restart_info.GetStreamID());
+    if (!chan) {
+      return dclient->ReStartStreamFail(req->id, common::make_error("Stream not found"));
+    }
+
+    ignore_result(chan->Restart());
+    return dclient->ReStartStreamSuccess(req->id);
+  }
+
+  return common::make_errno_error_inval();
+}
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientUpdateStream(ProtocoledDaemonClient* dclient,
+                                                                       const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  if (!dclient->HaveFullAccess()) {
+    return common::make_errno_error("Don't have permissions", EINTR);
+  }
+
+  if (req->params) {
+    const char* params_ptr = req->params->c_str();
+    json_object* jupdate_info = json_tokener_parse(params_ptr);
+    if (!jupdate_info) {
+      return common::make_errno_error_inval();
+    }
+
+    stream::UpdateConfigInfo update_info;
+    common::Error err_des = update_info.DeSerialize(jupdate_info);
+    json_object_put(jupdate_info);
+    if (err_des) {
+      const std::string err_str = err_des->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+
+    Child* chan = FindChildByID(update_info.GetStreamID());
+    if (!chan) {
+      return dclient->UpdateStreamFail(req->id, common::make_error("Stream not found"));
+    }
+
+    std::string changes_json;
+    if (!MakeJsonFromConfig(update_info.GetChanges(), &changes_json)) {
+      return dclient->UpdateStreamFail(req->id, common::make_error("Invalid config changes"));
+    }
+
+    // child keeps changes until stop, applied to running pipeline or by restart of it
+    common::ErrnoError errn = chan->UpdateConfig(changes_json);
+    if (errn) {
+      return dclient->UpdateStreamFail(req->id, common::make_error(errn->GetDescription()));
+    }
+    return dclient->UpdateStreamSuccess(req->id);
+  }
+
+  return common::make_errno_error_inval();
+}
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStartStreams(ProtocoledDaemonClient* dclient,
+                                                                        const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  if (!dclient->HaveFullAccess()) {
+    return common::make_errno_error("Don't have permissions", EINTR);
+  }
+
+  if (req->params) {
+    const fastotv::protocol::sequance_id_t id = req->id;
+    const std::string params = *req->params;
+    PostConfigTask([this, dclient, id, params]() {
+      json_object* jstart_info = ParseJson(params);
+      if (!jstart_info) {
+        loop_->ExecInLoopThread([this, dclient, id]() {
+          if (IsDaemonClientOnline(dclient)) {
+            ignore_result(dclient->BatchStreamsFail(id, common::make_error_inval()));
+          }
+        });
+        return;
+      }
+
+      stream::StartStreamsInfo start_info;
+      common::Error err_des = start_info.DeSerialize(jstart_info);
+      json_object_put(jstart_info);
+      if (err_des) {
+        loop_->ExecInLoopThread([this, dclient, id, err_des]() {
+          if (IsDaemonClientOnline(dclient)) {
+            ignore_result(dclient->BatchStreamsFail(id, err_des));
+          }
+        });
+        return;
+      }
+
+      // validate whole batch before first spawn, pipeline starts of children limited by start slots
+      std::vector<prepared_stream_t> prepared;
+      std::unordered_set<fastotv::stream_id_t> batch_ids;
+      stream::BatchResultInfo result;
+      for (const serialized_stream_t& config : start_info.GetConfigs()) {
+        StreamInfo sha;
+        common::ErrnoError err = ValidateStreamConfig(config, true, &sha);
+        if (err) {
+          result.AddFail(GetSid(config), err->GetDescription());
+          continue;
+        }
+
+        if (!batch_ids.insert(sha.id).second) {
+          result.AddFail(sha.id, "Duplicated stream id in batch");
+          continue;
+        }
+        prepared.push_back(prepared_stream_t(config, sha));
+      }
+
+      loop_->ExecInLoopThread([this, dclient, id, prepared, result]() {
+        stream::BatchResultInfo lresult = result;
+        for (const prepared_stream_t& stream : prepared) {
+          common::ErrnoError err = FindChildByID(stream.second.id) ? MakeStreamExistError(stream.second.id)
+                                                                   : SpawnChildStream(stream.first, stream.second);
+          if (err) {
+            lresult.AddFail(stream.second.id, err->GetDescription());
+            continue;
+          }
+          lresult.AddSuccess(stream.second.id);
+        }
+
+        INFO_LOG() << "Batch start streams: " << lresult.GetResults().size()
+                   << ", failed: " << lresult.GetFailedCount();
+        if (!IsDaemonClientOnline(dclient)) {
+          return;
+        }
+
+        std::string result_str;
+        common::Error err_ser = lresult.SerializeToString(&result_str);
+        if (err_ser) {
+          ignore_result(dclient->BatchStreamsFail(id, err_ser));
+          return;
+        }
+        ignore_result(dclient->BatchStreamsSuccess(id, result_str));
+      });
+    });
+    return common::ErrnoError();
   }
 
   return common::make_errno_error_inval();
 }
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestStatisticStream(stream_client_t* pclient,
-                                                                     const fastotv::protocol::request_t* req) {
-  UNUSED(pclient);
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStopStreams(ProtocoledDaemonClient* dclient,
+                                                                       const fastotv::protocol::request_t* req) {
   CHECK(loop_->IsLoopThread());
+  if (!dclient->HaveFullAccess()) {
+    return common::make_errno_error("Don't have permissions", EINTR);
+  }
+
   if (req->params) {
     const char* params_ptr = req->params->c_str();
-    json_object* jrequest_stat = json_tokener_parse(params_ptr);
-    if (!jrequest_stat) {
+    json_object* jstop_info = json_tokener_parse(params_ptr);
+    if (!jstop_info) {
       return common::make_errno_error_inval();
     }
 
-    StatisticInfo stat;
-    common::Error err_des = stat.DeSerialize(jrequest_stat);
-    json_object_put(jrequest_stat);
+    stream::StreamsInfo stop_info;
+    common::Error err_des = stop_info.DeSerialize(jstop_info);
+    json_object_put(jstop_info);
     if (err_des) {
+      ignore_result(dclient->BatchStreamsFail(req->id, err_des));
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    fastotv::protocol::request_t req;
-    common::Error err_ser = StatisitcStreamBroadcast(stat, &req);
+    stream::BatchResultInfo result;
+    for (const fastotv::stream_id_t& sid : stop_info.GetStreams()) {
+      common::ErrnoError errn = StopChildStreamImpl(sid);
+      if (errn) {
+        result.AddFail(sid, errn->GetDescription());
+        continue;
+      }
+      result.AddSuccess(sid);
+    }
+
+    std::string result_str;
+    common::Error err_ser = result.SerializeToString(&result_str);
     if (err_ser) {
       const std::string err_str = err_ser->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    BroadcastClients(req);
-    return common::ErrnoError();
+    return dclient->BatchStreamsSuccess(req->id, result_str);
   }
 
   return common::make_errno_error_inval();
 }
 
-#if defined(MACHINE_LEARNING)
-common::ErrnoError ProcessSlaveWrapper::HandleRequestMlNotificationStream(stream_client_t* pclient,
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientRestartStreams(ProtocoledDaemonClient* dclient,
                                                                           const fastotv::protocol::request_t* req) {
-  UNUSED(pclient);
   CHECK(loop_->IsLoopThread());
+  if (!dclient->HaveFullAccess()) {
+    return common::make_errno_error("Don't have permissions", EINTR);
+  }
+
   if (req->params) {
     const char* params_ptr = req->params->c_str();
-    json_object* jrequest_notif = json_tokener_parse(params_ptr);
-    if (!jrequest_notif) {
+    json_object* jrestart_info = json_tokener_parse(params_ptr);
+    if (!jrestart_info) {
       return common::make_errno_error_inval();
     }
 
-    fastotv::commands_info::ml::NotificationInfo notif;
-    common::Error err_des = notif.DeSerialize(jrequest_notif);
-    json_object_put(jrequest_notif);
+    stream::StreamsInfo restart_info;
+    common::Error err_des = restart_info.DeSerialize(jrestart_info);
+    json_object_put(jrestart_info);
     if (err_des) {
+      ignore_result(dclient->BatchStreamsFail(req->id, err_des));
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    fastotv::protocol::request_t req;
-    common::Error err_ser = MlNotificationStreamBroadcast(notif, &req);
+    stream::BatchResultInfo result;
+    for (const fastotv::stream_id_t& sid : restart_info.GetStreams()) {
+      Child* chan = FindChildByID(sid);
+      if (!chan) {
+        result.AddFail(sid, "Stream not found");
+        continue;
+      }
+
+      common::ErrnoError errn = chan->Restart();
+      if (errn) {
+        result.AddFail(sid, errn->GetDescription());
+        continue;
+      }
+      result.AddSuccess(sid);
+    }
+
+    std::string result_str;
+    common::Error err_ser = result.SerializeToString(&result_str);
     if (err_ser) {
       const std::string err_str = err_ser->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    BroadcastClients(req);
-    return common::ErrnoError();
+    return dclient->BatchStreamsSuccess(req->id, result_str);
   }
 
   return common::make_errno_error_inval();
 }
-#endif
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStartStream(ProtocoledDaemonClient* dclient,
-                                                                       const fastotv::protocol::request_t* req) {
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetLogStream(ProtocoledDaemonClient* dclient,
+                                                                        const fastotv::protocol::request_t* req) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->HaveFullAccess()) {
     return common::make_errno_error("Don't have permissions", EINTR);
@@ -832,33 +2168,32 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStartStream(Protocole
 
   if (req->params) {
     const char* params_ptr = req->params->c_str();
-    json_object* jstart_info = json_tokener_parse(params_ptr);
-    if (!jstart_info) {
+    json_object* jgetlog_info = json_tokener_parse(params_ptr);
+    if (!jgetlog_info) {
       return common::make_errno_error_inval();
     }
 
-    stream::StartInfo start_info;
-    common::Error err_des = start_info.DeSerialize(jstart_info);
-    json_object_put(jstart_info);
+    stream::GetLogInfo log_info;
+    common::Error err_des = log_info.DeSerialize(jgetlog_info);
+    json_object_put(jgetlog_info);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    common::ErrnoError err = CreateChildStream(start_info.GetConfig());
-    if (err) {
-      ignore_result(dclient->StartStreamFail(req->id, common::make_error_from_errno(err)));
-      return err;
+    const auto remote_log_path = log_info.GetLogPath();
+    const auto stream_log_file = MakeStreamLogPath(log_info.GetFeedbackDir());
+    if (stream_log_file) {
+      UploadFile(*stream_log_file, remote_log_path);
     }
-
-    return dclient->StartStreamSuccess(req->id);
+    return dclient->GetLogStreamSuccess(req->id);
   }
 
   return common::make_errno_error_inval();
 }
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStopStream(ProtocoledDaemonClient* dclient,
-                                                                      const fastotv::protocol::request_t* req) {
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetPipelineStream(ProtocoledDaemonClient* dclient,
+                                                                             const fastotv::protocol::request_t* req) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->HaveFullAccess()) {
     return common::make_errno_error("Don't have permissions", EINTR);
@@ -866,31 +2201,31 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStopStream(Protocoled
 
   if (req->params) {
     const char* params_ptr = req->params->c_str();
-    json_object* jstop_info = json_tokener_parse(params_ptr);
-    if (!jstop_info) {
+    json_object* jgetpipe_info = json_tokener_parse(params_ptr);
+    if (!jgetpipe_info) {
       return common::make_errno_error_inval();
     }
 
-    stream::StopInfo stop_info;
-    common::Error err_des = stop_info.DeSerialize(jstop_info);
-    json_object_put(jstop_info);
+    stream::GetLogInfo pipeline_info;
+    common::Error err_des = pipeline_info.DeSerialize(jgetpipe_info);
+    json_object_put(jgetpipe_info);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    common::ErrnoError errn = StopChildStreamImpl(stop_info.GetStreamID());
-    if (errn) {
-      return dclient->StopFail(req->id, common::make_error_from_errno(errn));
+    const auto remote_log_path = pipeline_info.GetLogPath();
+    const auto stream_log_file = MakeStreamPipelinePath(pipeline_info.GetFeedbackDir());
+    if (stream_log_file) {
+      UploadFile(*stream_log_file, remote_log_path);
     }
-
-    return dclient->StopStreamSuccess(req->id);
+    return dclient->GetLogStreamSuccess(req->id);
   }
 
   return common::make_errno_error_inval();
 }
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestClientRestartStream(ProtocoledDaemonClient* dclient,
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientProfileStream(ProtocoledDaemonClient* dclient,
                                                                          const fastotv::protocol::request_t* req) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->HaveFullAccess()) {
@@ -899,32 +2234,36 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientRestartStream(Protoco
 
   if (req->params) {
     const char* params_ptr = req->params->c_str();
-    json_object* jrestart_info = json_tokener_parse(params_ptr);
-    if (!jrestart_info) {
+    json_object* jprofile_info = json_tokener_parse(params_ptr);
+    if (!jprofile_info) {
       return common::make_errno_error_inval();
     }
 
-    stream::RestartInfo restart_info;
-    common::Error err_des = restart_info.DeSerialize(jrestart_info);
-    json_object_put(jrestart_info);
+    stream::ProfileInfo profile_info;
+    common::Error err_des = profile_info.DeSerialize(jprofile_info);
+    json_object_put(jprofile_info);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    Child* chan = FindChildByID(restart_info.GetStreamID());
+    Child* chan = FindChildByID(profile_info.GetStreamID());
     if (!chan) {
-      return dclient->ReStartStreamFail(req->id, common::make_error("Stream not found"));
+      return dclient->ProfileStreamFail(req->id, common::make_error("Stream not found"));
     }
 
-    ignore_result(chan->Restart());
-    return dclient->ReStartStreamSuccess(req->id);
+    // report written by child into its feedback dir, taken by get_profile_stream
+    common::ErrnoError errn = chan->Profile(profile_info.GetDuration());
+    if (errn) {
+      return dclient->ProfileStreamFail(req->id, common::make_error(errn->GetDescription()));
+    }
+    return dclient->ProfileStreamSuccess(req->id);
   }
 
   return common::make_errno_error_inval();
 }
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetLogStream(ProtocoledDaemonClient* dclient,
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientUnmuteStream(ProtocoledDaemonClient* dclient,
                                                                         const fastotv::protocol::request_t* req) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->HaveFullAccess()) {
@@ -933,35 +2272,41 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetLogStream(Protocol
 
   if (req->params) {
     const char* params_ptr = req->params->c_str();
-    json_object* jgetlog_info = json_tokener_parse(params_ptr);
-    if (!jgetlog_info) {
+    json_object* junmute_info = json_tokener_parse(params_ptr);
+    if (!junmute_info) {
       return common::make_errno_error_inval();
     }
 
-    stream::GetLogInfo log_info;
-    common::Error err_des = log_info.DeSerialize(jgetlog_info);
-    json_object_put(jgetlog_info);
+    stream::StreamInfo unmute_info;
+    common::Error err_des = unmute_info.DeSerialize(junmute_info);
+    json_object_put(junmute_info);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    const auto remote_log_path = log_info.GetLogPath();
-    if (remote_log_path.GetScheme() == common::uri::Url::http) {
-      const auto stream_log_file = MakeStreamLogPath(log_info.GetFeedbackDir());
-      if (stream_log_file) {
-        PostHttpFile(*stream_log_file, remote_log_path);
-      }
-    } else if (remote_log_path.GetScheme() == common::uri::Url::https) {
+    Child* chan = FindChildByID(unmute_info.GetStreamID());
+    if (!chan) {
+      return dclient->UnmuteStreamFail(req->id, common::make_error("Stream not found"));
     }
-    return dclient->GetLogStreamSuccess(req->id);
+
+    // controller retries, source node keeps streaming meanwhile
+    if (!chan->IsPlaying()) {
+      return dclient->UnmuteStreamFail(req->id, common::make_error("Stream not playing yet"));
+    }
+
+    common::ErrnoError errn = chan->UnmuteOutputs();
+    if (errn) {
+      return dclient->UnmuteStreamFail(req->id, common::make_error(errn->GetDescription()));
+    }
+    return dclient->UnmuteStreamSuccess(req->id);
   }
 
   return common::make_errno_error_inval();
 }
 
-common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetPipelineStream(ProtocoledDaemonClient* dclient,
-                                                                             const fastotv::protocol::request_t* req) {
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetProfileStream(ProtocoledDaemonClient* dclient,
+                                                                            const fastotv::protocol::request_t* req) {
   CHECK(loop_->IsLoopThread());
   if (!dclient->HaveFullAccess()) {
     return common::make_errno_error("Don't have permissions", EINTR);
@@ -969,26 +2314,23 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetPipelineStream(Pro
 
   if (req->params) {
     const char* params_ptr = req->params->c_str();
-    json_object* jgetpipe_info = json_tokener_parse(params_ptr);
-    if (!jgetpipe_info) {
+    json_object* jgetprofile_info = json_tokener_parse(params_ptr);
+    if (!jgetprofile_info) {
       return common::make_errno_error_inval();
     }
 
-    stream::GetLogInfo pipeline_info;
-    common::Error err_des = pipeline_info.DeSerialize(jgetpipe_info);
-    json_object_put(jgetpipe_info);
+    stream::GetLogInfo profile_info;
+    common::Error err_des = profile_info.DeSerialize(jgetprofile_info);
+    json_object_put(jgetprofile_info);
     if (err_des) {
       const std::string err_str = err_des->GetDescription();
       return common::make_errno_error(err_str, EAGAIN);
     }
 
-    const auto remote_log_path = pipeline_info.GetLogPath();
-    if (remote_log_path.GetScheme() == common::uri::Url::http) {
-      const auto stream_log_file = MakeStreamPipelinePath(pipeline_info.GetFeedbackDir());
-      if (stream_log_file) {
-        PostHttpFile(*stream_log_file, remote_log_path);
-      }
-    } else if (remote_log_path.GetScheme() == common::uri::Url::https) {
+    const auto remote_log_path = profile_info.GetLogPath();
+    const auto stream_profile_file = MakeStreamProfilePath(profile_info.GetFeedbackDir());
+    if (stream_profile_file) {
+      UploadFile(*stream_profile_file, remote_log_path);
     }
     return dclient->GetLogStreamSuccess(req->id);
   }
@@ -1024,6 +2366,18 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientPrepareService(Protoc
     static_cast<HttpHandler*>(http_handler_)->SetHttpRoot(http_root);
     folders_for_monitor_.push_back(http_root);
 
+    const std::string trash_dir = common::file_system::make_path(http_root.GetPath(), OUTPUT_TRASH_DIR_NAME);
+    if (!output_trash_ || output_trash_->GetPath() != trash_dir) {
+      destroy(&output_trash_);
+      output_trash_ = new OutputTrash(trash_dir);
+      if (output_trash_->Init()) {
+        output_trash_->Collect();  // left by previous service
+      } else {
+        WARNING_LOG() << "Can't create output trash: " << trash_dir << ", old vod outputs removed by streams";
+        destroy(&output_trash_);
+      }
+    }
+
     const auto vods_root = VodsHandler::http_directory_path_t(state_info.GetVodsDirectory());
     static_cast<VodsHandler*>(vods_handler_)->SetHttpRoot(vods_root);
     folders_for_monitor_.push_back(vods_root);
@@ -1033,8 +2387,16 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientPrepareService(Protoc
     folders_for_monitor_.push_back(cods_root);
 
     const auto timeshift_root = CodsHandler::http_directory_path_t(state_info.GetTimeshiftsDirectory());
+    static_cast<HttpHandler*>(http_handler_)->SetTimeshiftRoot(timeshift_root);
     folders_for_monitor_.push_back(timeshift_root);
 
+    if (file_expirer_) {
+      file_expirer_->Clear();
+      for (const auto& folder : folders_for_monitor_) {
+        file_expirer_->AddFolder(folder.GetPath());
+      }
+    }
+
     service::Directories dirs(state_info);
     std::string resp_str = service::MakeDirectoryResponce(dirs);
     return dclient->StateServiceSuccess(req->id, resp_str);
@@ -1051,72 +2413,140 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientSyncService(Protocole
   }
 
   if (req->params) {
-    const char* params_ptr = req->params->c_str();
-    json_object* jservice_state = json_tokener_parse(params_ptr);
-    if (!jservice_state) {
-      return common::make_errno_error_inval();
+    const fastotv::protocol::sequance_id_t id = req->id;
+    const std::string params = *req->params;
+    service::SyncInfo::hashes_t known_hashes;
+    for (auto it = stream_lines_.begin(); it != stream_lines_.end(); ++it) {
+      if (!it->second.hash.empty()) {
+        known_hashes[it->first] = it->second.hash;
+      }
     }
 
-    service::SyncInfo sync_info;
-    common::Error err_des = sync_info.DeSerialize(jservice_state);
-    json_object_put(jservice_state);
-    if (err_des) {
-      const std::string err_str = err_des->GetDescription();
-      return common::make_errno_error(err_str, EAGAIN);
-    }
+    PostConfigTask([this, dclient, id, params, known_hashes]() {
+      json_object* jservice_state = ParseJson(params);
+      if (!jservice_state) {
+        WARNING_LOG() << "Invalid sync service request";
+        return;
+      }
 
-    // refresh vods
-    vods_links_.Clear();
-    cods_links_.Clear();
-    for (StreamConfig config : sync_info.GetStreams()) {
-      AddStreamLine(config);
-    }
+      service::SyncInfo sync_info(known_hashes);
+      common::Error err_des = sync_info.DeSerialize(jservice_state);
+      json_object_put(jservice_state);
+      if (err_des) {
+        DEBUG_MSG_ERROR(err_des, common::logging::LOG_LEVEL_WARNING);
+        return;
+      }
+
+      // only changed and not versioned configs parsed and validated
+      std::vector<std::pair<fastotv::stream_id_t, StreamLine>> lines;
+      for (const service::SyncInfo::SyncStream& stream : sync_info.GetStreams()) {
+        StreamLine line;
+        line.hash = stream.hash;
+        line.cods = false;
+        if (stream.config) {
+          StreamInfo sha;
+          common::ErrnoError err = ValidateStreamConfig(stream.config, false, &sha);
+          if (err) {
+            continue;
+          }
+          line = MakeStreamLine(stream.config, sha);
+          line.hash = stream.hash;
+        }
+        lines.push_back(std::make_pair(stream.id, line));
+      }
 
-    return dclient->SyncServiceSuccess(req->id);
+      loop_->ExecInLoopThread([this, dclient, id, lines]() {
+        ApplyStreamLines(lines);
+        if (IsDaemonClientOnline(dclient)) {
+          ignore_result(dclient->SyncServiceSuccess(id));
+        }
+      });
+    });
+    return common::ErrnoError();
   }
 
   return common::make_errno_error_inval();
 }
 
-void ProcessSlaveWrapper::AddStreamLine(const serialized_stream_t& config_args) {
-  CHECK(loop_->IsLoopThread());
-  common::ErrnoError err = options::ValidateConfig(config_args);
-  if (err) {
-    return;
+ProcessSlaveWrapper::StreamLine ProcessSlaveWrapper::MakeStreamLine(const serialized_stream_t& config_args,
+                                                                    const StreamInfo& sha) {
+  StreamLine line;
+  line.config = config_args;
+  line.cods = false;
+  const bool is_vod = sha.type == fastotv::VOD_ENCODE || sha.type == fastotv::VOD_RELAY;
+  const bool is_cod = sha.type == fastotv::COD_ENCODE || sha.type == fastotv::COD_RELAY;
+  if (!is_vod && !is_cod) {
+    return line;
+  }
+
+  output_t output;
+  if (read_output(config_args, &output)) {
+    for (const OutputUri& out_uri : output) {
+      common::uri::Url ouri = out_uri.GetOutput();
+      if (ouri.GetScheme() == common::uri::Url::http) {
+        line.http_roots.push_back(out_uri.GetHttpRoot().GetPath());
+      }
+    }
   }
 
-  StreamInfo sha;
-  std::string feedback_dir;
-  common::logging::LOG_LEVEL logs_level;
-  err = MakeStreamInfo(config_args, false, &sha, &feedback_dir, &logs_level);
-  if (err) {
-    return;
+  line.cods = is_cod;
+  if (is_vod && !line.http_roots.empty()) {
+    config_args->Insert(CLEANUP_TS_FIELD, common::Value::CreateBooleanValue(false));
   }
+  return line;
+}
 
-  if (sha.type == fastotv::VOD_ENCODE || sha.type == fastotv::VOD_RELAY) {
-    output_t output;
-    if (read_output(config_args, &output)) {
-      for (const OutputUri& out_uri : output) {
-        common::uri::Url ouri = out_uri.GetOutput();
-        if (ouri.GetScheme() == common::uri::Url::http) {
-          const common::file_system::ascii_directory_string_path http_root = out_uri.GetHttpRoot();
-          config_args->Insert(CLEANUP_TS_FIELD, common::Value::CreateBooleanValue(false));
-          vods_links_.Insert(http_root, config_args);
-        }
+void ProcessSlaveWrapper::ApplyStreamLines(const std::vector<std::pair<fastotv::stream_id_t, StreamLine>>& lines) {
+  CHECK(loop_->IsLoopThread());
+  std::unordered_map<fastotv::stream_id_t, StreamLine> synced;
+  std::vector<std::string> vods_removed, cods_removed;
+  LinksHolderTS::links_t vods_inserted, cods_inserted;
+  auto remove_line = [&vods_removed, &cods_removed](const StreamLine& line) {
+    std::vector<std::string>* removed = line.cods ? &cods_removed : &vods_removed;
+    removed->insert(removed->end(), line.http_roots.begin(), line.http_roots.end());
+  };
+
+  size_t changed = 0;
+  for (const auto& entry : lines) {
+    if (synced.find(entry.first) != synced.end()) {
+      WARNING_LOG() << "Stream id: " << entry.first << " synced twice, skipped";
+      continue;
+    }
+
+    auto it = stream_lines_.find(entry.first);
+    if (!entry.second.config) {
+      if (it == stream_lines_.end() || it->second.hash != entry.second.hash) {
+        WARNING_LOG() << "Stream id: " << entry.first << " synced without config by unknown hash, skipped";
+        continue;
       }
+      synced[entry.first] = it->second;
+      stream_lines_.erase(it);
+      continue;
     }
-  } else if (sha.type == fastotv::COD_ENCODE || sha.type == fastotv::COD_RELAY) {
-    output_t output;
-    if (read_output(config_args, &output)) {
-      for (const OutputUri& out_uri : output) {
-        common::uri::Url ouri = out_uri.GetOutput();
-        if (ouri.GetScheme() == common::uri::Url::http) {
-          const common::file_system::ascii_directory_string_path http_root = out_uri.GetHttpRoot();
-          cods_links_.Insert(http_root, config_args);
-        }
-      }
+
+    if (it != stream_lines_.end()) {
+      remove_line(it->second);
+      stream_lines_.erase(it);
     }
+    const StreamLine& line = entry.second;
+    LinksHolderTS::links_t* inserted = line.cods ? &cods_inserted : &vods_inserted;
+    for (const std::string& http_root : line.http_roots) {
+      (*inserted)[http_root] = line.config;
+    }
+    synced[entry.first] = line;
+    changed++;
+  }
+
+  // not synced anymore
+  const size_t removed = stream_lines_.size();
+  for (auto it = stream_lines_.begin(); it != stream_lines_.end(); ++it) {
+    remove_line(it->second);
   }
+  stream_lines_.swap(synced);
+
+  vods_links_.Apply(vods_removed, vods_inserted);
+  cods_links_.Apply(cods_removed, cods_inserted);
+  INFO_LOG() << "Synced streams: " << stream_lines_.size() << ", changed: " << changed << ", removed: " << removed;
 }
 
 common::ErrnoError ProcessSlaveWrapper::HandleRequestClientActivate(ProtocoledDaemonClient* dclient,
@@ -1153,6 +2583,9 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientActivate(ProtocoledDa
     }
 
     dclient->SetVerified(true, tm);
+    if (std::find(daemon_clients_.begin(), daemon_clients_.end(), dclient) == daemon_clients_.end()) {
+      daemon_clients_.push_back(dclient);
+    }
     return common::ErrnoError();
   }
 
@@ -1210,10 +2643,7 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetLogService(Protoco
     }
 
     const auto remote_log_path = get_log_info.GetLogPath();
-    if (remote_log_path.GetScheme() == common::uri::Url::http) {
-      PostHttpFile(common::file_system::ascii_file_string_path(config_.log_path), remote_log_path);
-    } else if (remote_log_path.GetScheme() == common::uri::Url::https) {
-    }
+    UploadFile(common::file_system::ascii_file_string_path(config_.log_path), remote_log_path);
 
     return dclient->GetLogServiceSuccess(req->id);
   }
@@ -1221,6 +2651,73 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestClientGetLogService(Protoco
   return common::make_errno_error_inval();
 }
 
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStreamsStatusService(
+    ProtocoledDaemonClient* dclient,
+    const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  if (!dclient->IsVerified()) {
+    return common::make_errno_error_inval();
+  }
+
+  service::StreamsStatusInfo filter;  // all streams without params
+  if (req->params) {
+    const char* params_ptr = req->params->c_str();
+    json_object* jfilter = json_tokener_parse(params_ptr);
+    if (!jfilter) {
+      return common::make_errno_error_inval();
+    }
+
+    common::Error err_des = filter.DeSerialize(jfilter);
+    json_object_put(jfilter);
+    if (err_des) {
+      const std::string err_str = err_des->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+  }
+
+  std::string status_str;
+  common::Error err_ser = streams_status_->Serialize(filter, &status_str);
+  if (err_ser) {
+    const std::string err_str = err_ser->GetDescription();
+    return common::make_errno_error(err_str, EAGAIN);
+  }
+
+  return dclient->StreamsStatusServiceSuccess(req->id, status_str);
+}
+
+common::ErrnoError ProcessSlaveWrapper::HandleRequestClientStatsHistoryService(
+    ProtocoledDaemonClient* dclient,
+    const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  if (!dclient->IsVerified()) {
+    return common::make_errno_error_inval();
+  }
+
+  if (!stats_history_) {
+    ignore_result(dclient->StatsHistoryServiceFail(req->id, common::make_error("Stats history disabled")));
+    return common::make_errno_error("Stats history disabled", EINVAL);
+  }
+
+  service::StatsHistoryInfo filter;  // all streams, whole history
+  if (req->params) {
+    const char* params_ptr = req->params->c_str();
+    json_object* jfilter = json_tokener_parse(params_ptr);
+    if (!jfilter) {
+      return common::make_errno_error_inval();
+    }
+
+    common::Error err_des = filter.DeSerialize(jfilter);
+    json_object_put(jfilter);
+    if (err_des) {
+      const std::string err_str = err_des->GetDescription();
+      return common::make_errno_error(err_str, EAGAIN);
+    }
+  }
+
+  const std::string history_str = stats_history_->Serialize(filter.GetStreams(), filter.GetSince(), filter.GetStep());
+  return dclient->StatsHistoryServiceSuccess(req->id, history_str);
+}
+
 common::ErrnoError ProcessSlaveWrapper::HandleRequestServiceCommand(ProtocoledDaemonClient* dclient,
                                                                     const fastotv::protocol::request_t* req) {
   if (req->method == DAEMON_START_STREAM) {
@@ -1229,10 +2726,24 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestServiceCommand(ProtocoledDa
     return HandleRequestClientStopStream(dclient, req);
   } else if (req->method == DAEMON_RESTART_STREAM) {
     return HandleRequestClientRestartStream(dclient, req);
+  } else if (req->method == DAEMON_UPDATE_STREAM) {
+    return HandleRequestClientUpdateStream(dclient, req);
+  } else if (req->method == DAEMON_START_STREAMS) {
+    return HandleRequestClientStartStreams(dclient, req);
+  } else if (req->method == DAEMON_STOP_STREAMS) {
+    return HandleRequestClientStopStreams(dclient, req);
+  } else if (req->method == DAEMON_RESTART_STREAMS) {
+    return HandleRequestClientRestartStreams(dclient, req);
   } else if (req->method == DAEMON_GET_LOG_STREAM) {
     return HandleRequestClientGetLogStream(dclient, req);
   } else if (req->method == DAEMON_GET_PIPELINE_STREAM) {
     return HandleRequestClientGetPipelineStream(dclient, req);
+  } else if (req->method == DAEMON_PROFILE_STREAM) {
+    return HandleRequestClientProfileStream(dclient, req);
+  } else if (req->method == DAEMON_GET_PROFILE_STREAM) {
+    return HandleRequestClientGetProfileStream(dclient, req);
+  } else if (req->method == DAEMON_UNMUTE_STREAM) {
+    return HandleRequestClientUnmuteStream(dclient, req);
   } else if (req->method == DAEMON_PREPARE_SERVICE) {
     return HandleRequestClientPrepareService(dclient, req);
   } else if (req->method == DAEMON_SYNC_SERVICE) {
@@ -1245,6 +2756,10 @@ common::ErrnoError ProcessSlaveWrapper::HandleRequestServiceCommand(ProtocoledDa
     return HandleRequestClientPingService(dclient, req);
   } else if (req->method == DAEMON_GET_LOG_SERVICE) {
     return HandleRequestClientGetLogService(dclient, req);
+  } else if (req->method == DAEMON_STREAMS_STATUS_SERVICE) {
+    return HandleRequestClientStreamsStatusService(dclient, req);
+  } else if (req->method == DAEMON_STATS_HISTORY_SERVICE) {
+    return HandleRequestClientStatsHistoryService(dclient, req);
   }
 
   WARNING_LOG() << "Received unknown method: " << req->method;
@@ -1293,6 +2808,10 @@ common::ErrnoError ProcessSlaveWrapper::HandleResponceStreamsCommand(stream_clie
   if (pclient->PopRequestByID(resp->id, &req)) {
     if (req.method == STOP_STREAM) {
     } else if (req.method == RESTART_STREAM) {
+    } else if (req.method == UPDATE_CONFIG_STREAM) {
+      if (resp->IsError()) {
+        WARNING_LOG() << "Config of stream not updated: " << resp->error->message;
+      }
     } else {
       WARNING_LOG() << "HandleResponceStreamsCommand not handled command: " << req.method;
     }
@@ -1300,17 +2819,87 @@ common::ErrnoError ProcessSlaveWrapper::HandleResponceStreamsCommand(stream_clie
   return common::ErrnoError();
 }
 
+void ProcessSlaveWrapper::SetGpuDevices(service::ServerInfo* stat) const {
+  const gpu_stats::devices_stats_t devices = node_stats_->gpu_devices.Get();
+  if (devices.empty()) {
+    return;
+  }
+
+  std::unordered_map<long, fastotv::stream_id_t> streams_by_pid;
+  for (auto it = children_.begin(); it != children_.end(); ++it) {
+    const long pid = static_cast<ChildStream*>(it->second)->GetProcessID();
+    if (pid) {
+      streams_by_pid[pid] = it->first;
+    }
+  }
+
+  service::gpu_devices_t result;
+  for (const gpu_stats::DeviceStats& device : devices) {
+    service::GpuDeviceInfo::streams_t streams;
+    for (const gpu_stats::ProcessStats& process : device.processes) {
+      auto sit = streams_by_pid.find(process.pid);
+      if (sit != streams_by_pid.end()) {
+        streams.push_back({sit->second, process.encoder_load, process.decoder_load, process.compute_load});
+      }
+    }
+    result.push_back(service::GpuDeviceInfo(device, streams));
+  }
+  stat->SetGpuDevices(result);
+}
+
+void ProcessSlaveWrapper::SetCapacity(service::ServerInfo* stat,
+                                      double cpu_load,
+                                      uint64_t bandwidth,
+                                      uint64_t disk_written) const {
+  const AdmissionControl::Cost reserved = admission_ ? admission_->GetReserved() : AdmissionControl::Cost{0, 0};
+
+  const double cores = std::max(std::thread::hardware_concurrency(), 1u);
+  const double cpu_limit = config_.admission_cpu_limit ? config_.admission_cpu_limit : 100;
+  const double cores_capacity = cores * cpu_limit / 100;
+  const double cores_used = std::max(cpu_load * cores / 100, reserved.cpu / 100);
+  const service::CapacityInfo::Resource cpu_cores = {cores_capacity, std::max(cores_capacity - cores_used, 0.0)};
+
+  service::CapacityInfo::gpus_t gpus;
+  const gpu_stats::devices_stats_t devices = node_stats_->gpu_devices.Get();
+  for (size_t i = 0; i < devices.size(); ++i) {
+    const gpu_stats::DeviceStats& device = devices[i];
+    service::CapacityInfo::GpuCapacity gpu = {{0, 0}, {100, std::max(100.0 - device.decoder_load, 0.0)}};
+    if (config_.nvenc_max_sessions) {
+      const size_t sessions = encoder_pool_->GetSessions(gpu_stats::EncoderPool::NVIDIA_DEVICE, static_cast<int>(i));
+      gpu.encoder_sessions.capacity = config_.nvenc_max_sessions;
+      gpu.encoder_sessions.remaining = std::max(config_.nvenc_max_sessions - static_cast<double>(sessions), 0.0);
+      if (config_.gpu_max_load && device.encoder_load >= config_.gpu_max_load) {
+        gpu.encoder_sessions.remaining = 0;  // new sessions placed on cpu
+      }
+    }
+    gpus.push_back(gpu);
+  }
+
+  double output_capacity = config_.admission_bandwidth_limit;
+  if (!output_capacity) {
+    for (const service::InterfaceShot& interf : node_stats_->prev_nshot.interfaces) {
+      output_capacity += service::GetInterfaceSpeed(interf.name);
+    }
+  }
+  const double output_used = static_cast<double>(std::max(bandwidth, reserved.bandwidth)) * 8 / (1000 * 1000);
+  const service::CapacityInfo::Resource output_mbps = {output_capacity, std::max(output_capacity - output_used, 0.0)};
+
+  const double disk_capacity = config_.disk_write_capacity;
+  const double disk_used = static_cast<double>(disk_written) / (1024 * 1024);
+  const service::CapacityInfo::Resource disk_write_mbps = {disk_capacity, std::max(disk_capacity - disk_used, 0.0)};
+  stat->SetCapacity(service::CapacityInfo(cpu_cores, gpus, output_mbps, disk_write_mbps));
+}
+
 std::string ProcessSlaveWrapper::MakeServiceStats(common::time64_t expiration_time) const {
-  service::CpuShot next = service::GetMachineCpuShot();
+  service::CpuShot next = node_stats_->reader.GetCpuShot();
   double cpu_load = service::GetCpuMachineLoad(node_stats_->prev, next);
   node_stats_->prev = next;
 
-  service::NetShot next_nshot = service::GetMachineNetShot();
+  service::NetShot next_nshot = node_stats_->reader.GetNetShot();
   uint64_t bytes_recv = (next_nshot.bytes_recv - node_stats_->prev_nshot.bytes_recv);
   uint64_t bytes_send = (next_nshot.bytes_send - node_stats_->prev_nshot.bytes_send);
-  node_stats_->prev_nshot = next_nshot;
 
-  service::MemoryShot mem_shot = service::GetMachineMemoryShot();
+  service::MemoryShot mem_shot = node_stats_->reader.GetMemoryShot();
   service::HddShot hdd_shot = service::GetMachineHddShot();
   service::SysinfoShot sshot = service::GetMachineSysinfoShot();
   std::string uptime_str = common::MemSPrintf("%lu %lu %lu", sshot.loads[0], sshot.loads[1], sshot.loads[2]);
@@ -1320,20 +2909,53 @@ std::string ProcessSlaveWrapper::MakeServiceStats(common::time64_t expiration_ti
     ts_diff = 1;  // divide by zero
   }
   node_stats_->timestamp = current_time;
+  node_stats_->cpu_load = cpu_load;
+  node_stats_->bytes_send = bytes_send / ts_diff;
 
-  size_t daemons_client_count = 0;
-  std::vector<common::libev::IoClient*> clients = loop_->GetClients();
-  for (size_t i = 0; i < clients.size(); ++i) {
-    ProtocoledDaemonClient* dclient = dynamic_cast<ProtocoledDaemonClient*>(clients[i]);
-    if (dclient && dclient->IsVerified()) {
-      daemons_client_count++;
-    }
-  }
-  service::OnlineUsers online(daemons_client_count, static_cast<HttpHandler*>(http_handler_)->GetOnlineClients(),
+  service::OnlineUsers online(daemon_clients_.size(), static_cast<HttpHandler*>(http_handler_)->GetOnlineClients(),
                               static_cast<HttpHandler*>(vods_handler_)->GetOnlineClients(),
                               static_cast<HttpHandler*>(cods_handler_)->GetOnlineClients());
   service::ServerInfo stat(cpu_load, node_stats_->gpu_load, uptime_str, mem_shot, hdd_shot, bytes_recv / ts_diff,
                            bytes_send / ts_diff, sshot, current_time, online);
+  service::DiskIoShot next_dshot = node_stats_->reader.GetDiskIoShot();
+  const service::io_rates_t disks = service::GetDisksRates(node_stats_->prev_dshot, next_dshot, ts_diff);
+  node_stats_->prev_dshot = next_dshot;
+  uint64_t disk_written = 0;
+  for (const service::IoRate& disk : disks) {
+    disk_written += disk.out_bps;
+  }
+  if (metrics_) {
+    MetricsRegistry::NodeMetrics node;
+    node.cpu_load = cpu_load;
+    node.gpu_load = node_stats_->gpu_load;
+    node.ram_bytes_total = mem_shot.ram_bytes_total;
+    node.ram_bytes_free = mem_shot.ram_bytes_free;
+    node.hdd_bytes_total = hdd_shot.hdd_bytes_total;
+    node.hdd_bytes_free = hdd_shot.hdd_bytes_free;
+    node.net_bytes_recv = bytes_recv / ts_diff;
+    node.net_bytes_send = bytes_send / ts_diff;
+    node.uptime = sshot.uptime;
+    node.interfaces = service::GetInterfacesRates(node_stats_->prev_nshot, next_nshot, ts_diff);
+    node.disks = disks;
+    metrics_->SetNode(node);
+  }
+  if (stats_history_) {
+    const double node_values[StatsHistory::NODE_METRICS_COUNT] = {
+        cpu_load, static_cast<double>(node_stats_->gpu_load),
+        static_cast<double>(mem_shot.ram_bytes_total - mem_shot.ram_bytes_free),
+        static_cast<double>(bytes_recv / ts_diff), static_cast<double>(bytes_send / ts_diff)};
+    stats_history_->AddNode(current_time, node_values);
+  }
+  node_stats_->prev_nshot = next_nshot;
+  SetGpuDevices(&stat);
+  SetCapacity(&stat, cpu_load, bytes_send / ts_diff, disk_written);
+  if (segment_cache_) {
+    const SegmentCache::Stats cache = segment_cache_->GetStats();
+    stat.SetSegmentCache(
+        service::SegmentCacheInfo(cache.bytes, cache.entries, cache.hits, cache.misses, cache.served_bytes));
+  }
+  stat.SetStartup(service::StartupInfo(startup_stats_->GetCount(), startup_stats_->GetPercentile(0.5),
+                                       startup_stats_->GetPercentile(0.9), startup_stats_->GetPercentile(0.99)));
 
   std::string node_stats;
   if (expiration_time != 0) {
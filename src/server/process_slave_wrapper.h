@@ -14,13 +14,18 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <common/file_system/path.h>
 #include <common/libev/io_loop_observer.h>
 #include <common/net/types.h>
 #include <common/threads/ts_queue.h>
+#include <common/uri/url.h>
 
 #include <fastotv/protocol/protocol.h>
 #include <fastotv/protocol/types.h>
@@ -30,17 +35,49 @@
 
 #include "server/base/ihttp_requests_observer.h"
 #include "server/config.h"
+#include "server/job_queue.h"
 #include "server/links_holder_ts.h"
 
 namespace fastocloud {
 namespace server {
 
 class Child;
+class ChildStream;
 class ProtocoledDaemonClient;
+class Zygote;
+class StatisticBatch;
+class MetricsRegistry;
+class StreamCgroups;
+class SegmentCache;
+class FileExpirer;
+class OutputTrash;
+class CpuAffinityPool;
+class AdmissionControl;
+class StartupStats;
+class StreamsStatus;
+class StatsHistory;
+class CodsWarmPool;
+class ConfigWorkers;
+class FileUploader;
+class InferencePool;
+class HlsRetention;
+class PacketIngest;
+class StreamWorkerPool;
+namespace gpu_stats {
+class EncoderPool;
+}
+namespace service {
+class ServerInfo;
+}
 
 class ProcessSlaveWrapper : public common::libev::IoLoopObserver, public server::base::IHttpRequestsObserver {
  public:
-  enum { node_stats_send_seconds = 10, ping_timeout_clients_seconds = 60, cleanup_seconds = 3 };
+  enum {
+    node_stats_send_seconds = 10,
+    ping_timeout_clients_seconds = 60,
+    cleanup_seconds = 3,
+    flush_clients_seconds = 1
+  };
   typedef StreamConfig serialized_stream_t;
   typedef fastotv::protocol::protocol_client_t stream_client_t;
 
@@ -84,13 +121,42 @@ class ProcessSlaveWrapper : public common::libev::IoLoopObserver, public server:
 
  private:
   Child* FindChildByID(fastotv::stream_id_t cid) const;
-  void BroadcastClients(const fastotv::protocol::request_t& req);
+  void BroadcastClients(const fastotv::protocol::request_t& req, const std::string& key);  // empty key never replaced
 
   common::ErrnoError DaemonDataReceived(ProtocoledDaemonClient* dclient) WARN_UNUSED_RESULT;
   common::ErrnoError StreamDataReceived(stream_client_t* pclient) WARN_UNUSED_RESULT;
 
   common::ErrnoError CreateChildStream(const serialized_stream_t& config_args);
+  // validated config of not running stream
+  common::ErrnoError PrepareChildStream(const serialized_stream_t& config_args, StreamInfo* sha);
+  common::ErrnoError SpawnChildStream(const serialized_stream_t& config_args, const StreamInfo& sha);
+  // thread safe, called by config workers
+  static common::ErrnoError ValidateStreamConfig(const serialized_stream_t& config_args,
+                                                 bool check_folders,
+                                                 StreamInfo* sha);
+  static common::ErrnoError ParseStartInfo(const std::string& params,
+                                           serialized_stream_t* config_args,
+                                           StreamInfo* sha);
+  static common::ErrnoError MakeStreamExistError(fastotv::stream_id_t sid);
   common::ErrnoError CreateChildStreamImpl(const serialized_stream_t& config_args, const StreamInfo& sha);
+  bool IsHostedStream(const serialized_stream_t& config_args, const StreamInfo& sha) const;  // relay, radio or load
+  static bool IsLoadStream(const StreamInfo& sha);  // encode of load:// input
+  // nullptr if stream runs in own process, posix only
+  Zygote* GetStreamHost(const serialized_stream_t& config_args, const StreamInfo& sha);
+  // posix only, stopping service parks command pipes in streams, next one claims them from registry
+  bool ParkChildStream(ChildStream* channel);  // false if stream can't outlive service
+  void ParkChildStreams();
+  void AdoptChildStreams();
+  // encoder sessions, cpu cores, admission and packet ingest of adopted stream reserved again
+  // before requests are accepted
+  void RestoreChildStreamResources(const serialized_stream_t& config_args, const StreamInfo& sha);
+  void FinishChildStream(ChildStream* channel, int status, int signal);
+  bool MakeOfflineJob(const serialized_stream_t& config_args, const StreamInfo& sha, JobQueue::Job* job) const;
+  void ScheduleJobs();  // queued jobs started, running ones paused or resumed by live load
+  // posix only, process of job stopped or continued by signal, false if not own process
+  bool SignalJob(fastotv::stream_id_t sid, bool pause);
+  void TrackHlsOutputs(const serialized_stream_t& config_args, const StreamInfo& sha);
+  void UpdateHlsRetention();  // changed retention sent to children as live config updates
   common::ErrnoError StopChildStream(const serialized_stream_t& config_args);
   common::ErrnoError StopChildStreamImpl(fastotv::stream_id_t sid);
 
@@ -111,10 +177,24 @@ class ProcessSlaveWrapper : public common::libev::IoLoopObserver, public server:
                                                    const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientRestartStream(ProtocoledDaemonClient* dclient,
                                                       const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientUpdateStream(ProtocoledDaemonClient* dclient,
+                                                     const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientStartStreams(ProtocoledDaemonClient* dclient,
+                                                     const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientStopStreams(ProtocoledDaemonClient* dclient,
+                                                    const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientRestartStreams(ProtocoledDaemonClient* dclient,
+                                                       const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientGetLogStream(ProtocoledDaemonClient* dclient,
                                                      const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientGetPipelineStream(ProtocoledDaemonClient* dclient,
                                                           const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientProfileStream(ProtocoledDaemonClient* dclient,
+                                                      const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientGetProfileStream(ProtocoledDaemonClient* dclient,
+                                                         const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientUnmuteStream(ProtocoledDaemonClient* dclient,
+                                                     const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
 
   // service
   common::ErrnoError HandleRequestClientPrepareService(ProtocoledDaemonClient* dclient,
@@ -127,6 +207,12 @@ class ProcessSlaveWrapper : public common::libev::IoLoopObserver, public server:
                                                     const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientGetLogService(ProtocoledDaemonClient* dclient,
                                                       const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientStreamsStatusService(ProtocoledDaemonClient* dclient,
+                                                             const fastotv::protocol::request_t* req)
+      WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestClientStatsHistoryService(ProtocoledDaemonClient* dclient,
+                                                            const fastotv::protocol::request_t* req)
+      WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestClientStopService(ProtocoledDaemonClient* dclient,
                                                     const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
 
@@ -134,7 +220,24 @@ class ProcessSlaveWrapper : public common::libev::IoLoopObserver, public server:
                                                const fastotv::protocol::response_t* resp) WARN_UNUSED_RESULT;
 
   std::string MakeServiceStats(common::time64_t expiration_time) const;
-  void AddStreamLine(const serialized_stream_t& config_args);
+  void SetGpuDevices(service::ServerInfo* stat) const;  // gpu usage attributed to streams by pid
+  // remaining resources for placement, bandwidth and disk_written in bytes per second
+  void SetCapacity(service::ServerInfo* stat, double cpu_load, uint64_t bandwidth, uint64_t disk_written) const;
+  struct StreamLine {  // vods/cods links of synced stream
+    std::string hash;  // controller config version, empty if not versioned
+    serialized_stream_t config;
+    bool cods;
+    std::vector<std::string> http_roots;
+  };
+  static StreamLine MakeStreamLine(const serialized_stream_t& config_args, const StreamInfo& sha);  // thread safe
+  void ApplyStreamLines(const std::vector<std::pair<fastotv::stream_id_t, StreamLine>>& lines);
+
+  typedef std::pair<serialized_stream_t, StreamInfo> prepared_stream_t;  // validated by config workers
+  void PostConfigTask(const std::function<void()>& task);  // runs on loop if no config workers
+  void UploadFile(const common::file_system::ascii_file_string_path& file, const common::uri::Url& url);
+  void RemoveDaemonClient(common::libev::IoClient* client);
+  void FlushClients();  // queued broadcasts of lagging clients
+  bool IsDaemonClientOnline(ProtocoledDaemonClient* dclient) const;  // not closed while task was running
 
   struct NodeStats;
 
@@ -142,6 +245,10 @@ class ProcessSlaveWrapper : public common::libev::IoLoopObserver, public server:
 
   int process_argc_;
   char** process_argv_;
+  Zygote* zygote_;
+  std::vector<Zygote*> relay_hosts_;  // relay streams as threads of shared processes
+  std::vector<Zygote*> radio_hosts_;  // audio only encode streams as threads of shared processes
+  std::vector<Zygote*> load_hosts_;   // generated load streams as threads of shared processes
 
   common::libev::IoLoop* loop_;
   // http
@@ -150,19 +257,53 @@ class ProcessSlaveWrapper : public common::libev::IoLoopObserver, public server:
   // vods (video on demand)
   common::libev::IoLoop* vods_server_;
   common::libev::IoLoopObserver* vods_handler_;
+  std::vector<common::libev::IoLoop*> vods_workers_;  // empty if vods_server_ serves clients itself
   // cods (channel on demand)
   common::libev::IoLoop* cods_server_;
   common::libev::IoLoopObserver* cods_handler_;
+  std::vector<common::libev::IoLoop*> cods_workers_;
 
   common::libev::timer_id_t ping_client_timer_;
+  std::vector<ProtocoledDaemonClient*> daemon_clients_;  // verified, receive broadcasts and pings
   common::libev::timer_id_t check_cods_vods_timer_;
   common::libev::timer_id_t check_old_files_timer_;
   common::libev::timer_id_t node_stats_timer_;
   common::libev::timer_id_t quit_cleanup_timer_;
+  common::libev::timer_id_t stats_batch_timer_;
+  common::libev::timer_id_t flush_clients_timer_;
   NodeStats* node_stats_;
+  StatisticBatch* stats_batch_;  // nullptr if batching disabled
+  MetricsRegistry* metrics_;     // served by http server, nullptr if disabled
+  StreamCgroups* cgroups_;       // nullptr if stream children not placed in cgroups
+  SegmentCache* segment_cache_;  // shared by vods and cods servers, nullptr if disabled
+  FileExpirer* file_expirer_;    // old chunks of monitored folders, nullptr if folders scanned periodically
+  OutputTrash* output_trash_;    // old vod outputs in hls folder, nullptr until service prepared or if not created
+  gpu_stats::EncoderPool* encoder_pool_;
+  CpuAffinityPool* cpu_pool_;  // nullptr if encoding streams not pinned
+  size_t streaming_cpu_;       // next cpu of pinned streaming threads
+  AdmissionControl* admission_;  // nullptr if starts not limited by node load
+  JobQueue* job_queue_;          // offline vod transcodes started by free capacity, nullptr if started on request
+  std::unordered_map<fastotv::stream_id_t, std::pair<serialized_stream_t, StreamInfo>> job_configs_;  // queued
+  HlsRetention* hls_retention_;  // segments kept by live hls outputs, nullptr if static
+  StartupStats* startup_stats_;
+  StreamsStatus* streams_status_;  // last statistic of children
+  StatsHistory* stats_history_;    // last minutes of node and children metrics, nullptr if disabled
+  CodsWarmPool* cods_warm_;  // nullptr if cods stopped after ttl
+  InferencePool* inference_pool_;  // shared deep learning models, nullptr without machine learning
+  PacketIngest* packet_ingest_;    // multicast received once for node, nullptr if streams join groups themselves
+  StreamWorkerPool* worker_pool_;  // windows prestarted stream processes, nullptr if started on request
+  ConfigWorkers* config_workers_;  // nullptr if configs validated on loop
+  FileUploader* uploader_;
+  std::string start_slots_dir_;  // lock files limiting parallel pipeline starts, empty if unlimited
+  std::string assets_dir_;       // logo pictures shared by streams, empty if kept per stream
+  std::string ingest_dir_;       // sockets of shared live inputs, empty if every stream connects upstream
+  std::string adopt_registry_;   // streams parked by stopped service, empty if streams not adopted
 
   LinksHolderTS vods_links_;
   LinksHolderTS cods_links_;
+  std::unordered_map<fastotv::stream_id_t, StreamLine> stream_lines_;  // last synced streams, loop only
+
+  std::unordered_map<fastotv::stream_id_t, Child*> children_;  // registered in loop_, by stream id
 
   std::vector<common::file_system::ascii_directory_string_path> folders_for_monitor_;
 };
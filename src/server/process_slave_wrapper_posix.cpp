@@ -19,17 +19,28 @@
 #endif
 
 #include <dlfcn.h>
+#include <signal.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
 #include <common/file_system/file_system.h>
 #include <common/file_system/string_path_utils.h>
 
+#include "base/config_fields.h"
+#include "base/stream_adoption.h"
+#include "base/stream_config_parse.h"
 #include "base/stream_info.h"
+#include "base/stream_struct_shm.h"
 
 #include "server/child_stream.h"
 #include "server/daemon/server.h"
+#include "server/stream_cgroups.h"
 #include "server/utils/utils.h"
+#include "server/zygote.h"
 
 #include "stream/stream_wrapper.h"
 
@@ -44,6 +55,60 @@
 namespace fastocloud {
 namespace server {
 
+Zygote* ProcessSlaveWrapper::GetStreamHost(const serialized_stream_t& config_args, const StreamInfo& sha) {
+  if (!IsHostedStream(config_args, sha)) {
+    return nullptr;
+  }
+
+  // radio and load pipelines differ in weight from relays, so hosts of them are filled by own limits
+  std::vector<Zygote*>* hosts = &radio_hosts_;
+  size_t limit = config_.radio_host_streams;
+  const char* kind = "Radio";
+  if (sha.type == fastotv::RELAY) {
+    hosts = &relay_hosts_;
+    limit = config_.relay_host_streams;
+    kind = "Relay";
+  } else if (IsLoadStream(sha)) {
+    hosts = &load_hosts_;
+    limit = config_.load_host_streams;
+    kind = "Load";
+  }
+  for (auto it = hosts->begin(); it != hosts->end();) {
+    if (!(*it)->IsRunning()) {
+      delete *it;
+      it = hosts->erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  std::map<long, size_t> hosted;
+  for (auto it = children_.begin(); it != children_.end(); ++it) {
+    const ChildStream* channel = static_cast<const ChildStream*>(it->second);
+    if (channel->IsHosted()) {
+      hosted[channel->GetProcessID()]++;
+    }
+  }
+
+  for (Zygote* host : *hosts) {
+    if (hosted[host->GetProcessID()] < limit) {
+      return host;
+    }
+  }
+
+  Zygote* host = new Zygote(Zygote::THREAD_STREAMS);
+  common::ErrnoError err = host->Start(process_argc_, process_argv_);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    delete host;
+    return nullptr;
+  }
+
+  INFO_LOG() << kind << " host started, pid: " << host->GetProcessID();
+  hosts->push_back(host);
+  return host;
+}
+
 common::ErrnoError ProcessSlaveWrapper::CreateChildStreamImpl(const serialized_stream_t& config_args,
                                                               const StreamInfo& sha) {
   const fastotv::stream_id_t sid = GetSid(config_args);
@@ -78,10 +143,47 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStreamImpl(const serialized_s
   }
 #endif
 
+  // stats segment should exist before stream process started
+  StreamStructShm* stats_shm = nullptr;
+  common::ErrnoError shm_err = CreateStreamShm(MakeStreamShmName(sid), &stats_shm);
+  if (shm_err) {
+    DEBUG_MSG_ERROR(shm_err, common::logging::LOG_LEVEL_WARNING);
+    stats_shm = nullptr;
+  }
+
+  const std::string new_process_name = common::MemSPrintf(STREAMER_NAME "_%s", sid);
 #if !defined(TEST)
-  pid_t pid = fork();
+  pid_t pid = 0;
+  bool spawned = false;
+  bool hosted = false;
+#if PIPE
+  Zygote* stream_host = GetStreamHost(config_args, sha);
+  if (stream_host) {
+    common::ErrnoError herr =
+        stream_host->SpawnStream(new_process_name, config_args, read_command_client, write_responce_client, &pid);
+    if (herr) {
+      DEBUG_MSG_ERROR(herr, common::logging::LOG_LEVEL_WARNING);
+    } else {
+      spawned = true;
+      hosted = true;
+    }
+  }
+  if (!spawned && zygote_ && zygote_->IsRunning()) {
+    common::ErrnoError zerr =
+        zygote_->SpawnStream(new_process_name, config_args, read_command_client, write_responce_client, &pid);
+    if (zerr) {
+      DEBUG_MSG_ERROR(zerr, common::logging::LOG_LEVEL_WARNING);
+    } else {
+      spawned = true;
+    }
+  }
+#endif
+  if (!spawned) {
+    pid = fork();
+  }
 #else
   pid_t pid = 0;
+  bool hosted = false;
 #endif
   if (pid == 0) {  // child
     typedef int (*stream_exec_t)(const char* process_name, const void* args, void* command_client);
@@ -102,7 +204,6 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStreamImpl(const serialized_s
       _exit(EXIT_FAILURE);
     }
 
-    const std::string new_process_name = common::MemSPrintf(STREAMER_NAME "_%s", sid);
     const char* new_name = new_process_name.c_str();
 #if defined(OS_LINUX)
     for (int i = 0; i < process_argc_; ++i) {
@@ -148,6 +249,10 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStreamImpl(const serialized_s
     _exit(res);
   } else if (pid < 0) {
     ERROR_LOG() << "Failed to start children!";
+    if (stats_shm) {
+      ignore_result(CloseStreamShm(stats_shm));
+      ignore_result(UnlinkStreamShm(MakeStreamShmName(sid)));
+    }
   } else {
 #if PIPE
     // close not needed pipes
@@ -169,14 +274,199 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStreamImpl(const serialized_s
     tcp::Client* client = new tcp::Client(loop_, common::net::socket_info(parent_sock));
 #endif
     client->SetName(sid);
+    if (cgroups_ && !hosted && !cgroups_->Attach(sid, pid)) {
+      WARNING_LOG() << "Stream id: " << sid << " not placed in cgroup: " << cgroups_->GetPath(sid);
+    }
     loop_->RegisterClient(client);
     ChildStream* new_channel = new ChildStream(loop_, sha);
     new_channel->SetClient(client);
+    new_channel->SetBinaryPipe(config_.pipe_binary);
+    new_channel->SetStatsShm(stats_shm);
+    new_channel->SetProcessID(pid);
+    new_channel->SetHosted(hosted);
+    new_channel->SetConfig(config_args);
     loop_->RegisterChild(new_channel, pid);
   }
 
   return common::ErrnoError();
 }
 
+bool ProcessSlaveWrapper::SignalJob(fastotv::stream_id_t sid, bool pause) {
+  ChildStream* channel = static_cast<ChildStream*>(FindChildByID(sid));
+  if (!channel || channel->IsHosted() || channel->GetProcessID() <= 0) {  // host shared with live streams
+    return false;
+  }
+
+  if (kill(static_cast<pid_t>(channel->GetProcessID()), pause ? SIGSTOP : SIGCONT) == ERROR_RESULT_VALUE) {
+    WARNING_LOG() << "Job stream id: " << sid << " not " << (pause ? "paused" : "resumed") << ", errno: " << errno;
+    return false;
+  }
+  return true;
+}
+
+bool ProcessSlaveWrapper::ParkChildStream(ChildStream* channel) {
+#if PIPE
+  std::string adopt_socket;
+  const serialized_stream_t config_args = channel->GetConfig();
+  common::Value* adopt_socket_field = config_args ? config_args->Find(ACTIVE_ADOPT_SOCKET_FIELD) : nullptr;
+  pipe::Client* client = static_cast<pipe::Client*>(channel->GetClient());
+  if (channel->IsHosted() || !client || !adopt_socket_field || !adopt_socket_field->GetAsBasicString(&adopt_socket)) {
+    return false;
+  }
+
+  common::net::socket_descr_t sock = INVALID_DESCRIPTOR;
+  common::ErrnoError err = ConnectAdoptSocket(adopt_socket, &sock);
+  if (!err) {
+    const AdoptMessage msg = {ADOPT_PARK, 0};
+    const int fds[2] = {client->GetReadFd(), client->GetWriteFd()};
+    err = SendAdoptMessage(sock, msg, fds);
+  }
+  AdoptMessage resp = {ADOPT_PARK, 0};
+  if (!err) {
+    int none[2];
+    err = ReceiveAdoptMessage(sock, &resp, none);
+  }
+  if (sock != INVALID_DESCRIPTOR) {
+    ignore_result(common::file_system::close_descriptor(sock));
+  }
+  if (!err && resp.error) {
+    err = common::make_errno_error("Stream refused to park command pipes", resp.error);
+  }
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    return false;
+  }
+  return true;
+#else
+  UNUSED(channel);
+  return false;
+#endif
+}
+
+void ProcessSlaveWrapper::ParkChildStreams() {
+  std::ofstream registry(adopt_registry_, std::ios::trunc);
+  if (!registry) {
+    WARNING_LOG() << "Can't write adopted streams registry: " << adopt_registry_ << ", streams stopped";
+  }
+
+  size_t parked = 0;
+  DaemonServer* server = static_cast<DaemonServer*>(loop_);
+  auto childs = server->GetChilds();
+  for (auto* child : childs) {
+    ChildStream* channel = static_cast<ChildStream*>(child);
+    std::string config_json;
+    if (!registry || !MakeJsonFromConfig(channel->GetConfig(), &config_json) || !ParkChildStream(channel)) {
+      ignore_result(channel->Stop());
+      continue;
+    }
+
+    registry << channel->GetProcessID() << " " << config_json << "\n";
+    const auto sid = channel->GetStreamID();
+    INFO_LOG() << "Stream parked for next service, id: " << sid << ", pid: " << channel->GetProcessID();
+    channel->Detach();
+    Child::client_t* client = channel->GetClient();
+    channel->SetClient(nullptr);
+    ignore_result(client->Close());
+    delete client;
+    loop_->UnRegisterChild(channel);
+    children_.erase(sid);
+    delete channel;
+    parked++;
+  }
+
+  INFO_LOG() << "Streams parked: " << parked;
+}
+
+void ProcessSlaveWrapper::AdoptChildStreams() {
+  if (adopt_registry_.empty() || !common::file_system::is_file_exist(adopt_registry_)) {
+    return;
+  }
+
+  std::ifstream registry(adopt_registry_);
+  std::string line;
+  size_t adopted = 0;
+  while (std::getline(registry, line)) {
+    const size_t pos = line.find(' ');
+    const long pid = pos != std::string::npos ? std::strtol(line.c_str(), nullptr, 10) : 0;
+    if (pid <= 0) {
+      continue;
+    }
+
+    serialized_stream_t config_args(MakeConfigFromJson(line.substr(pos + 1)).release());
+    StreamInfo sha;
+    std::string feedback_dir;
+    common::logging::LOG_LEVEL logs_level;
+    std::string adopt_socket;
+    common::Value* adopt_socket_field = config_args ? config_args->Find(ACTIVE_ADOPT_SOCKET_FIELD) : nullptr;
+    if (!adopt_socket_field || !adopt_socket_field->GetAsBasicString(&adopt_socket) ||
+        MakeStreamInfo(config_args, false, &sha, &feedback_dir, &logs_level)) {
+      WARNING_LOG() << "Invalid parked stream, pid: " << pid;
+      continue;
+    }
+
+    if (kill(pid, 0) == ERROR_RESULT_VALUE) {  // stopped while no service was running
+      INFO_LOG() << "Parked stream finished, id: " << sha.id;
+      continue;
+    }
+
+    common::net::socket_descr_t sock = INVALID_DESCRIPTOR;
+    int fds[2] = {INVALID_DESCRIPTOR, INVALID_DESCRIPTOR};
+    AdoptMessage resp = {ADOPT_CLAIM, 0};
+    common::ErrnoError err = ConnectAdoptSocket(adopt_socket, &sock);
+    if (!err) {
+      const AdoptMessage msg = {ADOPT_CLAIM, 0};
+      err = SendAdoptMessage(sock, msg, nullptr);
+    }
+    if (!err) {
+      err = ReceiveAdoptMessage(sock, &resp, fds);
+    }
+    if (sock != INVALID_DESCRIPTOR) {
+      ignore_result(common::file_system::close_descriptor(sock));
+    }
+    if (!err && (resp.error || fds[0] == INVALID_DESCRIPTOR || fds[1] == INVALID_DESCRIPTOR)) {
+      err = common::make_errno_error("Stream refused to hand over command pipes", resp.error ? resp.error : EINVAL);
+    }
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+      continue;
+    }
+
+    StreamStructShm* stats_shm = nullptr;
+    common::ErrnoError shm_err = OpenStreamShm(MakeStreamShmName(sha.id), &stats_shm);
+    if (shm_err) {
+      DEBUG_MSG_ERROR(shm_err, common::logging::LOG_LEVEL_WARNING);
+      stats_shm = nullptr;
+    }
+
+    bool binary_pipe = false;  // framing chosen by service which spawned stream
+    common::Value* binary_pipe_field = config_args->Find(PIPE_BINARY_FIELD);
+    if (binary_pipe_field) {
+      ignore_result(binary_pipe_field->GetAsBoolean(&binary_pipe));
+    }
+
+    pipe::Client* client = new pipe::Client(loop_, fds[0], fds[1]);
+    client->SetName(sha.id);
+    loop_->RegisterClient(client);
+    ChildStream* channel = new ChildStream(loop_, sha);
+    channel->SetClient(client);
+    channel->SetBinaryPipe(binary_pipe);
+    channel->SetStatsShm(stats_shm);
+    channel->SetProcessID(pid);
+    channel->SetConfig(config_args);
+    channel->SetAdopted(true);
+    loop_->RegisterChild(channel, pid);
+    RestoreChildStreamResources(config_args, sha);
+    INFO_LOG() << "Stream adopted, id: " << sha.id << ", pid: " << pid;
+    adopted++;
+  }
+
+  registry.close();
+  common::ErrnoError errn = common::file_system::remove_file(adopt_registry_);
+  if (errn) {
+    DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+  }
+  INFO_LOG() << "Streams adopted: " << adopted;
+}
+
 }  // namespace server
 }  // namespace fastocloud
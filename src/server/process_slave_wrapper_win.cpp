@@ -1,4 +1,4 @@
-/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
     This file is part of fastocloud.
     fastocloud is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -14,35 +14,32 @@
 
 #include "server/process_slave_wrapper.h"
 
+#include <string>
+
 #include <common/libev/io_loop.h>
 
 #include "base/stream_config_parse.h"
 
 #include "server/child_stream.h"
+#include "server/stream_cgroups.h"
+#include "server/stream_worker_pool_win.h"
 #include "server/tcp/client.h"
 #include "server/utils/utils.h"
 
 namespace fastocloud {
 namespace server {
 
-common::ErrnoError ProcessSlaveWrapper::CreateChildStreamImpl(const serialized_stream_t& config_args,
-                                                              const StreamInfo& sha) {
-  const fastotv::stream_id_t sid = GetSid(config_args);
-  common::net::socket_descr_t parent_sock;
-  common::net::socket_descr_t child_sock;
-  common::ErrnoError err = CreateSocketPair(&parent_sock, &child_sock);
-  if (err) {
-    return err;
-  }
+namespace {
 
+// stream exe started for request, core library and gstreamer loaded after it
+common::ErrnoError StartStreamProcess(common::net::socket_descr_t child_sock,
+                                      const std::string& json,
+                                      HANDLE* process,
+                                      DWORD* pid) {
   SECURITY_ATTRIBUTES sa;
   memset(&sa, 0, sizeof(sa));
   sa.nLength = sizeof(sa);
   sa.bInheritHandle = TRUE;
-  std::string json;
-  if (!MakeJsonFromConfig(config_args, &json)) {
-    return common::make_errno_error(EINTR);
-  }
 
   const size_t proto_info_len = sizeof(WSAPROTOCOL_INFO);
   const size_t allocate_memory = proto_info_len + json.size();
@@ -81,12 +78,12 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStreamImpl(const serialized_s
   if (WSADuplicateSocket(child_sock, pi.dwProcessId, &pin) != 0) {
     UnmapViewOfFile(param);
     CloseHandle(args_handle);
+    TerminateProcess(pi.hProcess, EXIT_FAILURE);
     CloseHandle(pi.hProcess);
     CloseHandle(pi.hThread);
     return common::make_errno_error(errno);
   }
 
-  closesocket(child_sock);
   memcpy(param, &pin, proto_info_len);
   memcpy(param + proto_info_len, json.c_str(), json.size());
 
@@ -104,15 +101,90 @@ common::ErrnoError ProcessSlaveWrapper::CreateChildStreamImpl(const serialized_s
     return common::make_errno_error(errno);
   }
 
+  CloseHandle(pi.hThread);
+  *process = pi.hProcess;
+  *pid = pi.dwProcessId;
+  return common::ErrnoError();
+}
+
+// prestarted worker, nullptr process if it could not take stream
+void HandOffStream(StreamWorkerPool::Worker* worker,
+                   common::net::socket_descr_t child_sock,
+                   const std::string& json,
+                   HANDLE* process,
+                   DWORD* pid) {
+  WSAPROTOCOL_INFO pin;
+  if (WSADuplicateSocket(child_sock, worker->pid, &pin) != 0) {
+    StreamWorkerPool::Terminate(worker);
+    return;
+  }
+
+  std::string params(reinterpret_cast<const char*>(&pin), sizeof(pin));
+  params += json;
+  common::ErrnoError err = StreamWorkerPool::HandOff(worker, params);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    StreamWorkerPool::Terminate(worker);
+    return;
+  }
+
+  *process = worker->process;
+  *pid = worker->pid;
+}
+
+}  // namespace
+
+common::ErrnoError ProcessSlaveWrapper::CreateChildStreamImpl(const serialized_stream_t& config_args,
+                                                              const StreamInfo& sha) {
+  const fastotv::stream_id_t sid = GetSid(config_args);
+  std::string json;
+  if (!MakeJsonFromConfig(config_args, &json)) {
+    return common::make_errno_error(EINTR);
+  }
+
+  common::net::socket_descr_t parent_sock;
+  common::net::socket_descr_t child_sock;
+  common::ErrnoError err = CreateSocketPair(&parent_sock, &child_sock);
+  if (err) {
+    return err;
+  }
+
+  HANDLE process = nullptr;
+  DWORD pid = 0;
+  StreamWorkerPool::Worker worker;
+  if (worker_pool_ && worker_pool_->Take(&worker)) {
+    HandOffStream(&worker, child_sock, json, &process, &pid);
+    worker_pool_->Fill();  // replacement initializes while stream runs
+  }
+
+  if (!process) {
+    err = StartStreamProcess(child_sock, json, &process, &pid);
+    if (err) {
+      closesocket(child_sock);
+      closesocket(parent_sock);
+      return err;
+    }
+  }
+  closesocket(child_sock);
+
+  if (cgroups_ && !cgroups_->Attach(sid, pid)) {
+    WARNING_LOG() << "Stream id: " << sid << " not placed in job: " << cgroups_->GetPath(sid);
+  }
+
   tcp::Client* sock_client = new tcp::Client(loop_, common::net::socket_info(parent_sock));
   sock_client->SetName(sid);
   loop_->RegisterClient(sock_client);
   ChildStream* child = new ChildStream(loop_, sha);
   child->SetClient(sock_client);
-  loop_->RegisterChild(child, pi.hProcess);
-  CloseHandle(pi.hThread);
+  loop_->RegisterChild(child, process);
   return common::ErrnoError();
 }
 
+bool ProcessSlaveWrapper::SignalJob(fastotv::stream_id_t sid, bool pause) {
+  UNUSED(sid);
+  UNUSED(pause);
+  return false;  // jobs keep running, only queued by capacity
+}
+
 }  // namespace server
 }  // namespace fastocloud
@@ -0,0 +1,92 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/segment_cache.h"
+
+namespace fastocloud {
+namespace server {
+
+SegmentCache::Stats::Stats() : bytes(0), entries(0), hits(0), misses(0), served_bytes(0) {}
+
+SegmentCache::SegmentCache(size_t max_bytes) : max_bytes_(max_bytes), mutex_(), lru_(), index_(), stats_() {}
+
+bool SegmentCache::IsCacheable(size_t size) const {
+  return size != 0 && size <= max_bytes_ / 4;
+}
+
+SegmentCache::data_t SegmentCache::Find(const std::string& path, time_t mtime, size_t size) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = index_.find(path);
+  if (it == index_.end()) {
+    stats_.misses++;
+    return nullptr;
+  }
+
+  entries_t::iterator entry = it->second;
+  if (entry->mtime != mtime || entry->data->size() != size) {  // file rotated
+    RemoveLocked(it);
+    stats_.misses++;
+    return nullptr;
+  }
+
+  lru_.splice(lru_.begin(), lru_, entry);
+  stats_.hits++;
+  stats_.served_bytes += size;
+  return entry->data;
+}
+
+void SegmentCache::Insert(const std::string& path, time_t mtime, data_t data) {
+  if (!data || !IsCacheable(data->size())) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = index_.find(path);
+  if (it != index_.end()) {
+    RemoveLocked(it);
+  }
+
+  while (!lru_.empty() && stats_.bytes + data->size() > max_bytes_) {
+    RemoveLocked(index_.find(lru_.back().path));
+  }
+
+  stats_.bytes += data->size();
+  stats_.entries++;
+  lru_.push_front({path, mtime, data});
+  index_[path] = lru_.begin();
+}
+
+void SegmentCache::Remove(const std::string& path) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = index_.find(path);
+  if (it != index_.end()) {
+    RemoveLocked(it);
+  }
+}
+
+SegmentCache::Stats SegmentCache::GetStats() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void SegmentCache::RemoveLocked(std::unordered_map<std::string, entries_t::iterator>::iterator it) {
+  entries_t::iterator entry = it->second;
+  stats_.bytes -= entry->data->size();
+  stats_.entries--;
+  lru_.erase(entry);
+  index_.erase(it);
+}
+
+}  // namespace server
+}  // namespace fastocloud
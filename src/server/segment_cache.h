@@ -0,0 +1,76 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <time.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace server {
+
+// bounded lru cache of hls segments shared by http servers threads
+// entry valid while file keeps same modification time and size
+class SegmentCache {
+ public:
+  typedef std::shared_ptr<const std::string> data_t;
+
+  struct Stats {
+    Stats();
+
+    size_t bytes;
+    size_t entries;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t served_bytes;
+  };
+
+  explicit SegmentCache(size_t max_bytes);
+
+  bool IsCacheable(size_t size) const;
+
+  data_t Find(const std::string& path, time_t mtime, size_t size);  // nullptr if miss
+  void Insert(const std::string& path, time_t mtime, data_t data);
+  void Remove(const std::string& path);
+
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    std::string path;
+    time_t mtime;
+    data_t data;
+  };
+  typedef std::list<Entry> entries_t;
+
+  void RemoveLocked(std::unordered_map<std::string, entries_t::iterator>::iterator it);
+
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  entries_t lru_;  // front most recent
+  std::unordered_map<std::string, entries_t::iterator> index_;
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentCache);
+};
+
+}  // namespace server
+}  // namespace fastocloud
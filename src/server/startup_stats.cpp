@@ -0,0 +1,62 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/startup_stats.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace fastocloud {
+namespace server {
+
+StartupStats::StartupStats() : recorded_(), samples_() {}
+
+void StartupStats::Record(fastotv::stream_id_t sid, const startup_timing_t& startup) {
+  const fastotv::timestamp_t request_ts = startup[REQUEST_STARTUP_STAGE];
+  const fastotv::timestamp_t first_output_ts = startup[FIRST_OUTPUT_STARTUP_STAGE];
+  if (request_ts == 0 || first_output_ts == 0 || first_output_ts < request_ts) {
+    return;
+  }
+
+  if (!recorded_.insert(sid).second) {
+    return;
+  }
+
+  samples_.push_back(first_output_ts - request_ts);
+  if (samples_.size() > window_size) {
+    samples_.pop_front();
+  }
+}
+
+void StartupStats::Release(fastotv::stream_id_t sid) {
+  recorded_.erase(sid);
+}
+
+size_t StartupStats::GetCount() const {
+  return samples_.size();
+}
+
+fastotv::timestamp_t StartupStats::GetPercentile(double rank) const {
+  if (samples_.empty()) {
+    return 0;
+  }
+
+  std::vector<fastotv::timestamp_t> sorted(samples_.begin(), samples_.end());
+  const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(rank * (sorted.size() - 1) + 0.5));
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+  return sorted[index];
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,49 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <set>
+
+#include <common/macros.h>
+
+#include "base/stream_struct.h"
+
+namespace fastocloud {
+namespace server {
+
+// time to first frame of recent stream starts, from start request to first output buffer
+class StartupStats {
+ public:
+  enum { window_size = 256 };
+
+  StartupStats();
+
+  // counted once per stream run, ignored until first output is reached
+  void Record(fastotv::stream_id_t sid, const startup_timing_t& startup);
+  void Release(fastotv::stream_id_t sid);  // stream quit, next start counted again
+
+  size_t GetCount() const;                                // samples in window
+  fastotv::timestamp_t GetPercentile(double rank) const;  // rank in [0, 1], msec, 0 if no samples
+
+ private:
+  std::set<fastotv::stream_id_t> recorded_;
+  std::deque<fastotv::timestamp_t> samples_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupStats);
+};
+
+}  // namespace server
+}  // namespace fastocloud
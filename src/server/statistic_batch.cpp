@@ -0,0 +1,122 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/statistic_batch.h"
+
+#include <string.h>
+
+#define STATISTIC_BATCH_FULL_FIELD "full"
+#define STATISTIC_BATCH_STREAMS_FIELD "streams"
+#define STATISTIC_BATCH_ID_FIELD "id"
+
+namespace fastocloud {
+namespace server {
+
+namespace {
+bool IsSameJson(json_object* left, json_object* right) {
+  return strcmp(json_object_to_json_string_ext(left, JSON_C_TO_STRING_PLAIN),
+                json_object_to_json_string_ext(right, JSON_C_TO_STRING_PLAIN)) == 0;
+}
+
+// new object without fields equal to prev, id always present
+json_object* MakeDelta(json_object* prev, json_object* cur) {
+  json_object* delta = json_object_new_object();
+  json_object_object_foreach(cur, key, val) {
+    json_object* prev_val = nullptr;
+    if (strcmp(key, STATISTIC_BATCH_ID_FIELD) != 0 && json_object_object_get_ex(prev, key, &prev_val) &&
+        IsSameJson(prev_val, val)) {
+      continue;
+    }
+    json_object_object_add(delta, key, json_object_get(val));
+  }
+  return delta;
+}
+}  // namespace
+
+StatisticBatch::StatisticBatch(bool delta) : delta_(delta), batches_count_(0), pending_(), sent_() {}
+
+StatisticBatch::~StatisticBatch() {
+  for (auto it = sent_.begin(); it != sent_.end(); ++it) {
+    json_object_put(it->second);
+  }
+  sent_.clear();
+}
+
+void StatisticBatch::Add(const StatisticInfo& stat) {
+  const fastotv::stream_id_t sid = stat.GetStreamStruct().id;
+  auto it = pending_.find(sid);
+  if (it != pending_.end()) {
+    it->second = stat;
+    return;
+  }
+
+  pending_.insert(std::make_pair(sid, stat));
+}
+
+void StatisticBatch::Remove(fastotv::stream_id_t sid) {
+  pending_.erase(sid);
+  auto it = sent_.find(sid);
+  if (it != sent_.end()) {
+    json_object_put(it->second);
+    sent_.erase(it);
+  }
+}
+
+bool StatisticBatch::IsEmpty() const {
+  return pending_.empty();
+}
+
+common::Error StatisticBatch::Flush(std::string* batch_json) {
+  if (!batch_json) {
+    return common::make_error_inval();
+  }
+
+  const bool full = !delta_ || batches_count_ % full_batch_period == 0;
+  json_object* jstreams = json_object_new_array();
+  for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+    json_object* jstat = nullptr;
+    common::Error err = it->second.Serialize(&jstat);
+    if (err) {
+      continue;
+    }
+
+    if (!delta_) {
+      json_object_array_add(jstreams, jstat);
+      continue;
+    }
+
+    auto sent = sent_.find(it->first);
+    if (sent == sent_.end()) {
+      json_object_array_add(jstreams, json_object_get(jstat));
+      sent_.insert(std::make_pair(it->first, jstat));
+      continue;
+    }
+
+    json_object_array_add(jstreams, full ? json_object_get(jstat) : MakeDelta(sent->second, jstat));
+    json_object_put(sent->second);
+    sent->second = jstat;
+  }
+  pending_.clear();
+  batches_count_++;
+
+  json_object* jbatch = json_object_new_object();
+  json_object_object_add(jbatch, STATISTIC_BATCH_FULL_FIELD, json_object_new_boolean(full));
+  json_object_object_add(jbatch, STATISTIC_BATCH_STREAMS_FIELD, jstreams);
+  *batch_json = json_object_to_json_string_ext(jbatch, JSON_C_TO_STRING_PLAIN);
+  json_object_put(jbatch);
+  return common::Error();
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,52 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <common/error.h>
+
+#include "stream_commands/commands_info/statistic_info.h"
+
+namespace fastocloud {
+namespace server {
+
+// coalesces statistic of streams between flushes, latest statistic of stream wins
+class StatisticBatch {
+ public:
+  enum { full_batch_period = 10 };  // in delta mode every N-th batch is full
+
+  explicit StatisticBatch(bool delta);
+  ~StatisticBatch();
+
+  void Add(const StatisticInfo& stat);
+  void Remove(fastotv::stream_id_t sid);  // stream finished
+  bool IsEmpty() const;
+
+  // {"full": true, "streams": [...]}, in delta mode fields of stream equal to previous batch are omitted
+  common::Error Flush(std::string* batch_json) WARN_UNUSED_RESULT;
+
+ private:
+  const bool delta_;
+  size_t batches_count_;
+  std::map<fastotv::stream_id_t, StatisticInfo> pending_;
+  std::map<fastotv::stream_id_t, json_object*> sent_;
+
+  DISALLOW_COPY_AND_ASSIGN(StatisticBatch);
+};
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,213 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/stats_history.h"
+
+#include <json-c/json_object.h>
+
+#include <algorithm>
+
+#define STATS_HISTORY_NODE_FIELD "node"
+#define STATS_HISTORY_STREAMS_FIELD "streams"
+#define STATS_HISTORY_ID_FIELD "id"
+#define STATS_HISTORY_TIMESTAMPS_FIELD "timestamps"
+
+namespace fastocloud {
+namespace server {
+
+namespace {
+const char* const kStreamMetricNames[] = {"input_bps", "output_bps", "cpu", "rss"};
+const char* const kNodeMetricNames[] = {"cpu", "gpu", "ram_used", "net_recv", "net_send"};
+}  // namespace
+
+StatsHistory::Ring::Ring(size_t capacity, size_t metrics)
+    : capacity_(capacity),
+      metrics_(metrics),
+      head_(0),
+      size_(0),
+      merged_(0),
+      timestamps_(capacity),
+      values_(capacity * metrics) {}
+
+void StatsHistory::Ring::Push(fastotv::timestamp_t ts, const double* values, fastotv::timestamp_t resolution_msec) {
+  if (!capacity_) {
+    return;
+  }
+
+  if (size_) {
+    const size_t newest = GetIndex(size_ - 1);
+    if (ts / resolution_msec == timestamps_[newest] / resolution_msec) {  // same slot, running average
+      merged_++;
+      for (size_t i = 0; i < metrics_; ++i) {
+        float* value = &values_[i * capacity_ + newest];
+        *value += (values[i] - *value) / merged_;
+      }
+      timestamps_[newest] = ts;
+      return;
+    }
+  }
+
+  timestamps_[head_] = ts;
+  for (size_t i = 0; i < metrics_; ++i) {
+    values_[i * capacity_ + head_] = values[i];
+  }
+  head_ = (head_ + 1) % capacity_;
+  size_ = std::min(size_ + 1, capacity_);
+  merged_ = 1;
+}
+
+size_t StatsHistory::Ring::GetSize() const {
+  return size_;
+}
+
+fastotv::timestamp_t StatsHistory::Ring::GetTimestamp(size_t pos) const {
+  return timestamps_[GetIndex(pos)];
+}
+
+float StatsHistory::Ring::GetValue(size_t metric, size_t pos) const {
+  return values_[metric * capacity_ + GetIndex(pos)];
+}
+
+size_t StatsHistory::Ring::GetMetricsCount() const {
+  return metrics_;
+}
+
+size_t StatsHistory::Ring::GetIndex(size_t pos) const {
+  return (head_ + capacity_ - size_ + pos) % capacity_;
+}
+
+namespace {
+template <typename Ring>
+json_object* MakeRingJson(const Ring& ring,
+                          const char* const* names,
+                          fastotv::timestamp_t since,
+                          fastotv::timestamp_t step_msec) {
+  const size_t metrics = ring.GetMetricsCount();
+  json_object* jtimestamps = json_object_new_array();
+  std::vector<json_object*> jvalues(metrics);
+  for (size_t i = 0; i < metrics; ++i) {
+    jvalues[i] = json_object_new_array();
+  }
+
+  std::vector<double> sums(metrics);
+  size_t count = 0;
+  fastotv::timestamp_t bucket = 0;
+  auto flush = [&]() {
+    if (!count) {
+      return;
+    }
+    json_object_array_add(jtimestamps, json_object_new_int64(bucket * step_msec));
+    for (size_t i = 0; i < metrics; ++i) {
+      json_object_array_add(jvalues[i], json_object_new_double(sums[i] / count));
+      sums[i] = 0;
+    }
+    count = 0;
+  };
+
+  for (size_t pos = 0; pos < ring.GetSize(); ++pos) {
+    const fastotv::timestamp_t ts = ring.GetTimestamp(pos);
+    if (ts <= since) {
+      continue;
+    }
+    if (count && ts / step_msec != bucket) {
+      flush();
+    }
+    bucket = ts / step_msec;
+    for (size_t i = 0; i < metrics; ++i) {
+      sums[i] += ring.GetValue(i, pos);
+    }
+    count++;
+  }
+  flush();
+
+  json_object* jring = json_object_new_object();
+  json_object_object_add(jring, STATS_HISTORY_TIMESTAMPS_FIELD, jtimestamps);
+  for (size_t i = 0; i < metrics; ++i) {
+    json_object_object_add(jring, names[i], jvalues[i]);
+  }
+  return jring;
+}
+}  // namespace
+
+StatsHistory::StatsHistory(time_t span_sec, time_t resolution_sec)
+    : capacity_(resolution_sec > 0 && span_sec > 0 ? span_sec / resolution_sec : 0),
+      resolution_msec_(std::max<time_t>(resolution_sec, 1) * 1000),
+      mutex_(),
+      node_(capacity_, NODE_METRICS_COUNT),
+      streams_() {}
+
+void StatsHistory::AddNode(fastotv::timestamp_t ts, const double (&values)[NODE_METRICS_COUNT]) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  node_.Push(ts, values, resolution_msec_);
+}
+
+void StatsHistory::AddStream(const StatisticInfo& stat) {
+  const StreamStruct& str = stat.GetStreamStruct();
+  double values[STREAM_METRICS_COUNT] = {0, 0, stat.GetCpuLoad(), static_cast<double>(stat.GetRssBytes())};
+  for (const auto& input : str.input) {
+    values[STREAM_INPUT_BPS] += input.GetBps();
+  }
+  for (const auto& output : str.output) {
+    values[STREAM_OUTPUT_BPS] += output.GetBps();
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = streams_.find(str.id);
+  if (it == streams_.end()) {
+    it = streams_.insert(std::make_pair(str.id, Ring(capacity_, STREAM_METRICS_COUNT))).first;
+  }
+  it->second.Push(stat.GetTimestamp(), values, resolution_msec_);
+}
+
+void StatsHistory::RemoveStream(fastotv::stream_id_t sid) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  streams_.erase(sid);
+}
+
+size_t StatsHistory::GetCapacity() const {
+  return capacity_;
+}
+
+std::string StatsHistory::Serialize(const streams_t& ids, fastotv::timestamp_t since, time_t step_sec) const {
+  const fastotv::timestamp_t step_msec = std::max<fastotv::timestamp_t>(step_sec * 1000, resolution_msec_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  json_object* jstreams = json_object_new_array();
+  auto add_stream = [&](const fastotv::stream_id_t& sid, const Ring& ring) {
+    json_object* jstream = MakeRingJson(ring, kStreamMetricNames, since, step_msec);
+    json_object_object_add(jstream, STATS_HISTORY_ID_FIELD, json_object_new_string(sid.c_str()));
+    json_object_array_add(jstreams, jstream);
+  };
+  if (ids.empty()) {
+    for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+      add_stream(it->first, it->second);
+    }
+  } else {
+    for (const fastotv::stream_id_t& sid : ids) {
+      auto it = streams_.find(sid);
+      if (it != streams_.end()) {
+        add_stream(it->first, it->second);
+      }
+    }
+  }
+
+  json_object* jresult = json_object_new_object();
+  json_object_object_add(jresult, STATS_HISTORY_NODE_FIELD, MakeRingJson(node_, kNodeMetricNames, since, step_msec));
+  json_object_object_add(jresult, STATS_HISTORY_STREAMS_FIELD, jstreams);
+  const std::string result = json_object_to_json_string_ext(jresult, JSON_C_TO_STRING_PLAIN);
+  json_object_put(jresult);
+  return result;
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,85 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/macros.h>
+
+#include "stream_commands/commands_info/statistic_info.h"
+
+namespace fastocloud {
+namespace server {
+
+// last minutes of node and streams metrics in fixed rings, controller reads them instead of storing every sample
+// updated from daemon loop, serialized from daemon loop and http thread
+class StatsHistory {
+ public:
+  enum StreamMetric { STREAM_INPUT_BPS = 0, STREAM_OUTPUT_BPS, STREAM_CPU, STREAM_RSS, STREAM_METRICS_COUNT };
+  enum NodeMetric { NODE_CPU = 0, NODE_GPU, NODE_RAM_USED, NODE_NET_RECV, NODE_NET_SEND, NODE_METRICS_COUNT };
+
+  typedef std::vector<fastotv::stream_id_t> streams_t;
+
+  // samples of one resolution slot averaged into one, span / resolution samples per ring
+  StatsHistory(time_t span_sec, time_t resolution_sec);
+
+  void AddNode(fastotv::timestamp_t ts, const double (&values)[NODE_METRICS_COUNT]);
+  void AddStream(const StatisticInfo& stat);
+  void RemoveStream(fastotv::stream_id_t sid);  // stream finished
+
+  size_t GetCapacity() const;
+
+  // {"node": {"timestamps": [...], "cpu": [...], ...}, "streams": [{"id": "...", "timestamps": [...], ...}]}
+  // samples after since (utc msec) averaged over step seconds, resolution if less, empty ids - all streams
+  std::string Serialize(const streams_t& ids, fastotv::timestamp_t since, time_t step_sec) const;
+
+ private:
+  // struct of arrays, timestamps and one array per metric share write position
+  class Ring {
+   public:
+    Ring(size_t capacity, size_t metrics);
+
+    void Push(fastotv::timestamp_t ts, const double* values, fastotv::timestamp_t resolution_msec);
+    size_t GetSize() const;
+    fastotv::timestamp_t GetTimestamp(size_t pos) const;  // oldest first
+    float GetValue(size_t metric, size_t pos) const;
+    size_t GetMetricsCount() const;
+
+   private:
+    size_t GetIndex(size_t pos) const;
+
+    size_t capacity_;
+    size_t metrics_;
+    size_t head_;  // next write
+    size_t size_;
+    uint32_t merged_;  // samples averaged into newest
+    std::vector<fastotv::timestamp_t> timestamps_;
+    std::vector<float> values_;  // metric major
+  };
+
+  const size_t capacity_;
+  const fastotv::timestamp_t resolution_msec_;
+  mutable std::mutex mutex_;
+  Ring node_;
+  std::map<fastotv::stream_id_t, Ring> streams_;
+
+  DISALLOW_COPY_AND_ASSIGN(StatsHistory);
+};
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,203 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/stream_cgroups.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include <common/convert2string.h>
+#include <common/logger.h>
+#include <common/sprintf.h>
+
+#define CGROUP_CONTROLLERS_FILE "cgroup.controllers"
+#define CGROUP_SUBTREE_CONTROL_FILE "cgroup.subtree_control"
+#define CGROUP_PROCS_FILE "cgroup.procs"
+#define CGROUP_CPU_MAX_FILE "cpu.max"
+#define CGROUP_CPU_STAT_FILE "cpu.stat"
+#define CGROUP_CPU_WEIGHT_FILE "cpu.weight"
+#define CGROUP_IO_WEIGHT_FILE "io.weight"
+#define CGROUP_MEMORY_MAX_FILE "memory.max"
+#define CGROUP_MEMORY_CURRENT_FILE "memory.current"
+#define CGROUP_IO_STAT_FILE "io.stat"
+
+#define CGROUP_CPU_PERIOD_USEC 100000
+
+namespace {
+
+const char* const kControllers[] = {"cpu", "memory", "io"};
+
+bool WriteValue(const std::string& path, const std::string& value) {
+  std::ofstream file(path, std::ios::out | std::ios::app);  // cgroup files can't be truncated
+  if (!file.is_open()) {
+    return false;
+  }
+  file << value;
+  file.close();
+  return !file.fail();
+}
+
+bool ReadValue(const std::string& path, uint64_t* value) {
+  std::ifstream file(path);
+  return file.is_open() && static_cast<bool>(file >> *value);
+}
+
+// "8:0 rbytes=1 wbytes=2 rios=3 ..." line per device
+bool ReadIoStat(const std::string& path, uint64_t* read_bytes, uint64_t* write_bytes) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  uint64_t rbytes = 0, wbytes = 0;
+  std::string token;
+  while (file >> token) {
+    uint64_t* counter = nullptr;
+    size_t prefix = 0;
+    if (token.compare(0, 7, "rbytes=") == 0) {
+      counter = &rbytes;
+      prefix = 7;
+    } else if (token.compare(0, 7, "wbytes=") == 0) {
+      counter = &wbytes;
+      prefix = 7;
+    } else {
+      continue;
+    }
+    *counter += strtoull(token.c_str() + prefix, nullptr, 10);
+  }
+  *read_bytes = rbytes;
+  *write_bytes = wbytes;
+  return true;
+}
+
+bool ReadCpuStat(const std::string& path, uint64_t* usage_usec) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::string key;
+  uint64_t value;
+  while (file >> key >> value) {
+    if (key == "usage_usec") {
+      *usage_usec = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+namespace fastocloud {
+namespace server {
+
+StreamCgroups::Stats::Stats() : cpu_usec(0), memory_bytes(0), io_read_bytes(0), io_write_bytes(0) {}
+
+StreamCgroups::StreamCgroups(const std::string& root, int cpu_limit, int memory_limit)
+    : root_(root), cpu_limit_(cpu_limit), memory_limit_(memory_limit) {}
+
+bool StreamCgroups::Init() {
+#if defined(OS_LINUX)
+  if (root_.empty() || (mkdir(root_.c_str(), 0755) != 0 && errno != EEXIST)) {
+    return false;
+  }
+
+  const std::string controllers_path = root_ + "/" CGROUP_CONTROLLERS_FILE;
+  if (access(controllers_path.c_str(), R_OK) != 0 || access(root_.c_str(), W_OK) != 0) {
+    return false;
+  }
+
+  // not available controllers only lose accounting, streams still separated
+  const std::string subtree_path = root_ + "/" CGROUP_SUBTREE_CONTROL_FILE;
+  for (const char* controller : kControllers) {
+    if (!WriteValue(subtree_path, std::string("+") + controller)) {
+      WARNING_LOG() << "Cgroup controller " << controller << " not enabled in " << root_;
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::string StreamCgroups::GetPath(fastotv::stream_id_t sid) const {
+  std::string name = "stream_";
+  for (char c : sid) {
+    const bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+                         c == '-';
+    name += allowed ? c : '_';
+  }
+  return root_ + "/" + name;
+}
+
+bool StreamCgroups::Create(fastotv::stream_id_t sid, int weight) {
+  const std::string path = GetPath(sid);
+  if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {  // left by crashed daemon reused
+    return false;
+  }
+
+  if (cpu_limit_ > 0) {
+    const std::string cpu_max =
+        common::MemSPrintf("%d %d", cpu_limit_ * CGROUP_CPU_PERIOD_USEC / 100, CGROUP_CPU_PERIOD_USEC);
+    if (!WriteValue(path + "/" CGROUP_CPU_MAX_FILE, cpu_max)) {
+      WARNING_LOG() << "Cgroup cpu limit not applied, stream id: " << sid;
+    }
+  }
+  if (memory_limit_ > 0) {
+    const std::string memory_max = common::ConvertToString(static_cast<uint64_t>(memory_limit_) * 1024 * 1024);
+    if (!WriteValue(path + "/" CGROUP_MEMORY_MAX_FILE, memory_max)) {
+      WARNING_LOG() << "Cgroup memory limit not applied, stream id: " << sid;
+    }
+  }
+  if (weight > 0) {  // share of contended cpu and disk among siblings
+    const std::string weight_str = common::ConvertToString(weight);
+    if (!WriteValue(path + "/" CGROUP_CPU_WEIGHT_FILE, weight_str) ||
+        !WriteValue(path + "/" CGROUP_IO_WEIGHT_FILE, "default " + weight_str)) {
+      WARNING_LOG() << "Cgroup weight not applied, stream id: " << sid;
+    }
+  }
+  return true;
+}
+
+bool StreamCgroups::Attach(fastotv::stream_id_t sid, pid_t pid) {
+  return WriteValue(GetPath(sid) + "/" CGROUP_PROCS_FILE, common::ConvertToString(static_cast<long>(pid)));
+}
+
+bool StreamCgroups::GetStats(fastotv::stream_id_t sid, Stats* stats) const {
+  if (!stats) {
+    return false;
+  }
+
+  const std::string path = GetPath(sid);
+  Stats lstats;
+  if (!ReadCpuStat(path + "/" CGROUP_CPU_STAT_FILE, &lstats.cpu_usec)) {
+    return false;
+  }
+  ignore_result(ReadValue(path + "/" CGROUP_MEMORY_CURRENT_FILE, &lstats.memory_bytes));
+  ignore_result(ReadIoStat(path + "/" CGROUP_IO_STAT_FILE, &lstats.io_read_bytes, &lstats.io_write_bytes));
+  *stats = lstats;
+  return true;
+}
+
+bool StreamCgroups::Remove(fastotv::stream_id_t sid) {
+  return rmdir(GetPath(sid).c_str()) == 0;
+}
+
+}  // namespace server
+}  // namespace fastocloud
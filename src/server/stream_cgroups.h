@@ -0,0 +1,67 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <map>
+#include <string>
+
+#include <common/macros.h>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+namespace server {
+
+// cgroup v2 of every stream child under delegated root directory on linux, job object named by root on windows
+// kernel accounts cpu, memory with page cache and io of whole child, enforces optional limits
+class StreamCgroups {
+ public:
+  struct Stats {
+    Stats();
+
+    uint64_t cpu_usec;
+    uint64_t memory_bytes;
+    uint64_t io_read_bytes;
+    uint64_t io_write_bytes;
+  };
+
+  // cpu_limit in percents of one cpu, memory_limit in megabytes, 0 - unlimited
+  StreamCgroups(const std::string& root, int cpu_limit, int memory_limit);
+
+  bool Init();  // false if root is not writable cgroup v2 directory, controllers enabled for children
+
+  bool Create(fastotv::stream_id_t sid, int weight = 0);  // limits applied, before stream spawned, 0 default weight
+  bool Attach(fastotv::stream_id_t sid, pid_t pid);
+  bool GetStats(fastotv::stream_id_t sid, Stats* stats) const;
+  bool Remove(fastotv::stream_id_t sid);  // after stream exited
+
+  std::string GetPath(fastotv::stream_id_t sid) const;
+
+ private:
+  const std::string root_;
+  const int cpu_limit_;
+  const int memory_limit_;
+#if defined(OS_WIN)
+  std::map<fastotv::stream_id_t, void*> jobs_;  // job handles, processes killed when closed
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(StreamCgroups);
+};
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,153 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/stream_cgroups.h"
+
+#include <string.h>
+#include <windows.h>
+
+#include <algorithm>
+#include <string>
+
+#include <common/logger.h>
+
+namespace {
+
+uint64_t FileTimeUnits(const LARGE_INTEGER& value) {
+  return static_cast<uint64_t>(value.QuadPart);
+}
+
+}  // namespace
+
+namespace fastocloud {
+namespace server {
+
+StreamCgroups::Stats::Stats() : cpu_usec(0), memory_bytes(0), io_read_bytes(0), io_write_bytes(0) {}
+
+StreamCgroups::StreamCgroups(const std::string& root, int cpu_limit, int memory_limit)
+    : root_(root), cpu_limit_(cpu_limit), memory_limit_(memory_limit), jobs_() {}
+
+bool StreamCgroups::Init() {
+  return !root_.empty();
+}
+
+std::string StreamCgroups::GetPath(fastotv::stream_id_t sid) const {
+  std::string name = "stream_";
+  for (char c : sid) {
+    const bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+                         c == '-';
+    name += allowed ? c : '_';
+  }
+  return root_ + "_" + name;
+}
+
+bool StreamCgroups::Create(fastotv::stream_id_t sid, int weight) {
+  ignore_result(Remove(sid));
+  HANDLE job = CreateJobObjectA(nullptr, GetPath(sid).c_str());
+  if (!job) {
+    return false;
+  }
+
+  // stream dies with daemon like forked children with death signal
+  JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+  memset(&limits, 0, sizeof(limits));
+  limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+  if (memory_limit_ > 0) {
+    limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_JOB_MEMORY;
+    limits.JobMemoryLimit = static_cast<SIZE_T>(memory_limit_) * 1024 * 1024;
+  }
+  if (!SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits))) {
+    WARNING_LOG() << "Job memory limit not applied, stream id: " << sid;
+  }
+
+  // rate in 1/100 of percent of all cpus, weight from 1 to 9 if not capped
+  JOBOBJECT_CPU_RATE_CONTROL_INFORMATION rate;
+  memset(&rate, 0, sizeof(rate));
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  if (cpu_limit_ > 0) {
+    rate.ControlFlags = JOB_OBJECT_CPU_RATE_CONTROL_ENABLE | JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP;
+    const DWORD cpus = std::max<DWORD>(1, info.dwNumberOfProcessors);
+    rate.CpuRate = std::max<DWORD>(1, std::min<DWORD>(10000, cpu_limit_ * 100 / cpus));
+  } else if (weight > 0) {
+    rate.ControlFlags = JOB_OBJECT_CPU_RATE_CONTROL_ENABLE | JOB_OBJECT_CPU_RATE_CONTROL_WEIGHT_BASED;
+    rate.Weight = std::max<DWORD>(1, std::min<DWORD>(9, weight * 5 / 100));  // cgroup default 100 is middle 5
+  }
+  if (rate.ControlFlags && !SetInformationJobObject(job, JobObjectCpuRateControlInformation, &rate, sizeof(rate))) {
+    WARNING_LOG() << "Job cpu rate not applied, stream id: " << sid;
+  }
+
+  jobs_[sid] = job;
+  return true;
+}
+
+bool StreamCgroups::Attach(fastotv::stream_id_t sid, pid_t pid) {
+  const auto it = jobs_.find(sid);
+  if (it == jobs_.end()) {
+    return false;
+  }
+
+  HANDLE process = OpenProcess(PROCESS_SET_QUOTA | PROCESS_TERMINATE, FALSE, static_cast<DWORD>(pid));
+  if (!process) {
+    return false;
+  }
+  const bool attached = AssignProcessToJobObject(static_cast<HANDLE>(it->second), process);
+  CloseHandle(process);
+  return attached;
+}
+
+bool StreamCgroups::GetStats(fastotv::stream_id_t sid, Stats* stats) const {
+  if (!stats) {
+    return false;
+  }
+
+  const auto it = jobs_.find(sid);
+  if (it == jobs_.end()) {
+    return false;
+  }
+
+  HANDLE job = static_cast<HANDLE>(it->second);
+  JOBOBJECT_BASIC_AND_IO_ACCOUNTING_INFORMATION accounting;
+  if (!QueryInformationJobObject(job, JobObjectBasicAndIoAccountingInformation, &accounting, sizeof(accounting),
+                                 nullptr)) {
+    return false;
+  }
+
+  Stats lstats;
+  // 100 nanoseconds units
+  lstats.cpu_usec = (FileTimeUnits(accounting.BasicInfo.TotalUserTime) +
+                     FileTimeUnits(accounting.BasicInfo.TotalKernelTime)) / 10;
+  lstats.io_read_bytes = accounting.IoInfo.ReadTransferCount;
+  lstats.io_write_bytes = accounting.IoInfo.WriteTransferCount;
+  JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+  if (QueryInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits), nullptr)) {
+    lstats.memory_bytes = limits.PeakJobMemoryUsed;  // committed memory, peak since job created
+  }
+  *stats = lstats;
+  return true;
+}
+
+bool StreamCgroups::Remove(fastotv::stream_id_t sid) {
+  const auto it = jobs_.find(sid);
+  if (it == jobs_.end()) {
+    return false;
+  }
+
+  const bool closed = CloseHandle(static_cast<HANDLE>(it->second));
+  jobs_.erase(it);
+  return closed;
+}
+
+}  // namespace server
+}  // namespace fastocloud
@@ -1,4 +1,4 @@
-/*  Copyright (C) 2014-2019 FastoGT. All right reserved.
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
     This file is part of fastocloud.
     fastocloud is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -12,7 +12,9 @@
     along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <iostream>
 #include <string>
@@ -26,6 +28,7 @@
 #include "base/config_fields.h"
 #include "base/stream_config_parse.h"
 
+#include "server/stream_worker_pool_win.h"
 #include "server/tcp/client.h"
 
 namespace {
@@ -38,6 +41,63 @@ struct WinsockInit {
   }
   ~WinsockInit() { WSACleanup(); }
 } winsock_init;
+
+typedef int (*stream_exec_t)(const char* process_name, const void* args, void* command_client);
+typedef int (*stream_prepare_t)(int argc, char** argv);
+
+HANDLE HandleFromArg(const char* arg) {
+#if defined(_WIN64)
+  return reinterpret_cast<HANDLE>(_atoi64(arg));
+#else
+  return reinterpret_cast<HANDLE>(atol(arg));
+#endif
+}
+
+// pooled worker blocks here until daemon hands it stream
+bool ReadPooledParams(HANDLE pipe, std::string* params) {
+  uint64_t size = 0;
+  DWORD readed = 0;
+  if (!ReadFile(pipe, &size, sizeof(size), &readed, nullptr) || readed != sizeof(size) ||
+      size < sizeof(WSAPROTOCOL_INFO)) {
+    return false;
+  }
+
+  params->resize(size);
+  size_t offset = 0;
+  while (offset < size) {
+    if (!ReadFile(pipe, &(*params)[offset], static_cast<DWORD>(size - offset), &readed, nullptr) || readed == 0) {
+      return false;
+    }
+    offset += readed;
+  }
+  return true;
+}
+
+// socket info followed by json config
+int RunStream(stream_exec_t stream_exec_func, const char* params, size_t size) {
+  const size_t proto_info_len = sizeof(WSAPROTOCOL_INFO);
+  WSAPROTOCOL_INFO pin;
+  memcpy(&pin, params, proto_info_len);
+  const std::string json(params + proto_info_len, size - proto_info_len);
+  const auto params_config = fastocloud::MakeConfigFromJson(json);
+  if (!params_config) {
+    std::cerr << "Invalid config json";
+    return EXIT_FAILURE;
+  }
+
+  common::Value* id_field = params_config->Find(ID_FIELD);
+  std::string sid;
+  if (!id_field || !id_field->GetAsBasicString(&sid)) {
+    std::cerr << "Define " ID_FIELD " variable and make it valid";
+    return EXIT_FAILURE;
+  }
+
+  common::net::socket_descr_t cfd = WSASocket(pin.iAddressFamily, pin.iSocketType, pin.iProtocol, &pin, 0, 0);
+  const std::string new_process_name = common::MemSPrintf(STREAMER_NAME "_%s", sid);
+  const char* new_name = new_process_name.c_str();
+  return stream_exec_func(new_name, params_config.get(),
+                          new fastocloud::server::tcp::Client(nullptr, common::net::socket_info(cfd)));
+}
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -54,7 +114,6 @@ int main(int argc, char** argv) {
     return EXIT_FAILURE;
   }
 
-  typedef int (*stream_exec_t)(const char* process_name, const void* args, void* command_client);
   stream_exec_t stream_exec_func = reinterpret_cast<stream_exec_t>(GetProcAddress(dll, "stream_exec"));
   if (!stream_exec_func) {
     std::cerr << "Failed to load start stream function error: " << GetLastError();
@@ -62,14 +121,32 @@ int main(int argc, char** argv) {
     return EXIT_FAILURE;
   }
 
-  const char* hid = argv[1];
-  const char* sz = argv[2];
+  if (strcmp(argv[1], STREAM_WORKER_POOL_ARG) == 0) {
+    // gstreamer initialized and plugins loaded while stream not yet requested
+    stream_prepare_t stream_prepare_func = reinterpret_cast<stream_prepare_t>(GetProcAddress(dll, "stream_prepare"));
+    if (stream_prepare_func) {
+      stream_prepare_func(argc, argv);
+    }
+
+    HANDLE pipe = HandleFromArg(argv[2]);
+    std::string params;
+    const bool readed = ReadPooledParams(pipe, &params);
+    CloseHandle(pipe);
+    if (!readed) {  // daemon quit or replaced us
+      FreeLibrary(dll);
+      return EXIT_FAILURE;
+    }
+
+    int res = RunStream(stream_exec_func, params.data(), params.size());
+    FreeLibrary(dll);
+    return res;
+  }
+
+  HANDLE param_handle = HandleFromArg(argv[1]);
 #if defined(_WIN64)
-  HANDLE param_handle = reinterpret_cast<HANDLE>(_atoi64(hid));
-  size_t size = _atoi64(sz);
+  size_t size = _atoi64(argv[2]);
 #else
-  HANDLE param_handle = reinterpret_cast<HANDLE>(atol(hid));
-  size_t size = atol(sz);
+  size_t size = atol(argv[2]);
 #endif
 
   char* params = static_cast<char*>(MapViewOfFile(param_handle, FILE_MAP_READ, 0, 0, 0));
@@ -79,31 +156,8 @@ int main(int argc, char** argv) {
     return EXIT_FAILURE;
   }
 
-  const size_t proto_info_len = sizeof(WSAPROTOCOL_INFO);
-  WSAPROTOCOL_INFO pin;
-  memcpy(&pin, params, proto_info_len);
-  const char* params_json = params + proto_info_len;
-  const auto params_config = fastocloud::MakeConfigFromJson(std::string(params_json, size - proto_info_len));
-  UnmapViewOfFile(params_json);
-  if (!params_config) {
-    std::cerr << "Invalid config json";
-    FreeLibrary(dll);
-    return EXIT_FAILURE;
-  }
-
-  common::Value* id_field = params_config->Find(ID_FIELD);
-  std::string sid;
-  if (!id_field || !id_field->GetAsBasicString(&sid)) {
-    std::cerr << "Define " ID_FIELD " variable and make it valid";
-    FreeLibrary(dll);
-    return EXIT_FAILURE;
-  }
-
-  common::net::socket_descr_t cfd = WSASocket(pin.iAddressFamily, pin.iSocketType, pin.iProtocol, &pin, 0, 0);
-  const std::string new_process_name = common::MemSPrintf(STREAMER_NAME "_%s", sid);
-  const char* new_name = new_process_name.c_str();
-  int res = stream_exec_func(new_name, params_config.get(),
-                             new fastocloud::server::tcp::Client(nullptr, common::net::socket_info(cfd)));
+  int res = RunStream(stream_exec_func, params, size);
+  UnmapViewOfFile(params);
   FreeLibrary(dll);
   return res;
 }
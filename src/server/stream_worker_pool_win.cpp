@@ -0,0 +1,149 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/stream_worker_pool_win.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+
+#include <common/logger.h>
+#include <common/sprintf.h>
+
+namespace fastocloud {
+namespace server {
+
+StreamWorkerPool::Worker::Worker() : process(nullptr), pipe(nullptr), pid(0) {}
+
+StreamWorkerPool::StreamWorkerPool(size_t size) : size_(size), idle_() {}
+
+StreamWorkerPool::~StreamWorkerPool() {
+  for (Worker& worker : idle_) {
+    Terminate(&worker);
+  }
+  idle_.clear();
+}
+
+void StreamWorkerPool::Fill() {
+  while (idle_.size() < size_) {
+    Worker worker;
+    common::ErrnoError err = StartWorker(&worker);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+      return;
+    }
+    idle_.push_back(worker);
+  }
+}
+
+bool StreamWorkerPool::Take(Worker* worker) {
+  if (!worker) {
+    return false;
+  }
+
+  while (!idle_.empty()) {
+    Worker front = idle_.front();
+    idle_.pop_front();
+    if (WaitForSingleObject(front.process, 0) == WAIT_TIMEOUT) {
+      *worker = front;
+      return true;
+    }
+    WARNING_LOG() << "Idle stream worker exited, pid: " << front.pid;
+    Terminate(&front);
+  }
+  return false;
+}
+
+size_t StreamWorkerPool::GetIdleCount() const {
+  return idle_.size();
+}
+
+common::ErrnoError StreamWorkerPool::HandOff(Worker* worker, const std::string& params) {
+  if (!worker || !worker->pipe) {
+    return common::make_errno_error_inval();
+  }
+
+  // size prefixed, worker blocks in ReadFile until all of it arrives
+  const uint64_t size = params.size();
+  DWORD written = 0;
+  const bool sent = WriteFile(worker->pipe, &size, sizeof(size), &written, nullptr) && written == sizeof(size) &&
+                    WriteFile(worker->pipe, params.data(), static_cast<DWORD>(params.size()), &written, nullptr) &&
+                    written == params.size();
+  CloseHandle(worker->pipe);
+  worker->pipe = nullptr;
+  if (!sent) {
+    return common::make_errno_error("Stream worker pipe write failed", EPIPE);
+  }
+  return common::ErrnoError();
+}
+
+void StreamWorkerPool::Terminate(Worker* worker) {
+  if (!worker) {
+    return;
+  }
+
+  if (worker->pipe) {
+    CloseHandle(worker->pipe);
+  }
+  if (worker->process) {
+    TerminateProcess(worker->process, EXIT_FAILURE);
+    CloseHandle(worker->process);
+  }
+  *worker = Worker();
+}
+
+common::ErrnoError StreamWorkerPool::StartWorker(Worker* worker) {
+  SECURITY_ATTRIBUTES sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.nLength = sizeof(sa);
+  sa.bInheritHandle = TRUE;
+  HANDLE read_pipe = nullptr;
+  HANDLE write_pipe = nullptr;
+  if (!CreatePipe(&read_pipe, &write_pipe, &sa, 0)) {
+    return common::make_errno_error("Can't create stream worker pipe", EMFILE);
+  }
+  SetHandleInformation(write_pipe, HANDLE_FLAG_INHERIT, 0);  // only read end is for worker
+
+#define CMD_LINE_SIZE 512
+  char cmd_line[CMD_LINE_SIZE] = {0};
+#if defined(_WIN64)
+  common::SNPrintf(cmd_line, CMD_LINE_SIZE, STREAMER_EXE_NAME ".exe " STREAM_WORKER_POOL_ARG " %llu",
+                   reinterpret_cast<UINT_PTR>(read_pipe));
+#else
+  common::SNPrintf(cmd_line, CMD_LINE_SIZE, STREAMER_EXE_NAME ".exe " STREAM_WORKER_POOL_ARG " %lu",
+                   reinterpret_cast<DWORD>(read_pipe));
+#endif
+
+  STARTUPINFO si;
+  PROCESS_INFORMATION pi;
+  memset(&pi, 0, sizeof(pi));
+  memset(&si, 0, sizeof(si));
+  si.cb = sizeof(si);
+  const BOOL created = CreateProcess(nullptr, cmd_line, nullptr, nullptr, TRUE, 0, nullptr, nullptr, &si, &pi);
+  CloseHandle(read_pipe);
+  if (!created) {
+    CloseHandle(write_pipe);
+    return common::make_errno_error("Can't start stream worker", ECHILD);
+  }
+
+  CloseHandle(pi.hThread);
+  worker->process = pi.hProcess;
+  worker->pipe = write_pipe;
+  worker->pid = pi.dwProcessId;
+  return common::ErrnoError();
+}
+
+}  // namespace server
+}  // namespace fastocloud
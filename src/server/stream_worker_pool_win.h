@@ -0,0 +1,63 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <windows.h>
+
+#include <deque>
+#include <string>
+
+#include <common/error.h>
+#include <common/macros.h>
+
+#define STREAM_WORKER_POOL_ARG "pool"  // stream exe started ahead, waits for stream on inherited pipe
+
+namespace fastocloud {
+namespace server {
+
+// stream processes started ahead of requests on windows, where there is no fork:
+// core library loaded and gstreamer initialized while idle, socket and config of stream written to pipe of worker
+class StreamWorkerPool {
+ public:
+  struct Worker {
+    Worker();
+
+    HANDLE process;
+    HANDLE pipe;  // write end, worker reads stream from other end
+    DWORD pid;
+  };
+
+  explicit StreamWorkerPool(size_t size);
+  ~StreamWorkerPool();  // idle workers terminated
+
+  void Fill();  // idle workers started up to size
+  bool Take(Worker* worker);  // running idle worker, caller owns handles, false if pool empty
+  size_t GetIdleCount() const;
+
+  // duplicated socket info and json config, worker runs stream after reading it; pipe closed
+  static common::ErrnoError HandOff(Worker* worker, const std::string& params) WARN_UNUSED_RESULT;
+  static void Terminate(Worker* worker);
+
+ private:
+  static common::ErrnoError StartWorker(Worker* worker) WARN_UNUSED_RESULT;
+
+  const size_t size_;
+  std::deque<Worker> idle_;  // oldest first, most likely initialized
+
+  DISALLOW_COPY_AND_ASSIGN(StreamWorkerPool);
+};
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,111 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/streams_status.h"
+
+#include <algorithm>
+#include <vector>
+
+#define STREAMS_STATUS_STREAMS_FIELD "streams"
+#define STREAMS_STATUS_ID_FIELD "id"
+#define STREAMS_STATUS_STATUS_FIELD "status"
+#define STREAMS_STATUS_INPUT_BPS_FIELD "input_bps"
+#define STREAMS_STATUS_OUTPUT_BPS_FIELD "output_bps"
+#define STREAMS_STATUS_RESTARTS_FIELD "restarts"
+#define STREAMS_STATUS_CPU_FIELD "cpu"
+#define STREAMS_STATUS_RSS_FIELD "rss"
+#define STREAMS_STATUS_TIMESTAMP_FIELD "timestamp"
+
+namespace fastocloud {
+namespace server {
+
+namespace {
+json_object* MakeStatusJson(const fastotv::stream_id_t& sid, const StreamsStatus::Status& status) {
+  json_object* jstatus = json_object_new_object();
+  json_object_object_add(jstatus, STREAMS_STATUS_ID_FIELD, json_object_new_string(sid.c_str()));
+  json_object_object_add(jstatus, STREAMS_STATUS_STATUS_FIELD, json_object_new_int(status.status));
+  json_object_object_add(jstatus, STREAMS_STATUS_INPUT_BPS_FIELD, json_object_new_int64(status.input_bps));
+  json_object_object_add(jstatus, STREAMS_STATUS_OUTPUT_BPS_FIELD, json_object_new_int64(status.output_bps));
+  json_object_object_add(jstatus, STREAMS_STATUS_RESTARTS_FIELD, json_object_new_int64(status.restarts));
+  json_object_object_add(jstatus, STREAMS_STATUS_CPU_FIELD, json_object_new_double(status.cpu));
+  json_object_object_add(jstatus, STREAMS_STATUS_RSS_FIELD, json_object_new_int64(status.rss));
+  json_object_object_add(jstatus, STREAMS_STATUS_TIMESTAMP_FIELD, json_object_new_int64(status.timestamp));
+  return jstatus;
+}
+}  // namespace
+
+StreamsStatus::StreamsStatus() : streams_() {}
+
+void StreamsStatus::Set(const StatisticInfo& stat) {
+  const StreamStruct& str = stat.GetStreamStruct();
+  Status status = {str.status, 0, 0, str.restarts, stat.GetCpuLoad(), stat.GetRssBytes(), stat.GetTimestamp()};
+  for (const auto& input : str.input) {
+    status.input_bps += input.GetBps();
+  }
+  for (const auto& output : str.output) {
+    status.output_bps += output.GetBps();
+  }
+  streams_[str.id] = status;
+}
+
+void StreamsStatus::Remove(fastotv::stream_id_t sid) {
+  streams_.erase(sid);
+}
+
+bool StreamsStatus::Get(fastotv::stream_id_t sid, Status* status) const {
+  auto it = streams_.find(sid);
+  if (!status || it == streams_.end()) {
+    return false;
+  }
+
+  *status = it->second;
+  return true;
+}
+
+common::Error StreamsStatus::Serialize(const service::StreamsStatusInfo& filter, std::string* json) const {
+  if (!json) {
+    return common::make_error_inval();
+  }
+
+  const service::StreamsStatusInfo::statuses_t statuses = filter.GetStatuses();
+  auto matches = [&statuses](const Status& status) {
+    return statuses.empty() || std::find(statuses.begin(), statuses.end(), status.status) != statuses.end();
+  };
+
+  json_object* jstreams = json_object_new_array();
+  const service::StreamsStatusInfo::streams_t ids = filter.GetStreams();
+  if (ids.empty()) {
+    for (auto it = streams_.begin(); it != streams_.end(); ++it) {
+      if (matches(it->second)) {
+        json_object_array_add(jstreams, MakeStatusJson(it->first, it->second));
+      }
+    }
+  } else {
+    for (const fastotv::stream_id_t& sid : ids) {
+      auto it = streams_.find(sid);
+      if (it != streams_.end() && matches(it->second)) {
+        json_object_array_add(jstreams, MakeStatusJson(it->first, it->second));
+      }
+    }
+  }
+
+  json_object* jresult = json_object_new_object();
+  json_object_object_add(jresult, STREAMS_STATUS_STREAMS_FIELD, jstreams);
+  *json = json_object_to_json_string_ext(jresult, JSON_C_TO_STRING_PLAIN);
+  json_object_put(jresult);
+  return common::Error();
+}
+
+}  // namespace server
+}  // namespace fastocloud
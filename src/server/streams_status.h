@@ -0,0 +1,58 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <common/error.h>
+
+#include "server/daemon/commands_info/service/streams_status_info.h"
+#include "stream_commands/commands_info/statistic_info.h"
+
+namespace fastocloud {
+namespace server {
+
+// compact copy of last statistic of every stream, pulled on demand instead of listening to broadcasts
+class StreamsStatus {
+ public:
+  struct Status {
+    StreamStatus status;
+    uint64_t input_bps;   // all inputs
+    uint64_t output_bps;  // all outputs
+    size_t restarts;
+    StatisticInfo::cpu_load_t cpu;
+    StatisticInfo::rss_t rss;
+    fastotv::timestamp_t timestamp;  // of statistic, utc msec
+  };
+
+  StreamsStatus();
+
+  void Set(const StatisticInfo& stat);
+  void Remove(fastotv::stream_id_t sid);  // stream finished
+  bool Get(fastotv::stream_id_t sid, Status* status) const;
+
+  // {"streams": [{"id": "...", "status": 4, "input_bps": 0, "output_bps": 0, "restarts": 0, "cpu": 0.0, "rss": 0,
+  // "timestamp": 0}]}, unknown ids of filter skipped
+  common::Error Serialize(const service::StreamsStatusInfo& filter, std::string* json) const WARN_UNUSED_RESULT;
+
+ private:
+  std::map<fastotv::stream_id_t, Status> streams_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamsStatus);
+};
+
+}  // namespace server
+}  // namespace fastocloud
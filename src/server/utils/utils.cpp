@@ -16,7 +16,42 @@
 
 #include <unistd.h>
 
+#if defined(OS_POSIX)
+#include <poll.h>
+
+#include <algorithm>
+#include <chrono>
+#endif
+
+#if defined(OS_LINUX)
+#include <sys/sendfile.h>
+#endif
+
 namespace {
+#if defined(OS_POSIX)
+// whole stall of one send call, loop of all other clients waits meanwhile, slow client dropped after it
+const int kSendStallBudgetMsec = 250;
+
+common::ErrnoError wait_writable(common::net::socket_descr_t sock, int* budget_msec) {
+  if (*budget_msec <= 0) {
+    return common::make_errno_error("Send timeout", ETIMEDOUT);
+  }
+
+  struct pollfd pfd = {sock, POLLOUT, 0};
+  const auto start = std::chrono::steady_clock::now();
+  int ready = poll(&pfd, 1, *budget_msec);
+  const auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  *budget_msec -= std::max(static_cast<int>(waited.count()), 1);
+  if (ready == 0) {
+    return common::make_errno_error("Send timeout", ETIMEDOUT);
+  }
+  if (ready < 0 && errno != EINTR) {
+    return common::make_errno_error(errno);
+  }
+  return common::ErrnoError();
+}
+#endif
+
 #if defined(OS_WIN)
 int socketpair(int domain, int type, int protocol, SOCKET socks[2]) {
   SOCKET listener = socket(domain, type, protocol);
@@ -119,5 +154,66 @@ common::ErrnoError CreateSocketPair(common::net::socket_descr_t* parent_sock, co
   return common::ErrnoError();
 }
 
+#if defined(OS_LINUX)
+common::ErrnoError SendFileToSocket(common::net::socket_descr_t sock, int fd, size_t size, off_t offset) {
+  const off_t end = offset + size;
+  int budget_msec = kSendStallBudgetMsec;
+  while (offset < end) {
+    ssize_t res = sendfile(sock, fd, &offset, end - offset);
+    if (res > 0) {
+      continue;
+    }
+
+    if (res == 0) {  // file truncated
+      return common::make_errno_error("File truncated while sending", EIO);
+    }
+
+    if (errno == EINTR) {
+      continue;
+    }
+
+    if (errno != EAGAIN) {
+      return common::make_errno_error(errno);
+    }
+
+    common::ErrnoError err = wait_writable(sock, &budget_msec);
+    if (err) {
+      return err;
+    }
+  }
+
+  return common::ErrnoError();
+}
+#endif
+
+#if defined(OS_POSIX)
+common::ErrnoError WriteToSocket(common::net::socket_descr_t sock, const char* data, size_t size) {
+  size_t written = 0;
+  int budget_msec = kSendStallBudgetMsec;
+  while (written < size) {
+    ssize_t res = write(sock, data + written, size - written);
+    if (res > 0) {
+      written += res;
+      continue;
+    }
+
+    if (res < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (res == 0 || errno != EAGAIN) {
+      return common::make_errno_error(res == 0 ? EIO : errno);
+    }
+
+    common::ErrnoError err = wait_writable(sock, &budget_msec);
+    if (err) {
+      return err;
+    }
+  }
+
+  return common::ErrnoError();
+}
+#endif
+
 }  // namespace server
 }  // namespace fastocloud
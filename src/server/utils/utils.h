@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <sys/types.h>
+
 #include <common/error.h>
 #include <common/net/socket_info.h>
 
@@ -26,5 +28,16 @@ common::ErrnoError CreatePipe(common::net::socket_descr_t* read_client_fd,
 #endif
 common::ErrnoError CreateSocketPair(common::net::socket_descr_t* parent_sock, common::net::socket_descr_t* child_sock);
 
+#if defined(OS_LINUX)
+// kernel side copy of size bytes of file from offset into socket, waits while non blocking socket is full,
+// ETIMEDOUT once waits of call sum up to 250 msec, they block event loop of socket
+common::ErrnoError SendFileToSocket(common::net::socket_descr_t sock, int fd, size_t size, off_t offset = 0);
+#endif
+
+#if defined(OS_POSIX)
+// writes all size bytes, waits like SendFileToSocket while non blocking socket is full
+common::ErrnoError WriteToSocket(common::net::socket_descr_t sock, const char* data, size_t size);
+#endif
+
 }  // namespace server
 }  // namespace fastocloud
@@ -14,11 +14,36 @@
 
 #include "server/vods/client.h"
 
+#include <stdio.h>
+#include <unistd.h>
+
+#if defined(OS_LINUX)
+#include <sys/mman.h>
+#endif
+
+#include "server/utils/utils.h"
+
+namespace {
+int create_body_file() {
+#if defined(OS_LINUX)
+  return memfd_create("vods_body", MFD_CLOEXEC);
+#else
+  FILE* file = tmpfile();
+  if (!file) {
+    return INVALID_DESCRIPTOR;
+  }
+  int fd = dup(fileno(file));
+  fclose(file);
+  return fd;
+#endif
+}
+}  // namespace
+
 namespace fastocloud {
 namespace server {
 
 VodsClient::VodsClient(common::libev::IoLoop* server, const common::net::socket_info& info)
-    : base_class(server, info), is_verified_(false) {}
+    : base_class(server, info), is_verified_(false), request_buffer_() {}
 
 bool VodsClient::IsVerified() const {
   return is_verified_;
@@ -28,6 +53,45 @@ void VodsClient::SetVerified(bool verified) {
   is_verified_ = verified;
 }
 
+base::HttpRequestBuffer* VodsClient::GetRequestBuffer() {
+  return &request_buffer_;
+}
+
+common::ErrnoError VodsClient::SendBody(common::http::http_protocol protocol, const char* data, size_t size) {
+  if (protocol != common::http::HP_2_0) {
+    return WriteToSocket(GetFd(), data, size);
+  }
+
+  // framing of http/2 streams is reachable only through SendFileByFd, body handed over as in memory file
+  int fd = create_body_file();
+  if (fd == INVALID_DESCRIPTOR) {
+    return common::make_errno_error(errno);
+  }
+
+  size_t written = 0;
+  while (written < size) {
+    ssize_t res = write(fd, data + written, size - written);
+    if (res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (res <= 0) {
+      common::ErrnoError err = common::make_errno_error(res == 0 ? EIO : errno);
+      ::close(fd);
+      return err;
+    }
+    written += res;
+  }
+
+  common::ErrnoError err;
+  if (lseek(fd, 0, SEEK_SET) == static_cast<off_t>(-1)) {
+    err = common::make_errno_error(errno);
+  } else {
+    err = SendFileByFd(protocol, fd, size);
+  }
+  ::close(fd);
+  return err;
+}
+
 const char* VodsClient::ClassName() const {
   return "VodsClient";
 }
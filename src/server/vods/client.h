@@ -14,24 +14,33 @@
 
 #pragma once
 
-#include <common/libev/http/http_client.h>
+#include <common/libev/http/http2_client.h>
+
+#include "server/base/http_request_buffer.h"
 
 namespace fastocloud {
 namespace server {
 
-class VodsClient : public common::libev::http::HttpClient {
+// http/1.1 or h2c with prior knowledge, framing and hpack of http/2 streams done by base
+class VodsClient : public common::libev::http::Http2Client {
  public:
-  typedef common::libev::http::HttpClient base_class;
+  typedef common::libev::http::Http2Client base_class;
 
   VodsClient(common::libev::IoLoop* server, const common::net::socket_info& info);
 
   bool IsVerified() const;
   void SetVerified(bool verified);
 
+  base::HttpRequestBuffer* GetRequestBuffer();
+
+  // whole in memory body after SendHeaders, as data frames of the request stream for HP_2_0
+  common::ErrnoError SendBody(common::http::http_protocol protocol, const char* data, size_t size) WARN_UNUSED_RESULT;
+
   const char* ClassName() const override;
 
  private:
   bool is_verified_;
+  base::HttpRequestBuffer request_buffer_;
 };
 
 }  // namespace server
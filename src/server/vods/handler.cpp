@@ -18,28 +18,102 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
+#include <common/convert2string.h>
+#include <common/file_system/file_system.h>
+#include <common/http/http2.h>
+
+#include "base/types.h"
+
+#include "server/base/http_cache.h"
+#include "server/base/http_range.h"
 #include "server/base/ihttp_requests_observer.h"
+#include "server/segment_cache.h"
+#include "server/utils/utils.h"
 #include "server/vods/client.h"
+#include "server/vods/ts_index.h"
+
+#define VIRTUAL_HLS_SEGMENT_MSEC 10000
+
+namespace {
+const char kAcceptRanges[] = "\r\nAccept-Ranges: bytes";
+}
 
 namespace fastocloud {
 namespace server {
+namespace {
+SegmentCache::data_t read_segment(int fd, size_t size) {
+  std::string* data = new std::string(size, 0);
+  size_t readed = 0;
+  while (readed < size) {
+    ssize_t res = pread(fd, &(*data)[readed], size - readed, readed);
+    if (res <= 0) {
+      delete data;
+      return nullptr;
+    }
+    readed += res;
+  }
+  return SegmentCache::data_t(data);
+}
+
+// library sends from current position of descriptor
+common::ErrnoError SendFileRange(VodsClient* hclient,
+                                 common::http::http_protocol protocol,
+                                 int fd,
+                                 const base::ByteRange& range) {
+  if (range.start && lseek(fd, range.start, SEEK_SET) == static_cast<off_t>(-1)) {
+    return common::make_errno_error(errno);
+  }
+  return hclient->SendFileByFd(protocol, fd, range.length);
+}
+}  // namespace
 
 VodsHandler::VodsHandler(base::IHttpRequestsObserver* observer)
-    : base_class(), http_root_(http_directory_path_t::MakeHomeDir()), observer_(observer) {}
+    : base_class(),
+      http_root_(http_directory_path_t::MakeHomeDir()),
+      segment_cache_(nullptr),
+      virtual_hls_(false),
+      indexes_mutex_(),
+      indexes_(),
+      observer_(observer),
+      workers_(),
+      next_worker_(0) {}
 
 void VodsHandler::SetHttpRoot(const http_directory_path_t& http_root) {
   http_root_ = http_root;
 }
 
+void VodsHandler::SetSegmentCache(SegmentCache* cache) {
+  segment_cache_ = cache;
+}
+
+void VodsHandler::SetVirtualHls(bool virtual_hls) {
+  virtual_hls_ = virtual_hls;
+}
+
+void VodsHandler::SetWorkers(const std::vector<common::libev::IoLoop*>& workers) {
+  workers_ = workers;
+}
+
 void VodsHandler::PreLooped(common::libev::IoLoop* server) {
   UNUSED(server);
 }
 
 void VodsHandler::Accepted(common::libev::IoClient* client) {
   base_class::Accepted(client);
+  common::libev::IoLoop* server = client->GetServer();
+  if (workers_.empty() || IsWorker(server)) {
+    return;
+  }
+
+  common::libev::IoLoop* worker = workers_[next_worker_++ % workers_.size()];
+  server->ExecInLoopThread([server, worker, client]() {
+    server->UnRegisterClient(client);
+    worker->ExecInLoopThread([worker, client]() { worker->RegisterClient(client); });
+  });
 }
 
 void VodsHandler::Moved(common::libev::IoLoop* server, common::libev::IoClient* client) {
@@ -71,17 +145,54 @@ void VodsHandler::ChildStatusChanged(common::libev::IoChild* child, int status,
 }
 
 void VodsHandler::DataReceived(common::libev::IoClient* client) {
-  char buff[BUF_SIZE] = {0};
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  VodsClient* hclient = static_cast<server::VodsClient*>(client);
+  base::HttpRequestBuffer* buffer = hclient->GetRequestBuffer();
+  size_t free_size = 0;
+  char* buff = buffer->PrepareWrite(&free_size);
+  if (!buff) {
+    common::ErrnoError err = hclient->SendError(common::http::HP_1_1, common::http::HS_BAD_REQUEST, nullptr,
+                                                "Request too large.", false, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    ignore_result(client->Close());
+    delete client;
+    return;
+  }
+
   size_t nread = 0;
-  common::ErrnoError errn = client->SingleRead(buff, BUF_SIZE - 1, &nread);
+  common::ErrnoError errn = client->SingleRead(buff, free_size, &nread);
   if ((errn && errn->GetErrorCode() != EAGAIN) || nread == 0) {
     ignore_result(client->Close());
     delete client;
     return;
   }
 
-  VodsClient* hclient = static_cast<server::VodsClient*>(client);
-  ProcessReceived(hclient, buff, nread);
+  // handler shared between worker loops, request storage reused per thread
+  static thread_local std::string request;
+  buffer->CommitWrite(nread);
+  while (buffer->NextRequest(&request)) {
+    if (!ProcessReceived(hclient, request)) {
+      ignore_result(client->Close());
+      delete client;
+      return;
+    }
+  }
+  if (buffer->IsMalformed()) {
+    common::ErrnoError err = hclient->SendError(common::http::HP_1_1, common::http::HS_BAD_REQUEST, nullptr,
+                                                "Invalid Content-Length.", false, hinf);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    }
+    ignore_result(client->Close());
+    delete client;
+    return;
+  }
+  if (buffer->NextFrames(&request) && !ProcessFrames(hclient, request)) {
+    ignore_result(client->Close());
+    delete client;
+  }
 }
 
 void VodsHandler::DataReadyToWrite(common::libev::IoClient* client) {
@@ -92,11 +203,85 @@ void VodsHandler::PostLooped(common::libev::IoLoop* server) {
   UNUSED(server);
 }
 
-void VodsHandler::ProcessReceived(VodsClient* hclient, const char* request, size_t req_len) {
+bool VodsHandler::IsWorker(common::libev::IoLoop* loop) const {
+  return std::find(workers_.begin(), workers_.end(), loop) != workers_.end();
+}
+
+bool VodsHandler::ReadVirtualHls(const common::file_system::ascii_file_string_path& file,
+                                 std::string* body,
+                                 time_t* mtime) {
+  if (common::file_system::is_file_exist(file.GetPath())) {  // playlists and segments of vod streams
+    return false;
+  }
+
+  const common::file_system::ascii_directory_string_path dir(file.GetDirectory());
+  const std::string name = file.GetBaseFileName();
+  const std::string ext = file.GetExtension();
+  if (common::EqualsASCII(ext, M3U8_EXTENSION, false)) {
+    const auto source = dir.MakeFileStringPath(name);
+    const std::shared_ptr<const TsIndex> index = source ? FindTsIndex(source->GetPath()) : nullptr;
+    if (!index) {
+      return false;
+    }
+
+    *body = index->RenderPlaylist(name + ".");
+    *mtime = index->GetMtime();
+    return true;
+  }
+
+  const size_t pos = name.rfind('.');
+  uint64_t segment = 0;
+  if (!common::EqualsASCII(ext, TS_EXTENSION, false) || pos == std::string::npos ||
+      !common::ConvertFromString(name.substr(pos + 1), &segment)) {
+    return false;
+  }
+
+  const auto source = dir.MakeFileStringPath(name.substr(0, pos));
+  const std::shared_ptr<const TsIndex> index = source ? FindTsIndex(source->GetPath()) : nullptr;
+  if (!index || !index->ReadSegment(source->GetPath(), segment, body)) {
+    return false;
+  }
+
+  *mtime = index->GetMtime();
+  return true;
+}
+
+std::shared_ptr<const TsIndex> VodsHandler::FindTsIndex(const std::string& source) {
+  struct stat sb;
+  const size_t ext_len = sizeof(CHUNK_EXT) - 1;
+  if (source.size() <= ext_len || source.compare(source.size() - ext_len, ext_len, CHUNK_EXT) != 0 ||
+      stat(source.c_str(), &sb) < 0) {
+    return nullptr;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(indexes_mutex_);
+    auto it = indexes_.find(source);
+    if (it != indexes_.end() && it->second->GetMtime() == sb.st_mtime &&
+        it->second->GetSize() == static_cast<uint64_t>(sb.st_size)) {
+      return it->second;
+    }
+  }
+
+  // one scan of file per change, built outside lock so other loops keep serving
+  TsIndex* index = new TsIndex;
+  if (!index->Build(source, VIRTUAL_HLS_SEGMENT_MSEC)) {
+    delete index;
+    DEBUG_LOG() << "Not sliceable ts file: " << source;
+    return nullptr;
+  }
+
+  INFO_LOG() << "Indexed ts file: " << source << ", segments: " << index->GetSegments().size();
+  std::shared_ptr<const TsIndex> result(index);
+  std::unique_lock<std::mutex> lock(indexes_mutex_);
+  indexes_[source] = result;
+  return result;
+}
+
+bool VodsHandler::ProcessReceived(VodsClient* hclient, const std::string& request) {
   static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
   common::http::HttpRequest hrequest;
-  std::string request_str(request, req_len);
-  std::pair<common::http::http_status, common::Error> result = common::http::parse_http_request(request_str, &hrequest);
+  std::pair<common::http::http_status, common::Error> result = common::http::parse_http_request(request, &hrequest);
   DEBUG_LOG() << "Http request:\n" << request;
 
   if (result.second) {
@@ -107,15 +292,43 @@ void VodsHandler::ProcessReceived(VodsClient* hclient, const char* request, size
     if (err) {
       DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
     }
-    ignore_result(hclient->Close());
-    delete hclient;
-    return;
+    return false;
   }
 
-  // keep alive
-  common::http::header_t connection_field;
-  bool is_find_connection = hrequest.FindHeaderByKey("Connection", false, &connection_field);
-  bool IsKeepAlive = is_find_connection ? common::EqualsASCII(connection_field.value, "Keep-Alive", false) : false;
+  return ProcessRequest(hclient, hrequest);
+}
+
+bool VodsHandler::ProcessFrames(VodsClient* hclient, const std::string& data) {
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  common::http2::frames_t frames = common::http2::parse_frames(data.data(), data.size());
+  hclient->ProcessFrames(frames);  // settings, pings and window updates answered by client
+
+  common::http2::frames_t headers = common::http2::find_frames_by_type(frames, common::http2::HTTP2_HEADERS);
+  for (size_t i = 0; i < headers.size(); ++i) {
+    const common::http2::frame_headers* head = static_cast<const common::http2::frame_headers*>(&headers[i]);
+    common::http::HttpRequest hrequest;
+    std::pair<common::http::http_status, common::Error> result = common::http2::parse_http_request(*head, &hrequest);
+    if (result.second) {
+      const std::string error_text = result.second->GetDescription();
+      DEBUG_MSG_ERROR(result.second, common::logging::LOG_LEVEL_ERR);
+      common::ErrnoError err =
+          hclient->SendError(common::http::HP_2_0, result.first, nullptr, error_text.c_str(), false, hinf);
+      if (err) {
+        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+      }
+      return false;
+    }
+
+    if (!ProcessRequest(hclient, hrequest)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool VodsHandler::ProcessRequest(VodsClient* hclient, const common::http::HttpRequest& hrequest) {
+  static const common::libev::http::HttpServerInfo hinf(PROJECT_NAME_TITLE, PROJECT_DOMAIN);
+  const bool IsKeepAlive = base::IsKeepAliveRequest(hrequest);
   const common::http::http_protocol protocol = hrequest.GetProtocol();
   const char* extra_header = "Access-Control-Allow-Origin: *";
   if (hrequest.GetMethod() == common::http::http_method::HM_GET ||
@@ -131,6 +344,8 @@ void VodsHandler::ProcessReceived(VodsClient* hclient, const char* request, size
     }
 
     const std::string url_dirs = path.GetHpath();
+    const bool head_only = hrequest.GetMethod() == common::http::http_method::HM_HEAD;
+    const base::CacheConditions conditions = base::GetCacheConditions(hrequest);
     auto dirs_path = http_root_.MakeDirectoryStringPath(url_dirs.substr(1));
     if (!dirs_path) {
       dirs_path = http_root_;
@@ -146,6 +361,36 @@ void VodsHandler::ProcessReceived(VodsClient* hclient, const char* request, size
       goto finish;
     }
 
+    if (virtual_hls_) {
+      std::string body;
+      time_t mtime = 0;
+      if (ReadVirtualHls(*file_path, &body, &mtime)) {
+        const std::string mime = path.GetMime();
+        off_t size = body.size();
+        const std::string etag = base::MakeETag(size, mtime);
+        std::string cache_headers = base::MakeCacheHeaders(etag, file_path->GetPath(), false) + kAcceptRanges;
+        const bool not_modified = base::IsNotModified(conditions, etag, mtime);
+        base::ByteRange range = {0, body.size()};
+        const bool partial =
+            !not_modified && !head_only && base::GetByteRange(hrequest, body.size(), etag, mtime, &range);
+        common::http::http_status status = not_modified ? common::http::HS_NOT_MODIFIED : common::http::HS_OK;
+        if (partial) {
+          status = common::http::HS_PARTIAL_CONTENT;
+          cache_headers += "\r\n" + base::MakeContentRangeHeader(range, body.size());
+          size = range.length;
+        }
+        common::ErrnoError err = hclient->SendHeaders(protocol, status, cache_headers.c_str(), mime.c_str(), &size,
+                                                      &mtime, IsKeepAlive, hinf);
+        if (!err && !head_only && !not_modified) {
+          err = hclient->SendBody(protocol, body.data() + range.start, range.length);
+        }
+        if (err) {
+          DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+        }
+        goto finish;
+      }
+    }
+
     common::http::http_status recommend_status = common::http::HS_OK;
     if (observer_) {
       observer_->OnHttpRequest(hclient, *file_path, &recommend_status);
@@ -190,42 +435,94 @@ void VodsHandler::ProcessReceived(VodsClient* hclient, const char* request, size
       goto finish;
     }
 
-    int file = open(file_path_str.c_str(), open_flags);
-    if (file == INVALID_DESCRIPTOR) { /* open the file for reading */
-      common::ErrnoError err = hclient->SendError(protocol, common::http::HS_FORBIDDEN, extra_header,
-                                                  "File is protected.", IsKeepAlive, hinf);
+    // vod outputs rewritten under same names after reencode, segments revalidated after an hour
+    const std::string etag = base::MakeETag(sb.st_size, sb.st_mtime);
+    std::string cache_headers = base::MakeCacheHeaders(etag, file_path_str, false) + kAcceptRanges;
+    const std::string mime = path.GetMime();
+    const bool not_modified = base::IsNotModified(conditions, etag, sb.st_mtime);
+    if (not_modified || head_only) {  // headers only, file not opened and cache not filled
+      common::ErrnoError err =
+          hclient->SendHeaders(protocol, not_modified ? common::http::HS_NOT_MODIFIED : common::http::HS_OK,
+                               cache_headers.c_str(), mime.c_str(), &sb.st_size, &sb.st_mtime, IsKeepAlive, hinf);
       if (err) {
         DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
       }
       goto finish;
     }
 
-    const std::string mime = path.GetMime();
-    common::ErrnoError err = hclient->SendHeaders(protocol, common::http::HS_OK, extra_header, mime.c_str(),
-                                                  &sb.st_size, &sb.st_mtime, IsKeepAlive, hinf);
+    const bool is_segment =
+        segment_cache_ && common::EqualsASCII(file_path->GetExtension(), TS_EXTENSION, false) && sb.st_size > 0;
+    SegmentCache::data_t body;
+    if (is_segment) {
+      body = segment_cache_->Find(file_path_str, sb.st_mtime, sb.st_size);
+    }
+
+    int file = INVALID_DESCRIPTOR;
+    if (!body) {
+      file = open(file_path_str.c_str(), open_flags);
+      if (file == INVALID_DESCRIPTOR) { /* open the file for reading */
+        common::ErrnoError err = hclient->SendError(protocol, common::http::HS_FORBIDDEN, extra_header,
+                                                    "File is protected.", IsKeepAlive, hinf);
+        if (err) {
+          DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+        }
+        goto finish;
+      }
+
+      if (is_segment && segment_cache_->IsCacheable(sb.st_size)) {
+        body = read_segment(file, sb.st_size);
+        if (body) {
+          segment_cache_->Insert(file_path_str, sb.st_mtime, body);
+        }
+      }
+    }
+
+    // single range from cache or file offset, players seek in large mp4 and ts files by it
+    base::ByteRange range = {0, static_cast<uint64_t>(sb.st_size)};
+    common::http::http_status status = common::http::HS_OK;
+    off_t content_size = sb.st_size;
+    if (base::GetByteRange(hrequest, sb.st_size, etag, sb.st_mtime, &range)) {
+      status = common::http::HS_PARTIAL_CONTENT;
+      cache_headers += "\r\n" + base::MakeContentRangeHeader(range, sb.st_size);
+      content_size = range.length;
+    }
+
+    common::ErrnoError err = hclient->SendHeaders(protocol, status, cache_headers.c_str(), mime.c_str(), &content_size,
+                                                  &sb.st_mtime, IsKeepAlive, hinf);
     if (err) {
       DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
-      ::close(file);
+      if (file != INVALID_DESCRIPTOR) {
+        ::close(file);
+      }
       goto finish;
     }
 
-    if (hrequest.GetMethod() == common::http::http_method::HM_GET) {
-      common::ErrnoError err = hclient->SendFileByFd(protocol, file, sb.st_size);
-      if (err) {
-        DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    if (body) {
+      err = hclient->SendBody(protocol, body->data() + range.start, range.length);
+    } else {
+#if defined(OS_LINUX)
+      if (protocol != common::http::HP_2_0) {
+        err = SendFileToSocket(hclient->GetFd(), file, range.length, range.start);
       } else {
-        DEBUG_LOG() << "Sent file path: " << file_path_str << ", size: " << sb.st_size;
+        err = SendFileRange(hclient, protocol, file, range);
       }
+#else
+      err = SendFileRange(hclient, protocol, file, range);
+#endif
+    }
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
+    } else {
+      DEBUG_LOG() << "Sent file path: " << file_path_str << ", size: " << content_size;
     }
 
-    ::close(file);
+    if (file != INVALID_DESCRIPTOR) {
+      ::close(file);
+    }
   }
 
 finish:
-  if (!IsKeepAlive) {
-    ignore_result(hclient->Close());
-    delete hclient;
-  }
+  return IsKeepAlive;
 }
 
 }  // namespace server
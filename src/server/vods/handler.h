@@ -14,6 +14,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include <common/file_system/path.h>
 
 #include "server/base/iserver_handler.h"
@@ -22,18 +29,24 @@ namespace fastocloud {
 namespace server {
 
 class VodsClient;
+class SegmentCache;
+class TsIndex;
 namespace base {
 class IHttpRequestsObserver;
 }
 
 class VodsHandler : public base::IServerHandler {
  public:
-  enum { BUF_SIZE = 4096 };
   typedef base::IServerHandler base_class;
   typedef common::file_system::ascii_directory_string_path http_directory_path_t;
   explicit VodsHandler(base::IHttpRequestsObserver* observer);
 
   void SetHttpRoot(const http_directory_path_t& http_root);
+  void SetSegmentCache(SegmentCache* cache);  // not owned
+  // <file>.ts.m3u8 and <file>.ts.<n>.ts served from keyframe index of ts file, no child started
+  void SetVirtualHls(bool virtual_hls);
+  // accepted clients handed off round robin, handler shared between accepting loop and workers
+  void SetWorkers(const std::vector<common::libev::IoLoop*>& workers);  // not owned, before loops started
 
   void PreLooped(common::libev::IoLoop* server) override;
 
@@ -51,10 +64,21 @@ class VodsHandler : public base::IServerHandler {
   void PostLooped(common::libev::IoLoop* server) override;
 
  private:
-  void ProcessReceived(VodsClient* hclient, const char* request, size_t req_len);
+  bool ProcessReceived(VodsClient* hclient, const std::string& request);  // false if connection should be closed
+  bool ProcessFrames(VodsClient* hclient, const std::string& frames);     // false if connection should be closed
+  bool ProcessRequest(VodsClient* hclient, const common::http::HttpRequest& hrequest);  // keep alive
+  bool IsWorker(common::libev::IoLoop* loop) const;
+  bool ReadVirtualHls(const common::file_system::ascii_file_string_path& file, std::string* body, time_t* mtime);
+  std::shared_ptr<const TsIndex> FindTsIndex(const std::string& source);
 
   http_directory_path_t http_root_;
+  SegmentCache* segment_cache_;
+  bool virtual_hls_;
+  std::mutex indexes_mutex_;
+  std::map<std::string, std::shared_ptr<const TsIndex>> indexes_;  // by source file
   base::IHttpRequestsObserver* const observer_;
+  std::vector<common::libev::IoLoop*> workers_;
+  std::atomic<size_t> next_worker_;
 };
 
 }  // namespace server
@@ -0,0 +1,284 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/vods/ts_index.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <common/sprintf.h>
+
+#define TS_PACKET_SIZE 188
+#define TS_SYNC_BYTE 0x47
+#define TS_READ_PACKETS 1024
+#define PAT_PID 0
+#define PTS_MASK 0x1FFFFFFFFLL  // 33 bits of 90 khz clock
+
+namespace fastocloud {
+namespace server {
+namespace {
+
+bool is_video_stream_type(uint8_t type) {
+  return type == 0x01 || type == 0x02 || type == 0x10 || type == 0x1B || type == 0x24;  // mpeg, h264, h265
+}
+
+int64_t pts_diff(int64_t to, int64_t from) {
+  return (to - from) & PTS_MASK;
+}
+
+// one pass over packets, cuts segments on random access points
+class Scanner {
+ public:
+  Scanner(uint32_t target_msec, TsIndex::segments_t* segments, std::string* psi)
+      : target_pts_(static_cast<int64_t>(target_msec) * 90),
+        segments_(segments),
+        psi_(psi),
+        pmt_pid_(-1),
+        es_pid_(-1),
+        pat_(),
+        segment_pts_(-1),
+        last_pts_(-1),
+        segment_offset_(0),
+        random_access_(false) {}
+
+  void HandlePacket(const uint8_t* packet, uint64_t offset) {
+    const int pid = ((packet[1] & 0x1F) << 8) | packet[2];
+    const bool unit_start = packet[1] & 0x40;
+    const uint8_t adaptation = (packet[3] >> 4) & 0x3;
+    size_t payload = 4;
+    bool random_access = false;
+    if (adaptation & 0x2) {
+      const uint8_t length = packet[4];
+      random_access = length && (packet[5] & 0x40);
+      payload += 1 + length;
+    }
+    if (!(adaptation & 0x1) || payload >= TS_PACKET_SIZE) {
+      return;
+    }
+
+    if (pid == PAT_PID && unit_start && pmt_pid_ == -1) {
+      ParsePat(packet + payload, TS_PACKET_SIZE - payload);
+      pat_.assign(reinterpret_cast<const char*>(packet), TS_PACKET_SIZE);
+    } else if (pid == pmt_pid_ && unit_start && es_pid_ == -1) {
+      ParsePmt(packet + payload, TS_PACKET_SIZE - payload);
+      if (es_pid_ != -1) {
+        *psi_ = pat_ + std::string(reinterpret_cast<const char*>(packet), TS_PACKET_SIZE);
+      }
+    } else if (pid == es_pid_ && unit_start) {
+      int64_t pts = 0;
+      if (!ParsePts(packet + payload, TS_PACKET_SIZE - payload, &pts)) {
+        return;
+      }
+
+      random_access_ |= random_access;
+      if (segment_pts_ == -1) {
+        segment_pts_ = pts;
+      } else if (random_access && pts_diff(pts, segment_pts_) >= target_pts_) {
+        AddSegment(offset, pts_diff(pts, segment_pts_));
+        segment_pts_ = pts;
+      }
+      last_pts_ = pts;
+    }
+  }
+
+  bool Finish(uint64_t size) {
+    if (!random_access_ || segment_pts_ == -1) {
+      return false;
+    }
+
+    AddSegment(size, pts_diff(last_pts_, segment_pts_));
+    return true;
+  }
+
+ private:
+  void AddSegment(uint64_t end, int64_t duration_pts) {
+    segments_->push_back({segment_offset_, end - segment_offset_, duration_pts / 90000.0});
+    segment_offset_ = end;
+  }
+
+  void ParsePat(const uint8_t* data, size_t size) {
+    const size_t pointer = data[0];
+    if (1 + pointer + 8 > size) {
+      return;
+    }
+    const uint8_t* section = data + 1 + pointer;
+    const size_t section_length = ((section[1] & 0x0F) << 8) | section[2];
+    const size_t end = std::min<size_t>(3 + section_length - 4, size - 1 - pointer);
+    for (size_t i = 8; i + 4 <= end; i += 4) {
+      const int program = (section[i] << 8) | section[i + 1];
+      if (program) {
+        pmt_pid_ = ((section[i + 2] & 0x1F) << 8) | section[i + 3];
+        return;
+      }
+    }
+  }
+
+  void ParsePmt(const uint8_t* data, size_t size) {
+    const size_t pointer = data[0];
+    if (1 + pointer + 12 > size) {
+      return;
+    }
+    const uint8_t* section = data + 1 + pointer;
+    const size_t section_length = ((section[1] & 0x0F) << 8) | section[2];
+    const size_t end = std::min<size_t>(3 + section_length - 4, size - 1 - pointer);
+    const size_t program_info = ((section[10] & 0x0F) << 8) | section[11];
+    int first_pid = -1;
+    for (size_t i = 12 + program_info; i + 5 <= end;) {
+      const uint8_t type = section[i];
+      const int pid = ((section[i + 1] & 0x1F) << 8) | section[i + 2];
+      if (is_video_stream_type(type)) {
+        es_pid_ = pid;
+        return;
+      }
+      if (first_pid == -1) {
+        first_pid = pid;
+      }
+      i += 5 + (((section[i + 3] & 0x0F) << 8) | section[i + 4]);
+    }
+    es_pid_ = first_pid;  // audio only
+  }
+
+  static bool ParsePts(const uint8_t* pes, size_t size, int64_t* pts) {
+    if (size < 14 || pes[0] != 0 || pes[1] != 0 || pes[2] != 1 || !(pes[7] & 0x80)) {
+      return false;
+    }
+    const uint8_t* p = pes + 9;
+    *pts = (static_cast<int64_t>(p[0] & 0x0E) << 29) | (p[1] << 22) | ((p[2] & 0xFE) << 14) | (p[3] << 7) |
+           (p[4] >> 1);
+    return true;
+  }
+
+  const int64_t target_pts_;
+  TsIndex::segments_t* const segments_;
+  std::string* const psi_;
+  int pmt_pid_;
+  int es_pid_;
+  std::string pat_;
+  int64_t segment_pts_;
+  int64_t last_pts_;
+  uint64_t segment_offset_;
+  bool random_access_;  // files without marked keyframes can't be cut
+};
+
+}  // namespace
+
+TsIndex::TsIndex() : segments_(), psi_(), mtime_(0), size_(0) {}
+
+bool TsIndex::Build(const std::string& path, uint32_t target_msec) {
+  segments_.clear();
+  psi_.clear();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat sb;
+  if (fstat(fd, &sb) < 0) {
+    close(fd);
+    return false;
+  }
+
+  Scanner scanner(target_msec, &segments_, &psi_);
+  std::vector<uint8_t> buffer(TS_PACKET_SIZE * TS_READ_PACKETS);
+  uint64_t offset = 0;
+  bool valid = true;
+  while (valid) {
+    ssize_t readed = pread(fd, buffer.data(), buffer.size(), offset);
+    if (readed < TS_PACKET_SIZE) {
+      break;
+    }
+
+    const size_t packets = readed / TS_PACKET_SIZE;
+    for (size_t i = 0; i < packets; ++i) {
+      const uint8_t* packet = buffer.data() + i * TS_PACKET_SIZE;
+      if (packet[0] != TS_SYNC_BYTE) {  // m2ts or damaged, not sliced
+        valid = false;
+        break;
+      }
+      scanner.HandlePacket(packet, offset + i * TS_PACKET_SIZE);
+    }
+    offset += packets * TS_PACKET_SIZE;
+  }
+  close(fd);
+
+  if (!valid || psi_.empty() || !scanner.Finish(offset)) {
+    segments_.clear();
+    return false;
+  }
+
+  mtime_ = sb.st_mtime;
+  size_ = sb.st_size;
+  return true;
+}
+
+const TsIndex::segments_t& TsIndex::GetSegments() const {
+  return segments_;
+}
+
+time_t TsIndex::GetMtime() const {
+  return mtime_;
+}
+
+uint64_t TsIndex::GetSize() const {
+  return size_;
+}
+
+std::string TsIndex::RenderPlaylist(const std::string& segment_prefix) const {
+  double target = 0;
+  std::string chunks;
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    target = std::max(target, segments_[i].duration);
+    chunks += common::MemSPrintf("#EXTINF:%.3f,\n%s%lu.ts\n", segments_[i].duration, segment_prefix.c_str(), i);
+  }
+  return common::MemSPrintf("#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-PLAYLIST-TYPE:VOD\n#EXT-X-MEDIA-SEQUENCE:0\n"
+                            "#EXT-X-TARGETDURATION:%d\n",
+                            static_cast<int>(ceil(target))) +
+         chunks + "#EXT-X-ENDLIST\n";
+}
+
+bool TsIndex::ReadSegment(const std::string& path, size_t index, std::string* data) const {
+  if (index >= segments_.size() || !data) {
+    return false;
+  }
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  const Segment& segment = segments_[index];
+  const size_t head = index ? psi_.size() : 0;  // first segment starts with pat and pmt of file
+  data->assign(head + segment.size, 0);
+  memcpy(&(*data)[0], psi_.data(), head);
+  size_t readed = 0;
+  while (readed < segment.size) {
+    ssize_t res = pread(fd, &(*data)[head + readed], segment.size - readed, segment.offset + readed);
+    if (res <= 0) {
+      close(fd);
+      return false;
+    }
+    readed += res;
+  }
+  close(fd);
+  return true;
+}
+
+}  // namespace server
+}  // namespace fastocloud
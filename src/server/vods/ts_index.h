@@ -0,0 +1,62 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace server {
+
+// keyframe index of mpeg-ts vod file, hls segments served as byte ranges of file without remux
+class TsIndex {
+ public:
+  struct Segment {
+    uint64_t offset;
+    uint64_t size;
+    double duration;  // in seconds
+  };
+  typedef std::vector<Segment> segments_t;
+
+  TsIndex();
+
+  // segments cut on random access points of video (or first) stream after target duration,
+  // false if file is not ts or has no random access points marked
+  bool Build(const std::string& path, uint32_t target_msec);
+
+  const segments_t& GetSegments() const;
+  time_t GetMtime() const;
+  uint64_t GetSize() const;
+
+  // segment uris are prefix + index + ".ts"
+  std::string RenderPlaylist(const std::string& segment_prefix) const;
+  bool ReadSegment(const std::string& path, size_t index, std::string* data) const;  // psi prepended after first
+
+ private:
+  segments_t segments_;
+  std::string psi_;  // first pat and pmt packets
+  time_t mtime_;
+  uint64_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(TsIndex);
+};
+
+}  // namespace server
+}  // namespace fastocloud
@@ -0,0 +1,455 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "server/zygote.h"
+
+#if defined(OS_LINUX)
+#include <sys/prctl.h>
+#endif
+
+#include <dlfcn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <common/file_system/file_system.h>
+#include <common/file_system/string_path_utils.h>
+
+#include "base/stream_config_parse.h"
+
+#include "server/pipe/client.h"
+
+namespace {
+
+typedef int (*stream_exec_t)(const char* process_name, const void* args, void* command_client);
+typedef int (*stream_prepare_t)(int argc, char** argv);
+
+struct SpawnRequest {
+  uint32_t name_size;
+  uint32_t config_size;
+};
+
+struct SpawnResponce {
+  int32_t pid;
+  int32_t error;
+};
+
+common::ErrnoError WriteAll(common::net::socket_descr_t fd, const void* data, size_t size) {
+  const char* ptr = static_cast<const char*>(data);
+  while (size) {
+    ssize_t res = send(fd, ptr, size, MSG_NOSIGNAL);
+    if (res == ERROR_RESULT_VALUE) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return common::make_errno_error(errno);
+    }
+    ptr += res;
+    size -= res;
+  }
+  return common::ErrnoError();
+}
+
+common::ErrnoError ReadAll(common::net::socket_descr_t fd, void* data, size_t size) {
+  char* ptr = static_cast<char*>(data);
+  while (size) {
+    ssize_t res = recv(fd, ptr, size, 0);
+    if (res == ERROR_RESULT_VALUE) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return common::make_errno_error(errno);
+    }
+    if (res == 0) {
+      return common::make_errno_error("Zygote control socket closed", ECONNRESET);
+    }
+    ptr += res;
+    size -= res;
+  }
+  return common::ErrnoError();
+}
+
+common::ErrnoError SendRequest(common::net::socket_descr_t fd, const SpawnRequest& req, const int fds[2]) {
+  struct iovec iov;
+  iov.iov_base = const_cast<SpawnRequest*>(&req);
+  iov.iov_len = sizeof(req);
+
+  char control[CMSG_SPACE(sizeof(int) * 2)] = {0};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int) * 2);
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * 2);
+
+  while (sendmsg(fd, &msg, MSG_NOSIGNAL) == ERROR_RESULT_VALUE) {
+    if (errno != EINTR) {
+      return common::make_errno_error(errno);
+    }
+  }
+  return common::ErrnoError();
+}
+
+common::ErrnoError ReceiveRequest(common::net::socket_descr_t fd, SpawnRequest* req, int fds[2]) {
+  struct iovec iov;
+  iov.iov_base = req;
+  iov.iov_len = sizeof(*req);
+
+  char control[CMSG_SPACE(sizeof(int) * 2)] = {0};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t res;
+  while ((res = recvmsg(fd, &msg, MSG_WAITALL)) == ERROR_RESULT_VALUE) {
+    if (errno != EINTR) {
+      return common::make_errno_error(errno);
+    }
+  }
+
+  if (res != sizeof(*req)) {
+    return common::make_errno_error("Zygote control socket closed", ECONNRESET);
+  }
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (!cmsg || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(sizeof(int) * 2)) {
+    return common::make_errno_error("Zygote request without descriptors", EINVAL);
+  }
+
+  memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * 2);
+  return common::ErrnoError();
+}
+
+void SetProcessName(int argc, char** argv, const std::string& new_process_name) {
+  const char* new_name = new_process_name.c_str();
+#if defined(OS_LINUX)
+  for (int i = 0; i < argc; ++i) {
+    memset(argv[i], 0, strlen(argv[i]));
+  }
+  char* app_name = argv[0];
+  strncpy(app_name, new_name, new_process_name.length());
+  app_name[new_process_name.length()] = 0;
+  prctl(PR_SET_NAME, new_name);
+#elif defined(OS_FREEBSD)
+  UNUSED(argc);
+  UNUSED(argv);
+  setproctitle(new_name);
+#else
+#pragma message "Please implement"
+#endif
+}
+
+void CloseDescriptor(common::net::socket_descr_t fd) {
+  common::ErrnoError errn = common::file_system::close_descriptor(fd);
+  if (errn) {
+    DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+  }
+}
+
+int ZygoteMain(common::net::socket_descr_t control, fastocloud::server::Zygote::Mode mode, int argc, char** argv) {
+  const bool thread_streams = mode == fastocloud::server::Zygote::THREAD_STREAMS;
+  const std::string absolute_source_dir = common::file_system::absolute_path_from_relative(RELATIVE_SOURCE_DIR);
+  const std::string lib_full_path = common::file_system::make_path(absolute_source_dir, CORE_LIBRARY);
+  void* handle = dlopen(lib_full_path.c_str(), RTLD_NOW);
+  if (!handle) {
+    ERROR_LOG() << "Failed to load " CORE_LIBRARY " path: " << lib_full_path << ", error: " << dlerror();
+    return EXIT_FAILURE;
+  }
+
+  stream_exec_t stream_exec_func =
+      reinterpret_cast<stream_exec_t>(dlsym(handle, thread_streams ? "stream_exec_hosted" : "stream_exec"));
+  stream_prepare_t stream_prepare_func = reinterpret_cast<stream_prepare_t>(dlsym(handle, "stream_prepare"));
+  if (!stream_exec_func || !stream_prepare_func) {
+    ERROR_LOG() << "Failed to load stream functions error: " << dlerror();
+    dlclose(handle);
+    return EXIT_FAILURE;
+  }
+
+  SetProcessName(argc, argv, thread_streams ? STREAMER_NAME "_relay_host" : STREAMER_NAME "_zygote");
+  stream_prepare_func(0, nullptr);
+  INFO_LOG() << (thread_streams ? "Relay host" : "Zygote") << " ready, pid: " << getpid();
+
+  while (true) {
+    SpawnRequest req;
+    int fds[2] = {INVALID_DESCRIPTOR, INVALID_DESCRIPTOR};
+    common::ErrnoError err = ReceiveRequest(control, &req, fds);
+    if (err) {
+      break;
+    }
+
+    std::string process_name(req.name_size, 0);
+    std::string config_json(req.config_size, 0);
+    err = ReadAll(control, &process_name[0], process_name.size());
+    if (!err) {
+      err = ReadAll(control, &config_json[0], config_json.size());
+    }
+    if (err) {
+      CloseDescriptor(fds[0]);
+      CloseDescriptor(fds[1]);
+      break;
+    }
+
+    fastocloud::StreamConfig config_args(fastocloud::MakeConfigFromJson(config_json).release());
+    if (!config_args) {
+      CloseDescriptor(fds[0]);
+      CloseDescriptor(fds[1]);
+      SpawnResponce resp = {-1, EINVAL};
+      ignore_result(WriteAll(control, &resp, sizeof(resp)));
+      continue;
+    }
+
+    if (thread_streams) {
+      // pipe ends owned by stream thread, crash of one stream restarts all streams of host
+      std::thread([stream_exec_func, process_name, config_args, fds]() {
+        fastocloud::server::pipe::Client* client = new fastocloud::server::pipe::Client(nullptr, fds[0], fds[1]);
+        client->SetName(fastocloud::GetSid(config_args));
+        stream_exec_func(process_name.c_str(), config_args.get(), client);
+        client->Close();
+        delete client;
+      }).detach();
+      SpawnResponce resp = {getpid(), 0};
+      ignore_result(WriteAll(control, &resp, sizeof(resp)));
+      continue;
+    }
+
+    // double fork, so stream process will be adopted by daemon (child subreaper)
+    pid_t intermediate = fork();
+    if (intermediate == 0) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        CloseDescriptor(control);
+        SetProcessName(argc, argv, process_name);
+        fastocloud::server::pipe::Client* client = new fastocloud::server::pipe::Client(nullptr, fds[0], fds[1]);
+        client->SetName(fastocloud::GetSid(config_args));
+        int res = stream_exec_func(process_name.c_str(), config_args.get(), client);
+        client->Close();
+        delete client;
+        _exit(res);
+      }
+
+      SpawnResponce resp = {pid, pid < 0 ? errno : 0};
+      ignore_result(WriteAll(control, &resp, sizeof(resp)));
+      _exit(EXIT_SUCCESS);
+    } else if (intermediate < 0) {
+      SpawnResponce resp = {-1, errno};
+      ignore_result(WriteAll(control, &resp, sizeof(resp)));
+    } else {
+      waitpid(intermediate, nullptr, 0);
+    }
+
+    CloseDescriptor(fds[0]);
+    CloseDescriptor(fds[1]);
+  }
+
+  if (thread_streams) {
+    // streams still running go away with process, library stays loaded for them
+    INFO_LOG() << "Relay host finished";
+    return EXIT_SUCCESS;
+  }
+
+  INFO_LOG() << "Zygote finished";
+  dlclose(handle);
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+namespace fastocloud {
+namespace server {
+
+common::ErrnoError PrebuildStreamRegistry(const std::string& registry_path) {
+  if (registry_path.empty()) {
+    return common::make_errno_error_inval();
+  }
+
+  if (setenv("GST_REGISTRY", registry_path.c_str(), 1) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    const std::string absolute_source_dir = common::file_system::absolute_path_from_relative(RELATIVE_SOURCE_DIR);
+    const std::string lib_full_path = common::file_system::make_path(absolute_source_dir, CORE_LIBRARY);
+    void* handle = dlopen(lib_full_path.c_str(), RTLD_NOW);
+    if (!handle) {
+      _exit(EXIT_FAILURE);
+    }
+
+    stream_prepare_t stream_prepare_func = reinterpret_cast<stream_prepare_t>(dlsym(handle, "stream_prepare"));
+    if (!stream_prepare_func) {
+      _exit(EXIT_FAILURE);
+    }
+
+    // registry written by gst_init
+    _exit(stream_prepare_func(0, nullptr));
+  } else if (pid < 0) {
+    return common::make_errno_error(errno);
+  }
+
+  int status = 0;
+  while (waitpid(pid, &status, 0) == ERROR_RESULT_VALUE) {
+    if (errno != EINTR) {
+      return common::make_errno_error(errno);
+    }
+  }
+
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+    return common::make_errno_error("Failed to build stream registry", ECHILD);
+  }
+
+  // plugins installed later seen after daemon restart
+  if (setenv("GST_REGISTRY_UPDATE", "no", 1) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+  return common::ErrnoError();
+}
+
+Zygote::Zygote(Mode mode) : mode_(mode), pid_(0), control_(INVALID_DESCRIPTOR) {}
+
+Zygote::~Zygote() {
+  Stop();
+}
+
+common::ErrnoError Zygote::Start(int argc, char** argv) {
+  if (IsRunning()) {
+    return common::make_errno_error("Zygote already started", EINVAL);
+  }
+
+#if defined(OS_LINUX)
+  if (prctl(PR_SET_CHILD_SUBREAPER, 1) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+#else
+  UNUSED(argc);
+  UNUSED(argv);
+  return common::make_errno_error("Zygote not supported on this platform", ENOTSUP);
+#endif
+
+  int socks[2] = {INVALID_DESCRIPTOR, INVALID_DESCRIPTOR};
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, socks) == ERROR_RESULT_VALUE) {
+    return common::make_errno_error(errno);
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    CloseDescriptor(socks[0]);
+    int res = ZygoteMain(socks[1], mode_, argc, argv);
+    _exit(res);
+  } else if (pid < 0) {
+    common::ErrnoError err = common::make_errno_error(errno);
+    CloseDescriptor(socks[0]);
+    CloseDescriptor(socks[1]);
+    return err;
+  }
+
+  CloseDescriptor(socks[1]);
+  control_ = socks[0];
+  pid_ = pid;
+  return common::ErrnoError();
+}
+
+void Zygote::Stop() {
+  if (!IsRunning()) {
+    return;
+  }
+
+  const pid_t pid = pid_;
+  Close();
+  waitpid(pid, nullptr, 0);
+}
+
+bool Zygote::IsRunning() const {
+  return control_ != INVALID_DESCRIPTOR;
+}
+
+Zygote::Mode Zygote::GetMode() const {
+  return mode_;
+}
+
+pid_t Zygote::GetProcessID() const {
+  return pid_;
+}
+
+void Zygote::SetExited() {
+  Close();
+}
+
+common::ErrnoError Zygote::SpawnStream(const std::string& process_name,
+                                       const StreamConfig& config_args,
+                                       common::net::socket_descr_t read_command_client,
+                                       common::net::socket_descr_t write_responce_client,
+                                       pid_t* pid) {
+  if (!pid || !config_args) {
+    return common::make_errno_error_inval();
+  }
+
+  if (!IsRunning()) {
+    return common::make_errno_error("Zygote not running", ENOTCONN);
+  }
+
+  std::string config_json;
+  if (!MakeJsonFromConfig(config_args, &config_json)) {
+    return common::make_errno_error("Failed to serialize stream config", EINVAL);
+  }
+
+  SpawnRequest req = {static_cast<uint32_t>(process_name.size()), static_cast<uint32_t>(config_json.size())};
+  const int fds[2] = {read_command_client, write_responce_client};
+  common::ErrnoError err = SendRequest(control_, req, fds);
+  if (!err) {
+    err = WriteAll(control_, process_name.data(), process_name.size());
+  }
+  if (!err) {
+    err = WriteAll(control_, config_json.data(), config_json.size());
+  }
+
+  SpawnResponce resp;
+  if (!err) {
+    err = ReadAll(control_, &resp, sizeof(resp));
+  }
+
+  if (err) {
+    // zygote is broken, callers should fallback to plain fork
+    Close();
+    return err;
+  }
+
+  if (resp.pid <= 0) {
+    return common::make_errno_error("Zygote failed to fork stream", resp.error ? resp.error : ECHILD);
+  }
+
+  *pid = resp.pid;
+  return common::ErrnoError();
+}
+
+void Zygote::Close() {
+  if (control_ != INVALID_DESCRIPTOR) {
+    CloseDescriptor(control_);
+    control_ = INVALID_DESCRIPTOR;
+  }
+  pid_ = 0;
+}
+
+}  // namespace server
+}  // namespace fastocloud
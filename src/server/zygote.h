@@ -0,0 +1,71 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <string>
+
+#include <common/error.h>
+#include <common/net/types.h>
+
+#include "base/stream_config.h"
+
+namespace fastocloud {
+namespace server {
+
+// gstreamer registry cache written once by helper process and pinned in environment,
+// so zygote, relay hosts and plain forked streams load it instead of scanning plugins
+common::ErrnoError PrebuildStreamRegistry(const std::string& registry_path) WARN_UNUSED_RESULT;
+
+// Long-lived helper process which loads CORE_LIBRARY and initializes stream backend once,
+// then forks ready-to-run stream processes on request over control socket.
+// Spawned processes are reparented to the daemon (child subreaper), so it can track them as own childs.
+// In relay host mode streams run as threads of the helper itself, process exit ends all of them.
+class Zygote {
+ public:
+  enum Mode { FORK_STREAMS = 0, THREAD_STREAMS = 1 };
+
+  explicit Zygote(Mode mode = FORK_STREAMS);
+  ~Zygote();
+
+  common::ErrnoError Start(int argc, char** argv) WARN_UNUSED_RESULT;
+  void Stop();
+
+  bool IsRunning() const;
+  Mode GetMode() const;
+  pid_t GetProcessID() const;  // 0 if not running
+  void SetExited();            // process already reaped by loop
+
+  // pid of stream process, or of helper in relay host mode
+  // read_command_client and write_responce_client are stream side pipe ends, caller still owns them
+  common::ErrnoError SpawnStream(const std::string& process_name,
+                                 const StreamConfig& config_args,
+                                 common::net::socket_descr_t read_command_client,
+                                 common::net::socket_descr_t write_responce_client,
+                                 pid_t* pid) WARN_UNUSED_RESULT;
+
+ private:
+  void Close();
+
+  const Mode mode_;
+  pid_t pid_;
+  common::net::socket_descr_t control_;
+
+  DISALLOW_COPY_AND_ASSIGN(Zygote);
+};
+
+}  // namespace server
+}  // namespace fastocloud
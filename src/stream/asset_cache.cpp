@@ -0,0 +1,85 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/asset_cache.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <common/file_system/file_system.h>
+#include <common/sprintf.h>
+
+#include "stream/elements/video/video.h"
+
+namespace {
+uint64_t Fnv1a(const std::string& data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+}  // namespace
+
+namespace fastocloud {
+namespace stream {
+
+AssetCache::AssetCache(const common::file_system::ascii_directory_string_path& dir) : dir_(dir) {}
+
+bool AssetCache::GetPicture(const std::string& picture_path, int width, int height, std::string* png_path) const {
+  if (!png_path) {
+    return false;
+  }
+
+  std::string content;
+  if (!common::file_system::read_file_to_string(picture_path, &content)) {
+    return false;
+  }
+
+  const auto cached = dir_.MakeFileStringPath(MakePictureName(content, width, height));
+  if (!cached) {
+    return false;
+  }
+
+  const std::string cached_path = cached->GetPath();
+  if (common::file_system::is_file_exist(cached_path)) {
+    *png_path = cached_path;
+    return true;
+  }
+
+  // other streams may render the same picture, renamed when complete
+  const std::string tmp_path = common::MemSPrintf("%s.%d.tmp", cached_path, getpid());
+  if (!elements::video::render_picture(picture_path, width, height, tmp_path)) {
+    ignore_result(common::file_system::remove_file(tmp_path));
+    return false;
+  }
+
+  if (rename(tmp_path.c_str(), cached_path.c_str()) != 0) {
+    ignore_result(common::file_system::remove_file(tmp_path));
+    return false;
+  }
+
+  *png_path = cached_path;
+  return true;
+}
+
+std::string AssetCache::MakePictureName(const std::string& content, int width, int height) {
+  const unsigned long long hash = Fnv1a(content);
+  return common::MemSPrintf("%016llx_%dx%d.png", hash, width > 0 ? width : 0, height > 0 ? height : 0);
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,40 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <common/file_system/path.h>
+
+namespace fastocloud {
+namespace stream {
+
+// logo pictures decoded and scaled once, shared by streams of node through dir,
+// named by hash of picture content and size, changed picture gets new name
+class AssetCache {
+ public:
+  explicit AssetCache(const common::file_system::ascii_directory_string_path& dir);
+
+  // png of picture at size (0 - own size), rendered on miss
+  bool GetPicture(const std::string& picture_path, int width, int height, std::string* png_path) const;
+
+  static std::string MakePictureName(const std::string& content, int width, int height);
+
+ private:
+  const common::file_system::ascii_directory_string_path dir_;
+};
+
+}  // namespace stream
+}  // namespace fastocloud
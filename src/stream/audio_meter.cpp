@@ -0,0 +1,151 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/audio_meter.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+namespace {
+double to_db(double value, double factor) {
+  if (value <= 0) {
+    return fastocloud::stream::AudioMeter::min_db;
+  }
+  return std::max(factor * log10(value), static_cast<double>(fastocloud::stream::AudioMeter::min_db));
+}
+}  // namespace
+
+namespace fastocloud {
+namespace stream {
+
+AudioMeter::AudioMeter(fastotv::timestamp_t interval_msec)
+    : interval_msec_(interval_msec ? interval_msec : static_cast<fastotv::timestamp_t>(default_interval_msec)),
+      format_(FORMAT_UNKNOWN),
+      stride_(0),
+      channels_(0),
+      sample_size_(0),
+      rate_(0),
+      interval_frames_(0),
+      frames_(0),
+      sum_(),
+      peak_(),
+      silence_frames_(0) {}
+
+bool AudioMeter::SetFormat(Format format, size_t channels, int rate) {
+  format_ = FORMAT_UNKNOWN;
+  silence_frames_ = 0;
+  Reset();
+  if (channels == 0 || rate <= 0) {
+    return false;
+  }
+
+  switch (format) {
+    case FORMAT_S16:
+      sample_size_ = sizeof(int16_t);
+      break;
+    case FORMAT_S32:
+      sample_size_ = sizeof(int32_t);
+      break;
+    case FORMAT_F32:
+      sample_size_ = sizeof(float);
+      break;
+    case FORMAT_F64:
+      sample_size_ = sizeof(double);
+      break;
+    default:
+      return false;
+  }
+
+  format_ = format;
+  stride_ = channels;
+  channels_ = std::min(channels, static_cast<size_t>(max_channels));
+  rate_ = rate;
+  interval_frames_ = std::max(static_cast<size_t>(rate * interval_msec_ / 1000), static_cast<size_t>(1));
+  return true;
+}
+
+bool AudioMeter::IsActive() const {
+  return format_ != FORMAT_UNKNOWN;
+}
+
+bool AudioMeter::Process(const void* data, size_t size, Levels* levels) {
+  if (!data || !levels || !IsActive()) {
+    return false;
+  }
+
+  const size_t frames = size / (sample_size_ * stride_);
+  switch (format_) {
+    case FORMAT_S16:
+      Accumulate(static_cast<const int16_t*>(data), frames, 1.0 / 32768.0);
+      break;
+    case FORMAT_S32:
+      Accumulate(static_cast<const int32_t*>(data), frames, 1.0 / 2147483648.0);
+      break;
+    case FORMAT_F32:
+      Accumulate(static_cast<const float*>(data), frames, 1.0);
+      break;
+    case FORMAT_F64:
+      Accumulate(static_cast<const double*>(data), frames, 1.0);
+      break;
+    default:
+      return false;
+  }
+
+  if (frames_ < interval_frames_) {
+    return false;
+  }
+
+  bool silence = true;
+  levels->channels = channels_;
+  for (size_t c = 0; c < channels_; ++c) {
+    levels->rms_db[c] = to_db(sum_[c] / frames_, 10);  // power
+    levels->peak_db[c] = to_db(peak_[c], 20);
+    silence &= levels->peak_db[c] < silence_db;
+  }
+  silence_frames_ = silence ? silence_frames_ + frames_ : 0;
+  levels->silence_msec = silence_frames_ * 1000 / rate_;
+  Reset();
+  return true;
+}
+
+int AudioMeter::GetLoudest(const Levels& levels, bool peak) {
+  double loudest = min_db;
+  for (size_t c = 0; c < levels.channels && c < max_channels; ++c) {
+    loudest = std::max(loudest, peak ? levels.peak_db[c] : levels.rms_db[c]);
+  }
+  return static_cast<int>(loudest);
+}
+
+template <typename T>
+void AudioMeter::Accumulate(const T* samples, size_t frames, double scale) {
+  for (size_t f = 0; f < frames; ++f) {
+    const T* frame = samples + f * stride_;
+    for (size_t c = 0; c < channels_; ++c) {
+      const double value = frame[c] * scale;
+      sum_[c] += value * value;
+      peak_[c] = std::max(peak_[c], fabs(value));
+    }
+  }
+  frames_ += frames;
+}
+
+void AudioMeter::Reset() {
+  frames_ = 0;
+  std::fill(sum_, sum_ + max_channels, 0.0);
+  std::fill(peak_, peak_ + max_channels, 0.0);
+}
+
+}  // namespace stream
+}  // namespace fastocloud
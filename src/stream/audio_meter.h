@@ -0,0 +1,70 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <fastotv/types.h>
+
+#include "base/types.h"
+
+namespace fastocloud {
+namespace stream {
+
+// rms and peak per channel of interleaved raw audio over interval, without level element bus messages
+class AudioMeter {
+ public:
+  enum Format { FORMAT_UNKNOWN, FORMAT_S16, FORMAT_S32, FORMAT_F32, FORMAT_F64 };
+  enum { max_channels = 8, default_interval_msec = 100, min_db = AUDIO_LEVEL_MIN_DB, silence_db = -60 };
+
+  struct Levels {
+    size_t channels;
+    double rms_db[max_channels];
+    double peak_db[max_channels];
+    fastotv::timestamp_t silence_msec;  // peak of every channel below silence_db for
+  };
+
+  explicit AudioMeter(fastotv::timestamp_t interval_msec = default_interval_msec);
+
+  // channels over max_channels not metered, false if format not supported and metering stopped
+  bool SetFormat(Format format, size_t channels, int rate);
+  bool IsActive() const;
+
+  // true if interval completed and levels filled
+  bool Process(const void* data, size_t size, Levels* levels);
+
+  static int GetLoudest(const Levels& levels, bool peak);  // db of loudest channel, min_db if no channels
+
+ private:
+  template <typename T>
+  void Accumulate(const T* samples, size_t frames, double scale);
+  void Reset();
+
+  const fastotv::timestamp_t interval_msec_;
+  Format format_;
+  size_t stride_;    // interleaved channels
+  size_t channels_;  // metered channels
+  size_t sample_size_;
+  int rate_;
+  size_t interval_frames_;
+  size_t frames_;
+  double sum_[max_channels];
+  double peak_[max_channels];
+  uint64_t silence_frames_;
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,179 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/autoplug_cache.h"
+
+#include <fstream>
+
+#include <common/convert2string.h>
+
+#define AUTOPLUG_CACHE_INPUT "input"
+#define AUTOPLUG_CACHE_CAPS "caps"
+#define AUTOPLUG_CACHE_FACTORY "factory"
+#define AUTOPLUG_CACHE_ENCODER "encoder"
+
+namespace fastocloud {
+namespace stream {
+
+AutoplugCache::AutoplugCache(const std::string& input) : input_(input), sink_caps_(), factories_(), encoders_() {}
+
+std::string AutoplugCache::GetInput() const {
+  return input_;
+}
+
+std::string AutoplugCache::GetSinkCaps() const {
+  return sink_caps_;
+}
+
+void AutoplugCache::SetSinkCaps(const std::string& caps) {
+  sink_caps_ = caps;
+}
+
+bool AutoplugCache::FindFactory(const std::string& type, std::string* factory) const {
+  if (!factory) {
+    return false;
+  }
+
+  const auto it = factories_.find(type);
+  if (it == factories_.end()) {
+    return false;
+  }
+
+  *factory = it->second;
+  return true;
+}
+
+void AutoplugCache::SetFactory(const std::string& type, const std::string& factory) {
+  factories_[type] = factory;
+}
+
+AutoplugCache::factories_t AutoplugCache::GetFactories() const {
+  return factories_;
+}
+
+bool AutoplugCache::FindEncoderCaps(size_t encoder_id, std::string* caps) const {
+  if (!caps) {
+    return false;
+  }
+
+  const auto it = encoders_.find(encoder_id);
+  if (it == encoders_.end()) {
+    return false;
+  }
+
+  *caps = it->second;
+  return true;
+}
+
+void AutoplugCache::SetEncoderCaps(size_t encoder_id, const std::string& caps) {
+  encoders_[encoder_id] = caps;
+}
+
+AutoplugCache::encoders_t AutoplugCache::GetEncodersCaps() const {
+  return encoders_;
+}
+
+bool AutoplugCache::IsEmpty() const {
+  return sink_caps_.empty() && factories_.empty() && encoders_.empty();
+}
+
+void AutoplugCache::Clear() {
+  sink_caps_.clear();
+  factories_.clear();
+  encoders_.clear();
+}
+
+bool AutoplugCache::Load(const common::file_system::ascii_file_string_path& path) {
+  if (!path.IsValid()) {
+    return false;
+  }
+
+  std::ifstream file(path.GetPath());
+  if (!file.is_open()) {
+    return false;
+  }
+
+  // key value per line: input, caps once, factory <type> <name> for each media type, encoder <id> <caps>
+  std::string input;
+  std::string sink_caps;
+  factories_t factories;
+  encoders_t encoders;
+  std::string line;
+  while (std::getline(file, line)) {
+    const size_t key_end = line.find(' ');
+    if (key_end == std::string::npos) {
+      continue;
+    }
+
+    const std::string key = line.substr(0, key_end);
+    const std::string value = line.substr(key_end + 1);
+    if (key == AUTOPLUG_CACHE_INPUT) {
+      input = value;
+    } else if (key == AUTOPLUG_CACHE_CAPS) {
+      sink_caps = value;
+    } else if (key == AUTOPLUG_CACHE_FACTORY) {
+      const size_t type_end = value.find(' ');
+      if (type_end != std::string::npos && type_end + 1 < value.size()) {
+        factories[value.substr(0, type_end)] = value.substr(type_end + 1);
+      }
+    } else if (key == AUTOPLUG_CACHE_ENCODER) {
+      const size_t id_end = value.find(' ');
+      size_t encoder_id;
+      if (id_end != std::string::npos && id_end + 1 < value.size() &&
+          common::ConvertFromString(value.substr(0, id_end), &encoder_id)) {
+        encoders[encoder_id] = value.substr(id_end + 1);
+      }
+    }
+  }
+
+  if (input != input_) {
+    return false;
+  }
+
+  sink_caps_ = sink_caps;
+  factories_ = factories;
+  encoders_ = encoders;
+  return !IsEmpty();
+}
+
+bool AutoplugCache::Save(const common::file_system::ascii_file_string_path& path) const {
+  if (!path.IsValid()) {
+    return false;
+  }
+
+  std::ofstream file(path.GetPath(), std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  file << AUTOPLUG_CACHE_INPUT " " << input_ << "\n";
+  if (!sink_caps_.empty()) {
+    file << AUTOPLUG_CACHE_CAPS " " << sink_caps_ << "\n";
+  }
+  for (const auto& factory : factories_) {
+    file << AUTOPLUG_CACHE_FACTORY " " << factory.first << " " << factory.second << "\n";
+  }
+  for (const auto& encoder : encoders_) {
+    file << AUTOPLUG_CACHE_ENCODER " " << encoder.first << " " << encoder.second << "\n";
+  }
+  return file.good();
+}
+
+bool AutoplugCache::Equals(const AutoplugCache& other) const {
+  return input_ == other.input_ && sink_caps_ == other.sink_caps_ && factories_ == other.factories_ &&
+         encoders_ == other.encoders_;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
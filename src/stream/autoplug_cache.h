@@ -0,0 +1,72 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <common/file_system/path.h>
+
+namespace fastocloud {
+namespace stream {
+
+// autoplug decisions of decodebin for one input, kept in feedback dir between starts
+// sink caps skip typefinding, factories are tried first for the same media type,
+// raw caps of video encoders known before source connects
+class AutoplugCache {
+ public:
+  typedef std::map<std::string, std::string> factories_t;  // media type => element factory
+  typedef std::map<size_t, std::string> encoders_t;         // video encoder id => fixed input caps
+
+  explicit AutoplugCache(const std::string& input);
+
+  std::string GetInput() const;
+
+  std::string GetSinkCaps() const;  // fixed caps of input data, empty if unknown
+  void SetSinkCaps(const std::string& caps);
+
+  bool FindFactory(const std::string& type, std::string* factory) const;
+  void SetFactory(const std::string& type, const std::string& factory);
+  factories_t GetFactories() const;
+
+  bool FindEncoderCaps(size_t encoder_id, std::string* caps) const;
+  void SetEncoderCaps(size_t encoder_id, const std::string& caps);
+  encoders_t GetEncodersCaps() const;
+
+  bool IsEmpty() const;
+  void Clear();
+
+  bool Load(const common::file_system::ascii_file_string_path& path);  // false if missing or other input
+  bool Save(const common::file_system::ascii_file_string_path& path) const;
+
+  bool Equals(const AutoplugCache& other) const;
+
+ private:
+  std::string input_;
+  std::string sink_caps_;
+  factories_t factories_;
+  encoders_t encoders_;
+};
+
+inline bool operator==(const AutoplugCache& left, const AutoplugCache& right) {
+  return left.Equals(right);
+}
+
+inline bool operator!=(const AutoplugCache& left, const AutoplugCache& right) {
+  return !(left == right);
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,71 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/bitrate_controller.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+namespace fastocloud {
+namespace stream {
+
+BitrateController::BitrateController(int min_bitrate, int max_bitrate)
+    : min_bitrate_(min_bitrate), max_bitrate_(max_bitrate), bitrate_(max_bitrate), motion_(0), have_motion_(false) {}
+
+bool BitrateController::IsActive() const {
+  return min_bitrate_ > 0 && min_bitrate_ < max_bitrate_;
+}
+
+int BitrateController::GetBitrate() const {
+  return bitrate_;
+}
+
+void BitrateController::SetMaxBitrate(int max_bitrate) {
+  max_bitrate_ = max_bitrate;
+  bitrate_ = std::max(min_bitrate_, std::min(bitrate_, max_bitrate_));
+}
+
+bool BitrateController::Update(uint32_t motion, int* bitrate) {
+  if (!bitrate || !IsActive()) {
+    return false;
+  }
+
+  if (!have_motion_) {
+    motion_ = motion;
+    have_motion_ = true;
+  } else {
+    motion_ = (motion_ * (smoothing - 1) + motion) / smoothing;
+  }
+
+  const int64_t range = max_bitrate_ - min_bitrate_;
+  const int64_t level = std::min<uint32_t>(motion_, high_motion);
+  int target = min_bitrate_ + static_cast<int>(range * level / high_motion);
+  const int min_change = std::max(max_bitrate_ * min_change_percent / 100, 1);
+  const bool is_bound = target == min_bitrate_ || target == max_bitrate_;
+  if (target == bitrate_ || (abs(target - bitrate_) < min_change && !is_bound)) {
+    return false;
+  }
+
+  if (target < bitrate_) {
+    target = std::max(target, bitrate_ - bitrate_ * max_drop_percent / 100);
+  }
+
+  bitrate_ = target;
+  *bitrate = bitrate_;
+  return true;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
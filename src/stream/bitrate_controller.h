@@ -0,0 +1,55 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace stream {
+
+// bitrate of video encoder between bounds by motion of decoded picture, static scenes get lower bound
+class BitrateController {
+ public:
+  enum {
+    high_motion = 800,       // hundredths of luma level per sample, upper bound reached
+    smoothing = 4,           // motion averaged over about 4 updates
+    min_change_percent = 5,  // of upper bound, smaller changes not applied
+    max_drop_percent = 10    // of current bitrate per update, rises applied at once
+  };
+
+  // bitrate in config units, controller inactive if bounds not valid
+  BitrateController(int min_bitrate, int max_bitrate);
+
+  bool IsActive() const;
+  int GetBitrate() const;
+  void SetMaxBitrate(int max_bitrate);  // live config update, current bitrate clamped to it
+
+  // true if bitrate should be applied to encoder
+  bool Update(uint32_t motion, int* bitrate) WARN_UNUSED_RESULT;
+
+ private:
+  const int min_bitrate_;
+  int max_bitrate_;
+  int bitrate_;
+  uint32_t motion_;  // smoothed
+  bool have_motion_;
+
+  DISALLOW_COPY_AND_ASSIGN(BitrateController);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,62 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/buffer_pool.h"
+
+namespace fastocloud {
+namespace stream {
+
+BufferPool::BufferPool(guint buffer_size, guint min_buffers)
+    : pool_(gst_buffer_pool_new()), buffer_size_(buffer_size), min_buffers_(min_buffers) {}
+
+BufferPool::~BufferPool() {
+  Stop();
+  gst_object_unref(pool_);  // buffers in flight hold own references
+}
+
+bool BufferPool::Start() {
+  if (gst_buffer_pool_is_active(pool_)) {
+    return true;
+  }
+
+  GstStructure* config = gst_buffer_pool_get_config(pool_);
+  gst_buffer_pool_config_set_params(config, nullptr, buffer_size_, min_buffers_, 0);  // grows if downstream holds more
+  if (!gst_buffer_pool_set_config(pool_, config)) {
+    return false;
+  }
+
+  return gst_buffer_pool_set_active(pool_, TRUE);
+}
+
+void BufferPool::Stop() {
+  if (gst_buffer_pool_is_active(pool_)) {
+    ignore_result(gst_buffer_pool_set_active(pool_, FALSE));
+  }
+}
+
+GstBuffer* BufferPool::Acquire() {
+  GstBuffer* buffer = nullptr;
+  GstFlowReturn ret = gst_buffer_pool_acquire_buffer(pool_, &buffer, nullptr);
+  if (ret != GST_FLOW_OK) {
+    return nullptr;
+  }
+  return buffer;
+}
+
+guint BufferPool::GetBufferSize() const {
+  return buffer_size_;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
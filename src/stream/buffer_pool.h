@@ -0,0 +1,46 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gst/gstbufferpool.h>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace stream {
+
+// fixed size buffers for appsrc fed streams, buffers return to pool after pipeline drops them
+// min_buffers preallocated on start
+class BufferPool {
+ public:
+  BufferPool(guint buffer_size, guint min_buffers);
+  ~BufferPool();
+
+  bool Start() WARN_UNUSED_RESULT;
+  void Stop();
+
+  GstBuffer* Acquire();  // nullptr if pool not active
+  guint GetBufferSize() const;
+
+ private:
+  GstBufferPool* const pool_;
+  const guint buffer_size_;
+  const guint min_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferPool);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
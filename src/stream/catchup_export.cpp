@@ -0,0 +1,111 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/catchup_export.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include <common/file_system/file_system.h>
+#include <common/logger.h>
+#include <common/sprintf.h>
+
+#include "base/chunks_index.h"
+#include "base/types.h"
+
+#include "utils/chunk_info.h"
+#include "utils/m3u8_writer.h"
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+bool link_chunk(const std::string& from, const std::string& to) {
+  char real_path[PATH_MAX];
+  const char* target = realpath(from.c_str(), real_path) ? real_path : from.c_str();  // moved chunks are symlinks
+  unlink(to.c_str());
+  if (link(target, to.c_str()) == 0) {
+    return true;
+  }
+  if (errno != EXDEV) {
+    return false;
+  }
+  return symlink(target, to.c_str()) == 0;
+}
+}  // namespace
+
+bool export_recorded_catchup(const common::file_system::ascii_directory_string_path& recorder_dir,
+                             const common::file_system::ascii_directory_string_path& catchup_dir,
+                             time_t start_utc,
+                             time_t stop_utc,
+                             time_t chunk_duration) {
+  if (stop_utc <= start_utc || chunk_duration <= 0) {
+    return false;
+  }
+
+  const int64_t start_msec = static_cast<int64_t>(start_utc) * 1000;
+  const int64_t stop_msec = static_cast<int64_t>(stop_utc) * 1000;
+  const ChunksIndexReader reader(recorder_dir);
+  std::vector<ChunkIndexEntry> entries;
+  ChunkIndexEntry entry;
+  for (size_t pos = reader.FindPosByTime(start_utc); reader.Read(pos, &entry) && entry.start_msec < stop_msec; ++pos) {
+    entries.push_back(entry);
+  }
+  if (entries.empty() || entries.front().start_msec > start_msec + chunk_duration * 1000 ||
+      GetChunkEndMsec(entries.back()) < stop_msec) {  // head expired or tail still recording
+    return false;
+  }
+
+  const std::string dir = catchup_dir.GetPath();
+  if (!common::file_system::is_directory_exist(dir) && common::file_system::create_directory(dir, true)) {
+    return false;
+  }
+
+  std::vector<utils::ChunkInfo> chunks;
+  for (const ChunkIndexEntry& chunk : entries) {
+    const std::string name = common::MemSPrintf("%llu" CHUNK_EXT, chunk.index);
+    if (!link_chunk(recorder_dir.GetPath() + name, dir + name)) {
+      WARNING_LOG() << "Failed to link chunk " << name << " of " << recorder_dir.GetPath() << ", errno: " << errno;
+      return false;
+    }
+    chunks.push_back(utils::ChunkInfo(name, static_cast<uint64_t>(chunk.duration_msec) * 1000 * 1000, chunk.index));
+  }
+
+  const auto m3u8_path = catchup_dir.MakeFileStringPath(CATCHUP_PLAYLIST_NAME);
+  if (!m3u8_path) {
+    return false;
+  }
+
+  utils::M3u8Writer playlist;
+  common::ErrnoError err = playlist.OpenForAppend(*m3u8_path, chunks.front().index, chunk_duration, chunks);
+  if (!err) {
+    err = playlist.WriteFooter();
+    ignore_result(playlist.Close());
+  }
+  if (err) {
+    WARNING_LOG() << "Failed to write catchup m3u8 " << m3u8_path->GetPath() << ": " << err->GetDescription();
+    return false;
+  }
+
+  INFO_LOG() << "Catchup of " << chunks.size() << " recorded chunks linked from " << recorder_dir.GetPath();
+  return true;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,37 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <time.h>
+
+#include <common/file_system/path.h>
+
+#define CATCHUP_PLAYLIST_NAME "master.m3u8"
+
+namespace fastocloud {
+namespace stream {
+
+// catchup made from chunks timeshift recorder already closed, no pipeline:
+// chunks overlapping [start_utc, stop_utc) hardlinked into catchup_dir under recorder names and listed in
+// finished playlist, symlinked if dirs on different filesystems, then catchup expires together with recorder;
+// false if recorder doesn't have whole range (not recorded yet, expired or hour files), catchup is recorded then
+bool export_recorded_catchup(const common::file_system::ascii_directory_string_path& recorder_dir,
+                             const common::file_system::ascii_directory_string_path& catchup_dir,
+                             time_t start_utc,
+                             time_t stop_utc,
+                             time_t chunk_duration);
+
+}  // namespace stream
+}  // namespace fastocloud
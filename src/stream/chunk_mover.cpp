@@ -0,0 +1,236 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/chunk_mover.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include <common/file_system/file_system.h>
+#include <common/logger.h>
+#include <common/string_util.h>
+
+#include "base/types.h"
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+std::string make_path(const std::string& dir, const std::string& name) {
+  if (!dir.empty() && dir.back() == '/') {
+    return dir + name;
+  }
+  return dir + "/" + name;
+}
+}  // namespace
+
+ChunkMover::ChunkMover(const std::string& hot_dir, const std::string& cold_dir, time_t hot_time, uint64_t rate)
+    : hot_dir_(hot_dir),
+      cold_dir_(cold_dir),
+      hot_time_(hot_time),
+      rate_(rate),
+      stop_mutex_(),
+      stop_cond_(),
+      stop_(false),
+      thread_() {}
+
+ChunkMover::~ChunkMover() {
+  Stop();
+}
+
+void ChunkMover::Start() {
+  if (thread_.joinable()) {
+    return;
+  }
+
+  ignore_result(common::file_system::create_directory(cold_dir_, true));
+  stop_ = false;
+  thread_ = std::thread(&ChunkMover::WorkLoop, this);
+}
+
+void ChunkMover::Stop() {
+  {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    stop_ = true;
+    stop_cond_.notify_all();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool ChunkMover::IsStopped() {
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  return stop_;
+}
+
+void ChunkMover::WorkLoop() {
+  while (true) {
+    MoveOldChunks();
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    stop_cond_.wait_for(lock, std::chrono::seconds(scan_interval_sec), [this] { return stop_; });
+    if (stop_) {
+      return;
+    }
+  }
+}
+
+void ChunkMover::MoveOldChunks() {
+  DIR* dirp = opendir(hot_dir_.c_str());
+  if (!dirp) {
+    return;
+  }
+
+  const time_t hot_since = time(nullptr) - hot_time_;
+  std::vector<std::pair<time_t, std::string>> chunks;  // regular files only, links already moved
+  struct dirent* dent;
+  while ((dent = readdir(dirp)) != nullptr) {
+    if (!common::MatchPattern(dent->d_name, "*" CHUNK_EXT)) {
+      continue;
+    }
+
+    struct stat sb;
+    const std::string path = make_path(hot_dir_, dent->d_name);
+    if (lstat(path.c_str(), &sb) == 0 && S_ISREG(sb.st_mode) && sb.st_mtime < hot_since) {
+      chunks.push_back(std::make_pair(sb.st_mtime, std::string(dent->d_name)));
+    }
+  }
+  closedir(dirp);
+
+  std::sort(chunks.begin(), chunks.end());  // oldest first
+  for (const auto& chunk : chunks) {
+    if (IsStopped()) {
+      return;
+    }
+    if (!MoveChunk(chunk.second)) {
+      WARNING_LOG() << "Chunk " << chunk.second << " left in " << hot_dir_;
+    }
+  }
+}
+
+bool ChunkMover::MoveChunk(const std::string& name) {
+  const std::string hot_path = make_path(hot_dir_, name);
+  const std::string cold_path = make_path(cold_dir_, name);
+  const std::string cold_tmp_path = cold_path + ".tmp";
+  struct stat sb;
+  if (stat(hot_path.c_str(), &sb) != 0) {
+    return false;
+  }
+
+  if (!CopyFile(hot_path, cold_tmp_path)) {
+    unlink(cold_tmp_path.c_str());
+    return false;
+  }
+
+  // age of chunk kept, expiration by modification time works on both tiers
+  struct timeval times[2];
+  times[0].tv_sec = sb.st_atime;
+  times[0].tv_usec = 0;
+  times[1].tv_sec = sb.st_mtime;
+  times[1].tv_usec = 0;
+  utimes(cold_tmp_path.c_str(), times);
+  if (rename(cold_tmp_path.c_str(), cold_path.c_str()) != 0) {
+    unlink(cold_tmp_path.c_str());
+    return false;
+  }
+
+  // readers which opened hot file keep it until close
+  const std::string link_path = hot_path + ".lnk";
+  unlink(link_path.c_str());
+  if (symlink(cold_path.c_str(), link_path.c_str()) != 0 || rename(link_path.c_str(), hot_path.c_str()) != 0) {
+    unlink(link_path.c_str());
+    unlink(cold_path.c_str());
+    return false;
+  }
+
+  DEBUG_LOG() << "Chunk " << name << " moved to " << cold_dir_;
+  return true;
+}
+
+bool ChunkMover::CopyFile(const std::string& from, const std::string& to) {
+  int in = open(from.c_str(), O_RDONLY);
+  if (in == -1) {
+    return false;
+  }
+
+  int out = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  if (out == -1) {
+    close(in);
+    return false;
+  }
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+  posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  std::vector<char> buffer(copy_block_size);
+  const auto start = std::chrono::steady_clock::now();
+  uint64_t copied = 0;
+  bool res = true;
+  while (res) {
+    if (IsStopped()) {
+      res = false;
+      break;
+    }
+
+    ssize_t readed = read(in, buffer.data(), buffer.size());
+    if (readed < 0) {
+      res = false;
+      break;
+    }
+    if (readed == 0) {
+      break;
+    }
+
+    ssize_t written = 0;
+    while (written < readed) {
+      ssize_t nwrite = write(out, buffer.data() + written, readed - written);
+      if (nwrite <= 0) {
+        res = false;
+        break;
+      }
+      written += nwrite;
+    }
+    copied += readed;
+
+    if (rate_) {  // hot disk bandwidth belongs to recorder and players
+      const auto due = start + std::chrono::microseconds(copied * 1000000 / rate_);
+      std::unique_lock<std::mutex> lock(stop_mutex_);
+      stop_cond_.wait_until(lock, due, [this] { return stop_; });
+    }
+  }
+
+  if (res && fsync(out) != 0) {
+    res = false;
+  }
+#if defined(POSIX_FADV_DONTNEED)
+  posix_fadvise(in, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+  close(in);
+  if (close(out) != 0) {
+    res = false;
+  }
+  return res;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,65 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace stream {
+
+// recorder chunks older than hot time copied from hot to cold directory at limited rate,
+// chunk in hot directory replaced by symlink to copy, so players and daemon open same names on any tier
+class ChunkMover {
+ public:
+  enum { scan_interval_sec = 5, copy_block_size = 1024 * 1024 };
+
+  ChunkMover(const std::string& hot_dir, const std::string& cold_dir, time_t hot_time, uint64_t rate);  // bytes/sec
+  ~ChunkMover();  // stops
+
+  void Start();
+  void Stop();  // current chunk copy interrupted, hot file kept
+
+  // returns false if chunk left in hot directory
+  bool MoveChunk(const std::string& name);
+
+ private:
+  void WorkLoop();
+  void MoveOldChunks();
+  bool CopyFile(const std::string& from, const std::string& to);
+  bool IsStopped();
+
+  const std::string hot_dir_;
+  const std::string cold_dir_;
+  const time_t hot_time_;
+  const uint64_t rate_;  // 0 - unlimited
+
+  std::mutex stop_mutex_;
+  std::condition_variable stop_cond_;
+  bool stop_;
+  std::thread thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkMover);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,134 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/chunk_watcher.h"
+
+#include <poll.h>
+#include <unistd.h>
+
+#if defined(OS_LINUX)
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+#if defined(OS_LINUX)
+const uint32_t kChunkMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW;
+#endif
+}  // namespace
+
+ChunkWatcher::ChunkWatcher() : fd_(-1), wake_fd_(-1) {}
+
+ChunkWatcher::~ChunkWatcher() {
+  if (fd_ != -1) {
+    close(fd_);
+  }
+  if (wake_fd_ != -1) {
+    close(wake_fd_);
+  }
+}
+
+bool ChunkWatcher::Init(const std::string& dir) {
+#if defined(OS_LINUX)
+  if (IsValid() || dir.empty()) {
+    return IsValid();
+  }
+
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd == -1) {
+    return false;
+  }
+
+  if (inotify_add_watch(fd, dir.c_str(), kChunkMask) == -1) {  // folder created by recorder
+    close(fd);
+    return false;
+  }
+
+  int wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd == -1) {
+    close(fd);
+    return false;
+  }
+
+  fd_ = fd;
+  wake_fd_ = wake_fd;
+  return true;
+#else
+  UNUSED(dir);
+  return false;
+#endif
+}
+
+bool ChunkWatcher::IsValid() const {
+  return fd_ != -1 && wake_fd_ != -1;
+}
+
+ChunkWatcher::WaitResult ChunkWatcher::Wait(time_t timeout_msec) {
+  if (!IsValid()) {
+    return TIMED_OUT;
+  }
+
+  struct pollfd fds[2];
+  fds[0].fd = wake_fd_;
+  fds[0].events = POLLIN;
+  fds[1].fd = fd_;
+  fds[1].events = POLLIN;
+  fds[0].revents = fds[1].revents = 0;
+  int res = poll(fds, 2, static_cast<int>(timeout_msec));
+  if (res <= 0) {  // EINTR as timeout, caller rechecks folder
+    return TIMED_OUT;
+  }
+
+  if (fds[0].revents & POLLIN) {
+    Drain(wake_fd_);
+    return INTERRUPTED;
+  }
+
+  Drain(fd_);  // content of events not needed, caller rescans index
+  return CHUNK_CREATED;
+}
+
+void ChunkWatcher::Interrupt() {
+  if (wake_fd_ == -1) {
+    return;
+  }
+
+  const uint64_t value = 1;
+  ignore_result(write(wake_fd_, &value, sizeof(value)));
+}
+
+void ChunkWatcher::Reset() {
+  if (!IsValid()) {
+    return;
+  }
+
+  Drain(wake_fd_);
+  Drain(fd_);
+}
+
+void ChunkWatcher::Drain(int fd) const {
+#if defined(OS_LINUX)
+  alignas(struct inotify_event) char buff[4 * 1024];
+  while (read(fd, buff, sizeof(buff)) > 0) {  // EAGAIN, nothing more for now
+  }
+#else
+  UNUSED(fd);
+#endif
+}
+
+}  // namespace stream
+}  // namespace fastocloud
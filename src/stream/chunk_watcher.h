@@ -0,0 +1,52 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <time.h>
+
+#include <string>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace stream {
+
+// timeshift player waits for recorded chunk on inotify events of chunks folder instead of sleeping chunk duration
+// any completed or moved in file wakes waiter, chunks and index entries rechecked by caller, linux only
+class ChunkWatcher {
+ public:
+  enum WaitResult { CHUNK_CREATED, INTERRUPTED, TIMED_OUT };
+
+  ChunkWatcher();
+  ~ChunkWatcher();
+
+  bool Init(const std::string& dir);  // false if notifications not available, timed waits should be used
+  bool IsValid() const;
+
+  WaitResult Wait(time_t timeout_msec);  // blocking, single waiter
+  void Interrupt();                      // thread safe, current or next wait returns
+  void Reset();                          // drops pending interrupt and events
+
+ private:
+  void Drain(int fd) const;
+
+  int fd_;
+  int wake_fd_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkWatcher);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
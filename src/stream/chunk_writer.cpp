@@ -0,0 +1,246 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/chunk_writer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+bool pwrite_all(int fd, const uint8_t* data, size_t size, uint64_t offset) {
+  while (size) {
+    const ssize_t res = pwrite(fd, data, size, offset);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += res;
+    size -= res;
+    offset += res;
+  }
+  return true;
+}
+}  // namespace
+
+ChunkWriter::ChunkWriter(bool direct_io, size_t buffer_size)
+    : direct_io_(direct_io),
+      buffer_size_(std::max<size_t>((buffer_size + block_size - 1) / block_size, 1) * block_size),
+      buffer_(nullptr),
+      buffered_(0),
+      ring_(),
+      buffers_(),
+      in_flight_(0),
+      in_flight_offset_(0),
+      fd_(-1),
+      fd_direct_(false),
+      written_(0) {
+  for (size_t i = 0; i < 2; ++i) {
+    void* buffer = nullptr;
+    if (posix_memalign(&buffer, block_size, buffer_size_) == 0) {
+      buffers_[i] = static_cast<uint8_t*>(buffer);
+    }
+  }
+  buffer_ = buffers_[0];
+
+  const struct iovec iovs[] = {{buffers_[0], buffer_size_}, {buffers_[1], buffer_size_}};
+  if (!buffers_[0] || !buffers_[1] || !ring_.Init(2) || !ring_.RegisterBuffers(iovs, 2)) {
+    ring_.Close();  // locked memory limit or kernel without io_uring, synchronous writes
+    free(buffers_[1]);
+    buffers_[1] = nullptr;
+  }
+}
+
+ChunkWriter::~ChunkWriter() {
+  Close();
+  free(buffers_[0]);
+  free(buffers_[1]);
+}
+
+bool ChunkWriter::Open(const std::string& path, uint64_t preallocate) {
+  return OpenFile(path, preallocate, false);
+}
+
+bool ChunkWriter::Append(const std::string& path, uint64_t preallocate) {
+  return OpenFile(path, preallocate, true);
+}
+
+bool ChunkWriter::OpenFile(const std::string& path, uint64_t preallocate, bool append) {
+  Close();
+  if (!buffer_) {
+    return false;
+  }
+
+  const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+#if defined(O_DIRECT)
+  if (direct_io_ && !append) {  // end of existing file not aligned
+    fd_ = open(path.c_str(), flags | O_DIRECT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    fd_direct_ = fd_ != -1;
+  }
+#endif
+  if (fd_ == -1) {
+    fd_ = open(path.c_str(), flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  }
+  if (fd_ == -1) {
+    return false;
+  }
+
+  written_ = 0;
+  if (append) {
+    const off_t size = lseek(fd_, 0, SEEK_END);
+    if (size < 0) {
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    written_ = size;
+  }
+
+#if defined(OS_LINUX)
+  if (preallocate) {  // size kept, readers see only written data
+    fallocate(fd_, FALLOC_FL_KEEP_SIZE, written_, preallocate);
+  }
+#else
+  UNUSED(preallocate);
+#endif
+  buffered_ = 0;
+  return true;
+}
+
+bool ChunkWriter::Write(const uint8_t* data, size_t size) {
+  if (!IsOpen()) {
+    return false;
+  }
+
+  while (size) {
+    const size_t part = std::min(size, buffer_size_ - buffered_);
+    memcpy(buffer_ + buffered_, data, part);
+    buffered_ += part;
+    data += part;
+    size -= part;
+    if (buffered_ == buffer_size_ && !Flush(false)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ChunkWriter::Close() {
+  if (!IsOpen()) {
+    return true;
+  }
+
+  bool res = Flush(true);
+  if (ftruncate(fd_, written_) != 0) {  // releases preallocated tail
+    res = false;
+  }
+#if defined(POSIX_FADV_DONTNEED)
+  // only clean pages are dropped, chunk written back first
+  fdatasync(fd_);
+  posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+  close(fd_);
+  fd_ = -1;
+  fd_direct_ = false;
+  return res;
+}
+
+bool ChunkWriter::IsOpen() const {
+  return fd_ != -1;
+}
+
+bool ChunkWriter::IsDirect() const {
+  return fd_direct_;
+}
+
+uint64_t ChunkWriter::GetWritten() const {
+  return written_;
+}
+
+bool ChunkWriter::Flush(bool tail) {
+  if (!WaitSubmitted()) {
+    return false;
+  }
+  if (!buffered_) {
+    return true;
+  }
+  if (!tail && ring_.IsValid()) {
+    return SubmitBuffer();
+  }
+
+#if defined(O_DIRECT)
+  if (tail && fd_direct_ && buffered_ % block_size) {  // unaligned tail written buffered
+    const int flags = fcntl(fd_, F_GETFL);
+    if (flags == -1 || fcntl(fd_, F_SETFL, flags & ~O_DIRECT) == -1) {
+      return false;
+    }
+    fd_direct_ = false;
+  }
+#else
+  UNUSED(tail);
+#endif
+
+  // at offset, ring writes do not move file position
+  if (!pwrite_all(fd_, buffer_, buffered_, written_)) {
+    return false;
+  }
+  written_ += buffered_;
+  buffered_ = 0;
+  return true;
+}
+
+bool ChunkWriter::SubmitBuffer() {
+  const int index = buffer_ == buffers_[0] ? 0 : 1;
+  if (!ring_.PrepareWriteFixed(fd_, buffer_, buffered_, written_, index, index) || !ring_.Submit(0)) {
+    return false;
+  }
+
+  in_flight_ = buffered_;
+  in_flight_offset_ = written_;
+  written_ += buffered_;
+  buffered_ = 0;
+  buffer_ = buffers_[1 - index];
+  return true;
+}
+
+bool ChunkWriter::WaitSubmitted() {
+  if (!in_flight_) {
+    return true;
+  }
+
+  const size_t size = in_flight_;
+  in_flight_ = 0;
+  uint64_t tag = 0;
+  int res = 0;
+  if (!ring_.WaitCompletion(&tag, &res) || res < 0) {
+    return false;
+  }
+  if (static_cast<size_t>(res) < size) {  // short write, rest written synchronously
+    const uint8_t* submitted = buffers_[tag];
+    return pwrite_all(fd_, submitted + res, size - res, in_flight_offset_ + res);
+  }
+  return true;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
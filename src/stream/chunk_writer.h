@@ -0,0 +1,71 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include <common/macros.h>
+
+#include "stream/io_ring.h"
+
+namespace fastocloud {
+namespace stream {
+
+// chunk file written through one large aligned buffer, preallocated and dropped from page cache after close
+// direct io falls back to buffered io where filesystem rejects it
+// with io_uring full buffer written in background from second registered buffer, streaming thread keeps filling
+class ChunkWriter {
+ public:
+  enum { block_size = 4096, default_buffer_size = 1024 * 1024 };
+
+  explicit ChunkWriter(bool direct_io, size_t buffer_size = default_buffer_size);
+  ~ChunkWriter();
+
+  bool Open(const std::string& path, uint64_t preallocate);  // previous file closed
+  bool Append(const std::string& path, uint64_t preallocate);  // written from end of file, without direct io
+  bool Write(const uint8_t* data, size_t size);
+  bool Close();  // file truncated to written size
+
+  bool IsOpen() const;
+  bool IsDirect() const;  // current file opened with O_DIRECT
+  uint64_t GetWritten() const;  // file size, with existing part if appended
+
+ private:
+  bool OpenFile(const std::string& path, uint64_t preallocate, bool append);
+  bool Flush(bool tail);
+  bool SubmitBuffer();  // current buffer queued to ring, spare one becomes current
+  bool WaitSubmitted();  // buffer in flight written completely
+
+
+  const bool direct_io_;
+  const size_t buffer_size_;  // multiple of block size
+  uint8_t* buffer_;
+  size_t buffered_;
+  IoRing ring_;
+  uint8_t* buffers_[2];  // registered, buffer_ is one of them if ring valid
+  size_t in_flight_;     // bytes of other buffer being written
+  uint64_t in_flight_offset_;
+  int fd_;
+  bool fd_direct_;
+  uint64_t written_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkWriter);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -18,7 +18,39 @@ namespace fastocloud {
 namespace stream {
 
 Config::Config(fastotv::StreamType type, size_t max_restart_attempts, const input_t& input, const output_t& output)
-    : type_(type), max_restart_attempts_(max_restart_attempts), ttl_sec_(), input_(input), output_(output) {}
+    : type_(type),
+      max_restart_attempts_(max_restart_attempts),
+      ttl_sec_(),
+      latency_stats_(false),
+      watchdog_msec_(default_watchdog_msec),
+      no_data_panic_msec_(default_no_data_panic_msec),
+      content_failover_msec_(0),
+      udp_ingest_(),
+      udp_egress_(),
+      rtsp_ingest_(),
+      ll_hls_part_msec_(0),
+      hls_max_files_(0),
+      cmaf_(false),
+      rtmp_reconnect_(false),
+      output_queue_msec_(0),
+      latency_target_msec_(0),
+      clock_sync_(true),
+      net_clock_(),
+      pipeline_latency_msec_(0),
+      muted_outputs_(false),
+      ingest_dir_(),
+      output_trash_dir_(),
+      thumbnail_(),
+#if defined(AMAZON_KINESIS)
+      amazon_kinesis_(),
+#endif
+      input_sockets_(),
+      output_sockets_(),
+      input_https_(),
+      input_mptses_(),
+      output_tcps_(),
+      input_(input),
+      output_(output) {}
 
 Config::~Config() {}
 
@@ -58,6 +90,256 @@ void Config::SetTimeToLifeStream(ttl_t ttl) {
   ttl_sec_ = ttl;
 }
 
+bool Config::GetLatencyStats() const {
+  return latency_stats_;
+}
+
+void Config::SetLatencyStats(bool latency) {
+  latency_stats_ = latency;
+}
+
+fastotv::timestamp_t Config::GetWatchdogMsec() const {
+  return watchdog_msec_;
+}
+
+void Config::SetWatchdogMsec(fastotv::timestamp_t msec) {
+  watchdog_msec_ = msec;
+}
+
+fastotv::timestamp_t Config::GetNoDataPanicMsec() const {
+  return no_data_panic_msec_;
+}
+
+void Config::SetNoDataPanicMsec(fastotv::timestamp_t msec) {
+  no_data_panic_msec_ = msec;
+}
+
+fastotv::timestamp_t Config::GetContentFailoverMsec() const {
+  return content_failover_msec_;
+}
+
+void Config::SetContentFailoverMsec(fastotv::timestamp_t msec) {
+  content_failover_msec_ = msec;
+}
+
+UdpIngest Config::GetUdpIngest() const {
+  return udp_ingest_;
+}
+
+void Config::SetUdpIngest(const UdpIngest& udp) {
+  udp_ingest_ = udp;
+}
+
+RtspIngest Config::GetRtspIngest() const {
+  return rtsp_ingest_;
+}
+
+void Config::SetRtspIngest(const RtspIngest& rtsp) {
+  rtsp_ingest_ = rtsp;
+}
+
+UdpEgress Config::GetUdpEgress() const {
+  return udp_egress_;
+}
+
+void Config::SetUdpEgress(const UdpEgress& udp) {
+  udp_egress_ = udp;
+}
+
+fastotv::timestamp_t Config::GetLlHlsPartMsec() const {
+  return ll_hls_part_msec_;
+}
+
+void Config::SetLlHlsPartMsec(fastotv::timestamp_t msec) {
+  ll_hls_part_msec_ = msec;
+}
+
+size_t Config::GetHlsMaxFiles() const {
+  return hls_max_files_;
+}
+
+void Config::SetHlsMaxFiles(size_t max_files) {
+  hls_max_files_ = max_files;
+}
+
+bool Config::GetCmaf() const {
+  return cmaf_;
+}
+
+void Config::SetCmaf(bool cmaf) {
+  cmaf_ = cmaf;
+}
+
+bool Config::GetRtmpReconnect() const {
+  return rtmp_reconnect_;
+}
+
+void Config::SetRtmpReconnect(bool reconnect) {
+  rtmp_reconnect_ = reconnect;
+}
+
+fastotv::timestamp_t Config::GetOutputQueueMsec() const {
+  return output_queue_msec_;
+}
+
+void Config::SetOutputQueueMsec(fastotv::timestamp_t msec) {
+  output_queue_msec_ = msec;
+}
+
+fastotv::timestamp_t Config::GetLatencyTargetMsec() const {
+  return latency_target_msec_;
+}
+
+void Config::SetLatencyTargetMsec(fastotv::timestamp_t msec) {
+  latency_target_msec_ = msec;
+}
+
+bool Config::GetClockSync() const {
+  return clock_sync_;
+}
+
+void Config::SetClockSync(bool sync) {
+  clock_sync_ = sync;
+}
+
+std::string Config::GetNetClock() const {
+  return net_clock_;
+}
+
+void Config::SetNetClock(const std::string& url) {
+  net_clock_ = url;
+}
+
+fastotv::timestamp_t Config::GetPipelineLatencyMsec() const {
+  return pipeline_latency_msec_;
+}
+
+void Config::SetPipelineLatencyMsec(fastotv::timestamp_t msec) {
+  pipeline_latency_msec_ = msec;
+}
+
+bool Config::GetMutedOutputs() const {
+  return muted_outputs_;
+}
+
+void Config::SetMutedOutputs(bool muted) {
+  muted_outputs_ = muted;
+}
+
+std::string Config::GetIngestDir() const {
+  return ingest_dir_;
+}
+
+void Config::SetIngestDir(const std::string& dir) {
+  ingest_dir_ = dir;
+}
+
+std::string Config::GetOutputTrashDir() const {
+  return output_trash_dir_;
+}
+
+void Config::SetOutputTrashDir(const std::string& dir) {
+  output_trash_dir_ = dir;
+}
+
+Thumbnail Config::GetThumbnail() const {
+  return thumbnail_;
+}
+
+void Config::SetThumbnail(const Thumbnail& thumbnail) {
+  thumbnail_ = thumbnail;
+}
+
+#if defined(AMAZON_KINESIS)
+Config::amazon_kinesis_t Config::GetAmazonKinesis() const {
+  return amazon_kinesis_;
+}
+
+void Config::SetAmazonKinesis(const amazon_kinesis_t& kinesis) {
+  amazon_kinesis_ = kinesis;
+}
+#endif
+
+socket_tunings_t Config::GetInputSockets() const {
+  return input_sockets_;
+}
+
+void Config::SetInputSockets(const socket_tunings_t& sockets) {
+  input_sockets_ = sockets;
+}
+
+SocketTuning Config::GetInputSocket(fastotv::channel_id_t cid) const {
+  const auto it = input_sockets_.find(cid);
+  if (it == input_sockets_.end()) {
+    return SocketTuning();
+  }
+  return it->second;
+}
+
+socket_tunings_t Config::GetOutputSockets() const {
+  return output_sockets_;
+}
+
+void Config::SetOutputSockets(const socket_tunings_t& sockets) {
+  output_sockets_ = sockets;
+}
+
+SocketTuning Config::GetOutputSocket(fastotv::channel_id_t cid) const {
+  const auto it = output_sockets_.find(cid);
+  if (it == output_sockets_.end()) {
+    return SocketTuning();
+  }
+  return it->second;
+}
+
+http_tunings_t Config::GetInputHttps() const {
+  return input_https_;
+}
+
+void Config::SetInputHttps(const http_tunings_t& https) {
+  input_https_ = https;
+}
+
+HttpTuning Config::GetInputHttp(fastotv::channel_id_t cid) const {
+  const auto it = input_https_.find(cid);
+  if (it == input_https_.end()) {
+    return HttpTuning();
+  }
+  return it->second;
+}
+
+mpts_tunings_t Config::GetInputMptses() const {
+  return input_mptses_;
+}
+
+void Config::SetInputMptses(const mpts_tunings_t& mptses) {
+  input_mptses_ = mptses;
+}
+
+MptsTuning Config::GetInputMpts(fastotv::channel_id_t cid) const {
+  const auto it = input_mptses_.find(cid);
+  if (it == input_mptses_.end()) {
+    return MptsTuning();
+  }
+  return it->second;
+}
+
+tcp_tunings_t Config::GetOutputTcps() const {
+  return output_tcps_;
+}
+
+void Config::SetOutputTcps(const tcp_tunings_t& tcps) {
+  output_tcps_ = tcps;
+}
+
+TcpTuning Config::GetOutputTcp(fastotv::channel_id_t cid) const {
+  const auto it = output_tcps_.find(cid);
+  if (it == output_tcps_.end()) {
+    return TcpTuning();
+  }
+  return it->second;
+}
+
 Config* Config::Clone() const {
   return new Config(*this);
 }
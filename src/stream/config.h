@@ -14,17 +14,27 @@
 
 #pragma once
 
+#include <string>
+
 #include <common/macros.h>
 
+#if defined(AMAZON_KINESIS)
+#include "base/amazon_kinesis/amazon_kinesis.h"
+#endif
 #include "base/inputs_outputs.h"
 
+#include "stream/stypes.h"
+
 namespace fastocloud {
 namespace stream {
 
 class Config : public common::ClonableBase<Config> {
  public:
-  enum { report_delay_sec = 10 };
+  enum { report_delay_sec = 10, default_watchdog_msec = 1000, default_no_data_panic_msec = 60 * 1000 };
   typedef common::Optional<time_t> ttl_t;
+#if defined(AMAZON_KINESIS)
+  typedef common::Optional<amazon_kinesis::AmazonKinesis> amazon_kinesis_t;
+#endif
   Config(fastotv::StreamType type, size_t max_restart_attempts, const input_t& input, const output_t& output);
   virtual ~Config();
 
@@ -42,12 +52,125 @@ class Config : public common::ClonableBase<Config> {
   ttl_t GetTimeToLifeStream() const;
   void SetTimeToLifeStream(ttl_t ttl);
 
+  bool GetLatencyStats() const;
+  void SetLatencyStats(bool latency);
+
+  fastotv::timestamp_t GetWatchdogMsec() const;  // main timer period
+  void SetWatchdogMsec(fastotv::timestamp_t msec);
+
+  fastotv::timestamp_t GetNoDataPanicMsec() const;  // max time without buffers on probes
+  void SetNoDataPanicMsec(fastotv::timestamp_t msec);
+
+  fastotv::timestamp_t GetContentFailoverMsec() const;  // max black, freeze or silence of decoded input, 0 off
+  void SetContentFailoverMsec(fastotv::timestamp_t msec);
+
+  UdpIngest GetUdpIngest() const;  // udp inputs
+  void SetUdpIngest(const UdpIngest& udp);
+
+  UdpEgress GetUdpEgress() const;  // udp outputs
+  void SetUdpEgress(const UdpEgress& udp);
+
+  RtspIngest GetRtspIngest() const;  // rtsp inputs
+  void SetRtspIngest(const RtspIngest& rtsp);
+
+  fastotv::timestamp_t GetLlHlsPartMsec() const;  // 0 - classic hls outputs
+  void SetLlHlsPartMsec(fastotv::timestamp_t msec);
+
+  size_t GetHlsMaxFiles() const;  // live classic hls outputs, 0 - default of sink
+  void SetHlsMaxFiles(size_t max_files);
+
+  bool GetCmaf() const;  // http outputs, preferred over ll-hls
+  void SetCmaf(bool cmaf);
+
+  bool GetRtmpReconnect() const;  // rtmp outputs of decodebin streams
+  void SetRtmpReconnect(bool reconnect);
+
+  fastotv::timestamp_t GetOutputQueueMsec() const;  // 0 - output branches block tee
+  void SetOutputQueueMsec(fastotv::timestamp_t msec);
+
+  fastotv::timestamp_t GetLatencyTargetMsec() const;  // pipeline queues sized from it, 0 - default of stream type
+  void SetLatencyTargetMsec(fastotv::timestamp_t msec);
+
+  bool GetClockSync() const;  // false - no clock, remuxing pipelines push data as fast as it comes
+  void SetClockSync(bool sync);
+
+  std::string GetNetClock() const;  // pipelines of nodes with same clock produce aligned timestamps, empty - system
+  void SetNetClock(const std::string& url);
+
+  fastotv::timestamp_t GetPipelineLatencyMsec() const;  // 0 - latency queried from elements
+  void SetPipelineLatencyMsec(fastotv::timestamp_t msec);
+
+  bool GetMutedOutputs() const;  // started with silent output branches
+  void SetMutedOutputs(bool muted);
+
+  std::string GetIngestDir() const;  // live inputs shared by streams of node, empty - own connections
+  void SetIngestDir(const std::string& dir);
+
+  std::string GetOutputTrashDir() const;  // vods, old http outputs renamed into it at start, empty - removed in place
+  void SetOutputTrashDir(const std::string& dir);
+
+  Thumbnail GetThumbnail() const;  // relay streams
+  void SetThumbnail(const Thumbnail& thumbnail);
+
+#if defined(AMAZON_KINESIS)
+  amazon_kinesis_t GetAmazonKinesis() const;  // kvs outputs
+  void SetAmazonKinesis(const amazon_kinesis_t& kinesis);
+#endif
+
+  socket_tunings_t GetInputSockets() const;  // by input channel id
+  void SetInputSockets(const socket_tunings_t& sockets);
+  SocketTuning GetInputSocket(fastotv::channel_id_t cid) const;  // default if not tuned
+
+  http_tunings_t GetInputHttps() const;  // by input channel id
+  void SetInputHttps(const http_tunings_t& https);
+  HttpTuning GetInputHttp(fastotv::channel_id_t cid) const;  // default if not tuned
+
+  mpts_tunings_t GetInputMptses() const;  // by input channel id
+  void SetInputMptses(const mpts_tunings_t& mptses);
+  MptsTuning GetInputMpts(fastotv::channel_id_t cid) const;  // whole ts if not tuned
+
+  tcp_tunings_t GetOutputTcps() const;  // by output channel id
+  void SetOutputTcps(const tcp_tunings_t& tcps);
+  TcpTuning GetOutputTcp(fastotv::channel_id_t cid) const;  // default if not tuned
+
+  socket_tunings_t GetOutputSockets() const;  // by output channel id
+  void SetOutputSockets(const socket_tunings_t& sockets);
+  SocketTuning GetOutputSocket(fastotv::channel_id_t cid) const;
+
   Config* Clone() const override;
 
  private:
   fastotv::StreamType type_;
   size_t max_restart_attempts_;
   ttl_t ttl_sec_;
+  bool latency_stats_;
+  fastotv::timestamp_t watchdog_msec_;
+  fastotv::timestamp_t no_data_panic_msec_;
+  fastotv::timestamp_t content_failover_msec_;
+  UdpIngest udp_ingest_;
+  UdpEgress udp_egress_;
+  RtspIngest rtsp_ingest_;
+  fastotv::timestamp_t ll_hls_part_msec_;
+  size_t hls_max_files_;
+  bool cmaf_;
+  bool rtmp_reconnect_;
+  fastotv::timestamp_t output_queue_msec_;
+  fastotv::timestamp_t latency_target_msec_;
+  bool clock_sync_;
+  std::string net_clock_;
+  fastotv::timestamp_t pipeline_latency_msec_;
+  bool muted_outputs_;
+  std::string ingest_dir_;
+  std::string output_trash_dir_;
+  Thumbnail thumbnail_;
+#if defined(AMAZON_KINESIS)
+  amazon_kinesis_t amazon_kinesis_;
+#endif
+  socket_tunings_t input_sockets_;
+  socket_tunings_t output_sockets_;
+  http_tunings_t input_https_;
+  mpts_tunings_t input_mptses_;
+  tcp_tunings_t output_tcps_;
 
   input_t input_;
   output_t output_;
@@ -14,14 +14,18 @@
 
 #include "stream/configs_factory.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
 
 #include <common/sprintf.h>
 
 #include "base/config_fields.h"
+#include "base/constants.h"
 #include "base/gst_constants.h"
+#include "base/stream_config_parse.h"
 
+#include "stream/elements/encoders/video.h"
 #include "stream/link_generator/ilink_generator.h"
 #include "stream/streams/configs/encode_config.h"
 #include "stream/streams/configs/relay_config.h"
@@ -32,6 +36,7 @@ namespace stream {
 namespace {
 
 const size_t kDefaultRestartAttempts = 10;
+const int kMinWatchdogMsec = 100;
 
 void CheckAndSetValue(const StreamConfig& config, const std::string& name, video_encoders_args_t* map) {
   if (!config || !map) {
@@ -57,6 +62,36 @@ void CheckAndSetValue(const StreamConfig& config, const std::string& name, video
   }
 }
 
+streams::EncodeConfig::renditions_t ReadRenditions(common::ArrayValue* renditions_list) {
+  streams::EncodeConfig::renditions_t renditions;
+  for (size_t i = 0; i < renditions_list->GetSize(); ++i) {
+    common::Value* item = nullptr;
+    common::HashValue* item_hash = nullptr;
+    if (!renditions_list->Get(i, &item) || !item->GetAsHash(&item_hash)) {
+      continue;
+    }
+
+    int id;
+    std::string size_str;
+    streams::Rendition rendition;
+    common::Value* id_field = item_hash->Find(RENDITION_ID_FIELD);
+    common::Value* size_field = item_hash->Find(SIZE_FIELD);
+    if (!id_field || !id_field->GetAsInteger(&id) || !size_field || !size_field->GetAsBasicString(&size_str) ||
+        !common::ConvertFromString(size_str, &rendition.size)) {
+      continue;
+    }
+    rendition.output_id = id;
+
+    int v_bitrate;
+    common::Value* video_bitrate_field = item_hash->Find(VIDEO_BIT_RATE_FIELD);
+    if (video_bitrate_field && video_bitrate_field->GetAsInteger(&v_bitrate)) {
+      rendition.video_bitrate = v_bitrate;
+    }
+    renditions.push_back(rendition);
+  }
+  return renditions;
+}
+
 bool InitVideoEncodersWithArgs(const StreamConfig& config,
                                video_encoders_args_t* video_encoder_args,
                                video_encoders_str_args_t* video_encoder_str_args) {
@@ -157,6 +192,20 @@ bool InitVideoEncodersWithArgs(const StreamConfig& config,
 
 }  // namespace
 
+bool read_video_codec(const StreamConfig& config_args, std::string* video_codec) {
+  if (!config_args || !video_codec) {
+    return false;
+  }
+
+  common::Value* active_codec_field = config_args->Find(ACTIVE_VIDEO_CODEC_FIELD);
+  if (active_codec_field && active_codec_field->GetAsBasicString(video_codec)) {
+    return true;
+  }
+
+  common::Value* video_codec_field = config_args->Find(VIDEO_CODEC_FIELD);
+  return video_codec_field && video_codec_field->GetAsBasicString(video_codec);
+}
+
 common::Error make_config(const StreamConfig& config_args, Config** config) {
   if (!config_args || !config) {
     return common::make_error_inval();
@@ -204,6 +253,239 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
     conf.SetTimeToLifeStream(ttl_sec);
   }
 
+  bool latency_stats;
+  common::Value* latency_stats_field = config_args->Find(LATENCY_STATS_FIELD);
+  if (latency_stats_field && latency_stats_field->GetAsBoolean(&latency_stats)) {
+    conf.SetLatencyStats(latency_stats);
+  }
+
+  int watchdog_msec;
+  common::Value* watchdog_msec_field = config_args->Find(WATCHDOG_MSEC_FIELD);
+  if (watchdog_msec_field && watchdog_msec_field->GetAsInteger(&watchdog_msec) && watchdog_msec >= kMinWatchdogMsec) {
+    conf.SetWatchdogMsec(watchdog_msec);
+  }
+
+  int no_data_panic_msec;
+  common::Value* no_data_panic_msec_field = config_args->Find(NO_DATA_PANIC_MSEC_FIELD);
+  if (no_data_panic_msec_field && no_data_panic_msec_field->GetAsInteger(&no_data_panic_msec) &&
+      no_data_panic_msec > 0) {
+    // stall can't be detected faster than the timer ticks
+    conf.SetNoDataPanicMsec(std::max<fastotv::timestamp_t>(no_data_panic_msec, conf.GetWatchdogMsec()));
+  }
+
+  int content_failover_msec;
+  common::Value* content_failover_msec_field = config_args->Find(CONTENT_FAILOVER_MSEC_FIELD);
+  if (content_failover_msec_field && content_failover_msec_field->GetAsInteger(&content_failover_msec) &&
+      content_failover_msec > 0) {
+    conf.SetContentFailoverMsec(content_failover_msec);
+  }
+
+  UdpIngest udp;
+  int udp_batch;
+  common::Value* udp_batch_field = config_args->Find(UDP_BATCH_FIELD);
+  if (udp_batch_field && udp_batch_field->GetAsInteger(&udp_batch) && udp_batch > 0) {
+    udp.batch = udp_batch;
+  }
+
+  int udp_receive_buffer;
+  common::Value* udp_receive_buffer_field = config_args->Find(UDP_RECEIVE_BUFFER_FIELD);
+  if (udp_receive_buffer_field && udp_receive_buffer_field->GetAsInteger(&udp_receive_buffer) &&
+      udp_receive_buffer > 0) {
+    udp.receive_buffer = udp_receive_buffer;
+  }
+
+  int udp_busy_poll;
+  common::Value* udp_busy_poll_field = config_args->Find(UDP_BUSY_POLL_FIELD);
+  if (udp_busy_poll_field && udp_busy_poll_field->GetAsInteger(&udp_busy_poll) && udp_busy_poll > 0) {
+    udp.busy_poll_usec = udp_busy_poll;
+  }
+
+  bool packet_ingest;
+  common::Value* packet_ingest_field = config_args->Find(ACTIVE_PACKET_INGEST_FIELD);
+  if (packet_ingest_field && packet_ingest_field->GetAsBoolean(&packet_ingest)) {
+    udp.packet_ring = packet_ingest;
+  }
+  conf.SetUdpIngest(udp);
+
+  RtspIngest rtsp;
+  int rtsp_latency;
+  common::Value* rtsp_latency_field = config_args->Find(RTSP_LATENCY_FIELD);
+  if (rtsp_latency_field && rtsp_latency_field->GetAsInteger(&rtsp_latency) && rtsp_latency > 0) {
+    rtsp.latency_msec = rtsp_latency;
+  }
+
+  int rtsp_latency_min;
+  common::Value* rtsp_latency_min_field = config_args->Find(RTSP_LATENCY_MIN_FIELD);
+  if (rtsp_latency_min_field && rtsp_latency_min_field->GetAsInteger(&rtsp_latency_min) && rtsp_latency_min > 0) {
+    rtsp.latency_min_msec = rtsp_latency_min;
+  }
+
+  int rtsp_latency_max;
+  common::Value* rtsp_latency_max_field = config_args->Find(RTSP_LATENCY_MAX_FIELD);
+  if (rtsp_latency_max_field && rtsp_latency_max_field->GetAsInteger(&rtsp_latency_max) && rtsp_latency_max > 0) {
+    rtsp.latency_max_msec = rtsp_latency_max;
+  }
+
+  int rtsp_tcp_fallback_loss;
+  common::Value* rtsp_tcp_fallback_loss_field = config_args->Find(RTSP_TCP_FALLBACK_LOSS_FIELD);
+  if (rtsp_tcp_fallback_loss_field && rtsp_tcp_fallback_loss_field->GetAsInteger(&rtsp_tcp_fallback_loss) &&
+      rtsp_tcp_fallback_loss > 0) {
+    rtsp.tcp_fallback_loss = rtsp_tcp_fallback_loss;
+  }
+  conf.SetRtspIngest(rtsp);
+
+  UdpEgress udp_out;
+  int udp_out_batch;
+  common::Value* udp_out_batch_field = config_args->Find(UDP_OUT_BATCH_FIELD);
+  if (udp_out_batch_field && udp_out_batch_field->GetAsInteger(&udp_out_batch) && udp_out_batch > 0) {
+    udp_out.batch = udp_out_batch;
+  }
+
+  int udp_out_send_buffer;
+  common::Value* udp_out_send_buffer_field = config_args->Find(UDP_OUT_SEND_BUFFER_FIELD);
+  if (udp_out_send_buffer_field && udp_out_send_buffer_field->GetAsInteger(&udp_out_send_buffer) &&
+      udp_out_send_buffer > 0) {
+    udp_out.send_buffer = udp_out_send_buffer;
+  }
+
+  bool udp_out_pacing;
+  common::Value* udp_out_pacing_field = config_args->Find(UDP_OUT_PACING_FIELD);
+  if (udp_out_pacing_field && udp_out_pacing_field->GetAsBoolean(&udp_out_pacing)) {
+    udp_out.pacing = udp_out_pacing;
+  }
+
+  bool udp_out_fanout;
+  common::Value* udp_out_fanout_field = config_args->Find(UDP_OUT_FANOUT_FIELD);
+  if (udp_out_fanout_field && udp_out_fanout_field->GetAsBoolean(&udp_out_fanout)) {
+    udp_out.fanout = udp_out_fanout;
+  }
+  conf.SetUdpEgress(udp_out);
+
+  int ll_hls_part_msec;
+  common::Value* ll_hls_part_msec_field = config_args->Find(LL_HLS_PART_MSEC_FIELD);
+  if (ll_hls_part_msec_field && ll_hls_part_msec_field->GetAsInteger(&ll_hls_part_msec) && ll_hls_part_msec > 0) {
+    conf.SetLlHlsPartMsec(ll_hls_part_msec);
+  }
+
+  int hls_max_files;
+  common::Value* hls_max_files_field = config_args->Find(HLS_MAX_FILES_FIELD);
+  if (hls_max_files_field && hls_max_files_field->GetAsInteger(&hls_max_files) && hls_max_files > 0) {
+    conf.SetHlsMaxFiles(hls_max_files);
+  }
+
+  bool cmaf;
+  common::Value* cmaf_field = config_args->Find(CMAF_FIELD);
+  if (cmaf_field && cmaf_field->GetAsBoolean(&cmaf)) {
+    conf.SetCmaf(cmaf);
+  }
+
+  bool rtmp_reconnect;
+  common::Value* rtmp_reconnect_field = config_args->Find(RTMP_RECONNECT_FIELD);
+  if (rtmp_reconnect_field && rtmp_reconnect_field->GetAsBoolean(&rtmp_reconnect)) {
+    conf.SetRtmpReconnect(rtmp_reconnect);
+  }
+
+  int output_queue_msec;
+  common::Value* output_queue_msec_field = config_args->Find(OUTPUT_QUEUE_MSEC_FIELD);
+  if (output_queue_msec_field && output_queue_msec_field->GetAsInteger(&output_queue_msec) && output_queue_msec > 0) {
+    conf.SetOutputQueueMsec(output_queue_msec);
+  }
+
+  int latency_target_msec;
+  common::Value* latency_target_msec_field = config_args->Find(LATENCY_TARGET_MSEC_FIELD);
+  if (latency_target_msec_field && latency_target_msec_field->GetAsInteger(&latency_target_msec) &&
+      latency_target_msec > 0) {
+    conf.SetLatencyTargetMsec(latency_target_msec);
+  }
+
+  bool clock_sync;
+  common::Value* clock_sync_field = config_args->Find(CLOCK_SYNC_FIELD);
+  if (clock_sync_field && clock_sync_field->GetAsBoolean(&clock_sync)) {
+    conf.SetClockSync(clock_sync);
+  }
+
+  std::string net_clock;
+  common::Value* net_clock_field = config_args->Find(NET_CLOCK_FIELD);
+  if (net_clock_field && net_clock_field->GetAsBasicString(&net_clock)) {
+    conf.SetNetClock(net_clock);
+  }
+
+  int pipeline_latency_msec;
+  common::Value* pipeline_latency_msec_field = config_args->Find(PIPELINE_LATENCY_MSEC_FIELD);
+  if (pipeline_latency_msec_field && pipeline_latency_msec_field->GetAsInteger(&pipeline_latency_msec) &&
+      pipeline_latency_msec > 0) {
+    conf.SetPipelineLatencyMsec(pipeline_latency_msec);
+  }
+
+  bool muted_outputs;
+  common::Value* muted_outputs_field = config_args->Find(MUTED_OUTPUTS_FIELD);
+  if (muted_outputs_field && muted_outputs_field->GetAsBoolean(&muted_outputs)) {
+    conf.SetMutedOutputs(muted_outputs);
+  }
+
+  std::string ingest_dir;
+  common::Value* ingest_dir_field = config_args->Find(INGEST_DIR_FIELD);
+  if (ingest_dir_field && ingest_dir_field->GetAsBasicString(&ingest_dir)) {
+    conf.SetIngestDir(ingest_dir);
+  }
+
+  std::string output_trash_dir;
+  common::Value* output_trash_dir_field = config_args->Find(OUTPUT_TRASH_DIR_FIELD);
+  if (output_trash_dir_field && output_trash_dir_field->GetAsBasicString(&output_trash_dir)) {
+    conf.SetOutputTrashDir(output_trash_dir);
+  }
+
+  int thumbnail_interval;
+  std::string thumbnail_dir;
+  common::Value* thumbnail_interval_field = config_args->Find(THUMBNAIL_INTERVAL_FIELD);
+  common::Value* thumbnail_dir_field = config_args->Find(FEEDBACK_DIR_FIELD);
+  if (thumbnail_interval_field && thumbnail_interval_field->GetAsInteger(&thumbnail_interval) &&
+      thumbnail_interval > 0 && thumbnail_dir_field && thumbnail_dir_field->GetAsBasicString(&thumbnail_dir)) {
+    auto thumbnail_path = common::file_system::ascii_directory_string_path(thumbnail_dir).MakeFileStringPath(
+        THUMBNAIL_FILE_NAME);
+    int thumbnail_width = DEFAULT_THUMBNAIL_WIDTH;
+    common::Value* thumbnail_width_field = config_args->Find(THUMBNAIL_WIDTH_FIELD);
+    if (thumbnail_width_field) {
+      ignore_result(thumbnail_width_field->GetAsInteger(&thumbnail_width));
+    }
+    if (thumbnail_path) {
+      conf.SetThumbnail(Thumbnail(thumbnail_path->GetPath(), thumbnail_interval, thumbnail_width));
+    }
+  }
+
+#if defined(AMAZON_KINESIS)
+  common::HashValue* amazon_kinesis_hash = nullptr;
+  common::Value* amazon_kinesis_field = config_args->Find(AMAZON_KINESIS_FIELD);
+  if (amazon_kinesis_field && amazon_kinesis_field->GetAsHash(&amazon_kinesis_hash)) {
+    conf.SetAmazonKinesis(amazon_kinesis::AmazonKinesis::MakeAmazonKinesis(amazon_kinesis_hash));
+  }
+#endif
+
+  socket_tunings_t input_sockets;
+  if (read_input_sockets(config_args, &input_sockets)) {
+    conf.SetInputSockets(input_sockets);
+  }
+
+  socket_tunings_t output_sockets;
+  if (read_output_sockets(config_args, &output_sockets)) {
+    conf.SetOutputSockets(output_sockets);
+  }
+
+  http_tunings_t input_https;
+  if (read_input_http(config_args, &input_https)) {
+    conf.SetInputHttps(input_https);
+  }
+
+  mpts_tunings_t input_mptses;
+  if (read_input_mpts(config_args, &input_mptses)) {
+    conf.SetInputMptses(input_mptses);
+  }
+
+  tcp_tunings_t output_tcps;
+  if (read_output_tcp(config_args, &output_tcps)) {
+    conf.SetOutputTcps(output_tcps);
+  }
+
   streams::AudioVideoConfig aconf(conf);
   bool have_video;
   common::Value* have_video_field = config_args->Find(HAVE_VIDEO_FIELD);
@@ -229,6 +511,20 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
     aconf.SetAudioSelect(audio_select);
   }
 
+  common::ArrayValue* audio_tracks_list = nullptr;
+  common::Value* audio_tracks_field = config_args->Find(AUDIO_TRACKS_FIELD);
+  if (audio_tracks_field && audio_tracks_field->GetAsList(&audio_tracks_list)) {
+    streams::AudioVideoConfig::audio_tracks_t audio_tracks;
+    for (size_t i = 0; i < audio_tracks_list->GetSize(); ++i) {
+      int track;
+      common::Value* item = nullptr;
+      if (audio_tracks_list->Get(i, &item) && item->GetAsInteger(&track) && track >= 0) {
+        audio_tracks.push_back(track);
+      }
+    }
+    aconf.SetAudioTracks(audio_tracks);
+  }
+
   bool avformat;
   common::Value* avformat_field = config_args->Find(AVFORMAT_FIELD);
   if (avformat_field && avformat_field->GetAsBoolean(&avformat)) {
@@ -241,6 +537,52 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
     aconf.SetLoop(loop);
   }
 
+  bool mmap;
+  common::Value* mmap_field = config_args->Find(MMAP_FIELD);
+  if (mmap_field && mmap_field->GetAsBoolean(&mmap)) {
+    aconf.SetMmap(mmap);
+  }
+
+  bool warm_standby;
+  common::Value* warm_standby_field = config_args->Find(WARM_STANDBY_FIELD);
+  if (warm_standby_field && warm_standby_field->GetAsBoolean(&warm_standby)) {
+    aconf.SetWarmStandby(warm_standby);
+  }
+
+  bool hitless_merge;
+  common::Value* hitless_merge_field = config_args->Find(HITLESS_MERGE_FIELD);
+  if (hitless_merge_field && hitless_merge_field->GetAsBoolean(&hitless_merge)) {
+    aconf.SetHitlessMerge(hitless_merge);
+  }
+
+  bool soft_restart;
+  common::Value* soft_restart_field = config_args->Find(SOFT_RESTART_FIELD);
+  if (soft_restart_field && soft_restart_field->GetAsBoolean(&soft_restart)) {
+    aconf.SetSoftRestart(soft_restart);
+  }
+
+  bool gapless;
+  common::Value* gapless_field = config_args->Find(GAPLESS_FIELD);
+  if (gapless_field && gapless_field->GetAsBoolean(&gapless)) {
+    aconf.SetGapless(gapless);
+  }
+
+  bool autoplug_cache;
+  std::string feedback_dir;
+  common::Value* autoplug_cache_field = config_args->Find(AUTOPLUG_CACHE_FIELD);
+  common::Value* feedback_dir_field = config_args->Find(FEEDBACK_DIR_FIELD);
+  if (autoplug_cache_field && autoplug_cache_field->GetAsBoolean(&autoplug_cache) && autoplug_cache &&
+      feedback_dir_field && feedback_dir_field->GetAsBasicString(&feedback_dir)) {
+    common::file_system::ascii_directory_string_path dir(feedback_dir);
+    aconf.SetAutoplugCache(dir.MakeFileStringPath(AUTOPLUG_CACHE_FILE_NAME));
+  }
+
+  bool hw_decode;
+  common::Value* hw_decode_field = config_args->Find(ACTIVE_HW_DECODE_FIELD);
+  if (hw_decode_field && hw_decode_field->GetAsBoolean(&hw_decode)) {
+    aconf.SetHwDecode(hw_decode);
+  }
+
   if (stream_type == fastotv::SCREEN) {
     *config = new streams::AudioVideoConfig(aconf);
     return common::Error();
@@ -261,6 +603,49 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
       rconfig->SetAudioParser(audio_parser);
     }
 
+    bool ts_passthrough;
+    common::Value* ts_passthrough_field = config_args->Find(TS_PASSTHROUGH_FIELD);
+    if (stream_type == fastotv::RELAY && ts_passthrough_field && ts_passthrough_field->GetAsBoolean(&ts_passthrough)) {
+      rconfig->SetTsPassthrough(ts_passthrough);
+    }
+
+    common::ArrayValue* drop_pids_list = nullptr;
+    common::Value* drop_pids_field = config_args->Find(TS_DROP_PIDS_FIELD);
+    if (drop_pids_field && drop_pids_field->GetAsList(&drop_pids_list)) {
+      ts_pids_t drop_pids;
+      for (size_t i = 0; i < drop_pids_list->GetSize(); ++i) {
+        int pid;
+        common::Value* item = nullptr;
+        if (drop_pids_list->Get(i, &item) && item->GetAsInteger(&pid) && pid >= 0 && pid < 0x1FFF) {  // null pid kept
+          drop_pids.push_back(pid);
+        }
+      }
+      rconfig->SetTsDropPids(drop_pids);
+    }
+
+#if defined(MACHINE_LEARNING)
+    common::HashValue* deep_learning_hash = nullptr;
+    common::Value* deep_learning_field = config_args->Find(DEEP_LEARNING_FIELD);
+    if (stream_type == fastotv::RELAY && deep_learning_field && deep_learning_field->GetAsHash(&deep_learning_hash)) {
+      auto deep_learning = machine_learning::DeepLearning::MakeDeepLearning(deep_learning_hash);
+      if (deep_learning) {
+        rconfig->SetDeepLearning(*deep_learning);
+      }
+    }
+
+    std::string inference_shm;
+    common::Value* inference_shm_field = config_args->Find(ACTIVE_INFERENCE_SHM_FIELD);
+    if (inference_shm_field && inference_shm_field->GetAsBasicString(&inference_shm)) {
+      rconfig->SetInferenceShm(inference_shm);
+    }
+
+    bool deep_learning_metadata;
+    common::Value* deep_learning_metadata_field = config_args->Find(DEEP_LEARNING_METADATA_FIELD);
+    if (deep_learning_metadata_field && deep_learning_metadata_field->GetAsBoolean(&deep_learning_metadata)) {
+      rconfig->SetDeepLearningMetadata(deep_learning_metadata);
+    }
+#endif
+
     if (stream_type == fastotv::VOD_RELAY) {
       streams::VodRelayConfig* vconf = new streams::VodRelayConfig(*rconfig);
       delete rconfig;
@@ -289,6 +674,24 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
       econfig->SetRelayVideo(relay_video);
     }
 
+    bool passthrough;
+    common::Value* passthrough_field = config_args->Find(PASSTHROUGH_FIELD);
+    if (passthrough_field && passthrough_field->GetAsBoolean(&passthrough)) {
+      econfig->SetPassthrough(passthrough);
+    }
+
+    bool low_latency;
+    common::Value* low_latency_field = config_args->Find(LOW_LATENCY_FIELD);
+    if (low_latency_field && low_latency_field->GetAsBoolean(&low_latency)) {
+      econfig->SetLowLatency(low_latency);
+    }
+
+    bool network_feedback;
+    common::Value* network_feedback_field = config_args->Find(NETWORK_FEEDBACK_FIELD);
+    if (network_feedback_field && network_feedback_field->GetAsBoolean(&network_feedback)) {
+      econfig->SetNetworkFeedback(network_feedback);
+    }
+
     bool deinterlace;
     common::Value* deinterlace_field = config_args->Find(DEINTERLACE_FIELD);
     if (deinterlace_field && deinterlace_field->GetAsBoolean(&deinterlace)) {
@@ -307,10 +710,19 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
       econfig->SetVolume(volume);
     }
 
+    double loudness_target;
+    common::Value* loudness_target_field = config_args->Find(LOUDNESS_TARGET_FIELD);
+    if (loudness_target_field && loudness_target_field->GetAsDouble(&loudness_target)) {
+      econfig->SetLoudnessTarget(loudness_target);
+    }
+
     std::string video_codec;
-    common::Value* video_codec_field = config_args->Find(VIDEO_CODEC_FIELD);
-    if (video_codec_field && video_codec_field->GetAsBasicString(&video_codec)) {
+    if (read_video_codec(config_args, &video_codec)) {
       econfig->SetVideoEncoder(video_codec);
+      if (elements::encoders::IsAV1Encoder(video_codec) && !econfig->GetCmaf()) {
+        // mpegts has no av1 mapping, http outputs muxed into mp4 fragments
+        econfig->SetCmaf(true);
+      }
     }
 
     std::string audio_codec;
@@ -325,6 +737,12 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
       econfig->SetAudioChannelsCount(audio_channels);
     }
 
+    bool audio_dithering;
+    common::Value* audio_dithering_field = config_args->Find(AUDIO_DITHERING_FIELD);
+    if (audio_dithering_field && audio_dithering_field->GetAsBoolean(&audio_dithering)) {
+      econfig->SetAudioDithering(audio_dithering);
+    }
+
     common::draw::Size size;
     common::Value* size_field = config_args->Find(SIZE_FIELD);
     std::string size_str;
@@ -338,6 +756,12 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
       econfig->SetVideoBitrate(v_bitrate);
     }
 
+    int v_min_bitrate;
+    common::Value* video_min_bitrate_field = config_args->Find(VIDEO_MIN_BIT_RATE_FIELD);
+    if (video_min_bitrate_field && video_min_bitrate_field->GetAsInteger(&v_min_bitrate) && v_min_bitrate > 0) {
+      econfig->SetVideoMinBitrate(v_min_bitrate);
+    }
+
     int a_bitrate;
     common::Value* audio_bitrate_field = config_args->Find(AUDIO_BIT_RATE_FIELD);
     if (audio_bitrate_field && audio_bitrate_field->GetAsInteger(&a_bitrate)) {
@@ -354,6 +778,12 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
       }
     }
 
+    std::string inference_shm;
+    common::Value* inference_shm_field = config_args->Find(ACTIVE_INFERENCE_SHM_FIELD);
+    if (inference_shm_field && inference_shm_field->GetAsBasicString(&inference_shm)) {
+      econfig->SetInferenceShm(inference_shm);
+    }
+
     common::HashValue* deep_learning_overlay_hash = nullptr;
     common::Value* deep_learning_overlay_field = config_args->Find(DEEP_LEARNING_OVERLAY_FIELD);
     if (deep_learning_overlay_field && deep_learning_overlay_field->GetAsHash(&deep_learning_overlay_hash)) {
@@ -363,6 +793,12 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
         econfig->SetDeepLearningOverlay(*deep_learning_overlay);
       }
     }
+
+    bool deep_learning_metadata;
+    common::Value* deep_learning_metadata_field = config_args->Find(DEEP_LEARNING_METADATA_FIELD);
+    if (deep_learning_metadata_field && deep_learning_metadata_field->GetAsBoolean(&deep_learning_metadata)) {
+      econfig->SetDeepLearningMetadata(deep_learning_metadata);
+    }
 #endif
 
     common::HashValue* logo_hash = nullptr;
@@ -383,6 +819,14 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
       }
     }
 
+    std::string assets_dir;  // own feedback dir if not shared by daemon
+    common::Value* assets_dir_field = config_args->Find(ASSETS_DIR_FIELD);
+    common::Value* feedback_dir_field = config_args->Find(FEEDBACK_DIR_FIELD);
+    if ((assets_dir_field && assets_dir_field->GetAsBasicString(&assets_dir)) ||
+        (feedback_dir_field && feedback_dir_field->GetAsBasicString(&assets_dir))) {
+      econfig->SetAssetsDir(common::file_system::ascii_directory_string_path(assets_dir));
+    }
+
     common::media::Rational rat;
     common::Value* rat_field = config_args->Find(ASPECT_RATIO_FIELD);
     std::string rat_str;
@@ -396,9 +840,34 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
       econfig->SetDecklinkMode(decl_vm);
     }
 
+    int v4l2_io_mode;
+    common::Value* v4l2_io_mode_field = config_args->Find(V4L2_IO_MODE_FIELD);
+    if (v4l2_io_mode_field && v4l2_io_mode_field->GetAsInteger(&v4l2_io_mode)) {
+      econfig->SetV4L2IoMode(v4l2_io_mode);
+    }
+
+    common::ArrayValue* renditions_list = nullptr;
+    common::Value* renditions_field = config_args->Find(RENDITIONS_FIELD);
+    if (renditions_field && renditions_field->GetAsList(&renditions_list)) {
+      econfig->SetRenditions(ReadRenditions(renditions_list));
+    }
+
+    int gpu_device;
+    common::Value* gpu_device_field = config_args->Find(ACTIVE_GPU_DEVICE_FIELD);
+    if (gpu_device_field && gpu_device_field->GetAsInteger(&gpu_device) && gpu_device >= 0) {
+      econfig->SetGpuDevice(gpu_device);
+    }
+
     video_encoders_args_t video_encoder_args;
     video_encoders_str_args_t video_encoder_str_args;
     if (InitVideoEncodersWithArgs(config_args, &video_encoder_args, &video_encoder_str_args)) {
+      // x264 threads by cpus pinned by daemon if not configured
+      common::ArrayValue* cpus_list = nullptr;
+      common::Value* cpus_field = config_args->Find(ACTIVE_CPU_SET_FIELD);
+      if (cpus_field && cpus_field->GetAsList(&cpus_list) && cpus_list->GetSize() &&
+          video_encoder_args.find(X264_ENC_THREADS) == video_encoder_args.end()) {
+        video_encoder_args[X264_ENC_THREADS] = static_cast<int>(cpus_list->GetSize());
+      }
       econfig->SetVideoEncoderArgs(video_encoder_args);
       econfig->SetVideoEncoderStrArgs(video_encoder_str_args);
     }
@@ -412,6 +881,16 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
       if (cleanup_ts_field && cleanup_ts_field->GetAsBoolean(&cleanup_ts)) {
         vconf->SetCleanupTS(cleanup_ts);
       }
+      int workers;
+      common::Value* workers_field = config_args->Find(VOD_WORKERS_FIELD);
+      if (workers_field && workers_field->GetAsInteger(&workers)) {
+        vconf->SetWorkers(workers);
+      }
+      bool offline;
+      common::Value* offline_field = config_args->Find(VOD_OFFLINE_FIELD);
+      if (offline_field && offline_field->GetAsBoolean(&offline)) {
+        vconf->SetOffline(offline);
+      }
     }
 
     *config = econfig;
@@ -439,6 +918,54 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
     }
     CHECK(tconf->GetTimeShiftChunkDuration()) << "Avoid division by zero";
 
+    bool chunk_writer;
+    common::Value* chunk_writer_field = config_args->Find(TIMESHIFT_CHUNK_WRITER_FIELD);
+    if (chunk_writer_field && chunk_writer_field->GetAsBoolean(&chunk_writer)) {
+      tconf->SetTimeShiftChunkWriter(chunk_writer);
+    }
+
+    bool direct_io;
+    common::Value* direct_io_field = config_args->Find(TIMESHIFT_DIRECT_IO_FIELD);
+    if (direct_io_field && direct_io_field->GetAsBoolean(&direct_io)) {
+      tconf->SetTimeShiftDirectIO(direct_io);
+    }
+
+    bool hour_files;
+    common::Value* hour_files_field = config_args->Find(TIMESHIFT_HOUR_FILES_FIELD);
+    if (hour_files_field && hour_files_field->GetAsBoolean(&hour_files)) {
+      tconf->SetTimeShiftHourFiles(hour_files);
+    }
+
+    std::string cold_dir;
+    common::Value* cold_dir_field = config_args->Find(TIMESHIFT_COLD_DIR_FIELD);
+    if (cold_dir_field && cold_dir_field->GetAsBasicString(&cold_dir)) {
+      tconf->SetTimeShiftColdDir(cold_dir);
+    }
+
+    int hot_time;
+    common::Value* hot_time_field = config_args->Find(TIMESHIFT_HOT_TIME_FIELD);
+    if (hot_time_field && hot_time_field->GetAsInteger(&hot_time)) {
+      tconf->SetTimeShiftHotTime(hot_time);
+    }
+
+    int move_rate;
+    common::Value* move_rate_field = config_args->Find(TIMESHIFT_MOVE_RATE_FIELD);
+    if (move_rate_field && move_rate_field->GetAsInteger(&move_rate)) {
+      tconf->SetTimeShiftMoveRate(move_rate);
+    }
+
+    std::string recorder_dir;
+    common::Value* recorder_dir_field = config_args->Find(CATCHUP_RECORDER_DIR_FIELD);
+    if (recorder_dir_field && recorder_dir_field->GetAsBasicString(&recorder_dir)) {
+      tconf->SetCatchupRecorderDir(recorder_dir);
+    }
+
+    time_t stop_utc;
+    common::Value* stop_utc_field = config_args->Find(CATCHUP_STOP_UTC_FIELD);
+    if (stop_utc_field && GetTimeFromValue(stop_utc_field, &stop_utc)) {
+      tconf->SetCatchupStopUtc(stop_utc);
+    }
+
     *config = tconf;
     return common::Error();
   }
@@ -446,17 +973,32 @@ common::Error make_config(const StreamConfig& config_args, Config** config) {
   return common::make_error(common::MemSPrintf("Unhandled stream type: %d", stream_type));
 }
 
+bool make_generated_input(const Config* conf, const link_generator::ILinkGenerator* generator, input_t* input) {
+  if (!conf || !generator || !input) {
+    return false;
+  }
+
+  bool generated = false;
+  input_t linput = conf->GetInput();
+  for (size_t i = 0; i < linput.size(); ++i) {
+    InputUri url;
+    if (generator->Generate(linput[i], &url)) {
+      linput[i] = url;
+      generated = true;
+      DEBUG_LOG() << "Generated url: " << url.GetInput().GetUrl();
+    }
+  }
+
+  if (generated) {
+    *input = linput;
+  }
+  return generated;
+}
+
 Config* make_config_copy(const Config* conf, const link_generator::ILinkGenerator* generator) {
   Config* copy = conf->Clone();
-  if (generator) {
-    input_t input = copy->GetInput();
-    for (size_t i = 0; i < input.size(); ++i) {
-      InputUri url;
-      if (generator->Generate(input[i], &url)) {
-        input[i] = url;
-        DEBUG_LOG() << "Generated url: " << url.GetInput().GetUrl();
-      }
-    }
+  input_t input;
+  if (make_generated_input(conf, generator, &input)) {
     copy->SetInput(input);
   }
 
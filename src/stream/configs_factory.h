@@ -14,8 +14,11 @@
 
 #pragma once
 
+#include <string>
+
 #include <common/error.h>
 
+#include "base/inputs_outputs.h"
 #include "base/stream_config.h"
 
 namespace fastocloud {
@@ -26,8 +29,14 @@ class ILinkGenerator;
 }
 
 class Config;
+// codec selected by daemon for current start, configured one otherwise
+bool read_video_codec(const StreamConfig& config_args, std::string* video_codec) WARN_UNUSED_RESULT;
 common::Error make_config(const StreamConfig& config_args, Config** config) WARN_UNUSED_RESULT;
 
+// false if no input resolved by generator, config can be used as is without copy
+bool make_generated_input(const Config* conf,
+                          const link_generator::ILinkGenerator* generator,
+                          input_t* input) WARN_UNUSED_RESULT;
 Config* make_config_copy(const Config* conf, const link_generator::ILinkGenerator* generator);
 
 }  // namespace stream
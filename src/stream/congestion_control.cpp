@@ -0,0 +1,84 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/congestion_control.h"
+
+#include <algorithm>
+
+namespace fastocloud {
+namespace stream {
+
+CongestionControl::CongestionControl() : outputs_(), congested_(false), percent_(100), hold_(0), clean_(0) {}
+
+void CongestionControl::Report(size_t output, const Feedback& feedback) {
+  if (output >= outputs_.size()) {
+    OutputState state = {false, 0, 0};
+    outputs_.resize(output + 1, state);
+  }
+
+  OutputState* state = &outputs_[output];
+  if (feedback.queue_fill >= congested_fill) {
+    congested_ = true;
+  }
+
+  if (state->have_drops && feedback.drops > state->drops) {
+    congested_ = true;
+  }
+  state->drops = feedback.drops;  // counters reset with restarted sink
+  state->have_drops = true;
+
+  if (feedback.rtt_msec > 0) {
+    if (!state->min_rtt_msec || feedback.rtt_msec < state->min_rtt_msec) {
+      state->min_rtt_msec = feedback.rtt_msec;
+    }
+    if (feedback.rtt_msec > state->min_rtt_msec + rtt_slack_msec && feedback.rtt_msec > state->min_rtt_msec * 2) {
+      congested_ = true;
+    }
+  }
+}
+
+bool CongestionControl::Update(int* percent) {
+  const bool congested = congested_;
+  congested_ = false;
+  if (!percent) {
+    return false;
+  }
+
+  const int prev = percent_;
+  if (congested) {
+    clean_ = 0;
+    if (hold_ > 0) {
+      hold_--;
+    } else {
+      percent_ = std::max<int>(min_percent, percent_ - percent_ * step_down_percent / 100);
+      hold_ = hold_ticks;
+    }
+  } else {
+    hold_ = std::max(hold_ - 1, 0);
+    if (++clean_ >= clean_ticks) {
+      percent_ = std::min(100, percent_ + step_up_percent);
+      clean_ = 0;
+    }
+  }
+
+  *percent = percent_;
+  return percent_ != prev;
+}
+
+int CongestionControl::GetPercent() const {
+  return percent_;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace stream {
+
+// share of configured video bitrate left for congested network outputs, cut fast and restored slowly
+class CongestionControl {
+ public:
+  enum {
+    congested_fill = 50,     // percent of output queue, sink not keeping up with encoder
+    rtt_slack_msec = 100,    // rtt above lowest seen one by more and twice of it
+    hold_ticks = 3,          // after cut, queues drained before next one
+    clean_ticks = 10,        // without congestion before step up
+    step_down_percent = 20,  // of current share
+    step_up_percent = 5,     // of configured bitrate
+    min_percent = 25
+  };
+
+  struct Feedback {
+    int queue_fill;         // percent, -1 if not known
+    uint64_t drops;         // cumulative, queue and srt sender drops
+    int64_t rtt_msec;       // 0 if not known
+  };
+
+  CongestionControl();
+
+  void Report(size_t output, const Feedback& feedback);  // each output on tick, before Update
+  bool Update(int* percent) WARN_UNUSED_RESULT;          // true if share changed
+  int GetPercent() const;
+
+ private:
+  struct OutputState {
+    bool have_drops;
+    uint64_t drops;
+    int64_t min_rtt_msec;
+  };
+
+  std::vector<OutputState> outputs_;
+  bool congested_;  // reported on current tick
+  int percent_;
+  int hold_;
+  int clean_;
+
+  DISALLOW_COPY_AND_ASSIGN(CongestionControl);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,259 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/detection_sei.h"
+
+#include <string.h>
+
+#include <sstream>
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+
+const uint8_t kSeiUserDataUnregistered = 5;
+const uint8_t kH264SeiNal = 6;
+const uint8_t kH265PrefixSeiNal = 39;
+
+bool is_slice(uint8_t nal_header, bool hevc) {
+  if (hevc) {
+    return ((nal_header >> 1) & 0x3f) < 32;  // vcl types
+  }
+  const uint8_t type = nal_header & 0x1f;
+  return type >= 1 && type <= 5;
+}
+
+// nal length size of avc/hvcc stream format from codec data, 0 if byte-stream or unknown
+size_t get_length_size(GstCaps* caps, bool hevc, bool* byte_stream) {
+  GstStructure* structure = gst_caps_get_structure(caps, 0);
+  const gchar* format = gst_structure_get_string(structure, "stream-format");
+  *byte_stream = !format || g_str_equal(format, "byte-stream");
+  if (*byte_stream) {
+    return 0;
+  }
+
+  const GValue* codec_data = gst_structure_get_value(structure, "codec_data");
+  GstBuffer* config = codec_data ? gst_value_get_buffer(codec_data) : nullptr;
+  GstMapInfo map;
+  if (!config || !gst_buffer_map(config, &map, GST_MAP_READ)) {
+    return 0;
+  }
+
+  const size_t offset = hevc ? 21 : 4;  // lengthSizeMinusOne of hvcC and avcC
+  const size_t length_size = map.size > offset ? (map.data[offset] & 0x03) + 1 : 0;
+  gst_buffer_unmap(config, &map);
+  return length_size;
+}
+
+}  // namespace
+
+struct DetectionSei::PadContext {
+  DetectionSei* sei;
+  bool hevc;
+  uint64_t seq;  // last sent on pad
+};
+
+const uint8_t DetectionSei::uuid[uuid_size] = {0x8c, 0x1b, 0x6e, 0x2a, 0x57, 0x0d, 0x4f, 0x32,
+                                               0x9e, 0x41, 0xb5, 0x73, 0x06, 0xd8, 0xc2, 0x9f};
+
+DetectionSei::DetectionSei() : mutex_(), pending_(), seq_(0) {}
+
+void DetectionSei::Push(const images_t& images) {
+  const std::string payload = MakePayload(images);
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_ = payload;
+  seq_++;
+}
+
+void DetectionSei::Attach(GstPad* pad, bool hevc) {
+  PadContext* context = new PadContext{this, hevc, 0};
+  gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, &DetectionSei::buffer_probe, context,
+                    &DetectionSei::destroy_context);
+}
+
+std::string DetectionSei::MakePayload(const images_t& images) {
+  std::ostringstream payload;
+  payload << "{\"boxes\":[";
+  for (size_t i = 0; i < images.size(); ++i) {
+    const fastotv::commands_info::ml::ImageBox& box = images[i];
+    if (i) {
+      payload << ",";
+    }
+    payload << "{\"label\":" << box.label << ",\"prob\":" << box.prob << ",\"x\":" << box.x << ",\"y\":" << box.y
+            << ",\"width\":" << box.width << ",\"height\":" << box.height << "}";
+  }
+  payload << "]}";
+  return payload.str();
+}
+
+DetectionSei::nal_t DetectionSei::MakeNal(const std::string& payload, bool hevc) {
+  nal_t rbsp;
+  rbsp.push_back(kSeiUserDataUnregistered);
+  size_t size = uuid_size + payload.size();
+  for (; size >= 0xff; size -= 0xff) {
+    rbsp.push_back(0xff);
+  }
+  rbsp.push_back(static_cast<uint8_t>(size));
+  rbsp.insert(rbsp.end(), uuid, uuid + uuid_size);
+  rbsp.insert(rbsp.end(), payload.begin(), payload.end());
+  rbsp.push_back(0x80);  // rbsp trailing bits
+
+  nal_t nal;
+  if (hevc) {
+    nal.push_back(kH265PrefixSeiNal << 1);
+    nal.push_back(1);  // layer 0, temporal id 0
+  } else {
+    nal.push_back(kH264SeiNal);
+  }
+  size_t zeros = 0;
+  for (uint8_t byte : rbsp) {
+    if (zeros >= 2 && byte <= 3) {
+      nal.push_back(3);  // emulation prevention
+      zeros = 0;
+    }
+    nal.push_back(byte);
+    zeros = byte ? 0 : zeros + 1;
+  }
+  return nal;
+}
+
+size_t DetectionSei::FindFirstSlice(const uint8_t* data, size_t size, bool hevc, size_t length_size) {
+  if (!data) {
+    return size;
+  }
+
+  if (!length_size) {
+    for (size_t i = 0; i + 3 < size; ++i) {
+      if (data[i] || data[i + 1] || data[i + 2] != 1) {
+        continue;
+      }
+      if (is_slice(data[i + 3], hevc)) {
+        return i && !data[i - 1] ? i - 1 : i;  // 4 bytes start code
+      }
+      i += 2;
+    }
+    return size;
+  }
+
+  size_t offset = 0;
+  while (offset + length_size < size) {
+    size_t nal_size = 0;
+    for (size_t i = 0; i < length_size; ++i) {
+      nal_size = (nal_size << 8) | data[offset + i];
+    }
+    if (is_slice(data[offset + length_size], hevc)) {
+      return offset;
+    }
+    offset += length_size + nal_size;
+  }
+  return size;
+}
+
+bool DetectionSei::Take(uint64_t* seq, std::string* payload) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (seq_ == *seq) {
+    return false;
+  }
+
+  *seq = seq_;
+  *payload = pending_;
+  return true;
+}
+
+GstBuffer* DetectionSei::Insert(GstBuffer* buffer, GstPad* pad, bool hevc, const std::string& payload) const {
+  GstCaps* caps = gst_pad_get_current_caps(pad);
+  if (!caps) {
+    return nullptr;
+  }
+  bool byte_stream;
+  const size_t length_size = get_length_size(caps, hevc, &byte_stream);
+  gst_caps_unref(caps);
+  if (!byte_stream && !length_size) {
+    return nullptr;
+  }
+
+  const nal_t nal = MakeNal(payload, hevc);
+  const size_t prefix_size = byte_stream ? 4 : length_size;
+  if (!byte_stream && length_size < 4 && nal.size() >= (1u << (8 * length_size))) {
+    return nullptr;
+  }
+
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    return nullptr;
+  }
+  const size_t offset = FindFirstSlice(map.data, map.size, hevc, length_size);
+  if (offset == map.size) {  // not access unit with slices
+    gst_buffer_unmap(buffer, &map);
+    return nullptr;
+  }
+
+  GstBuffer* out = gst_buffer_new_allocate(nullptr, map.size + prefix_size + nal.size(), nullptr);
+  GstMapInfo out_map;
+  if (!out || !gst_buffer_map(out, &out_map, GST_MAP_WRITE)) {
+    gst_buffer_unmap(buffer, &map);
+    if (out) {
+      gst_buffer_unref(out);
+    }
+    return nullptr;
+  }
+
+  uint8_t* ptr = out_map.data;
+  memcpy(ptr, map.data, offset);
+  ptr += offset;
+  if (byte_stream) {
+    const uint8_t start_code[] = {0, 0, 0, 1};
+    memcpy(ptr, start_code, sizeof(start_code));
+  } else {
+    for (size_t i = 0; i < length_size; ++i) {
+      ptr[i] = static_cast<uint8_t>(nal.size() >> (8 * (length_size - i - 1)));
+    }
+  }
+  ptr += prefix_size;
+  memcpy(ptr, nal.data(), nal.size());
+  ptr += nal.size();
+  memcpy(ptr, map.data + offset, map.size - offset);
+  gst_buffer_unmap(out, &out_map);
+  gst_buffer_unmap(buffer, &map);
+  gst_buffer_copy_into(out, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
+  return out;
+}
+
+GstPadProbeReturn DetectionSei::buffer_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  PadContext* context = static_cast<PadContext*>(user_data);
+  uint64_t seq = context->seq;
+  std::string payload;
+  if (!context->sei->Take(&seq, &payload)) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstBuffer* buffer = gst_pad_probe_info_get_buffer(info);
+  GstBuffer* out = context->sei->Insert(buffer, pad, context->hevc, payload);
+  if (!out) {  // parameter sets only or unknown stream format, next access unit tries
+    return GST_PAD_PROBE_OK;
+  }
+
+  context->seq = seq;
+  gst_buffer_unref(buffer);
+  GST_PAD_PROBE_INFO_DATA(info) = out;
+  return GST_PAD_PROBE_OK;
+}
+
+void DetectionSei::destroy_context(gpointer user_data) {
+  delete static_cast<PadContext*>(user_data);
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,66 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gst/gst.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/macros.h>
+
+#include <fastotv/commands_info/ml/types.h>
+
+namespace fastocloud {
+namespace stream {
+
+// detections carried to players as user data unregistered sei of next h264/h265 access unit,
+// boxes drawn by players instead of overlay of pipeline, every inference result sent once per pad
+class DetectionSei {
+ public:
+  typedef std::vector<fastotv::commands_info::ml::ImageBox> images_t;
+  typedef std::vector<uint8_t> nal_t;
+  enum { uuid_size = 16 };
+  static const uint8_t uuid[uuid_size];  // of detections payload
+
+  DetectionSei();
+
+  void Push(const images_t& images);  // streaming threads of inference, latest detections win
+  void Attach(GstPad* pad, bool hevc);  // src pad of parser, lives while stream lives
+
+  static std::string MakePayload(const images_t& images);  // {"boxes":[{"label":..,"prob":..,"x":..}]}
+  static nal_t MakeNal(const std::string& payload, bool hevc);  // without start code, emulation prevented
+  // offset of first slice of access unit, start codes if length_size is 0, size if no slice found
+  static size_t FindFirstSlice(const uint8_t* data, size_t size, bool hevc, size_t length_size);
+
+ private:
+  struct PadContext;
+
+  bool Take(uint64_t* seq, std::string* payload) const;
+  GstBuffer* Insert(GstBuffer* buffer, GstPad* pad, bool hevc, const std::string& payload) const;
+
+  static GstPadProbeReturn buffer_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static void destroy_context(gpointer user_data);
+
+  mutable std::mutex mutex_;
+  std::string pending_;  // payload of latest detections
+  uint64_t seq_;        // 0 if nothing detected yet
+
+  DISALLOW_COPY_AND_ASSIGN(DetectionSei);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -27,7 +27,64 @@ namespace fastocloud {
 namespace stream {
 namespace dumper {
 
-bool HtmlDump::Dump(GstBin* pipeline, const common::file_system::ascii_file_string_path& path) {
+namespace {
+#if !defined(GST_DISABLE_GST_DEBUG)
+// same canonization as gst_debug_bin_to_dot_data uses for cluster names
+std::string make_cluster_prefix(const std::string& name) {
+  std::string canon = name;
+  for (char& c : canon) {
+    if (!g_ascii_isalnum(c) && c != '_') {
+      c = '_';
+    }
+  }
+  return "subgraph cluster_" + canon + "_0x";
+}
+
+std::string escape_html(const std::string& text) {
+  std::string result;
+  for (char c : text) {
+    if (c == '<') {
+      result += "&lt;";
+    } else if (c == '>') {
+      result += "&gt;";
+    } else if (c == '&') {
+      result += "&amp;";
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+// stats as first line of element label
+void annotate_dot(const IDumper::annotations_t& annotations, std::string* dot) {
+  for (const auto& annotation : annotations) {
+    const std::string::size_type cluster = dot->find(make_cluster_prefix(annotation.first));
+    if (cluster == std::string::npos) {
+      continue;
+    }
+
+    static const std::string label = "label=\"";
+    const std::string::size_type label_pos = dot->find(label, cluster);
+    if (label_pos == std::string::npos) {
+      continue;
+    }
+
+    std::string text;
+    for (char c : annotation.second) {
+      if (c != '"' && c != '\\' && c != '`') {
+        text += c;
+      }
+    }
+    dot->insert(label_pos + label.size(), text + "\\n");
+  }
+}
+#endif
+}  // namespace
+
+bool HtmlDump::Dump(GstBin* pipeline,
+                    const common::file_system::ascii_file_string_path& path,
+                    const annotations_t& annotations) {
   if (!path.IsValid()) {
     return false;
   }
@@ -49,20 +106,31 @@ bool HtmlDump::Dump(GstBin* pipeline, const common::file_system::ascii_file_stri
   }
 
   std::string pipeline_description(dot_description);
+  annotate_dot(annotations, &pipeline_description);
   dumpfile << "<html><head></head>"
            << "<body>"
            << "  <script type=\"text/javascript\" src=\"" JS_LIB "\"></script>"
            << "  <script>"
            << "    document.body.innerHTML += Viz(String.raw`" << pipeline_description << "`);"
-           << "  </script>"
-           << "</body>"
+           << "  </script>";
+  if (!annotations.empty()) {
+    dumpfile << "<table border=\"1\"><tr><th>element</th><th>stats</th></tr>";
+    for (const auto& annotation : annotations) {
+      dumpfile << "<tr><td>" << escape_html(annotation.first) << "</td><td>" << escape_html(annotation.second)
+               << "</td></tr>";
+    }
+    dumpfile << "</table>";
+  }
+  dumpfile << "</body>"
            << "</html>";
   g_free(dot_description);
   return true;
 #else
+  UNUSED(annotations);
   return false;
 #endif
 #else
+  UNUSED(annotations);
   return false;
 #endif
 }
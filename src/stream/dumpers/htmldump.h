@@ -22,7 +22,9 @@ namespace dumper {
 
 class HtmlDump : public IDumper {
  public:
-  bool Dump(GstBin* pipeline, const common::file_system::ascii_file_string_path& path) override;
+  bool Dump(GstBin* pipeline,
+            const common::file_system::ascii_file_string_path& path,
+            const annotations_t& annotations) override;
 };
 
 }  // namespace dumper
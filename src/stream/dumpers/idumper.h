@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+
 #include <common/file_system/path.h>
 
 typedef struct _GstBin GstBin;
@@ -24,7 +27,11 @@ namespace dumper {
 
 class IDumper {
  public:
-  virtual bool Dump(GstBin* pipeline, const common::file_system::ascii_file_string_path& path) = 0;
+  typedef std::map<std::string, std::string> annotations_t;  // element name => stats text
+
+  virtual bool Dump(GstBin* pipeline,
+                    const common::file_system::ascii_file_string_path& path,
+                    const annotations_t& annotations) = 0;
   virtual ~IDumper();
 };
 
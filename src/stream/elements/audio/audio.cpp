@@ -19,6 +19,14 @@ namespace stream {
 namespace elements {
 namespace audio {
 
+void ElementAudioConvert::SetDithering(gint dithering) {
+  SetProperty("dithering", dithering);
+}
+
+void ElementAudioConvert::SetNoiseShaping(gint shaping) {
+  SetProperty("noise-shaping", shaping);
+}
+
 void ElementVolume::SetVolume(gdouble volume) {
   SetProperty("volume", volume);
 }
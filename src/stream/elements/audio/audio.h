@@ -25,6 +25,9 @@ class ElementAudioConvert : public ElementEx<ELEMENT_AUDIO_CONVERT> {
  public:
   typedef ElementEx<ELEMENT_AUDIO_CONVERT> base_class;
   using base_class::base_class;
+
+  void SetDithering(gint dithering = 2);  // Default: tpdf (2), Allowed values: none (0), rpdf (1), tpdf-hf (3)
+  void SetNoiseShaping(gint shaping = 0);  // Default: none (0), Allowed values: error-feedback (1), simple (2)
 };
 
 class ElementAudioResample : public ElementEx<ELEMENT_AUDIO_RESAMPLE> {
@@ -193,6 +193,16 @@ std::string Element::GetStringProperty(const char* property) const {
   return gvalue_cast<const char*>(&gvalue);
 }
 
+bool Element::IsPropertyMutablePlaying(const char* property) const {
+  GParamSpec* spec = g_object_class_find_property(G_OBJECT_GET_CLASS(element_), property);
+  if (!spec || !(spec->flags & G_PARAM_WRITABLE)) {
+    return false;
+  }
+
+  // controllable properties are read by element per buffer, others without mutability flags only in null state
+  return spec->flags & (GST_PARAM_MUTABLE_PLAYING | GST_PARAM_CONTROLLABLE);
+}
+
 std::string Element::GetElementName(GstElement* element) {
   if (!element) {
     return std::string();
@@ -226,6 +236,10 @@ void ElementDecodebin::SetUseBuffering(bool use_buffering) {
   SetProperty("use-buffering", use_buffering);
 }
 
+void ElementDecodebin::SetSinkCaps(GstCaps* caps) {
+  SetProperty("sink-caps", caps);
+}
+
 gboolean ElementDecodebin::RegisterAutoplugContinue(autoplug_continue_callback_t cb, gpointer user_data) {
   return RegisterCallback("autoplug-continue", G_CALLBACK(cb), user_data);
 }
@@ -238,15 +252,35 @@ gboolean ElementDecodebin::RegisterAutoplugSort(autoplug_sort_callback_t cb, gpo
   return RegisterCallback("autoplug-sort", G_CALLBACK(cb), user_data);
 }
 
+void ElementFunnel::SetForwardStickyEvents(bool forward) {
+  SetProperty("forward-sticky-events", forward);
+}
+
+void ElementInputSelector::SetActivePad(GstPad* pad) {
+  SetProperty("active-pad", static_cast<void*>(pad));
+}
+
+void ElementInputSelector::SetSyncStreams(bool sync_streams) {
+  SetProperty("sync-streams", sync_streams);
+}
+
+void ElementInputSelector::SetCacheBuffers(bool cache) {
+  SetProperty("cache-buffers", cache);
+}
+
 void ElementQueue::SetMaxSizeBuffers(guint val) {
   SetProperty("max-size-buffers", val);
 }
 
-void ElementQueue::SetMaxSizeTime(guint val) {
+void ElementQueue::SetMaxSizeTime(guint64 val) {
   SetProperty("max-size-time", val);
 }
 
-void ElementQueue::SetMaxSizeBytes(guint64 val) {
+void ElementQueue::SetLeaky(guint leaky) {
+  SetProperty("leaky", leaky);
+}
+
+void ElementQueue::SetMaxSizeBytes(guint val) {
   SetProperty("max-size-bytes", val);
 }
 
@@ -352,20 +386,27 @@ DECLARE_ELEMENT_TRAITS_SPECIALIZATION(TEST_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(VIDEO_TEST_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(AUDIO_TEST_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(DISPLAY_SRC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(PIPEWIRE_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(VIDEO_SCREEN_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(AUDIO_SCREEN_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(QUEUE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(QUEUE2)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(H264_PARSE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(H265_PARSE)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(AV1_PARSE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MPEG_VIDEO_PARSE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(AAC_PARSE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(AC3_PARSE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MPEG_AUDIO_PARSE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(RAW_AUDIO_PARSE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(TEE)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(FUNNEL)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(INPUT_SELECTOR)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(PARSEBIN)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(CONCAT)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(FLV_MUX)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MPEGTS_MUX)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MP4_MUX)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(FILE_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MULTIFILE_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(RTP_MUX)
@@ -384,6 +425,7 @@ DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SPLIT_MUX_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(ALSA_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MULTIFILE_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(APP_SRC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(APP_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(FILE_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(IMAGE_FREEZE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(CAPS_FILTER)
@@ -399,8 +441,10 @@ DECLARE_ELEMENT_TRAITS_SPECIALIZATION(DEINTERLACE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(ASPECT_RATIO)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(AV_DEINTERLACE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(UDP_SINK)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MULTIUDP_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(TCP_SERVER_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(RTMP_SINK)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SHOUT2_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(HLS_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(KVS_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SOUP_HTTP_SRC)
@@ -409,6 +453,10 @@ DECLARE_ELEMENT_TRAITS_SPECIALIZATION(VIDEO_RATE)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(NV_H264_ENC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(NV_H265_ENC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MSDK_H264_ENC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(NV_AV1_ENC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(QSV_AV1_ENC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(VA_AV1_ENC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SVT_AV1_ENC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(X264_ENC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(X265_ENC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MPEG2_ENC)
@@ -446,10 +494,19 @@ DECLARE_ELEMENT_TRAITS_SPECIALIZATION(AVDEC_AC3_FIXED)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SOUP_HTTP_CLIENT_SINK)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(VAAPI_DECODEBIN)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(VAAPI_POST_PROC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(VAAPI_OVERLAY)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MFX_VPP)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(MFX_H264_DEC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(CUDA_UPLOAD)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(CUDA_CONVERT)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(CUDA_SCALE)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(CUDA_COMPOSITOR)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SRT_SRC)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SRT_SINK)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SHM_SRC)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(SHM_SINK)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(GDP_PAY)
+DECLARE_ELEMENT_TRAITS_SPECIALIZATION(GDP_DEPAY)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(TINY_YOLOV2)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(TINY_YOLOV3)
 DECLARE_ELEMENT_TRAITS_SPECIALIZATION(DETECTION_OVERLAY)
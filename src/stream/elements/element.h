@@ -38,20 +38,27 @@ enum SupportedElements {
   ELEMENT_VIDEO_TEST_SRC,
   ELEMENT_AUDIO_TEST_SRC,
   ELEMENT_DISPLAY_SRC,
+  ELEMENT_PIPEWIRE_SRC,
   ELEMENT_VIDEO_SCREEN_SINK,
   ELEMENT_AUDIO_SCREEN_SINK,
   ELEMENT_QUEUE,
   ELEMENT_QUEUE2,
   ELEMENT_H264_PARSE,
   ELEMENT_H265_PARSE,
+  ELEMENT_AV1_PARSE,
   ELEMENT_MPEG_VIDEO_PARSE,
   ELEMENT_AAC_PARSE,
   ELEMENT_AC3_PARSE,
   ELEMENT_MPEG_AUDIO_PARSE,
   ELEMENT_RAW_AUDIO_PARSE,
   ELEMENT_TEE,
+  ELEMENT_FUNNEL,
+  ELEMENT_INPUT_SELECTOR,
+  ELEMENT_PARSEBIN,
+  ELEMENT_CONCAT,
   ELEMENT_FLV_MUX,
   ELEMENT_MPEGTS_MUX,
+  ELEMENT_MP4_MUX,
   ELEMENT_FILE_SINK,
   ELEMENT_RTP_MUX,
   ELEMENT_RTP_MPEG2_PAY,
@@ -69,6 +76,7 @@ enum SupportedElements {
   ELEMENT_ALSA_SRC,
   ELEMENT_MULTIFILE_SRC,
   ELEMENT_APP_SRC,
+  ELEMENT_APP_SINK,
   ELEMENT_FILE_SRC,
   ELEMENT_IMAGE_FREEZE,
   ELEMENT_CAPS_FILTER,
@@ -84,8 +92,10 @@ enum SupportedElements {
   ELEMENT_DEINTERLACE,
   ELEMENT_AV_DEINTERLACE,
   ELEMENT_UDP_SINK,
+  ELEMENT_MULTIUDP_SINK,
   ELEMENT_TCP_SERVER_SINK,
   ELEMENT_RTMP_SINK,
+  ELEMENT_SHOUT2_SINK,
   ELEMENT_HLS_SINK,
   ELEMENT_MULTIFILE_SINK,
   ELEMENT_KVS_SINK,
@@ -95,6 +105,10 @@ enum SupportedElements {
   ELEMENT_NV_H264_ENC,
   ELEMENT_NV_H265_ENC,
   ELEMENT_MSDK_H264_ENC,
+  ELEMENT_NV_AV1_ENC,
+  ELEMENT_QSV_AV1_ENC,
+  ELEMENT_VA_AV1_ENC,
+  ELEMENT_SVT_AV1_ENC,
   ELEMENT_X264_ENC,
   ELEMENT_X265_ENC,
   ELEMENT_MPEG2_ENC,
@@ -132,10 +146,19 @@ enum SupportedElements {
   ELEMENT_SOUP_HTTP_CLIENT_SINK,
   ELEMENT_VAAPI_DECODEBIN,
   ELEMENT_VAAPI_POST_PROC,
+  ELEMENT_VAAPI_OVERLAY,
   ELEMENT_MFX_VPP,
   ELEMENT_MFX_H264_DEC,
+  ELEMENT_CUDA_UPLOAD,
+  ELEMENT_CUDA_CONVERT,
+  ELEMENT_CUDA_SCALE,
+  ELEMENT_CUDA_COMPOSITOR,
   ELEMENT_SRT_SRC,
   ELEMENT_SRT_SINK,
+  ELEMENT_SHM_SRC,
+  ELEMENT_SHM_SINK,
+  ELEMENT_GDP_PAY,
+  ELEMENT_GDP_DEPAY,
   ELEMENT_TINY_YOLOV2,
   ELEMENT_TINY_YOLOV3,
   ELEMENT_DETECTION_OVERLAY,
@@ -184,6 +207,7 @@ class Element {
 
   GValue GetProperty(const char* property, GType type) const;
   std::string GetStringProperty(const char* property) const;
+  bool IsPropertyMutablePlaying(const char* property) const;  // can be changed in running pipeline
 
   static std::string GetElementName(GstElement* element);
   static std::string GetPluginName(GstElement* element);
@@ -279,6 +303,7 @@ class ElementDecodebin : public ElementBinEx<ELEMENT_DECODEBIN> {
                                                                 gpointer user_data);
 
   void SetUseBuffering(bool use_buffering = false);  // Default: false
+  void SetSinkCaps(GstCaps* caps);                   // Default: NULL, typefind used
 
   gboolean RegisterAutoplugContinue(autoplug_continue_callback_t cb, gpointer user_data) WARN_UNUSED_RESULT;
   gboolean RegisterAutoplugSelect(autoplug_select_callback_t cb, gpointer user_data) WARN_UNUSED_RESULT;
@@ -380,8 +405,9 @@ class ElementQueue : public ElementEx<ELEMENT_QUEUE> {
   using base_class::base_class;
 
   void SetMaxSizeBuffers(guint val = 200);         // 0 - 4294967295 Default: 200
-  void SetMaxSizeTime(guint val = 10485760);       // 0 - 4294967295 Default: 10485760
-  void SetMaxSizeBytes(guint64 val = 1000000000);  // 0 - 18446744073709551615 Default: 1000000000
+  void SetMaxSizeTime(guint64 val = 1000000000);  // 0 - 18446744073709551615 Default: 1000000000
+  void SetMaxSizeBytes(guint val = 10485760);     // 0 - 4294967295 Default: 10485760
+  void SetLeaky(guint leaky = 0);                 // 0 no, 1 upstream, 2 downstream Default: 0
 };
 
 class ElementQueue2 : public ElementEx<ELEMENT_QUEUE2> {
@@ -401,6 +427,48 @@ class ElementTee : public ElementEx<ELEMENT_TEE> {
   using base_class::base_class;
 };
 
+class ElementFunnel : public ElementEx<ELEMENT_FUNNEL> {
+ public:
+  typedef ElementEx<ELEMENT_FUNNEL> base_class;
+  using base_class::base_class;
+
+  void SetForwardStickyEvents(bool forward = true);  // true - false: true
+};
+
+class ElementGDPPay : public ElementEx<ELEMENT_GDP_PAY> {  // buffers with caps in byte stream
+ public:
+  typedef ElementEx<ELEMENT_GDP_PAY> base_class;
+  using base_class::base_class;
+};
+
+class ElementGDPDepay : public ElementEx<ELEMENT_GDP_DEPAY> {
+ public:
+  typedef ElementEx<ELEMENT_GDP_DEPAY> base_class;
+  using base_class::base_class;
+};
+
+class ElementInputSelector : public ElementEx<ELEMENT_INPUT_SELECTOR> {
+ public:
+  typedef ElementEx<ELEMENT_INPUT_SELECTOR> base_class;
+  using base_class::base_class;
+
+  void SetActivePad(GstPad* pad);                 // Default: first linked pad
+  void SetSyncStreams(bool sync_streams = true);  // true - false: true
+  void SetCacheBuffers(bool cache = false);       // true - false: false
+};
+
+class ElementParsebin : public ElementBinEx<ELEMENT_PARSEBIN> {
+ public:
+  typedef ElementBinEx<ELEMENT_PARSEBIN> base_class;
+  using base_class::base_class;
+};
+
+class ElementConcat : public ElementEx<ELEMENT_CONCAT> {  // sink pads played one after another in request order
+ public:
+  typedef ElementEx<ELEMENT_CONCAT> base_class;
+  using base_class::base_class;
+};
+
 class ElementCapsFilter : public ElementEx<ELEMENT_CAPS_FILTER> {
  public:
   typedef ElementEx<ELEMENT_CAPS_FILTER> base_class;
@@ -95,10 +95,16 @@ Element* make_audio_encoder(const std::string& codec, const std::string& name) {
 
 elements_line_t build_audio_converters(volume_t volume,
                                        audio_channels_count_t achannels,
+                                       bool dithering,
                                        ILinker* linker,
                                        element_id_t audio_convert_id) {
   elements::audio::ElementAudioConvert* audio_convert =
       new elements::audio::ElementAudioConvert(common::MemSPrintf(AUDIO_CONVERT_NAME_1U, audio_convert_id));
+  if (!dithering) {
+    // float samples of decoders quantized for encoders without random dither noise generated per sample
+    audio_convert->SetDithering(0);
+    audio_convert->SetNoiseShaping(0);
+  }
   elements::Element* first = audio_convert;
   elements::Element* last = audio_convert;
 
@@ -130,6 +136,10 @@ bool IsAACEncoder(const std::string& encoder) {
   return encoder == ElementFAAC::GetPluginName() || encoder == ElementVoaacEnc::GetPluginName();
 }
 
+bool IsMP3Encoder(const std::string& encoder) {
+  return encoder == ElementMP3Enc::GetPluginName();
+}
+
 }  // namespace encoders
 }  // namespace elements
 }  // namespace stream
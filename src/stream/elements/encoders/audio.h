@@ -80,10 +80,12 @@ Element* make_audio_encoder(const std::string& codec, const std::string& name);
 
 elements_line_t build_audio_converters(volume_t volume,
                                        audio_channels_count_t achannels,
+                                       bool dithering,
                                        ILinker* linker,
                                        element_id_t audio_convert_id);
 
 bool IsAACEncoder(const std::string& encoder);
+bool IsMP3Encoder(const std::string& encoder);
 
 }  // namespace encoders
 }  // namespace elements
@@ -17,7 +17,9 @@
 #include <string.h>
 #include <string>  // for string
 
+#include <gst/gstcapsfeatures.h>
 #include <gst/gstelementfactory.h>
+#include <gst/gstutils.h>
 #include <gst/gstvalue.h>
 
 #include "base/constants.h"
@@ -95,12 +97,89 @@ Element* setup_encoder_str_params(const video_encoders_str_args_t& video_str_arg
   return last;
 }
 
+#define OFFLINE_X264_RC_LOOKAHEAD "60"
+#define OFFLINE_NV_RC_LOOKAHEAD "32"  // max of nvenc
+#define SVT_AV1_REALTIME_PRESET "12"  // 0 - 13, higher faster
+#define SVT_AV1_OFFLINE_PRESET "6"
+
+struct TuningParam {
+  const char* property;
+  const char* value;
+};
+
+// names differ between backends, only properties existing in encoder are installed
+const TuningParam kLowLatencyParams[] = {{"bframes", "0"},
+                                         {"b-frames", "0"},
+                                         {"max-bframes", "0"},
+                                         {"rc-lookahead", "0"},
+                                         {"sync-lookahead", "0"},
+                                         {"zerolatency", "true"},
+                                         {"async-depth", "1"},
+                                         {"sliced-threads", "true"}};
+
+void set_tuning_param(const video_encoders_args_t& video_args,
+                      const video_encoders_str_args_t& video_str_args,
+                      Element* encoder,
+                      const char* property,
+                      const char* value) {
+  const std::string key = encoder->GetPluginName() + "." + property;
+  if (video_args.find(key) != video_args.end() || video_str_args.find(key) != video_str_args.end()) {
+    return;
+  }
+
+  GstElement* gelement = encoder->GetGstElement();
+  if (!g_object_class_find_property(G_OBJECT_GET_CLASS(gelement), property)) {
+    return;
+  }
+
+  DEBUG_LOG() << "Installing tuning parametr: " << key << " value: " << value;
+  gst_util_set_object_arg(G_OBJECT(gelement), property, value);  // enums and flags by nick
+}
+
+// legacy nvenc only, per gpu factories of nvcodec have read only device id
+void set_writable_cuda_device_id(Element* element, gint device_id) {
+  GParamSpec* pspec = g_object_class_find_property(G_OBJECT_GET_CLASS(element->GetGstElement()), "cuda-device-id");
+  if (!pspec || !(pspec->flags & G_PARAM_WRITABLE)) {
+    return;
+  }
+
+  element->SetProperty("cuda-device-id", device_id);
+}
+
+template <typename T>
+T* wrap_or_make(const std::string& name, GstElement* element) {
+  if (element) {
+    return new T(name, element);
+  }
+  return new T(name);
+}
+
 }  // namespace
 
 void ElementMFXH264Enc::SetIDRInterval(guint idr) {
   SetProperty("idr-interval", idr);
 }
 
+void ElementNvH264Enc::SetCudaDeviceId(gint device_id) {
+  set_writable_cuda_device_id(this, device_id);
+}
+
+void ElementNvH265Enc::SetCudaDeviceId(gint device_id) {
+  set_writable_cuda_device_id(this, device_id);
+}
+
+void ElementNvAV1Enc::SetCudaDeviceId(gint device_id) {
+  set_writable_cuda_device_id(this, device_id);
+}
+
+void set_cuda_device(gpu_device_t device, Element* element) {
+  if (!device || !element) {
+    return;
+  }
+
+  set_writable_cuda_device_id(element, *device);
+}
+
 Element* build_video_scale(int width, int height, ILinker* linker, Element* link_to, element_id_t video_scale_id) {
   video::ElementVideoScale* videoscale =
       new video::ElementVideoScale(common::MemSPrintf(VIDEO_SCALE_NAME_1U, video_scale_id));
@@ -119,6 +198,44 @@ Element* build_video_scale(int width, int height, ILinker* linker, Element* link
   return capsfilter;
 }
 
+Element* build_cuda_video_scale(int width,
+                                int height,
+                                gpu_device_t device,
+                                ILinker* linker,
+                                Element* link_to,
+                                element_id_t video_scale_id) {
+  video::ElementCudaScale* cudascale =
+      new video::ElementCudaScale(common::MemSPrintf(CUDA_SCALE_NAME_1U, video_scale_id));
+  set_cuda_device(device, cudascale);
+  ElementCapsFilter* capsfilter =
+      new ElementCapsFilter(common::MemSPrintf(CUDA_SCALE_CAPS_FILTER_NAME_1U, video_scale_id));
+  linker->ElementAdd(cudascale);
+  linker->ElementAdd(capsfilter);
+
+  GstCaps* cap_width_height =
+      gst_caps_new_simple("video/x-raw", "width", G_TYPE_INT, width, "height", G_TYPE_INT, height, nullptr);
+  gst_caps_set_features(cap_width_height, 0, gst_caps_features_new("memory:CUDAMemory", nullptr));
+  capsfilter->SetCaps(cap_width_height);
+  gst_caps_unref(cap_width_height);
+
+  linker->ElementLink(link_to, cudascale);
+  linker->ElementLink(cudascale, capsfilter);
+  return capsfilter;
+}
+
+elements_line_t build_cuda_video_convert(gpu_device_t device, ILinker* linker, element_id_t video_convert_id) {
+  video::ElementCudaUpload* upload =
+      new video::ElementCudaUpload(common::MemSPrintf(CUDA_UPLOAD_NAME_1U, video_convert_id));
+  video::ElementCudaConvert* convert =
+      new video::ElementCudaConvert(common::MemSPrintf(CUDA_CONVERT_NAME_1U, video_convert_id));
+  set_cuda_device(device, upload);
+  set_cuda_device(device, convert);
+  linker->ElementAdd(upload);
+  linker->ElementAdd(convert);
+  linker->ElementLink(upload, convert);
+  return {upload, convert};
+}
+
 Element* build_video_framerate(int framerate, ILinker* linker, Element* link_to, element_id_t video_framerate_id) {
   video::ElementVideoRate* videorate =
       new video::ElementVideoRate(common::MemSPrintf(VIDEO_RATE_NAME_1U, video_framerate_id));
@@ -180,37 +297,89 @@ ElementMsdkH264Enc* make_msdk_h264_encoder(element_id_t encoder_id) {
   return make_video_encoder<ElementMsdkH264Enc>(encoder_id);
 }
 
-Element* make_video_encoder(const std::string& codec, const std::string& name) {
+ElementNvAV1Enc* make_nv_av1_encoder(element_id_t encoder_id) {
+  return make_video_encoder<ElementNvAV1Enc>(encoder_id);
+}
+
+ElementQsvAV1Enc* make_qsv_av1_encoder(element_id_t encoder_id) {
+  return make_video_encoder<ElementQsvAV1Enc>(encoder_id);
+}
+
+ElementVaAV1Enc* make_va_av1_encoder(element_id_t encoder_id) {
+  return make_video_encoder<ElementVaAV1Enc>(encoder_id);
+}
+
+ElementSvtAV1Enc* make_svt_av1_encoder(element_id_t encoder_id) {
+  return make_video_encoder<ElementSvtAV1Enc>(encoder_id);
+}
+
+Element* make_video_encoder(const std::string& codec, const std::string& name, GstElement* element) {
   if (codec == ElementX264Enc::GetPluginName()) {
-    return new ElementX264Enc(name);
+    return wrap_or_make<ElementX264Enc>(name, element);
   } else if (codec == ElementX265Enc::GetPluginName()) {
-    ElementX265Enc* x265 = new ElementX265Enc(name);
+    ElementX265Enc* x265 = wrap_or_make<ElementX265Enc>(name, element);
     return x265;
   } else if (codec == ElementMPEG2Enc::GetPluginName()) {
-    return new ElementMPEG2Enc(name);
+    return wrap_or_make<ElementMPEG2Enc>(name, element);
   } else if (codec == ElementVAAPIH264Enc::GetPluginName()) {
-    return new ElementVAAPIH264Enc(name);
+    return wrap_or_make<ElementVAAPIH264Enc>(name, element);
   } else if (codec == ElementVAAPIMpeg2Enc::GetPluginName()) {
-    return new ElementVAAPIMpeg2Enc(name);
+    return wrap_or_make<ElementVAAPIMpeg2Enc>(name, element);
   } else if (codec == ElementMFXH264Enc::GetPluginName()) {
-    ElementMFXH264Enc* mfx = new ElementMFXH264Enc(name);
+    ElementMFXH264Enc* mfx = wrap_or_make<ElementMFXH264Enc>(name, element);
     return mfx;
   } else if (codec == ElementOpenH264Enc::GetPluginName()) {
-    return new ElementOpenH264Enc(name);
+    return wrap_or_make<ElementOpenH264Enc>(name, element);
   } else if (codec == ElementEAVCEnc::GetPluginName()) {
-    return new ElementEAVCEnc(name);
+    return wrap_or_make<ElementEAVCEnc>(name, element);
   } else if (codec == ElementNvH264Enc::GetPluginName()) {
-    return new ElementNvH264Enc(name);
+    return wrap_or_make<ElementNvH264Enc>(name, element);
   } else if (codec == ElementNvH265Enc::GetPluginName()) {
-    return new ElementNvH265Enc(name);
+    return wrap_or_make<ElementNvH265Enc>(name, element);
   } else if (codec == ElementMsdkH264Enc::GetPluginName()) {
-    return new ElementMsdkH264Enc(name);
+    return wrap_or_make<ElementMsdkH264Enc>(name, element);
+  } else if (codec == ElementNvAV1Enc::GetPluginName()) {
+    return wrap_or_make<ElementNvAV1Enc>(name, element);
+  } else if (codec == ElementQsvAV1Enc::GetPluginName()) {
+    return wrap_or_make<ElementQsvAV1Enc>(name, element);
+  } else if (codec == ElementVaAV1Enc::GetPluginName()) {
+    return wrap_or_make<ElementVaAV1Enc>(name, element);
+  } else if (codec == ElementSvtAV1Enc::GetPluginName()) {
+    return wrap_or_make<ElementSvtAV1Enc>(name, element);
   }
 
   NOTREACHED() << "Please register new video encoder type: " << codec;
   return nullptr;
 }
 
+bool is_hardware_video_encoder(const std::string& codec) {
+  return codec == ElementNvH264Enc::GetPluginName() || codec == ElementNvH265Enc::GetPluginName() ||
+         codec == ElementVAAPIH264Enc::GetPluginName() || codec == ElementVAAPIMpeg2Enc::GetPluginName() ||
+         codec == ElementMFXH264Enc::GetPluginName() || codec == ElementMsdkH264Enc::GetPluginName() ||
+         codec == ElementNvAV1Enc::GetPluginName() || codec == ElementQsvAV1Enc::GetPluginName() ||
+         codec == ElementVaAV1Enc::GetPluginName();
+}
+
+bool set_video_encoder_bitrate(Element* codec_element, int video_bitrate, bool playing) {
+  const char* property = "bitrate";
+  int bitrate = video_bitrate;
+  if (codec_element->GetPluginName() == ElementEAVCEnc::GetPluginName()) {
+    property = "bitrate-avg";
+    bitrate *= 1024;
+  } else if (codec_element->GetPluginName() == ElementOpenH264Enc::GetPluginName()) {
+    bitrate *= 1024;
+  } else if (codec_element->GetPluginName() == ElementSvtAV1Enc::GetPluginName()) {
+    property = "target-bitrate";
+  }
+
+  if (playing && !codec_element->IsPropertyMutablePlaying(property)) {
+    return false;
+  }
+
+  codec_element->SetProperty(property, bitrate);
+  return true;
+}
+
 elements_line_t build_video_convert(deinterlace_t deinterlace, ILinker* linker, element_id_t video_convert_id) {
   video::ElementVideoConvert* video_convert =
       new video::ElementVideoConvert(common::MemSPrintf(VIDEO_CONVERT_NAME_1U, video_convert_id));
@@ -235,32 +404,29 @@ elements_line_t build_video_encoder(const std::string& codec,
                                     const video_encoders_args_t& video_args,
                                     const video_encoders_str_args_t& video_str_args,
                                     ILinker* linker,
-                                    element_id_t encoder_id) {
-  Element* codec_element = make_video_encoder(codec, common::MemSPrintf(VIDEO_CODEC_NAME_1U, encoder_id));
+                                    element_id_t encoder_id,
+                                    GstElement* parked_encoder) {
+  Element* codec_element =
+      make_video_encoder(codec, common::MemSPrintf(VIDEO_CODEC_NAME_1U, encoder_id), parked_encoder);
   Element* const first = codec_element;
   linker->ElementAdd(codec_element);
 
   if (video_bitrate) {
-    if (codec_element->GetPluginName() == ElementEAVCEnc::GetPluginName()) {
-      codec_element->SetProperty("bitrate-avg", *video_bitrate * 1024);
-    } else {
-      int bitrate = *video_bitrate;
-      if (codec_element->GetPluginName() == ElementOpenH264Enc::GetPluginName()) {
-        bitrate *= 1024;
-      } else if (codec_element->GetPluginName() == ElementNvH264Enc::GetPluginName()) {
-        // bitrate *= 1024;
-        codec_element->SetProperty("rc-mode", 2);  // constant
-      } else if (codec_element->GetPluginName() == ElementNvH265Enc::GetPluginName()) {
-        // bitrate *= 1024;
-        codec_element->SetProperty("rc-mode", 1);  // constant
-      } else if (codec_element->GetPluginName() == ElementVAAPIH264Enc::GetPluginName()) {
-        codec_element->SetProperty("rate-control", 2);  // constant
-      } else if (codec_element->GetPluginName() == ElementMFXH264Enc::GetPluginName()) {
-        codec_element->SetProperty("rate-control", 1);  // constant
-      }
-
-      codec_element->SetProperty("bitrate", bitrate);
+    if (codec_element->GetPluginName() == ElementNvH264Enc::GetPluginName()) {
+      codec_element->SetProperty("rc-mode", 2);  // constant
+    } else if (codec_element->GetPluginName() == ElementNvH265Enc::GetPluginName()) {
+      codec_element->SetProperty("rc-mode", 1);  // constant
+    } else if (codec_element->GetPluginName() == ElementVAAPIH264Enc::GetPluginName()) {
+      codec_element->SetProperty("rate-control", 2);  // constant
+    } else if (codec_element->GetPluginName() == ElementMFXH264Enc::GetPluginName()) {
+      codec_element->SetProperty("rate-control", 1);  // constant
+    } else if (codec_element->GetPluginName() == ElementNvAV1Enc::GetPluginName()) {
+      gst_util_set_object_arg(G_OBJECT(codec_element->GetGstElement()), "rc-mode", "cbr");
+    } else if (codec_element->GetPluginName() == ElementQsvAV1Enc::GetPluginName() ||
+               codec_element->GetPluginName() == ElementVaAV1Enc::GetPluginName()) {
+      gst_util_set_object_arg(G_OBJECT(codec_element->GetGstElement()), "rate-control", "cbr");
     }
+    ignore_result(set_video_encoder_bitrate(codec_element, *video_bitrate, false));
   }
 
   // https://en.wikibooks.org/wiki/MeGUI/x264_Settings
@@ -269,12 +435,81 @@ elements_line_t build_video_encoder(const std::string& codec,
   return {first, last};
 }
 
+void setup_low_latency_encoder(const video_encoders_args_t& video_args,
+                               const video_encoders_str_args_t& video_str_args,
+                               Element* encoder) {
+  const std::string name = encoder->GetPluginName();
+  if (name == ElementX264Enc::GetPluginName() || name == ElementX265Enc::GetPluginName()) {
+    set_tuning_param(video_args, video_str_args, encoder, "tune", "zerolatency");
+  } else if (name == ElementNvH264Enc::GetPluginName() || name == ElementNvH265Enc::GetPluginName()) {
+    set_tuning_param(video_args, video_str_args, encoder, "preset", "low-latency-hq");
+  } else if (name == ElementNvAV1Enc::GetPluginName()) {
+    set_tuning_param(video_args, video_str_args, encoder, "tune", "ultra-low-latency");
+  } else if (name == ElementSvtAV1Enc::GetPluginName()) {
+    set_tuning_param(video_args, video_str_args, encoder, "preset", SVT_AV1_REALTIME_PRESET);
+  }
+
+  for (const TuningParam& param : kLowLatencyParams) {
+    set_tuning_param(video_args, video_str_args, encoder, param.property, param.value);
+  }
+}
+
+void setup_offline_encoder(const video_encoders_args_t& video_args,
+                           const video_encoders_str_args_t& video_str_args,
+                           unsigned int threads,
+                           Element* encoder) {
+  const std::string name = encoder->GetPluginName();
+  if (name == ElementX264Enc::GetPluginName()) {
+    set_tuning_param(video_args, video_str_args, encoder, "speed-preset", "slow");
+    set_tuning_param(video_args, video_str_args, encoder, "rc-lookahead", OFFLINE_X264_RC_LOOKAHEAD);
+    set_tuning_param(video_args, video_str_args, encoder, "mb-tree", "true");
+    if (threads) {
+      set_tuning_param(video_args, video_str_args, encoder, "threads", std::to_string(threads).c_str());
+    }
+  } else if (name == ElementX265Enc::GetPluginName()) {
+    set_tuning_param(video_args, video_str_args, encoder, "speed-preset", "slow");
+  } else if (name == ElementNvH264Enc::GetPluginName() || name == ElementNvH265Enc::GetPluginName()) {
+    set_tuning_param(video_args, video_str_args, encoder, "preset", "hq");
+    set_tuning_param(video_args, video_str_args, encoder, "rc-lookahead", OFFLINE_NV_RC_LOOKAHEAD);
+  } else if (name == ElementNvAV1Enc::GetPluginName()) {
+    set_tuning_param(video_args, video_str_args, encoder, "preset", "p6");
+    set_tuning_param(video_args, video_str_args, encoder, "rc-lookahead", OFFLINE_NV_RC_LOOKAHEAD);
+  } else if (name == ElementSvtAV1Enc::GetPluginName()) {
+    set_tuning_param(video_args, video_str_args, encoder, "preset", SVT_AV1_OFFLINE_PRESET);
+  }
+}
+
+const char* get_encoder_keyframe_interval_property(const std::string& encoder) {
+  if (encoder == ElementX264Enc::GetPluginName() || encoder == ElementX265Enc::GetPluginName() ||
+      encoder == ElementVaAV1Enc::GetPluginName()) {
+    return "key-int-max";
+  } else if (encoder == ElementNvH264Enc::GetPluginName() || encoder == ElementNvH265Enc::GetPluginName() ||
+             encoder == ElementMFXH264Enc::GetPluginName() || encoder == ElementOpenH264Enc::GetPluginName() ||
+             encoder == ElementMsdkH264Enc::GetPluginName() || encoder == ElementNvAV1Enc::GetPluginName() ||
+             encoder == ElementQsvAV1Enc::GetPluginName()) {
+    return "gop-size";
+  } else if (encoder == ElementVAAPIH264Enc::GetPluginName()) {
+    return "keyframe-period";
+  } else if (encoder == ElementEAVCEnc::GetPluginName()) {
+    return "gop-max-length";
+  } else if (encoder == ElementSvtAV1Enc::GetPluginName()) {
+    return "intra-period-length";
+  }
+
+  return nullptr;
+}
+
 bool IsH264Encoder(const std::string& encoder) {
   return encoder == ElementX264Enc::GetPluginName() || encoder == ElementVAAPIH264Enc::GetPluginName() ||
          encoder == ElementOpenH264Enc::GetPluginName() || encoder == ElementNvH264Enc::GetPluginName() ||
          encoder == ElementMFXH264Enc::GetPluginName();
 }
 
+bool IsAV1Encoder(const std::string& encoder) {
+  return encoder == ElementNvAV1Enc::GetPluginName() || encoder == ElementQsvAV1Enc::GetPluginName() ||
+         encoder == ElementVaAV1Enc::GetPluginName() || encoder == ElementSvtAV1Enc::GetPluginName();
+}
+
 }  // namespace encoders
 }  // namespace elements
 }  // namespace stream
@@ -43,12 +43,14 @@ class ElementNvH264Enc : public ElementEx<ELEMENT_NV_H264_ENC> {
  public:
   typedef ElementEx<ELEMENT_NV_H264_ENC> base_class;
   using base_class::base_class;
+  void SetCudaDeviceId(gint device_id = -1);  // Range: -1 - 2147483647 Default: -1, automatic
 };
 
 class ElementNvH265Enc : public ElementEx<ELEMENT_NV_H265_ENC> {
  public:
   typedef ElementEx<ELEMENT_NV_H265_ENC> base_class;
   using base_class::base_class;
+  void SetCudaDeviceId(gint device_id = -1);  // Range: -1 - 2147483647 Default: -1, automatic
 };
 
 class ElementX264Enc : public ElementEx<ELEMENT_X264_ENC> {
@@ -100,7 +102,43 @@ class ElementMFXH264Enc : public ElementEx<ELEMENT_MFX_H264_ENC> {
   void SetIDRInterval(guint idr = 0);  // Range: 0 - 2147483647 Default: 0
 };
 
+class ElementNvAV1Enc : public ElementEx<ELEMENT_NV_AV1_ENC> {
+ public:
+  typedef ElementEx<ELEMENT_NV_AV1_ENC> base_class;
+  using base_class::base_class;
+  void SetCudaDeviceId(gint device_id = -1);  // Range: -1 - 2147483647 Default: -1, automatic
+};
+
+class ElementQsvAV1Enc : public ElementEx<ELEMENT_QSV_AV1_ENC> {
+ public:
+  typedef ElementEx<ELEMENT_QSV_AV1_ENC> base_class;
+  using base_class::base_class;
+};
+
+class ElementVaAV1Enc : public ElementEx<ELEMENT_VA_AV1_ENC> {
+ public:
+  typedef ElementEx<ELEMENT_VA_AV1_ENC> base_class;
+  using base_class::base_class;
+};
+
+class ElementSvtAV1Enc : public ElementEx<ELEMENT_SVT_AV1_ENC> {
+ public:
+  typedef ElementEx<ELEMENT_SVT_AV1_ENC> base_class;
+  using base_class::base_class;
+};
+
 Element* build_video_scale(int width, int height, ILinker* linker, Element* link_to, element_id_t video_scale_id);
+// frames stay in memory:CUDAMemory
+Element* build_cuda_video_scale(int width,
+                                int height,
+                                gpu_device_t device,
+                                ILinker* linker,
+                                Element* link_to,
+                                element_id_t video_scale_id);
+// upload => convert
+elements_line_t build_cuda_video_convert(gpu_device_t device, ILinker* linker, element_id_t video_convert_id);
+// noop if element have not writable cuda-device-id property
+void set_cuda_device(gpu_device_t device, Element* element);
 Element* build_video_framerate(int framerate, ILinker* linker, Element* link_to, element_id_t video_framerate_id);
 
 template <typename T>
@@ -119,19 +157,47 @@ ElementMFXH264Enc* make_mfx_h264_encoder(element_id_t encoder_id);
 ElementNvH264Enc* make_nv_h264_encoder(element_id_t encoder_id);
 ElementNvH265Enc* make_nv_h265_encoder(element_id_t encoder_id);
 ElementMsdkH264Enc* make_msdk_h264_encoder(element_id_t encoder_id);
+ElementNvAV1Enc* make_nv_av1_encoder(element_id_t encoder_id);
+ElementQsvAV1Enc* make_qsv_av1_encoder(element_id_t encoder_id);
+ElementVaAV1Enc* make_va_av1_encoder(element_id_t encoder_id);
+ElementSvtAV1Enc* make_svt_av1_encoder(element_id_t encoder_id);
 
-Element* make_video_encoder(const std::string& codec, const std::string& name);
+Element* make_video_encoder(const std::string& codec,
+                            const std::string& name,
+                            GstElement* element = nullptr);  // wraps element if not null
+
+bool is_hardware_video_encoder(const std::string& codec);  // opens device session, worth keeping between starts
 
 elements_line_t build_video_convert(deinterlace_t deinterlace, ILinker* linker, element_id_t video_convert_id);
 
+// bitrate in config units, false if encoder can't change it in running pipeline
+bool set_video_encoder_bitrate(Element* codec_element, int video_bitrate, bool playing) WARN_UNUSED_RESULT;
+
 elements_line_t build_video_encoder(const std::string& codec,
                                     bit_rate_t video_bitrate,
                                     const video_encoders_args_t& video_args,
                                     const video_encoders_str_args_t& video_str_args,
                                     ILinker* linker,
-                                    element_id_t encoder_id);
+                                    element_id_t encoder_id,
+                                    GstElement* parked_encoder = nullptr);  // reused instead of allocating
+
+// zero latency tuning without lookahead and b-frames, properties set in args by user are kept
+void setup_low_latency_encoder(const video_encoders_args_t& video_args,
+                               const video_encoders_str_args_t& video_str_args,
+                               Element* encoder);
+
+// slower presets and deep lookahead for files encoded faster than realtime, threads 0 - encoder default,
+// properties set in args by user are kept
+void setup_offline_encoder(const video_encoders_args_t& video_args,
+                           const video_encoders_str_args_t& video_str_args,
+                           unsigned int threads,
+                           Element* encoder);
+
+// property limiting distance between keyframes in frames, nullptr if encoder has no such
+const char* get_encoder_keyframe_interval_property(const std::string& encoder);
 
 bool IsH264Encoder(const std::string& encoder);
+bool IsAV1Encoder(const std::string& encoder);  // muxed only into mp4 fragments
 
 }  // namespace encoders
 }  // namespace elements
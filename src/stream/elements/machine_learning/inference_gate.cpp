@@ -0,0 +1,176 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/machine_learning/inference_gate.h"
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include "stream/pad/pad.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace machine_learning {
+
+namespace {
+
+class InferenceGate {
+ public:
+  InferenceGate(int interval, double rate) : schedule_(interval, rate), last_(nullptr), refs_(0) {}
+  ~InferenceGate() {
+    if (last_) {
+      gst_buffer_unref(last_);
+    }
+  }
+
+  void Link(GstPad* pad, GstPadProbeCallback cb) {
+    refs_++;
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, cb, this, &InferenceGate::unref);
+  }
+
+  static GstPadProbeReturn gate_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+    UNUSED(pad);
+    UNUSED(info);
+    InferenceGate* gate = static_cast<InferenceGate*>(user_data);
+    std::lock_guard<std::mutex> lock(gate->mutex_);
+    return gate->schedule_.IsDue(g_get_monotonic_time()) ? GST_PAD_PROBE_OK : GST_PAD_PROBE_DROP;
+  }
+
+  static GstPadProbeReturn result_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+    UNUSED(pad);
+    InferenceGate* gate = static_cast<InferenceGate*>(user_data);
+    GstBuffer* buffer = gst_pad_probe_info_get_buffer(info);
+    std::lock_guard<std::mutex> lock(gate->mutex_);
+    gate->schedule_.SetDone(g_get_monotonic_time());
+    if (gate->last_) {
+      gst_buffer_unref(gate->last_);
+    }
+    gate->last_ = gst_buffer_ref(buffer);
+    return GST_PAD_PROBE_OK;
+  }
+
+  static GstPadProbeReturn main_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+    UNUSED(pad);
+    InferenceGate* gate = static_cast<InferenceGate*>(user_data);
+    GstBuffer* last = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(gate->mutex_);
+      if (gate->last_) {
+        last = gst_buffer_ref(gate->last_);
+      }
+    }
+    if (!last) {
+      return GST_PAD_PROBE_OK;
+    }
+
+    GstBuffer* buffer = gst_buffer_make_writable(gst_pad_probe_info_get_buffer(info));
+    GST_PAD_PROBE_INFO_DATA(info) = buffer;
+    gst_buffer_foreach_meta(last, copy_detection_meta, buffer);
+    gst_buffer_unref(last);
+    return GST_PAD_PROBE_OK;
+  }
+
+ private:
+  // detections only, memory layout metas describe source buffer
+  static gboolean copy_detection_meta(GstBuffer* src, GstMeta** meta, gpointer user_data) {
+    GstBuffer* dest = static_cast<GstBuffer*>(user_data);
+    const GstMetaInfo* info = (*meta)->info;
+    if (!info->transform_func || info->api == GST_VIDEO_META_API_TYPE ||
+        gst_meta_api_type_has_tag(info->api, g_quark_from_static_string(GST_META_TAG_MEMORY_STR)) ||
+        gst_buffer_get_meta(dest, info->api)) {
+      return TRUE;
+    }
+
+    GstMetaTransformCopy copy = {FALSE, 0, static_cast<gsize>(-1)};
+    info->transform_func(dest, *meta, src, _gst_meta_transform_copy, &copy);
+    return TRUE;
+  }
+
+  static void unref(gpointer user_data) {
+    InferenceGate* gate = static_cast<InferenceGate*>(user_data);
+    if (--gate->refs_ == 0) {
+      delete gate;
+    }
+  }
+
+  std::mutex mutex_;
+  InferenceSchedule schedule_;
+  GstBuffer* last_;  // last inferred frame with detections
+  std::atomic<int> refs_;
+
+  DISALLOW_COPY_AND_ASSIGN(InferenceGate);
+};
+
+}  // namespace
+
+InferenceSchedule::InferenceSchedule(int interval, double rate)
+    : interval_(std::max(interval, 1)),
+      rate_interval_usec_(rate > 0 ? static_cast<gint64>(G_USEC_PER_SEC / rate) : 0),
+      frames_(0),
+      last_start_usec_(0),
+      latency_usec_(0) {}
+
+bool InferenceSchedule::IsDue(gint64 now_usec) {
+  frames_++;
+  if (frames_ < interval_) {
+    return false;
+  }
+
+  if (rate_interval_usec_ && last_start_usec_) {
+    const gint64 min_interval = std::max(rate_interval_usec_, latency_usec_);
+    if (now_usec - last_start_usec_ < min_interval) {
+      return false;
+    }
+  }
+
+  frames_ = 0;
+  last_start_usec_ = now_usec;
+  return true;
+}
+
+void InferenceSchedule::SetDone(gint64 now_usec) {
+  if (!last_start_usec_) {
+    return;
+  }
+
+  const gint64 latency = now_usec - last_start_usec_;
+  latency_usec_ = latency_usec_ ? (latency_usec_ * 7 + latency) / 8 : latency;
+}
+
+gint64 InferenceSchedule::GetLatency() const {
+  return latency_usec_;
+}
+
+void attach_inference_gate(Element* infer_queue, Element* infer_sink, Element* main_queue, int interval, double rate) {
+  InferenceGate* gate = new InferenceGate(interval, rate);
+  pad::Pad* gate_pad = infer_queue->StaticPad("src");
+  pad::Pad* result_pad = infer_sink->StaticPad("sink");
+  pad::Pad* main_pad = main_queue->StaticPad("src");
+  gate->Link(gate_pad->GetGstPad(), InferenceGate::gate_probe);
+  gate->Link(result_pad->GetGstPad(), InferenceGate::result_probe);
+  gate->Link(main_pad->GetGstPad(), InferenceGate::main_probe);
+  delete main_pad;
+  delete result_pad;
+  delete gate_pad;
+}
+
+}  // namespace machine_learning
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
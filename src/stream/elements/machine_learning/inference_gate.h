@@ -0,0 +1,52 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <glib.h>
+
+#include "stream/elements/element.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace machine_learning {
+
+// picks frames for inference every Nth frame and not above target rate,
+// rate interval stretched to measured inference latency
+class InferenceSchedule {
+ public:
+  InferenceSchedule(int interval, double rate);
+
+  bool IsDue(gint64 now_usec);  // counts frame
+  void SetDone(gint64 now_usec);
+
+  gint64 GetLatency() const;  // usec, smoothed
+
+ private:
+  const int interval_;
+  const gint64 rate_interval_usec_;
+  int frames_;
+  gint64 last_start_usec_;
+  gint64 latency_usec_;
+};
+
+// inference branch of ml tee: infer_queue (leaky, 1 buffer) => ml filter => fakesink,
+// detections of last inference copied onto frames leaving main_queue; lives while probes are linked
+void attach_inference_gate(Element* infer_queue, Element* infer_sink, Element* main_queue, int interval, double rate);
+
+}  // namespace machine_learning
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,145 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/machine_learning/inference_sink.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include <gst/app/gstappsink.h>  // for GST_APP_SINK
+
+#include "stream/elements/machine_learning/inference_gate.h"
+
+#define INFERENCE_CLIENT_DATA "inference-client"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace machine_learning {
+
+namespace {
+
+class InferenceClient {
+ public:
+  InferenceClient(fastocloud::machine_learning::InferenceShm* shm, uint64_t client, int interval, double rate)
+      : shm_(shm), client_(client), schedule_(interval, rate), cb_(nullptr), user_data_(nullptr) {}
+  ~InferenceClient() {
+    fastocloud::machine_learning::ReleaseInferenceSlots(shm_, client_);
+    ignore_result(fastocloud::machine_learning::CloseInferenceShm(shm_));
+  }
+
+  void SetResultsCallback(ElementInferenceSink::results_callback_t cb, gpointer user_data) {
+    cb_ = cb;
+    user_data_ = user_data;
+  }
+
+  void Push(const uint8_t* frame, size_t size) {
+    const gint64 now = g_get_monotonic_time();
+    ElementInferenceSink::boxes_t boxes;
+    while (fastocloud::machine_learning::TakeInferenceResult(shm_, client_, &boxes)) {
+      schedule_.SetDone(now);
+      if (cb_) {
+        cb_(boxes, user_data_);
+      }
+    }
+
+    if (schedule_.IsDue(now)) {
+      ignore_result(fastocloud::machine_learning::SubmitInferenceFrame(shm_, client_, frame, size));
+    }
+  }
+
+ private:
+  fastocloud::machine_learning::InferenceShm* const shm_;
+  const uint64_t client_;
+  InferenceSchedule schedule_;
+  ElementInferenceSink::results_callback_t cb_;
+  gpointer user_data_;
+
+  DISALLOW_COPY_AND_ASSIGN(InferenceClient);
+};
+
+GstFlowReturn inference_new_sample(GstAppSink* appsink, gpointer user_data) {
+  InferenceClient* client = static_cast<InferenceClient*>(user_data);
+  GstSample* sample = gst_app_sink_pull_sample(appsink);
+  if (!sample) {
+    return GST_FLOW_EOS;
+  }
+
+  GstBuffer* buffer = gst_sample_get_buffer(sample);
+  GstMapInfo map;
+  if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    // rows of 416 RGB pixels are 4 byte aligned, frame is tightly packed
+    client->Push(map.data, map.size);
+    gst_buffer_unmap(buffer, &map);
+  }
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
+
+void inference_destroy(gpointer user_data) {
+  delete static_cast<InferenceClient*>(user_data);
+}
+
+}  // namespace
+
+bool ElementInferenceSink::SetInference(const std::string& shm_name, element_id_t video_id, int interval, double rate) {
+  fastocloud::machine_learning::InferenceShm* shm = nullptr;
+  common::ErrnoError err = fastocloud::machine_learning::OpenInferenceShm(shm_name, &shm);
+  if (err) {
+    WARNING_LOG() << "Failed to open inference segment " << shm_name << ", error: " << err->GetDescription();
+    return false;
+  }
+
+  // streams of node told apart by pid, video branches of stream by id
+  const uint64_t client_id = (static_cast<uint64_t>(getpid()) << 16) | (video_id & 0xFFFF);
+  InferenceClient* client = new InferenceClient(shm, client_id, interval, rate);
+  GstAppSinkCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(callbacks));
+  callbacks.new_sample = inference_new_sample;
+  // client lives as long as gst element, element wrappers are deleted before pipeline stops
+  GstElement* element = GetGstElement();
+  g_object_set_data_full(G_OBJECT(element), INFERENCE_CLIENT_DATA, client, inference_destroy);
+  gst_app_sink_set_callbacks(GST_APP_SINK(element), &callbacks, client, nullptr);
+  return true;
+}
+
+void ElementInferenceSink::SetResultsCallback(results_callback_t cb, gpointer user_data) {
+  InferenceClient* client =
+      static_cast<InferenceClient*>(g_object_get_data(G_OBJECT(GetGstElement()), INFERENCE_CLIENT_DATA));
+  if (client) {
+    client->SetResultsCallback(cb, user_data);
+  }
+}
+
+std::vector<fastotv::commands_info::ml::ImageBox> make_image_boxes(const ElementInferenceSink::boxes_t& boxes) {
+  std::vector<fastotv::commands_info::ml::ImageBox> images;
+  for (const auto& box : boxes) {
+    fastotv::commands_info::ml::ImageBox image;
+    image.label = box.label;
+    image.prob = box.prob;
+    image.x = box.x;
+    image.y = box.y;
+    image.width = box.width;
+    image.height = box.height;
+    images.push_back(image);
+  }
+  return images;
+}
+
+}  // namespace machine_learning
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,50 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <fastotv/commands_info/ml/types.h>
+
+#include "base/machine_learning/inference_shm.h"
+
+#include "stream/elements/sink/sink.h"  // for ElementBaseSink
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace machine_learning {
+
+// appsink of shared inference branch, RGB frames of worker input size copied into daemon segment,
+// answers of earlier frames handed to callback from streaming thread
+class ElementInferenceSink : public sink::ElementBaseSink<ELEMENT_APP_SINK> {
+ public:
+  typedef sink::ElementBaseSink<ELEMENT_APP_SINK> base_class;
+  typedef std::vector<fastocloud::machine_learning::InferenceBoxShm> boxes_t;
+  typedef void (*results_callback_t)(const boxes_t& boxes, gpointer user_data);
+  using base_class::base_class;
+
+  // segment opened for lifetime of gst element, frames skipped by interval and rate as in-process inference
+  bool SetInference(const std::string& shm_name, element_id_t video_id, int interval, double rate);
+  void SetResultsCallback(results_callback_t cb, gpointer user_data);
+};
+
+std::vector<fastotv::commands_info::ml::ImageBox> make_image_boxes(const ElementInferenceSink::boxes_t& boxes);
+
+}  // namespace machine_learning
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
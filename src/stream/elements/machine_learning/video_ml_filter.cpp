@@ -14,6 +14,13 @@
 
 #include "stream/elements/machine_learning/video_ml_filter.h"
 
+#include <common/logger.h>
+
+#include <fastoml/gst/gstbackend.h>
+#include <fastoml/gst/gstmlmeta.h>
+
+#include "stream/gstreamer_utils.h"
+
 namespace fastocloud {
 namespace stream {
 namespace elements {
@@ -27,6 +34,50 @@ gboolean ElementVideoMLFilter::RegisterNewPredictionCallback(new_prediction_call
   return RegisterCallback("new-prediction", G_CALLBACK(cb), user_data);
 }
 
+GstBackend* make_backend(const fastocloud::machine_learning::DeepLearning& learning,
+                         fastoml::SupportedBackends* chosen) {
+  for (const auto& candidate : learning.GetBackendModels()) {
+    GstBackend* backend = gst_backend_new(candidate.backend);
+    if (!backend) {
+      INFO_LOG() << "ML backend " << candidate.backend << " not available, next one tried";
+      continue;
+    }
+
+    const std::string model_path_str = candidate.model_path.GetPath();
+    GValue model = make_gvalue(model_path_str);
+    g_object_set_property(G_OBJECT(backend), "model", &model);
+    g_value_unset(&model);
+    for (auto prop : candidate.properties) {
+      GValue value = make_gvalue(prop.value);
+      g_object_set_property(G_OBJECT(backend), prop.property.c_str(), &value);
+      g_value_unset(&value);
+    }
+    INFO_LOG() << "ML backend " << candidate.backend << " with model " << model_path_str;
+    if (chosen) {
+      *chosen = candidate.backend;
+    }
+    return backend;
+  }
+  return nullptr;
+}
+
+std::vector<fastotv::commands_info::ml::ImageBox> make_image_boxes(gpointer detection_meta) {
+  std::vector<fastotv::commands_info::ml::ImageBox> images;
+  GstDetectionMeta* meta = static_cast<GstDetectionMeta*>(detection_meta);
+  for (int i = 0; i < meta->num_boxes; ++i) {
+    BBox* box = (meta->boxes) + i;
+    fastotv::commands_info::ml::ImageBox image;
+    image.label = box->label;
+    image.prob = box->prob;
+    image.x = box->x;
+    image.y = box->y;
+    image.width = box->width;
+    image.height = box->height;
+    images.push_back(image);
+  }
+  return images;
+}
+
 }  // namespace machine_learning
 }  // namespace elements
 }  // namespace stream
@@ -20,6 +20,10 @@
 
 #include <common/sprintf.h>
 
+#include <fastotv/commands_info/ml/types.h>
+
+#include "base/machine_learning/deep_learning.h"
+
 #include "stream/elements/element.h"
 
 typedef struct _GstBackend GstBackend;
@@ -40,6 +44,14 @@ class ElementVideoMLFilter : public Element {
   gboolean RegisterNewPredictionCallback(new_prediction_callback_t cb, gpointer user_data) WARN_UNUSED_RESULT;
 };
 
+// first backend of config available on node with its model and properties loaded on start, chosen one stored if
+// set, nullptr if none available
+GstBackend* make_backend(const fastocloud::machine_learning::DeepLearning& learning,
+                         fastoml::SupportedBackends* chosen = nullptr);
+
+// boxes of detection meta handed to prediction callback
+std::vector<fastotv::commands_info::ml::ImageBox> make_image_boxes(gpointer detection_meta);
+
 }  // namespace machine_learning
 }  // namespace elements
 }  // namespace stream
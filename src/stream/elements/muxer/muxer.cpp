@@ -14,6 +14,8 @@
 
 #include "stream/elements/muxer/muxer.h"
 
+#include "base/cmaf_manifest.h"
+
 namespace fastocloud {
 namespace stream {
 namespace elements {
@@ -29,11 +31,18 @@ ElementMPEGTSMux* make_mpegtsmux(element_id_t muxer_id) {
   return make_muxer<ElementMPEGTSMux>(muxer_id);
 }
 
+ElementMP4Mux* make_cmaf_mux(guint fragment_msec, element_id_t muxer_id) {
+  ElementMP4Mux* mp4mux = make_muxer<ElementMP4Mux>(muxer_id);
+  mp4mux->SetFragmentDuration(fragment_msec);
+  mp4mux->SetStreamable(true);
+  return mp4mux;
+}
+
 ElementRTPMux* make_rtpmux(element_id_t muxer_id) {
   return make_muxer<ElementRTPMux>(muxer_id);
 }
 
-Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id) {
+Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id, bool cmaf) {
   if (scheme == common::uri::Url::rtmp) {
     return make_flvmux(true, muxer_id);
   } else if (scheme == common::uri::Url::udp) {
@@ -41,6 +50,9 @@ Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id) {
   } else if (scheme == common::uri::Url::tcp) {
     return make_mpegtsmux(muxer_id);
   } else if (scheme == common::uri::Url::http) {
+    if (cmaf) {
+      return make_cmaf_mux(CMAF_SEGMENT_MSEC, muxer_id);
+    }
     return make_mpegtsmux(muxer_id);
   } else if (scheme == common::uri::Url::srt) {
     return make_mpegtsmux(muxer_id);
@@ -54,6 +66,14 @@ void ElementFLVMux::SetStreamable(bool streamable) {
   SetProperty("streamable", streamable);
 }
 
+void ElementMP4Mux::SetFragmentDuration(guint duration_msec) {
+  SetProperty("fragment-duration", duration_msec);
+}
+
+void ElementMP4Mux::SetStreamable(bool streamable) {
+  SetProperty("streamable", streamable);
+}
+
 }  // namespace muxer
 }  // namespace elements
 }  // namespace stream
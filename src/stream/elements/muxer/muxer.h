@@ -41,6 +41,15 @@ class ElementFLVMux : public ElementEx<ELEMENT_FLV_MUX> {
   void SetStreamable(bool streamable = false);  // Default: false
 };
 
+class ElementMP4Mux : public ElementEx<ELEMENT_MP4_MUX> {
+ public:
+  typedef ElementEx<ELEMENT_MP4_MUX> base_class;
+  using base_class::base_class;
+
+  void SetFragmentDuration(guint duration_msec);  // Default: 0, not fragmented
+  void SetStreamable(bool streamable = false);     // Default: false
+};
+
 template <typename T>
 T* make_muxer(element_id_t muxer_id) {
   return make_element<T>(common::MemSPrintf(MUXER_NAME_1U, muxer_id));
@@ -49,8 +58,10 @@ T* make_muxer(element_id_t muxer_id) {
 ElementFLVMux* make_flvmux(bool streamable, element_id_t muxer_id);
 ElementRTPMux* make_rtpmux(element_id_t muxer_id);
 ElementMPEGTSMux* make_mpegtsmux(element_id_t muxer_id);
+ElementMP4Mux* make_cmaf_mux(guint fragment_msec, element_id_t muxer_id);  // fragmented, never seeks back
 
-Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id);
+// http outputs muxed as fmp4 if cmaf
+Element* make_muxer(common::uri::Url::scheme scheme, element_id_t muxer_id, bool cmaf = false);
 
 }  // namespace muxer
 }  // namespace elements
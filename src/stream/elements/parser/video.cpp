@@ -50,11 +50,17 @@ ElementH265Parse* make_h265_parser(element_id_t parser_id) {
   return make_video_parser<ElementH265Parse>(parser_id);
 }
 
+ElementAV1Parse* make_av1_parser(element_id_t parser_id) {
+  return make_video_parser<ElementAV1Parse>(parser_id);
+}
+
 Element* make_video_parser(const std::string& parser, const std::string& name) {
   if (parser == ElementH264Parse::GetPluginName()) {
     return new ElementH264Parse(name);
   } else if (parser == ElementH265Parse::GetPluginName()) {
     return new ElementH265Parse(name);
+  } else if (parser == ElementAV1Parse::GetPluginName()) {
+    return new ElementAV1Parse(name);
   } else if (parser == ElementMpegParse::GetPluginName()) {
     return new ElementMpegParse(name);
   } else if (parser == ElementTsParse::GetPluginName()) {
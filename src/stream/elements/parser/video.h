@@ -44,6 +44,12 @@ class ElementH265Parse : public ElementBaseParse<ELEMENT_H265_PARSE> {
   void SetConfigInterval(guint interval = 0);  // Range: 0 - 3600 Default: 0
 };
 
+class ElementAV1Parse : public ElementBaseParse<ELEMENT_AV1_PARSE> {
+ public:
+  typedef ElementBaseParse<ELEMENT_AV1_PARSE> base_class;
+  using base_class::base_class;
+};
+
 class ElementMpegParse : public ElementBaseParse<ELEMENT_MPEG_VIDEO_PARSE> {
  public:
   typedef ElementBaseParse<ELEMENT_MPEG_VIDEO_PARSE> base_class;
@@ -65,6 +71,7 @@ ElementMpegParse* make_mpeg2_parser(element_id_t parser_id);
 ElementTsParse* make_ts_parser(element_id_t parser_id);
 ElementH264Parse* make_h264_parser(element_id_t parser_id);
 ElementH265Parse* make_h265_parser(element_id_t parser_id);
+ElementAV1Parse* make_av1_parser(element_id_t parser_id);
 
 Element* make_video_parser(const std::string& parser, const std::string& name);
 
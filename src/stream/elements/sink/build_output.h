@@ -18,7 +18,12 @@
 
 #include "stream/stypes.h"
 
+#if defined(AMAZON_KINESIS)
+#include "base/amazon_kinesis/amazon_kinesis.h"
+#endif
 #include "base/output_uri.h"
+#include "base/socket_tuning.h"
+#include "base/tcp_tuning.h"
 
 namespace fastocloud {
 namespace stream {
@@ -27,7 +32,21 @@ class Element;
 
 namespace sink {
 
-Element* build_output(const OutputUri& output, element_id_t sink_id, bool is_vod);
+// socket tuning overrides stream wide udp settings, live http outputs split into ll-hls parts if part msec set,
+// cmaf http outputs expect fragmented mp4, tcp tuning limits client queues of tcp server outputs
+Element* build_output(const OutputUri& output,
+                      element_id_t sink_id,
+                      bool is_vod,
+                      const UdpEgress& udp = UdpEgress(),
+                      const SocketTuning& socket = SocketTuning(),
+                      fastotv::timestamp_t ll_hls_part_msec = 0,
+                      bool cmaf = false,
+                      const TcpTuning& tcp = TcpTuning());
+
+#if defined(AMAZON_KINESIS)
+// kvs url outputs, sink linked to parsed streams without muxer
+Element* build_kvs_output(const common::Optional<amazon_kinesis::AmazonKinesis>& kinesis, element_id_t sink_id);
+#endif
 
 }  // namespace sink
 }  // namespace elements
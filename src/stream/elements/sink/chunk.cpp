@@ -0,0 +1,150 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sink/chunk.h"
+
+#include <string.h>
+
+#include <mutex>
+#include <string>
+
+#include <gst/app/gstappsink.h>  // for GST_APP_SINK
+
+#include "stream/chunk_writer.h"
+
+#define CHUNK_WRITER_DATA "chunk-writer"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+namespace {
+
+class ChunkSinkWriter {
+ public:
+  explicit ChunkSinkWriter(bool direct_io)
+      : writer_(direct_io), location_(), append_(false), start_(0), last_size_(0), mutex_() {}
+
+  void SetLocation(const std::string& path, bool append) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    location_ = path;
+    append_ = append;
+  }
+
+  bool Push(const uint8_t* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!location_.empty()) {
+      // chunks of equal duration, previous size with margin avoids extending on each write
+      const uint64_t preallocate = last_size_ + last_size_ / 8;
+      const bool opened = append_ ? writer_.Append(location_, preallocate) : writer_.Open(location_, preallocate);
+      if (!opened) {
+        WARNING_LOG() << "Can't open chunk: " << location_;
+      }
+      start_ = writer_.GetWritten();
+      location_.clear();
+    }
+    return writer_.Write(data, size);
+  }
+
+  void Finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!writer_.IsOpen()) {
+      return;
+    }
+
+    last_size_ = writer_.GetWritten() - start_;
+    if (!writer_.Close()) {
+      WARNING_LOG() << "Can't close chunk, written: " << last_size_;
+    }
+  }
+
+ private:
+  ChunkWriter writer_;
+  std::string location_;  // next fragment, opened on first data
+  bool append_;
+  uint64_t start_;  // size of file before fragment
+  uint64_t last_size_;
+  std::mutex mutex_;
+};
+
+GstFlowReturn chunk_new_sample(GstAppSink* appsink, gpointer user_data) {
+  ChunkSinkWriter* writer = static_cast<ChunkSinkWriter*>(user_data);
+  GstSample* sample = gst_app_sink_pull_sample(appsink);
+  if (!sample) {
+    return GST_FLOW_EOS;
+  }
+
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer* buffer = gst_sample_get_buffer(sample);
+  GstMapInfo map;
+  if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    if (!writer->Push(map.data, map.size)) {
+      ret = GST_FLOW_ERROR;
+    }
+    gst_buffer_unmap(buffer, &map);
+  }
+  gst_sample_unref(sample);
+  return ret;
+}
+
+void chunk_eos(GstAppSink* appsink, gpointer user_data) {
+  UNUSED(appsink);
+  static_cast<ChunkSinkWriter*>(user_data)->Finish();
+}
+
+void chunk_destroy(gpointer user_data) {
+  delete static_cast<ChunkSinkWriter*>(user_data);
+}
+
+}  // namespace
+
+void ElementChunkSink::SetWriter(bool direct_io) {
+  GstAppSinkCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(callbacks));
+  callbacks.eos = chunk_eos;
+  callbacks.new_sample = chunk_new_sample;
+  // writer lives as long as gst element, element wrappers are deleted before pipeline stops
+  ChunkSinkWriter* writer = new ChunkSinkWriter(direct_io);
+  GstElement* element = GetGstElement();
+  g_object_set_data_full(G_OBJECT(element), CHUNK_WRITER_DATA, writer, chunk_destroy);
+  gst_app_sink_set_callbacks(GST_APP_SINK(element), &callbacks, writer, nullptr);
+}
+
+ElementChunkSink* make_chunk_sink(element_id_t sink_id, bool direct_io) {
+  ElementChunkSink* chunk_out = make_sink<ElementChunkSink>(sink_id);
+  chunk_out->SetSync(false);
+  chunk_out->SetWriter(direct_io);
+  return chunk_out;
+}
+
+bool set_chunk_sink_location(GstElement* splitmux, const std::string& path, bool append) {
+  GstElement* sink = nullptr;
+  g_object_get(splitmux, "sink", &sink, nullptr);
+  if (!sink) {
+    return false;
+  }
+
+  ChunkSinkWriter* writer = static_cast<ChunkSinkWriter*>(g_object_get_data(G_OBJECT(sink), CHUNK_WRITER_DATA));
+  if (writer) {
+    writer->SetLocation(path, append);
+  }
+  gst_object_unref(sink);
+  return writer;
+}
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,44 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "stream/elements/sink/sink.h"  // for ElementBaseSink
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+// appsink writing splitmuxsink fragments through ChunkWriter, preallocated from previous chunk size
+class ElementChunkSink : public ElementBaseSink<ELEMENT_APP_SINK> {
+ public:
+  typedef ElementBaseSink<ELEMENT_APP_SINK> base_class;
+  using base_class::base_class;
+
+  void SetWriter(bool direct_io);
+};
+
+ElementChunkSink* make_chunk_sink(element_id_t sink_id, bool direct_io);
+
+// from format-location callbacks, false if splitmux sink not a chunk sink
+// appended fragment written from end of existing file
+bool set_chunk_sink_location(GstElement* splitmux, const std::string& path, bool append = false);
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,170 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sink/cmaf.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gst/app/gstappsink.h>  // for GST_APP_SINK
+
+#include <common/sprintf.h>
+#include <common/time.h>
+
+#include "base/cmaf_manifest.h"
+
+#include "stream/fmp4_splitter.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+namespace {
+
+bool write_file(const std::string& path, const char* data, size_t size) {
+  // readers never see half written file
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(data, size);
+    if (!out) {
+      return false;
+    }
+  }
+  return rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+class CmafWriter {
+ public:
+  explicit CmafWriter(const CmafOutput& output)
+      : output_(output),
+        splitter_(),
+        manifest_(output.prefix, output.playlist_length),
+        init_written_(false),
+        availability_start_(0) {}
+
+  void Push(GstBuffer* buffer) {
+    GstMapInfo map;
+    if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+      return;
+    }
+    splitter_.Feed(map.data, map.size);
+    gst_buffer_unmap(buffer, &map);
+
+    if (!init_written_ && splitter_.HaveInit()) {
+      const Fmp4Splitter::bytes_t& init = splitter_.GetInit();
+      const std::string init_path = output_.directory + manifest_.GetInitName();
+      init_written_ = write_file(init_path, reinterpret_cast<const char*>(init.data()), init.size());
+      manifest_.SetCodecs(splitter_.GetCodecs());
+    }
+
+    Fmp4Splitter::Fragment fragment;
+    while (splitter_.PopFragment(&fragment)) {
+      WriteSegment(fragment);
+    }
+  }
+
+ private:
+  void WriteSegment(const Fmp4Splitter::Fragment& fragment) {
+    const fastotv::timestamp_t now = common::time::current_utc_mstime();
+    if (!availability_start_) {
+      availability_start_ = now - fragment.duration_msec;
+    }
+
+    const std::string name = manifest_.GetSegmentName(manifest_.GetNextNumber());
+    if (!write_file(output_.directory + name, reinterpret_cast<const char*>(fragment.data.data()),
+                    fragment.data.size())) {
+      WARNING_LOG() << "Can't write segment: " << name;
+      return;
+    }
+
+    const std::vector<std::string> expired = manifest_.AddSegment(fragment.duration_msec, fragment.data.size());
+    const std::string hls = manifest_.RenderHls();
+    if (!write_file(output_.playlist, hls.data(), hls.size())) {
+      WARNING_LOG() << "Can't write playlist: " << output_.playlist;
+    }
+    const std::string dash = manifest_.RenderDash(availability_start_, now);
+    if (!write_file(output_.manifest, dash.data(), dash.size())) {
+      WARNING_LOG() << "Can't write manifest: " << output_.manifest;
+    }
+    for (const std::string& file : expired) {
+      remove((output_.directory + file).c_str());
+    }
+  }
+
+  const CmafOutput output_;
+  Fmp4Splitter splitter_;
+  CmafManifest manifest_;
+  bool init_written_;
+  fastotv::timestamp_t availability_start_;
+};
+
+GstFlowReturn cmaf_new_sample(GstAppSink* appsink, gpointer user_data) {
+  CmafWriter* writer = static_cast<CmafWriter*>(user_data);
+  GstSample* sample = gst_app_sink_pull_sample(appsink);
+  if (!sample) {
+    return GST_FLOW_EOS;
+  }
+
+  GstBuffer* buffer = gst_sample_get_buffer(sample);
+  if (buffer) {
+    writer->Push(buffer);
+  }
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
+
+void cmaf_destroy(gpointer user_data) {
+  delete static_cast<CmafWriter*>(user_data);
+}
+
+}  // namespace
+
+CmafOutput MakeCmafOutput(const common::file_system::ascii_directory_string_path& http_root,
+                          const std::string& filename) {
+  CmafOutput cmaf;
+  cmaf.directory = http_root.GetPath();
+  cmaf.playlist = cmaf.directory + filename;
+  const std::string::size_type dot = filename.find_last_of('.');
+  const std::string stem = dot == std::string::npos ? filename : filename.substr(0, dot);
+  cmaf.manifest = cmaf.directory + stem + "." DASH_MANIFEST_EXTENSION;
+  cmaf.prefix = common::MemSPrintf("%llu_", common::time::current_utc_mstime());
+  cmaf.playlist_length = CMAF_PLAYLIST_LENGTH;
+  return cmaf;
+}
+
+void ElementCmafSink::SetOutput(const CmafOutput& output) {
+  GstAppSinkCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(callbacks));
+  callbacks.new_sample = cmaf_new_sample;
+  // writer lives as long as gst element, element wrappers are deleted before pipeline stops
+  gst_app_sink_set_callbacks(GST_APP_SINK(GetGstElement()), &callbacks, new CmafWriter(output), cmaf_destroy);
+}
+
+ElementCmafSink* make_cmaf_sink(element_id_t sink_id, const CmafOutput& output) {
+  ElementCmafSink* cmaf_out = make_sink<ElementCmafSink>(sink_id);
+  cmaf_out->SetSync(false);
+  cmaf_out->SetOutput(output);
+  return cmaf_out;
+}
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,55 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <common/file_system/path.h>
+
+#include "stream/elements/sink/sink.h"  // for ElementBaseSink
+#include "stream/stypes.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+struct CmafOutput {
+  std::string directory;  // with trailing separator
+  std::string playlist;   // hls, full path
+  std::string manifest;   // dash, full path
+  std::string prefix;     // init and segment file names
+  uint32_t playlist_length;
+};
+
+// manifest named as playlist with mpd extension
+CmafOutput MakeCmafOutput(const common::file_system::ascii_directory_string_path& http_root,
+                          const std::string& filename);
+
+// appsink after fragmented mp4mux, segments written once for both hls and dash
+class ElementCmafSink : public ElementBaseSink<ELEMENT_APP_SINK> {
+ public:
+  typedef ElementBaseSink<ELEMENT_APP_SINK> base_class;
+  using base_class::base_class;
+
+  void SetOutput(const CmafOutput& output);
+};
+
+ElementCmafSink* make_cmaf_sink(element_id_t sink_id, const CmafOutput& output);
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,57 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sink/icecast.h"
+
+#include <string>
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+void ElementShout2Sink::SetIp(const std::string& ip) {
+  SetProperty("ip", ip);
+}
+
+void ElementShout2Sink::SetPort(uint16_t port) {
+  SetProperty("port", static_cast<gint>(port));
+}
+
+void ElementShout2Sink::SetMount(const std::string& mount) {
+  SetProperty("mount", mount);
+}
+
+void ElementShout2Sink::SetUsername(const std::string& username) {
+  SetProperty("username", username);
+}
+
+void ElementShout2Sink::SetPassword(const std::string& password) {
+  SetProperty("password", password);
+}
+
+ElementShout2Sink* make_icecast_sink(const IcecastOutput& output, element_id_t sink_id) {
+  ElementShout2Sink* icecast_out = make_sink<ElementShout2Sink>(sink_id);
+  icecast_out->SetIp(output.host);
+  icecast_out->SetPort(output.port);
+  icecast_out->SetMount(output.mount);
+  icecast_out->SetUsername(output.user);
+  icecast_out->SetPassword(output.password);
+  return icecast_out;
+}
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,48 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+// for element_id_t
+
+#include "stream/elements/element.h"    // for SupportedElements::ELEMENT_SHOUT2_SINK
+#include "stream/elements/sink/sink.h"  // for ElementBaseSink
+#include "stream/stypes.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+class ElementShout2Sink : public ElementBaseSink<ELEMENT_SHOUT2_SINK> {
+ public:
+  typedef ElementBaseSink<ELEMENT_SHOUT2_SINK> base_class;
+  using base_class::base_class;
+
+  void SetIp(const std::string& ip = "127.0.0.1");  // String; Default: "127.0.0.1"
+  void SetPort(uint16_t port = 8000);               // 1 - 65535; Default: 8000
+  void SetMount(const std::string& mount);          // String; Default: ""
+  void SetUsername(const std::string& username = "source");
+  void SetPassword(const std::string& password = "hackme");
+};
+
+// mp3 source of icecast mount, takes parsed audio/mpeg layer 3 without muxer
+ElementShout2Sink* make_icecast_sink(const IcecastOutput& output, element_id_t sink_id);
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
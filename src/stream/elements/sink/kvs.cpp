@@ -0,0 +1,97 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sink/kvs.h"
+
+#include <string>
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+void ElementKvsSink::SetStreamName(const std::string& name) {
+  SetProperty("stream-name", name);
+}
+
+void ElementKvsSink::SetAccessKey(const std::string& key) {
+  SetProperty("access-key", key);
+}
+
+void ElementKvsSink::SetSecretKey(const std::string& key) {
+  SetProperty("secret-key", key);
+}
+
+void ElementKvsSink::SetAwsRegion(const std::string& region) {
+  SetProperty("aws-region", region);
+}
+
+void ElementKvsSink::SetKeyFrameFragmentation(bool fragmentation) {
+  SetProperty("key-frame-fragmentation", fragmentation);
+}
+
+void ElementKvsSink::SetFragmentDuration(guint duration_msec) {
+  SetProperty("fragment-duration", duration_msec);
+}
+
+void ElementKvsSink::SetStorageSize(guint size_mb) {
+  SetProperty("storage-size", size_mb);
+}
+
+void ElementKvsSink::SetBufferDuration(guint duration_sec) {
+  SetProperty("buffer-duration", duration_sec);
+}
+
+void ElementKvsSink::SetMaxLatency(guint latency_sec) {
+  SetProperty("max-latency", latency_sec);
+}
+
+void ElementKvsSink::SetAvgBandwidth(guint bandwidth_bps) {
+  SetProperty("avg-bandwidth-bps", bandwidth_bps);
+}
+
+ElementKvsSink* make_kvs_sink(const amazon_kinesis::AmazonKinesis& kinesis, element_id_t sink_id) {
+  ElementKvsSink* kvs_sink = make_sink<ElementKvsSink>(sink_id);
+  kvs_sink->SetStreamName(kinesis.GetStreamName());
+  kvs_sink->SetAccessKey(kinesis.GetAccessKey());
+  kvs_sink->SetSecretKey(kinesis.GetSecretKey());
+  const std::string region = kinesis.GetRegion();
+  if (!region.empty()) {
+    kvs_sink->SetAwsRegion(region);
+  }
+  // one put per key frame floods the connection after a blip, batch by duration
+  const int fragment_msec = kinesis.GetFragmentDurationMsec();
+  if (fragment_msec) {
+    kvs_sink->SetKeyFrameFragmentation(false);
+    kvs_sink->SetFragmentDuration(fragment_msec);
+  }
+  if (kinesis.GetStorageSizeMb()) {
+    kvs_sink->SetStorageSize(kinesis.GetStorageSizeMb());
+  }
+  if (kinesis.GetBufferDurationSec()) {
+    kvs_sink->SetBufferDuration(kinesis.GetBufferDurationSec());
+  }
+  if (kinesis.GetMaxLatencySec()) {
+    kvs_sink->SetMaxLatency(kinesis.GetMaxLatencySec());
+  }
+  if (kinesis.GetAvgBandwidthBps()) {
+    kvs_sink->SetAvgBandwidth(kinesis.GetAvgBandwidthBps());
+  }
+  return kvs_sink;
+}
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,53 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "base/amazon_kinesis/amazon_kinesis.h"
+
+#include "stream/elements/element.h"    // for SupportedElements::ELEMENT_KVS_SINK
+#include "stream/elements/sink/sink.h"  // for ElementBaseSink
+#include "stream/stypes.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+// muxes parsed h264/aac into mkv fragments itself, video_%u/audio_%u request pads
+class ElementKvsSink : public ElementBaseSink<ELEMENT_KVS_SINK> {
+ public:
+  typedef ElementBaseSink<ELEMENT_KVS_SINK> base_class;
+  using base_class::base_class;
+
+  void SetStreamName(const std::string& name);
+  void SetAccessKey(const std::string& key);
+  void SetSecretKey(const std::string& key);
+  void SetAwsRegion(const std::string& region);
+  void SetKeyFrameFragmentation(bool fragmentation);  // Default: true
+  void SetFragmentDuration(guint duration_msec);      // Default: 2000, used without key frame fragmentation
+  void SetStorageSize(guint size_mb);                 // Default: 128
+  void SetBufferDuration(guint duration_sec);         // Default: 120
+  void SetMaxLatency(guint latency_sec);              // Default: 60
+  void SetAvgBandwidth(guint bandwidth_bps);          // Default: 4194304
+};
+
+ElementKvsSink* make_kvs_sink(const amazon_kinesis::AmazonKinesis& kinesis, element_id_t sink_id);
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,226 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sink/llhls.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gst/app/gstappsink.h>  // for GST_APP_SINK
+
+#include <common/sprintf.h>
+#include <common/time.h>
+
+#include "base/ll_hls_playlist.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+namespace {
+
+class LlHlsWriter {
+ public:
+  explicit LlHlsWriter(const LlHlsOutput& output)
+      : output_(output),
+        playlist_(output.part_msec, output.playlist_length),
+        segment_index_(0),
+        part_index_(0),
+        segment_start_(0),
+        part_start_(0),
+        last_ts_(0),
+        part_independent_(false),
+        segment_file_(),
+        part_file_() {}
+
+  ~LlHlsWriter() { Finish(); }
+
+  void Push(GstBuffer* buffer) {
+    const fastotv::timestamp_t ts = GetTimestamp(buffer);
+    const bool keyframe = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    if (!segment_file_.is_open()) {
+      OpenSegment(ts);
+    }
+
+    if (!part_file_.is_open()) {
+      OpenPart(ts, keyframe);
+    } else if (keyframe && ts - segment_start_ >= output_.segment_msec) {
+      ClosePart(ts);
+      CloseSegment(ts);
+      OpenSegment(ts);
+      OpenPart(ts, keyframe);
+    } else if (ts - part_start_ >= output_.part_msec) {
+      ClosePart(ts);
+      OpenPart(ts, keyframe);
+    }
+
+    GstMapInfo map;
+    if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+      const char* data = reinterpret_cast<const char*>(map.data);
+      part_file_.write(data, map.size);
+      segment_file_.write(data, map.size);
+      gst_buffer_unmap(buffer, &map);
+    }
+    last_ts_ = ts;
+  }
+
+  void Finish() {
+    if (part_file_.is_open()) {
+      ClosePart(last_ts_);
+    }
+    if (segment_file_.is_open()) {
+      CloseSegment(last_ts_);
+    }
+  }
+
+ private:
+  static fastotv::timestamp_t GetTimestamp(GstBuffer* buffer) {
+    if (GST_BUFFER_PTS_IS_VALID(buffer)) {
+      return GST_BUFFER_PTS(buffer) / GST_MSECOND;
+    }
+    if (GST_BUFFER_DTS_IS_VALID(buffer)) {
+      return GST_BUFFER_DTS(buffer) / GST_MSECOND;
+    }
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+  }
+
+  std::string SegmentName(uint64_t segment) const {
+    return output_.prefix + common::MemSPrintf("%05llu" CHUNK_EXT, segment);
+  }
+
+  std::string PartName(uint64_t segment, uint32_t part) const {
+    return output_.prefix + common::MemSPrintf("%05llu.%u" CHUNK_EXT, segment, part);
+  }
+
+  void OpenSegment(fastotv::timestamp_t ts) {
+    segment_start_ = ts;
+    part_index_ = 0;
+    segment_file_.open(output_.directory + SegmentName(segment_index_), std::ios::binary | std::ios::trunc);
+  }
+
+  void OpenPart(fastotv::timestamp_t ts, bool independent) {
+    part_start_ = ts;
+    part_independent_ = independent;
+    part_file_.open(output_.directory + PartName(segment_index_, part_index_), std::ios::binary | std::ios::trunc);
+  }
+
+  void ClosePart(fastotv::timestamp_t ts) {
+    part_file_.close();
+    playlist_.AddPart(PartName(segment_index_, part_index_), ts - part_start_, part_independent_);
+    part_index_++;
+    playlist_.SetPreloadHint(PartName(segment_index_, part_index_));
+    WritePlaylist();
+  }
+
+  void CloseSegment(fastotv::timestamp_t ts) {
+    segment_file_.close();
+    const std::vector<std::string> expired = playlist_.CloseSegment(SegmentName(segment_index_), ts - segment_start_);
+    segment_index_++;
+    playlist_.SetPreloadHint(PartName(segment_index_, 0));
+    WritePlaylist();
+    for (const std::string& file : expired) {
+      remove((output_.directory + file).c_str());
+    }
+  }
+
+  void WritePlaylist() {
+    // readers never see half written playlist
+    const std::string tmp = output_.playlist + ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::trunc);
+      out << playlist_.Render();
+    }
+    if (rename(tmp.c_str(), output_.playlist.c_str()) != 0) {
+      WARNING_LOG() << "Can't write playlist: " << output_.playlist;
+    }
+  }
+
+  const LlHlsOutput output_;
+  LlHlsPlaylist playlist_;
+  uint64_t segment_index_;
+  uint32_t part_index_;
+  fastotv::timestamp_t segment_start_;
+  fastotv::timestamp_t part_start_;
+  fastotv::timestamp_t last_ts_;
+  bool part_independent_;
+  std::ofstream segment_file_;
+  std::ofstream part_file_;
+};
+
+GstFlowReturn ll_hls_new_sample(GstAppSink* appsink, gpointer user_data) {
+  LlHlsWriter* writer = static_cast<LlHlsWriter*>(user_data);
+  GstSample* sample = gst_app_sink_pull_sample(appsink);
+  if (!sample) {
+    return GST_FLOW_EOS;
+  }
+
+  GstBuffer* buffer = gst_sample_get_buffer(sample);
+  if (buffer) {
+    writer->Push(buffer);
+  }
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
+
+void ll_hls_eos(GstAppSink* appsink, gpointer user_data) {
+  UNUSED(appsink);
+  static_cast<LlHlsWriter*>(user_data)->Finish();
+}
+
+void ll_hls_destroy(gpointer user_data) {
+  delete static_cast<LlHlsWriter*>(user_data);
+}
+
+}  // namespace
+
+LlHlsOutput MakeLlHlsOutput(const common::file_system::ascii_directory_string_path& http_root,
+                            const std::string& filename,
+                            fastotv::timestamp_t part_msec) {
+  LlHlsOutput hout;
+  hout.directory = http_root.GetPath();
+  hout.playlist = hout.directory + filename;
+  hout.prefix = common::MemSPrintf("%llu_", common::time::current_utc_mstime());
+  hout.part_msec = part_msec;
+  hout.segment_msec = LL_HLS_SEGMENT_MSEC;
+  hout.playlist_length = LL_HLS_PLAYLIST_LENGTH;
+  return hout;
+}
+
+void ElementLlHlsSink::SetOutput(const LlHlsOutput& output) {
+  GstAppSinkCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(callbacks));
+  callbacks.eos = ll_hls_eos;
+  callbacks.new_sample = ll_hls_new_sample;
+  // writer lives as long as gst element, element wrappers are deleted before pipeline stops
+  gst_app_sink_set_callbacks(GST_APP_SINK(GetGstElement()), &callbacks, new LlHlsWriter(output), ll_hls_destroy);
+}
+
+ElementLlHlsSink* make_ll_hls_sink(element_id_t sink_id, const LlHlsOutput& output) {
+  ElementLlHlsSink* hls_out = make_sink<ElementLlHlsSink>(sink_id);
+  hls_out->SetSync(false);
+  hls_out->SetOutput(output);
+  return hls_out;
+}
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
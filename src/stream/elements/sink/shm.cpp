@@ -0,0 +1,48 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sink/shm.h"
+
+#include <string>
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+void ElementShmSink::SetSocketPath(const std::string& path) {
+  SetProperty("socket-path", path);
+}
+
+void ElementShmSink::SetShmSize(guint size) {
+  SetProperty("shm-size", size);
+}
+
+void ElementShmSink::SetWaitForConnection(bool wait) {
+  SetProperty("wait-for-connection", wait);
+}
+
+ElementShmSink* make_shm_sink(const std::string& socket_path, guint shm_size, element_id_t sink_id) {
+  ElementShmSink* sink = make_element<ElementShmSink>(common::MemSPrintf(INGEST_SINK_NAME_1U, sink_id));
+  sink->SetSocketPath(socket_path);
+  sink->SetShmSize(shm_size);
+  sink->SetWaitForConnection(false);
+  sink->SetSync(false);
+  return sink;
+}
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,42 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "stream/elements/sink/sink.h"  // for ElementBaseSink
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+class ElementShmSink : public ElementBaseSink<ELEMENT_SHM_SINK> {
+ public:
+  typedef ElementBaseSink<ELEMENT_SHM_SINK> base_class;
+  using base_class::base_class;
+
+  void SetSocketPath(const std::string& path);  // String. Default: null
+  void SetShmSize(guint size = 67108864);       // Range: 0 - 4294967295 Default: 67108864
+  void SetWaitForConnection(bool wait = true);  // true - false: true
+};
+
+// readers attached to socket_path, buffers are not blocked while no one connected
+ElementShmSink* make_shm_sink(const std::string& socket_path, guint shm_size, element_id_t sink_id);
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -14,8 +14,14 @@
 
 #include "stream/elements/sink/srt.h"
 
+#include <stdio.h>
+#include <string.h>
+
 #include <string>
 
+#include <gio/gio.h>
+#include <gst/gst.h>
+
 namespace fastocloud {
 namespace stream {
 namespace elements {
@@ -25,12 +31,80 @@ void ElementSrtSink::SetUri(const std::string& uri) {
   SetProperty("uri", uri);
 }
 
+void ElementSrtSink::SetLatency(gint latency) {
+  SetProperty("latency", latency);
+}
+
+void ElementSrtSink::SetWaitForConnection(bool wait) {
+  SetProperty("wait-for-connection", wait);
+}
+
+namespace {
+void read_peer(const GstStructure* stats, PeerStats* peer) {
+  memset(peer, 0, sizeof(PeerStats));
+  gdouble rtt = 0;
+  if (gst_structure_get_double(stats, "rtt-ms", &rtt)) {
+    peer->rtt_msec = rtt;
+  }
+  gint value = 0;
+  if (gst_structure_get_int(stats, "packets-retransmitted", &value)) {
+    peer->retransmits = value;
+  }
+  if (gst_structure_get_int(stats, "packets-sent-dropped", &value)) {
+    peer->drops = value;
+  }
+
+  const GValue* address = gst_structure_get_value(stats, "caller-address");
+  if (!address || !G_VALUE_HOLDS(address, G_TYPE_SOCKET_ADDRESS)) {
+    return;
+  }
+  GObject* socket_address = G_OBJECT(g_value_get_object(address));
+  if (!G_IS_INET_SOCKET_ADDRESS(socket_address)) {
+    return;
+  }
+  GInetSocketAddress* inet = G_INET_SOCKET_ADDRESS(socket_address);
+  gchar* host = g_inet_address_to_string(g_inet_socket_address_get_address(inet));
+  snprintf(peer->address, sizeof(peer->address), "%s:%u", host, g_inet_socket_address_get_port(inet));
+  g_free(host);
+}
+}  // namespace
+
+bool is_srt_listener(const common::uri::Url& uri) {
+  return uri.GetScheme() == common::uri::Url::srt && uri.GetUrl().find("mode=listener") != std::string::npos;
+}
+
 ElementSrtSink* make_srt_sink(const std::string& uri, element_id_t sink_id) {
   ElementSrtSink* sink = make_sink<ElementSrtSink>(sink_id);
   sink->SetUri(uri);
   return sink;
 }
 
+size_t get_srt_sink_peers(GstElement* sink, PeerStats* peers, size_t max_peers) {
+  GstStructure* stats = nullptr;
+  g_object_get(sink, "stats", &stats, nullptr);
+  if (!stats) {
+    return 0;
+  }
+
+  size_t count = 0;
+  const GValue* callers = gst_structure_get_value(stats, "callers");
+  if (callers && G_VALUE_HOLDS(callers, G_TYPE_VALUE_ARRAY)) {  // listener
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    GValueArray* array = static_cast<GValueArray*>(g_value_get_boxed(callers));
+    for (guint i = 0; array && i < array->n_values && count < max_peers; ++i) {
+      const GValue* caller = g_value_array_get_nth(array, i);
+      if (GST_VALUE_HOLDS_STRUCTURE(caller)) {
+        read_peer(gst_value_get_structure(caller), &peers[count++]);
+      }
+    }
+    G_GNUC_END_IGNORE_DEPRECATIONS
+  } else if (max_peers && gst_structure_has_field(stats, "rtt-ms")) {  // connected caller
+    read_peer(stats, &peers[count++]);
+  }
+  gst_structure_free(stats);
+  return count;
+}
+
 }  // namespace sink
 }  // namespace elements
 }  // namespace stream
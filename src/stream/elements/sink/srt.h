@@ -17,6 +17,9 @@
 #include <string>
 
 #include <common/net/types.h>
+#include <common/uri/url.h>
+
+#include "base/channel_stats.h"
 
 // for element_id_t
 
@@ -39,10 +42,18 @@ class ElementSrtSink : public ElementBaseSink<ELEMENT_SRT_SINK> {
   using base_class::base_class;
 
   void SetUri(const std::string& uri = "srt://127.0.0.1:7001");  // String. Default: "srt://127.0.0.1:7001"
+  void SetLatency(gint latency = 125);                            // Range: 0 - 2147483647 Default: 125, msec
+  void SetWaitForConnection(bool wait = true);                    // true - false: true
 };
 
+// srt://:port?mode=listener, callers share one sink
+bool is_srt_listener(const common::uri::Url& uri);
+
 ElementSrtSink* make_srt_sink(const std::string& uri, element_id_t sink_id);
 
+// connected callers of srtsink (one in caller mode), returns count written
+size_t get_srt_sink_peers(GstElement* sink, PeerStats* peers, size_t max_peers);
+
 }  // namespace sink
 }  // namespace elements
 }  // namespace stream
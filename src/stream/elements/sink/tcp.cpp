@@ -21,6 +21,36 @@ namespace stream {
 namespace elements {
 namespace sink {
 
+namespace {
+const gint kRecoverKeyframe = 3;
+const gint kSyncLatestKeyframe = 2;
+
+guint64 get_client_stat(const GstStructure* stats, const char* name) {
+  guint64 value = 0;
+  if (!gst_structure_get_uint64(stats, name, &value)) {
+    return 0;
+  }
+  return value;
+}
+
+void tcp_client_removed_callback(GstElement* sink, GObject* socket, gint status, gpointer user_data) {
+  UNUSED(user_data);
+  GstStructure* stats = nullptr;
+  g_signal_emit_by_name(sink, "get-stats", socket, &stats);
+  if (!stats) {
+    return;
+  }
+
+  const guint64 sent = get_client_stat(stats, "bytes-sent");
+  const guint64 dropped = get_client_stat(stats, "bytes-dropped");
+  const guint64 duration_msec = get_client_stat(stats, "connect-duration") / GST_MSECOND;
+  const guint64 kbps = duration_msec ? sent * 8 / duration_msec : 0;
+  INFO_LOG() << "Tcp client of " << GST_ELEMENT_NAME(sink) << " removed, status: " << status << ", sent: " << sent
+             << " bytes in " << duration_msec << " msec (" << kbps << " kbps), dropped: " << dropped << " bytes";
+  gst_structure_free(stats);
+}
+}  // namespace
+
 void ElementTCPServerSink::SetHost(const std::string& host) {
   SetProperty("host", host);
 }
@@ -29,10 +59,55 @@ void ElementTCPServerSink::SetPort(uint16_t port) {
   SetProperty("port", port);
 }
 
-ElementTCPServerSink* make_tcp_server_sink(const common::net::HostAndPort& host, element_id_t sink_id) {
+void ElementTCPServerSink::SetQosDscp(gint dscp) {
+  SetProperty("qos-dscp", dscp);
+}
+
+void ElementTCPServerSink::SetUnitsFormat(GstFormat format) {
+  SetProperty("units-format", format);
+}
+
+void ElementTCPServerSink::SetUnitsMax(gint64 max) {
+  SetProperty("units-max", max);
+}
+
+void ElementTCPServerSink::SetUnitsSoftMax(gint64 max) {
+  SetProperty("units-soft-max", max);
+}
+
+void ElementTCPServerSink::SetRecoverPolicy(gint policy) {
+  SetProperty("recover-policy", policy);
+}
+
+void ElementTCPServerSink::SetSyncMethod(gint method) {
+  SetProperty("sync-method", method);
+}
+
+void ElementTCPServerSink::SetTimeout(guint64 timeout) {
+  SetProperty("timeout", timeout);
+}
+
+ElementTCPServerSink* make_tcp_server_sink(const common::net::HostAndPort& host,
+                                           const TcpTuning& tcp,
+                                           element_id_t sink_id) {
   ElementTCPServerSink* tcp_out = make_sink<ElementTCPServerSink>(sink_id);
   tcp_out->SetHost(host.GetHost());
   tcp_out->SetPort(host.GetPort());
+  if (tcp.client_buffer) {  // slow client never backs up sink, its own queue is cut instead
+    tcp_out->SetUnitsFormat(GST_FORMAT_BYTES);
+    tcp_out->SetUnitsSoftMax(tcp.client_buffer);
+    tcp_out->SetUnitsMax(static_cast<gint64>(tcp.client_buffer) * 2);
+  }
+  if (tcp.keyframe_recover) {
+    tcp_out->SetRecoverPolicy(kRecoverKeyframe);
+  }
+  if (tcp.keyframe_burst) {
+    tcp_out->SetSyncMethod(kSyncLatestKeyframe);
+  }
+  if (tcp.timeout) {
+    tcp_out->SetTimeout(tcp.timeout * GST_SECOND);
+  }
+  g_signal_connect(tcp_out->GetGstElement(), "client-removed", G_CALLBACK(tcp_client_removed_callback), nullptr);
   return tcp_out;
 }
 
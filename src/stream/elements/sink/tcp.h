@@ -20,6 +20,8 @@
 
 // for element_id_t
 
+#include "base/tcp_tuning.h"
+
 #include "stream/elements/element.h"    // for SupportedElements::ELEMENT_UDP_SINK
 #include "stream/elements/sink/sink.h"  // for ElementBaseSink
 #include "stream/stypes.h"
@@ -40,9 +42,21 @@ class ElementTCPServerSink : public ElementBaseSink<ELEMENT_TCP_SERVER_SINK> {
 
   void SetHost(const std::string& host = "localhost");  // String; Default: "localhost"
   void SetPort(uint16_t port = 5004);                   // 0 - 65535; Default: 5004
+  void SetQosDscp(gint dscp = -1);                      // -1 - 63; Default: -1
+
+  // queue of every client, soft max applies recover policy, hard max disconnects
+  void SetUnitsFormat(GstFormat format = GST_FORMAT_BUFFERS);  // Default: buffers
+  void SetUnitsMax(gint64 max = -1);                           // -1 unlimited; Default: -1
+  void SetUnitsSoftMax(gint64 max = -1);                       // -1 unlimited; Default: -1
+  void SetRecoverPolicy(gint policy = 0);  // 0 none, 1 latest, 2 soft limit, 3 keyframe; Default: 0
+  void SetSyncMethod(gint method = 0);     // 0 latest, 1 next keyframe, 2 latest keyframe .. 5; Default: 0
+  void SetTimeout(guint64 timeout = 0);    // nsec without client activity, 0 never; Default: 0
 };
 
-ElementTCPServerSink* make_tcp_server_sink(const common::net::HostAndPort& host, element_id_t sink_id);
+// client queues limited by tuning, sent and dropped bytes of every client logged on disconnect
+ElementTCPServerSink* make_tcp_server_sink(const common::net::HostAndPort& host,
+                                           const TcpTuning& tcp,
+                                           element_id_t sink_id);
 
 }  // namespace sink
 }  // namespace elements
@@ -16,6 +16,8 @@
 
 #include <string>
 
+#include <common/convert2string.h>
+
 namespace fastocloud {
 namespace stream {
 namespace elements {
@@ -29,10 +31,52 @@ void ElementUDPSink::SetPort(uint16_t port) {
   SetProperty("port", port);
 }
 
-ElementUDPSink* make_udp_sink(const common::net::HostAndPort& host, element_id_t sink_id) {
+void ElementUDPSink::SetBufferSize(gint size) {
+  SetProperty("buffer-size", size);
+}
+
+void ElementUDPSink::SetQosDscp(gint dscp) {
+  SetProperty("qos-dscp", dscp);
+}
+
+void ElementUDPSink::SetMulticastIface(const std::string& iface) {
+  SetProperty("multicast-iface", iface);
+}
+
+void ElementMultiUDPSink::SetClients(const std::string& clients) {
+  SetProperty("clients", clients);
+}
+
+void ElementMultiUDPSink::SetBufferSize(gint size) {
+  SetProperty("buffer-size", size);
+}
+
+ElementUDPSink* make_udp_sink(const common::net::HostAndPort& host, gint buffer_size, element_id_t sink_id) {
   ElementUDPSink* udp_out = make_sink<ElementUDPSink>(sink_id);
   udp_out->SetHost(host.GetHost());
   udp_out->SetPort(host.GetPort());
+  if (buffer_size > 0) {
+    udp_out->SetBufferSize(buffer_size);
+  }
+  return udp_out;
+}
+
+ElementMultiUDPSink* make_multi_udp_sink(const std::vector<common::net::HostAndPort>& hosts,
+                                         gint buffer_size,
+                                         element_id_t sink_id) {
+  std::string clients;
+  for (const common::net::HostAndPort& host : hosts) {
+    if (!clients.empty()) {
+      clients += ",";
+    }
+    clients += host.GetHost() + ":" + common::ConvertToString(host.GetPort());
+  }
+
+  ElementMultiUDPSink* udp_out = make_sink<ElementMultiUDPSink>(sink_id);
+  udp_out->SetClients(clients);
+  if (buffer_size > 0) {
+    udp_out->SetBufferSize(buffer_size);
+  }
   return udp_out;
 }
 
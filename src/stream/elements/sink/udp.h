@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <common/net/types.h>
 
@@ -40,9 +41,25 @@ class ElementUDPSink : public ElementBaseSink<ELEMENT_UDP_SINK> {
 
   void SetHost(const std::string& host = "localhost");  // String; Default: "localhost"
   void SetPort(uint16_t port = 5004);                   // 0 - 65535; Default: 5004
+  void SetBufferSize(gint size = 0);                    // 0 - 2147483647; Default: 0
+  void SetQosDscp(gint dscp = -1);                      // -1 - 63; Default: -1
+  void SetMulticastIface(const std::string& iface);     // String; Default: null
 };
 
-ElementUDPSink* make_udp_sink(const common::net::HostAndPort& host, element_id_t sink_id);
+// same buffers sent to every client from one socket and streaming thread
+class ElementMultiUDPSink : public ElementBaseSink<ELEMENT_MULTIUDP_SINK> {
+ public:
+  typedef ElementBaseSink<ELEMENT_MULTIUDP_SINK> base_class;
+  using base_class::base_class;
+
+  void SetClients(const std::string& clients);  // String "host:port,host:port"; Default: ""
+  void SetBufferSize(gint size = 0);            // 0 - 2147483647; Default: 0
+};
+
+ElementUDPSink* make_udp_sink(const common::net::HostAndPort& host, gint buffer_size, element_id_t sink_id);
+ElementMultiUDPSink* make_multi_udp_sink(const std::vector<common::net::HostAndPort>& hosts,
+                                         gint buffer_size,
+                                         element_id_t sink_id);
 
 }  // namespace sink
 }  // namespace elements
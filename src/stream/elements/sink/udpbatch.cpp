@@ -0,0 +1,381 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sink/udpbatch.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(OS_LINUX)
+#include <net/if.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <gst/app/gstappsink.h>  // for GST_APP_SINK
+
+#include <common/convert2string.h>
+
+#include "stream/gstreamer_utils.h"
+#include "stream/ts_packet_filter.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+namespace {
+
+typedef std::chrono::steady_clock pacing_clock_t;
+
+// send times of datagrams from PCR, datagrams between PCRs spread by measured rate
+class PcrPacer {
+ public:
+  enum { max_drift_msec = 1000 };  // discontinuity or stall, time base reset
+
+  PcrPacer()
+      : pcr_pid_(0),
+        have_base_(false),
+        base_pcr_(0),
+        base_time_(),
+        pcr_time_(),
+        next_time_(),
+        bytes_since_pcr_(0),
+        bytes_per_usec_(0) {}
+
+  pacing_clock_t::time_point When(const uint8_t* data, size_t size) {
+    const pacing_clock_t::time_point now = pacing_clock_t::now();
+    uint64_t pcr;
+    if (!FindPcr(data, size, &pcr)) {
+      if (!have_base_ || bytes_per_usec_ <= 0) {
+        return now;
+      }
+      const pacing_clock_t::time_point when = next_time_;
+      next_time_ += std::chrono::microseconds(static_cast<int64_t>(size / bytes_per_usec_));
+      return when;
+    }
+
+    if (!have_base_) {
+      Rebase(pcr, now);
+      return now;
+    }
+
+    const uint64_t pcr_wrap = (1ULL << 33) * 300;
+    const uint64_t elapsed_pcr = (pcr + pcr_wrap - base_pcr_) % pcr_wrap;
+    const pacing_clock_t::time_point when = base_time_ + std::chrono::microseconds(elapsed_pcr / 27);
+    if (when > now + std::chrono::milliseconds(max_drift_msec) ||
+        when + std::chrono::milliseconds(max_drift_msec) < now) {
+      Rebase(pcr, now);
+      return now;
+    }
+
+    const int64_t usec = std::chrono::duration_cast<std::chrono::microseconds>(when - pcr_time_).count();
+    if (usec > 0) {
+      bytes_per_usec_ = static_cast<double>(bytes_since_pcr_) / usec;
+    }
+    bytes_since_pcr_ = 0;
+    pcr_time_ = when;
+    next_time_ = when;
+    if (bytes_per_usec_ > 0) {
+      next_time_ += std::chrono::microseconds(static_cast<int64_t>(size / bytes_per_usec_));
+    }
+    return when;
+  }
+
+  void Account(size_t size) { bytes_since_pcr_ += size; }  // bytes sent since last PCR datagram, for rate
+
+ private:
+  bool FindPcr(const uint8_t* data, size_t size, uint64_t* pcr) {
+    for (size_t off = 0; off + TS_PACKET_SIZE <= size; off += TS_PACKET_SIZE) {
+      uint16_t pid;
+      if (!get_ts_packet_pid(data + off, size - off, &pid) || !get_ts_packet_pcr(data + off, size - off, pcr)) {
+        continue;
+      }
+
+      if (pcr_pid_ == 0) {
+        pcr_pid_ = pid;  // first program clock followed
+      }
+      if (pid == pcr_pid_) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Rebase(uint64_t pcr, pacing_clock_t::time_point now) {
+    have_base_ = true;
+    base_pcr_ = pcr;
+    base_time_ = now;
+    pcr_time_ = now;
+    next_time_ = now;
+    bytes_since_pcr_ = 0;
+  }
+
+  uint16_t pcr_pid_;
+  bool have_base_;
+  uint64_t base_pcr_;
+  pacing_clock_t::time_point base_time_;
+  pacing_clock_t::time_point pcr_time_;   // send time of last PCR datagram
+  pacing_clock_t::time_point next_time_;  // interpolated by rate
+  size_t bytes_since_pcr_;
+  double bytes_per_usec_;
+};
+
+class UdpBatchSender {
+ public:
+  enum { datagram_size = TS_PACKET_SIZE * 7, max_hold_msec = 10 };
+
+  UdpBatchSender(int fd, const UdpEgress& udp)
+      : fd_(fd),
+        batch_(udp.batch),
+        pacing_(udp.pacing),
+        data_(batch_ * datagram_size),
+        sizes_(batch_, 0),
+#if defined(OS_LINUX)
+        iovs_(batch_),
+        msgs_(batch_),
+#endif
+        ready_(0),
+        first_ready_(),
+        pacer_(),
+        send_error_logged_(false) {}
+
+  ~UdpBatchSender() {
+    Finish();
+#if defined(OS_LINUX)
+    close(fd_);
+#endif
+  }
+
+  void Push(const uint8_t* data, size_t size) {
+    while (size > 0) {
+      size_t& current = sizes_[ready_];
+      const size_t chunk = std::min(size, static_cast<size_t>(datagram_size) - current);
+      memcpy(&data_[ready_ * datagram_size] + current, data, chunk);
+      current += chunk;
+      data += chunk;
+      size -= chunk;
+      if (current == datagram_size) {
+        Complete();
+      }
+    }
+
+    if (ready_ != 0 && pacing_clock_t::now() - first_ready_ > std::chrono::milliseconds(max_hold_msec)) {
+      Flush();  // low bitrate, don't hold datagrams for a full batch
+    }
+  }
+
+  void Finish() {
+    if (sizes_[ready_] != 0) {
+      ready_++;
+    }
+    Flush();
+  }
+
+ private:
+  void Complete() {
+    if (pacing_) {
+      const uint8_t* datagram = &data_[ready_ * datagram_size];
+      const pacing_clock_t::time_point when = pacer_.When(datagram, datagram_size);
+      pacer_.Account(datagram_size);
+      if (when > pacing_clock_t::now()) {
+        // queued datagrams are due, the new one waits for its PCR time
+        Flush();
+        std::this_thread::sleep_until(when);
+      }
+    }
+
+    if (ready_ == 0) {
+      first_ready_ = pacing_clock_t::now();
+    }
+    ready_++;
+    if (ready_ == batch_) {
+      Flush();
+    }
+  }
+
+  void Flush() {
+    if (ready_ == 0) {
+      return;
+    }
+
+#if defined(OS_LINUX)
+    for (size_t i = 0; i < ready_; ++i) {
+      iovs_[i].iov_base = &data_[i * datagram_size];
+      iovs_[i].iov_len = sizes_[i];
+      memset(&msgs_[i], 0, sizeof(struct mmsghdr));
+      msgs_[i].msg_hdr.msg_iov = &iovs_[i];
+      msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t sent = 0;
+    while (sent < ready_) {
+      const int count = sendmmsg(fd_, msgs_.data() + sent, ready_ - sent, 0);
+      if (count <= 0) {
+        if (!send_error_logged_) {
+          WARNING_LOG() << "Udp batch send failed, errno: " << errno;
+          send_error_logged_ = true;
+        }
+        break;  // live output, datagrams dropped
+      }
+      sent += count;
+    }
+#endif
+    // datagram in progress moved to first slot
+    const size_t partial = ready_ < batch_ ? sizes_[ready_] : 0;
+    if (partial != 0) {
+      memmove(&data_[0], &data_[ready_ * datagram_size], partial);
+    }
+    std::fill(sizes_.begin(), sizes_.end(), 0);
+    sizes_[0] = partial;
+    ready_ = 0;
+  }
+
+  const int fd_;
+  const size_t batch_;
+  const bool pacing_;
+  std::vector<uint8_t> data_;
+  std::vector<size_t> sizes_;
+#if defined(OS_LINUX)
+  std::vector<struct iovec> iovs_;
+  std::vector<struct mmsghdr> msgs_;
+#endif
+  size_t ready_;  // complete datagrams
+  pacing_clock_t::time_point first_ready_;
+  PcrPacer pacer_;
+  bool send_error_logged_;
+};
+
+GstFlowReturn udp_batch_new_sample(GstAppSink* appsink, gpointer user_data) {
+  UdpBatchSender* sender = static_cast<UdpBatchSender*>(user_data);
+  GstSample* sample = gst_app_sink_pull_sample(appsink);
+  if (!sample) {
+    return GST_FLOW_EOS;
+  }
+
+  GstBuffer* buffer = gst_sample_get_buffer(sample);
+  GstMapInfo map;
+  if (buffer && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    sender->Push(map.data, map.size);
+    gst_buffer_unmap(buffer, &map);
+  }
+  gst_sample_unref(sample);
+  return GST_FLOW_OK;
+}
+
+void udp_batch_eos(GstAppSink* appsink, gpointer user_data) {
+  UNUSED(appsink);
+  static_cast<UdpBatchSender*>(user_data)->Finish();
+}
+
+void udp_batch_destroy(gpointer user_data) {
+  delete static_cast<UdpBatchSender*>(user_data);
+}
+
+}  // namespace
+
+void ElementUDPBatchSink::SetSocket(int fd, const UdpEgress& udp) {
+  GstAppSinkCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(callbacks));
+  callbacks.eos = udp_batch_eos;
+  callbacks.new_sample = udp_batch_new_sample;
+  // sender lives as long as gst element, element wrappers are deleted before pipeline stops
+  gst_app_sink_set_callbacks(GST_APP_SINK(GetGstElement()), &callbacks, new UdpBatchSender(fd, udp),
+                             udp_batch_destroy);
+  g_object_set_data(G_OBJECT(GetGstElement()), SOCKET_FD_DATA, GINT_TO_POINTER(fd + 1));
+}
+
+int ElementUDPBatchSink::OpenSocket(const common::net::HostAndPort& host,
+                                    const UdpEgress& udp,
+                                    const SocketTuning& socket) {
+#if defined(OS_LINUX)
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  struct addrinfo* info = nullptr;
+  const std::string port = common::ConvertToString(host.GetPort());
+  if (getaddrinfo(host.GetHost().c_str(), port.c_str(), &hints, &info) != 0 || !info) {
+    return -1;
+  }
+
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    freeaddrinfo(info);
+    return -1;
+  }
+
+  const int send_buffer = socket.send_buffer > 0 ? socket.send_buffer : udp.send_buffer;
+  if (send_buffer > 0 && setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &send_buffer, sizeof(send_buffer)) == -1) {
+    WARNING_LOG() << "Can't set udp send buffer: " << send_buffer;
+  }
+
+  if (socket.HaveDscp()) {
+    const int tos = socket.dscp << 2;
+    if (setsockopt(fd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos)) == -1) {
+      WARNING_LOG() << "Can't set udp dscp: " << socket.dscp;
+    }
+  }
+
+  if (!socket.multicast_iface.empty()) {
+    struct ip_mreqn mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.imr_ifindex = if_nametoindex(socket.multicast_iface.c_str());
+    if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &mreq, sizeof(mreq)) == -1) {
+      WARNING_LOG() << "Can't set udp multicast interface: " << socket.multicast_iface;
+    }
+  }
+
+  const int res = connect(fd, info->ai_addr, info->ai_addrlen);
+  freeaddrinfo(info);
+  if (res == -1) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+#else
+  UNUSED(host);
+  UNUSED(udp);
+  UNUSED(socket);
+  return -1;
+#endif
+}
+
+ElementUDPBatchSink* make_udp_batch_sink(const common::net::HostAndPort& host,
+                                         const UdpEgress& udp,
+                                         const SocketTuning& socket,
+                                         element_id_t sink_id) {
+  const int fd = ElementUDPBatchSink::OpenSocket(host, udp, socket);
+  if (fd == -1) {
+    return nullptr;
+  }
+
+  ElementUDPBatchSink* udp_out = make_sink<ElementUDPBatchSink>(sink_id);
+  udp_out->SetSync(false);  // sender paces by PCR if enabled, streaming thread blocked meanwhile
+  udp_out->SetSocket(fd, udp);
+  return udp_out;
+}
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,50 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/net/types.h>
+
+#include "base/socket_tuning.h"
+
+#include "stream/elements/sink/sink.h"  // for ElementBaseSink
+#include "stream/stypes.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sink {
+
+// appsink aggregating ts into 7x188 datagrams sent by sendmmsg from streaming thread, linux only
+class ElementUDPBatchSink : public ElementBaseSink<ELEMENT_APP_SINK> {
+ public:
+  typedef ElementBaseSink<ELEMENT_APP_SINK> base_class;
+  using base_class::base_class;
+
+  void SetSocket(int fd, const UdpEgress& udp);  // socket owned by gst element since call
+
+  // connected, -1 on error
+  static int OpenSocket(const common::net::HostAndPort& host, const UdpEgress& udp, const SocketTuning& socket);
+};
+
+// nullptr if socket can't be opened
+ElementUDPBatchSink* make_udp_batch_sink(const common::net::HostAndPort& host,
+                                         const UdpEgress& udp,
+                                         const SocketTuning& socket,
+                                         element_id_t sink_id);
+
+}  // namespace sink
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -16,6 +16,8 @@
 
 #include <gst/app/gstappsrc.h>  // for GST_APP_SRC
 
+#include "stream/buffer_pool.h"
+
 namespace fastocloud {
 namespace stream {
 namespace elements {
@@ -25,10 +27,45 @@ gboolean ElementAppSrc::RegisterNeedDataCallback(need_data_callback_t cb, gpoint
   return RegisterCallback("need-data", G_CALLBACK(cb), user_data);
 }
 
+void ElementAppSrc::SetBufferPool(BufferPool* pool) {
+  pool_ = pool;
+}
+
+guint64 ElementAppSrc::GetMaxBytes() const {
+  return gst_app_src_get_max_bytes(GST_APP_SRC(GetGstElement()));
+}
+
+GstBuffer* ElementAppSrc::AcquireBuffer(guint rsize, gsize default_size) {
+  GstBuffer* buffer = nullptr;
+  gsize size = default_size;
+  if (pool_) {
+    buffer = pool_->Acquire();
+    size = pool_->GetBufferSize();
+  }
+
+  if (!buffer) {
+    buffer = gst_buffer_new_allocate(nullptr, default_size, nullptr);
+    size = default_size;
+  }
+
+  if (buffer && rsize != 0 && rsize < size) {
+    gst_buffer_set_size(buffer, rsize);
+  }
+  return buffer;
+}
+
 GstFlowReturn ElementAppSrc::PushBuffer(GstBuffer* buffer) {
   return gst_app_src_push_buffer(GST_APP_SRC(GetGstElement()), buffer);
 }
 
+GstFlowReturn ElementAppSrc::PushBufferList(GstBufferList* list) {
+  return gst_app_src_push_buffer_list(GST_APP_SRC(GetGstElement()), list);
+}
+
+guint64 ElementAppSrc::GetCurrentLevelBytes() const {
+  return gst_app_src_get_current_level_bytes(GST_APP_SRC(GetGstElement()));
+}
+
 void ElementAppSrc::SendEOS() {
   gst_app_src_end_of_stream(GST_APP_SRC(GetGstElement()));  // send  eos
 }
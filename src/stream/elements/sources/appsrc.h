@@ -18,6 +18,9 @@
 
 namespace fastocloud {
 namespace stream {
+
+class BufferPool;
+
 namespace elements {
 namespace sources {
 
@@ -27,10 +30,21 @@ class ElementAppSrc : public ElementBaseSrc<ELEMENT_APP_SRC> {
   typedef void (*need_data_callback_t)(GstElement* pipeline, guint size, gpointer user_data);
   using base_class::base_class;
 
+  void SetBufferPool(BufferPool* pool);  // not owned, should outlive pushes
+  guint64 GetMaxBytes() const;           // queue depth in bytes
+
+  // buffer for filling, size min(rsize, pool buffer size) if rsize not 0, allocated if no pool
+  GstBuffer* AcquireBuffer(guint rsize, gsize default_size);
+
   gboolean RegisterNeedDataCallback(need_data_callback_t cb, gpointer user_data) WARN_UNUSED_RESULT;
 
   GstFlowReturn PushBuffer(GstBuffer* buffer);
+  GstFlowReturn PushBufferList(GstBufferList* list);  // takes ownership of list
+  guint64 GetCurrentLevelBytes() const;
   void SendEOS();
+
+ private:
+  BufferPool* pool_ = nullptr;
 };
 
 ElementAppSrc* make_app_src(element_id_t input_id);
@@ -18,9 +18,11 @@
 
 #include "stream/elements/sources/filesrc.h"
 #include "stream/elements/sources/httpsrc.h"
+#include "stream/elements/sources/packetringsrc.h"
 #include "stream/elements/sources/rtmpsrc.h"
 #include "stream/elements/sources/srtsrc.h"
 #include "stream/elements/sources/tcpsrc.h"
+#include "stream/elements/sources/udpbatchsrc.h"
 #include "stream/elements/sources/udpsrc.h"
 
 namespace {
@@ -37,7 +39,12 @@ namespace stream {
 namespace elements {
 namespace sources {
 
-Element* make_src(const InputUri& uri, element_id_t input_id, gint timeout_secs) {
+Element* make_src(const InputUri& uri,
+                  element_id_t input_id,
+                  gint timeout_secs,
+                  const UdpIngest& udp,
+                  const SocketTuning& socket,
+                  const HttpTuning& http) {
   common::uri::Url url = uri.GetInput();
   common::uri::Url::scheme scheme = url.GetScheme();
   if (scheme == common::uri::Url::file) {
@@ -59,7 +66,8 @@ Element* make_src(const InputUri& uri, element_id_t input_id, gint timeout_secs)
       agent = std::string(kSafariUA);
     }
 
-    return make_http_src(url.GetUrl(), agent, uri.GetHttpProxyUrl(), timeout_secs, input_id);
+    const gint http_timeout = http.timeout ? http.timeout : timeout_secs;
+    return make_http_src(url.GetUrl(), agent, uri.GetHttpProxyUrl(), http_timeout, http.keep_alive, input_id);
   } else if (scheme == common::uri::Url::udp) {
     // udp://localhost:8080
     std::string host_str = url.GetHost();
@@ -68,7 +76,28 @@ Element* make_src(const InputUri& uri, element_id_t input_id, gint timeout_secs)
       NOTREACHED() << "Unknown input url: " << host_str;
       return nullptr;
     }
-    return make_udp_src(host, input_id);
+    UdpIngest ludp = udp;
+    if (socket.receive_buffer > 0) {
+      ludp.receive_buffer = socket.receive_buffer;
+    }
+    if (ludp.packet_ring) {
+      ElementPacketRingSrc* ring_src = make_packet_ring_src(host, input_id);
+      if (ring_src) {
+        return ring_src;
+      }
+    }
+    if (ludp.IsBatched()) {
+      ElementUDPBatchSrc* batch_src = make_udp_batch_src(host, ludp, socket.multicast_iface, input_id);
+      if (batch_src) {
+        return batch_src;
+      }
+      WARNING_LOG() << "Batched udp source can't be opened, using udpsrc: " << host_str;
+    }
+    ElementUDPSrc* udp_src = make_udp_src(host, ludp.receive_buffer, input_id);
+    if (!socket.multicast_iface.empty()) {
+      udp_src->SetMulticastIface(socket.multicast_iface);
+    }
+    return udp_src;
   } else if (scheme == common::uri::Url::rtmp) {
     return make_rtmp_src(url.GetUrl(), timeout_secs, input_id);
   } else if (scheme == common::uri::Url::tcp) {
@@ -20,14 +20,22 @@
 
 #include "stream/elements/element.h"
 
+#include "base/http_tuning.h"
 #include "base/input_uri.h"
+#include "base/socket_tuning.h"
 
 namespace fastocloud {
 namespace stream {
 namespace elements {
 namespace sources {
 
-Element* make_src(const InputUri& uri, element_id_t input_id, gint timeout_secs);
+// socket tuning overrides stream wide udp settings, http tuning applied to http inputs
+Element* make_src(const InputUri& uri,
+                  element_id_t input_id,
+                  gint timeout_secs,
+                  const UdpIngest& udp = UdpIngest(),
+                  const SocketTuning& socket = SocketTuning(),
+                  const HttpTuning& http = HttpTuning());
 
 }  // namespace sources
 }  // namespace elements
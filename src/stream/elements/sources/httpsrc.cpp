@@ -14,8 +14,35 @@
 
 #include "stream/elements/sources/httpsrc.h"
 
+#include <string>
 #include <vector>
 
+#include <common/macros.h>
+
+#include "base/gst_constants.h"
+
+namespace {
+void hls_source_added_callback(GstBin* bin, GstBin* sub_bin, GstElement* element, gpointer user_data) {
+  UNUSED(bin);
+  UNUSED(sub_bin);
+  const fastocloud::HttpTuning* http = static_cast<const fastocloud::HttpTuning*>(user_data);
+  if (fastocloud::stream::elements::Element::GetPluginName(element) != SOUP_HTTP_SRC) {
+    return;
+  }
+
+  g_object_set(element, "keep-alive", http->keep_alive, "timeout", http->timeout, nullptr);
+}
+
+void hls_tuning_destroy(gpointer user_data, GClosure* closure) {
+  UNUSED(closure);
+  delete static_cast<fastocloud::HttpTuning*>(user_data);
+}
+
+bool has_property(GstElement* element, const char* property) {
+  return g_object_class_find_property(G_OBJECT_GET_CLASS(element), property) != nullptr;
+}
+}  // namespace
+
 namespace fastocloud {
 namespace stream {
 namespace elements {
@@ -29,6 +56,10 @@ void ElementSoupHTTPSrc::SetTimeOut(gint secs) {
   SetProperty("timeout", secs);
 }
 
+void ElementSoupHTTPSrc::SetKeepAlive(bool keep_alive) {
+  SetProperty("keep-alive", keep_alive);
+}
+
 void ElementSoupHTTPSrc::SetUserAgent(const std::string& agent) {
   SetProperty("user-agent", agent);
 }
@@ -64,10 +95,14 @@ ElementSoupHTTPSrc* make_http_src(const std::string& location,
                                   const common::Optional<std::string>& user_agent,
                                   common::Optional<fastotv::HttpProxy> proxy,
                                   gint timeout_secs,
+                                  bool keep_alive,
                                   element_id_t input_id) {
   ElementSoupHTTPSrc* http_src = make_sources<ElementSoupHTTPSrc>(input_id);
   http_src->SetLocation(location);
   http_src->SetTimeOut(timeout_secs);
+  if (keep_alive) {
+    http_src->SetKeepAlive(true);
+  }
   if (user_agent) {
     http_src->SetUserAgent(*user_agent);
   }
@@ -86,6 +121,29 @@ ElementSoupHTTPSrc* make_http_src(const std::string& location,
   return http_src;
 }
 
+void apply_hls_tuning(GstElement* demux, const HttpTuning& http, gint timeout_secs) {
+  if (http.hls_bitrate) {
+    const guint bitrate = http.hls_bitrate * 1000;
+    if (has_property(demux, "max-bitrate")) {  // hlsdemux2, bits per second
+      g_object_set(demux, "max-bitrate", bitrate, "connection-bitrate", bitrate, nullptr);
+    } else if (has_property(demux, "connection-speed")) {  // kbps, fixed estimate keeps variant
+      g_object_set(demux, "connection-speed", static_cast<guint>(http.hls_bitrate), nullptr);
+    }
+  }
+
+  if (http.hls_buffer_msec && has_property(demux, "high-watermark-time")) {
+    const guint64 buffer_time = http.hls_buffer_msec * GST_MSECOND;
+    g_object_set(demux, "max-buffering-time", buffer_time, "high-watermark-time", buffer_time, nullptr);
+  }
+
+  if (http.keep_alive || http.timeout) {
+    HttpTuning* sources = new HttpTuning(http);
+    sources->timeout = http.timeout ? http.timeout : timeout_secs;
+    g_signal_connect_data(demux, "deep-element-added", G_CALLBACK(hls_source_added_callback), sources,
+                          hls_tuning_destroy, static_cast<GConnectFlags>(0));
+  }
+}
+
 }  // namespace sources
 }  // namespace elements
 }  // namespace stream
@@ -19,6 +19,8 @@
 
 #include <fastotv/types/http_proxy.h>
 
+#include "base/http_tuning.h"
+
 #include "stream/elements/sources/sources.h"  // for ElementLocation
 
 namespace fastocloud {
@@ -33,6 +35,7 @@ class ElementSoupHTTPSrc : public ElementLocation<ELEMENT_SOUP_HTTP_SRC> {
 
   void SetIsLive(bool live = false);  // Defaut: false
   void SetTimeOut(gint secs = 15);    // 0 - 3600 Default: 15
+  void SetKeepAlive(bool keep_alive = false);  // Default: false
   void SetUserAgent(const std::string& agent);
 
   void SetProxy(const common::uri::Url& url);
@@ -47,8 +50,13 @@ ElementSoupHTTPSrc* make_http_src(const std::string& location,
                                   const common::Optional<std::string>& user_agent,
                                   common::Optional<fastotv::HttpProxy> proxy,
                                   gint timeout_secs,
+                                  bool keep_alive,
                                   element_id_t input_id);
 
+// hls demuxer plugged by decodebin: variant pinning, buffering ahead for hlsdemux2,
+// keep-alive and timeout of segment sources of hlsdemux
+void apply_hls_tuning(GstElement* demux, const HttpTuning& http, gint timeout_secs);
+
 }  // namespace sources
 }  // namespace elements
 }  // namespace stream
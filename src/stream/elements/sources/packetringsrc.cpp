@@ -0,0 +1,119 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sources/packetringsrc.h"
+
+#include <chrono>
+#include <string>
+
+#include "stream/buffer_pool.h"
+#include "stream/gstreamer_utils.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sources {
+
+ElementPacketRingSrc::ElementPacketRingSrc(const std::string& name, const PacketRingShm* ring)
+    : base_class(name),
+      ring_(ring),
+      buffer_pool_(new BufferPool(PACKET_RING_SHM_SLOT_SIZE, batch_size * 2)),
+      stop_(false),
+      thread_() {
+  SetProperty("is-live", true);
+  SetProperty("format", GST_FORMAT_TIME);
+  SetProperty("do-timestamp", true);
+  if (buffer_pool_->Start()) {
+    SetBufferPool(buffer_pool_);
+  } else {
+    WARNING_LOG() << "Buffer pool can't be started, ring buffers will be allocated";
+  }
+  thread_ = std::thread(&ElementPacketRingSrc::ReceiveLoop, this);
+}
+
+ElementPacketRingSrc::~ElementPacketRingSrc() {
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  SetBufferPool(nullptr);
+  buffer_pool_->Stop();
+  delete buffer_pool_;
+  ignore_result(ClosePacketRingShm(ring_));
+}
+
+void ElementPacketRingSrc::ReceiveLoop() {
+  const guint64 max_bytes = GetMaxBytes();
+  uint64_t position = GetPacketRingPosition(ring_);  // live, backlog of ring not replayed
+  uint64_t overruns = 0;
+  while (!stop_) {
+    GstBufferList* list = nullptr;
+    for (guint i = 0; i < batch_size; ++i) {
+      GstBuffer* buffer = AcquireBuffer(0, PACKET_RING_SHM_SLOT_SIZE);
+      if (!buffer) {
+        break;
+      }
+
+      GstMapInfo map;
+      if (!gst_buffer_map(buffer, &map, GST_MAP_WRITE)) {
+        gst_buffer_unref(buffer);
+        break;
+      }
+
+      size_t size = 0;
+      PacketRingRead res = map.size >= PACKET_RING_SHM_SLOT_SIZE
+                               ? ReadPacketRing(ring_, &position, map.data, &size)
+                               : PACKET_RING_EMPTY;
+      gst_buffer_unmap(buffer, &map);
+      if (res != PACKET_RING_PACKET) {
+        gst_buffer_unref(buffer);
+        if (res == PACKET_RING_OVERRUN && overruns++ % 100 == 0) {
+          WARNING_LOG() << "Stream doesn't keep up with packet ring, overruns: " << overruns;
+        }
+        break;
+      }
+
+      gst_buffer_set_size(buffer, size);
+      if (!list) {
+        list = gst_buffer_list_new_sized(batch_size);
+      }
+      gst_buffer_list_add(list, buffer);
+    }
+
+    if (!list) {
+      std::this_thread::sleep_for(std::chrono::microseconds(idle_sleep_usec));
+      continue;
+    }
+
+    if (max_bytes && GetCurrentLevelBytes() >= max_bytes) {
+      gst_buffer_list_unref(list);  // pipeline doesn't keep up, live data dropped
+      continue;
+    }
+    PushBufferList(list);
+  }
+}
+
+ElementPacketRingSrc* make_packet_ring_src(const common::net::HostAndPort& host, element_id_t input_id) {
+  const PacketRingShm* ring = nullptr;
+  common::ErrnoError err = OpenPacketRingShm(MakePacketRingShmName(host.GetHost(), host.GetPort()), &ring);
+  if (err) {
+    return nullptr;
+  }
+  return new ElementPacketRingSrc(common::MemSPrintf(SRC_NAME_1U, input_id), ring);
+}
+
+}  // namespace sources
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,57 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <common/net/types.h>
+
+#include "base/packet_ring_shm.h"
+
+#include "stream/elements/sources/appsrc.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sources {
+
+// appsrc fed by own thread from shared memory ring of udp group written by packet ingest of daemon,
+// datagrams pushed as buffer lists, no socket of stream
+class ElementPacketRingSrc : public ElementAppSrc {
+ public:
+  typedef ElementAppSrc base_class;
+  enum { batch_size = 64, idle_sleep_usec = 1000 };
+
+  ElementPacketRingSrc(const std::string& name, const PacketRingShm* ring);  // ring mapping owned
+  ~ElementPacketRingSrc() override;
+
+ private:
+  void ReceiveLoop();
+
+  const PacketRingShm* const ring_;
+  BufferPool* const buffer_pool_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+};
+
+// nullptr if daemon has no ring of host
+ElementPacketRingSrc* make_packet_ring_src(const common::net::HostAndPort& host, element_id_t input_id);
+
+}  // namespace sources
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
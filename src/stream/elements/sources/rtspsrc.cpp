@@ -33,6 +33,10 @@ void ElementRTSPSrc::SetLatency(gint latency) {
   SetProperty("latency", latency);
 }
 
+void ElementRTSPSrc::SetProtocols(guint protocols) {
+  SetProperty("protocols", protocols);
+}
+
 ElementRTSPSrc* make_rtsp_src(const std::string& location, element_id_t input_id) {
   ElementRTSPSrc* rtsp_src = make_sources<ElementRTSPSrc>(input_id);
   rtsp_src->SetLocation(location);
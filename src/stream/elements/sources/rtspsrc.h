@@ -32,6 +32,7 @@ class ElementRTSPSrc : public ElementBinEx<ELEMENT_RTSP_SRC> {
   std::string GetLocation() const;
 
   void SetLatency(gint latency);
+  void SetProtocols(guint protocols);  // GstRTSPLowerTrans flags
 };
 
 ElementRTSPSrc* make_rtsp_src(const std::string& location, element_id_t input_id);
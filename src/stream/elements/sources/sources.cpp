@@ -14,10 +14,22 @@
 
 #include "stream/elements/sources/sources.h"
 
+#include <gst/gstutils.h>
+
 namespace fastocloud {
 namespace stream {
 namespace elements {
-namespace sources {}
+namespace sources {
+
+void ElementVideoTestSrc::SetPattern(const std::string& pattern) {
+  gst_util_set_object_arg(G_OBJECT(GetGstElement()), "pattern", pattern.c_str());
+}
+
+void ElementAudioTestSrc::SetWave(const std::string& wave) {
+  gst_util_set_object_arg(G_OBJECT(GetGstElement()), "wave", wave.c_str());
+}
+
+}  // namespace sources
 }  // namespace elements
 }  // namespace stream
 }  // namespace fastocloud
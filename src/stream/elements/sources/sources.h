@@ -41,9 +41,44 @@ class ElementPushSrc : public ElementBaseSrc<el> {
   using base_class::base_class;
 };
 
-typedef ElementPushSrc<ELEMENT_VIDEO_TEST_SRC> ElementVideoTestSrc;
-typedef ElementPushSrc<ELEMENT_AUDIO_TEST_SRC> ElementAudioTestSrc;
-typedef ElementPushSrc<ELEMENT_DISPLAY_SRC> ElementDisplayTestSrc;
+class ElementVideoTestSrc : public ElementPushSrc<ELEMENT_VIDEO_TEST_SRC> {
+ public:
+  typedef ElementPushSrc<ELEMENT_VIDEO_TEST_SRC> base_class;
+  using base_class::base_class;
+
+  void SetIsLive(bool live) { base_class::SetProperty("is-live", live); }  // Default: false, as fast as possible
+  void SetPattern(const std::string& pattern);                            // by nick, Default: smpte
+  void SetHorizontalSpeed(gint speed) { base_class::SetProperty("horizontal-speed", speed); }  // Default: 0
+};
+
+class ElementAudioTestSrc : public ElementPushSrc<ELEMENT_AUDIO_TEST_SRC> {
+ public:
+  typedef ElementPushSrc<ELEMENT_AUDIO_TEST_SRC> base_class;
+  using base_class::base_class;
+
+  void SetIsLive(bool live) { base_class::SetProperty("is-live", live); }  // Default: false, as fast as possible
+  void SetWave(const std::string& wave);                                  // by nick, Default: sine
+};
+
+class ElementDisplayTestSrc : public ElementPushSrc<ELEMENT_DISPLAY_SRC> {
+ public:
+  typedef ElementPushSrc<ELEMENT_DISPLAY_SRC> base_class;
+  using base_class::base_class;
+
+  // only damaged regions of X screen copied into frame
+  void SetUseDamage(bool damage) { base_class::SetProperty("use-damage", damage); }
+};
+
+// frames of compositor shared as dma-buf or memfd, sent only on damage
+class ElementPipeWireSrc : public ElementPushSrc<ELEMENT_PIPEWIRE_SRC> {
+ public:
+  typedef ElementPushSrc<ELEMENT_PIPEWIRE_SRC> base_class;
+  using base_class::base_class;
+
+  void SetTargetObject(const std::string& target) { base_class::SetProperty("target-object", target); }
+  void SetAlwaysCopy(bool copy) { base_class::SetProperty("always-copy", copy); }  // Default: false
+  void SetKeepaliveTime(gint msec) { base_class::SetProperty("keepalive-time", msec); }  // last frame resent, 0 off
+};
 
 template <SupportedElements el>
 class ElementLocation : public ElementPushSrc<el> {
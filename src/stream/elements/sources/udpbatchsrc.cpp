@@ -0,0 +1,226 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements/sources/udpbatchsrc.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#if defined(OS_LINUX)
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <common/convert2string.h>
+
+#include "stream/buffer_pool.h"
+#include "stream/gstreamer_utils.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sources {
+
+ElementUDPBatchSrc::ElementUDPBatchSrc(const std::string& name, int fd, const UdpIngest& udp)
+    : base_class(name),
+      fd_(fd),
+      batch_(udp.batch),
+      buffer_pool_(new BufferPool(datagram_size, udp.batch * 2)),
+      stop_(false),
+      thread_() {
+  SetProperty("is-live", true);
+  SetProperty("format", GST_FORMAT_TIME);
+  SetProperty("do-timestamp", true);
+  g_object_set_data(G_OBJECT(GetGstElement()), SOCKET_FD_DATA, GINT_TO_POINTER(fd + 1));
+  if (buffer_pool_->Start()) {
+    SetBufferPool(buffer_pool_);
+  } else {
+    WARNING_LOG() << "Buffer pool can't be started, udp buffers will be allocated";
+  }
+  thread_ = std::thread(&ElementUDPBatchSrc::ReceiveLoop, this);
+}
+
+ElementUDPBatchSrc::~ElementUDPBatchSrc() {
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  SetBufferPool(nullptr);
+  buffer_pool_->Stop();
+  delete buffer_pool_;
+#if defined(OS_LINUX)
+  close(fd_);
+#endif
+}
+
+int ElementUDPBatchSrc::OpenSocket(const common::net::HostAndPort& host,
+                                   const UdpIngest& udp,
+                                   const std::string& multicast_iface) {
+#if defined(OS_LINUX)
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  struct addrinfo* info = nullptr;
+  const std::string port = common::ConvertToString(host.GetPort());
+  if (getaddrinfo(host.GetHost().c_str(), port.c_str(), &hints, &info) != 0 || !info) {
+    return -1;
+  }
+
+  struct sockaddr_in addr;
+  memcpy(&addr, info->ai_addr, sizeof(addr));
+  freeaddrinfo(info);
+
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    return -1;
+  }
+
+  int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (udp.receive_buffer > 0 &&
+      setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &udp.receive_buffer, sizeof(udp.receive_buffer)) == -1) {
+    WARNING_LOG() << "Can't set udp receive buffer: " << udp.receive_buffer;
+  }
+#if defined(SO_BUSY_POLL)
+  if (udp.busy_poll_usec > 0 &&
+      setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &udp.busy_poll_usec, sizeof(udp.busy_poll_usec)) == -1) {
+    WARNING_LOG() << "Can't set udp busy poll: " << udp.busy_poll_usec;
+  }
+#endif
+
+  // multicast socket bound to group address, only its datagrams received
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
+    close(fd);
+    return -1;
+  }
+
+  if (IN_MULTICAST(ntohl(addr.sin_addr.s_addr))) {
+    struct ip_mreqn mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.imr_multiaddr = addr.sin_addr;
+    mreq.imr_address.s_addr = htonl(INADDR_ANY);
+    mreq.imr_ifindex = multicast_iface.empty() ? 0 : if_nametoindex(multicast_iface.c_str());
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == -1) {
+      close(fd);
+      return -1;
+    }
+  }
+  return fd;
+#else
+  UNUSED(host);
+  UNUSED(udp);
+  UNUSED(multicast_iface);
+  return -1;
+#endif
+}
+
+void ElementUDPBatchSrc::ReceiveLoop() {
+#if defined(OS_LINUX)
+  std::vector<GstBuffer*> buffers(batch_, nullptr);
+  std::vector<GstMapInfo> maps(batch_);
+  std::vector<struct iovec> iovs(batch_);
+  std::vector<struct mmsghdr> msgs(batch_);
+  const guint64 max_bytes = GetMaxBytes();
+  bool truncated_logged = false;
+  while (!stop_) {
+    struct pollfd pfd;
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, poll_timeout_msec) <= 0) {
+      continue;  // timeout to check stop
+    }
+
+    size_t prepared = 0;
+    for (; prepared < batch_; ++prepared) {
+      if (!buffers[prepared]) {
+        GstBuffer* buffer = AcquireBuffer(0, datagram_size);
+        if (!buffer) {
+          break;
+        }
+
+        if (!gst_buffer_map(buffer, &maps[prepared], GST_MAP_WRITE)) {
+          gst_buffer_unref(buffer);
+          break;
+        }
+        buffers[prepared] = buffer;
+      }
+
+      iovs[prepared].iov_base = maps[prepared].data;
+      iovs[prepared].iov_len = maps[prepared].size;
+      memset(&msgs[prepared], 0, sizeof(struct mmsghdr));
+      msgs[prepared].msg_hdr.msg_iov = &iovs[prepared];
+      msgs[prepared].msg_hdr.msg_iovlen = 1;
+    }
+
+    if (prepared == 0) {
+      continue;
+    }
+
+    const int count = recvmmsg(fd_, msgs.data(), prepared, MSG_DONTWAIT, nullptr);
+    if (count <= 0) {
+      continue;
+    }
+
+    GstBufferList* list = gst_buffer_list_new_sized(count);
+    for (int i = 0; i < count; ++i) {
+      if ((msgs[i].msg_hdr.msg_flags & MSG_TRUNC) && !truncated_logged) {
+        WARNING_LOG() << "Udp datagram truncated to " << maps[i].size << " bytes";
+        truncated_logged = true;
+      }
+      gst_buffer_unmap(buffers[i], &maps[i]);
+      gst_buffer_set_size(buffers[i], msgs[i].msg_len);
+      gst_buffer_list_add(list, buffers[i]);
+      buffers[i] = nullptr;
+    }
+
+    if (max_bytes && GetCurrentLevelBytes() >= max_bytes) {
+      gst_buffer_list_unref(list);  // pipeline doesn't keep up, live data dropped
+      continue;
+    }
+    PushBufferList(list);
+  }
+
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    if (buffers[i]) {
+      gst_buffer_unmap(buffers[i], &maps[i]);
+      gst_buffer_unref(buffers[i]);
+    }
+  }
+#endif
+}
+
+ElementUDPBatchSrc* make_udp_batch_src(const common::net::HostAndPort& host,
+                                       const UdpIngest& udp,
+                                       const std::string& multicast_iface,
+                                       element_id_t input_id) {
+  const int fd = ElementUDPBatchSrc::OpenSocket(host, udp, multicast_iface);
+  if (fd == -1) {
+    return nullptr;
+  }
+  return new ElementUDPBatchSrc(common::MemSPrintf(SRC_NAME_1U, input_id), fd, udp);
+}
+
+}  // namespace sources
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,63 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <common/net/types.h>
+
+#include "stream/stypes.h"
+
+#include "stream/elements/sources/appsrc.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sources {
+
+// appsrc fed by own thread, up to batch datagrams received by one recvmmsg and pushed as buffer list, linux only
+class ElementUDPBatchSrc : public ElementAppSrc {
+ public:
+  typedef ElementAppSrc base_class;
+  enum { datagram_size = 2048, poll_timeout_msec = 100 };  // 7x188 ts packets with rtp header fit
+
+  ElementUDPBatchSrc(const std::string& name, int fd, const UdpIngest& udp);  // socket owned
+  ~ElementUDPBatchSrc() override;
+
+  // multicast group joined on iface if not empty, -1 on error
+  static int OpenSocket(const common::net::HostAndPort& host, const UdpIngest& udp, const std::string& multicast_iface);
+
+ private:
+  void ReceiveLoop();
+
+  const int fd_;
+  const size_t batch_;
+  BufferPool* const buffer_pool_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+};
+
+// nullptr if socket can't be opened
+ElementUDPBatchSrc* make_udp_batch_src(const common::net::HostAndPort& host,
+                                       const UdpIngest& udp,
+                                       const std::string& multicast_iface,
+                                       element_id_t input_id);
+
+}  // namespace sources
+}  // namespace elements
+}  // namespace stream
+}  // namespace fastocloud
@@ -31,10 +31,21 @@ void ElementUDPSrc::SetPort(uint16_t port) {
   SetProperty("port", port);
 }
 
-ElementUDPSrc* make_udp_src(const common::net::HostAndPort& host, element_id_t input_id) {
+void ElementUDPSrc::SetBufferSize(gint size) {
+  SetProperty("buffer-size", size);
+}
+
+void ElementUDPSrc::SetMulticastIface(const std::string& iface) {
+  SetProperty("multicast-iface", iface);
+}
+
+ElementUDPSrc* make_udp_src(const common::net::HostAndPort& host, gint buffer_size, element_id_t input_id) {
   ElementUDPSrc* udpsrc = make_sources<ElementUDPSrc>(input_id);
   udpsrc->SetAddress(host.GetHost());
   udpsrc->SetPort(host.GetPort());
+  if (buffer_size > 0) {
+    udpsrc->SetBufferSize(buffer_size);
+  }
   return udpsrc;
 }
 
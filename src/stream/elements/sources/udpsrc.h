@@ -33,9 +33,11 @@ class ElementUDPSrc : public ElementPushSrc<ELEMENT_UDP_SRC> {
   void SetAddress(const std::string& host);
   void SetPort(uint16_t port);
   void SetUri(const std::string& uri = "udp://0.0.0.0:5004");  // String. Default: "udp://0.0.0.0:5004"
+  void SetBufferSize(gint size = 0);                            // Range: 0 - 2147483647 Default: 0
+  void SetMulticastIface(const std::string& iface);             // String. Default: null
 };
 
-ElementUDPSrc* make_udp_src(const common::net::HostAndPort& host, element_id_t input_id);
+ElementUDPSrc* make_udp_src(const common::net::HostAndPort& host, gint buffer_size, element_id_t input_id);
 
 }  // namespace sources
 }  // namespace elements
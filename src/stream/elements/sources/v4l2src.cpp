@@ -23,6 +23,10 @@ void ElementV4L2Src::SetDevice(const std::string& device) {
   SetProperty("device", device);
 }
 
+void ElementV4L2Src::SetIoMode(int mode) {
+  SetProperty("io-mode", mode);
+}
+
 ElementV4L2Src* make_v4l2_src(const std::string& device, element_id_t input_id) {
   ElementV4L2Src* v4l2sr = make_sources<ElementV4L2Src>(input_id);
   v4l2sr->SetDevice(device);
@@ -29,6 +29,7 @@ class ElementV4L2Src : public ElementPushSrc<ELEMENT_V4L2_SRC> {
   using base_class::base_class;
 
   void SetDevice(const std::string& device = "/dev/video0");  // Default value: "/dev/video0"
+  void SetIoMode(int mode = 0);  // 0 auto, 1 rw, 2 mmap, 3 userptr, 4 dmabuf, 5 dmabuf-import; Default: 0
 };
 
 ElementV4L2Src* make_v4l2_src(const std::string& device, element_id_t input_id);
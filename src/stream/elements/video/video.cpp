@@ -14,7 +14,12 @@
 
 #include "stream/elements/video/video.h"
 
+#include <gst/gst.h>
+
+#include <common/sprintf.h>
+
 #define DEINTERLACE_METHOD 5
+#define RENDER_PICTURE_TIMEOUT_SEC 5
 
 // https://gstreamer.freedesktop.org/data/doc/gstreamer/head/gst-plugins-good-plugins/html/gst-plugins-good-plugins-deinterlace.html
 
@@ -88,6 +93,39 @@ Element* make_video_deinterlace(const std::string& deinterlace, const std::strin
   return nullptr;
 }
 
+bool render_picture(const std::string& picture_path, gint width, gint height, const std::string& png_path) {
+  std::string size_caps;
+  if (width > 0 && height > 0) {
+    size_caps = common::MemSPrintf("video/x-raw,width=%d,height=%d ! ", width, height);
+  }
+  const std::string desc = common::MemSPrintf(
+      "filesrc location=\"%s\" ! decodebin ! videoconvert ! videoscale ! %svideoconvert ! pngenc "
+      "compression-level=0 snapshot=true ! filesink location=\"%s\"",
+      picture_path, size_caps, png_path);
+  GError* err = nullptr;
+  GstElement* pipeline = gst_parse_launch(desc.c_str(), &err);
+  if (err) {
+    g_error_free(err);
+    if (pipeline) {
+      gst_object_unref(pipeline);
+    }
+    return false;
+  }
+
+  gst_element_set_state(pipeline, GST_STATE_PLAYING);
+  GstBus* bus = gst_element_get_bus(pipeline);
+  GstMessage* msg = gst_bus_timed_pop_filtered(bus, RENDER_PICTURE_TIMEOUT_SEC * GST_SECOND,
+                                               static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  const bool res = msg && GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS;
+  if (msg) {
+    gst_message_unref(msg);
+  }
+  gst_object_unref(bus);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+  return res;
+}
+
 gboolean ElementCairoOverlay::RegisterDrawCallback(draw_callback_t cb, gpointer user_data) {
   return RegisterCallback("draw", G_CALLBACK(cb), user_data);
 }
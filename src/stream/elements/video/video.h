@@ -69,10 +69,19 @@ class ElementDeinterlace : public ElementEx<ELEMENT_DEINTERLACE> {
 
 Element* make_video_deinterlace(const std::string& deinterlace, const std::string& name);
 
+// decodes picture (png, jpeg, svg) into uncompressed png once, size 0 - size of picture,
+// result blended by gdkpixbufoverlay instead of rendering svg or scaling on every start
+bool render_picture(const std::string& picture_path, gint width, gint height, const std::string& png_path);
+
 typedef ElementEx<ELEMENT_AUTO_VIDEO_CONVERT> ElementAutoVideoConvert;
 typedef ElementEx<ELEMENT_VIDEO_CONVERT> ElementVideoConvert;
 typedef ElementEx<ELEMENT_VIDEO_SCALE> ElementVideoScale;
 typedef ElementEx<ELEMENT_VIDEO_RATE> ElementVideoRate;
+typedef ElementEx<ELEMENT_CUDA_UPLOAD> ElementCudaUpload;
+typedef ElementEx<ELEMENT_CUDA_CONVERT> ElementCudaConvert;
+typedef ElementEx<ELEMENT_CUDA_SCALE> ElementCudaScale;
+typedef ElementEx<ELEMENT_CUDA_COMPOSITOR> ElementCudaCompositor;  // memory:CUDAMemory tiles
+typedef ElementEx<ELEMENT_VAAPI_OVERLAY> ElementVaapiOverlay;      // memory:VASurface tiles
 
 class ElementAspectRatio : public ElementEx<ELEMENT_ASPECT_RATIO> {
  public:
@@ -0,0 +1,118 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements_pool.h"
+
+#include <utility>
+#include <vector>
+
+namespace fastocloud {
+namespace stream {
+
+ElementsPool::ElementsPool() : mutex_(), tracked_(), parked_() {}
+
+ElementsPool::~ElementsPool() {
+  Clear();
+}
+
+GstElement* ElementsPool::Acquire(const std::string& key) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto it = parked_.find(key);
+  if (it == parked_.end()) {
+    return nullptr;
+  }
+
+  GstElement* element = it->second;
+  parked_.erase(it);
+  // added to bin as new element, bin sinks pool reference
+  g_object_force_floating(G_OBJECT(element));
+  return element;
+}
+
+void ElementsPool::Track(GstElement* element, const std::string& key) {
+  if (!element) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  tracked_[element] = key;
+}
+
+void ElementsPool::Untrack(GstElement* element) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  tracked_.erase(element);
+}
+
+size_t ElementsPool::Park(GstBin* pipeline) {
+  std::vector<GstElement*> stale;
+  std::vector<std::pair<std::string, GstElement*>> parked;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (const auto& element : parked_) {
+      stale.push_back(element.second);
+    }
+    parked_.clear();
+
+    for (const auto& element : tracked_) {
+      if (GST_OBJECT_PARENT(element.first) == GST_OBJECT(pipeline)) {
+        parked.push_back(std::make_pair(element.second, element.first));
+      }
+    }
+    tracked_.clear();
+  }
+
+  for (GstElement* element : stale) {
+    ReleaseElement(element);
+  }
+
+  size_t count = 0;
+  for (const auto& element : parked) {
+    GstElement* gst = element.second;
+    gst_object_ref(gst);
+    // bin unlinks pads, state of removed element not changed
+    if (!gst_bin_remove(pipeline, gst) || gst_element_set_state(gst, GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+      ReleaseElement(gst);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    parked_.insert(element);
+    count++;
+  }
+  return count;
+}
+
+void ElementsPool::Clear() {
+  std::vector<GstElement*> parked;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (const auto& element : parked_) {
+      parked.push_back(element.second);
+    }
+    parked_.clear();
+    tracked_.clear();
+  }
+
+  for (GstElement* element : parked) {
+    ReleaseElement(element);
+  }
+}
+
+void ElementsPool::ReleaseElement(GstElement* element) {
+  gst_element_set_state(element, GST_STATE_NULL);
+  gst_object_unref(element);
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,54 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <gst/gst.h>
+
+#include <common/patterns/singleton_pattern.h>
+
+namespace fastocloud {
+namespace stream {
+
+// encoders of last pipeline of this process kept at ready state after stream destroyed,
+// next start of stream with same encoder config takes them back without reopening hardware session
+class ElementsPool : public common::patterns::LazySingleton<ElementsPool> {
+ public:
+  friend class common::patterns::LazySingleton<ElementsPool>;
+
+  GstElement* Acquire(const std::string& key);  // floating reference to parked element, nullptr if no such
+  void Track(GstElement* element, const std::string& key);  // element of running pipeline, parked on destroy
+  void Untrack(GstElement* element);
+
+  // tracked elements removed from pipeline at ready state, parked before and not acquired released
+  size_t Park(GstBin* pipeline);
+  void Clear();
+
+ private:
+  ElementsPool();
+  ~ElementsPool();
+
+  static void ReleaseElement(GstElement* element);
+
+  std::mutex mutex_;
+  std::map<GstElement*, std::string> tracked_;
+  std::multimap<std::string, GstElement*> parked_;
+};
+
+}  // namespace stream
+}  // namespace fastocloud
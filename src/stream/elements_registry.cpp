@@ -0,0 +1,50 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/elements_registry.h"
+
+#include <algorithm>
+
+namespace fastocloud {
+namespace stream {
+
+ElementsRegistry::ElementsRegistry() : elements_() {}
+
+void ElementsRegistry::Register(ElementRole role, element_id_t id, elements::Element* elem) {
+  std::vector<elements::Element*>& line = elements_[role];
+  if (line.size() <= id) {
+    line.resize(id + 1, nullptr);
+  }
+  line[id] = elem;
+}
+
+void ElementsRegistry::Unregister(elements::Element* elem) {
+  for (std::vector<elements::Element*>& line : elements_) {
+    std::replace(line.begin(), line.end(), elem, static_cast<elements::Element*>(nullptr));
+  }
+}
+
+elements::Element* ElementsRegistry::Find(ElementRole role, element_id_t id) const {
+  const std::vector<elements::Element*>& line = elements_[role];
+  return id < line.size() ? line[id] : nullptr;
+}
+
+void ElementsRegistry::Clear() {
+  for (std::vector<elements::Element*>& line : elements_) {
+    line.clear();
+  }
+}
+
+}  // namespace stream
+}  // namespace fastocloud
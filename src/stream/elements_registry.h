@@ -0,0 +1,58 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "stream/stypes.h"
+
+namespace fastocloud {
+namespace stream {
+
+namespace elements {
+class Element;
+}
+
+// elements found from pad-added handlers and live changes, names of them only for debugging
+enum ElementRole {
+  UDB_VIDEO_ROLE = 0,
+  UDB_AUDIO_ROLE,
+  UDB_VIDEO_PASSTHROUGH_ROLE,
+  UDB_AUDIO_PASSTHROUGH_ROLE,
+  DECODEBIN_ROLE,
+  INGEST_TEE_ROLE,
+  SPLIT_SINK_ROLE,
+  VIDEO_TEE_ROLE,  // outputs attached to running pipeline
+  AUDIO_TEE_ROLE,
+  ELEMENT_ROLES_COUNT
+};
+
+// pipeline elements by role and id, lookups without allocations from streaming threads
+class ElementsRegistry {
+ public:
+  ElementsRegistry();
+
+  void Register(ElementRole role, element_id_t id, elements::Element* elem);
+  void Unregister(elements::Element* elem);  // removed from pipeline
+  elements::Element* Find(ElementRole role, element_id_t id) const;  // nullptr if not registered
+  void Clear();
+
+ private:
+  std::array<std::vector<elements::Element*>, ELEMENT_ROLES_COUNT> elements_;  // indexed by id
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,117 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/encoder_warmup.h"
+
+#include <common/logger.h>
+
+#define ENCODER_WARMUP_CAPS_DATA "fastocloud-warmup-caps"
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+void warm_up_encoder(GstElement* encoder, gpointer user_data) {
+  GstCaps* caps = static_cast<GstCaps*>(user_data);
+  GstPad* pad = gst_element_get_static_pad(encoder, "sink");
+  if (!pad) {
+    return;
+  }
+
+  // under stream lock nothing of upstream passes in between, streaming already started if caps set
+  GST_PAD_STREAM_LOCK(pad);
+  if (!gst_pad_has_current_caps(pad)) {
+    gchar* stream_id = gst_pad_create_stream_id(pad, encoder, "warmup");
+    gboolean res = gst_pad_send_event(pad, gst_event_new_stream_start(stream_id));
+    g_free(stream_id);
+    if (res) {
+      res = gst_pad_send_event(pad, gst_event_new_caps(caps));
+    }
+    if (!res) {
+      WARNING_LOG() << "Warm up of encoder " << GST_ELEMENT_NAME(encoder) << " failed";
+    }
+  }
+  GST_PAD_STREAM_UNLOCK(pad);
+  gst_object_unref(pad);
+}
+
+void unref_caps(gpointer caps) {
+  gst_caps_unref(static_cast<GstCaps*>(caps));
+}
+}  // namespace
+
+GstCaps* make_encoder_warmup_caps(GstElement* encoder,
+                                  const std::string& cached_caps,
+                                  const common::draw::Size& size,
+                                  int framerate) {
+  GstPad* pad = gst_element_get_static_pad(encoder, "sink");
+  if (!pad) {
+    return nullptr;
+  }
+
+  GstCaps* accepted = gst_pad_query_caps(pad, nullptr);
+  gst_object_unref(pad);
+  GstCaps* caps = nullptr;
+  if (!cached_caps.empty()) {
+    caps = gst_caps_from_string(cached_caps.c_str());
+    if (caps && (!gst_caps_is_fixed(caps) || !gst_caps_can_intersect(caps, accepted))) {
+      gst_caps_unref(caps);
+      caps = nullptr;
+    }
+  }
+
+  if (!caps && size.IsValid() && framerate > 0) {
+    GstCaps* filter = gst_caps_new_simple("video/x-raw", "width", G_TYPE_INT, size.width, "height", G_TYPE_INT,
+                                          size.height, "framerate", GST_TYPE_FRACTION, framerate, 1, nullptr);
+    caps = gst_caps_intersect_full(filter, accepted, GST_CAPS_INTERSECT_FIRST);
+    gst_caps_unref(filter);
+    if (gst_caps_is_empty(caps)) {
+      gst_caps_unref(caps);
+      caps = nullptr;
+    } else {
+      caps = gst_caps_fixate(caps);  // first format of encoder, also picked by converter upstream
+    }
+  }
+  gst_caps_unref(accepted);
+  return caps;
+}
+
+void set_encoder_warmup_caps(GstElement* encoder, GstCaps* caps) {
+  g_object_set_data_full(G_OBJECT(encoder), ENCODER_WARMUP_CAPS_DATA, caps, unref_caps);
+}
+
+bool start_encoder_warmup(GstMessage* message) {
+  if (GST_MESSAGE_TYPE(message) != GST_MESSAGE_STATE_CHANGED || !GST_IS_ELEMENT(GST_MESSAGE_SRC(message))) {
+    return false;
+  }
+
+  GstState old_state, new_state;
+  gst_message_parse_state_changed(message, &old_state, &new_state, nullptr);
+  if (old_state != GST_STATE_READY || new_state != GST_STATE_PAUSED) {
+    return false;
+  }
+
+  GstElement* encoder = GST_ELEMENT(GST_MESSAGE_SRC(message));
+  gpointer caps = g_object_steal_data(G_OBJECT(encoder), ENCODER_WARMUP_CAPS_DATA);
+  if (!caps) {
+    return false;
+  }
+
+  // pool thread opens session, pipeline goes on to source meanwhile
+  gst_element_call_async(encoder, warm_up_encoder, caps, unref_caps);
+  return true;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
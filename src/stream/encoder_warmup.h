@@ -0,0 +1,39 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <gst/gst.h>
+
+#include <common/draw/types.h>
+
+namespace fastocloud {
+namespace stream {
+
+// hardware encoders open session and allocate surfaces on first caps, so first segment of fresh start was late,
+// caps known ahead are sent to encoder as soon as its pads are active, while source still connects,
+// equal caps from upstream later negotiate nothing again
+
+// fixed raw caps accepted by encoder: cached ones if valid, else size and framerate of config, nullptr if unknown
+GstCaps* make_encoder_warmup_caps(GstElement* encoder,
+                                  const std::string& cached_caps,
+                                  const common::draw::Size& size,
+                                  int framerate);
+void set_encoder_warmup_caps(GstElement* encoder, GstCaps* caps);  // takes caps, sent once encoder paused
+bool start_encoder_warmup(GstMessage* message);                    // sync bus state changed, true if started
+
+}  // namespace stream
+}  // namespace fastocloud
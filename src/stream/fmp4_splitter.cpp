@@ -0,0 +1,475 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/fmp4_splitter.h"
+
+#include <common/sprintf.h>
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+
+constexpr uint32_t fourcc(char a, char b, char c, char d) {
+  return (static_cast<uint32_t>(a) << 24) | (static_cast<uint32_t>(b) << 16) | (static_cast<uint32_t>(c) << 8) |
+         static_cast<uint32_t>(d);
+}
+
+const uint32_t kFtyp = fourcc('f', 't', 'y', 'p');
+const uint32_t kMoov = fourcc('m', 'o', 'o', 'v');
+const uint32_t kMoof = fourcc('m', 'o', 'o', 'f');
+const uint32_t kMdat = fourcc('m', 'd', 'a', 't');
+const uint32_t kTrak = fourcc('t', 'r', 'a', 'k');
+const uint32_t kTkhd = fourcc('t', 'k', 'h', 'd');
+const uint32_t kMdia = fourcc('m', 'd', 'i', 'a');
+const uint32_t kMdhd = fourcc('m', 'd', 'h', 'd');
+const uint32_t kMinf = fourcc('m', 'i', 'n', 'f');
+const uint32_t kStbl = fourcc('s', 't', 'b', 'l');
+const uint32_t kStsd = fourcc('s', 't', 's', 'd');
+const uint32_t kMvex = fourcc('m', 'v', 'e', 'x');
+const uint32_t kTrex = fourcc('t', 'r', 'e', 'x');
+const uint32_t kTraf = fourcc('t', 'r', 'a', 'f');
+const uint32_t kTfhd = fourcc('t', 'f', 'h', 'd');
+const uint32_t kTrun = fourcc('t', 'r', 'u', 'n');
+const uint32_t kAvcC = fourcc('a', 'v', 'c', 'C');
+const uint32_t kHvcC = fourcc('h', 'v', 'c', 'C');
+const uint32_t kEsds = fourcc('e', 's', 'd', 's');
+
+const size_t kBoxHeaderSize = 8;
+const size_t kVisualSampleEntrySize = 78;  // after box header
+const size_t kAudioSampleEntrySize = 28;
+
+uint32_t read_u32(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+uint64_t read_u64(const uint8_t* data) {
+  return (static_cast<uint64_t>(read_u32(data)) << 32) | read_u32(data + 4);
+}
+
+// box at begin of data, false if not complete
+bool get_box_size(const uint8_t* data, size_t size, size_t* box_size, size_t* header_size) {
+  if (size < kBoxHeaderSize) {
+    return false;
+  }
+  uint64_t lbox_size = read_u32(data);
+  size_t lheader_size = kBoxHeaderSize;
+  if (lbox_size == 1) {
+    if (size < kBoxHeaderSize + 8) {
+      return false;
+    }
+    lbox_size = read_u64(data + kBoxHeaderSize);
+    lheader_size += 8;
+  } else if (lbox_size == 0) {  // up to end, never complete in stream
+    return false;
+  }
+  if (lbox_size < lheader_size) {
+    return false;
+  }
+  *box_size = lbox_size;
+  *header_size = lheader_size;
+  return true;
+}
+
+class BoxIterator {
+ public:
+  BoxIterator(const uint8_t* data, size_t size) : data_(data), size_(size), offset_(0) {}
+
+  bool Next(uint32_t* type, const uint8_t** payload, size_t* payload_size) {
+    size_t box_size = 0;
+    size_t header_size = 0;
+    if (!get_box_size(data_ + offset_, size_ - offset_, &box_size, &header_size) || box_size > size_ - offset_) {
+      return false;
+    }
+    *type = read_u32(data_ + offset_ + 4);
+    *payload = data_ + offset_ + header_size;
+    *payload_size = box_size - header_size;
+    offset_ += box_size;
+    return true;
+  }
+
+ private:
+  const uint8_t* const data_;
+  const size_t size_;
+  size_t offset_;
+};
+
+bool find_box(const uint8_t* data, size_t size, uint32_t type, const uint8_t** payload, size_t* payload_size) {
+  BoxIterator it(data, size);
+  uint32_t ltype;
+  while (it.Next(&ltype, payload, payload_size)) {
+    if (ltype == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string fourcc_to_string(uint32_t type) {
+  std::string result;
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    result += static_cast<char>((type >> shift) & 0xFF);
+  }
+  return result;
+}
+
+std::string hevc_codec(const std::string& prefix, const uint8_t* hvcc, size_t size) {
+  if (size < 13) {
+    return prefix;
+  }
+  const uint8_t profile_space = hvcc[1] >> 6;
+  const bool high_tier = hvcc[1] & 0x20;
+  const uint8_t profile_idc = hvcc[1] & 0x1F;
+  const uint32_t compat = read_u32(hvcc + 2);
+  uint32_t reversed = 0;
+  for (int i = 0; i < 32; ++i) {
+    reversed |= ((compat >> i) & 1) << (31 - i);
+  }
+
+  std::string result = prefix + ".";
+  if (profile_space) {
+    result += static_cast<char>('A' + profile_space - 1);
+  }
+  result += common::MemSPrintf("%u.%X.%c%u", profile_idc, reversed, high_tier ? 'H' : 'L', hvcc[12]);
+  int last = 5;
+  while (last >= 0 && hvcc[6 + last] == 0) {
+    last--;
+  }
+  for (int i = 0; i <= last; ++i) {
+    result += common::MemSPrintf(".%X", hvcc[6 + i]);
+  }
+  return result;
+}
+
+// descriptor length, 7 bits per byte
+bool read_descriptor(const uint8_t* data, size_t size, size_t* offset, uint8_t* tag, size_t* length) {
+  if (*offset >= size) {
+    return false;
+  }
+  *tag = data[(*offset)++];
+  size_t llength = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (*offset >= size) {
+      return false;
+    }
+    const uint8_t byte = data[(*offset)++];
+    llength = (llength << 7) | (byte & 0x7F);
+    if (!(byte & 0x80)) {
+      break;
+    }
+  }
+  *length = llength;
+  return true;
+}
+
+std::string aac_codec(const uint8_t* esds, size_t size) {
+  static const std::string default_codec = "mp4a.40.2";
+  size_t offset = 4;  // version, flags
+  uint8_t tag;
+  size_t length;
+  if (!read_descriptor(esds, size, &offset, &tag, &length) || tag != 0x03) {
+    return default_codec;
+  }
+  if (offset + 3 > size) {
+    return default_codec;
+  }
+  const uint8_t flags = esds[offset + 2];
+  offset += 3;
+  if (flags & 0x80) {
+    offset += 2;
+  }
+  if (flags & 0x40) {
+    if (offset >= size) {
+      return default_codec;
+    }
+    offset += 1 + esds[offset];
+  }
+  if (flags & 0x20) {
+    offset += 2;
+  }
+  if (!read_descriptor(esds, size, &offset, &tag, &length) || tag != 0x04 || offset + 13 > size) {
+    return default_codec;
+  }
+  const uint8_t object_type = esds[offset];
+  offset += 13;
+  if (object_type != 0x40) {
+    return common::MemSPrintf("mp4a.%02X", object_type);
+  }
+  if (!read_descriptor(esds, size, &offset, &tag, &length) || tag != 0x05 || offset >= size) {
+    return default_codec;
+  }
+  return common::MemSPrintf("mp4a.40.%u", esds[offset] >> 3);
+}
+
+std::string sample_entry_codec(const uint8_t* stsd, size_t size) {
+  if (size < 8) {
+    return std::string();
+  }
+  BoxIterator entries(stsd + 8, size - 8);  // version, flags, entry count
+  uint32_t type;
+  const uint8_t* entry;
+  size_t entry_size;
+  if (!entries.Next(&type, &entry, &entry_size)) {
+    return std::string();
+  }
+
+  const std::string name = fourcc_to_string(type);
+  const uint8_t* config;
+  size_t config_size;
+  if (type == fourcc('a', 'v', 'c', '1') || type == fourcc('a', 'v', 'c', '3')) {
+    if (entry_size > kVisualSampleEntrySize &&
+        find_box(entry + kVisualSampleEntrySize, entry_size - kVisualSampleEntrySize, kAvcC, &config, &config_size) &&
+        config_size >= 4) {
+      return common::MemSPrintf("%s.%02X%02X%02X", name, config[1], config[2], config[3]);
+    }
+  } else if (type == fourcc('h', 'v', 'c', '1') || type == fourcc('h', 'e', 'v', '1')) {
+    if (entry_size > kVisualSampleEntrySize &&
+        find_box(entry + kVisualSampleEntrySize, entry_size - kVisualSampleEntrySize, kHvcC, &config, &config_size)) {
+      return hevc_codec(name, config, config_size);
+    }
+  } else if (type == fourcc('m', 'p', '4', 'a')) {
+    if (entry_size > kAudioSampleEntrySize &&
+        find_box(entry + kAudioSampleEntrySize, entry_size - kAudioSampleEntrySize, kEsds, &config, &config_size)) {
+      return aac_codec(config, config_size);
+    }
+    return "mp4a.40.2";
+  } else if (type == fourcc('O', 'p', 'u', 's')) {
+    return "opus";
+  }
+  return name;
+}
+
+}  // namespace
+
+Fmp4Splitter::Fmp4Splitter()
+    : pending_(),
+      init_(),
+      have_init_(false),
+      fragment_(),
+      fragment_open_(false),
+      fragment_duration_(0),
+      fragments_(),
+      tracks_(),
+      codecs_() {}
+
+void Fmp4Splitter::Feed(const uint8_t* data, size_t size) {
+  pending_.insert(pending_.end(), data, data + size);
+  size_t offset = 0;
+  while (true) {
+    size_t box_size = 0;
+    size_t header_size = 0;
+    if (!get_box_size(pending_.data() + offset, pending_.size() - offset, &box_size, &header_size) ||
+        box_size > pending_.size() - offset) {
+      break;
+    }
+    HandleBox(pending_.data() + offset, box_size);
+    offset += box_size;
+  }
+  pending_.erase(pending_.begin(), pending_.begin() + offset);
+}
+
+bool Fmp4Splitter::HaveInit() const {
+  return have_init_;
+}
+
+const Fmp4Splitter::bytes_t& Fmp4Splitter::GetInit() const {
+  return init_;
+}
+
+std::string Fmp4Splitter::GetCodecs() const {
+  std::string result;
+  for (const std::string& codec : codecs_) {
+    if (!result.empty()) {
+      result += ",";
+    }
+    result += codec;
+  }
+  return result;
+}
+
+bool Fmp4Splitter::PopFragment(Fragment* fragment) {
+  if (fragments_.empty()) {
+    return false;
+  }
+  *fragment = fragments_.front();
+  fragments_.erase(fragments_.begin());
+  return true;
+}
+
+void Fmp4Splitter::HandleBox(const uint8_t* box, size_t size) {
+  const uint32_t type = read_u32(box + 4);
+  if (type == kFtyp) {  // new stream
+    init_.assign(box, box + size);
+    have_init_ = false;
+    fragment_open_ = false;
+    tracks_.clear();
+    codecs_.clear();
+  } else if (type == kMoov) {
+    init_.insert(init_.end(), box, box + size);
+    size_t box_size = 0;
+    size_t header_size = 0;
+    get_box_size(box, size, &box_size, &header_size);
+    ParseMoov(box + header_size, size - header_size);
+    have_init_ = true;
+  } else if (type == kMoof) {
+    fragment_.assign(box, box + size);
+    size_t box_size = 0;
+    size_t header_size = 0;
+    get_box_size(box, size, &box_size, &header_size);
+    fragment_duration_ = GetFragmentDuration(box + header_size, size - header_size);
+    fragment_open_ = true;
+  } else if (type == kMdat) {
+    if (fragment_open_) {
+      fragment_.insert(fragment_.end(), box, box + size);
+      fragments_.push_back({fragment_, fragment_duration_});
+      fragment_.clear();
+      fragment_open_ = false;
+    }
+  } else if (!have_init_) {
+    init_.insert(init_.end(), box, box + size);
+  }
+}
+
+void Fmp4Splitter::ParseMoov(const uint8_t* data, size_t size) {
+  std::map<uint32_t, uint32_t> durations;
+  BoxIterator it(data, size);
+  uint32_t type;
+  const uint8_t* payload;
+  size_t payload_size;
+  while (it.Next(&type, &payload, &payload_size)) {
+    if (type == kTrak) {
+      const uint8_t* tkhd;
+      size_t tkhd_size;
+      const uint8_t* mdia;
+      size_t mdia_size;
+      if (!find_box(payload, payload_size, kTkhd, &tkhd, &tkhd_size) ||
+          !find_box(payload, payload_size, kMdia, &mdia, &mdia_size) || tkhd_size < 24) {
+        continue;
+      }
+      const uint32_t track_id = tkhd[0] == 1 ? read_u32(tkhd + 20) : read_u32(tkhd + 12);
+
+      Track track = {0, 0};
+      const uint8_t* mdhd;
+      size_t mdhd_size;
+      if (find_box(mdia, mdia_size, kMdhd, &mdhd, &mdhd_size) && mdhd_size >= 24) {
+        track.timescale = mdhd[0] == 1 ? read_u32(mdhd + 20) : read_u32(mdhd + 12);
+      }
+      tracks_[track_id] = track;
+
+      const uint8_t* minf;
+      size_t minf_size;
+      const uint8_t* stbl;
+      size_t stbl_size;
+      const uint8_t* stsd;
+      size_t stsd_size;
+      if (find_box(mdia, mdia_size, kMinf, &minf, &minf_size) &&
+          find_box(minf, minf_size, kStbl, &stbl, &stbl_size) &&
+          find_box(stbl, stbl_size, kStsd, &stsd, &stsd_size)) {
+        const std::string codec = sample_entry_codec(stsd, stsd_size);
+        if (!codec.empty()) {
+          codecs_.push_back(codec);
+        }
+      }
+    } else if (type == kMvex) {
+      BoxIterator mvex(payload, payload_size);
+      const uint8_t* trex;
+      size_t trex_size;
+      while (mvex.Next(&type, &trex, &trex_size)) {
+        if (type == kTrex && trex_size >= 16) {
+          durations[read_u32(trex + 4)] = read_u32(trex + 12);
+        }
+      }
+    }
+  }
+
+  for (const auto& duration : durations) {
+    auto track = tracks_.find(duration.first);
+    if (track != tracks_.end()) {
+      track->second.default_sample_duration = duration.second;
+    }
+  }
+}
+
+uint64_t Fmp4Splitter::GetFragmentDuration(const uint8_t* moof, size_t size) const {
+  const uint8_t* traf;
+  size_t traf_size;
+  if (!find_box(moof, size, kTraf, &traf, &traf_size)) {
+    return 0;
+  }
+
+  uint32_t track_id = 0;
+  uint32_t default_duration = 0;
+  uint64_t duration = 0;
+  BoxIterator it(traf, traf_size);
+  uint32_t type;
+  const uint8_t* payload;
+  size_t payload_size;
+  while (it.Next(&type, &payload, &payload_size)) {
+    if (type == kTfhd && payload_size >= 8) {
+      const uint32_t flags = read_u32(payload) & 0xFFFFFF;
+      track_id = read_u32(payload + 4);
+      const auto track = tracks_.find(track_id);
+      if (track != tracks_.end()) {
+        default_duration = track->second.default_sample_duration;
+      }
+      size_t offset = 8;
+      if (flags & 0x01) {  // base data offset
+        offset += 8;
+      }
+      if (flags & 0x02) {  // sample description index
+        offset += 4;
+      }
+      if ((flags & 0x08) && offset + 4 <= payload_size) {
+        default_duration = read_u32(payload + offset);
+      }
+    } else if (type == kTrun && payload_size >= 8) {
+      const uint32_t flags = read_u32(payload) & 0xFFFFFF;
+      const uint32_t sample_count = read_u32(payload + 4);
+      size_t offset = 8;
+      if (flags & 0x01) {  // data offset
+        offset += 4;
+      }
+      if (flags & 0x04) {  // first sample flags
+        offset += 4;
+      }
+      size_t sample_size = 0;
+      for (uint32_t flag = 0x100; flag <= 0x800; flag <<= 1) {
+        if (flags & flag) {
+          sample_size += 4;
+        }
+      }
+      for (uint32_t i = 0; i < sample_count; ++i) {
+        if (flags & 0x100) {
+          if (offset + 4 > payload_size) {
+            break;
+          }
+          duration += read_u32(payload + offset);
+        } else {
+          duration += default_duration;
+        }
+        offset += sample_size;
+      }
+    }
+  }
+
+  const auto track = tracks_.find(track_id);
+  if (track == tracks_.end() || track->second.timescale == 0) {
+    return 0;
+  }
+  return duration * 1000 / track->second.timescale;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fastocloud {
+namespace stream {
+
+// splits fragmented mp4 byte stream (mp4mux streamable) into init segment and moof+mdat fragments
+class Fmp4Splitter {
+ public:
+  typedef std::vector<uint8_t> bytes_t;
+
+  struct Fragment {
+    bytes_t data;
+    uint64_t duration_msec;  // of first track in fragment
+  };
+
+  Fmp4Splitter();
+
+  void Feed(const uint8_t* data, size_t size);
+
+  bool HaveInit() const;
+  const bytes_t& GetInit() const;  // ftyp + moov
+  std::string GetCodecs() const;   // rfc 6381, comma separated, empty if init not parsed
+
+  bool PopFragment(Fragment* fragment);  // completed fragments in order
+
+ private:
+  struct Track {
+    uint32_t timescale;
+    uint32_t default_sample_duration;
+  };
+
+  void HandleBox(const uint8_t* box, size_t size);
+  void ParseMoov(const uint8_t* data, size_t size);
+  uint64_t GetFragmentDuration(const uint8_t* moof, size_t size) const;
+
+  bytes_t pending_;
+  bytes_t init_;
+  bool have_init_;
+  bytes_t fragment_;
+  bool fragment_open_;
+  uint64_t fragment_duration_;
+  std::vector<Fragment> fragments_;
+  std::map<uint32_t, Track> tracks_;
+  std::vector<std::string> codecs_;
+};
+
+}  // namespace stream
+}  // namespace fastocloud
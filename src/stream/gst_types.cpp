@@ -29,7 +29,7 @@ bool GetEncoderType(const std::string& encoder, EncoderType* enc) {
     return true;
   }
 
-  if (encoder == VAAPI_H264_ENC || encoder == VAAPI_MPEG2_ENC) {
+  if (encoder == VAAPI_H264_ENC || encoder == VAAPI_MPEG2_ENC || encoder == VA_AV1_ENC) {
     *enc = GPU_VAAPI;
     return true;
   }
@@ -14,15 +14,69 @@
 
 #include "stream/gstreamer_utils.h"
 
-#include <gst/gstutils.h>  // for gst_pad_query_caps
+#include <gst/gstelementfactory.h>  // for gst_element_factory_get_metadata
+#include <gst/gstutils.h>           // for gst_pad_query_caps
+
+#include <algorithm>
+#include <map>
+#include <mutex>
 
 #include <common/macros.h>
 
+namespace {
+std::mutex factories_mutex;
+std::map<std::string, GstElementFactory*> factories;  // also misses, plugins are not registered at runtime
+
+GValueArray* reorder_factories(GValueArray* list, const std::vector<size_t>& order) {
+  bool changed = false;
+  for (size_t i = 0; i < order.size() && !changed; ++i) {
+    changed = order[i] != i;
+  }
+  if (!changed) {
+    return nullptr;
+  }
+
+  GValueArray* sorted = g_value_array_new(list->n_values);
+  for (size_t i = 0; i < order.size(); ++i) {
+    g_value_array_append(sorted, g_value_array_get_nth(list, order[i]));
+  }
+  return sorted;
+}
+}  // namespace
+
 namespace fastocloud {
 namespace stream {
 
+GstElementFactory* find_element_factory(const std::string& type) {
+  std::unique_lock<std::mutex> lock(factories_mutex);
+  auto it = factories.find(type);
+  if (it != factories.end()) {
+    return it->second;
+  }
+
+  GstElementFactory* factory = gst_element_factory_find(type.c_str());
+  if (factory) {  // plugin loaded here, create of not loaded feature loads it every time
+    GstPluginFeature* loaded = gst_plugin_feature_load(GST_PLUGIN_FEATURE(factory));
+    gst_object_unref(factory);
+    factory = loaded ? GST_ELEMENT_FACTORY(loaded) : nullptr;
+  }
+  factories[type] = factory;
+  return factory;
+}
+
+void clear_element_factories() {
+  std::unique_lock<std::mutex> lock(factories_mutex);
+  for (auto it = factories.begin(); it != factories.end(); ++it) {
+    if (it->second) {
+      gst_object_unref(it->second);
+    }
+  }
+  factories.clear();
+}
+
 GstElement* make_element_safe(const std::string& type, const std::string& name) {
-  GstElement* elem = gst_element_factory_make(type.c_str(), name.c_str());
+  GstElementFactory* factory = find_element_factory(type);
+  GstElement* elem = factory ? gst_element_factory_create(factory, name.c_str()) : nullptr;
   if (!elem) {
     CRITICAL_LOG() << "Cannot create '" << type << "' named: " << name;
   }
@@ -30,6 +84,10 @@ GstElement* make_element_safe(const std::string& type, const std::string& name)
   return elem;
 }
 
+bool is_element_available(const std::string& type) {
+  return find_element_factory(type) != nullptr;
+}
+
 const gchar* pad_get_type(GstPad* pad) {
   GstCaps* caps = gst_pad_query_caps(pad, nullptr);
   if (!caps) {
@@ -143,5 +201,170 @@ bool get_type_from_caps(GstCaps* caps, std::string* type_title, std::string* typ
   return true;
 }
 
+int get_element_socket_fd(GstElement* element) {
+  if (!element) {
+    return -1;
+  }
+
+  gpointer data = g_object_get_data(G_OBJECT(element), SOCKET_FD_DATA);
+  if (data) {
+    return GPOINTER_TO_INT(data) - 1;
+  }
+
+  if (!g_object_class_find_property(G_OBJECT_GET_CLASS(element), "used-socket")) {
+    return -1;
+  }
+
+  GObject* socket = nullptr;  // GSocket, fd read as property so gio isn't linked
+  g_object_get(element, "used-socket", &socket, nullptr);
+  if (!socket) {
+    return -1;
+  }
+
+  gint fd = -1;
+  g_object_get(socket, "fd", &fd, nullptr);
+  g_object_unref(socket);
+  return fd;
+}
+
+bool get_queue_level(GstElement* queue, int* fill_percent, guint64* level_time) {
+  if (!queue || !fill_percent || !level_time) {
+    return false;
+  }
+
+  if (!g_object_class_find_property(G_OBJECT_GET_CLASS(queue), "current-level-time")) {
+    return false;
+  }
+
+  guint level_buffers = 0, max_buffers = 0, level_bytes = 0, max_bytes = 0;
+  guint64 ltime = 0, max_time = 0;
+  g_object_get(queue, "current-level-buffers", &level_buffers, "max-size-buffers", &max_buffers,
+               "current-level-bytes", &level_bytes, "max-size-bytes", &max_bytes, "current-level-time", &ltime,
+               "max-size-time", &max_time, nullptr);
+
+  guint64 fill = 0;  // 0 limit is unlimited
+  if (max_buffers) {
+    fill = std::max<guint64>(fill, static_cast<guint64>(level_buffers) * 100 / max_buffers);
+  }
+  if (max_bytes) {
+    fill = std::max<guint64>(fill, static_cast<guint64>(level_bytes) * 100 / max_bytes);
+  }
+  if (max_time) {
+    fill = std::max<guint64>(fill, ltime * 100 / max_time);
+  }
+  *fill_percent = std::min<guint64>(fill, 100);
+  *level_time = ltime;
+  return true;
+}
+
+bool is_decoder_klass(const std::string& klass) {
+  return klass.find("Decoder") != std::string::npos;
+}
+
+bool is_hardware_decoder_klass(const std::string& klass) {
+  return is_decoder_klass(klass) && klass.find("Hardware") != std::string::npos;
+}
+
+std::vector<size_t> rank_hardware_decoders(const std::vector<std::string>& klasses, bool hardware_first) {
+  std::vector<size_t> slots;
+  std::vector<size_t> hardware;
+  std::vector<size_t> software;
+  for (size_t i = 0; i < klasses.size(); ++i) {
+    if (!is_decoder_klass(klasses[i])) {
+      continue;
+    }
+    slots.push_back(i);
+    if (is_hardware_decoder_klass(klasses[i])) {
+      hardware.push_back(i);
+    } else {
+      software.push_back(i);
+    }
+  }
+
+  std::vector<size_t> decoders = hardware_first ? hardware : software;
+  const std::vector<size_t>& rest = hardware_first ? software : hardware;
+  decoders.insert(decoders.end(), rest.begin(), rest.end());
+
+  std::vector<size_t> order(klasses.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  for (size_t i = 0; i < slots.size(); ++i) {
+    order[slots[i]] = decoders[i];
+  }
+  return order;
+}
+
+GValueArray* sort_hardware_decoders(GValueArray* factories, bool hardware_first) {
+  if (!factories) {
+    return nullptr;
+  }
+
+  std::vector<std::string> klasses;
+  for (guint i = 0; i < factories->n_values; ++i) {
+    GstElementFactory* factory = GST_ELEMENT_FACTORY(g_value_get_object(g_value_array_get_nth(factories, i)));
+    const gchar* klass = gst_element_factory_get_metadata(factory, GST_ELEMENT_METADATA_KLASS);
+    klasses.push_back(klass ? klass : std::string());
+  }
+
+  return reorder_factories(factories, rank_hardware_decoders(klasses, hardware_first));
+}
+
+std::string make_cuda_device_factory_name(const std::string& factory, int device) {
+  const size_t suffix_len = 3;
+  if (device < 0 || factory.size() <= 2 + suffix_len || factory.compare(0, 2, "nv") != 0) {
+    return std::string();
+  }
+
+  const std::string suffix = factory.substr(factory.size() - suffix_len);
+  if (suffix != "enc" && suffix != "dec") {
+    return std::string();
+  }
+  return factory.substr(0, factory.size() - suffix_len) + "device" + std::to_string(device) + suffix;
+}
+
+std::string get_cuda_device_factory(const std::string& factory, int device) {
+  const std::string name = make_cuda_device_factory_name(factory, device);
+  if (name.empty()) {
+    return name;
+  }
+
+  return is_element_available(name) ? name : std::string();
+}
+
+std::vector<size_t> rank_cuda_device_factories(const std::vector<std::string>& names, int device) {
+  std::vector<size_t> order;
+  std::vector<bool> placed(names.size(), false);
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (placed[i]) {
+      continue;
+    }
+
+    const std::string device_name = make_cuda_device_factory_name(names[i], device);
+    const auto it = device_name.empty() ? names.end() : std::find(names.begin(), names.end(), device_name);
+    if (it != names.end() && !placed[it - names.begin()]) {
+      order.push_back(it - names.begin());
+      placed[it - names.begin()] = true;
+    }
+    order.push_back(i);
+    placed[i] = true;
+  }
+  return order;
+}
+
+GValueArray* sort_cuda_device_factories(GValueArray* factories, int device) {
+  if (!factories) {
+    return nullptr;
+  }
+
+  std::vector<std::string> names;
+  for (guint i = 0; i < factories->n_values; ++i) {
+    GstPluginFeature* feature = GST_PLUGIN_FEATURE(g_value_get_object(g_value_array_get_nth(factories, i)));
+    names.push_back(gst_plugin_feature_get_name(feature));
+  }
+
+  return reorder_factories(factories, rank_cuda_device_factories(names, device));
+}
+
 }  // namespace stream
 }  // namespace fastocloud
@@ -17,11 +17,18 @@
 #include <gst/gstelement.h>  // for GstElement
 
 #include <string>  // for string
+#include <vector>  // for vector
+
+#define SOCKET_FD_DATA "fastocloud-socket-fd"  // object data of elements with own socket, fd + 1
 
 namespace fastocloud {
 namespace stream {
 
 GstElement* make_element_safe(const std::string& type, const std::string& name);
+bool is_element_available(const std::string& type);  // plugin registered
+// loaded factory found once per process (zygote children inherit it), owned by cache, nullptr if not registered
+GstElementFactory* find_element_factory(const std::string& type);
+void clear_element_factories();  // before backend deinit
 
 const gchar* pad_get_type(GstPad* pad);
 
@@ -33,5 +40,26 @@ T gvalue_cast(const GValue* val);
 
 bool get_type_from_caps(GstCaps* caps, std::string* type_title, std::string* type_full);
 
+int get_element_socket_fd(GstElement* element);  // "used-socket" or SOCKET_FD_DATA, -1 if none
+// queue or queue2, percent of most filled limit (buffers, bytes, time) and buffered time in nsec
+bool get_queue_level(GstElement* queue, int* fill_percent, guint64* level_time);
+
+bool is_decoder_klass(const std::string& klass);           // "Codec/Decoder/..."
+bool is_hardware_decoder_klass(const std::string& klass);  // "Codec/Decoder/Video/Hardware" of nvcodec, va, msdk
+// permutation of factories by klass, decoders swapped among own slots with hardware ones first or last,
+// parsers and demuxers keep their positions
+std::vector<size_t> rank_hardware_decoders(const std::vector<std::string>& klasses, bool hardware_first);
+// autoplug-sort helper, copy of factories ranked as above or nullptr if order kept
+GValueArray* sort_hardware_decoders(GValueArray* factories, bool hardware_first);
+
+// nvcodec (gst 1.18+) registers own factory per gpu and its cuda-device-id is read only,
+// "nvh264device1enc" for "nvh264enc" and device 1, empty if factory is not "nv*enc" or "nv*dec"
+std::string make_cuda_device_factory_name(const std::string& factory, int device);
+std::string get_cuda_device_factory(const std::string& factory, int device);  // empty if not registered
+// permutation of factories by name, factory of device moved right before its default factory
+std::vector<size_t> rank_cuda_device_factories(const std::vector<std::string>& names, int device);
+// autoplug-sort helper, copy of factories ranked as above or nullptr if order kept
+GValueArray* sort_cuda_device_factories(GValueArray* factories, int device);
+
 }  // namespace stream
 }  // namespace fastocloud
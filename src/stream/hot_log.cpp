@@ -0,0 +1,164 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/hot_log.h"
+
+#include <common/time.h>
+
+namespace fastocloud {
+namespace stream {
+
+HotLogSite::HotLogSite(fastotv::timestamp_t interval_msec)
+    : interval_msec_(interval_msec), next_ts_(0), suppressed_(0) {}
+
+HotLogSite* HotLogSite::Enter(common::logging::LOG_LEVEL level, HotLogSite* site) {
+  if (!HotLogWriter::GetInstance().IsEnabled(level)) {
+    return nullptr;
+  }
+
+  return site->Allow() ? site : nullptr;
+}
+
+bool HotLogSite::Allow() {
+  const fastotv::timestamp_t now = common::time::current_utc_mstime();
+  fastotv::timestamp_t next = next_ts_.load(std::memory_order_relaxed);
+  if (now >= next && next_ts_.compare_exchange_strong(next, now + interval_msec_, std::memory_order_relaxed)) {
+    return true;
+  }
+
+  suppressed_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+uint64_t HotLogSite::TakeSuppressed() {
+  return suppressed_.exchange(0, std::memory_order_relaxed);
+}
+
+HotLogWriter::HotLogWriter()
+    : level_(common::logging::LOG_LEVEL_DEBUG),
+      started_(false),
+      mutex_(),
+      cond_(),
+      pending_(),
+      dropped_(0),
+      stop_(false),
+      thread_() {}
+
+HotLogWriter::~HotLogWriter() {
+  Stop();
+}
+
+void HotLogWriter::Start(common::logging::LOG_LEVEL level) {
+  level_ = level;
+  if (started_) {
+    return;
+  }
+
+  stop_ = false;
+  thread_ = std::thread(&HotLogWriter::WriteLoop, this);
+  started_ = true;
+}
+
+void HotLogWriter::Stop() {
+  if (!started_) {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_one();
+  thread_.join();
+  started_ = false;
+}
+
+bool HotLogWriter::IsEnabled(common::logging::LOG_LEVEL level) const {
+  return level <= level_.load(std::memory_order_relaxed);
+}
+
+void HotLogWriter::Write(common::logging::LOG_LEVEL level, std::string line) {
+  if (!started_) {
+    WriteLine(level, line);
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (pending_.size() >= max_pending) {
+      dropped_++;
+      return;
+    }
+    pending_.emplace_back(level, std::move(line));
+  }
+  cond_.notify_one();
+}
+
+void HotLogWriter::WriteLoop() {
+  std::deque<std::pair<common::logging::LOG_LEVEL, std::string>> lines;
+  while (true) {
+    uint64_t dropped = 0;
+    bool stop = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+      lines.swap(pending_);
+      std::swap(dropped, dropped_);
+      stop = stop_;
+    }
+
+    for (const auto& line : lines) {
+      WriteLine(line.first, line.second);
+    }
+    lines.clear();
+    if (dropped) {
+      WARNING_LOG() << "Hot path logs dropped: " << dropped;
+    }
+    if (stop) {
+      return;
+    }
+  }
+}
+
+void HotLogWriter::WriteLine(common::logging::LOG_LEVEL level, const std::string& line) {
+  if (level <= common::logging::LOG_LEVEL_ERR) {
+    ERROR_LOG() << line;
+  } else if (level == common::logging::LOG_LEVEL_WARNING) {
+    WARNING_LOG() << line;
+  } else if (level == common::logging::LOG_LEVEL_NOTICE) {
+    NOTICE_LOG() << line;
+  } else if (level == common::logging::LOG_LEVEL_INFO) {
+    INFO_LOG() << line;
+  } else {
+    DEBUG_LOG() << line;
+  }
+}
+
+HotLogMessage::HotLogMessage(common::logging::LOG_LEVEL level, HotLogSite* site)
+    : level_(level), site_(site), stream_() {}
+
+HotLogMessage::~HotLogMessage() {
+  const uint64_t suppressed = site_ ? site_->TakeSuppressed() : 0;
+  if (suppressed) {
+    stream_ << " (" << suppressed << " similar suppressed)";
+  }
+  HotLogWriter::GetInstance().Write(level_, stream_.str());
+}
+
+std::ostream& HotLogMessage::Stream() {
+  return stream_;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
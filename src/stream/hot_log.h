@@ -0,0 +1,114 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <common/logger.h>
+#include <common/patterns/singleton_pattern.h>
+
+#include <fastotv/types.h>
+
+// logs of streaming threads and per tick code, each site writes at most once per interval,
+// messages go through queue to writer thread so streaming threads never wait on log file
+#define HOT_LOG(LEVEL, INTERVAL_MSEC)                                                        \
+  for (fastocloud::stream::HotLogSite* hot_log_site = fastocloud::stream::HotLogSite::Enter( \
+           LEVEL,                                                                            \
+           [] {                                                                              \
+             static fastocloud::stream::HotLogSite site(INTERVAL_MSEC);                      \
+             return &site;                                                                   \
+           }());                                                                             \
+       hot_log_site; hot_log_site = nullptr)                                                 \
+  fastocloud::stream::HotLogMessage(LEVEL, hot_log_site).Stream()
+
+#if defined(HOT_PATH_DEBUG_LOGS)
+#define HOT_DEBUG_LOG(INTERVAL_MSEC) HOT_LOG(common::logging::LOG_LEVEL_DEBUG, INTERVAL_MSEC)
+#else
+// elided, arguments not evaluated
+#define HOT_DEBUG_LOG(INTERVAL_MSEC) \
+  for (; false;)                     \
+  fastocloud::stream::HotLogMessage(common::logging::LOG_LEVEL_DEBUG, nullptr).Stream()
+#endif
+#define HOT_WARNING_LOG(INTERVAL_MSEC) HOT_LOG(common::logging::LOG_LEVEL_WARNING, INTERVAL_MSEC)
+
+namespace fastocloud {
+namespace stream {
+
+class HotLogSite {
+ public:
+  explicit HotLogSite(fastotv::timestamp_t interval_msec);
+
+  // site if message should be written, counts suppressed ones otherwise
+  static HotLogSite* Enter(common::logging::LOG_LEVEL level, HotLogSite* site);
+  uint64_t TakeSuppressed();
+
+ private:
+  bool Allow();
+
+  const fastotv::timestamp_t interval_msec_;
+  std::atomic<fastotv::timestamp_t> next_ts_;
+  std::atomic<uint64_t> suppressed_;
+};
+
+class HotLogWriter : public common::patterns::LazySingleton<HotLogWriter> {
+ public:
+  friend class common::patterns::LazySingleton<HotLogWriter>;
+  enum { max_pending = 4096 };  // dropped above, counted
+
+  void Start(common::logging::LOG_LEVEL level);
+  void Stop();  // pending written
+  bool IsEnabled(common::logging::LOG_LEVEL level) const;
+
+  void Write(common::logging::LOG_LEVEL level, std::string line);  // synchronous while not started
+
+ private:
+  HotLogWriter();
+  ~HotLogWriter();
+
+  void WriteLoop();
+  static void WriteLine(common::logging::LOG_LEVEL level, const std::string& line);
+
+  std::atomic<int> level_;
+  std::atomic<bool> started_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::pair<common::logging::LOG_LEVEL, std::string>> pending_;
+  uint64_t dropped_;
+  bool stop_;
+  std::thread thread_;
+};
+
+class HotLogMessage {
+ public:
+  HotLogMessage(common::logging::LOG_LEVEL level, HotLogSite* site);
+  ~HotLogMessage();
+
+  std::ostream& Stream();
+
+ private:
+  const common::logging::LOG_LEVEL level_;
+  HotLogSite* const site_;
+  std::ostringstream stream_;
+};
+
+}  // namespace stream
+}  // namespace fastocloud
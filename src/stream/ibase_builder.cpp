@@ -18,19 +18,127 @@
 #include <gst/gstpipeline.h>
 
 #include <algorithm>
+#include <vector>
+
+#include <common/sprintf.h>
 
 #include "stream/elements/element.h"
 #include "stream/elements/sink/build_output.h"
+#include "stream/elements/sink/shm.h"
+#include "stream/elements/sink/udp.h"
+#include "stream/elements/sources/build_input.h"
+#include "stream/elements/sources/shmsrc.h"
 #include "stream/ibase_builder_observer.h"
 #include "stream/ibase_stream.h"
+#include "stream/link_cache.h"
+#include "stream/shared_ingest.h"
+#include "stream/ts_packet_filter.h"
 
 #include "pad/pad.h"
 
+#define QUEUE_POLICY_PATH_QUEUES 3     // decoded, encoded and output branch queues
+#define QUEUE_POLICY_MIN_MSEC 40
+#define QUEUE_POLICY_MIN_BYTES 524288  // keyframe of short share
+#define QUEUE_POLICY_BYTES_HEADROOM 2  // bitrate peaks and keyframes
+
 namespace fastocloud {
 namespace stream {
+namespace {
+GstPadProbeReturn ts_program_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  TsProgramFilter* filter = static_cast<TsProgramFilter*>(user_data);
+  GstBuffer* buffer = gst_buffer_make_writable(GST_PAD_PROBE_INFO_BUFFER(info));
+  GST_PAD_PROBE_INFO_DATA(info) = buffer;
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_READWRITE)) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  const size_t left = filter->Filter(map.data, map.size);
+  gst_buffer_unmap(buffer, &map);
+  if (left == 0) {  // other programs only
+    return GST_PAD_PROBE_DROP;
+  }
+
+  gst_buffer_set_size(buffer, left);
+  return GST_PAD_PROBE_OK;
+}
+
+void ts_program_destroy(gpointer user_data) {
+  delete static_cast<TsProgramFilter*>(user_data);
+}
+
+void add_ts_program_probe(elements::Element* elem, uint16_t program) {
+  pad::Pad* src_pad = elem->StaticPad("src");
+  if (src_pad->IsValid()) {
+    gst_pad_add_probe(src_pad->GetGstPad(), GST_PAD_PROBE_TYPE_BUFFER, ts_program_probe,
+                      new TsProgramFilter(program), ts_program_destroy);
+  }
+  delete src_pad;
+}
+
+LinkCache::Pad make_cache_pad(GstPad* pad) {
+  GstPadTemplate* templ = GST_PAD_PAD_TEMPLATE(pad);
+  if (templ && GST_PAD_TEMPLATE_PRESENCE(templ) == GST_PAD_REQUEST) {
+    return {GST_PAD_TEMPLATE_NAME_TEMPLATE(templ), true};
+  }
+  return {GST_PAD_NAME(pad), false};
+}
+
+GstPad* get_cached_pad(GstElement* element, const LinkCache::Pad& pad) {
+  return pad.request ? gst_element_get_request_pad(element, pad.name.c_str())
+                     : gst_element_get_static_pad(element, pad.name.c_str());
+}
+
+void release_cached_pad(GstElement* element, GstPad* pad, const LinkCache::Pad& cached) {
+  if (!pad) {
+    return;
+  }
+  if (cached.request) {
+    gst_element_release_request_pad(element, pad);
+  }
+  gst_object_unref(pad);
+}
+
+bool link_cached_pads(GstElement* src, GstElement* dest, const LinkCache::Link& link) {
+  GstPad* src_pad = get_cached_pad(src, link.src);
+  GstPad* sink_pad = get_cached_pad(dest, link.sink);
+  const GstPadLinkCheck check =
+      static_cast<GstPadLinkCheck>(GST_PAD_LINK_CHECK_HIERARCHY | GST_PAD_LINK_CHECK_TEMPLATE_CAPS);
+  if (src_pad && sink_pad && !gst_pad_is_linked(src_pad) && !gst_pad_is_linked(sink_pad) &&
+      GST_PAD_LINK_SUCCESSFUL(gst_pad_link_full(src_pad, sink_pad, check))) {
+    gst_object_unref(src_pad);
+    gst_object_unref(sink_pad);
+    return true;
+  }
+
+  release_cached_pad(src, src_pad, link.src);
+  release_cached_pad(dest, sink_pad, link.sink);
+  return false;
+}
+
+// pads linked by element link, false if elements linked more than once
+bool find_linked_pads(GstElement* src, GstElement* dest, LinkCache::Link* link) {
+  size_t found = 0;
+  GST_OBJECT_LOCK(src);
+  for (GList* item = GST_ELEMENT_PADS(src); item; item = item->next) {
+    GstPad* pad = GST_PAD(item->data);
+    GstPad* peer = GST_PAD_PEER(pad);
+    if (GST_PAD_IS_SRC(pad) && peer && GST_OBJECT_PARENT(peer) == GST_OBJECT(dest)) {
+      link->src = make_cache_pad(pad);
+      link->sink = make_cache_pad(peer);
+      found++;
+    }
+  }
+  GST_OBJECT_UNLOCK(src);
+  return found == 1;
+}
+}  // namespace
 
 IBaseBuilder::IBaseBuilder(const Config* config, IBaseBuilderObserver* observer)
-    : config_(config), observer_(observer), pipeline_(gst_pipeline_new("pipeline")), pipeline_elements_() {}
+    : config_(config), observer_(observer), pipeline_(gst_pipeline_new("pipeline")),
+      pipeline_elements_(),
+      registry_() {}
 
 IBaseBuilder::~IBaseBuilder() {}
 
@@ -49,6 +157,10 @@ elements::Element* IBaseBuilder::GetElementByName(const std::string& name) const
   return nullptr;
 }
 
+void IBaseBuilder::RegisterElement(ElementRole role, element_id_t id, elements::Element* elem) {
+  registry_.Register(role, id, elem);
+}
+
 bool IBaseBuilder::ElementAdd(elements::Element* elem) {
   GstBin* pipeline = GST_BIN(pipeline_);
   bool res = gst_bin_add(pipeline, elem->GetGstElement());
@@ -70,8 +182,24 @@ bool IBaseBuilder::ElementLink(elements::Element* src, elements::Element* dest)
     return false;
   }
 
-  bool res = gst_element_link(src->GetGstElement(), dest->GetGstElement());
+  GstElement* src_element = src->GetGstElement();
+  GstElement* dest_element = dest->GetGstElement();
+  const std::string key = LinkCache::MakeKey(GST_ELEMENT_NAME(src_element), src->GetPluginName(),
+                                             GST_ELEMENT_NAME(dest_element), dest->GetPluginName());
+  LinkCache& cache = LinkCache::GetInstance();
+  LinkCache::Link link;
+  if (cache.Find(key, &link)) {
+    if (link_cached_pads(src_element, dest_element, link)) {
+      return true;
+    }
+    cache.Remove(key);  // other pads now, negotiated below
+  }
+
+  bool res = gst_element_link(src_element, dest_element);
   CHECK(res) << "Can't linked " << src->GetPluginName() << " to " << dest->GetPluginName();
+  if (res && find_linked_pads(src_element, dest_element, &link)) {
+    cache.Set(key, link);
+  }
   return res;
 }
 
@@ -81,6 +209,7 @@ bool IBaseBuilder::ElementRemove(elements::Element* elem) {
   CHECK(res);
   pipeline_elements_.erase(std::remove(pipeline_elements_.begin(), pipeline_elements_.end(), elem),
                            pipeline_elements_.end());
+  registry_.Unregister(elem);
   delete elem;
   return res;
 }
@@ -106,11 +235,214 @@ elements::Element* IBaseBuilder::BuildGenericOutput(const OutputUri& output, ele
 }
 
 elements::Element* IBaseBuilder::CreateSink(const OutputUri& output, element_id_t sink_id) {
+#if defined(AMAZON_KINESIS)
+  if (IsKvsUrl(output.GetOutput())) {
+    return elements::sink::build_kvs_output(config_->GetAmazonKinesis(), sink_id);
+  }
+#endif
   IBaseStream* stream = static_cast<IBaseStream*>(GetObserver());
-  elements::Element* sink = elements::sink::build_output(output, sink_id, stream->IsVod());
+  elements::Element* sink = elements::sink::build_output(output, sink_id, stream->IsVod(), config_->GetUdpEgress(),
+                                                         config_->GetOutputSocket(output.GetID()),
+                                                         config_->GetLlHlsPartMsec(), config_->GetCmaf(),
+                                                         config_->GetOutputTcp(output.GetID()));
+  return sink;
+}
+
+std::vector<element_id_t> IBaseBuilder::GetFanoutOutputs() const {
+  std::vector<element_id_t> fanout;
+  if (!config_->GetUdpEgress().fanout) {
+    return fanout;
+  }
+
+  const output_t output = config_->GetOutput();
+  for (size_t i = 0; i < output.size(); ++i) {
+    const common::uri::Url uri = output[i].GetOutput();
+    // tuned sockets keep own sink
+    if (uri.GetScheme() == common::uri::Url::udp && config_->GetOutputSocket(output[i].GetID()).IsEmpty()) {
+      fanout.push_back(i);
+    }
+  }
+
+  if (fanout.size() < 2) {
+    fanout.clear();
+  }
+  return fanout;
+}
+
+elements::Element* IBaseBuilder::BuildFanoutOutput(const std::vector<element_id_t>& fanout) {
+  const output_t output = config_->GetOutput();
+  std::vector<common::net::HostAndPort> hosts;
+  for (element_id_t id : fanout) {
+    const std::string url = output[id].GetOutput().GetHost();
+    common::net::HostAndPort host;
+    if (!common::ConvertFromString(url, &host)) {
+      NOTREACHED() << "Unknown output url: " << url;
+      continue;
+    }
+    hosts.push_back(host);
+  }
+
+  const element_id_t sink_id = fanout.front();
+  elements::Element* sink = elements::sink::make_multi_udp_sink(hosts, config_->GetUdpEgress().send_buffer, sink_id);
+  pad::Pad* sink_pad = sink->StaticPad("sink");
+  if (sink_pad->IsValid()) {
+    for (element_id_t id : fanout) {  // every output counted on shared pad
+      HandleOutputSinkPadCreated(sink_pad, id, output[id].GetOutput(), false);
+    }
+  }
+  delete sink_pad;
   return sink;
 }
 
+bool IBaseBuilder::IsFanoutFollower(const std::vector<element_id_t>& fanout, element_id_t id) {
+  return !fanout.empty() && fanout.front() != id && std::find(fanout.begin(), fanout.end(), id) != fanout.end();
+}
+
+void IBaseBuilder::SetupQueue(elements::ElementQueue* queue, bool encoded) const {
+  const fastotv::timestamp_t share =
+      std::max<fastotv::timestamp_t>(GetLatencyTarget() / QUEUE_POLICY_PATH_QUEUES, QUEUE_POLICY_MIN_MSEC);
+  queue->SetMaxSizeBuffers(0);
+  queue->SetMaxSizeTime(share * GST_MSECOND);
+  const bit_rate_t bitrate = GetQueueBitrate();
+  if (encoded && bitrate && *bitrate > 0) {
+    const guint64 bytes = static_cast<guint64>(*bitrate) * 1000 / 8 * share / 1000 * QUEUE_POLICY_BYTES_HEADROOM;
+    queue->SetMaxSizeBytes(std::min<guint64>(std::max<guint64>(bytes, QUEUE_POLICY_MIN_BYTES), G_MAXUINT));
+  }
+}
+
+fastotv::timestamp_t IBaseBuilder::GetLatencyTarget() const {
+  const fastotv::timestamp_t msec = config_->GetLatencyTargetMsec();
+  return msec ? msec : DEFAULT_LATENCY_TARGET_MSEC;
+}
+
+bit_rate_t IBaseBuilder::GetQueueBitrate() const {
+  return bit_rate_t();
+}
+
+void IBaseBuilder::SetupOutputQueue(elements::ElementQueue* queue, element_id_t output_id) {
+  HandleOutputBranchQueueCreated(queue, output_id);
+  SetupQueue(queue, true);
+  const fastotv::timestamp_t msec = config_->GetOutputQueueMsec();
+  if (!msec) {
+    return;
+  }
+
+  // slow sink loses oldest buffers instead of blocking tee and other outputs
+  queue->SetMaxSizeBuffers(0);
+  queue->SetMaxSizeBytes(0);
+  queue->SetMaxSizeTime(msec * GST_MSECOND);
+  queue->SetLeaky(2);
+  HandleOutputQueueCreated(queue, output_id);
+}
+
+elements::Element* IBaseBuilder::BuildInputSource(const InputUri& uri, element_id_t input_id) {
+  const common::uri::Url url = uri.GetInput();
+  const std::string ingest_dir = config_->GetIngestDir();
+  SharedIngest* ingest = nullptr;
+  if (!ingest_dir.empty() && SharedIngest::IsShareable(url)) {
+    ingest = new SharedIngest(ingest_dir, url.GetUrl());
+  }
+
+  elements::Element* src = nullptr;
+  if (ingest && !ingest->TryPublish()) {
+    // upstream bytes read from publisher, failed reads restart pipeline and role is taken again
+    src = elements::sources::make_shm_src(ingest->GetSocketPath(), input_id);
+    destroy(&ingest);
+  } else {
+    src = elements::sources::make_src(uri, input_id, IBaseStream::src_timeout_sec, config_->GetUdpIngest(),
+                                      config_->GetInputSocket(uri.GetID()), config_->GetInputHttp(uri.GetID()));
+  }
+
+  pad::Pad* src_pad = src->StaticPad("src");
+  if (src_pad->IsValid()) {
+    HandleInputSrcPadCreated(src_pad, input_id, url);
+  }
+  delete src_pad;
+  ElementAdd(src);
+  // program of mpts split after ingest, whole ts published to readers
+  const uint16_t program = config_->GetInputMpts(uri.GetID()).program;
+  if (!ingest) {
+    if (program) {
+      add_ts_program_probe(src, program);
+    }
+    return src;
+  }
+
+  elements::ElementTee* tee = BuildIngestPublisher(ingest, false, input_id);
+  ElementLink(src, tee);
+  if (!program) {
+    return tee;
+  }
+
+  elements::ElementQueue* queue =
+      new elements::ElementQueue(common::MemSPrintf(INGEST_PROGRAM_QUEUE_NAME_1U, input_id));
+  SetupQueue(queue, true);
+  ElementAdd(queue);
+  ElementLink(tee, queue);
+  add_ts_program_probe(queue, program);
+  return queue;
+}
+
+bool IBaseBuilder::BuildRtspIngest(const InputUri& uri, element_id_t input_id, elements::Element* decodebin) {
+  const common::uri::Url url = uri.GetInput();
+  const std::string ingest_dir = config_->GetIngestDir();
+  if (ingest_dir.empty() || url.GetScheme() != common::uri::Url::rtsp) {
+    return false;
+  }
+
+  SharedIngest* ingest = new SharedIngest(ingest_dir, url.GetUrl());
+  if (ingest->TryPublish()) {
+    // rtp pad of rtspsrc is linked to tee by stream
+    elements::ElementTee* tee = BuildIngestPublisher(ingest, true, input_id);
+    ElementLink(tee, decodebin);
+    return false;
+  }
+
+  elements::Element* src = elements::sources::make_shm_src(ingest->GetSocketPath(), input_id);
+  destroy(&ingest);
+  pad::Pad* src_pad = src->StaticPad("src");
+  if (src_pad->IsValid()) {
+    HandleInputSrcPadCreated(src_pad, input_id, url);
+  }
+  delete src_pad;
+  ElementAdd(src);
+  elements::ElementGDPDepay* depay =
+      new elements::ElementGDPDepay(common::MemSPrintf(INGEST_DEPAY_NAME_1U, input_id));
+  ElementAdd(depay);
+  ElementLink(src, depay);
+  ElementLink(depay, decodebin);
+  return true;
+}
+
+elements::ElementTee* IBaseBuilder::BuildIngestPublisher(SharedIngest* ingest, bool with_caps, element_id_t input_id) {
+  // readers never block own pipeline
+  elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(INGEST_TEE_NAME_1U, input_id));
+  ElementAdd(tee);
+  RegisterElement(INGEST_TEE_ROLE, input_id, tee);
+  elements::ElementQueue* queue = new elements::ElementQueue(common::MemSPrintf(INGEST_QUEUE_NAME_1U, input_id));
+  queue->SetMaxSizeBuffers(0);
+  queue->SetMaxSizeTime(0);
+  queue->SetMaxSizeBytes(SharedIngest::queue_size);
+  queue->SetLeaky(2);
+  ElementAdd(queue);
+  ElementLink(tee, queue);
+  elements::Element* last = queue;
+  if (with_caps) {
+    elements::ElementGDPPay* pay = new elements::ElementGDPPay(common::MemSPrintf(INGEST_PAY_NAME_1U, input_id));
+    ElementAdd(pay);
+    ElementLink(queue, pay);
+    last = pay;
+  }
+  elements::sink::ElementShmSink* sink =
+      elements::sink::make_shm_sink(ingest->GetSocketPath(), SharedIngest::shm_size, input_id);
+  // lock is held while sink exists
+  g_object_set_data_full(G_OBJECT(sink->GetGstElement()), "shared-ingest", ingest,
+                         [](gpointer data) { delete static_cast<SharedIngest*>(data); });
+  ElementAdd(sink);
+  ElementLink(last, sink);
+  return tee;
+}
+
 void IBaseBuilder::HandleInputSrcPadCreated(pad::Pad* pad, element_id_t id, const common::uri::Url& url) {
   if (observer_) {
     observer_->OnInpudSrcPadCreated(pad, id, url);
@@ -126,8 +458,53 @@ void IBaseBuilder::HandleOutputSinkPadCreated(pad::Pad* pad,
   }
 }
 
-bool IBaseBuilder::CreatePipeLine(GstElement** pipeline, elements_line_t* elements) {
-  if (!elements) {
+void IBaseBuilder::HandleLatencyPadCreated(pad::Pad* pad, LatencyStage stage) {
+  if (observer_) {
+    observer_->OnLatencyPadCreated(pad, stage);
+  }
+}
+
+void IBaseBuilder::HandleOutputQueueCreated(elements::Element* queue, element_id_t id) {
+  if (observer_) {
+    observer_->OnOutputQueueCreated(queue, id);
+  }
+}
+
+void IBaseBuilder::HandleOutputBranchQueueCreated(elements::Element* queue, element_id_t id) {
+  if (observer_) {
+    observer_->OnOutputBranchQueueCreated(queue, id);
+  }
+}
+
+void IBaseBuilder::HandleAudioMeterPadCreated(pad::Pad* pad, element_id_t id) {
+  if (observer_) {
+    observer_->OnAudioMeterPadCreated(pad, id);
+  }
+}
+
+void IBaseBuilder::HandleVideoMeterPadCreated(pad::Pad* pad, element_id_t id) {
+  if (observer_) {
+    observer_->OnVideoMeterPadCreated(pad, id);
+  }
+}
+
+void IBaseBuilder::HandleThumbnailPadCreated(pad::Pad* pad) {
+  if (observer_) {
+    observer_->OnThumbnailPadCreated(pad);
+  }
+}
+
+void IBaseBuilder::HandleOutputBranchCreated(element_id_t id,
+                                             elements::Element* video_queue,
+                                             elements::Element* audio_queue,
+                                             const elements_line_t& downstream) {
+  if (observer_) {
+    observer_->OnOutputBranchCreated(id, video_queue, audio_queue, downstream);
+  }
+}
+
+bool IBaseBuilder::CreatePipeLine(GstElement** pipeline, elements_line_t* elements, ElementsRegistry* registry) {
+  if (!elements || !registry) {
     return false;
   }
 
@@ -136,6 +513,7 @@ bool IBaseBuilder::CreatePipeLine(GstElement** pipeline, elements_line_t* elemen
   }
 
   *elements = pipeline_elements_;
+  *registry = registry_;
   *pipeline = pipeline_;
   return true;
 }
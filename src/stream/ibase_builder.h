@@ -15,12 +15,14 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <gst/gstelement.h>
 
 #include <common/uri/url.h>
 
 #include "stream/config.h"
+#include "stream/elements_registry.h"
 #include "stream/gst_types.h"
 #include "stream/ilinker.h"
 #include "stream/stypes.h"
@@ -29,6 +31,12 @@ namespace fastocloud {
 namespace stream {
 
 class IBaseBuilderObserver;
+class SharedIngest;
+
+namespace elements {
+class ElementQueue;
+class ElementTee;
+}
 
 namespace pad {
 class Pad;
@@ -41,7 +49,9 @@ class IBaseBuilder : public ILinker {
 
   const Config* GetConfig() const;
 
-  bool CreatePipeLine(GstElement** pipeline, elements_line_t* elements) WARN_UNUSED_RESULT;
+  bool CreatePipeLine(GstElement** pipeline,
+                      elements_line_t* elements,
+                      ElementsRegistry* registry) WARN_UNUSED_RESULT;
 
   elements::Element* GetElementByName(const std::string& name) const;
 
@@ -53,19 +63,54 @@ class IBaseBuilder : public ILinker {
  protected:
   IBaseBuilderObserver* GetObserver() const;
 
+  void RegisterElement(ElementRole role, element_id_t id, elements::Element* elem);  // added before
+
   elements::Element* BuildGenericOutput(const OutputUri& output, element_id_t sink_id);
   virtual elements::Element* CreateSink(const OutputUri& output, element_id_t sink_id);
+  // udp outputs sharing one branch, first builds it, empty if fan-out off or less than two
+  std::vector<element_id_t> GetFanoutOutputs() const;
+  elements::Element* BuildFanoutOutput(const std::vector<element_id_t>& fanout);
+  static bool IsFanoutFollower(const std::vector<element_id_t>& fanout, element_id_t id);
+
+  // tee branch queue of output, leaky with drops counted if configured
+  void SetupOutputQueue(elements::ElementQueue* queue, element_id_t output_id);
+  // queue policy: time limit is share of target latency for queues on path from input to sink, buffers count not
+  // limited, bytes derived from bitrate for encoded data, raw frames keep element bytes limit
+  void SetupQueue(elements::ElementQueue* queue, bool encoded) const;
+  virtual fastotv::timestamp_t GetLatencyTarget() const;  // msec, config or DEFAULT_LATENCY_TARGET_MSEC
+  virtual bit_rate_t GetQueueBitrate() const;             // kbps of encoded data, unknown by default
 
   virtual bool InitPipeline() WARN_UNUSED_RESULT = 0;
 
+  // source of input added to pipeline, live network inputs shared with other streams of node if ingest dir set,
+  // tuned program of mpts input split at ts level, returns element to link decoding or parsing to
+  elements::Element* BuildInputSource(const InputUri& uri, element_id_t input_id);
+  // rtsp session shared with other streams of node if ingest dir set, publisher links rtp pad to ingest tee,
+  // true if rtp packets of other stream session are read and rtspsrc is not needed
+  bool BuildRtspIngest(const InputUri& uri, element_id_t input_id, elements::Element* decodebin);
+
   void HandleInputSrcPadCreated(pad::Pad* pad, element_id_t id, const common::uri::Url& url);
   void HandleOutputSinkPadCreated(pad::Pad* pad, element_id_t id, const common::uri::Url& url, bool need_push);
+  void HandleLatencyPadCreated(pad::Pad* pad, LatencyStage stage);
+  void HandleOutputQueueCreated(elements::Element* queue, element_id_t id);
+  void HandleOutputBranchQueueCreated(elements::Element* queue, element_id_t id);
+  void HandleAudioMeterPadCreated(pad::Pad* pad, element_id_t id);
+  void HandleVideoMeterPadCreated(pad::Pad* pad, element_id_t id);
+  void HandleThumbnailPadCreated(pad::Pad* pad);
+  void HandleOutputBranchCreated(element_id_t id,
+                                 elements::Element* video_queue,
+                                 elements::Element* audio_queue,
+                                 const elements_line_t& downstream);
 
  private:
+  // tee with leaky branch to shm sink owning ingest lock, gdp framing if caps are not in bytes
+  elements::ElementTee* BuildIngestPublisher(SharedIngest* ingest, bool with_caps, element_id_t input_id);
+
   const Config* const config_;
   IBaseBuilderObserver* const observer_;
   GstElement* const pipeline_;
   elements_line_t pipeline_elements_;
+  ElementsRegistry registry_;
 };
 
 }  // namespace stream
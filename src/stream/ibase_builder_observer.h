@@ -16,6 +16,9 @@
 
 #include <common/uri/url.h>
 
+#include "base/latency_histogram.h"
+
+#include "stream/gst_types.h"
 #include "stream/stypes.h"
 
 namespace fastocloud {
@@ -32,6 +35,17 @@ class IBaseBuilderObserver {
                                       element_id_t id,
                                       const common::uri::Url& url,
                                       bool need_push) = 0;
+  virtual void OnLatencyPadCreated(pad::Pad* pad, LatencyStage stage) = 0;
+  virtual void OnOutputQueueCreated(elements::Element* queue, element_id_t id) = 0;  // leaky output branch
+  virtual void OnOutputBranchQueueCreated(elements::Element* queue, element_id_t id) = 0;  // head of every branch
+  virtual void OnAudioMeterPadCreated(pad::Pad* pad, element_id_t id) = 0;  // decoded audio of input
+  virtual void OnVideoMeterPadCreated(pad::Pad* pad, element_id_t id) = 0;  // decoded video of input
+  virtual void OnThumbnailPadCreated(pad::Pad* pad) = 0;                     // parsed video of input
+  // restartable output, queues (nullptr if absent) linked to tees, downstream after them in link order
+  virtual void OnOutputBranchCreated(element_id_t id,
+                                     elements::Element* video_queue,
+                                     elements::Element* audio_queue,
+                                     const elements_line_t& downstream) = 0;
 
   virtual ~IBaseBuilderObserver();
 };
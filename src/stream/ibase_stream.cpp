@@ -18,14 +18,22 @@
 #include <X11/Xlib.h>
 #endif
 
+#if defined(OS_POSIX)
+#include <unistd.h>
+#endif
+
 #include <gst/base/gstbasesrc.h>  // for GstBaseSrc
 #include <gst/video/video.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include <common/convert2string.h>
+#include <common/file_system/string_path_utils.h>
 #include <common/sprintf.h>
 #include <common/time.h>
 
@@ -35,12 +43,21 @@
 #include "stream/dumpers/dumpers_factory.h"
 #include "stream/elements/element.h"
 #include "stream/elements/sink/http.h"
+#include "stream/elements/sink/srt.h"
+#include "stream/elements_pool.h"
 #include "stream/gstreamer_utils.h"
+#include "stream/hot_log.h"
 #include "stream/ibase_builder.h"
+#include "stream/link_cache.h"
+#include "stream/net_clock.h"
+#include "stream/output_branch.h"
+#include "stream/pad/pad.h"
 #include "stream/probes.h"  // for Probe (ptr only), PROBE_IN, PROBE_OUT
+#include "stream/stream_profiler.h"
+#include "stream/streaming_task_pool.h"
+#include "stream/thumbnailer.h"
+#include "stream/udp_socket_stats.h"
 
-#define MIN_OUT_DATA(SEC) 4 * 1024 * SEC  // 4 kBps
-#define MIN_IN_DATA(SEC) 4 * 1024 * SEC   // 4 kBps
 #define DEFAULT_FRAMERATE 25
 #define MFX_ENV "iHD"
 #define MFX_DRIVER_PATH "/usr/local/lib/dri/"
@@ -48,6 +65,10 @@
 #define VAAPI_I965_ENV "i965"
 #define VAAPI_I965_DRIVER_PATH "/usr/local/lib/dri/"
 
+#define EXIT_MESSAGE_NAME "exit_info"
+#define LIVE_CONFIG_MESSAGE_NAME "live_config"
+#define PROFILE_MESSAGE_NAME "profile"
+
 #if defined(OS_WIN)
 int setenv(const char* key, const char* value, int set) {
   UNUSED(set);
@@ -62,21 +83,24 @@ void remove_notify_callback(gpointer user_data) {
   UNUSED(user_data);
 }
 
-struct ctx_holder {
-  static ctx_holder* instance() {
-    static ctx_holder inst;
-    return &inst;
-  }
-  GMainContext* ctx;
+// sources on context of loop, streams of relay host run each in own thread default context
+guint attach_timeout(GMainLoop* loop, guint interval_msec, GSourceFunc func, gpointer user_data) {
+  GSource* source = g_timeout_source_new(interval_msec);
+  g_source_set_callback(source, func, user_data, nullptr);
+  guint id = g_source_attach(source, g_main_loop_get_context(loop));
+  g_source_unref(source);
+  return id;
+}
 
- private:
-  ctx_holder() {
-    ctx = g_main_context_default();  // 1 ref
-  }
-  ~ctx_holder() {
-    g_main_context_unref(ctx);  //
+bool remove_source(GMainLoop* loop, guint id) {
+  GSource* source = g_main_context_find_source_by_id(g_main_loop_get_context(loop), id);
+  if (!source) {
+    return false;
   }
-};
+
+  g_source_destroy(source);
+  return true;
+}
 
 void RedirectGstLog(GstDebugCategory* category,
                     GstDebugLevel level,
@@ -91,25 +115,68 @@ void RedirectGstLog(GstDebugCategory* category,
   UNUSED(message);
   UNUSED(category);
 
+  common::logging::LOG_LEVEL log_level;
   if (level == GST_LEVEL_ERROR) {
-    ERROR_LOG() << gst_debug_category_get_name(category) << " " << file << ":" << line << " " << function << " "
-                << gst_debug_message_get(message);
+    log_level = common::logging::LOG_LEVEL_ERR;
   } else if (level == GST_LEVEL_WARNING) {
-    WARNING_LOG() << gst_debug_category_get_name(category) << " " << file << ":" << line << " " << function << " "
-                  << gst_debug_message_get(message);
+    log_level = common::logging::LOG_LEVEL_WARNING;
   } else if (level == GST_LEVEL_FIXME) {
-    NOTICE_LOG() << gst_debug_category_get_name(category) << " " << file << ":" << line << " " << function << " "
-                 << gst_debug_message_get(message);
-  } else if (level == GST_LEVEL_INFO) {
-    INFO_LOG() << gst_debug_category_get_name(category) << " " << file << ":" << line << " " << function << " "
-               << gst_debug_message_get(message);
-  } else if (level == GST_LEVEL_LOG) {
-    INFO_LOG() << gst_debug_category_get_name(category) << " " << file << ":" << line << " " << function << " "
-               << gst_debug_message_get(message);
+    log_level = common::logging::LOG_LEVEL_NOTICE;
+  } else if (level == GST_LEVEL_INFO || level == GST_LEVEL_LOG) {
+    log_level = common::logging::LOG_LEVEL_INFO;
   } else if (level == GST_LEVEL_DEBUG) {
-    DEBUG_LOG() << gst_debug_category_get_name(category) << " " << file << ":" << line << " " << function << " "
-                << gst_debug_message_get(message);
+    log_level = common::logging::LOG_LEVEL_DEBUG;
+  } else {
+    return;
+  }
+
+  // called from streaming threads, written by log thread
+  fastocloud::stream::HotLogWriter& writer = fastocloud::stream::HotLogWriter::GetInstance();
+  if (!writer.IsEnabled(log_level)) {
+    return;
+  }
+  std::ostringstream text;
+  text << gst_debug_category_get_name(category) << " " << file << ":" << line << " " << function << " "
+       << gst_debug_message_get(message);
+  writer.Write(log_level, text.str());
+}
+
+struct BackendTiming {
+  fastotv::timestamp_t gst_init_msec;
+  fastotv::timestamp_t preload_msec;
+  size_t preloaded;
+  long pid;  // process inited backend, children of zygote inherit it
+};
+
+BackendTiming backend_timing = {0, 0, 0, 0};
+
+long current_process_id() {
+#if defined(OS_POSIX)
+  return getpid();
+#else
+  return 0;
+#endif
+}
+
+size_t loaded_plugins_count() {
+  size_t count = 0;
+  GList* plugins = gst_registry_get_plugin_list(gst_registry_get());
+  for (GList* it = plugins; it; it = it->next) {
+    if (gst_plugin_is_loaded(GST_PLUGIN(it->data))) {
+      count++;
+    }
   }
+  gst_plugin_list_free(plugins);
+  return count;
+}
+
+// not-negotiated flow returns posted by base classes as stream failures
+bool is_negotiation_error(const GError* err, const gchar* debug) {
+  if (!err) {
+    return false;
+  }
+  return g_error_matches(err, GST_CORE_ERROR, GST_CORE_ERROR_NEGOTIATION) ||
+         g_error_matches(err, GST_STREAM_ERROR, GST_STREAM_ERROR_FORMAT) || (debug && strstr(debug, "not-negotiated"));
 }
 
 }  // namespace
@@ -118,14 +185,7 @@ namespace fastocloud {
 namespace stream {
 
 void streams_init(int argc, char** argv, EncoderType enc) {
-  if (gst_is_initialized()) {
-    return;
-  }
-
-#ifdef HAVE_X11
-  XInitThreads();
-#endif
-
+  // backend can be already inited by zygote, but encoder enviroment is per stream
   if (enc == GPU_MFX) {
     int res = setenv("LIBVA_DRIVER_NAME", MFX_ENV, 1);
     if (res == ERROR_RESULT_VALUE) {
@@ -148,6 +208,15 @@ void streams_init(int argc, char** argv, EncoderType enc) {
                        "to " VAAPI_I965_DRIVER_PATH;
     }
   }
+
+  if (gst_is_initialized()) {
+    return;
+  }
+
+#ifdef HAVE_X11
+  XInitThreads();
+#endif
+
   if (common::logging::CURRENT_LOG_LEVEL() == common::logging::LOG_LEVEL_DEBUG) {
     int res = setenv("GST_DEBUG", "3", 1);
     if (res == SUCCESS_RESULT_VALUE) {
@@ -155,7 +224,10 @@ void streams_init(int argc, char** argv, EncoderType enc) {
     }
   }
 
+  const fastotv::timestamp_t init_start_ts = common::time::current_utc_mstime();
   gst_init(&argc, &argv);
+  backend_timing.gst_init_msec = common::time::current_utc_mstime() - init_start_ts;
+  backend_timing.pid = current_process_id();
   const char* va_dr_name = getenv("LIBVA_DRIVER_NAME");
   if (!va_dr_name) {
     va_dr_name = "(null)";
@@ -167,7 +239,50 @@ void streams_init(int argc, char** argv, EncoderType enc) {
   DEBUG_LOG() << "Stream backend inited, LIBVA_DRIVER_NAME=" << va_dr_name << ", LIBVA_DRIVERS_PATH=" << va_dr_path;
 }
 
+void streams_preload_plugins() {
+  // relay, encode and decodebin autoplugged elements
+  const char* elements[] = {elements::ElementsTraits<elements::ELEMENT_QUEUE>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_QUEUE2>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_TEE>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_UDP_SRC>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_UDP_SINK>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_SOUP_HTTP_SRC>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_SRT_SRC>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_SRT_SINK>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_TCP_SERVER_SINK>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_RTMP_SINK>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_HLS_SINK>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_HLS_DEMUX>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_TS_PARSE>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_TS_DEMUX>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_MPEGTS_MUX>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_FLV_MUX>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_H264_PARSE>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_H265_PARSE>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_AAC_PARSE>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_DECODEBIN>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_AVDEC_H264>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_VIDEO_CONVERT>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_VIDEO_SCALE>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_AUDIO_CONVERT>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_AUDIO_RESAMPLE>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_X264_ENC>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_FAAC>::name(),
+                            elements::ElementsTraits<elements::ELEMENT_VOAAC_ENC>::name()};
+
+  const fastotv::timestamp_t start_ts = common::time::current_utc_mstime();
+  for (const char* name : elements) {
+    ignore_result(find_element_factory(name));  // loaded factories are inherited by children
+  }
+  backend_timing.preload_msec = common::time::current_utc_mstime() - start_ts;
+  backend_timing.preloaded = loaded_plugins_count();
+  INFO_LOG() << "Plugins preloaded: " << backend_timing.preloaded << ", time: " << backend_timing.preload_msec
+             << " msec.";
+}
+
 void streams_deinit() {
+  ElementsPool::GetInstance().Clear();
+  clear_element_factories();
   gst_deinit();
 }
 
@@ -179,10 +294,39 @@ IBaseStream::IBaseStream(const Config* config, IStreamClient* client, StreamStru
       config_(config),
       probe_in_(),
       probe_out_(),
-      loop_(g_main_loop_new(ctx_holder::instance()->ctx, FALSE)),
+      probe_latency_(),
+      probe_queue_(),
+      probe_audio_(),
+      probe_video_(),
+      probe_gate_(),
+      thumbnailer_(nullptr),
+      content_failed_(false),
+      outputs_muted_(false),
+      output_branches_(),
+      live_update_mutex_(),
+      live_update_(),
+      profile_path_(),
+      profile_dump_path_(),
+      profile_duration_(0),
+      loop_(g_main_loop_new(g_main_context_get_thread_default(), FALSE)),
       pipeline_(nullptr),
+      pipeline_elements_(),
+      elements_registry_(),
+      qos_dropped_(),
+      profiler_(nullptr),
+      profiler_path_(),
+      profiler_dump_path_(),
+      profile_timer_id_(0),
       status_tick_(0),
-      no_data_panic_tick_(0),
+      no_data_panic_ts_(0),
+      checkpoint_ts_(0),
+      last_tick_ts_(0),
+      play_ts_(0),
+      build_msec_(0),
+      preloaded_plugins_(0),
+      first_input_ts_(0),
+      first_output_ts_(0),
+      startup_logged_(false),
       stats_(stats),
       last_exit_status_(EXIT_INNER),
       is_live_(false),
@@ -202,6 +346,20 @@ void IBaseStream::LinkInputPad(GstPad* pad, element_id_t id, const common::uri::
   InputProbe* probe = new InputProbe(id, url, this);
   probe->Link(pad);
   probe_in_.push_back(probe);
+  LinkLatencyPad(pad, INPUT_LATENCY_STAGE);
+}
+
+void IBaseStream::RelinkInputPad(GstPad* pad, element_id_t id, const common::uri::Url& url) {
+  CollectProbesStats();
+  for (auto it = probe_in_.begin(); it != probe_in_.end();) {
+    if ((*it)->GetID() == id) {
+      delete *it;
+      it = probe_in_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  LinkInputPad(pad, id, url);
 }
 
 void IBaseStream::LinkOutputPad(GstPad* pad, element_id_t id, const common::uri::Url& url, bool need_push) {
@@ -209,17 +367,119 @@ void IBaseStream::LinkOutputPad(GstPad* pad, element_id_t id, const common::uri:
   OutputProbe* probe = new OutputProbe(id, url, need_push, this);
   probe->Link(pad);
   probe_out_.push_back(probe);
+  LinkLatencyPad(pad, OUTPUT_LATENCY_STAGE);
+}
+
+void IBaseStream::UnlinkOutputPads(element_id_t id) {
+  for (auto it = probe_out_.begin(); it != probe_out_.end();) {
+    if ((*it)->GetID() == id) {
+      delete *it;
+      it = probe_out_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void IBaseStream::LinkLatencyPad(GstPad* pad, LatencyStage stage) {
+  if (!config_->GetLatencyStats()) {
+    return;
+  }
+
+  DEBUG_LOG() << "LatencyPad created stage: " << common::ConvertToString(stage);
+  LatencyProbe* probe = new LatencyProbe(stage);
+  probe->Link(pad);
+  probe_latency_.push_back(probe);
+}
+
+void IBaseStream::OnLatencyPadCreated(pad::Pad* pad, LatencyStage stage) {
+  LinkLatencyPad(pad->GetGstPad(), stage);
+}
+
+AudioMeterProbe* IBaseStream::LinkAudioMeterPad(GstPad* pad, element_id_t id) {
+  AudioMeterProbe* probe = new AudioMeterProbe(id);
+  probe->Link(pad);
+  probe_audio_.push_back(probe);
+  return probe;
+}
+
+void IBaseStream::OnAudioMeterPadCreated(pad::Pad* pad, element_id_t id) {
+  ignore_result(LinkAudioMeterPad(pad->GetGstPad(), id));
+}
+
+void IBaseStream::OnVideoMeterPadCreated(pad::Pad* pad, element_id_t id) {
+  VideoMeterProbe* probe = new VideoMeterProbe(id);
+  probe->Link(pad->GetGstPad());
+  probe_video_.push_back(probe);
+}
+
+void IBaseStream::OnThumbnailPadCreated(pad::Pad* pad) {
+  destroy(&thumbnailer_);
+  thumbnailer_ = new Thumbnailer(config_->GetThumbnail());
+  thumbnailer_->Link(pad->GetGstPad());
+}
+
+void IBaseStream::OnOutputQueueCreated(elements::Element* queue, element_id_t id) {
+  QueueDropProbe* probe = new QueueDropProbe(id);
+  probe->Link(queue->GetGstElement());
+  probe_queue_.push_back(probe);
+}
+
+void IBaseStream::OnOutputBranchQueueCreated(elements::Element* queue, element_id_t id) {
+  // cods parked as warm by daemon muted while running
+  const fastotv::StreamType type = config_->GetType();
+  const bool remutable = type == fastotv::COD_RELAY || type == fastotv::COD_ENCODE;
+  if (!outputs_muted_ && !remutable) {
+    return;
+  }
+
+  pad::Pad* src_pad = queue->StaticPad("src");
+  if (src_pad->IsValid()) {
+    OutputGateProbe* probe = new OutputGateProbe(id, &outputs_muted_, remutable);
+    probe->Link(src_pad->GetGstPad());
+    probe_gate_.push_back(probe);
+  }
+  delete src_pad;
+}
+
+void IBaseStream::OnOutputBranchCreated(element_id_t id,
+                                        elements::Element* video_queue,
+                                        elements::Element* audio_queue,
+                                        const elements_line_t& downstream) {
+  OutputBranch* branch = new OutputBranch(id);
+  if (video_queue) {
+    branch->AddInput(video_queue->GetGstElement(), true);
+    branch->AddElement(video_queue->GetGstElement());
+  }
+  if (audio_queue) {
+    branch->AddInput(audio_queue->GetGstElement(), false);
+    branch->AddElement(audio_queue->GetGstElement());
+  }
+  for (elements::Element* element : downstream) {
+    branch->AddElement(element->GetGstElement());
+  }
+  output_branches_.push_back(branch);
 }
 
 void IBaseStream::PreExecCleanup(time_t old_life_time) {
   const fastotv::timestamp_t cur_timestamp = common::time::current_utc_mstime();
   const fastotv::timestamp_t max_life_time = IsVod() ? cur_timestamp : cur_timestamp - old_life_time * 1000;
+  const std::string trash_dir = config_->GetOutputTrashDir();
   for (const OutputUri& output : config_->GetOutput()) {
     common::uri::Url uri = output.GetOutput();
     common::uri::Url::scheme scheme = uri.GetScheme();
 
     if (scheme == common::uri::Url::http) {
       const common::file_system::ascii_directory_string_path http_path = output.GetHttpRoot();
+#if defined(OS_POSIX)
+      if (IsVod() && !trash_dir.empty()) {  // nothing kept, folder renamed aside and removed by daemon
+        const std::string trashed = common::MemSPrintf("%d_%s_%s", getpid(), common::ConvertToString(output.GetID()),
+                                                       common::ConvertToString(cur_timestamp));
+        if (MoveOutputDirToTrash(http_path.GetPath(), common::file_system::make_path(trash_dir, trashed))) {
+          continue;
+        }
+      }
+#endif
       RemoveOldFilesByTime(http_path, max_life_time / 1000, "*" CHUNK_EXT);
     }
   }
@@ -229,7 +489,7 @@ void IBaseStream::PostExecCleanup() {}
 
 bool IBaseStream::InitPipeLine() {
   IBaseBuilder* builder = CreateBuilder();
-  if (!builder->CreatePipeLine(&pipeline_, &pipeline_elements_)) {
+  if (!builder->CreatePipeLine(&pipeline_, &pipeline_elements_, &elements_registry_)) {
     delete builder;
     return false;
   }
@@ -239,11 +499,227 @@ bool IBaseStream::InitPipeLine() {
   }
 
   delete builder;
+  ApplyClock();
+  ApplyHlsMaxFiles(config_->GetHlsMaxFiles());
   DEBUG_LOG() << "Pipeline for: " << ClassName() << " created";
   return true;
 }
 
+void IBaseStream::ApplyClock() {
+  GstPipeline* pipeline = GST_PIPELINE(pipeline_);
+  const fastotv::timestamp_t latency = config_->GetPipelineLatencyMsec();
+  if (latency) {
+    gst_pipeline_set_latency(pipeline, latency * GST_MSECOND);
+  }
+
+  if (!config_->GetClockSync()) {
+    gst_pipeline_use_clock(pipeline, nullptr);
+    return;
+  }
+
+  const std::string net_clock = config_->GetNetClock();
+  if (net_clock.empty()) {
+    return;
+  }
+
+  GstClock* clock = obtain_net_clock(net_clock);
+  if (!clock) {
+    return;
+  }
+
+  // running time equals clock time, same timestamps on every node of clock
+  gst_pipeline_use_clock(pipeline, clock);
+  gst_element_set_start_time(pipeline_, GST_CLOCK_TIME_NONE);
+  gst_element_set_base_time(pipeline_, 0);
+  gst_object_unref(clock);
+}
+
+void IBaseStream::ApplyHlsMaxFiles(size_t max_files) {
+  if (!max_files || !pipeline_ || !GST_IS_BIN(pipeline_)) {
+    return;
+  }
+
+  // ll-hls and cmaf sinks keep own segments
+  GstIterator* it = gst_bin_iterate_recurse(GST_BIN(pipeline_));
+  GValue item = G_VALUE_INIT;
+  bool done = false;
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK: {
+        GstElement* element = GST_ELEMENT(g_value_get_object(&item));
+        if (elements::Element::GetPluginName(element) == elements::sink::ElementHLSSink::GetPluginName()) {
+          elements::sink::ElementHLSSink* hls_sink = new elements::sink::ElementHLSSink("sink", element);
+          hls_sink->SetMaxFiles(max_files);
+          delete hls_sink;
+        }
+        g_value_reset(&item);
+        break;
+      }
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync(it);
+        break;
+      case GST_ITERATOR_ERROR:
+      case GST_ITERATOR_DONE:
+        done = true;
+        break;
+    }
+  }
+  g_value_unset(&item);
+  gst_iterator_free(it);
+}
+
+void IBaseStream::CollectProbesStats() {
+  uint64_t bytes = 0;
+  uint64_t packets = 0;
+  for (InputProbe* probe : probe_in_) {
+    const element_id_t id = probe->GetID();
+    probe->TakeData(&bytes, &packets);
+    if (packets && id < stats_->input.size()) {
+      ChannelStats* stat = &stats_->input[id];
+      stat->SetTotalBytes(stat->GetTotalBytes() + bytes);
+      stat->SetTotalPackets(stat->GetTotalPackets() + packets);
+      stat->SetLastUpdateTime(probe->GetLastBufferTime());
+    }
+
+    uint64_t drops;
+    if (id < stats_->input.size() && GetInputSocketDrops(probe, &drops)) {
+      stats_->input[id].SetTotalDrops(drops);
+    }
+  }
+
+  for (OutputProbe* probe : probe_out_) {
+    const element_id_t id = probe->GetID();
+    probe->TakeData(&bytes, &packets);
+    if (packets && id < stats_->output.size()) {
+      ChannelStats* stat = &stats_->output[id];
+      stat->SetTotalBytes(stat->GetTotalBytes() + bytes);
+      stat->SetTotalPackets(stat->GetTotalPackets() + packets);
+      stat->SetLastUpdateTime(probe->GetLastBufferTime());
+    }
+
+    if (id < stats_->output.size() && probe->GetUrl().GetScheme() == common::uri::Url::srt) {
+      CollectSrtPeers(probe, &stats_->output[id]);
+    }
+  }
+
+  for (LatencyProbe* probe : probe_latency_) {
+    probe->TakeData(&stats_->latency[probe->GetStage()]);
+  }
+
+  for (QueueDropProbe* probe : probe_queue_) {  // several probes per output, audio and video branches
+    const element_id_t id = probe->GetID();
+    const uint64_t drops = probe->TakeDrops();
+    if (drops && id < stats_->output.size()) {
+      ChannelStats* stat = &stats_->output[id];
+      stat->SetTotalDrops(stat->GetTotalDrops() + drops);
+    }
+  }
+
+  for (AudioMeterProbe* probe : probe_audio_) {
+    if (probe->GetLevel(&stats_->audio_rms, &stats_->audio_peak, &stats_->audio_silence)) {
+      LoudnessMeter::Loudness loudness;
+      if (probe->GetLoudness(&loudness)) {
+        stats_->audio_loudness = loudness.momentary;
+        stats_->audio_loudness_integrated = loudness.integrated;
+      }
+      break;
+    }
+  }
+
+  for (VideoMeterProbe* probe : probe_video_) {
+    if (probe->GetState(&stats_->video_black, &stats_->video_freeze)) {
+      break;
+    }
+  }
+}
+
+bool IBaseStream::GetInputSocketDrops(InputProbe* probe, uint64_t* drops) const {
+  if (probe->GetUrl().GetScheme() != common::uri::Url::udp || !probe->GetPad()) {
+    return false;
+  }
+
+  GstElement* src = gst_pad_get_parent_element(probe->GetPad());
+  if (!src) {
+    return false;
+  }
+
+  const int fd = get_element_socket_fd(src);
+  gst_object_unref(src);
+  return get_udp_socket_drops(fd, drops);
+}
+
+void IBaseStream::CollectSrtPeers(OutputProbe* probe, ChannelStats* stat) const {
+  if (!probe->GetPad()) {
+    return;
+  }
+
+  GstElement* sink = gst_pad_get_parent_element(probe->GetPad());
+  if (!sink) {
+    return;
+  }
+
+  PeerStats peers[CHANNEL_STATS_MAX_PEERS];
+  const size_t count = elements::sink::get_srt_sink_peers(sink, peers, CHANNEL_STATS_MAX_PEERS);
+  gst_object_unref(sink);
+  stat->SetPeers(peers, count);
+}
+
+void IBaseStream::CollectQueueLevels() {
+  int queue_fill = 0;
+  guint64 queue_time = 0;
+  for (elements::Element* el : pipeline_elements_) {
+    const std::string plugin = el->GetPluginName();
+    if (plugin != elements::ElementQueue::GetPluginName() && plugin != elements::ElementQueue2::GetPluginName()) {
+      continue;
+    }
+
+    int fill = 0;
+    guint64 level_time = 0;
+    if (get_queue_level(el->GetGstElement(), &fill, &level_time)) {
+      queue_fill = std::max(queue_fill, fill);
+      queue_time = std::max(queue_time, level_time);
+    }
+  }
+  stats_->queue_fill = queue_fill;
+  stats_->queue_time = GST_TIME_AS_MSECONDS(queue_time);
+}
+
+void IBaseStream::CollectProgress() {
+  if (!IsVod()) {
+    return;
+  }
+
+  gint64 position = 0;
+  gint64 duration = 0;
+  if (!gst_element_query_position(pipeline_, GST_FORMAT_TIME, &position) ||
+      !gst_element_query_duration(pipeline_, GST_FORMAT_TIME, &duration) || duration <= 0) {
+    return;
+  }
+
+  stats_->progress = static_cast<int>(std::min<gint64>(std::max<gint64>(position, 0) * 100 / duration, 100));
+}
+
+void IBaseStream::HandleQosMessage(GstMessage* message) {
+  GstFormat format;
+  guint64 processed = 0, dropped = 0;
+  gst_message_parse_qos_stats(message, &format, &processed, &dropped);
+  stats_->qos_events++;
+  if (format != GST_FORMAT_BUFFERS || dropped == static_cast<guint64>(-1)) {
+    return;
+  }
+
+  // drops are totals of element, counted once
+  gchar* name = gst_object_get_name(GST_MESSAGE_SRC(message));
+  guint64& last = qos_dropped_[name ? name : ""];
+  g_free(name);
+  if (dropped > last) {
+    stats_->qos_dropped += dropped - last;
+  }
+  last = dropped;
+}
+
 void IBaseStream::ClearOutProbes() {
+  CollectProbesStats();
   for (OutputProbe* probe : probe_out_) {
     delete probe;
   }
@@ -251,12 +727,91 @@ void IBaseStream::ClearOutProbes() {
 }
 
 void IBaseStream::ClearInProbes() {
+  CollectProbesStats();
   for (InputProbe* probe : probe_in_) {
     delete probe;
   }
   probe_in_.clear();
 }
 
+void IBaseStream::ClearLatencyProbes() {
+  CollectProbesStats();
+  for (LatencyProbe* probe : probe_latency_) {
+    delete probe;
+  }
+  probe_latency_.clear();
+}
+
+void IBaseStream::ClearOutputBranches() {
+  for (OutputBranch* branch : output_branches_) {
+    delete branch;
+  }
+  output_branches_.clear();
+}
+
+void IBaseStream::ClearQueueProbes() {
+  CollectProbesStats();
+  for (QueueDropProbe* probe : probe_queue_) {
+    delete probe;
+  }
+  probe_queue_.clear();
+}
+
+void IBaseStream::ClearGateProbes() {
+  for (OutputGateProbe* probe : probe_gate_) {
+    delete probe;
+  }
+  probe_gate_.clear();
+}
+
+void IBaseStream::ClearAudioMeterProbes() {
+  CollectProbesStats();
+  for (AudioMeterProbe* probe : probe_audio_) {
+    delete probe;
+  }
+  probe_audio_.clear();
+}
+
+bool IBaseStream::GetAudioLoudness(double* short_term_lufs, int* peak_db) const {
+  for (AudioMeterProbe* probe : probe_audio_) {
+    LoudnessMeter::Loudness loudness;
+    fastotv::timestamp_t silence_msec;
+    int rms_db;
+    if (probe->GetLoudness(&loudness) && probe->GetLevel(&rms_db, peak_db, &silence_msec)) {
+      *short_term_lufs = loudness.short_term;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IBaseStream::GetVideoMotion(uint32_t* motion) const {
+  for (VideoMeterProbe* probe : probe_video_) {
+    if (probe->GetMotion(motion)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IBaseStream::IsContentFailed() const {
+  const fastotv::timestamp_t content_failover_msec = config_->GetContentFailoverMsec();
+  if (!content_failover_msec) {
+    return false;
+  }
+
+  return stats_->video_black >= content_failover_msec || stats_->video_freeze >= content_failover_msec ||
+         stats_->audio_silence >= content_failover_msec;
+}
+
+void IBaseStream::ClearVideoMeterProbes() {
+  CollectProbesStats();
+  for (VideoMeterProbe* probe : probe_video_) {
+    delete probe;
+  }
+  probe_video_.clear();
+}
+
 size_t IBaseStream::CountInputEOS() const {
   size_t count_in_eos = 0;
   std::map<element_id_t, Consistency> probes_statuses;
@@ -311,10 +866,26 @@ IBaseStream::~IBaseStream() {
   g_main_loop_unref(loop_);
   ClearOutProbes();
   ClearInProbes();
+  ClearLatencyProbes();
+  ClearQueueProbes();
+  ClearAudioMeterProbes();
+  ClearVideoMeterProbes();
+  ClearGateProbes();
+  destroy(&thumbnailer_);
+  ClearOutputBranches();
+  if (pipeline_) {
+    // hardware encoders stay open for next start of stream in this process
+    SetPipelineState(GST_STATE_READY);
+    const size_t parked = ElementsPool::GetInstance().Park(GST_BIN(pipeline_));
+    if (parked) {
+      INFO_LOG() << "Parked elements: " << parked;
+    }
+  }
   for (elements::Element* el : pipeline_elements_) {
     delete el;
   }
   pipeline_elements_.clear();
+  elements_registry_.Clear();
   // pipeline
 
   SetPipelineState(GST_STATE_NULL);
@@ -328,12 +899,19 @@ IBaseStream::~IBaseStream() {
 ExitStatus IBaseStream::Exec() {
   PreExecCleanup(cleanup_life_period_sec);
 
+  preloaded_plugins_ = loaded_plugins_count();
+  const fastotv::timestamp_t build_start_ts = common::time::current_utc_mstime();
   if (!InitPipeLine()) {
     return EXIT_INNER;
   }
+  build_msec_ = common::time::current_utc_mstime() - build_start_ts;
+  first_input_ts_ = 0;
+  first_output_ts_ = 0;
+  startup_logged_ = false;
 
   GstBus* bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline_));
-  guint main_timeout_id = g_timeout_add(main_timer_msecs, main_timer_callback, this);
+  guint main_timeout_id = attach_timeout(loop_, config_->GetWatchdogMsec(), main_timer_callback, this);
+  last_tick_ts_ = common::time::current_utc_mstime();
 
   gst_bus_set_sync_handler(bus, sync_bus_callback, this, remove_notify_callback);
   guint bus_watch_id = gst_bus_add_watch(bus, async_bus_callback, this);
@@ -343,16 +921,22 @@ ExitStatus IBaseStream::Exec() {
   stats_->loop_start_time = common::time::current_utc_mstime();
   ResetDataWait();
 
-  Play();
+  play_ts_ = common::time::current_utc_mstime();
+  StartPipeline();
 
   // stream run
   PreLoop();
   g_main_loop_run(loop_);
   PostLoop(last_exit_status_);
+  qos_dropped_.clear();  // elements of next pipeline count from zero
+  if (profile_timer_id_) {
+    remove_source(loop_, profile_timer_id_);
+    FinishProfile();  // partial window
+  }
 
-  bool res = g_source_remove(bus_watch_id);
+  bool res = remove_source(loop_, bus_watch_id);
   DCHECK(res);
-  res = g_source_remove(main_timeout_id);
+  res = remove_source(loop_, main_timeout_id);
   DCHECK(res);
 
   SetStatus(INIT);  // emulating loop statuses
@@ -443,7 +1027,7 @@ void IBaseStream::SetAudioInited(bool val) {
   if (val) {
     flags_ |= INITED_AUDIO;
   } else {
-    flags_ &= INITED_AUDIO;
+    flags_ &= ~INITED_AUDIO;
   }
 }
 
@@ -483,14 +1067,48 @@ void IBaseStream::Play() {
   }
 }
 
+void IBaseStream::StartPipeline() {
+  Play();
+}
+
+bool IBaseStream::PrerollPipeline(GstClockTime timeout) {
+  if (SetPipelineState(GST_STATE_PAUSED) == GST_STATE_CHANGE_FAILURE) {
+    return false;
+  }
+
+  GstState state = GST_STATE_NULL;
+  GstStateChangeReturn ret = gst_element_get_state(pipeline_, &state, nullptr, timeout);
+  return ret == GST_STATE_CHANGE_SUCCESS && state == GST_STATE_PAUSED;
+}
+
+bool IBaseStream::QueryDuration(fastotv::timestamp_t* duration_msec) const {
+  gint64 duration = 0;
+  if (!gst_element_query_duration(pipeline_, GST_FORMAT_TIME, &duration) || duration <= 0) {
+    return false;
+  }
+
+  *duration_msec = duration / GST_MSECOND;
+  return true;
+}
+
+bool IBaseStream::SeekRange(fastotv::timestamp_t start_msec, fastotv::timestamp_t stop_msec) {
+  const GstSeekFlags flags = static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE);
+  const GstSeekType stop_type = stop_msec ? GST_SEEK_TYPE_SET : GST_SEEK_TYPE_NONE;
+  const gint64 stop = stop_msec ? stop_msec * GST_MSECOND : GST_CLOCK_TIME_NONE;
+  return gst_element_seek(pipeline_, 1.0, GST_FORMAT_TIME, flags, GST_SEEK_TYPE_SET, start_msec * GST_MSECOND,
+                          stop_type, stop);
+}
+
 void IBaseStream::ResetDataWait() {
-  no_data_panic_tick_ = GetElipsedTime() + no_data_panic_sec;  // update no_data_panic timestamp
+  const fastotv::timestamp_t now = common::time::current_utc_mstime();
+  no_data_panic_ts_ = now + config_->GetNoDataPanicMsec();  // update no_data_panic timestamp
+  checkpoint_ts_ = now;
   stats_->ResetDataWait();
 }
 
 void IBaseStream::Quit(ExitStatus status) {
   GstElement* pipeline = pipeline_;
-  GstStructure* result = gst_structure_new("exit_info", "status", G_TYPE_INT, status, nullptr);
+  GstStructure* result = gst_structure_new(EXIT_MESSAGE_NAME, "status", G_TYPE_INT, status, nullptr);
   GstMessage* message = gst_message_new_application(GST_OBJECT(pipeline), result);
   bool res = gst_element_post_message(pipeline, message);
   if (!res) {
@@ -498,6 +1116,66 @@ void IBaseStream::Quit(ExitStatus status) {
   }
 }
 
+void IBaseStream::SetOutputsMuted(bool muted) {
+  const bool was_muted = outputs_muted_.exchange(muted);
+  if (was_muted && !muted) {
+    INFO_LOG() << "Outputs unmuted, opened on next keyframe";
+  } else if (!was_muted && muted) {
+    INFO_LOG() << "Outputs muted";
+  }
+}
+
+bool IBaseStream::IsOutputsMuted() const {
+  return outputs_muted_;
+}
+
+void IBaseStream::UpdateLiveConfig(const LiveConfigUpdate& update) {
+  {
+    std::unique_lock<std::mutex> lock(live_update_mutex_);
+    live_update_.Append(update);
+  }
+
+  GstElement* pipeline = pipeline_;
+  GstStructure* result = gst_structure_new_empty(LIVE_CONFIG_MESSAGE_NAME);
+  GstMessage* message = gst_message_new_application(GST_OBJECT(pipeline), result);
+  bool res = gst_element_post_message(pipeline, message);
+  if (!res) {
+    WARNING_LOG() << "Failed to post config update message.";
+  }
+}
+
+void IBaseStream::StartProfile(const common::file_system::ascii_file_string_path& report_path,
+                               const common::file_system::ascii_file_string_path& dump_path,
+                               uint32_t duration_sec) {
+  {
+    std::unique_lock<std::mutex> lock(live_update_mutex_);
+    profile_path_ = report_path;
+    profile_dump_path_ = dump_path;
+    profile_duration_ = duration_sec;
+  }
+
+  GstElement* pipeline = pipeline_;
+  GstStructure* result = gst_structure_new_empty(PROFILE_MESSAGE_NAME);
+  GstMessage* message = gst_message_new_application(GST_OBJECT(pipeline), result);
+  bool res = gst_element_post_message(pipeline, message);
+  if (!res) {
+    WARNING_LOG() << "Failed to post profile message.";
+  }
+}
+
+void IBaseStream::FinishProfile() {
+  if (!profiler_->WriteReport(profiler_path_)) {
+    WARNING_LOG() << "Failed to write profile report: " << profiler_path_.GetPath();
+  } else {
+    INFO_LOG() << "Profile report written: " << profiler_path_.GetPath();
+  }
+  if (!DumpIntoFile(profiler_dump_path_, profiler_->MakeAnnotations())) {
+    WARNING_LOG() << "Can't create annotated pipeline graph, path: " << profiler_dump_path_.GetPath();
+  }
+  destroy(&profiler_);
+  profile_timer_id_ = 0;
+}
+
 StreamStruct* IBaseStream::GetStats() const {
   return stats_;
 }
@@ -517,7 +1195,7 @@ GstBusSyncReply IBaseStream::HandleSyncBusMessageReceived(GstBus* bus, GstMessag
   GstObject* src = GST_MESSAGE_SRC(message);
   if (type == GST_MESSAGE_APPLICATION) {
     GstObject* pipeline = GST_OBJECT(pipeline_);
-    if (src == pipeline && g_main_loop_is_running(loop_)) {
+    if (src == pipeline && gst_message_has_name(message, EXIT_MESSAGE_NAME) && g_main_loop_is_running(loop_)) {
       const GstStructure* exit_status_struct = gst_message_get_structure(message);
       const GValue* status_val = gst_structure_get_value(exit_status_struct, "status");
       gint exit_status = gvalue_cast<gint>(status_val);
@@ -526,6 +1204,32 @@ GstBusSyncReply IBaseStream::HandleSyncBusMessageReceived(GstBus* bus, GstMessag
       g_main_loop_quit(loop_);
       last_exit_status_ = static_cast<ExitStatus>(exit_status);
     }
+  } else if (type == GST_MESSAGE_ERROR) {
+    // before flow error returns through tee, failed output stops taking data
+    for (OutputBranch* branch : output_branches_) {
+      if (branch->Contains(src)) {
+        branch->SetFailed();
+      }
+    }
+    GError* err = nullptr;
+    gchar* debug = nullptr;
+    gst_message_parse_error(message, &err, &debug);
+    if (is_negotiation_error(err, debug)) {  // cached pads may not fit new caps, rebuild links by negotiation
+      LinkCache::GetInstance().Clear();
+    }
+    g_clear_error(&err);
+    g_free(debug);
+  } else if (type == GST_MESSAGE_STREAM_STATUS) {
+    // pool must be set before task started, so only from streaming thread posting create
+    GstTaskPool* pool = get_streaming_task_pool();
+    GstStreamStatusType status;
+    GstElement* owner = nullptr;
+    gst_message_parse_stream_status(message, &status, &owner);
+    const GValue* object = gst_message_get_stream_status_object(message);
+    if (pool && status == GST_STREAM_STATUS_TYPE_CREATE && object && G_VALUE_HOLDS_OBJECT(object) &&
+        GST_IS_TASK(g_value_get_object(object))) {
+      gst_task_set_pool(GST_TASK(g_value_get_object(object)), pool);
+    }
   } else if (type == GST_MESSAGE_ELEMENT) {
     const GstStructure* structure = gst_message_get_structure(message);
     const char* element_name = gst_structure_get_name(structure);
@@ -565,17 +1269,15 @@ void IBaseStream::OnOutputDataFailed() {
   }
 
   if (!is_lazy_streams) {
-    WARNING_LOG() << "There is no output data for a last " << no_data_panic_sec << " seconds.";
+    WARNING_LOG() << "There is no output data for a last " << config_->GetNoDataPanicMsec() << " msec.";
     Quit(EXIT_INNER);
   }
 }
 
-void IBaseStream::OnOutputDataOK() {
-  ResetDataWait();
-}
+void IBaseStream::OnOutputDataOK() {}
 
 void IBaseStream::OnInputDataFailed() {
-  WARNING_LOG() << "There is no input data for a last " << no_data_panic_sec << " seconds.";
+  WARNING_LOG() << "There is no input data for a last " << config_->GetNoDataPanicMsec() << " msec.";
   // handle streamlink
   Quit(EXIT_INNER);
 }
@@ -583,10 +1285,20 @@ void IBaseStream::OnInputDataFailed() {
 void IBaseStream::OnInputDataOK() {}
 
 gboolean IBaseStream::HandleMainTimerTick() {
-  const time_t up_time = GetElipsedTime();
-  const size_t diff = (no_data_panic_sec - no_data_panic_tick_ + up_time) + 1;
+  CollectProbesStats();
+  CollectQueueLevels();
+  CollectProgress();
+  UpdateStartupTiming();
+
+  const fastotv::timestamp_t now = common::time::current_utc_mstime();
+  for (OutputBranch* branch : output_branches_) {
+    branch->CheckRestart(now);
+  }
+  const fastotv::timestamp_t no_data_panic_msec = config_->GetNoDataPanicMsec();
+  const size_t diff = std::max<fastotv::timestamp_t>((now - checkpoint_ts_ + 500) / 1000, 1);
 
   size_t checkpoint_diff_in_total = 0;
+  fastotv::timestamp_t last_in_ts = 0;
   common::media::DesireBytesPerSec checkpoint_desire_in_total;
   size_t input_stream_count = stats_->input.size();
   for (size_t i = 0; i < input_stream_count; ++i) {
@@ -594,29 +1306,52 @@ gboolean IBaseStream::HandleMainTimerTick() {
     stats_->input[i].UpdateBps(diff);
     checkpoint_diff_in_total += checkpoint_diff_out_stream;
     checkpoint_desire_in_total += stats_->input[i].GetDesireBytesPerSecond();
+    last_in_ts = std::max(last_in_ts, stats_->input[i].GetLastUpdateTime());
   }
 
   size_t checkpoint_diff_out_total = 0;
+  fastotv::timestamp_t last_out_ts = 0;
   size_t output_stream_count = stats_->output.size();
   for (size_t i = 0; i < output_stream_count; ++i) {
     size_t checkpoint_diff_out_stream = stats_->output[i].GetDiffTotalBytes();
     stats_->output[i].UpdateBps(diff);
     checkpoint_diff_out_total += checkpoint_diff_out_stream;
+    last_out_ts = std::max(last_out_ts, stats_->output[i].GetLastUpdateTime());
   }
 
-  if (up_time > no_data_panic_tick_) {  // check is stream in noraml state
-    size_t count_in_eos = CountInputEOS();
-    size_t count_out_eos = CountOutEOS();
-    DEBUG_LOG() << "NoData checkpoint: input eos (" << count_in_eos << "/" << input_stream_count << "), output eos ("
-                << count_out_eos << "/" << output_stream_count << "), received bytes " << checkpoint_diff_in_total
-                << ", sended bytes " << checkpoint_diff_out_total;
-    bool is_input_failed = checkpoint_diff_in_total < MIN_IN_DATA(no_data_panic_sec);
+  if (now >= no_data_panic_ts_) {  // startup grace passed, stalls checked on each tick
+    bool is_input_failed = now - last_in_ts >= no_data_panic_msec;
+    bool is_output_failed = now - last_out_ts >= no_data_panic_msec;
+    const bool is_content_failed = IsContentFailed();
+    if (is_content_failed != content_failed_) {
+      NOTICE_LOG() << "Content of input " << (is_content_failed ? "failed" : "restored") << ": black "
+                   << stats_->video_black << " msec, freeze " << stats_->video_freeze << " msec, silence "
+                   << stats_->audio_silence << " msec";
+      content_failed_ = is_content_failed;
+    }
+    is_input_failed |= is_content_failed;  // bytes flow, but nothing to watch
+    if (is_input_failed || is_output_failed) {
+      DEBUG_LOG() << "NoData checkpoint: input eos (" << CountInputEOS() << "/" << input_stream_count
+                  << "), output eos (" << CountOutEOS() << "/" << output_stream_count << "), last input buffer "
+                  << now - last_in_ts << " msec ago, last output buffer " << now - last_out_ts << " msec ago";
+    }
+
     if (is_input_failed) {
       OnInputDataFailed();
     } else {
       OnInputDataOK();
     }
 
+    if (now < no_data_panic_ts_) {
+      // input rebuilt in place, outputs wait for its data
+    } else if (is_output_failed) {
+      OnOutputDataFailed();
+    } else {
+      OnOutputDataOK();
+    }
+  }
+
+  if (now - checkpoint_ts_ >= no_data_panic_msec) {  // bps averaged over stall window
     if (checkpoint_desire_in_total.IsValid() && desire_flags_ != INITED_NOTHING) {
       size_t in_bytes_per_sec = (checkpoint_diff_in_total / diff);
       if (!checkpoint_desire_in_total.InRange(in_bytes_per_sec)) {
@@ -624,13 +1359,12 @@ gboolean IBaseStream::HandleMainTimerTick() {
                      << " <= " << in_bytes_per_sec << " <= " << checkpoint_desire_in_total.max;
       }
     }
+    checkpoint_ts_ = now;
+    stats_->ResetDataWait();
+  }
 
-    bool is_output_failed = checkpoint_diff_out_total < MIN_OUT_DATA(no_data_panic_sec);
-    if (is_output_failed) {
-      OnOutputDataFailed();
-    } else {
-      OnOutputDataOK();
-    }
+  if (client_) {
+    client_->OnStatisticUpdated(this);
   }
 
   /*
@@ -638,6 +1372,7 @@ gboolean IBaseStream::HandleMainTimerTick() {
   */
 
   if (IsActive()) {
+    const time_t up_time = GetElipsedTime();
     if (status_tick_ <= up_time) {
       status_tick_ = up_time + Config::report_delay_sec;  // update status timestamp
       if (client_) {
@@ -689,6 +1424,40 @@ gboolean IBaseStream::HandleAsyncBusMessageReceived(GstBus* bus, GstMessage* mes
     if (client_) {
       client_->OnPipelineEOS(this);
     }
+  } else if (type == GST_MESSAGE_QOS) {
+    HandleQosMessage(message);
+  } else if (type == GST_MESSAGE_APPLICATION && src == GST_OBJECT(pipeline_) &&
+             gst_message_has_name(message, LIVE_CONFIG_MESSAGE_NAME)) {
+    LiveConfigUpdate update;
+    {
+      std::unique_lock<std::mutex> lock(live_update_mutex_);
+      update = live_update_;
+      live_update_ = LiveConfigUpdate();
+    }
+    if (!update.IsEmpty() && !HandleLiveConfigUpdate(update)) {
+      WARNING_LOG() << "Config changes can't be applied to running pipeline, restarting.";
+      Quit(EXIT_SELF);
+    }
+  } else if (type == GST_MESSAGE_APPLICATION && src == GST_OBJECT(pipeline_) &&
+             gst_message_has_name(message, PROFILE_MESSAGE_NAME)) {
+    common::file_system::ascii_file_string_path path;
+    common::file_system::ascii_file_string_path dump_path;
+    uint32_t duration_sec;
+    {
+      std::unique_lock<std::mutex> lock(live_update_mutex_);
+      path = profile_path_;
+      dump_path = profile_dump_path_;
+      duration_sec = profile_duration_;
+    }
+    if (profiler_) {
+      WARNING_LOG() << "Profile already running, request skipped.";
+    } else {
+      INFO_LOG() << "Profile of stream started for " << duration_sec << " sec.";
+      profiler_ = new StreamProfiler(pipeline_, duration_sec);
+      profiler_path_ = path;
+      profiler_dump_path_ = dump_path;
+      profile_timer_id_ = attach_timeout(loop_, PROFILE_SAMPLE_MSEC, profile_timer_callback, this);
+    }
   }
 
   if (client_) {
@@ -706,6 +1475,10 @@ void IBaseStream::SetStatus(StreamStatus status) {
   }
 }
 
+void IBaseStream::SetMlBackend(int backend) {
+  stats_->ml_backend = backend;
+}
+
 bool IBaseStream::IsActive() const {
   return stats_->status != INIT;
 }
@@ -742,9 +1515,10 @@ void IBaseStream::HandleOutputProbeEvent(OutputProbe* probe, GstEvent* event) {
                 gboolean all_headers = FALSE;
                 guint count = 0;
                 if (gst_video_event_parse_upstream_force_key_unit(event, &running_time, &all_headers, &count)) {
-                  DEBUG_LOG() << "New keyframe up, running_time: " << running_time << ", all_headers: " << all_headers
-                              << ", count: " << count << ", location: " << fs_template.GetParentDirectory()
-                              << ", url: " << url.GetUrl();
+                  HOT_DEBUG_LOG(1000) << "New keyframe up, running_time: " << running_time
+                                      << ", all_headers: " << all_headers << ", count: " << count
+                                      << ", location: " << fs_template.GetParentDirectory()
+                                      << ", url: " << url.GetUrl();
                 }
               } else if (event_type == GST_EVENT_CUSTOM_DOWNSTREAM) {
                 GstClockTime timestamp = 0;
@@ -754,10 +1528,11 @@ void IBaseStream::HandleOutputProbeEvent(OutputProbe* probe, GstEvent* event) {
                 guint count = 0;
                 if (gst_video_event_parse_downstream_force_key_unit(event, &timestamp, &stream_time, &running_time,
                                                                     &all_headers, &count)) {
-                  DEBUG_LOG() << "New keyframe down, timestamp: " << timestamp << ", stream_time: " << stream_time
-                              << ", running_time: " << running_time << ", all_headers: " << all_headers
-                              << ", count: " << count << ", location: " << fs_template.GetParentDirectory()
-                              << ", url: " << url.GetUrl();
+                  HOT_DEBUG_LOG(1000) << "New keyframe down, timestamp: " << timestamp
+                                      << ", stream_time: " << stream_time << ", running_time: " << running_time
+                                      << ", all_headers: " << all_headers << ", count: " << count
+                                      << ", location: " << fs_template.GetParentDirectory()
+                                      << ", url: " << url.GetUrl();
                 }
               }
             }
@@ -773,6 +1548,31 @@ void IBaseStream::HandleOutputProbeEvent(OutputProbe* probe, GstEvent* event) {
   }
 }
 
+void IBaseStream::ElementAdd(elements::Element* elem) {
+  GstElement* element = elem->GetGstElement();
+  bool res = gst_bin_add(GST_BIN(pipeline_), element);
+  CHECK(res) << "Can't added " << elem->GetPluginName();
+  pipeline_elements_.push_back(elem);
+}
+
+void IBaseStream::ElementRemove(elements::Element* elem) {
+  GstElement* element = elem->GetGstElement();
+  gst_object_ref(element);  // wrapper disconnects signals in destructor
+  gst_element_set_state(element, GST_STATE_NULL);
+  bool res = gst_bin_remove(GST_BIN(pipeline_), element);
+  CHECK(res);
+  pipeline_elements_.erase(std::remove(pipeline_elements_.begin(), pipeline_elements_.end(), elem),
+                           pipeline_elements_.end());
+  elements_registry_.Unregister(elem);
+  ElementsPool::GetInstance().Untrack(element);
+  delete elem;
+  gst_object_unref(element);
+}
+
+void IBaseStream::RegisterElement(ElementRole role, element_id_t id, elements::Element* elem) {
+  elements_registry_.Register(role, id, elem);
+}
+
 elements::Element* IBaseStream::GetElementByName(const std::string& name) const {
   for (elements::Element* el : pipeline_elements_) {
     if (el->GetName() == name) {
@@ -784,11 +1584,46 @@ elements::Element* IBaseStream::GetElementByName(const std::string& name) const
   return nullptr;
 }
 
+elements::Element* IBaseStream::FindElementByName(const std::string& name) const {
+  for (elements::Element* el : pipeline_elements_) {
+    if (el->GetName() == name) {
+      return el;
+    }
+  }
+
+  return nullptr;
+}
+
+elements::Element* IBaseStream::GetElement(ElementRole role, element_id_t id) const {
+  elements::Element* elem = elements_registry_.Find(role, id);
+  if (!elem) {
+    NOTREACHED() << "Not registered element role: " << role << ", id: " << id;
+  }
+  return elem;
+}
+
+elements::Element* IBaseStream::FindElement(ElementRole role, element_id_t id) const {
+  return elements_registry_.Find(role, id);
+}
+
+bool IBaseStream::HandleLiveConfigUpdate(const LiveConfigUpdate& update) {
+  LiveConfigUpdate rest = update;
+  if (rest.hls_max_files) {
+    ApplyHlsMaxFiles(rest.hls_max_files);
+    rest.hls_max_files = 0;
+  }
+  return rest.IsEmpty();
+}
+
 void IBaseStream::HandleBufferingMessage(GstMessage* message) {
   UNUSED(message);
 }
 
 GstPadProbeInfo* IBaseStream::CheckProbeData(InputProbe* probe, GstPadProbeInfo* buff) {
+  if (!first_input_ts_.load(std::memory_order_relaxed)) {
+    fastotv::timestamp_t expected = 0;
+    first_input_ts_.compare_exchange_strong(expected, common::time::current_utc_mstime());
+  }
   if (client_) {
     return client_->OnCheckReveivedData(this, probe, buff);
   }
@@ -796,7 +1631,37 @@ GstPadProbeInfo* IBaseStream::CheckProbeData(InputProbe* probe, GstPadProbeInfo*
   return buff;
 }
 
+void IBaseStream::UpdateStartupTiming() {
+  const fastotv::timestamp_t first_input_ts = first_input_ts_;
+  if (first_input_ts && !stats_->startup[FIRST_INPUT_STARTUP_STAGE]) {
+    stats_->startup[FIRST_INPUT_STARTUP_STAGE] = first_input_ts;
+  }
+
+  const fastotv::timestamp_t first_output_ts = first_output_ts_;
+  if (startup_logged_ || !first_output_ts) {
+    return;
+  }
+
+  if (!stats_->startup[FIRST_OUTPUT_STARTUP_STAGE]) {
+    stats_->startup[FIRST_OUTPUT_STARTUP_STAGE] = first_output_ts;
+  }
+
+  // plugins opened lazily, by elements of builder and by decodebin autoplugging
+  const size_t plugins = loaded_plugins_count();
+  const bool preinited = backend_timing.pid != current_process_id();
+  INFO_LOG() << "Startup timing, gst_init: " << backend_timing.gst_init_msec << " msec"
+             << (preinited ? " (zygote)" : "") << ", plugin preload: " << backend_timing.preload_msec << " msec ("
+             << backend_timing.preloaded << " plugins), pipeline build: " << build_msec_
+             << " msec, first buffer: " << first_output_ts - play_ts_ << " msec, plugins loaded by pipeline: "
+             << (plugins > preloaded_plugins_ ? plugins - preloaded_plugins_ : 0);
+  startup_logged_ = true;
+}
+
 GstPadProbeInfo* IBaseStream::CheckProbeDataOutput(OutputProbe* probe, GstPadProbeInfo* buff) {
+  if (!first_output_ts_.load(std::memory_order_relaxed)) {
+    fastotv::timestamp_t expected = 0;
+    first_output_ts_.compare_exchange_strong(expected, common::time::current_utc_mstime());
+  }
   if (client_) {
     return client_->OnCheckReveivedOutputData(this, probe, buff);
   }
@@ -825,24 +1690,32 @@ gboolean IBaseStream::main_timer_callback(gpointer user_data) {
   */
   IBaseStream* stream = reinterpret_cast<IBaseStream*>(user_data);
   const fastotv::timestamp_t start_ts = common::time::current_utc_mstime();
+  // late timer means loop is starved, reported before tick so stats of this tick include it
+  const fastotv::timestamp_t late = start_ts - stream->last_tick_ts_ - stream->config_->GetWatchdogMsec();
+  stream->stats_->timer_lag = late > 0 ? late : 0;
+  stream->last_tick_ts_ = start_ts;
   gboolean res = stream->HandleMainTimerTick();
   const fastotv::timestamp_t end_ts = common::time::current_utc_mstime();
-  DEBUG_LOG() << "HandleMainTimerTick time is: " << end_ts - start_ts << " msec.";
+  HOT_DEBUG_LOG(10000) << "HandleMainTimerTick time is: " << end_ts - start_ts << " msec.";
   return res;
 }
 
-void IBaseStream::UpdateInputProbeStats(const InputProbe* probe, gsize size) {
-  if (probe->GetID() < stats_->input.size()) {
-    const size_t prev_total = stats_->input[probe->GetID()].GetTotalBytes();
-    stats_->input[probe->GetID()].SetTotalBytes(prev_total + size);
+gboolean IBaseStream::profile_timer_callback(gpointer user_data) {
+  IBaseStream* stream = reinterpret_cast<IBaseStream*>(user_data);
+  if (stream->profiler_->Tick()) {
+    return TRUE;
   }
+
+  stream->FinishProfile();
+  return FALSE;
 }
 
-void IBaseStream::UpdateOutputProbeStats(const OutputProbe* probe, gsize size) {
-  if (probe->GetID() < stats_->output.size()) {
-    const size_t prev_total = stats_->output[probe->GetID()].GetTotalBytes();
-    stats_->output[probe->GetID()].SetTotalBytes(prev_total + size);
-  }
+void IBaseStream::UpdateInputProbeStats(InputProbe* probe, gsize size) {
+  probe->AddData(size, 1);
+}
+
+void IBaseStream::UpdateOutputProbeStats(OutputProbe* probe, gsize size) {
+  probe->AddData(size, 1);
 }
 
 const Config* IBaseStream::GetConfig() const {
@@ -859,7 +1732,8 @@ gboolean IBaseStream::async_bus_callback(GstBus* bus, GstMessage* message, gpoin
   return stream->HandleAsyncBusMessageReceived(bus, message);
 }
 
-bool IBaseStream::DumpIntoFile(const common::file_system::ascii_file_string_path& path) const {
+bool IBaseStream::DumpIntoFile(const common::file_system::ascii_file_string_path& path,
+                               const dumper::IDumper::annotations_t& annotations) const {
   if (!path.IsValid()) {
     return false;
   }
@@ -869,7 +1743,7 @@ bool IBaseStream::DumpIntoFile(const common::file_system::ascii_file_string_path
     return false;
   }
 
-  return dumper->Dump(GST_BIN(pipeline_), path);
+  return dumper->Dump(GST_BIN(pipeline_), path, annotations);
 }
 
 }  // namespace stream
@@ -16,6 +16,9 @@
 
 #include <gst/gstevent.h>
 
+#include <atomic>
+#include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -29,8 +32,11 @@
 #include "base/input_uri.h"
 #include "base/stream_struct.h"  // for StreamStatus, StreamStruct (ptr only)
 
+#include "stream/dumpers/idumper.h"
+#include "stream/elements_registry.h"
 #include "stream/gst_types.h"
 #include "stream/ibase_builder_observer.h"
+#include "stream/live_config.h"
 
 namespace fastocloud {
 namespace stream {
@@ -38,11 +44,21 @@ namespace stream {
 class IBaseBuilder;
 class InputProbe;
 class OutputProbe;
+class LatencyProbe;
+class QueueDropProbe;
+class AudioMeterProbe;
+class VideoMeterProbe;
+class Thumbnailer;
+class OutputGateProbe;
+class OutputBranch;
 class Config;
+class StreamProfiler;
 
 enum ExitStatus { EXIT_SELF, EXIT_INNER };
 
 void streams_init(int argc, char** argv, EncoderType enc = CPU);
+// loads plugins of elements common to stream types, processes forked after it don't open them again
+void streams_preload_plugins();
 void streams_deinit();
 
 class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
@@ -52,6 +68,7 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
     virtual void OnStatusChanged(IBaseStream* stream, StreamStatus status) = 0;
     virtual void OnPipelineEOS(IBaseStream* stream) = 0;
     virtual void OnTimeoutUpdated(IBaseStream* stream) = 0;
+    virtual void OnStatisticUpdated(IBaseStream* stream) = 0;
     virtual void OnInputProbeEvent(IBaseStream* stream, InputProbe* probe, GstEvent* event) = 0;
     virtual void OnOutputProbeEvent(IBaseStream* stream, OutputProbe* probe, GstEvent* event) = 0;
     virtual void OnSyncMessageReceived(IBaseStream* stream, GstMessage* message) = 0;
@@ -70,8 +87,7 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
 
   enum InitedFlag { INITED_NOTHING = 0x0000, INITED_VIDEO = 0x0001, INITED_AUDIO = 0x0002 };
   enum {
-    main_timer_msecs = 1000,
-    no_data_panic_sec = 60,
+    no_data_panic_sec = 60,  // sources timeouts and periodic jobs, stall detection is Config::GetNoDataPanicMsec
     src_timeout_sec = no_data_panic_sec * 2,
     cleanup_life_period_sec = 15 * 2 * 10  // 2x15 sec and 10 chunks
   };
@@ -87,6 +103,14 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
   bool IsLive() const;
 
   void Quit(ExitStatus status);
+  void UpdateLiveConfig(const LiveConfigUpdate& update);  // applied in pipeline loop, quits if not applicable
+  // muted output branches drop buffers, set before Exec, unmuted from any thread
+  void SetOutputsMuted(bool muted);
+  bool IsOutputsMuted() const;
+  // report and pipeline graph with element stats written when window ends or loop quits
+  void StartProfile(const common::file_system::ascii_file_string_path& report_path,
+                    const common::file_system::ascii_file_string_path& dump_path,
+                    uint32_t duration_sec);
   StreamStruct* GetStats() const;
 
   time_t GetElipsedTime() const;  // stream life time sec
@@ -103,21 +127,36 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
   virtual GstPadProbeInfo* CheckProbeData(InputProbe* probe, GstPadProbeInfo* buff);
   virtual GstPadProbeInfo* CheckProbeDataOutput(OutputProbe* probe, GstPadProbeInfo* buff);
 
-  void UpdateInputProbeStats(const InputProbe* probe, gsize size);
-  void UpdateOutputProbeStats(const OutputProbe* probe, gsize size);
+  // called from streaming threads
+  void UpdateInputProbeStats(InputProbe* probe, gsize size);
+  void UpdateOutputProbeStats(OutputProbe* probe, gsize size);
 
   const Config* GetConfig() const;
 
   void LinkInputPad(GstPad* pad, element_id_t id, const common::uri::Url& url);
   void LinkOutputPad(GstPad* pad, element_id_t id, const common::uri::Url& url, bool need_push);
+  void LinkLatencyPad(GstPad* pad, LatencyStage stage);  // noop if latency stats disabled
+  AudioMeterProbe* LinkAudioMeterPad(GstPad* pad, element_id_t id);  // owned by stream
 
   size_t CountInputEOS() const;
   size_t CountOutEOS() const;
 
-  bool DumpIntoFile(const common::file_system::ascii_file_string_path& path) const;
+  bool DumpIntoFile(const common::file_system::ascii_file_string_path& path,
+                    const dumper::IDumper::annotations_t& annotations = dumper::IDumper::annotations_t()) const;
 
  protected:
   elements::Element* GetElementByName(const std::string& name) const;
+  elements::Element* FindElementByName(const std::string& name) const;  // nullptr if not in pipeline
+  elements::Element* GetElement(ElementRole role, element_id_t id) const;
+  elements::Element* FindElement(ElementRole role, element_id_t id) const;  // nullptr if not registered
+
+  // changes of running pipeline, main loop only
+  void ElementAdd(elements::Element* elem);     // owned by stream, state synced by caller after linking
+  void ElementRemove(elements::Element* elem);  // stopped, unlinked and deleted
+  void RegisterElement(ElementRole role, element_id_t id, elements::Element* elem);  // added before
+  void UnlinkOutputPads(element_id_t id);  // statistic probes of detached output
+  void RelinkInputPad(GstPad* pad, element_id_t id, const common::uri::Url& url);  // probes of replaced source
+  void ResetDataWait();
 
   bool IsAudioInited() const;
   bool IsVideoInited() const;
@@ -128,11 +167,24 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
   void SetAudioInited(bool val);
   void SetVideoInited(bool val);
 
+  bool GetVideoMotion(uint32_t* motion) const;  // of decoded video, false if not metered
+  bool GetAudioLoudness(double* short_term_lufs, int* peak_db) const;  // of decoded audio, false if not metered
+
   void OnInpudSrcPadCreated(pad::Pad* src_pad, element_id_t id, const common::uri::Url& url) override = 0;
   void OnOutputSinkPadCreated(pad::Pad* sink_pad,
                               element_id_t id,
                               const common::uri::Url& url,
                               bool need_push) override = 0;
+  void OnLatencyPadCreated(pad::Pad* pad, LatencyStage stage) override;
+  void OnOutputQueueCreated(elements::Element* queue, element_id_t id) override;
+  void OnOutputBranchQueueCreated(elements::Element* queue, element_id_t id) override;
+  void OnAudioMeterPadCreated(pad::Pad* pad, element_id_t id) override;
+  void OnVideoMeterPadCreated(pad::Pad* pad, element_id_t id) override;
+  void OnThumbnailPadCreated(pad::Pad* pad) override;
+  void OnOutputBranchCreated(element_id_t id,
+                             elements::Element* video_queue,
+                             elements::Element* audio_queue,
+                             const elements_line_t& downstream) override;
 
   virtual IBaseBuilder* CreateBuilder() = 0;
 
@@ -140,8 +192,10 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
   virtual void PostLoop(ExitStatus status) = 0;
 
   virtual void HandleBufferingMessage(GstMessage* message);
+  virtual bool HandleLiveConfigUpdate(const LiveConfigUpdate& update);  // false if some of changes not applied
 
   void SetStatus(StreamStatus status);
+  void SetMlBackend(int backend);  // reported in stats
 
   virtual gboolean HandleMainTimerTick();
   virtual GstBusSyncReply HandleSyncBusMessageReceived(GstBus* bus, GstMessage* message);
@@ -164,29 +218,83 @@ class IBaseStream : public common::IMetaClassInfo, public IBaseBuilderObserver {
   void Stop();
   void Pause();
   void Play();
+  virtual void StartPipeline();  // first play of Exec, before main loop
+
+  bool PrerollPipeline(GstClockTime timeout);  // paused and prerolled, blocks caller
+  bool QueryDuration(fastotv::timestamp_t* duration_msec) const;
+  bool SeekRange(fastotv::timestamp_t start_msec, fastotv::timestamp_t stop_msec);  // stop 0 until end
 
  private:
   const Config* const config_;
 
   std::vector<InputProbe*> probe_in_;
   std::vector<OutputProbe*> probe_out_;
+  std::vector<LatencyProbe*> probe_latency_;
+  std::vector<QueueDropProbe*> probe_queue_;  // leaky output branches
+  std::vector<AudioMeterProbe*> probe_audio_;  // decoded audio, first measured one in stats
+  std::vector<VideoMeterProbe*> probe_video_;  // decoded video, first measured one in stats
+  std::vector<OutputGateProbe*> probe_gate_;   // output branches of muted stream
+  Thumbnailer* thumbnailer_;                   // nullptr if thumbnails off
+  bool content_failed_;                        // last tick, transitions logged
+  std::atomic<bool> outputs_muted_;
+  std::vector<OutputBranch*> output_branches_;  // restarted in place, read from sync bus handler
+
+  std::mutex live_update_mutex_;
+  LiveConfigUpdate live_update_;  // not applied changes, taken by async bus handler
+  common::file_system::ascii_file_string_path profile_path_;  // requested profile, taken by async bus handler
+  common::file_system::ascii_file_string_path profile_dump_path_;
+  uint32_t profile_duration_;
 
   bool InitPipeLine();
+  void ApplyClock();  // configured clock and latency of created pipeline
+  void ApplyHlsMaxFiles(size_t max_files);  // segments kept by every hls sink of pipeline, 0 - sink defaults
   void ClearOutProbes();
   void ClearInProbes();
-  void ResetDataWait();
+  void ClearLatencyProbes();
+  void ClearQueueProbes();
+  void ClearAudioMeterProbes();
+  void ClearVideoMeterProbes();
+  bool IsContentFailed() const;  // by meters of decoded input
+  void ClearGateProbes();
+  void ClearOutputBranches();
+  void CollectProbesStats();
+  bool GetInputSocketDrops(InputProbe* probe, uint64_t* drops) const;  // udp inputs
+  void CollectSrtPeers(OutputProbe* probe, ChannelStats* stat) const;  // srt outputs
+  void CollectQueueLevels();
+  void CollectProgress();  // vods, position of pipeline in input duration
+  void HandleQosMessage(GstMessage* message);
+  void FinishProfile();
 
   static GstBusSyncReply sync_bus_callback(GstBus* bus, GstMessage* message, gpointer user_data);
+  void UpdateStartupTiming();  // stages of stats, logged once per pipeline after first output buffer
+
   static gboolean main_timer_callback(gpointer user_data);
+  static gboolean profile_timer_callback(gpointer user_data);
   static gboolean async_bus_callback(GstBus* bus, GstMessage* message, gpointer user_data);
 
   //! Gstreamer loop pointer. You set it up with you custom run-loop.
   GMainLoop* const loop_;
   GstElement* pipeline_;
   elements_line_t pipeline_elements_;
+  ElementsRegistry elements_registry_;
+  std::map<std::string, guint64> qos_dropped_;  // last reported drops by element name, current pipeline
+  StreamProfiler* profiler_;  // pipeline loop only
+  common::file_system::ascii_file_string_path profiler_path_;
+  common::file_system::ascii_file_string_path profiler_dump_path_;
+  guint profile_timer_id_;
 
   time_t status_tick_;
-  time_t no_data_panic_tick_;
+  fastotv::timestamp_t no_data_panic_ts_;  // utc msec, stalls not checked before
+  fastotv::timestamp_t checkpoint_ts_;     // utc msec, bps counted from
+  fastotv::timestamp_t last_tick_ts_;  // main timer, msec
+
+  // startup timing of current pipeline
+  fastotv::timestamp_t play_ts_;        // utc msec
+  fastotv::timestamp_t build_msec_;
+  size_t preloaded_plugins_;            // loaded before pipeline build
+  std::atomic<fastotv::timestamp_t> first_input_ts_;   // utc msec, streaming threads, 0 - nothing received yet
+  std::atomic<fastotv::timestamp_t> first_output_ts_;  // utc msec, streaming threads, 0 - nothing sent yet
+  bool startup_logged_;
 
   StreamStruct* const stats_;
 
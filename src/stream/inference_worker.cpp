@@ -0,0 +1,208 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/inference_worker.h"
+
+#include <glib-unix.h>
+#include <signal.h>
+
+#include <fastoml/gst/gstmlmeta.h>
+
+#include "base/gst_constants.h"
+
+#include "stream/elements/machine_learning/tinyyolov2.h"
+#include "stream/elements/sources/appsrc.h"
+
+namespace fastocloud {
+namespace stream {
+
+InferenceWorker::InferenceWorker(const fastocloud::machine_learning::DeepLearning& learning,
+                                 fastocloud::machine_learning::InferenceShm* shm)
+    : learning_(learning),
+      shm_(shm),
+      loop_(g_main_loop_new(nullptr, FALSE)),
+      pipeline_(nullptr),
+      src_(nullptr),
+      filter_(nullptr),
+      in_flight_mutex_(),
+      in_flight_(),
+      stop_(false),
+      feed_thread_(),
+      failed_(false) {}
+
+InferenceWorker::~InferenceWorker() {
+  delete filter_;
+  delete src_;
+  if (pipeline_) {
+    gst_object_unref(pipeline_);
+  }
+  g_main_loop_unref(loop_);
+}
+
+int InferenceWorker::Exec() {
+  if (!InitPipeline()) {
+    return EXIT_FAILURE;
+  }
+
+  // answers of crashed worker lost, its frames inferred again
+  fastocloud::machine_learning::ResetInferenceSlots(shm_);
+  guint sigterm = g_unix_signal_add(SIGTERM, quit_callback, this);
+  GstBus* bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline_));
+  guint bus_watch = gst_bus_add_watch(bus, async_bus_callback, this);
+  gst_object_unref(bus);
+
+  if (gst_element_set_state(pipeline_, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    failed_ = true;
+  } else {
+    feed_thread_ = std::thread(&InferenceWorker::FeedLoop, this);
+    INFO_LOG() << "Inference worker started, model: " << learning_.GetModelPath().GetPath();
+    g_main_loop_run(loop_);
+  }
+
+  stop_ = true;
+  src_->SendEOS();  // unblocks feeder waiting in push
+  gst_element_set_state(pipeline_, GST_STATE_NULL);
+  if (feed_thread_.joinable()) {
+    feed_thread_.join();
+  }
+  g_source_remove(bus_watch);
+  g_source_remove(sigterm);
+  INFO_LOG() << "Inference worker finished, drops: " << shm_->drops.load();
+  return failed_ ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+void InferenceWorker::Quit() {
+  g_main_loop_quit(loop_);
+}
+
+bool InferenceWorker::InitPipeline() {
+  GstBackend* backend = elements::machine_learning::make_backend(learning_);
+  if (!backend) {
+    ERROR_LOG() << "Can't allocate ML backend: " << learning_.GetBackend();
+    return false;
+  }
+
+  pipeline_ = gst_pipeline_new("inference");
+  src_ = elements::sources::make_app_src(0);
+  filter_ = new elements::machine_learning::ElementTinyYolov2("tiny_0");
+  GstElement* sink = gst_element_factory_make(FAKE_SINK, nullptr);
+  if (!src_->IsValid() || !filter_->IsValid() || !sink) {
+    ERROR_LOG() << "Can't allocate inference pipeline elements";
+    if (sink) {
+      gst_object_unref(sink);
+    }
+    g_object_unref(backend);
+    return false;
+  }
+
+  GstCaps* caps = gst_caps_new_simple("video/x-raw", "format", G_TYPE_STRING, "RGB", "width", G_TYPE_INT,
+                                      INFERENCE_SHM_FRAME_WIDTH, "height", G_TYPE_INT, INFERENCE_SHM_FRAME_HEIGHT,
+                                      "framerate", GST_TYPE_FRACTION, 0, 1, nullptr);
+  g_object_set(src_->GetGstElement(), "caps", caps, nullptr);
+  gst_caps_unref(caps);
+  src_->SetProperty("format", GST_FORMAT_TIME);
+  src_->SetProperty("is-live", true);
+  src_->SetProperty("do-timestamp", true);
+  src_->SetProperty("block", true);  // feeder waits for filter, frames stay pending in segment
+  src_->SetProperty("max-bytes", static_cast<guint64>(INFERENCE_SHM_FRAME_SIZE * 2));
+  filter_->SetBackend(backend);
+  ignore_result(filter_->RegisterNewPredictionCallback(&InferenceWorker::new_prediction_callback, this));
+  g_object_set(sink, "sync", FALSE, "async", FALSE, nullptr);
+
+  gst_bin_add_many(GST_BIN(pipeline_), src_->GetGstElement(), filter_->GetGstElement(), sink, nullptr);
+  if (!gst_element_link_many(src_->GetGstElement(), filter_->GetGstElement(), sink, nullptr)) {
+    ERROR_LOG() << "Can't link inference pipeline";
+    return false;
+  }
+  return true;
+}
+
+void InferenceWorker::FeedLoop() {
+  size_t slots[INFERENCE_SHM_SLOTS];
+  while (!stop_) {
+    // frames of all streams pending since last pass go to filter back to back
+    const size_t count = fastocloud::machine_learning::AcquireInferenceBatch(shm_, slots, INFERENCE_SHM_SLOTS);
+    if (!count) {
+      g_usleep(idle_usec);
+      continue;
+    }
+
+    GstBufferList* list = gst_buffer_list_new_sized(count);
+    for (size_t i = 0; i < count; ++i) {
+      GstBuffer* buffer = gst_buffer_new_allocate(nullptr, INFERENCE_SHM_FRAME_SIZE, nullptr);
+      gst_buffer_fill(buffer, 0, shm_->slots[slots[i]].frame, INFERENCE_SHM_FRAME_SIZE);
+      gst_buffer_list_add(list, buffer);
+    }
+    {
+      std::lock_guard<std::mutex> lock(in_flight_mutex_);
+      in_flight_.insert(in_flight_.end(), slots, slots + count);
+    }
+
+    if (src_->PushBufferList(list) != GST_FLOW_OK) {
+      break;
+    }
+  }
+}
+
+void InferenceWorker::HandlePrediction(gpointer meta) {
+  size_t slot;
+  {
+    std::lock_guard<std::mutex> lock(in_flight_mutex_);
+    if (in_flight_.empty()) {
+      return;
+    }
+    slot = in_flight_.front();
+    in_flight_.pop_front();
+  }
+
+  GstDetectionMeta* detection_meta = static_cast<GstDetectionMeta*>(meta);
+  fastocloud::machine_learning::InferenceBoxShm boxes[INFERENCE_SHM_MAX_BOXES];
+  size_t count = 0;
+  for (int i = 0; i < detection_meta->num_boxes && count < INFERENCE_SHM_MAX_BOXES; ++i) {
+    const BBox* box = detection_meta->boxes + i;
+    boxes[count++] = {box->label, box->prob, box->x, box->y, box->width, box->height};
+  }
+  fastocloud::machine_learning::CompleteInferenceSlot(shm_, slot, boxes, count);
+}
+
+void InferenceWorker::new_prediction_callback(GstElement* elem, gpointer meta, gpointer user_data) {
+  UNUSED(elem);
+  InferenceWorker* worker = static_cast<InferenceWorker*>(user_data);
+  worker->HandlePrediction(meta);
+}
+
+gboolean InferenceWorker::async_bus_callback(GstBus* bus, GstMessage* message, gpointer user_data) {
+  UNUSED(bus);
+  InferenceWorker* worker = static_cast<InferenceWorker*>(user_data);
+  if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_ERROR) {
+    GError* err = nullptr;
+    gst_message_parse_error(message, &err, nullptr);
+    ERROR_LOG() << "Inference pipeline error: " << (err ? err->message : "unknown");
+    g_clear_error(&err);
+    worker->failed_ = true;
+    worker->Quit();
+  } else if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS) {
+    worker->Quit();
+  }
+  return TRUE;
+}
+
+gboolean InferenceWorker::quit_callback(gpointer user_data) {
+  InferenceWorker* worker = static_cast<InferenceWorker*>(user_data);
+  worker->Quit();
+  return TRUE;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,78 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <common/macros.h>
+
+#include "base/machine_learning/inference_shm.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace machine_learning {
+class ElementVideoMLFilter;
+}
+namespace sources {
+class ElementAppSrc;
+}
+}  // namespace elements
+
+// process of daemon serving one model to all streams of node:
+// appsrc => tiny yolo => fakesink, fed with pending frames of segment in request order
+class InferenceWorker {
+ public:
+  enum { idle_usec = 2000 };  // segment polled while no frames pending
+
+  InferenceWorker(const fastocloud::machine_learning::DeepLearning& learning,
+                  fastocloud::machine_learning::InferenceShm* shm);  // segment not owned
+  ~InferenceWorker();
+
+  int Exec();  // until SIGTERM or pipeline error
+  void Quit();
+
+ private:
+  bool InitPipeline();
+  void FeedLoop();
+  void HandlePrediction(gpointer meta);
+
+  static void new_prediction_callback(GstElement* elem, gpointer meta, gpointer user_data);
+  static gboolean async_bus_callback(GstBus* bus, GstMessage* message, gpointer user_data);
+  static gboolean quit_callback(gpointer user_data);
+
+  const fastocloud::machine_learning::DeepLearning learning_;
+  fastocloud::machine_learning::InferenceShm* const shm_;
+  GMainLoop* const loop_;
+  GstElement* pipeline_;
+  elements::sources::ElementAppSrc* src_;
+  elements::machine_learning::ElementVideoMLFilter* filter_;
+
+  std::mutex in_flight_mutex_;
+  std::deque<size_t> in_flight_;  // slots pushed and not answered, filter keeps order
+  std::atomic<bool> stop_;
+  std::thread feed_thread_;
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(InferenceWorker);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
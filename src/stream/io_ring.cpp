@@ -0,0 +1,291 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/io_ring.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(OS_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#define HAVE_IO_URING
+#endif
+#endif
+#endif
+
+namespace fastocloud {
+namespace stream {
+
+#if defined(HAVE_IO_URING)
+struct IoRing::Rings {
+  void* sq_ptr;
+  size_t sq_size;
+  void* cq_ptr;
+  size_t cq_size;
+  struct io_uring_sqe* sqes;
+  size_t sqes_size;
+
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  unsigned sq_entries;
+
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  struct io_uring_cqe* cqes;
+};
+
+namespace {
+uint8_t* offset_ptr(void* base, uint32_t offset) {
+  return static_cast<uint8_t*>(base) + offset;
+}
+}  // namespace
+#else
+struct IoRing::Rings {};
+#endif
+
+IoRing::IoRing() : fd_(-1), rings_(nullptr), prepared_(0) {}
+
+IoRing::~IoRing() {
+  Close();
+}
+
+bool IoRing::Init(unsigned entries) {
+  Close();
+#if defined(HAVE_IO_URING)
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  const long fd = syscall(__NR_io_uring_setup, entries, &params);
+  if (fd < 0) {
+    return false;
+  }
+
+  fd_ = fd;
+  rings_ = new Rings;
+  memset(rings_, 0, sizeof(Rings));
+  rings_->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  rings_->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  rings_->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  // rings mapped separately, valid with and without IORING_FEAT_SINGLE_MMAP
+  const int prot = PROT_READ | PROT_WRITE;
+  const int flags = MAP_SHARED | MAP_POPULATE;
+  void* sq = mmap(nullptr, rings_->sq_size, prot, flags, fd_, IORING_OFF_SQ_RING);
+  void* cq = mmap(nullptr, rings_->cq_size, prot, flags, fd_, IORING_OFF_CQ_RING);
+  void* sqes = mmap(nullptr, rings_->sqes_size, prot, flags, fd_, IORING_OFF_SQES);
+  rings_->sq_ptr = sq == MAP_FAILED ? nullptr : sq;
+  rings_->cq_ptr = cq == MAP_FAILED ? nullptr : cq;
+  rings_->sqes = sqes == MAP_FAILED ? nullptr : static_cast<struct io_uring_sqe*>(sqes);
+  if (!rings_->sq_ptr || !rings_->cq_ptr || !rings_->sqes) {
+    Close();
+    return false;
+  }
+
+  rings_->sq_head = reinterpret_cast<unsigned*>(offset_ptr(sq, params.sq_off.head));
+  rings_->sq_tail = reinterpret_cast<unsigned*>(offset_ptr(sq, params.sq_off.tail));
+  rings_->sq_mask = reinterpret_cast<unsigned*>(offset_ptr(sq, params.sq_off.ring_mask));
+  rings_->sq_array = reinterpret_cast<unsigned*>(offset_ptr(sq, params.sq_off.array));
+  rings_->sq_entries = params.sq_entries;
+  rings_->cq_head = reinterpret_cast<unsigned*>(offset_ptr(cq, params.cq_off.head));
+  rings_->cq_tail = reinterpret_cast<unsigned*>(offset_ptr(cq, params.cq_off.tail));
+  rings_->cq_mask = reinterpret_cast<unsigned*>(offset_ptr(cq, params.cq_off.ring_mask));
+  rings_->cqes = reinterpret_cast<struct io_uring_cqe*>(offset_ptr(cq, params.cq_off.cqes));
+  return true;
+#else
+  UNUSED(entries);
+  return false;
+#endif
+}
+
+bool IoRing::IsValid() const {
+  return fd_ != -1;
+}
+
+bool IoRing::RegisterBuffers(const struct iovec* buffers, unsigned count) {
+  if (!IsValid()) {
+    return false;
+  }
+
+#if defined(HAVE_IO_URING)
+  return syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+#else
+  UNUSED(buffers);
+  UNUSED(count);
+  return false;
+#endif
+}
+
+bool IoRing::PrepareWriteFixed(int fd,
+                               const void* data,
+                               uint32_t size,
+                               uint64_t offset,
+                               int buffer_index,
+                               uint64_t tag) {
+#if defined(HAVE_IO_URING)
+  return Prepare(IORING_OP_WRITE_FIXED, fd, data, size, offset, buffer_index, tag);
+#else
+  UNUSED(fd);
+  UNUSED(data);
+  UNUSED(size);
+  UNUSED(offset);
+  UNUSED(buffer_index);
+  UNUSED(tag);
+  return false;
+#endif
+}
+
+bool IoRing::PrepareReadFixed(int fd, void* data, uint32_t size, uint64_t offset, int buffer_index, uint64_t tag) {
+#if defined(HAVE_IO_URING)
+  return Prepare(IORING_OP_READ_FIXED, fd, data, size, offset, buffer_index, tag);
+#else
+  UNUSED(fd);
+  UNUSED(data);
+  UNUSED(size);
+  UNUSED(offset);
+  UNUSED(buffer_index);
+  UNUSED(tag);
+  return false;
+#endif
+}
+
+bool IoRing::Prepare(uint8_t opcode,
+                     int fd,
+                     const void* data,
+                     uint32_t size,
+                     uint64_t offset,
+                     int index,
+                     uint64_t tag) {
+  if (!IsValid()) {
+    return false;
+  }
+
+#if defined(HAVE_IO_URING)
+  const unsigned tail = *rings_->sq_tail;  // written only by owner
+  const unsigned head = __atomic_load_n(rings_->sq_head, __ATOMIC_ACQUIRE);
+  if (tail - head >= rings_->sq_entries) {
+    return false;
+  }
+
+  const unsigned pos = tail & *rings_->sq_mask;
+  struct io_uring_sqe* sqe = &rings_->sqes[pos];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  sqe->off = offset;
+  sqe->addr = reinterpret_cast<uint64_t>(data);
+  sqe->len = size;
+  sqe->buf_index = index;
+  sqe->user_data = tag;
+  rings_->sq_array[pos] = pos;
+  __atomic_store_n(rings_->sq_tail, tail + 1, __ATOMIC_RELEASE);
+  prepared_++;
+  return true;
+#else
+  UNUSED(opcode);
+  UNUSED(fd);
+  UNUSED(data);
+  UNUSED(size);
+  UNUSED(offset);
+  UNUSED(index);
+  UNUSED(tag);
+  return false;
+#endif
+}
+
+bool IoRing::Submit(unsigned wait_count) {
+  if (!IsValid()) {
+    return false;
+  }
+
+#if defined(HAVE_IO_URING)
+  while (prepared_ || wait_count) {
+    const unsigned flags = wait_count ? IORING_ENTER_GETEVENTS : 0;
+    const long res = syscall(__NR_io_uring_enter, fd_, prepared_, wait_count, flags, nullptr, 0);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    prepared_ -= static_cast<unsigned>(res);
+    break;
+  }
+  return true;
+#else
+  UNUSED(wait_count);
+  return false;
+#endif
+}
+
+bool IoRing::PeekCompletion(uint64_t* tag, int* res) {
+  if (!IsValid() || !tag || !res) {
+    return false;
+  }
+
+#if defined(HAVE_IO_URING)
+  const unsigned head = *rings_->cq_head;
+  if (head == __atomic_load_n(rings_->cq_tail, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+
+  const struct io_uring_cqe* cqe = &rings_->cqes[head & *rings_->cq_mask];
+  *tag = cqe->user_data;
+  *res = cqe->res;
+  __atomic_store_n(rings_->cq_head, head + 1, __ATOMIC_RELEASE);
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool IoRing::WaitCompletion(uint64_t* tag, int* res) {
+  while (!PeekCompletion(tag, res)) {
+    if (!Submit(1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void IoRing::Close() {
+#if defined(HAVE_IO_URING)
+  if (rings_) {
+    if (rings_->sq_ptr) {
+      munmap(rings_->sq_ptr, rings_->sq_size);
+    }
+    if (rings_->cq_ptr) {
+      munmap(rings_->cq_ptr, rings_->cq_size);
+    }
+    if (rings_->sqes) {
+      munmap(rings_->sqes, rings_->sqes_size);
+    }
+  }
+#endif
+  delete rings_;
+  rings_ = nullptr;
+  if (fd_ != -1) {
+    close(fd_);
+    fd_ = -1;
+  }
+  prepared_ = 0;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,62 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace stream {
+
+// minimal io_uring of one owner thread, rings mapped without liburing
+// Init fails where kernel, headers or seccomp reject io_uring, callers keep synchronous io then
+class IoRing {
+ public:
+  IoRing();
+  ~IoRing();
+
+  bool Init(unsigned entries);
+  bool IsValid() const;
+  void Close();  // rings unmapped, Init allowed again
+
+  // buffers pinned once, fixed reads and writes skip page mapping of each request
+  bool RegisterBuffers(const struct iovec* buffers, unsigned count);
+
+  // queued until Submit, buffer_index of registered buffer containing data
+  bool PrepareWriteFixed(int fd, const void* data, uint32_t size, uint64_t offset, int buffer_index, uint64_t tag);
+  bool PrepareReadFixed(int fd, void* data, uint32_t size, uint64_t offset, int buffer_index, uint64_t tag);
+  bool Submit(unsigned wait_count);  // all prepared in one syscall, blocks until wait_count completed
+
+  // res is bytes transferred or -errno
+  bool PeekCompletion(uint64_t* tag, int* res);
+  bool WaitCompletion(uint64_t* tag, int* res);  // request must be in flight
+
+ private:
+  struct Rings;
+
+  bool Prepare(uint8_t opcode, int fd, const void* data, uint32_t size, uint64_t offset, int index, uint64_t tag);
+
+  int fd_;
+  Rings* rings_;
+  unsigned prepared_;
+
+  DISALLOW_COPY_AND_ASSIGN(IoRing);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
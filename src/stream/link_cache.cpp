@@ -0,0 +1,65 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/link_cache.h"
+
+namespace fastocloud {
+namespace stream {
+
+LinkCache::LinkCache() : mutex_(), links_() {}
+
+std::string LinkCache::MakeKey(const std::string& src_name,
+                               const std::string& src_plugin,
+                               const std::string& dest_name,
+                               const std::string& dest_plugin) {
+  return src_name + ":" + src_plugin + "->" + dest_name + ":" + dest_plugin;
+}
+
+bool LinkCache::Find(const std::string& key, Link* link) const {
+  if (!link) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto it = links_.find(key);
+  if (it == links_.end()) {
+    return false;
+  }
+
+  *link = it->second;
+  return true;
+}
+
+void LinkCache::Set(const std::string& key, const Link& link) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  links_[key] = link;
+}
+
+void LinkCache::Remove(const std::string& key) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  links_.erase(key);
+}
+
+void LinkCache::Clear() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  links_.clear();
+}
+
+size_t LinkCache::GetCount() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return links_.size();
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,63 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <common/patterns/singleton_pattern.h>
+
+namespace fastocloud {
+namespace stream {
+
+// pads chosen by caps negotiation of static links in previous pipelines of this process, rebuilt pipelines link
+// same pads with template check only, without pad lookup and caps queries of both elements;
+// link position is names and plugins of both elements, cleared when negotiation of pipeline failed
+class LinkCache : public common::patterns::LazySingleton<LinkCache> {
+ public:
+  friend class common::patterns::LazySingleton<LinkCache>;
+
+  struct Pad {
+    std::string name;  // template name of request pad
+    bool request;
+  };
+
+  struct Link {
+    Pad src;
+    Pad sink;
+  };
+
+  static std::string MakeKey(const std::string& src_name,
+                             const std::string& src_plugin,
+                             const std::string& dest_name,
+                             const std::string& dest_plugin);
+
+  bool Find(const std::string& key, Link* link) const;
+  void Set(const std::string& key, const Link& link);
+  void Remove(const std::string& key);  // cached pads not linked
+  void Clear();                         // next builds negotiate every link
+
+  size_t GetCount() const;
+
+ private:
+  LinkCache();
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Link> links_;
+};
+
+}  // namespace stream
+}  // namespace fastocloud
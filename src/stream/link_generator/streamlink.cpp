@@ -12,39 +12,18 @@
     along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <chrono>
 #include <string>
+#include <vector>
 
 #include "stream/link_generator/streamlink.h"
 
 #include <common/sprintf.h>
+#include <common/time.h>
 
 namespace {
-bool GetTrueUrl(const std::string& path, const common::uri::Url& url, common::uri::Url* generated_url) {
-  if (!generated_url) {
-    return false;
-  }
-
-  const std::string cmd_line = common::MemSPrintf("%s %s best --stream-url", path, url.GetUrl());
-  FILE* fp = popen(cmd_line.c_str(), "r");
-  if (!fp) {
-    return false;
-  }
-
-  char true_url[1024] = {0};
-  char* res = fgets(true_url, sizeof(true_url) - 1, fp);
-  pclose(fp);
-
-  if (!res) {
-    return false;
-  }
-
-  size_t ln = strlen(true_url) - 1;
-  if (true_url[ln] == '\n') {
-    true_url[ln] = 0;
-  }
-
-  *generated_url = common::uri::Url(true_url);
-  return true;
+time_t current_time_sec() {
+  return common::time::current_utc_mstime() / 1000;
 }
 }  // namespace
 
@@ -52,8 +31,26 @@ namespace fastocloud {
 namespace stream {
 namespace link_generator {
 
-StreamLinkGenerator::StreamLinkGenerator(const common::file_system::ascii_file_string_path& script_path)
-    : script_path_(script_path) {}
+StreamLinkGenerator::StreamLinkGenerator(const common::file_system::ascii_file_string_path& script_path,
+                                         time_t ttl_sec)
+    : script_path_(script_path),
+      ttl_sec_(ttl_sec),
+      cache_mutex_(),
+      cache_cond_(),
+      cache_(),
+      stop_(false),
+      resolver_thread_() {
+  resolver_thread_ = std::thread(&StreamLinkGenerator::RefreshLoop, this);
+}
+
+StreamLinkGenerator::~StreamLinkGenerator() {
+  {
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    stop_ = true;
+    cache_cond_.notify_all();
+  }
+  resolver_thread_.join();
+}
 
 bool StreamLinkGenerator::Generate(const InputUri& src, InputUri* out) const {
   if (!out) {
@@ -68,16 +65,118 @@ bool StreamLinkGenerator::Generate(const InputUri& src, InputUri* out) const {
     return false;
   }
 
+  const common::uri::Url source = src.GetInput();
+  const std::string key = source.GetUrl();
+  {
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    auto it = cache_.find(key);
+    if (it != cache_.end() && it->second.expire_time > current_time_sec()) {
+      *out = src;
+      out->SetInput(it->second.resolved);
+      return true;
+    }
+  }
+
   common::uri::Url gen;
-  if (!GetTrueUrl(script_path_.GetPath(), src.GetInput(), &gen)) {
+  if (!Resolve(source, &gen)) {
     return false;
   }
 
+  {
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    const time_t expire_time = current_time_sec() + ttl_sec_;
+    CacheEntry entry = {source, gen, expire_time, expire_time - refresh_before_expire_sec};
+    cache_[key] = entry;
+    cache_cond_.notify_all();
+  }
+
   *out = src;
   out->SetInput(gen);
   return true;
 }
 
+bool StreamLinkGenerator::Resolve(const common::uri::Url& url, common::uri::Url* generated_url) const {
+  if (!generated_url) {
+    return false;
+  }
+
+  const std::string cmd_line = common::MemSPrintf("%s %s best --stream-url", script_path_.GetPath(), url.GetUrl());
+  FILE* fp = popen(cmd_line.c_str(), "r");
+  if (!fp) {
+    return false;
+  }
+
+  char true_url[1024] = {0};
+  char* res = fgets(true_url, sizeof(true_url) - 1, fp);
+  pclose(fp);
+
+  if (!res) {
+    return false;
+  }
+
+  size_t ln = strlen(true_url) - 1;
+  if (true_url[ln] == '\n') {
+    true_url[ln] = 0;
+  }
+
+  *generated_url = common::uri::Url(true_url);
+  return true;
+}
+
+void StreamLinkGenerator::RefreshLoop() {
+  std::unique_lock<std::mutex> lock(cache_mutex_);
+  while (!stop_) {
+    const time_t now = current_time_sec();
+    time_t next_wakeup = now + ttl_sec_;
+    std::vector<common::uri::Url> to_refresh;
+    for (auto it = cache_.begin(); it != cache_.end();) {
+      const time_t refresh_time = it->second.refresh_time;
+      if (it->second.expire_time <= now) {
+        it = cache_.erase(it);
+        continue;
+      }
+
+      if (refresh_time <= now) {
+        to_refresh.push_back(it->second.source);
+      } else if (refresh_time < next_wakeup) {
+        next_wakeup = refresh_time;
+      }
+      ++it;
+    }
+
+    if (to_refresh.empty()) {
+      cache_cond_.wait_for(lock, std::chrono::seconds(next_wakeup - now));
+      continue;
+    }
+
+    lock.unlock();
+    for (const common::uri::Url& source : to_refresh) {
+      common::uri::Url gen;
+      const bool resolved = Resolve(source, &gen);
+      std::unique_lock<std::mutex> refresh_lock(cache_mutex_);
+      if (stop_) {
+        break;
+      }
+
+      auto it = cache_.find(source.GetUrl());
+      if (it == cache_.end()) {
+        continue;
+      }
+
+      const time_t cur_time = current_time_sec();
+      if (resolved) {
+        it->second.resolved = gen;
+        it->second.expire_time = cur_time + ttl_sec_;
+        it->second.refresh_time = it->second.expire_time - refresh_before_expire_sec;
+      } else {
+        // keep previous url until expiration
+        it->second.refresh_time = cur_time + refresh_retry_sec;
+      }
+    }
+    lock.lock();
+  }
+}
+
 }  // namespace link_generator
 }  // namespace stream
 }  // namespace fastocloud
@@ -14,6 +14,12 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #include <common/file_system/path.h>
 
 #include "stream/link_generator/ilink_generator.h"
@@ -22,14 +28,38 @@ namespace fastocloud {
 namespace stream {
 namespace link_generator {
 
+// resolved urls cached by source url, resolver thread refreshes them before expiration
 class StreamLinkGenerator : public ILinkGenerator {
  public:
-  explicit StreamLinkGenerator(const common::file_system::ascii_file_string_path& script_path);
+  enum { cache_ttl_sec = 300, refresh_before_expire_sec = 60, refresh_retry_sec = 10 };
+
+  explicit StreamLinkGenerator(const common::file_system::ascii_file_string_path& script_path,
+                               time_t ttl_sec = cache_ttl_sec);
+  ~StreamLinkGenerator() override;
 
   bool Generate(const InputUri& src, InputUri* out) const override WARN_UNUSED_RESULT;
 
  private:
+  struct CacheEntry {
+    common::uri::Url source;
+    common::uri::Url resolved;
+    time_t expire_time;
+    time_t refresh_time;
+  };
+
+  bool Resolve(const common::uri::Url& url, common::uri::Url* generated_url) const WARN_UNUSED_RESULT;
+  void RefreshLoop();
+
   const common::file_system::ascii_file_string_path script_path_;
+  const time_t ttl_sec_;
+
+  mutable std::mutex cache_mutex_;
+  mutable std::condition_variable cache_cond_;
+  mutable std::map<std::string, CacheEntry> cache_;
+  bool stop_;
+  std::thread resolver_thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamLinkGenerator);
 };
 
 }  // namespace link_generator
@@ -0,0 +1,237 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/live_config.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/config_fields.h"
+
+#include "stream/config.h"
+#include "stream/streams/configs/encode_config.h"
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+
+bool IsEncodeType(fastotv::StreamType type) {
+  return type == fastotv::ENCODE || type == fastotv::VOD_ENCODE || type == fastotv::COD_ENCODE ||
+         type == fastotv::EVENT;
+}
+
+bool IsRelayType(fastotv::StreamType type) {
+  return type == fastotv::RELAY || type == fastotv::VOD_RELAY || type == fastotv::COD_RELAY;
+}
+
+const OutputUri* FindOutput(const output_t& outputs, fastotv::channel_id_t id) {
+  for (const OutputUri& output : outputs) {
+    if (output.GetID() == id) {
+      return &output;
+    }
+  }
+  return nullptr;
+}
+
+// outputs only added or removed by id, changed ones need restart
+bool MakeOutputsUpdate(const output_t& outputs, const output_t& updated, LiveConfigUpdate* update) {
+  for (const OutputUri& output : outputs) {
+    const OutputUri* same = FindOutput(updated, output.GetID());
+    if (!same) {
+      update->removed_outputs.push_back(output.GetID());
+    } else if (same->GetOutput().GetUrl() != output.GetOutput().GetUrl() ||
+               same->GetHlsType() != output.GetHlsType()) {
+      return false;
+    }
+  }
+  for (const OutputUri& output : updated) {
+    if (!FindOutput(outputs, output.GetID())) {
+      update->added_outputs.push_back(output);
+    }
+  }
+  return true;
+}
+
+bool IsSameSize(const Logo::image_size_t& size, const Logo::image_size_t& other) {
+  if (!size || !other) {
+    return !size && !other;
+  }
+  return size->width == other->width && size->height == other->height;
+}
+
+}  // namespace
+
+LiveConfigUpdate::LiveConfigUpdate()
+    : volume(),
+      video_bitrate(),
+      logo_position(),
+      logo_alpha(),
+      rsvg_logo_position(),
+      hls_max_files(0),
+      added_outputs(),
+      removed_outputs() {}
+
+bool LiveConfigUpdate::IsEmpty() const {
+  return !volume && !video_bitrate && !logo_position && !logo_alpha && !rsvg_logo_position && !hls_max_files &&
+         added_outputs.empty() && removed_outputs.empty();
+}
+
+void LiveConfigUpdate::Append(const LiveConfigUpdate& update) {
+  if (update.volume) {
+    volume = update.volume;
+  }
+  if (update.video_bitrate) {
+    video_bitrate = update.video_bitrate;
+  }
+  if (update.logo_position) {
+    logo_position = update.logo_position;
+  }
+  if (update.logo_alpha) {
+    logo_alpha = update.logo_alpha;
+  }
+  if (update.rsvg_logo_position) {
+    rsvg_logo_position = update.rsvg_logo_position;
+  }
+  if (update.hls_max_files) {
+    hls_max_files = update.hls_max_files;
+  }
+  for (fastotv::channel_id_t id : update.removed_outputs) {
+    auto it = std::find_if(added_outputs.begin(), added_outputs.end(),
+                           [id](const OutputUri& output) { return output.GetID() == id; });
+    if (it != added_outputs.end()) {  // not attached yet
+      added_outputs.erase(it);
+    } else {
+      removed_outputs.push_back(id);
+    }
+  }
+  added_outputs.insert(added_outputs.end(), update.added_outputs.begin(), update.added_outputs.end());
+}
+
+StreamConfig MergeStreamConfig(const StreamConfig& config, const StreamConfig& changes) {
+  StreamConfig merged(new common::HashValue);
+  for (auto it = config->begin(); it != config->end(); ++it) {
+    if (!changes->Find(it->first)) {
+      merged->Insert(it->first, it->second->DeepCopy());
+    }
+  }
+  for (auto it = changes->begin(); it != changes->end(); ++it) {
+    merged->Insert(it->first, it->second->DeepCopy());
+  }
+  return merged;
+}
+
+common::Error CheckStreamConfigUpdate(const StreamConfig& config, const StreamConfig& changes) {
+  if (!config || !changes) {
+    return common::make_error_inval();
+  }
+
+  if (changes->Find(ID_FIELD) && GetSid(changes) != GetSid(config)) {
+    return common::make_error("Stream id can't be changed");
+  }
+
+  if (changes->Find(TYPE_FIELD)) {
+    int type;
+    int new_type;
+    common::Value* type_field = config->Find(TYPE_FIELD);
+    common::Value* new_type_field = changes->Find(TYPE_FIELD);
+    if (!type_field || !type_field->GetAsInteger(&type) || !new_type_field->GetAsInteger(&new_type) ||
+        type != new_type) {
+      return common::make_error("Stream type can't be changed");
+    }
+  }
+
+  return common::Error();
+}
+
+bool MakeLiveConfigUpdate(const Config* config,
+                          const Config* updated,
+                          const StreamConfig& changes,
+                          LiveConfigUpdate* update) {
+  if (!config || !updated || !changes || !update) {
+    return false;
+  }
+
+  const bool encode = IsEncodeType(config->GetType());
+  if ((!encode && !IsRelayType(config->GetType())) || config->GetType() != updated->GetType()) {
+    return false;
+  }
+
+  const streams::EncodeConfig* econfig = encode ? static_cast<const streams::EncodeConfig*>(config) : nullptr;
+  const streams::EncodeConfig* eupdated = encode ? static_cast<const streams::EncodeConfig*>(updated) : nullptr;
+  LiveConfigUpdate lupdate;
+  for (auto it = changes->begin(); it != changes->end(); ++it) {
+    const std::string field = it->first.as_string();
+    if (field == ID_FIELD || field == TYPE_FIELD) {  // checked as not changed
+      continue;
+    }
+
+    if (field == OUTPUT_FIELD) {
+      if (!MakeOutputsUpdate(config->GetOutput(), updated->GetOutput(), &lupdate)) {
+        return false;
+      }
+      continue;
+    }
+
+    if (field == HLS_MAX_FILES_FIELD) {  // sent by service, sized by requests of viewers
+      if (!updated->GetHlsMaxFiles()) {
+        return false;
+      }
+      lupdate.hls_max_files = updated->GetHlsMaxFiles();
+      continue;
+    }
+
+    if (!encode) {  // relays change only outputs and retention live
+      return false;
+    }
+
+    if (field == VOLUME_FIELD) {
+      // volume element created only if volume was in config
+      if (!econfig->GetVolume() || !eupdated->GetVolume()) {
+        return false;
+      }
+      lupdate.volume = eupdated->GetVolume();
+    } else if (field == VIDEO_BIT_RATE_FIELD) {
+      // renditions have own bitrates, relayed video has no encoder
+      if (econfig->GetRelayVideo() || !econfig->GetRenditions().empty() || !econfig->GetVideoBitrate() ||
+          !eupdated->GetVideoBitrate()) {
+        return false;
+      }
+      lupdate.video_bitrate = eupdated->GetVideoBitrate();
+    } else if (field == LOGO_FIELD) {
+      const auto logo = econfig->GetLogo();
+      const auto new_logo = eupdated->GetLogo();
+      if (!logo || !new_logo || !logo->Equals(*new_logo) || !IsSameSize(logo->GetSize(), new_logo->GetSize())) {
+        return false;
+      }
+      lupdate.logo_position = new_logo->GetPosition();
+      lupdate.logo_alpha = new_logo->GetAlpha();
+    } else if (field == RSVG_LOGO_FIELD) {
+      const auto logo = econfig->GetRSVGLogo();
+      const auto new_logo = eupdated->GetRSVGLogo();
+      if (!logo || !new_logo || !logo->Equals(*new_logo) || !IsSameSize(logo->GetSize(), new_logo->GetSize())) {
+        return false;
+      }
+      lupdate.rsvg_logo_position = new_logo->GetPosition();
+    } else {
+      return false;
+    }
+  }
+
+  *update = lupdate;
+  return true;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
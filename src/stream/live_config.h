@@ -0,0 +1,65 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <common/draw/types.h>
+#include <common/error.h>
+
+#include "base/inputs_outputs.h"
+#include "base/stream_config.h"
+#include "base/types.h"
+
+namespace fastocloud {
+namespace stream {
+
+class Config;
+
+// changes of running pipeline applied by element properties and output branches, without restart
+struct LiveConfigUpdate {
+  typedef common::Optional<common::draw::Point> position_t;
+  typedef common::Optional<alpha_t> logo_alpha_t;
+  typedef std::vector<fastotv::channel_id_t> output_ids_t;
+
+  LiveConfigUpdate();
+
+  bool IsEmpty() const;
+  void Append(const LiveConfigUpdate& update);  // fields of newer update replace own
+
+  volume_t volume;
+  bit_rate_t video_bitrate;
+  position_t logo_position;
+  logo_alpha_t logo_alpha;
+  position_t rsvg_logo_position;
+  size_t hls_max_files;           // segments kept by hls sinks, 0 - unchanged
+  output_t added_outputs;         // branches attached to running tees
+  output_ids_t removed_outputs;  // detached before added ones are attached
+};
+
+// fields of changes replace fields of config
+StreamConfig MergeStreamConfig(const StreamConfig& config, const StreamConfig& changes);
+
+// id and type of stream not updated, stream should be stopped and started with new config instead
+common::Error CheckStreamConfigUpdate(const StreamConfig& config, const StreamConfig& changes) WARN_UNUSED_RESULT;
+
+// updated is config merged with changes, false if some of changed fields applied only by restart
+bool MakeLiveConfigUpdate(const Config* config,
+                          const Config* updated,
+                          const StreamConfig& changes,
+                          LiveConfigUpdate* update) WARN_UNUSED_RESULT;
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,300 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/loudness_meter.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+namespace {
+double to_lufs(double power) {
+  if (power <= 0) {
+    return fastocloud::stream::LoudnessMeter::min_lufs;
+  }
+  return std::max(-0.691 + 10 * log10(power), static_cast<double>(fastocloud::stream::LoudnessMeter::min_lufs));
+}
+
+double to_power(double lufs) {
+  return pow(10, (lufs + 0.691) / 10);
+}
+
+size_t to_bin(double lufs) {
+  typedef fastocloud::stream::LoudnessMeter meter_t;
+  const double bin = (lufs - meter_t::absolute_gate) * meter_t::bins_per_lu;
+  if (bin <= 0) {
+    return 0;
+  }
+  return std::min(static_cast<size_t>(bin), static_cast<size_t>(meter_t::histogram_bins - 1));
+}
+}  // namespace
+
+namespace fastocloud {
+namespace stream {
+
+LoudnessMeter::LoudnessMeter()
+    : format_(AudioMeter::FORMAT_UNKNOWN),
+      stride_(0),
+      channels_(0),
+      sample_size_(0),
+      block_frames_(0),
+      frames_(0),
+      weight_(),
+      shelf_b_(),
+      shelf_a_(),
+      pass_a_(),
+      shelf_z1_(),
+      shelf_z2_(),
+      pass_z1_(),
+      pass_z2_(),
+      power_(),
+      blocks_(),
+      blocks_count_(0),
+      next_block_(0),
+      histogram_(histogram_bins, 0),
+      bin_power_(histogram_bins, 0),
+      loudness_() {
+  for (size_t i = 0; i < bin_power_.size(); ++i) {
+    bin_power_[i] = to_power(absolute_gate + (i + 0.5) / bins_per_lu);  // middle of bin
+  }
+  Reset();
+}
+
+bool LoudnessMeter::SetFormat(AudioMeter::Format format, size_t channels, int rate) {
+  format_ = AudioMeter::FORMAT_UNKNOWN;
+  Reset();
+  if (channels == 0 || rate <= 0) {
+    return false;
+  }
+
+  switch (format) {
+    case AudioMeter::FORMAT_S16:
+      sample_size_ = sizeof(int16_t);
+      break;
+    case AudioMeter::FORMAT_S32:
+      sample_size_ = sizeof(int32_t);
+      break;
+    case AudioMeter::FORMAT_F32:
+      sample_size_ = sizeof(float);
+      break;
+    case AudioMeter::FORMAT_F64:
+      sample_size_ = sizeof(double);
+      break;
+    default:
+      return false;
+  }
+
+  // filters of itu-r bs.1770 for any sample rate
+  const double shelf_k = tan(M_PI * 1681.974450955533 / rate);
+  const double shelf_q = 0.7071752369554196;
+  const double vh = pow(10, 3.999843853973347 / 20);
+  const double vb = pow(vh, 0.4996667741545416);
+  const double shelf_a0 = 1 + shelf_k / shelf_q + shelf_k * shelf_k;
+  shelf_b_[0] = (vh + vb * shelf_k / shelf_q + shelf_k * shelf_k) / shelf_a0;
+  shelf_b_[1] = 2 * (shelf_k * shelf_k - vh) / shelf_a0;
+  shelf_b_[2] = (vh - vb * shelf_k / shelf_q + shelf_k * shelf_k) / shelf_a0;
+  shelf_a_[0] = 1;
+  shelf_a_[1] = 2 * (shelf_k * shelf_k - 1) / shelf_a0;
+  shelf_a_[2] = (1 - shelf_k / shelf_q + shelf_k * shelf_k) / shelf_a0;
+
+  const double pass_k = tan(M_PI * 38.13547087602444 / rate);
+  const double pass_q = 0.5003270373238773;
+  const double pass_a0 = 1 + pass_k / pass_q + pass_k * pass_k;
+  pass_a_[0] = 1;
+  pass_a_[1] = 2 * (pass_k * pass_k - 1) / pass_a0;
+  pass_a_[2] = (1 - pass_k / pass_q + pass_k * pass_k) / pass_a0;
+
+  format_ = format;
+  stride_ = channels;
+  channels_ = std::min(channels, static_cast<size_t>(max_channels));
+  block_frames_ = std::max(static_cast<size_t>(rate * block_msec / 1000), static_cast<size_t>(1));
+  for (size_t c = 0; c < max_channels; ++c) {
+    weight_[c] = 1;
+  }
+  if (channels == 6) {  // 5.1 in default order, lfe not counted and surrounds weighted
+    weight_[3] = 0;
+    weight_[4] = 1.41;
+    weight_[5] = 1.41;
+  }
+  return true;
+}
+
+bool LoudnessMeter::IsActive() const {
+  return format_ != AudioMeter::FORMAT_UNKNOWN;
+}
+
+bool LoudnessMeter::Process(const void* data, size_t size, Loudness* loudness) {
+  if (!data || !loudness || !IsActive()) {
+    return false;
+  }
+
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  const size_t frame_size = sample_size_ * stride_;
+  size_t frames = size / frame_size;
+  bool completed = false;
+  while (frames) {
+    const size_t chunk = std::min(frames, block_frames_ - frames_);
+    switch (format_) {
+      case AudioMeter::FORMAT_S16:
+        Filter(reinterpret_cast<const int16_t*>(bytes), chunk, 1.0 / 32768.0);
+        break;
+      case AudioMeter::FORMAT_S32:
+        Filter(reinterpret_cast<const int32_t*>(bytes), chunk, 1.0 / 2147483648.0);
+        break;
+      case AudioMeter::FORMAT_F32:
+        Filter(reinterpret_cast<const float*>(bytes), chunk, 1.0);
+        break;
+      case AudioMeter::FORMAT_F64:
+        Filter(reinterpret_cast<const double*>(bytes), chunk, 1.0);
+        break;
+      default:
+        return false;
+    }
+
+    bytes += chunk * frame_size;
+    frames -= chunk;
+    frames_ += chunk;
+    if (frames_ == block_frames_) {
+      CompleteBlock();
+      completed = true;
+    }
+  }
+
+  if (!completed) {
+    return false;
+  }
+
+  *loudness = loudness_;
+  return true;
+}
+
+template <typename T>
+void LoudnessMeter::Filter(const T* samples, size_t frames, double scale) {
+  // both biquads recurse along time, channels of frame are independent lanes with state in own arrays,
+  // so inner loop has no dependency between iterations and is vectorized by compiler
+  for (size_t f = 0; f < frames; ++f) {
+    const T* frame = samples + f * stride_;
+    for (size_t c = 0; c < channels_; ++c) {
+      const double x = frame[c] * scale;
+      const double y = shelf_b_[0] * x + shelf_z1_[c];
+      shelf_z1_[c] = shelf_b_[1] * x - shelf_a_[1] * y + shelf_z2_[c];
+      shelf_z2_[c] = shelf_b_[2] * x - shelf_a_[2] * y;
+      const double z = y + pass_z1_[c];  // high pass numerator 1, -2, 1
+      pass_z1_[c] = -2 * y - pass_a_[1] * z + pass_z2_[c];
+      pass_z2_[c] = y - pass_a_[2] * z;
+      power_[c] += z * z;
+    }
+  }
+}
+
+void LoudnessMeter::CompleteBlock() {
+  double power = 0;
+  for (size_t c = 0; c < channels_; ++c) {
+    power += weight_[c] * power_[c];
+    power_[c] = 0;
+    // state of filters fed by digital silence decays to denormals, slow on most cpus
+    double* states[] = {&shelf_z1_[c], &shelf_z2_[c], &pass_z1_[c], &pass_z2_[c]};
+    for (double* state : states) {
+      if (fabs(*state) < 1e-15) {
+        *state = 0;
+      }
+    }
+  }
+  blocks_[next_block_] = power / frames_;
+  next_block_ = (next_block_ + 1) % short_term_blocks;
+  blocks_count_ = std::min(blocks_count_ + 1, static_cast<size_t>(short_term_blocks));
+  frames_ = 0;
+  if (blocks_count_ < momentary_blocks) {
+    return;
+  }
+
+  loudness_.momentary = to_lufs(GetMeanPower(momentary_blocks));  // gating block, overlapped by 75%
+  loudness_.short_term = to_lufs(GetMeanPower(blocks_count_));
+  if (loudness_.momentary > absolute_gate) {
+    histogram_[to_bin(loudness_.momentary)]++;
+    loudness_.integrated = GetIntegrated();
+  }
+}
+
+double LoudnessMeter::GetMeanPower(size_t blocks) const {
+  double power = 0;
+  for (size_t i = 0; i < blocks; ++i) {
+    power += blocks_[(next_block_ + short_term_blocks - 1 - i) % short_term_blocks];
+  }
+  return power / blocks;
+}
+
+double LoudnessMeter::GetIntegrated() const {
+  double power = 0;
+  uint64_t count = 0;
+  for (size_t i = 0; i < histogram_.size(); ++i) {
+    power += histogram_[i] * bin_power_[i];
+    count += histogram_[i];
+  }
+  if (!count) {
+    return min_lufs;
+  }
+
+  const double gate = to_lufs(power / count) + relative_gate;
+  power = 0;
+  count = 0;
+  for (size_t i = to_bin(gate); i < histogram_.size(); ++i) {
+    power += histogram_[i] * bin_power_[i];
+    count += histogram_[i];
+  }
+  return count ? to_lufs(power / count) : static_cast<double>(min_lufs);
+}
+
+void LoudnessMeter::Reset() {
+  frames_ = 0;
+  blocks_count_ = 0;
+  next_block_ = 0;
+  std::fill(shelf_z1_, shelf_z1_ + max_channels, 0.0);
+  std::fill(shelf_z2_, shelf_z2_ + max_channels, 0.0);
+  std::fill(pass_z1_, pass_z1_ + max_channels, 0.0);
+  std::fill(pass_z2_, pass_z2_ + max_channels, 0.0);
+  std::fill(power_, power_ + max_channels, 0.0);
+  std::fill(histogram_.begin(), histogram_.end(), 0);
+  loudness_.momentary = min_lufs;
+  loudness_.short_term = min_lufs;
+  loudness_.integrated = min_lufs;
+}
+
+LoudnessNormalizer::LoudnessNormalizer(double target_lufs) : target_(target_lufs), gain_(0) {}
+
+double LoudnessNormalizer::GetGain() const {
+  return gain_;
+}
+
+bool LoudnessNormalizer::Update(double short_term_lufs, int peak_db, double* gain_db) {
+  if (!gain_db || short_term_lufs <= LoudnessMeter::absolute_gate) {  // noise of pauses not raised
+    return false;
+  }
+
+  double desired = std::max(std::min(target_ - short_term_lufs, static_cast<double>(max_gain_db)),
+                            static_cast<double>(-max_gain_db));
+  desired = std::min(desired, static_cast<double>(peak_ceiling_db - peak_db));
+  double gain = desired < gain_ ? std::max(desired, gain_ - cut_step_db) : std::min(desired, gain_ + raise_step_db);
+  gain = round(gain * 10) / 10;  // volume not touched for tenths of db
+  if (gain == gain_) {
+    return false;
+  }
+
+  gain_ = gain;
+  *gain_db = gain_;
+  return true;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
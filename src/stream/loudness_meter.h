@@ -0,0 +1,105 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "stream/audio_meter.h"
+
+namespace fastocloud {
+namespace stream {
+
+// ebu r128 loudness of interleaved raw audio, k-weighted power of 100 msec blocks, integrated one gated on histogram
+class LoudnessMeter {
+ public:
+  enum {
+    max_channels = AudioMeter::max_channels,
+    min_lufs = AudioMeter::min_db,  // silence and not measured
+    block_msec = 100,
+    momentary_blocks = 4,    // 400 msec
+    short_term_blocks = 30,  // 3 sec
+    absolute_gate = -70,     // LUFS
+    relative_gate = -10,     // LU below ungated loudness
+    bins_per_lu = 10,
+    histogram_bins = (5 - absolute_gate) * bins_per_lu  // gating blocks up to +5 LUFS
+  };
+
+  struct Loudness {
+    double momentary;   // LUFS
+    double short_term;  // LUFS
+    double integrated;  // LUFS, since format set
+  };
+
+  LoudnessMeter();
+
+  // channels over max_channels not metered, false if format not supported and metering stopped
+  bool SetFormat(AudioMeter::Format format, size_t channels, int rate);
+  bool IsActive() const;
+
+  // true if block completed and loudness filled
+  bool Process(const void* data, size_t size, Loudness* loudness);
+
+ private:
+  template <typename T>
+  void Filter(const T* samples, size_t frames, double scale);
+  void CompleteBlock();
+  double GetMeanPower(size_t blocks) const;  // of last blocks
+  double GetIntegrated() const;
+  void Reset();
+
+  AudioMeter::Format format_;
+  size_t stride_;    // interleaved channels
+  size_t channels_;  // metered channels
+  size_t sample_size_;
+  size_t block_frames_;
+  size_t frames_;
+  double weight_[max_channels];
+  double shelf_b_[3];  // high shelf of head, then high pass of rlb weighting
+  double shelf_a_[3];
+  double pass_a_[3];
+  double shelf_z1_[max_channels];
+  double shelf_z2_[max_channels];
+  double pass_z1_[max_channels];
+  double pass_z2_[max_channels];
+  double power_[max_channels];
+  double blocks_[short_term_blocks];
+  size_t blocks_count_;
+  size_t next_block_;
+  std::vector<uint64_t> histogram_;  // gating blocks above absolute gate
+  std::vector<double> bin_power_;
+  Loudness loudness_;
+};
+
+// gain bringing short-term loudness to target, cut fast and raised slowly, peak kept under ceiling
+class LoudnessNormalizer {
+ public:
+  enum { max_gain_db = 20, cut_step_db = 3, raise_step_db = 1, peak_ceiling_db = -1 };
+
+  explicit LoudnessNormalizer(double target_lufs);
+
+  double GetGain() const;  // db
+  // peak in dBFS before gain, true if gain changed, held on silence
+  bool Update(double short_term_lufs, int peak_db, double* gain_db);
+
+ private:
+  const double target_;
+  double gain_;
+};
+
+}  // namespace stream
+}  // namespace fastocloud
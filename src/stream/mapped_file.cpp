@@ -0,0 +1,111 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/mapped_file.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fastocloud {
+namespace stream {
+
+MappedFile* MappedFile::Open(const std::string& path) {
+#if defined(OS_POSIX)
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return nullptr;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+    close(fd);
+    return nullptr;
+  }
+
+  const size_t size = st.st_size;
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+
+  madvise(data, size, MADV_SEQUENTIAL);
+  madvise(data, size, MADV_WILLNEED);
+  return new MappedFile(data, size);
+#else
+  UNUSED(path);
+  return nullptr;
+#endif
+}
+
+void MappedFile::Prefetch(const std::string& path) {
+#if defined(OS_LINUX)
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return;
+  }
+
+  posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  close(fd);
+#else
+  UNUSED(path);
+#endif
+}
+
+MappedFile::MappedFile(void* data, size_t size) : data_(data), size_(size), refs_(1) {}
+
+MappedFile::~MappedFile() {
+#if defined(OS_POSIX)
+  munmap(data_, size_);
+#endif
+}
+
+void MappedFile::Unref() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+size_t MappedFile::GetSize() const {
+  return size_;
+}
+
+GstBuffer* MappedFile::MakeBuffer(size_t offset, size_t size) {
+  if (offset >= size_) {
+    return nullptr;
+  }
+
+  if (size > size_ - offset) {
+    size = size_ - offset;
+  }
+
+  refs_.fetch_add(1, std::memory_order_relaxed);
+  GstMemory* mem = gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY, data_, size_, offset, size, this,
+                                          memory_destroy_callback);
+  GstBuffer* buffer = gst_buffer_new();
+  gst_buffer_append_memory(buffer, mem);
+  return buffer;
+}
+
+void MappedFile::memory_destroy_callback(gpointer user_data) {
+  MappedFile* file = reinterpret_cast<MappedFile*>(user_data);
+  file->Unref();
+}
+
+}  // namespace stream
+}  // namespace fastocloud
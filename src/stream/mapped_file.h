@@ -0,0 +1,55 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gst/gstbuffer.h>
+
+#include <atomic>
+#include <string>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace stream {
+
+// read only mapping of file, sliced into buffers without copy
+// buffers keep mapping alive, so it can be released by owner at any time
+class MappedFile {
+ public:
+  static MappedFile* Open(const std::string& path);  // nullptr if file can't be mapped, owner holds reference
+  static void Prefetch(const std::string& path);     // page cache read ahead
+
+  void Unref();
+
+  size_t GetSize() const;
+
+  // buffer wrapping [offset, offset + size) of mapping
+  GstBuffer* MakeBuffer(size_t offset, size_t size);
+
+ private:
+  MappedFile(void* data, size_t size);
+  ~MappedFile();
+
+  static void memory_destroy_callback(gpointer user_data);
+
+  void* const data_;
+  const size_t size_;
+  std::atomic<int> refs_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
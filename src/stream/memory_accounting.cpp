@@ -0,0 +1,257 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/memory_accounting.h"
+
+#include <gst/gst.h>
+
+#if defined(OS_LINUX)
+#include <sys/prctl.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+#include <common/macros.h>
+
+#define ACCOUNTING_ALLOCATOR_NAME "FastocloudAccounting"
+#define UNKNOWN_MEMORY_SITE "unknown"
+#define JEMALLOC_PURGE_ALL_ARENAS "arena.4096.purge"  // MALLCTL_ARENAS_ALL
+
+#if defined(__GNUC__)
+// resolved only if process linked with such allocator
+extern "C" int mallctl(const char* name, void* oldp, size_t* oldlenp, void* newp, size_t newlen)
+    __attribute__((weak));
+extern "C" int MallocExtension_GetNumericProperty(const char* property, size_t* value) __attribute__((weak));
+extern "C" void MallocExtension_ReleaseFreeMemory() __attribute__((weak));
+#endif
+
+namespace fastocloud {
+namespace stream {
+namespace {
+
+struct Site {
+  explicit Site(const std::string& name) : name(name), bytes(0), peak(0), allocations(0) {}
+
+  const std::string name;
+  std::atomic<int64_t> bytes;
+  std::atomic<int64_t> peak;
+  std::atomic<uint64_t> allocations;
+};
+
+struct Record {
+  Site* site;
+  gsize size;
+};
+
+std::mutex g_sites_mutex;
+std::map<std::string, Site*> g_sites;  // never freed, memory can outlive pipelines
+std::atomic<int64_t> g_accounted(0);
+std::atomic<bool> g_installed(false);
+GstAllocator* g_sysmem = nullptr;
+
+std::string current_thread_name() {
+#if defined(OS_LINUX)
+  char name[16] = {0};
+  if (prctl(PR_GET_NAME, name, 0, 0, 0) == 0 && name[0]) {
+    return name;
+  }
+#endif
+  return UNKNOWN_MEMORY_SITE;
+}
+
+Site* find_site(const std::string& name) {
+  std::unique_lock<std::mutex> lock(g_sites_mutex);
+  const auto it = g_sites.find(name);
+  if (it != g_sites.end()) {
+    return it->second;
+  }
+
+  Site* site = new Site(name);
+  g_sites[name] = site;
+  return site;
+}
+
+Site* current_site() {
+  // task threads of pool are renamed for each pad task
+  static thread_local std::string last_name;
+  static thread_local Site* last_site = nullptr;
+  const std::string name = current_thread_name();
+  if (!last_site || name != last_name) {
+    last_site = find_site(name);
+    last_name = name;
+  }
+  return last_site;
+}
+
+GQuark record_quark() {
+  static const GQuark quark = g_quark_from_static_string("fastocloud-memory-record");
+  return quark;
+}
+
+void memory_freed(gpointer data) {
+  Record* record = static_cast<Record*>(data);
+  record->site->bytes -= record->size;
+  g_accounted -= record->size;
+  delete record;
+}
+
+typedef struct {
+  GstAllocator parent;
+} AccountingAllocator;
+
+typedef struct {
+  GstAllocatorClass parent_class;
+} AccountingAllocatorClass;
+
+G_DEFINE_TYPE(AccountingAllocator, accounting_allocator, GST_TYPE_ALLOCATOR)
+
+// memory belongs to sysmem allocator, only counted here and uncounted on its finalize
+GstMemory* accounting_allocator_alloc(GstAllocator* allocator, gsize size, GstAllocationParams* params) {
+  UNUSED(allocator);
+  GstMemory* memory = gst_allocator_alloc(g_sysmem, size, params);
+  if (!memory) {
+    return nullptr;
+  }
+
+  Record* record = new Record;
+  record->site = current_site();
+  record->size = memory->maxsize;
+  const int64_t bytes = record->site->bytes += record->size;
+  record->site->allocations++;
+  int64_t peak = record->site->peak;
+  while (bytes > peak && !record->site->peak.compare_exchange_weak(peak, bytes)) {
+  }
+  g_accounted += record->size;
+  gst_mini_object_set_qdata(GST_MINI_OBJECT_CAST(memory), record_quark(), record, memory_freed);
+  return memory;
+}
+
+void accounting_allocator_free(GstAllocator* allocator, GstMemory* memory) {
+  UNUSED(allocator);
+  gst_allocator_free(memory->allocator, memory);
+}
+
+void accounting_allocator_class_init(AccountingAllocatorClass* klass) {
+  GstAllocatorClass* allocator_class = GST_ALLOCATOR_CLASS(klass);
+  allocator_class->alloc = accounting_allocator_alloc;
+  allocator_class->free = accounting_allocator_free;
+}
+
+void accounting_allocator_init(AccountingAllocator* allocator) {
+  GST_ALLOCATOR_CAST(allocator)->mem_type = ACCOUNTING_ALLOCATOR_NAME;
+}
+
+}  // namespace
+
+bool install_memory_accounting() {
+  if (g_installed) {
+    return false;
+  }
+
+  g_sysmem = gst_allocator_find(GST_ALLOCATOR_SYSMEM);
+  if (!g_sysmem) {
+    return false;
+  }
+
+  GstAllocator* allocator = GST_ALLOCATOR_CAST(g_object_new(accounting_allocator_get_type(), nullptr));
+  gst_object_ref_sink(allocator);
+  gst_allocator_register(ACCOUNTING_ALLOCATOR_NAME, GST_ALLOCATOR_CAST(gst_object_ref(allocator)));
+  gst_allocator_set_default(allocator);
+  g_installed = true;
+  return true;
+}
+
+bool is_memory_accounting_installed() {
+  return g_installed;
+}
+
+uint64_t get_accounted_memory() {
+  const int64_t bytes = g_accounted;
+  return bytes > 0 ? bytes : 0;
+}
+
+std::vector<MemorySite> get_memory_sites() {
+  std::vector<MemorySite> sites;
+  {
+    std::unique_lock<std::mutex> lock(g_sites_mutex);
+    for (const auto& site : g_sites) {
+      const int64_t bytes = site.second->bytes;
+      MemorySite msite = {site.first, static_cast<uint64_t>(std::max<int64_t>(bytes, 0)),
+                          static_cast<uint64_t>(site.second->peak.load()), site.second->allocations};
+      sites.push_back(msite);
+    }
+  }
+
+  std::sort(sites.begin(), sites.end(),
+            [](const MemorySite& left, const MemorySite& right) { return left.bytes > right.bytes; });
+  return sites;
+}
+
+uint64_t get_heap_memory() {
+#if defined(__GNUC__)
+  if (mallctl) {
+    // jemalloc refreshes stats on epoch write
+    uint64_t epoch = 1;
+    size_t size = sizeof(epoch);
+    mallctl("epoch", &epoch, &size, &epoch, size);
+    size_t allocated = 0;
+    size = sizeof(allocated);
+    if (mallctl("stats.allocated", &allocated, &size, nullptr, 0) == 0) {
+      return allocated;
+    }
+  }
+  if (MallocExtension_GetNumericProperty) {
+    size_t allocated = 0;
+    if (MallocExtension_GetNumericProperty("generic.current_allocated_bytes", &allocated)) {
+      return allocated;
+    }
+  }
+#endif
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+  const struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+#else
+  const struct mallinfo info = mallinfo();  // counters wrap above 4 GB
+  return static_cast<unsigned int>(info.uordblks) + static_cast<unsigned int>(info.hblkhd);
+#endif
+#else
+  return 0;
+#endif
+}
+
+void release_heap_memory() {
+#if defined(__GNUC__)
+  if (mallctl) {
+    mallctl(JEMALLOC_PURGE_ALL_ARENAS, nullptr, nullptr, nullptr, 0);
+    return;
+  }
+  if (MallocExtension_ReleaseFreeMemory) {
+    MallocExtension_ReleaseFreeMemory();
+    return;
+  }
+#endif
+#if defined(__GLIBC__)
+  malloc_trim(0);
+#endif
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,46 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace fastocloud {
+namespace stream {
+
+// live bytes of buffers from default allocator by allocating thread, streaming threads of gstreamer are named
+// after element and pad ("queue0:src"), so site shows element which filled buffer or buffer pool
+struct MemorySite {
+  std::string name;
+  uint64_t bytes;
+  uint64_t peak;
+  uint64_t allocations;  // total
+};
+
+// after gst_init, replaces default allocator, memory of elements with own allocators (gpu, v4l2) not accounted
+bool install_memory_accounting();
+bool is_memory_accounting_installed();
+uint64_t get_accounted_memory();          // 0 if not installed
+std::vector<MemorySite> get_memory_sites();  // most bytes first
+
+// bytes in use by malloc, jemalloc or tcmalloc stats when linked, glibc arenas otherwise, 0 if unknown
+uint64_t get_heap_memory();
+// returns free pages of allocator to system: jemalloc purge of all arenas, tcmalloc release, glibc trim
+void release_heap_memory();
+
+}  // namespace stream
+}  // namespace fastocloud
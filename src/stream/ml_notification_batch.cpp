@@ -0,0 +1,98 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/ml_notification_batch.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace fastocloud {
+namespace stream {
+
+MlNotificationBatch::MlNotificationBatch(fastotv::timestamp_t interval_msec)
+    : interval_msec_(interval_msec), mutex_(), pending_(), has_pending_(false), sent_(), sent_ts_(0), dropped_(0) {}
+
+bool MlNotificationBatch::Add(const images_t& images, fastotv::timestamp_t now_msec, images_t* out) {
+  if (!out) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (IsSameImages(images, sent_)) {
+    has_pending_ = false;  // changed back inside window, clients are up to date
+    dropped_++;
+    return false;
+  }
+
+  if (has_pending_) {
+    dropped_++;
+  }
+
+  if (now_msec - sent_ts_ >= interval_msec_) {
+    sent_ = images;
+    sent_ts_ = now_msec;
+    has_pending_ = false;
+    *out = images;
+    return true;
+  }
+
+  pending_ = images;
+  has_pending_ = true;
+  return false;
+}
+
+bool MlNotificationBatch::Flush(fastotv::timestamp_t now_msec, images_t* out) {
+  if (!out) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!has_pending_ || now_msec - sent_ts_ < interval_msec_) {
+    return false;
+  }
+
+  sent_ = pending_;
+  sent_ts_ = now_msec;
+  has_pending_ = false;
+  pending_.clear();
+  *out = sent_;
+  return true;
+}
+
+size_t MlNotificationBatch::GetDropped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+bool MlNotificationBatch::IsSameImages(const images_t& left, const images_t& right) {
+  if (left.size() != right.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < left.size(); ++i) {
+    const auto& lbox = left[i];
+    const auto& rbox = right[i];
+    if (lbox.label != rbox.label) {
+      return false;
+    }
+    if (std::abs(lbox.x - rbox.x) > box_tolerance || std::abs(lbox.y - rbox.y) > box_tolerance ||
+        std::abs(lbox.width - rbox.width) > box_tolerance || std::abs(lbox.height - rbox.height) > box_tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
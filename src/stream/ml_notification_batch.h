@@ -0,0 +1,59 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include <common/macros.h>
+
+#include <fastotv/commands_info/ml/types.h>
+#include <fastotv/types.h>
+
+namespace fastocloud {
+namespace stream {
+
+// coalesces detections of stream between notifications, latest detections win inside window,
+// detections equal to last sent ones are dropped
+class MlNotificationBatch {
+ public:
+  typedef std::vector<fastotv::commands_info::ml::ImageBox> images_t;
+  enum { box_tolerance = 4 };  // pixels, boxes moved not more are unchanged
+
+  explicit MlNotificationBatch(fastotv::timestamp_t interval_msec);  // 0 - every change sent
+
+  // streaming threads, true if out should be sent now
+  bool Add(const images_t& images, fastotv::timestamp_t now_msec, images_t* out);
+  // main loop, true if pending detections window passed
+  bool Flush(fastotv::timestamp_t now_msec, images_t* out);
+
+  size_t GetDropped() const;  // results coalesced or unchanged
+
+  static bool IsSameImages(const images_t& left, const images_t& right);
+
+ private:
+  const fastotv::timestamp_t interval_msec_;
+  mutable std::mutex mutex_;
+  images_t pending_;
+  bool has_pending_;
+  images_t sent_;
+  fastotv::timestamp_t sent_ts_;
+  size_t dropped_;
+
+  DISALLOW_COPY_AND_ASSIGN(MlNotificationBatch);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,114 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/net_clock.h"
+
+#include <gst/net/net.h>
+
+#include <map>
+#include <mutex>
+
+#include <common/convert2string.h>
+#include <common/logger.h>
+#include <common/net/types.h>
+
+#define NET_CLOCK_NAME "fastocloud_net_clock"
+#define NET_CLOCK_SYNC_TIMEOUT_SEC 5
+#define NTP_DEFAULT_PORT 123
+
+#define PTP_SCHEME "ptp://"
+#define NTP_SCHEME "ntp://"
+#define NET_SCHEME "net://"
+
+namespace fastocloud {
+namespace stream {
+namespace {
+
+std::mutex g_clocks_mutex;
+std::map<std::string, GstClock*> g_clocks;  // synchronization is slow, clocks kept for pipeline restarts
+
+bool has_scheme(const std::string& url, const char* scheme, std::string* rest) {
+  const std::string prefix(scheme);
+  if (url.compare(0, prefix.size(), prefix) != 0) {
+    return false;
+  }
+
+  *rest = url.substr(prefix.size());
+  return true;
+}
+
+bool parse_host(const std::string& str, uint16_t default_port, common::net::HostAndPort* host) {
+  common::net::HostAndPort lhost;
+  if (common::ConvertFromString(str, &lhost) && lhost.IsValid()) {
+    *host = lhost;
+    return true;
+  }
+
+  if (!default_port || str.empty()) {
+    return false;
+  }
+
+  *host = common::net::HostAndPort(str, default_port);
+  return true;
+}
+
+GstClock* make_clock(const std::string& url) {
+  std::string rest;
+  if (has_scheme(url, PTP_SCHEME, &rest)) {
+    unsigned int domain = 0;
+    if (!rest.empty() && !common::ConvertFromString(rest, &domain)) {
+      return nullptr;
+    }
+    if (!gst_ptp_is_initialized() && !gst_ptp_init(GST_PTP_CLOCK_ID_NONE, nullptr)) {
+      WARNING_LOG() << "Failed to init ptp, helper process not available";
+      return nullptr;
+    }
+    return gst_ptp_clock_new(NET_CLOCK_NAME, domain);
+  }
+
+  common::net::HostAndPort host;
+  if (has_scheme(url, NTP_SCHEME, &rest) && parse_host(rest, NTP_DEFAULT_PORT, &host)) {
+    return gst_ntp_clock_new(NET_CLOCK_NAME, host.GetHost().c_str(), host.GetPort(), 0);
+  }
+  if (has_scheme(url, NET_SCHEME, &rest) && parse_host(rest, 0, &host)) {
+    return gst_net_client_clock_new(NET_CLOCK_NAME, host.GetHost().c_str(), host.GetPort(), 0);
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+GstClock* obtain_net_clock(const std::string& url) {
+  std::unique_lock<std::mutex> lock(g_clocks_mutex);
+  const auto it = g_clocks.find(url);
+  if (it != g_clocks.end()) {
+    return GST_CLOCK(gst_object_ref(it->second));
+  }
+
+  GstClock* clock = make_clock(url);
+  if (!clock) {
+    WARNING_LOG() << "Failed to create net clock: " << url;
+    return nullptr;
+  }
+
+  // not synchronized clock still used, pipeline slaves to it when it catches up
+  if (!gst_clock_wait_for_sync(clock, NET_CLOCK_SYNC_TIMEOUT_SEC * GST_SECOND)) {
+    WARNING_LOG() << "Net clock " << url << " not synchronized in " << NET_CLOCK_SYNC_TIMEOUT_SEC << " sec";
+  }
+  g_clocks[url] = clock;
+  return GST_CLOCK(gst_object_ref(clock));
+}
+
+}  // namespace stream
+}  // namespace fastocloud
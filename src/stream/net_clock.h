@@ -0,0 +1,29 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gst/gst.h>
+
+#include <string>
+
+namespace fastocloud {
+namespace stream {
+
+// clock of ptp://domain, ntp://host:port or net://host:port of GstNetTimeProvider, shared by pipelines of process,
+// synchronization awaited on first use, new reference, nullptr if failed
+GstClock* obtain_net_clock(const std::string& url);
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,167 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/output_branch.h"
+
+#include <algorithm>
+
+#include <gst/video/video.h>
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+gboolean send_sticky_event(GstPad* peer, GstEvent** event, gpointer user_data) {
+  UNUSED(peer);
+  if (GST_EVENT_TYPE(*event) != GST_EVENT_EOS) {
+    gst_pad_send_event(static_cast<GstPad*>(user_data), gst_event_ref(*event));
+  }
+  return TRUE;
+}
+}  // namespace
+
+OutputBranch::OutputBranch(element_id_t id)
+    : id_(id), inputs_(), elements_(), state_(RUNNING), restart_ts_(0), last_restart_ts_(0), failures_(0) {}
+
+OutputBranch::~OutputBranch() {
+  for (Input* input : inputs_) {
+    gst_pad_remove_probe(input->pad, input->probe_id);
+    gst_object_unref(input->pad);
+    delete input;
+  }
+  for (GstElement* element : elements_) {
+    gst_object_unref(element);
+  }
+}
+
+element_id_t OutputBranch::GetID() const {
+  return id_;
+}
+
+void OutputBranch::AddInput(GstElement* queue, bool video) {
+  GstPad* pad = gst_element_get_static_pad(queue, "sink");
+  if (!pad) {
+    return;
+  }
+
+  Input* input = new Input;
+  input->branch = this;
+  input->pad = pad;
+  input->video = video;
+  input->probe_id = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, input_probe, input, nullptr);
+  inputs_.push_back(input);
+}
+
+void OutputBranch::AddElement(GstElement* element) {
+  elements_.push_back(GST_ELEMENT(gst_object_ref(element)));
+}
+
+bool OutputBranch::Contains(GstObject* object) const {
+  for (GstElement* element : elements_) {
+    if (object == GST_OBJECT(element) || gst_object_has_as_ancestor(object, GST_OBJECT(element))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void OutputBranch::SetFailed() {
+  state_ = FAILED;
+}
+
+bool OutputBranch::IsFailed() const {
+  return state_ == FAILED;
+}
+
+bool OutputBranch::CheckRestart(fastotv::timestamp_t now) {
+  if (!IsFailed()) {
+    return false;
+  }
+
+  if (!restart_ts_) {
+    if (now - last_restart_ts_ >= stable_msec) {
+      failures_ = 0;
+    }
+    const fastotv::timestamp_t delay = std::min<fastotv::timestamp_t>(
+        static_cast<fastotv::timestamp_t>(restart_min_msec) << std::min<size_t>(failures_, 5), restart_max_msec);
+    failures_++;
+    restart_ts_ = now + delay;
+    WARNING_LOG() << "Output " << id_ << " failed, restart in " << delay << " msec";
+    return false;
+  }
+
+  if (now < restart_ts_) {
+    return false;
+  }
+
+  restart_ts_ = 0;
+  last_restart_ts_ = now;
+  Restart();
+  return true;
+}
+
+void OutputBranch::Restart() {
+  // inputs dropped, nothing pushed into branch while tasks stop
+  for (auto it = elements_.rbegin(); it != elements_.rend(); ++it) {
+    gst_element_set_state(*it, GST_STATE_NULL);
+  }
+  for (auto it = elements_.rbegin(); it != elements_.rend(); ++it) {
+    gst_element_sync_state_with_parent(*it);
+  }
+
+  // deactivated pads lost stream-start, caps and segment
+  bool have_video = false;
+  for (Input* input : inputs_) {
+    resend_sticky_events(input->pad);
+    if (input->video) {
+      gst_pad_push_event(input->pad, gst_video_event_new_upstream_force_key_unit(GST_CLOCK_TIME_NONE, TRUE, 0));
+      have_video = true;
+    }
+  }
+  INFO_LOG() << "Output " << id_ << " restarted";
+  state_ = have_video ? WAIT_KEYFRAME : RUNNING;
+}
+
+void OutputBranch::resend_sticky_events(GstPad* pad) {
+  GstPad* peer = gst_pad_get_peer(pad);
+  if (!peer) {
+    return;
+  }
+
+  gst_pad_sticky_events_foreach(peer, send_sticky_event, pad);
+  gst_object_unref(peer);
+}
+
+GstPadProbeReturn OutputBranch::input_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  Input* input = static_cast<Input*>(user_data);
+  OutputBranch* branch = input->branch;
+  const int state = branch->state_;
+  if (state == RUNNING) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  if (state == WAIT_KEYFRAME && input->video) {
+    GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    if (!GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+      int expected = WAIT_KEYFRAME;
+      branch->state_.compare_exchange_strong(expected, RUNNING);
+      return GST_PAD_PROBE_OK;
+    }
+  }
+  return GST_PAD_PROBE_DROP;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,79 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <gst/gst.h>
+
+#include <common/macros.h>
+
+#include "stream/stypes.h"
+
+namespace fastocloud {
+namespace stream {
+
+// tee branch of one output restarted in place when its sink fails, other outputs keep streaming;
+// data entering branch dropped while failed, resumed from keyframe
+class OutputBranch {
+ public:
+  enum { restart_min_msec = 1000, restart_max_msec = 30000, stable_msec = 60000 };
+
+  explicit OutputBranch(element_id_t id);
+  ~OutputBranch();
+
+  element_id_t GetID() const;
+
+  void AddInput(GstElement* queue, bool video);  // sink pad linked to tee
+  void AddElement(GstElement* element);          // cycled on restart
+
+  bool Contains(GstObject* object) const;
+
+  // streaming thread, from sync bus handler before error reaches tee
+  void SetFailed();
+  bool IsFailed() const;
+
+  // main loop tick, restart scheduled with backoff, true if restarted
+  bool CheckRestart(fastotv::timestamp_t now);
+
+ private:
+  enum State { RUNNING, FAILED, WAIT_KEYFRAME };
+
+  struct Input {
+    OutputBranch* branch;
+    GstPad* pad;
+    gulong probe_id;
+    bool video;
+  };
+
+  void Restart();
+  static void resend_sticky_events(GstPad* pad);
+  static GstPadProbeReturn input_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+
+  const element_id_t id_;
+  std::vector<Input*> inputs_;
+  std::vector<GstElement*> elements_;  // in link order
+  std::atomic<int> state_;
+
+  fastotv::timestamp_t restart_ts_;  // main loop only, 0 not scheduled
+  fastotv::timestamp_t last_restart_ts_;
+  size_t failures_;
+
+  DISALLOW_COPY_AND_ASSIGN(OutputBranch);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -14,11 +14,29 @@
 
 #include "stream/probes.h"
 
+#include <gst/audio/audio.h>
+
+#include <common/time.h>
+
+#include "stream/hot_log.h"
 #include "stream/ibase_stream.h"
 
 namespace fastocloud {
 namespace stream {
 
+namespace {
+// hot path, only counts data
+const GstPadProbeType kDataProbeType =
+    static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST);
+const GstPadProbeType kEventProbeType =
+    static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM | GST_PAD_PROBE_TYPE_EVENT_FLUSH);
+const GstPadProbeType kLatencyProbeType = static_cast<GstPadProbeType>(
+    GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM | GST_PAD_PROBE_TYPE_EVENT_FLUSH);
+// audio and video meters
+const GstPadProbeType kAudioMeterProbeType =
+    static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM);
+}  // namespace
+
 Consistency::Consistency()
     : segment(FALSE),
       eos(TRUE),
@@ -27,8 +45,10 @@ Consistency::Consistency()
       saw_stream_start(FALSE),
       saw_serialized_event(FALSE) {}
 
+ProbeCounters::ProbeCounters() : bytes(0), packets(0), last_buffer_ts(0) {}
+
 Probe::Probe(element_id_t id, const common::uri::Url& url, IBaseStream* stream)
-    : stream_(stream), id_(id), id_buffer_(0), pad_(nullptr), consistency_(), url_(url) {
+    : stream_(stream), id_(id), id_buffer_(0), id_event_(0), pad_(nullptr), consistency_(), url_(url), counters_() {
   CHECK(stream);
 }
 
@@ -45,12 +65,24 @@ void Probe::Clear() {
     return;
   }
 
-  gst_pad_remove_probe(pad_, id_buffer_);
+  // removing of data probe calls destroy callback, which resets fields
+  GstPad* pad = pad_;
+  const gulong id_event = id_event_;
+  gst_pad_remove_probe(pad, id_buffer_);
+  if (id_event) {
+    gst_pad_remove_probe(pad, id_event);
+  }
+  ClearInner();
 }
 
 void Probe::ClearInner() {
   pad_ = nullptr;
   id_buffer_ = 0;
+  id_event_ = 0;
+}
+
+bool Probe::IsDiagnosticsEnabled() {
+  return common::logging::CURRENT_LOG_LEVEL() == common::logging::LOG_LEVEL_DEBUG;
 }
 
 element_id_t Probe::GetID() const {
@@ -65,6 +97,21 @@ Consistency Probe::GetConsistency() const {
   return consistency_;
 }
 
+void Probe::AddData(gsize bytes, guint packets) {
+  counters_.bytes.fetch_add(bytes, std::memory_order_relaxed);
+  counters_.packets.fetch_add(packets, std::memory_order_relaxed);
+  counters_.last_buffer_ts.store(common::time::current_utc_mstime(), std::memory_order_relaxed);
+}
+
+void Probe::TakeData(uint64_t* bytes, uint64_t* packets) {
+  *bytes = counters_.bytes.exchange(0, std::memory_order_relaxed);
+  *packets = counters_.packets.exchange(0, std::memory_order_relaxed);
+}
+
+fastotv::timestamp_t Probe::GetLastBufferTime() const {
+  return counters_.last_buffer_ts.load(std::memory_order_relaxed);
+}
+
 void Probe::destroy_callback_probe(gpointer user_data) {
   Probe* probe = reinterpret_cast<Probe*>(user_data);
   probe->ClearInner();
@@ -74,6 +121,7 @@ InputProbe::InputProbe(element_id_t id, const common::uri::Url& url, IBaseStream
     : base_class(id, url, stream) {}
 
 GstPadProbeReturn InputProbe::source_callback_probe_buffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
   InputProbe* probe = reinterpret_cast<InputProbe*>(user_data);
   IBaseStream* stream = probe->stream_;
   GstPadProbeInfo* checked_info = stream->CheckProbeData(probe, info);
@@ -81,87 +129,90 @@ GstPadProbeReturn InputProbe::source_callback_probe_buffer(GstPad* pad, GstPadPr
     return GST_PAD_PROBE_DROP;
   }
 
-  void* data = GST_PAD_PROBE_INFO_DATA(checked_info);
-  if (GST_IS_BUFFER(data)) {
+  if (GST_PAD_PROBE_INFO_TYPE(checked_info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList* buffer_list = GST_PAD_PROBE_INFO_BUFFER_LIST(checked_info);
+    probe->AddData(gst_buffer_list_calculate_size(buffer_list), gst_buffer_list_length(buffer_list));
+  } else {
     GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(checked_info);
     stream->UpdateInputProbeStats(probe, gst_buffer_get_size(buffer));
-  } else if (GST_IS_EVENT(data)) {
-    GstEvent* event = GST_EVENT(data);
-    const gchar* event_name = GST_EVENT_TYPE_NAME(event);
-    GstEventType event_type = GST_EVENT_TYPE(event);
-    DEBUG_LOG() << "Source[" << probe->id_ << "] event: " << event_name;
-
-    if (event_type == GST_EVENT_FLUSH_START) {
-      /* getting two flush_start in a row seems to be okay
-     fail_if (consist->flushing, "Received another FLUSH_START");
-  */
-      probe->consistency_.flushing = TRUE;
-    } else if (event_type == GST_EVENT_FLUSH_STOP) {
-      /* Receiving a flush-stop is only valid after receiving a flush-start */
-      if (!probe->consistency_.flushing) {
-        INFO_LOG() << "Received a FLUSH_STOP without a FLUSH_START on pad " << pad;
-      }
-      if (probe->consistency_.eos) {
-        INFO_LOG() << "Received a FLUSH_STOP after an EOS on pad " << pad;
-      }
-      probe->consistency_.flushing = probe->consistency_.expect_flush = FALSE;
-    } else if (event_type == GST_EVENT_STREAM_START) {
-      if (probe->consistency_.saw_serialized_event && !probe->consistency_.saw_stream_start) {
-        INFO_LOG() << "Got a STREAM_START event after a serialized event on pad " << pad;
-      }
-      probe->consistency_.saw_stream_start = TRUE;
-    } else if (event_type == GST_EVENT_CAPS) {
-      /* ok to have these before segment event */
-      /* FIXME check order more precisely, if so spec'ed somehow ? */
-      GstCaps* caps = nullptr;
-      gst_event_parse_caps(event, &caps);
-      if (caps) {
-        GstStructure* pad_struct = gst_caps_get_structure(caps, 0);
-        if (pad_struct) {
-          gchar* structure_text = gst_structure_to_string(pad_struct);
-          INFO_LOG() << "Source[" << probe->id_ << "] caps are: " << structure_text;
-          g_free(structure_text);
-        }
-      }
-    } else if (event_type == GST_EVENT_SEGMENT) {
-      if (probe->consistency_.expect_flush && probe->consistency_.flushing) {
-        INFO_LOG() << "Received SEGMENT while in a flushing seek on pad " << pad;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn InputProbe::source_callback_probe_event(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  InputProbe* probe = reinterpret_cast<InputProbe*>(user_data);
+  IBaseStream* stream = probe->stream_;
+  GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+  const gchar* event_name = GST_EVENT_TYPE_NAME(event);
+  GstEventType event_type = GST_EVENT_TYPE(event);
+  const bool diagnostics = IsDiagnosticsEnabled();
+  HOT_DEBUG_LOG(1000) << "Source[" << probe->id_ << "] event: " << event_name;
+
+  if (event_type == GST_EVENT_FLUSH_START) {
+    /* getting two flush_start in a row seems to be okay
+   fail_if (consist->flushing, "Received another FLUSH_START");
+*/
+    probe->consistency_.flushing = TRUE;
+  } else if (event_type == GST_EVENT_FLUSH_STOP) {
+    /* Receiving a flush-stop is only valid after receiving a flush-start */
+    if (diagnostics && !probe->consistency_.flushing) {
+      INFO_LOG() << "Received a FLUSH_STOP without a FLUSH_START on pad " << pad;
+    }
+    if (diagnostics && probe->consistency_.eos) {
+      INFO_LOG() << "Received a FLUSH_STOP after an EOS on pad " << pad;
+    }
+    probe->consistency_.flushing = probe->consistency_.expect_flush = FALSE;
+  } else if (event_type == GST_EVENT_STREAM_START) {
+    if (diagnostics && probe->consistency_.saw_serialized_event && !probe->consistency_.saw_stream_start) {
+      INFO_LOG() << "Got a STREAM_START event after a serialized event on pad " << pad;
+    }
+    probe->consistency_.saw_stream_start = TRUE;
+  } else if (event_type == GST_EVENT_CAPS) {
+    /* ok to have these before segment event */
+    /* FIXME check order more precisely, if so spec'ed somehow ? */
+    GstCaps* caps = nullptr;
+    gst_event_parse_caps(event, &caps);
+    if (caps) {
+      GstStructure* pad_struct = gst_caps_get_structure(caps, 0);
+      if (pad_struct) {
+        gchar* structure_text = gst_structure_to_string(pad_struct);
+        INFO_LOG() << "Source[" << probe->id_ << "] caps are: " << structure_text;
+        g_free(structure_text);
       }
-      const GstSegment* segment = nullptr;
-      gst_event_parse_segment(event, &segment);
-      probe->consistency_.segment = TRUE;
-      probe->consistency_.eos = FALSE;
-    } else if (event_type == GST_EVENT_EOS) {
-      /* FIXME : not 100% sure about whether two eos in a row is valid */
+    }
+  } else if (event_type == GST_EVENT_SEGMENT) {
+    if (diagnostics && probe->consistency_.expect_flush && probe->consistency_.flushing) {
+      INFO_LOG() << "Received SEGMENT while in a flushing seek on pad " << pad;
+    }
+    probe->consistency_.segment = TRUE;
+    probe->consistency_.eos = FALSE;
+  } else if (event_type == GST_EVENT_EOS) {
+    /* FIXME : not 100% sure about whether two eos in a row is valid */
+    if (diagnostics && probe->consistency_.eos) {
+      INFO_LOG() << "Received EOS just after another EOS on pad " << pad;
+    }
+    probe->consistency_.eos = TRUE;
+    probe->consistency_.segment = FALSE;
+  } else if (diagnostics) {
+    if (GST_EVENT_IS_SERIALIZED(event) && GST_EVENT_IS_DOWNSTREAM(event)) {
       if (probe->consistency_.eos) {
-        INFO_LOG() << "Received EOS just after another EOS on pad " << pad;
+        INFO_LOG() << "Event received after EOS";
       }
-      probe->consistency_.eos = TRUE;
-      probe->consistency_.segment = FALSE;
-    } else {
-      if (GST_EVENT_IS_SERIALIZED(event) && GST_EVENT_IS_DOWNSTREAM(event)) {
-        if (probe->consistency_.eos) {
-          INFO_LOG() << "Event received after EOS";
-        }
-        if (!probe->consistency_.segment) {
-          INFO_LOG() << "Event " << event_name << " received before segment on pad " << pad;
-        }
+      if (!probe->consistency_.segment) {
+        INFO_LOG() << "Event " << event_name << " received before segment on pad " << pad;
       }
-      /* FIXME : Figure out what to do for other events */
     }
+    /* FIXME : Figure out what to do for other events */
+  }
 
-    if (GST_EVENT_IS_SERIALIZED(event)) {
-      if (!probe->consistency_.saw_stream_start && event_type != GST_EVENT_STREAM_START) {
-        INFO_LOG() << "Got a serialized event (" << event_name << ") before a STREAM_START on pad" << pad;
-      }
-      probe->consistency_.saw_serialized_event = TRUE;
+  if (GST_EVENT_IS_SERIALIZED(event)) {
+    if (diagnostics && !probe->consistency_.saw_stream_start && event_type != GST_EVENT_STREAM_START) {
+      INFO_LOG() << "Got a serialized event (" << event_name << ") before a STREAM_START on pad" << pad;
     }
-    stream->HandleInputProbeEvent(probe, event);
-  } else {
-    GstPadProbeType pt = GST_PAD_PROBE_INFO_TYPE(checked_info);
-    WARNING_LOG() << "Unknow probe type: " << pt;
+    probe->consistency_.saw_serialized_event = TRUE;
   }
-
+  stream->HandleInputProbeEvent(probe, event);
   return GST_PAD_PROBE_OK;
 }
 
@@ -173,28 +224,28 @@ void InputProbe::Link(GstPad* pad) {
   Clear();
 
   GstPadDirection dir = gst_pad_get_direction(pad);
-  gulong id_probe = 0;
-  if (dir == GST_PAD_SRC) {
-    id_probe = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_DATA_DOWNSTREAM, source_callback_probe_buffer, this,
-                                 &destroy_callback_probe);
-  } else {
+  if (dir != GST_PAD_SRC) {
     NOTREACHED();
+    return;
   }
 
+  gulong id_probe = gst_pad_add_probe(pad, kDataProbeType, source_callback_probe_buffer, this, &destroy_callback_probe);
   if (!id_probe) {
-    CRITICAL_LOG() << "Cannot add output prode";
+    CRITICAL_LOG() << "Cannot add input prode";
     return;
   }
 
   pad_ = pad;
   id_buffer_ = id_probe;
-  DEBUG_LOG() << "Input probe added id: " << id_probe;
+  id_event_ = gst_pad_add_probe(pad, kEventProbeType, source_callback_probe_event, this, nullptr);
+  DEBUG_LOG() << "Input probe added id: " << id_probe << ", event id: " << id_event_;
 }
 
 OutputProbe::OutputProbe(element_id_t id, const common::uri::Url& url, bool need_push, IBaseStream* stream)
     : base_class(id, url, stream), need_push_(need_push) {}
 
 GstPadProbeReturn OutputProbe::sink_callback_probe_buffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
   OutputProbe* probe = reinterpret_cast<OutputProbe*>(user_data);
   IBaseStream* stream = probe->stream_;
   GstPadProbeInfo* checked_info = stream->CheckProbeDataOutput(probe, info);
@@ -202,61 +253,59 @@ GstPadProbeReturn OutputProbe::sink_callback_probe_buffer(GstPad* pad, GstPadPro
     return GST_PAD_PROBE_DROP;
   }
 
-  void* data = GST_PAD_PROBE_INFO_DATA(checked_info);
-  if (GST_IS_BUFFER(data)) {
+  if (GST_PAD_PROBE_INFO_TYPE(checked_info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList* buffer_list = GST_PAD_PROBE_INFO_BUFFER_LIST(checked_info);
+    probe->AddData(gst_buffer_list_calculate_size(buffer_list), gst_buffer_list_length(buffer_list));
+  } else {
     GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(checked_info);
     stream->UpdateOutputProbeStats(probe, gst_buffer_get_size(buffer));
-  } else if (GST_IS_BUFFER_LIST(data)) {
-    GstBufferList* buffer_list = GST_PAD_PROBE_INFO_BUFFER_LIST(checked_info);
-    guint len = gst_buffer_list_length(buffer_list);
-    for (guint i = 0; i < len; ++i) {
-      GstBuffer* buffer = gst_buffer_list_get(buffer_list, i);
-      stream->UpdateOutputProbeStats(probe, gst_buffer_get_size(buffer));
-    }
-  } else if (GST_IS_EVENT(data)) {
-    GstEvent* event = GST_EVENT(data);
-    const gchar* event_name = GST_EVENT_TYPE_NAME(event);
-    GstEventType event_type = GST_EVENT_TYPE(event);
-
-    DEBUG_LOG() << "Sink[" << probe->id_ << "] event: " << event_name;
-    if (event_type == GST_EVENT_SEEK) {
-      GstSeekFlags flags;
-      gst_event_parse_seek(event, nullptr, nullptr, &flags, nullptr, nullptr, nullptr, nullptr);
-      probe->consistency_.expect_flush = ((flags & GST_SEEK_FLAG_FLUSH) == GST_SEEK_FLAG_FLUSH);
-    } else if (event_type == GST_EVENT_CAPS) {
-      /* ok to have these before segment event */
-      /* FIXME check order more precisely, if so spec'ed somehow ? */
-      GstCaps* caps = nullptr;
-      gst_event_parse_caps(event, &caps);
-      if (caps) {
-        GstStructure* pad_struct = gst_caps_get_structure(caps, 0);
-        if (pad_struct) {
-          gchar* structure_text = gst_structure_to_string(pad_struct);
-          INFO_LOG() << "Sink[" << probe->id_ << "] caps are: " << structure_text;
-          g_free(structure_text);
-        }
-      }
-    } else if (event_type == GST_EVENT_SEGMENT) {
-      if (probe->consistency_.expect_flush && probe->consistency_.flushing) {
-        INFO_LOG() << "Received SEGMENT while in a flushing seek on pad " << pad;
-      }
-      probe->consistency_.segment = TRUE;
-      probe->consistency_.eos = FALSE;
-    } else if (event_type == GST_EVENT_EOS) {
-      /* FIXME : not 100% sure about whether two eos in a row is valid */
-      if (probe->consistency_.eos) {
-        INFO_LOG() << "Received EOS just after another EOS on pad " << pad;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn OutputProbe::sink_callback_probe_event(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  OutputProbe* probe = reinterpret_cast<OutputProbe*>(user_data);
+  IBaseStream* stream = probe->stream_;
+  GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+  const gchar* event_name = GST_EVENT_TYPE_NAME(event);
+  GstEventType event_type = GST_EVENT_TYPE(event);
+  const bool diagnostics = IsDiagnosticsEnabled();
+
+  HOT_DEBUG_LOG(1000) << "Sink[" << probe->id_ << "] event: " << event_name;
+  if (event_type == GST_EVENT_SEEK) {
+    GstSeekFlags flags;
+    gst_event_parse_seek(event, nullptr, nullptr, &flags, nullptr, nullptr, nullptr, nullptr);
+    probe->consistency_.expect_flush = ((flags & GST_SEEK_FLAG_FLUSH) == GST_SEEK_FLAG_FLUSH);
+  } else if (event_type == GST_EVENT_CAPS) {
+    /* ok to have these before segment event */
+    /* FIXME check order more precisely, if so spec'ed somehow ? */
+    GstCaps* caps = nullptr;
+    gst_event_parse_caps(event, &caps);
+    if (caps) {
+      GstStructure* pad_struct = gst_caps_get_structure(caps, 0);
+      if (pad_struct) {
+        gchar* structure_text = gst_structure_to_string(pad_struct);
+        INFO_LOG() << "Sink[" << probe->id_ << "] caps are: " << structure_text;
+        g_free(structure_text);
       }
-      probe->consistency_.eos = TRUE;
-      probe->consistency_.segment = FALSE;
     }
-
-    stream->HandleOutputProbeEvent(probe, event);
-  } else {
-    GstPadProbeType pt = GST_PAD_PROBE_INFO_TYPE(checked_info);
-    WARNING_LOG() << "Unknow probe type: " << pt;
+  } else if (event_type == GST_EVENT_SEGMENT) {
+    if (diagnostics && probe->consistency_.expect_flush && probe->consistency_.flushing) {
+      INFO_LOG() << "Received SEGMENT while in a flushing seek on pad " << pad;
+    }
+    probe->consistency_.segment = TRUE;
+    probe->consistency_.eos = FALSE;
+  } else if (event_type == GST_EVENT_EOS) {
+    /* FIXME : not 100% sure about whether two eos in a row is valid */
+    if (diagnostics && probe->consistency_.eos) {
+      INFO_LOG() << "Received EOS just after another EOS on pad " << pad;
+    }
+    probe->consistency_.eos = TRUE;
+    probe->consistency_.segment = FALSE;
   }
 
+  stream->HandleOutputProbeEvent(probe, event);
   return GST_PAD_PROBE_OK;
 }
 
@@ -272,14 +321,12 @@ void OutputProbe::Link(GstPad* pad) {
   Clear();
 
   GstPadDirection dir = gst_pad_get_direction(pad);
-  gulong id_probe = 0;
-  if (dir == GST_PAD_SINK) {
-    id_probe = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_DATA_DOWNSTREAM, sink_callback_probe_buffer, this,
-                                 &destroy_callback_probe);
-  } else {
+  if (dir != GST_PAD_SINK) {
     NOTREACHED();
+    return;
   }
 
+  gulong id_probe = gst_pad_add_probe(pad, kDataProbeType, sink_callback_probe_buffer, this, &destroy_callback_probe);
   if (!id_probe) {
     CRITICAL_LOG() << "Cannot add output prode";
     return;
@@ -287,7 +334,482 @@ void OutputProbe::Link(GstPad* pad) {
 
   pad_ = pad;
   id_buffer_ = id_probe;
-  DEBUG_LOG() << "Output probe added id: " << id_probe;
+  id_event_ = gst_pad_add_probe(pad, kEventProbeType, sink_callback_probe_event, this, nullptr);
+  DEBUG_LOG() << "Output probe added id: " << id_probe << ", event id: " << id_event_;
+}
+
+LatencyProbe::LatencyProbe(LatencyStage stage)
+    : stage_(stage), id_probe_(0), pad_(nullptr), segment_(), have_segment_(false), buckets_() {
+  for (size_t i = 0; i < LatencyHistogram::buckets_count; ++i) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+LatencyProbe::~LatencyProbe() {
+  Clear();
+}
+
+LatencyStage LatencyProbe::GetStage() const {
+  return stage_;
+}
+
+void LatencyProbe::Link(GstPad* pad) {
+  Clear();
+  pad_ = pad;
+  id_probe_ = gst_pad_add_probe(pad_, kLatencyProbeType, callback_probe, this, destroy_callback_probe);
+}
+
+void LatencyProbe::TakeData(LatencyHistogram* hist) {
+  for (size_t i = 0; i < LatencyHistogram::buckets_count; ++i) {
+    const uint64_t count = buckets_[i].exchange(0, std::memory_order_relaxed);
+    if (count) {
+      hist->Add(i, count);
+    }
+  }
+}
+
+void LatencyProbe::Clear() {
+  if (!pad_) {
+    return;
+  }
+
+  gst_pad_remove_probe(pad_, id_probe_);
+  pad_ = nullptr;
+  id_probe_ = 0;
+}
+
+void LatencyProbe::Record(GstPad* pad, GstClockTime pts) {
+  if (!have_segment_ || !GST_CLOCK_TIME_IS_VALID(pts)) {
+    return;
+  }
+
+  const guint64 running_time = gst_segment_to_running_time(&segment_, GST_FORMAT_TIME, pts);
+  if (!GST_CLOCK_TIME_IS_VALID(running_time)) {
+    return;
+  }
+
+  GstElement* parent = gst_pad_get_parent_element(pad);
+  if (!parent) {
+    return;
+  }
+
+  GstClock* clock = gst_element_get_clock(parent);
+  if (clock) {
+    const GstClockTime now = gst_clock_get_time(clock) - gst_element_get_base_time(parent);
+    const GstClockTimeDiff diff = GST_CLOCK_DIFF(running_time, now);
+    const size_t index = LatencyHistogram::GetBucketIndex(diff / GST_MSECOND);
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+    gst_object_unref(clock);
+  }
+  gst_object_unref(parent);
+}
+
+GstPadProbeReturn LatencyProbe::callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  LatencyProbe* probe = reinterpret_cast<LatencyProbe*>(user_data);
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    probe->Record(pad, GST_BUFFER_PTS(buffer));
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_SEGMENT) {
+    const GstSegment* segment = nullptr;
+    gst_event_parse_segment(event, &segment);
+    probe->have_segment_ = segment->format == GST_FORMAT_TIME;
+    if (probe->have_segment_) {
+      gst_segment_copy_into(segment, &probe->segment_);
+    }
+  } else if (GST_EVENT_TYPE(event) == GST_EVENT_FLUSH_STOP) {
+    probe->have_segment_ = false;
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+void LatencyProbe::destroy_callback_probe(gpointer user_data) {
+  LatencyProbe* probe = reinterpret_cast<LatencyProbe*>(user_data);
+  probe->pad_ = nullptr;
+  probe->id_probe_ = 0;
+}
+
+QueueDropProbe::QueueDropProbe(element_id_t id) : id_(id), id_signal_(0), queue_(nullptr), drops_(0) {}
+
+QueueDropProbe::~QueueDropProbe() {
+  Clear();
+}
+
+element_id_t QueueDropProbe::GetID() const {
+  return id_;
+}
+
+void QueueDropProbe::Link(GstElement* queue) {
+  Clear();
+  queue_ = GST_ELEMENT(gst_object_ref(queue));
+  id_signal_ = g_signal_connect(queue_, "overrun", G_CALLBACK(overrun_callback), this);
+}
+
+uint64_t QueueDropProbe::TakeDrops() {
+  return drops_.exchange(0, std::memory_order_relaxed);
+}
+
+void QueueDropProbe::Clear() {
+  if (!queue_) {
+    return;
+  }
+
+  g_signal_handler_disconnect(queue_, id_signal_);
+  gst_object_unref(queue_);
+  queue_ = nullptr;
+  id_signal_ = 0;
+}
+
+void QueueDropProbe::overrun_callback(GstElement* queue, gpointer user_data) {
+  UNUSED(queue);
+  QueueDropProbe* probe = reinterpret_cast<QueueDropProbe*>(user_data);
+  probe->drops_.fetch_add(1, std::memory_order_relaxed);
+}
+
+AudioMeterProbe::AudioMeterProbe(element_id_t id)
+    : id_(id),
+      id_probe_(0),
+      pad_(nullptr),
+      meter_(),
+      loudness_meter_(),
+      levels_cb_(nullptr),
+      levels_user_data_(nullptr),
+      measured_(false),
+      rms_db_(AudioMeter::min_db),
+      peak_db_(AudioMeter::min_db),
+      silence_msec_(0),
+      loudness_measured_(false),
+      momentary_(LoudnessMeter::min_lufs),
+      short_term_(LoudnessMeter::min_lufs),
+      integrated_(LoudnessMeter::min_lufs) {}
+
+AudioMeterProbe::~AudioMeterProbe() {
+  Clear();
+}
+
+element_id_t AudioMeterProbe::GetID() const {
+  return id_;
+}
+
+void AudioMeterProbe::SetLevelsCallback(levels_callback_t cb, gpointer user_data) {
+  levels_cb_ = cb;
+  levels_user_data_ = user_data;
+}
+
+void AudioMeterProbe::Link(GstPad* pad) {
+  Clear();
+  pad_ = pad;
+  id_probe_ = gst_pad_add_probe(pad_, kAudioMeterProbeType, callback_probe, this, destroy_callback_probe);
+}
+
+bool AudioMeterProbe::GetLevel(int* rms_db, int* peak_db, fastotv::timestamp_t* silence_msec) const {
+  if (!rms_db || !peak_db || !silence_msec || !measured_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  *rms_db = rms_db_.load(std::memory_order_relaxed);
+  *peak_db = peak_db_.load(std::memory_order_relaxed);
+  *silence_msec = silence_msec_.load(std::memory_order_relaxed);
+  return true;
+}
+
+bool AudioMeterProbe::GetLoudness(LoudnessMeter::Loudness* loudness) const {
+  if (!loudness || !loudness_measured_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  loudness->momentary = momentary_.load(std::memory_order_relaxed);
+  loudness->short_term = short_term_.load(std::memory_order_relaxed);
+  loudness->integrated = integrated_.load(std::memory_order_relaxed);
+  return true;
+}
+
+void AudioMeterProbe::SetCaps(GstCaps* caps) {
+  GstAudioInfo info;
+  if (!gst_audio_info_from_caps(&info, caps) || GST_AUDIO_INFO_LAYOUT(&info) != GST_AUDIO_LAYOUT_INTERLEAVED) {
+    ignore_result(meter_.SetFormat(AudioMeter::FORMAT_UNKNOWN, 0, 0));
+    ignore_result(loudness_meter_.SetFormat(AudioMeter::FORMAT_UNKNOWN, 0, 0));
+    return;
+  }
+
+  AudioMeter::Format format = AudioMeter::FORMAT_UNKNOWN;
+  switch (GST_AUDIO_INFO_FORMAT(&info)) {
+    case GST_AUDIO_FORMAT_S16:
+      format = AudioMeter::FORMAT_S16;
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      format = AudioMeter::FORMAT_S32;
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      format = AudioMeter::FORMAT_F32;
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      format = AudioMeter::FORMAT_F64;
+      break;
+    default:
+      break;
+  }
+  ignore_result(meter_.SetFormat(format, GST_AUDIO_INFO_CHANNELS(&info), GST_AUDIO_INFO_RATE(&info)));
+  ignore_result(loudness_meter_.SetFormat(format, GST_AUDIO_INFO_CHANNELS(&info), GST_AUDIO_INFO_RATE(&info)));
+}
+
+void AudioMeterProbe::Measure(GstBuffer* buffer) {
+  if (!meter_.IsActive()) {
+    return;
+  }
+
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    return;
+  }
+
+  AudioMeter::Levels levels;
+  const bool done = meter_.Process(map.data, map.size, &levels);
+  LoudnessMeter::Loudness loudness;
+  const bool block_done = loudness_meter_.Process(map.data, map.size, &loudness);
+  gst_buffer_unmap(buffer, &map);
+  if (block_done) {
+    momentary_.store(loudness.momentary, std::memory_order_relaxed);
+    short_term_.store(loudness.short_term, std::memory_order_relaxed);
+    integrated_.store(loudness.integrated, std::memory_order_relaxed);
+    loudness_measured_.store(true, std::memory_order_release);
+  }
+  if (!done) {
+    return;
+  }
+
+  rms_db_.store(AudioMeter::GetLoudest(levels, false), std::memory_order_relaxed);
+  peak_db_.store(AudioMeter::GetLoudest(levels, true), std::memory_order_relaxed);
+  silence_msec_.store(levels.silence_msec, std::memory_order_relaxed);
+  measured_.store(true, std::memory_order_release);
+  if (levels_cb_) {
+    levels_cb_(id_, levels, levels_user_data_);
+  }
+}
+
+void AudioMeterProbe::Clear() {
+  if (!pad_) {
+    return;
+  }
+
+  gst_pad_remove_probe(pad_, id_probe_);
+  pad_ = nullptr;
+  id_probe_ = 0;
+}
+
+GstPadProbeReturn AudioMeterProbe::callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  AudioMeterProbe* probe = reinterpret_cast<AudioMeterProbe*>(user_data);
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    probe->Measure(GST_PAD_PROBE_INFO_BUFFER(info));
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+    GstCaps* caps = nullptr;
+    gst_event_parse_caps(event, &caps);
+    probe->SetCaps(caps);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+void AudioMeterProbe::destroy_callback_probe(gpointer user_data) {
+  AudioMeterProbe* probe = reinterpret_cast<AudioMeterProbe*>(user_data);
+  probe->pad_ = nullptr;
+  probe->id_probe_ = 0;
+}
+
+VideoMeterProbe::VideoMeterProbe(element_id_t id)
+    : id_(id),
+      id_probe_(0),
+      pad_(nullptr),
+      info_(),
+      meter_(),
+      measured_(false),
+      black_msec_(0),
+      freeze_msec_(0),
+      motion_(0) {
+  gst_video_info_init(&info_);
+}
+
+VideoMeterProbe::~VideoMeterProbe() {
+  Clear();
+}
+
+element_id_t VideoMeterProbe::GetID() const {
+  return id_;
+}
+
+void VideoMeterProbe::Link(GstPad* pad) {
+  Clear();
+  pad_ = pad;
+  id_probe_ = gst_pad_add_probe(pad_, kAudioMeterProbeType, callback_probe, this, destroy_callback_probe);
+}
+
+bool VideoMeterProbe::GetState(fastotv::timestamp_t* black_msec, fastotv::timestamp_t* freeze_msec) const {
+  if (!black_msec || !freeze_msec || !measured_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  *black_msec = black_msec_.load(std::memory_order_relaxed);
+  *freeze_msec = freeze_msec_.load(std::memory_order_relaxed);
+  return true;
+}
+
+bool VideoMeterProbe::GetMotion(uint32_t* motion) const {
+  if (!motion || !measured_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  *motion = motion_.load(std::memory_order_relaxed);
+  return true;
+}
+
+void VideoMeterProbe::SetCaps(GstCaps* caps) {
+  if (!gst_video_info_from_caps(&info_, caps)) {
+    ignore_result(meter_.SetFormat(0, 0));
+    return;
+  }
+
+  switch (GST_VIDEO_INFO_FORMAT(&info_)) {
+    case GST_VIDEO_FORMAT_I420:
+    case GST_VIDEO_FORMAT_YV12:
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_NV21:
+    case GST_VIDEO_FORMAT_Y42B:
+    case GST_VIDEO_FORMAT_Y444:
+    case GST_VIDEO_FORMAT_GRAY8:  // first plane is 8 bit luma
+      ignore_result(meter_.SetFormat(GST_VIDEO_INFO_WIDTH(&info_), GST_VIDEO_INFO_HEIGHT(&info_)));
+      break;
+    default:
+      ignore_result(meter_.SetFormat(0, 0));
+      break;
+  }
+}
+
+void VideoMeterProbe::Measure(GstBuffer* buffer) {
+  const GstClockTime pts = GST_BUFFER_PTS(buffer);
+  const fastotv::timestamp_t ts =
+      GST_CLOCK_TIME_IS_VALID(pts) ? GST_TIME_AS_MSECONDS(pts) : common::time::current_utc_mstime();
+  if (!meter_.IsDue(ts)) {  // most frames skipped without mapping
+    return;
+  }
+
+  GstVideoFrame frame;
+  if (!gst_video_frame_map(&frame, &info_, buffer, GST_MAP_READ)) {
+    return;
+  }
+
+  VideoMeter::State state;
+  const bool done = meter_.Process(static_cast<const uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(&frame, 0)),
+                                   GST_VIDEO_FRAME_PLANE_STRIDE(&frame, 0), ts, &state);
+  gst_video_frame_unmap(&frame);
+  if (!done) {
+    return;
+  }
+
+  black_msec_.store(state.black_msec, std::memory_order_relaxed);
+  freeze_msec_.store(state.freeze_msec, std::memory_order_relaxed);
+  motion_.store(state.motion, std::memory_order_relaxed);
+  measured_.store(true, std::memory_order_release);
+}
+
+void VideoMeterProbe::Clear() {
+  if (!pad_) {
+    return;
+  }
+
+  gst_pad_remove_probe(pad_, id_probe_);
+  pad_ = nullptr;
+  id_probe_ = 0;
+}
+
+GstPadProbeReturn VideoMeterProbe::callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  VideoMeterProbe* probe = reinterpret_cast<VideoMeterProbe*>(user_data);
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    probe->Measure(GST_PAD_PROBE_INFO_BUFFER(info));
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+    GstCaps* caps = nullptr;
+    gst_event_parse_caps(event, &caps);
+    probe->SetCaps(caps);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+void VideoMeterProbe::destroy_callback_probe(gpointer user_data) {
+  VideoMeterProbe* probe = reinterpret_cast<VideoMeterProbe*>(user_data);
+  probe->pad_ = nullptr;
+  probe->id_probe_ = 0;
+}
+
+OutputGateProbe::OutputGateProbe(element_id_t id, const std::atomic<bool>* muted, bool persistent)
+    : id_(id), muted_(muted), persistent_(persistent), opened_(false), id_probe_(0), pad_(nullptr) {}
+
+OutputGateProbe::~OutputGateProbe() {
+  Clear();
+}
+
+element_id_t OutputGateProbe::GetID() const {
+  return id_;
+}
+
+void OutputGateProbe::Link(GstPad* pad) {
+  Clear();
+  pad_ = pad;
+  id_probe_ = gst_pad_add_probe(pad_, kDataProbeType, callback_probe, this, destroy_callback_probe);
+}
+
+void OutputGateProbe::Clear() {
+  if (!pad_) {
+    return;
+  }
+
+  gst_pad_remove_probe(pad_, id_probe_);
+  pad_ = nullptr;
+  id_probe_ = 0;
+}
+
+GstPadProbeReturn OutputGateProbe::callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  OutputGateProbe* probe = reinterpret_cast<OutputGateProbe*>(user_data);
+  if (probe->muted_->load(std::memory_order_relaxed)) {
+    probe->opened_ = false;
+    return GST_PAD_PROBE_DROP;  // events pass, sinks keep caps and segment
+  }
+
+  if (probe->opened_) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstBuffer* buffer = nullptr;
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList* list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+    buffer = gst_buffer_list_length(list) ? gst_buffer_list_get(list, 0) : nullptr;
+  } else {
+    buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  }
+
+  // audio and muxed ts have no delta units
+  if (buffer && GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    return GST_PAD_PROBE_DROP;
+  }
+  probe->opened_ = true;
+  return probe->persistent_ ? GST_PAD_PROBE_OK : GST_PAD_PROBE_REMOVE;
+}
+
+void OutputGateProbe::destroy_callback_probe(gpointer user_data) {
+  OutputGateProbe* probe = reinterpret_cast<OutputGateProbe*>(user_data);
+  probe->pad_ = nullptr;
+  probe->id_probe_ = 0;
 }
 
 }  // namespace stream
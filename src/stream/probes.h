@@ -16,11 +16,19 @@
 
 #include <common/utils.h>
 
+#include <atomic>
 #include <string>  // for string
 
+#include <gst/gstelement.h>
 #include <gst/gstpad.h>  // for GstPad, GstPadProbeInfo, GstPadProbeReturn
+#include <gst/video/video.h>
 
+#include "base/latency_histogram.h"
+
+#include "stream/audio_meter.h"
+#include "stream/loudness_meter.h"
 #include "stream/stypes.h"
+#include "stream/video_meter.h"
 
 namespace fastocloud {
 namespace stream {
@@ -38,6 +46,15 @@ struct Consistency {
   gboolean saw_serialized_event;
 };
 
+// written from streaming thread, collected from main loop; own cache line to avoid false sharing between probes
+struct alignas(64) ProbeCounters {
+  ProbeCounters();
+
+  std::atomic<uint64_t> bytes;
+  std::atomic<uint64_t> packets;
+  std::atomic<int64_t> last_buffer_ts;  // utc msec of last counted buffer, not reset by TakeData
+};
+
 class Probe {
  public:
   Probe(element_id_t id, const common::uri::Url& url, IBaseStream* stream);
@@ -51,8 +68,15 @@ class Probe {
   GstPad* GetPad() const;
   Consistency GetConsistency() const;
 
+  void AddData(gsize bytes, guint packets);
+  // returns collected counters since previous call
+  void TakeData(uint64_t* bytes, uint64_t* packets);
+  fastotv::timestamp_t GetLastBufferTime() const;
+
  protected:
   static void destroy_callback_probe(gpointer user_data);
+  // consistency checks logging of events
+  static bool IsDiagnosticsEnabled();
 
   void Clear();
 
@@ -64,9 +88,11 @@ class Probe {
 
   const element_id_t id_;
   gulong id_buffer_;
+  gulong id_event_;
   GstPad* pad_;
   Consistency consistency_;
   const common::uri::Url url_;
+  ProbeCounters counters_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(Probe);
@@ -81,6 +107,7 @@ class InputProbe : public Probe {
 
  private:
   static GstPadProbeReturn source_callback_probe_buffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static GstPadProbeReturn source_callback_probe_event(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
 };
 
 class OutputProbe : public Probe {
@@ -94,9 +121,167 @@ class OutputProbe : public Probe {
 
  private:
   static GstPadProbeReturn sink_callback_probe_buffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static GstPadProbeReturn sink_callback_probe_event(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
 
   const bool need_push_;
 };
 
+// samples pts to pipeline clock running time delta of passing buffers
+class LatencyProbe {
+ public:
+  explicit LatencyProbe(LatencyStage stage);
+  ~LatencyProbe();
+
+  LatencyStage GetStage() const;
+
+  void Link(GstPad* pad);
+  // moves samples collected since previous call into hist
+  void TakeData(LatencyHistogram* hist);
+
+ private:
+  static GstPadProbeReturn callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static void destroy_callback_probe(gpointer user_data);
+
+  void Record(GstPad* pad, GstClockTime pts);
+  void Clear();
+
+  const LatencyStage stage_;
+  gulong id_probe_;
+  GstPad* pad_;
+  GstSegment segment_;  // streaming thread only
+  bool have_segment_;
+  std::atomic<uint64_t> buckets_[LatencyHistogram::buckets_count];
+
+  DISALLOW_COPY_AND_ASSIGN(LatencyProbe);
+};
+
+// counts buffers leaked by output branch queue, overrun signaled before each leak
+class QueueDropProbe {
+ public:
+  explicit QueueDropProbe(element_id_t id);
+  ~QueueDropProbe();
+
+  element_id_t GetID() const;
+
+  void Link(GstElement* queue);
+  // returns drops since previous call
+  uint64_t TakeDrops();
+
+ private:
+  static void overrun_callback(GstElement* queue, gpointer user_data);
+
+  void Clear();
+
+  const element_id_t id_;
+  gulong id_signal_;
+  GstElement* queue_;
+  std::atomic<uint64_t> drops_;
+
+  DISALLOW_COPY_AND_ASSIGN(QueueDropProbe);
+};
+
+// levels and loudness of raw audio passing pad, non raw or planar audio not metered
+class AudioMeterProbe {
+ public:
+  typedef void (*levels_callback_t)(element_id_t id, const AudioMeter::Levels& levels, gpointer user_data);
+
+  explicit AudioMeterProbe(element_id_t id);
+  ~AudioMeterProbe();
+
+  element_id_t GetID() const;
+
+  void SetLevelsCallback(levels_callback_t cb, gpointer user_data);  // called from streaming thread, before Link
+  void Link(GstPad* pad);
+  // loudest channel of last interval, false if nothing measured
+  bool GetLevel(int* rms_db, int* peak_db, fastotv::timestamp_t* silence_msec) const;
+  bool GetLoudness(LoudnessMeter::Loudness* loudness) const;  // of last block, false if nothing measured
+
+ private:
+  static GstPadProbeReturn callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static void destroy_callback_probe(gpointer user_data);
+
+  void SetCaps(GstCaps* caps);
+  void Measure(GstBuffer* buffer);
+  void Clear();
+
+  const element_id_t id_;
+  gulong id_probe_;
+  GstPad* pad_;
+  AudioMeter meter_;  // streaming thread only
+  LoudnessMeter loudness_meter_;
+  levels_callback_t levels_cb_;
+  gpointer levels_user_data_;
+  std::atomic<bool> measured_;
+  std::atomic<int> rms_db_;
+  std::atomic<int> peak_db_;
+  std::atomic<fastotv::timestamp_t> silence_msec_;
+  std::atomic<bool> loudness_measured_;
+  std::atomic<double> momentary_;
+  std::atomic<double> short_term_;
+  std::atomic<double> integrated_;
+
+  DISALLOW_COPY_AND_ASSIGN(AudioMeterProbe);
+};
+
+// black and freeze of raw 8 bit yuv video passing pad, other formats not metered
+class VideoMeterProbe {
+ public:
+  explicit VideoMeterProbe(element_id_t id);
+  ~VideoMeterProbe();
+
+  element_id_t GetID() const;
+
+  void Link(GstPad* pad);
+  // state of last sampled frame, false if nothing measured
+  bool GetState(fastotv::timestamp_t* black_msec, fastotv::timestamp_t* freeze_msec) const;
+  bool GetMotion(uint32_t* motion) const;  // of last sampled frame, VideoMeter::State::motion
+
+ private:
+  static GstPadProbeReturn callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static void destroy_callback_probe(gpointer user_data);
+
+  void SetCaps(GstCaps* caps);
+  void Measure(GstBuffer* buffer);
+  void Clear();
+
+  const element_id_t id_;
+  gulong id_probe_;
+  GstPad* pad_;
+  GstVideoInfo info_;  // streaming thread only
+  VideoMeter meter_;
+  std::atomic<bool> measured_;
+  std::atomic<fastotv::timestamp_t> black_msec_;
+  std::atomic<fastotv::timestamp_t> freeze_msec_;
+  std::atomic<uint32_t> motion_;
+
+  DISALLOW_COPY_AND_ASSIGN(VideoMeterProbe);
+};
+
+// drops buffers of output branch while muted, after unmute opens on first keyframe so outputs start decodable
+class OutputGateProbe {
+ public:
+  OutputGateProbe(element_id_t id, const std::atomic<bool>* muted, bool persistent = false);  // kept to mute again
+  ~OutputGateProbe();
+
+  element_id_t GetID() const;
+
+  void Link(GstPad* pad);
+
+ private:
+  static GstPadProbeReturn callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static void destroy_callback_probe(gpointer user_data);
+
+  void Clear();
+
+  const element_id_t id_;
+  const std::atomic<bool>* const muted_;
+  const bool persistent_;
+  bool opened_;  // streaming thread only
+  gulong id_probe_;
+  GstPad* pad_;
+
+  DISALLOW_COPY_AND_ASSIGN(OutputGateProbe);
+};
+
 }  // namespace stream
 }  // namespace fastocloud
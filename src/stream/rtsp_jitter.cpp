@@ -0,0 +1,215 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/rtsp_jitter.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <set>
+
+#include <common/logger.h>
+
+#include "stream/elements/sources/rtspsrc.h"
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+const int kDefaultLatencyMsec = 2000;  // rtspsrc default
+const int kJitterFactor = 4;
+const double kPeakDecay = 0.9;
+const int kLatencyChangePercent = 10;
+const guint kRtspLowerTransTcp = 4;  // GST_RTSP_LOWER_TRANS_TCP
+
+// urls restarted over tcp, live while process hosts restarted streams
+std::mutex g_tcp_urls_mutex;
+std::set<std::string> g_tcp_urls;
+
+bool is_tcp_url(const std::string& url) {
+  std::lock_guard<std::mutex> lock(g_tcp_urls_mutex);
+  return g_tcp_urls.find(url) != g_tcp_urls.end();
+}
+
+void mark_tcp_url(const std::string& url) {
+  std::lock_guard<std::mutex> lock(g_tcp_urls_mutex);
+  g_tcp_urls.insert(url);
+}
+
+bool get_uint64_field(const GstStructure* stats, const char* name, uint64_t* value) {
+  guint64 field = 0;
+  if (!gst_structure_get_uint64(stats, name, &field)) {
+    return false;
+  }
+  *value = field;
+  return true;
+}
+}  // namespace
+
+JitterLatencyTuner::JitterLatencyTuner(int min_msec, int max_msec, int start_msec, int tcp_fallback_loss)
+    : min_msec_(min_msec),
+      max_msec_(std::max(min_msec, max_msec)),
+      tcp_fallback_loss_(tcp_fallback_loss),
+      latency_msec_(std::min(std::max(start_msec, min_msec_), max_msec_)),
+      peak_jitter_msec_(0),
+      lossy_ticks_(0) {}
+
+int JitterLatencyTuner::Update(int jitter_msec, uint64_t received, uint64_t lost, uint64_t late) {
+  peak_jitter_msec_ = std::max(peak_jitter_msec_ * kPeakDecay, static_cast<double>(std::max(jitter_msec, 0)));
+  const int target = std::min(std::max(static_cast<int>(peak_jitter_msec_ * kJitterFactor), min_msec_), max_msec_);
+  if (late) {
+    latency_msec_ = std::min(std::max(latency_msec_ + latency_msec_ / 2, target), max_msec_);
+  } else if (latency_msec_ > target) {
+    latency_msec_ = std::max(latency_msec_ - std::max(latency_msec_ / 20, 1), target);
+  } else {
+    latency_msec_ = target;
+  }
+
+  const uint64_t total = received + lost;
+  if (tcp_fallback_loss_ > 0 && total && lost * 100 >= total * static_cast<uint64_t>(tcp_fallback_loss_)) {
+    lossy_ticks_++;
+  } else {
+    lossy_ticks_ = 0;
+  }
+  return latency_msec_;
+}
+
+int JitterLatencyTuner::GetLatency() const {
+  return latency_msec_;
+}
+
+bool JitterLatencyTuner::NeedTcpFallback() const {
+  return lossy_ticks_ >= fallback_ticks;
+}
+
+RtspJitterControl::RtspJitterControl(const RtspIngest& rtsp)
+    : rtsp_(rtsp),
+      tuner_(rtsp.latency_min_msec,
+             rtsp.latency_max_msec,
+             rtsp.latency_msec ? rtsp.latency_msec : kDefaultLatencyMsec,
+             rtsp.tcp_fallback_loss),
+      url_(),
+      jitterbuffers_mutex_(),
+      jitterbuffers_(),
+      checkpoint_() {}
+
+RtspJitterControl::~RtspJitterControl() {
+  std::lock_guard<std::mutex> lock(jitterbuffers_mutex_);
+  for (GstElement* jitterbuffer : jitterbuffers_) {
+    gst_object_unref(jitterbuffer);
+  }
+  jitterbuffers_.clear();
+}
+
+void RtspJitterControl::OnSourceCreated(elements::sources::ElementRTSPSrc* src) {
+  url_ = src->GetLocation();
+  if (rtsp_.IsAdaptive()) {
+    src->SetLatency(tuner_.GetLatency());
+  } else if (rtsp_.latency_msec) {
+    src->SetLatency(rtsp_.latency_msec);
+  }
+
+  if (is_tcp_url(url_)) {
+    INFO_LOG() << "Rtsp input " << url_ << " restarted over tcp after udp loss";
+    src->SetProtocols(kRtspLowerTransTcp);
+  }
+
+  if (rtsp_.IsAdaptive() || rtsp_.tcp_fallback_loss) {
+    g_signal_connect(src->GetGstElement(), "new-manager", G_CALLBACK(new_manager_callback), this);
+  }
+}
+
+bool RtspJitterControl::Tick() {
+  std::lock_guard<std::mutex> lock(jitterbuffers_mutex_);
+  if (jitterbuffers_.empty()) {
+    return true;
+  }
+
+  stats_t total = {0, 0, 0};
+  int jitter_msec = 0;
+  for (GstElement* jitterbuffer : jitterbuffers_) {
+    GstStructure* stats = nullptr;
+    g_object_get(jitterbuffer, "stats", &stats, nullptr);
+    if (!stats) {
+      continue;
+    }
+
+    uint64_t value = 0;
+    if (get_uint64_field(stats, "num-pushed", &value)) {
+      total.pushed += value;
+    }
+    if (get_uint64_field(stats, "num-lost", &value)) {
+      total.lost += value;
+    }
+    if (get_uint64_field(stats, "num-late", &value)) {
+      total.late += value;
+    }
+    if (get_uint64_field(stats, "avg-jitter", &value)) {  // nsec
+      jitter_msec = std::max(jitter_msec, static_cast<int>(value / GST_MSECOND));
+    }
+    gst_structure_free(stats);
+  }
+
+  // counters restart with new jitter buffers
+  const uint64_t pushed = total.pushed >= checkpoint_.pushed ? total.pushed - checkpoint_.pushed : total.pushed;
+  const uint64_t lost = total.lost >= checkpoint_.lost ? total.lost - checkpoint_.lost : total.lost;
+  const uint64_t late = total.late >= checkpoint_.late ? total.late - checkpoint_.late : total.late;
+  checkpoint_ = total;
+
+  const int prev_latency = tuner_.GetLatency();
+  const int latency = tuner_.Update(jitter_msec, pushed, lost, late);
+  if (rtsp_.IsAdaptive() && abs(latency - prev_latency) * 100 >= prev_latency * kLatencyChangePercent) {
+    DEBUG_LOG() << "Rtsp jitter buffer latency: " << latency << " msec, jitter: " << jitter_msec
+                << " msec, late: " << late;
+    for (GstElement* jitterbuffer : jitterbuffers_) {
+      g_object_set(jitterbuffer, "latency", static_cast<guint>(latency), nullptr);
+    }
+  }
+
+  if (tuner_.NeedTcpFallback() && !is_tcp_url(url_)) {
+    WARNING_LOG() << "Rtsp input " << url_ << " lost " << lost << " of " << pushed + lost
+                  << " packets, switching to tcp";
+    mark_tcp_url(url_);
+    return false;
+  }
+  return true;
+}
+
+void RtspJitterControl::HandleNewJitterBuffer(GstElement* jitterbuffer) {
+  if (rtsp_.IsAdaptive()) {
+    g_object_set(jitterbuffer, "latency", static_cast<guint>(tuner_.GetLatency()), nullptr);
+  }
+  std::lock_guard<std::mutex> lock(jitterbuffers_mutex_);
+  jitterbuffers_.push_back(GST_ELEMENT(gst_object_ref(jitterbuffer)));
+}
+
+void RtspJitterControl::new_manager_callback(GstElement* rtspsrc, GstElement* manager, gpointer user_data) {
+  UNUSED(rtspsrc);
+  g_signal_connect(manager, "new-jitterbuffer", G_CALLBACK(new_jitterbuffer_callback), user_data);
+}
+
+void RtspJitterControl::new_jitterbuffer_callback(GstElement* manager,
+                                                  GstElement* jitterbuffer,
+                                                  guint session,
+                                                  guint ssrc,
+                                                  gpointer user_data) {
+  UNUSED(manager);
+  UNUSED(session);
+  UNUSED(ssrc);
+  RtspJitterControl* control = reinterpret_cast<RtspJitterControl*>(user_data);
+  control->HandleNewJitterBuffer(jitterbuffer);
+}
+
+}  // namespace stream
+}  // namespace fastocloud
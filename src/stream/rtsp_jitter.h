@@ -0,0 +1,89 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gst/gst.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/macros.h>
+
+#include "stream/stypes.h"
+
+namespace fastocloud {
+namespace stream {
+namespace elements {
+namespace sources {
+class ElementRTSPSrc;
+}
+}  // namespace elements
+
+// latency of rtp jitter buffer from arrival jitter, grows fast on late packets, shrinks slowly to jitter target
+class JitterLatencyTuner {
+ public:
+  enum { fallback_ticks = 3 };  // consecutive lossy ticks before tcp
+
+  JitterLatencyTuner(int min_msec, int max_msec, int start_msec, int tcp_fallback_loss);
+
+  int Update(int jitter_msec, uint64_t received, uint64_t lost, uint64_t late);  // deltas of tick, new latency
+  int GetLatency() const;
+  bool NeedTcpFallback() const;
+
+ private:
+  const int min_msec_;
+  const int max_msec_;
+  const int tcp_fallback_loss_;
+  int latency_msec_;
+  double peak_jitter_msec_;
+  int lossy_ticks_;
+};
+
+// jitter buffers of rtspsrc, tuned on main timer tick
+class RtspJitterControl {
+ public:
+  explicit RtspJitterControl(const RtspIngest& rtsp);
+  ~RtspJitterControl();
+
+  void OnSourceCreated(elements::sources::ElementRTSPSrc* src);
+  bool Tick();  // false if stream should restart over tcp
+
+ private:
+  struct stats_t {
+    uint64_t pushed;
+    uint64_t lost;
+    uint64_t late;
+  };
+
+  void HandleNewJitterBuffer(GstElement* jitterbuffer);
+
+  static void new_manager_callback(GstElement* rtspsrc, GstElement* manager, gpointer user_data);
+  static void new_jitterbuffer_callback(GstElement* manager, GstElement* jitterbuffer, guint session, guint ssrc,
+                                        gpointer user_data);
+
+  const RtspIngest rtsp_;
+  JitterLatencyTuner tuner_;
+  std::string url_;
+
+  std::mutex jitterbuffers_mutex_;
+  std::vector<GstElement*> jitterbuffers_;
+  stats_t checkpoint_;
+
+  DISALLOW_COPY_AND_ASSIGN(RtspJitterControl);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
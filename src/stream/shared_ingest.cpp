@@ -0,0 +1,92 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/shared_ingest.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <functional>
+
+#include <common/sprintf.h>
+
+namespace {
+std::string MakeIngestPath(const std::string& dir, const std::string& url, const char* ext) {
+  const unsigned long long hash = std::hash<std::string>()(url);
+  return common::MemSPrintf("%s/%016llx.%s", dir, hash, ext);
+}
+}  // namespace
+
+namespace fastocloud {
+namespace stream {
+
+SharedIngest::SharedIngest(const std::string& dir, const std::string& url)
+    : lock_path_(MakeIngestPath(dir, url, "lock")), socket_path_(MakeIngestPath(dir, url, "sock")), fd_(-1) {}
+
+SharedIngest::~SharedIngest() {
+  if (!IsPublisher()) {
+    return;
+  }
+
+#if defined(OS_POSIX)
+  unlink(socket_path_.c_str());
+  flock(fd_, LOCK_UN);
+  close(fd_);
+#endif
+  fd_ = -1;
+}
+
+bool SharedIngest::TryPublish() {
+  if (IsPublisher()) {
+    return true;
+  }
+
+#if defined(OS_POSIX)
+  int fd = open(lock_path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    return false;
+  }
+
+  if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+    close(fd);
+    return false;
+  }
+
+  unlink(socket_path_.c_str());  // left by died publisher
+  fd_ = fd;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool SharedIngest::IsPublisher() const {
+  return fd_ != -1;
+}
+
+std::string SharedIngest::GetSocketPath() const {
+  return socket_path_;
+}
+
+bool SharedIngest::IsShareable(const common::uri::Url& url) {
+  const common::uri::Url::scheme scheme = url.GetScheme();
+  return scheme == common::uri::Url::http || scheme == common::uri::Url::https || scheme == common::uri::Url::udp ||
+         scheme == common::uri::Url::rtmp || scheme == common::uri::Url::srt;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
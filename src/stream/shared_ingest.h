@@ -0,0 +1,49 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <common/macros.h>
+#include <common/uri/url.h>
+
+namespace fastocloud {
+namespace stream {
+
+// one upstream connection per input url on node, first stream locking the url republishes it over shm socket,
+// others read socket, lock released by kernel if publisher died and next restarted stream takes it
+class SharedIngest {
+ public:
+  enum { shm_size = 32 * 1024 * 1024, queue_size = 8 * 1024 * 1024 };  // bytes, not yet read data of readers
+
+  SharedIngest(const std::string& dir, const std::string& url);
+  ~SharedIngest();
+
+  bool TryPublish();  // false if url published by other stream
+  bool IsPublisher() const;
+  std::string GetSocketPath() const;
+
+  static bool IsShareable(const common::uri::Url& url);  // live network inputs
+
+ private:
+  const std::string lock_path_;
+  const std::string socket_path_;
+  int fd_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedIngest);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
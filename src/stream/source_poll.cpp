@@ -0,0 +1,283 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/source_poll.h"
+
+#if defined(OS_POSIX)
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include <common/file_system/file_system.h>
+#include <common/sprintf.h>
+
+#define HTTP_PROBE_REQUEST "HEAD %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: fastocloud\r\nConnection: close\r\n\r\n"
+#define SRT_HANDSHAKE_SIZE 64
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+
+const char* GetDefaultPort(common::uri::Url::scheme scheme) {
+  if (scheme == common::uri::Url::http) {
+    return "80";
+  } else if (scheme == common::uri::Url::https) {
+    return "443";
+  } else if (scheme == common::uri::Url::rtmp) {
+    return "1935";
+  } else if (scheme == common::uri::Url::rtsp) {
+    return "554";
+  }
+  return nullptr;
+}
+
+bool IsSrtListener(const common::uri::Url& url) {
+  return url.GetUrl().find("mode=listener") != std::string::npos;
+}
+
+#if defined(OS_POSIX)
+bool WaitFd(int fd, short events, int timeout_msec) {
+  struct pollfd pfd = {fd, events, 0};
+  return poll(&pfd, 1, timeout_msec) == 1 && (pfd.revents & events);
+}
+
+// -1 if not connected in time
+int ConnectWithTimeout(const struct addrinfo* addr, int timeout_msec) {
+  int fd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+  if (fd == -1) {
+    return -1;
+  }
+
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  bool connected = connect(fd, addr->ai_addr, addr->ai_addrlen) == 0;
+  if (!connected && errno == EINPROGRESS) {
+    int error = 0;
+    socklen_t len = sizeof(error);
+    connected = WaitFd(fd, POLLOUT, timeout_msec) && getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 &&
+                error == 0;
+  }
+  if (!connected) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// server answered with status line, client errors except missing method mean input is gone
+bool ProbeHttp(int fd, const common::uri::Url& url, const std::string& host, int timeout_msec) {
+  std::string path = url.GetPath().GetPath();
+  if (path.empty()) {
+    path = "/";
+  }
+  const std::string request = common::MemSPrintf(HTTP_PROBE_REQUEST, path.c_str(), host.c_str());
+  if (!WaitFd(fd, POLLOUT, timeout_msec) || send(fd, request.data(), request.size(), MSG_NOSIGNAL) <= 0) {
+    return false;
+  }
+
+  char buff[32] = {0};
+  if (!WaitFd(fd, POLLIN, timeout_msec) || recv(fd, buff, sizeof(buff) - 1, 0) <= 0) {
+    return false;
+  }
+
+  int status = 0;
+  if (sscanf(buff, "HTTP/%*d.%*d %d", &status) != 1) {
+    return false;
+  }
+  return status < 400 || status == 405;
+}
+
+SourcePollResult ProbeTcp(const common::uri::Url& url, const std::string& host, const std::string& port, int timeout) {
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* result = nullptr;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0) {
+    return SOURCE_UNREACHABLE;  // dns failures are as dead as refused connects
+  }
+
+  SourcePollResult res = SOURCE_UNREACHABLE;
+  for (struct addrinfo* rp = result; rp; rp = rp->ai_next) {
+    int fd = ConnectWithTimeout(rp, timeout);
+    if (fd == -1) {
+      continue;
+    }
+    const bool answered = url.GetScheme() != common::uri::Url::http || ProbeHttp(fd, url, host, timeout);
+    close(fd);
+    res = answered ? SOURCE_REACHABLE : SOURCE_UNREACHABLE;
+    break;
+  }
+  freeaddrinfo(result);
+  return res;
+}
+
+// datagram received on input port, multicast group joined for it
+SourcePollResult ProbeUdp(const std::string& host, const std::string& port, int timeout_msec) {
+  struct in_addr group;
+  memset(&group, 0, sizeof(group));
+  if (!host.empty() && inet_pton(AF_INET, host.c_str(), &group) != 1) {
+    return SOURCE_NOT_POLLABLE;  // names and ipv6 left to pipeline
+  }
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd == -1) {
+    return SOURCE_NOT_POLLABLE;
+  }
+
+  const int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(atoi(port.c_str())));
+  const bool multicast = IN_MULTICAST(ntohl(group.s_addr));
+  addr.sin_addr.s_addr = multicast ? group.s_addr : htonl(INADDR_ANY);
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+    close(fd);
+    return SOURCE_NOT_POLLABLE;
+  }
+
+  if (multicast) {
+    struct ip_mreq mreq;
+    mreq.imr_multiaddr = group;
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+      close(fd);
+      return SOURCE_NOT_POLLABLE;
+    }
+  }
+
+  const bool received = WaitFd(fd, POLLIN, timeout_msec);
+  close(fd);
+  return received ? SOURCE_REACHABLE : SOURCE_UNREACHABLE;
+}
+
+void PutUint32(uint32_t value, uint8_t* out) {
+  const uint32_t net = htonl(value);
+  memcpy(out, &net, sizeof(net));
+}
+
+// induction handshake of caller, answered by any listening srt peer before encryption and stream id checks
+SourcePollResult ProbeSrt(const std::string& host, const std::string& port, int timeout_msec) {
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_DGRAM;
+  struct addrinfo* result = nullptr;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+    return SOURCE_UNREACHABLE;
+  }
+
+  int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+  if (fd == -1 || connect(fd, result->ai_addr, result->ai_addrlen) != 0) {
+    if (fd != -1) {
+      close(fd);
+    }
+    freeaddrinfo(result);
+    return SOURCE_NOT_POLLABLE;
+  }
+  freeaddrinfo(result);
+
+  uint8_t packet[SRT_HANDSHAKE_SIZE] = {0};
+  PutUint32(0x80000000, packet);    // control packet, handshake
+  PutUint32(4, packet + 16);        // udt version of induction
+  PutUint32(2, packet + 20);        // extension field, dgram
+  PutUint32(static_cast<uint32_t>(getpid()) & 0x7FFFFFFF, packet + 24);  // initial sequence
+  PutUint32(1500, packet + 28);     // mtu
+  PutUint32(8192, packet + 32);     // flow window
+  PutUint32(1, packet + 36);        // induction
+  PutUint32(static_cast<uint32_t>(fd) + 1, packet + 40);  // caller socket id
+  SourcePollResult res = SOURCE_UNREACHABLE;
+  uint8_t answer[SRT_HANDSHAKE_SIZE * 2];
+  if (send(fd, packet, sizeof(packet), 0) == sizeof(packet) && WaitFd(fd, POLLIN, timeout_msec)) {
+    const ssize_t size = recv(fd, answer, sizeof(answer), 0);
+    if (size >= SRT_HANDSHAKE_SIZE && memcmp(answer, packet, 4) == 0) {
+      res = SOURCE_REACHABLE;
+    }
+  }
+  close(fd);
+  return res;
+}
+#endif
+
+}  // namespace
+
+bool GetSourcePollAddress(const common::uri::Url& url, std::string* host, std::string* port) {
+  if (!host || !port) {
+    return false;
+  }
+
+  const common::uri::Url::scheme scheme = url.GetScheme();
+  const char* default_port = GetDefaultPort(scheme);
+  const bool datagram = scheme == common::uri::Url::udp || scheme == common::uri::Url::srt;
+  if (!default_port && scheme != common::uri::Url::tcp && !datagram) {
+    return false;
+  }
+
+  if (scheme == common::uri::Url::srt && IsSrtListener(url)) {
+    return false;  // callers connect to us, nothing to knock at
+  }
+
+  const std::string host_str = url.GetHost();
+  std::string lhost = host_str;
+  std::string lport = default_port ? default_port : std::string();
+  const size_t del = host_str.find_last_of(':');
+  if (del != std::string::npos) {
+    lhost = host_str.substr(0, del);
+    lport = host_str.substr(del + 1);
+  }
+  if (lport.empty() || (lhost.empty() && scheme != common::uri::Url::udp)) {  // udp://:port on all interfaces
+    return false;
+  }
+
+  *host = lhost;
+  *port = lport;
+  return true;
+}
+
+SourcePollResult PollInputSource(const common::uri::Url& url, int timeout_msec) {
+  if (url.GetScheme() == common::uri::Url::file) {
+    return common::file_system::is_file_exist(url.GetPath().GetPath()) ? SOURCE_REACHABLE : SOURCE_UNREACHABLE;
+  }
+
+  std::string host;
+  std::string port;
+  if (!GetSourcePollAddress(url, &host, &port)) {
+    return SOURCE_NOT_POLLABLE;
+  }
+
+#if defined(OS_POSIX)
+  if (url.GetScheme() == common::uri::Url::udp) {
+    return ProbeUdp(host, port, timeout_msec);
+  } else if (url.GetScheme() == common::uri::Url::srt) {
+    return ProbeSrt(host, port, timeout_msec);
+  }
+  return ProbeTcp(url, host, port, timeout_msec);
+#else
+  UNUSED(timeout_msec);
+  return SOURCE_NOT_POLLABLE;
+#endif
+}
+
+}  // namespace stream
+}  // namespace fastocloud
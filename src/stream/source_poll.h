@@ -0,0 +1,33 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <common/uri/url.h>
+
+namespace fastocloud {
+namespace stream {
+
+enum SourcePollResult { SOURCE_UNREACHABLE = 0, SOURCE_REACHABLE, SOURCE_NOT_POLLABLE };
+
+// host and port knocked at by probe of input, false if scheme has no cheap check (srt listener, devices)
+bool GetSourcePollAddress(const common::uri::Url& url, std::string* host, std::string* port);
+
+// tcp connect, http head, udp receive, srt induction or file lookup, run before building pipeline after failures
+SourcePollResult PollInputSource(const common::uri::Url& url, int timeout_msec);
+
+}  // namespace stream
+}  // namespace fastocloud
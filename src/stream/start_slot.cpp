@@ -0,0 +1,76 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/start_slot.h"
+
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <common/sprintf.h>
+
+namespace fastocloud {
+namespace stream {
+
+StartSlot::StartSlot(const std::string& dir, size_t count) : dir_(dir), count_(count), fd_(-1) {}
+
+StartSlot::~StartSlot() {
+  Release();
+}
+
+bool StartSlot::TryAcquire() {
+  if (IsAcquired()) {
+    return true;
+  }
+
+#if defined(OS_POSIX)
+  for (size_t i = 0; i < count_; ++i) {
+    const std::string path = common::MemSPrintf("%s/slot_%lu.lock", dir_, i);
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+      continue;
+    }
+
+    if (flock(fd, LOCK_EX | LOCK_NB) == 0) {
+      fd_ = fd;
+      return true;
+    }
+    close(fd);
+  }
+  return false;
+#else
+  return true;
+#endif
+}
+
+void StartSlot::Release() {
+  if (!IsAcquired()) {
+    return;
+  }
+
+#if defined(OS_POSIX)
+  flock(fd_, LOCK_UN);
+  close(fd_);
+#endif
+  fd_ = -1;
+}
+
+bool StartSlot::IsAcquired() const {
+  return fd_ != -1;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,44 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace stream {
+
+// node wide limit of simultaneously built pipelines, shared by stream processes of one daemon
+// slots are locked files in directory prepared by daemon, lock released by kernel if process died
+class StartSlot {
+ public:
+  StartSlot(const std::string& dir, size_t count);
+  ~StartSlot();
+
+  bool TryAcquire();  // false if all slots taken by other streams
+  void Release();
+  bool IsAcquired() const;
+
+ private:
+  const std::string dir_;
+  const size_t count_;
+  int fd_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartSlot);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
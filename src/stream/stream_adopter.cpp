@@ -0,0 +1,192 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/stream_adopter.h"
+
+#if defined(OS_POSIX)
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include <common/logger.h>
+
+#include "base/stream_adoption.h"
+
+#define ADOPT_CONNECTION_TIMEOUT_SEC 5
+
+namespace fastocloud {
+namespace stream {
+
+StreamAdopter::Observer::~Observer() {}
+
+StreamAdopter::StreamAdopter(const std::string& path, Observer* observer)
+    : path_(path), observer_(observer), listen_(INVALID_DESCRIPTOR), stop_(false), thread_(), parked_mutex_() {
+  parked_[0] = INVALID_DESCRIPTOR;
+  parked_[1] = INVALID_DESCRIPTOR;
+}
+
+StreamAdopter::~StreamAdopter() {
+#if defined(OS_POSIX)
+  stop_ = true;
+  if (listen_ != INVALID_DESCRIPTOR) {
+    shutdown(listen_, SHUT_RDWR);  // wakes accept
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  if (listen_ != INVALID_DESCRIPTOR) {
+    close(listen_);
+    unlink(path_.c_str());
+  }
+#endif
+  CloseParked();
+}
+
+bool StreamAdopter::Start() {
+#if defined(OS_POSIX)
+  if (listen_ != INVALID_DESCRIPTOR) {
+    return true;
+  }
+
+  common::ErrnoError err = ListenAdoptSocket(path_, &listen_);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    listen_ = INVALID_DESCRIPTOR;
+    return false;
+  }
+
+  thread_ = std::thread([this] { Run(); });
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool StreamAdopter::IsParked() const {
+  std::unique_lock<std::mutex> lock(parked_mutex_);
+  return parked_[0] != INVALID_DESCRIPTOR;
+}
+
+void StreamAdopter::Run() {
+#if defined(OS_POSIX)
+  while (!stop_) {
+    int sock = accept4(listen_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (sock == INVALID_DESCRIPTOR) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      if (!stop_) {
+        WARNING_LOG() << "Adopt socket failed, errno: " << errno;
+      }
+      return;
+    }
+
+    struct timeval timeout = {ADOPT_CONNECTION_TIMEOUT_SEC, 0};  // peer stuck in the middle of message
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    HandleConnection(sock);
+    close(sock);
+  }
+#endif
+}
+
+void StreamAdopter::HandleConnection(int sock) {
+#if defined(OS_POSIX)
+  AdoptMessage msg;
+  int fds[2];
+  common::ErrnoError err = ReceiveAdoptMessage(sock, &msg, fds);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    return;
+  }
+
+  if (msg.command == ADOPT_PARK) {
+    AdoptMessage resp = {ADOPT_PARK, 0};
+    if (fds[0] == INVALID_DESCRIPTOR || fds[1] == INVALID_DESCRIPTOR) {
+      resp.error = EINVAL;
+      for (int i = 0; i < 2; ++i) {
+        if (fds[i] != INVALID_DESCRIPTOR) {
+          close(fds[i]);
+        }
+      }
+    } else {
+      CloseParked();
+      std::unique_lock<std::mutex> lock(parked_mutex_);
+      parked_[0] = fds[0];
+      parked_[1] = fds[1];
+    }
+    err = SendAdoptMessage(sock, resp, nullptr);
+    if (err) {
+      DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    }
+    if (!resp.error) {
+      INFO_LOG() << "Command pipes parked, waiting for service to adopt stream";
+      observer_->OnCommandPipeParked();
+    }
+    return;
+  }
+
+  for (int i = 0; i < 2; ++i) {  // only park passes descriptors
+    if (fds[i] != INVALID_DESCRIPTOR) {
+      close(fds[i]);
+    }
+  }
+
+  if (msg.command != ADOPT_CLAIM) {
+    AdoptMessage resp = {msg.command, EINVAL};
+    ignore_result(SendAdoptMessage(sock, resp, nullptr));
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(parked_mutex_);
+  if (parked_[0] == INVALID_DESCRIPTOR) {
+    lock.unlock();
+    AdoptMessage resp = {ADOPT_CLAIM, ENOENT};  // daemon which spawned stream still owns pipes
+    ignore_result(SendAdoptMessage(sock, resp, nullptr));
+    return;
+  }
+
+  AdoptMessage resp = {ADOPT_CLAIM, 0};
+  err = SendAdoptMessage(sock, resp, parked_);
+  if (err) {
+    DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_WARNING);
+    return;
+  }
+
+  close(parked_[0]);  // copies went to claiming daemon
+  close(parked_[1]);
+  parked_[0] = INVALID_DESCRIPTOR;
+  parked_[1] = INVALID_DESCRIPTOR;
+  lock.unlock();
+  INFO_LOG() << "Command pipes claimed, stream adopted by service";
+  observer_->OnCommandPipeClaimed();
+#else
+  UNUSED(sock);
+#endif
+}
+
+void StreamAdopter::CloseParked() {
+#if defined(OS_POSIX)
+  std::unique_lock<std::mutex> lock(parked_mutex_);
+  for (int i = 0; i < 2; ++i) {
+    if (parked_[i] != INVALID_DESCRIPTOR) {
+      close(parked_[i]);
+      parked_[i] = INVALID_DESCRIPTOR;
+    }
+  }
+#endif
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,63 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <common/macros.h>
+
+namespace fastocloud {
+namespace stream {
+
+// unix socket of stream process in feedback dir, stopping daemon parks its ends of command pipes here
+// so they never see eof, next daemon claims them back and talks to stream like it was spawned by it
+class StreamAdopter {
+ public:
+  class Observer {
+   public:
+    // both called on adopter thread
+    virtual void OnCommandPipeParked() = 0;
+    virtual void OnCommandPipeClaimed() = 0;
+    virtual ~Observer();
+  };
+
+  StreamAdopter(const std::string& path, Observer* observer);
+  ~StreamAdopter();  // parked pipes closed, stream sees eof and stops
+
+  bool Start();  // false if socket not bound, stream not adoptable
+  bool IsParked() const;
+
+ private:
+  void Run();
+  void HandleConnection(int sock);
+  void CloseParked();
+
+  const std::string path_;
+  Observer* const observer_;
+  int listen_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+
+  mutable std::mutex parked_mutex_;
+  int parked_[2];  // read responces, write requests
+
+  DISALLOW_COPY_AND_ASSIGN(StreamAdopter);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
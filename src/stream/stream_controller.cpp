@@ -18,6 +18,11 @@
 #include <processthreadsapi.h>
 #endif
 
+#include <algorithm>
+#include <vector>
+
+#include <json-c/json_tokener.h>
+
 #include <common/file_system/file_system.h>
 #include <common/file_system/string_path_utils.h>
 #include <common/system_info/system_info.h>
@@ -26,17 +31,26 @@
 #include "base/config_fields.h"  // for ID_FIELD
 #include "base/constants.h"
 #include "base/gst_constants.h"
+#include "base/stream_config_parse.h"
 
+#include "stream/catchup_export.h"
 #include "stream/configs_factory.h"
 #include "stream/ibase_stream.h"
 #include "stream/link_generator/streamlink.h"
+#include "stream/live_config.h"
+#include "stream/memory_accounting.h"
 #include "stream/probes.h"
+#include "stream/source_poll.h"
+#include "stream/start_slot.h"
 #include "stream/stream_server.h"
+#include "stream/streaming_task_pool.h"
 #include "stream/streams/configs/relay_config.h"
 #include "stream/streams_factory.h"  // for isTimeshiftP...
 
+#include "stream_commands/binary_protocol.h"
 #include "stream_commands/commands.h"
 #include "stream_commands/commands_factory.h"
+#include "stream_commands/commands_info/profile_info.h"
 
 namespace fastocloud {
 namespace stream {
@@ -64,6 +78,12 @@ TimeShiftInfo make_timeshift_info(const StreamConfig& config) {
   if (timeshift_delay_field && timeshift_delay_field->GetAsInteger(&timeshift_delay)) {
     tinfo.timeshift_delay = timeshift_delay;
   }
+
+  time_t timeshift_start_utc = 0;
+  common::Value* timeshift_start_utc_field = config->Find(TIMESHIFT_START_UTC_FIELD);
+  if (timeshift_start_utc_field && GetTimeFromValue(timeshift_start_utc_field, &timeshift_start_utc)) {
+    tinfo.timeshift_start_utc = timeshift_start_utc;
+  }
   return tinfo;
 }
 
@@ -76,18 +96,32 @@ StreamController::StreamController(const common::file_system::ascii_directory_st
     : IBaseStream::IStreamClient(),
       feedback_dir_(feedback_dir),
       streamlink_path_(streamlink_path),
+      config_args_(),
       config_(nullptr),
+      pending_config_(nullptr),
       timeshift_info_(),
       restart_attempts_(0),
+      quarantine_failures_(0),
+      short_failures_(0),
+      random_(std::random_device()()),
+      start_slot_(nullptr),
+      start_slot_ts_(0),
       stop_mutex_(),
       stop_cond_(),
       stop_(false),
+      chunk_watcher_(),
       ev_thread_(),
       loop_(new StreamServer(command_client, this)),
       ttl_master_timer_(0),
+      heap_release_interval_(0),
+      heap_release_timer_(0),
       libev_started_(2),
+      adopter_(nullptr),
+      adopt_wait_timer_(0),
       mem_(mem),
+      mem_shm_(nullptr),
       origin_(nullptr),
+      outputs_muted_(false),
 #if defined(OS_WIN)
       process_metrics_(common::process::ProcessMetrics::CreateProcessMetrics(GetCurrentProcess()))
 #else
@@ -105,7 +139,9 @@ common::Error StreamController::Init(const StreamConfig& config_args) {
     return err;
   }
 
+  config_args_ = config_args;
   config_ = lconfig;
+  outputs_muted_ = config_->GetMutedOutputs();
   fastotv::StreamType stream_type = config_->GetType();
   if (stream_type == fastotv::TIMESHIFT_RECORDER || stream_type == fastotv::TIMESHIFT_PLAYER ||
       stream_type == fastotv::CATCHUP) {
@@ -114,8 +150,7 @@ common::Error StreamController::Init(const StreamConfig& config_args) {
 
   EncoderType enc = CPU;
   std::string video_codec;
-  common::Value* vcodec = config_args->Find(VIDEO_CODEC_FIELD);
-  if (vcodec && vcodec->GetAsBasicString(&video_codec)) {
+  if (read_video_codec(config_args, &video_codec)) {
     EncoderType lenc;
     if (GetEncoderType(video_codec, &lenc)) {
       enc = lenc;
@@ -123,16 +158,97 @@ common::Error StreamController::Init(const StreamConfig& config_args) {
   }
 
   streams_init(0, nullptr, enc);
+
+  bool memory_accounting;
+  common::Value* memory_accounting_field = config_args->Find(MEMORY_ACCOUNTING_FIELD);
+  if (memory_accounting_field && memory_accounting_field->GetAsBoolean(&memory_accounting) && memory_accounting) {
+    // also child of zygote where gstreamer already inited
+    if (install_memory_accounting()) {
+      INFO_LOG() << "Memory accounting allocator installed.";
+    }
+  }
+
+  int streaming_pool_threads;
+  common::Value* streaming_pool_threads_field = config_args->Find(STREAMING_POOL_THREADS_FIELD);
+  if (streaming_pool_threads_field && streaming_pool_threads_field->GetAsInteger(&streaming_pool_threads) &&
+      streaming_pool_threads > 0) {
+    std::vector<int> cpus;
+    common::ArrayValue* cpus_list = nullptr;
+    common::Value* cpus_field = config_args->Find(STREAMING_POOL_CPUS_FIELD);
+    if (cpus_field && cpus_field->GetAsList(&cpus_list)) {
+      for (size_t i = 0; i < cpus_list->GetSize(); ++i) {
+        common::Value* item = nullptr;
+        int cpu;
+        if (cpus_list->Get(i, &item) && item->GetAsInteger(&cpu)) {
+          cpus.push_back(cpu);
+        }
+      }
+    }
+    if (install_streaming_task_pool(streaming_pool_threads, cpus)) {
+      INFO_LOG() << "Streaming task pool installed, idle threads: " << streaming_pool_threads;
+    }
+  }
+
+  common::Value* heap_release_interval_field = config_args->Find(HEAP_RELEASE_INTERVAL_FIELD);
+  if (heap_release_interval_field) {
+    ignore_result(heap_release_interval_field->GetAsInteger(&heap_release_interval_));
+  }
+
+  int quarantine_failures;
+  common::Value* quarantine_failures_field = config_args->Find(QUARANTINE_FAILURES_FIELD);
+  if (quarantine_failures_field && quarantine_failures_field->GetAsInteger(&quarantine_failures) &&
+      quarantine_failures > 0) {
+    quarantine_failures_ = quarantine_failures;
+  }
+
+  bool binary_pipe;
+  common::Value* binary_pipe_field = config_args->Find(PIPE_BINARY_FIELD);
+  if (binary_pipe_field && binary_pipe_field->GetAsBoolean(&binary_pipe)) {
+    static_cast<StreamServer*>(loop_)->SetBinaryPipe(binary_pipe);
+  }
+
+  int start_slots;
+  std::string start_slots_dir;
+  common::Value* start_slots_field = config_args->Find(START_SLOTS_FIELD);
+  common::Value* start_slots_dir_field = config_args->Find(START_SLOTS_DIR_FIELD);
+  if (start_slots_field && start_slots_field->GetAsInteger(&start_slots) && start_slots > 0 && start_slots_dir_field &&
+      start_slots_dir_field->GetAsBasicString(&start_slots_dir)) {
+    start_slot_ = new StartSlot(start_slots_dir, start_slots);
+  }
+
+  std::string adopt_socket;
+  common::Value* adopt_socket_field = config_args->Find(ACTIVE_ADOPT_SOCKET_FIELD);
+  if (adopt_socket_field && adopt_socket_field->GetAsBasicString(&adopt_socket)) {
+    adopter_ = new StreamAdopter(adopt_socket, this);
+    if (!adopter_->Start()) {
+      WARNING_LOG() << "Stream can't be adopted by next service, socket: " << adopt_socket;
+      destroy(&adopter_);
+    }
+  }
+
+  // segment created by daemon, stats still sended via pipe if not exists
+  common::ErrnoError errn = OpenStreamShm(MakeStreamShmName(mem_->id), &mem_shm_);
+  if (errn) {
+    DEBUG_MSG_ERROR(errn, common::logging::LOG_LEVEL_WARNING);
+    mem_shm_ = nullptr;
+  }
+  mem_->startup[INIT_STARTUP_STAGE] = common::time::current_utc_mstime();
   return common::Error();
 }
 
 StreamController::~StreamController() {
+  destroy(&adopter_);  // posts to loop from own thread
   loop_->Stop();
   ev_thread_.join();
 
   destroy(&loop_);
-  streams_deinit();
   destroy(&config_);
+  destroy(&pending_config_);
+  destroy(&start_slot_);
+  if (mem_shm_) {
+    ignore_result(CloseStreamShm(mem_shm_));
+    mem_shm_ = nullptr;
+  }
 }
 
 int StreamController::Exec() {
@@ -143,15 +259,39 @@ int StreamController::Exec() {
   });
   libev_started_.Wait();
 
-  while (!stop_) {
+  const bool exported = config_->GetType() == fastotv::CATCHUP && ExportRecordedCatchup();
+  while (!stop_ && !exported) {
+    {
+      std::unique_lock<std::mutex> lock(stop_mutex_);
+      if (pending_config_) {
+        destroy(&config_);
+        config_ = pending_config_;
+        pending_config_ = nullptr;
+      }
+    }
+
     chunk_index_t start_chunk_index = invalid_chunk_index;
     if (config_->GetType() == fastotv::TIMESHIFT_PLAYER) {  // if timeshift player or cathcup player
       const streams::TimeshiftConfig* tconfig = static_cast<const streams::TimeshiftConfig*>(config_);
       time_t timeshift_chunk_duration = tconfig->GetTimeShiftChunkDuration();
-      while (!timeshift_info_.FindChunkToPlay(timeshift_chunk_duration, &start_chunk_index)) {
+      {
+        std::unique_lock<std::mutex> lock(stop_mutex_);
+        chunk_watcher_.Reset();  // earlier interrupts handled by previous run or seen as stop_
+      }
+
+      const std::string chunks_dir = timeshift_info_.timshift_dir.GetPath();
+      while (!stop_ && !timeshift_info_.FindChunkToPlay(timeshift_chunk_duration, &start_chunk_index)) {
         mem_->status = WAITING;
         DumpStreamStatus(mem_);
 
+        if (chunk_watcher_.Init(chunks_dir)) {  // retried until recorder created folder
+          if (chunk_watcher_.Wait(timeshift_chunk_duration * 1000) == ChunkWatcher::INTERRUPTED) {
+            mem_->restarts++;
+            break;
+          }
+          continue;
+        }
+
         {
           std::unique_lock<std::mutex> lock(stop_mutex_);
           std::cv_status interrupt_status = stop_cond_.wait_for(lock, std::chrono::seconds(timeshift_chunk_duration));
@@ -166,22 +306,52 @@ int StreamController::Exec() {
       if (start_chunk_index == invalid_chunk_index) {
         continue;
       }
+
+      if (timeshift_info_.timeshift_start_utc) {  // restarts keep offset from now
+        const time_t now = common::time::current_utc_mstime() / 1000;
+        timeshift_info_.timeshift_delay = (now - timeshift_info_.timeshift_start_utc) / 60;
+        timeshift_info_.timeshift_start_utc = 0;
+      }
+    }
+
+    // source still down after failure, expensive pipeline start waits until it answers cheap probe
+    if (restart_attempts_ && config_->GetType() != fastotv::TIMESHIFT_PLAYER) {
+      const fastotv::timestamp_t probe_start_utc = common::time::current_utc_mstime();
+      if (!IsInputResponding()) {
+        INFO_LOG() << "Input not responding, pipeline start skipped";
+        mem_->idle_time += common::time::current_utc_mstime() - probe_start_utc;
+        WaitRestart(false);
+        continue;
+      }
+    }
+
+    if (!WaitStartSlot()) {
+      break;
     }
 
     int stabled_status = EXIT_SUCCESS;
     int signal_number = 0;
     fastotv::timestamp_t start_utc_now = common::time::current_utc_mstime();
-    const std::unique_ptr<Config> config_copy(make_config_copy(config_, &gena));
-    origin_ =
-        StreamsFactory::GetInstance().CreateStream(config_copy.get(), this, mem_, timeshift_info_, start_chunk_index);
+    // parsed config shared by restarts, copied only if streamlink resolved inputs again
+    std::unique_ptr<Config> generated_config;
+    input_t generated_input;
+    if (make_generated_input(config_, &gena, &generated_input)) {
+      generated_config.reset(config_->Clone());
+      generated_config->SetInput(generated_input);
+    }
+    const Config* run_config = generated_config ? generated_config.get() : config_;
+    origin_ = StreamsFactory::GetInstance().CreateStream(run_config, this, mem_, timeshift_info_, start_chunk_index);
     if (!origin_) {
       CRITICAL_LOG() << "Can't create stream";
+      ReleaseStartSlot();
       break;
     }
 
     bool is_vod = origin_->IsVod();
+    origin_->SetOutputsMuted(outputs_muted_);
     ExitStatus res = origin_->Exec();
     destroy(&origin_);
+    ReleaseStartSlot();
     if (res == EXIT_INNER) {
       stabled_status = EXIT_FAILURE;
     }
@@ -201,37 +371,157 @@ int StreamController::Exec() {
 
     if (stabled_status == EXIT_SUCCESS) {
       restart_attempts_ = 0;
+      short_failures_ = 0;
       continue;
     }
 
-    if (diff_utc_time) {  // if longer work
-      restart_attempts_ = 0;
-      continue;
+    WaitRestart(is_longer_work);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+void StreamController::WaitRestart(bool is_longer_work) {
+  if (is_longer_work) {  // failure after stable work starts backoff from the beginning
+    restart_attempts_ = 0;
+    short_failures_ = 0;
+  }
+
+  if (quarantine_failures_ && !is_longer_work && ++short_failures_ >= quarantine_failures_) {
+    WaitQuarantine();
+    // one run to prove source, quarantined again if it fails short
+    short_failures_ = quarantine_failures_ - 1;
+    restart_attempts_ = 0;
+    return;
+  }
+
+  fastotv::timestamp_t wait_msec = 0;
+  if (++restart_attempts_ == config_->GetMaxRestartAttempts()) {
+    restart_attempts_ = 0;
+    mem_->status = FROZEN;
+    DumpStreamStatus(mem_);
+    wait_msec = restart_after_frozen_sec * 1000;
+  } else {
+    wait_msec = CalcRestartDelay();
+  }
+
+  INFO_LOG() << "Automatically restarted after " << wait_msec << " msec, stream restarts: " << mem_->restarts
+             << ", attempts: " << restart_attempts_;
+
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  std::cv_status interrupt_status = stop_cond_.wait_for(lock, std::chrono::milliseconds(wait_msec));
+  if (interrupt_status == std::cv_status::no_timeout) {  // if notify
+    restart_attempts_ = 0;
+  } else {
+    mem_->idle_time += wait_msec;
+  }
+}
+
+bool StreamController::ExportRecordedCatchup() const {
+  const streams::TimeshiftConfig* tconfig = static_cast<const streams::TimeshiftConfig*>(config_);
+  const std::string recorder_dir = tconfig->GetCatchupRecorderDir();
+  const time_t stop_utc = tconfig->GetCatchupStopUtc();
+  if (recorder_dir.empty() || !timeshift_info_.timeshift_start_utc || !stop_utc) {
+    return false;
+  }
+
+  if (!export_recorded_catchup(common::file_system::ascii_directory_string_path(recorder_dir),
+                               timeshift_info_.timshift_dir, timeshift_info_.timeshift_start_utc, stop_utc,
+                               tconfig->GetTimeShiftChunkDuration())) {
+    INFO_LOG() << "Catchup range not found in recorder " << recorder_dir << ", recording from input";
+    return false;
+  }
+  return true;
+}
+
+bool StreamController::IsInputResponding() const {
+  bool pollable = false;
+  for (const InputUri& iuri : config_->GetInput()) {
+    const SourcePollResult probe = PollInputSource(iuri.GetInput(), source_probe_timeout_msec);
+    if (probe == SOURCE_REACHABLE) {
+      return true;
+    }
+    pollable |= probe == SOURCE_UNREACHABLE;
+  }
+  return !pollable;
+}
+
+fastotv::timestamp_t StreamController::CalcRestartDelay() {
+  // streams failed by the same upstream blip should not restart in lockstep, delay is in [max/2, max]
+  const size_t shift = std::min<size_t>(restart_attempts_ - 1, 16);
+  const fastotv::timestamp_t max_msec = std::min<fastotv::timestamp_t>(
+      static_cast<fastotv::timestamp_t>(restart_backoff_base_msec) << shift, restart_after_frozen_sec * 1000);
+  std::uniform_int_distribution<fastotv::timestamp_t> jitter(0, max_msec / 2);
+  return max_msec - jitter(random_);
+}
+
+void StreamController::WaitQuarantine() {
+  INFO_LOG() << "Stream quarantined after " << short_failures_ << " short runs, pipeline replaced by source polls";
+  mem_->status = QUARANTINED;
+  DumpStreamStatus(mem_);
+
+  const input_t input = config_->GetInput();
+  const fastotv::timestamp_t start_utc = common::time::current_utc_mstime();
+  while (true) {
+    bool reachable = false;
+    bool pollable = false;
+    for (const InputUri& iuri : input) {
+      const SourcePollResult poll = PollInputSource(iuri.GetInput(), source_probe_timeout_msec);
+      reachable = poll == SOURCE_REACHABLE;
+      if (reachable) {
+        break;
+      }
+      pollable |= poll == SOURCE_UNREACHABLE;
+    }
+    if (reachable) {
+      INFO_LOG() << "Source of quarantined stream reachable again";
+      break;
     }
 
-    size_t wait_time = 0;
-    if (++restart_attempts_ == config_->GetMaxRestartAttempts()) {
-      restart_attempts_ = 0;
-      mem_->status = FROZEN;
-      DumpStreamStatus(mem_);
-      wait_time = restart_after_frozen_sec;
-    } else {
-      wait_time = restart_attempts_ * (restart_after_frozen_sec / config_->GetMaxRestartAttempts());
+    const uint32_t wait_sec = pollable ? quarantine_poll_sec : quarantine_not_pollable_sec;
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    if (stop_) {
+      break;
+    }
+    std::cv_status interrupt_status = stop_cond_.wait_for(lock, std::chrono::seconds(wait_sec));
+    // restart request, or pipeline is the only check
+    if (interrupt_status == std::cv_status::no_timeout || !pollable) {
+      break;
     }
+  }
+
+  mem_->idle_time += common::time::current_utc_mstime() - start_utc;
+}
 
-    INFO_LOG() << "Automatically restarted after " << wait_time << " seconds, stream restarts: " << mem_->restarts
-               << ", attempts: " << restart_attempts_;
+bool StreamController::WaitStartSlot() {
+  if (!start_slot_) {
+    return true;
+  }
+
+  std::uniform_int_distribution<int> jitter(start_slot_poll_msec / 2, start_slot_poll_msec);
+  bool logged = false;
+  while (!start_slot_->TryAcquire()) {
+    if (!logged) {
+      INFO_LOG() << "Waiting for free start slot, too many pipelines are starting on node";
+      logged = true;
+    }
 
     std::unique_lock<std::mutex> lock(stop_mutex_);
-    std::cv_status interrupt_status = stop_cond_.wait_for(lock, std::chrono::seconds(wait_time));
-    if (interrupt_status == std::cv_status::no_timeout) {  // if notify
-      restart_attempts_ = 0;
-    } else {
-      mem_->idle_time += wait_time * 1000;
+    stop_cond_.wait_for(lock, std::chrono::milliseconds(jitter(random_)));
+    if (stop_) {
+      return false;
     }
   }
 
-  return EXIT_SUCCESS;
+  start_slot_ts_ = common::time::current_utc_mstime();
+  return true;
+}
+
+void StreamController::ReleaseStartSlot() {
+  if (start_slot_ && start_slot_->IsAcquired()) {
+    start_slot_->Release();
+    DEBUG_LOG() << "Start slot released after " << common::time::current_utc_mstime() - start_slot_ts_ << " msec.";
+  }
 }
 
 void StreamController::Stop() {
@@ -239,6 +529,7 @@ void StreamController::Stop() {
     std::unique_lock<std::mutex> lock(stop_mutex_);
     stop_ = true;
     stop_cond_.notify_all();
+    chunk_watcher_.Interrupt();
   }
   StopStream();
 }
@@ -247,6 +538,7 @@ void StreamController::Restart() {
   {
     std::unique_lock<std::mutex> lock(stop_mutex_);
     stop_cond_.notify_all();
+    chunk_watcher_.Interrupt();
   }
   StopStream();
 }
@@ -258,6 +550,9 @@ void StreamController::PreLooped(common::libev::IoLoop* loop) {
     ttl_master_timer_ = loop_->CreateTimer(*ttl_sec, false);
     NOTICE_LOG() << "Set stream ttl: " << *ttl_sec;
   }
+  if (heap_release_interval_ > 0) {
+    heap_release_timer_ = loop_->CreateTimer(heap_release_interval_, true);
+  }
 
   libev_started_.Wait();
   INFO_LOG() << "Child listening started!";
@@ -268,6 +563,13 @@ void StreamController::PostLooped(common::libev::IoLoop* loop) {
   if (ttl_master_timer_) {
     loop_->RemoveTimer(ttl_master_timer_);
   }
+  if (heap_release_timer_) {
+    loop_->RemoveTimer(heap_release_timer_);
+  }
+  if (adopt_wait_timer_) {
+    loop_->RemoveTimer(adopt_wait_timer_);
+    adopt_wait_timer_ = 0;
+  }
   INFO_LOG() << "Child listening finished!";
 }
 
@@ -286,31 +588,25 @@ void StreamController::Closed(common::libev::IoClient* client) {
 }
 
 common::ErrnoError StreamController::StreamDataRecived(common::libev::IoClient* client) {
-  std::string input_command;
   fastotv::protocol::protocol_client_t* pclient = static_cast<fastotv::protocol::protocol_client_t*>(client);
-  common::ErrnoError err = pclient->ReadCommand(&input_command);
+  const bool binary = static_cast<StreamServer*>(loop_)->IsBinaryPipe();
+  fastotv::protocol::request_t* req = nullptr;
+  fastotv::protocol::response_t* resp = nullptr;
+  common::ErrnoError err = ReadPipeCommand(pclient, binary, &req, &resp);
   if (err) {  // i don't want handle spam, command must be formated according
               // protocol
     return err;
   }
 
-  fastotv::protocol::request_t* req = nullptr;
-  fastotv::protocol::response_t* resp = nullptr;
-  common::Error err_parse = common::protocols::json_rpc::ParseJsonRPC(input_command, &req, &resp);
-  if (err_parse) {
-    const std::string err_str = err_parse->GetDescription();
-    return common::make_errno_error(err_str, EAGAIN);
-  }
-
   if (req) {
-    INFO_LOG() << "Received request: " << input_command;
+    INFO_LOG() << "Received request: " << req->method;
     err = HandleRequestCommand(pclient, req);
     if (err) {
       DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
     }
     delete req;
   } else if (resp) {
-    INFO_LOG() << "Received responce: " << input_command;
+    INFO_LOG() << "Received responce";
     err = HandleResponceCommand(pclient, resp);
     if (err) {
       DEBUG_MSG_ERROR(err, common::logging::LOG_LEVEL_ERR);
@@ -340,11 +636,22 @@ void StreamController::DataReadyToWrite(common::libev::IoClient* client) {
 void StreamController::TimerEmited(common::libev::IoLoop* loop, common::libev::timer_id_t id) {
   UNUSED(loop);
   if (id == ttl_master_timer_) {
-    const auto ttl_sec = config_->GetTimeToLifeStream();
-    if (ttl_sec) {
-      NOTICE_LOG() << "Timeout notified ttl was: " << *ttl_sec;
+    {
+      std::unique_lock<std::mutex> lock(stop_mutex_);  // config swapped by pipeline thread
+      const auto ttl_sec = config_->GetTimeToLifeStream();
+      if (ttl_sec) {
+        NOTICE_LOG() << "Timeout notified ttl was: " << *ttl_sec;
+      }
     }
     Stop();
+  } else if (id == heap_release_timer_) {
+    release_heap_memory();
+  } else if (id == adopt_wait_timer_) {
+    adopt_wait_timer_ = 0;
+    if (adopter_ && adopter_->IsParked()) {
+      NOTICE_LOG() << "Stream not adopted by service in " << adopt_wait_sec << " sec.";
+      Stop();
+    }
   }
 }
 
@@ -369,6 +676,14 @@ common::ErrnoError StreamController::HandleRequestCommand(common::libev::IoClien
     return HandleRequestStopStream(client, req);
   } else if (req->method == RESTART_STREAM) {
     return HandleRequestRestartStream(client, req);
+  } else if (req->method == UPDATE_CONFIG_STREAM) {
+    return HandleRequestUpdateConfigStream(client, req);
+  } else if (req->method == PROFILE_STREAM) {
+    return HandleRequestProfileStream(client, req);
+  } else if (req->method == UNMUTE_OUTPUTS_STREAM) {
+    return HandleRequestUnmuteOutputsStream(client, req);
+  } else if (req->method == MUTE_OUTPUTS_STREAM) {
+    return HandleRequestMuteOutputsStream(client, req);
   }
 
   WARNING_LOG() << "Received unknown command: " << req->method;
@@ -399,7 +714,7 @@ common::ErrnoError StreamController::HandleRequestStopStream(common::libev::IoCl
   CHECK(loop_->IsLoopThread());
   fastotv::protocol::protocol_client_t* pclient = static_cast<fastotv::protocol::protocol_client_t*>(client);
   fastotv::protocol::response_t resp = StopStreamResponseSuccess(req->id);
-  ignore_result(pclient->WriteResponse(resp));
+  ignore_result(WritePipeResponse(pclient, resp, static_cast<StreamServer*>(loop_)->IsBinaryPipe()));
   Stop();
   return common::ErrnoError();
 }
@@ -409,11 +724,114 @@ common::ErrnoError StreamController::HandleRequestRestartStream(common::libev::I
   CHECK(loop_->IsLoopThread());
   fastotv::protocol::protocol_client_t* pclient = static_cast<fastotv::protocol::protocol_client_t*>(client);
   fastotv::protocol::response_t resp = RestartStreamResponseSuccess(req->id);
-  ignore_result(pclient->WriteResponse(resp));
+  ignore_result(WritePipeResponse(pclient, resp, static_cast<StreamServer*>(loop_)->IsBinaryPipe()));
   Restart();
   return common::ErrnoError();
 }
 
+common::ErrnoError StreamController::HandleRequestUpdateConfigStream(common::libev::IoClient* client,
+                                                                     const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  fastotv::protocol::protocol_client_t* pclient = static_cast<fastotv::protocol::protocol_client_t*>(client);
+  const bool binary_pipe = static_cast<StreamServer*>(loop_)->IsBinaryPipe();
+  if (!req->params) {
+    return common::make_errno_error_inval();
+  }
+
+  StreamConfig changes(MakeConfigFromJson(*req->params));
+  if (!changes) {
+    return common::make_errno_error_inval();
+  }
+
+  common::Error err = CheckStreamConfigUpdate(config_args_, changes);
+  Config* lconfig = nullptr;
+  const StreamConfig updated_args = MergeStreamConfig(config_args_, changes);
+  if (!err) {
+    err = make_config(updated_args, &lconfig);
+  }
+  if (err) {
+    fastotv::protocol::response_t resp = UpdateConfigStreamResponseFail(req->id, err->GetDescription());
+    ignore_result(WritePipeResponse(pclient, resp, binary_pipe));
+    return common::ErrnoError();
+  }
+
+  config_args_ = updated_args;
+  LiveConfigUpdate update;
+  bool live;
+  {
+    std::unique_lock<std::mutex> lock(stop_mutex_);
+    live = MakeLiveConfigUpdate(pending_config_ ? pending_config_ : config_, lconfig, changes, &update);
+    destroy(&pending_config_);
+    pending_config_ = lconfig;  // restarts keep changes
+  }
+
+  fastotv::protocol::response_t resp = UpdateConfigStreamResponseSuccess(req->id);
+  ignore_result(WritePipeResponse(pclient, resp, binary_pipe));
+  if (!live) {
+    INFO_LOG() << "Changed config fields applied by restart of stream";
+    Restart();
+  } else if (origin_) {
+    origin_->UpdateLiveConfig(update);
+  }
+  return common::ErrnoError();
+}
+
+common::ErrnoError StreamController::HandleRequestProfileStream(common::libev::IoClient* client,
+                                                                const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  fastotv::protocol::protocol_client_t* pclient = static_cast<fastotv::protocol::protocol_client_t*>(client);
+  if (!req->params) {
+    return common::make_errno_error_inval();
+  }
+
+  json_object* jprofile = json_tokener_parse(req->params->c_str());
+  if (!jprofile) {
+    return common::make_errno_error_inval();
+  }
+
+  ProfileInfo profile_info;
+  common::Error err_des = profile_info.DeSerialize(jprofile);
+  json_object_put(jprofile);
+  if (err_des) {
+    return common::make_errno_error(err_des->GetDescription(), EAGAIN);
+  }
+
+  fastotv::protocol::response_t resp = ProfileStreamResponseSuccess(req->id);
+  ignore_result(WritePipeResponse(pclient, resp, static_cast<StreamServer*>(loop_)->IsBinaryPipe()));
+  auto profile_file = feedback_dir_.MakeFileStringPath(PROFILE_FILE_NAME);
+  auto dump_file = feedback_dir_.MakeFileStringPath(DUMP_FILE_NAME);  // replaced by graph with element stats
+  if (profile_file && dump_file && origin_) {
+    origin_->StartProfile(*profile_file, *dump_file, profile_info.GetDuration());
+  }
+  return common::ErrnoError();
+}
+
+common::ErrnoError StreamController::HandleRequestUnmuteOutputsStream(common::libev::IoClient* client,
+                                                                      const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  fastotv::protocol::protocol_client_t* pclient = static_cast<fastotv::protocol::protocol_client_t*>(client);
+  fastotv::protocol::response_t resp = UnmuteOutputsStreamResponseSuccess(req->id);
+  ignore_result(WritePipeResponse(pclient, resp, static_cast<StreamServer*>(loop_)->IsBinaryPipe()));
+  outputs_muted_ = false;
+  if (origin_) {
+    origin_->SetOutputsMuted(false);
+  }
+  return common::ErrnoError();
+}
+
+common::ErrnoError StreamController::HandleRequestMuteOutputsStream(common::libev::IoClient* client,
+                                                                    const fastotv::protocol::request_t* req) {
+  CHECK(loop_->IsLoopThread());
+  fastotv::protocol::protocol_client_t* pclient = static_cast<fastotv::protocol::protocol_client_t*>(client);
+  fastotv::protocol::response_t resp = MuteOutputsStreamResponseSuccess(req->id);
+  ignore_result(WritePipeResponse(pclient, resp, static_cast<StreamServer*>(loop_)->IsBinaryPipe()));
+  outputs_muted_ = true;
+  if (origin_) {
+    origin_->SetOutputsMuted(true);
+  }
+  return common::ErrnoError();
+}
+
 void StreamController::StopStream() {
   if (origin_) {
     origin_->Quit(EXIT_SELF);
@@ -427,7 +845,9 @@ void StreamController::RestartStream() {
 }
 
 void StreamController::OnStatusChanged(IBaseStream* stream, StreamStatus status) {
-  UNUSED(status);
+  if (status == PLAYING) {  // pipeline built and autoplugged
+    ReleaseStartSlot();
+  }
   DumpStreamStatus(stream->GetStats());
 }
 
@@ -469,6 +889,14 @@ void StreamController::OnTimeoutUpdated(IBaseStream* stream) {
   DumpStreamStatus(stream->GetStats());
 }
 
+void StreamController::OnStatisticUpdated(IBaseStream* stream) {
+  if (start_slot_ && start_slot_->IsAcquired() &&
+      common::time::current_utc_mstime() - start_slot_ts_ > start_slot_hold_sec * 1000) {
+    ReleaseStartSlot();  // waiting for data of slow source, build is done
+  }
+  WriteStreamStructShm(*stream->GetStats(), mem_shm_);
+}
+
 void StreamController::OnASyncMessageReceived(IBaseStream* stream, GstMessage* message) {
   UNUSED(stream);
   UNUSED(message);
@@ -494,6 +922,9 @@ void StreamController::OnMlNotification(IBaseStream* stream, const std::vector<f
 #endif
 
 void StreamController::OnPipelineCreated(IBaseStream* stream) {
+  if (!mem_->startup[PIPELINE_STARTUP_STAGE]) {
+    mem_->startup[PIPELINE_STARTUP_STAGE] = common::time::current_utc_mstime();
+  }
   auto dump_file = feedback_dir_.MakeFileStringPath(DUMP_FILE_NAME);
   if (dump_file) {
     const auto path = *dump_file;
@@ -504,6 +935,27 @@ void StreamController::OnPipelineCreated(IBaseStream* stream) {
   }
 }
 
+void StreamController::OnCommandPipeParked() {
+  static_cast<StreamServer*>(loop_)->SetParked(true);
+  auto cb = [this] {
+    if (!adopt_wait_timer_) {
+      adopt_wait_timer_ = loop_->CreateTimer(adopt_wait_sec, false);
+    }
+  };
+  loop_->ExecInLoopThread(cb);
+}
+
+void StreamController::OnCommandPipeClaimed() {
+  static_cast<StreamServer*>(loop_)->SetParked(false);
+  auto cb = [this] {
+    if (adopt_wait_timer_) {
+      loop_->RemoveTimer(adopt_wait_timer_);
+      adopt_wait_timer_ = 0;
+    }
+  };
+  loop_->ExecInLoopThread(cb);
+}
+
 void StreamController::DumpStreamStatus(StreamStruct* stat) {
   const double cpu_load = process_metrics_->GetPlatformIndependentCPUUsage();
 #if defined(OS_LINUX) || defined(OS_ANDROID)
@@ -513,6 +965,9 @@ void StreamController::DumpStreamStatus(StreamStruct* stat) {
   const size_t rss = 0;
 #endif
   const fastotv::timestamp_t current_time = common::time::current_utc_mstime();
+  stat->gst_memory = get_accounted_memory();
+  stat->heap_memory = get_heap_memory();
+  WriteStreamStructShm(*stat, mem_shm_);
   StatisticInfo statistic(*stat, cpu_load, rss, current_time);
   static_cast<StreamServer*>(loop_)->SendStatisticBroadcast(statistic);
 }
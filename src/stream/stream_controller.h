@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <random>
 #include <string>
 #include <thread>
 
@@ -26,15 +28,31 @@
 #include <fastotv/protocol/types.h>
 
 #include "base/stream_config.h"
+#include "base/stream_struct_shm.h"
+#include "stream/chunk_watcher.h"
 #include "stream/ibase_stream.h"
+#include "stream/stream_adopter.h"
 #include "stream/timeshift.h"
 
 namespace fastocloud {
 namespace stream {
 
-class StreamController : public common::libev::IoLoopObserver, public IBaseStream::IStreamClient {
+class StartSlot;
+
+class StreamController : public common::libev::IoLoopObserver,
+                         public IBaseStream::IStreamClient,
+                         public StreamAdopter::Observer {
  public:
-  enum constants : uint32_t { restart_after_frozen_sec = 60 };
+  enum constants : uint32_t {
+    restart_after_frozen_sec = 60,
+    restart_backoff_base_msec = 1000,  // first restart delay, doubled by every failed attempt
+    start_slot_hold_sec = 15,          // slot released if pipeline not playing for this long
+    start_slot_poll_msec = 200,
+    adopt_wait_sec = 300,  // parked stream stops if no service claimed it
+    quarantine_poll_sec = 30,
+    source_probe_timeout_msec = 3000,  // connect, answer or first datagram of input
+    quarantine_not_pollable_sec = 600  // udp, srt and devices, pipeline tried after it
+  };
 
   StreamController(const common::file_system::ascii_directory_string_path& feedback_dir,
                    const common::file_system::ascii_file_string_path& streamlink_path,
@@ -58,6 +76,14 @@ class StreamController : public common::libev::IoLoopObserver, public IBaseStrea
                                              const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
   common::ErrnoError HandleRequestRestartStream(common::libev::IoClient* client,
                                                 const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestUpdateConfigStream(common::libev::IoClient* client,
+                                                     const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestProfileStream(common::libev::IoClient* client,
+                                                const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestUnmuteOutputsStream(common::libev::IoClient* client,
+                                                      const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
+  common::ErrnoError HandleRequestMuteOutputsStream(common::libev::IoClient* client,
+                                                    const fastotv::protocol::request_t* req) WARN_UNUSED_RESULT;
 
   void Stop();
   void Restart();
@@ -88,6 +114,7 @@ class StreamController : public common::libev::IoLoopObserver, public IBaseStrea
   void OnOutputProbeEvent(IBaseStream* stream, OutputProbe* probe, GstEvent* event) override;
   void OnPipelineEOS(IBaseStream* stream) override;
   void OnTimeoutUpdated(IBaseStream* stream) override;
+  void OnStatisticUpdated(IBaseStream* stream) override;
   void OnSyncMessageReceived(IBaseStream* stream, GstMessage* message) override;
   void OnASyncMessageReceived(IBaseStream* stream, GstMessage* message) override;
   void OnInputChanged(IBaseStream* stream, const InputUri& uri) override;
@@ -97,29 +124,55 @@ class StreamController : public common::libev::IoLoopObserver, public IBaseStrea
 
   void OnPipelineCreated(IBaseStream* stream) override;
 
+  void OnCommandPipeParked() override;
+  void OnCommandPipeClaimed() override;
+
   common::ErrnoError SendResponceToParent(const std::string& cmd) WARN_UNUSED_RESULT;
 
   void DumpStreamStatus(StreamStruct* stat);
 
+  fastotv::timestamp_t CalcRestartDelay();  // msec, exponential with jitter
+  bool WaitStartSlot();                     // false if stopped while waiting
+  void WaitQuarantine();                    // until source reachable, stopped or restarted by request
+  bool IsInputResponding() const;           // probe before pipeline, true if nothing can be probed
+  bool ExportRecordedCatchup() const;       // catchup linked from recorder chunks, false if it has to be recorded
+  void WaitRestart(bool is_longer_work);    // after failed run, backoff or quarantine
+  void ReleaseStartSlot();
+
   const common::file_system::ascii_directory_string_path feedback_dir_;
   const common::file_system::ascii_file_string_path streamlink_path_;
+  StreamConfig config_args_;  // loop thread, with updates
   const Config* config_;
+  const Config* pending_config_;  // updated config, used by next run of pipeline, guarded by stop_mutex_
   TimeShiftInfo timeshift_info_;
   size_t restart_attempts_;
+  size_t quarantine_failures_;  // 0 - never quarantined
+  size_t short_failures_;       // failed runs in row shorter than stable work
+  std::minstd_rand random_;  // restart jitter, seeded per process
+
+  StartSlot* start_slot_;  // nullptr if parallel starts not limited
+  fastotv::timestamp_t start_slot_ts_;  // utc msec, slot acquired at
 
   std::mutex stop_mutex_;
   std::condition_variable stop_cond_;
   bool stop_;
+  ChunkWatcher chunk_watcher_;  // timeshift player, interrupted with stop_cond_
 
   std::thread ev_thread_;
   common::libev::IoLoop* loop_;
   common::libev::timer_id_t ttl_master_timer_;
+  int heap_release_interval_;  // seconds, 0 - not released by timer
+  common::libev::timer_id_t heap_release_timer_;
   common::threads::barrier libev_started_;
+  StreamAdopter* adopter_;  // nullptr if service doesn't adopt streams
+  common::libev::timer_id_t adopt_wait_timer_;
 
   StreamStruct* mem_;
+  StreamStructShm* mem_shm_;
 
   //
   IBaseStream* origin_;
+  std::atomic<bool> outputs_muted_;  // migration target until unmuted, kept over restarts
   std::unique_ptr<common::process::ProcessMetrics> process_metrics_;
 };
 
@@ -0,0 +1,360 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/stream_profiler.h"
+
+#if defined(OS_LINUX)
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <common/time.h>
+
+#include "stream/memory_accounting.h"
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+#if defined(OS_LINUX)
+// /proc/self/task/<tid>/stat: tid (comm) state ppid ... utime stime, comm may have spaces
+bool read_task_stat(const std::string& path, std::string* comm, uint64_t* ticks) {
+  std::ifstream stat(path);
+  std::string line;
+  if (!std::getline(stat, line)) {
+    return false;
+  }
+
+  const std::string::size_type open = line.find('(');
+  const std::string::size_type close = line.rfind(')');
+  if (open == std::string::npos || close == std::string::npos || close < open) {
+    return false;
+  }
+
+  std::istringstream fields(line.substr(close + 1));
+  std::string skip;
+  for (int i = 0; i < 11; ++i) {  // state .. cmajflt
+    fields >> skip;
+  }
+  uint64_t utime = 0, stime = 0;
+  fields >> utime >> stime;
+  if (!fields) {
+    return false;
+  }
+
+  *comm = line.substr(open + 1, close - open - 1);
+  *ticks = utime + stime;
+  return true;
+}
+#endif
+
+bool has_level_time(GstElement* element) {
+  return g_object_class_find_property(G_OBJECT_GET_CLASS(element), "current-level-time") &&
+         g_object_class_find_property(G_OBJECT_GET_CLASS(element), "current-level-buffers");
+}
+}  // namespace
+
+StreamProfiler::ElementSample::ElementSample()
+    : buffers_in(0), buffers_out(0), bytes_out(0), proc_time(0), proc_samples(0), enter_ts(0), enter_thread(nullptr) {}
+
+StreamProfiler::StreamProfiler(GstElement* pipeline, uint32_t duration_sec)
+    : pipeline_(pipeline),
+      duration_sec_(std::min<uint32_t>(duration_sec, PROFILE_MAX_DURATION_SEC)),
+      start_ts_(common::time::current_utc_mstime()),
+      last_ts_(start_ts_),
+      samples_(0),
+      threads_(),
+      queues_(),
+      elements_(),
+      probes_() {
+  SampleThreads();
+  AddElementProbes();
+}
+
+StreamProfiler::~StreamProfiler() {
+  for (const auto& probe : probes_) {
+    gst_pad_remove_probe(probe.first, probe.second);
+    gst_object_unref(probe.first);
+  }
+}
+
+void StreamProfiler::AddElementProbes() {
+  if (!pipeline_ || !GST_IS_BIN(pipeline_)) {
+    return;
+  }
+
+  // pads of elements created later (decodebin, rebuilt outputs) not counted
+  std::vector<GstElement*> elements;
+  GstIterator* it = gst_bin_iterate_recurse(GST_BIN(pipeline_));
+  GValue item = G_VALUE_INIT;
+  bool done = false;
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK: {
+        GstElement* element = GST_ELEMENT(g_value_get_object(&item));
+        if (!GST_IS_BIN(element)) {
+          elements.push_back(GST_ELEMENT(gst_object_ref(element)));
+        }
+        g_value_reset(&item);
+        break;
+      }
+      case GST_ITERATOR_RESYNC:
+        for (GstElement* element : elements) {
+          gst_object_unref(element);
+        }
+        elements.clear();
+        gst_iterator_resync(it);
+        break;
+      case GST_ITERATOR_ERROR:
+      case GST_ITERATOR_DONE:
+        done = true;
+        break;
+    }
+  }
+  g_value_unset(&item);
+  gst_iterator_free(it);
+
+  for (GstElement* element : elements) {
+    gchar* name = gst_element_get_name(element);
+    std::unique_ptr<ElementSample>& slot = elements_[name];  // same names in different bins share sample
+    g_free(name);
+    if (!slot) {
+      slot.reset(new ElementSample);
+    }
+    ElementSample* sample = slot.get();
+
+    GstIterator* pads = gst_element_iterate_pads(element);
+    GValue vpad = G_VALUE_INIT;
+    while (gst_iterator_next(pads, &vpad) == GST_ITERATOR_OK) {
+      GstPad* pad = GST_PAD(g_value_get_object(&vpad));
+      const gulong id = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, buffer_probe_callback, sample, nullptr);
+      if (id) {
+        probes_.push_back(std::make_pair(GST_PAD(gst_object_ref(pad)), id));
+      }
+      g_value_reset(&vpad);
+    }
+    g_value_unset(&vpad);
+    gst_iterator_free(pads);
+    gst_object_unref(element);
+  }
+}
+
+GstPadProbeReturn StreamProfiler::buffer_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  ElementSample* sample = reinterpret_cast<ElementSample*>(user_data);
+  const gint64 now = g_get_monotonic_time();
+  if (GST_PAD_DIRECTION(pad) == GST_PAD_SINK) {
+    sample->buffers_in++;
+    sample->enter_ts = now;
+    sample->enter_thread = g_thread_self();
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  sample->buffers_out++;
+  sample->bytes_out += gst_buffer_get_size(buffer);
+  const gint64 enter_ts = sample->enter_ts;
+  if (enter_ts && sample->enter_thread == g_thread_self()) {  // pushed from chain, not from own task
+    sample->proc_time += now - enter_ts;
+    sample->proc_samples++;
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+bool StreamProfiler::Tick() {
+  last_ts_ = common::time::current_utc_mstime();
+  samples_++;
+  SampleThreads();
+  SampleQueues();
+  return last_ts_ - start_ts_ < static_cast<fastotv::timestamp_t>(duration_sec_) * 1000;
+}
+
+void StreamProfiler::SampleThreads() {
+#if defined(OS_LINUX)
+  DIR* dir = opendir("/proc/self/task");
+  if (!dir) {
+    return;
+  }
+
+  struct dirent* entry = nullptr;
+  while ((entry = readdir(dir))) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+
+    const long tid = strtol(entry->d_name, nullptr, 10);
+    std::string comm;
+    uint64_t ticks = 0;
+    if (!read_task_stat(std::string("/proc/self/task/") + entry->d_name + "/stat", &comm, &ticks)) {
+      continue;
+    }
+
+    auto it = threads_.find(tid);
+    if (it == threads_.end()) {
+      threads_[tid] = {comm, ticks, ticks};  // started in window, counted from first sample
+    } else {
+      it->second.name = comm;
+      it->second.last_ticks = ticks;
+    }
+  }
+  closedir(dir);
+#endif
+}
+
+void StreamProfiler::SampleQueues() {
+  if (!pipeline_ || !GST_IS_BIN(pipeline_)) {
+    return;
+  }
+
+  GstIterator* it = gst_bin_iterate_recurse(GST_BIN(pipeline_));
+  GValue item = G_VALUE_INIT;
+  bool done = false;
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK: {
+        GstElement* element = GST_ELEMENT(g_value_get_object(&item));
+        if (has_level_time(element)) {
+          guint64 level_time = 0;
+          guint level_buffers = 0;
+          g_object_get(element, "current-level-time", &level_time, "current-level-buffers", &level_buffers, nullptr);
+          gchar* name = gst_element_get_name(element);
+          QueueSample& sample = queues_[name];
+          g_free(name);
+          sample.samples++;
+          sample.sum_level_time += level_time;
+          sample.max_level_time = std::max(sample.max_level_time, level_time);
+          sample.max_level_buffers = std::max(sample.max_level_buffers, level_buffers);
+          if (level_buffers == 0) {
+            sample.empty_samples++;
+          }
+        }
+        g_value_reset(&item);
+        break;
+      }
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync(it);
+        break;
+      case GST_ITERATOR_ERROR:
+      case GST_ITERATOR_DONE:
+        done = true;
+        break;
+    }
+  }
+  g_value_unset(&item);
+  gst_iterator_free(it);
+}
+
+bool StreamProfiler::WriteReport(const common::file_system::ascii_file_string_path& path) const {
+  if (!path.IsValid()) {
+    return false;
+  }
+
+  std::ofstream report(path.GetPath());
+  if (!report.is_open()) {
+    return false;
+  }
+
+  const fastotv::timestamp_t window = last_ts_ - start_ts_;
+  report << "profile window: " << window << " msec, samples: " << samples_ << "\n\n";
+
+#if defined(OS_LINUX)
+  std::vector<std::pair<uint64_t, long>> by_ticks;
+  for (const auto& thread : threads_) {
+    by_ticks.push_back(std::make_pair(thread.second.last_ticks - thread.second.start_ticks, thread.first));
+  }
+  std::sort(by_ticks.rbegin(), by_ticks.rend());
+
+  const long clk_tck = sysconf(_SC_CLK_TCK);
+  report << "threads (tid, name, cpu %):\n";
+  for (const auto& entry : by_ticks) {
+    double cpu = 0;
+    if (window > 0 && clk_tck > 0) {
+      cpu = static_cast<double>(entry.first) * 100000 / clk_tck / window;
+    }
+    report << "  " << entry.second << " " << threads_.at(entry.second).name << " " << cpu << "\n";
+  }
+  report << "\n";
+#endif
+
+  report << "elements (name, buffers in/sec, buffers out/sec, out kbps, avg proctime usec):\n";
+  for (const auto& element : elements_) {
+    report << "  " << element.first << " " << MakeElementLine(*element.second) << "\n";
+  }
+  report << "\n";
+
+  report << "queues (name, avg level msec, max level msec, max buffers, empty %):\n";
+  for (const auto& queue : queues_) {
+    const QueueSample& sample = queue.second;
+    if (!sample.samples) {
+      continue;
+    }
+    report << "  " << queue.first << " " << sample.sum_level_time / sample.samples / GST_MSECOND << " "
+           << sample.max_level_time / GST_MSECOND << " " << sample.max_level_buffers << " "
+           << sample.empty_samples * 100 / sample.samples << "\n";
+  }
+
+  report << "\nheap bytes: " << get_heap_memory() << "\n";
+  if (is_memory_accounting_installed()) {
+    report << "buffers memory (thread, bytes, peak bytes, allocations), total: " << get_accounted_memory() << "\n";
+    for (const MemorySite& site : get_memory_sites()) {
+      report << "  " << site.name << " " << site.bytes << " " << site.peak << " " << site.allocations << "\n";
+    }
+  }
+  return report.good();
+}
+
+std::string StreamProfiler::MakeElementLine(const ElementSample& sample) const {
+  const double window_sec = std::max<fastotv::timestamp_t>(last_ts_ - start_ts_, 1) / 1000.0;
+  const uint64_t proc_samples = sample.proc_samples;
+  std::ostringstream line;
+  line.precision(1);
+  line << std::fixed << sample.buffers_in / window_sec << " " << sample.buffers_out / window_sec << " "
+       << sample.bytes_out * 8 / 1000 / window_sec << " ";
+  if (proc_samples) {
+    line << sample.proc_time / proc_samples;
+  } else {
+    line << "-";
+  }
+  return line.str();
+}
+
+dumper::IDumper::annotations_t StreamProfiler::MakeAnnotations() const {
+  const double window_sec = std::max<fastotv::timestamp_t>(last_ts_ - start_ts_, 1) / 1000.0;
+  dumper::IDumper::annotations_t annotations;
+  for (const auto& element : elements_) {
+    const ElementSample& sample = *element.second;
+    const uint64_t proc_samples = sample.proc_samples;
+    std::ostringstream text;
+    text.precision(1);
+    text << std::fixed << "in " << sample.buffers_in / window_sec << "/s, out " << sample.buffers_out / window_sec
+         << "/s, " << sample.bytes_out * 8 / 1000 / window_sec << " kbps";
+    if (proc_samples) {
+      text << ", proctime " << sample.proc_time / proc_samples << " usec";
+    }
+    auto queue = queues_.find(element.first);
+    if (queue != queues_.end() && queue->second.samples) {
+      text << ", level avg " << queue->second.sum_level_time / queue->second.samples / GST_MSECOND << " ms, max "
+           << queue->second.max_level_time / GST_MSECOND << " ms";
+    }
+    annotations[element.first] = text.str();
+  }
+  return annotations;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,97 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gst/gst.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <common/file_system/path.h>
+
+#include <fastotv/types.h>
+
+#include "stream/dumpers/idumper.h"
+
+#define PROFILE_SAMPLE_MSEC 200
+#define PROFILE_MAX_DURATION_SEC 300
+
+namespace fastocloud {
+namespace stream {
+
+// samples of running pipeline for a time window: cpu of its threads (linux only), fill of its queues and
+// buffers of elements counted by pad probes (proctime as time from sink to src pad on same thread),
+// gstreamer tracers need GST_TRACERS before gst_init so they can't be turned on in running child
+class StreamProfiler {
+ public:
+  StreamProfiler(GstElement* pipeline, uint32_t duration_sec);
+  ~StreamProfiler();
+
+  bool Tick();  // sample, false when window elapsed
+  bool WriteReport(const common::file_system::ascii_file_string_path& path) const;
+  dumper::IDumper::annotations_t MakeAnnotations() const;  // for pipeline graph
+
+ private:
+  struct ElementSample {
+    ElementSample();
+
+    std::atomic<uint64_t> buffers_in;
+    std::atomic<uint64_t> buffers_out;
+    std::atomic<uint64_t> bytes_out;
+    std::atomic<uint64_t> proc_time;  // usec
+    std::atomic<uint64_t> proc_samples;
+    std::atomic<gint64> enter_ts;  // monotonic usec of last buffer on sink pad
+    std::atomic<gpointer> enter_thread;
+  };
+
+  struct ThreadSample {
+    std::string name;
+    uint64_t start_ticks;
+    uint64_t last_ticks;
+  };
+
+  struct QueueSample {
+    uint64_t samples;
+    guint64 sum_level_time;  // nsec
+    guint64 max_level_time;
+    guint max_level_buffers;
+    guint empty_samples;
+  };
+
+  void SampleThreads();
+  void SampleQueues();
+  void AddElementProbes();
+  std::string MakeElementLine(const ElementSample& sample) const;
+
+  static GstPadProbeReturn buffer_probe_callback(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+
+  GstElement* const pipeline_;
+  const uint32_t duration_sec_;
+  const fastotv::timestamp_t start_ts_;
+  fastotv::timestamp_t last_ts_;
+  uint64_t samples_;
+
+  std::map<long, ThreadSample> threads_;  // by tid
+  std::map<std::string, QueueSample> queues_;  // by element name
+  std::map<std::string, std::unique_ptr<ElementSample>> elements_;  // filled before probes added
+  std::vector<std::pair<GstPad*, gulong>> probes_;
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -15,6 +15,7 @@
 #include "stream/stream_server.h"
 
 #include "stream/commands_factory.h"
+#include "stream_commands/binary_protocol.h"
 #include "stream_commands/commands.h"
 
 namespace fastocloud {
@@ -22,15 +23,38 @@ namespace stream {
 
 StreamServer::StreamServer(fastotv::protocol::protocol_client_t* command_client,
                            common::libev::IoLoopObserver* observer)
-    : base_class(new common::libev::LibEvLoop, observer), command_client_(command_client) {
+    : base_class(new common::libev::LibEvLoop, observer),
+      command_client_(command_client),
+      binary_pipe_(false),
+      parked_(false) {
   CHECK(command_client);
 }
 
 void StreamServer::WriteRequest(const fastotv::protocol::request_t& request) {
-  auto cb = [this, request] { command_client_->WriteRequest(request); };
+  if (parked_) {  // pipe buffer would fill up and block loop until adopted
+    return;
+  }
+
+  auto cb = [this, request] { ignore_result(WritePipeRequest(command_client_, request, binary_pipe_)); };
   ExecInLoopThread(cb);
 }
 
+bool StreamServer::IsBinaryPipe() const {
+  return binary_pipe_;
+}
+
+void StreamServer::SetBinaryPipe(bool binary) {
+  binary_pipe_ = binary;
+}
+
+bool StreamServer::IsParked() const {
+  return parked_;
+}
+
+void StreamServer::SetParked(bool parked) {
+  parked_ = parked;
+}
+
 const char* StreamServer::ClassName() const {
   return "StreamServer";
 }
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include <common/libev/io_loop.h>
 
 #include <fastotv/protocol/protocol.h>
@@ -37,6 +39,12 @@ class StreamServer : public common::libev::IoLoop {
 
   void WriteRequest(const fastotv::protocol::request_t& request) WARN_UNUSED_RESULT;
 
+  bool IsBinaryPipe() const;
+  void SetBinaryPipe(bool binary);  // before loop started
+
+  bool IsParked() const;
+  void SetParked(bool parked);  // requests dropped while no daemon reads pipe
+
   const char* ClassName() const override;
 
   void SendChangeSourcesBroadcast(const ChangedSouresInfo& change) WARN_UNUSED_RESULT;
@@ -53,6 +61,8 @@ class StreamServer : public common::libev::IoLoop {
 
  private:
   fastotv::protocol::protocol_client_t* const command_client_;
+  bool binary_pipe_;
+  std::atomic<bool> parked_;
 };
 
 }  // namespace stream
@@ -14,57 +14,178 @@
 
 #include "stream/stream_wrapper.h"
 
+#if defined(OS_LINUX)
+#include <errno.h>
+#include <sched.h>
+#endif
+
+#include <mutex>
 #include <string>
 
+#include <glib.h>
+
 #include <common/file_system/string_path_utils.h>
+#include <common/time.h>
 
 #include "base/config_fields.h"
 #include "base/constants.h"
+#include "base/priority_class.h"
 
+#include "stream/ibase_stream.h"
+#include "stream/hot_log.h"
 #include "stream/stream_controller.h"
 
+#if defined(MACHINE_LEARNING)
+#include "base/machine_learning/inference_shm.h"
+
+#include "stream/inference_worker.h"
+#endif
+
 namespace {
 
 const size_t kMaxSizeLogFile = 1024 * 1024;
 
+// before any stream thread started, so all of them inherit mask
+void ApplyCpuAffinity(const fastocloud::StreamConfig& config_args) {
+  common::ArrayValue* cpus_list = nullptr;
+  common::Value* cpus_field = config_args->Find(ACTIVE_CPU_SET_FIELD);
+  if (!cpus_field || !cpus_field->GetAsList(&cpus_list) || !cpus_list->GetSize()) {
+    return;
+  }
+
+#if defined(OS_LINUX)
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (size_t i = 0; i < cpus_list->GetSize(); ++i) {
+    common::Value* item = nullptr;
+    int cpu;
+    if (cpus_list->Get(i, &item) && item->GetAsInteger(&cpu) && cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &mask);
+    }
+  }
+
+  if (sched_setaffinity(0, sizeof(mask), &mask) == ERROR_RESULT_VALUE) {
+    WARNING_LOG() << "Failed to set cpu affinity, errno: " << errno;
+  }
+#else
+#pragma message "Please implement"
+#endif
+}
+
+// same moment as affinity, hosted streams share scheduling of host process
+void ApplyPriority(const fastocloud::StreamConfig& config_args) {
+  int priority;
+  common::Value* priority_field = config_args->Find(ACTIVE_PRIORITY_CLASS_FIELD);
+  if (!priority_field || !priority_field->GetAsInteger(&priority) || !fastocloud::IsValidPriorityClass(priority)) {
+    return;
+  }
+
+#if defined(OS_LINUX)
+  if (!fastocloud::ApplyPriorityClass(static_cast<fastocloud::PriorityClass>(priority))) {
+    WARNING_LOG() << "Failed to apply priority class: " << priority << ", errno: " << errno;
+  }
+#else
+#pragma message "Please implement"
+#endif
+}
+
+// stages before controller, set by daemon and on entry of stream_exec
+void set_startup_timing(const fastocloud::StreamConfig& config_args,
+                        fastotv::timestamp_t exec_ts,
+                        fastocloud::StreamStruct* mem) {
+  double ts;
+  common::Value* request_ts_field = config_args->Find(ACTIVE_REQUEST_TS_FIELD);
+  if (request_ts_field && request_ts_field->GetAsDouble(&ts)) {
+    mem->startup[fastocloud::REQUEST_STARTUP_STAGE] = ts;
+  }
+  common::Value* fork_ts_field = config_args->Find(ACTIVE_FORK_TS_FIELD);
+  if (fork_ts_field && fork_ts_field->GetAsDouble(&ts)) {
+    mem->startup[fastocloud::FORK_STARTUP_STAGE] = ts;
+  }
+  mem->startup[fastocloud::EXEC_STARTUP_STAGE] = exec_ts;
+}
+
 int start_stream(const std::string& process_name,
                  const common::file_system::ascii_directory_string_path& feedback_dir,
                  const common::file_system::ascii_file_string_path& streamlink_path,
                  common::logging::LOG_LEVEL logs_level,
                  const fastocloud::StreamConfig& config_args,
                  fastotv::protocol::protocol_client_t* command_client,
-                 const fastocloud::StreamInfo& sha) {
+                 const fastocloud::StreamInfo& sha,
+                 fastotv::timestamp_t exec_ts) {
   auto log_file = feedback_dir.MakeFileStringPath(LOGS_FILE_NAME);
   if (log_file) {
     common::logging::INIT_LOGGER(process_name, log_file->GetPath(), logs_level,
                                  kMaxSizeLogFile);  // initialization of logging system
   }
+  fastocloud::stream::HotLogWriter& hot_log = fastocloud::stream::HotLogWriter::GetInstance();
+  hot_log.Start(logs_level);
   NOTICE_LOG() << "Running " PROJECT_VERSION_HUMAN;
+  ApplyCpuAffinity(config_args);
+  ApplyPriority(config_args);
 
   const std::unique_ptr<fastocloud::StreamStruct> mem(new fastocloud::StreamStruct(sha));
-  fastocloud::stream::StreamController proc(feedback_dir, streamlink_path, command_client, mem.get());
-  common::Error err = proc.Init(config_args);
-  if (err) {
-    WARNING_LOG() << err->GetDescription();
-    NOTICE_LOG() << "Quiting " PROJECT_VERSION_HUMAN;
-    return EXIT_FAILURE;
+  set_startup_timing(config_args, exec_ts, mem.get());
+  int res = EXIT_FAILURE;
+  {
+    fastocloud::stream::StreamController proc(feedback_dir, streamlink_path, command_client, mem.get());
+    common::Error err = proc.Init(config_args);
+    if (err) {
+      WARNING_LOG() << err->GetDescription();
+    } else {
+      res = proc.Exec();
+    }
   }
-
-  int res = proc.Exec();
+  // backend of process, streams of relay host share it
+  fastocloud::stream::streams_deinit();
+  hot_log.Stop();
   NOTICE_LOG() << "Quiting " PROJECT_VERSION_HUMAN;
   return res;
 }
 
-}  // namespace
+// logger and hot log writer belong to host process, pipeline sources attached to main context of thread
+int start_hosted_stream(const common::file_system::ascii_directory_string_path& feedback_dir,
+                        const common::file_system::ascii_file_string_path& streamlink_path,
+                        common::logging::LOG_LEVEL logs_level,
+                        const fastocloud::StreamConfig& config_args,
+                        fastotv::protocol::protocol_client_t* command_client,
+                        const fastocloud::StreamInfo& sha,
+                        fastotv::timestamp_t exec_ts) {
+  static std::once_flag hot_log_started;
+  std::call_once(hot_log_started,
+                 [logs_level]() { fastocloud::stream::HotLogWriter::GetInstance().Start(logs_level); });
+  NOTICE_LOG() << "Running hosted stream id: " << sha.id;
 
-int stream_exec(const char* process_name, const void* args, void* command_client) {
+  GMainContext* ctx = g_main_context_new();
+  g_main_context_push_thread_default(ctx);
+  int res = EXIT_FAILURE;
+  {
+    const std::unique_ptr<fastocloud::StreamStruct> mem(new fastocloud::StreamStruct(sha));
+    set_startup_timing(config_args, exec_ts, mem.get());
+    fastocloud::stream::StreamController proc(feedback_dir, streamlink_path, command_client, mem.get());
+    common::Error err = proc.Init(config_args);
+    if (err) {
+      WARNING_LOG() << err->GetDescription();
+    } else {
+      res = proc.Exec();
+    }
+  }
+  g_main_context_pop_thread_default(ctx);
+  g_main_context_unref(ctx);
+  NOTICE_LOG() << "Quiting hosted stream id: " << sha.id;
+  return res;
+}
+
+int exec_stream(const char* process_name, const void* args, void* command_client, bool hosted) {
+  const fastotv::timestamp_t exec_ts = common::time::current_utc_mstime();
   if (!process_name || !args || !command_client) {
     CRITICAL_LOG() << "Invalid arguments.";
     return EXIT_FAILURE;
   }
 
-  const common::HashValue* vargs = static_cast<const common::HashValue*>(args);
-  fastocloud::StreamConfig sargs(vargs->DeepCopy());
+  // args owned by caller until return, parsed once into typed config and not copied
+  common::HashValue* vargs = static_cast<common::HashValue*>(const_cast<void*>(args));
+  fastocloud::StreamConfig sargs(vargs, [](common::HashValue*) {});
   fastocloud::StreamInfo sha;
   std::string feedback_dir;
   common::logging::LOG_LEVEL logs_level;
@@ -87,6 +208,77 @@ int stream_exec(const char* process_name, const void* args, void* command_client
   }
 
   fastotv::protocol::protocol_client_t* client = static_cast<fastotv::protocol::protocol_client_t*>(command_client);
+  if (hosted) {
+    return start_hosted_stream(common::file_system::ascii_directory_string_path(feedback_dir),
+                               common::file_system::ascii_file_string_path(streamlink_path), logs_level, sargs, client,
+                               sha, exec_ts);
+  }
   return start_stream(process_name, common::file_system::ascii_directory_string_path(feedback_dir),
-                      common::file_system::ascii_file_string_path(streamlink_path), logs_level, sargs, client, sha);
+                      common::file_system::ascii_file_string_path(streamlink_path), logs_level, sargs, client, sha,
+                      exec_ts);
+}
+
+}  // namespace
+
+int stream_prepare(int argc, char** argv) {
+  fastocloud::stream::streams_init(argc, argv);
+  fastocloud::stream::streams_preload_plugins();
+  return EXIT_SUCCESS;
+}
+
+int stream_exec(const char* process_name, const void* args, void* command_client) {
+  return exec_stream(process_name, args, command_client, false);
+}
+
+int stream_exec_hosted(const char* process_name, const void* args, void* command_client) {
+  return exec_stream(process_name, args, command_client, true);
+}
+
+#if defined(MACHINE_LEARNING)
+int inference_exec(const char* process_name, const void* args) {
+  if (!process_name || !args) {
+    CRITICAL_LOG() << "Invalid arguments.";
+    return EXIT_FAILURE;
+  }
+
+  const common::HashValue* vargs = static_cast<const common::HashValue*>(args);
+  fastocloud::StreamConfig sargs(vargs->DeepCopy());
+  common::HashValue* learning_hash = nullptr;
+  common::Value* learning_field = sargs->Find(DEEP_LEARNING_FIELD);
+  if (!learning_field || !learning_field->GetAsHash(&learning_hash)) {
+    CRITICAL_LOG() << "Define " DEEP_LEARNING_FIELD " variable and make it valid";
+    return EXIT_FAILURE;
+  }
+
+  const auto learning = fastocloud::machine_learning::DeepLearning::MakeDeepLearning(learning_hash);
+  if (!learning) {
+    CRITICAL_LOG() << "Invalid " DEEP_LEARNING_FIELD " variable";
+    return EXIT_FAILURE;
+  }
+
+  std::string shm_name;
+  common::Value* shm_field = sargs->Find(ACTIVE_INFERENCE_SHM_FIELD);
+  if (!shm_field || !shm_field->GetAsBasicString(&shm_name)) {
+    CRITICAL_LOG() << "Define " ACTIVE_INFERENCE_SHM_FIELD " variable and make it valid";
+    return EXIT_FAILURE;
+  }
+
+  fastocloud::machine_learning::InferenceShm* shm = nullptr;
+  common::ErrnoError err = fastocloud::machine_learning::OpenInferenceShm(shm_name, &shm);
+  if (err) {
+    CRITICAL_LOG() << "Failed to open inference segment " << shm_name << ", error: " << err->GetDescription();
+    return EXIT_FAILURE;
+  }
+
+  NOTICE_LOG() << "Running " PROJECT_VERSION_HUMAN " inference worker " << process_name;
+  fastocloud::stream::streams_init(0, nullptr);
+  int res;
+  {
+    fastocloud::stream::InferenceWorker worker(*learning, shm);
+    res = worker.Exec();
+  }
+  ignore_result(fastocloud::machine_learning::CloseInferenceShm(shm));
+  NOTICE_LOG() << "Quiting " PROJECT_VERSION_HUMAN " inference worker";
+  return res;
 }
+#endif
@@ -14,4 +14,11 @@
 
 #pragma once
 
+extern "C" int stream_prepare(int argc, char** argv);
 extern "C" int stream_exec(const char* process_name, const void* args, void* command_client);
+// stream as thread of relay host process, caller thread runs it until stream quit
+extern "C" int stream_exec_hosted(const char* process_name, const void* args, void* command_client);
+#if defined(MACHINE_LEARNING)
+// args: deep learning config and segment name of it, process of daemon shared by streams of model
+extern "C" int inference_exec(const char* process_name, const void* args);
+#endif
@@ -0,0 +1,139 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/streaming_task_pool.h"
+
+#if defined(OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <atomic>
+
+#include <common/logger.h>
+#include <common/macros.h>
+
+#define STREAMING_TASK_POOL_IDLE_TIME_MSEC 60000
+
+namespace fastocloud {
+namespace stream {
+namespace {
+
+struct Task {
+  GstTaskPoolFunction func;
+  gpointer user_data;
+};
+
+std::atomic<size_t> g_tasks(0);
+GstTaskPool* g_pool = nullptr;
+std::vector<int> g_cpus;  // written before pool installed
+
+void pin_current_thread() {
+#if defined(OS_LINUX)
+  thread_local bool pinned = false;
+  if (pinned || g_cpus.empty()) {
+    return;
+  }
+
+  pinned = true;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : g_cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &mask);
+    }
+  }
+  if (pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) != 0) {
+    WARNING_LOG() << "Failed to set cpu affinity of streaming thread";
+  }
+#endif
+}
+
+void run_task(void* user_data) {
+  Task* task = static_cast<Task*>(user_data);
+  pin_current_thread();
+  g_tasks++;
+  task->func(task->user_data);
+  g_tasks--;
+  delete task;
+}
+
+typedef struct {
+  GstTaskPool parent;
+} StreamingTaskPool;
+
+typedef struct {
+  GstTaskPoolClass parent_class;
+} StreamingTaskPoolClass;
+
+G_DEFINE_TYPE(StreamingTaskPool, streaming_task_pool, GST_TYPE_TASK_POOL)
+
+// default pool runs function on shared GThreadPool without threads limit, unused threads kept up to process limit
+gpointer streaming_task_pool_push(GstTaskPool* pool, GstTaskPoolFunction func, gpointer user_data, GError** error) {
+  Task* task = new Task;
+  task->func = func;
+  task->user_data = user_data;
+  GError* err = nullptr;
+  gpointer id = GST_TASK_POOL_CLASS(streaming_task_pool_parent_class)->push(pool, run_task, task, &err);
+  if (err) {
+    delete task;
+    g_propagate_error(error, err);
+  }
+  return id;
+}
+
+void streaming_task_pool_class_init(StreamingTaskPoolClass* klass) {
+  GstTaskPoolClass* pool_class = GST_TASK_POOL_CLASS(klass);
+  pool_class->push = streaming_task_pool_push;
+}
+
+void streaming_task_pool_init(StreamingTaskPool* pool) {
+  UNUSED(pool);
+}
+
+}  // namespace
+
+bool install_streaming_task_pool(size_t idle_threads, const std::vector<int>& cpus) {
+  if (g_pool) {
+    return false;
+  }
+
+  g_cpus = cpus;
+  GstTaskPool* pool = GST_TASK_POOL(g_object_new(streaming_task_pool_get_type(), nullptr));
+  gst_object_ref_sink(pool);
+  GError* err = nullptr;
+  gst_task_pool_prepare(pool, &err);
+  if (err) {
+    WARNING_LOG() << "Failed to prepare streaming task pool: " << err->message;
+    g_error_free(err);
+    gst_object_unref(pool);
+    return false;
+  }
+
+  g_thread_pool_set_max_unused_threads(idle_threads);
+  g_thread_pool_set_max_idle_time(STREAMING_TASK_POOL_IDLE_TIME_MSEC);
+  g_pool = pool;
+  return true;
+}
+
+GstTaskPool* get_streaming_task_pool() {
+  return g_pool;
+}
+
+size_t get_streaming_tasks_count() {
+  return g_tasks;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
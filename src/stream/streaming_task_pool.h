@@ -0,0 +1,32 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gst/gst.h>
+
+#include <vector>
+
+namespace fastocloud {
+namespace stream {
+
+// process wide pool of streaming threads, set on every task of pipelines from sync bus handler, threads of stopped
+// tasks wait for next task instead of exit, so restarts and dynamic pads do not create threads, workers pinned to
+// cpus if not empty, task blocks its thread while running, so tasks are never queued behind each other
+bool install_streaming_task_pool(size_t idle_threads, const std::vector<int>& cpus);
+GstTaskPool* get_streaming_task_pool();  // nullptr if not installed
+size_t get_streaming_tasks_count();      // running tasks
+
+}  // namespace stream
+}  // namespace fastocloud
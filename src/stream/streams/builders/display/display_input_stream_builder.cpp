@@ -14,11 +14,17 @@
 
 #include "stream/streams/builders/display/display_input_stream_builder.h"
 
+#include <string>
+
+#include "base/input_uri.h"
+
 #include "stream/elements/element.h"  // for Element
 #include "stream/elements/sources/sources.h"
 
 #include "stream/pad/pad.h"  // for Pad
 
+#define PIPEWIRE_KEEPALIVE_MSEC 1000  // static screens still give encoder frame per second
+
 namespace fastocloud {
 namespace stream {
 namespace streams {
@@ -31,7 +37,24 @@ Connector DisplayInputStreamBuilder::BuildInput() {
   elements::Element* video = nullptr;
   const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
   if (config->HaveVideo()) {
-    video = elements::sources::make_sources<elements::sources::ElementDisplayTestSrc>(0);
+    const InputUri iuri = config->GetInput()[0];
+    if (IsPipeWireInputUrl(iuri)) {
+      // no copy from compositor, dma-buf imported by vaapipostproc of gpu encoders
+      elements::sources::ElementPipeWireSrc* pipewire =
+          elements::sources::make_sources<elements::sources::ElementPipeWireSrc>(0);
+      const std::string target = GetPipeWireTarget(iuri);
+      if (!target.empty()) {
+        pipewire->SetTargetObject(target);
+      }
+      pipewire->SetAlwaysCopy(false);
+      pipewire->SetKeepaliveTime(PIPEWIRE_KEEPALIVE_MSEC);
+      video = pipewire;
+    } else {
+      elements::sources::ElementDisplayTestSrc* display =
+          elements::sources::make_sources<elements::sources::ElementDisplayTestSrc>(0);
+      display->SetUseDamage(true);
+      video = display;
+    }
     ElementAdd(video);
     pad::Pad* src_pad = video->StaticPad("src");
     if (src_pad->IsValid()) {
@@ -32,6 +32,10 @@ namespace streams {
 namespace builders {
 namespace encoding {
 
+namespace {
+const int kV4L2IoModeDmabuf = 4;
+}
+
 DeviceStreamBuilder::DeviceStreamBuilder(const EncodeConfig* api, SrcDecodeBinStream* observer)
     : EncodingStreamBuilder(api, observer) {}
 
@@ -45,6 +49,13 @@ Connector DeviceStreamBuilder::BuildInput() {
   if (config->HaveVideo()) {
     elements::sources::ElementV4L2Src* v4l = elements::sources::make_v4l2_src(dpath.GetPath(), 0);
     v4l->SetProperty("do-timestamp", true);
+    const v4l2_io_mode_t io_mode = config->GetV4L2IoMode();
+    if (io_mode) {
+      v4l->SetIoMode(*io_mode);
+    } else if (config->IsGpu()) {
+      // exported driver buffers imported by vaapi/msdk post proc, raw frame is not copied into system memory
+      v4l->SetIoMode(kV4L2IoModeDmabuf);
+    }
     video = v4l;
     ElementAdd(video);
     pad::Pad* src_pad = video->StaticPad("src");
@@ -67,6 +78,7 @@ Connector DeviceStreamBuilder::BuildInput() {
 
     elements::ElementDecodebin* decodebin = new elements::ElementDecodebin(common::MemSPrintf(DECODEBIN_NAME_1U, 0));
     ElementAdd(decodebin);
+    RegisterElement(DECODEBIN_ROLE, 0, decodebin);
     ElementLink(video, decodebin);
     HandleDecodebinCreated(decodebin);
     video = decodebin;
@@ -95,6 +107,7 @@ Connector DeviceStreamBuilder::BuildInput() {
 
     elements::ElementDecodebin* decodebin = new elements::ElementDecodebin(common::MemSPrintf(DECODEBIN_NAME_1U, 1));
     ElementAdd(decodebin);
+    RegisterElement(DECODEBIN_ROLE, 1, decodebin);
     ElementLink(audio, decodebin);
     HandleDecodebinCreated(decodebin);
     audio = decodebin;
@@ -102,6 +115,10 @@ Connector DeviceStreamBuilder::BuildInput() {
   return {nullptr, nullptr, nullptr};
 }
 
+bool DeviceStreamBuilder::IsPassthroughAvailable() const {
+  return false;
+}
+
 }  // namespace encoding
 }  // namespace builders
 }  // namespace streams
@@ -27,6 +27,9 @@ class DeviceStreamBuilder : public EncodingStreamBuilder {
   enum { VIDEO_WIDTH = 1280, VIDEO_HEIGHT = 720 };
   DeviceStreamBuilder(const EncodeConfig* api, SrcDecodeBinStream* observer);
   Connector BuildInput() override;
+
+ protected:
+  bool IsPassthroughAvailable() const override;  // capture devices produce raw frames
 };
 
 }  // namespace encoding
@@ -14,6 +14,9 @@
 
 #include "stream/streams/builders/encoding/encoding_stream_builder.h"
 
+#include <gst/video/video.h>
+
+#include <sstream>
 #include <string>
 
 #include <common/file_system/file_system.h>
@@ -21,36 +24,250 @@
 
 #include "base/constants.h"
 
+#include "stream/asset_cache.h"
 #include "stream/elements/audio/audio.h"
 #if defined(MACHINE_LEARNING)
-#include <fastoml/gst/gstbackend.h>
 #include "stream/elements/machine_learning/detectionoverlay.h"
+#include "stream/elements/machine_learning/inference_gate.h"
+#include "stream/elements/machine_learning/inference_sink.h"
 #include "stream/elements/machine_learning/tinyyolov2.h"
 #include "stream/elements/machine_learning/tinyyolov3.h"
-#include "stream/gstreamer_utils.h"
-#include "stream/streams/encoding/encoding_stream.h"
 #endif
 #include "stream/elements/encoders/audio.h"
 #include "stream/elements/encoders/video.h"
 #include "stream/elements/parser/audio.h"
 #include "stream/elements/parser/video.h"
+#include "stream/elements/sink/fake.h"
+#include "stream/elements/sink/http.h"
 #include "stream/elements/sink/screen.h"
+#include "stream/elements/sink/srt.h"
 #include "stream/elements/video/video.h"
+#include "stream/elements_pool.h"
+#include "stream/gstreamer_utils.h"
 
 #include "stream/pad/pad.h"
+#include "stream/streams/encoding/encoding_stream.h"
 
 namespace fastocloud {
 namespace stream {
 namespace streams {
 namespace builders {
 
+namespace {
+
+// frames can stay in CUDA memory up to the encoder only if no software filter is required
+bool can_use_cuda_post_proc(const EncodeConfig* conf) {
+  if (!conf->IsNvGpu()) {
+    return false;
+  }
+
+  const auto deinterlace = conf->GetDeinterlace();
+  if (deinterlace && *deinterlace) {
+    return false;
+  }
+
+  if (conf->GetFramerate() || conf->GetAspectRatio() || conf->GetLogo() || conf->GetRSVGLogo()) {
+    return false;
+  }
+
+#if defined(MACHINE_LEARNING)
+  if (conf->GetDeepLearning() || conf->GetDeepLearningOverlay()) {
+    return false;
+  }
+#endif
+
+  return is_element_available(elements::video::ElementCudaUpload::GetPluginName()) &&
+         is_element_available(elements::video::ElementCudaConvert::GetPluginName()) &&
+         is_element_available(elements::video::ElementCudaScale::GetPluginName());
+}
+
+// input h264 can be muxed as is only if nothing is drawn or converted on frames
+bool can_passthrough_video(const EncodeConfig* conf) {
+  if (!elements::encoders::IsH264Encoder(conf->GetVideoEncoder()) || !conf->GetRenditions().empty()) {
+    return false;
+  }
+
+  const auto deinterlace = conf->GetDeinterlace();
+  if (deinterlace && *deinterlace) {
+    return false;
+  }
+
+  if (conf->GetFramerate() || conf->GetAspectRatio() || conf->GetLogo() || conf->GetRSVGLogo()) {
+    return false;
+  }
+
+#if defined(MACHINE_LEARNING)
+  if (conf->GetDeepLearning() || conf->GetDeepLearningOverlay()) {
+    return false;
+  }
+#endif
+  return true;
+}
+
+// aac and mp3 of input muxed as is if level not changed, mostly radio
+bool can_passthrough_audio(const EncodeConfig* conf) {
+  const std::string encoder = conf->GetAudioEncoder();
+  return (elements::encoders::IsAACEncoder(encoder) || elements::encoders::IsMP3Encoder(encoder)) &&
+         !conf->GetVolume() && !conf->GetLoudnessTarget();
+}
+
+// hls segment length in seconds, keyframes placed on segment boundaries
+int get_segment_duration(const EncodeConfig* conf) {
+  return conf->GetLowLatency() ? LOW_LATENCY_TS_DURATION : TS_DURATION;
+}
+
+// everything what sets properties of video encoder, parked encoder reused only with same key
+std::string make_video_encoder_pool_key(const EncodeConfig* conf,
+                                        bit_rate_t video_bitrate,
+                                        element_id_t video_id,
+                                        bool align_keyframes) {
+  std::ostringstream key;
+  key << conf->GetVideoEncoder() << "/" << video_id << "/" << (video_bitrate ? *video_bitrate : -1);
+  for (const auto& arg : conf->GetVideoEncoderArgs()) {
+    key << "/" << arg.first << "=" << arg.second;
+  }
+  for (const auto& arg : conf->GetVideoEncoderStrArgs()) {
+    key << "/" << arg.first << "=" << arg.second;
+  }
+  const auto gpu_device = conf->GetGpuDevice();
+  const auto framerate = conf->GetFramerate();
+  key << "/" << (gpu_device && conf->IsNvGpu() ? *gpu_device : -1) << "/" << conf->GetLowLatency() << "/"
+      << align_keyframes << "/" << (framerate ? *framerate : 0);
+  return key.str();
+}
+
+// forces idr in all renditions on same pts, boundaries match hls segments
+struct KeyframeClock {
+  explicit KeyframeClock(GstClockTime interval) : interval(interval), next(GST_CLOCK_TIME_NONE), count(0) {}
+
+  const GstClockTime interval;
+  GstClockTime next;
+  guint count;
+};
+
+GstPadProbeReturn keyframe_clock_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  KeyframeClock* clock = static_cast<KeyframeClock*>(user_data);
+  GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  const GstClockTime pts = GST_BUFFER_PTS(buffer);
+  if (!GST_CLOCK_TIME_IS_VALID(pts)) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  // first frame is keyframe anyway, also resync after pts jumped back
+  if (!GST_CLOCK_TIME_IS_VALID(clock->next) || pts + clock->interval < clock->next) {
+    clock->next = (pts / clock->interval + 1) * clock->interval;
+    return GST_PAD_PROBE_OK;
+  }
+
+  if (pts < clock->next) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  while (clock->next <= pts) {
+    clock->next += clock->interval;
+  }
+  // serialized, reaches encoder of every rendition before this frame
+  GstEvent* event = gst_video_event_new_downstream_force_key_unit(pts, GST_CLOCK_TIME_NONE, GST_CLOCK_TIME_NONE, TRUE,
+                                                                   clock->count++);
+  if (GST_PAD_IS_SINK(pad)) {
+    gst_pad_send_event(pad, event);
+  } else {
+    gst_pad_push_event(pad, event);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+void destroy_keyframe_clock(gpointer user_data) {
+  delete static_cast<KeyframeClock*>(user_data);
+}
+
+}  // namespace
+
 EncodingStreamBuilder::EncodingStreamBuilder(const EncodeConfig* api, SrcDecodeBinStream* observer)
-    : SrcDecodeStreamBuilder(api, observer) {}
+    : SrcDecodeStreamBuilder(api, observer),
+      rendition_tees_(),
+      align_keyframes_(false),
+      video_passthrough_(nullptr),
+      audio_passthrough_(nullptr) {}
+
+Connector EncodingStreamBuilder::BuildUdbConnections(Connector conn) {
+  conn = SrcDecodeStreamBuilder::BuildUdbConnections(conn);
+  if (!IsPassthroughAvailable()) {
+    return conn;
+  }
+
+  // decodebin decides which branch gets data when input caps are known, see EncodingStream
+  const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  if (config->HaveVideo() && can_passthrough_video(config)) {
+    video_passthrough_ = BuildQueue(common::MemSPrintf(UDB_VIDEO_PASSTHROUGH_NAME_1U, 0));
+    ElementAdd(video_passthrough_);
+    RegisterElement(UDB_VIDEO_PASSTHROUGH_ROLE, 0, video_passthrough_);
+  }
+  if (config->HaveAudio() && can_passthrough_audio(config)) {
+    audio_passthrough_ = BuildQueue(common::MemSPrintf(UDB_AUDIO_PASSTHROUGH_NAME_1U, 0));
+    ElementAdd(audio_passthrough_);
+    RegisterElement(UDB_AUDIO_PASSTHROUGH_ROLE, 0, audio_passthrough_);
+  }
+
+  EncodingStream* stream = static_cast<EncodingStream*>(GetObserver());
+  if (stream) {
+    stream->OnPassthroughBranchesCreated(video_passthrough_ != nullptr, audio_passthrough_ != nullptr);
+  }
+  return conn;
+}
+
+elements::Element* EncodingStreamBuilder::BuildAudioTrack(element_id_t track_id) {
+  const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  if (config->GetRelayAudio() || IsPassthroughAvailable()) {  // tracks of decodebin stay encoded
+    return nullptr;
+  }
+
+  elements::ElementQueue* audb = BuildQueue(common::MemSPrintf(UDB_AUDIO_NAME_1U, track_id));
+  ElementAdd(audb);
+  RegisterElement(UDB_AUDIO_ROLE, track_id, audb);
+  elements::Element* last = audb;
+  const elements_line_t post_line = BuildAudioPostProc(track_id);
+  if (!post_line.empty()) {
+    ElementLink(last, post_line.front());
+    last = post_line.back();
+  }
+
+  const elements_line_t encoder_line = BuildAudioConverter(track_id);
+  if (!encoder_line.empty()) {
+    ElementLink(last, encoder_line.front());
+    last = encoder_line.back();
+  }
+
+  if (elements::encoders::IsAACEncoder(config->GetAudioEncoder())) {
+    elements::parser::ElementAACParse* premux_parser = elements::parser::make_aac_parser(track_id);
+    ElementAdd(premux_parser);
+    ElementLink(last, premux_parser);
+    last = premux_parser;
+  }
+
+  elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(AUDIO_TEE_NAME_1U, track_id));
+  ElementAdd(tee);
+  ElementLink(last, tee);
+  return tee;
+}
+
+bool EncodingStreamBuilder::IsPassthroughAvailable() const {
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  return conf->GetPassthrough() && !conf->GetRelayVideo() && !conf->GetRelayAudio();
+}
 
 Connector EncodingStreamBuilder::BuildPostProc(Connector conn) {
   const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
 
   if (config->HaveVideo()) {
+    if (!config->GetRelayVideo()) {  // black and freeze of decoded video in stats
+      pad::Pad* meter_pad = conn.video->StaticPad("src");
+      if (meter_pad->IsValid()) {
+        HandleVideoMeterPadCreated(meter_pad, 0);
+      }
+      delete meter_pad;
+    }
+
     elements_line_t video_post_line = BuildVideoPostProc(0);
     if (!video_post_line.empty()) {
       ElementLink(conn.video, video_post_line.front());
@@ -59,6 +276,14 @@ Connector EncodingStreamBuilder::BuildPostProc(Connector conn) {
   }
 
   if (config->HaveAudio()) {
+    if (!config->GetRelayAudio()) {  // decoded audio levels in stats
+      pad::Pad* meter_pad = conn.audio->StaticPad("src");
+      if (meter_pad->IsValid()) {
+        HandleAudioMeterPadCreated(meter_pad, 0);
+      }
+      delete meter_pad;
+    }
+
     elements_line_t audio_post_line = BuildAudioPostProc(0);
     if (!audio_post_line.empty()) {
       ElementLink(conn.audio, audio_post_line.front());
@@ -78,6 +303,8 @@ SupportedVideoCodec EncodingStreamBuilder::GetVideoCodecType() const {
     return VIDEO_H265_CODEC;
   } else if (vcodec == elements::encoders::ElementMPEG2Enc::GetPluginName()) {
     return VIDEO_MPEG_CODEC;
+  } else if (elements::encoders::IsAV1Encoder(vcodec)) {
+    return VIDEO_AV1_CODEC;
   }
 
   NOTREACHED();
@@ -100,24 +327,57 @@ SupportedAudioCodec EncodingStreamBuilder::GetAudioCodecType() const {
 Connector EncodingStreamBuilder::BuildConverter(Connector conn) {
   const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
   if (config->HaveVideo()) {
-    elements_line_t video_encoder = BuildVideoConverter(0);
-    if (!video_encoder.empty()) {
-      ElementLink(conn.video, video_encoder.front());
-      conn.video = video_encoder.back();
-    }
+    const EncodeConfig::renditions_t renditions = config->GetRenditions();
+    if (renditions.empty()) {
+      elements_line_t video_encoder = BuildVideoConverter(0);
+      conn.video = BuildVideoEncodeBranch(conn.video, video_encoder, 0);
+    } else {
+      // decoded once, each rendition scaled and encoded in own branch
+      elements::ElementTee* ladder = new elements::ElementTee(common::MemSPrintf(RENDITION_TEE_NAME_1U, 0));
+      ElementAdd(ladder);
+      ElementLink(conn.video, ladder);
+      pad::Pad* ladder_pad = ladder->StaticPad("sink");
+      if (ladder_pad->IsValid()) {
+        gst_pad_add_probe(ladder_pad->GetGstPad(), GST_PAD_PROBE_TYPE_BUFFER, keyframe_clock_probe,
+                          new KeyframeClock(get_segment_duration(config) * GST_SECOND), destroy_keyframe_clock);
+      }
+      delete ladder_pad;
+      align_keyframes_ = true;
+
+      elements::Element* first_rendition = nullptr;
+      for (size_t i = 0; i < renditions.size(); ++i) {
+        const Rendition& rendition = renditions[i];
+        const element_id_t rendition_id = i + 1;
+        elements::ElementQueue* queue = BuildQueue(common::MemSPrintf(RENDITION_QUEUE_NAME_1U, rendition_id));
+        ElementAdd(queue);
+        ElementLink(ladder, queue);
+        elements::Element* scaled = BuildVideoScale(queue, rendition.size, rendition_id);
+        const bit_rate_t video_bitrate = rendition.video_bitrate ? rendition.video_bitrate : config->GetVideoBitrate();
+        elements_line_t video_encoder = BuildVideoEncoder(video_bitrate, rendition_id);
+        elements::Element* rendition_tee = BuildVideoEncodeBranch(scaled, video_encoder, rendition_id);
+        rendition_tees_[rendition.output_id] = rendition_tee;
+        if (!first_rendition) {
+          first_rendition = rendition_tee;
+        }
+      }
 
-    const std::string vcodec = config->GetVideoEncoder();
-    if (elements::encoders::IsH264Encoder(vcodec)) {
-      elements::parser::ElementH264Parse* premux_parser = elements::parser::make_h264_parser(0);
-      ElementAdd(premux_parser);
-      ElementLink(conn.video, premux_parser);
-      conn.video = premux_parser;
-    }
+      bool need_main = false;
+      for (const OutputUri& output : config->GetOutput()) {
+        if (rendition_tees_.find(output.GetID()) == rendition_tees_.end()) {
+          need_main = true;
+          break;
+        }
+      }
 
-    elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(VIDEO_TEE_NAME_1U, 0));
-    ElementAdd(tee);
-    ElementLink(conn.video, tee);
-    conn.video = tee;
+      conn.video = first_rendition;
+      if (need_main) {
+        elements::ElementQueue* queue = BuildQueue(common::MemSPrintf(RENDITION_QUEUE_NAME_1U, 0));
+        ElementAdd(queue);
+        ElementLink(ladder, queue);
+        elements_line_t video_encoder = BuildVideoConverter(0);
+        conn.video = BuildVideoEncodeBranch(queue, video_encoder, 0);
+      }
+    }
   }
 
   if (config->HaveAudio()) {
@@ -125,6 +385,13 @@ Connector EncodingStreamBuilder::BuildConverter(Connector conn) {
     if (!audio_encoder_line.empty()) {
       ElementLink(conn.audio, audio_encoder_line.front());
       conn.audio = audio_encoder_line.back();
+      if (audio_passthrough_) {
+        elements::ElementFunnel* funnel = new elements::ElementFunnel(common::MemSPrintf(AUDIO_FUNNEL_NAME_1U, 0));
+        ElementAdd(funnel);
+        ElementLink(conn.audio, funnel);
+        ElementLink(audio_passthrough_, funnel);
+        conn.audio = funnel;
+      }
     }
 
     const std::string acodec = config->GetAudioEncoder();
@@ -137,12 +404,46 @@ Connector EncodingStreamBuilder::BuildConverter(Connector conn) {
 
     elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(AUDIO_TEE_NAME_1U, 0));
     ElementAdd(tee);
+    RegisterElement(AUDIO_TEE_ROLE, 0, tee);
     ElementLink(conn.audio, tee);
     conn.audio = tee;
   }
   return conn;
 }
 
+elements::Element* EncodingStreamBuilder::BuildVideoScale(elements::Element* src,
+                                                          const common::draw::Size& size,
+                                                          element_id_t video_id) {
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  if (conf->IsGpu()) {
+    elements::Element* post = nullptr;
+    if (conf->IsMfxGpu()) {
+      elements::ElementMFXVpp* mfx = new elements::ElementMFXVpp(common::MemSPrintf(POST_PROC_NAME_1U, video_id));
+      mfx->SetForceAspectRatio(false);
+      mfx->SetWidth(size.width);
+      mfx->SetHeight(size.height);
+      post = mfx;
+    } else {
+      elements::ElementVaapiPostProc* vaapi =
+          new elements::ElementVaapiPostProc(common::MemSPrintf(POST_PROC_NAME_1U, video_id));
+      vaapi->SetForceAspectRatio(false);
+      vaapi->SetWidth(size.width);
+      vaapi->SetHeight(size.height);
+      post = vaapi;
+    }
+    ElementAdd(post);
+    ElementLink(src, post);
+    return post;
+  }
+
+  if (can_use_cuda_post_proc(conf)) {
+    return elements::encoders::build_cuda_video_scale(size.width, size.height, conf->GetGpuDevice(), this, src,
+                                                      video_id);
+  }
+
+  return elements::encoders::build_video_scale(size.width, size.height, this, src, video_id);
+}
+
 elements_line_t EncodingStreamBuilder::BuildVideoPostProc(element_id_t video_id) {
   const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
   elements::Element* first = nullptr;
@@ -161,24 +462,33 @@ elements_line_t EncodingStreamBuilder::BuildVideoPostProc(element_id_t video_id)
       if (framerate) {
         post->SetFrameRate(*framerate);
       }
-      if (conf->GetDeinterlace()) {
-        post->SetDinterlaceMode(1);
-      }
+      // deinterlace mode set by stream on caps of decoded video
       first = post;
       last = post;
     } else {
       elements::ElementVaapiPostProc* post =
           new elements::ElementVaapiPostProc(common::MemSPrintf(POST_PROC_NAME_1U, video_id));
-      if (!conf->GetDeinterlace()) {
-        post->SetDinterlaceMode(2);  // (2): disabled - Never deinterlace
-      }
+      post->SetDinterlaceMode(2);  // (2): disabled - Never deinterlace, auto on caps of interlaced video
       post->SetFormat(2);  // GST_VIDEO_FORMAT_I420
       post->SetForceAspectRatio(false);
+      if (size.IsValid()) {
+        post->SetWidth(size.width);
+        post->SetHeight(size.height);
+      }
       first = post;
       last = post;
     }
 
     ElementAdd(first);
+  } else if (can_use_cuda_post_proc(conf)) {
+    elements_line_t first_last = elements::encoders::build_cuda_video_convert(conf->GetGpuDevice(), this, video_id);
+    first = first_last.front();
+    last = first_last.back();
+
+    if (size.IsValid()) {
+      last = elements::encoders::build_cuda_video_scale(size.width, size.height, conf->GetGpuDevice(), this, last,
+                                                        video_id);
+    }
   } else {
     elements_line_t first_last = elements::encoders::build_video_convert(conf->GetDeinterlace(), this, video_id);
     first = first_last.front();
@@ -205,31 +515,78 @@ elements_line_t EncodingStreamBuilder::BuildVideoPostProc(element_id_t video_id)
 
 #if defined(MACHINE_LEARNING)
   const auto deep_learning = conf->GetDeepLearning();
-  if (deep_learning) {
+  elements::machine_learning::ElementInferenceSink* shared_sink = nullptr;
+  if (deep_learning && deep_learning->IsShared() && !conf->GetInferenceShm().empty()) {
+    shared_sink = new elements::machine_learning::ElementInferenceSink(common::MemSPrintf("ml_sink_%lu", video_id));
+    if (!shared_sink->SetInference(conf->GetInferenceShm(), video_id, deep_learning->GetInferenceInterval(),
+                                   deep_learning->GetInferenceRate())) {
+      WARNING_LOG() << "Shared inference not available, model loaded by stream";
+      gst_object_unref(shared_sink->GetGstElement());
+      delete shared_sink;
+      shared_sink = nullptr;
+    }
+  }
+
+  if (shared_sink) {  // frames scaled to model input and answered by inference worker of daemon
+    HandleInferenceSinkCreated(shared_sink);
+    elements::ElementQueue* main_queue = nullptr;
+    elements::ElementQueue* infer_queue = nullptr;
+    BuildInferenceTee(last, video_id, &main_queue, &infer_queue);
+    elements::video::ElementVideoConvert* ml_convert =
+        new elements::video::ElementVideoConvert(common::MemSPrintf("ml_convert_%lu", video_id));
+    elements::video::ElementVideoScale* ml_scale =
+        new elements::video::ElementVideoScale(common::MemSPrintf("ml_scale_%lu", video_id));
+    elements::ElementCapsFilter* ml_caps =
+        new elements::ElementCapsFilter(common::MemSPrintf("ml_caps_%lu", video_id));
+    GstCaps* caps = gst_caps_new_simple("video/x-raw", "format", G_TYPE_STRING, "RGB", "width", G_TYPE_INT,
+                                        INFERENCE_SHM_FRAME_WIDTH, "height", G_TYPE_INT, INFERENCE_SHM_FRAME_HEIGHT,
+                                        nullptr);
+    ml_caps->SetCaps(caps);
+    gst_caps_unref(caps);
+    shared_sink->SetSync(false);
+    shared_sink->SetProperty("async", false);
+    ElementAdd(ml_convert);
+    ElementAdd(ml_scale);
+    ElementAdd(ml_caps);
+    ElementAdd(shared_sink);
+    ElementLink(infer_queue, ml_convert);
+    ElementLink(ml_convert, ml_scale);
+    ElementLink(ml_scale, ml_caps);
+    ElementLink(ml_caps, shared_sink);
+    last = main_queue;
+  } else if (deep_learning) {
     elements::machine_learning::ElementVideoMLFilter* tiny =
         new elements::machine_learning::ElementTinyYolov2(common::MemSPrintf("tiny_%lu", video_id));
-    HandleMLElementCreated(tiny);
-    fastoml::SupportedBackends backend_code = deep_learning->GetBackend();
-    GstBackend* backend = gst_backend_new(backend_code);
+    fastoml::SupportedBackends chosen;
+    GstBackend* backend = elements::machine_learning::make_backend(*deep_learning, &chosen);
     CHECK(backend) << "Can't allocate ML backend: ";
-    const std::string model_path_str = deep_learning->GetModelPath().GetPath();
-    GValue model = make_gvalue(model_path_str);
-    g_object_set_property(G_OBJECT(backend), "model", &model);
-    g_value_unset(&model);
-    for (auto prop : deep_learning->GetProperties()) {
-      GValue value = make_gvalue(prop.value);
-      g_object_set_property(G_OBJECT(backend), prop.property.c_str(), &value);
-      g_value_unset(&value);
-    }
+    HandleMLElementCreated(tiny, chosen);
     tiny->SetBackend(backend);
 
     ElementAdd(tiny);
-    ElementLink(last, tiny);
-    last = tiny;
+    if (deep_learning->IsInferenceScheduled()) {  // frames between inferences bypass ml filter
+      elements::ElementQueue* main_queue = nullptr;
+      elements::ElementQueue* infer_queue = nullptr;
+      BuildInferenceTee(last, video_id, &main_queue, &infer_queue);
+      elements::sink::ElementFakeSink* infer_sink =
+          new elements::sink::ElementFakeSink(common::MemSPrintf("ml_sink_%lu", video_id));
+      infer_sink->SetSync(false);
+      infer_sink->SetProperty("async", false);
+      ElementAdd(infer_sink);
+      ElementLink(infer_queue, tiny);
+      ElementLink(tiny, infer_sink);
+      elements::machine_learning::attach_inference_gate(infer_queue, infer_sink, main_queue,
+                                                        deep_learning->GetInferenceInterval(),
+                                                        deep_learning->GetInferenceRate());
+      last = main_queue;
+    } else {
+      ElementLink(last, tiny);
+      last = tiny;
+    }
   }
 
   const auto deep_learning_overlay = conf->GetDeepLearningOverlay();
-  if (deep_learning_overlay) {
+  if (deep_learning_overlay && !conf->GetDeepLearningMetadata()) {  // players draw boxes sent as metadata
     elements::machine_learning::ElementDetectionOverlay* detection =
         new elements::machine_learning::ElementDetectionOverlay(common::MemSPrintf("detection_%lu", video_id));
     const auto labels_path = deep_learning_overlay->GetLabelsPath();
@@ -243,6 +600,7 @@ elements_line_t EncodingStreamBuilder::BuildVideoPostProc(element_id_t video_id)
   }
 #endif
 
+  const auto assets_dir = conf->GetAssetsDir();
   const auto logo = conf->GetLogo();
   if (logo) {
     common::uri::Url logo_uri = logo->GetPath();
@@ -250,19 +608,25 @@ elements_line_t EncodingStreamBuilder::BuildVideoPostProc(element_id_t video_id)
     alpha_t alpha = logo->GetAlpha();
     elements::video::ElementGDKPixBufOverlay* videologo =
         new elements::video::ElementGDKPixBufOverlay(common::MemSPrintf(VIDEO_LOGO_NAME_1U, video_id));
+    auto size = logo->GetSize();
     common::uri::Url::scheme scheme = logo_uri.GetScheme();
+    std::string cached_path;
     if (scheme == common::uri::Url::file) {
       common::uri::Upath upath = logo_uri.GetPath();
       std::string path = upath.GetPath();
-      videologo->SetLocation(path);
+      if (assets_dir && AssetCache(*assets_dir).GetPicture(path, size ? size->width : 0, size ? size->height : 0,
+                                                           &cached_path)) {
+        videologo->SetLocation(cached_path);  // already at overlay size
+      } else {
+        videologo->SetLocation(path);
+      }
     } else {
       NOTREACHED();
     }
     videologo->SetOffsetX(logo_point.x);
     videologo->SetOffsetY(logo_point.y);
     videologo->SetAlpha(alpha);
-    auto size = logo->GetSize();
-    if (size) {
+    if (size && cached_path.empty()) {
       common::draw::Size sz = *size;
       videologo->SetOverlayHeight(sz.height);
       videologo->SetOverlayWidth(sz.width);
@@ -273,7 +637,28 @@ elements_line_t EncodingStreamBuilder::BuildVideoPostProc(element_id_t video_id)
   }
 
   const auto rsvg_logo = conf->GetRSVGLogo();
-  if (rsvg_logo) {
+  bool rsvg_logo_rasterized = false;
+  if (rsvg_logo && assets_dir && rsvg_logo->GetPath().GetScheme() == common::uri::Url::file) {
+    const std::string svg_path = rsvg_logo->GetPath().GetPath().GetPath();
+    auto size = rsvg_logo->GetSize();
+    std::string png_path;
+    if (AssetCache(*assets_dir).GetPicture(svg_path, size ? size->width : 0, size ? size->height : 0, &png_path)) {
+      common::draw::Point logo_point = rsvg_logo->GetPosition();
+      elements::video::ElementGDKPixBufOverlay* videologo =
+          new elements::video::ElementGDKPixBufOverlay(common::MemSPrintf(RSVG_VIDEO_LOGO_NAME_1U, video_id));
+      videologo->SetLocation(png_path);
+      videologo->SetOffsetX(logo_point.x);
+      videologo->SetOffsetY(logo_point.y);
+      ElementAdd(videologo);
+      ElementLink(last, videologo);
+      last = videologo;
+      rsvg_logo_rasterized = true;
+    } else {
+      WARNING_LOG() << "Rasterize svg logo failed, rendered per frame: " << svg_path;
+    }
+  }
+
+  if (rsvg_logo && !rsvg_logo_rasterized) {
     common::uri::Url logo_uri = rsvg_logo->GetPath();
     common::draw::Point logo_point = rsvg_logo->GetPosition();
     elements::video::ElementRSVGOverlay* rvideologo =
@@ -311,22 +696,198 @@ elements_line_t EncodingStreamBuilder::BuildVideoPostProc(element_id_t video_id)
 elements_line_t EncodingStreamBuilder::BuildAudioPostProc(element_id_t audio_id) {
   const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
 
-  const auto volume = conf->GetVolume();
+  auto volume = conf->GetVolume();
+  if (!volume && conf->GetLoudnessTarget() && audio_id == 0) {  // gain of main audio set by stream
+    volume = 1.0;
+  }
   const auto achannels = conf->GetAudioChannelsCount();
-  elements_line_t first_last = elements::encoders::build_audio_converters(volume, achannels, this, audio_id);
+  const bool dithering = conf->GetAudioDithering();
+  elements_line_t first_last = elements::encoders::build_audio_converters(volume, achannels, dithering, this, audio_id);
   return first_last;
 }
 
 elements_line_t EncodingStreamBuilder::BuildVideoConverter(element_id_t video_id) {
   const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  return BuildVideoEncoder(conf->GetVideoBitrate(), video_id);
+}
+
+elements_line_t EncodingStreamBuilder::BuildVideoEncoder(bit_rate_t video_bitrate, element_id_t video_id) {
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  const bool pooled = elements::encoders::is_hardware_video_encoder(conf->GetVideoEncoder());
+  std::string pool_key;
+  GstElement* parked_encoder = nullptr;
+  if (pooled) {
+    pool_key = make_video_encoder_pool_key(conf, video_bitrate, video_id, align_keyframes_);
+    parked_encoder = ElementsPool::GetInstance().Acquire(pool_key);
+    if (parked_encoder) {
+      INFO_LOG() << "Reused parked video encoder: " << conf->GetVideoEncoder() << " id: " << video_id;
+    }
+  }
+
+  const auto gpu_device = conf->GetGpuDevice();
+  if (!parked_encoder && gpu_device && conf->IsNvGpu()) {
+    const std::string device_factory = get_cuda_device_factory(conf->GetVideoEncoder(), *gpu_device);
+    if (!device_factory.empty()) {  // wrapped as default factory, same properties
+      parked_encoder = make_element_safe(device_factory, common::MemSPrintf(VIDEO_CODEC_NAME_1U, video_id));
+    }
+  }
 
-  const auto video_bitrate = conf->GetVideoBitrate();
   elements_line_t video_encoder =
       elements::encoders::build_video_encoder(conf->GetVideoEncoder(), video_bitrate, conf->GetVideoEncoderArgs(),
-                                              conf->GetVideoEncoderStrArgs(), this, video_id);
+                                              conf->GetVideoEncoderStrArgs(), this, video_id, parked_encoder);
+  if (pooled && !video_encoder.empty()) {
+    ElementsPool::GetInstance().Track(video_encoder.front()->GetGstElement(), pool_key);
+    const EncodeConfig::renditions_t renditions = conf->GetRenditions();
+    const common::draw::Size size =
+        video_id && video_id <= renditions.size() ? renditions[video_id - 1].size : conf->GetSize();
+    EncodingStream* stream = static_cast<EncodingStream*>(GetObserver());
+    if (stream) {
+      stream->OnVideoEncoderCreated(video_encoder.front(), video_id, size);
+    }
+  }
+  if (gpu_device && conf->IsNvGpu() && !video_encoder.empty()) {
+    elements::Element* codec = video_encoder.front();
+    if (codec->GetPluginName() == elements::encoders::ElementNvH264Enc::GetPluginName()) {
+      static_cast<elements::encoders::ElementNvH264Enc*>(codec)->SetCudaDeviceId(*gpu_device);
+    } else if (codec->GetPluginName() == elements::encoders::ElementNvH265Enc::GetPluginName()) {
+      static_cast<elements::encoders::ElementNvH265Enc*>(codec)->SetCudaDeviceId(*gpu_device);
+    } else if (codec->GetPluginName() == elements::encoders::ElementNvAV1Enc::GetPluginName()) {
+      static_cast<elements::encoders::ElementNvAV1Enc*>(codec)->SetCudaDeviceId(*gpu_device);
+    }
+  }
+
+  if (conf->GetLowLatency() && !video_encoder.empty()) {
+    elements::encoders::setup_low_latency_encoder(conf->GetVideoEncoderArgs(), conf->GetVideoEncoderStrArgs(),
+                                                  video_encoder.front());
+  }
+
+  // same gop in every rendition, so encoders don't place own idr between forced ones differently,
+  // short low latency segments can be cut only if gop is not longer than segment, time clock of
+  // BuildVideoEncodeBranch or ladder forces idr if framerate is not configured
+  const auto framerate = conf->GetFramerate();
+  if ((align_keyframes_ || conf->GetLowLatency()) && framerate && !video_encoder.empty()) {
+    elements::Element* codec = video_encoder.front();
+    const std::string codec_name = codec->GetPluginName();
+    const char* keyframe_property = elements::encoders::get_encoder_keyframe_interval_property(codec_name);
+    const video_encoders_args_t args = conf->GetVideoEncoderArgs();
+    if (keyframe_property && args.find(codec_name + "." + keyframe_property) == args.end()) {
+      codec->SetProperty(keyframe_property, *framerate * get_segment_duration(conf));
+    }
+  }
   return video_encoder;
 }
 
+elements::Element* EncodingStreamBuilder::BuildVideoEncodeBranch(elements::Element* src,
+                                                                 const elements_line_t& video_encoder,
+                                                                 element_id_t video_id) {
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  elements::Element* last = src;
+  if (!video_encoder.empty() && conf->GetLowLatency() && !align_keyframes_ && !conf->GetFramerate()) {
+    // gop unknown without framerate, idr forced by time so short segments can be cut,
+    // probe stays upstream since parked encoders are reused
+    pad::Pad* src_pad = src->StaticPad("src");
+    if (src_pad->IsValid()) {
+      gst_pad_add_probe(src_pad->GetGstPad(), GST_PAD_PROBE_TYPE_BUFFER, keyframe_clock_probe,
+                        new KeyframeClock(get_segment_duration(conf) * GST_SECOND), destroy_keyframe_clock);
+    }
+    delete src_pad;
+  }
+  if (!video_encoder.empty()) {
+    ElementLink(last, video_encoder.front());
+    last = video_encoder.back();
+    pad::Pad* enc_pad = last->StaticPad("src");
+    if (enc_pad->IsValid()) {
+      HandleLatencyPadCreated(enc_pad, ENCODE_LATENCY_STAGE);
+    }
+    delete enc_pad;
+
+    if (video_id == 0 && video_passthrough_) {
+      elements::ElementFunnel* funnel = new elements::ElementFunnel(common::MemSPrintf(VIDEO_FUNNEL_NAME_1U, 0));
+      ElementAdd(funnel);
+      ElementLink(last, funnel);
+      ElementLink(video_passthrough_, funnel);
+      last = funnel;
+    }
+  }
+
+  const std::string vcodec = conf->GetVideoEncoder();
+  if (elements::encoders::IsH264Encoder(vcodec)) {
+    elements::parser::ElementH264Parse* premux_parser = elements::parser::make_h264_parser(video_id);
+    ElementAdd(premux_parser);
+    ElementLink(last, premux_parser);
+    last = premux_parser;
+#if defined(MACHINE_LEARNING)
+    if (conf->GetDeepLearning() && conf->GetDeepLearningMetadata()) {
+      pad::Pad* parser_pad = premux_parser->StaticPad("src");
+      if (parser_pad->IsValid()) {
+        HandleDetectionsPadCreated(parser_pad);
+      }
+      delete parser_pad;
+    }
+#endif
+  }
+
+  elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(VIDEO_TEE_NAME_1U, video_id));
+  ElementAdd(tee);
+  RegisterElement(VIDEO_TEE_ROLE, video_id, tee);
+  ElementLink(last, tee);
+  return tee;
+}
+
+elements::Element* EncodingStreamBuilder::GetOutputVideoSource(Connector conn, const OutputUri& output) {
+  auto it = rendition_tees_.find(output.GetID());
+  if (it != rendition_tees_.end()) {
+    return it->second;
+  }
+
+  return SrcDecodeStreamBuilder::GetOutputVideoSource(conn, output);
+}
+
+elements::ElementQueue* EncodingStreamBuilder::BuildQueue(const std::string& name) {
+  elements::ElementQueue* queue = SrcDecodeStreamBuilder::BuildQueue(name);
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  if (conf->GetLowLatency()) {
+    queue->SetMaxSizeBuffers(LOW_LATENCY_QUEUE_MAX_SIZE_BUFFERS);
+  }
+  return queue;
+}
+
+fastotv::timestamp_t EncodingStreamBuilder::GetLatencyTarget() const {
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  if (conf->GetLowLatency() && !conf->GetLatencyTargetMsec()) {
+    return LOW_LATENCY_TARGET_MSEC;
+  }
+  return SrcDecodeStreamBuilder::GetLatencyTarget();
+}
+
+bit_rate_t EncodingStreamBuilder::GetQueueBitrate() const {
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  const bit_rate_t video_bitrate = conf->GetVideoBitrate();
+  const bit_rate_t audio_bitrate = conf->GetAudioBitrate();
+  if (!video_bitrate && !audio_bitrate) {
+    return bit_rate_t();
+  }
+  return bit_rate_t((video_bitrate ? *video_bitrate : 0) + (audio_bitrate ? *audio_bitrate : 0));
+}
+
+elements::Element* EncodingStreamBuilder::CreateSink(const OutputUri& output, element_id_t sink_id) {
+  elements::Element* sink = SrcDecodeStreamBuilder::CreateSink(output, sink_id);
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  if (!conf->GetLowLatency() || !sink) {
+    return sink;
+  }
+
+  const std::string sink_name = sink->GetPluginName();
+  if (sink_name == elements::sink::ElementHLSSink::GetPluginName()) {
+    elements::sink::ElementHLSSink* hls = static_cast<elements::sink::ElementHLSSink*>(sink);
+    hls->SetTargetDuration(LOW_LATENCY_TS_DURATION);
+    hls->SetPlaylistLenght(LOW_LATENCY_PLAYLIST_LENGTH);
+  } else if (sink_name == elements::sink::ElementSrtSink::GetPluginName()) {
+    static_cast<elements::sink::ElementSrtSink*>(sink)->SetLatency(LOW_LATENCY_SRT_MSEC);
+  }
+  return sink;
+}
+
 elements_line_t EncodingStreamBuilder::BuildAudioConverter(element_id_t audio_id) {
   const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
 
@@ -356,12 +917,48 @@ elements_line_t EncodingStreamBuilder::BuildAudioConverter(element_id_t audio_id
 }
 
 #if defined(MACHINE_LEARNING)
-void EncodingStreamBuilder::HandleMLElementCreated(elements::machine_learning::ElementVideoMLFilter* machine) {
+void EncodingStreamBuilder::HandleMLElementCreated(elements::machine_learning::ElementVideoMLFilter* machine,
+                                                   fastoml::SupportedBackends backend) {
   EncodingStream* stream = static_cast<EncodingStream*>(GetObserver());
   if (stream) {
-    stream->OnMLElementCreated(machine);
+    stream->OnMLElementCreated(machine, backend);
   }
 }
+
+void EncodingStreamBuilder::HandleInferenceSinkCreated(elements::machine_learning::ElementInferenceSink* sink) {
+  EncodingStream* stream = static_cast<EncodingStream*>(GetObserver());
+  if (stream) {
+    stream->OnInferenceSinkCreated(sink);
+  }
+}
+
+void EncodingStreamBuilder::HandleDetectionsPadCreated(pad::Pad* pad) {
+  EncodingStream* stream = static_cast<EncodingStream*>(GetObserver());
+  if (stream) {
+    stream->OnDetectionsPadCreated(pad, false);
+  }
+}
+
+void EncodingStreamBuilder::BuildInferenceTee(elements::Element* src,
+                                              element_id_t video_id,
+                                              elements::ElementQueue** main_queue,
+                                              elements::ElementQueue** infer_queue) {
+  elements::ElementTee* ml_tee = new elements::ElementTee(common::MemSPrintf("ml_tee_%lu", video_id));
+  elements::ElementQueue* main = new elements::ElementQueue(common::MemSPrintf("ml_main_queue_%lu", video_id));
+  elements::ElementQueue* infer = new elements::ElementQueue(common::MemSPrintf("ml_infer_queue_%lu", video_id));
+  infer->SetMaxSizeBuffers(1);
+  infer->SetMaxSizeBytes(0);
+  infer->SetMaxSizeTime(0);
+  infer->SetLeaky(2);  // slow inference drops frames, never stalls video
+  ElementAdd(ml_tee);
+  ElementAdd(main);
+  ElementAdd(infer);
+  ElementLink(src, ml_tee);
+  ElementLink(ml_tee, main);
+  ElementLink(ml_tee, infer);
+  *main_queue = main;
+  *infer_queue = infer;
+}
 #endif
 
 }  // namespace builders
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+
 #include "stream/streams/builders/src_decodebin_stream_builder.h"
 
 #include "stream/streams/configs/encode_config.h"
@@ -25,6 +28,7 @@ class ElementQueue;
 #if defined(MACHINE_LEARNING)
 namespace machine_learning {
 class ElementVideoMLFilter;
+class ElementInferenceSink;
 }
 #endif
 }  // namespace elements
@@ -35,6 +39,7 @@ namespace builders {
 class EncodingStreamBuilder : public SrcDecodeStreamBuilder {
  public:
   EncodingStreamBuilder(const EncodeConfig* api, SrcDecodeBinStream* observer);
+  Connector BuildUdbConnections(Connector conn) override;
   Connector BuildPostProc(Connector conn) override;
   Connector BuildConverter(Connector conn) override;
 
@@ -42,15 +47,46 @@ class EncodingStreamBuilder : public SrcDecodeStreamBuilder {
   SupportedAudioCodec GetAudioCodecType() const override;
 
  protected:
+  virtual bool IsPassthroughAvailable() const;  // input can expose encoded tracks, not only raw
+
   virtual elements_line_t BuildVideoPostProc(element_id_t video_id);
   virtual elements_line_t BuildAudioPostProc(element_id_t audio_id);
 
   virtual elements_line_t BuildVideoConverter(element_id_t video_id);
   virtual elements_line_t BuildAudioConverter(element_id_t audio_id);
 
+  virtual elements_line_t BuildVideoEncoder(bit_rate_t video_bitrate, element_id_t video_id);
+  // scaler matching memory of decoded frames (system, VASurface or CUDA)
+  elements::Element* BuildVideoScale(elements::Element* src, const common::draw::Size& size, element_id_t video_id);
+  elements::Element* GetOutputVideoSource(Connector conn, const OutputUri& output) override;
+  elements::Element* BuildAudioTrack(element_id_t track_id) override;  // decoded and encoded like main track
+  elements::ElementQueue* BuildQueue(const std::string& name) override;
+  fastotv::timestamp_t GetLatencyTarget() const override;  // LOW_LATENCY_TARGET_MSEC if low latency and not set
+  bit_rate_t GetQueueBitrate() const override;             // video and audio bitrates
+  elements::Element* CreateSink(const OutputUri& output, element_id_t sink_id) override;
+
 #if defined(MACHINE_LEARNING)
-  void HandleMLElementCreated(fastocloud::stream::elements::machine_learning::ElementVideoMLFilter* machine);
+  void HandleMLElementCreated(fastocloud::stream::elements::machine_learning::ElementVideoMLFilter* machine,
+                              fastoml::SupportedBackends backend);
+  void HandleInferenceSinkCreated(fastocloud::stream::elements::machine_learning::ElementInferenceSink* sink);
+  void HandleDetectionsPadCreated(pad::Pad* pad);  // h264 parsed before tee
+  // tee of decoded video, main queue continues pipeline, leaky one buffer queue starts inference branch
+  void BuildInferenceTee(elements::Element* src,
+                         element_id_t video_id,
+                         elements::ElementQueue** main_queue,
+                         elements::ElementQueue** infer_queue);
 #endif
+
+ private:
+  // encoder (=> funnel with passthrough) => parser => tee, returns tee
+  elements::Element* BuildVideoEncodeBranch(elements::Element* src,
+                                            const elements_line_t& video_encoder,
+                                            element_id_t video_id);
+
+  std::map<fastotv::channel_id_t, elements::Element*> rendition_tees_;  // encoded video by output id
+  bool align_keyframes_;                                                 // ladder encoders share keyframe clock
+  elements::Element* video_passthrough_;                                 // parsed input video, joins encoder at funnel
+  elements::Element* audio_passthrough_;                                 // parsed input audio, joins encoder at funnel
 };
 
 }  // namespace builders
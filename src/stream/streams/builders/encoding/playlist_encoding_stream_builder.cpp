@@ -14,8 +14,11 @@
 
 #include "stream/streams/builders/encoding/playlist_encoding_stream_builder.h"
 
+#include <common/sprintf.h>
+
 #include "stream/streams/encoding/playlist_encoding_stream.h"
 
+#include "stream/elements/element.h"
 #include "stream/elements/sources/appsrc.h"
 
 #include "stream/pad/pad.h"
@@ -29,6 +32,54 @@ PlaylistEncodingStreamBuilder::PlaylistEncodingStreamBuilder(const PlaylistEncod
                                                              PlaylistEncodingStream* observer)
     : EncodingStreamBuilder(api, observer) {}
 
+bool PlaylistEncodingStreamBuilder::IsWarmStandbyAvailable() const {
+  return false;  // files are played one by one from appsrc
+}
+
+bool PlaylistEncodingStreamBuilder::IsSoftRestartAvailable() const {
+  return false;
+}
+
+Connector PlaylistEncodingStreamBuilder::BuildInput() {
+  const PlaylistEncodeConfig* config = static_cast<const PlaylistEncodeConfig*>(GetConfig());
+  if (!config->GetGapless()) {
+    return EncodingStreamBuilder::BuildInput();
+  }
+
+  elements::ElementConcat* video_concat = nullptr;
+  elements::ElementConcat* audio_concat = nullptr;
+  if (config->HaveVideo()) {
+    video_concat = new elements::ElementConcat(common::MemSPrintf(VIDEO_CONCAT_NAME_1U, 0));
+    ElementAdd(video_concat);
+    elements::ElementDecodebin* decodebin =
+        new elements::ElementDecodebin(common::MemSPrintf(VIDEO_DECODEBIN_NAME_1U, 0));
+    ElementAdd(decodebin);
+    ElementLink(video_concat, decodebin);
+    HandleDecodebinCreated(decodebin);
+  }
+  if (config->HaveAudio()) {
+    audio_concat = new elements::ElementConcat(common::MemSPrintf(AUDIO_CONCAT_NAME_1U, 0));
+    ElementAdd(audio_concat);
+    elements::ElementDecodebin* decodebin =
+        new elements::ElementDecodebin(common::MemSPrintf(AUDIO_DECODEBIN_NAME_1U, 0));
+    ElementAdd(decodebin);
+    ElementLink(audio_concat, decodebin);
+    HandleDecodebinCreated(decodebin);
+  }
+
+  // input statistic of joined elementary stream
+  elements::Element* input = video_concat ? video_concat : audio_concat;
+  if (input) {
+    pad::Pad* src_pad = input->StaticPad("src");
+    if (src_pad->IsValid()) {
+      HandleInputSrcPadCreated(src_pad, 0, common::uri::Url());
+    }
+    delete src_pad;
+  }
+  HandleGaplessCreated(video_concat, audio_concat);
+  return {nullptr, nullptr, nullptr};
+}
+
 elements::Element* PlaylistEncodingStreamBuilder::BuildInputSrc() {
   elements::sources::ElementAppSrc* appsrc = elements::sources::make_app_src(0);
 
@@ -50,6 +101,14 @@ void PlaylistEncodingStreamBuilder::HandleAppSrcCreated(elements::sources::Eleme
   }
 }
 
+void PlaylistEncodingStreamBuilder::HandleGaplessCreated(elements::ElementConcat* video_concat,
+                                                         elements::ElementConcat* audio_concat) {
+  PlaylistEncodingStream* stream = static_cast<PlaylistEncodingStream*>(GetObserver());
+  if (stream) {
+    stream->OnGaplessCreated(video_concat, audio_concat);
+  }
+}
+
 }  // namespace builders
 }  // namespace streams
 }  // namespace stream
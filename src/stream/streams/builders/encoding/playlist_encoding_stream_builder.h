@@ -19,6 +19,7 @@
 namespace fastocloud {
 namespace stream {
 namespace elements {
+class ElementConcat;
 namespace sources {
 class ElementAppSrc;
 }
@@ -30,10 +31,14 @@ namespace builders {
 class PlaylistEncodingStreamBuilder : public EncodingStreamBuilder {
  public:
   PlaylistEncodingStreamBuilder(const PlaylistEncodeConfig* api, PlaylistEncodingStream* observer);
+  Connector BuildInput() override;  // gapless: concat per track to decodebin, files added by stream while playing
   elements::Element* BuildInputSrc() override;
+  bool IsWarmStandbyAvailable() const override;
+  bool IsSoftRestartAvailable() const override;
 
  protected:
   void HandleAppSrcCreated(elements::sources::ElementAppSrc* src);
+  void HandleGaplessCreated(elements::ElementConcat* video_concat, elements::ElementConcat* audio_concat);
 };
 
 }  // namespace builders
@@ -0,0 +1,42 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/streams/builders/encoding/radio_stream_builder.h"
+
+namespace fastocloud {
+namespace stream {
+namespace streams {
+namespace builders {
+
+RadioStreamBuilder::RadioStreamBuilder(const EncodeConfig* api, SrcDecodeBinStream* observer)
+    : EncodingStreamBuilder(api, observer) {}
+
+fastotv::timestamp_t RadioStreamBuilder::GetLatencyTarget() const {
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  if (conf->GetLatencyTargetMsec()) {
+    return conf->GetLatencyTargetMsec();
+  }
+  return conf->GetLowLatency() ? LOW_LATENCY_TARGET_MSEC : RADIO_LATENCY_TARGET_MSEC;
+}
+
+bit_rate_t RadioStreamBuilder::GetQueueBitrate() const {
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  const bit_rate_t audio_bitrate = conf->GetAudioBitrate();
+  return audio_bitrate ? audio_bitrate : bit_rate_t(RADIO_QUEUE_BITRATE);
+}
+
+}  // namespace builders
+}  // namespace streams
+}  // namespace stream
+}  // namespace fastocloud
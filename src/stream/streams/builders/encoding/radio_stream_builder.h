@@ -0,0 +1,37 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "stream/streams/builders/encoding/encoding_stream_builder.h"
+
+namespace fastocloud {
+namespace stream {
+namespace streams {
+namespace builders {
+
+// audio only, queues sized by audio bitrate and short latency target
+class RadioStreamBuilder : public EncodingStreamBuilder {
+ public:
+  RadioStreamBuilder(const EncodeConfig* api, SrcDecodeBinStream* observer);
+
+ protected:
+  fastotv::timestamp_t GetLatencyTarget() const override;  // RADIO_LATENCY_TARGET_MSEC if not set
+  bit_rate_t GetQueueBitrate() const override;             // audio bitrate, RADIO_QUEUE_BITRATE if not set
+};
+
+}  // namespace builders
+}  // namespace streams
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,116 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/streams/builders/encoding/vod_encoding_stream_builder.h"
+
+#if defined(OS_LINUX)
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+#include "stream/elements/encoders/video.h"
+#include "stream/elements/sink/http.h"
+
+namespace fastocloud {
+namespace stream {
+namespace streams {
+namespace builders {
+
+namespace {
+
+unsigned int get_assigned_cores() {
+#if defined(OS_LINUX)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    return std::max(CPU_COUNT(&set), 1);
+  }
+#endif
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// sinks inside bins too, file is written as fast as encoded
+void disable_sync(GstElement* element) {
+  if (GST_IS_BIN(element)) {
+    GstIterator* it = gst_bin_iterate_sinks(GST_BIN(element));
+    GValue item = G_VALUE_INIT;
+    while (gst_iterator_next(it, &item) == GST_ITERATOR_OK) {
+      disable_sync(GST_ELEMENT(g_value_get_object(&item)));
+      g_value_reset(&item);
+    }
+    g_value_unset(&item);
+    gst_iterator_free(it);
+    return;
+  }
+
+  if (g_object_class_find_property(G_OBJECT_GET_CLASS(element), "sync")) {
+    g_object_set(element, "sync", FALSE, nullptr);
+  }
+}
+
+}  // namespace
+
+VodEncodeStreamBuilder::VodEncodeStreamBuilder(const VodEncodeConfig* api, SrcDecodeBinStream* observer)
+    : EncodingStreamBuilder(api, observer) {}
+
+elements_line_t VodEncodeStreamBuilder::BuildVideoEncoder(bit_rate_t video_bitrate, element_id_t video_id) {
+  elements_line_t video_encoder = EncodingStreamBuilder::BuildVideoEncoder(video_bitrate, video_id);
+  const VodEncodeConfig* conf = static_cast<const VodEncodeConfig*>(GetConfig());
+  if (!conf->GetOffline() || video_encoder.empty()) {
+    return video_encoder;
+  }
+
+  // parts encoded in parallel share cores of stream
+  const unsigned int threads = std::max<unsigned int>(get_assigned_cores() / conf->GetWorkers(), 1);
+  elements::encoders::setup_offline_encoder(conf->GetVideoEncoderArgs(), conf->GetVideoEncoderStrArgs(), threads,
+                                            video_encoder.front());
+  return video_encoder;
+}
+
+fastotv::timestamp_t VodEncodeStreamBuilder::GetLatencyTarget() const {
+  const VodEncodeConfig* conf = static_cast<const VodEncodeConfig*>(GetConfig());
+  if (conf->GetOffline() && !conf->GetLatencyTargetMsec()) {
+    return OFFLINE_LATENCY_TARGET_MSEC;
+  }
+  return EncodingStreamBuilder::GetLatencyTarget();
+}
+
+elements::Element* VodEncodeStreamBuilder::CreateSink(const OutputUri& output, element_id_t sink_id) {
+  elements::Element* sink = EncodingStreamBuilder::CreateSink(output, sink_id);
+  const VodEncodeConfig* conf = static_cast<const VodEncodeConfig*>(GetConfig());
+  if (conf->GetOffline() && sink) {
+    disable_sync(sink->GetGstElement());
+  }
+  if (!conf->IsParallel() || !sink || sink->GetPluginName() != elements::sink::ElementHLSSink::GetPluginName()) {
+    return sink;
+  }
+
+  // every part writes own segments and playlist, served playlist merged by stream of first part
+  const auto part = conf->GetPart();
+  const std::string prefix = part ? part->GetPrefix() : VodPart().GetPrefix();
+  const std::string http_root = output.GetHttpRoot().GetPath();
+  const std::string filename = output.GetOutput().GetPath().GetFileName();
+  elements::sink::ElementHLSSink* hls = static_cast<elements::sink::ElementHLSSink*>(sink);
+  hls->SetLocation(http_root + prefix + GenVodHttpTsTemplate());
+  hls->SetPlayLocation(http_root + prefix + filename);
+  return sink;
+}
+
+}  // namespace builders
+}  // namespace streams
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,37 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "stream/streams/builders/encoding/encoding_stream_builder.h"
+
+namespace fastocloud {
+namespace stream {
+namespace streams {
+namespace builders {
+
+class VodEncodeStreamBuilder : public EncodingStreamBuilder {
+ public:
+  VodEncodeStreamBuilder(const VodEncodeConfig* api, SrcDecodeBinStream* observer);
+
+ protected:
+  elements_line_t BuildVideoEncoder(bit_rate_t video_bitrate, element_id_t video_id) override;
+  fastotv::timestamp_t GetLatencyTarget() const override;  // OFFLINE_LATENCY_TARGET_MSEC if offline and not set
+  elements::Element* CreateSink(const OutputUri& output, element_id_t sink_id) override;
+};
+
+}  // namespace builders
+}  // namespace streams
+}  // namespace stream
+}  // namespace fastocloud
@@ -17,7 +17,7 @@
 #include <string.h>
 #include <string>
 
-#include "stream/gstreamer_utils.h"  // for pad_get_type
+#include "stream/gstreamer_utils.h"  // for pad_get_type, is_element_available
 
 #include "base/constants.h"
 #include "base/gst_constants.h"
@@ -31,7 +31,6 @@
 #include "stream/elements/pay/audio.h"
 #include "stream/elements/pay/video.h"
 #include "stream/elements/sink/screen.h"
-#include "stream/elements/sources/build_input.h"
 #include "stream/elements/video/video.h"
 
 #include "stream/pad/pad.h"
@@ -64,6 +63,42 @@ Element* build_mux_video_scale(common::draw::Size sz, ILinker* linker, Element*
 namespace streams {
 namespace builders {
 
+namespace {
+
+enum MosaicCompositor { CPU_COMPOSITOR, VAAPI_COMPOSITOR, CUDA_COMPOSITOR };
+
+// tiles stay in gpu memory from scale through compose to encoder only without software filters,
+// audio meters are cairo drawn so cpu only
+MosaicCompositor select_compositor(const EncodeConfig* conf) {
+  const auto deinterlace = conf->GetDeinterlace();
+  if ((deinterlace && *deinterlace) || conf->GetFramerate() || conf->GetAspectRatio()) {
+    return CPU_COMPOSITOR;
+  }
+
+  const output_t out = conf->GetOutput();
+  for (const OutputUri& output : out) {
+    SinkDeviceType dt;
+    if (IsDeviceOutUrl(output.GetOutput(), &dt)) {
+      return CPU_COMPOSITOR;
+    }
+  }
+
+  if (conf->IsNvGpu() && is_element_available(elements::video::ElementCudaCompositor::GetPluginName()) &&
+      is_element_available(elements::video::ElementCudaUpload::GetPluginName()) &&
+      is_element_available(elements::video::ElementCudaScale::GetPluginName())) {
+    return CUDA_COMPOSITOR;
+  }
+
+  if (conf->IsGpu() && !conf->IsMfxGpu() &&
+      is_element_available(elements::video::ElementVaapiOverlay::GetPluginName())) {
+    return VAAPI_COMPOSITOR;
+  }
+
+  return CPU_COMPOSITOR;
+}
+
+}  // namespace
+
 MosaicStreamBuilder::MosaicStreamBuilder(const EncodeConfig* config, MosaicStream* observer)
     : IBaseBuilder(config, observer) {}
 
@@ -96,8 +131,18 @@ bool MosaicStreamBuilder::InitPipeline() {
     return false;
   }
 
-  elements::video::ElementVideoMixer* vmix =
-      new elements::video::ElementVideoMixer(common::MemSPrintf(VIDEOMIXER_NAME_1U, 0));
+  const MosaicCompositor compositor = select_compositor(config);
+  const std::string vmix_name = common::MemSPrintf(VIDEOMIXER_NAME_1U, 0);
+  elements::Element* vmix = nullptr;
+  if (compositor == CUDA_COMPOSITOR) {
+    vmix = new elements::video::ElementCudaCompositor(vmix_name);
+    elements::encoders::set_cuda_device(config->GetGpuDevice(), vmix);
+  } else if (compositor == VAAPI_COMPOSITOR) {
+    vmix = new elements::video::ElementVaapiOverlay(vmix_name);
+  } else {
+    vmix = new elements::video::ElementVideoMixer(vmix_name);
+  }
+  INFO_LOG() << "Mosaic compositor: " << vmix->GetPluginName();
   ElementAdd(vmix);
   elements::audio::ElementAudioMixer* amix =
       new elements::audio::ElementAudioMixer(common::MemSPrintf(INTERLIVE_NAME_1U, 0));
@@ -109,43 +154,56 @@ bool MosaicStreamBuilder::InitPipeline() {
       ImageInfo image;
       SoundInfo sound;
       InputUri uri = prepared[i];
-      const common::uri::Url iuri = uri.GetInput();
-      elements::Element* src = elements::sources::make_src(uri, i, IBaseStream::src_timeout_sec);
-      pad::Pad* src_pad = src->StaticPad("src");
-      if (src_pad->IsValid()) {
-        HandleInputSrcPadCreated(src_pad, i, iuri);
-      }
-      delete src_pad;
-      ElementAdd(src);
+      elements::Element* src = BuildInputSource(uri, i);
 
       elements::ElementDecodebin* decodebin = new elements::ElementDecodebin(common::MemSPrintf(DECODEBIN_NAME_1U, i));
       ElementAdd(decodebin);
+      RegisterElement(DECODEBIN_ROLE, i, decodebin);
       ElementLink(src, decodebin);
       HandleDecodebinCreated(decodebin);
 
       if (config->HaveVideo()) {
         elements::ElementQueue* video_queue = new elements::ElementQueue(common::MemSPrintf(UDB_VIDEO_NAME_1U, i));
         ElementAdd(video_queue);
+        RegisterElement(UDB_VIDEO_ROLE, i, video_queue);
 
         common::draw::Size image_size(options.screen_size.width / column_counts,
                                       options.screen_size.height / row_counts);
         image.size = image_size;
-        elements::Element* scale = elements::build_mux_video_scale(image.size, this, video_queue, i);
-
-        elements::video::ElementVideoBox* video_box =
-            new elements::video::ElementVideoBox(common::MemSPrintf(VIDEO_BOX_NAME_1U, i));
-        ElementAdd(video_box);
-        ElementLink(scale, video_box);
-        video_box->SetProperty("border-alpha", 1.0);
-        ElementLink(video_box, vmix);
+        if (compositor == CUDA_COMPOSITOR) {
+          elements_line_t upload = elements::encoders::build_cuda_video_convert(config->GetGpuDevice(), this, i);
+          ElementLink(video_queue, upload.front());
+          elements::Element* scale = elements::encoders::build_cuda_video_scale(
+              image.size.width, image.size.height, config->GetGpuDevice(), this, upload.back(), i);
+          ElementLink(scale, vmix);
+        } else if (compositor == VAAPI_COMPOSITOR) {
+          elements::ElementVaapiPostProc* post =
+              new elements::ElementVaapiPostProc(common::MemSPrintf(POST_PROC_NAME_1U, i));
+          post->SetForceAspectRatio(false);
+          post->SetWidth(image.size.width);
+          post->SetHeight(image.size.height);
+          ElementAdd(post);
+          ElementLink(video_queue, post);
+          ElementLink(post, vmix);
+        } else {
+          elements::Element* scale = elements::build_mux_video_scale(image.size, this, video_queue, i);
+
+          elements::video::ElementVideoBox* video_box =
+              new elements::video::ElementVideoBox(common::MemSPrintf(VIDEO_BOX_NAME_1U, i));
+          ElementAdd(video_box);
+          ElementLink(scale, video_box);
+          video_box->SetProperty("border-alpha", 1.0);
+          ElementLink(video_box, vmix);
+        }
 
         const std::string pad_name = common::MemSPrintf("sink_%lu", i);
         pad::Pad* sink_pad = vmix->StaticPad(pad_name.c_str());
         common::draw::Point p(c * image_size.width, r * image_size.height);
         image.x_y = p;
         if (sink_pad->IsValid()) {
-          sink_pad->SetProperty("xpos", p.x);
-          sink_pad->SetProperty("ypos", p.y);
+          const bool short_names = compositor == VAAPI_COMPOSITOR;  // vaapioverlay pads have x/y
+          sink_pad->SetProperty(short_names ? "x" : "xpos", p.x);
+          sink_pad->SetProperty(short_names ? "y" : "ypos", p.y);
         }
         delete sink_pad;
       }
@@ -153,13 +211,15 @@ bool MosaicStreamBuilder::InitPipeline() {
       if (config->HaveAudio()) {
         elements::ElementQueue* audio_queue = new elements::ElementQueue(common::MemSPrintf(UDB_AUDIO_NAME_1U, i));
         ElementAdd(audio_queue);
+        RegisterElement(UDB_AUDIO_ROLE, i, audio_queue);
 
-        elements::audio::ElementLevel* spec =
-            new elements::audio::ElementLevel(common::MemSPrintf(AUDIO_LEVEL_NAME_1U, i));
-        ElementAdd(spec);
-        ElementLink(audio_queue, spec);
+        pad::Pad* meter_pad = audio_queue->StaticPad("src");
+        if (meter_pad->IsValid()) {
+          HandleAudioMeterPadCreated(meter_pad, i);
+        }
+        delete meter_pad;
 
-        ElementLink(spec, amix);
+        ElementLink(audio_queue, amix);
         /*
         const std::string pad_name = common::MemSPrintf("sink_%lu", i);
         pad::Pad* sink_pad = amix->StaticPad(pad_name.c_str());
@@ -182,8 +242,15 @@ bool MosaicStreamBuilder::InitPipeline() {
     }
   }
 
+  HandleLayoutCreated(options);
+
   Connector conn{vmix, amix, nullptr};
-  if (config->HaveVideo()) {
+  if (config->HaveVideo() && compositor != CPU_COMPOSITOR) {  // composed frames go to gpu encoders as is
+    elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(VIDEO_TEE_NAME_1U, 0));
+    ElementAdd(tee);
+    ElementLink(conn.video, tee);
+    conn.video = tee;
+  } else if (config->HaveVideo()) {
     elements::video::ElementCairoOverlay* cairo =
         new elements::video::ElementCairoOverlay(common::MemSPrintf(CAIRO_NAME_1U, 0));
     ElementAdd(cairo);
@@ -204,7 +271,8 @@ bool MosaicStreamBuilder::InitPipeline() {
   if (config->HaveAudio()) {
     const auto volume = config->GetVolume();
     const auto achannels = config->GetAudioChannelsCount();
-    elements_line_t first_last = elements::encoders::build_audio_converters(volume, achannels, this, 0);
+    const bool dithering = config->GetAudioDithering();
+    elements_line_t first_last = elements::encoders::build_audio_converters(volume, achannels, dithering, this, 0);
     ElementLink(conn.audio, first_last.front());
     conn.audio = first_last.back();
 
@@ -230,6 +298,7 @@ void MosaicStreamBuilder::BuildOutput(elements::Element* video, elements::Elemen
         elements::ElementQueue* video_tee_queue =
             new elements::ElementQueue(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, i));
         // video_tee_queue->SetMaxSizeBuffers(4);
+        SetupOutputQueue(video_tee_queue, i);
         ElementAdd(video_tee_queue);
         elements::Element* next = video_tee_queue;
         ElementLink(video, next);
@@ -256,6 +325,7 @@ void MosaicStreamBuilder::BuildOutput(elements::Element* video, elements::Elemen
         elements::ElementQueue* audio_tee_queue =
             new elements::ElementQueue(common::MemSPrintf(AUDIO_TEE_QUEUE_NAME_1U, i));
         // audio_tee_queue->SetMaxSizeBuffers(4);
+        SetupOutputQueue(audio_tee_queue, i);
         ElementAdd(audio_tee_queue);
         elements::Element* next = audio_tee_queue;
         ElementLink(audio, next);
@@ -276,13 +346,14 @@ void MosaicStreamBuilder::BuildOutput(elements::Element* video, elements::Elemen
     common::uri::Url::scheme scheme = uri.GetScheme();
     bool is_rtp_out = scheme == common::uri::Url::udp;
     const std::string vcodec = config->GetVideoEncoder();
-    elements::Element* mux = elements::muxer::make_muxer(scheme, i);
+    elements::Element* mux = elements::muxer::make_muxer(scheme, i, config->GetCmaf());
     ElementAdd(mux);
 
     if (config->HaveVideo()) {
       elements::ElementQueue* video_tee_queue =
           new elements::ElementQueue(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, i));
       // video_tee_queue->SetMaxSizeBuffers(4);
+      SetupOutputQueue(video_tee_queue, i);
       ElementAdd(video_tee_queue);
       elements::Element* next = video_tee_queue;
       ElementLink(video, next);
@@ -339,6 +410,7 @@ void MosaicStreamBuilder::BuildOutput(elements::Element* video, elements::Elemen
       elements::ElementQueue* audio_tee_queue =
           new elements::ElementQueue(common::MemSPrintf(AUDIO_TEE_QUEUE_NAME_1U, i));
       // audio_tee_queue->SetMaxSizeBuffers(4);
+      SetupOutputQueue(audio_tee_queue, i);
       ElementAdd(audio_tee_queue);
       elements::Element* next = audio_tee_queue;
       ElementLink(audio, next);
@@ -389,6 +461,13 @@ void MosaicStreamBuilder::HandleDecodebinCreated(elements::ElementDecodebin* dec
   }
 }
 
+void MosaicStreamBuilder::HandleLayoutCreated(const MosaicImageOptions& options) {
+  MosaicStream* stream = static_cast<MosaicStream*>(GetObserver());
+  if (stream) {
+    stream->OnLayoutCreated(options);
+  }
+}
+
 void MosaicStreamBuilder::HandleCairoCreated(elements::video::ElementCairoOverlay* cairo,
                                              const MosaicImageOptions& options) {
   MosaicStream* stream = static_cast<MosaicStream*>(GetObserver());
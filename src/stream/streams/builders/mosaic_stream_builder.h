@@ -41,6 +41,7 @@ class MosaicStreamBuilder : public IBaseBuilder {
 
  protected:
   void HandleDecodebinCreated(elements::ElementDecodebin* decodebin);
+  void HandleLayoutCreated(const MosaicImageOptions& options);
   void HandleCairoCreated(elements::video::ElementCairoOverlay* cairo, const MosaicImageOptions& options);
 
   bool InitPipeline() override;
@@ -35,6 +35,14 @@ void PlaylistRelayStreamBuilder::HandleAppSrcCreated(elements::sources::ElementA
   }
 }
 
+bool PlaylistRelayStreamBuilder::IsWarmStandbyAvailable() const {
+  return false;  // files are played one by one from appsrc
+}
+
+bool PlaylistRelayStreamBuilder::IsSoftRestartAvailable() const {
+  return false;
+}
+
 elements::Element* PlaylistRelayStreamBuilder::BuildInputSrc() {
   elements::sources::ElementAppSrc* appsrc = elements::sources::make_app_src(0);
   // g_signal_connect(appsrc, "enough-data", G_CALLBACK(enough_data), this);
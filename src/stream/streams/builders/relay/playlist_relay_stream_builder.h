@@ -33,6 +33,8 @@ class PlaylistRelayStreamBuilder : public RelayStreamBuilder {
   PlaylistRelayStreamBuilder(const PlaylistRelayConfig* api, PlaylistRelayStream* observer);
 
   elements::Element* BuildInputSrc() override;
+  bool IsWarmStandbyAvailable() const override;
+  bool IsSoftRestartAvailable() const override;
 
  protected:
   void HandleAppSrcCreated(elements::sources::ElementAppSrc* src);
@@ -14,6 +14,8 @@
 
 #include "stream/streams/builders/relay/relay_stream_builder.h"
 
+#include <math.h>
+
 #include <string>
 
 #include <common/sprintf.h>
@@ -21,11 +23,35 @@
 #include "stream/elements/encoders/audio.h"
 #include "stream/elements/parser/audio.h"
 #include "stream/elements/parser/video.h"
+#include "stream/pad/pad.h"
+
+#if defined(MACHINE_LEARNING)
+#include "base/machine_learning/inference_shm.h"
+
+#include "stream/elements/machine_learning/inference_sink.h"
+#include "stream/elements/machine_learning/tinyyolov2.h"
+#include "stream/elements/sink/fake.h"
+#include "stream/elements/video/video.h"
+#include "stream/streams/relay/relay_stream.h"
+#endif
 
 namespace fastocloud {
 namespace stream {
 namespace streams {
 namespace builders {
+#if defined(MACHINE_LEARNING)
+namespace {
+void analysis_pad_added(GstElement* self, GstPad* new_pad, gpointer user_data) {
+  UNUSED(self);
+  GstElement* rate = static_cast<GstElement*>(user_data);
+  GstPad* sink_pad = gst_element_get_static_pad(rate, "sink");
+  if (!gst_pad_is_linked(sink_pad) && GST_PAD_LINK_FAILED(gst_pad_link(new_pad, sink_pad))) {
+    WARNING_LOG() << "Analysis branch not linked, relay continues without detections";
+  }
+  gst_object_unref(sink_pad);
+}
+}  // namespace
+#endif
 
 RelayStreamBuilder::RelayStreamBuilder(const RelayConfig* config, SrcDecodeBinStream* observer)
     : SrcDecodeStreamBuilder(config, observer) {}
@@ -58,12 +84,21 @@ Connector RelayStreamBuilder::BuildUdbConnections(Connector conn) {
     elements::Element* vudb = BuildVideoUdbConnection();
     CHECK(vudb);
     ElementAdd(vudb);
+    RegisterElement(UDB_VIDEO_ROLE, 0, vudb);
+    if (rconfig->GetThumbnail().IsEnabled()) {  // keyframes already parsed, no decoding of whole stream
+      pad::Pad* thumbnail_pad = vudb->StaticPad("src");
+      if (thumbnail_pad->IsValid()) {
+        HandleThumbnailPadCreated(thumbnail_pad);
+      }
+      delete thumbnail_pad;
+    }
     conn.video = vudb;
   }
   if (rconfig->HaveAudio()) {
     elements::Element* audb = BuildAudioUdbConnection();
     CHECK(audb);
     ElementAdd(audb);
+    RegisterElement(UDB_AUDIO_ROLE, 0, audb);
     std::string audio_parser = rconfig->GetAudioParser();
     if (audio_parser == elements::parser::ElementRawAudioParse::GetPluginName()) {
       elements::encoders::ElementFAAC* faac = elements::encoders::make_aac_encoder(0);
@@ -83,6 +118,8 @@ SupportedVideoCodec RelayStreamBuilder::GetVideoCodecType() const {
     return VIDEO_H264_CODEC;
   } else if (vparser == elements::parser::ElementH265Parse::GetPluginName()) {
     return VIDEO_H265_CODEC;
+  } else if (vparser == elements::parser::ElementAV1Parse::GetPluginName()) {
+    return VIDEO_AV1_CODEC;
   } else if (vparser == elements::parser::ElementTsParse::GetPluginName()) {
     return VIDEO_MPEG_CODEC;
   }
@@ -106,23 +143,147 @@ SupportedAudioCodec RelayStreamBuilder::GetAudioCodecType() const {
   return AUDIO_MPEG_CODEC;
 }
 
+elements::Element* RelayStreamBuilder::BuildAudioTrack(element_id_t track_id) {
+  const RelayConfig* rconfig = static_cast<const RelayConfig*>(GetConfig());
+  const std::string audio_parser = rconfig->GetAudioParser();
+  if (audio_parser == elements::parser::ElementRawAudioParse::GetPluginName()) {
+    return nullptr;  // main track encoded
+  }
+
+  elements::Element* audb =
+      elements::parser::make_audio_parser(audio_parser, common::MemSPrintf(UDB_AUDIO_NAME_1U, track_id));
+  ElementAdd(audb);
+  RegisterElement(UDB_AUDIO_ROLE, track_id, audb);
+  elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(AUDIO_TEE_NAME_1U, track_id));
+  ElementAdd(tee);
+  ElementLink(audb, tee);
+  return tee;
+}
+
 Connector RelayStreamBuilder::BuildConverter(Connector conn) {
   const RelayConfig* config = static_cast<const RelayConfig*>(GetConfig());
   if (config->HaveVideo()) {
     elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(VIDEO_TEE_NAME_1U, 0));
     ElementAdd(tee);
+    RegisterElement(VIDEO_TEE_ROLE, 0, tee);
     ElementLink(conn.video, tee);
     conn.video = tee;
+#if defined(MACHINE_LEARNING)
+    if (config->GetDeepLearning()) {
+      BuildAnalysisBranch(tee);
+      if (config->GetDeepLearningMetadata()) {
+        BuildDetectionsMetadata(tee);
+      }
+    }
+#endif
   }
   if (config->HaveAudio()) {
     elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(AUDIO_TEE_NAME_1U, 0));
     ElementAdd(tee);
+    RegisterElement(AUDIO_TEE_ROLE, 0, tee);
     ElementLink(conn.audio, tee);
     conn.audio = tee;
   }
   return conn;
 }
 
+#if defined(MACHINE_LEARNING)
+void RelayStreamBuilder::BuildAnalysisBranch(elements::Element* video_tee) {
+  const RelayConfig* config = static_cast<const RelayConfig*>(GetConfig());
+  const auto deep_learning = config->GetDeepLearning();
+  RelayStream* stream = static_cast<RelayStream*>(GetObserver());
+
+  elements::ElementQueue* queue = new elements::ElementQueue("ml_analysis_queue_0");
+  queue->SetMaxSizeBuffers(0);
+  queue->SetMaxSizeBytes(0);
+  queue->SetMaxSizeTime(ML_ANALYSIS_QUEUE_MSEC * GST_MSECOND);
+  queue->SetLeaky(2);  // decoder recovers on next keyframe, relay never stalls
+  ElementAdd(queue);
+  ElementLink(video_tee, queue);
+
+  elements::ElementDecodebin* decodebin = new elements::ElementDecodebin("ml_analysis_decodebin_0");
+  ElementAdd(decodebin);
+  ElementLink(queue, decodebin);
+
+  elements::video::ElementVideoRate* rate = new elements::video::ElementVideoRate("ml_analysis_rate_0");
+  rate->SetProperty("drop-only", true);
+  elements::video::ElementVideoConvert* convert =
+      new elements::video::ElementVideoConvert("ml_analysis_convert_0");
+  elements::video::ElementVideoScale* scale = new elements::video::ElementVideoScale("ml_analysis_scale_0");
+  elements::ElementCapsFilter* caps_filter = new elements::ElementCapsFilter("ml_analysis_caps_0");
+  const double inference_rate = deep_learning->GetInferenceRate();
+  const gint framerate = inference_rate > 0 ? static_cast<gint>(ceil(inference_rate)) : ML_ANALYSIS_FRAMERATE;
+  GstCaps* caps = gst_caps_new_simple("video/x-raw", "format", G_TYPE_STRING, "RGB", "width", G_TYPE_INT,
+                                      INFERENCE_SHM_FRAME_WIDTH, "height", G_TYPE_INT, INFERENCE_SHM_FRAME_HEIGHT,
+                                      "framerate", GST_TYPE_FRACTION, framerate, 1, nullptr);
+  caps_filter->SetCaps(caps);
+  gst_caps_unref(caps);
+  ElementAdd(rate);
+  ElementAdd(convert);
+  ElementAdd(scale);
+  ElementAdd(caps_filter);
+  ElementLink(rate, convert);
+  ElementLink(convert, scale);
+  ElementLink(scale, caps_filter);
+  ignore_result(decodebin->RegisterPadAddedCallback(analysis_pad_added, rate->GetGstElement()));
+
+  elements::machine_learning::ElementInferenceSink* shared_sink = nullptr;
+  if (deep_learning->IsShared() && !config->GetInferenceShm().empty()) {
+    shared_sink = new elements::machine_learning::ElementInferenceSink("ml_sink_0");
+    if (!shared_sink->SetInference(config->GetInferenceShm(), 0, deep_learning->GetInferenceInterval(),
+                                   deep_learning->GetInferenceRate())) {
+      WARNING_LOG() << "Shared inference not available, model loaded by stream";
+      gst_object_unref(shared_sink->GetGstElement());
+      delete shared_sink;
+      shared_sink = nullptr;
+    }
+  }
+
+  if (shared_sink) {  // frames answered by inference worker of daemon
+    if (stream) {
+      stream->OnInferenceSinkCreated(shared_sink);
+    }
+    shared_sink->SetSync(false);
+    shared_sink->SetProperty("async", false);
+    ElementAdd(shared_sink);
+    ElementLink(caps_filter, shared_sink);
+    return;
+  }
+
+  elements::machine_learning::ElementVideoMLFilter* tiny =
+      new elements::machine_learning::ElementTinyYolov2("ml_analysis_tiny_0");
+  fastoml::SupportedBackends chosen;
+  GstBackend* backend = elements::machine_learning::make_backend(*deep_learning, &chosen);
+  CHECK(backend) << "Can't allocate ML backend: ";
+  if (stream) {
+    stream->OnMLElementCreated(tiny, chosen);
+  }
+  tiny->SetBackend(backend);
+  elements::sink::ElementFakeSink* sink = new elements::sink::ElementFakeSink("ml_analysis_sink_0");
+  sink->SetSync(false);
+  sink->SetProperty("async", false);
+  ElementAdd(tiny);
+  ElementAdd(sink);
+  ElementLink(caps_filter, tiny);
+  ElementLink(tiny, sink);
+}
+
+void RelayStreamBuilder::BuildDetectionsMetadata(elements::Element* video_tee) {
+  const SupportedVideoCodec codec = GetVideoCodecType();
+  if (codec != VIDEO_H264_CODEC && codec != VIDEO_H265_CODEC) {
+    WARNING_LOG() << "Detections carried only in parsed h264 or h265 video, not sent to players";
+    return;
+  }
+
+  RelayStream* stream = static_cast<RelayStream*>(GetObserver());
+  pad::Pad* sink_pad = video_tee->StaticPad("sink");  // every output gets detections
+  if (stream && sink_pad->IsValid()) {
+    stream->OnDetectionsPadCreated(sink_pad, codec == VIDEO_H265_CODEC);
+  }
+  delete sink_pad;
+}
+#endif
+
 }  // namespace builders
 }  // namespace streams
 }  // namespace stream
@@ -36,6 +36,17 @@ class RelayStreamBuilder : public SrcDecodeStreamBuilder {
 
   Connector BuildPostProc(Connector conn) override;
   Connector BuildConverter(Connector conn) override;
+
+ protected:
+  elements::Element* BuildAudioTrack(element_id_t track_id) override;  // parsed with parser of main track
+
+#if defined(MACHINE_LEARNING)
+ private:
+  // video tee => leaky queue => decodebin => rate and size of model => ml filter or shared inference sink,
+  // relayed video untouched
+  void BuildAnalysisBranch(elements::Element* video_tee);
+  void BuildDetectionsMetadata(elements::Element* video_tee);  // sei inserted into video entering tee
+#endif
 };
 
 }  // namespace builders
@@ -40,15 +40,19 @@ Connector RtspRelayStreamBuilder::BuildInput() {
   input_t prepared = config->GetInput();
   InputUri uri = prepared[0];
   const common::uri::Url url = uri.GetInput();
+  elements::ElementDecodebin* decodebin = new elements::ElementDecodebin(common::MemSPrintf(DECODEBIN_NAME_1U, 0));
+  ElementAdd(decodebin);
+  RegisterElement(DECODEBIN_ROLE, 0, decodebin);
+  HandleDecodebinCreated(decodebin);
+  if (BuildRtspIngest(uri, 0, decodebin)) {
+    return {nullptr, nullptr, nullptr};
+  }
+
   elements::sources::ElementRTSPSrc* src = elements::sources::make_rtsp_src(url.GetUrl(), 0);
   src->SetLatency(0);
   ElementAdd(src);
   HandleRTSPSrcCreated(src);
 
-  elements::ElementDecodebin* decodebin = new elements::ElementDecodebin(common::MemSPrintf(DECODEBIN_NAME_1U, 0));
-  ElementAdd(decodebin);
-  HandleDecodebinCreated(decodebin);
-
   return {nullptr, nullptr, nullptr};
 }
 
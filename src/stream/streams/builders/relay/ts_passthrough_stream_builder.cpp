@@ -0,0 +1,191 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/streams/builders/relay/ts_passthrough_stream_builder.h"
+
+#include <string>
+#include <vector>
+
+#include <common/sprintf.h>
+
+#include "base/constants.h"
+
+#include "stream/elements/element.h"
+#include "stream/elements/parser/video.h"
+#include "stream/pad/pad.h"
+#include "stream/streams/src_decodebin_stream.h"
+#include "stream/ts_packet_filter.h"
+
+namespace fastocloud {
+namespace stream {
+namespace streams {
+namespace builders {
+
+namespace {
+GstPadProbeReturn ts_drop_pids_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  const ts_pids_t* drop_pids = static_cast<const ts_pids_t*>(user_data);
+  GstBuffer* buffer = gst_buffer_make_writable(GST_PAD_PROBE_INFO_BUFFER(info));
+  GST_PAD_PROBE_INFO_DATA(info) = buffer;
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_READWRITE)) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  const size_t left = filter_ts_packets(map.data, map.size, *drop_pids);
+  gst_buffer_unmap(buffer, &map);
+  if (left == 0) {
+    return GST_PAD_PROBE_DROP;
+  }
+
+  gst_buffer_set_size(buffer, left);
+  return GST_PAD_PROBE_OK;
+}
+
+void ts_drop_pids_destroy(gpointer user_data) {
+  delete static_cast<ts_pids_t*>(user_data);
+}
+
+bool IsTsInput(const common::uri::Url& url) {
+  const common::uri::Url::scheme scheme = url.GetScheme();
+  if (scheme == common::uri::Url::udp || scheme == common::uri::Url::srt || scheme == common::uri::Url::tcp) {
+    return true;
+  }
+
+  if (scheme == common::uri::Url::http || scheme == common::uri::Url::https) {  // playlists are not ts
+    const std::string filename = url.GetPath().GetFileName();
+    const std::string ext = CHUNK_EXT;
+    return filename.size() > ext.size() && filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0;
+  }
+  return false;
+}
+
+bool IsTsOutput(const common::uri::Url& url) {
+  const common::uri::Url::scheme scheme = url.GetScheme();
+  // udp gets raw ts here, rtp payloading is done by the regular relay path only
+  return scheme == common::uri::Url::udp || scheme == common::uri::Url::srt || scheme == common::uri::Url::tcp;
+}
+}  // namespace
+
+TsPassthroughStreamBuilder::TsPassthroughStreamBuilder(const RelayConfig* config, SrcDecodeBinStream* observer)
+    : GstBaseBuilder(config, observer) {}
+
+bool TsPassthroughStreamBuilder::IsAvailable(const RelayConfig* config) {
+  const input_t input = config->GetInput();
+  if (!config->GetTsPassthrough() || input.size() != 1 || !IsTsInput(input[0].GetInput())) {
+    return false;
+  }
+#if defined(MACHINE_LEARNING)
+  if (config->GetDeepLearning()) {  // analysis branch needs demuxed video
+    return false;
+  }
+#endif
+
+  const output_t output = config->GetOutput();
+  if (output.empty()) {
+    return false;
+  }
+
+  for (const OutputUri& out : output) {
+    if (!IsTsOutput(out.GetOutput())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Connector TsPassthroughStreamBuilder::BuildInput() {
+  const RelayConfig* config = static_cast<const RelayConfig*>(GetConfig());
+  const input_t input = config->GetInput();
+  const InputUri uri = input[0];
+  elements::Element* src = BuildInputSource(uri, 0);
+
+  elements::parser::ElementTsParse* tsparse = elements::parser::make_ts_parser(0);  // packets aligned for sinks
+  ElementAdd(tsparse);
+  ElementLink(src, tsparse);
+
+  const ts_pids_t drop_pids = config->GetTsDropPids();
+  if (!drop_pids.empty()) {
+    pad::Pad* parsed_pad = tsparse->StaticPad("src");
+    if (parsed_pad->IsValid()) {  // packets are aligned after tsparse
+      gst_pad_add_probe(parsed_pad->GetGstPad(), GST_PAD_PROBE_TYPE_BUFFER, ts_drop_pids_probe,
+                        new ts_pids_t(drop_pids), ts_drop_pids_destroy);
+    }
+    delete parsed_pad;
+  }
+
+  if (IsDirectOutput()) {
+    return {tsparse, nullptr, nullptr};
+  }
+
+  elements::ElementTee* tee = new elements::ElementTee(common::MemSPrintf(VIDEO_TEE_NAME_1U, 0));
+  ElementAdd(tee);
+  ElementLink(tsparse, tee);
+  return {tee, nullptr, nullptr};
+}
+
+Connector TsPassthroughStreamBuilder::BuildUdbConnections(Connector conn) {
+  return conn;
+}
+
+Connector TsPassthroughStreamBuilder::BuildPostProc(Connector conn) {
+  return conn;
+}
+
+Connector TsPassthroughStreamBuilder::BuildConverter(Connector conn) {
+  return conn;
+}
+
+Connector TsPassthroughStreamBuilder::BuildOutput(Connector conn) {
+  const output_t output = GetConfig()->GetOutput();
+  if (IsDirectOutput()) {
+    elements::Element* sink = BuildGenericOutput(output[0], 0);
+    ElementAdd(sink);
+    ElementLink(conn.video, sink);
+    return conn;
+  }
+
+  const std::vector<element_id_t> fanout = GetFanoutOutputs();
+  for (size_t i = 0; i < output.size(); ++i) {
+    if (IsFanoutFollower(fanout, i)) {  // sent by branch of first fan-out output
+      continue;
+    }
+
+    elements::ElementQueue* tee_queue = new elements::ElementQueue(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, i));
+    SetupOutputQueue(tee_queue, i);
+    ElementAdd(tee_queue);
+    ElementLink(conn.video, tee_queue);
+
+    elements::Element* sink =
+        fanout.empty() || fanout.front() != i ? BuildGenericOutput(output[i], i) : BuildFanoutOutput(fanout);
+    ElementAdd(sink);
+    ElementLink(tee_queue, sink);
+  }
+  return conn;
+}
+
+bool TsPassthroughStreamBuilder::IsDirectOutput() const {
+  const Config* config = GetConfig();
+  if (config->GetOutput().size() != 1 || config->GetOutputQueueMsec() || config->GetType() == fastotv::COD_RELAY) {
+    return false;
+  }
+
+  IBaseStream* stream = static_cast<IBaseStream*>(GetObserver());
+  return !stream || !stream->IsOutputsMuted();
+}
+
+}  // namespace builders
+}  // namespace streams
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,49 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "stream/streams/builders/gst_base_builder.h"
+
+#include "stream/streams/configs/relay_config.h"
+
+namespace fastocloud {
+namespace stream {
+namespace streams {
+class SrcDecodeBinStream;
+namespace builders {
+
+// mpegts input forwarded to mpegts outputs as is: src -> tsparse -> tee -> queue -> sink,
+// src -> tsparse -> sink if direct output, nothing demuxed, so no typefinding, parsers or muxers on start
+class TsPassthroughStreamBuilder : public GstBaseBuilder {
+ public:
+  TsPassthroughStreamBuilder(const RelayConfig* config, SrcDecodeBinStream* observer);
+
+  static bool IsAvailable(const RelayConfig* config);  // single udp/srt/tcp/http ts input, udp/srt/tcp outputs
+
+  Connector BuildInput() override;
+  Connector BuildUdbConnections(Connector conn) override;
+  Connector BuildPostProc(Connector conn) override;
+  Connector BuildConverter(Connector conn) override;
+  Connector BuildOutput(Connector conn) override;
+
+ private:
+  // single output without leaky queue or mute gate, packets go to sink on source thread
+  bool IsDirectOutput() const;
+};
+
+}  // namespace builders
+}  // namespace streams
+}  // namespace stream
+}  // namespace fastocloud
@@ -14,11 +14,15 @@
 
 #include "stream/streams/builders/src_decodebin_stream_builder.h"
 
+#include <gst/gstpad.h>
+
+#include <algorithm>
+#include <vector>
+
 #include <common/sprintf.h>
 
 #include "stream/ibase_stream.h"
-
-#include "stream/elements/sources/build_input.h"
+#include "stream/ts_packet_filter.h"
 
 #include "stream/streams/src_decodebin_stream.h"
 
@@ -33,6 +37,30 @@
 namespace fastocloud {
 namespace stream {
 namespace {
+GstPadProbeReturn ts_merge_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  TsPacketMerger* merger = static_cast<TsPacketMerger*>(user_data);
+  GstBuffer* buffer = gst_buffer_make_writable(GST_PAD_PROBE_INFO_BUFFER(info));
+  GST_PAD_PROBE_INFO_DATA(info) = buffer;
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_READWRITE)) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  const size_t left = merger->Merge(map.data, map.size);
+  gst_buffer_unmap(buffer, &map);
+  if (left == 0) {  // whole buffer came by faster path
+    return GST_PAD_PROBE_DROP;
+  }
+
+  gst_buffer_set_size(buffer, left);
+  return GST_PAD_PROBE_OK;
+}
+
+void ts_merge_destroy(gpointer user_data) {
+  delete static_cast<TsPacketMerger*>(user_data);
+}
+
 elements::Element* make_video_pay(SupportedVideoCodec vcodec, element_id_t pay_id) {
   if (vcodec == VIDEO_H264_CODEC) {
     return elements::pay::make_h264_pay(96, pay_id);
@@ -58,6 +86,28 @@ elements::Element* make_audio_pay(SupportedAudioCodec acodec, element_id_t pay_i
   NOTREACHED() << "Please add rtp pay for audio codec type: " << acodec;
   return nullptr;
 }
+
+// one audio stream per muxer on rtp, rtmp, kinesis and icecast, extra tracks for ts and mp4 based outputs
+bool is_multitrack_output(const common::uri::Url& uri) {
+  const common::uri::Url::scheme scheme = uri.GetScheme();
+  return scheme != common::uri::Url::udp && scheme != common::uri::Url::rtmp && !IsKvsUrl(uri) && !IsIcecastUrl(uri);
+}
+
+// muxer of output same for every output with same key, empty if own muxer needed:
+// udp pays in branch, hls sinks cut segments by own key unit requests, reconnected rtmp branch replaced alone
+std::string get_shared_mux_type(const common::uri::Url& uri, bool rtmp_reconnect) {
+  const common::uri::Url::scheme scheme = uri.GetScheme();
+  if (IsKvsUrl(uri) || IsIcecastUrl(uri)) {
+    return std::string();
+  }
+
+  if (scheme == common::uri::Url::tcp || scheme == common::uri::Url::srt) {
+    return "mpegtsmux";
+  } else if (scheme == common::uri::Url::rtmp && !rtmp_reconnect) {
+    return "flvmux";
+  }
+  return std::string();
+}
 }  // namespace
 namespace streams {
 namespace builders {
@@ -66,11 +116,23 @@ SrcDecodeStreamBuilder::SrcDecodeStreamBuilder(const AudioVideoConfig* config, S
     : GstBaseBuilder(config, observer) {}
 
 Connector SrcDecodeStreamBuilder::BuildInput() {
-  elements::Element* src = BuildInputSrc();
+  if (IsWarmStandbyAvailable()) {
+    return BuildWarmStandbyInput();
+  }
+
+  const bool merge = IsHitlessMergeAvailable();
+  elements::Element* src = merge ? BuildHitlessMergeSrc() : BuildInputSrc();
   elements::ElementDecodebin* decodebin = new elements::ElementDecodebin(common::MemSPrintf(DECODEBIN_NAME_1U, 0));
   ElementAdd(decodebin);
+  RegisterElement(DECODEBIN_ROLE, 0, decodebin);
   ElementLink(src, decodebin);
   HandleDecodebinCreated(decodebin);
+  if (!merge && IsSoftRestartAvailable()) {
+    SrcDecodeBinStream* stream = static_cast<SrcDecodeBinStream*>(GetObserver());
+    if (stream) {
+      stream->OnInputChainCreated(src, decodebin);
+    }
+  }
 
   return {nullptr, nullptr, nullptr};
 }
@@ -85,25 +147,115 @@ void SrcDecodeStreamBuilder::HandleDecodebinCreated(elements::ElementDecodebin*
 elements::Element* SrcDecodeStreamBuilder::BuildInputSrc() {
   const Config* config = GetConfig();
   input_t prepared = config->GetInput();
-  InputUri uri = prepared[0];
-  const common::uri::Url url = uri.GetInput();
-  elements::Element* src = elements::sources::make_src(uri, 0, IBaseStream::src_timeout_sec);
-  pad::Pad* src_pad = src->StaticPad("src");
+  return MakeInputSrc(prepared[0], 0);
+}
+
+elements::Element* SrcDecodeStreamBuilder::MakeInputSrc(const InputUri& uri, element_id_t input_id) {
+  return BuildInputSource(uri, input_id);
+}
+
+bool SrcDecodeStreamBuilder::IsWarmStandbyAvailable() const {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  return config->GetWarmStandby() && config->GetInput().size() > 1;
+}
+
+bool SrcDecodeStreamBuilder::IsSoftRestartAvailable() const {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  IBaseStream* stream = static_cast<IBaseStream*>(GetObserver());
+  // vod sources end with eos, shared inputs change role on full restart only
+  return config->GetSoftRestart() && !stream->IsVod() && config->GetIngestDir().empty();
+}
+
+bool SrcDecodeStreamBuilder::IsHitlessMergeAvailable() const {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const input_t input = config->GetInput();
+  if (!config->GetHitlessMerge() || input.size() < 2) {
+    return false;
+  }
+
+  for (const InputUri& uri : input) {
+    if (uri.GetInput().GetScheme() != common::uri::Url::srt) {
+      return false;
+    }
+  }
+  return true;
+}
+
+elements::Element* SrcDecodeStreamBuilder::BuildHitlessMergeSrc() {
+  elements::ElementFunnel* funnel = new elements::ElementFunnel(common::MemSPrintf(MERGE_FUNNEL_NAME_1U, 0));
+  funnel->SetForwardStickyEvents(false);  // stream of paths is one stream for decodebin
+  ElementAdd(funnel);
+
+  const input_t input = GetConfig()->GetInput();
+  for (size_t i = 0; i < input.size(); ++i) {
+    elements::Element* src = MakeInputSrc(input[i], i);
+    ElementLink(src, funnel);
+  }
+
+  pad::Pad* src_pad = funnel->StaticPad("src");
   if (src_pad->IsValid()) {
-    HandleInputSrcPadCreated(src_pad, 0, url);
+    gst_pad_add_probe(src_pad->GetGstPad(), GST_PAD_PROBE_TYPE_BUFFER, ts_merge_probe, new TsPacketMerger,
+                      ts_merge_destroy);
   }
   delete src_pad;
-  ElementAdd(src);
-  return src;
+  return funnel;
+}
+
+Connector SrcDecodeStreamBuilder::BuildWarmStandbyInput() {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  elements::ElementInputSelector* video_selector = nullptr;
+  elements::ElementInputSelector* audio_selector = nullptr;
+  if (config->HaveVideo()) {
+    video_selector = new elements::ElementInputSelector(common::MemSPrintf(VIDEO_INPUT_SELECTOR_NAME_1U, 0));
+    video_selector->SetSyncStreams(false);  // inactive inputs dropped, not blocked
+    ElementAdd(video_selector);
+    elements::ElementDecodebin* decodebin =
+        new elements::ElementDecodebin(common::MemSPrintf(VIDEO_DECODEBIN_NAME_1U, 0));
+    ElementAdd(decodebin);
+    ElementLink(video_selector, decodebin);
+    HandleDecodebinCreated(decodebin);
+  }
+  if (config->HaveAudio()) {
+    audio_selector = new elements::ElementInputSelector(common::MemSPrintf(AUDIO_INPUT_SELECTOR_NAME_1U, 0));
+    audio_selector->SetSyncStreams(false);
+    ElementAdd(audio_selector);
+    elements::ElementDecodebin* decodebin =
+        new elements::ElementDecodebin(common::MemSPrintf(AUDIO_DECODEBIN_NAME_1U, 0));
+    ElementAdd(decodebin);
+    ElementLink(audio_selector, decodebin);
+    HandleDecodebinCreated(decodebin);
+  }
+
+  const input_t input = config->GetInput();
+  std::vector<elements::Element*> parsebins;
+  for (size_t i = 0; i < input.size(); ++i) {
+    elements::Element* src = MakeInputSrc(input[i], i);
+    elements::ElementParsebin* parsebin = new elements::ElementParsebin(common::MemSPrintf(PARSEBIN_NAME_1U, i));
+    ElementAdd(parsebin);
+    ElementLink(src, parsebin);
+    parsebins.push_back(parsebin);
+  }
+
+  SrcDecodeBinStream* stream = static_cast<SrcDecodeBinStream*>(GetObserver());
+  if (stream) {
+    stream->OnWarmStandbyCreated(parsebins, video_selector, audio_selector);
+  }
+  return {nullptr, nullptr, nullptr};
+}
+
+elements::ElementQueue* SrcDecodeStreamBuilder::BuildQueue(const std::string& name) {
+  elements::ElementQueue* queue = new elements::ElementQueue(name);
+  SetupQueue(queue, false);
+  return queue;
 }
 
 elements::Element* SrcDecodeStreamBuilder::BuildVideoUdbConnection() {
-  elements::ElementQueue* video_queue = new elements::ElementQueue(common::MemSPrintf(UDB_VIDEO_NAME_1U, 0));
+  elements::ElementQueue* video_queue = BuildQueue(common::MemSPrintf(UDB_VIDEO_NAME_1U, 0));
   return video_queue;
 }
 
 elements::Element* SrcDecodeStreamBuilder::BuildAudioUdbConnection() {
-  elements::ElementQueue* audio_queue = new elements::ElementQueue(common::MemSPrintf(UDB_AUDIO_NAME_1U, 0));
+  elements::ElementQueue* audio_queue = BuildQueue(common::MemSPrintf(UDB_AUDIO_NAME_1U, 0));
   return audio_queue;
 }
 
@@ -115,22 +267,113 @@ Connector SrcDecodeStreamBuilder::BuildUdbConnections(Connector conn) {
     elements::Element* vudb = BuildVideoUdbConnection();
     CHECK(vudb);
     ElementAdd(vudb);
+    RegisterElement(UDB_VIDEO_ROLE, 0, vudb);
     conn.video = vudb;
   }
   if (config->HaveAudio()) {
     elements::Element* audb = BuildAudioUdbConnection();
     CHECK(audb);
     ElementAdd(audb);
+    RegisterElement(UDB_AUDIO_ROLE, 0, audb);
     conn.audio = audb;
   }
   return conn;
 }
 
+elements::Element* SrcDecodeStreamBuilder::GetOutputVideoSource(Connector conn, const OutputUri& output) {
+  UNUSED(output);
+  return conn.video;
+}
+
+elements::Element* SrcDecodeStreamBuilder::BuildAudioTrack(element_id_t track_id) {
+  UNUSED(track_id);
+  return nullptr;
+}
+
+std::vector<elements::Element*> SrcDecodeStreamBuilder::BuildAudioTracks() {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const AudioVideoConfig::audio_tracks_t tracks = config->GetAudioTracks();
+  std::vector<elements::Element*> tees;
+  const output_t out = config->GetOutput();
+  const bool multitrack = std::any_of(out.begin(), out.end(), [](const OutputUri& output) {
+    return is_multitrack_output(output.GetOutput());
+  });
+  if (tracks.empty() || !config->HaveAudio() || !multitrack) {  // tee without outputs stops its track
+    return tees;
+  }
+
+  if (IsWarmStandbyAvailable()) {  // input-selector passes one track per type
+    WARNING_LOG() << "Audio tracks not muxed in warm standby mode";
+    return tees;
+  }
+
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    elements::Element* tee = BuildAudioTrack(i + 1);
+    if (!tee) {
+      WARNING_LOG() << "Audio track " << tracks[i] << " not supported by stream";
+      break;
+    }
+    tees.push_back(tee);
+  }
+  return tees;
+}
+
+std::map<element_id_t, element_id_t> SrcDecodeStreamBuilder::GetSharedMuxOutputs(
+    Connector conn,
+    const std::vector<element_id_t>& fanout) {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const output_t out = config->GetOutput();
+  std::map<std::string, element_id_t> firsts;  // key => first output
+  std::map<element_id_t, element_id_t> followers;
+  for (size_t i = 0; i < out.size(); ++i) {
+    const common::uri::Url uri = out[i].GetOutput();
+    const std::string type = get_shared_mux_type(uri, config->GetRtmpReconnect());
+    if (type.empty() || std::find(fanout.begin(), fanout.end(), i) != fanout.end()) {
+      continue;
+    }
+
+    // renditions feed own outputs, multitrack muxer gets extra audio pads
+    const std::string key = common::MemSPrintf("%s_%p_%d", type, GetOutputVideoSource(conn, out[i]),
+                                               is_multitrack_output(uri) ? 1 : 0);
+    const auto it = firsts.find(key);
+    if (it == firsts.end()) {
+      firsts[key] = i;
+    } else {
+      followers[i] = it->second;
+    }
+  }
+  return followers;
+}
+
 Connector SrcDecodeStreamBuilder::BuildOutput(Connector conn) {
   const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
   output_t out = config->GetOutput();
+  const std::vector<element_id_t> fanout = GetFanoutOutputs();
+  const std::vector<elements::Element*> audio_tracks = BuildAudioTracks();
+  const std::map<element_id_t, element_id_t> mux_followers = GetSharedMuxOutputs(conn, fanout);
+  std::map<element_id_t, elements::Element*> mux_tees;  // first output => tee after its muxer
+  for (const auto& follower : mux_followers) {
+    mux_tees[follower.second] = nullptr;
+  }
+
   for (size_t i = 0; i < out.size(); ++i) {
+    if (IsFanoutFollower(fanout, i)) {  // sent by branch of first fan-out output
+      continue;
+    }
+
     const OutputUri output = out[i];
+    const auto shared_mux = mux_followers.find(i);
+    if (shared_mux != mux_followers.end()) {  // muxed by first output, own queue keeps slow sink off others
+      elements::ElementQueue* mux_queue = BuildQueue(common::MemSPrintf(MUX_TEE_QUEUE_NAME_1U, i));
+      SetupOutputQueue(mux_queue, i);
+      ElementAdd(mux_queue);
+      ElementLink(mux_tees[shared_mux->second], mux_queue);
+      elements::Element* sink = BuildGenericOutput(output, i);
+      ElementAdd(sink);
+      ElementLink(mux_queue, sink);
+      continue;
+    }
+
     SinkDeviceType dt;
     if (IsDeviceOutUrl(output.GetOutput(), &dt)) {  // monitor
       CRITICAL_LOG() << "Decklink not supported for encoding based streams!";
@@ -140,15 +383,22 @@ Connector SrcDecodeStreamBuilder::BuildOutput(Connector conn) {
     common::uri::Url uri = output.GetOutput();
     common::uri::Url::scheme scheme = uri.GetScheme();
     bool is_rtp_out = scheme == common::uri::Url::udp;
-    elements::Element* mux = elements::muxer::make_muxer(scheme, i);
+    const bool is_kvs_out = IsKvsUrl(uri);
+    const bool is_icecast_out = IsIcecastUrl(uri);
+    // kvssink fragments parsed streams itself, shout2send takes elementary mp3, both linked in place of muxer
+    elements::Element* mux = is_kvs_out || is_icecast_out ? CreateSink(output, i)
+                                                          : elements::muxer::make_muxer(scheme, i, config->GetCmaf());
     ElementAdd(mux);
+    elements::Element* video_input = nullptr;
+    elements::Element* audio_input = nullptr;
 
-    if (config->HaveVideo()) {
-      elements::ElementQueue* video_tee_queue =
-          new elements::ElementQueue(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, i));
+    if (config->HaveVideo() && !is_icecast_out) {
+      elements::ElementQueue* video_tee_queue = BuildQueue(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, i));
+      SetupOutputQueue(video_tee_queue, i);
       ElementAdd(video_tee_queue);
       elements::Element* next = video_tee_queue;
-      ElementLink(conn.video, next);
+      ElementLink(GetOutputVideoSource(conn, output), next);
+      video_input = video_tee_queue;
 
       if (is_rtp_out) {
         elements::Element* rtp_pay = make_video_pay(GetVideoCodecType(), i);
@@ -161,11 +411,12 @@ Connector SrcDecodeStreamBuilder::BuildOutput(Connector conn) {
     }
 
     if (config->HaveAudio()) {
-      elements::ElementQueue* audio_tee_queue =
-          new elements::ElementQueue(common::MemSPrintf(AUDIO_TEE_QUEUE_NAME_1U, i));
+      elements::ElementQueue* audio_tee_queue = BuildQueue(common::MemSPrintf(AUDIO_TEE_QUEUE_NAME_1U, i));
+      SetupOutputQueue(audio_tee_queue, i);
       ElementAdd(audio_tee_queue);
       elements::Element* next = audio_tee_queue;
       ElementLink(conn.audio, next);
+      audio_input = audio_tee_queue;
 
       if (is_rtp_out) {
         elements::Element* rtp_pay = make_audio_pay(GetAudioCodecType(), i);
@@ -177,9 +428,52 @@ Connector SrcDecodeStreamBuilder::BuildOutput(Connector conn) {
       ElementLink(next, mux);
     }
 
-    elements::Element* sink = BuildGenericOutput(output, i);
+    const bool multitrack = is_multitrack_output(uri);
+    for (size_t j = 0; multitrack && j < audio_tracks.size(); ++j) {
+      elements::ElementQueue* track_queue =
+          BuildQueue(common::MemSPrintf(AUDIO_TRACK_TEE_QUEUE_NAME_2U, i, j + 1));
+      SetupOutputQueue(track_queue, i);
+      ElementAdd(track_queue);
+      ElementLink(audio_tracks[j], track_queue);
+      ElementLink(track_queue, mux);
+    }
+
+    if (is_kvs_out || is_icecast_out) {  // kvssink has no static sink pad, peer of queue probed for both
+      elements::Element* probed = video_input ? video_input : audio_input;
+      pad::Pad* src_pad = probed ? probed->StaticPad("src") : nullptr;
+      if (src_pad && src_pad->IsValid()) {
+        GstPad* peer = gst_pad_get_peer(src_pad->GetGstPad());
+        if (peer) {
+          pad::Pad sink_pad(peer);
+          HandleOutputSinkPadCreated(&sink_pad, i, uri, false);
+          gst_object_unref(peer);
+        }
+      }
+      delete src_pad;
+      continue;
+    }
+
+    elements::Element* mux_out = mux;
+    if (mux_tees.find(i) != mux_tees.end()) {
+      elements::ElementTee* mux_tee = new elements::ElementTee(common::MemSPrintf(MUX_TEE_NAME_1U, i));
+      ElementAdd(mux_tee);
+      ElementLink(mux, mux_tee);
+      mux_tees[i] = mux_tee;
+      elements::ElementQueue* mux_queue = BuildQueue(common::MemSPrintf(MUX_TEE_QUEUE_NAME_1U, i));
+      SetupOutputQueue(mux_queue, i);
+      ElementAdd(mux_queue);
+      ElementLink(mux_tee, mux_queue);
+      mux_out = mux_queue;
+    }
+
+    elements::Element* sink =
+        fanout.empty() || fanout.front() != i ? BuildGenericOutput(output, i) : BuildFanoutOutput(fanout);
     ElementAdd(sink);
-    ElementLink(mux, sink);
+    ElementLink(mux_out, sink);
+
+    if (scheme == common::uri::Url::rtmp && config->GetRtmpReconnect()) {  // cdn ingest flaps, no pays in branch
+      HandleOutputBranchCreated(i, video_input, audio_input, {mux, sink});
+    }
   }
   return conn;
 }
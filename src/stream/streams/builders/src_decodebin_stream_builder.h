@@ -14,12 +14,20 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/input_uri.h"
+#include "base/output_uri.h"
+
 #include "stream/streams/builders/gst_base_builder.h"
 
 namespace fastocloud {
 namespace stream {
 namespace elements {
 class ElementDecodebin;
+class ElementQueue;
 }
 namespace streams {
 class SrcDecodeBinStream;
@@ -32,6 +40,9 @@ class SrcDecodeStreamBuilder : public GstBaseBuilder {
 
   Connector BuildInput() override;
   virtual elements::Element* BuildInputSrc();
+  virtual bool IsWarmStandbyAvailable() const;  // inputs are live sources which can be built by MakeInputSrc
+  virtual bool IsSoftRestartAvailable() const;   // input can be rebuilt by make_src while pipeline plays
+  bool IsHitlessMergeAvailable() const;          // every input is srt path of same ts
 
   Connector BuildUdbConnections(Connector conn) override;
   virtual elements::Element* BuildVideoUdbConnection();
@@ -46,6 +57,22 @@ class SrcDecodeStreamBuilder : public GstBaseBuilder {
 
  protected:
   void HandleDecodebinCreated(elements::ElementDecodebin* decodebin);
+  elements::Element* MakeInputSrc(const InputUri& uri, element_id_t input_id);
+  virtual elements::ElementQueue* BuildQueue(const std::string& name);  // every queue between input and sinks
+  virtual elements::Element* GetOutputVideoSource(Connector conn, const OutputUri& output);
+  // udb connection of extra input audio track registered with track id, returns tee linked to outputs,
+  // nullptr if stream can't carry more tracks
+  virtual elements::Element* BuildAudioTrack(element_id_t track_id);
+
+ private:
+  std::vector<elements::Element*> BuildAudioTracks();  // tees of config audio tracks, ids from 1
+  // outputs with equal muxer and tracks, first one muxes for all through tee, follower => first
+  std::map<element_id_t, element_id_t> GetSharedMuxOutputs(Connector conn, const std::vector<element_id_t>& fanout);
+
+  // every input parsed and kept flowing, input-selector per track passes one of them to decodebin
+  Connector BuildWarmStandbyInput();
+  // every path linked to funnel, packets already passed by other path dropped on funnel output
+  elements::Element* BuildHitlessMergeSrc();
 };
 
 }  // namespace builders
@@ -14,6 +14,8 @@
 
 #include "stream/streams/builders/test/test_input_stream_builder.h"
 
+#include "base/input_uri.h"
+
 #include "stream/elements/element.h"  // for Element
 #include "stream/elements/sources/sources.h"
 
@@ -30,9 +32,19 @@ TestInputStreamBuilder::TestInputStreamBuilder(const EncodeConfig* api, SrcDecod
 Connector TestInputStreamBuilder::BuildInput() {
   elements::Element* video = nullptr;
   const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  const input_t input = config->GetInput();
+  LoadGenerator generator;
+  const bool load = !input.empty() && GetLoadGenerator(input[0], &generator);
   if (config->HaveVideo()) {
-    video = new elements::sources::ElementVideoTestSrc("video_src");
-    ElementAdd(video);
+    elements::sources::ElementVideoTestSrc* video_src = new elements::sources::ElementVideoTestSrc("video_src");
+    ElementAdd(video_src);
+    video = video_src;
+    if (load) {
+      video_src->SetIsLive(true);
+      video_src->SetPattern(generator.pattern);
+      video_src->SetHorizontalSpeed(generator.speed);
+      video = BuildLoadCaps(video_src);
+    }
     pad::Pad* src_pad = video->StaticPad("src");
     if (src_pad->IsValid()) {
       HandleInputSrcPadCreated(src_pad, 0, common::uri::Url());
@@ -42,8 +54,13 @@ Connector TestInputStreamBuilder::BuildInput() {
 
   elements::Element* audio = nullptr;
   if (config->HaveAudio()) {
-    audio = new elements::sources::ElementAudioTestSrc("audio_src");
-    ElementAdd(audio);
+    elements::sources::ElementAudioTestSrc* audio_src = new elements::sources::ElementAudioTestSrc("audio_src");
+    ElementAdd(audio_src);
+    audio = audio_src;
+    if (load) {
+      audio_src->SetIsLive(true);
+      audio_src->SetWave(generator.wave);
+    }
     pad::Pad* src_pad = audio->StaticPad("src");
     if (src_pad->IsValid()) {
       HandleInputSrcPadCreated(src_pad, 0, common::uri::Url());
@@ -53,6 +70,30 @@ Connector TestInputStreamBuilder::BuildInput() {
   return {video, audio, nullptr};
 }
 
+elements::Element* TestInputStreamBuilder::BuildLoadCaps(elements::Element* video_src) {
+  const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  const common::draw::Size size = config->GetSize();
+  const auto framerate = config->GetFramerate();
+  if (!size.IsValid() && !framerate) {
+    return video_src;
+  }
+
+  // frames generated in output size and rate, encoder gets whole complexity instead of upscaled default picture
+  GstCaps* caps = gst_caps_new_empty_simple("video/x-raw");
+  if (size.IsValid()) {
+    gst_caps_set_simple(caps, "width", G_TYPE_INT, size.width, "height", G_TYPE_INT, size.height, nullptr);
+  }
+  if (framerate) {
+    gst_caps_set_simple(caps, "framerate", GST_TYPE_FRACTION, *framerate, 1, nullptr);
+  }
+  elements::ElementCapsFilter* capsfilter = new elements::ElementCapsFilter("video_src_caps");
+  capsfilter->SetCaps(caps);
+  gst_caps_unref(caps);
+  ElementAdd(capsfilter);
+  ElementLink(video_src, capsfilter);
+  return capsfilter;
+}
+
 Connector TestInputStreamBuilder::BuildUdbConnections(Connector conn) {
   return conn;
 }
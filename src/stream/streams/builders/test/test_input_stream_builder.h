@@ -27,6 +27,9 @@ class TestInputStreamBuilder : public EncodingStreamBuilder {
   TestInputStreamBuilder(const EncodeConfig* api, SrcDecodeBinStream* observer);
   Connector BuildInput() override;
   Connector BuildUdbConnections(Connector conn) override;
+
+ private:
+  elements::Element* BuildLoadCaps(elements::Element* video_src);  // video_src if size and rate not set
 };
 
 }  // namespace builders
@@ -39,6 +39,10 @@ elements::Element* TimeShiftPlayerBuilder::BuildInputSrc() {
   return multifilesrc;
 }
 
+bool TimeShiftPlayerBuilder::IsSoftRestartAvailable() const {
+  return false;  // chunks played from start index, input is not a make_src uri
+}
+
 }  // namespace builders
 }  // namespace streams
 }  // namespace stream
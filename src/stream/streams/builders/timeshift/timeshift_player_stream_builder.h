@@ -32,6 +32,7 @@ class TimeShiftPlayerBuilder : public RelayStreamBuilder {
                          SrcDecodeBinStream* observer);
 
   elements::Element* BuildInputSrc() override;
+  bool IsSoftRestartAvailable() const override;
 
  private:
   TimeShiftInfo tinfo_;
@@ -17,6 +17,7 @@
 #include <common/sprintf.h>
 
 #include "stream/elements/muxer/muxer.h"
+#include "stream/elements/sink/chunk.h"
 #include "stream/elements/sink/sink.h"
 
 #include "stream/streams/timeshift/timeshift_recorder_stream.h"
@@ -34,6 +35,7 @@ Connector TimeShiftRecorderStreamBuilder::BuildOutput(Connector conn) {
   elements::sink::ElementSplitMuxSink* splitmuxsink =
       new elements::sink::ElementSplitMuxSink(common::MemSPrintf(SPLIT_SINK_NAME_1U, 0));
   ElementAdd(splitmuxsink);
+  RegisterElement(SPLIT_SINK_ROLE, 0, splitmuxsink);
 
   const TimeshiftConfig* tconf = static_cast<const TimeshiftConfig*>(GetConfig());
   elements::muxer::ElementMPEGTSMux* mpegtsmux = elements::muxer::make_mpegtsmux(0);
@@ -41,6 +43,12 @@ Connector TimeShiftRecorderStreamBuilder::BuildOutput(Connector conn) {
   splitmuxsink->SetMuxer(mpegtsmux);
   delete mpegtsmux;
 
+  if (tconf->GetTimeShiftChunkWriter() || tconf->GetTimeShiftHourFiles()) {  // filesink can't append
+    elements::sink::ElementChunkSink* chunk_sink = elements::sink::make_chunk_sink(0, tconf->GetTimeShiftDirectIO());
+    splitmuxsink->SetSink(chunk_sink);
+    delete chunk_sink;
+  }
+
   splitmuxsink->SetMaxSizeTime(mst_nsec);
   HandleSplitmuxsinkCreated(conn, splitmuxsink);
   return conn;
@@ -26,8 +26,16 @@ AudioVideoConfig::AudioVideoConfig(const base_class& config)
       have_audio_(true),
       have_subtitle_(false),
       audio_select_(),
+      audio_tracks_(),
       avformat_(DEFAULT_AVFORMAT),
-      loop_(DEFAULT_LOOP) {}
+      loop_(DEFAULT_LOOP),
+      mmap_(false),
+      warm_standby_(false),
+      hitless_merge_(false),
+      soft_restart_(false),
+      gapless_(false),
+      autoplug_cache_(),
+      hw_decode_() {}
 
 AudioVideoConfig::have_stream_t AudioVideoConfig::HaveVideo() const {
   return have_video_;
@@ -61,6 +69,14 @@ void AudioVideoConfig::SetAudioSelect(audio_select_t sel) {
   audio_select_ = sel;
 }
 
+AudioVideoConfig::audio_tracks_t AudioVideoConfig::GetAudioTracks() const {
+  return audio_tracks_;
+}
+
+void AudioVideoConfig::SetAudioTracks(const audio_tracks_t& tracks) {
+  audio_tracks_ = tracks;
+}
+
 AudioVideoConfig::avformat_t AudioVideoConfig::IsAvFormat() const {
   return avformat_;
 }
@@ -77,6 +93,62 @@ void AudioVideoConfig::SetLoop(loop_t loop) {
   loop_ = loop;
 }
 
+AudioVideoConfig::mmap_t AudioVideoConfig::IsMmap() const {
+  return mmap_;
+}
+
+void AudioVideoConfig::SetMmap(mmap_t mmap) {
+  mmap_ = mmap;
+}
+
+AudioVideoConfig::warm_standby_t AudioVideoConfig::GetWarmStandby() const {
+  return warm_standby_;
+}
+
+void AudioVideoConfig::SetWarmStandby(warm_standby_t standby) {
+  warm_standby_ = standby;
+}
+
+AudioVideoConfig::hitless_merge_t AudioVideoConfig::GetHitlessMerge() const {
+  return hitless_merge_;
+}
+
+void AudioVideoConfig::SetHitlessMerge(hitless_merge_t merge) {
+  hitless_merge_ = merge;
+}
+
+AudioVideoConfig::soft_restart_t AudioVideoConfig::GetSoftRestart() const {
+  return soft_restart_;
+}
+
+void AudioVideoConfig::SetSoftRestart(soft_restart_t soft) {
+  soft_restart_ = soft;
+}
+
+AudioVideoConfig::gapless_t AudioVideoConfig::GetGapless() const {
+  return gapless_;
+}
+
+void AudioVideoConfig::SetGapless(gapless_t gapless) {
+  gapless_ = gapless;
+}
+
+AudioVideoConfig::autoplug_cache_t AudioVideoConfig::GetAutoplugCache() const {
+  return autoplug_cache_;
+}
+
+void AudioVideoConfig::SetAutoplugCache(autoplug_cache_t path) {
+  autoplug_cache_ = path;
+}
+
+AudioVideoConfig::hw_decode_t AudioVideoConfig::GetHwDecode() const {
+  return hw_decode_;
+}
+
+void AudioVideoConfig::SetHwDecode(hw_decode_t hw) {
+  hw_decode_ = hw;
+}
+
 AudioVideoConfig* AudioVideoConfig::Clone() const {
   return new AudioVideoConfig(*this);
 }
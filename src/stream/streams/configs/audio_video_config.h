@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include <common/file_system/path.h>
+
 #include "stream/config.h"
 
 namespace fastocloud {
@@ -24,7 +28,15 @@ class AudioVideoConfig : public Config {
  public:
   typedef Config base_class;
   typedef common::Optional<int> audio_select_t;
+  typedef std::vector<int> audio_tracks_t;
   typedef bool loop_t;
+  typedef bool mmap_t;
+  typedef bool warm_standby_t;
+  typedef bool hitless_merge_t;
+  typedef bool soft_restart_t;
+  typedef bool gapless_t;
+  typedef common::Optional<common::file_system::ascii_file_string_path> autoplug_cache_t;
+  typedef common::Optional<bool> hw_decode_t;
   typedef bool avformat_t;
   typedef bool have_stream_t;
   explicit AudioVideoConfig(const base_class& config);
@@ -41,12 +53,36 @@ class AudioVideoConfig : public Config {
   audio_select_t GetAudioSelect() const;
   void SetAudioSelect(audio_select_t sel);
 
+  audio_tracks_t GetAudioTracks() const;  // relay, encoding, pad ids of tracks muxed next to selected one
+  void SetAudioTracks(const audio_tracks_t& tracks);
+
   avformat_t IsAvFormat() const;
   void SetIsAvFormat(avformat_t av);
 
   loop_t GetLoop() const;
   void SetLoop(loop_t loop);
 
+  mmap_t IsMmap() const;  // playlist
+  void SetMmap(mmap_t mmap);
+
+  warm_standby_t GetWarmStandby() const;  // relay, encoding, second input is hot backup of first
+  void SetWarmStandby(warm_standby_t standby);
+
+  hitless_merge_t GetHitlessMerge() const;  // relay, encoding, srt inputs carry same ts over different paths
+  void SetHitlessMerge(hitless_merge_t merge);
+
+  soft_restart_t GetSoftRestart() const;  // relay, encoding, failed input rebuilt without restart of pipeline
+  void SetSoftRestart(soft_restart_t soft);
+
+  gapless_t GetGapless() const;  // playlist encoding, files demuxed and concatenated per track before decoders
+  void SetGapless(gapless_t gapless);
+
+  autoplug_cache_t GetAutoplugCache() const;  // relay, encoding, single input only
+  void SetAutoplugCache(autoplug_cache_t path);
+
+  hw_decode_t GetHwDecode() const;  // set by daemon, hardware decoders ranked first or last, unset plugin ranks
+  void SetHwDecode(hw_decode_t hw);
+
   AudioVideoConfig* Clone() const override;
 
  private:
@@ -54,8 +90,16 @@ class AudioVideoConfig : public Config {
   have_stream_t have_audio_;
   have_stream_t have_subtitle_;
   audio_select_t audio_select_;
+  audio_tracks_t audio_tracks_;
   avformat_t avformat_;
   loop_t loop_;
+  mmap_t mmap_;
+  warm_standby_t warm_standby_;
+  hitless_merge_t hitless_merge_;
+  soft_restart_t soft_restart_;
+  gapless_t gapless_;
+  autoplug_cache_t autoplug_cache_;
+  hw_decode_t hw_decode_;
 };
 
 }  // namespace streams
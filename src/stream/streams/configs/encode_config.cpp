@@ -33,6 +33,7 @@ EncodeConfig::EncodeConfig(const base_class& config)
       deinterlace_(),
       frame_rate_(),
       volume_(),
+      loudness_target_(),
       video_encoder_(DEFAULT_VIDEO_ENCODER),
       audio_encoder_(DEFAULT_AUDIO_ENCODER),
       audio_channels_count_(),
@@ -40,17 +41,28 @@ EncodeConfig::EncodeConfig(const base_class& config)
       video_encoder_str_args_(),
       size_(),
       video_bit_rate_(),
+      video_min_bit_rate_(),
       audio_bit_rate_(),
       logo_(),
       rsvg_logo_(),
+      assets_dir_(),
 #if defined(MACHINE_LEARNING)
       learning_(),
       learning_overlay_(),
+      inference_shm_(),
+      learning_metadata_(false),
 #endif
       decklink_video_mode_(DEFAULT_DECKLINK_VIDEO_MODE),
+      v4l2_io_mode_(),
       aspect_ratio_(),
+      renditions_(),
+      gpu_device_(),
       relay_video_(false),
-      relay_audio_(false) {
+      relay_audio_(false),
+      passthrough_(false),
+      low_latency_(false),
+      network_feedback_(false),
+      audio_dithering_(true) {
 }
 
 bool EncodeConfig::GetRelayVideo() const {
@@ -69,6 +81,38 @@ void EncodeConfig::SetRelayAudio(bool ra) {
   relay_audio_ = ra;
 }
 
+bool EncodeConfig::GetPassthrough() const {
+  return passthrough_;
+}
+
+void EncodeConfig::SetPassthrough(bool passthrough) {
+  passthrough_ = passthrough;
+}
+
+bool EncodeConfig::GetLowLatency() const {
+  return low_latency_;
+}
+
+void EncodeConfig::SetLowLatency(bool low_latency) {
+  low_latency_ = low_latency;
+}
+
+bool EncodeConfig::GetNetworkFeedback() const {
+  return network_feedback_;
+}
+
+void EncodeConfig::SetNetworkFeedback(bool feedback) {
+  network_feedback_ = feedback;
+}
+
+bool EncodeConfig::GetAudioDithering() const {
+  return audio_dithering_;
+}
+
+void EncodeConfig::SetAudioDithering(bool dithering) {
+  audio_dithering_ = dithering;
+}
+
 void EncodeConfig::SetVolume(volume_t volume) {
   volume_ = volume;
 }
@@ -77,6 +121,14 @@ volume_t EncodeConfig::GetVolume() const {
   return volume_;
 }
 
+loudness_t EncodeConfig::GetLoudnessTarget() const {
+  return loudness_target_;
+}
+
+void EncodeConfig::SetLoudnessTarget(loudness_t target) {
+  loudness_target_ = target;
+}
+
 frame_rate_t EncodeConfig::GetFramerate() const {
   return frame_rate_;
 }
@@ -129,6 +181,11 @@ bool EncodeConfig::IsMfxGpu() const {
   return false;
 }
 
+bool EncodeConfig::IsNvGpu() const {
+  const std::string video_enc = GetVideoEncoder();
+  return video_enc == NV_H264_ENC || video_enc == NV_H265_ENC || video_enc == NV_AV1_ENC;
+}
+
 audio_channels_count_t EncodeConfig::GetAudioChannelsCount() const {
   return audio_channels_count_;
 }
@@ -153,6 +210,14 @@ void EncodeConfig::SetVideoBitrate(bit_rate_t bitr) {
   video_bit_rate_ = bitr;
 }
 
+bit_rate_t EncodeConfig::GetVideoMinBitrate() const {
+  return video_min_bit_rate_;
+}
+
+void EncodeConfig::SetVideoMinBitrate(bit_rate_t bitr) {
+  video_min_bit_rate_ = bitr;
+}
+
 bit_rate_t EncodeConfig::GetAudioBitrate() const {
   return audio_bit_rate_;
 }
@@ -193,6 +258,14 @@ void EncodeConfig::SetRSVGLogo(const rsvg_logo_t& logo) {
   rsvg_logo_ = logo;
 }
 
+EncodeConfig::assets_dir_t EncodeConfig::GetAssetsDir() const {
+  return assets_dir_;
+}
+
+void EncodeConfig::SetAssetsDir(assets_dir_t dir) {
+  assets_dir_ = dir;
+}
+
 #if defined(MACHINE_LEARNING)
 EncodeConfig::deep_learning_t EncodeConfig::GetDeepLearning() const {
   return learning_;
@@ -209,6 +282,22 @@ EncodeConfig::deep_learning_overlay_t EncodeConfig::GetDeepLearningOverlay() con
 void EncodeConfig::SetDeepLearningOverlay(const EncodeConfig::deep_learning_overlay_t& learning) {
   learning_overlay_ = learning;
 }
+
+std::string EncodeConfig::GetInferenceShm() const {
+  return inference_shm_;
+}
+
+void EncodeConfig::SetInferenceShm(const std::string& name) {
+  inference_shm_ = name;
+}
+
+bool EncodeConfig::GetDeepLearningMetadata() const {
+  return learning_metadata_;
+}
+
+void EncodeConfig::SetDeepLearningMetadata(bool metadata) {
+  learning_metadata_ = metadata;
+}
 #endif
 
 rational_t EncodeConfig::GetAspectRatio() const {
@@ -219,6 +308,22 @@ void EncodeConfig::SetAspectRatio(rational_t rat) {
   aspect_ratio_ = rat;
 }
 
+EncodeConfig::renditions_t EncodeConfig::GetRenditions() const {
+  return renditions_;
+}
+
+void EncodeConfig::SetRenditions(const renditions_t& renditions) {
+  renditions_ = renditions;
+}
+
+gpu_device_t EncodeConfig::GetGpuDevice() const {
+  return gpu_device_;
+}
+
+void EncodeConfig::SetGpuDevice(gpu_device_t device) {
+  gpu_device_ = device;
+}
+
 decklink_video_mode_t EncodeConfig::GetDecklinkMode() const {
   return decklink_video_mode_;
 }
@@ -227,11 +332,20 @@ void EncodeConfig::SetDecklinkMode(decklink_video_mode_t decl) {
   decklink_video_mode_ = decl;
 }
 
+v4l2_io_mode_t EncodeConfig::GetV4L2IoMode() const {
+  return v4l2_io_mode_;
+}
+
+void EncodeConfig::SetV4L2IoMode(v4l2_io_mode_t mode) {
+  v4l2_io_mode_ = mode;
+}
+
 EncodeConfig* EncodeConfig::Clone() const {
   return new EncodeConfig(*this);
 }
 
-VodEncodeConfig::VodEncodeConfig(const base_class& config) : base_class(config), cleanup_ts_(false) {}
+VodEncodeConfig::VodEncodeConfig(const base_class& config)
+    : base_class(config), cleanup_ts_(false), workers_(1), offline_(false), part_() {}
 
 bool VodEncodeConfig::GetCleanupTS() const {
   return cleanup_ts_;
@@ -241,6 +355,34 @@ void VodEncodeConfig::SetCleanupTS(bool cleanup) {
   cleanup_ts_ = cleanup;
 }
 
+size_t VodEncodeConfig::GetWorkers() const {
+  return workers_;
+}
+
+void VodEncodeConfig::SetWorkers(size_t workers) {
+  workers_ = workers;
+}
+
+bool VodEncodeConfig::GetOffline() const {
+  return offline_;
+}
+
+void VodEncodeConfig::SetOffline(bool offline) {
+  offline_ = offline;
+}
+
+bool VodEncodeConfig::IsParallel() const {
+  return (workers_ > 1 || part_) && !GetCmaf();
+}
+
+VodEncodeConfig::part_t VodEncodeConfig::GetPart() const {
+  return part_;
+}
+
+void VodEncodeConfig::SetPart(const part_t& part) {
+  part_ = part;
+}
+
 VodEncodeConfig* VodEncodeConfig::Clone() const {
   return new VodEncodeConfig(*this);
 }
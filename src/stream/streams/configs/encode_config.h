@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <common/draw/types.h>
 #if defined(MACHINE_LEARNING)
@@ -32,11 +33,22 @@ namespace fastocloud {
 namespace stream {
 namespace streams {
 
+// output encoded from shared decoded video with own size and bitrate
+struct Rendition {
+  Rendition() : output_id(0), size(), video_bitrate() {}  // no bitrate, shared encoder value used
+
+  fastotv::channel_id_t output_id;
+  common::draw::Size size;
+  bit_rate_t video_bitrate;
+};
+
 class EncodeConfig : public AudioVideoConfig {
  public:
   typedef AudioVideoConfig base_class;
   typedef common::Optional<Logo> logo_t;
   typedef common::Optional<RSVGLogo> rsvg_logo_t;
+  typedef common::Optional<common::file_system::ascii_directory_string_path> assets_dir_t;
+  typedef std::vector<Rendition> renditions_t;
 #if defined(MACHINE_LEARNING)
   typedef common::Optional<machine_learning::DeepLearning> deep_learning_t;
   typedef common::Optional<machine_learning::DeepLearningOverlay> deep_learning_overlay_t;
@@ -50,9 +62,21 @@ class EncodeConfig : public AudioVideoConfig {
   bool GetRelayAudio() const;
   void SetRelayAudio(bool ra);
 
+  bool GetPassthrough() const;  // encoding, untouched tracks parsed and muxed without decode
+  void SetPassthrough(bool passthrough);
+
+  bool GetLowLatency() const;  // encoding, profile without lookahead and b-frames, short buffers everywhere
+  void SetLowLatency(bool low_latency);
+
+  bool GetNetworkFeedback() const;  // encoding, video bitrate follows congestion of srt and rtmp outputs
+  void SetNetworkFeedback(bool feedback);
+
   volume_t GetVolume() const;  // encoding
   void SetVolume(volume_t volume);
 
+  loudness_t GetLoudnessTarget() const;  // encoding, decoded audio normalized to it, unset if gain static
+  void SetLoudnessTarget(loudness_t target);
+
   frame_rate_t GetFramerate() const;  // encoding
   void SetFrameRate(frame_rate_t rate);
 
@@ -67,10 +91,14 @@ class EncodeConfig : public AudioVideoConfig {
 
   bool IsGpu() const;     // encoding
   bool IsMfxGpu() const;  // encoding
+  bool IsNvGpu() const;   // encoding, nvcodec encoders
 
   audio_channels_count_t GetAudioChannelsCount() const;  // encoding
   void SetAudioChannelsCount(audio_channels_count_t channels);
 
+  bool GetAudioDithering() const;  // encoding, off saves per sample noise of audioconvert
+  void SetAudioDithering(bool dithering);
+
   video_encoders_args_t GetVideoEncoderArgs() const;  // encoding
   void SetVideoEncoderArgs(const video_encoders_args_t& args);
 
@@ -83,6 +111,9 @@ class EncodeConfig : public AudioVideoConfig {
   bit_rate_t GetVideoBitrate() const;  // encoding
   void SetVideoBitrate(bit_rate_t bitr);
 
+  bit_rate_t GetVideoMinBitrate() const;  // encoding, bitrate follows motion down to it, unset if fixed
+  void SetVideoMinBitrate(bit_rate_t bitr);
+
   bit_rate_t GetAudioBitrate() const;  // encoding
   void SetAudioBitrate(bit_rate_t bitr);
 
@@ -92,20 +123,38 @@ class EncodeConfig : public AudioVideoConfig {
   rsvg_logo_t GetRSVGLogo() const;  // encoding
   void SetRSVGLogo(const rsvg_logo_t& logo);
 
+  assets_dir_t GetAssetsDir() const;  // encoding, logos decoded and scaled once, shared by streams of node
+  void SetAssetsDir(assets_dir_t dir);
+
 #if defined(MACHINE_LEARNING)
   deep_learning_t GetDeepLearning() const;  // encoding
   void SetDeepLearning(const deep_learning_t& learning);
 
   deep_learning_overlay_t GetDeepLearningOverlay() const;  // encoding
   void SetDeepLearningOverlay(const deep_learning_overlay_t& learning);
+
+  std::string GetInferenceShm() const;  // encoding, empty if model loaded by stream itself
+  void SetInferenceShm(const std::string& name);
+
+  bool GetDeepLearningMetadata() const;  // encoding, detections carried as sei of h264 video, overlay not drawn
+  void SetDeepLearningMetadata(bool metadata);
 #endif
 
   rational_t GetAspectRatio() const;  // encoding
   void SetAspectRatio(rational_t rat);
 
+  renditions_t GetRenditions() const;  // encoding
+  void SetRenditions(const renditions_t& renditions);
+
+  gpu_device_t GetGpuDevice() const;  // encoding, nvcodec elements
+  void SetGpuDevice(gpu_device_t device);
+
   decklink_video_mode_t GetDecklinkMode() const;  // mosaic
   void SetDecklinkMode(decklink_video_mode_t decl);
 
+  v4l2_io_mode_t GetV4L2IoMode() const;  // device, unset if picked by encoder
+  void SetV4L2IoMode(v4l2_io_mode_t mode);
+
   EncodeConfig* Clone() const override;
 
  private:
@@ -113,6 +162,7 @@ class EncodeConfig : public AudioVideoConfig {
 
   frame_rate_t frame_rate_;
   volume_t volume_;
+  loudness_t loudness_target_;
 
   std::string video_encoder_;
   std::string audio_encoder_;
@@ -124,34 +174,59 @@ class EncodeConfig : public AudioVideoConfig {
 
   common::draw::Size size_;
   bit_rate_t video_bit_rate_;
+  bit_rate_t video_min_bit_rate_;
   bit_rate_t audio_bit_rate_;
 
   logo_t logo_;
   rsvg_logo_t rsvg_logo_;
+  assets_dir_t assets_dir_;
 #if defined(MACHINE_LEARNING)
   deep_learning_t learning_;
   deep_learning_overlay_t learning_overlay_;
+  std::string inference_shm_;
+  bool learning_metadata_;
 #endif
 
   decklink_video_mode_t decklink_video_mode_;
+  v4l2_io_mode_t v4l2_io_mode_;
   rational_t aspect_ratio_;
+  renditions_t renditions_;
+  gpu_device_t gpu_device_;
 
   bool relay_video_;
   bool relay_audio_;
+  bool passthrough_;
+  bool low_latency_;
+  bool network_feedback_;
+  bool audio_dithering_;
 };
 
 class VodEncodeConfig : public EncodeConfig {
  public:
   typedef EncodeConfig base_class;
+  typedef common::Optional<VodPart> part_t;
   explicit VodEncodeConfig(const base_class& config);
 
   bool GetCleanupTS() const;
   void SetCleanupTS(bool cleanup);
 
+  size_t GetWorkers() const;  // parts of file transcoded in parallel, 1 linear
+  void SetWorkers(size_t workers);
+
+  bool GetOffline() const;  // not synced to clock, presets and queues for throughput instead of latency
+  void SetOffline(bool offline);
+
+  bool IsParallel() const;  // hls outputs, served playlist merged from parts
+  part_t GetPart() const;   // set for workers started by stream of first part
+  void SetPart(const part_t& part);
+
   VodEncodeConfig* Clone() const override;
 
  private:
   bool cleanup_ts_;
+  size_t workers_;
+  bool offline_;
+  part_t part_;
 };
 
 typedef EncodeConfig CodEncodeConfig;
@@ -27,7 +27,18 @@ namespace stream {
 namespace streams {
 
 RelayConfig::RelayConfig(const base_class& config)
-    : base_class(config), video_parser_(DEFAULT_VIDEO_PARSER), audio_parser_(DEFAULT_AUDIO_PARSER) {}
+    : base_class(config),
+      video_parser_(DEFAULT_VIDEO_PARSER),
+      audio_parser_(DEFAULT_AUDIO_PARSER),
+      ts_passthrough_(false),
+      ts_drop_pids_()
+#if defined(MACHINE_LEARNING)
+      ,
+      learning_(),
+      inference_shm_(),
+      learning_metadata_(false)
+#endif
+{}
 
 std::string RelayConfig::GetVideoParser() const {
   return video_parser_;
@@ -45,6 +56,48 @@ void RelayConfig::SetAudioParser(const std::string& parser) {
   audio_parser_ = parser;
 }
 
+bool RelayConfig::GetTsPassthrough() const {
+  return ts_passthrough_;
+}
+
+void RelayConfig::SetTsPassthrough(bool passthrough) {
+  ts_passthrough_ = passthrough;
+}
+
+ts_pids_t RelayConfig::GetTsDropPids() const {
+  return ts_drop_pids_;
+}
+
+void RelayConfig::SetTsDropPids(const ts_pids_t& pids) {
+  ts_drop_pids_ = pids;
+}
+
+#if defined(MACHINE_LEARNING)
+RelayConfig::deep_learning_t RelayConfig::GetDeepLearning() const {
+  return learning_;
+}
+
+void RelayConfig::SetDeepLearning(const deep_learning_t& learning) {
+  learning_ = learning;
+}
+
+std::string RelayConfig::GetInferenceShm() const {
+  return inference_shm_;
+}
+
+void RelayConfig::SetInferenceShm(const std::string& name) {
+  inference_shm_ = name;
+}
+
+bool RelayConfig::GetDeepLearningMetadata() const {
+  return learning_metadata_;
+}
+
+void RelayConfig::SetDeepLearningMetadata(bool metadata) {
+  learning_metadata_ = metadata;
+}
+#endif
+
 RelayConfig* RelayConfig::Clone() const {
   return new RelayConfig(*this);
 }
@@ -64,7 +117,16 @@ VodRelayConfig* VodRelayConfig::Clone() const {
 }
 
 TimeshiftConfig::TimeshiftConfig(const base_class& config)
-    : base_class(config), timeshift_chunk_duration_(DEFAULT_TIMESHIFT_CHUNK_DURATION) {}
+    : base_class(config),
+      timeshift_chunk_duration_(DEFAULT_TIMESHIFT_CHUNK_DURATION),
+      timeshift_chunk_writer_(false),
+      timeshift_direct_io_(false),
+      timeshift_hour_files_(false),
+      timeshift_cold_dir_(),
+      timeshift_hot_time_(DEFAULT_TIMESHIFT_HOT_TIME),
+      timeshift_move_rate_(0),
+      catchup_recorder_dir_(),
+      catchup_stop_utc_(0) {}
 
 time_t TimeshiftConfig::GetTimeShiftChunkDuration() const {
   return timeshift_chunk_duration_;
@@ -74,6 +136,70 @@ void TimeshiftConfig::SetTimeShiftChunkDuration(time_t t) {
   timeshift_chunk_duration_ = t;
 }
 
+bool TimeshiftConfig::GetTimeShiftChunkWriter() const {
+  return timeshift_chunk_writer_;
+}
+
+void TimeshiftConfig::SetTimeShiftChunkWriter(bool writer) {
+  timeshift_chunk_writer_ = writer;
+}
+
+bool TimeshiftConfig::GetTimeShiftDirectIO() const {
+  return timeshift_direct_io_;
+}
+
+void TimeshiftConfig::SetTimeShiftDirectIO(bool direct) {
+  timeshift_direct_io_ = direct;
+}
+
+bool TimeshiftConfig::GetTimeShiftHourFiles() const {
+  return timeshift_hour_files_;
+}
+
+void TimeshiftConfig::SetTimeShiftHourFiles(bool hour_files) {
+  timeshift_hour_files_ = hour_files;
+}
+
+std::string TimeshiftConfig::GetTimeShiftColdDir() const {
+  return timeshift_cold_dir_;
+}
+
+void TimeshiftConfig::SetTimeShiftColdDir(const std::string& dir) {
+  timeshift_cold_dir_ = dir;
+}
+
+time_t TimeshiftConfig::GetTimeShiftHotTime() const {
+  return timeshift_hot_time_;
+}
+
+void TimeshiftConfig::SetTimeShiftHotTime(time_t t) {
+  timeshift_hot_time_ = t;
+}
+
+int TimeshiftConfig::GetTimeShiftMoveRate() const {
+  return timeshift_move_rate_;
+}
+
+void TimeshiftConfig::SetTimeShiftMoveRate(int rate) {
+  timeshift_move_rate_ = rate;
+}
+
+std::string TimeshiftConfig::GetCatchupRecorderDir() const {
+  return catchup_recorder_dir_;
+}
+
+void TimeshiftConfig::SetCatchupRecorderDir(const std::string& dir) {
+  catchup_recorder_dir_ = dir;
+}
+
+time_t TimeshiftConfig::GetCatchupStopUtc() const {
+  return catchup_stop_utc_;
+}
+
+void TimeshiftConfig::SetCatchupStopUtc(time_t t) {
+  catchup_stop_utc_ = t;
+}
+
 TimeshiftConfig* TimeshiftConfig::Clone() const {
   return new TimeshiftConfig(*this);
 }
@@ -16,7 +16,12 @@
 
 #include <string>
 
+#if defined(MACHINE_LEARNING)
+#include "base/machine_learning/deep_learning.h"
+#endif
+
 #include "stream/streams/configs/audio_video_config.h"
+#include "stream/ts_packet_filter.h"
 
 namespace fastocloud {
 namespace stream {
@@ -25,6 +30,9 @@ namespace streams {
 class RelayConfig : public AudioVideoConfig {
  public:
   typedef AudioVideoConfig base_class;
+#if defined(MACHINE_LEARNING)
+  typedef common::Optional<machine_learning::DeepLearning> deep_learning_t;
+#endif
   explicit RelayConfig(const base_class& config);
 
   std::string GetVideoParser() const;  // relay
@@ -33,11 +41,35 @@ class RelayConfig : public AudioVideoConfig {
   std::string GetAudioParser() const;  // relay
   void SetAudioParser(const std::string& parser);
 
+  bool GetTsPassthrough() const;  // relay, mpegts packets forwarded when input and outputs allow it
+  void SetTsPassthrough(bool passthrough);
+
+  ts_pids_t GetTsDropPids() const;  // ts passthrough
+  void SetTsDropPids(const ts_pids_t& pids);
+
+#if defined(MACHINE_LEARNING)
+  deep_learning_t GetDeepLearning() const;  // relay, side branch decoded at reduced size and rate for inference only
+  void SetDeepLearning(const deep_learning_t& learning);
+
+  std::string GetInferenceShm() const;  // relay, empty if model loaded by stream itself
+  void SetInferenceShm(const std::string& name);
+
+  bool GetDeepLearningMetadata() const;  // relay, detections carried as sei of relayed h264/h265 video
+  void SetDeepLearningMetadata(bool metadata);
+#endif
+
   RelayConfig* Clone() const override;
 
  private:
   std::string video_parser_;
   std::string audio_parser_;
+  bool ts_passthrough_;
+  ts_pids_t ts_drop_pids_;
+#if defined(MACHINE_LEARNING)
+  deep_learning_t learning_;
+  std::string inference_shm_;
+  bool learning_metadata_;
+#endif
 };
 
 class VodRelayConfig : public RelayConfig {
@@ -62,10 +94,42 @@ class TimeshiftConfig : public RelayConfig {
   time_t GetTimeShiftChunkDuration() const;  // timeshift_rec, catchup_rec
   void SetTimeShiftChunkDuration(time_t t);  // timeshift_rec, catchup_rec
 
+  bool GetTimeShiftChunkWriter() const;  // preallocated chunk files instead of filesink
+  void SetTimeShiftChunkWriter(bool writer);
+
+  bool GetTimeShiftDirectIO() const;  // chunk writer only
+  void SetTimeShiftDirectIO(bool direct);
+
+  bool GetTimeShiftHourFiles() const;  // chunk writer appends chunks into hour files, byte ranges catalog kept
+  void SetTimeShiftHourFiles(bool hour_files);
+
+  std::string GetTimeShiftColdDir() const;  // empty if chunks kept in timeshift dir
+  void SetTimeShiftColdDir(const std::string& dir);
+
+  time_t GetTimeShiftHotTime() const;
+  void SetTimeShiftHotTime(time_t t);
+
+  int GetTimeShiftMoveRate() const;  // in megabytes per second, 0 - unlimited
+  void SetTimeShiftMoveRate(int rate);
+
+  std::string GetCatchupRecorderDir() const;  // catchup, empty if always recorded from input
+  void SetCatchupRecorderDir(const std::string& dir);
+
+  time_t GetCatchupStopUtc() const;  // catchup, end of programme in sec, 0 if recorded until stopped
+  void SetCatchupStopUtc(time_t t);
+
   TimeshiftConfig* Clone() const override;
 
  private:
   time_t timeshift_chunk_duration_;
+  bool timeshift_chunk_writer_;
+  bool timeshift_direct_io_;
+  bool timeshift_hour_files_;
+  std::string timeshift_cold_dir_;
+  time_t timeshift_hot_time_;
+  int timeshift_move_rate_;
+  std::string catchup_recorder_dir_;
+  time_t catchup_stop_utc_;
 };
 
 typedef RelayConfig PlaylistRelayConfig;
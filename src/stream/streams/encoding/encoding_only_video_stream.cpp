@@ -72,6 +72,8 @@ gboolean EncodingOnlyVideoStream::HandleDecodeBinAutoplugger(GstElement* elem, G
       return TRUE;
     } else if (svideo == VIDEO_H265_CODEC) {
       return TRUE;
+    } else if (svideo == VIDEO_AV1_CODEC) {
+      return TRUE;
     } else if (svideo == VIDEO_MPEG_CODEC) {
       return TRUE;
     }
@@ -14,21 +14,35 @@
 
 #include "stream/streams/encoding/encoding_stream.h"
 
+#include <math.h>
+
+#include <algorithm>
 #include <string>
 
+#include <gst/video/video.h>
+
 #include <common/sprintf.h>
+#include <common/time.h>
 
 #include "base/constants.h"
 #include "base/gst_constants.h"
 
+#include "stream/bitrate_controller.h"
+#include "stream/congestion_control.h"
+#include "stream/elements/audio/audio.h"
+#include "stream/elements/encoders/audio.h"
+#include "stream/elements/encoders/video.h"
 #include "stream/elements/parser/audio.h"
 #include "stream/elements/parser/video.h"
+#include "stream/elements/video/video.h"
+#include "stream/encoder_warmup.h"
 #include "stream/gstreamer_utils.h"
+#include "stream/loudness_meter.h"
 #include "stream/pad/pad.h"
 #include "stream/streams/builders/encoding/encoding_stream_builder.h"
 
 #if defined(MACHINE_LEARNING)
-#include <fastoml/gst/gstmlmeta.h>
+#include "stream/elements/machine_learning/inference_sink.h"
 #include "stream/elements/machine_learning/video_ml_filter.h"
 #endif
 
@@ -42,12 +56,93 @@ IBaseBuilder* EncodingStream::CreateBuilder() {
 }
 
 EncodingStream::EncodingStream(const EncodeConfig* config, IStreamClient* client, StreamStruct* stats)
-    : base_class(config, client, stats) {}
+    : base_class(config, client, stats),
+      video_passthrough_available_(false),
+      audio_passthrough_available_(false),
+      video_passthrough_(false),
+      audio_passthrough_(false),
+      bitrate_control_(nullptr),
+      congestion_(nullptr),
+      max_video_bitrate_(0),
+      video_bitrate_(0),
+      loudness_(nullptr),
+      volume_(1)
+#if defined(MACHINE_LEARNING)
+      ,
+      ml_notifications_(nullptr),
+      detection_sei_(nullptr)
+#endif
+{
+  const bit_rate_t min_bitrate = config->GetVideoMinBitrate();
+  const bit_rate_t max_bitrate = config->GetVideoBitrate();
+  if (max_bitrate && !config->GetRelayVideo()) {
+    max_video_bitrate_ = *max_bitrate;
+    video_bitrate_ = *max_bitrate;
+    if (min_bitrate) {
+      bitrate_control_ = new BitrateController(*min_bitrate, *max_bitrate);
+      if (!bitrate_control_->IsActive()) {
+        WARNING_LOG() << "Video bitrate fixed, lower bound " << *min_bitrate << " not below " << *max_bitrate;
+        destroy(&bitrate_control_);
+      }
+    }
+    if (config->GetNetworkFeedback()) {
+      congestion_ = new CongestionControl;
+    }
+  }
+
+  const volume_t volume = config->GetVolume();
+  if (volume) {
+    volume_ = *volume;
+  }
+  const loudness_t loudness_target = config->GetLoudnessTarget();
+  if (loudness_target && !config->GetRelayAudio()) {
+    loudness_ = new LoudnessNormalizer(*loudness_target);
+  }
+#if defined(MACHINE_LEARNING)
+  const auto deep_learning = config->GetDeepLearning();
+  if (deep_learning) {
+    ml_notifications_ = new MlNotificationBatch(deep_learning->GetNotificationInterval());
+    if (config->GetDeepLearningMetadata()) {
+      detection_sei_ = new DetectionSei;
+    }
+  }
+#endif
+}
+
+EncodingStream::~EncodingStream() {
+  destroy(&loudness_);
+  destroy(&congestion_);
+  destroy(&bitrate_control_);
+#if defined(MACHINE_LEARNING)
+  destroy(&detection_sei_);
+  destroy(&ml_notifications_);
+#endif
+}
 
 const char* EncodingStream::ClassName() const {
   return GetType() == fastotv::ENCODE ? "EncodingStream" : "CodEncodeStream";
 }
 
+gboolean EncodingStream::HandleMainTimerTick() {
+  gboolean res = base_class::HandleMainTimerTick();
+  UpdateVideoBitrate();
+  UpdateLoudnessGain();
+#if defined(MACHINE_LEARNING)
+  MlNotificationBatch::images_t images;
+  if (ml_notifications_ && ml_notifications_->Flush(common::time::current_utc_mstime(), &images) && client_) {
+    client_->OnMlNotification(this, images);
+  }
+#endif
+  return res;
+}
+
+GstBusSyncReply EncodingStream::HandleSyncBusMessageReceived(GstBus* bus, GstMessage* message) {
+  if (start_encoder_warmup(message)) {
+    INFO_LOG() << "Warm up of video encoder started: " << GST_MESSAGE_SRC_NAME(message);
+  }
+  return base_class::HandleSyncBusMessageReceived(bus, message);
+}
+
 void EncodingStream::HandleBufferingMessage(GstMessage* message) {
   if (IsLive()) {
     return;
@@ -63,12 +158,230 @@ void EncodingStream::HandleBufferingMessage(GstMessage* message) {
   SrcDecodeBinStream::HandleBufferingMessage(message);
 }
 
+bool EncodingStream::HandleLiveConfigUpdate(const LiveConfigUpdate& update) {
+  const element_id_t main_id = 0;  // elements are created on decodebin pads, may be not in pipeline yet
+  bool applied = true;
+  if (!update.added_outputs.empty() || !update.removed_outputs.empty() || update.hls_max_files) {
+    LiveConfigUpdate outputs;
+    outputs.added_outputs = update.added_outputs;
+    outputs.removed_outputs = update.removed_outputs;
+    outputs.hls_max_files = update.hls_max_files;
+    applied = SrcDecodeBinStream::HandleLiveConfigUpdate(outputs);
+  }
+
+  if (update.volume) {
+    volume_ = *update.volume;
+    if (!ApplyVolume()) {
+      applied = false;
+    }
+  }
+
+  if (update.video_bitrate) {
+    max_video_bitrate_ = *update.video_bitrate;
+    if (bitrate_control_) {
+      bitrate_control_->SetMaxBitrate(max_video_bitrate_);
+    }
+    const int video_bitrate = GetTargetVideoBitrate();
+    elements::Element* codec = FindElementByName(common::MemSPrintf(VIDEO_CODEC_NAME_1U, main_id));
+    if (codec && elements::encoders::set_video_encoder_bitrate(codec, video_bitrate, true)) {
+      video_bitrate_ = video_bitrate;
+    } else {
+      applied = false;
+    }
+  }
+
+  if (update.logo_position || update.logo_alpha) {
+    elements::Element* logo = FindElementByName(common::MemSPrintf(VIDEO_LOGO_NAME_1U, main_id));
+    if (logo && logo->IsPropertyMutablePlaying("offset-x") && logo->IsPropertyMutablePlaying("alpha")) {
+      elements::video::ElementGDKPixBufOverlay* overlay = static_cast<elements::video::ElementGDKPixBufOverlay*>(logo);
+      if (update.logo_position) {
+        overlay->SetOffsetX(update.logo_position->x);
+        overlay->SetOffsetY(update.logo_position->y);
+      }
+      if (update.logo_alpha) {
+        overlay->SetAlpha(*update.logo_alpha);
+      }
+    } else {
+      applied = false;
+    }
+  }
+
+  if (update.rsvg_logo_position) {
+    elements::Element* logo = FindElementByName(common::MemSPrintf(RSVG_VIDEO_LOGO_NAME_1U, main_id));
+    if (!logo) {
+      applied = false;
+    } else if (logo->GetPluginName() == elements::video::ElementGDKPixBufOverlay::GetPluginName() &&
+               logo->IsPropertyMutablePlaying("offset-x")) {  // rasterized by asset cache
+      elements::video::ElementGDKPixBufOverlay* overlay = static_cast<elements::video::ElementGDKPixBufOverlay*>(logo);
+      overlay->SetOffsetX(update.rsvg_logo_position->x);
+      overlay->SetOffsetY(update.rsvg_logo_position->y);
+    } else if (logo->GetPluginName() == elements::video::ElementRSVGOverlay::GetPluginName() &&
+               logo->IsPropertyMutablePlaying("x")) {
+      elements::video::ElementRSVGOverlay* overlay = static_cast<elements::video::ElementRSVGOverlay*>(logo);
+      overlay->SetX(update.rsvg_logo_position->x);
+      overlay->SetY(update.rsvg_logo_position->y);
+    } else {
+      applied = false;
+    }
+  }
+
+  if (applied) {
+    INFO_LOG() << "Config changes applied to running pipeline.";
+  }
+  return applied;
+}
+
+void EncodingStream::SetupVideoPostProc(GstPad* pad) {
+  const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  const auto deinterlace = config->GetDeinterlace();
+  if (!deinterlace || !*deinterlace) {
+    return;
+  }
+
+  GstCaps* caps = gst_pad_get_current_caps(pad);
+  if (!caps) {
+    return;
+  }
+
+  GstVideoInfo info;
+  const bool valid = gst_video_info_from_caps(&info, caps);
+  gst_caps_unref(caps);
+  if (!valid) {
+    return;
+  }
+
+  // post processing built before caps known, deinterlacers enabled only for interlaced input
+  const bool interlaced = GST_VIDEO_INFO_IS_INTERLACED(&info);
+  const element_id_t main_id = 0;
+  elements::Element* post = FindElementByName(common::MemSPrintf(POST_PROC_NAME_1U, main_id));
+  if (post && post->GetPluginName() == elements::ElementVaapiPostProc::GetPluginName()) {
+    static_cast<elements::ElementVaapiPostProc*>(post)->SetDinterlaceMode(interlaced ? 0 : 2);
+  } else if (post && post->GetPluginName() == elements::ElementMFXVpp::GetPluginName() && interlaced) {
+    static_cast<elements::ElementMFXVpp*>(post)->SetDinterlaceMode(1);
+  }
+
+  elements::Element* deinter = FindElementByName(common::MemSPrintf(DEINTERLACE_NAME_1U, main_id));
+  if (deinter) {
+    deinter->SetProperty("mode", interlaced ? 1 : 2);  // (1): interlaced - Force deinterlacing, (2): disabled
+  }
+  INFO_LOG() << "Deinterlace " << (interlaced ? "enabled" : "disabled") << " for "
+             << gst_video_interlace_mode_to_string(GST_VIDEO_INFO_INTERLACE_MODE(&info)) << " video";
+}
+
+void EncodingStream::UpdateVideoBitrate() {
+  if (!bitrate_control_ && !congestion_) {
+    return;
+  }
+
+  const element_id_t main_id = 0;  // renditions keep their bitrates
+  elements::Element* codec = FindElementByName(common::MemSPrintf(VIDEO_CODEC_NAME_1U, main_id));
+  if (!codec) {
+    return;
+  }
+
+  uint32_t motion = 0;
+  int value;
+  if (bitrate_control_ && GetVideoMotion(&motion)) {
+    ignore_result(bitrate_control_->Update(motion, &value));
+  }
+  if (congestion_) {
+    ReportOutputsCongestion();
+    if (congestion_->Update(&value)) {
+      NOTICE_LOG() << "Video bitrate share for network outputs " << value << "%";
+    }
+  }
+
+  const int bitrate = GetTargetVideoBitrate();
+  if (bitrate == video_bitrate_) {
+    return;
+  }
+
+  if (!elements::encoders::set_video_encoder_bitrate(codec, bitrate, true)) {
+    WARNING_LOG() << "Video bitrate fixed, " << codec->GetPluginName() << " can't change it while playing";
+    destroy(&bitrate_control_);
+    destroy(&congestion_);
+    return;
+  }
+  DEBUG_LOG() << "Video bitrate " << bitrate << " for motion " << motion;
+  video_bitrate_ = bitrate;
+}
+
+void EncodingStream::UpdateLoudnessGain() {
+  double short_term_lufs;
+  int peak_db;
+  double gain_db;
+  if (!loudness_ || !GetAudioLoudness(&short_term_lufs, &peak_db) ||
+      !loudness_->Update(short_term_lufs, peak_db, &gain_db)) {
+    return;
+  }
+
+  if (!ApplyVolume()) {
+    WARNING_LOG() << "Loudness gain not applied, volume can't be changed while playing";
+    destroy(&loudness_);
+    return;
+  }
+  DEBUG_LOG() << "Loudness gain " << gain_db << " dB for " << short_term_lufs << " LUFS";
+}
+
+bool EncodingStream::ApplyVolume() const {
+  const element_id_t main_id = 0;
+  elements::Element* volume = FindElementByName(common::MemSPrintf(VOLUME_NAME_1U, main_id));
+  if (!volume || !volume->IsPropertyMutablePlaying("volume")) {
+    return false;
+  }
+
+  const double gain = loudness_ ? pow(10, loudness_->GetGain() / 20) : 1;
+  static_cast<elements::audio::ElementVolume*>(volume)->SetVolume(std::min(volume_ * gain, 10.0));  // max of element
+  return true;
+}
+
+int EncodingStream::GetTargetVideoBitrate() const {
+  int bitrate = bitrate_control_ ? bitrate_control_->GetBitrate() : max_video_bitrate_;
+  if (congestion_) {
+    bitrate = std::min<int>(bitrate, static_cast<int64_t>(max_video_bitrate_) * congestion_->GetPercent() / 100);
+  }
+  return bitrate;
+}
+
+void EncodingStream::ReportOutputsCongestion() {
+  const StreamStruct* stats = GetStats();
+  const auto outputs = GetConfig()->GetOutput();
+  for (size_t i = 0; i < outputs.size() && i < stats->output.size(); ++i) {
+    const common::uri::Url::scheme scheme = outputs[i].GetOutput().GetScheme();
+    if (scheme != common::uri::Url::srt && scheme != common::uri::Url::rtmp) {
+      continue;  // files and multicast take what they get
+    }
+
+    CongestionControl::Feedback feedback = {-1, 0, 0};
+    elements::Element* queue = FindElementByName(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, i));
+    guint64 level_time = 0;
+    if (queue) {
+      ignore_result(get_queue_level(queue->GetGstElement(), &feedback.queue_fill, &level_time));
+    }
+
+    const ChannelStats& stat = stats->output[i];
+    feedback.drops = stat.GetTotalDrops();
+    for (size_t j = 0; j < stat.GetPeersCount(); ++j) {
+      const PeerStats peer = stat.GetPeer(j);
+      feedback.drops += peer.drops;
+      feedback.rtt_msec = std::max(feedback.rtt_msec, peer.rtt_msec);
+    }
+    congestion_->Report(i, feedback);
+  }
+}
+
 GValueArray* EncodingStream::HandleAutoplugSort(GstElement* bin, GstPad* pad, GstCaps* caps, GValueArray* factories) {
   UNUSED(bin);
   UNUSED(pad);
   UNUSED(caps);
-  UNUSED(factories);
-  return nullptr;
+
+  // nvdec decoders of the gpu selected for encoder tried before default ones
+  const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  const auto gpu_device = config->GetGpuDevice();
+  if (!gpu_device || !config->IsNvGpu()) {
+    return nullptr;
+  }
+  return sort_cuda_device_factories(factories, *gpu_device);
 }
 
 GstAutoplugSelectResult EncodingStream::HandleAutoplugSelect(GstElement* bin,
@@ -133,11 +446,18 @@ gboolean EncodingStream::HandleDecodeBinAutoplugger(GstElement* elem, GstPad* pa
       if (pad_struct && gst_structure_get_int(pad_struct, "width", &width) &&
           gst_structure_get_int(pad_struct, "height", &height)) {
         RegisterVideoCaps(svideo, caps, 0);
+        if (video_passthrough_available_ && !IsVideoInited() && IsVideoPassthroughCaps(pad_struct, width, height)) {
+          INFO_LOG() << "Video passthrough: " << type_full;
+          video_passthrough_ = true;
+          return FALSE;
+        }
         return TRUE;
       }
       return TRUE;
     } else if (svideo == VIDEO_H265_CODEC) {
       return TRUE;
+    } else if (svideo == VIDEO_AV1_CODEC) {
+      return TRUE;
     } else if (svideo == VIDEO_MPEG_CODEC) {
       return TRUE;
     }
@@ -148,6 +468,11 @@ gboolean EncodingStream::HandleDecodeBinAutoplugger(GstElement* elem, GstPad* pa
       gint rate = 0;
       if (pad_struct && gst_structure_get_int(pad_struct, "rate", &rate)) {
         RegisterAudioCaps(saudio, caps, 0);
+        if (audio_passthrough_available_ && !IsAudioInited() && IsAudioPassthroughCaps(pad_struct)) {
+          INFO_LOG() << "Audio passthrough: " << type_full;
+          audio_passthrough_ = true;
+          return FALSE;
+        }
         return TRUE;
       }
       return TRUE;
@@ -179,22 +504,41 @@ void EncodingStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
   const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
   INFO_LOG() << "Pad added: " << new_pad_type;
   elements::Element* dest = nullptr;
+  elements::Element* unused_branch = nullptr;
+  bool is_audio_track = false;
   bool is_video = strncmp(new_pad_type, "video", 5) == 0;
   bool is_audio = strncmp(new_pad_type, "audio", 5) == 0;
   bool is_subtitle = strncmp(new_pad_type, "text", 4) == 0;
   if (is_video) {
     if (config->HaveVideo() && !IsVideoInited()) {
-      dest = GetElementByName(common::MemSPrintf(UDB_VIDEO_NAME_1U, 0));
+      const bool passthrough = video_passthrough_ && strncmp(new_pad_type, "video/x-raw", 11) != 0;
+      dest = GetElement(passthrough ? UDB_VIDEO_PASSTHROUGH_ROLE : UDB_VIDEO_ROLE, 0);
+      if (!passthrough && !config->GetRelayVideo()) {
+        SetupVideoPostProc(new_pad);
+      }
+      if (video_passthrough_available_) {
+        unused_branch = GetElement(passthrough ? UDB_VIDEO_ROLE : UDB_VIDEO_PASSTHROUGH_ROLE, 0);
+      }
     }
   } else if (is_audio) {
     if (config->HaveAudio() && !IsAudioInited()) {
       const char* gst_pad_name = GST_PAD_NAME(new_pad);
       const auto audio_select = config->GetAudioSelect();
       int current_audio_track = 0;
-      if (!audio_select || (GetPadId(gst_pad_name, &current_audio_track) && *audio_select == current_audio_track)) {
-        dest = GetElementByName(common::MemSPrintf(UDB_AUDIO_NAME_1U, 0));
+      // in warm standby and gapless modes track is selected on parsebin of every input
+      if (!audio_select || IsTrackPreselected() ||
+          (GetPadId(gst_pad_name, &current_audio_track) && *audio_select == current_audio_track)) {
+        const bool passthrough = audio_passthrough_ && strncmp(new_pad_type, "audio/x-raw", 11) != 0;
+        dest = GetElement(passthrough ? UDB_AUDIO_PASSTHROUGH_ROLE : UDB_AUDIO_ROLE, 0);
+        if (audio_passthrough_available_) {
+          unused_branch = GetElement(passthrough ? UDB_AUDIO_ROLE : UDB_AUDIO_PASSTHROUGH_ROLE, 0);
+        }
       }
     }
+    if (!dest && config->HaveAudio()) {
+      dest = FindAudioTrackDest(new_pad);
+      is_audio_track = dest != nullptr;
+    }
   } else if (is_subtitle) {
     if (config->HaveSubtitle()) {
     }
@@ -218,6 +562,9 @@ void EncodingStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
                     << new_pad_type;
     } else {
       DEBUG_LOG() << "Pad emitted: " << GST_ELEMENT_NAME(src) << " " << GST_PAD_NAME(new_pad) << " " << new_pad_type;
+      if (unused_branch) {
+        EndUnusedBranch(unused_branch);
+      }
     }
   } else {
     DEBUG_LOG() << "pad-emitter: pad is linked";
@@ -225,7 +572,7 @@ void EncodingStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
 
   if (is_video) {
     SetVideoInited(true);
-  } else if (is_audio) {
+  } else if (is_audio && !is_audio_track) {
     SetAudioInited(true);
   }
   delete sink_pad;
@@ -236,6 +583,17 @@ void EncodingStream::HandleDecodeBinElementAdded(GstBin* bin, GstElement* elemen
 
   const std::string element_plugin_name = elements::Element::GetPluginName(element);
   DEBUG_LOG() << "decodebin added element: " << element_plugin_name;
+
+  // legacy nvdec decoders on the gpu selected for encoder, per gpu ones of nvcodec picked by autoplug sort
+  const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  const auto gpu_device = config->GetGpuDevice();
+  if (!gpu_device || element_plugin_name.compare(0, 2, "nv") != 0) {
+    return;
+  }
+  GParamSpec* pspec = g_object_class_find_property(G_OBJECT_GET_CLASS(element), "cuda-device-id");
+  if (pspec && (pspec->flags & G_PARAM_WRITABLE)) {
+    g_object_set(element, "cuda-device-id", *gpu_device, nullptr);
+  }
 }
 
 void EncodingStream::HandleDecodeBinElementRemoved(GstBin* bin, GstElement* element) {
@@ -245,36 +603,149 @@ void EncodingStream::HandleDecodeBinElementRemoved(GstBin* bin, GstElement* elem
   DEBUG_LOG() << "decodebin removed element: " << element_plugin_name;
 }
 
+void EncodingStream::OnPassthroughBranchesCreated(bool video, bool audio) {
+  video_passthrough_available_ = video;
+  audio_passthrough_available_ = audio;
+  video_passthrough_ = false;
+  audio_passthrough_ = false;
+}
+
+void EncodingStream::OnVideoEncoderCreated(elements::Element* encoder,
+                                           element_id_t video_id,
+                                           const common::draw::Size& size) {
+  GstElement* element = encoder->GetGstElement();
+  GstPad* pad = gst_element_get_static_pad(element, "sink");
+  if (pad) {
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, encoder_caps_probe, this, nullptr);
+    gst_object_unref(pad);
+  }
+
+  const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  const auto framerate = config->GetFramerate();
+  GstCaps* caps = make_encoder_warmup_caps(element, GetCachedEncoderCaps(video_id), size, framerate ? *framerate : 0);
+  if (!caps) {
+    return;
+  }
+
+  gchar* caps_str = gst_caps_to_string(caps);
+  INFO_LOG() << "Video encoder " << video_id << " warm up caps: " << caps_str;
+  g_free(caps_str);
+  set_encoder_warmup_caps(element, caps);
+}
+
+GstPadProbeReturn EncodingStream::encoder_caps_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) != GST_EVENT_CAPS) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  element_id_t video_id = 0;
+  GstElement* encoder = gst_pad_get_parent_element(pad);
+  if (encoder) {
+    GetElementId(GST_ELEMENT_NAME(encoder), &video_id);
+    gst_object_unref(encoder);
+  }
+
+  GstCaps* caps = nullptr;
+  gst_event_parse_caps(event, &caps);
+  EncodingStream* stream = reinterpret_cast<EncodingStream*>(user_data);
+  stream->RecordEncoderCaps(video_id, caps);
+  return GST_PAD_PROBE_OK;
+}
+
+bool EncodingStream::IsVideoPassthroughCaps(const GstStructure* pad_struct, gint width, gint height) const {
+  const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  const common::draw::Size size = config->GetSize();
+  if (size.IsValid() && (size.width != width || size.height != height)) {
+    return false;
+  }
+
+  // bitrate checked only if demuxer or parser exposes it
+  const auto bitrate = config->GetVideoBitrate();
+  guint caps_bitrate = 0;
+  if (bitrate && gst_structure_get_uint(pad_struct, "bitrate", &caps_bitrate) &&
+      caps_bitrate > static_cast<guint>(*bitrate * 1024)) {
+    return false;
+  }
+  return true;
+}
+
+bool EncodingStream::IsAudioPassthroughCaps(const GstStructure* pad_struct) const {
+  const EncodeConfig* config = static_cast<const EncodeConfig*>(GetConfig());
+  const bool mp3 = elements::encoders::IsMP3Encoder(config->GetAudioEncoder());
+  gint mpegversion = 0;
+  if (!gst_structure_get_int(pad_struct, "mpegversion", &mpegversion) || mpegversion != (mp3 ? 1 : 4)) {
+    return false;
+  }
+
+  gint layer = 0;
+  if (mp3 && (!gst_structure_get_int(pad_struct, "layer", &layer) || layer != 3)) {
+    return false;
+  }
+
+  const auto channels = config->GetAudioChannelsCount();
+  gint caps_channels = 0;
+  if (channels && (!gst_structure_get_int(pad_struct, "channels", &caps_channels) || caps_channels != *channels)) {
+    return false;
+  }
+
+  const auto bitrate = config->GetAudioBitrate();
+  guint caps_bitrate = 0;
+  if (bitrate && gst_structure_get_uint(pad_struct, "bitrate", &caps_bitrate) &&
+      caps_bitrate > static_cast<guint>(*bitrate * 1024)) {
+    return false;
+  }
+  return true;
+}
+
 #if defined(MACHINE_LEARNING)
-void EncodingStream::OnMLElementCreated(elements::machine_learning::ElementVideoMLFilter* machine) {
+void EncodingStream::OnMLElementCreated(elements::machine_learning::ElementVideoMLFilter* machine,
+                                        fastoml::SupportedBackends backend) {
+  SetMlBackend(backend);
   ignore_result(machine->RegisterNewPredictionCallback(&EncodingStream::new_prediction_callback, this));
 }
 
+void EncodingStream::OnInferenceSinkCreated(elements::machine_learning::ElementInferenceSink* sink) {
+  sink->SetResultsCallback(&EncodingStream::inference_results_callback, this);
+}
+
+void EncodingStream::OnDetectionsPadCreated(pad::Pad* pad, bool hevc) {
+  if (detection_sei_) {
+    detection_sei_->Attach(pad->GetGstPad(), hevc);
+  }
+}
+
 void EncodingStream::HandleMlNotification(const std::vector<fastotv::commands_info::ml::ImageBox> &images) {
-  if (client_) {
+  if (detection_sei_) {
+    detection_sei_->Push(images);
+  }
+  if (!client_) {
+    return;
+  }
+
+  if (!ml_notifications_) {
     client_->OnMlNotification(this, images);
+    return;
+  }
+
+  MlNotificationBatch::images_t out;
+  if (ml_notifications_->Add(images, common::time::current_utc_mstime(), &out)) {
+    client_->OnMlNotification(this, out);
   }
 }
 
 void EncodingStream::new_prediction_callback(GstElement* elem, gpointer meta, gpointer user_data) {
   UNUSED(elem);
-  UNUSED(user_data);
-
-  std::vector<fastotv::commands_info::ml::ImageBox> images;
-  GstDetectionMeta* detection_meta = static_cast<GstDetectionMeta*>(meta);
-  for (int i = 0; i < detection_meta->num_boxes; ++i) {
-    BBox* box = (detection_meta->boxes) + i;
-    fastotv::commands_info::ml::ImageBox image;
-    image.label = box->label;
-    image.prob = box->prob;
-    image.x = box->x;
-    image.y = box->y;
-    image.width = box->width;
-    image.height = box->height;
-    images.push_back(image);
-  }
+
+  EncodingStream* stream = reinterpret_cast<EncodingStream*>(user_data);
+  stream->HandleMlNotification(elements::machine_learning::make_image_boxes(meta));
+}
+
+void EncodingStream::inference_results_callback(
+    const std::vector<fastocloud::machine_learning::InferenceBoxShm>& boxes,
+    gpointer user_data) {
   EncodingStream* stream = reinterpret_cast<EncodingStream*>(user_data);
-  stream->HandleMlNotification(images);
+  stream->HandleMlNotification(elements::machine_learning::make_image_boxes(boxes));
 }
 #endif
 
@@ -14,16 +14,33 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "stream/streams/src_decodebin_stream.h"
 
 #include "stream/streams/configs/encode_config.h"
 
+#if defined(MACHINE_LEARNING)
+#include "stream/detection_sei.h"
+#include "stream/ml_notification_batch.h"
+#endif
+
 namespace fastocloud {
+#if defined(MACHINE_LEARNING)
+namespace machine_learning {
+struct InferenceBoxShm;
+}
+#endif
 namespace stream {
+class BitrateController;
+class CongestionControl;
+class LoudnessNormalizer;
 namespace elements {
 #if defined(MACHINE_LEARNING)
 namespace machine_learning {
 class ElementVideoMLFilter;
+class ElementInferenceSink;
 }
 #endif
 }  // namespace elements
@@ -40,11 +57,16 @@ class EncodingStream : public SrcDecodeBinStream {
   EncodingStream(const EncodeConfig* config, IStreamClient* client, StreamStruct* stats);
 
   const char* ClassName() const override;
+  ~EncodingStream() override;
 
  protected:
   IBaseBuilder* CreateBuilder() override;
 
+  gboolean HandleMainTimerTick() override;
+  GstBusSyncReply HandleSyncBusMessageReceived(GstBus* bus, GstMessage* message) override;
+
   void HandleBufferingMessage(GstMessage* message) override;
+  bool HandleLiveConfigUpdate(const LiveConfigUpdate& update) override;
   gboolean HandleDecodeBinAutoplugger(GstElement* elem, GstPad* pad, GstCaps* caps) override;
   void HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) override;
 
@@ -58,12 +80,47 @@ class EncodingStream : public SrcDecodeBinStream {
   void HandleDecodeBinElementRemoved(GstBin* bin, GstElement* element) override;
 
 #if defined(MACHINE_LEARNING)
-  virtual void OnMLElementCreated(elements::machine_learning::ElementVideoMLFilter* machine);
+  virtual void OnMLElementCreated(elements::machine_learning::ElementVideoMLFilter* machine,
+                                  fastoml::SupportedBackends backend);
+  virtual void OnInferenceSinkCreated(elements::machine_learning::ElementInferenceSink* sink);
+  void OnDetectionsPadCreated(pad::Pad* pad, bool hevc);  // parsed encoded video
+#endif
 
  private:
+  void OnPassthroughBranchesCreated(bool video, bool audio);
+  // hardware encoder, input caps recorded and known ones sent ahead of source
+  void OnVideoEncoderCreated(elements::Element* encoder, element_id_t video_id, const common::draw::Size& size);
+  bool IsVideoPassthroughCaps(const GstStructure* pad_struct, gint width, gint height) const;
+  bool IsAudioPassthroughCaps(const GstStructure* pad_struct) const;
+  void SetupVideoPostProc(GstPad* pad);            // on raw video pad, before first buffer
+  void UpdateVideoBitrate();                        // by motion of decoded video and congestion of outputs
+  int GetTargetVideoBitrate() const;
+  void ReportOutputsCongestion();                   // srt and rtmp outputs
+  void UpdateLoudnessGain();                        // by loudness of decoded audio
+  bool ApplyVolume() const;                         // configured volume with loudness gain
+
+  bool video_passthrough_available_;
+  bool audio_passthrough_available_;
+  bool video_passthrough_;  // input video parsed and muxed without decode
+  bool audio_passthrough_;  // input audio parsed and muxed without decode
+  BitrateController* bitrate_control_;  // nullptr if video bitrate fixed
+  CongestionControl* congestion_;       // nullptr if network feedback off
+  int max_video_bitrate_;               // configured, 0 if picked by encoder
+  int video_bitrate_;                   // applied to encoder
+  LoudnessNormalizer* loudness_;        // nullptr if gain static
+  double volume_;                       // configured, without loudness gain
+
+  static GstPadProbeReturn encoder_caps_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+
+#if defined(MACHINE_LEARNING)
   void HandleMlNotification(const std::vector<fastotv::commands_info::ml::ImageBox>& images);
 
+  MlNotificationBatch* ml_notifications_;  // streaming threads, flushed by main timer
+  DetectionSei* detection_sei_;            // nullptr if detections not carried in video
+
   static void new_prediction_callback(GstElement* elem, gpointer meta, gpointer user_data);
+  static void inference_results_callback(const std::vector<fastocloud::machine_learning::InferenceBoxShm>& boxes,
+                                         gpointer user_data);
 #endif
 };
 
@@ -14,11 +14,21 @@
 
 #include "stream/streams/encoding/playlist_encoding_stream.h"
 
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
 #include <string>
 
 #include <gst/app/gstappsrc.h>  // for GST_APP_SRC
 
+#include <common/sprintf.h>
+
+#include "stream/buffer_pool.h"
+#include "stream/elements/element.h"
 #include "stream/elements/sources/appsrc.h"
+#include "stream/elements/sources/filesrc.h"
+#include "stream/gstreamer_utils.h"
 
 #include "stream/streams/builders/encoding/playlist_encoding_stream_builder.h"
 
@@ -28,14 +38,82 @@ namespace fastocloud {
 namespace stream {
 namespace streams {
 
+struct PlaylistEncodingStream::GaplessFile {
+  explicit GaplessFile(const InputUri& uri)
+      : uri(uri),
+        src(nullptr),
+        parsebin(nullptr),
+        video_pad(nullptr),
+        audio_pad(nullptr),
+        video_eos(false),
+        audio_eos(false),
+        no_more_pads(false) {}
+
+  const InputUri uri;
+  elements::Element* src;
+  elements::ElementParsebin* parsebin;
+  GstPad* video_pad;  // requested on concat, released if file has no such track
+  GstPad* audio_pad;
+  std::atomic<bool> video_eos;
+  std::atomic<bool> audio_eos;
+  bool no_more_pads;
+};
+
+namespace {
+
+GstPadProbeReturn gapless_eos_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_EOS) {
+    *static_cast<std::atomic<bool>*>(user_data) = true;
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+GstPad* request_concat_pad(elements::ElementConcat* concat, std::atomic<bool>* eos) {
+  if (!concat) {
+    return nullptr;
+  }
+
+  GstPad* pad = gst_element_get_request_pad(concat->GetGstElement(), "sink_%u");
+  if (pad) {
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, gapless_eos_probe, eos, nullptr);
+  }
+  return pad;
+}
+
+void release_concat_pad(elements::ElementConcat* concat, GstPad** pad) {
+  if (!*pad) {
+    return;
+  }
+
+  gst_element_release_request_pad(concat->GetGstElement(), *pad);
+  gst_object_unref(*pad);
+  *pad = nullptr;
+}
+
+}  // namespace
+
 PlaylistEncodingStream::PlaylistEncodingStream(const EncodeConfig* config, IStreamClient* client, StreamStruct* stats)
-    : EncodingStream(config, client, stats), app_src_(nullptr), current_file_(nullptr), curent_pos_(0) {}
+    : EncodingStream(config, client, stats),
+      app_src_(nullptr),
+      buffer_pool_(nullptr),
+      current_file_(nullptr),
+      curent_pos_(0),
+      video_concat_(nullptr),
+      audio_concat_(nullptr),
+      gapless_files_(),
+      gapless_mutex_(),
+      next_gapless_id_(0) {}
 
 PlaylistEncodingStream::~PlaylistEncodingStream() {
   if (current_file_) {
     fclose(current_file_);
     current_file_ = nullptr;
   }
+
+  ClearGaplessFiles();
+  destroy(&buffer_pool_);
 }
 
 const char* PlaylistEncodingStream::ClassName() const {
@@ -44,6 +122,17 @@ const char* PlaylistEncodingStream::ClassName() const {
 
 void PlaylistEncodingStream::OnAppSrcCreatedCreated(elements::sources::ElementAppSrc* src) {
   app_src_ = src;
+  if (!buffer_pool_) {
+    const guint depth = src->GetMaxBytes() / BUFFER_SIZE + 1;
+    buffer_pool_ = new BufferPool(BUFFER_SIZE, depth);
+  }
+
+  if (buffer_pool_->Start()) {
+    src->SetBufferPool(buffer_pool_);
+  } else {
+    WARNING_LOG() << "Buffer pool can't be started, buffers will be allocated";
+  }
+
   gboolean res = src->RegisterNeedDataCallback(PlaylistEncodingStream::need_data_callback, this);
   DCHECK(res);
 }
@@ -53,38 +142,232 @@ IBaseBuilder* PlaylistEncodingStream::CreateBuilder() {
   return new builders::PlaylistEncodingStreamBuilder(econf, this);
 }
 
-void PlaylistEncodingStream::PreLoop() {}
+void PlaylistEncodingStream::OnGaplessCreated(elements::ElementConcat* video_concat,
+                                              elements::ElementConcat* audio_concat) {
+  ClearGaplessFiles();  // elements of previous pipeline
+  video_concat_ = video_concat;
+  audio_concat_ = audio_concat;
+}
+
+void PlaylistEncodingStream::PreLoop() {
+  if (!IsGapless()) {
+    return;
+  }
+
+  if (PrerollNextFile() && client_) {
+    client_->OnInputChanged(this, gapless_files_.front()->uri);
+  }
+  ignore_result(PrerollNextFile());
+}
+
+gboolean PlaylistEncodingStream::HandleMainTimerTick() {
+  gboolean res = EncodingStream::HandleMainTimerTick();
+  if (IsGapless()) {
+    ReleaseFinishedFiles();
+  }
+  return res;
+}
+
+bool PlaylistEncodingStream::IsTrackPreselected() const {
+  return IsGapless() || EncodingStream::IsTrackPreselected();
+}
+
+bool PlaylistEncodingStream::IsGapless() const {
+  return video_concat_ || audio_concat_;
+}
+
+bool PlaylistEncodingStream::PrerollNextFile() {
+  const PlaylistEncodeConfig* econf = static_cast<const PlaylistEncodeConfig*>(GetConfig());
+  const size_t attempts = econf->GetInput().size();
+  InputUri iuri;
+  std::string path;
+  for (size_t i = 0;; ++i) {
+    if (i == attempts || !SelectNextInput(&iuri)) {
+      return false;
+    }
+
+    path = iuri.GetInput().GetPath().GetPath();
+    if (access(path.c_str(), R_OK) == 0) {
+      break;
+    }
+    WARNING_LOG() << "File " << path << " can't open for playing";
+  }
+
+  const element_id_t id = next_gapless_id_++;
+  GaplessFile* file = new GaplessFile(iuri);
+  file->src = elements::sources::make_file_src(path, id);
+  file->parsebin = new elements::ElementParsebin(common::MemSPrintf(PARSEBIN_NAME_1U, id));
+  // concat plays pads in request order, so tracks of file wait until previous file ends
+  file->video_pad = request_concat_pad(video_concat_, &file->video_eos);
+  file->audio_pad = request_concat_pad(audio_concat_, &file->audio_eos);
+  ElementAdd(file->src);
+  ElementAdd(file->parsebin);
+  gst_element_link(file->src->GetGstElement(), file->parsebin->GetGstElement());
+  gboolean res = file->parsebin->RegisterPadAddedCallback(gapless_pad_added_callback, this);
+  DCHECK(res);
+  res = file->parsebin->RegisterNoMorePadsCallback(gapless_no_more_pads_callback, this);
+  DCHECK(res);
+  {
+    std::unique_lock<std::mutex> lock(gapless_mutex_);
+    gapless_files_.push_back(file);
+  }
+
+  gst_element_sync_state_with_parent(file->parsebin->GetGstElement());
+  gst_element_sync_state_with_parent(file->src->GetGstElement());
+  INFO_LOG() << "File " << path << " prerolled for playing";
+  return true;
+}
+
+void PlaylistEncodingStream::ReleaseFinishedFiles() {
+  bool switched = false;
+  while (true) {
+    GaplessFile* file = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(gapless_mutex_);
+      if (gapless_files_.empty()) {
+        break;
+      }
+
+      GaplessFile* front = gapless_files_.front();
+      const bool finished = front->no_more_pads && (!front->video_pad || front->video_eos) &&
+                            (!front->audio_pad || front->audio_eos);
+      if (!finished) {
+        break;
+      }
+      file = front;
+      gapless_files_.erase(gapless_files_.begin());
+    }
+
+    release_concat_pad(video_concat_, &file->video_pad);
+    release_concat_pad(audio_concat_, &file->audio_pad);
+    ElementRemove(file->parsebin);
+    ElementRemove(file->src);
+    delete file;
+    switched = true;
+  }
+
+  if (switched && !gapless_files_.empty() && client_) {
+    client_->OnInputChanged(this, gapless_files_.front()->uri);
+  }
+
+  // next file always waits on concat, so switch does not depend on this timer
+  while (gapless_files_.size() < 2 && PrerollNextFile()) {
+  }
+}
+
+void PlaylistEncodingStream::ClearGaplessFiles() {
+  std::unique_lock<std::mutex> lock(gapless_mutex_);
+  for (GaplessFile* file : gapless_files_) {
+    if (file->video_pad) {
+      gst_object_unref(file->video_pad);
+    }
+    if (file->audio_pad) {
+      gst_object_unref(file->audio_pad);
+    }
+    delete file;
+  }
+  gapless_files_.clear();
+}
+
+void PlaylistEncodingStream::gapless_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data) {
+  PlaylistEncodingStream* stream = reinterpret_cast<PlaylistEncodingStream*>(user_data);
+  stream->HandleGaplessPadAdded(src, new_pad);
+}
+
+void PlaylistEncodingStream::gapless_no_more_pads_callback(GstElement* src, gpointer user_data) {
+  PlaylistEncodingStream* stream = reinterpret_cast<PlaylistEncodingStream*>(user_data);
+  stream->HandleGaplessNoMorePads(src);
+}
+
+void PlaylistEncodingStream::HandleGaplessPadAdded(GstElement* src, GstPad* new_pad) {
+  const gchar* new_pad_type = pad_get_type(new_pad);
+  if (!new_pad_type) {
+    return;
+  }
+
+  const PlaylistEncodeConfig* econf = static_cast<const PlaylistEncodeConfig*>(GetConfig());
+  std::unique_lock<std::mutex> lock(gapless_mutex_);
+  for (GaplessFile* file : gapless_files_) {
+    if (file->parsebin->GetGstElement() != src) {
+      continue;
+    }
+
+    GstPad* sink_pad = nullptr;
+    if (strncmp(new_pad_type, "video", 5) == 0) {
+      sink_pad = file->video_pad;
+    } else if (strncmp(new_pad_type, "audio", 5) == 0) {
+      const auto audio_select = econf->GetAudioSelect();
+      int current_audio_track = 0;
+      if (!audio_select || (GetPadId(GST_PAD_NAME(new_pad), &current_audio_track) &&
+                            *audio_select == current_audio_track)) {
+        sink_pad = file->audio_pad;
+      }
+    }
+
+    if (sink_pad && !gst_pad_is_linked(sink_pad) && GST_PAD_LINK_FAILED(gst_pad_link(new_pad, sink_pad))) {
+      WARNING_LOG() << "Failed to link playlist file track: " << new_pad_type;
+    }
+    return;
+  }
+}
+
+void PlaylistEncodingStream::HandleGaplessNoMorePads(GstElement* src) {
+  std::unique_lock<std::mutex> lock(gapless_mutex_);
+  for (GaplessFile* file : gapless_files_) {
+    if (file->parsebin->GetGstElement() != src) {
+      continue;
+    }
+
+    // track missing in file, concat goes on with next file
+    if (file->video_pad && !gst_pad_is_linked(file->video_pad)) {
+      release_concat_pad(video_concat_, &file->video_pad);
+    }
+    if (file->audio_pad && !gst_pad_is_linked(file->audio_pad)) {
+      release_concat_pad(audio_concat_, &file->audio_pad);
+    }
+    file->no_more_pads = true;
+    return;
+  }
+}
 
 void PlaylistEncodingStream::HandleNeedData(GstElement* pipeline, guint rsize) {
   UNUSED(pipeline);
-  UNUSED(rsize);
 
-  size_t size = 0;
-  char* ptr = static_cast<char*>(calloc(BUFFER_SIZE, sizeof(char)));
-  if (!ptr) {
-    app_src_->SendEOS();
+  GstBuffer* buffer = app_src_->AcquireBuffer(rsize, BUFFER_SIZE);
+  if (!buffer) {
+    app_src_->SendEOS();  // send  eos
     return;
   }
 
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_WRITE)) {
+    gst_buffer_unref(buffer);
+    app_src_->SendEOS();  // send  eos
+    return;
+  }
+
+  size_t size = 0;
   while (size == 0) {
     if (!current_file_) {
       current_file_ = OpenNextFile();
     }
 
     if (!current_file_) {
-      app_src_->SendEOS();
-      free(ptr);
+      gst_buffer_unmap(buffer, &map);
+      gst_buffer_unref(buffer);
+      app_src_->SendEOS();  // send  eos
       return;
     }
 
-    size = fread(ptr, sizeof(char), BUFFER_SIZE, current_file_);
+    size = fread(map.data, sizeof(char), map.size, current_file_);
     if (size == 0) {
       fclose(current_file_);
       current_file_ = nullptr;
     }
   }
 
-  GstBuffer* buffer = gst_buffer_new_wrapped(ptr, size);
+  gst_buffer_unmap(buffer, &map);
+  gst_buffer_set_size(buffer, size);
   GstFlowReturn ret = app_src_->PushBuffer(buffer);
   if (ret != GST_FLOW_OK) {
     WARNING_LOG() << "gst_app_src_push_buffer failed: " << gst_flow_get_name(ret);
@@ -97,7 +380,7 @@ void PlaylistEncodingStream::need_data_callback(GstElement* pipeline, guint size
   return stream->HandleNeedData(pipeline, size);
 }
 
-FILE* PlaylistEncodingStream::OpenNextFile() {
+bool PlaylistEncodingStream::SelectNextInput(InputUri* iuri) {
   const PlaylistEncodeConfig* econf = static_cast<const PlaylistEncodeConfig*>(GetConfig());
   const auto loop = econf->GetLoop();
 
@@ -105,7 +388,7 @@ FILE* PlaylistEncodingStream::OpenNextFile() {
     input_t input = econf->GetInput();
     if (curent_pos_ >= input.size()) {
       INFO_LOG() << "No more files for playing";
-      return nullptr;  // EOS
+      return false;  // EOS
     }
   }
 
@@ -114,9 +397,17 @@ FILE* PlaylistEncodingStream::OpenNextFile() {
     curent_pos_ = 0;
   }
 
-  InputUri iuri = input[curent_pos_];
+  *iuri = input[curent_pos_++];
+  return true;
+}
+
+FILE* PlaylistEncodingStream::OpenNextFile() {
+  InputUri iuri;
+  if (!SelectNextInput(&iuri)) {
+    return nullptr;
+  }
+
   common::uri::Url uri = iuri.GetInput();
-  curent_pos_++;
   common::uri::Upath path = uri.GetPath();
   std::string cur_path = path.GetPath();
   FILE* file = fopen(cur_path.c_str(), "rb");
@@ -14,12 +14,18 @@
 
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 #include "stream/streams/encoding/encoding_stream.h"
 
 namespace fastocloud {
 namespace stream {
 
+class BufferPool;
+
 namespace elements {
+class ElementConcat;
 namespace sources {
 class ElementAppSrc;
 }
@@ -42,20 +48,43 @@ class PlaylistEncodingStream : public EncodingStream {
 
  protected:
   void PreLoop() override;
+  gboolean HandleMainTimerTick() override;
+  bool IsTrackPreselected() const override;
 
   virtual void OnAppSrcCreatedCreated(elements::sources::ElementAppSrc* src);
+  virtual void OnGaplessCreated(elements::ElementConcat* video_concat, elements::ElementConcat* audio_concat);
   IBaseBuilder* CreateBuilder() override;
 
   virtual void HandleNeedData(GstElement* pipeline, guint rsize);
+  virtual void HandleGaplessPadAdded(GstElement* src, GstPad* new_pad);
+  virtual void HandleGaplessNoMorePads(GstElement* src);
 
  private:
+  struct GaplessFile;
+
   static void need_data_callback(GstElement* pipeline, guint size, gpointer user_data);
+  static void gapless_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data);
+  static void gapless_no_more_pads_callback(GstElement* src, gpointer user_data);
 
+  bool SelectNextInput(InputUri* iuri);
   FILE* OpenNextFile();
 
+  bool IsGapless() const;
+  // filesrc and parsebin of next file, its tracks wait on concat pads requested after pads of previous file
+  bool PrerollNextFile();
+  void ReleaseFinishedFiles();  // every track of file passed eos, concat plays next file
+  void ClearGaplessFiles();
+
   elements::sources::ElementAppSrc* app_src_;
+  BufferPool* buffer_pool_;
   FILE* current_file_;
   size_t curent_pos_;
+
+  elements::ElementConcat* video_concat_;
+  elements::ElementConcat* audio_concat_;
+  std::vector<GaplessFile*> gapless_files_;  // playing first, then prerolled
+  std::mutex gapless_mutex_;                 // tracks linked from streaming threads
+  element_id_t next_gapless_id_;
 };
 
 }  // namespace streams
@@ -0,0 +1,52 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/streams/encoding/radio_stream.h"
+
+#include <string>
+
+#include "stream/gstreamer_utils.h"
+
+#include "stream/streams/builders/encoding/radio_stream_builder.h"
+
+namespace fastocloud {
+namespace stream {
+namespace streams {
+
+RadioStream::RadioStream(const EncodeConfig* config, IStreamClient* client, StreamStruct* stats)
+    : EncodingStream(config, client, stats) {}
+
+const char* RadioStream::ClassName() const {
+  return "RadioStream";
+}
+
+IBaseBuilder* RadioStream::CreateBuilder() {
+  const EncodeConfig* econf = static_cast<const EncodeConfig*>(GetConfig());
+  return new builders::RadioStreamBuilder(econf, this);
+}
+
+gboolean RadioStream::HandleDecodeBinAutoplugger(GstElement* elem, GstPad* pad, GstCaps* caps) {
+  std::string type_title;
+  std::string type_full;
+  SupportedVideoCodec svideo;
+  if (get_type_from_caps(caps, &type_title, &type_full) && IsVideoCodecFromType(type_title, &svideo)) {
+    // cover art and video tracks exposed encoded and left unlinked instead of decoded
+    return FALSE;
+  }
+  return EncodingStream::HandleDecodeBinAutoplugger(elem, pad, caps);
+}
+
+}  // namespace streams
+}  // namespace stream
+}  // namespace fastocloud
@@ -28,7 +28,7 @@ namespace stream {
 namespace streams {
 
 RtspEncodingStream::RtspEncodingStream(const EncodeConfig* config, IStreamClient* client, StreamStruct* stats)
-    : EncodingStream(config, client, stats) {}
+    : EncodingStream(config, client, stats), jitter_(config->GetRtspIngest()) {}
 
 const char* RtspEncodingStream::ClassName() const {
   return "RtspEncodingStream";
@@ -39,7 +39,15 @@ IBaseBuilder* RtspEncodingStream::CreateBuilder() {
   return new builders::RtspEncodingStreamBuilder(econf, this);
 }
 
+gboolean RtspEncodingStream::HandleMainTimerTick() {
+  if (!jitter_.Tick()) {
+    Quit(EXIT_SELF);  // recreated over tcp
+  }
+  return EncodingStream::HandleMainTimerTick();
+}
+
 void RtspEncodingStream::OnRTSPSrcCreated(elements::sources::ElementRTSPSrc* src) {
+  jitter_.OnSourceCreated(src);
   gboolean pad_added = src->RegisterPadAddedCallback(rtspsrc_pad_added_callback, this);
   DCHECK(pad_added);
 }
@@ -57,7 +65,10 @@ void RtspEncodingStream::HandleRtspSrcPadAdded(GstElement* src, GstPad* new_pad)
   }
 
   INFO_LOG() << "RTP Pad added: " << new_pad_type;
-  elements::Element* dest = GetElementByName(common::MemSPrintf(DECODEBIN_NAME_1U, 0));
+  elements::Element* dest = FindElement(INGEST_TEE_ROLE, 0);  // session publisher
+  if (!dest) {
+    dest = GetElement(DECODEBIN_ROLE, 0);
+  }
 
   if (!dest) {
     return;
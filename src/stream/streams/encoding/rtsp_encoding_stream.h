@@ -16,6 +16,8 @@
 
 #include "stream/streams/encoding/encoding_stream.h"
 
+#include "stream/rtsp_jitter.h"
+
 namespace fastocloud {
 namespace stream {
 namespace elements {
@@ -38,12 +40,15 @@ class RtspEncodingStream : public EncodingStream {
 
  protected:
   IBaseBuilder* CreateBuilder() override;
+  gboolean HandleMainTimerTick() override;
 
   virtual void OnRTSPSrcCreated(elements::sources::ElementRTSPSrc* src);
   virtual void HandleRtspSrcPadAdded(GstElement* src, GstPad* new_pad);
 
  private:
   static void rtspsrc_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data);
+
+  RtspJitterControl jitter_;
 };
 
 }  // namespace streams
@@ -14,18 +14,71 @@
 
 #include "stream/streams/mosaic_options.h"
 
+#include <algorithm>
+
 namespace fastocloud {
 namespace stream {
 namespace streams {
 
 SoundInfo::SoundInfo() : channels() {}
 
+TileSource::TileSource() : tile_size(), source_size(), source_framerate(0) {}
+
 MosaicImageOptions::MosaicImageOptions() : screen_size(), right_padding(0), sreams() {}
 
 bool MosaicImageOptions::isValid() const {
   return screen_size.width != 0 && screen_size.height != 0;
 }
 
+namespace {
+
+const uint32_t kChannelsMask = 0xf;
+const uint32_t kLevelBits = 4;
+
+uint32_t level_shift(size_t channel) {
+  return kLevelBits * (channel + 1);
+}
+
+}  // namespace
+
+MeterLevels::MeterLevels() : packed_(0) {}
+
+void MeterLevels::AddChannels(size_t count) {
+  uint32_t cur = packed_.load(std::memory_order_relaxed);
+  uint32_t next;
+  do {
+    size_t channels = std::min<size_t>((cur & kChannelsMask) + count, max_channels);
+    next = (cur & ~kChannelsMask) | static_cast<uint32_t>(channels);
+  } while (!packed_.compare_exchange_weak(cur, next, std::memory_order_release, std::memory_order_relaxed));
+}
+
+bool MeterLevels::SetLevel(size_t channel, int level) {
+  const uint32_t value = static_cast<uint32_t>(std::max(0, std::min<int>(level, max_level)));
+  const uint32_t mask = static_cast<uint32_t>(max_level) << level_shift(channel);
+  uint32_t cur = packed_.load(std::memory_order_relaxed);
+  uint32_t next;
+  do {
+    if (channel >= (cur & kChannelsMask)) {
+      return false;
+    }
+    next = (cur & ~mask) | (value << level_shift(channel));
+    if (next == cur) {
+      return false;
+    }
+  } while (!packed_.compare_exchange_weak(cur, next, std::memory_order_release, std::memory_order_relaxed));
+  return true;
+}
+
+MeterLevels::Snapshot MeterLevels::Load() const {
+  const uint32_t cur = packed_.load(std::memory_order_acquire);
+  Snapshot res;
+  res.channels = cur & kChannelsMask;
+  for (size_t i = 0; i < max_channels; ++i) {
+    res.levels[i] = i < res.channels ? static_cast<int>((cur >> level_shift(i)) & max_level) : 0;
+  }
+  return res;
+}
+
 }  // namespace streams
 }  // namespace stream
 }  // namespace fastocloud
@@ -14,9 +14,13 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <atomic>
 #include <vector>
 
 #include <common/draw/types.h>
+#include <common/macros.h>
 
 #include "base/types.h"
 #include "stream/stypes.h"
@@ -46,6 +50,15 @@ struct StreamInfo {
   SoundInfo sound;
 };
 
+// tile decode hints, source filled from caps before decoder is plugged
+struct TileSource {
+  TileSource();
+
+  common::draw::Size tile_size;
+  common::draw::Size source_size;
+  double source_framerate;  // 0 - unknown
+};
+
 struct MosaicImageOptions {
   MosaicImageOptions();
   bool isValid() const;
@@ -55,6 +68,27 @@ struct MosaicImageOptions {
   std::vector<StreamInfo> sreams;
 };
 
+// lit meter cells of tile channels packed into one word, bus thread writes and draw reads without locks
+class MeterLevels {
+ public:
+  enum { max_channels = 6, max_level = 15 };
+  struct Snapshot {
+    size_t channels;
+    int levels[max_channels];
+  };
+
+  MeterLevels();
+
+  void AddChannels(size_t count);           // clamped to max_channels
+  bool SetLevel(size_t channel, int level);  // false if unchanged or unknown channel
+  Snapshot Load() const;
+
+ private:
+  std::atomic<uint32_t> packed_;
+
+  DISALLOW_COPY_AND_ASSIGN(MeterLevels);
+};
+
 }  // namespace streams
 }  // namespace stream
 }  // namespace fastocloud
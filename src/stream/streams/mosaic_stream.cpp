@@ -16,10 +16,9 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <string>
 
-#include <common/sprintf.h>
-
 #include "base/gst_constants.h"
 #include "stream/gstreamer_utils.h"
 
@@ -28,6 +27,7 @@
 #include "stream/streams/builders/mosaic_stream_builder.h"
 
 #include "stream/pad/pad.h"
+#include "stream/probes.h"
 
 #define COUNT_CHUNKS 10
 #define CHANNELS 2
@@ -36,6 +36,14 @@ namespace fastocloud {
 namespace stream {
 namespace streams {
 
+namespace {
+
+int meter_level(double rms_db) {  // lit cells
+  return std::max(0, std::min(static_cast<int>(rms_db / -10), COUNT_CHUNKS));
+}
+
+}  // namespace
+
 void MosaicStream::ConnectDecodebinSignals(elements::ElementDecodebin* decodebin) {
   gboolean pad_added = decodebin->RegisterPadAddedCallback(decodebin_pad_added_callback, this);
   DCHECK(pad_added);
@@ -52,6 +60,9 @@ void MosaicStream::ConnectDecodebinSignals(elements::ElementDecodebin* decodebin
 
 void MosaicStream::ConnectCairoSignals(elements::video::ElementCairoOverlay* cairo, const MosaicImageOptions& options) {
   options_ = options;
+  levels_count_ = options.sreams.size();
+  levels_.reset(new MeterLevels[levels_count_]);
+  levels_generation_.fetch_add(1, std::memory_order_release);
   gboolean cairo_draw = cairo->RegisterDrawCallback(cairo_draw_callback, this);
   DCHECK(cairo_draw);
 }
@@ -77,6 +88,22 @@ gboolean MosaicStream::HandleDecodeBinAutoplugger(GstElement* elem, GstPad* pad,
   bool is_audio = IsAudioCodecFromType(type_title, &saudio);
   bool is_video = IsVideoCodecFromType(type_title, &svideo);
   bool is_demuxer = IsDemuxerFromType(type_title, &sdemuxer);
+  if (is_video && tiles_.size() > elem_id) {  // decoder not plugged yet
+    GstStructure* video_struct = gst_caps_get_structure(caps, 0);
+    TileSource& tile = tiles_[elem_id];
+    gint width = 0;
+    gint height = 0;
+    if (video_struct && gst_structure_get_int(video_struct, "width", &width) &&
+        gst_structure_get_int(video_struct, "height", &height)) {
+      tile.source_size = common::draw::Size(width, height);
+    }
+    gint fps_n = 0;
+    gint fps_d = 0;
+    if (video_struct && gst_structure_get_fraction(video_struct, "framerate", &fps_n, &fps_d) && fps_d) {
+      tile.source_framerate = static_cast<double>(fps_n) / fps_d;
+    }
+  }
+
   if (is_demuxer) {
     if (sdemuxer == VIDEO_MPEGTS_DEMUXER) {
       return TRUE;
@@ -96,6 +123,8 @@ gboolean MosaicStream::HandleDecodeBinAutoplugger(GstElement* elem, GstPad* pad,
       return TRUE;
     } else if (svideo == VIDEO_H265_CODEC) {
       return TRUE;
+    } else if (svideo == VIDEO_AV1_CODEC) {
+      return TRUE;
     } else if (svideo == VIDEO_MPEG_CODEC) {
       return TRUE;
     }
@@ -155,20 +184,19 @@ void MosaicStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
   const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
   if (is_video) {
     if (config->HaveVideo() && !IsVideoInited()) {
-      dest = GetElementByName(common::MemSPrintf(UDB_VIDEO_NAME_1U, elem_id));
+      dest = GetElement(UDB_VIDEO_ROLE, elem_id);
     }
   } else if (is_audio) {
     if (config->HaveAudio() && !IsAudioInited()) {
-      dest = GetElementByName(common::MemSPrintf(UDB_AUDIO_NAME_1U, elem_id));
+      dest = GetElement(UDB_AUDIO_ROLE, elem_id);
       GstCaps* caps = gst_pad_get_current_caps(new_pad);
       GstStructure* pad_struct = gst_caps_get_structure(caps, 0);
       if (pad_struct) {
         gint channels = 0;
         if (gst_structure_get_int(pad_struct, "channels", &channels)) {
-          for (gint i = 0; i < channels; ++i) {
-            if (options_.sreams.size() > elem_id) {
-              options_.sreams[elem_id].sound.channels.push_back(AudioChannelInfo());
-            }
+          if (levels_count_ > elem_id) {
+            levels_[elem_id].AddChannels(channels);
+            levels_generation_.fetch_add(1, std::memory_order_release);
           }
         }
       }
@@ -212,18 +240,52 @@ void MosaicStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
 }
 
 void MosaicStream::HandleElementAdded(GstBin* bin, GstElement* element) {
-  UNUSED(bin);
-
   const std::string element_plugin_name = elements::Element::GetPluginName(element);
   DEBUG_LOG() << "decodebin added element: " << element_plugin_name;
+
+  element_id_t elem_id;
+  if (GetElementId(GST_ELEMENT_NAME(bin), &elem_id) && tiles_.size() > elem_id) {
+    SetupTileDecoder(elem_id, element);
+  }
+}
+
+void MosaicStream::SetupTileDecoder(element_id_t tile, GstElement* decoder) const {
+  // only avdec decoders scale and skip inside, gpu compositors scale right after hardware decoders
+  GObjectClass* klass = G_OBJECT_GET_CLASS(decoder);
+  const TileSource& source = tiles_[tile];
+  if (g_object_class_find_property(klass, "lowres") && source.source_size.IsValid() &&
+      source.tile_size.IsValid()) {
+    gint lowres = 0;  // 1/2 or 1/4 size, never below tile
+    while (lowres < 2 && (source.source_size.width >> (lowres + 1)) >= source.tile_size.width &&
+           (source.source_size.height >> (lowres + 1)) >= source.tile_size.height) {
+      lowres++;
+    }
+    if (lowres) {
+      g_object_set(decoder, "lowres", lowres, nullptr);  // noop for codecs without lowres support
+      INFO_LOG() << "Tile " << tile << " decoded at 1/" << (1 << lowres) << " size";
+    }
+  }
+
+  const EncodeConfig* conf = static_cast<const EncodeConfig*>(GetConfig());
+  const auto framerate = conf->GetFramerate();
+  if (framerate && *framerate > 0 && source.source_framerate >= *framerate * 2 &&
+      g_object_class_find_property(klass, "skip-frame")) {
+    g_object_set(decoder, "skip-frame", 1, nullptr);  // non reference frames, dropped by videorate anyway
+    INFO_LOG() << "Tile " << tile << " skips non reference frames";
+  }
 }
 
 GValueArray* MosaicStream::HandleAutoplugSort(GstElement* bin, GstPad* pad, GstCaps* caps, GValueArray* factories) {
   UNUSED(bin);
   UNUSED(pad);
   UNUSED(caps);
-  UNUSED(factories);
-  return nullptr;
+  const AudioVideoConfig* conf = static_cast<const AudioVideoConfig*>(GetConfig());
+  const auto hw_decode = conf->GetHwDecode();
+  if (!hw_decode) {
+    return nullptr;
+  }
+
+  return sort_hardware_decoders(factories, *hw_decode);  // tiles decoded on gpu while it has capacity
 }
 
 void MosaicStream::HandleCairoDraw(GstElement* overlay, cairo_t* cr, guint64 timestamp, guint64 duration) {
@@ -235,13 +297,49 @@ void MosaicStream::HandleCairoDraw(GstElement* overlay, cairo_t* cr, guint64 tim
     return;
   }
 
+  const common::draw::Size screen = options_.screen_size;
+  if (meters_ && (cairo_image_surface_get_width(meters_) != screen.width ||
+                  cairo_image_surface_get_height(meters_) != screen.height)) {
+    cairo_surface_destroy(meters_);
+    meters_ = nullptr;
+  }
+
+  const uint32_t generation = levels_generation_.load(std::memory_order_acquire);
+  if (!meters_ || generation != drawn_generation_) {
+    if (!meters_) {
+      meters_ = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, screen.width, screen.height);
+    }
+    cairo_t* meters_cr = cairo_create(meters_);
+    cairo_set_operator(meters_cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(meters_cr);
+    cairo_set_operator(meters_cr, CAIRO_OPERATOR_OVER);
+    DrawMeters(meters_cr);
+    cairo_destroy(meters_cr);
+    cairo_surface_flush(meters_);
+    drawn_generation_ = generation;
+  }
+
+  // one blit clipped to meter strips, tiles untouched
+  cairo_save(cr);
+  for (const StreamInfo& stream : options_.sreams) {
+    const ImageInfo& img = stream.img;
+    cairo_rectangle(cr, img.x_y.x + img.size.width - options_.right_padding, img.x_y.y, options_.right_padding,
+                    img.size.height);
+  }
+  cairo_clip(cr);
+  cairo_set_source_surface(cr, meters_, 0, 0);
+  cairo_paint(cr);
+  cairo_restore(cr);
+}
+
+void MosaicStream::DrawMeters(cairo_t* cr) const {
   int right_padding = options_.right_padding;
   int width_chunk = options_.right_padding / (2 * CHANNELS);
   int padding = width_chunk;
 
-  for (const StreamInfo& stream : options_.sreams) {
-    ImageInfo img = stream.img;
-    SoundInfo sound = stream.sound;
+  for (size_t t = 0; t < options_.sreams.size() && t < levels_count_; ++t) {
+    const ImageInfo& img = options_.sreams[t].img;
+    const MeterLevels::Snapshot levels = levels_[t].Load();  // consistent per tile
 
     common::draw::Size sz = img.size;
     common::draw::Point xy = img.x_y;
@@ -253,11 +351,7 @@ void MosaicStream::HandleCairoDraw(GstElement* overlay, cairo_t* cr, guint64 tim
 
     for (size_t i = 0; i < COUNT_CHUNKS * 2; i += 2) {
       for (size_t j = 0; j < CHANNELS; ++j) {
-        // AudioChannelInfo chan = sound.channels[j];
-        double val = 0.0;
-        if (sound.channels.size() > j) {
-          val = sound.channels[j].rms_dB / -10;
-        }
+        const int val = levels.channels > j ? levels.levels[j] : 0;
         int pos = (COUNT_CHUNKS * 2 - i) / 2;  // backward
         cairo_rectangle(cr, (x0 + x_padding) + (width_chunk * j) + (x_padding / 2 * j),
                         (y0 + y_padding) + (height_chuk * i), width_chunk, height_chuk);
@@ -275,20 +369,30 @@ void MosaicStream::HandleCairoDraw(GstElement* overlay, cairo_t* cr, guint64 tim
         cairo_fill(cr);
       }
     }
-
-    // cairo_rectangle(cr, x0, y0, right_padding, sz.height);
-    // cairo_set_source_rgba(cr, 0.9, 0.0, 0.1, 0.7);
-    // cairo_fill(cr);
   }
 }
 
 MosaicStream::MosaicStream(const EncodeConfig* config, IStreamClient* client, StreamStruct* stats)
-    : IBaseStream(config, client, stats), options_() {}
+    : IBaseStream(config, client, stats),
+      tiles_(),
+      options_(),
+      levels_(),
+      levels_count_(0),
+      levels_generation_(0),
+      drawn_generation_(0),
+      meters_(nullptr) {}
 
 const char* MosaicStream::ClassName() const {
   return "MosaicStream";
 }
 
+MosaicStream::~MosaicStream() {
+  if (meters_) {
+    cairo_surface_destroy(meters_);
+    meters_ = nullptr;
+  }
+}
+
 void MosaicStream::OnInpudSrcPadCreated(pad::Pad* src_pad, element_id_t id, const common::uri::Url& url) {
   LinkInputPad(src_pad->GetGstPad(), id, url);
 }
@@ -304,6 +408,13 @@ void MosaicStream::OnDecodebinCreated(elements::ElementDecodebin* decodebin) {
   ConnectDecodebinSignals(decodebin);
 }
 
+void MosaicStream::OnLayoutCreated(const MosaicImageOptions& options) {
+  tiles_.assign(options.sreams.size(), TileSource());
+  for (size_t i = 0; i < options.sreams.size(); ++i) {
+    tiles_[i].tile_size = options.sreams[i].img.size;
+  }
+}
+
 void MosaicStream::OnCairoCreated(elements::video::ElementCairoOverlay* cairo, const MosaicImageOptions& options) {
   ConnectCairoSignals(cairo, options);
 }
@@ -313,48 +424,23 @@ IBaseBuilder* MosaicStream::CreateBuilder() {
   return new builders::MosaicStreamBuilder(conf, this);
 }
 
-gboolean MosaicStream::HandleAsyncBusMessageReceived(GstBus* bus, GstMessage* message) {
-  GstMessageType type = GST_MESSAGE_TYPE(message);
-  if (type != GST_MESSAGE_ELEMENT) {
-    return IBaseStream::HandleAsyncBusMessageReceived(bus, message);
-  }
+void MosaicStream::OnAudioMeterPadCreated(pad::Pad* pad, element_id_t id) {
+  AudioMeterProbe* probe = LinkAudioMeterPad(pad->GetGstPad(), id);
+  probe->SetLevelsCallback(audio_levels_callback, this);
+}
 
-  const GstStructure* s = gst_message_get_structure(message);
-  const gchar* name = gst_structure_get_name(s);
-  if (strcmp(name, "level") != 0) {
-    return IBaseStream::HandleAsyncBusMessageReceived(bus, message);
+void MosaicStream::HandleAudioLevels(element_id_t tile, const AudioMeter::Levels& levels) {
+  if (levels_count_ <= tile) {
+    return;
   }
 
-  GstObject* src = GST_MESSAGE_SRC(message);
-  const char* gst_element_name = GST_ELEMENT_NAME(src);
-  element_id_t elem_id;
-  if (!GetElementId(gst_element_name, &elem_id)) {
-    return IBaseStream::HandleAsyncBusMessageReceived(bus, message);
+  bool changed = false;
+  for (size_t i = 0; i < levels.channels; ++i) {  // meters draw rms only
+    changed |= levels_[tile].SetLevel(i, meter_level(levels.rms_db[i]));
   }
-
-  /* the values are packed into GValueArrays with the value per channel */
-  const GValue* array_val = gst_structure_get_value(s, "rms");
-  GValueArray* rms_arr = static_cast<GValueArray*>(g_value_get_boxed(array_val));
-
-  array_val = gst_structure_get_value(s, "peak");
-  GValueArray* peak_arr = static_cast<GValueArray*>(g_value_get_boxed(array_val));
-
-  array_val = gst_structure_get_value(s, "decay");
-  GValueArray* decay_arr = static_cast<GValueArray*>(g_value_get_boxed(array_val));
-
-  for (guint i = 0; i < rms_arr->n_values; ++i) {
-    if (options_.sreams.size() > elem_id) {
-      const GValue* value = g_value_array_get_nth(rms_arr, i);
-      options_.sreams[elem_id].sound.channels[i].rms_dB = g_value_get_double(value);
-
-      value = g_value_array_get_nth(peak_arr, i);
-      options_.sreams[elem_id].sound.channels[i].peak_dB = g_value_get_double(value);
-
-      value = g_value_array_get_nth(decay_arr, i);
-      options_.sreams[elem_id].sound.channels[i].decay_dB = g_value_get_double(value);
-    }
+  if (changed) {
+    levels_generation_.fetch_add(1, std::memory_order_release);
   }
-  return IBaseStream::HandleAsyncBusMessageReceived(bus, message);
 }
 
 void MosaicStream::PreLoop() {
@@ -369,6 +455,11 @@ void MosaicStream::PostLoop(ExitStatus status) {
   UNUSED(status);
 }
 
+void MosaicStream::audio_levels_callback(element_id_t id, const AudioMeter::Levels& levels, gpointer user_data) {
+  MosaicStream* stream = reinterpret_cast<MosaicStream*>(user_data);
+  stream->HandleAudioLevels(id, levels);
+}
+
 void MosaicStream::decodebin_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data) {
   MosaicStream* stream = reinterpret_cast<MosaicStream*>(user_data);
   stream->HandleDecodeBinPadAdded(src, new_pad);
@@ -18,6 +18,11 @@
 
 #include <gst/gst.h>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "stream/audio_meter.h"
 #include "stream/ibase_stream.h"
 #include "stream/streams/configs/encode_config.h"
 
@@ -52,6 +57,7 @@ class MosaicStream : public IBaseStream {
  public:
   MosaicStream(const EncodeConfig* config, IStreamClient* client, StreamStruct* stats);
   const char* ClassName() const override;
+  ~MosaicStream() override;
 
  protected:
   void OnInpudSrcPadCreated(pad::Pad* src_pad, element_id_t id, const common::uri::Url& url) override;
@@ -59,8 +65,10 @@ class MosaicStream : public IBaseStream {
                               element_id_t id,
                               const common::uri::Url& url,
                               bool need_push) override;
+  void OnAudioMeterPadCreated(pad::Pad* pad, element_id_t id) override;  // tile levels
 
   virtual void OnDecodebinCreated(elements::ElementDecodebin* decodebin);
+  virtual void OnLayoutCreated(const MosaicImageOptions& options);  // tiles placed, before pipeline plays
   virtual void OnCairoCreated(elements::video::ElementCairoOverlay* cairo, const MosaicImageOptions& options);
 
   IBaseBuilder* CreateBuilder() override;
@@ -71,13 +79,13 @@ class MosaicStream : public IBaseStream {
   virtual void ConnectDecodebinSignals(elements::ElementDecodebin* decodebin);
   virtual void ConnectCairoSignals(elements::video::ElementCairoOverlay* cairo, const MosaicImageOptions& options);
 
-  gboolean HandleAsyncBusMessageReceived(GstBus* bus, GstMessage* message) override;
   virtual gboolean HandleDecodeBinAutoplugger(GstElement* elem, GstPad* pad, GstCaps* caps);
   virtual void HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad);
   virtual GValueArray* HandleAutoplugSort(GstElement* bin, GstPad* pad, GstCaps* caps, GValueArray* factories);
   virtual void HandleElementAdded(GstBin* bin, GstElement* element);
 
   virtual void HandleCairoDraw(GstElement* overlay, cairo_t* cr, guint64 timestamp, guint64 duration);
+  void HandleAudioLevels(element_id_t tile, const AudioMeter::Levels& levels);  // streaming thread of tile
 
  private:
   static void decodebin_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data);
@@ -88,6 +96,7 @@ class MosaicStream : public IBaseStream {
                                                        GValueArray* factories,
                                                        gpointer user_data);
   static void decodebin_element_added_callback(GstBin* bin, GstElement* element, gpointer user_data);
+  static void audio_levels_callback(element_id_t id, const AudioMeter::Levels& levels, gpointer user_data);
 
   static void cairo_draw_callback(GstElement* overlay,
                                   cairo_t* cr,
@@ -95,7 +104,17 @@ class MosaicStream : public IBaseStream {
                                   guint64 duration,
                                   gpointer user_data);
 
-  MosaicImageOptions options_;
+  void DrawMeters(cairo_t* cr) const;
+  void SetupTileDecoder(element_id_t tile, GstElement* decoder) const;
+
+  std::vector<TileSource> tiles_;  // slot written and read by streaming thread of its tile
+
+  MosaicImageOptions options_;  // layout, set while building
+  std::unique_ptr<MeterLevels[]> levels_;  // per tile
+  size_t levels_count_;
+  std::atomic<uint32_t> levels_generation_;  // bumped on level changes
+  uint32_t drawn_generation_;
+  cairo_surface_t* meters_;  // cached meters layer, redrawn only on level changes
 };
 
 }  // namespace streams
@@ -18,25 +18,41 @@
 
 #include <gst/app/gstappsrc.h>  // for GST_APP_SRC
 
+#include "stream/buffer_pool.h"
 #include "stream/elements/sources/appsrc.h"
+#include "stream/mapped_file.h"
 #include "stream/pad/pad.h"
 
 #include "stream/streams/builders/relay/playlist_relay_stream_builder.h"
 
 #define BUFFER_SIZE 4096
+#define MMAP_SLICE_SIZE (64 * 1024)
 
 namespace fastocloud {
 namespace stream {
 namespace streams {
 
 PlaylistRelayStream::PlaylistRelayStream(const PlaylistRelayConfig* config, IStreamClient* client, StreamStruct* stats)
-    : RelayStream(config, client, stats), app_src_(nullptr), current_file_(nullptr), curent_pos_(0) {}
+    : RelayStream(config, client, stats),
+      app_src_(nullptr),
+      buffer_pool_(nullptr),
+      current_file_(nullptr),
+      current_map_(nullptr),
+      map_pos_(0),
+      curent_pos_(0) {}
 
 PlaylistRelayStream::~PlaylistRelayStream() {
   if (current_file_) {
     fclose(current_file_);
     current_file_ = nullptr;
   }
+
+  destroy(&buffer_pool_);
+
+  if (current_map_) {
+    current_map_->Unref();
+    current_map_ = nullptr;
+  }
 }
 
 const char* PlaylistRelayStream::ClassName() const {
@@ -45,6 +61,17 @@ const char* PlaylistRelayStream::ClassName() const {
 
 void PlaylistRelayStream::OnAppSrcCreatedCreated(elements::sources::ElementAppSrc* src) {
   app_src_ = src;
+  if (!buffer_pool_) {
+    const guint depth = src->GetMaxBytes() / BUFFER_SIZE + 1;
+    buffer_pool_ = new BufferPool(BUFFER_SIZE, depth);
+  }
+
+  if (buffer_pool_->Start()) {
+    src->SetBufferPool(buffer_pool_);
+  } else {
+    WARNING_LOG() << "Buffer pool can't be started, buffers will be allocated";
+  }
+
   gboolean res = src->RegisterNeedDataCallback(PlaylistRelayStream::need_data_callback, this);
   DCHECK(res);
 }
@@ -62,10 +89,22 @@ void PlaylistRelayStream::PostLoop(ExitStatus status) {
 
 void PlaylistRelayStream::HandleNeedData(GstElement* pipeline, guint rsize) {
   UNUSED(pipeline);
-  UNUSED(rsize);
 
-  char* ptr = static_cast<char*>(calloc(BUFFER_SIZE, sizeof(char)));
-  if (!ptr) {
+  const PlaylistRelayConfig* rconf = static_cast<const PlaylistRelayConfig*>(GetConfig());
+  if (rconf->IsMmap()) {
+    HandleNeedMappedData();
+    return;
+  }
+
+  GstBuffer* buffer = app_src_->AcquireBuffer(rsize, BUFFER_SIZE);
+  if (!buffer) {
+    app_src_->SendEOS();  // send  eos
+    return;
+  }
+
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_WRITE)) {
+    gst_buffer_unref(buffer);
     app_src_->SendEOS();  // send  eos
     return;
   }
@@ -77,19 +116,45 @@ void PlaylistRelayStream::HandleNeedData(GstElement* pipeline, guint rsize) {
     }
 
     if (!current_file_) {
+      gst_buffer_unmap(buffer, &map);
+      gst_buffer_unref(buffer);
       app_src_->SendEOS();  // send  eos
-      free(ptr);
       return;
     }
 
-    size = fread(ptr, sizeof(char), BUFFER_SIZE, current_file_);
+    size = fread(map.data, sizeof(char), map.size, current_file_);
     if (size == 0) {
       fclose(current_file_);
       current_file_ = nullptr;
     }
   }
 
-  GstBuffer* buffer = gst_buffer_new_wrapped(ptr, size);
+  gst_buffer_unmap(buffer, &map);
+  gst_buffer_set_size(buffer, size);
+  GstFlowReturn ret = app_src_->PushBuffer(buffer);
+  if (ret != GST_FLOW_OK) {
+    WARNING_LOG() << "gst_app_src_push_buffer failed: " << gst_flow_get_name(ret);
+    Quit(EXIT_INNER);
+  }
+}
+
+void PlaylistRelayStream::HandleNeedMappedData() {
+  while (!current_map_ || map_pos_ >= current_map_->GetSize()) {
+    if (current_map_) {
+      current_map_->Unref();
+      current_map_ = nullptr;
+    }
+
+    current_map_ = MapNextFile();
+    map_pos_ = 0;
+    if (!current_map_) {
+      app_src_->SendEOS();  // send  eos
+      return;
+    }
+  }
+
+  GstBuffer* buffer = current_map_->MakeBuffer(map_pos_, MMAP_SLICE_SIZE);
+  map_pos_ += gst_buffer_get_size(buffer);
   GstFlowReturn ret = app_src_->PushBuffer(buffer);
   if (ret != GST_FLOW_OK) {
     WARNING_LOG() << "gst_app_src_push_buffer failed: " << gst_flow_get_name(ret);
@@ -102,7 +167,7 @@ void PlaylistRelayStream::need_data_callback(GstElement* pipeline, guint size, g
   return stream->HandleNeedData(pipeline, size);
 }
 
-FILE* PlaylistRelayStream::OpenNextFile() {
+bool PlaylistRelayStream::SelectNextInput(InputUri* iuri) {
   const PlaylistRelayConfig* rconf = static_cast<const PlaylistRelayConfig*>(GetConfig());
   const bool loop = rconf->GetLoop();
 
@@ -110,7 +175,7 @@ FILE* PlaylistRelayStream::OpenNextFile() {
     input_t input = rconf->GetInput();
     if (curent_pos_ >= input.size()) {
       INFO_LOG() << "No more files for playing";
-      return nullptr;  // EOS
+      return false;  // EOS
     }
   }
 
@@ -119,7 +184,16 @@ FILE* PlaylistRelayStream::OpenNextFile() {
     curent_pos_ = 0;
   }
 
-  InputUri iuri = input[curent_pos_++];
+  *iuri = input[curent_pos_++];
+  return true;
+}
+
+FILE* PlaylistRelayStream::OpenNextFile() {
+  InputUri iuri;
+  if (!SelectNextInput(&iuri)) {
+    return nullptr;
+  }
+
   common::uri::Url uri = iuri.GetInput();
   common::uri::Upath path = uri.GetPath();
   std::string cur_path = path.GetPath();
@@ -135,6 +209,34 @@ FILE* PlaylistRelayStream::OpenNextFile() {
   return file;
 }
 
+MappedFile* PlaylistRelayStream::MapNextFile() {
+  InputUri iuri;
+  if (!SelectNextInput(&iuri)) {
+    return nullptr;
+  }
+
+  std::string cur_path = iuri.GetInput().GetPath().GetPath();
+  MappedFile* file = MappedFile::Open(cur_path);
+  if (!file) {
+    WARNING_LOG() << "File " << cur_path << " can't map for playing";
+    return nullptr;
+  }
+
+  INFO_LOG() << "File " << cur_path << " mapped for playing";
+  const PlaylistRelayConfig* rconf = static_cast<const PlaylistRelayConfig*>(GetConfig());
+  input_t input = rconf->GetInput();
+  if (curent_pos_ < input.size()) {
+    MappedFile::Prefetch(input[curent_pos_].GetInput().GetPath().GetPath());
+  } else if (rconf->GetLoop() && !input.empty()) {
+    MappedFile::Prefetch(input[0].GetInput().GetPath().GetPath());
+  }
+
+  if (client_) {
+    client_->OnInputChanged(this, iuri);
+  }
+  return file;
+}
+
 }  // namespace streams
 }  // namespace stream
 }  // namespace fastocloud
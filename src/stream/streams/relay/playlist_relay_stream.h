@@ -18,12 +18,16 @@
 
 namespace fastocloud {
 namespace stream {
+
+class BufferPool;
 namespace elements {
 namespace sources {
 class ElementAppSrc;
 }
 }  // namespace elements
 
+class MappedFile;
+
 namespace streams {
 
 namespace builders {
@@ -52,10 +56,17 @@ class PlaylistRelayStream : public RelayStream {
  private:
   static void need_data_callback(GstElement* pipeline, guint size, gpointer user_data);
 
+  void HandleNeedMappedData();
+
+  bool SelectNextInput(InputUri* iuri);
   FILE* OpenNextFile();
+  MappedFile* MapNextFile();
 
   elements::sources::ElementAppSrc* app_src_;
+  BufferPool* buffer_pool_;
   FILE* current_file_;
+  MappedFile* current_map_;
+  size_t map_pos_;
   size_t curent_pos_;
 };
 
@@ -18,6 +18,8 @@
 
 #include <string>
 
+#include <common/time.h>
+
 #include "base/constants.h"
 #include "base/gst_constants.h"
 
@@ -25,6 +27,12 @@
 #include "stream/gstreamer_utils.h"  // for pad_get_type
 #include "stream/pad/pad.h"          // for Pad
 #include "stream/streams/builders/relay/relay_stream_builder.h"
+#include "stream/streams/builders/relay/ts_passthrough_stream_builder.h"
+
+#if defined(MACHINE_LEARNING)
+#include "stream/elements/machine_learning/inference_sink.h"
+#include "stream/elements/machine_learning/video_ml_filter.h"
+#endif
 
 namespace {
 const char kAvdecMpeg2Video[] = "avdec_mpeg2video";
@@ -36,7 +44,30 @@ namespace stream {
 namespace streams {
 
 RelayStream::RelayStream(const RelayConfig* config, IStreamClient* client, StreamStruct* stats)
-    : SrcDecodeBinStream(config, client, stats) {}
+    : SrcDecodeBinStream(config, client, stats)
+#if defined(MACHINE_LEARNING)
+      ,
+      ml_notifications_(nullptr),
+      detection_sei_(nullptr)
+#endif
+{
+#if defined(MACHINE_LEARNING)
+  const auto deep_learning = config->GetDeepLearning();
+  if (deep_learning) {
+    ml_notifications_ = new MlNotificationBatch(deep_learning->GetNotificationInterval());
+    if (config->GetDeepLearningMetadata()) {
+      detection_sei_ = new DetectionSei;
+    }
+  }
+#endif
+}
+
+RelayStream::~RelayStream() {
+#if defined(MACHINE_LEARNING)
+  destroy(&detection_sei_);
+  destroy(&ml_notifications_);
+#endif
+}
 
 const char* RelayStream::ClassName() const {
   return "RelayStream";
@@ -44,6 +75,10 @@ const char* RelayStream::ClassName() const {
 
 IBaseBuilder* RelayStream::CreateBuilder() {
   const RelayConfig* rconf = static_cast<const RelayConfig*>(GetConfig());
+  if (builders::TsPassthroughStreamBuilder::IsAvailable(rconf)) {
+    INFO_LOG() << "Mpegts passthrough, input forwarded without demuxing";
+    return new builders::TsPassthroughStreamBuilder(rconf, this);
+  }
   return new builders::RelayStreamBuilder(rconf, this);
 }
 
@@ -85,6 +120,8 @@ gboolean RelayStream::HandleDecodeBinAutoplugger(GstElement* elem,
       return TRUE;
     } else if (svideo == VIDEO_H265_CODEC) {
       return FALSE;
+    } else if (svideo == VIDEO_AV1_CODEC) {
+      return FALSE;
     } else if (svideo == VIDEO_MPEG_CODEC) {
       return TRUE;
     }
@@ -125,19 +162,26 @@ void RelayStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
   bool is_audio = strncmp(new_pad_type, "audio", 5) == 0;
   bool is_subtitle = strncmp(new_pad_type, "text", 4) == 0;
   elements::Element* dest = nullptr;
+  bool is_audio_track = false;
   if (is_video) {
     if (config->HaveVideo() && !IsVideoInited()) {
-      dest = GetElementByName(common::MemSPrintf(UDB_VIDEO_NAME_1U, 0));
+      dest = GetElement(UDB_VIDEO_ROLE, 0);
     }
   } else if (is_audio) {
     if (config->HaveAudio() && !IsAudioInited()) {
       const char* gst_pad_name = GST_PAD_NAME(new_pad);
       const auto audio_select = config->GetAudioSelect();
       int current_audio_track = 0;
-      if (!audio_select || (GetPadId(gst_pad_name, &current_audio_track) && *audio_select == current_audio_track)) {
-        dest = GetElementByName(common::MemSPrintf(UDB_AUDIO_NAME_1U, 0));
+      // in warm standby and gapless modes track is selected on parsebin of every input
+      if (!audio_select || IsTrackPreselected() ||
+          (GetPadId(gst_pad_name, &current_audio_track) && *audio_select == current_audio_track)) {
+        dest = GetElement(UDB_AUDIO_ROLE, 0);
       }
     }
+    if (!dest && config->HaveAudio()) {
+      dest = FindAudioTrackDest(new_pad);
+      is_audio_track = dest != nullptr;
+    }
   } else if (is_subtitle) {
     if (config->HaveSubtitle()) {
     }
@@ -168,7 +212,7 @@ void RelayStream::HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) {
 
   if (is_video) {
     SetVideoInited(true);
-  } else if (is_audio) {
+  } else if (is_audio && !is_audio_track) {
     SetAudioInited(true);
   }
   delete sink_pad;
@@ -231,6 +275,62 @@ void RelayStream::HandleDecodeBinElementRemoved(GstBin* bin, GstElement* element
   DEBUG_LOG() << "decodebin removed element: " << element_plugin_name;
 }
 
+gboolean RelayStream::HandleMainTimerTick() {
+  gboolean res = SrcDecodeBinStream::HandleMainTimerTick();
+#if defined(MACHINE_LEARNING)
+  MlNotificationBatch::images_t images;
+  if (ml_notifications_ && ml_notifications_->Flush(common::time::current_utc_mstime(), &images) && client_) {
+    client_->OnMlNotification(this, images);
+  }
+#endif
+  return res;
+}
+
+#if defined(MACHINE_LEARNING)
+void RelayStream::OnMLElementCreated(elements::machine_learning::ElementVideoMLFilter* machine,
+                                     fastoml::SupportedBackends backend) {
+  SetMlBackend(backend);
+  ignore_result(machine->RegisterNewPredictionCallback(&RelayStream::new_prediction_callback, this));
+}
+
+void RelayStream::OnInferenceSinkCreated(elements::machine_learning::ElementInferenceSink* sink) {
+  sink->SetResultsCallback(&RelayStream::inference_results_callback, this);
+}
+
+void RelayStream::OnDetectionsPadCreated(pad::Pad* pad, bool hevc) {
+  if (detection_sei_) {
+    detection_sei_->Attach(pad->GetGstPad(), hevc);
+  }
+}
+
+void RelayStream::HandleMlNotification(const std::vector<fastotv::commands_info::ml::ImageBox>& images) {
+  if (detection_sei_) {
+    detection_sei_->Push(images);
+  }
+  if (!client_) {
+    return;
+  }
+
+  MlNotificationBatch::images_t out;
+  if (ml_notifications_->Add(images, common::time::current_utc_mstime(), &out)) {
+    client_->OnMlNotification(this, out);
+  }
+}
+
+void RelayStream::new_prediction_callback(GstElement* elem, gpointer meta, gpointer user_data) {
+  UNUSED(elem);
+
+  RelayStream* stream = reinterpret_cast<RelayStream*>(user_data);
+  stream->HandleMlNotification(elements::machine_learning::make_image_boxes(meta));
+}
+
+void RelayStream::inference_results_callback(const std::vector<fastocloud::machine_learning::InferenceBoxShm>& boxes,
+                                             gpointer user_data) {
+  RelayStream* stream = reinterpret_cast<RelayStream*>(user_data);
+  stream->HandleMlNotification(elements::machine_learning::make_image_boxes(boxes));
+}
+#endif
+
 }  // namespace streams
 }  // namespace stream
 }  // namespace fastocloud
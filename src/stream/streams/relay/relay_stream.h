@@ -14,23 +14,54 @@
 
 #pragma once
 
+#include <vector>
+
 #include "stream/streams/src_decodebin_stream.h"
 
 #include "stream/streams/configs/relay_config.h"
 
+#if defined(MACHINE_LEARNING)
+#include "stream/detection_sei.h"
+#include "stream/ml_notification_batch.h"
+#endif
+
 namespace fastocloud {
+#if defined(MACHINE_LEARNING)
+namespace machine_learning {
+struct InferenceBoxShm;
+}
+#endif
 namespace stream {
+#if defined(MACHINE_LEARNING)
+namespace elements {
+namespace machine_learning {
+class ElementVideoMLFilter;
+class ElementInferenceSink;
+}
+}  // namespace elements
+#endif
 namespace streams {
 
 class RelayStream : public SrcDecodeBinStream {
  public:
   RelayStream(const RelayConfig* config, IStreamClient* client, StreamStruct* stats);
+  ~RelayStream() override;
 
   const char* ClassName() const override;
 
+#if defined(MACHINE_LEARNING)
+  // analysis branch of relayed video
+  void OnMLElementCreated(elements::machine_learning::ElementVideoMLFilter* machine,
+                          fastoml::SupportedBackends backend);
+  void OnInferenceSinkCreated(elements::machine_learning::ElementInferenceSink* sink);
+  void OnDetectionsPadCreated(pad::Pad* pad, bool hevc);  // parsed relayed video
+#endif
+
  protected:
   IBaseBuilder* CreateBuilder() override;
 
+  gboolean HandleMainTimerTick() override;
+
   gboolean HandleDecodeBinAutoplugger(GstElement* elem, GstPad* pad, GstCaps* caps) override;
   void HandleDecodeBinPadAdded(GstElement* src, GstPad* new_pad) override;
 
@@ -42,6 +73,18 @@ class RelayStream : public SrcDecodeBinStream {
 
   void HandleDecodeBinElementAdded(GstBin* bin, GstElement* element) override;
   void HandleDecodeBinElementRemoved(GstBin* bin, GstElement* element) override;
+
+#if defined(MACHINE_LEARNING)
+ private:
+  void HandleMlNotification(const std::vector<fastotv::commands_info::ml::ImageBox>& images);
+
+  MlNotificationBatch* ml_notifications_;  // streaming threads, flushed by main timer
+  DetectionSei* detection_sei_;            // nullptr if detections not carried in video
+
+  static void new_prediction_callback(GstElement* elem, gpointer meta, gpointer user_data);
+  static void inference_results_callback(const std::vector<fastocloud::machine_learning::InferenceBoxShm>& boxes,
+                                         gpointer user_data);
+#endif
 };
 
 }  // namespace streams
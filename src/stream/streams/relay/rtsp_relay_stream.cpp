@@ -28,7 +28,7 @@ namespace stream {
 namespace streams {
 
 RtspRelayStream::RtspRelayStream(const RelayConfig* config, IStreamClient* client, StreamStruct* stats)
-    : RelayStream(config, client, stats) {}
+    : RelayStream(config, client, stats), jitter_(config->GetRtspIngest()) {}
 
 const char* RtspRelayStream::ClassName() const {
   return "RtspRelayStream";
@@ -39,7 +39,15 @@ IBaseBuilder* RtspRelayStream::CreateBuilder() {
   return new builders::RtspRelayStreamBuilder(rconf, this);
 }
 
+gboolean RtspRelayStream::HandleMainTimerTick() {
+  if (!jitter_.Tick()) {
+    Quit(EXIT_SELF);  // recreated over tcp
+  }
+  return RelayStream::HandleMainTimerTick();
+}
+
 void RtspRelayStream::OnRTSPSrcCreated(elements::sources::ElementRTSPSrc* src) {
+  jitter_.OnSourceCreated(src);
   gboolean pad_added = src->RegisterPadAddedCallback(rtspsrc_pad_added_callback, this);
   DCHECK(pad_added);
 
@@ -81,7 +89,10 @@ void RtspRelayStream::HandleRtspSrcPadAdded(GstElement* src, GstPad* new_pad) {
   }
 
   INFO_LOG() << "RTP Pad added: " << new_pad_type;
-  elements::Element* dest = GetElementByName(common::MemSPrintf(DECODEBIN_NAME_1U, 0));
+  elements::Element* dest = FindElement(INGEST_TEE_ROLE, 0);  // session publisher
+  if (!dest) {
+    dest = GetElement(DECODEBIN_ROLE, 0);
+  }
 
   if (!dest) {
     return;
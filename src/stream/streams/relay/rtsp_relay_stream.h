@@ -16,6 +16,8 @@
 
 #include "stream/streams/relay/relay_stream.h"
 
+#include "stream/rtsp_jitter.h"
+
 namespace fastocloud {
 namespace stream {
 namespace elements {
@@ -37,6 +39,7 @@ class RtspRelayStream : public RelayStream {
 
  protected:
   IBaseBuilder* CreateBuilder() override;
+  gboolean HandleMainTimerTick() override;
 
   virtual void OnRTSPSrcCreated(elements::sources::ElementRTSPSrc* src);
   virtual void HandleRtspSrcPadAdded(GstElement* src, GstPad* new_pad);
@@ -45,6 +48,8 @@ class RtspRelayStream : public RelayStream {
   static void rtspsrc_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data);
   static void rtspsrc_pad_removed_callback(GstElement* self, GstPad* old_pad, gpointer user_data);
   static void rtspsrc_no_more_pads_callback(GstElement* self, gpointer user_data);
+
+  RtspJitterControl jitter_;
 };
 
 }  // namespace streams
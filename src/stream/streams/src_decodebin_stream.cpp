@@ -14,8 +14,51 @@
 
 #include "stream/streams/src_decodebin_stream.h"
 
+#include <string.h>
+
+#include <algorithm>
+
+#include <common/file_system/file_system.h>
+#include <common/sprintf.h>
+#include <common/time.h>
+
+#include "base/gst_constants.h"
+
+#include "stream/autoplug_cache.h"
 #include "stream/config.h"
+#include "stream/elements/muxer/muxer.h"
+#include "stream/elements/sink/build_output.h"
+#include "stream/elements/sources/build_input.h"
+#include "stream/elements/sources/httpsrc.h"
+#include "stream/gstreamer_utils.h"
 #include "stream/pad/pad.h"
+#include "stream/stypes.h"
+#include "stream/streams/configs/audio_video_config.h"
+
+namespace {
+const char kHlsDemux2[] = "hlsdemux2";
+
+// factories copy with named one first, nullptr if missing or already first
+GValueArray* move_factory_first(GValueArray* factories, const std::string& name) {
+  for (guint i = 0; i < factories->n_values; ++i) {
+    GValue* value = g_value_array_get_nth(factories, i);
+    GstPluginFeature* feature = GST_PLUGIN_FEATURE(g_value_get_object(value));
+    if (name != gst_plugin_feature_get_name(feature)) {
+      continue;
+    }
+
+    if (i == 0) {
+      return nullptr;
+    }
+
+    GValueArray* sorted = g_value_array_copy(factories);
+    g_value_array_remove(sorted, i);
+    g_value_array_prepend(sorted, value);
+    return sorted;
+  }
+  return nullptr;
+}
+}  // namespace
 
 namespace fastocloud {
 namespace stream {
@@ -39,10 +82,40 @@ void SrcDecodeBinStream::ConnectDecodebinSignals(elements::ElementDecodebin* dec
 
   gboolean element_removed = decodebin->RegisterElementRemoved(decodebin_element_removed_callback, this);
   DCHECK(element_removed);
+
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  if (!config->GetAudioTracks().empty()) {
+    gboolean no_more_pads = decodebin->RegisterNoMorePadsCallback(decodebin_no_more_pads_callback, this);
+    DCHECK(no_more_pads);
+  }
 }
 
 SrcDecodeBinStream::SrcDecodeBinStream(const Config* config, IStreamClient* client, StreamStruct* stats)
-    : IBaseStream(config, client, stats) {}
+    : IBaseStream(config, client, stats),
+      parsebins_(),
+      video_selector_(nullptr),
+      audio_selector_(nullptr),
+      video_selector_pads_(),
+      audio_selector_pads_(),
+      active_input_(0),
+      active_since_ts_(0),
+      standby_mutex_(),
+      input_src_(nullptr),
+      input_decodebin_(nullptr),
+      soft_restarts_(0),
+      autoplug_cache_(nullptr),
+      autoplug_found_(nullptr),
+      autoplug_confirmed_(false),
+      autoplug_saved_(false),
+      autoplug_mutex_(),
+      live_outputs_(),
+      next_live_output_id_(live_output_first_id) {}
+
+SrcDecodeBinStream::~SrcDecodeBinStream() {
+  ClearLiveOutputs();
+  destroy(&autoplug_found_);
+  destroy(&autoplug_cache_);
+}
 
 const char* SrcDecodeBinStream::ClassName() const {
   return "SrcDecodeBinStream";
@@ -57,11 +130,150 @@ void SrcDecodeBinStream::PreLoop() {
 }
 
 void SrcDecodeBinStream::PostLoop(ExitStatus status) {
-  UNUSED(status);
+  ClearLiveOutputs();
+  if (status == EXIT_INNER) {
+    DropAutoplugCache();
+  }
+}
+
+bool SrcDecodeBinStream::HandleLiveConfigUpdate(const LiveConfigUpdate& update) {
+  bool applied = true;
+  for (fastotv::channel_id_t cid : update.removed_outputs) {
+    applied &= DetachOutput(cid);
+  }
+  for (const OutputUri& output : update.added_outputs) {
+    applied &= AttachOutput(output);
+  }
+
+  LiveConfigUpdate rest = update;
+  rest.added_outputs.clear();
+  rest.removed_outputs.clear();
+  return applied && IBaseStream::HandleLiveConfigUpdate(rest);
+}
+
+bool SrcDecodeBinStream::AttachOutput(const OutputUri& output) {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const common::uri::Url uri = output.GetOutput();
+  if (uri.GetScheme() == common::uri::Url::udp || IsKvsUrl(uri)) {  // rtp pays and kvs built by builders only
+    return false;
+  }
+
+  elements::Element* video_tee = config->HaveVideo() ? FindElement(VIDEO_TEE_ROLE, 0) : nullptr;
+  elements::Element* audio_tee = config->HaveAudio() ? FindElement(AUDIO_TEE_ROLE, 0) : nullptr;
+  if ((config->HaveVideo() && !video_tee) || (config->HaveAudio() && !audio_tee)) {
+    return false;
+  }
+
+  const element_id_t id = next_live_output_id_++;
+  const fastotv::channel_id_t cid = output.GetID();
+  elements::Element* mux = elements::muxer::make_muxer(uri.GetScheme(), id, config->GetCmaf());
+  elements::Element* sink =
+      elements::sink::build_output(output, id, IsVod(), config->GetUdpEgress(), config->GetOutputSocket(cid),
+                                   config->GetLlHlsPartMsec(), config->GetCmaf(), config->GetOutputTcp(cid));
+  if (!mux || !sink) {
+    delete mux;
+    delete sink;
+    return false;
+  }
+
+  LiveOutput* live = new LiveOutput{cid, id, {}, {}};
+  ElementAdd(mux);
+  ElementAdd(sink);
+  gst_element_link(mux->GetGstElement(), sink->GetGstElement());
+  pad::Pad* sink_pad = sink->StaticPad("sink");
+  if (sink_pad->IsValid()) {
+    LinkOutputPad(sink_pad->GetGstPad(), id, uri, output.GetHlsType() == OutputUri::HLS_PUSH);
+  }
+  delete sink_pad;
+
+  std::vector<std::pair<elements::Element*, elements::Element*>> branches;  // tee and queue
+  if (video_tee) {
+    elements::Element* queue = new elements::ElementQueue(common::MemSPrintf(VIDEO_TEE_QUEUE_NAME_1U, id));
+    branches.push_back(std::make_pair(video_tee, queue));
+  }
+  if (audio_tee) {
+    elements::Element* queue = new elements::ElementQueue(common::MemSPrintf(AUDIO_TEE_QUEUE_NAME_1U, id));
+    branches.push_back(std::make_pair(audio_tee, queue));
+  }
+  for (const auto& branch : branches) {
+    ElementAdd(branch.second);
+    gst_element_link(branch.second->GetGstElement(), mux->GetGstElement());
+    live->elements.push_back(branch.second);
+  }
+  live->elements.push_back(mux);
+  live->elements.push_back(sink);
+  for (auto it = live->elements.rbegin(); it != live->elements.rend(); ++it) {  // sink ready before data comes
+    gst_element_sync_state_with_parent((*it)->GetGstElement());
+  }
+
+  bool linked = true;
+  for (const auto& branch : branches) {
+    GstPad* tee_pad = gst_element_get_request_pad(branch.first->GetGstElement(), "src_%u");
+    if (!tee_pad) {
+      linked = false;
+      continue;
+    }
+    live->tee_pads.push_back(std::make_pair(branch.first, tee_pad));
+    GstPad* queue_pad = gst_element_get_static_pad(branch.second->GetGstElement(), "sink");
+    linked &= GST_PAD_LINK_SUCCESSFUL(gst_pad_link(tee_pad, queue_pad));
+    gst_object_unref(queue_pad);
+  }
+
+  live_outputs_.push_back(live);
+  if (!linked) {
+    WARNING_LOG() << "Failed to attach output: " << uri.GetUrl();
+    ignore_result(DetachOutput(cid));
+    return false;
+  }
+
+  INFO_LOG() << "Output attached: " << uri.GetUrl();
+  return true;
+}
+
+bool SrcDecodeBinStream::DetachOutput(fastotv::channel_id_t cid) {
+  auto it = std::find_if(live_outputs_.begin(), live_outputs_.end(),
+                         [cid](const LiveOutput* live) { return live->cid == cid; });
+  if (it == live_outputs_.end()) {  // built with pipeline
+    return false;
+  }
+
+  LiveOutput* live = *it;
+  live_outputs_.erase(it);
+  for (const auto& tee_pad : live->tee_pads) {  // tee stops pushing into released pad
+    gst_element_release_request_pad(tee_pad.first->GetGstElement(), tee_pad.second);
+    gst_object_unref(tee_pad.second);
+  }
+  UnlinkOutputPads(live->id);
+  for (elements::Element* element : live->elements) {  // queues first, their threads stopped before muxer
+    ElementRemove(element);
+  }
+  INFO_LOG() << "Output detached, id: " << cid;
+  delete live;
+  return true;
+}
+
+void SrcDecodeBinStream::ClearLiveOutputs() {
+  for (LiveOutput* live : live_outputs_) {
+    for (const auto& tee_pad : live->tee_pads) {
+      gst_object_unref(tee_pad.second);
+    }
+    delete live;
+  }
+  live_outputs_.clear();
+}
+
+void SrcDecodeBinStream::decodebin_no_more_pads_callback(GstElement* src, gpointer user_data) {
+  SrcDecodeBinStream* stream = reinterpret_cast<SrcDecodeBinStream*>(user_data);
+  stream->HandleDecodeBinNoMorePads(src);
 }
 
 void SrcDecodeBinStream::decodebin_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data) {
   SrcDecodeBinStream* stream = reinterpret_cast<SrcDecodeBinStream*>(user_data);
+  {
+    std::unique_lock<std::mutex> lock(stream->autoplug_mutex_);
+    stream->autoplug_confirmed_ = true;
+  }
+  stream->LinkLatencyPad(new_pad, DECODE_LATENCY_STAGE);
   stream->HandleDecodeBinPadAdded(src, new_pad);
 }
 
@@ -79,7 +291,11 @@ GstAutoplugSelectResult SrcDecodeBinStream::decodebin_autoplug_select_callback(G
                                                                                GstElementFactory* factory,
                                                                                gpointer user_data) {
   SrcDecodeBinStream* stream = reinterpret_cast<SrcDecodeBinStream*>(user_data);
-  return stream->HandleAutoplugSelect(bin, pad, caps, factory);
+  GstAutoplugSelectResult res = stream->HandleAutoplugSelect(bin, pad, caps, factory);
+  if (res == GST_AUTOPLUG_SELECT_TRY) {
+    stream->RecordAutoplugSelect(pad, caps, factory);
+  }
+  return res;
 }
 
 GValueArray* SrcDecodeBinStream::decodebin_autoplug_sort_callback(GstElement* bin,
@@ -88,11 +304,24 @@ GValueArray* SrcDecodeBinStream::decodebin_autoplug_sort_callback(GstElement* bi
                                                                   GValueArray* factories,
                                                                   gpointer user_data) {
   SrcDecodeBinStream* stream = reinterpret_cast<SrcDecodeBinStream*>(user_data);
-  return stream->HandleAutoplugSort(bin, pad, caps, factories);
+  GValueArray* sorted = stream->HandleAutoplugSort(bin, pad, caps, factories);
+  if (sorted) {
+    return sorted;
+  }
+  sorted = stream->SortByHlsTuning(caps, factories);
+  if (sorted) {
+    return sorted;
+  }
+  sorted = stream->SortByHwDecode(factories);  // capacity now may differ from cached start
+  if (sorted) {
+    return sorted;
+  }
+  return stream->SortByAutoplugCache(caps, factories);
 }
 
 void SrcDecodeBinStream::decodebin_element_added_callback(GstBin* bin, GstElement* element, gpointer user_data) {
   SrcDecodeBinStream* stream = reinterpret_cast<SrcDecodeBinStream*>(user_data);
+  stream->ApplyHlsTuning(element);
   return stream->HandleDecodeBinElementAdded(bin, element);
 }
 
@@ -114,6 +343,474 @@ void SrcDecodeBinStream::OnOutputSinkPadCreated(pad::Pad* sink_pad,
 
 void SrcDecodeBinStream::OnDecodebinCreated(elements::ElementDecodebin* decodebin) {
   ConnectDecodebinSignals(decodebin);
+  ApplyAutoplugCache(decodebin);
+}
+
+void SrcDecodeBinStream::OnInputChainCreated(elements::Element* src, elements::ElementDecodebin* decodebin) {
+  pad::Pad* src_pad = src->StaticPad("src");
+  if (src_pad->IsValid()) {
+    AddSourceEosProbe(src_pad->GetGstPad());
+    input_src_ = src;
+    input_decodebin_ = decodebin;
+  }
+  delete src_pad;
+}
+
+void SrcDecodeBinStream::OnWarmStandbyCreated(const std::vector<elements::Element*>& parsebins,
+                                              elements::ElementInputSelector* video_selector,
+                                              elements::ElementInputSelector* audio_selector) {
+  std::unique_lock<std::mutex> lock(standby_mutex_);
+  parsebins_.clear();
+  for (elements::Element* parsebin : parsebins) {
+    gboolean pad_added = parsebin->RegisterPadAddedCallback(parsebin_pad_added_callback, this);
+    DCHECK(pad_added);
+    parsebins_.push_back(parsebin->GetGstElement());
+  }
+  video_selector_ = video_selector;
+  audio_selector_ = audio_selector;
+  video_selector_pads_.assign(parsebins.size(), nullptr);
+  audio_selector_pads_.assign(parsebins.size(), nullptr);
+  active_input_ = 0;
+  active_since_ts_ = common::time::current_utc_mstime();
+}
+
+bool SrcDecodeBinStream::IsWarmStandby() const {
+  return !parsebins_.empty();
+}
+
+bool SrcDecodeBinStream::IsTrackPreselected() const {
+  return IsWarmStandby();
+}
+
+elements::Element* SrcDecodeBinStream::FindAudioTrackDest(GstPad* new_pad) const {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const AudioVideoConfig::audio_tracks_t tracks = config->GetAudioTracks();
+  int track = 0;
+  if (tracks.empty() || !GetPadId(GST_PAD_NAME(new_pad), &track)) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    if (tracks[i] == track) {
+      return FindElement(UDB_AUDIO_ROLE, i + 1);
+    }
+  }
+  return nullptr;
+}
+
+void SrcDecodeBinStream::EndUnusedBranch(elements::Element* queue) {
+  pad::Pad* sink_pad = queue->StaticPad("sink");
+  if (sink_pad->IsValid() && !GST_PAD_IS_EOS(sink_pad->GetGstPad())) {  // already ended before soft restart
+    GstPad* pad = sink_pad->GetGstPad();
+    GstSegment segment;
+    gst_segment_init(&segment, GST_FORMAT_TIME);
+    gst_pad_send_event(pad, gst_event_new_stream_start(queue->GetName().c_str()));
+    gst_pad_send_event(pad, gst_event_new_segment(&segment));
+    gst_pad_send_event(pad, gst_event_new_eos());
+  }
+  delete sink_pad;
+}
+
+void SrcDecodeBinStream::HandleDecodeBinNoMorePads(GstElement* src) {
+  UNUSED(src);
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const AudioVideoConfig::audio_tracks_t tracks = config->GetAudioTracks();
+  for (size_t i = 0; i < tracks.size(); ++i) {
+    elements::Element* udb = FindElement(UDB_AUDIO_ROLE, i + 1);
+    if (!udb) {
+      continue;
+    }
+
+    pad::Pad* sink_pad = udb->StaticPad("sink");
+    const bool linked = sink_pad->IsValid() && gst_pad_is_linked(sink_pad->GetGstPad());
+    delete sink_pad;
+    if (!linked) {  // muxers would wait for it
+      WARNING_LOG() << "Audio track " << tracks[i] << " not found in input";
+      EndUnusedBranch(udb);
+    }
+  }
+}
+
+void SrcDecodeBinStream::parsebin_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data) {
+  SrcDecodeBinStream* stream = reinterpret_cast<SrcDecodeBinStream*>(user_data);
+  stream->HandleParsebinPadAdded(src, new_pad);
+}
+
+void SrcDecodeBinStream::HandleParsebinPadAdded(GstElement* src, GstPad* new_pad) {
+  const gchar* new_pad_type = pad_get_type(new_pad);
+  if (!new_pad_type) {
+    return;
+  }
+
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  std::unique_lock<std::mutex> lock(standby_mutex_);
+  const auto it = std::find(parsebins_.begin(), parsebins_.end(), src);
+  if (it == parsebins_.end()) {
+    return;
+  }
+
+  const size_t input_index = it - parsebins_.begin();
+  elements::ElementInputSelector* selector = nullptr;
+  GstPad** selector_pad = nullptr;
+  if (strncmp(new_pad_type, "video", 5) == 0) {
+    selector = video_selector_;
+    selector_pad = &video_selector_pads_[input_index];
+  } else if (strncmp(new_pad_type, "audio", 5) == 0) {
+    const auto audio_select = config->GetAudioSelect();
+    int current_audio_track = 0;
+    const char* gst_pad_name = GST_PAD_NAME(new_pad);
+    if (!audio_select || (GetPadId(gst_pad_name, &current_audio_track) && *audio_select == current_audio_track)) {
+      selector = audio_selector_;
+      selector_pad = &audio_selector_pads_[input_index];
+    }
+  }
+
+  if (!selector || *selector_pad) {
+    return;  // not needed or not first track of this type
+  }
+
+  GstElement* gselector = selector->GetGstElement();
+  GstPad* sink_pad = gst_element_get_request_pad(gselector, "sink_%u");
+  if (!sink_pad) {
+    return;
+  }
+
+  GstPadLinkReturn ret = gst_pad_link(new_pad, sink_pad);
+  if (GST_PAD_LINK_FAILED(ret)) {
+    WARNING_LOG() << "Failed to link standby input " << input_index << " " << new_pad_type;
+    gst_element_release_request_pad(gselector, sink_pad);
+    gst_object_unref(sink_pad);
+    return;
+  }
+
+  INFO_LOG() << "Input " << input_index << " track linked to selector: " << new_pad_type;
+  *selector_pad = sink_pad;
+  gst_object_unref(sink_pad);  // owned by selector while pipeline lives
+  if (input_index == active_input_) {
+    selector->SetActivePad(sink_pad);
+  }
+}
+
+gboolean SrcDecodeBinStream::HandleMainTimerTick() {
+  gboolean res = IBaseStream::HandleMainTimerTick();
+  if (IsWarmStandby()) {
+    CheckStandbyInputs();
+  }
+  return res;
+}
+
+void SrcDecodeBinStream::OnInputDataFailed() {
+  DropAutoplugCache();
+  if (SoftRestartInput()) {
+    return;
+  }
+
+  IBaseStream::OnInputDataFailed();
+}
+
+void SrcDecodeBinStream::OnInputDataOK() {
+  soft_restarts_ = 0;
+  SaveAutoplugCache();
+  IBaseStream::OnInputDataOK();
+}
+
+bool SrcDecodeBinStream::SoftRestartInput() {
+  const Config* config = GetConfig();
+  if (!input_src_ || !input_decodebin_ || soft_restarts_ >= config->GetMaxRestartAttempts()) {
+    return false;
+  }
+
+  soft_restarts_++;
+  WARNING_LOG() << "Rebuilding input source, attempt " << soft_restarts_ << "/" << config->GetMaxRestartAttempts();
+  const InputUri uri = config->GetInput()[0];
+  // removing of decodebin unlinks its pads from udb branches, they are linked again on pad-added
+  ElementRemove(input_decodebin_);
+  ElementRemove(input_src_);
+  SetVideoInited(false);
+  SetAudioInited(false);
+
+  elements::Element* src =
+      elements::sources::make_src(uri, 0, src_timeout_sec, config->GetUdpIngest(), config->GetInputSocket(uri.GetID()),
+                                  config->GetInputHttp(uri.GetID()));
+  elements::ElementDecodebin* decodebin = new elements::ElementDecodebin(common::MemSPrintf(DECODEBIN_NAME_1U, 0));
+  ElementAdd(src);
+  ElementAdd(decodebin);
+  RegisterElement(DECODEBIN_ROLE, 0, decodebin);
+  ConnectDecodebinSignals(decodebin);
+  if (!gst_element_link(src->GetGstElement(), decodebin->GetGstElement())) {
+    WARNING_LOG() << "Failed to link rebuilt input source.";
+    input_src_ = nullptr;
+    input_decodebin_ = nullptr;
+    return false;
+  }
+
+  pad::Pad* src_pad = src->StaticPad("src");
+  RelinkInputPad(src_pad->GetGstPad(), 0, uri.GetInput());
+  AddSourceEosProbe(src_pad->GetGstPad());
+  delete src_pad;
+
+  gst_element_sync_state_with_parent(decodebin->GetGstElement());
+  gst_element_sync_state_with_parent(src->GetGstElement());
+  input_src_ = src;
+  input_decodebin_ = decodebin;
+  ResetDataWait();
+  return true;
+}
+
+void SrcDecodeBinStream::ApplyAutoplugCache(elements::ElementDecodebin* decodebin) {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const auto cache_path = config->GetAutoplugCache();
+  const input_t input = config->GetInput();
+  if (!cache_path || input.size() != 1) {
+    return;
+  }
+
+  const std::string url = input[0].GetInput().GetUrl();
+  std::unique_lock<std::mutex> lock(autoplug_mutex_);
+  destroy(&autoplug_found_);
+  destroy(&autoplug_cache_);
+  autoplug_found_ = new AutoplugCache(url);
+  autoplug_confirmed_ = false;
+  autoplug_saved_ = false;
+
+  AutoplugCache* cache = new AutoplugCache(url);
+  if (!cache->Load(*cache_path)) {
+    delete cache;
+    return;
+  }
+
+  autoplug_cache_ = cache;
+  const std::string sink_caps = cache->GetSinkCaps();
+  GstCaps* caps = sink_caps.empty() ? nullptr : gst_caps_from_string(sink_caps.c_str());
+  if (!caps) {
+    INFO_LOG() << "Autoplug cache applied, sink caps typefound";
+    return;
+  }
+
+  decodebin->SetSinkCaps(caps);
+  gst_caps_unref(caps);
+  INFO_LOG() << "Autoplug cache applied, sink caps: " << sink_caps;
+}
+
+void SrcDecodeBinStream::RecordAutoplugSelect(GstPad* pad, GstCaps* caps, GstElementFactory* factory) {
+  std::string type_title;
+  std::string type_full;
+  if (!get_type_from_caps(caps, &type_title, &type_full)) {
+    return;
+  }
+
+  // caps found by typefind of decodebin are input caps, next start them forced
+  bool is_sink_caps = false;
+  GstElement* parent = gst_pad_get_parent_element(pad);
+  if (parent) {
+    is_sink_caps = elements::Element::GetPluginName(parent) == "typefind" && gst_caps_is_fixed(caps);
+    gst_object_unref(parent);
+  }
+
+  const gchar* factory_name = gst_plugin_feature_get_name(GST_PLUGIN_FEATURE(factory));
+  std::unique_lock<std::mutex> lock(autoplug_mutex_);
+  if (!autoplug_found_) {
+    return;
+  }
+
+  if (is_sink_caps) {
+    gchar* caps_str = gst_caps_to_string(caps);
+    autoplug_found_->SetSinkCaps(caps_str);
+    g_free(caps_str);
+  }
+  autoplug_found_->SetFactory(type_title, factory_name);  // last tried is the one that worked
+}
+
+GValueArray* SrcDecodeBinStream::SortByAutoplugCache(GstCaps* caps, GValueArray* factories) {
+  std::string type_title;
+  std::string type_full;
+  if (!factories || !get_type_from_caps(caps, &type_title, &type_full)) {
+    return nullptr;
+  }
+
+  std::string cached_factory;
+  {
+    std::unique_lock<std::mutex> lock(autoplug_mutex_);
+    if (!autoplug_cache_ || !autoplug_cache_->FindFactory(type_title, &cached_factory)) {
+      return nullptr;
+    }
+  }
+
+  return move_factory_first(factories, cached_factory);
+}
+
+GValueArray* SrcDecodeBinStream::SortByHwDecode(GValueArray* factories) {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const auto hw_decode = config->GetHwDecode();
+  if (!hw_decode) {
+    return nullptr;
+  }
+
+  return sort_hardware_decoders(factories, *hw_decode);
+}
+
+GValueArray* SrcDecodeBinStream::SortByHlsTuning(GstCaps* caps, GValueArray* factories) {
+  const input_t input = GetConfig()->GetInput();
+  if (!factories || !caps || gst_caps_is_empty(caps) || gst_caps_is_any(caps) || input.empty()) {
+    return nullptr;
+  }
+
+  const HttpTuning http = GetConfig()->GetInputHttp(input[0].GetID());
+  if (!http.hls_buffer_msec || !gst_structure_has_name(gst_caps_get_structure(caps, 0), "application/x-hls")) {
+    return nullptr;
+  }
+
+  // adaptivedemux2 fetches segments on own thread ahead of playback, hlsdemux one by one
+  return move_factory_first(factories, kHlsDemux2);
+}
+
+void SrcDecodeBinStream::ApplyHlsTuning(GstElement* element) {
+  const std::string plugin_name = elements::Element::GetPluginName(element);
+  const input_t input = GetConfig()->GetInput();
+  if ((plugin_name != HLS_DEMUX && plugin_name != kHlsDemux2) || input.empty()) {
+    return;
+  }
+
+  const HttpTuning http = GetConfig()->GetInputHttp(input[0].GetID());
+  if (http.IsEmpty()) {
+    return;
+  }
+
+  elements::sources::apply_hls_tuning(element, http, src_timeout_sec);
+}
+
+std::string SrcDecodeBinStream::GetCachedEncoderCaps(element_id_t encoder_id) {
+  std::string caps;
+  std::unique_lock<std::mutex> lock(autoplug_mutex_);
+  if (!autoplug_cache_ || !autoplug_cache_->FindEncoderCaps(encoder_id, &caps)) {
+    return std::string();
+  }
+  return caps;
+}
+
+void SrcDecodeBinStream::RecordEncoderCaps(element_id_t encoder_id, GstCaps* caps) {
+  if (!caps || !gst_caps_is_fixed(caps)) {
+    return;
+  }
+
+  gchar* caps_str = gst_caps_to_string(caps);
+  bool resave = false;
+  {
+    std::unique_lock<std::mutex> lock(autoplug_mutex_);
+    if (autoplug_found_) {
+      autoplug_found_->SetEncoderCaps(encoder_id, caps_str);
+      resave = autoplug_saved_;  // input confirmed before first frame got to encoder
+      autoplug_saved_ = false;
+    }
+  }
+  g_free(caps_str);
+  if (resave) {
+    SaveAutoplugCache();
+  }
+}
+
+void SrcDecodeBinStream::SaveAutoplugCache() {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const auto cache_path = config->GetAutoplugCache();
+  std::unique_lock<std::mutex> lock(autoplug_mutex_);
+  if (!cache_path || !autoplug_found_ || autoplug_saved_ || !autoplug_confirmed_ || autoplug_found_->IsEmpty()) {
+    return;
+  }
+
+  autoplug_saved_ = true;
+  if (autoplug_cache_ && *autoplug_cache_ == *autoplug_found_) {
+    return;
+  }
+
+  if (!autoplug_found_->Save(*cache_path)) {
+    WARNING_LOG() << "Failed to save autoplug cache: " << cache_path->GetPath();
+    return;
+  }
+  INFO_LOG() << "Autoplug cache saved: " << cache_path->GetPath();
+}
+
+void SrcDecodeBinStream::DropAutoplugCache() {
+  const AudioVideoConfig* config = static_cast<const AudioVideoConfig*>(GetConfig());
+  const auto cache_path = config->GetAutoplugCache();
+  std::unique_lock<std::mutex> lock(autoplug_mutex_);
+  if (!cache_path || !autoplug_cache_ || autoplug_confirmed_) {
+    return;
+  }
+
+  WARNING_LOG() << "Autoplug cache didn't match input, typefind on next start";
+  common::ErrnoError err = common::file_system::remove_file(cache_path->GetPath());
+  if (err) {
+    WARNING_LOG() << "Failed to remove autoplug cache: " << err->GetDescription();
+  }
+  destroy(&autoplug_cache_);
+}
+
+void SrcDecodeBinStream::AddSourceEosProbe(GstPad* pad) {
+  gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, source_eos_callback_probe, this, nullptr);
+}
+
+GstPadProbeReturn SrcDecodeBinStream::source_eos_callback_probe(GstPad* pad,
+                                                               GstPadProbeInfo* info,
+                                                               gpointer user_data) {
+  UNUSED(pad);
+  UNUSED(user_data);
+  GstEvent* event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_EOS) {
+    // eos of live source would finish encoders and sinks, source is rebuilt when no data detected
+    DEBUG_LOG() << "Source eos dropped, waiting for soft restart";
+    return GST_PAD_PROBE_DROP;
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+void SrcDecodeBinStream::CheckStandbyInputs() {
+  const StreamStruct* stats = GetStats();
+  const fastotv::timestamp_t now = common::time::current_utc_mstime();
+  const fastotv::timestamp_t switch_msec =
+      std::min<fastotv::timestamp_t>(standby_switch_msec, GetConfig()->GetNoDataPanicMsec());
+  std::vector<bool> have_data(parsebins_.size(), false);
+  for (size_t i = 0; i < have_data.size() && i < stats->input.size(); ++i) {
+    have_data[i] = now - stats->input[i].GetLastUpdateTime() < switch_msec;
+  }
+
+  if (have_data[active_input_] || now - active_since_ts_ < switch_msec) {
+    return;
+  }
+
+  for (size_t i = 1; i < have_data.size(); ++i) {
+    const size_t candidate = (active_input_ + i) % have_data.size();
+    if (have_data[candidate]) {
+      SwitchInput(candidate);
+      return;
+    }
+  }
+}
+
+void SrcDecodeBinStream::SwitchInput(size_t input_index) {
+  {
+    std::unique_lock<std::mutex> lock(standby_mutex_);
+    const fastotv::timestamp_t now = common::time::current_utc_mstime();
+    const StreamStruct* stats = GetStats();
+    fastotv::timestamp_t last_ts = active_since_ts_;
+    if (active_input_ < stats->input.size()) {
+      last_ts = std::max(last_ts, stats->input[active_input_].GetLastUpdateTime());
+    }
+    WARNING_LOG() << "No data from input " << active_input_ << " for " << now - last_ts
+                  << " msec, switching to standby input " << input_index;
+    if (video_selector_ && video_selector_pads_[input_index]) {
+      video_selector_->SetActivePad(video_selector_pads_[input_index]);
+    }
+    if (audio_selector_ && audio_selector_pads_[input_index]) {
+      audio_selector_->SetActivePad(audio_selector_pads_[input_index]);
+    }
+    active_input_ = input_index;
+    active_since_ts_ = now;
+  }
+
+  const input_t input = GetConfig()->GetInput();
+  if (client_ && input_index < input.size()) {
+    client_->OnInputChanged(this, input[input_index]);
+  }
 }
 
 }  // namespace streams
@@ -14,12 +14,18 @@
 
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 #include "stream/ibase_stream.h"
 
 #include "stream/elements/element.h"
 
 namespace fastocloud {
 namespace stream {
+
+class AutoplugCache;
+
 namespace streams {
 
 namespace builders {
@@ -30,7 +36,10 @@ class SrcDecodeBinStream : public IBaseStream {
   friend class builders::SrcDecodeStreamBuilder;
 
  public:
+  enum { standby_switch_msec = 2000 };  // active input without data this long is replaced by standby with data
+
   SrcDecodeBinStream(const Config* config, IStreamClient* client, StreamStruct* stats);
+  ~SrcDecodeBinStream() override;
 
   const char* ClassName() const override;
 
@@ -41,9 +50,29 @@ class SrcDecodeBinStream : public IBaseStream {
                               const common::uri::Url& url,
                               bool need_push) override;
   virtual void OnDecodebinCreated(elements::ElementDecodebin* decodebin);
+  virtual void OnInputChainCreated(elements::Element* src, elements::ElementDecodebin* decodebin);
+  virtual void OnWarmStandbyCreated(const std::vector<elements::Element*>& parsebins,
+                                    elements::ElementInputSelector* video_selector,
+                                    elements::ElementInputSelector* audio_selector);
+  bool IsWarmStandby() const;  // tracks came to decodebin through input-selector, already selected
+  virtual bool IsTrackPreselected() const;  // audio track chosen on parsebin, decodebin gets only it
+  // udb connection of config audio track for decodebin pad, nullptr if pad not listed or track not built
+  elements::Element* FindAudioTrackDest(GstPad* new_pad) const;
+  void EndUnusedBranch(elements::Element* queue);  // lets funnel or muxer after this branch reach eos
+  // raw caps reached video encoder, kept with autoplug cache for warm up of next start, empty if unknown
+  std::string GetCachedEncoderCaps(element_id_t encoder_id);
+  void RecordEncoderCaps(element_id_t encoder_id, GstCaps* caps);
+
+  gboolean HandleMainTimerTick() override;
+
+  void OnInputDataFailed() override;
+  void OnInputDataOK() override;
 
   IBaseBuilder* CreateBuilder() override = 0;
 
+  // added and removed outputs, other changes not applied
+  bool HandleLiveConfigUpdate(const LiveConfigUpdate& update) override;
+
   void PreLoop() override;
   void PostLoop(ExitStatus status) override;
 
@@ -60,8 +89,43 @@ class SrcDecodeBinStream : public IBaseStream {
   virtual void HandleDecodeBinElementAdded(GstBin* bin, GstElement* element) = 0;
   virtual void HandleDecodeBinElementRemoved(GstBin* bin, GstElement* element) = 0;
 
+  virtual void HandleParsebinPadAdded(GstElement* src, GstPad* new_pad);
+  virtual void HandleDecodeBinNoMorePads(GstElement* src);  // audio tracks absent in input ended
+
  private:
+  enum { live_output_first_id = 1000 };  // element ids of outputs attached to running pipeline, no statistic slots
+
+  // branch on main tees, queues, muxer and sink
+  struct LiveOutput {
+    fastotv::channel_id_t cid;
+    element_id_t id;
+    std::vector<std::pair<elements::Element*, GstPad*>> tee_pads;  // requested
+    elements_line_t elements;                                      // in link order from queues to sink
+  };
+
+  bool AttachOutput(const OutputUri& output);
+  bool DetachOutput(fastotv::channel_id_t cid);  // only attached to running pipeline
+  void ClearLiveOutputs();                    // refs of tee pads, elements owned by pipeline
+
+  void CheckStandbyInputs();
+  void SwitchInput(size_t input_index);
+  bool SoftRestartInput();  // new source and decodebin linked to the same branches
+  void AddSourceEosProbe(GstPad* pad);
+
+  void ApplyAutoplugCache(elements::ElementDecodebin* decodebin);
+  void RecordAutoplugSelect(GstPad* pad, GstCaps* caps, GstElementFactory* factory);
+  GValueArray* SortByAutoplugCache(GstCaps* caps, GValueArray* factories);
+  GValueArray* SortByHlsTuning(GstCaps* caps, GValueArray* factories);  // hlsdemux2 first if buffering ahead
+  GValueArray* SortByHwDecode(GValueArray* factories);  // decoders ranked by gpu decode capacity of node
+  void ApplyHlsTuning(GstElement* element);                              // http tuning of first input
+  void SaveAutoplugCache();
+  void DropAutoplugCache();  // cached chain didn't expose pads, typefind on next start
+
+  static GstPadProbeReturn source_eos_callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+
+  static void parsebin_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data);
   static void decodebin_pad_added_callback(GstElement* src, GstPad* new_pad, gpointer user_data);
+  static void decodebin_no_more_pads_callback(GstElement* src, gpointer user_data);
   static gboolean decodebin_autoplugger_callback(GstElement* elem, GstPad* pad, GstCaps* caps, gpointer user_data);
 
   static GstAutoplugSelectResult decodebin_autoplug_select_callback(GstElement* bin,
@@ -78,6 +142,25 @@ class SrcDecodeBinStream : public IBaseStream {
 
   static void decodebin_element_added_callback(GstBin* bin, GstElement* element, gpointer user_data);
   static void decodebin_element_removed_callback(GstBin* bin, GstElement* element, gpointer user_data);
+
+  std::vector<GstElement*> parsebins_;  // by input index, warm standby only
+  elements::ElementInputSelector* video_selector_;
+  elements::ElementInputSelector* audio_selector_;
+  std::vector<GstPad*> video_selector_pads_;  // selector sink by input index, nullptr until track parsed
+  std::vector<GstPad*> audio_selector_pads_;
+  size_t active_input_;
+  fastotv::timestamp_t active_since_ts_;  // utc msec, active input selected at
+  std::mutex standby_mutex_;  // pads linked from streaming threads
+  elements::Element* input_src_;  // soft restart only
+  elements::ElementDecodebin* input_decodebin_;
+  size_t soft_restarts_;  // in a row, without input data between
+  AutoplugCache* autoplug_cache_;  // loaded from feedback dir, applied to decodebin
+  AutoplugCache* autoplug_found_;  // decisions of this start
+  bool autoplug_confirmed_;        // decodebin exposed pads
+  bool autoplug_saved_;
+  std::mutex autoplug_mutex_;  // autoplug signals come from streaming threads
+  std::vector<LiveOutput*> live_outputs_;  // main loop only
+  element_id_t next_live_output_id_;
 };
 
 }  // namespace streams
@@ -21,10 +21,9 @@
 #include "utils/m3u8_reader.h"
 #include "utils/m3u8_writer.h"
 
+#include "stream/catchup_export.h"
 #include "stream/gst_macros.h"
 
-#define PLAYLIST_NAME "master.m3u8"
-
 #include "stream/streams/builders/timeshift/catchup_stream_builder.h"
 
 namespace fastocloud {
@@ -35,8 +34,12 @@ CatchupStream::CatchupStream(const TimeshiftConfig* config,
                              const TimeShiftInfo& info,
                              IStreamClient* client,
                              StreamStruct* stats)
-    : base_class(config, info, client, stats), chunks_() {
-  auto m3u8_path = info.timshift_dir.MakeFileStringPath(PLAYLIST_NAME);
+    : base_class(config, info, client, stats),
+      chunks_(),
+      playlist_(),
+      playlist_opened_(false),
+      pending_chunk_(false) {
+  auto m3u8_path = info.timshift_dir.MakeFileStringPath(CATCHUP_PLAYLIST_NAME);
   if (!m3u8_path) {
     return;
   }
@@ -60,53 +63,76 @@ IBaseBuilder* CatchupStream::CreateBuilder() {
   return new builders::CatchupStreamBuilder(tconf, this);
 }
 
-void CatchupStream::WriteM3u8List() {
+void CatchupStream::OpenM3u8List(chunk_index_t first_index) {
   TimeShiftInfo tinf = GetTimeshiftInfo();
-  auto m3u8_path = tinf.timshift_dir.MakeFileStringPath(PLAYLIST_NAME);
+  auto m3u8_path = tinf.timshift_dir.MakeFileStringPath(CATCHUP_PLAYLIST_NAME);
   if (!m3u8_path) {
     return;
   }
 
-  utils::M3u8Writer fl;
-  common::ErrnoError err =
-      fl.Open(*m3u8_path, common::file_system::File::FLAG_CREATE | common::file_system::File::FLAG_WRITE);
-  if (err) {
-    return;
-  }
-
   const TimeshiftConfig* tconf = static_cast<const TimeshiftConfig*>(GetConfig());
   time_t duration = tconf->GetTimeShiftChunkDuration();
-  chunk_index_t first_index = 0;
   if (!chunks_.empty()) {
     first_index = chunks_[0].index;
   }
-  err = fl.WriteHeader(first_index, duration);
-  if (err) {
-    WARNING_LOG() << "Failed to write m3u8 header to " << m3u8_path->GetPath() << ": " << err->GetDescription();
-    return;
-  }
-  GstClockTime total_time = 0;
   for (size_t i = 0; i < chunks_.size(); ++i) {
     if (!GST_CLOCK_TIME_IS_VALID(chunks_[i].duration)) {
       chunks_[i].duration = duration * GST_SECOND;
     }
-    total_time += chunks_[i].duration;
-    err = fl.WriteLine(chunks_[i]);
-    if (err) {
-      WARNING_LOG() << "Failed to write chunk info to " << m3u8_path->GetPath() << ": " << err->GetDescription();
+  }
+
+  common::ErrnoError err = playlist_.OpenForAppend(*m3u8_path, first_index, duration, chunks_);
+  if (err) {
+    WARNING_LOG() << "Failed to open m3u8 file " << m3u8_path->GetPath() << ": " << err->GetDescription();
+    return;
+  }
+
+  playlist_opened_ = true;
+  INFO_LOG() << "Catchup m3u8 file path: " << m3u8_path->GetPath() << " opened for appending";
+}
+
+void CatchupStream::AppendM3u8Chunk(utils::ChunkInfo* chunk) {
+  if (!GST_CLOCK_TIME_IS_VALID(chunk->duration)) {
+    const TimeshiftConfig* tconf = static_cast<const TimeshiftConfig*>(GetConfig());
+    chunk->duration = tconf->GetTimeShiftChunkDuration() * GST_SECOND;
+  }
+
+  if (!playlist_opened_) {
+    return;
+  }
+
+  common::ErrnoError err = playlist_.WriteLine(*chunk);
+  if (err) {
+    WARNING_LOG() << "Failed to append chunk info to m3u8: " << err->GetDescription();
+  }
+}
+
+void CatchupStream::CloseM3u8List() {
+  if (!playlist_opened_) {
+    chunk_index_t first_index = chunks_.empty() ? 0 : chunks_[0].index;
+    pending_chunk_ = false;  // all chunks written by open
+    OpenM3u8List(first_index);
+    if (!playlist_opened_) {
       return;
     }
   }
-  err = fl.WriteFooter();
+
+  if (pending_chunk_ && !chunks_.empty()) {
+    AppendM3u8Chunk(&chunks_.back());
+    pending_chunk_ = false;
+  }
+
+  common::ErrnoError err = playlist_.WriteFooter();
   if (err) {
-    WARNING_LOG() << "Failed to write m3u8 footer to " << m3u8_path->GetPath() << ": " << err->GetDescription();
-  } else {
-    INFO_LOG() << "Catchup m3u8 file path: " << m3u8_path->GetPath() << " have been written successfully";
+    WARNING_LOG() << "Failed to write m3u8 footer: " << err->GetDescription();
   }
+  ignore_result(playlist_.Close());
+  playlist_opened_ = false;
+  INFO_LOG() << "Catchup m3u8 file have been finished";
 }
 
 void CatchupStream::PostLoop(ExitStatus status) {
-  WriteM3u8List();
+  CloseM3u8List();
   base_class::PostLoop(status);
 }
 
@@ -128,7 +154,14 @@ gchararray CatchupStream::OnPathSet(GstElement* splitmux, guint fragment_id, Gst
     }
   }
 
+  if (!playlist_opened_) {
+    OpenM3u8List(ind);
+  } else if (pending_chunk_ && !chunks_.empty()) {
+    AppendM3u8Chunk(&chunks_.back());
+  }
+
   chunks_.push_back(chunk);
+  pending_chunk_ = true;
   return base_class::OnPathSet(splitmux, fragment_id, sample);
 }
 
@@ -18,6 +18,8 @@
 
 #include "stream/streams/timeshift/timeshift_recorder_stream.h"
 
+#include "utils/m3u8_writer.h"
+
 namespace fastocloud {
 namespace stream {
 namespace streams {
@@ -37,8 +39,14 @@ class CatchupStream : public TimeShiftRecorderStream {
   gchararray OnPathSet(GstElement* splitmux, guint fragment_id, GstSample* sample) override;
 
  private:
-  void WriteM3u8List();
+  void OpenM3u8List(chunk_index_t first_index);
+  void AppendM3u8Chunk(utils::ChunkInfo* chunk);
+  void CloseM3u8List();
+
   std::vector<utils::ChunkInfo> chunks_;
+  utils::M3u8Writer playlist_;
+  bool playlist_opened_;
+  bool pending_chunk_;  // last chunk not yet in playlist, duration unknown until next one started
 };
 
 }  // namespace streams
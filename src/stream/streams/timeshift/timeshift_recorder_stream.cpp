@@ -14,6 +14,8 @@
 
 #include "stream/streams/timeshift/timeshift_recorder_stream.h"
 
+#include <sys/stat.h>
+
 #include <string>
 
 #include <common/file_system/string_path_utils.h>
@@ -22,6 +24,8 @@
 #include "base/constants.h"
 #include "base/utils.h"
 
+#include "stream/chunk_mover.h"
+#include "stream/elements/sink/chunk.h"
 #include "stream/elements/sink/sink.h"
 #include "stream/pad/pad.h"
 #include "stream/streams/builders/timeshift/timeshift_recorder_stream_builder.h"
@@ -54,14 +58,32 @@ TimeShiftRecorderStream::TimeShiftRecorderStream(const TimeshiftConfig* config,
                                                  const TimeShiftInfo& info,
                                                  IStreamClient* client,
                                                  StreamStruct* stats)
-    : base_class(config, info, client, stats), chunk_(), audio_pad_(nullptr), video_pad_(nullptr) {}
+    : base_class(config, info, client, stats),
+      chunk_(),
+      audio_pad_(nullptr),
+      video_pad_(nullptr),
+      chunk_start_msec_(0),
+      pts_base_(GST_CLOCK_TIME_NONE),
+      pts_base_msec_(0),
+      chunk_hour_file_(),
+      chunk_offset_(0),
+      cleanup_tick_(0),
+      mover_(nullptr),
+      index_mutex_() {
+  const std::string cold_dir = config->GetTimeShiftColdDir();
+  if (!cold_dir.empty()) {
+    const uint64_t rate = static_cast<uint64_t>(config->GetTimeShiftMoveRate()) * 1024 * 1024;
+    mover_ = new ChunkMover(info.timshift_dir.GetPath(), cold_dir, config->GetTimeShiftHotTime(), rate);
+    mover_->Start();
+  }
+}
 
 const char* TimeShiftRecorderStream::ClassName() const {
   return "TimeShiftRecorderStream";
 }
 
 TimeShiftRecorderStream::~TimeShiftRecorderStream() {
-  elements::Element* splitmuxsink = GetElementByName(common::MemSPrintf(SPLIT_SINK_NAME_1U, 0));
+  elements::Element* splitmuxsink = GetElement(SPLIT_SINK_ROLE, 0);
   if (audio_pad_) {
     splitmuxsink->ReleaseRequestedPad(audio_pad_);
   }
@@ -70,13 +92,17 @@ TimeShiftRecorderStream::~TimeShiftRecorderStream() {
   }
   destroy(&audio_pad_);
   destroy(&video_pad_);
+  destroy(&mover_);
 }
 
 void TimeShiftRecorderStream::OnSplitmuxsinkCreated(Connector conn, elements::sink::ElementSplitMuxSink* sink) {
   TimeShiftInfo tinfo = GetTimeshiftInfo();
+  const TimeshiftConfig* tconf = static_cast<const TimeshiftConfig*>(GetConfig());
   chunk_index_t index = invalid_chunk_index;
   time_t file_created_time = 0;
-  if (tinfo.FindLastChunk(&index, &file_created_time)) {
+  const bool found = tconf->GetTimeShiftHourFiles() ? tinfo.FindLastRange(&index, &file_created_time)
+                                                    : tinfo.FindLastChunk(&index, &file_created_time);
+  if (found) {
     index = GetNextChunkStrategy(index, file_created_time);
   }
   chunk_ = {tinfo.timshift_dir.GetPath(), index, GST_CLOCK_TIME_NONE};
@@ -115,13 +141,65 @@ void TimeShiftRecorderStream::HandleDecodeBinElementAdded(GstBin* bin, GstElemen
 gboolean TimeShiftRecorderStream::HandleMainTimerTick() {
   TimeShiftInfo tinfo = GetTimeshiftInfo();
   time_t el = GetElipsedTime();
-  if (el % no_data_panic_sec == 0) {
+  if (el % no_data_panic_sec == 0 && el != cleanup_tick_) {
+    cleanup_tick_ = el;
     const time_t max_life_time = common::time::current_utc_mstime() / 1000 - tinfo.timeshift_chunk_life_time;
-    RemoveOldFilesByTime(tinfo.timshift_dir, max_life_time, "*" CHUNK_EXT);
+    RemoveOldFilesByTime(tinfo.timshift_dir, max_life_time, "*" CHUNK_EXT);  // links of moved and hour files too
+    const TimeshiftConfig* tconf = static_cast<const TimeshiftConfig*>(GetConfig());
+    const std::string cold_dir = tconf->GetTimeShiftColdDir();
+    if (!cold_dir.empty()) {
+      RemoveOldFilesByTime(common::file_system::ascii_directory_string_path(cold_dir), max_life_time, "*" CHUNK_EXT);
+    }
+    std::unique_lock<std::mutex> lock(index_mutex_);
+    if (!tinfo.CompactChunks(max_life_time)) {
+      WARNING_LOG() << "Failed to compact chunks index in " << tinfo.timshift_dir.GetPath();
+    }
+    if (tconf->GetTimeShiftHourFiles() && !tinfo.CompactRanges(max_life_time)) {
+      WARNING_LOG() << "Failed to compact ranges index in " << tinfo.timshift_dir.GetPath();
+    }
   }
   return base_class::HandleMainTimerTick();
 }
 
+void TimeShiftRecorderStream::PostLoop(ExitStatus status) {
+  IndexCurrentChunk(common::time::current_utc_mstime());
+  base_class::PostLoop(status);
+}
+
+void TimeShiftRecorderStream::IndexCurrentChunk(fastotv::timestamp_t end_msec) {
+  if (chunk_start_msec_ == 0 || chunk_.index == invalid_chunk_index) {
+    return;
+  }
+
+  TimeShiftInfo tinfo = GetTimeshiftInfo();
+  if (!chunk_hour_file_.empty()) {
+    const std::string path = chunk_.path + chunk_hour_file_;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && static_cast<uint64_t>(st.st_size) > chunk_offset_) {
+      const ChunkRangeEntry entry = {chunk_.index, chunk_start_msec_, end_msec - chunk_start_msec_,
+                                     static_cast<uint64_t>(st.st_size) - chunk_offset_, chunk_offset_};
+      std::unique_lock<std::mutex> lock(index_mutex_);
+      if (!tinfo.AppendRange(entry)) {
+        WARNING_LOG() << "Failed to append chunk " << chunk_.index << " into ranges index";
+      }
+    }
+    chunk_start_msec_ = 0;
+    return;
+  }
+
+  const std::string path = common::MemSPrintf("%s%llu." TS_EXTENSION, chunk_.path, chunk_.index);
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0) {
+    const ChunkIndexEntry entry = {chunk_.index, chunk_start_msec_, end_msec - chunk_start_msec_,
+                                   static_cast<uint64_t>(st.st_size)};
+    std::unique_lock<std::mutex> lock(index_mutex_);
+    if (!tinfo.AppendChunk(entry)) {
+      WARNING_LOG() << "Failed to append chunk " << chunk_.index << " into index";
+    }
+  }
+  chunk_start_msec_ = 0;
+}
+
 void TimeShiftRecorderStream::OnOutputDataFailed() {
   OnOutputDataOK();
 }
@@ -140,14 +218,57 @@ chunk_index_t TimeShiftRecorderStream::CalcNextIndex() const {
   return index;
 }
 
+fastotv::timestamp_t TimeShiftRecorderStream::CalcChunkStartMsec(GstSample* sample) {
+  const fastotv::timestamp_t now = common::time::current_utc_mstime();
+  GstClockTime pts = GST_CLOCK_TIME_NONE;
+  if (sample) {
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    if (buffer) {
+      pts = GST_BUFFER_DTS_OR_PTS(buffer);
+    }
+  }
+
+  if (!GST_CLOCK_TIME_IS_VALID(pts)) {
+    pts_base_ = GST_CLOCK_TIME_NONE;
+    return now;
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID(pts_base_) && pts >= pts_base_) {
+    const fastotv::timestamp_t start_msec = pts_base_msec_ + GST_TIME_AS_MSECONDS(pts - pts_base_);
+    const TimeshiftConfig* tconf = static_cast<const TimeshiftConfig*>(GetConfig());
+    const fastotv::timestamp_t max_drift_msec = tconf->GetTimeShiftChunkDuration() * 1000;
+    if (start_msec > now - max_drift_msec && start_msec < now + max_drift_msec) {
+      return start_msec;
+    }
+    WARNING_LOG() << "Chunk pts drifted from wall clock by " << start_msec - now << " msec, rebase";
+  }
+
+  pts_base_ = pts;  // source restarted or timestamps reset
+  pts_base_msec_ = now;
+  return now;
+}
+
 gchararray TimeShiftRecorderStream::OnPathSet(GstElement* splitmux, guint fragment_id, GstSample* sample) {
-  UNUSED(splitmux);
   UNUSED(fragment_id);
-  UNUSED(sample);
+
+  const fastotv::timestamp_t start_msec = CalcChunkStartMsec(sample);
+  IndexCurrentChunk(start_msec);  // previous chunk closed
+  chunk_start_msec_ = start_msec;
+  const TimeshiftConfig* tconf = static_cast<const TimeshiftConfig*>(GetConfig());
+  if (tconf->GetTimeShiftHourFiles()) {
+    chunk_.index = chunk_.index == invalid_chunk_index ? 0 : chunk_.index + 1;  // no file of chunk to check
+    chunk_hour_file_ = MakeChunkHourFileName(start_msec / 1000);
+    const std::string hour_path = chunk_.path + chunk_hour_file_;
+    struct stat st;
+    chunk_offset_ = stat(hour_path.c_str(), &st) == 0 ? st.st_size : 0;
+    elements::sink::set_chunk_sink_location(splitmux, hour_path, true);
+    return strdup(hour_path.c_str());
+  }
 
   chunk_index_t ind = CalcNextIndex();
   chunk_.index = ind;
   std::string new_path = common::MemSPrintf("%s%llu." TS_EXTENSION, chunk_.path, chunk_.index);
+  elements::sink::set_chunk_sink_location(splitmux, new_path);  // appsink has no location property
   return strdup(new_path.c_str());
 }
 
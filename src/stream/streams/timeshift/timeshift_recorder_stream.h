@@ -14,12 +14,16 @@
 
 #pragma once
 
+#include <mutex>
+#include <string>
+
 #include "stream/streams/timeshift/itimeshift_recorder_stream.h"
 
 #include "utils/chunk_info.h"
 
 namespace fastocloud {
 namespace stream {
+class ChunkMover;
 namespace elements {
 namespace sink {
 class ElementSplitMuxSink;
@@ -52,6 +56,7 @@ class TimeShiftRecorderStream : public ITimeShiftRecorderStream {
   void HandleDecodeBinElementAdded(GstBin* bin, GstElement* element) override;
 
   gboolean HandleMainTimerTick() override;
+  void PostLoop(ExitStatus status) override;
   void OnOutputDataFailed() override;
   virtual gchararray OnPathSet(GstElement* splitmux, guint fragment_id, GstSample* sample);
 
@@ -59,6 +64,9 @@ class TimeShiftRecorderStream : public ITimeShiftRecorderStream {
   utils::ChunkInfo chunk_;
 
  private:
+  void IndexCurrentChunk(fastotv::timestamp_t end_msec);
+  fastotv::timestamp_t CalcChunkStartMsec(GstSample* sample);  // utc of first buffer of fragment
+
   static gchararray path_setter_callback(GstElement* splitmux, guint fragment_id, gpointer user_data);
   static gchararray path_setter_full_callback(GstElement* splitmux,
                                               guint fragment_id,
@@ -67,6 +75,15 @@ class TimeShiftRecorderStream : public ITimeShiftRecorderStream {
 
   pad::Pad* audio_pad_;
   pad::Pad* video_pad_;
+  fastotv::timestamp_t chunk_start_msec_;
+  GstClockTime pts_base_;  // pts mapped to utc of pts_base_msec_, from first fragment after start or jump
+  fastotv::timestamp_t pts_base_msec_;
+  std::string chunk_hour_file_;  // empty if chunk is own file
+  uint64_t chunk_offset_;        // in hour file
+  time_t cleanup_tick_;  // elapsed sec of last chunks cleanup, timer can tick several times per second
+  ChunkMover* mover_;    // nullptr if chunks kept in timeshift dir
+  // index files appended on splitmuxsink thread, compacted on main loop
+  std::mutex index_mutex_;
 };
 
 }  // namespace streams
@@ -14,20 +14,256 @@
 
 #include "stream/streams/vod/vod_encoding_stream.h"
 
+#include <stdio.h>
+#if defined(OS_LINUX)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include <common/logger.h>
+
 #include "base/utils.h"
 
+#include "stream/streams/builders/encoding/vod_encoding_stream_builder.h"
+#include "stream/streams/vod/vod_parts.h"
+
+#define VOD_PREROLL_TIMEOUT (10 * GST_SECOND)
+#define VOD_PART_MAX_NICE 10
+
 namespace fastocloud {
 namespace stream {
 namespace streams {
 
+namespace {
+
+// worker of part has no controller, finished on eos
+class PartClient : public IBaseStream::IStreamClient {
+ public:
+  void OnStatusChanged(IBaseStream* stream, StreamStatus status) override {
+    UNUSED(stream);
+    UNUSED(status);
+  }
+  void OnPipelineEOS(IBaseStream* stream) override { stream->Quit(EXIT_SELF); }
+  void OnTimeoutUpdated(IBaseStream* stream) override { UNUSED(stream); }
+  void OnStatisticUpdated(IBaseStream* stream) override { UNUSED(stream); }
+  void OnInputProbeEvent(IBaseStream* stream, InputProbe* probe, GstEvent* event) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    UNUSED(event);
+  }
+  void OnOutputProbeEvent(IBaseStream* stream, OutputProbe* probe, GstEvent* event) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    UNUSED(event);
+  }
+  void OnSyncMessageReceived(IBaseStream* stream, GstMessage* message) override {
+    UNUSED(stream);
+    UNUSED(message);
+  }
+  void OnASyncMessageReceived(IBaseStream* stream, GstMessage* message) override {
+    UNUSED(stream);
+    UNUSED(message);
+  }
+  GstPadProbeInfo* OnCheckReveivedOutputData(IBaseStream* stream,
+                                             OutputProbe* probe,
+                                             GstPadProbeInfo* info) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    return info;
+  }
+  GstPadProbeInfo* OnCheckReveivedData(IBaseStream* stream, InputProbe* probe, GstPadProbeInfo* info) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    return info;
+  }
+  void OnInputChanged(IBaseStream* stream, const InputUri& uri) override {
+    UNUSED(stream);
+    UNUSED(uri);
+  }
+  void OnPipelineCreated(IBaseStream* stream) override { UNUSED(stream); }
+#if defined(MACHINE_LEARNING)
+  void OnMlNotification(IBaseStream* stream, const std::vector<fastotv::commands_info::ml::ImageBox>& images) override {
+    UNUSED(stream);
+    UNUSED(images);
+  }
+#endif
+};
+
+std::string read_file(const std::string& path) {
+  std::ifstream in(path);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+bool write_file(const std::string& path, const std::string& data) {
+  // players never see half written playlist
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::trunc);
+    out << data;
+    if (!out) {
+      return false;
+    }
+  }
+  return rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+}  // namespace
+
 VodEncodeStream::VodEncodeStream(const VodEncodeConfig* config, IStreamClient* client, StreamStruct* stats)
-    : base_class(config, client, stats) {}
+    : VodEncodeStream(config, client, stats, nullptr) {}
+
+VodEncodeStream::VodEncodeStream(const VodEncodeConfig* config,
+                                 IStreamClient* client,
+                                 StreamStruct* stats,
+                                 const VodEncodeStream* parent)
+    : base_class(config, client, stats), parent_(parent), parts_(), workers_(), workers_stopped_(false) {}
 
 const char* VodEncodeStream::ClassName() const {
   return "VodEncodeStream";
 }
 
+IBaseBuilder* VodEncodeStream::CreateBuilder() {
+  const VodEncodeConfig* vconfig = static_cast<const VodEncodeConfig*>(GetConfig());
+  return new builders::VodEncodeStreamBuilder(vconfig, this);
+}
+
+void VodEncodeStream::StartPipeline() {
+  const VodEncodeConfig* vconfig = static_cast<const VodEncodeConfig*>(GetConfig());
+  if (!vconfig->IsParallel()) {
+    base_class::StartPipeline();
+    return;
+  }
+
+  const auto part = vconfig->GetPart();
+  if (part) {
+    if (part->IsRange() &&
+        (!PrerollPipeline(VOD_PREROLL_TIMEOUT) || !SeekRange(part->start_msec, part->stop_msec))) {
+      WARNING_LOG() << "Can't seek to vod part: " << part->index;
+      Quit(EXIT_INNER);
+    }
+    Play();
+    return;
+  }
+
+  // duration known only after preroll, first part encoded by this stream
+  fastotv::timestamp_t duration_msec = 0;
+  if (!PrerollPipeline(VOD_PREROLL_TIMEOUT) || !QueryDuration(&duration_msec)) {
+    WARNING_LOG() << "Unknown vod duration, encoded in one part";
+  }
+  parts_ = split_vod_parts(duration_msec, vconfig->GetWorkers(), TS_DURATION * 1000);
+  if (parts_.size() > 1 && !SeekRange(0, parts_[0].stop_msec)) {
+    WARNING_LOG() << "Can't seek vod, encoded in one part";
+    parts_ = {VodPart()};
+  }
+  StartWorkers();
+  Play();
+}
+
+void VodEncodeStream::PostLoop(ExitStatus status) {
+  base_class::PostLoop(status);
+  if (status != EXIT_SELF) {
+    workers_stopped_ = true;
+  }
+}
+
+gboolean VodEncodeStream::HandleMainTimerTick() {
+  if (parent_ && parent_->workers_stopped_) {
+    Quit(EXIT_INNER);
+  } else if (!parts_.empty()) {
+    WriteServedPlaylists();
+  }
+  return base_class::HandleMainTimerTick();
+}
+
+void VodEncodeStream::StartWorkers() {
+  const VodEncodeConfig* vconfig = static_cast<const VodEncodeConfig*>(GetConfig());
+  for (size_t i = 1; i < parts_.size(); ++i) {
+    VodEncodeConfig* part_config = vconfig->Clone();
+    part_config->SetPart(parts_[i]);
+    workers_.push_back(std::thread(&VodEncodeStream::RunWorker, this, part_config, *GetStats()));
+  }
+  if (!workers_.empty()) {
+    INFO_LOG() << "Vod split into " << parts_.size() << " parts of " << parts_[0].stop_msec << " msec";
+  }
+}
+
+void VodEncodeStream::RunWorker(VodEncodeConfig* config, StreamStruct stats) {
+  const std::unique_ptr<VodEncodeConfig> part_config(config);
+  const VodPart part = *part_config->GetPart();
+#if defined(OS_LINUX)
+  // later parts yield cpu to earlier ones, served playlist grows from start, pipeline threads inherit nice
+  setpriority(PRIO_PROCESS, syscall(SYS_gettid), std::min<int>(part.index, VOD_PART_MAX_NICE));
+#endif
+  PartClient client;
+  GMainContext* ctx = g_main_context_new();
+  g_main_context_push_thread_default(ctx);
+  ExitStatus status = EXIT_INNER;
+  {
+    VodEncodeStream stream(part_config.get(), &client, &stats, this);
+    status = stream.Exec();
+  }
+  g_main_context_pop_thread_default(ctx);
+  g_main_context_unref(ctx);
+  INFO_LOG() << "Vod part " << part.index << (status == EXIT_SELF ? " encoded" : " failed");
+}
+
+void VodEncodeStream::JoinWorkers() {
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void VodEncodeStream::WriteServedPlaylists() const {
+  for (const OutputUri& output : GetConfig()->GetOutput()) {
+    common::uri::Url uri = output.GetOutput();
+    if (uri.GetScheme() != common::uri::Url::http) {
+      continue;
+    }
+
+    const std::string http_root = output.GetHttpRoot().GetPath();
+    const std::string filename = uri.GetPath().GetFileName();
+    std::vector<std::string> playlists;
+    for (const VodPart& part : parts_) {
+      playlists.push_back(read_file(http_root + part.GetPrefix() + filename));
+    }
+    std::string merged;
+    merge_vod_playlists(playlists, &merged);
+    if (!write_file(http_root + filename, merged)) {
+      WARNING_LOG() << "Can't write vod playlist: " << http_root + filename;
+    }
+  }
+}
+
+void VodEncodeStream::PreExecCleanup(time_t old_life_time) {
+  if (parent_) {  // segments of other parts already written
+    return;
+  }
+  base_class::PreExecCleanup(old_life_time);
+}
+
 void VodEncodeStream::PostExecCleanup() {
+  if (parent_) {
+    return;
+  }
+
+  if (!workers_.empty()) {
+    INFO_LOG() << "Waiting vod parts: " << workers_.size();
+  }
+  JoinWorkers();
+  if (!parts_.empty()) {
+    WriteServedPlaylists();
+    parts_.clear();
+  }
+  workers_stopped_ = false;
+
   const VodEncodeConfig* vconfig = static_cast<const VodEncodeConfig*>(GetConfig());
   if (vconfig->GetCleanupTS()) {
     for (const OutputUri& output : vconfig->GetOutput()) {
@@ -14,12 +14,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "stream/streams/encoding/encoding_stream.h"
 
 namespace fastocloud {
 namespace stream {
 namespace streams {
 
+// parallel encode: stream of first part splits file, starts workers of other parts and serves merged playlist
 class VodEncodeStream : public EncodingStream {
  public:
   typedef EncodingStream base_class;
@@ -28,7 +33,30 @@ class VodEncodeStream : public EncodingStream {
   const char* ClassName() const override;
 
  protected:
+  IBaseBuilder* CreateBuilder() override;
+
+  void StartPipeline() override;
+  void PostLoop(ExitStatus status) override;
+  gboolean HandleMainTimerTick() override;
+
+  void PreExecCleanup(time_t old_life_time) override;
   void PostExecCleanup() override;
+
+ private:
+  VodEncodeStream(const VodEncodeConfig* config,
+                  IStreamClient* client,
+                  StreamStruct* stats,
+                  const VodEncodeStream* parent);
+
+  void StartWorkers();  // parts except first
+  void RunWorker(VodEncodeConfig* config, StreamStruct stats);
+  void JoinWorkers();
+  void WriteServedPlaylists() const;
+
+  const VodEncodeStream* const parent_;  // of worker
+  std::vector<VodPart> parts_;
+  std::vector<std::thread> workers_;
+  std::atomic<bool> workers_stopped_;
 };
 
 }  // namespace streams
@@ -0,0 +1,115 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/streams/vod/vod_parts.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <common/sprintf.h>
+
+#define VOD_PART_MIN_SEGMENTS 3
+
+#define M3U8_TARGET_DURATION "#EXT-X-TARGETDURATION:"
+#define M3U8_CHUNK_HEADER "#EXTINF:"
+#define M3U8_DISCONTINUITY "#EXT-X-DISCONTINUITY"
+#define M3U8_FOOTER "#EXT-X-ENDLIST"
+
+namespace fastocloud {
+namespace stream {
+namespace streams {
+
+namespace {
+bool starts_with(const std::string& line, const char* prefix) {
+  return line.compare(0, strlen(prefix), prefix) == 0;
+}
+}  // namespace
+
+std::vector<VodPart> split_vod_parts(fastotv::timestamp_t duration_msec,
+                                     size_t workers,
+                                     fastotv::timestamp_t segment_msec) {
+  std::vector<VodPart> parts;
+  if (!duration_msec || !segment_msec || workers <= 1) {
+    parts.push_back(VodPart());
+    return parts;
+  }
+
+  // short files not split, part should outlive pipeline startup
+  const fastotv::timestamp_t segments = (duration_msec + segment_msec - 1) / segment_msec;
+  const size_t count = std::max<size_t>(1, std::min<size_t>(workers, segments / VOD_PART_MIN_SEGMENTS));
+  const fastotv::timestamp_t part_msec = (segments + count - 1) / count * segment_msec;
+  for (size_t i = 0; i < count; ++i) {
+    const fastotv::timestamp_t start = i * part_msec;
+    fastotv::timestamp_t stop = start + part_msec;
+    if (i + 1 == count || stop >= duration_msec) {
+      stop = 0;
+    }
+    parts.push_back(VodPart(i, start, stop));
+    if (!stop) {
+      break;
+    }
+  }
+  return parts;
+}
+
+bool merge_vod_playlists(const std::vector<std::string>& playlists, std::string* merged) {
+  if (!merged) {
+    return false;
+  }
+
+  int target_duration = TS_DURATION;
+  bool ended = !playlists.empty();
+  std::string chunks;
+  for (size_t i = 0; i < playlists.size() && ended; ++i) {
+    std::istringstream in(playlists[i]);
+    std::string line;
+    bool part_ended = false;
+    bool first_chunk = true;
+    while (std::getline(in, line)) {
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+
+      if (starts_with(line, M3U8_TARGET_DURATION)) {
+        target_duration = std::max(target_duration, atoi(line.c_str() + strlen(M3U8_TARGET_DURATION)));
+      } else if (line == M3U8_FOOTER) {
+        part_ended = true;
+      } else if (starts_with(line, M3U8_CHUNK_HEADER)) {
+        if (first_chunk && i) {  // timestamps of every part start from zero
+          chunks += M3U8_DISCONTINUITY "\n";
+        }
+        first_chunk = false;
+        chunks += line + "\n";
+      } else if (!line.empty() && line[0] != '#') {
+        chunks += line + "\n";
+      }
+    }
+    ended = part_ended;
+  }
+
+  *merged = common::MemSPrintf("#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-MEDIA-SEQUENCE:0\n#EXT-X-TARGETDURATION:%d\n\n",
+                               target_duration) +
+            chunks;
+  if (ended) {
+    *merged += M3U8_FOOTER "\n";
+  }
+  return ended;
+}
+
+}  // namespace streams
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,36 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "stream/stypes.h"
+
+namespace fastocloud {
+namespace stream {
+namespace streams {
+
+// parts of vod for parallel encode, each starts on segment boundary so first keyframe of part opens segment
+std::vector<VodPart> split_vod_parts(fastotv::timestamp_t duration_msec,
+                                     size_t workers,
+                                     fastotv::timestamp_t segment_msec);
+
+// served playlist from playlists of parts in order, parts after first incomplete not listed, true if all ended
+bool merge_vod_playlists(const std::vector<std::string>& playlists, std::string* merged);
+
+}  // namespace streams
+}  // namespace stream
+}  // namespace fastocloud
@@ -24,6 +24,7 @@
 #include "stream/streams/encoding/encoding_only_audio_stream.h"
 #include "stream/streams/encoding/encoding_only_video_stream.h"
 #include "stream/streams/encoding/playlist_encoding_stream.h"
+#include "stream/streams/encoding/radio_stream.h"
 #include "stream/streams/encoding/rtsp_encoding_stream.h"
 #include "stream/streams/mosaic_stream.h"
 #include "stream/streams/relay/playlist_relay_stream.h"
@@ -62,6 +63,10 @@ IBaseStream* StreamsFactory::CreateStream(const Config* config,
         return new streams::PlaylistRelayStream(prconfig, client, stats);
       }
 
+      if (rconfig->GetWarmStandby() || rconfig->GetHitlessMerge()) {
+        return new streams::RelayStream(rconfig, client, stats);
+      }
+
       NOTREACHED();
       return nullptr;  // not supported
       // return new streams::MosaicStream(rconfig, client, stats);
@@ -85,13 +90,16 @@ IBaseStream* StreamsFactory::CreateStream(const Config* config,
         return new streams::PlaylistEncodingStream(econfig, client, stats);
       }
 
-      return new streams::MosaicStream(econfig, client, stats);
+      if (!econfig->GetWarmStandby() && !econfig->GetHitlessMerge()) {
+        return new streams::MosaicStream(econfig, client, stats);
+      }
+      // primary and standby inputs, input-selector in front of decodebin, or paths merged by funnel
     }
 
     InputUri iuri = input[0];
-    if (IsTestInputUrl(iuri)) {
+    if (IsTestInputUrl(iuri) || IsLoadInputUrl(iuri)) {
       return new streams::TestInputStream(econfig, client, stats);
-    } else if (IsDisplayInputUrl(iuri)) {
+    } else if (IsDisplayInputUrl(iuri) || IsPipeWireInputUrl(iuri)) {
       return new streams::DisplayInputStream(econfig, client, stats);
     }
 
@@ -101,7 +109,9 @@ IBaseStream* StreamsFactory::CreateStream(const Config* config,
       return new streams::RtspEncodingStream(econfig, client, stats);
     }
 
-    if (econfig->GetRelayVideo()) {
+    if (!econfig->HaveVideo() && econfig->HaveAudio() && !econfig->GetRelayAudio()) {
+      return new streams::RadioStream(econfig, client, stats);
+    } else if (econfig->GetRelayVideo()) {
       return new streams::EncodingOnlyAudioStream(econfig, client, stats);
     } else if (econfig->GetRelayAudio()) {
       return new streams::EncodingOnlyVideoStream(econfig, client, stats);
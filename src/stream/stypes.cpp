@@ -19,6 +19,8 @@
 #include <common/convert2string.h>
 #include <common/sprintf.h>
 
+#include "base/constants.h"
+
 #define APPLICATION_HLS "application/x-hls"
 #define APPLICATION_ICY "application/x-icy"
 #define APPLICATION_TELETEXT "application/x-teletext"
@@ -35,6 +37,7 @@
 #define VIDEO_MPEG "video/mpeg"
 #define VIDEO_H264 "video/x-h264"
 #define VIDEO_H265 "video/x-h265"
+#define VIDEO_AV1 "video/x-av1"
 
 #define AUDIO_MPEG "audio/mpeg"
 #define AUDIO_AC3 "audio/x-ac3"
@@ -77,6 +80,112 @@ bool IsFakeUrl(const common::uri::Url& url) {
   return url == common::uri::Url(FAKE_URL);
 }
 
+bool IsKvsUrl(const common::uri::Url& url) {
+  return url == common::uri::Url(KVS_URL);
+}
+
+bool IsIcecastUrl(const common::uri::Url& url) {
+  return url.GetUrl().compare(0, sizeof(ICECAST_URL_PREFIX) - 1, ICECAST_URL_PREFIX) == 0;
+}
+
+IcecastOutput::IcecastOutput()
+    : host(), port(ICECAST_DEFAULT_PORT), mount("/"), user(ICECAST_DEFAULT_USER), password() {}
+
+bool MakeIcecastOutput(const std::string& url, IcecastOutput* out) {
+  const size_t prefix_len = sizeof(ICECAST_URL_PREFIX) - 1;
+  if (!out || url.compare(0, prefix_len, ICECAST_URL_PREFIX) != 0) {
+    return false;
+  }
+
+  IcecastOutput res;
+  std::string rest = url.substr(prefix_len);
+  const size_t slash = rest.find('/');
+  if (slash != std::string::npos) {
+    res.mount = rest.substr(slash);
+    rest = rest.substr(0, slash);
+  }
+
+  const size_t at = rest.rfind('@');
+  if (at != std::string::npos) {
+    const std::string credentials = rest.substr(0, at);
+    rest = rest.substr(at + 1);
+    const size_t colon = credentials.find(':');
+    if (colon == std::string::npos) {
+      res.password = credentials;
+    } else {
+      res.user = credentials.substr(0, colon);
+      res.password = credentials.substr(colon + 1);
+    }
+  }
+
+  const size_t colon = rest.rfind(':');
+  if (colon != std::string::npos) {
+    if (!common::ConvertFromString(rest.substr(colon + 1), &res.port)) {
+      return false;
+    }
+    rest = rest.substr(0, colon);
+  }
+
+  if (rest.empty()) {
+    return false;
+  }
+  res.host = rest;
+  *out = res;
+  return true;
+}
+
+UdpIngest::UdpIngest() : UdpIngest(0, 0, 0) {}
+
+UdpIngest::UdpIngest(size_t batch, int receive_buffer, int busy_poll_usec)
+    : batch(batch), receive_buffer(receive_buffer), busy_poll_usec(busy_poll_usec), packet_ring(false) {}
+
+bool UdpIngest::IsBatched() const {
+  return batch > 1;
+}
+
+UdpEgress::UdpEgress() : UdpEgress(0, 0, false, false) {}
+
+UdpEgress::UdpEgress(size_t batch, int send_buffer, bool pacing, bool fanout)
+    : batch(batch), send_buffer(send_buffer), pacing(pacing), fanout(fanout) {}
+
+bool UdpEgress::IsBatched() const {
+  return batch > 1;
+}
+
+RtspIngest::RtspIngest() : RtspIngest(0, 0, 0, 0) {}
+
+RtspIngest::RtspIngest(int latency_msec, int latency_min_msec, int latency_max_msec, int tcp_fallback_loss)
+    : latency_msec(latency_msec),
+      latency_min_msec(latency_min_msec),
+      latency_max_msec(latency_max_msec),
+      tcp_fallback_loss(tcp_fallback_loss) {}
+
+bool RtspIngest::IsAdaptive() const {
+  return latency_max_msec > latency_min_msec;
+}
+
+Thumbnail::Thumbnail() : Thumbnail(std::string(), 0, DEFAULT_THUMBNAIL_WIDTH) {}
+
+Thumbnail::Thumbnail(const std::string& path, time_t interval_sec, int width)
+    : path(path), interval_sec(interval_sec), width(width) {}
+
+bool Thumbnail::IsEnabled() const {
+  return !path.empty() && interval_sec > 0;
+}
+
+VodPart::VodPart() : VodPart(0, 0, 0) {}
+
+VodPart::VodPart(size_t index, fastotv::timestamp_t start_msec, fastotv::timestamp_t stop_msec)
+    : index(index), start_msec(start_msec), stop_msec(stop_msec) {}
+
+bool VodPart::IsRange() const {
+  return start_msec || stop_msec;
+}
+
+std::string VodPart::GetPrefix() const {
+  return common::MemSPrintf(VOD_PART_PREFIX_1U, index);
+}
+
 bool GetElementId(const std::string& name, element_id_t* elem_id) {
   if (!elem_id) {
     return false;
@@ -177,6 +286,9 @@ bool IsVideoCodecFromType(const std::string& type, SupportedVideoCodec* vc) {
   } else if (type == VIDEO_H265) {
     *vc = VIDEO_H265_CODEC;
     return true;
+  } else if (type == VIDEO_AV1) {
+    *vc = VIDEO_AV1_CODEC;
+    return true;
   }
 
   return false;
@@ -0,0 +1,200 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/thumbnailer.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include <gst/app/gstappsrc.h>
+
+#include <common/logger.h>
+#include <common/sprintf.h>
+#include <common/time.h>
+
+#define THUMBNAIL_RENDER_TIMEOUT_SEC 5
+#define THUMBNAIL_TMP_EXT ".tmp"
+
+namespace fastocloud {
+namespace stream {
+
+Thumbnailer::Thumbnailer(const Thumbnail& thumbnail)
+    : thumbnail_(thumbnail),
+      id_probe_(0),
+      pad_(nullptr),
+      next_msec_(0),
+      mutex_(),
+      cond_(),
+      pending_buffer_(nullptr),
+      pending_caps_(nullptr),
+      stop_(false),
+      thread_() {
+  thread_ = std::thread(&Thumbnailer::RenderLoop, this);
+}
+
+Thumbnailer::~Thumbnailer() {
+  Clear();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_one();
+  thread_.join();
+  if (pending_buffer_) {
+    gst_buffer_unref(pending_buffer_);
+  }
+  if (pending_caps_) {
+    gst_caps_unref(pending_caps_);
+  }
+}
+
+void Thumbnailer::Link(GstPad* pad) {
+  Clear();
+  pad_ = pad;
+  id_probe_ = gst_pad_add_probe(pad_, GST_PAD_PROBE_TYPE_BUFFER, callback_probe, this, destroy_callback_probe);
+}
+
+void Thumbnailer::Take(GstPad* pad, GstBuffer* buffer) {
+  if (GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    return;
+  }
+
+  const fastotv::timestamp_t now = common::time::current_utc_mstime();
+  if (now < next_msec_) {
+    return;
+  }
+
+  GstCaps* caps = gst_pad_get_current_caps(pad);
+  if (!caps) {
+    return;
+  }
+
+  next_msec_ = now + thumbnail_.interval_sec * 1000;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_buffer_) {
+      pending_buffer_ = gst_buffer_ref(buffer);
+      pending_caps_ = caps;
+      caps = nullptr;
+    }
+  }
+  if (caps) {  // previous still rendering
+    gst_caps_unref(caps);
+    return;
+  }
+  cond_.notify_one();
+}
+
+void Thumbnailer::RenderLoop() {
+  while (true) {
+    GstBuffer* buffer = nullptr;
+    GstCaps* caps = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this]() { return stop_ || pending_buffer_; });
+      if (stop_) {
+        return;
+      }
+      buffer = pending_buffer_;
+      caps = pending_caps_;
+    }
+
+    if (!Render(buffer, caps)) {
+      WARNING_LOG() << "Failed to render thumbnail: " << thumbnail_.path;
+    }
+    gst_buffer_unref(buffer);
+    gst_caps_unref(caps);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_buffer_ = nullptr;
+    pending_caps_ = nullptr;
+  }
+}
+
+bool Thumbnailer::Render(GstBuffer* buffer, GstCaps* caps) const {
+  // keyframe pushed alone, decoder has nothing else to decode
+  const std::string tmp_path = thumbnail_.path + THUMBNAIL_TMP_EXT;
+  const std::string desc = common::MemSPrintf(
+      "appsrc name=src format=time ! decodebin ! videoconvert ! videoscale ! "
+      "video/x-raw,width=%d,pixel-aspect-ratio=1/1 ! jpegenc snapshot=true ! filesink sync=false location=\"%s\"",
+      thumbnail_.width, tmp_path.c_str());
+  GError* err = nullptr;
+  GstElement* pipeline = gst_parse_launch(desc.c_str(), &err);
+  if (err) {
+    g_error_free(err);
+    if (pipeline) {
+      gst_object_unref(pipeline);
+    }
+    return false;
+  }
+
+  GstElement* src = gst_bin_get_by_name(GST_BIN(pipeline), "src");
+  if (!src) {
+    gst_object_unref(pipeline);
+    return false;
+  }
+
+  GstBuffer* frame = gst_buffer_copy(buffer);  // timestamps of live stream not needed
+  GST_BUFFER_PTS(frame) = 0;
+  GST_BUFFER_DTS(frame) = GST_CLOCK_TIME_NONE;
+  gst_app_src_set_caps(GST_APP_SRC(src), caps);
+  gst_app_src_push_buffer(GST_APP_SRC(src), frame);
+  gst_app_src_end_of_stream(GST_APP_SRC(src));
+  gst_object_unref(src);
+
+  gst_element_set_state(pipeline, GST_STATE_PLAYING);
+  GstBus* bus = gst_element_get_bus(pipeline);
+  GstMessage* msg = gst_bus_timed_pop_filtered(bus, THUMBNAIL_RENDER_TIMEOUT_SEC * GST_SECOND,
+                                               static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  bool res = msg && GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS;
+  if (msg) {
+    gst_message_unref(msg);
+  }
+  gst_object_unref(bus);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(pipeline);
+
+  if (res) {
+    res = rename(tmp_path.c_str(), thumbnail_.path.c_str()) == 0;  // readers never see partial jpeg
+  } else {
+    remove(tmp_path.c_str());
+  }
+  return res;
+}
+
+void Thumbnailer::Clear() {
+  if (!pad_) {
+    return;
+  }
+
+  gst_pad_remove_probe(pad_, id_probe_);
+  pad_ = nullptr;
+  id_probe_ = 0;
+}
+
+GstPadProbeReturn Thumbnailer::callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  Thumbnailer* thumbnailer = reinterpret_cast<Thumbnailer*>(user_data);
+  thumbnailer->Take(pad, GST_PAD_PROBE_INFO_BUFFER(info));
+  return GST_PAD_PROBE_OK;
+}
+
+void Thumbnailer::destroy_callback_probe(gpointer user_data) {
+  Thumbnailer* thumbnailer = reinterpret_cast<Thumbnailer*>(user_data);
+  thumbnailer->pad_ = nullptr;
+  thumbnailer->id_probe_ = 0;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
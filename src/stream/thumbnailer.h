@@ -0,0 +1,64 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gst/gst.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <common/macros.h>
+
+#include "stream/stypes.h"
+
+namespace fastocloud {
+namespace stream {
+
+// keyframes of parsed video taken at interval and decoded alone into jpeg by own small pipeline:
+// appsrc => decodebin => videoscale => jpegenc => filesink, streaming thread only refs buffer
+class Thumbnailer {
+ public:
+  explicit Thumbnailer(const Thumbnail& thumbnail);
+  ~Thumbnailer();
+
+  void Link(GstPad* pad);
+
+ private:
+  static GstPadProbeReturn callback_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+  static void destroy_callback_probe(gpointer user_data);
+
+  void Take(GstPad* pad, GstBuffer* buffer);
+  void RenderLoop();
+  bool Render(GstBuffer* buffer, GstCaps* caps) const;
+  void Clear();
+
+  const Thumbnail thumbnail_;
+  gulong id_probe_;
+  GstPad* pad_;
+  fastotv::timestamp_t next_msec_;  // streaming thread only
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  GstBuffer* pending_buffer_;  // one keyframe at time, next skipped while rendering
+  GstCaps* pending_caps_;
+  bool stop_;
+  std::thread thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(Thumbnailer);
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -14,10 +14,14 @@
 
 #include "stream/timeshift.h"
 
+#include <stdio.h>
+
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include <common/convert2string.h>
+#include <common/sprintf.h>
 #include <common/time.h>
 
 #include <common/file_system/file_system.h>
@@ -30,7 +34,14 @@
 namespace fastocloud {
 namespace stream {
 
+#define INDEX_TMP_EXT ".tmp"
+
 namespace {
+bool is_chunk_exist(const common::file_system::ascii_directory_string_path& dir, chunk_index_t index) {
+  auto path = dir.MakeFileStringPath(common::MemSPrintf("%llu" CHUNK_EXT, index));
+  return path && common::file_system::is_file_exist(path->GetPath());
+}
+
 template <typename CharT, typename Traits>
 bool filter_files(const common::file_system::FileStringPath<CharT, Traits>& path) {
   std::string file_name = path.GetBaseFileName();
@@ -51,20 +62,100 @@ bool compare_files(const common::file_system::ascii_file_string_path& first,
   CHECK(ok) << "Must be index but: " << second_chunk;
   return first_index < second_index;
 }
+
+template <typename Entry>
+bool append_entry(const common::file_system::ascii_directory_string_path& dir,
+                  const std::string& name,
+                  const Entry& entry) {
+  auto path = dir.MakeFileStringPath(name);
+  if (!path) {
+    return false;
+  }
+
+  FILE* file = fopen(path->GetPath().c_str(), "ab");
+  if (!file) {
+    return false;
+  }
+
+  bool res = fwrite(&entry, sizeof(Entry), 1, file) == 1;
+  fclose(file);
+  return res;
+}
+
+template <typename Entry>
+bool compact_entries(const common::file_system::ascii_directory_string_path& dir,
+                     const std::string& name,
+                     time_t min_end_utc) {
+  auto path = dir.MakeFileStringPath(name);
+  auto tmp_path = dir.MakeFileStringPath(name + INDEX_TMP_EXT);
+  if (!path || !tmp_path) {
+    return false;
+  }
+
+  std::vector<Entry> entries;
+  {
+    const IndexReader<Entry> reader(dir, name);
+    Entry first;
+    if (!reader.Read(0, &first) || GetChunkEndMsec(first) >= static_cast<int64_t>(min_end_utc) * 1000) {
+      return true;  // nothing to drop
+    }
+
+    Entry entry;
+    for (size_t i = 0; reader.Read(i, &entry); ++i) {
+      if (GetChunkEndMsec(entry) >= static_cast<int64_t>(min_end_utc) * 1000) {
+        entries.push_back(entry);
+      }
+    }
+  }
+
+  FILE* file = fopen(tmp_path->GetPath().c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+
+  bool res = entries.empty() || fwrite(entries.data(), sizeof(Entry), entries.size(), file) == entries.size();
+  fclose(file);
+  if (!res) {
+    remove(tmp_path->GetPath().c_str());
+    return false;
+  }
+
+  return rename(tmp_path->GetPath().c_str(), path->GetPath().c_str()) == 0;  // readers keep old file
+}
 }  // namespace
 
 TimeShiftInfo::TimeShiftInfo()
-    : timshift_dir(), timeshift_chunk_life_time(DEFAULT_CHUNK_LIFE_TIME), timeshift_delay(0) {}
+    : timshift_dir(), timeshift_chunk_life_time(DEFAULT_CHUNK_LIFE_TIME), timeshift_delay(0), timeshift_start_utc(0) {}
 
 TimeShiftInfo::TimeShiftInfo(const std::string& path, chunk_life_time_t lth, time_shift_delay_t delay)
-    : timshift_dir(path), timeshift_chunk_life_time(lth), timeshift_delay(delay) {}
+    : timshift_dir(path), timeshift_chunk_life_time(lth), timeshift_delay(delay), timeshift_start_utc(0) {}
 
 bool TimeShiftInfo::FindChunkToPlay(time_t chunk_duration, chunk_index_t* index) const {
   if (!index) {
     return false;
   }
 
+  if (timeshift_start_utc) {
+    return FindChunkByTime(timeshift_start_utc, index);
+  }
+
   time_t desired_time = common::time::current_utc_mstime() / 1000 - timeshift_delay * 60;  // OK
+  const ChunksIndexReader reader(timshift_dir);
+  if (reader.GetCount() != 0) {
+    ChunkIndexEntry entry;
+    if (!reader.FindByTime(desired_time, &entry)) {
+      return false;  // not recorded yet
+    }
+
+    if (is_chunk_exist(timshift_dir, entry.index)) {
+      *index = entry.index;
+      INFO_LOG() << "Select " << *index << " part by index, start msec " << entry.start_msec;
+      return true;
+    }
+
+    WARNING_LOG() << "Chunks index out of sync, chunk " << entry.index << " not found, scan folder";
+  }
+
   std::string absolute_path = timshift_dir.GetPath();
   if (!common::file_system::is_directory_exist(absolute_path)) {
     CRITICAL_LOG() << "Folder with chunks doesn't exist: " << absolute_path;
@@ -102,11 +193,56 @@ bool TimeShiftInfo::FindChunkToPlay(time_t chunk_duration, chunk_index_t* index)
   return false;
 }
 
+bool TimeShiftInfo::FindChunkByTime(time_t utc, chunk_index_t* index) const {
+  if (!index) {
+    return false;
+  }
+
+  const ChunksIndexReader reader(timshift_dir);
+  if (reader.GetCount() != 0) {
+    ChunkIndexEntry entry;
+    if (reader.FindByTime(utc, &entry) && is_chunk_exist(timshift_dir, entry.index)) {
+      *index = entry.index;
+      INFO_LOG() << "Select " << *index << " part for utc " << utc << ", start msec " << entry.start_msec;
+      return true;
+    }
+    return false;
+  }
+
+  auto files = common::file_system::ScanFolder(timshift_dir, CHUNK_EXT, false, &filter_files);
+  std::sort(files.begin(), files.end(), compare_files);
+  for (size_t i = 0; i < files.size(); ++i) {
+    time_t file_created_time;
+    common::ErrnoError err =
+        common::file_system::get_file_time_last_modification(files[i].GetPath(), &file_created_time);
+    if (err || file_created_time <= utc) {  // modification time is end of chunk
+      continue;
+    }
+
+    chunk_index_t lindex;
+    if (common::ConvertFromString(files[i].GetBaseFileName(), &lindex)) {
+      *index = lindex;
+      INFO_LOG() << "Select " << *index << " part for utc " << utc << " by scan";
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool TimeShiftInfo::FindLastChunk(chunk_index_t* index, time_t* file_created_time) const {
   if (!index || !file_created_time) {
     return false;
   }
 
+  const ChunksIndexReader reader(timshift_dir);
+  ChunkIndexEntry entry;
+  if (reader.Read(reader.GetCount() - 1, &entry) && is_chunk_exist(timshift_dir, entry.index)) {
+    *index = entry.index;
+    *file_created_time = GetChunkEndMsec(entry) / 1000;
+    return true;
+  }
+
   const std::string absolute_path = timshift_dir.GetPath();
   if (!common::file_system::is_directory_exist(absolute_path)) {
     CRITICAL_LOG() << "Folder with chunks doesn't exist: " << absolute_path;
@@ -131,5 +267,37 @@ bool TimeShiftInfo::FindLastChunk(chunk_index_t* index, time_t* file_created_tim
   return true;
 }
 
+bool TimeShiftInfo::AppendChunk(const ChunkIndexEntry& entry) const {
+  return append_entry(timshift_dir, CHUNKS_INDEX_NAME, entry);
+}
+
+bool TimeShiftInfo::CompactChunks(time_t min_end_utc) const {
+  return compact_entries<ChunkIndexEntry>(timshift_dir, CHUNKS_INDEX_NAME, min_end_utc);
+}
+
+bool TimeShiftInfo::FindLastRange(chunk_index_t* index, time_t* end_utc) const {
+  if (!index || !end_utc) {
+    return false;
+  }
+
+  const ChunkRangesReader reader(timshift_dir);
+  ChunkRangeEntry entry;
+  if (!reader.Read(reader.GetCount() - 1, &entry)) {
+    return false;
+  }
+
+  *index = entry.index;
+  *end_utc = GetChunkEndMsec(entry) / 1000;
+  return true;
+}
+
+bool TimeShiftInfo::AppendRange(const ChunkRangeEntry& entry) const {
+  return append_entry(timshift_dir, CHUNK_RANGES_INDEX_NAME, entry);
+}
+
+bool TimeShiftInfo::CompactRanges(time_t min_end_utc) const {
+  return compact_entries<ChunkRangeEntry>(timshift_dir, CHUNK_RANGES_INDEX_NAME, min_end_utc);
+}
+
 }  // namespace stream
 }  // namespace fastocloud
@@ -19,6 +19,8 @@
 
 #include <common/file_system/path.h>
 
+#include "base/chunks_index.h"
+
 namespace fastocloud {
 namespace stream {
 
@@ -34,10 +36,20 @@ struct TimeShiftInfo {
 
   bool FindLastChunk(chunk_index_t* index, time_t* file_created_time) const WARN_UNUSED_RESULT;
   bool FindChunkToPlay(time_t chunk_duration, chunk_index_t* index) const WARN_UNUSED_RESULT;
+  bool FindChunkByTime(time_t utc, chunk_index_t* index) const WARN_UNUSED_RESULT;  // chunk containing utc
+
+  bool AppendChunk(const ChunkIndexEntry& entry) const WARN_UNUSED_RESULT;
+  bool CompactChunks(time_t min_end_utc) const WARN_UNUSED_RESULT;  // drop entries of removed chunks
+
+  // hour files, chunks there not playable by player streams, only by http timeshift playlists
+  bool FindLastRange(chunk_index_t* index, time_t* end_utc) const WARN_UNUSED_RESULT;
+  bool AppendRange(const ChunkRangeEntry& entry) const WARN_UNUSED_RESULT;
+  bool CompactRanges(time_t min_end_utc) const WARN_UNUSED_RESULT;
 
   common::file_system::ascii_directory_string_path timshift_dir;
   chunk_life_time_t timeshift_chunk_life_time;
   time_shift_delay_t timeshift_delay;
+  time_t timeshift_start_utc;  // 0 if relative to now by delay
 };
 
 }  // namespace stream
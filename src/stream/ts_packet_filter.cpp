@@ -0,0 +1,319 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/ts_packet_filter.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+uint64_t hash_ts_packet(const uint8_t* packet) {  // fnv-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < TS_PACKET_SIZE; ++i) {
+    hash ^= packet[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+}  // namespace
+
+bool get_ts_packet_pid(const uint8_t* packet, size_t size, uint16_t* pid) {
+  if (!packet || size < TS_PACKET_SIZE || !pid || packet[0] != TS_SYNC_BYTE) {
+    return false;
+  }
+
+  *pid = static_cast<uint16_t>(((packet[1] & 0x1F) << 8) | packet[2]);
+  return true;
+}
+
+bool get_ts_packet_pcr(const uint8_t* packet, size_t size, uint64_t* pcr) {
+  if (!packet || size < TS_PACKET_SIZE || !pcr || packet[0] != TS_SYNC_BYTE) {
+    return false;
+  }
+
+  const bool have_adaptation = packet[3] & 0x20;
+  if (!have_adaptation || packet[4] < 7 || !(packet[5] & 0x10)) {
+    return false;
+  }
+
+  const uint64_t base = (static_cast<uint64_t>(packet[6]) << 25) | (packet[7] << 17) | (packet[8] << 9) |
+                        (packet[9] << 1) | (packet[10] >> 7);
+  const uint64_t ext = ((packet[10] & 0x01) << 8) | packet[11];
+  *pcr = base * 300 + ext;
+  return true;
+}
+
+size_t filter_ts_packets(uint8_t* data, size_t size, const ts_pids_t& drop_pids) {
+  if (!data || drop_pids.empty()) {
+    return size;
+  }
+
+  size_t read = 0;
+  size_t write = 0;
+  while (read < size) {
+    uint16_t pid;
+    if (!get_ts_packet_pid(data + read, size - read, &pid)) {
+      break;  // not aligned, rest forwarded untouched
+    }
+
+    if (std::find(drop_pids.begin(), drop_pids.end(), pid) == drop_pids.end()) {
+      if (write != read) {
+        memmove(data + write, data + read, TS_PACKET_SIZE);
+      }
+      write += TS_PACKET_SIZE;
+    }
+    read += TS_PACKET_SIZE;
+  }
+
+  if (read < size) {
+    if (write != read) {
+      memmove(data + write, data + read, size - read);
+    }
+    write += size - read;
+  }
+  return write;
+}
+
+TsPacketMerger::TsPacketMerger() : mutex_(), seen_(), order_(), duplicates_(0) {}
+
+size_t TsPacketMerger::Merge(uint8_t* data, size_t size) {
+  if (!data) {
+    return size;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t read = 0;
+  size_t write = 0;
+  while (read + TS_PACKET_SIZE <= size && data[read] == TS_SYNC_BYTE) {
+    if (Insert(hash_ts_packet(data + read))) {
+      if (write != read) {
+        memmove(data + write, data + read, TS_PACKET_SIZE);
+      }
+      write += TS_PACKET_SIZE;
+    } else {
+      duplicates_++;
+    }
+    read += TS_PACKET_SIZE;
+  }
+
+  if (read < size) {  // not aligned, rest forwarded untouched
+    if (write != read) {
+      memmove(data + write, data + read, size - read);
+    }
+    write += size - read;
+  }
+  return write;
+}
+
+uint64_t TsPacketMerger::GetDuplicates() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return duplicates_;
+}
+
+bool TsPacketMerger::Insert(uint64_t hash) {
+  if (!seen_.insert(hash).second) {
+    return false;
+  }
+
+  order_.push_back(hash);
+  if (order_.size() > window_packets) {
+    seen_.erase(order_.front());
+    order_.pop_front();
+  }
+  return true;
+}
+
+uint32_t ts_section_crc32(const uint8_t* data, size_t size) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= static_cast<uint32_t>(data[i]) << 24;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+TsProgramFilter::TsProgramFilter(uint16_t program)
+    : program_(program), pmt_pid_(TS_NULL_PID), pmt_version_(-1), kept_(TS_NULL_PID + 1, false) {}
+
+size_t TsProgramFilter::Filter(uint8_t* data, size_t size) {
+  if (!data) {
+    return size;
+  }
+
+  size_t read = 0;
+  size_t write = 0;
+  while (read < size) {
+    uint16_t pid;
+    if (!get_ts_packet_pid(data + read, size - read, &pid)) {
+      break;  // not aligned, rest forwarded untouched
+    }
+
+    uint8_t* packet = data + read;
+    bool keep = false;
+    if (pid == TS_PAT_PID) {
+      keep = HandlePat(packet) && IsReady();
+    } else if (pid == pmt_pid_) {
+      HandlePmt(packet);
+      keep = IsReady();
+    } else {
+      keep = IsKept(pid);
+    }
+
+    if (keep) {
+      if (write != read) {
+        memmove(data + write, packet, TS_PACKET_SIZE);
+      }
+      write += TS_PACKET_SIZE;
+    }
+    read += TS_PACKET_SIZE;
+  }
+
+  if (read < size) {
+    if (write != read) {
+      memmove(data + write, data + read, size - read);
+    }
+    write += size - read;
+  }
+  return write;
+}
+
+uint16_t TsProgramFilter::GetProgram() const {
+  return program_;
+}
+
+bool TsProgramFilter::IsReady() const {
+  return pmt_version_ != -1;
+}
+
+bool TsProgramFilter::HandlePat(uint8_t* packet) {
+  const bool unit_start = packet[1] & 0x40;
+  const uint8_t adaptation = (packet[3] >> 4) & 0x03;
+  if (!unit_start || !(adaptation & 0x01)) {
+    return false;  // continuation of section not fitting one packet
+  }
+
+  size_t pos = 4;
+  if (adaptation & 0x02) {
+    pos += 1 + packet[4];
+  }
+  if (pos >= TS_PACKET_SIZE) {
+    return false;
+  }
+  pos += 1 + packet[pos];  // pointer field
+  if (pos + 8 > TS_PACKET_SIZE || packet[pos] != 0x00) {
+    return false;
+  }
+
+  const uint8_t* section = packet + pos;
+  const size_t section_length = ((section[1] & 0x0F) << 8) | section[2];
+  if (section_length < 9 || pos + 3 + section_length > TS_PACKET_SIZE) {
+    return false;
+  }
+
+  bool found = false;
+  for (size_t i = 8; i + 4 <= 3 + section_length - 4; i += 4) {
+    const uint16_t program = (section[i] << 8) | section[i + 1];
+    if (program == program_) {
+      const uint16_t pmt_pid = ((section[i + 2] & 0x1F) << 8) | section[i + 3];
+      if (pmt_pid != pmt_pid_) {
+        pmt_pid_ = pmt_pid;
+        pmt_version_ = -1;
+        kept_.assign(kept_.size(), false);
+      }
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    return false;
+  }
+
+  // ts id, version and continuity kept, payload only with one program entry
+  uint8_t pat[12];
+  memcpy(pat, section, 8);
+  pat[1] = 0xB0;
+  pat[2] = 13;
+  pat[6] = 0;
+  pat[7] = 0;
+  pat[8] = static_cast<uint8_t>(program_ >> 8);
+  pat[9] = static_cast<uint8_t>(program_);
+  pat[10] = static_cast<uint8_t>(0xE0 | (pmt_pid_ >> 8));
+  pat[11] = static_cast<uint8_t>(pmt_pid_);
+  const uint32_t crc = ts_section_crc32(pat, sizeof(pat));
+
+  packet[3] = static_cast<uint8_t>(0x10 | (packet[3] & 0x0F));
+  packet[4] = 0;
+  memcpy(packet + 5, pat, sizeof(pat));
+  packet[17] = static_cast<uint8_t>(crc >> 24);
+  packet[18] = static_cast<uint8_t>(crc >> 16);
+  packet[19] = static_cast<uint8_t>(crc >> 8);
+  packet[20] = static_cast<uint8_t>(crc);
+  memset(packet + 21, 0xFF, TS_PACKET_SIZE - 21);
+  return true;
+}
+
+void TsProgramFilter::HandlePmt(const uint8_t* packet) {
+  const bool unit_start = packet[1] & 0x40;
+  const uint8_t adaptation = (packet[3] >> 4) & 0x03;
+  if (!unit_start || !(adaptation & 0x01)) {
+    return;
+  }
+
+  size_t pos = 4;
+  if (adaptation & 0x02) {
+    pos += 1 + packet[4];
+  }
+  if (pos >= TS_PACKET_SIZE) {
+    return;
+  }
+  pos += 1 + packet[pos];
+  if (pos + 12 > TS_PACKET_SIZE || packet[pos] != 0x02) {
+    return;
+  }
+
+  const uint8_t* section = packet + pos;
+  const size_t section_length = ((section[1] & 0x0F) << 8) | section[2];
+  const uint16_t program = (section[3] << 8) | section[4];
+  const int version = (section[5] >> 1) & 0x1F;
+  if (section_length < 13 || pos + 3 + section_length > TS_PACKET_SIZE || program != program_ ||
+      version == pmt_version_) {
+    return;
+  }
+
+  std::vector<bool> kept(kept_.size(), false);
+  kept[pmt_pid_] = true;
+  kept[((section[8] & 0x1F) << 8) | section[9]] = true;  // pcr pid
+  const size_t end = 3 + section_length - 4;
+  size_t i = 12 + (((section[10] & 0x0F) << 8) | section[11]);
+  while (i + 5 <= end) {
+    kept[((section[i + 1] & 0x1F) << 8) | section[i + 2]] = true;
+    i += 5 + (((section[i + 3] & 0x0F) << 8) | section[i + 4]);
+  }
+  kept[TS_NULL_PID] = false;
+  kept_.swap(kept);
+  pmt_version_ = version;
+}
+
+bool TsProgramFilter::IsKept(uint16_t pid) const {
+  return IsReady() && kept_[pid];
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,85 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#define TS_PACKET_SIZE 188
+#define TS_SYNC_BYTE 0x47
+#define TS_PAT_PID 0x0000
+#define TS_NULL_PID 0x1FFF
+
+namespace fastocloud {
+namespace stream {
+
+typedef std::vector<uint16_t> ts_pids_t;
+
+bool get_ts_packet_pid(const uint8_t* packet, size_t size, uint16_t* pid);
+bool get_ts_packet_pcr(const uint8_t* packet, size_t size, uint64_t* pcr);  // 27 MHz, false if packet carries none
+
+// packets of dropped pids removed in place, data after lost sync kept as is, returns size left
+size_t filter_ts_packets(uint8_t* data, size_t size, const ts_pids_t& drop_pids);
+
+// hitless merge of same ts received over redundant paths, first copy of packet passed and later ones dropped,
+// packets identified by content within window covering delay between paths
+class TsPacketMerger {
+ public:
+  enum { window_packets = 8192 };
+
+  TsPacketMerger();
+
+  size_t Merge(uint8_t* data, size_t size);  // any path thread, duplicates removed in place, returns size left
+  uint64_t GetDuplicates() const;
+
+ private:
+  bool Insert(uint64_t hash);  // false if seen
+
+  mutable std::mutex mutex_;
+  std::unordered_set<uint64_t> seen_;
+  std::deque<uint64_t> order_;
+  uint64_t duplicates_;
+};
+
+uint32_t ts_section_crc32(const uint8_t* data, size_t size);  // mpeg-2 crc of psi section
+
+// single program split from multi program ts: pat rewritten to list only it, its pmt and pids of pmt kept, rest
+// dropped, nothing passed till pmt of program seen; pat and pmt sections expected within one packet
+class TsProgramFilter {
+ public:
+  explicit TsProgramFilter(uint16_t program);
+
+  size_t Filter(uint8_t* data, size_t size);  // streaming thread, in place, returns size left
+  uint16_t GetProgram() const;
+  bool IsReady() const;
+
+ private:
+  bool HandlePat(uint8_t* packet);  // rewritten in place, false if program not listed
+  void HandlePmt(const uint8_t* packet);
+  bool IsKept(uint16_t pid) const;
+
+  const uint16_t program_;
+  uint16_t pmt_pid_;  // TS_NULL_PID till listed in pat
+  int pmt_version_;   // -1 till pmt seen
+  std::vector<bool> kept_;
+};
+
+}  // namespace stream
+}  // namespace fastocloud
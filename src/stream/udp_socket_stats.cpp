@@ -0,0 +1,83 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/udp_socket_stats.h"
+
+#if defined(OS_LINUX)
+#include <sys/stat.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace fastocloud {
+namespace stream {
+
+namespace {
+#if defined(OS_LINUX)
+bool find_socket_drops(const char* path, ino_t inode, uint64_t* drops) {
+  std::ifstream table(path);
+  if (!table.is_open()) {
+    return false;
+  }
+
+  std::string line;
+  std::getline(table, line);  // header
+  while (std::getline(table, line)) {
+    // sl local rem st tx:rx tr:when retrnsmt uid timeout inode ref pointer drops
+    std::istringstream fields(line);
+    std::string skip;
+    for (int i = 0; i < 9; ++i) {
+      fields >> skip;
+    }
+    uint64_t line_inode = 0;
+    fields >> line_inode;
+    if (!fields || line_inode != inode) {
+      continue;
+    }
+
+    fields >> skip >> skip;
+    uint64_t line_drops = 0;
+    fields >> line_drops;
+    if (!fields) {
+      return false;
+    }
+    *drops = line_drops;
+    return true;
+  }
+  return false;
+}
+#endif
+}  // namespace
+
+bool get_udp_socket_drops(int fd, uint64_t* drops) {
+  if (fd < 0 || !drops) {
+    return false;
+  }
+
+#if defined(OS_LINUX)
+  struct stat st;
+  if (fstat(fd, &st) == -1 || !S_ISSOCK(st.st_mode)) {
+    return false;
+  }
+
+  return find_socket_drops("/proc/net/udp", st.st_ino, drops) || find_socket_drops("/proc/net/udp6", st.st_ino, drops);
+#else
+  return false;
+#endif
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,121 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream/video_meter.h"
+
+#include <stdlib.h>
+
+namespace fastocloud {
+namespace stream {
+
+VideoMeter::VideoMeter(fastotv::timestamp_t interval_msec)
+    : interval_msec_(interval_msec ? interval_msec : static_cast<fastotv::timestamp_t>(default_interval_msec)),
+      width_(0),
+      height_(0),
+      samples_(),
+      prev_samples_(),
+      have_prev_(false),
+      next_ts_(0),
+      black_since_(-1),
+      freeze_since_(-1) {}
+
+bool VideoMeter::SetFormat(size_t width, size_t height) {
+  Reset();
+  if (width == 0 || height == 0) {
+    width_ = 0;
+    return false;
+  }
+
+  width_ = width;
+  height_ = height;
+  const size_t count = ((width + grid_step - 1) / grid_step) * ((height + grid_step - 1) / grid_step);
+  samples_.assign(count, 0);
+  prev_samples_.assign(count, 0);
+  return true;
+}
+
+bool VideoMeter::IsActive() const {
+  return width_ != 0;
+}
+
+bool VideoMeter::IsDue(fastotv::timestamp_t ts) const {
+  return IsActive() && (ts >= next_ts_ || ts < next_ts_ - interval_msec_);  // timestamps jumped back
+}
+
+bool VideoMeter::Process(const uint8_t* luma, size_t stride, fastotv::timestamp_t ts, State* state) {
+  if (!luma || !state || stride < width_ || !IsDue(ts)) {
+    return false;
+  }
+
+  next_ts_ = ts + interval_msec_;
+  uint8_t* out = samples_.data();
+  for (size_t y = 0; y < height_; y += grid_step) {
+    const uint8_t* line = luma + y * stride;
+    for (size_t x = 0; x < width_; x += grid_step) {
+      *out++ = line[x];
+    }
+  }
+
+  // plain integer loops over contiguous samples, vectorized by compiler
+  const size_t count = samples_.size();
+  const uint8_t* cur = samples_.data();
+  const uint8_t* prev = prev_samples_.data();
+  uint64_t sum = 0;
+  uint64_t sum_sq = 0;
+  uint64_t sad = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t value = cur[i];
+    sum += value;
+    sum_sq += value * value;
+    sad += static_cast<uint32_t>(abs(static_cast<int>(value) - static_cast<int>(prev[i])));
+  }
+
+  const uint64_t mean = sum / count;
+  const uint64_t variance = sum_sq / count - mean * mean;
+  if (mean <= black_luma && variance <= black_variance) {
+    if (black_since_ < 0) {
+      black_since_ = ts;
+    }
+  } else {
+    black_since_ = -1;
+  }
+
+  if (have_prev_ && sad <= static_cast<uint64_t>(freeze_difference) * count) {
+    if (freeze_since_ < 0) {
+      freeze_since_ = ts;
+    }
+  } else {
+    freeze_since_ = -1;
+  }
+
+  if (!have_prev_) {
+    sad = 0;  // nothing to compare with
+  }
+  samples_.swap(prev_samples_);
+  have_prev_ = true;
+  state->black_msec = black_since_ < 0 ? 0 : ts - black_since_;
+  state->freeze_msec = freeze_since_ < 0 ? 0 : ts - freeze_since_;
+  state->motion = static_cast<uint32_t>(sad * 100 / count);
+  return true;
+}
+
+void VideoMeter::Reset() {
+  have_prev_ = false;
+  next_ts_ = 0;
+  black_since_ = -1;
+  freeze_since_ = -1;
+}
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <fastotv/types.h>
+
+namespace fastocloud {
+namespace stream {
+
+// black and frozen picture of decoded video, luma plane sampled on sparse grid of frames taken at interval
+class VideoMeter {
+ public:
+  enum {
+    default_interval_msec = 500,
+    grid_step = 8,         // every 8th pixel of every 8th line
+    black_luma = 32,       // mean of limited range luma
+    black_variance = 64,   // flat picture, stddev 8 of luma
+    freeze_difference = 1  // mean absolute difference of samples with previous frame
+  };
+
+  struct State {
+    fastotv::timestamp_t black_msec;   // picture black for
+    fastotv::timestamp_t freeze_msec;  // picture not changed for
+    uint32_t motion;                   // mean absolute difference with previous frame, hundredths of luma level
+  };
+
+  explicit VideoMeter(fastotv::timestamp_t interval_msec = default_interval_msec);
+
+  // luma plane of 8 bit formats, false if size not valid and metering stopped
+  bool SetFormat(size_t width, size_t height);
+  bool IsActive() const;
+
+  bool IsDue(fastotv::timestamp_t ts) const;  // frame at ts should be sampled, check before mapping buffer
+  // stride of luma lines in bytes, ts of frame in msec, true if frame sampled and state filled
+  bool Process(const uint8_t* luma, size_t stride, fastotv::timestamp_t ts, State* state);
+
+ private:
+  void Reset();
+
+  const fastotv::timestamp_t interval_msec_;
+  size_t width_;
+  size_t height_;
+  std::vector<uint8_t> samples_;
+  std::vector<uint8_t> prev_samples_;
+  bool have_prev_;
+  fastotv::timestamp_t next_ts_;
+  fastotv::timestamp_t black_since_;  // -1 if not black
+  fastotv::timestamp_t freeze_since_;  // -1 if changed
+};
+
+}  // namespace stream
+}  // namespace fastocloud
@@ -0,0 +1,281 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream_commands/binary_protocol.h"
+
+#include <stdint.h>
+
+namespace fastocloud {
+
+namespace {
+enum BinaryCommandKind : uint8_t { BINARY_REQUEST = 1, BINARY_RESPONSE_MESSAGE = 2, BINARY_RESPONSE_ERROR = 3 };
+const uint32_t kAbsentField = UINT32_MAX;
+
+void PutSize(uint32_t size, std::string* out) {
+  out->push_back(static_cast<char>((size >> 24) & 0xFF));
+  out->push_back(static_cast<char>((size >> 16) & 0xFF));
+  out->push_back(static_cast<char>((size >> 8) & 0xFF));
+  out->push_back(static_cast<char>(size & 0xFF));
+}
+
+uint32_t GetSize(const char* data) {
+  const unsigned char* udata = reinterpret_cast<const unsigned char*>(data);
+  return (uint32_t(udata[0]) << 24) | (uint32_t(udata[1]) << 16) | (uint32_t(udata[2]) << 8) | uint32_t(udata[3]);
+}
+
+void PutField(const std::string& field, std::string* out) {
+  PutSize(field.size(), out);
+  out->append(field);
+}
+
+void PutOptionalField(const common::Optional<std::string>& field, std::string* out) {
+  if (!field) {
+    PutSize(kAbsentField, out);
+    return;
+  }
+
+  PutField(*field, out);
+}
+
+bool GetOptionalField(const std::string& payload, size_t* pos, common::Optional<std::string>* field) {
+  if (payload.size() - *pos < sizeof(uint32_t)) {
+    return false;
+  }
+
+  const uint32_t size = GetSize(payload.data() + *pos);
+  *pos += sizeof(uint32_t);
+  if (size == kAbsentField) {
+    *field = common::Optional<std::string>();
+    return true;
+  }
+
+  if (payload.size() - *pos < size) {
+    return false;
+  }
+
+  *field = payload.substr(*pos, size);
+  *pos += size;
+  return true;
+}
+
+bool GetField(const std::string& payload, size_t* pos, std::string* field) {
+  common::Optional<std::string> lfield;
+  if (!GetOptionalField(payload, pos, &lfield) || !lfield) {
+    return false;
+  }
+
+  *field = *lfield;
+  return true;
+}
+
+common::ErrnoError WriteFrame(fastotv::protocol::protocol_client_t* client, const std::string& payload) {
+  std::string frame;
+  frame.reserve(sizeof(uint32_t) + payload.size());
+  PutSize(payload.size(), &frame);
+  frame.append(payload);
+
+  const char* data = frame.data();
+  size_t left = frame.size();
+  while (left) {
+    size_t nwrite = 0;
+    common::ErrnoError err = client->SingleWrite(data, left, &nwrite);
+    if (err) {
+      return err;
+    }
+    data += nwrite;
+    left -= nwrite;
+  }
+  return common::ErrnoError();
+}
+
+common::ErrnoError ReadExactly(fastotv::protocol::protocol_client_t* client, char* out, size_t size) {
+  while (size) {
+    size_t nread = 0;
+    common::ErrnoError err = client->SingleRead(out, size, &nread);
+    if (err) {
+      return err;
+    }
+
+    if (nread == 0) {
+      return common::make_errno_error("Connection closed", ECONNRESET);
+    }
+    out += nread;
+    size -= nread;
+  }
+  return common::ErrnoError();
+}
+}  // namespace
+
+common::Error EncodeBinaryRequest(const fastotv::protocol::request_t& req, std::string* out) {
+  if (!out) {
+    return common::make_error_inval();
+  }
+
+  std::string payload;
+  payload.push_back(static_cast<char>(BINARY_REQUEST));
+  PutOptionalField(req.id, &payload);
+  PutField(req.method, &payload);
+  PutOptionalField(req.params, &payload);
+  *out = payload;
+  return common::Error();
+}
+
+common::Error EncodeBinaryResponse(const fastotv::protocol::response_t& resp, std::string* out) {
+  if (!out) {
+    return common::make_error_inval();
+  }
+
+  std::string payload;
+  if (resp.IsMessage()) {
+    payload.push_back(static_cast<char>(BINARY_RESPONSE_MESSAGE));
+    PutOptionalField(resp.id, &payload);
+    PutField(resp.message->result, &payload);
+  } else if (resp.IsError()) {
+    payload.push_back(static_cast<char>(BINARY_RESPONSE_ERROR));
+    PutOptionalField(resp.id, &payload);
+    PutField(resp.error->message, &payload);
+  } else {
+    return common::make_error_inval();
+  }
+
+  *out = payload;
+  return common::Error();
+}
+
+common::Error DecodeBinaryCommand(const std::string& payload,
+                                  fastotv::protocol::request_t** req,
+                                  fastotv::protocol::response_t** resp) {
+  if (!req || !resp || payload.empty()) {
+    return common::make_error_inval();
+  }
+
+  size_t pos = 1;
+  const uint8_t kind = static_cast<uint8_t>(payload[0]);
+  if (kind == BINARY_REQUEST) {
+    fastotv::protocol::request_t lreq;
+    if (!GetOptionalField(payload, &pos, &lreq.id) || !GetField(payload, &pos, &lreq.method) ||
+        !GetOptionalField(payload, &pos, &lreq.params)) {
+      return common::make_error("Invalid binary request");
+    }
+
+    *req = new fastotv::protocol::request_t(lreq);
+    return common::Error();
+  }
+
+  if (kind == BINARY_RESPONSE_MESSAGE || kind == BINARY_RESPONSE_ERROR) {
+    fastotv::protocol::sequance_id_t id;
+    std::string text;
+    if (!GetOptionalField(payload, &pos, &id) || !GetField(payload, &pos, &text)) {
+      return common::make_error("Invalid binary responce");
+    }
+
+    if (kind == BINARY_RESPONSE_MESSAGE) {
+      common::protocols::json_rpc::JsonRPCMessage message;
+      message.result = text;
+      *resp = new fastotv::protocol::response_t(fastotv::protocol::response_t::MakeMessage(id, message));
+    } else {
+      *resp = new fastotv::protocol::response_t(fastotv::protocol::response_t::MakeError(
+          id, common::protocols::json_rpc::JsonRPCError::MakeServerErrorFromText(text)));
+    }
+    return common::Error();
+  }
+
+  return common::make_error("Unknown binary command kind");
+}
+
+common::ErrnoError WritePipeRequest(fastotv::protocol::protocol_client_t* client,
+                                    const fastotv::protocol::request_t& req,
+                                    bool binary) {
+  if (!client) {
+    return common::make_errno_error_inval();
+  }
+
+  if (!binary) {
+    return client->WriteRequest(req);
+  }
+
+  std::string payload;
+  common::Error err = EncodeBinaryRequest(req, &payload);
+  if (err) {
+    return common::make_errno_error(err->GetDescription(), EINVAL);
+  }
+  return WriteFrame(client, payload);
+}
+
+common::ErrnoError WritePipeResponse(fastotv::protocol::protocol_client_t* client,
+                                     const fastotv::protocol::response_t& resp,
+                                     bool binary) {
+  if (!client) {
+    return common::make_errno_error_inval();
+  }
+
+  if (!binary) {
+    return client->WriteResponse(resp);
+  }
+
+  std::string payload;
+  common::Error err = EncodeBinaryResponse(resp, &payload);
+  if (err) {
+    return common::make_errno_error(err->GetDescription(), EINVAL);
+  }
+  return WriteFrame(client, payload);
+}
+
+common::ErrnoError ReadPipeCommand(fastotv::protocol::protocol_client_t* client,
+                                   bool binary,
+                                   fastotv::protocol::request_t** req,
+                                   fastotv::protocol::response_t** resp) {
+  if (!client || !req || !resp) {
+    return common::make_errno_error_inval();
+  }
+
+  if (!binary) {
+    std::string input_command;
+    common::ErrnoError err = client->ReadCommand(&input_command);
+    if (err) {
+      return err;
+    }
+
+    common::Error err_parse = common::protocols::json_rpc::ParseJsonRPC(input_command, req, resp);
+    if (err_parse) {
+      return common::make_errno_error(err_parse->GetDescription(), EAGAIN);
+    }
+    return common::ErrnoError();
+  }
+
+  char size_buff[sizeof(uint32_t)];
+  common::ErrnoError err = ReadExactly(client, size_buff, sizeof(size_buff));
+  if (err) {
+    return err;
+  }
+
+  const uint32_t size = GetSize(size_buff);
+  if (size == 0 || size > BINARY_PROTOCOL_MAX_FRAME_SIZE) {
+    return common::make_errno_error("Invalid binary frame size", EINVAL);
+  }
+
+  std::string payload(size, 0);
+  err = ReadExactly(client, &payload[0], size);
+  if (err) {
+    return err;
+  }
+
+  common::Error err_parse = DecodeBinaryCommand(payload, req, resp);
+  if (err_parse) {
+    return common::make_errno_error(err_parse->GetDescription(), EAGAIN);
+  }
+  return common::ErrnoError();
+}
+
+}  // namespace fastocloud
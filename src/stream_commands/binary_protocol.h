@@ -0,0 +1,48 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <fastotv/protocol/protocol.h>
+#include <fastotv/protocol/types.h>
+
+#define BINARY_PROTOCOL_MAX_FRAME_SIZE (16 * 1024 * 1024)
+
+namespace fastocloud {
+
+// Compact length prefixed encoding of json rpc structures for parent-child pipes.
+// Frame: payload size (uint32 BE) | kind (uint8) | fields, field: size (uint32 BE, ~0 if absent) | bytes.
+// Params and results are passed as is, so the envelope is not parsed and serialized again.
+common::Error EncodeBinaryRequest(const fastotv::protocol::request_t& req, std::string* out) WARN_UNUSED_RESULT;
+common::Error EncodeBinaryResponse(const fastotv::protocol::response_t& resp, std::string* out) WARN_UNUSED_RESULT;
+// payload without size prefix, one of req or resp allocated on success
+common::Error DecodeBinaryCommand(const std::string& payload,
+                                  fastotv::protocol::request_t** req,
+                                  fastotv::protocol::response_t** resp) WARN_UNUSED_RESULT;
+
+// binary frames if negotiated, json rpc otherwise
+common::ErrnoError WritePipeRequest(fastotv::protocol::protocol_client_t* client,
+                                    const fastotv::protocol::request_t& req,
+                                    bool binary) WARN_UNUSED_RESULT;
+common::ErrnoError WritePipeResponse(fastotv::protocol::protocol_client_t* client,
+                                     const fastotv::protocol::response_t& resp,
+                                     bool binary) WARN_UNUSED_RESULT;
+common::ErrnoError ReadPipeCommand(fastotv::protocol::protocol_client_t* client,
+                                   bool binary,
+                                   fastotv::protocol::request_t** req,
+                                   fastotv::protocol::response_t** resp) WARN_UNUSED_RESULT;
+
+}  // namespace fastocloud
@@ -16,6 +16,10 @@
 
 #define STOP_STREAM "stop"
 #define RESTART_STREAM "restart"
+#define UPDATE_CONFIG_STREAM "update_config"
+#define PROFILE_STREAM "profile"  // {"duration": 10}
+#define UNMUTE_OUTPUTS_STREAM "unmute_outputs"
+#define MUTE_OUTPUTS_STREAM "mute_outputs"  // source kept running, parked cod
 
 #define CHANGED_SOURCES_STREAM "changed_source_stream"
 #define STATISTIC_STREAM "statistic_stream"
@@ -28,6 +28,32 @@ fastotv::protocol::response_t StopStreamResponseSuccess(fastotv::protocol::sequa
                                                     common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage());
 }
 
+fastotv::protocol::response_t UpdateConfigStreamResponseSuccess(fastotv::protocol::sequance_id_t id) {
+  return fastotv::protocol::response_t::MakeMessage(id,
+                                                    common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage());
+}
+
+fastotv::protocol::response_t UpdateConfigStreamResponseFail(fastotv::protocol::sequance_id_t id,
+                                                             const std::string& error_text) {
+  return fastotv::protocol::response_t::MakeError(
+      id, common::protocols::json_rpc::JsonRPCError::MakeServerErrorFromText(error_text));
+}
+
+fastotv::protocol::response_t ProfileStreamResponseSuccess(fastotv::protocol::sequance_id_t id) {
+  return fastotv::protocol::response_t::MakeMessage(id,
+                                                    common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage());
+}
+
+fastotv::protocol::response_t UnmuteOutputsStreamResponseSuccess(fastotv::protocol::sequance_id_t id) {
+  return fastotv::protocol::response_t::MakeMessage(id,
+                                                    common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage());
+}
+
+fastotv::protocol::response_t MuteOutputsStreamResponseSuccess(fastotv::protocol::sequance_id_t id) {
+  return fastotv::protocol::response_t::MakeMessage(id,
+                                                    common::protocols::json_rpc::JsonRPCMessage::MakeSuccessMessage());
+}
+
 fastotv::protocol::request_t RestartStreamRequest(fastotv::protocol::sequance_id_t id) {
   fastotv::protocol::request_t req;
   req.id = id;
@@ -42,4 +68,36 @@ fastotv::protocol::request_t StopStreamRequest(fastotv::protocol::sequance_id_t
   return req;
 }
 
+fastotv::protocol::request_t UpdateConfigStreamRequest(fastotv::protocol::sequance_id_t id,
+                                                       const std::string& changes_json) {
+  fastotv::protocol::request_t req;
+  req.id = id;
+  req.method = UPDATE_CONFIG_STREAM;
+  req.params = changes_json;
+  return req;
+}
+
+fastotv::protocol::request_t ProfileStreamRequest(fastotv::protocol::sequance_id_t id,
+                                                  const std::string& profile_json) {
+  fastotv::protocol::request_t req;
+  req.id = id;
+  req.method = PROFILE_STREAM;
+  req.params = profile_json;
+  return req;
+}
+
+fastotv::protocol::request_t UnmuteOutputsStreamRequest(fastotv::protocol::sequance_id_t id) {
+  fastotv::protocol::request_t req;
+  req.id = id;
+  req.method = UNMUTE_OUTPUTS_STREAM;
+  return req;
+}
+
+fastotv::protocol::request_t MuteOutputsStreamRequest(fastotv::protocol::sequance_id_t id) {
+  fastotv::protocol::request_t req;
+  req.id = id;
+  req.method = MUTE_OUTPUTS_STREAM;
+  return req;
+}
+
 }  // namespace fastocloud
@@ -14,14 +14,27 @@
 
 #pragma once
 
+#include <string>
+
 #include <fastotv/protocol/types.h>
 
 namespace fastocloud {
 
 fastotv::protocol::request_t RestartStreamRequest(fastotv::protocol::sequance_id_t id);
 fastotv::protocol::request_t StopStreamRequest(fastotv::protocol::sequance_id_t id);
+fastotv::protocol::request_t UpdateConfigStreamRequest(fastotv::protocol::sequance_id_t id,
+                                                       const std::string& changes_json);  // changed fields only
+fastotv::protocol::request_t ProfileStreamRequest(fastotv::protocol::sequance_id_t id, const std::string& profile_json);
+fastotv::protocol::request_t UnmuteOutputsStreamRequest(fastotv::protocol::sequance_id_t id);
+fastotv::protocol::request_t MuteOutputsStreamRequest(fastotv::protocol::sequance_id_t id);
 
 fastotv::protocol::response_t RestartStreamResponseSuccess(fastotv::protocol::sequance_id_t id);
 fastotv::protocol::response_t StopStreamResponseSuccess(fastotv::protocol::sequance_id_t id);
+fastotv::protocol::response_t UpdateConfigStreamResponseSuccess(fastotv::protocol::sequance_id_t id);
+fastotv::protocol::response_t UpdateConfigStreamResponseFail(fastotv::protocol::sequance_id_t id,
+                                                             const std::string& error_text);
+fastotv::protocol::response_t ProfileStreamResponseSuccess(fastotv::protocol::sequance_id_t id);
+fastotv::protocol::response_t UnmuteOutputsStreamResponseSuccess(fastotv::protocol::sequance_id_t id);
+fastotv::protocol::response_t MuteOutputsStreamResponseSuccess(fastotv::protocol::sequance_id_t id);
 
 }  // namespace fastocloud
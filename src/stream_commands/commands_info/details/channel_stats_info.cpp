@@ -14,14 +14,24 @@
 
 #include "stream_commands/commands_info/details/channel_stats_info.h"
 
+#include <string.h>
+
 #include <string>
 
 #define FIELD_STATS_ID "id"
 #define FIELD_STATS_LAST_UPDATE_TIME "last_update_time"
 #define FIELD_STATS_PREV_TOTAL_BYTES "prev_total_bytes"
 #define FIELD_STATS_TOTAL_BYTES "total_bytes"
+#define FIELD_STATS_TOTAL_PACKETS "total_packets"
+#define FIELD_STATS_TOTAL_DROPS "drops"
 #define FIELD_STATS_BYTES_PER_SECOND "bps"
 #define FIELD_STATS_DESIRE_BYTES_PER_SECOND "dbps"
+#define FIELD_STATS_PEERS "peers"
+
+#define FIELD_PEER_ADDRESS "address"
+#define FIELD_PEER_RTT "rtt"
+#define FIELD_PEER_RETRANSMITS "retransmits"
+#define FIELD_PEER_DROPS "drops"
 
 namespace fastocloud {
 namespace details {
@@ -44,12 +54,33 @@ common::Error ChannelStatsInfo::SerializeFields(json_object* out) const {
   size_t prev_t = stats_.GetPrevTotalBytes();
   json_object_object_add(out, FIELD_STATS_PREV_TOTAL_BYTES, json_object_new_int64(prev_t));
 
-  size_t tot = stats_.GetPrevTotalBytes();
+  size_t tot = stats_.GetTotalBytes();
   json_object_object_add(out, FIELD_STATS_TOTAL_BYTES, json_object_new_int64(tot));
 
+  size_t packets = stats_.GetTotalPackets();
+  json_object_object_add(out, FIELD_STATS_TOTAL_PACKETS, json_object_new_int64(packets));
+
+  size_t drops = stats_.GetTotalDrops();
+  json_object_object_add(out, FIELD_STATS_TOTAL_DROPS, json_object_new_int64(drops));
+
   size_t bps = stats_.GetBps();
   json_object_object_add(out, FIELD_STATS_BYTES_PER_SECOND, json_object_new_int64(bps));
 
+  const size_t peers_count = stats_.GetPeersCount();
+  if (peers_count) {
+    json_object* jpeers = json_object_new_array();
+    for (size_t i = 0; i < peers_count; ++i) {
+      const PeerStats peer = stats_.GetPeer(i);
+      json_object* jpeer = json_object_new_object();
+      json_object_object_add(jpeer, FIELD_PEER_ADDRESS, json_object_new_string(peer.address));
+      json_object_object_add(jpeer, FIELD_PEER_RTT, json_object_new_int64(peer.rtt_msec));
+      json_object_object_add(jpeer, FIELD_PEER_RETRANSMITS, json_object_new_int64(peer.retransmits));
+      json_object_object_add(jpeer, FIELD_PEER_DROPS, json_object_new_int64(peer.drops));
+      json_object_array_add(jpeers, jpeer);
+    }
+    json_object_object_add(out, FIELD_STATS_PEERS, jpeers);
+  }
+
   common::media::DesireBytesPerSec dbps = stats_.GetDesireBytesPerSecond();
   std::string dbps_str = common::ConvertToString(dbps);
   json_object_object_add(out, FIELD_STATS_DESIRE_BYTES_PER_SECOND, json_object_new_string(dbps_str.c_str()));
@@ -65,12 +96,6 @@ common::Error ChannelStatsInfo::DoDeSerialize(json_object* serialized) {
   }
   ChannelStats stats(json_object_get_int64(jid));
 
-  json_object* jlut = nullptr;
-  json_bool jlut_exists = json_object_object_get_ex(serialized, FIELD_STATS_LAST_UPDATE_TIME, &jlut);
-  if (jlut_exists) {
-    stats.SetLastUpdateTime(json_object_get_int64(jlut));
-  }
-
   json_object* jptb = nullptr;
   json_bool jptb_exists = json_object_object_get_ex(serialized, FIELD_STATS_PREV_TOTAL_BYTES, &jptb);
   if (jptb_exists) {
@@ -83,6 +108,25 @@ common::Error ChannelStatsInfo::DoDeSerialize(json_object* serialized) {
     stats.SetTotalBytes(json_object_get_int64(jtb));
   }
 
+  json_object* jtp = nullptr;
+  json_bool jtp_exists = json_object_object_get_ex(serialized, FIELD_STATS_TOTAL_PACKETS, &jtp);
+  if (jtp_exists) {
+    stats.SetTotalPackets(json_object_get_int64(jtp));
+  }
+
+  json_object* jtd = nullptr;
+  json_bool jtd_exists = json_object_object_get_ex(serialized, FIELD_STATS_TOTAL_DROPS, &jtd);
+  if (jtd_exists) {
+    stats.SetTotalDrops(json_object_get_int64(jtd));
+  }
+
+  // after total bytes, setter updates time
+  json_object* jlut = nullptr;
+  json_bool jlut_exists = json_object_object_get_ex(serialized, FIELD_STATS_LAST_UPDATE_TIME, &jlut);
+  if (jlut_exists) {
+    stats.SetLastUpdateTime(json_object_get_int64(jlut));
+  }
+
   json_object* jbps = nullptr;
   json_bool jbps_exists = json_object_object_get_ex(serialized, FIELD_STATS_BYTES_PER_SECOND, &jbps);
   if (jbps_exists) {
@@ -96,6 +140,33 @@ common::Error ChannelStatsInfo::DoDeSerialize(json_object* serialized) {
     stats.SetDesireBytesPerSecond(dbps);
   }
 
+  json_object* jpeers = nullptr;
+  json_bool jpeers_exists = json_object_object_get_ex(serialized, FIELD_STATS_PEERS, &jpeers);
+  if (jpeers_exists) {
+    PeerStats peers[CHANNEL_STATS_MAX_PEERS];
+    memset(peers, 0, sizeof(peers));
+    size_t count = 0;
+    const size_t len = json_object_array_length(jpeers);
+    for (size_t i = 0; i < len && count < CHANNEL_STATS_MAX_PEERS; ++i) {
+      json_object* jpeer = json_object_array_get_idx(jpeers, i);
+      PeerStats* peer = &peers[count++];
+      json_object* jfield = nullptr;
+      if (json_object_object_get_ex(jpeer, FIELD_PEER_ADDRESS, &jfield)) {
+        strncpy(peer->address, json_object_get_string(jfield), sizeof(peer->address) - 1);
+      }
+      if (json_object_object_get_ex(jpeer, FIELD_PEER_RTT, &jfield)) {
+        peer->rtt_msec = json_object_get_int64(jfield);
+      }
+      if (json_object_object_get_ex(jpeer, FIELD_PEER_RETRANSMITS, &jfield)) {
+        peer->retransmits = json_object_get_int64(jfield);
+      }
+      if (json_object_object_get_ex(jpeer, FIELD_PEER_DROPS, &jfield)) {
+        peer->drops = json_object_get_int64(jfield);
+      }
+    }
+    stats.SetPeers(peers, count);
+  }
+
   *this = ChannelStatsInfo(stats);
   return common::Error();
 }
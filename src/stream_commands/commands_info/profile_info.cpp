@@ -0,0 +1,50 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "stream_commands/commands_info/profile_info.h"
+
+#define PROFILE_INFO_DURATION_FIELD "duration"
+
+namespace fastocloud {
+
+ProfileInfo::ProfileInfo() : base_class(), duration_(0) {}
+
+ProfileInfo::ProfileInfo(uint32_t duration) : base_class(), duration_(duration) {}
+
+uint32_t ProfileInfo::GetDuration() const {
+  return duration_;
+}
+
+common::Error ProfileInfo::SerializeFields(json_object* out) const {
+  json_object_object_add(out, PROFILE_INFO_DURATION_FIELD, json_object_new_int64(duration_));
+  return common::Error();
+}
+
+common::Error ProfileInfo::DoDeSerialize(json_object* serialized) {
+  json_object* jduration = nullptr;
+  json_bool jduration_exists = json_object_object_get_ex(serialized, PROFILE_INFO_DURATION_FIELD, &jduration);
+  if (!jduration_exists) {
+    return common::make_error_inval();
+  }
+
+  const int64_t duration = json_object_get_int64(jduration);
+  if (duration <= 0) {
+    return common::make_error_inval();
+  }
+
+  *this = ProfileInfo(duration);
+  return common::Error();
+}
+
+}  // namespace fastocloud
@@ -0,0 +1,38 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/serializer/json_serializer.h>
+
+namespace fastocloud {
+
+// {"duration": 10}, profile window of running stream in sec
+class ProfileInfo : public common::serializer::JsonSerializer<ProfileInfo> {
+ public:
+  typedef JsonSerializer<ProfileInfo> base_class;
+  ProfileInfo();
+  explicit ProfileInfo(uint32_t duration);
+
+  uint32_t GetDuration() const;
+
+ protected:
+  common::Error DoDeSerialize(json_object* serialized) override;
+  common::Error SerializeFields(json_object* out) const override;
+
+ private:
+  uint32_t duration_;
+};
+
+}  // namespace fastocloud
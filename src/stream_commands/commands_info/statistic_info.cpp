@@ -16,6 +16,9 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <string>
+
 #include "stream_commands/commands_info/details/channel_stats_info.h"
 
 #define STREAM_ID_FIELD "id"
@@ -28,9 +31,27 @@
 #define STREAM_START_TIME_FIELD "start_time"
 #define STREAM_TIMESTAMP_FIELD "timestamp"
 #define STREAM_IDLE_TIME_FIELD "idle_time"
+#define STREAM_TIMER_LAG_FIELD "timer_lag"
+#define STREAM_AUDIO_RMS_FIELD "audio_rms"
+#define STREAM_AUDIO_PEAK_FIELD "audio_peak"
+#define STREAM_AUDIO_SILENCE_FIELD "audio_silence"
+#define STREAM_AUDIO_LOUDNESS_FIELD "audio_loudness"
+#define STREAM_AUDIO_LOUDNESS_INTEGRATED_FIELD "audio_loudness_integrated"
+#define STREAM_VIDEO_BLACK_FIELD "video_black"
+#define STREAM_VIDEO_FREEZE_FIELD "video_freeze"
+#define STREAM_QUEUE_FILL_FIELD "queue_fill"
+#define STREAM_QUEUE_TIME_FIELD "queue_time"
+#define STREAM_QOS_EVENTS_FIELD "qos_events"
+#define STREAM_QOS_DROPPED_FIELD "qos_dropped"
+#define STREAM_GST_MEMORY_FIELD "gst_memory"
+#define STREAM_HEAP_MEMORY_FIELD "heap_memory"
+#define STREAM_ML_BACKEND_FIELD "ml_backend"
+#define STREAM_PROGRESS_FIELD "progress"
 
 #define STREAM_INPUT_STREAMS_FIELD "input_streams"
 #define STREAM_OUTPUT_STREAMS_FIELD "output_streams"
+#define STREAM_LATENCY_FIELD "latency"
+#define STREAM_STARTUP_FIELD "startup"
 
 namespace fastocloud {
 
@@ -93,6 +114,43 @@ common::Error StatisticInfo::SerializeFields(json_object* out) const {
   }
   json_object_object_add(out, STREAM_OUTPUT_STREAMS_FIELD, joutput_streams);
 
+  json_object* jlatency = nullptr;
+  for (size_t i = 0; i < LATENCY_STAGES_COUNT; ++i) {
+    const LatencyHistogram& hist = stream_struct_.latency[i];
+    if (!hist.GetCount()) {
+      continue;
+    }
+
+    if (!jlatency) {
+      jlatency = json_object_new_object();
+    }
+    json_object* jbuckets = json_object_new_array();
+    for (uint64_t bucket : hist.GetBuckets()) {
+      json_object_array_add(jbuckets, json_object_new_int64(bucket));
+    }
+    const std::string stage = common::ConvertToString(static_cast<LatencyStage>(i));
+    json_object_object_add(jlatency, stage.c_str(), jbuckets);
+  }
+  if (jlatency) {
+    json_object_object_add(out, STREAM_LATENCY_FIELD, jlatency);
+  }
+
+  json_object* jstartup = nullptr;
+  for (size_t i = 0; i < STARTUP_STAGES_COUNT; ++i) {
+    if (!stream_struct_.startup[i]) {
+      continue;
+    }
+
+    if (!jstartup) {
+      jstartup = json_object_new_object();
+    }
+    const std::string stage = common::ConvertToString(static_cast<StartupStage>(i));
+    json_object_object_add(jstartup, stage.c_str(), json_object_new_int64(stream_struct_.startup[i]));
+  }
+  if (jstartup) {
+    json_object_object_add(out, STREAM_STARTUP_FIELD, jstartup);
+  }
+
   json_object_object_add(out, STREAM_LOOP_START_TIME_FIELD, json_object_new_int64(stream_struct_.loop_start_time));
   json_object_object_add(out, STREAM_RSS_FIELD, json_object_new_int64(rss_bytes_));
   json_object_object_add(out, STREAM_CPU_FIELD, json_object_new_double(cpu_load_));
@@ -101,6 +159,23 @@ common::Error StatisticInfo::SerializeFields(json_object* out) const {
   json_object_object_add(out, STREAM_START_TIME_FIELD, json_object_new_int64(stream_struct_.start_time));
   json_object_object_add(out, STREAM_TIMESTAMP_FIELD, json_object_new_int64(timestamp_));
   json_object_object_add(out, STREAM_IDLE_TIME_FIELD, json_object_new_int64(stream_struct_.idle_time));
+  json_object_object_add(out, STREAM_TIMER_LAG_FIELD, json_object_new_int64(stream_struct_.timer_lag));
+  json_object_object_add(out, STREAM_AUDIO_RMS_FIELD, json_object_new_int(stream_struct_.audio_rms));
+  json_object_object_add(out, STREAM_AUDIO_PEAK_FIELD, json_object_new_int(stream_struct_.audio_peak));
+  json_object_object_add(out, STREAM_AUDIO_SILENCE_FIELD, json_object_new_int64(stream_struct_.audio_silence));
+  json_object_object_add(out, STREAM_AUDIO_LOUDNESS_FIELD, json_object_new_double(stream_struct_.audio_loudness));
+  json_object_object_add(out, STREAM_AUDIO_LOUDNESS_INTEGRATED_FIELD,
+                         json_object_new_double(stream_struct_.audio_loudness_integrated));
+  json_object_object_add(out, STREAM_VIDEO_BLACK_FIELD, json_object_new_int64(stream_struct_.video_black));
+  json_object_object_add(out, STREAM_VIDEO_FREEZE_FIELD, json_object_new_int64(stream_struct_.video_freeze));
+  json_object_object_add(out, STREAM_QUEUE_FILL_FIELD, json_object_new_int(stream_struct_.queue_fill));
+  json_object_object_add(out, STREAM_QUEUE_TIME_FIELD, json_object_new_int64(stream_struct_.queue_time));
+  json_object_object_add(out, STREAM_QOS_EVENTS_FIELD, json_object_new_int64(stream_struct_.qos_events));
+  json_object_object_add(out, STREAM_QOS_DROPPED_FIELD, json_object_new_int64(stream_struct_.qos_dropped));
+  json_object_object_add(out, STREAM_GST_MEMORY_FIELD, json_object_new_int64(stream_struct_.gst_memory));
+  json_object_object_add(out, STREAM_HEAP_MEMORY_FIELD, json_object_new_int64(stream_struct_.heap_memory));
+  json_object_object_add(out, STREAM_ML_BACKEND_FIELD, json_object_new_int(stream_struct_.ml_backend));
+  json_object_object_add(out, STREAM_PROGRESS_FIELD, json_object_new_int(stream_struct_.progress));
   return common::Error();
 }
 
@@ -210,8 +285,97 @@ common::Error StatisticInfo::DoDeSerialize(json_object* serialized) {
     idle_time = json_object_get_int64(jidle_time);
   }
 
+  fastotv::timestamp_t timer_lag = 0;
+  json_object* jtimer_lag = nullptr;
+  json_bool jtimer_lag_exists = json_object_object_get_ex(serialized, STREAM_TIMER_LAG_FIELD, &jtimer_lag);
+  if (jtimer_lag_exists) {
+    timer_lag = json_object_get_int64(jtimer_lag);
+  }
+
   StreamStruct strct(cid, type, st, input, output, start_time, loop_start_time, restarts);
   strct.idle_time = idle_time;
+  strct.timer_lag = timer_lag;
+
+  json_object* jaudio = nullptr;
+  if (json_object_object_get_ex(serialized, STREAM_AUDIO_RMS_FIELD, &jaudio)) {
+    strct.audio_rms = json_object_get_int(jaudio);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_AUDIO_PEAK_FIELD, &jaudio)) {
+    strct.audio_peak = json_object_get_int(jaudio);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_AUDIO_SILENCE_FIELD, &jaudio)) {
+    strct.audio_silence = json_object_get_int64(jaudio);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_AUDIO_LOUDNESS_FIELD, &jaudio)) {
+    strct.audio_loudness = json_object_get_double(jaudio);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_AUDIO_LOUDNESS_INTEGRATED_FIELD, &jaudio)) {
+    strct.audio_loudness_integrated = json_object_get_double(jaudio);
+  }
+
+  json_object* jvideo = nullptr;
+  if (json_object_object_get_ex(serialized, STREAM_VIDEO_BLACK_FIELD, &jvideo)) {
+    strct.video_black = json_object_get_int64(jvideo);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_VIDEO_FREEZE_FIELD, &jvideo)) {
+    strct.video_freeze = json_object_get_int64(jvideo);
+  }
+
+  json_object* jpipeline = nullptr;
+  if (json_object_object_get_ex(serialized, STREAM_QUEUE_FILL_FIELD, &jpipeline)) {
+    strct.queue_fill = json_object_get_int(jpipeline);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_QUEUE_TIME_FIELD, &jpipeline)) {
+    strct.queue_time = json_object_get_int64(jpipeline);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_QOS_EVENTS_FIELD, &jpipeline)) {
+    strct.qos_events = json_object_get_int64(jpipeline);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_QOS_DROPPED_FIELD, &jpipeline)) {
+    strct.qos_dropped = json_object_get_int64(jpipeline);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_GST_MEMORY_FIELD, &jpipeline)) {
+    strct.gst_memory = json_object_get_int64(jpipeline);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_HEAP_MEMORY_FIELD, &jpipeline)) {
+    strct.heap_memory = json_object_get_int64(jpipeline);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_ML_BACKEND_FIELD, &jpipeline)) {
+    strct.ml_backend = json_object_get_int(jpipeline);
+  }
+  if (json_object_object_get_ex(serialized, STREAM_PROGRESS_FIELD, &jpipeline)) {
+    strct.progress = json_object_get_int(jpipeline);
+  }
+
+  json_object* jlatency = nullptr;
+  json_bool jlatency_exists = json_object_object_get_ex(serialized, STREAM_LATENCY_FIELD, &jlatency);
+  if (jlatency_exists) {
+    for (size_t i = 0; i < LATENCY_STAGES_COUNT; ++i) {
+      const std::string stage = common::ConvertToString(static_cast<LatencyStage>(i));
+      json_object* jbuckets = nullptr;
+      if (!json_object_object_get_ex(jlatency, stage.c_str(), &jbuckets)) {
+        continue;
+      }
+
+      LatencyHistogram::buckets_t buckets = LatencyHistogram::buckets_t();
+      size_t len = std::min(json_object_array_length(jbuckets), static_cast<size_t>(LatencyHistogram::buckets_count));
+      for (size_t j = 0; j < len; ++j) {
+        buckets[j] = json_object_get_int64(json_object_array_get_idx(jbuckets, j));
+      }
+      strct.latency[i].SetBuckets(buckets);
+    }
+  }
+
+  json_object* jstartup = nullptr;
+  if (json_object_object_get_ex(serialized, STREAM_STARTUP_FIELD, &jstartup)) {
+    for (size_t i = 0; i < STARTUP_STAGES_COUNT; ++i) {
+      const std::string stage = common::ConvertToString(static_cast<StartupStage>(i));
+      json_object* jstage = nullptr;
+      if (json_object_object_get_ex(jstartup, stage.c_str(), &jstage)) {
+        strct.startup[i] = json_object_get_int64(jstage);
+      }
+    }
+  }
   *this = StatisticInfo(strct, cpu_load, rss, time);
   return common::Error();
 }
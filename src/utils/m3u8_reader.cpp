@@ -14,171 +14,348 @@
 
 #include "utils/m3u8_reader.h"
 
-#include <regex>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include <string>
 
-#include <common/convert2string.h>
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #define CHUNK_EXT ".ts"
-#define CHUNK_EXT_RE "\\" CHUNK_EXT
 
 #define M3U8_HEADER "#EXTM3U"
-#define M3U8_VERSION "#EXT-X-VERSION:%d"
-#define M3U8_ALLOW_CACHE "#EXT-X-ALLOW-CACHE:%s"
-#define M3U8_MEDIA_SEQUENCE "#EXT-X-MEDIA-SEQUENCE:%d"
-#define M3U8_TARGET_DURATION "#EXT-X-TARGETDURATION:%d"
-#define M3U8_CHUNK_HEADER "#EXTINF:%lf"
+#define M3U8_VERSION "#EXT-X-VERSION:"
+#define M3U8_ALLOW_CACHE "#EXT-X-ALLOW-CACHE:"
+#define M3U8_MEDIA_SEQUENCE "#EXT-X-MEDIA-SEQUENCE:"
+#define M3U8_TARGET_DURATION "#EXT-X-TARGETDURATION:"
+#define M3U8_CHUNK_HEADER "#EXTINF:"
 #define M3U8_FOOTER "#EXT-X-ENDLIST"
+#define M3U8_DISCONTINUITY "#EXT-X-DISCONTINUITY"
 #define SECOND 1000000000
-#define MAX_LINE 255
+#define MAX_NUMBER 64
+#define MAX_TAIL 64
 
 namespace {
 
-bool GetNonEmptyLine(FILE* file, std::string* line) {
-  if (!line) {
+// not owned slice of file content
+struct Token {
+  const char* data;
+  size_t size;
+
+  bool Equals(const char* str) const {
+    const size_t len = strlen(str);
+    return size == len && memcmp(data, str, len) == 0;
+  }
+
+  bool StartsWith(const char* str) const {
+    const size_t len = strlen(str);
+    return size >= len && memcmp(data, str, len) == 0;
+  }
+
+  Token Suffix(size_t pos) const { return {data + pos, size - pos}; }
+};
+
+bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+bool is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+class Tokenizer {
+ public:
+  Tokenizer(const char* data, size_t size) : cur_(data), end_(data + size) {}
+
+  bool NextNonEmptyLine(Token* line) {
+    while (cur_ < end_) {
+      const char* start = cur_;
+      const char* stop = static_cast<const char*>(memchr(cur_, '\n', end_ - cur_));
+      if (!stop) {
+        stop = end_;
+      }
+      cur_ = stop == end_ ? end_ : stop + 1;
+
+      while (start < stop && is_space(*start)) {
+        start++;
+      }
+      while (stop > start && is_space(*(stop - 1))) {
+        stop--;
+      }
+      if (start != stop) {
+        *line = {start, static_cast<size_t>(stop - start)};
+        return true;
+      }
+    }
     return false;
   }
 
-  char t[MAX_LINE] = {0};
-  while (true) {
-    if (!fgets(t, MAX_LINE, file)) {
+ private:
+  const char* cur_;
+  const char* const end_;
+};
+
+bool parse_uint64(Token token, uint64_t* out) {
+  if (token.size == 0 || token.size > 20) {
+    return false;
+  }
+
+  uint64_t result = 0;
+  for (size_t i = 0; i < token.size; ++i) {
+    if (!is_digit(token.data[i])) {
       return false;
     }
+    result = result * 10 + (token.data[i] - '0');
+  }
+  *out = result;
+  return true;
+}
 
-    auto it = std::find_if(std::begin(t), std::end(t), [](char c) { return !std::isspace(c); });
-    if (it != std::end(t) && *it != 0) {
-      *line = t;
-      return true;
+bool parse_int(Token token, int* out) {
+  uint64_t result;
+  if (!parse_uint64(token, &result) || result > INT32_MAX) {
+    return false;
+  }
+  *out = static_cast<int>(result);
+  return true;
+}
+
+bool parse_double(Token token, double* out) {
+  if (token.size == 0 || token.size >= MAX_NUMBER) {
+    return false;
+  }
+
+  char buff[MAX_NUMBER];
+  memcpy(buff, token.data, token.size);
+  buff[token.size] = 0;
+  char* end = nullptr;
+  double result = strtod(buff, &end);
+  if (end != buff + token.size) {
+    return false;
+  }
+  *out = result;
+  return true;
+}
+
+// [A-Za-z0-9_]*?([0-9]+).ts
+bool parse_chunk_index(Token line, uint64_t* index) {
+  const size_t ext_len = sizeof(CHUNK_EXT) - 1;
+  if (line.size <= ext_len || memcmp(line.data + line.size - ext_len, CHUNK_EXT, ext_len) != 0) {
+    return false;
+  }
+
+  const size_t name_len = line.size - ext_len;
+  size_t digits_start = name_len;
+  while (digits_start > 0 && is_digit(line.data[digits_start - 1])) {
+    digits_start--;
+  }
+
+  for (size_t i = 0; i < digits_start; ++i) {
+    char c = line.data[i];
+    if (!(is_digit(c) || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_')) {
+      return false;
     }
   }
+
+  return parse_uint64({line.data + digits_start, name_len - digits_start}, index);
 }
 
-void RemoveTrailingSpaces(std::string* str) {
-  if (!str || str->empty()) {
-    return;
+// read only view of whole file
+class FileContent {
+ public:
+  explicit FileContent(const std::string& path) : data_(nullptr), size_(0), mapped_(false), buffer_() {
+#if defined(OS_POSIX)
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+      return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = static_cast<const char*>(data);
+        size_ = st.st_size;
+        mapped_ = true;
+      }
+    }
+    close(fd);
+#else
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+      return;
+    }
+
+    char buff[4096];
+    size_t readed;
+    while ((readed = fread(buff, 1, sizeof(buff), file)) > 0) {
+      buffer_.append(buff, readed);
+    }
+    fclose(file);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+  }
+
+  ~FileContent() {
+#if defined(OS_POSIX)
+    if (mapped_) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+  }
+
+  bool IsValid() const { return data_ != nullptr; }
+  const char* GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+  bool mapped_;
+  std::string buffer_;
+};
+
+bool is_end_list(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  char tail[MAX_TAIL];
+  size_t readed = 0;
+  if (fseek(file, -MAX_TAIL, SEEK_END) != 0) {
+    rewind(file);  // small file
   }
-  while (std::isspace(str->back())) {
-    str->pop_back();
+  readed = fread(tail, 1, sizeof(tail), file);
+  fclose(file);
+
+  while (readed > 0 && is_space(tail[readed - 1])) {
+    readed--;
   }
+
+  const size_t footer_len = sizeof(M3U8_FOOTER) - 1;
+  return readed >= footer_len && memcmp(tail + readed - footer_len, M3U8_FOOTER, footer_len) == 0;
 }
+
 }  // namespace
 
 namespace fastocloud {
 namespace utils {
 
-M3u8Reader::M3u8Reader() : version_(-1), allow_cache_(false), media_sequence_(-1), target_duration_(-1), chunks_() {}
+M3u8Reader::M3u8Reader()
+    : version_(-1), allow_cache_(false), media_sequence_(-1), target_duration_(-1), ended_(false), chunks_() {}
 
 bool M3u8Reader::Parse(const std::string& path) {
-  FILE* file = fopen(path.c_str(), "r");
-  return ParseFile(file);
+  Clear();
+
+  const FileContent content(path);
+  if (!content.IsValid()) {
+    return false;
+  }
+
+  return ParseData(content.GetData(), content.GetSize());
 }
 
 bool M3u8Reader::Parse(const common::file_system::ascii_file_string_path& path) {
-  const std::string filepath = path.GetPath();
-  FILE* file = fopen(filepath.c_str(), "r");
-  return ParseFile(file);
+  return Parse(path.GetPath());
 }
 
-bool M3u8Reader::ParseFile(FILE* file) {
-  static const std::regex m3u8_version("^#EXT-X-VERSION:([0-9]+)$");
-  static const std::regex m3u8_allow_cache("^#EXT-X-ALLOW-CACHE:([A-Z]+)$");
-  static const std::regex m3u8_media_sequence("^#EXT-X-MEDIA-SEQUENCE:([0-9]+)$");
-  static const std::regex m3u8_target_duration("^#EXT-X-TARGETDURATION:([0-9]+)$");
+bool M3u8Reader::IsEndList(const std::string& path) {
+  return is_end_list(path);
+}
 
-  Clear();
+bool M3u8Reader::IsEndList(const common::file_system::ascii_file_string_path& path) {
+  return is_end_list(path.GetPath());
+}
 
-  if (!file) {
-    return false;
-  }
+bool M3u8Reader::ParseData(const char* data, size_t size) {
+  Tokenizer tokenizer(data, size);
+  Token line;
+
+  // header
+  while (true) {
+    if (!tokenizer.NextNonEmptyLine(&line)) {
+      return false;
+    }
 
-  std::string line;
-  std::smatch match;
-  while (GetNonEmptyLine(file, &line)) {
-    RemoveTrailingSpaces(&line);
-    if (line == M3U8_HEADER) {
+    if (line.Equals(M3U8_HEADER)) {
       continue;
-    } else if (std::regex_match(line, match, m3u8_version)) {
-      int version;
-      if (!common::ConvertFromString(match.str(1), &version)) {
+    } else if (line.StartsWith(M3U8_VERSION)) {
+      if (!parse_int(line.Suffix(sizeof(M3U8_VERSION) - 1), &version_)) {
         return false;
       }
-      version_ = version;
-    } else if (std::regex_match(line, match, m3u8_allow_cache)) {
-      const std::string allow_cache = match.str(1);
-      if (allow_cache == "YES") {
+    } else if (line.StartsWith(M3U8_ALLOW_CACHE)) {
+      Token allow_cache = line.Suffix(sizeof(M3U8_ALLOW_CACHE) - 1);
+      if (allow_cache.Equals("YES")) {
         allow_cache_ = true;
-      } else if (allow_cache == "NO") {
+      } else if (allow_cache.Equals("NO")) {
         allow_cache_ = false;
       } else {
         return false;
       }
-      continue;
-    } else if (std::regex_match(line, match, m3u8_media_sequence)) {
-      int media_sequence;
-      if (!common::ConvertFromString(match.str(1), &media_sequence)) {
+    } else if (line.StartsWith(M3U8_MEDIA_SEQUENCE)) {
+      if (!parse_int(line.Suffix(sizeof(M3U8_MEDIA_SEQUENCE) - 1), &media_sequence_)) {
         return false;
       }
-      media_sequence_ = media_sequence;
-    } else if (std::regex_match(line, match, m3u8_target_duration)) {
-      int target_duration;
-      if (!common::ConvertFromString(match.str(1), &target_duration)) {
+    } else if (line.StartsWith(M3U8_TARGET_DURATION)) {
+      if (!parse_int(line.Suffix(sizeof(M3U8_TARGET_DURATION) - 1), &target_duration_)) {
         return false;
       }
-      target_duration_ = target_duration;
     } else {
-      long off = ftell(file);
-      fseek(file, off - line.length() - 1, SEEK_SET);
-      return ParseChunks(file);
+      break;
     }
   }
 
-  return false;
-}
-
-bool M3u8Reader::ParseChunks(FILE* file) {
-  if (!file) {
-    return false;
-  }
-
-  std::string header_line, chunk_line;
+  // chunks, line already holds first chunk header
   while (true) {
-    if (!GetNonEmptyLine(file, &header_line)) {
-      return !chunks_.empty();
+    if (line.Equals(M3U8_FOOTER)) {
+      ended_ = true;
+      return true;
     }
-    RemoveTrailingSpaces(&header_line);
 
-    if (header_line == M3U8_FOOTER) {
-      return true;
+    // timestamps reset between chunks, vod merged from parts
+    if (line.Equals(M3U8_DISCONTINUITY)) {
+      if (!tokenizer.NextNonEmptyLine(&line)) {
+        return !chunks_.empty();
+      }
+      continue;
     }
 
-    if (!GetNonEmptyLine(file, &chunk_line)) {
+    // #EXTINF:<duration>,
+    if (!line.StartsWith(M3U8_CHUNK_HEADER) || line.data[line.size - 1] != ',') {
       return false;
     }
-    RemoveTrailingSpaces(&chunk_line);
 
+    Token duration_token = line.Suffix(sizeof(M3U8_CHUNK_HEADER) - 1);
+    duration_token.size--;
     double duration = 0;
-    uint64_t index = 0;
-
-    static const std::regex m3u8_chunk_header_re("^#EXTINF:([0-9.]+),$");
-    static const std::regex m3u8_chunk_re("^[A-Za-z0-9_]*?([0-9]+)" CHUNK_EXT_RE "$");
-
-    std::smatch header_match;
-    if (!std::regex_match(header_line, header_match, m3u8_chunk_header_re)) {
+    if (!parse_double(duration_token, &duration)) {
       return false;
     }
-    if (!common::ConvertFromString(header_match.str(1), &duration)) {
-      return false;
-    }
-    std::smatch chunk_match;
-    if (!std::regex_match(chunk_line, chunk_match, m3u8_chunk_re)) {
+
+    Token chunk_line;
+    if (!tokenizer.NextNonEmptyLine(&chunk_line)) {
       return false;
     }
-    if (!common::ConvertFromString(chunk_match.str(1), &index)) {
+
+    uint64_t index = 0;
+    if (!parse_chunk_index(chunk_line, &index)) {
       return false;
     }
 
-    ChunkInfo chunk(chunk_line, static_cast<uint64_t>(duration * SECOND), index);
-    chunks_.push_back(chunk);
+    chunks_.emplace_back(std::string(chunk_line.data, chunk_line.size), static_cast<uint64_t>(duration * SECOND),
+                         index);
+    if (!tokenizer.NextNonEmptyLine(&line)) {
+      return !chunks_.empty();
+    }
   }
 }
 
@@ -198,15 +375,28 @@ int M3u8Reader::GetTargetDuration() const {
   return target_duration_;
 }
 
-std::vector<ChunkInfo> M3u8Reader::GetChunks() const {
+bool M3u8Reader::IsEnded() const {
+  return ended_;
+}
+
+const M3u8Reader::chunks_t& M3u8Reader::GetChunks() const {
   return chunks_;
 }
 
+M3u8Reader::const_iterator M3u8Reader::begin() const {
+  return chunks_.begin();
+}
+
+M3u8Reader::const_iterator M3u8Reader::end() const {
+  return chunks_.end();
+}
+
 void M3u8Reader::Clear() {
   version_ = -1;
   allow_cache_ = false;
   media_sequence_ = -1;
   target_duration_ = -1;
+  ended_ = false;
 
   chunks_.clear();
 }
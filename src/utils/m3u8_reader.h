@@ -26,29 +26,40 @@ namespace utils {
 
 class M3u8Reader {
  public:
+  typedef std::vector<ChunkInfo> chunks_t;
+  typedef chunks_t::const_iterator const_iterator;
+
   M3u8Reader();
 
   bool Parse(const std::string& path);
   bool Parse(const common::file_system::ascii_file_string_path& path);
 
+  // checks only tail of file for #EXT-X-ENDLIST
+  static bool IsEndList(const std::string& path);
+  static bool IsEndList(const common::file_system::ascii_file_string_path& path);
+
   int GetVersion() const;
   bool IsAllowCache() const;
   int GetMediaSequence() const;
   int GetTargetDuration() const;
-  std::vector<ChunkInfo> GetChunks() const;
+  bool IsEnded() const;  // #EXT-X-ENDLIST found
+
+  const chunks_t& GetChunks() const;
+  const_iterator begin() const;
+  const_iterator end() const;
 
  private:
   void Clear();
 
-  bool ParseFile(FILE* file);
-  bool ParseChunks(FILE* file);
+  bool ParseData(const char* data, size_t size);
 
   int version_;
   bool allow_cache_;
   int media_sequence_;
   int target_duration_;
+  bool ended_;
 
-  std::vector<ChunkInfo> chunks_;
+  chunks_t chunks_;
 };
 
 }  // namespace utils
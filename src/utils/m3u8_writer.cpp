@@ -14,6 +14,11 @@
 
 #include "utils/m3u8_writer.h"
 
+#include <errno.h>
+#include <stdio.h>
+
+#include <string>
+
 #include "utils/chunk_info.h"
 
 namespace fastocloud {
@@ -25,6 +30,42 @@ common::ErrnoError M3u8Writer::Open(const common::file_system::ascii_file_string
   return file_.Open(file_path, flags);
 }
 
+common::ErrnoError M3u8Writer::OpenForAppend(const common::file_system::ascii_file_string_path& file_path,
+                                             uint64_t first_index,
+                                             size_t target_duration,
+                                             const std::vector<ChunkInfo>& chunks) {
+  const std::string path = file_path.GetPath();
+  const std::string tmp_path = path + ".tmp";
+  remove(tmp_path.c_str());
+
+  M3u8Writer tmp;
+  common::ErrnoError err = tmp.Open(common::file_system::ascii_file_string_path(tmp_path),
+                                    common::file_system::File::FLAG_CREATE | common::file_system::File::FLAG_WRITE);
+  if (err) {
+    return err;
+  }
+
+  err = tmp.WriteHeader(first_index, target_duration);
+  for (size_t i = 0; !err && i < chunks.size(); ++i) {
+    err = tmp.WriteLine(chunks[i]);
+  }
+
+  common::ErrnoError close_err = tmp.Close();
+  if (err) {
+    return err;
+  }
+  if (close_err) {
+    return close_err;
+  }
+
+  if (rename(tmp_path.c_str(), path.c_str()) == -1) {
+    return common::make_errno_error(errno);
+  }
+
+  return Open(file_path, common::file_system::File::FLAG_OPEN | common::file_system::File::FLAG_WRITE |
+                             common::file_system::File::FLAG_APPEND);
+}
+
 common::ErrnoError M3u8Writer::WriteHeader(uint64_t first_index, size_t target_duration) {
   size_t writed;
   return file_.WriteBuffer(common::MemSPrintf("#EXTM3U\n#EXT-X-MEDIA-SEQUENCE:%llu\n#EXT-X-ALLOW-"
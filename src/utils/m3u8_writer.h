@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <common/file_system/file.h>
 
 namespace fastocloud {
@@ -27,6 +29,11 @@ class M3u8Writer {
 
   common::ErrnoError Open(const common::file_system::ascii_file_string_path& file_path,
                           uint32_t flags) WARN_UNUSED_RESULT;
+  // writes header and chunks into temp file, renames it over file_path and keeps it open for appending
+  common::ErrnoError OpenForAppend(const common::file_system::ascii_file_string_path& file_path,
+                                   uint64_t first_index,
+                                   size_t target_duration,
+                                   const std::vector<ChunkInfo>& chunks) WARN_UNUSED_RESULT;
 
   common::ErrnoError WriteHeader(uint64_t first_index, size_t target_duration) WARN_UNUSED_RESULT;
   common::ErrnoError WriteLine(const ChunkInfo& chunks) WARN_UNUSED_RESULT;
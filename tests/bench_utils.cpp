@@ -0,0 +1,69 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bench_utils.h"
+
+#include <stdio.h>
+
+#include <sstream>
+
+#if defined(BENCH_WITH_GSTREAMER)
+#include <gst/gst.h>
+#endif
+
+namespace fastocloud {
+namespace bench {
+
+std::vector<std::string> split(const std::string& line, char delim) {
+  std::vector<std::string> result;
+  std::stringstream stream(line);
+  std::string item;
+  while (std::getline(stream, item, delim)) {
+    if (!item.empty()) {
+      result.push_back(item);
+    }
+  }
+  return result;
+}
+
+double cpu_time_sec(const struct rusage& usage) {
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+bool parse_key_values(int argc, char** argv, key_values_t* args) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const size_t eq = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) {
+      fprintf(stderr, "Invalid argument: %s\n", arg.c_str());
+      return false;
+    }
+
+    args->push_back(std::make_pair(arg.substr(2, eq - 2), arg.substr(eq + 1)));
+  }
+  return true;
+}
+
+#if defined(BENCH_WITH_GSTREAMER)
+GstElement* add_element(GstElement* pipeline, const char* factory) {
+  GstElement* element = gst_element_factory_make(factory, nullptr);
+  if (element) {
+    gst_bin_add(GST_BIN(pipeline), element);
+  }
+  return element;
+}
+#endif
+
+}  // namespace bench
+}  // namespace fastocloud
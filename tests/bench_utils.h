@@ -0,0 +1,49 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <sys/resource.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(BENCH_WITH_GSTREAMER)
+typedef struct _GstElement GstElement;
+#endif
+
+// helpers shared by benchmarks in tests/stream and tests/server
+
+namespace fastocloud {
+namespace bench {
+
+typedef std::vector<std::pair<std::string, std::string>> key_values_t;
+
+// non empty items of delimited list
+std::vector<std::string> split(const std::string& line, char delim);
+
+// user plus system time
+double cpu_time_sec(const struct rusage& usage);
+
+// command line of --key=value arguments, prints error and returns false on argument of other form
+bool parse_key_values(int argc, char** argv, key_values_t* args);
+
+#if defined(BENCH_WITH_GSTREAMER)
+// created element added into pipeline, nullptr if factory is not installed
+GstElement* add_element(GstElement* pipeline, const char* factory);
+#endif
+
+}  // namespace bench
+}  // namespace fastocloud
@@ -0,0 +1,567 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/select.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <json-c/json.h>
+
+#include <common/convert2string.h>
+#include <common/net/net.h>
+#include <common/time.h>
+
+#include "base/config_fields.h"
+#include "base/constants.h"
+
+#include "server/config.h"
+#include "server/daemon/client.h"
+#include "server/daemon/commands.h"
+
+#include "stream_commands/commands_info/statistic_info.h"
+
+#include "../bench_utils.h"
+
+// usage: bench_channel_density [--config=/etc/fastocloud.conf] [--types=encode,relay] [--relay_input=udp://...]
+//                              [--output=udp|hls] [--start=1] [--step=1] [--max=64] [--settle=20] [--window=20]
+//                              [--bitrate_drop=0.2] [--timer_lag=250]
+// talks to running service, starts K channels, ramps K until outputs degrade, prints json report into stdout
+
+#define DEFAULT_OUTPUT "udp"
+#define DEFAULT_START 1
+#define DEFAULT_STEP 1
+#define DEFAULT_MAX 64
+#define DEFAULT_SETTLE_SEC 20
+#define DEFAULT_WINDOW_SEC 20
+#define DEFAULT_BITRATE_DROP 0.2
+#define DEFAULT_TIMER_LAG_MSEC 250
+#define UDP_OUTPUT_BASE_PORT 17000
+#define HLS_OUTPUT_ROOT "/tmp/bench_channel_density"
+#define FEEDBACK_ROOT "/tmp/bench_channel_density/feedback"
+
+#define STATISTIC_BATCH_FULL_FIELD "full"
+#define STATISTIC_BATCH_STREAMS_FIELD "streams"
+
+namespace {
+
+struct BenchOptions {
+  std::string config_path;
+  std::vector<std::string> types;
+  std::string relay_input;
+  std::string output;
+  size_t start;
+  size_t step;
+  size_t max;
+  int settle_sec;
+  int window_sec;
+  double bitrate_drop;
+  fastotv::timestamp_t timer_lag;
+};
+
+// latest statistic of channel, merged from delta batches
+struct ChannelState {
+  ChannelState() : json(nullptr), updated(false) {}
+
+  json_object* json;
+  bool updated;
+};
+
+struct StepResult {
+  StepResult()
+      : channels(0),
+        mean_bps(0),
+        min_bps(0),
+        mean_rss(0),
+        mean_heap(0),
+        restarts(0),
+        not_playing(0),
+        max_timer_lag(0),
+        degraded(false) {}
+
+  size_t channels;
+  size_t mean_bps;  // output per channel
+  size_t min_bps;
+  size_t mean_rss;   // bytes per channel, compares allocators and heap_release_interval
+  size_t mean_heap;  // malloc bytes in use per channel
+  size_t restarts;     // during window
+  size_t not_playing;  // samples out of PLAYING status, frozen or waiting outputs drop frames
+  fastotv::timestamp_t max_timer_lag;
+  bool degraded;
+  std::string reason;
+};
+
+bool parse_options(int argc, char** argv, BenchOptions* options) {
+  options->config_path = CONFIG_PATH;
+  options->types = {"encode"};
+  options->output = DEFAULT_OUTPUT;
+  options->start = DEFAULT_START;
+  options->step = DEFAULT_STEP;
+  options->max = DEFAULT_MAX;
+  options->settle_sec = DEFAULT_SETTLE_SEC;
+  options->window_sec = DEFAULT_WINDOW_SEC;
+  options->bitrate_drop = DEFAULT_BITRATE_DROP;
+  options->timer_lag = DEFAULT_TIMER_LAG_MSEC;
+  fastocloud::bench::key_values_t args;
+  if (!fastocloud::bench::parse_key_values(argc, argv, &args)) {
+    return false;
+  }
+
+  for (const auto& arg : args) {
+    const std::string& key = arg.first;
+    const std::string& value = arg.second;
+    if (key == "config") {
+      options->config_path = value;
+    } else if (key == "types") {
+      options->types = fastocloud::bench::split(value, ',');
+    } else if (key == "relay_input") {
+      options->relay_input = value;
+    } else if (key == "output") {
+      options->output = value;
+    } else if (key == "start") {
+      options->start = strtoul(value.c_str(), nullptr, 10);
+    } else if (key == "step") {
+      options->step = strtoul(value.c_str(), nullptr, 10);
+    } else if (key == "max") {
+      options->max = strtoul(value.c_str(), nullptr, 10);
+    } else if (key == "settle") {
+      options->settle_sec = atoi(value.c_str());
+    } else if (key == "window") {
+      options->window_sec = atoi(value.c_str());
+    } else if (key == "bitrate_drop") {
+      options->bitrate_drop = atof(value.c_str());
+    } else if (key == "timer_lag") {
+      options->timer_lag = atoll(value.c_str());
+    } else {
+      fprintf(stderr, "Unknown argument: --%s\n", key.c_str());
+      return false;
+    }
+  }
+
+  for (const std::string& type : options->types) {
+    if (type != "encode" && type != "relay") {
+      fprintf(stderr, "Unknown stream type: %s\n", type.c_str());
+      return false;
+    }
+    if (type == "relay" && options->relay_input.empty()) {
+      fprintf(stderr, "Relay channels need --relay_input, test sources are generated only by encode\n");
+      return false;
+    }
+  }
+
+  if (options->output != "udp" && options->output != "hls") {
+    fprintf(stderr, "Unknown output: %s\n", options->output.c_str());
+    return false;
+  }
+  return !options->types.empty() && options->start > 0 && options->step > 0 && options->max >= options->start &&
+         options->settle_sec >= 0 && options->window_sec > 0;
+}
+
+std::string make_channel_id(const std::string& type, size_t index) {
+  return "bench_" + type + "_" + std::to_string(index);
+}
+
+json_object* make_channel_config(const BenchOptions& options, const std::string& type, size_t index) {
+  const std::string sid = make_channel_id(type, index);
+  json_object* jconfig = json_object_new_object();
+  json_object_object_add(jconfig, ID_FIELD, json_object_new_string(sid.c_str()));
+  json_object_object_add(jconfig, TYPE_FIELD, json_object_new_int(type == "relay" ? fastotv::RELAY : fastotv::ENCODE));
+  const std::string feedback_dir = std::string(FEEDBACK_ROOT) + "/" + sid;
+  json_object_object_add(jconfig, FEEDBACK_DIR_FIELD, json_object_new_string(feedback_dir.c_str()));
+
+  json_object* jinput = json_object_new_object();
+  json_object_object_add(jinput, "id", json_object_new_int(0));
+  const std::string input = type == "relay" ? options.relay_input : std::string(TEST_URL);
+  json_object_object_add(jinput, "uri", json_object_new_string(input.c_str()));
+  json_object* jinputs = json_object_new_array();
+  json_object_array_add(jinputs, jinput);
+  json_object* jinput_urls = json_object_new_object();
+  json_object_object_add(jinput_urls, "urls", jinputs);
+  json_object_object_add(jconfig, INPUT_FIELD, jinput_urls);
+
+  json_object* joutput = json_object_new_object();
+  json_object_object_add(joutput, "id", json_object_new_int(0));
+  if (options.output == "hls") {
+    const std::string http_root = std::string(HLS_OUTPUT_ROOT) + "/" + sid;
+    const std::string uri = "http://localhost/" + sid + "/master.m3u8";
+    json_object_object_add(joutput, "uri", json_object_new_string(uri.c_str()));
+    json_object_object_add(joutput, "http_root", json_object_new_string(http_root.c_str()));
+  } else {
+    const std::string uri = "udp://127.0.0.1:" + std::to_string(UDP_OUTPUT_BASE_PORT + index);
+    json_object_object_add(joutput, "uri", json_object_new_string(uri.c_str()));
+  }
+  json_object* joutputs = json_object_new_array();
+  json_object_array_add(joutputs, joutput);
+  json_object* joutput_urls = json_object_new_object();
+  json_object_object_add(joutput_urls, "urls", joutputs);
+  json_object_object_add(jconfig, OUTPUT_FIELD, joutput_urls);
+  return jconfig;
+}
+
+common::ErrnoError write_request(fastocloud::server::ProtocoledDaemonClient* client,
+                                 const std::string& method,
+                                 json_object* jparams) {
+  fastotv::protocol::request_t req;
+  req.id = client->NextRequestID();
+  req.method = method;
+  req.params = std::string(json_object_to_json_string_ext(jparams, JSON_C_TO_STRING_PLAIN));
+  json_object_put(jparams);
+  return client->WriteRequest(req);
+}
+
+common::ErrnoError start_channel(fastocloud::server::ProtocoledDaemonClient* client,
+                                 const BenchOptions& options,
+                                 const std::string& type,
+                                 size_t index) {
+  json_object* jparams = json_object_new_object();
+  json_object_object_add(jparams, "config", make_channel_config(options, type, index));
+  return write_request(client, DAEMON_START_STREAM, jparams);
+}
+
+common::ErrnoError stop_channel(fastocloud::server::ProtocoledDaemonClient* client,
+                                const std::string& type,
+                                size_t index) {
+  json_object* jparams = json_object_new_object();
+  json_object_object_add(jparams, "id", json_object_new_string(make_channel_id(type, index).c_str()));
+  return write_request(client, DAEMON_STOP_STREAM, jparams);
+}
+
+void apply_statistic(json_object* jstat, bool full, std::map<std::string, ChannelState>* channels) {
+  json_object* jid = nullptr;
+  if (!json_object_object_get_ex(jstat, ID_FIELD, &jid)) {
+    return;
+  }
+
+  const std::string sid = json_object_get_string(jid);
+  auto it = channels->find(sid);
+  if (it == channels->end()) {
+    return;  // not our channel
+  }
+
+  ChannelState* state = &it->second;
+  if (full || !state->json) {
+    if (state->json) {
+      json_object_put(state->json);
+    }
+    state->json = json_object_get(jstat);
+  } else {
+    json_object* merged = json_tokener_parse(json_object_to_json_string_ext(state->json, JSON_C_TO_STRING_PLAIN));
+    json_object_object_foreach(jstat, key, val) { json_object_object_add(merged, key, json_object_get(val)); }
+    json_object_put(state->json);
+    state->json = merged;
+  }
+  state->updated = true;
+}
+
+void handle_broadcast(const fastotv::protocol::request_t* req, std::map<std::string, ChannelState>* channels) {
+  if (!req->params) {
+    return;
+  }
+
+  json_object* jparams = json_tokener_parse(req->params->c_str());
+  if (!jparams) {
+    return;
+  }
+
+  if (req->method == STREAM_STATISTIC_STREAM) {
+    apply_statistic(jparams, true, channels);
+  } else if (req->method == STREAM_STATISTIC_STREAMS) {
+    json_object* jfull = nullptr;
+    json_object* jstreams = nullptr;
+    const bool full = json_object_object_get_ex(jparams, STATISTIC_BATCH_FULL_FIELD, &jfull) &&
+                      json_object_get_boolean(jfull);
+    if (json_object_object_get_ex(jparams, STATISTIC_BATCH_STREAMS_FIELD, &jstreams)) {
+      for (size_t i = 0; i < json_object_array_length(jstreams); ++i) {
+        apply_statistic(json_object_array_get_idx(jstreams, i), full, channels);
+      }
+    }
+  }
+  json_object_put(jparams);
+}
+
+// reads daemon commands until deadline, responses on our requests ignored
+bool pump(fastocloud::server::ProtocoledDaemonClient* client,
+          fastotv::timestamp_t deadline,
+          std::map<std::string, ChannelState>* channels) {
+  const int fd = client->GetInfo().fd();
+  for (fastotv::timestamp_t now = common::time::current_utc_mstime(); now < deadline;
+       now = common::time::current_utc_mstime()) {
+    fd_set rfds;
+    FD_ZERO(&rfds);
+    FD_SET(fd, &rfds);
+    const fastotv::timestamp_t left = deadline - now;
+    struct timeval tv = {static_cast<time_t>(left / 1000), static_cast<suseconds_t>((left % 1000) * 1000)};
+    const int res = select(fd + 1, &rfds, nullptr, nullptr, &tv);
+    if (res < 0) {
+      return false;
+    }
+    if (res == 0) {
+      continue;
+    }
+
+    std::string input_command;
+    common::ErrnoError err = client->ReadCommand(&input_command);
+    if (err) {
+      fprintf(stderr, "Read from service failed: %s\n", err->GetDescription().c_str());
+      return false;
+    }
+
+    fastotv::protocol::request_t* req = nullptr;
+    fastotv::protocol::response_t* resp = nullptr;
+    common::Error err_parse = common::protocols::json_rpc::ParseJsonRPC(input_command, &req, &resp);
+    if (err_parse) {
+      continue;
+    }
+
+    if (req) {
+      handle_broadcast(req, channels);
+      delete req;
+    } else if (resp) {
+      if (resp->IsError()) {
+        fprintf(stderr, "Service error: %s\n", input_command.c_str());
+      }
+      delete resp;
+    }
+  }
+  return true;
+}
+
+bool take_sample(const ChannelState& state, fastocloud::StreamStruct* sample, size_t* rss) {
+  if (!state.json) {
+    return false;
+  }
+
+  fastocloud::StatisticInfo info;
+  common::Error err = info.DeSerialize(state.json);
+  if (err) {
+    return false;
+  }
+
+  *sample = info.GetStreamStruct();
+  *rss = info.GetRssBytes();
+  return true;
+}
+
+size_t output_bps(const fastocloud::StreamStruct& sample) {
+  size_t bps = 0;
+  for (const fastocloud::ChannelStats& out : sample.output) {
+    bps += out.GetBps();
+  }
+  return bps;
+}
+
+bool measure_step(fastocloud::server::ProtocoledDaemonClient* client,
+                  const BenchOptions& options,
+                  std::map<std::string, ChannelState>* channels,
+                  StepResult* result) {
+  if (!pump(client, common::time::current_utc_mstime() + options.settle_sec * 1000, channels)) {
+    return false;
+  }
+
+  std::map<std::string, size_t> start_restarts;
+  for (auto it = channels->begin(); it != channels->end(); ++it) {
+    fastocloud::StreamStruct sample;
+    size_t rss = 0;
+    start_restarts[it->first] = take_sample(it->second, &sample, &rss) ? sample.restarts : 0;
+  }
+
+  std::map<std::string, size_t> bps_sum;
+  std::map<std::string, size_t> bps_count;
+  std::map<std::string, size_t> restarts;
+  size_t rss_sum = 0;
+  size_t heap_sum = 0;
+  size_t memory_count = 0;
+  const fastotv::timestamp_t window_end = common::time::current_utc_mstime() + options.window_sec * 1000;
+  while (common::time::current_utc_mstime() < window_end) {
+    if (!pump(client, std::min(window_end, common::time::current_utc_mstime() + 1000), channels)) {
+      return false;
+    }
+
+    for (auto it = channels->begin(); it != channels->end(); ++it) {
+      fastocloud::StreamStruct sample;
+      size_t rss = 0;
+      if (!it->second.updated || !take_sample(it->second, &sample, &rss)) {
+        continue;
+      }
+
+      it->second.updated = false;
+      if (sample.status != fastocloud::PLAYING) {
+        result->not_playing++;
+      }
+      result->max_timer_lag = std::max(result->max_timer_lag, sample.timer_lag);
+      restarts[it->first] = sample.restarts - start_restarts[it->first];
+      bps_sum[it->first] += output_bps(sample);
+      bps_count[it->first]++;
+      rss_sum += rss;
+      heap_sum += sample.heap_memory;
+      memory_count++;
+    }
+  }
+
+  size_t total_bps = 0;
+  result->min_bps = SIZE_MAX;
+  for (auto it = channels->begin(); it != channels->end(); ++it) {
+    const size_t count = bps_count[it->first];
+    const size_t bps = count ? bps_sum[it->first] / count : 0;  // silent channel counts as zero output
+    total_bps += bps;
+    result->min_bps = std::min(result->min_bps, bps);
+    result->restarts += restarts[it->first];
+  }
+  result->channels = channels->size();
+  result->mean_bps = channels->empty() ? 0 : total_bps / channels->size();
+  result->mean_rss = memory_count ? rss_sum / memory_count : 0;
+  result->mean_heap = memory_count ? heap_sum / memory_count : 0;
+  if (result->min_bps == SIZE_MAX) {
+    result->min_bps = 0;
+  }
+  return true;
+}
+
+void check_degraded(const BenchOptions& options, size_t baseline_bps, StepResult* result) {
+  if (result->restarts) {
+    result->degraded = true;
+    result->reason = "restarts";
+  } else if (result->not_playing) {
+    result->degraded = true;
+    result->reason = "not_playing";
+  } else if (result->max_timer_lag > options.timer_lag) {
+    result->degraded = true;
+    result->reason = "timer_lag";
+  } else if (result->min_bps < baseline_bps * (1.0 - options.bitrate_drop)) {
+    result->degraded = true;
+    result->reason = "bitrate";
+  }
+}
+
+void print_step(const StepResult& step, bool last) {
+  printf("        {\"channels\": %zu, \"mean_bps\": %zu, \"min_bps\": %zu, \"mean_rss\": %zu, \"mean_heap\": %zu, "
+         "\"restarts\": %zu, \"not_playing\": %zu, "
+         "\"max_timer_lag_msec\": %lld, \"degraded\": %s, \"reason\": \"%s\"}%s\n",
+         step.channels, step.mean_bps, step.min_bps, step.mean_rss, step.mean_heap, step.restarts, step.not_playing,
+         static_cast<long long>(step.max_timer_lag), step.degraded ? "true" : "false", step.reason.c_str(),
+         last ? "" : ",");
+}
+
+bool run_type(fastocloud::server::ProtocoledDaemonClient* client,
+              const BenchOptions& options,
+              const std::string& type) {
+  std::map<std::string, ChannelState> channels;
+  std::vector<StepResult> steps;
+  size_t baseline_bps = 0;
+  size_t sustained = 0;
+  bool ok = true;
+  for (size_t k = options.start; k <= options.max; k += options.step) {
+    while (channels.size() < k) {
+      const size_t index = channels.size();
+      common::ErrnoError err = start_channel(client, options, type, index);
+      if (err) {
+        fprintf(stderr, "Start channel failed: %s\n", err->GetDescription().c_str());
+        ok = false;
+        break;
+      }
+      channels[make_channel_id(type, index)] = ChannelState();
+    }
+
+    StepResult step;
+    if (!ok || !measure_step(client, options, &channels, &step)) {
+      ok = false;
+      break;
+    }
+
+    if (steps.empty()) {
+      baseline_bps = step.mean_bps;
+    }
+    check_degraded(options, baseline_bps, &step);
+    steps.push_back(step);
+    if (step.degraded) {
+      break;
+    }
+    sustained = k;
+  }
+
+  printf("    {\"type\": \"%s\", \"max_channels\": %zu, \"baseline_bps\": %zu,\n      \"steps\": [\n", type.c_str(),
+         sustained, baseline_bps);
+  for (size_t i = 0; i < steps.size(); ++i) {
+    print_step(steps[i], i + 1 == steps.size());
+  }
+  printf("      ]}");
+  fflush(stdout);
+
+  for (size_t i = 0; i < channels.size(); ++i) {
+    common::ErrnoError err = stop_channel(client, type, i);
+    if (err) {
+      fprintf(stderr, "Stop channel failed: %s\n", err->GetDescription().c_str());
+    }
+  }
+  for (auto it = channels.begin(); it != channels.end(); ++it) {
+    if (it->second.json) {
+      json_object_put(it->second.json);
+    }
+  }
+  // let service reap children before next type
+  return pump(client, common::time::current_utc_mstime() + options.settle_sec * 1000, &channels) && ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  if (!parse_options(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+
+  fastocloud::server::Config config;
+  common::ErrnoError err = fastocloud::server::load_config_from_file(options.config_path, &config);
+  if (err) {
+    fprintf(stderr, "Can't read config %s: %s\n", options.config_path.c_str(), err->GetDescription().c_str());
+    return EXIT_FAILURE;
+  }
+
+  if (!config.license_key) {
+    fprintf(stderr, "Service config without license key, stream commands need activated client\n");
+    return EXIT_FAILURE;
+  }
+
+  common::net::socket_info client_info;
+  err = common::net::connect(config.host, common::net::ST_SOCK_STREAM, nullptr, &client_info);
+  if (err) {
+    fprintf(stderr, "Can't connect to %s: %s\n", common::ConvertToString(config.host).c_str(),
+            err->GetDescription().c_str());
+    return EXIT_FAILURE;
+  }
+
+  fastocloud::server::ProtocoledDaemonClient client(nullptr, client_info);
+  err = client.ActivateMe(*config.license_key);
+  if (err) {
+    fprintf(stderr, "Activation failed: %s\n", err->GetDescription().c_str());
+    ignore_result(client.Close());
+    return EXIT_FAILURE;
+  }
+
+  bool ok = true;
+  printf("{\n  \"output\": \"%s\", \"settle_sec\": %d, \"window_sec\": %d,\n  \"results\": [\n", options.output.c_str(),
+         options.settle_sec, options.window_sec);
+  for (size_t i = 0; i < options.types.size() && ok; ++i) {
+    ok = run_type(&client, options, options.types[i]);
+    printf("%s\n", i + 1 == options.types.size() || !ok ? "" : ",");
+  }
+  printf("  ]\n}\n");
+  ignore_result(client.Close());
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
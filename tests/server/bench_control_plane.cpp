@@ -0,0 +1,273 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <common/convert2string.h>
+#include <common/macros.h>
+#include <common/protocols/json_rpc/json_rpc.h>
+#include <common/sprintf.h>
+
+#include <json-c/json_object.h>
+#include <json-c/json_tokener.h>
+
+#include <fastotv/protocol/types.h>
+
+#include "base/config_fields.h"
+#include "base/stream_config.h"
+#include "base/stream_config_parse.h"
+
+#include "server/daemon/commands.h"
+#include "server/links_holder_ts.h"
+#include "server/options/options.h"
+
+#include "stream_commands/commands_info/statistic_info.h"
+
+#include "utils/m3u8_reader.h"
+
+#include "../bench_utils.h"
+
+// usage: bench_control_plane [--iterations=10000] [--links=1000] [--chunks=8640] [--filter=name]
+// times control plane hot paths of daemon on generated data of production size, prints json report into stdout
+
+#define DEFAULT_ITERATIONS 10000
+#define DEFAULT_LINKS 1000
+#define DEFAULT_CHUNKS 8640  // day of 10 sec vod chunks
+#define INPUTS_COUNT 2
+#define OUTPUTS_COUNT 4
+#define PLAYLIST_PATH "/tmp/bench_control_plane.m3u8"
+
+namespace {
+
+struct BenchOptions {
+  size_t iterations;
+  size_t links;
+  size_t chunks;
+  std::string filter;
+};
+
+bool parse_options(int argc, char** argv, BenchOptions* options) {
+  options->iterations = DEFAULT_ITERATIONS;
+  options->links = DEFAULT_LINKS;
+  options->chunks = DEFAULT_CHUNKS;
+  fastocloud::bench::key_values_t args;
+  if (!fastocloud::bench::parse_key_values(argc, argv, &args)) {
+    return false;
+  }
+
+  for (const auto& arg : args) {
+    const std::string& key = arg.first;
+    const std::string& value = arg.second;
+    if (key == "iterations") {
+      options->iterations = strtoul(value.c_str(), nullptr, 10);
+    } else if (key == "links") {
+      options->links = strtoul(value.c_str(), nullptr, 10);
+    } else if (key == "chunks") {
+      options->chunks = strtoul(value.c_str(), nullptr, 10);
+    } else if (key == "filter") {
+      options->filter = value;
+    } else {
+      fprintf(stderr, "Unknown argument: --%s\n", key.c_str());
+      return false;
+    }
+  }
+  return options->iterations > 0 && options->links > 0 && options->chunks > 0;
+}
+
+// encoding stream of typical node, several inputs and outputs
+std::string make_stream_json(size_t index) {
+  std::string inputs;
+  for (size_t i = 0; i < INPUTS_COUNT; ++i) {
+    inputs += common::MemSPrintf("%s{\"id\": %lu, \"uri\": \"udp://239.0.%lu.%lu:1234\"}", i ? ", " : "", i,
+                                 index % 256, i);
+  }
+  std::string outputs;
+  for (size_t i = 0; i < OUTPUTS_COUNT; ++i) {
+    outputs += common::MemSPrintf("%s{\"id\": %lu, \"uri\": \"rtmp://live.example.com/app/stream_%lu_%lu\"}",
+                                  i ? ", " : "", i, index, i);
+  }
+  return common::MemSPrintf(
+      "{\"" ID_FIELD "\": \"stream_%lu\", \"" TYPE_FIELD "\": %d, \"" INPUT_FIELD "\": [%s], "
+      "\"" OUTPUT_FIELD "\": [%s], \"" VIDEO_CODEC_FIELD "\": \"x264enc\", "
+      "\"" AUDIO_CODEC_FIELD "\": \"faac\", \"" SIZE_FIELD "\": \"1280x720\", \"" VIDEO_BIT_RATE_FIELD "\": 4000000, "
+      "\"" AUDIO_BIT_RATE_FIELD "\": 128000, \"" FRAME_RATE_FIELD "\": 25, \"" VOLUME_FIELD "\": 1.0, "
+      "\"" AUDIO_CHANNELS_FIELD "\": 2, \"" LOG_LEVEL_FIELD "\": 6}",
+      index, static_cast<int>(fastotv::ENCODE), inputs.c_str(), outputs.c_str());
+}
+
+fastocloud::StatisticInfo make_statistic(size_t index) {
+  fastocloud::StreamStruct str;
+  str.id = common::MemSPrintf("stream_%lu", index);
+  str.type = fastotv::ENCODE;
+  str.status = fastocloud::PLAYING;
+  for (size_t i = 0; i < INPUTS_COUNT; ++i) {
+    fastocloud::ChannelStats input(i);
+    input.SetBps(4 * 1000 * 1000);
+    str.input.push_back(input);
+  }
+  for (size_t i = 0; i < OUTPUTS_COUNT; ++i) {
+    fastocloud::ChannelStats output(i);
+    output.SetBps(4 * 1000 * 1000);
+    str.output.push_back(output);
+  }
+  return fastocloud::StatisticInfo(str, 25.5, 200 * 1024 * 1024, 1600000000000);
+}
+
+bool write_playlist(size_t chunks) {
+  FILE* file = fopen(PLAYLIST_PATH, "w");
+  if (!file) {
+    return false;
+  }
+
+  fprintf(file, "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-MEDIA-SEQUENCE:0\n#EXT-X-TARGETDURATION:10\n");
+  for (size_t i = 0; i < chunks; ++i) {
+    fprintf(file, "#EXTINF:10.000,\n%lu.ts\n", i);
+  }
+  fprintf(file, "#EXT-X-ENDLIST\n");
+  fclose(file);
+  return true;
+}
+
+class Report {
+ public:
+  explicit Report(const BenchOptions& options) : options_(options), count_(0), sink_(0) {
+    printf("{\n  \"iterations\": %lu,\n  \"results\": [", options_.iterations);
+  }
+
+  ~Report() { printf("\n  ]\n}\n"); }
+
+  // func returns something derived from its work, so calls are not optimized out
+  template <typename F>
+  void Measure(const std::string& name, F func) {
+    if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+      return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < options_.iterations; ++i) {
+      sink_ += func(i);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    printf("%s\n    {\"name\": \"%s\", \"ns_per_op\": %.1f, \"ops_per_sec\": %.0f}", count_ ? "," : "", name.c_str(),
+           ns / options_.iterations, ns > 0 ? options_.iterations * 1e9 / ns : 0);
+    fflush(stdout);
+    count_++;
+  }
+
+  size_t GetSink() const { return sink_; }
+
+ private:
+  const BenchOptions options_;
+  size_t count_;
+  size_t sink_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  if (!parse_options(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+
+  const std::string stream_json = make_stream_json(0);
+  const fastocloud::StreamConfig stream_config = fastocloud::MakeConfigFromJson(stream_json);
+  if (!stream_config) {
+    fprintf(stderr, "Invalid stream config: %s\n", stream_json.c_str());
+    return EXIT_FAILURE;
+  }
+
+  const fastocloud::StatisticInfo stat = make_statistic(0);
+  std::string stat_json;
+  common::Error err = stat.SerializeToString(&stat_json);
+  if (err) {
+    fprintf(stderr, "Statistic not serialized: %s\n", err->GetDescription().c_str());
+    return EXIT_FAILURE;
+  }
+  const std::string rpc_json = "{\"jsonrpc\": \"2.0\", \"method\": \"" STREAM_STATISTIC_STREAM
+                               "\", \"id\": \"00000001\", \"params\": " + stat_json + "}";
+
+  fastocloud::server::LinksHolderTS links;
+  std::vector<common::file_system::ascii_directory_string_path> paths;
+  for (size_t i = 0; i < options.links; ++i) {
+    paths.push_back(common::file_system::ascii_directory_string_path(common::MemSPrintf("/var/www/html/vods/%lu/", i)));
+    links.Insert(paths.back(), stream_config);
+  }
+
+  if (!write_playlist(options.chunks)) {
+    fprintf(stderr, "Playlist not written: %s\n", PLAYLIST_PATH);
+    return EXIT_FAILURE;
+  }
+
+  {
+    Report report(options);
+    report.Measure("ParseJsonRPC", [&rpc_json](size_t) {
+      fastotv::protocol::request_t* req = nullptr;
+      fastotv::protocol::response_t* resp = nullptr;
+      common::Error err_parse = common::protocols::json_rpc::ParseJsonRPC(rpc_json, &req, &resp);
+      const size_t res = err_parse ? 0 : 1;
+      delete req;
+      delete resp;
+      return res;
+    });
+    report.Measure("StatisticInfo::SerializeToString", [&stat](size_t) {
+      std::string json;
+      ignore_result(stat.SerializeToString(&json));
+      return json.size();
+    });
+    report.Measure("StatisticInfo::DeSerialize", [&stat_json](size_t) {
+      json_object* jstat = json_tokener_parse(stat_json.c_str());
+      fastocloud::StatisticInfo parsed;
+      common::Error err_des = parsed.DeSerialize(jstat);
+      json_object_put(jstat);
+      return err_des ? 0 : parsed.GetStreamStruct().output.size();
+    });
+    report.Measure("ParseJson", [&stat_json](size_t) {
+      json_object* jstat = fastocloud::ParseJson(stat_json);
+      const size_t res = jstat ? 1 : 0;
+      json_object_put(jstat);
+      return res;
+    });
+    report.Measure("MakeConfigFromJson", [&stream_json](size_t) {
+      return fastocloud::MakeConfigFromJson(stream_json) ? 1 : 0;
+    });
+    report.Measure("options::ValidateConfig", [&stream_config](size_t) {
+      return fastocloud::server::options::ValidateConfig(stream_config) ? 0 : 1;
+    });
+    report.Measure("MakeStreamInfo", [&stream_config](size_t) {
+      fastocloud::StreamInfo sha;
+      std::string feedback_dir;
+      common::logging::LOG_LEVEL logs_level;
+      common::ErrnoError errn = fastocloud::MakeStreamInfo(stream_config, false, &sha, &feedback_dir, &logs_level);
+      return errn ? 0 : sha.output.size();
+    });
+    report.Measure("LinksHolderTS::Find", [&links, &paths](size_t i) {
+      return links.Find(paths[i % paths.size()]) ? 1 : 0;
+    });
+    report.Measure("M3u8Reader::Parse", [](size_t) {
+      fastocloud::utils::M3u8Reader reader;
+      return reader.Parse(std::string(PLAYLIST_PATH)) ? reader.GetChunks().size() : 0;
+    });
+  }
+  unlink(PLAYLIST_PATH);
+  return EXIT_SUCCESS;
+}
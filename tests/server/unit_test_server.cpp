@@ -12,13 +12,60 @@
     along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <string.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#if defined(OS_LINUX)
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
 #include "gtest/gtest.h"
 
+#include "base/chunks_index.h"
 #include "base/config_fields.h"
 #include "base/constants.h"
+#include "base/gst_constants.h"
+#include "base/stream_config.h"
 #include "base/stream_config_parse.h"
+#include "base/utils.h"
 
+#include "server/admission_control.h"
+#include "server/cods_warm_pool.h"
+#include "server/base/http_cache.h"
+#include "server/base/http_range.h"
+#include "server/base/http_request_buffer.h"
+#include "server/config_workers.h"
+#include "server/cpu_affinity_pool.h"
+#include "server/daemon/commands_info/service/details/proc_reader.h"
+#include "server/daemon/commands_info/service/sync_info.h"
+#include "server/daemon/commands_info/stream/batch_info.h"
+#include "server/daemon/commands_info/stream/update_config_info.h"
+#include "server/file_expirer.h"
+#include "server/gpu_stats/encoder_pool.h"
+#include "server/hls_retention.h"
+#include "server/job_queue.h"
+#include "server/startup_stats.h"
+#include "server/links_holder_ts.h"
+#include "server/metrics_registry.h"
 #include "server/options/options.h"
+#include "server/output_trash.h"
+#include "server/packet_ingest.h"
+#include "server/segment_cache.h"
+#include "server/statistic_batch.h"
+#include "server/stats_history.h"
+#include "server/stream_cgroups.h"
+#include "server/streams_status.h"
+#include "server/vods/client.h"
+#include "server/vods/handler.h"
+#include "server/vods/ts_index.h"
 
 namespace {
 const char kTimeshiftRecorderConfig[] = R"({
@@ -29,6 +76,51 @@ const char kTimeshiftRecorderConfig[] = R"({
   })";
 }
 
+TEST(Options, parse_json_reused) {
+  json_object* obj = fastocloud::ParseJson(kTimeshiftRecorderConfig);
+  ASSERT_TRUE(obj);
+  json_object* jid = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(obj, "id", &jid));
+  ASSERT_STREQ(json_object_get_string(jid), "test_1");
+  json_object_put(obj);
+
+  ASSERT_FALSE(fastocloud::ParseJson("{\"id\": "));
+  ASSERT_FALSE(fastocloud::ParseJson(""));
+  obj = fastocloud::ParseJson("42");
+  ASSERT_TRUE(obj);
+  ASSERT_EQ(json_object_get_int(obj), 42);
+  json_object_put(obj);
+  obj = fastocloud::ParseJson("{\"id\": \"a\"}");
+  ASSERT_TRUE(obj);
+  json_object_put(obj);
+}
+
+TEST(Options, utc_beyond_int) {
+  fastocloud::StreamConfig args =
+      fastocloud::MakeConfigFromJson("{\"" TIMESHIFT_START_UTC_FIELD "\": 4102444800, \"" FRAME_RATE_FIELD "\": 25}");
+  ASSERT_TRUE(args);
+  time_t utc = 0;
+  ASSERT_TRUE(fastocloud::GetTimeFromValue(args->Find(TIMESHIFT_START_UTC_FIELD), &utc));
+  ASSERT_EQ(utc, 4102444800);
+  ASSERT_TRUE(fastocloud::GetTimeFromValue(args->Find(FRAME_RATE_FIELD), &utc));
+  ASSERT_EQ(utc, 25);
+  ASSERT_FALSE(fastocloud::server::options::ValidateConfig(args));
+
+  std::string json;
+  ASSERT_TRUE(fastocloud::MakeJsonFromConfig(args, &json));
+  ASSERT_NE(json.find("4102444800"), std::string::npos);
+}
+
+TEST(Options, audio_only_stream) {
+  fastocloud::StreamConfig args = fastocloud::MakeConfigFromJson("{\"" HAVE_VIDEO_FIELD "\": false}");
+  ASSERT_TRUE(args);
+  ASSERT_TRUE(fastocloud::IsAudioOnlyStream(args));
+  args = fastocloud::MakeConfigFromJson("{\"" HAVE_VIDEO_FIELD "\": false, \"" HAVE_AUDIO_FIELD "\": false}");
+  ASSERT_FALSE(fastocloud::IsAudioOnlyStream(args));
+  args = fastocloud::MakeConfigFromJson("{\"id\": \"a\"}");
+  ASSERT_FALSE(fastocloud::IsAudioOnlyStream(args));
+}
+
 TEST(Options, logo_path) {
   std::string cfg = "{\"" LOGO_FIELD "\" : {\"path\": \"file:///home/user/logo.png\"}}";
   fastocloud::StreamConfig args = fastocloud::MakeConfigFromJson(cfg);
@@ -53,3 +145,1050 @@ TEST(Options, cfgs) {
   ASSERT_FALSE(err);
   ASSERT_EQ(args->GetSize(), 4);
 }
+
+TEST(StatisticBatch, coalesce_and_delta) {
+  fastocloud::StreamStruct str;
+  str.id = "test_1";
+  fastocloud::server::StatisticBatch batch(true);
+  ASSERT_TRUE(batch.IsEmpty());
+  batch.Add(fastocloud::StatisticInfo(str, 1, 100, 10));
+  batch.Add(fastocloud::StatisticInfo(str, 2, 100, 20));
+  ASSERT_FALSE(batch.IsEmpty());
+
+  std::string json;
+  common::Error err = batch.Flush(&json);
+  ASSERT_FALSE(err);
+  ASSERT_TRUE(batch.IsEmpty());
+  json_object* jbatch = json_tokener_parse(json.c_str());
+  ASSERT_TRUE(jbatch);
+  json_object* jfull = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(jbatch, "full", &jfull));
+  ASSERT_TRUE(json_object_get_boolean(jfull));
+  json_object* jstreams = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(jbatch, "streams", &jstreams));
+  ASSERT_EQ(json_object_array_length(jstreams), 1);
+  json_object* jcpu = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(json_object_array_get_idx(jstreams, 0), "cpu", &jcpu));
+  ASSERT_EQ(json_object_get_double(jcpu), 2);
+  json_object_put(jbatch);
+
+  batch.Add(fastocloud::StatisticInfo(str, 2, 200, 30));
+  err = batch.Flush(&json);
+  ASSERT_FALSE(err);
+  jbatch = json_tokener_parse(json.c_str());
+  ASSERT_TRUE(jbatch);
+  ASSERT_TRUE(json_object_object_get_ex(jbatch, "full", &jfull));
+  ASSERT_FALSE(json_object_get_boolean(jfull));
+  ASSERT_TRUE(json_object_object_get_ex(jbatch, "streams", &jstreams));
+  json_object* jstat = json_object_array_get_idx(jstreams, 0);
+  json_object* jfield = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(jstat, "id", &jfield));
+  ASSERT_TRUE(json_object_object_get_ex(jstat, "rss", &jfield));
+  ASSERT_FALSE(json_object_object_get_ex(jstat, "cpu", &jfield));
+  json_object_put(jbatch);
+}
+
+TEST(MetricsRegistry, render_node_and_streams) {
+  fastocloud::server::MetricsRegistry metrics;
+  fastocloud::server::MetricsRegistry::NodeMetrics node;
+  node.gpu_load = 42;
+  metrics.SetNode(node);
+  fastocloud::StreamStruct str;
+  str.id = "test\"1";
+  str.restarts = 3;
+  metrics.SetStream(fastocloud::StatisticInfo(str, 1, 100, 10));
+  std::string text = metrics.Render();
+  ASSERT_NE(text.find("# TYPE fastocloud_node_gpu_load gauge\nfastocloud_node_gpu_load 42\n"), std::string::npos);
+  ASSERT_NE(text.find("fastocloud_stream_restarts_total{id=\"test\\\"1\"} 3\n"), std::string::npos);
+  ASSERT_NE(text.find("fastocloud_stream_rss_bytes{id=\"test\\\"1\"} 100\n"), std::string::npos);
+
+  metrics.RemoveStream(str.id);
+  text = metrics.Render();
+  ASSERT_EQ(text.find("{id="), std::string::npos);
+}
+
+TEST(BatchInfo, streams_and_results) {
+  fastocloud::server::stream::StreamsInfo streams;
+  json_object* jstreams = json_tokener_parse("{\"streams\": [\"a\", \"b\"]}");
+  ASSERT_TRUE(jstreams);
+  common::Error err = streams.DeSerialize(jstreams);
+  json_object_put(jstreams);
+  ASSERT_FALSE(err);
+  ASSERT_EQ(streams.GetStreams().size(), 2);
+  ASSERT_EQ(streams.GetStreams()[1], "b");
+
+  jstreams = json_tokener_parse("{\"streams\": [\"a\", 1]}");
+  ASSERT_TRUE(jstreams);
+  err = streams.DeSerialize(jstreams);
+  json_object_put(jstreams);
+  ASSERT_TRUE(err);
+
+  fastocloud::server::stream::BatchResultInfo result;
+  result.AddSuccess("a");
+  result.AddFail("b", "Stream not found");
+  ASSERT_EQ(result.GetFailedCount(), 1);
+  std::string json;
+  err = result.SerializeToString(&json);
+  ASSERT_FALSE(err);
+  json_object* jresult = json_tokener_parse(json.c_str());
+  ASSERT_TRUE(jresult);
+  json_object* jfield = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(jresult, "failed", &jfield));
+  ASSERT_EQ(json_object_get_int(jfield), 1);
+  fastocloud::server::stream::BatchResultInfo parsed;
+  err = parsed.DeSerialize(jresult);
+  json_object_put(jresult);
+  ASSERT_FALSE(err);
+  ASSERT_EQ(parsed.GetResults().size(), 2);
+  ASSERT_TRUE(parsed.GetResults()[0].second.empty());
+  ASSERT_EQ(parsed.GetResults()[1].second, "Stream not found");
+}
+
+TEST(UpdateConfigInfo, id_and_changes) {
+  fastocloud::server::stream::UpdateConfigInfo update;
+  json_object* jupdate = json_tokener_parse("{\"id\": \"a\", \"config\": {\"volume\": 0.5}}");
+  ASSERT_TRUE(jupdate);
+  common::Error err = update.DeSerialize(jupdate);
+  json_object_put(jupdate);
+  ASSERT_FALSE(err);
+  ASSERT_EQ(update.GetStreamID(), "a");
+  ASSERT_TRUE(update.GetChanges());
+  double volume = 0;
+  common::Value* volume_field = update.GetChanges()->Find(VOLUME_FIELD);
+  ASSERT_TRUE(volume_field && volume_field->GetAsDouble(&volume));
+  ASSERT_EQ(volume, 0.5);
+
+  std::string json;
+  err = update.SerializeToString(&json);
+  ASSERT_FALSE(err);
+  fastocloud::server::stream::UpdateConfigInfo parsed;
+  jupdate = json_tokener_parse(json.c_str());
+  ASSERT_TRUE(jupdate);
+  err = parsed.DeSerialize(jupdate);
+  json_object_put(jupdate);
+  ASSERT_FALSE(err);
+  ASSERT_EQ(parsed.GetStreamID(), "a");
+
+  jupdate = json_tokener_parse("{\"id\": \"a\", \"config\": 1}");
+  ASSERT_TRUE(jupdate);
+  err = parsed.DeSerialize(jupdate);
+  json_object_put(jupdate);
+  ASSERT_TRUE(err);
+}
+
+TEST(SyncInfo, known_hashes_not_parsed) {
+  fastocloud::server::service::SyncInfo::hashes_t known;
+  known["a"] = "1";
+  known["b"] = "1";
+  fastocloud::server::service::SyncInfo sync(known);
+  json_object* jsync = json_tokener_parse(
+      "{\"streams\": [{\"id\": \"a\", \"hash\": \"1\"}, {\"id\": \"b\", \"hash\": \"2\", \"type\": 0}, "
+      "{\"id\": \"c\", \"type\": 0}]}");
+  ASSERT_TRUE(jsync);
+  common::Error err = sync.DeSerialize(jsync);
+  json_object_put(jsync);
+  ASSERT_FALSE(err);
+  const auto streams = sync.GetStreams();
+  ASSERT_EQ(streams.size(), 3);
+  ASSERT_EQ(streams[0].id, "a");
+  ASSERT_FALSE(streams[0].config);
+  ASSERT_EQ(streams[1].hash, "2");
+  ASSERT_TRUE(streams[1].config);
+  ASSERT_EQ(streams[2].id, "c");
+  ASSERT_TRUE(streams[2].hash.empty());
+  ASSERT_TRUE(streams[2].config);
+}
+
+TEST(LinksHolderTS, apply_removed_and_inserted) {
+  fastocloud::server::LinksHolderTS links;
+  fastocloud::StreamConfig first = fastocloud::MakeConfigFromJson("{\"id\": \"a\"}");
+  fastocloud::StreamConfig second = fastocloud::MakeConfigFromJson("{\"id\": \"b\"}");
+  links.Insert(common::file_system::ascii_directory_string_path("/tmp/a/"), first);
+  fastocloud::server::LinksHolderTS::snapshot_t old_snapshot = links.GetSnapshot();
+
+  fastocloud::server::LinksHolderTS::links_t inserted;
+  inserted[common::file_system::ascii_directory_string_path("/tmp/b/").GetPath()] = second;
+  links.Apply({common::file_system::ascii_directory_string_path("/tmp/a/").GetPath()}, inserted);
+  ASSERT_EQ(old_snapshot->size(), 1);
+  ASSERT_FALSE(links.Find(common::file_system::ascii_directory_string_path("/tmp/a/")));
+  ASSERT_EQ(links.Find(common::file_system::ascii_directory_string_path("/tmp/b/")), second);
+  ASSERT_EQ(links.GetSnapshot()->size(), 1);
+}
+
+TEST(ConfigWorkers, run_posted_tasks) {
+  std::mutex done_mutex;
+  std::condition_variable done_cond;
+  size_t done = 0;
+  {
+    fastocloud::server::ConfigWorkers workers(2);
+    ASSERT_EQ(workers.GetWorkersCount(), 2);
+    for (size_t i = 0; i < 10; ++i) {
+      workers.Post([&done_mutex, &done_cond, &done]() {
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done++;
+        done_cond.notify_all();
+      });
+    }
+
+    std::unique_lock<std::mutex> lock(done_mutex);
+    ASSERT_TRUE(done_cond.wait_for(lock, std::chrono::seconds(5), [&done]() { return done == 10; }));
+  }
+  ASSERT_EQ(done, 10);
+}
+
+TEST(SegmentCache, lru_and_invalidation) {
+  fastocloud::server::SegmentCache cache(400);
+  ASSERT_FALSE(cache.IsCacheable(0));
+  ASSERT_FALSE(cache.IsCacheable(101));
+
+  fastocloud::server::SegmentCache::data_t first(new std::string(100, 'a'));
+  fastocloud::server::SegmentCache::data_t second(new std::string(100, 'b'));
+  cache.Insert("/1.ts", 1, first);
+  cache.Insert("/2.ts", 1, second);
+  ASSERT_EQ(cache.Find("/1.ts", 1, 100), first);
+  ASSERT_FALSE(cache.Find("/2.ts", 2, 100));  // rotated
+  ASSERT_FALSE(cache.Find("/2.ts", 1, 100));
+
+  for (int i = 3; i < 7; ++i) {
+    fastocloud::server::SegmentCache::data_t data(new std::string(100, 'c'));
+    cache.Insert("/" + std::to_string(i) + ".ts", 1, data);
+  }
+  ASSERT_FALSE(cache.Find("/1.ts", 1, 100));  // evicted
+  ASSERT_TRUE(cache.Find("/6.ts", 1, 100));
+
+  fastocloud::server::SegmentCache::Stats stats = cache.GetStats();
+  ASSERT_EQ(stats.bytes, 400);
+  ASSERT_EQ(stats.entries, 4);
+  ASSERT_EQ(stats.hits, 2);
+  ASSERT_EQ(stats.misses, 3);
+  ASSERT_EQ(stats.served_bytes, 200);
+}
+
+#if defined(OS_LINUX)
+TEST(FileExpirer, registered_by_events) {
+  char dir_template[] = "/tmp/file_expirer_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir_template));
+  const std::string root = dir_template;
+  auto touch = [](const std::string& path) {
+    FILE* file = fopen(path.c_str(), "w");
+    ASSERT_TRUE(file);
+    fclose(file);
+  };
+
+  touch(root + "/old.ts");
+  fastocloud::server::FileExpirer expirer("*.ts");
+  ASSERT_TRUE(expirer.Init());
+  ASSERT_TRUE(expirer.AddFolder(root));
+  ASSERT_EQ(expirer.GetTrackedCount(), 1u);
+
+  ASSERT_EQ(mkdir((root + "/channel").c_str(), 0755), 0);
+  ASSERT_EQ(expirer.ProcessEvents(), 0u);
+  touch(root + "/channel/1.ts");
+  touch(root + "/channel/master.m3u8");
+  ASSERT_EQ(expirer.ProcessEvents(), 1u);
+  ASSERT_EQ(expirer.GetTrackedCount(), 2u);
+
+  ASSERT_EQ(expirer.RemoveExpired(time(nullptr) - 100), 0u);
+  ASSERT_EQ(expirer.RemoveExpired(time(nullptr) + 1), 2u);
+  ASSERT_EQ(access((root + "/channel/1.ts").c_str(), F_OK), -1);
+  ASSERT_EQ(access((root + "/channel/master.m3u8").c_str(), F_OK), 0);
+  ASSERT_EQ(expirer.GetTrackedCount(), 0u);
+
+  unlink((root + "/channel/master.m3u8").c_str());
+  rmdir((root + "/channel").c_str());
+  rmdir(root.c_str());
+}
+#endif
+
+#if defined(OS_POSIX)
+TEST(OutputTrash, renamed_and_removed) {
+  char dir_template[] = "/tmp/output_trash_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir_template));
+  const std::string root = dir_template;
+  ASSERT_EQ(mkdir((root + "/vod").c_str(), 0755), 0);
+  FILE* file = fopen((root + "/vod/1.ts").c_str(), "w");
+  ASSERT_TRUE(file);
+  fclose(file);
+
+  fastocloud::server::OutputTrash trash(root + "/" OUTPUT_TRASH_DIR_NAME);
+  ASSERT_TRUE(trash.Init());
+  ASSERT_FALSE(fastocloud::MoveOutputDirToTrash(root + "/missing", trash.GetPath() + "/0"));
+  ASSERT_TRUE(fastocloud::MoveOutputDirToTrash(root + "/vod/", trash.GetPath() + "/1"));
+  ASSERT_EQ(access((root + "/vod").c_str(), F_OK), 0);
+  ASSERT_EQ(access((root + "/vod/1.ts").c_str(), F_OK), -1);
+  ASSERT_EQ(access((trash.GetPath() + "/1/1.ts").c_str(), F_OK), 0);
+
+  trash.Collect();
+  for (int i = 0; i < 100 && access((trash.GetPath() + "/1").c_str(), F_OK) == 0; ++i) {
+    usleep(10000);
+  }
+  ASSERT_EQ(access((trash.GetPath() + "/1").c_str(), F_OK), -1);
+
+  rmdir(trash.GetPath().c_str());
+  rmdir((root + "/vod").c_str());
+  rmdir(root.c_str());
+}
+#endif
+
+#if defined(OS_POSIX)
+TEST(ProcReader, reread_and_scan) {
+  char path_template[] = "/tmp/proc_reader_XXXXXX";
+  int fd = mkstemp(path_template);
+  ASSERT_NE(fd, -1);
+  close(fd);
+  auto write_file = [&path_template](const std::string& data) {
+    FILE* file = fopen(path_template, "w");
+    ASSERT_TRUE(file);
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+  };
+
+  write_file("  eth0:1024 2 0 0\nMemTotal:  16 kB\npartial 1");
+  fastocloud::server::service::ProcReader reader(path_template, 64);
+  fastocloud::server::service::ProcScanner scanner;
+  ASSERT_TRUE(reader.Read(&scanner));
+  ASSERT_TRUE(scanner.NextLine());
+  std::string token;
+  uint64_t value = 0;
+  ASSERT_TRUE(scanner.ReadToken(&token));
+  ASSERT_EQ(token, "eth0");
+  ASSERT_TRUE(scanner.ReadUint64(&value));
+  ASSERT_EQ(value, 1024u);
+  ASSERT_TRUE(scanner.SkipTokens(3));
+  ASSERT_FALSE(scanner.ReadUint64(&value));
+  ASSERT_TRUE(scanner.NextLine());
+  ASSERT_TRUE(scanner.ReadToken(&token));
+  ASSERT_EQ(token, "MemTotal");
+  ASSERT_TRUE(scanner.ReadUint64(&value));
+  ASSERT_EQ(value, 16u);
+  ASSERT_FALSE(scanner.ReadUint64(&value));
+  ASSERT_FALSE(scanner.NextLine());
+
+  write_file("cpu 7\n");
+  ASSERT_TRUE(reader.Read(&scanner));
+  ASSERT_TRUE(scanner.NextLine());
+  ASSERT_TRUE(scanner.SkipTokens(1));
+  ASSERT_TRUE(scanner.ReadUint64(&value));
+  ASSERT_EQ(value, 7u);
+  ASSERT_FALSE(scanner.NextLine());
+  unlink(path_template);
+}
+#endif
+
+#if defined(OS_LINUX)
+TEST(StreamCgroups, limits_and_stats) {
+  char dir_template[] = "/tmp/stream_cgroups_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir_template));
+  const std::string root = dir_template;
+  auto write_file = [](const std::string& path, const std::string& data) {
+    FILE* file = fopen(path.c_str(), "w");
+    ASSERT_TRUE(file);
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+  };
+  auto read_file = [](const std::string& path) {
+    char buff[64] = {0};
+    FILE* file = fopen(path.c_str(), "r");
+    if (file) {
+      ignore_result(fread(buff, 1, sizeof(buff) - 1, file));
+      fclose(file);
+    }
+    return std::string(buff);
+  };
+
+  fastocloud::server::StreamCgroups cgroups(root, 150, 2);
+  ASSERT_FALSE(cgroups.Init());
+  write_file(root + "/cgroup.controllers", "cpu io memory\n");
+  ASSERT_TRUE(cgroups.Init());
+  ASSERT_EQ(read_file(root + "/cgroup.subtree_control"), "+cpu+memory+io");
+
+  ASSERT_TRUE(cgroups.Create("a/b"));
+  const std::string path = cgroups.GetPath("a/b");
+  ASSERT_EQ(path, root + "/stream_a_b");
+  ASSERT_EQ(read_file(path + "/cpu.max"), "150000 100000");
+  ASSERT_EQ(read_file(path + "/memory.max"), "2097152");
+
+  fastocloud::server::StreamCgroups::Stats stats;
+  ASSERT_FALSE(cgroups.GetStats("a/b", &stats));
+  write_file(path + "/cpu.stat", "usage_usec 2500000\nuser_usec 2000000\n");
+  write_file(path + "/memory.current", "4096\n");
+  write_file(path + "/io.stat", "8:0 rbytes=10 wbytes=20 rios=1\n8:16 rbytes=1 wbytes=2 rios=1\n");
+  ASSERT_TRUE(cgroups.GetStats("a/b", &stats));
+  ASSERT_EQ(stats.cpu_usec, 2500000u);
+  ASSERT_EQ(stats.memory_bytes, 4096u);
+  ASSERT_EQ(stats.io_read_bytes, 11u);
+  ASSERT_EQ(stats.io_write_bytes, 22u);
+
+  ASSERT_EQ(access((path + "/cpu.weight").c_str(), F_OK), -1);
+  ASSERT_TRUE(cgroups.Create("a/b", 25));  // left by previous run reused
+  ASSERT_EQ(read_file(path + "/cpu.weight"), "25");
+  ASSERT_EQ(read_file(path + "/io.weight"), "default 25");
+
+  const char* files[] = {"cpu.max", "memory.max", "cpu.stat", "memory.current", "io.stat", "cpu.weight", "io.weight"};
+  for (const char* file : files) {
+    unlink((path + "/" + file).c_str());
+  }
+  ASSERT_TRUE(cgroups.Remove("a/b"));
+  unlink((root + "/cgroup.controllers").c_str());
+  unlink((root + "/cgroup.subtree_control").c_str());
+  rmdir(root.c_str());
+}
+#endif
+
+namespace {
+void write_to_buffer(fastocloud::server::base::HttpRequestBuffer* buffer, const std::string& data) {
+  size_t free_size = 0;
+  char* buff = buffer->PrepareWrite(&free_size);
+  ASSERT_TRUE(buff);
+  ASSERT_GE(free_size, data.size());
+  memcpy(buff, data.data(), data.size());
+  buffer->CommitWrite(data.size());
+}
+}  // namespace
+
+TEST(HttpCache, etag_and_conditions) {
+  const std::string etag = fastocloud::server::base::MakeETag(255, 16);
+  ASSERT_EQ(etag, "\"ff-10\"");
+  fastocloud::server::base::CacheConditions conditions;
+  ASSERT_FALSE(fastocloud::server::base::IsNotModified(conditions, etag, 16));
+  conditions.if_none_match = "\"1-1\", W/\"ff-10\"";
+  ASSERT_TRUE(fastocloud::server::base::IsNotModified(conditions, etag, 16));
+  conditions.if_none_match = "\"1-1\"";
+  conditions.if_modified_since = 100;  // ignored with if-none-match
+  ASSERT_FALSE(fastocloud::server::base::IsNotModified(conditions, etag, 16));
+  conditions.if_none_match = "*";
+  ASSERT_TRUE(fastocloud::server::base::IsNotModified(conditions, etag, 16));
+  conditions.if_none_match.clear();
+  ASSERT_TRUE(fastocloud::server::base::IsNotModified(conditions, etag, 16));
+  ASSERT_FALSE(fastocloud::server::base::IsNotModified(conditions, etag, 101));
+
+  time_t date = 0;
+  ASSERT_TRUE(fastocloud::server::base::ParseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT", &date));
+  ASSERT_EQ(date, 784111777);
+  ASSERT_FALSE(fastocloud::server::base::ParseHttpDate("yesterday", &date));
+
+  std::string headers = fastocloud::server::base::MakeCacheHeaders(etag, "/live/1/1600000000000_00001.ts", true);
+  ASSERT_NE(headers.find("ETag: " + etag), std::string::npos);
+  ASSERT_NE(headers.find("immutable"), std::string::npos);
+  headers = fastocloud::server::base::MakeCacheHeaders(etag, "/vods/1/00001.ts", false);
+  ASSERT_EQ(headers.find("immutable"), std::string::npos);
+  headers = fastocloud::server::base::MakeCacheHeaders(etag, "/live/1/master.m3u8", true);
+  ASSERT_NE(headers.find("max-age=1"), std::string::npos);
+}
+
+TEST(HttpRange, single_ranges) {
+  fastocloud::server::base::ByteRange range;
+  ASSERT_TRUE(fastocloud::server::base::ParseRangeHeader("bytes=0-99", 1000, &range));
+  ASSERT_EQ(range.start, 0u);
+  ASSERT_EQ(range.length, 100u);
+  ASSERT_EQ(fastocloud::server::base::MakeContentRangeHeader(range, 1000), "Content-Range: bytes 0-99/1000");
+  ASSERT_TRUE(fastocloud::server::base::ParseRangeHeader("bytes=900-", 1000, &range));
+  ASSERT_EQ(range.start, 900u);
+  ASSERT_EQ(range.length, 100u);
+  ASSERT_TRUE(fastocloud::server::base::ParseRangeHeader("bytes=-10", 1000, &range));
+  ASSERT_EQ(range.start, 990u);
+  ASSERT_EQ(range.length, 10u);
+  ASSERT_TRUE(fastocloud::server::base::ParseRangeHeader("bytes=-5000", 1000, &range));
+  ASSERT_EQ(range.start, 0u);
+  ASSERT_EQ(range.length, 1000u);
+  ASSERT_TRUE(fastocloud::server::base::ParseRangeHeader("bytes=990-5000", 1000, &range));
+  ASSERT_EQ(range.length, 10u);
+
+  ASSERT_FALSE(fastocloud::server::base::ParseRangeHeader("bytes=1000-", 1000, &range));
+  ASSERT_FALSE(fastocloud::server::base::ParseRangeHeader("bytes=5-1", 1000, &range));
+  ASSERT_FALSE(fastocloud::server::base::ParseRangeHeader("bytes=0-1,5-6", 1000, &range));
+  ASSERT_FALSE(fastocloud::server::base::ParseRangeHeader("items=0-1", 1000, &range));
+  ASSERT_FALSE(fastocloud::server::base::ParseRangeHeader("bytes=-0", 1000, &range));
+
+  ASSERT_TRUE(fastocloud::server::base::IsRangeCurrent(std::string(), "\"ff-10\"", 16));
+  ASSERT_TRUE(fastocloud::server::base::IsRangeCurrent("\"ff-10\"", "\"ff-10\"", 16));
+  ASSERT_FALSE(fastocloud::server::base::IsRangeCurrent("\"ff-11\"", "\"ff-10\"", 16));
+  ASSERT_TRUE(fastocloud::server::base::IsRangeCurrent("Sun, 06 Nov 1994 08:49:37 GMT", "\"ff-10\"", 784111777));
+  ASSERT_FALSE(fastocloud::server::base::IsRangeCurrent("Sun, 06 Nov 1994 08:49:37 GMT", "\"ff-10\"", 16));
+}
+
+TEST(HttpRequestBuffer, partial_and_pipelined) {
+  const std::string first = "GET /1.m3u8 HTTP/1.1\r\nHost: a\r\n\r\n";
+  const std::string second = "POST /2 HTTP/1.1\r\nContent-Length: 4\r\n\r\nbody";
+  fastocloud::server::base::HttpRequestBuffer buffer;
+  std::string request;
+  write_to_buffer(&buffer, first.substr(0, 20));
+  ASSERT_FALSE(buffer.NextRequest(&request));
+  write_to_buffer(&buffer, first.substr(20) + second.substr(0, second.size() - 2));
+  ASSERT_TRUE(buffer.NextRequest(&request));
+  ASSERT_EQ(request, first);
+  ASSERT_FALSE(buffer.NextRequest(&request));  // body incomplete
+  write_to_buffer(&buffer, second.substr(second.size() - 2));
+  ASSERT_TRUE(buffer.NextRequest(&request));
+  ASSERT_EQ(request, second);
+  ASSERT_EQ(buffer.GetSize(), 0);
+}
+
+TEST(HttpRequestBuffer, invalid_content_length) {
+  const std::string first = "GET /1.m3u8 HTTP/1.1\r\nHost: a\r\n\r\n";
+  fastocloud::server::base::HttpRequestBuffer buffer;
+  std::string request;
+  write_to_buffer(&buffer, first + "POST /2 HTTP/1.1\r\nContent-Length: 18446744073709551615\r\n\r\nbody");
+  ASSERT_TRUE(buffer.NextRequest(&request));
+  ASSERT_EQ(request, first);
+  ASSERT_FALSE(buffer.NextRequest(&request));
+  ASSERT_TRUE(buffer.IsMalformed());
+  size_t free_size = 0;
+  ASSERT_FALSE(buffer.PrepareWrite(&free_size));
+
+  const char* invalid[] = {"-1", "4x", "", "70000"};
+  for (const char* value : invalid) {
+    fastocloud::server::base::HttpRequestBuffer other;
+    write_to_buffer(&other, std::string("POST /2 HTTP/1.1\r\nContent-Length: ") + value + "\r\n\r\nbody");
+    ASSERT_FALSE(other.NextRequest(&request));
+    ASSERT_TRUE(other.IsMalformed());
+  }
+
+  fastocloud::server::base::HttpRequestBuffer valid;
+  write_to_buffer(&valid, "POST /2 HTTP/1.1\r\nContent-Length:  4 \r\n\r\nbody");
+  ASSERT_TRUE(valid.NextRequest(&request));
+  ASSERT_FALSE(valid.IsMalformed());
+}
+
+TEST(HttpRequestBuffer, http2_preface_and_frames) {
+  const std::string preface("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+  const std::string settings("\x00\x00\x00\x04\x00\x00\x00\x00\x00", 9);
+  const std::string headers("\x00\x00\x03\x01\x05\x00\x00\x00\x01\x82\x84\x86", 12);
+  fastocloud::server::base::HttpRequestBuffer buffer;
+  std::string request;
+  write_to_buffer(&buffer, preface.substr(0, 18));
+  ASSERT_FALSE(buffer.NextRequest(&request));
+  ASSERT_FALSE(buffer.IsHttp2());
+  write_to_buffer(&buffer, preface.substr(18) + settings + headers.substr(0, 10));
+  ASSERT_FALSE(buffer.NextRequest(&request));
+  ASSERT_TRUE(buffer.IsHttp2());
+  ASSERT_TRUE(buffer.NextFrames(&request));
+  ASSERT_EQ(request, settings);
+  ASSERT_FALSE(buffer.NextFrames(&request));
+  write_to_buffer(&buffer, headers.substr(10));
+  ASSERT_TRUE(buffer.NextFrames(&request));
+  ASSERT_EQ(request, headers);
+  ASSERT_EQ(buffer.GetSize(), 0u);
+  ASSERT_TRUE(buffer.IsHttp2());
+
+  fastocloud::server::base::HttpRequestBuffer http1;
+  write_to_buffer(&http1, "GET /1.m3u8 HTTP/1.1\r\n\r\n");
+  ASSERT_TRUE(http1.NextRequest(&request));
+  ASSERT_FALSE(http1.IsHttp2());
+  ASSERT_FALSE(http1.NextFrames(&request));
+}
+
+#if defined(OS_LINUX)
+TEST(VodsHandler, h2c_cached_segment) {
+  char dir_template[] = "/tmp/vods_handler_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir_template));
+  const std::string root = dir_template;
+  const std::string segment_path = root + "/1.ts";
+  FILE* file = fopen(segment_path.c_str(), "w");
+  ASSERT_TRUE(file);
+  fputs("disk-data", file);
+  fclose(file);
+  struct stat sb;
+  ASSERT_EQ(stat(segment_path.c_str(), &sb), 0);
+
+  // same size as file, so response carries cached bytes only if cache was hit
+  fastocloud::server::SegmentCache cache(1024);
+  cache.Insert(segment_path, sb.st_mtime, fastocloud::server::SegmentCache::data_t(new std::string("hot-data!")));
+  fastocloud::server::VodsHandler handler(nullptr);
+  handler.SetHttpRoot(fastocloud::server::VodsHandler::http_directory_path_t(root + "/"));
+  handler.SetSegmentCache(&cache);
+
+  int socks[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, socks), 0);
+  fastocloud::server::VodsClient* client =
+      new fastocloud::server::VodsClient(nullptr, common::net::socket_info(socks[0]));
+  const std::string preface("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+  const std::string settings("\x00\x00\x00\x04\x00\x00\x00\x00\x00", 9);
+  // GET http :path /1.ts, end of stream and headers
+  const std::string headers("\x00\x00\x09\x01\x05\x00\x00\x00\x01\x82\x86\x44\x05/1.ts", 18);
+  const std::string request = preface + settings + headers;
+  ASSERT_EQ(write(socks[1], request.data(), request.size()), static_cast<ssize_t>(request.size()));
+  handler.DataReceived(client);
+
+  std::string response;
+  char buff[4096];
+  ssize_t nread = 0;
+  while ((nread = recv(socks[1], buff, sizeof(buff), MSG_DONTWAIT)) > 0) {
+    response.append(buff, nread);
+  }
+  ASSERT_NE(response.find("hot-data!"), std::string::npos);
+  ASSERT_EQ(response.find("disk-data"), std::string::npos);
+  ASSERT_EQ(response.find("HTTP/1.1"), std::string::npos);
+  ASSERT_EQ(cache.GetStats().hits, 1);
+
+  ignore_result(client->Close());
+  delete client;
+  close(socks[1]);
+  unlink(segment_path.c_str());
+  rmdir(root.c_str());
+}
+#endif
+
+TEST(EncoderPool, fallback_when_saturated) {
+  fastocloud::server::gpu_stats::EncoderPool pool(2, 90);
+  const fastocloud::server::gpu_stats::devices_stats_t no_stats;
+  int device = 0;
+  ASSERT_EQ(pool.Acquire("1", X264_ENC, 0, no_stats, &device), X264_ENC);
+  ASSERT_EQ(device, fastocloud::server::gpu_stats::EncoderPool::invalid_device_index);
+  ASSERT_EQ(pool.Acquire("2", NV_H264_ENC, 0, no_stats, &device), NV_H264_ENC);
+  ASSERT_EQ(pool.Acquire("3", NV_H265_ENC, 0, no_stats, &device), NV_H265_ENC);
+  ASSERT_EQ(pool.GetSessions(fastocloud::server::gpu_stats::EncoderPool::NVIDIA_DEVICE), 2u);
+  ASSERT_EQ(pool.Acquire("4", NV_H264_ENC, 0, no_stats, &device), X264_ENC);
+  ASSERT_EQ(pool.Acquire("5", NV_H265_ENC, 0, no_stats, &device), X265_ENC);
+  pool.Release("2");
+  ASSERT_EQ(pool.Acquire("4", NV_H264_ENC, 0, no_stats, &device), NV_H264_ENC);
+  ASSERT_EQ(pool.Acquire("6", MFX_H264_ENC, 95, no_stats, &device), X264_ENC);
+  ASSERT_EQ(pool.Acquire("6", MFX_H264_ENC, 10, no_stats, &device), MFX_H264_ENC);
+}
+
+TEST(EncoderPool, av1_fallback_to_svt) {
+  fastocloud::server::gpu_stats::EncoderPool pool(1, 90);
+  const fastocloud::server::gpu_stats::devices_stats_t no_stats;
+  int device = 0;
+  ASSERT_EQ(pool.Acquire("1", NV_AV1_ENC, 0, no_stats, &device), NV_AV1_ENC);
+  ASSERT_EQ(pool.Acquire("2", NV_AV1_ENC, 0, no_stats, &device), SVT_AV1_ENC);
+  ASSERT_EQ(pool.Acquire("3", QSV_AV1_ENC, 95, no_stats, &device), SVT_AV1_ENC);
+  ASSERT_EQ(pool.Acquire("4", SVT_AV1_ENC, 0, no_stats, &device), SVT_AV1_ENC);
+  ASSERT_EQ(device, fastocloud::server::gpu_stats::EncoderPool::invalid_device_index);
+}
+
+TEST(EncoderPool, least_loaded_device) {
+  fastocloud::server::gpu_stats::EncoderPool pool(1, 90);
+  fastocloud::server::gpu_stats::devices_stats_t devices(3);
+  devices[0].encoder_load = 50;
+  devices[1].encoder_load = 10;
+  devices[2].memory_load = 95;
+  int device = fastocloud::server::gpu_stats::EncoderPool::invalid_device_index;
+  ASSERT_EQ(pool.Acquire("1", NV_H264_ENC, 0, devices, &device), NV_H264_ENC);
+  ASSERT_EQ(device, 1);
+  ASSERT_EQ(pool.Acquire("2", NV_H264_ENC, 0, devices, &device), NV_H264_ENC);
+  ASSERT_EQ(device, 0);
+  ASSERT_EQ(pool.Acquire("3", NV_H264_ENC, 0, devices, &device), X264_ENC);
+  ASSERT_EQ(device, fastocloud::server::gpu_stats::EncoderPool::invalid_device_index);
+}
+
+TEST(EncoderPool, restore_adopted) {
+  fastocloud::server::gpu_stats::EncoderPool pool(1, 90);
+  fastocloud::server::gpu_stats::devices_stats_t devices(2);
+  pool.Restore("1", NV_H264_ENC, 0);
+  pool.Restore("2", X264_ENC, -1);  // fell back before adoption
+  ASSERT_EQ(pool.GetSessions(fastocloud::server::gpu_stats::EncoderPool::NVIDIA_DEVICE), 1);
+  int device = fastocloud::server::gpu_stats::EncoderPool::invalid_device_index;
+  ASSERT_EQ(pool.Acquire("3", NV_H264_ENC, 0, devices, &device), NV_H264_ENC);
+  ASSERT_EQ(device, 1);
+}
+
+TEST(CpuAffinityPool, numa_local_least_used) {
+  fastocloud::server::CpuAffinityPool::cores_t cores;
+  for (int i = 0; i < 4; ++i) {
+    fastocloud::server::CpuAffinityPool::Core core;
+    core.node = i / 2;
+    core.cpus = {i, i + 4};  // smt sibling
+    cores.push_back(core);
+  }
+
+  fastocloud::server::CpuAffinityPool pool(cores, 2);
+  fastocloud::server::CpuAffinityPool::cpus_t cpus;
+  ASSERT_TRUE(pool.Acquire("1", &cpus));
+  ASSERT_EQ(cpus, fastocloud::server::CpuAffinityPool::cpus_t({0, 1, 4, 5}));
+  ASSERT_TRUE(pool.Acquire("2", &cpus));
+  ASSERT_EQ(cpus, fastocloud::server::CpuAffinityPool::cpus_t({2, 3, 6, 7}));
+  pool.Release("1");
+  ASSERT_TRUE(pool.Acquire("3", &cpus));
+  ASSERT_EQ(cpus, fastocloud::server::CpuAffinityPool::cpus_t({0, 1, 4, 5}));
+
+  fastocloud::server::CpuAffinityPool adopted(cores, 2);
+  adopted.Restore("1", {0, 1, 4, 5});
+  ASSERT_TRUE(adopted.Acquire("2", &cpus));
+  ASSERT_EQ(cpus, fastocloud::server::CpuAffinityPool::cpus_t({2, 3, 6, 7}));
+}
+
+TEST(AdmissionControl, reject_overload) {
+  fastocloud::server::AdmissionControl admission(4, 100, 10 * 1000 * 1000 / 8);  // 400% of cpu, 10 Mbps
+  const auto encode = admission.Estimate("1", fastotv::ENCODE, X264_ENC, common::draw::Size(1920, 1080), 4000, 1);
+  ASSERT_EQ(encode.cpu, fastocloud::server::AdmissionControl::software_encode_cpu_estimate);
+  ASSERT_FALSE(admission.Admit("1", encode, 10, 0));
+  ASSERT_FALSE(admission.Admit("2", encode, 10, 0));
+  ASSERT_TRUE(admission.Admit("3", encode, 10, 0));
+
+  const auto gpu = admission.Estimate("3", fastotv::ENCODE, NV_H264_ENC, common::draw::Size(1920, 1080), 4000, 1);
+  ASSERT_EQ(gpu.cpu, fastocloud::server::AdmissionControl::hardware_encode_cpu_estimate);
+  admission.Release("1");
+  ASSERT_FALSE(admission.Admit("3", gpu, 10, 0));
+
+  const auto relay = admission.Estimate("4", fastotv::RELAY, std::string(), common::draw::Size(), 0, 3);
+  ASSERT_TRUE(admission.Admit("4", relay, 10, 0));  // 3 outputs over network limit
+  admission.Measure("4", {5, 100 * 1000});
+  const auto measured = admission.Estimate("4", fastotv::RELAY, std::string(), common::draw::Size(), 0, 3);
+  ASSERT_EQ(measured.bandwidth, 100u * 1000);
+  ASSERT_FALSE(admission.Admit("4", measured, 10, 0));
+}
+
+TEST(JobQueue, schedule_by_load) {
+  typedef fastocloud::server::JobQueue JobQueue;
+  JobQueue queue(4, 2, 1, 70);  // 2 cpu and 1 gpu jobs, paused above 70% of live load
+  queue.Push({"1", JobQueue::CPU_RESOURCE, 0});
+  queue.Push({"2", JobQueue::CPU_RESOURCE, 5});
+  queue.Push({"3", JobQueue::CPU_RESOURCE, 0});
+  queue.Push({"4", JobQueue::GPU_RESOURCE, 0});
+  std::vector<fastotv::stream_id_t> start, pause, resume;
+  queue.Schedule(20, &start, &pause, &resume);
+  ASSERT_EQ(start, std::vector<fastotv::stream_id_t>({"2", "1", "4"}));
+  ASSERT_TRUE(queue.IsQueued("3"));
+
+  queue.Measure("1", 40);
+  queue.Measure("2", 40);  // jobs use 20% of node
+  queue.Schedule(95, &start, &pause, &resume);
+  ASSERT_EQ(pause, std::vector<fastotv::stream_id_t>({"4"}));
+  queue.Schedule(95, &start, &pause, &resume);
+  ASSERT_EQ(pause, std::vector<fastotv::stream_id_t>({"4", "1"}));
+  ASSERT_TRUE(queue.IsPaused("1"));
+  queue.Schedule(75, &start, &pause, &resume);  // inside hysteresis
+  ASSERT_TRUE(resume.empty());
+  queue.Schedule(30, &start, &pause, &resume);
+  ASSERT_EQ(resume, std::vector<fastotv::stream_id_t>({"1"}));
+  ASSERT_EQ(queue.GetPausedCount(), 1u);
+  ASSERT_EQ(queue.GetRunningCount(), 2u);
+
+  ASSERT_TRUE(queue.Remove("2"));
+  start.clear();
+  queue.Schedule(30, &start, &pause, &resume);
+  ASSERT_TRUE(start.empty());  // paused ones continue first
+  queue.Schedule(30, &start, &pause, &resume);
+  ASSERT_EQ(start, std::vector<fastotv::stream_id_t>({"3"}));
+  ASSERT_FALSE(queue.Remove("5"));
+}
+
+TEST(HlsRetention, size_by_lag) {
+  typedef fastocloud::server::HlsRetention HlsRetention;
+  uint64_t index;
+  ASSERT_TRUE(HlsRetention::GetSegmentIndex("1600000_00042.ts", &index));
+  ASSERT_EQ(index, 42u);
+  ASSERT_FALSE(HlsRetention::GetSegmentIndex("master.m3u8", &index));
+  ASSERT_FALSE(HlsRetention::GetSegmentIndex("00042.ts", &index));
+
+  HlsRetention retention(20, 1000);  // no playlists, live edge is newest requested
+  retention.Track("1", "/tmp/hls_retention_1/", "master.m3u8");
+  retention.Track("2", "/tmp/hls_retention_2/", "master.m3u8");
+  ASSERT_TRUE(retention.Update(1000).empty());
+  retention.Record("/tmp/hls_retention_1/", "1_10.ts");
+  retention.Record("/tmp/hls_retention_1/", "1_12.ts");
+  retention.Record("/tmp/hls_retention_2/", "1_85.ts");
+  retention.Record("/tmp/hls_retention_2/", "1_99.ts");
+  retention.Record("/tmp/hls_retention_3/", "1_1.ts");  // not tracked
+  ASSERT_TRUE(retention.Update(1500).empty());
+
+  HlsRetention::changes_t changes = retention.Update(2000);
+  ASSERT_EQ(changes.size(), 2u);
+  ASSERT_EQ(changes[0].first, "1");
+  ASSERT_EQ(changes[0].second, 7u);  // playlist with margin
+  ASSERT_EQ(changes[1].first, "2");
+  ASSERT_EQ(changes[1].second, 18u);
+
+  changes = retention.Update(3000);  // nobody rewinds, shrinks
+  ASSERT_EQ(changes.size(), 1u);
+  ASSERT_EQ(changes[0].first, "2");
+  ASSERT_EQ(changes[0].second, 7u);
+
+  retention.Record("/tmp/hls_retention_2/", "1_50.ts");
+  changes = retention.Update(4000);
+  ASSERT_EQ(changes.size(), 1u);
+  ASSERT_EQ(changes[0].second, 20u);  // clamped to max files
+
+  retention.Untrack("2");
+  ASSERT_EQ(retention.GetMaxFiles("2"), 0u);
+  ASSERT_EQ(retention.GetMaxFiles("1"), 7u);
+}
+
+TEST(StartupStats, percentiles) {
+  fastocloud::server::StartupStats stats;
+  ASSERT_EQ(stats.GetPercentile(0.5), 0u);
+  fastocloud::startup_timing_t startup = {};
+  startup[fastocloud::REQUEST_STARTUP_STAGE] = 1000;
+  stats.Record("0", startup);  // no output yet
+  ASSERT_EQ(stats.GetCount(), 0u);
+  for (int i = 1; i <= 100; ++i) {
+    startup[fastocloud::FIRST_OUTPUT_STARTUP_STAGE] = 1000 + i * 10;
+    stats.Record(std::to_string(i), startup);
+    stats.Record(std::to_string(i), startup);  // counted once per run
+  }
+  ASSERT_EQ(stats.GetCount(), 100u);
+  ASSERT_EQ(stats.GetPercentile(0.5), 510u);
+  ASSERT_EQ(stats.GetPercentile(0.99), 990u);
+  stats.Release("1");
+  stats.Record("1", startup);
+  ASSERT_EQ(stats.GetCount(), 101u);
+}
+
+TEST(StreamsStatus, snapshot_and_filter) {
+  fastocloud::server::StreamsStatus status;
+  fastocloud::StreamStruct str;
+  str.id = "a";
+  str.status = fastocloud::PLAYING;
+  str.restarts = 2;
+  fastocloud::ChannelStats output(0);
+  output.SetBps(1000);
+  str.output.push_back(output);
+  str.output.push_back(output);
+  status.Set(fastocloud::StatisticInfo(str, 5, 100, 10));
+  str.id = "b";
+  str.status = fastocloud::WAITING;
+  status.Set(fastocloud::StatisticInfo(str, 1, 100, 10));
+  fastocloud::server::StreamsStatus::Status stat;
+  ASSERT_TRUE(status.Get("a", &stat));
+  ASSERT_EQ(stat.output_bps, 2000u);
+  ASSERT_EQ(stat.restarts, 2u);
+  ASSERT_EQ(stat.cpu, 5);
+
+  std::string json;
+  ASSERT_FALSE(status.Serialize(fastocloud::server::service::StreamsStatusInfo(), &json));
+  json_object* jresult = json_tokener_parse(json.c_str());
+  json_object* jstreams = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(jresult, "streams", &jstreams));
+  ASSERT_EQ(json_object_array_length(jstreams), 2);
+  json_object_put(jresult);
+
+  fastocloud::server::service::StreamsStatusInfo filter({"a", "b", "c"}, {fastocloud::WAITING});
+  ASSERT_FALSE(status.Serialize(filter, &json));
+  jresult = json_tokener_parse(json.c_str());
+  ASSERT_TRUE(json_object_object_get_ex(jresult, "streams", &jstreams));
+  ASSERT_EQ(json_object_array_length(jstreams), 1);
+  json_object* jid = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(json_object_array_get_idx(jstreams, 0), "id", &jid));
+  ASSERT_STREQ(json_object_get_string(jid), "b");
+  json_object_put(jresult);
+
+  status.Remove("b");
+  ASSERT_FALSE(status.Get("b", &stat));
+}
+
+TEST(StatsHistory, ring_and_downsample) {
+  fastocloud::server::StatsHistory history(40, 10);  // 4 samples
+  ASSERT_EQ(history.GetCapacity(), 4u);
+  for (int i = 0; i < 6; ++i) {
+    const double values[fastocloud::server::StatsHistory::NODE_METRICS_COUNT] = {10.0 * i, 0, 0, 0, 0};
+    history.AddNode(i * 10000, values);
+  }
+  const double merged[fastocloud::server::StatsHistory::NODE_METRICS_COUNT] = {70, 0, 0, 0, 0};
+  history.AddNode(55000, merged);  // same slot as 50000
+
+  json_object* jresult = json_tokener_parse(history.Serialize({}, 0, 0).c_str());
+  json_object* jnode = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(jresult, "node", &jnode));
+  json_object* jcpu = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(jnode, "cpu", &jcpu));
+  ASSERT_EQ(json_object_array_length(jcpu), 4);
+  ASSERT_DOUBLE_EQ(json_object_get_double(json_object_array_get_idx(jcpu, 0)), 20);
+  ASSERT_DOUBLE_EQ(json_object_get_double(json_object_array_get_idx(jcpu, 3)), 60);
+  json_object_put(jresult);
+
+  jresult = json_tokener_parse(history.Serialize({}, 25000, 20).c_str());
+  ASSERT_TRUE(json_object_object_get_ex(jresult, "node", &jnode));
+  ASSERT_TRUE(json_object_object_get_ex(jnode, "cpu", &jcpu));
+  ASSERT_EQ(json_object_array_length(jcpu), 2);  // 30 and average of 40, 60
+  ASSERT_DOUBLE_EQ(json_object_get_double(json_object_array_get_idx(jcpu, 0)), 30);
+  ASSERT_DOUBLE_EQ(json_object_get_double(json_object_array_get_idx(jcpu, 1)), 50);
+  json_object_put(jresult);
+
+  fastocloud::StreamStruct str;
+  str.id = "a";
+  fastocloud::ChannelStats output(0);
+  output.SetBps(1000);
+  str.output.push_back(output);
+  history.AddStream(fastocloud::StatisticInfo(str, 5, 100, 10000));
+  str.id = "b";
+  history.AddStream(fastocloud::StatisticInfo(str, 5, 100, 10000));
+  history.RemoveStream("b");
+  jresult = json_tokener_parse(history.Serialize({"a", "b"}, 0, 0).c_str());
+  json_object* jstreams = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(jresult, "streams", &jstreams));
+  ASSERT_EQ(json_object_array_length(jstreams), 1);
+  json_object* joutput = nullptr;
+  ASSERT_TRUE(json_object_object_get_ex(json_object_array_get_idx(jstreams, 0), "output_bps", &joutput));
+  ASSERT_DOUBLE_EQ(json_object_get_double(json_object_array_get_idx(joutput, 0)), 1000);
+  json_object_put(jresult);
+}
+
+TEST(CodsWarmPool, popularity) {
+  fastocloud::server::CodsWarmPool pool(1, 1000);
+  ASSERT_FALSE(pool.IsWarm("a", 0));  // never requested
+  pool.Hit("a", 0);
+  pool.Hit("a", 0);
+  pool.Hit("b", 0);
+  ASSERT_TRUE(pool.IsWarm("a", 0));
+  ASSERT_FALSE(pool.IsWarm("b", 0));
+  pool.Hit("b", 3000);  // hits of a decayed to 0.25
+  ASSERT_TRUE(pool.IsWarm("b", 3000));
+  ASSERT_FALSE(pool.IsWarm("a", 3000));
+
+  pool.Park("b");
+  ASSERT_TRUE(pool.IsParked("b"));
+  ASSERT_TRUE(pool.Unpark("b"));
+  ASSERT_FALSE(pool.Unpark("b"));
+  pool.Park("a");
+  pool.Release("a");
+  ASSERT_EQ(pool.GetParkedCount(), 0u);
+}
+
+#if defined(OS_POSIX)
+TEST(TsIndex, keyframe_segments) {
+  char path_template[] = "/tmp/ts_index_XXXXXX";
+  int fd = mkstemp(path_template);
+  ASSERT_NE(fd, -1);
+  auto packet = [fd](int pid, bool unit_start, bool random_access, const std::string& payload) {
+    std::string ts(188, static_cast<char>(0xFF));
+    ts[0] = 0x47;
+    ts[1] = static_cast<char>((unit_start ? 0x40 : 0) | (pid >> 8));
+    ts[2] = static_cast<char>(pid & 0xFF);
+    ts[3] = 0x30;  // adaptation and payload
+    const size_t length = 183 - payload.size();
+    ts[4] = static_cast<char>(length);
+    if (length) {
+      ts[5] = random_access ? 0x40 : 0;
+    }
+    ts.replace(188 - payload.size(), payload.size(), payload);
+    ASSERT_EQ(write(fd, ts.data(), ts.size()), 188);
+  };
+  const std::string pat("\x00\x00\xB0\x0D\x00\x01\xC1\x00\x00\x00\x01\xF0\x00\x00\x00\x00\x00", 17);
+  const std::string pmt("\x00\x02\xB0\x12\x00\x01\xC1\x00\x00\xE1\x00\xF0\x00\x1B\xE1\x00\xF0\x00\x00\x00\x00\x00",
+                        22);
+  auto pes = [](int64_t pts) {
+    std::string pes("\x00\x00\x01\xE0\x00\x00\x80\x80\x05", 9);
+    pes += static_cast<char>(0x21 | ((pts >> 29) & 0x0E));
+    pes += static_cast<char>((pts >> 22) & 0xFF);
+    pes += static_cast<char>(0x01 | ((pts >> 14) & 0xFE));
+    pes += static_cast<char>((pts >> 7) & 0xFF);
+    pes += static_cast<char>(0x01 | ((pts << 1) & 0xFE));
+    return pes;
+  };
+
+  packet(0, true, false, pat);
+  packet(0x1000, true, false, pmt);
+  for (int64_t sec = 0; sec <= 25; ++sec) {  // keyframe every 5 seconds
+    packet(0x100, true, sec % 5 == 0, pes(sec * 90000));
+  }
+  close(fd);
+
+  fastocloud::server::TsIndex index;
+  ASSERT_TRUE(index.Build(path_template, 10000));
+  const fastocloud::server::TsIndex::segments_t& segments = index.GetSegments();
+  ASSERT_EQ(segments.size(), 3u);
+  ASSERT_EQ(segments[0].offset, 0u);
+  ASSERT_DOUBLE_EQ(segments[0].duration, 10);
+  ASSERT_EQ(segments[1].offset, 188u * 12);
+  ASSERT_DOUBLE_EQ(segments[2].duration, 5);
+  ASSERT_EQ(segments[2].offset + segments[2].size, 188u * 28);
+
+  std::string data;
+  ASSERT_TRUE(index.ReadSegment(path_template, 1, &data));
+  ASSERT_EQ(data.size(), 188u * 12);  // pat and pmt prepended
+  ASSERT_FALSE(index.ReadSegment(path_template, 3, &data));
+  const std::string playlist = index.RenderPlaylist("movie.ts.");
+  ASSERT_NE(playlist.find("#EXT-X-TARGETDURATION:10\n"), std::string::npos);
+  ASSERT_NE(playlist.find("movie.ts.2.ts\n#EXT-X-ENDLIST"), std::string::npos);
+  unlink(path_template);
+}
+#endif
+
+#if defined(OS_POSIX)
+TEST(TimeshiftPlaylist, delay_window) {
+  char dir_template[] = "/tmp/timeshift_playlist_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir_template));
+  const std::string dir = std::string(dir_template) + "/";
+  FILE* file = fopen((dir + CHUNKS_INDEX_NAME).c_str(), "wb");
+  ASSERT_TRUE(file);
+  for (uint64_t i = 0; i < 10; ++i) {
+    const fastocloud::ChunkIndexEntry entry = {i + 1, static_cast<int64_t>(1000 + i * 10) * 1000, 10000, 1024};
+    ASSERT_EQ(fwrite(&entry, sizeof(entry), 1, file), 1u);
+  }
+  fclose(file);
+
+  const common::file_system::ascii_directory_string_path path(dir);
+  std::string playlist;
+  ASSERT_FALSE(fastocloud::MakeTimeshiftPlaylist(path, 1100, 95, 3, &playlist));  // nothing closed by 1005
+  ASSERT_TRUE(fastocloud::MakeTimeshiftPlaylist(path, 1100, 55, 3, &playlist));   // 1045, chunks 1..4 closed
+  ASSERT_NE(playlist.find("#EXT-X-MEDIA-SEQUENCE:2\n"), std::string::npos);
+  ASSERT_NE(playlist.find("#EXTINF:10.000,\n4.ts\n"), std::string::npos);
+  ASSERT_EQ(playlist.find("5.ts"), std::string::npos);
+  ASSERT_TRUE(fastocloud::MakeTimeshiftPlaylist(path, 1100, 0, 3, &playlist));
+  ASSERT_NE(playlist.find("#EXTINF:10.000,\n10.ts\n"), std::string::npos);
+
+  file = fopen((dir + CHUNKS_INDEX_NAME).c_str(), "ab");
+  ASSERT_TRUE(file);
+  const fastocloud::ChunkIndexEntry last = {11, 1100000, 9960, 1024};  // duration from pts, not rounded
+  ASSERT_EQ(fwrite(&last, sizeof(last), 1, file), 1u);
+  fclose(file);
+  ASSERT_TRUE(fastocloud::MakeTimeshiftPlaylist(path, 1110, 0, 3, &playlist));
+  ASSERT_NE(playlist.find("#EXTINF:9.960,\n11.ts\n"), std::string::npos);
+
+  remove((dir + CHUNKS_INDEX_NAME).c_str());
+  rmdir(dir_template);
+}
+#endif
+
+#if defined(OS_POSIX)
+TEST(TimeshiftPlaylist, hour_file_ranges) {
+  char dir_template[] = "/tmp/timeshift_ranges_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir_template));
+  const std::string dir = std::string(dir_template) + "/";
+  const std::string hour_file = dir + fastocloud::MakeChunkHourFileName(3600 + 10);
+  FILE* file = fopen(hour_file.c_str(), "wb");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(fwrite("aaaabbbbbbcc", 1, 12, file), 12u);
+  fclose(file);
+  file = fopen((dir + CHUNK_RANGES_INDEX_NAME).c_str(), "wb");
+  ASSERT_TRUE(file);
+  const fastocloud::ChunkRangeEntry entries[] = {
+      {5, 3600000, 10000, 4, 0}, {6, 3610000, 10000, 6, 4}, {7, 3620000, 10000, 2, 10}};
+  ASSERT_EQ(fwrite(entries, sizeof(entries[0]), 3, file), 3u);
+  fclose(file);
+
+  const common::file_system::ascii_directory_string_path path(dir);
+  std::string playlist;
+  ASSERT_TRUE(fastocloud::MakeTimeshiftPlaylist(path, 3640, 15, 6, &playlist));  // 3625, chunks 5..6 closed
+  ASSERT_NE(playlist.find("#EXT-X-MEDIA-SEQUENCE:5\n"), std::string::npos);
+  ASSERT_NE(playlist.find("\n6.ts\n"), std::string::npos);
+  ASSERT_EQ(playlist.find("7.ts"), std::string::npos);
+
+  std::string chunk;
+  ASSERT_TRUE(fastocloud::ReadChunkRange(path, 6, &chunk));
+  ASSERT_EQ(chunk, "bbbbbb");
+  ASSERT_TRUE(fastocloud::ReadChunkRange(path, 7, &chunk));
+  ASSERT_EQ(chunk, "cc");
+  ASSERT_FALSE(fastocloud::ReadChunkRange(path, 8, &chunk));
+
+  remove(hour_file.c_str());
+  remove((dir + CHUNK_RANGES_INDEX_NAME).c_str());
+  rmdir(dir_template);
+}
+#endif
+
+TEST(PacketIngest, parse_udp_datagram) {
+  uint8_t packet[] = {0x45, 0,    0,    32,   0,    1,    0x40, 0,    64,  17,  0,   0,   10,  0,   0,   1,
+                      239,  1,    2,    3,    0x30, 0x39, 0x04, 0xd2, 0,   12,  0,   0,   'a', 'b', 'c', 'd'};
+  uint32_t group = 0;
+  uint16_t port = 0;
+  const uint8_t* payload = nullptr;
+  size_t payload_size = 0;
+  ASSERT_TRUE(fastocloud::server::ParseUdpDatagram(packet, sizeof(packet), &group, &port, &payload, &payload_size));
+  ASSERT_EQ(group, 0xEF010203u);
+  ASSERT_EQ(port, 1234);
+  ASSERT_EQ(payload_size, 4u);
+  ASSERT_EQ(payload[0], 'a');
+  ASSERT_FALSE(fastocloud::server::ParseUdpDatagram(packet, 24, &group, &port, &payload, &payload_size));
+
+  packet[6] = 0x20;  // more fragments
+  ASSERT_FALSE(fastocloud::server::ParseUdpDatagram(packet, sizeof(packet), &group, &port, &payload, &payload_size));
+  packet[6] = 0x40;
+  packet[9] = 6;  // tcp
+  ASSERT_FALSE(fastocloud::server::ParseUdpDatagram(packet, sizeof(packet), &group, &port, &payload, &payload_size));
+
+  fastocloud::server::PacketIngest ingest("fastocloud_no_such_iface");
+  ASSERT_TRUE(ingest.Start());
+  ASSERT_EQ(ingest.GetChannelsCount(), 0u);
+}
@@ -0,0 +1,414 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <common/file_system/file_system.h>
+#include <common/macros.h>
+#include <common/sprintf.h>
+
+#include "base/config_fields.h"
+#include "base/stream_config.h"
+#include "base/stream_config_parse.h"
+
+#include "stream/configs_factory.h"
+#include "stream/ibase_stream.h"
+#include "stream/streams_factory.h"
+#include "stream/timeshift.h"
+
+#include "../bench_utils.h"
+
+// usage: bench_captures --capture=channel.ts [--types=relay,encode,timeshift,mosaic] [--speeds=1,4]
+//                       [--video_codec=x264enc] [--mosaic_inputs=4] [--port=20000]
+// replays recorded mpegts capture over local udp into each stream type, realtime (speed 1) or faster,
+// prints json report with throughput, cpu and latency into stdout
+// capture has no arrival times, datagrams paced by pcr of first pcr pid, so sender mux rate is preserved
+
+#define DEFAULT_TYPES "relay,encode,timeshift,mosaic"
+#define DEFAULT_SPEEDS "1,4"
+#define DEFAULT_VIDEO_CODEC "x264enc"
+#define DEFAULT_MOSAIC_INPUTS 4
+#define DEFAULT_PORT 20000
+#define OUTPUT_PORT_OFFSET 100  // nobody listens there, udpsink output only costs send
+#define TS_PACKET_SIZE 188
+#define TS_PACKETS_IN_DATAGRAM 7
+#define PCR_CLOCK_HZ 27000000.0
+#define PCR_MAX_GAP_SEC 1.0  // bigger or negative pcr step is discontinuity
+#define START_DELAY_SEC 2    // pipeline goes playing before first datagram
+#define TAIL_SEC 2           // queued data drained before quit
+#define CHUNK_LIFE_TIME_SEC 600
+#define WORK_DIR_TEMPLATE "/tmp/bench_captures_XXXXXX"
+
+namespace {
+
+struct BenchOptions {
+  std::string capture;
+  std::vector<std::string> types;
+  std::vector<double> speeds;
+  std::string video_codec;
+  int mosaic_inputs;
+  int port;
+};
+
+struct Capture {
+  std::vector<char> data;
+  std::vector<double> send_sec;  // of each datagram, relative to first
+};
+
+struct BenchResult {
+  std::string error;
+  double elapsed_sec;
+  double cpu_percent;
+  long rss_kb;
+  uint64_t input_bytes;
+  uint64_t output_bytes;
+  fastotv::timestamp_t latency_p50_msec;
+  fastotv::timestamp_t latency_p99_msec;
+};
+
+bool parse_options(int argc, char** argv, BenchOptions* options) {
+  std::string types = DEFAULT_TYPES;
+  std::string speeds = DEFAULT_SPEEDS;
+  options->video_codec = DEFAULT_VIDEO_CODEC;
+  options->mosaic_inputs = DEFAULT_MOSAIC_INPUTS;
+  options->port = DEFAULT_PORT;
+  fastocloud::bench::key_values_t args;
+  if (!fastocloud::bench::parse_key_values(argc, argv, &args)) {
+    return false;
+  }
+
+  for (const auto& arg : args) {
+    const std::string& key = arg.first;
+    const std::string& value = arg.second;
+    if (key == "capture") {
+      options->capture = value;
+    } else if (key == "types") {
+      types = value;
+    } else if (key == "speeds") {
+      speeds = value;
+    } else if (key == "video_codec") {
+      options->video_codec = value;
+    } else if (key == "mosaic_inputs") {
+      options->mosaic_inputs = atoi(value.c_str());
+    } else if (key == "port") {
+      options->port = atoi(value.c_str());
+    } else {
+      fprintf(stderr, "Unknown argument: --%s\n", key.c_str());
+      return false;
+    }
+  }
+
+  options->types = fastocloud::bench::split(types, ',');
+  for (const std::string& speed_str : fastocloud::bench::split(speeds, ',')) {
+    const double speed = atof(speed_str.c_str());
+    if (speed <= 0) {
+      fprintf(stderr, "Invalid speed: %s\n", speed_str.c_str());
+      return false;
+    }
+    options->speeds.push_back(speed);
+  }
+  return !options->capture.empty() && !options->types.empty() && !options->speeds.empty() &&
+         options->mosaic_inputs > 1 && options->port > 0;
+}
+
+bool read_pcr(const unsigned char* packet, int* pid, uint64_t* pcr) {
+  const bool have_adaptation = packet[3] & 0x20;
+  if (packet[0] != 0x47 || !have_adaptation || packet[4] < 7 || !(packet[5] & 0x10)) {
+    return false;
+  }
+
+  const uint64_t base = (static_cast<uint64_t>(packet[6]) << 25) | (packet[7] << 17) | (packet[8] << 9) |
+                        (packet[9] << 1) | (packet[10] >> 7);
+  const uint64_t ext = ((packet[10] & 0x01) << 8) | packet[11];
+  *pid = ((packet[1] & 0x1f) << 8) | packet[2];
+  *pcr = base * 300 + ext;
+  return true;
+}
+
+// datagrams timed by pcrs of first pcr pid, interpolated between them and extrapolated with last rate after
+// discontinuity and at end, packets before first pcr sent at once
+bool load_capture(const std::string& path, Capture* capture) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  char buff[TS_PACKET_SIZE * TS_PACKETS_IN_DATAGRAM];
+  size_t readed;
+  while ((readed = fread(buff, 1, sizeof(buff), file)) > 0) {
+    capture->data.insert(capture->data.end(), buff, buff + readed);
+  }
+  fclose(file);
+
+  const size_t packets = capture->data.size() / TS_PACKET_SIZE;
+  std::vector<std::pair<size_t, double>> anchors;  // packet index => sec
+  int pcr_pid = -1;
+  uint64_t prev_pcr = 0;
+  double sec_per_packet = 0;
+  for (size_t i = 0; i < packets; ++i) {
+    const unsigned char* packet = reinterpret_cast<const unsigned char*>(capture->data.data()) + i * TS_PACKET_SIZE;
+    int pid;
+    uint64_t pcr;
+    if (!read_pcr(packet, &pid, &pcr) || (pcr_pid != -1 && pid != pcr_pid)) {
+      continue;
+    }
+
+    if (pcr_pid == -1) {
+      pcr_pid = pid;
+      anchors.push_back(std::make_pair(i, 0.0));
+    } else {
+      const double delta = (static_cast<double>(pcr) - static_cast<double>(prev_pcr)) / PCR_CLOCK_HZ;
+      const size_t step = i - anchors.back().first;
+      if (delta > 0 && delta <= PCR_MAX_GAP_SEC) {
+        sec_per_packet = delta / step;
+      }
+      anchors.push_back(std::make_pair(i, anchors.back().second + sec_per_packet * step));
+    }
+    prev_pcr = pcr;
+  }
+
+  if (anchors.empty()) {
+    return false;
+  }
+
+  size_t cur = 0;
+  for (size_t i = 0; i < packets; i += TS_PACKETS_IN_DATAGRAM) {
+    while (cur + 1 < anchors.size() && anchors[cur + 1].first <= i) {
+      cur++;
+    }
+
+    const std::pair<size_t, double>& prev = anchors[cur];
+    double sec = prev.second;
+    if (i > prev.first && cur + 1 < anchors.size()) {
+      const std::pair<size_t, double>& next = anchors[cur + 1];
+      sec += (next.second - prev.second) * (i - prev.first) / (next.first - prev.first);
+    } else if (i > prev.first) {
+      sec += sec_per_packet * (i - prev.first);
+    }
+    capture->send_sec.push_back(sec);
+  }
+  return true;
+}
+
+// sends capture to each port, quits stream when all sent and drained
+void replay(const Capture* capture, double speed, std::vector<int> ports, fastocloud::stream::IBaseStream* job) {
+  std::this_thread::sleep_for(std::chrono::seconds(START_DELAY_SEC));
+  const int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  std::vector<struct sockaddr_in> addrs;
+  for (int port : ports) {
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addrs.push_back(addr);
+  }
+
+  const size_t datagram_size = TS_PACKET_SIZE * TS_PACKETS_IN_DATAGRAM;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < capture->send_sec.size() && sock != -1; ++i) {
+    const auto at = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(capture->send_sec[i] / speed));
+    std::this_thread::sleep_until(at);
+    const size_t offset = i * datagram_size;
+    const size_t size = std::min(datagram_size, capture->data.size() - offset);
+    for (const struct sockaddr_in& addr : addrs) {
+      const struct sockaddr* dest = reinterpret_cast<const struct sockaddr*>(&addr);
+      ignore_result(sendto(sock, capture->data.data() + offset, size, 0, dest, sizeof(addr)));
+    }
+  }
+  if (sock != -1) {
+    close(sock);
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(TAIL_SEC));
+  job->Quit(fastocloud::stream::EXIT_SELF);
+}
+
+std::string make_inputs(int port, int count) {
+  std::string inputs;
+  for (int i = 0; i < count; ++i) {
+    inputs += common::MemSPrintf("%s{\"id\": %d, \"uri\": \"udp://127.0.0.1:%d\"}", i ? ", " : "", i, port + i);
+  }
+  return inputs;
+}
+
+// config json of stream type, empty if unknown
+std::string make_stream_json(const std::string& type, const BenchOptions& options, const std::string& work_dir) {
+  const std::string output = common::MemSPrintf("{\"id\": 0, \"uri\": \"udp://127.0.0.1:%d\"}",
+                                                options.port + OUTPUT_PORT_OFFSET);
+  const std::string shared = common::MemSPrintf(
+      "\"" ID_FIELD "\": \"bench_%s\", \"" FEEDBACK_DIR_FIELD "\": \"%s\", \"" LATENCY_STATS_FIELD "\": true",
+      type.c_str(), work_dir.c_str());
+  if (type == "relay") {
+    return common::MemSPrintf("{%s, \"" TYPE_FIELD "\": %d, \"" INPUT_FIELD "\": [%s], \"" OUTPUT_FIELD "\": [%s]}",
+                              shared.c_str(), static_cast<int>(fastotv::RELAY), make_inputs(options.port, 1).c_str(),
+                              output.c_str());
+  } else if (type == "encode") {
+    return common::MemSPrintf("{%s, \"" TYPE_FIELD "\": %d, \"" INPUT_FIELD "\": [%s], \"" OUTPUT_FIELD
+                              "\": [%s], \"" VIDEO_CODEC_FIELD "\": \"%s\"}",
+                              shared.c_str(), static_cast<int>(fastotv::ENCODE), make_inputs(options.port, 1).c_str(),
+                              output.c_str(), options.video_codec.c_str());
+  } else if (type == "timeshift") {
+    return common::MemSPrintf("{%s, \"" TYPE_FIELD "\": %d, \"" INPUT_FIELD "\": [%s], \"" TIMESHIFT_DIR_FIELD
+                              "\": \"%s\"}",
+                              shared.c_str(), static_cast<int>(fastotv::TIMESHIFT_RECORDER),
+                              make_inputs(options.port, 1).c_str(), work_dir.c_str());
+  } else if (type == "mosaic") {
+    return common::MemSPrintf("{%s, \"" TYPE_FIELD "\": %d, \"" INPUT_FIELD "\": [%s], \"" OUTPUT_FIELD
+                              "\": [%s], \"" VIDEO_CODEC_FIELD "\": \"%s\", \"" SIZE_FIELD "\": \"1920x1080\"}",
+                              shared.c_str(), static_cast<int>(fastotv::ENCODE),
+                              make_inputs(options.port, options.mosaic_inputs).c_str(), output.c_str(),
+                              options.video_codec.c_str());
+  }
+  return std::string();
+}
+
+BenchResult run_bench(const std::string& type,
+                      double speed,
+                      const Capture& capture,
+                      const BenchOptions& options,
+                      const std::string& work_dir) {
+  BenchResult result = {};
+  const std::string json = make_stream_json(type, options, work_dir);
+  if (json.empty()) {
+    result.error = "unknown type";
+    return result;
+  }
+
+  const fastocloud::StreamConfig config_args = fastocloud::MakeConfigFromJson(json);
+  fastocloud::StreamInfo info;
+  std::string feedback_dir;
+  common::logging::LOG_LEVEL logs_level;
+  common::ErrnoError errn = fastocloud::MakeStreamInfo(config_args, false, &info, &feedback_dir, &logs_level);
+  if (errn) {
+    result.error = errn->GetDescription();
+    return result;
+  }
+
+  fastocloud::stream::Config* lconfig = nullptr;
+  common::Error err = fastocloud::stream::make_config(config_args, &lconfig);
+  if (err) {
+    result.error = err->GetDescription();
+    return result;
+  }
+
+  const std::unique_ptr<fastocloud::stream::Config> config(lconfig);
+  fastocloud::StreamStruct stats(info);
+  fastocloud::stream::TimeShiftInfo tinfo(work_dir, CHUNK_LIFE_TIME_SEC, 0);
+  fastocloud::stream::IBaseStream* job = fastocloud::stream::StreamsFactory::GetInstance().CreateStream(
+      config.get(), nullptr, &stats, tinfo, fastocloud::stream::invalid_chunk_index);
+  if (!job) {
+    result.error = "stream not created";
+    return result;
+  }
+
+  std::vector<int> ports;
+  for (size_t i = 0; i < info.input.size(); ++i) {
+    ports.push_back(options.port + i);
+  }
+
+  struct rusage usage_start;
+  getrusage(RUSAGE_SELF, &usage_start);
+  const auto start = std::chrono::steady_clock::now();
+  std::thread th(replay, &capture, speed, ports, job);
+  job->Exec();
+  th.join();
+  const auto stop = std::chrono::steady_clock::now();
+  struct rusage usage_stop;
+  getrusage(RUSAGE_SELF, &usage_stop);
+
+  result.elapsed_sec = std::chrono::duration<double>(stop - start).count() - START_DELAY_SEC - TAIL_SEC;
+  const double run_sec = result.elapsed_sec + START_DELAY_SEC + TAIL_SEC;
+  const double cpu_sec = fastocloud::bench::cpu_time_sec(usage_stop) - fastocloud::bench::cpu_time_sec(usage_start);
+  result.cpu_percent = run_sec > 0 ? cpu_sec / run_sec * 100.0 : 0;
+  result.rss_kb = usage_stop.ru_maxrss;
+  for (const fastocloud::ChannelStats& input : stats.input) {
+    result.input_bytes += input.GetTotalBytes();
+  }
+  for (const fastocloud::ChannelStats& output : stats.output) {
+    result.output_bytes += output.GetTotalBytes();
+  }
+  const fastocloud::LatencyHistogram& latency = stats.latency[fastocloud::OUTPUT_LATENCY_STAGE];
+  result.latency_p50_msec = latency.GetPercentile(50);
+  result.latency_p99_msec = latency.GetPercentile(99);
+  delete job;
+  return result;
+}
+
+void print_result(const std::string& type, double speed, const BenchResult& result, bool last) {
+  printf("    {\"type\": \"%s\", \"speed\": %.2f", type.c_str(), speed);
+  if (!result.error.empty()) {
+    printf(", \"error\": \"%s\"", result.error.c_str());
+  }
+  const double input_mbps = result.elapsed_sec > 0 ? result.input_bytes * 8 / result.elapsed_sec / 1e6 : 0;
+  const double output_mbps = result.elapsed_sec > 0 ? result.output_bytes * 8 / result.elapsed_sec / 1e6 : 0;
+  printf(", \"elapsed_sec\": %.2f, \"input_mbps\": %.2f, \"output_mbps\": %.2f", result.elapsed_sec, input_mbps,
+         output_mbps);
+  printf(", \"latency_ms\": {\"p50\": %ld, \"p99\": %ld}", static_cast<long>(result.latency_p50_msec),
+         static_cast<long>(result.latency_p99_msec));
+  printf(", \"cpu_percent\": %.1f, \"rss_kb\": %ld}%s\n", result.cpu_percent, result.rss_kb, last ? "" : ",");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  if (!parse_options(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+
+  Capture capture;
+  if (!load_capture(options.capture, &capture)) {
+    fprintf(stderr, "Capture not readable or without pcr: %s\n", options.capture.c_str());
+    return EXIT_FAILURE;
+  }
+
+  char dir_template[] = WORK_DIR_TEMPLATE;
+  const char* work_dir = mkdtemp(dir_template);
+  if (!work_dir) {
+    fprintf(stderr, "Work directory not created: %s\n", dir_template);
+    return EXIT_FAILURE;
+  }
+
+  fastocloud::stream::streams_init(argc, argv);
+  const double duration_sec = capture.send_sec.empty() ? 0 : capture.send_sec.back();
+  printf("{\n  \"capture\": \"%s\", \"bytes\": %lu, \"duration_sec\": %.2f,\n  \"results\": [\n",
+         options.capture.c_str(), capture.data.size(), duration_sec);
+  for (size_t i = 0; i < options.types.size(); ++i) {
+    for (size_t j = 0; j < options.speeds.size(); ++j) {
+      const BenchResult result = run_bench(options.types[i], options.speeds[j], capture, options, work_dir);
+      print_result(options.types[i], options.speeds[j], result,
+                   i + 1 == options.types.size() && j + 1 == options.speeds.size());
+      fflush(stdout);
+    }
+  }
+  printf("  ]\n}\n");
+  fastocloud::stream::streams_deinit();
+  common::file_system::remove_directory(work_dir, true);
+  return EXIT_SUCCESS;
+}
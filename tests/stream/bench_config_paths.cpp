@@ -0,0 +1,212 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+
+#include <common/file_system/file_system.h>
+#include <common/macros.h>
+#include <common/sprintf.h>
+#include <common/time.h>
+
+#include "base/config_fields.h"
+#include "base/stream_config_parse.h"
+#include "base/types.h"
+
+#include "stream/configs_factory.h"
+#include "stream/link_generator/ilink_generator.h"
+#include "stream/stypes.h"
+#include "stream/timeshift.h"
+
+#include "../bench_utils.h"
+
+// usage: bench_config_paths [--iterations=10000] [--chunks=8640] [--filter=name]
+// times config and timeshift paths of stream start on generated data, prints json report into stdout
+
+#define DEFAULT_ITERATIONS 10000
+#define DEFAULT_CHUNKS 8640  // day of 10 sec chunks
+#define CHUNK_DURATION_SEC 10
+#define TIMESHIFT_DIR_TEMPLATE "/tmp/bench_timeshift_XXXXXX"
+
+namespace {
+
+struct BenchOptions {
+  size_t iterations;
+  size_t chunks;
+  std::string filter;
+};
+
+bool parse_options(int argc, char** argv, BenchOptions* options) {
+  options->iterations = DEFAULT_ITERATIONS;
+  options->chunks = DEFAULT_CHUNKS;
+  fastocloud::bench::key_values_t args;
+  if (!fastocloud::bench::parse_key_values(argc, argv, &args)) {
+    return false;
+  }
+
+  for (const auto& arg : args) {
+    const std::string& key = arg.first;
+    const std::string& value = arg.second;
+    if (key == "iterations") {
+      options->iterations = strtoul(value.c_str(), nullptr, 10);
+    } else if (key == "chunks") {
+      options->chunks = strtoul(value.c_str(), nullptr, 10);
+    } else if (key == "filter") {
+      options->filter = value;
+    } else {
+      fprintf(stderr, "Unknown argument: --%s\n", key.c_str());
+      return false;
+    }
+  }
+  return options->iterations > 0 && options->chunks > 0;
+}
+
+// resolves nothing, copy made as for stream without generated links
+class NullLinkGenerator : public fastocloud::stream::link_generator::ILinkGenerator {
+ public:
+  bool Generate(const fastocloud::InputUri& src, fastocloud::InputUri* out) const override {
+    UNUSED(src);
+    UNUSED(out);
+    return false;
+  }
+};
+
+std::string make_stream_json() {
+  return common::MemSPrintf(
+      "{\"" ID_FIELD "\": \"stream_0\", \"" TYPE_FIELD "\": %d, "
+      "\"" INPUT_FIELD "\": [{\"id\": 0, \"uri\": \"udp://239.0.0.1:1234\"}, "
+      "{\"id\": 1, \"uri\": \"udp://239.0.0.2:1234\"}], "
+      "\"" OUTPUT_FIELD "\": [{\"id\": 0, \"uri\": \"rtmp://live.example.com/app/stream_0\"}, "
+      "{\"id\": 1, \"uri\": \"rtmp://backup.example.com/app/stream_0\"}], "
+      "\"" VIDEO_CODEC_FIELD "\": \"x264enc\", \"" AUDIO_CODEC_FIELD "\": \"faac\", \"" SIZE_FIELD "\": \"1280x720\", "
+      "\"" VIDEO_BIT_RATE_FIELD "\": 4000000, \"" AUDIO_BIT_RATE_FIELD "\": 128000, \"" FRAME_RATE_FIELD "\": 25}",
+      static_cast<int>(fastotv::ENCODE));
+}
+
+// chunks of last chunks * 10 sec recorded into dir, index kept in sync
+bool make_timeshift(const std::string& dir, size_t chunks, fastocloud::stream::TimeShiftInfo* info) {
+  const int64_t now_msec = common::time::current_utc_mstime();
+  const int64_t start_msec = now_msec - static_cast<int64_t>(chunks) * CHUNK_DURATION_SEC * 1000;
+  // player starts in the middle of recorded day
+  const time_t delay_min = static_cast<time_t>(chunks) * CHUNK_DURATION_SEC / 60 / 2;
+  *info = fastocloud::stream::TimeShiftInfo(dir, chunks * CHUNK_DURATION_SEC, delay_min);
+  for (size_t i = 0; i < chunks; ++i) {
+    const std::string path = common::MemSPrintf("%s/%lu" CHUNK_EXT, dir, i);
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+      return false;
+    }
+    fclose(file);
+
+    const fastocloud::ChunkIndexEntry entry = {i, start_msec + static_cast<int64_t>(i) * CHUNK_DURATION_SEC * 1000,
+                                               CHUNK_DURATION_SEC * 1000, 0};
+    if (!info->AppendChunk(entry)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class Report {
+ public:
+  explicit Report(const BenchOptions& options) : options_(options), count_(0), sink_(0) {
+    printf("{\n  \"iterations\": %lu,\n  \"chunks\": %lu,\n  \"results\": [", options_.iterations, options_.chunks);
+  }
+
+  ~Report() { printf("\n  ]\n}\n"); }
+
+  // func returns something derived from its work, so calls are not optimized out
+  template <typename F>
+  void Measure(const std::string& name, F func) {
+    if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+      return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < options_.iterations; ++i) {
+      sink_ += func(i);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    printf("%s\n    {\"name\": \"%s\", \"ns_per_op\": %.1f, \"ops_per_sec\": %.0f}", count_ ? "," : "", name.c_str(),
+           ns / options_.iterations, ns > 0 ? options_.iterations * 1e9 / ns : 0);
+    fflush(stdout);
+    count_++;
+  }
+
+  size_t GetSink() const { return sink_; }
+
+ private:
+  const BenchOptions options_;
+  size_t count_;
+  size_t sink_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  if (!parse_options(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+
+  const std::string stream_json = make_stream_json();
+  const fastocloud::StreamConfig stream_config = fastocloud::MakeConfigFromJson(stream_json);
+  fastocloud::stream::Config* config = nullptr;
+  common::Error err = fastocloud::stream::make_config(stream_config, &config);
+  if (err) {
+    fprintf(stderr, "Invalid stream config: %s\n", err->GetDescription().c_str());
+    return EXIT_FAILURE;
+  }
+
+  char dir_template[] = TIMESHIFT_DIR_TEMPLATE;
+  const char* dir = mkdtemp(dir_template);
+  fastocloud::stream::TimeShiftInfo timeshift;
+  if (!dir || !make_timeshift(dir, options.chunks, &timeshift)) {
+    fprintf(stderr, "Timeshift not recorded: %s\n", dir_template);
+    delete config;
+    return EXIT_FAILURE;
+  }
+
+  {
+    Report report(options);
+    report.Measure("make_config", [&stream_config](size_t) {
+      fastocloud::stream::Config* lconfig = nullptr;
+      common::Error err_make = fastocloud::stream::make_config(stream_config, &lconfig);
+      delete lconfig;
+      return err_make ? 0 : 1;
+    });
+    const NullLinkGenerator generator;
+    report.Measure("make_config_copy", [config, &generator](size_t) {
+      fastocloud::stream::Config* copy = fastocloud::stream::make_config_copy(config, &generator);
+      delete copy;
+      return copy ? 1 : 0;
+    });
+    report.Measure("TimeShiftInfo::FindChunkToPlay", [&timeshift](size_t) {
+      fastocloud::stream::chunk_index_t index;
+      return timeshift.FindChunkToPlay(CHUNK_DURATION_SEC, &index) ? 1 : 0;
+    });
+  }
+
+  delete config;
+  common::ErrnoError errn = common::file_system::remove_directory(dir, true);
+  if (errn) {
+    fprintf(stderr, "Timeshift not removed: %s\n", dir);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,335 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gst/gst.h>
+
+#include <common/macros.h>
+
+#include "base/gst_constants.h"
+
+#include "stream/elements/encoders/video.h"
+#include "stream/gst_types.h"
+#include "stream/gstreamer_utils.h"
+#include "stream/ibase_stream.h"
+#include "stream/ilinker.h"
+
+#include "../bench_utils.h"
+
+// usage: bench_encoders [--encoders=x264enc,nvh264enc] [--sizes=1280x720,1920x1080] [--frames=300]
+//                       [--framerate=25] [--bitrate=4096] [--param=x264enc.speed-preset=1 ...]
+// prints json report into stdout, encoders which are not installed reported with error
+
+#define DEFAULT_FRAMES 300
+#define DEFAULT_FRAMERATE 25
+#define DEFAULT_SIZE "1280x720"
+#define PIPELINE_TIMEOUT_SEC 600
+
+namespace {
+
+const char* const kAllEncoders[] = {X264_ENC,       X265_ENC,     OPEN_H264_ENC, NV_H264_ENC, NV_H265_ENC,
+                                    VAAPI_H264_ENC, MFX_H264_ENC, MSDK_H264_ENC, EAVC_ENC};
+
+struct Size {
+  int width;
+  int height;
+};
+
+struct BenchOptions {
+  std::vector<std::string> encoders;
+  std::vector<Size> sizes;
+  int frames;
+  int framerate;
+  fastocloud::bit_rate_t bitrate;
+  fastocloud::stream::video_encoders_args_t args;
+};
+
+struct BenchResult {
+  std::string error;
+  guint64 frames;
+  double elapsed_sec;
+  double cpu_percent;
+  long rss_kb;
+  double bitrate_kbps;
+  std::vector<gint64> latencies_us;
+};
+
+// per frame latency and output size, filled from streaming threads
+struct Measure {
+  std::mutex lock;
+  std::map<GstClockTime, gint64> in_flight;  // pts => time frame entered encoder
+  std::vector<gint64> latencies_us;
+  guint64 bytes = 0;
+  guint64 frames = 0;
+};
+
+class BenchLinker : public fastocloud::stream::ILinker {
+ public:
+  explicit BenchLinker(GstElement* pipeline) : pipeline_(pipeline), elements_() {}
+  ~BenchLinker() override {
+    for (fastocloud::stream::elements::Element* element : elements_) {
+      delete element;
+    }
+  }
+
+  bool ElementAdd(fastocloud::stream::elements::Element* elem) override {
+    elements_.push_back(elem);
+    return gst_bin_add(GST_BIN(pipeline_), elem->GetGstElement());
+  }
+
+  bool ElementLink(fastocloud::stream::elements::Element* src, fastocloud::stream::elements::Element* dest) override {
+    return gst_element_link(src->GetGstElement(), dest->GetGstElement());
+  }
+
+  bool ElementRemove(fastocloud::stream::elements::Element* elem) override {
+    return gst_bin_remove(GST_BIN(pipeline_), elem->GetGstElement());
+  }
+
+  bool ElementLinkRemove(fastocloud::stream::elements::Element* src,
+                         fastocloud::stream::elements::Element* dest) override {
+    gst_element_unlink(src->GetGstElement(), dest->GetGstElement());
+    return true;
+  }
+
+ private:
+  GstElement* const pipeline_;
+  std::vector<fastocloud::stream::elements::Element*> elements_;
+};
+
+bool parse_options(int argc, char** argv, BenchOptions* options) {
+  options->frames = DEFAULT_FRAMES;
+  options->framerate = DEFAULT_FRAMERATE;
+  std::string sizes = DEFAULT_SIZE;
+  fastocloud::bench::key_values_t args;
+  if (!fastocloud::bench::parse_key_values(argc, argv, &args)) {
+    return false;
+  }
+
+  for (const auto& arg : args) {
+    const std::string& key = arg.first;
+    const std::string& value = arg.second;
+    if (key == "encoders") {
+      options->encoders = fastocloud::bench::split(value, ',');
+    } else if (key == "sizes") {
+      sizes = value;
+    } else if (key == "frames") {
+      options->frames = atoi(value.c_str());
+    } else if (key == "framerate") {
+      options->framerate = atoi(value.c_str());
+    } else if (key == "bitrate") {
+      options->bitrate = atoi(value.c_str());
+    } else if (key == "param") {
+      const size_t peq = value.rfind('=');
+      if (peq == std::string::npos) {
+        fprintf(stderr, "Invalid param: %s\n", value.c_str());
+        return false;
+      }
+      options->args[value.substr(0, peq)] = atoi(value.substr(peq + 1).c_str());
+    } else {
+      fprintf(stderr, "Unknown argument: --%s\n", key.c_str());
+      return false;
+    }
+  }
+
+  if (options->encoders.empty()) {
+    options->encoders.assign(std::begin(kAllEncoders), std::end(kAllEncoders));
+  }
+
+  for (const std::string& size_str : fastocloud::bench::split(sizes, ',')) {
+    Size size;
+    if (sscanf(size_str.c_str(), "%dx%d", &size.width, &size.height) != 2 || size.width <= 0 || size.height <= 0) {
+      fprintf(stderr, "Invalid size: %s\n", size_str.c_str());
+      return false;
+    }
+    options->sizes.push_back(size);
+  }
+  return options->frames > 0 && options->framerate > 0 && !options->sizes.empty();
+}
+
+GstPadProbeReturn encoder_input_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  Measure* measure = static_cast<Measure*>(user_data);
+  GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  std::unique_lock<std::mutex> lock(measure->lock);
+  measure->in_flight[GST_BUFFER_PTS(buffer)] = g_get_monotonic_time();
+  return GST_PAD_PROBE_OK;
+}
+
+GstPadProbeReturn encoder_output_probe(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+  UNUSED(pad);
+  Measure* measure = static_cast<Measure*>(user_data);
+  GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  const gint64 now = g_get_monotonic_time();
+  std::unique_lock<std::mutex> lock(measure->lock);
+  measure->bytes += gst_buffer_get_size(buffer);
+  measure->frames++;
+  auto it = measure->in_flight.find(GST_BUFFER_PTS(buffer));
+  if (it != measure->in_flight.end()) {
+    measure->latencies_us.push_back(now - it->second);
+    measure->in_flight.erase(it);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+BenchResult run_bench(const std::string& codec, const Size& size, const BenchOptions& options) {
+  BenchResult result = {};
+  if (!fastocloud::stream::is_element_available(codec)) {
+    result.error = "not available";
+    return result;
+  }
+
+  GstElement* pipeline = gst_pipeline_new("bench");
+  GstElement* src = fastocloud::bench::add_element(pipeline, VIDEO_TEST_SRC);
+  GstElement* caps = fastocloud::bench::add_element(pipeline, CAPS_FILTER);
+  GstElement* convert = fastocloud::bench::add_element(pipeline, VIDEO_CONVERT);
+  GstElement* sink = fastocloud::bench::add_element(pipeline, FAKE_SINK);
+  if (!src || !caps || !convert || !sink) {
+    gst_object_unref(pipeline);
+    result.error = "base plugins not available";
+    return result;
+  }
+
+  g_object_set(src, "num-buffers", options.frames, nullptr);
+  GstCaps* raw_caps = gst_caps_new_simple("video/x-raw", "width", G_TYPE_INT, size.width, "height", G_TYPE_INT,
+                                          size.height, "framerate", GST_TYPE_FRACTION, options.framerate, 1, nullptr);
+  g_object_set(caps, "caps", raw_caps, nullptr);
+  gst_caps_unref(raw_caps);
+  g_object_set(sink, "sync", FALSE, nullptr);
+
+  Measure measure;
+  BenchLinker* linker = new BenchLinker(pipeline);
+  fastocloud::stream::elements_line_t encoder = fastocloud::stream::elements::encoders::build_video_encoder(
+      codec, options.bitrate, options.args, fastocloud::stream::video_encoders_str_args_t(), linker, 0);
+  GstElement* first = encoder.front()->GetGstElement();
+  GstElement* last = encoder.back()->GetGstElement();
+  if (!gst_element_link_many(src, caps, convert, first, nullptr) || !gst_element_link(last, sink)) {
+    delete linker;
+    gst_object_unref(pipeline);
+    result.error = "failed to link";
+    return result;
+  }
+
+  GstPad* enc_sink = gst_element_get_static_pad(first, "sink");
+  gst_pad_add_probe(enc_sink, GST_PAD_PROBE_TYPE_BUFFER, encoder_input_probe, &measure, nullptr);
+  gst_object_unref(enc_sink);
+  GstPad* enc_src = gst_element_get_static_pad(last, "src");
+  gst_pad_add_probe(enc_src, GST_PAD_PROBE_TYPE_BUFFER, encoder_output_probe, &measure, nullptr);
+  gst_object_unref(enc_src);
+
+  struct rusage usage_start;
+  getrusage(RUSAGE_SELF, &usage_start);
+  const gint64 start = g_get_monotonic_time();
+  gst_element_set_state(pipeline, GST_STATE_PLAYING);
+  GstBus* bus = gst_element_get_bus(pipeline);
+  GstMessage* msg = gst_bus_timed_pop_filtered(bus, PIPELINE_TIMEOUT_SEC * GST_SECOND,
+                                               static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  const gint64 stop = g_get_monotonic_time();
+  struct rusage usage_stop;
+  getrusage(RUSAGE_SELF, &usage_stop);
+
+  if (!msg) {
+    result.error = "timeout";
+  } else if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_ERROR) {
+    GError* err = nullptr;
+    gst_message_parse_error(msg, &err, nullptr);
+    result.error = err ? err->message : "pipeline error";
+    g_clear_error(&err);
+  }
+  if (msg) {
+    gst_message_unref(msg);
+  }
+  gst_object_unref(bus);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+
+  result.elapsed_sec = (stop - start) / 1e6;
+  const double cpu_sec = fastocloud::bench::cpu_time_sec(usage_stop) - fastocloud::bench::cpu_time_sec(usage_start);
+  result.cpu_percent = result.elapsed_sec > 0 ? cpu_sec / result.elapsed_sec * 100.0 : 0;
+  result.rss_kb = usage_stop.ru_maxrss;
+  result.frames = measure.frames;
+  const double media_sec = static_cast<double>(options.frames) / options.framerate;
+  result.bitrate_kbps = measure.bytes * 8 / media_sec / 1000.0;
+  result.latencies_us = measure.latencies_us;
+  std::sort(result.latencies_us.begin(), result.latencies_us.end());
+
+  delete linker;
+  gst_object_unref(pipeline);
+  return result;
+}
+
+double percentile_ms(const std::vector<gint64>& sorted, double pct) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(pct / 100.0 * sorted.size()));
+  return sorted[index] / 1000.0;
+}
+
+std::string escape_json(const std::string& text) {
+  std::string result;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result;
+}
+
+void print_result(const std::string& codec, const Size& size, const BenchResult& result, bool last) {
+  printf("    {\"encoder\": \"%s\", \"size\": \"%dx%d\"", codec.c_str(), size.width, size.height);
+  if (!result.error.empty()) {
+    printf(", \"error\": \"%s\"", escape_json(result.error).c_str());
+  }
+  const double fps = result.elapsed_sec > 0 ? result.frames / result.elapsed_sec : 0;
+  printf(", \"frames\": %" G_GUINT64_FORMAT ", \"fps\": %.2f", result.frames, fps);
+  printf(", \"latency_ms\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+         percentile_ms(result.latencies_us, 50), percentile_ms(result.latencies_us, 90),
+         percentile_ms(result.latencies_us, 99), percentile_ms(result.latencies_us, 100));
+  printf(", \"cpu_percent\": %.1f, \"rss_kb\": %ld, \"bitrate_kbps\": %.1f}%s\n", result.cpu_percent, result.rss_kb,
+         result.bitrate_kbps, last ? "" : ",");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  if (!parse_options(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+
+  printf("{\n  \"frames\": %d, \"framerate\": %d,\n  \"results\": [\n", options.frames, options.framerate);
+  for (size_t i = 0; i < options.encoders.size(); ++i) {
+    const std::string& codec = options.encoders[i];
+    fastocloud::stream::EncoderType enc = fastocloud::stream::CPU;
+    fastocloud::stream::GetEncoderType(codec, &enc);
+    fastocloud::stream::streams_init(argc, argv, enc);
+    for (size_t j = 0; j < options.sizes.size(); ++j) {
+      const BenchResult result = run_bench(codec, options.sizes[j], options);
+      print_result(codec, options.sizes[j], result, i + 1 == options.encoders.size() && j + 1 == options.sizes.size());
+      fflush(stdout);
+    }
+  }
+  printf("  ]\n}\n");
+  fastocloud::stream::streams_deinit();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,257 @@
+/*  Copyright (C) 2014-2020 FastoGT. All right reserved.
+    This file is part of fastocloud.
+    fastocloud is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    fastocloud is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include <gst/gst.h>
+
+#include <common/macros.h>
+
+#include "base/constants.h"
+#include "base/gst_constants.h"
+
+#include "stream/ibase_stream.h"
+#include "stream/probes.h"
+#include "stream/streams/configs/audio_video_config.h"
+#include "stream/streams/screen_stream.h"
+
+#include "../bench_utils.h"
+
+// usage: bench_probes [--buffers=2000000] [--size=1316] [--list=64]
+// pushes buffers and buffer lists through src ! identity ! fakesink from main thread, without probes and with
+// input/output probes of stream linked as in real pipelines, prints json report with ns per buffer into stdout
+
+#define DEFAULT_BUFFERS 2000000
+#define DEFAULT_BUFFER_SIZE 1316  // 7 ts packets of udp datagram
+#define DEFAULT_LIST_SIZE 64
+
+namespace {
+
+struct BenchOptions {
+  guint64 buffers;
+  gsize size;
+  guint list;
+};
+
+enum ProbesMode { NO_PROBES = 0, STREAM_PROBES, STREAM_AND_LATENCY_PROBES };
+const char* const kModeNames[] = {"none", "probes", "probes_latency"};
+
+struct BenchResult {
+  std::string error;
+  guint64 buffers;
+  double ns_per_buffer;
+};
+
+// stream callbacks of probes, counts nothing by itself
+class BenchClient : public fastocloud::stream::IBaseStream::IStreamClient {
+ public:
+  void OnStatusChanged(fastocloud::stream::IBaseStream* stream, fastocloud::StreamStatus status) override {
+    UNUSED(stream);
+    UNUSED(status);
+  }
+  void OnPipelineEOS(fastocloud::stream::IBaseStream* stream) override { UNUSED(stream); }
+  void OnTimeoutUpdated(fastocloud::stream::IBaseStream* stream) override { UNUSED(stream); }
+  void OnStatisticUpdated(fastocloud::stream::IBaseStream* stream) override { UNUSED(stream); }
+  void OnInputProbeEvent(fastocloud::stream::IBaseStream* stream,
+                         fastocloud::stream::InputProbe* probe,
+                         GstEvent* event) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    UNUSED(event);
+  }
+  void OnOutputProbeEvent(fastocloud::stream::IBaseStream* stream,
+                          fastocloud::stream::OutputProbe* probe,
+                          GstEvent* event) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    UNUSED(event);
+  }
+  void OnSyncMessageReceived(fastocloud::stream::IBaseStream* stream, GstMessage* message) override {
+    UNUSED(stream);
+    UNUSED(message);
+  }
+  void OnASyncMessageReceived(fastocloud::stream::IBaseStream* stream, GstMessage* message) override {
+    UNUSED(stream);
+    UNUSED(message);
+  }
+  GstPadProbeInfo* OnCheckReveivedOutputData(fastocloud::stream::IBaseStream* stream,
+                                             fastocloud::stream::OutputProbe* probe,
+                                             GstPadProbeInfo* info) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    return info;
+  }
+  GstPadProbeInfo* OnCheckReveivedData(fastocloud::stream::IBaseStream* stream,
+                                       fastocloud::stream::InputProbe* probe,
+                                       GstPadProbeInfo* info) override {
+    UNUSED(stream);
+    UNUSED(probe);
+    return info;
+  }
+  void OnInputChanged(fastocloud::stream::IBaseStream* stream, const fastocloud::InputUri& uri) override {
+    UNUSED(stream);
+    UNUSED(uri);
+  }
+  void OnPipelineCreated(fastocloud::stream::IBaseStream* stream) override { UNUSED(stream); }
+#if defined(MACHINE_LEARNING)
+  void OnMlNotification(fastocloud::stream::IBaseStream* stream,
+                        const std::vector<fastotv::commands_info::ml::ImageBox>& images) override {
+    UNUSED(stream);
+    UNUSED(images);
+  }
+#endif
+};
+
+bool parse_options(int argc, char** argv, BenchOptions* options) {
+  options->buffers = DEFAULT_BUFFERS;
+  options->size = DEFAULT_BUFFER_SIZE;
+  options->list = DEFAULT_LIST_SIZE;
+  fastocloud::bench::key_values_t args;
+  if (!fastocloud::bench::parse_key_values(argc, argv, &args)) {
+    return false;
+  }
+
+  for (const auto& arg : args) {
+    const std::string& key = arg.first;
+    const std::string& value = arg.second;
+    if (key == "buffers") {
+      options->buffers = g_ascii_strtoull(value.c_str(), nullptr, 10);
+    } else if (key == "size") {
+      options->size = g_ascii_strtoull(value.c_str(), nullptr, 10);
+    } else if (key == "list") {
+      options->list = atoi(value.c_str());
+    } else {
+      fprintf(stderr, "Unknown argument: --%s\n", key.c_str());
+      return false;
+    }
+  }
+  return options->buffers > 0 && options->size > 0 && options->list > 0;
+}
+
+BenchResult run_bench(ProbesMode mode, bool lists, const BenchOptions& options) {
+  BenchResult result = {};
+  GstElement* pipeline = gst_pipeline_new("bench");
+  GstElement* identity = fastocloud::bench::add_element(pipeline, IDENTITY);
+  GstElement* sink = fastocloud::bench::add_element(pipeline, FAKE_SINK);
+  if (!identity || !sink || !gst_element_link(identity, sink)) {
+    gst_object_unref(pipeline);
+    result.error = "base plugins not available";
+    return result;
+  }
+  // buffers pushed from this thread, sink must not block on preroll or clock
+  g_object_set(sink, "sync", FALSE, "async", FALSE, nullptr);
+
+  GstPad* identity_sink = gst_element_get_static_pad(identity, "sink");
+  GstPad* sink_pad = gst_element_get_static_pad(sink, "sink");
+  GstPad* src = gst_pad_new("src", GST_PAD_SRC);
+  gst_pad_set_active(src, TRUE);
+  gst_pad_link(src, identity_sink);
+
+  BenchClient client;
+  fastocloud::stream::Config bconf(fastotv::SCREEN, 0, {fastocloud::InputUri(0, common::uri::Url(SCREEN_URL))},
+                                   {fastocloud::OutputUri(0, common::uri::Url(TEST_URL))});
+  bconf.SetLatencyStats(mode == STREAM_AND_LATENCY_PROBES);
+  fastocloud::stream::streams::AudioVideoConfig conf(bconf);
+  fastocloud::StreamStruct stats(fastocloud::StreamInfo{"bench", fastotv::SCREEN, {}, bconf.GetOutput()});
+  fastocloud::stream::IBaseStream* stream = nullptr;
+  if (mode != NO_PROBES) {
+    stream = new fastocloud::stream::streams::ScreenStream(&conf, &client, &stats);
+    stream->LinkInputPad(identity_sink, 0, common::uri::Url(SCREEN_URL));
+    stream->LinkOutputPad(sink_pad, 0, common::uri::Url(TEST_URL), false);
+  }
+
+  gst_element_set_state(pipeline, GST_STATE_PLAYING);
+  gst_pad_push_event(src, gst_event_new_stream_start("bench"));
+  GstCaps* caps = gst_caps_new_empty_simple("video/mpegts");
+  gst_pad_push_event(src, gst_event_new_caps(caps));
+  gst_caps_unref(caps);
+  GstSegment segment;
+  gst_segment_init(&segment, GST_FORMAT_TIME);
+  gst_pad_push_event(src, gst_event_new_segment(&segment));
+
+  // same buffer pushed again, payload allocation not measured
+  GstBuffer* buffer = gst_buffer_new_allocate(nullptr, options.size, nullptr);
+  GstBufferList* list = gst_buffer_list_new_sized(options.list);
+  for (guint i = 0; i < options.list; ++i) {
+    gst_buffer_list_add(list, gst_buffer_ref(buffer));
+  }
+
+  GstFlowReturn ret = GST_FLOW_OK;
+  const gint64 start = g_get_monotonic_time();
+  while (result.buffers < options.buffers && ret == GST_FLOW_OK) {
+    if (lists) {
+      ret = gst_pad_push_list(src, gst_buffer_list_ref(list));
+      result.buffers += options.list;
+    } else {
+      ret = gst_pad_push(src, gst_buffer_ref(buffer));
+      result.buffers++;
+    }
+  }
+  const gint64 stop = g_get_monotonic_time();
+  if (ret != GST_FLOW_OK) {
+    result.error = gst_flow_get_name(ret);
+  }
+  result.ns_per_buffer = result.buffers ? (stop - start) * 1000.0 / result.buffers : 0;
+
+  gst_pad_push_event(src, gst_event_new_eos());
+  gst_buffer_list_unref(list);
+  gst_buffer_unref(buffer);
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  delete stream;  // probes removed from pads before pipeline destroyed
+  gst_pad_unlink(src, identity_sink);
+  gst_object_unref(src);
+  gst_object_unref(sink_pad);
+  gst_object_unref(identity_sink);
+  gst_object_unref(pipeline);
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  if (!parse_options(argc, argv, &options)) {
+    return EXIT_FAILURE;
+  }
+
+  fastocloud::stream::streams_init(argc, argv);
+  printf("{\n  \"buffers\": %" G_GUINT64_FORMAT ", \"size\": %" G_GSIZE_FORMAT ", \"list\": %u,\n  \"results\": [\n",
+         options.buffers, options.size, options.list);
+  for (int l = 0; l < 2; ++l) {
+    const bool lists = l != 0;
+    double base_ns = 0;
+    for (int m = NO_PROBES; m <= STREAM_AND_LATENCY_PROBES; ++m) {
+      const ProbesMode mode = static_cast<ProbesMode>(m);
+      const BenchResult result = run_bench(mode, lists, options);
+      if (mode == NO_PROBES) {
+        base_ns = result.ns_per_buffer;
+      }
+      printf("    {\"push\": \"%s\", \"probes\": \"%s\"", lists ? "list" : "buffer", kModeNames[mode]);
+      if (!result.error.empty()) {
+        printf(", \"error\": \"%s\"", result.error.c_str());
+      }
+      printf(", \"buffers\": %" G_GUINT64_FORMAT ", \"ns_per_buffer\": %.1f, \"overhead_ns\": %.1f}%s\n",
+             result.buffers, result.ns_per_buffer, result.ns_per_buffer - base_ns,
+             lists && mode == STREAM_AND_LATENCY_PROBES ? "" : ",");
+      fflush(stdout);
+    }
+  }
+  printf("  ]\n}\n");
+  fastocloud::stream::streams_deinit();
+  return EXIT_SUCCESS;
+}
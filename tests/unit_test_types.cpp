@@ -14,8 +14,26 @@
 
 #include <gtest/gtest.h>
 
+#if defined(OS_POSIX)
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <memory>
+#include <vector>
+
 #include "stream_commands/commands_info/statistic_info.h"
 #include "base/constants.h"
+#include "base/input_uri.h"
+#include "base/ll_hls_playlist.h"
+#include "base/packet_ring_shm.h"
+#include "base/priority_class.h"
+#include "base/stream_adoption.h"
+#include "base/stream_struct_shm.h"
+#if defined(MACHINE_LEARNING)
+#include "base/machine_learning/inference_shm.h"
+#endif
+#include "stream_commands/binary_protocol.h"
 
 TEST(StreamStructInfo, SerializeDeSerialize) {
   fastocloud::StreamInfo sha;
@@ -53,3 +71,279 @@ TEST(StreamStructInfo, SerializeDeSerialize) {
 
   json_object_put(serialized);
 }
+
+TEST(StreamStructShm, WriteRead) {
+  fastocloud::StreamInfo sha;
+  static const auto test_url = common::uri::Url(TEST_URL);
+  sha.id = "test/1";
+  sha.input = {fastocloud::InputUri(0, test_url), fastocloud::InputUri(1, test_url)};
+  sha.output = {fastocloud::OutputUri(2, test_url)};
+
+  fastocloud::StreamStruct str(sha, 15, 33, 2);
+  str.status = fastocloud::PLAYING;
+  str.input[1].SetTotalBytes(1024);
+  str.output[0].SetBps(512);
+  fastocloud::PeerStats peer = {"10.0.0.1:4200", 12, 3, 1};
+  str.output[0].SetPeers(&peer, 1);
+  str.queue_fill = 80;
+  str.qos_dropped = 7;
+  str.gst_memory = 1 << 20;
+  str.ml_backend = 2;
+  str.progress = 42;
+
+  fastocloud::StreamStructShm shm = {};
+  fastocloud::WriteStreamStructShm(str, &shm);
+  ASSERT_EQ(shm.sequence.load() % 2, 0u);
+
+  fastocloud::StreamStruct str2;
+  ASSERT_TRUE(fastocloud::ReadStreamStructShm(&shm, &str2));
+  ASSERT_EQ(str.id, str2.id);
+  ASSERT_EQ(str.status, str2.status);
+  ASSERT_EQ(str.restarts, str2.restarts);
+  ASSERT_EQ(str.start_time, str2.start_time);
+  ASSERT_EQ(str.input.size(), str2.input.size());
+  ASSERT_EQ(str.output.size(), str2.output.size());
+  ASSERT_EQ(str2.input[1].GetTotalBytes(), 1024u);
+  ASSERT_EQ(str2.input[1].GetID(), 1u);
+  ASSERT_EQ(str2.output[0].GetBps(), 512u);
+  ASSERT_EQ(str2.output[0].GetPeersCount(), 1u);
+  ASSERT_STREQ(str2.output[0].GetPeer(0).address, "10.0.0.1:4200");
+  ASSERT_EQ(str2.output[0].GetPeer(0).retransmits, 3u);
+  ASSERT_EQ(str2.queue_fill, 80);
+  ASSERT_EQ(str2.qos_dropped, 7u);
+  ASSERT_EQ(str2.gst_memory, 1u << 20);
+  ASSERT_EQ(str2.ml_backend, 2);
+  ASSERT_EQ(str2.progress, 42);
+
+  ASSERT_EQ(fastocloud::MakeStreamShmName("test/1"), STREAM_SHM_NAME_PREFIX "test_1");
+}
+
+#if defined(MACHINE_LEARNING)
+TEST(InferenceShm, SlotsRoundTrip) {
+  using namespace fastocloud::machine_learning;
+  std::unique_ptr<InferenceShm> shm(new InferenceShm());
+  const std::vector<uint8_t> frame(INFERENCE_SHM_FRAME_SIZE, 1);
+  ASSERT_TRUE(SubmitInferenceFrame(shm.get(), 1, frame.data(), frame.size()));
+  ASSERT_TRUE(SubmitInferenceFrame(shm.get(), 2, frame.data(), frame.size()));
+  ASSERT_FALSE(SubmitInferenceFrame(shm.get(), 2, frame.data(), frame.size() - 1));
+
+  size_t slots[INFERENCE_SHM_SLOTS];
+  ASSERT_EQ(AcquireInferenceBatch(shm.get(), slots, INFERENCE_SHM_SLOTS), 2u);
+  ASSERT_EQ(shm->slots[slots[0]].client, 1u);
+  ASSERT_EQ(AcquireInferenceBatch(shm.get(), slots + 2, INFERENCE_SHM_SLOTS), 0u);
+
+  const InferenceBoxShm box = {3, 0.5, 1, 2, 3, 4};
+  CompleteInferenceSlot(shm.get(), slots[1], &box, 1);
+  std::vector<InferenceBoxShm> boxes;
+  ASSERT_FALSE(TakeInferenceResult(shm.get(), 1, &boxes));
+  ASSERT_TRUE(TakeInferenceResult(shm.get(), 2, &boxes));
+  ASSERT_EQ(boxes.size(), 1u);
+  ASSERT_EQ(boxes[0].label, 3);
+
+  ResetInferenceSlots(shm.get());  // worker restarted, busy frame of client 1 inferred again
+  ASSERT_EQ(AcquireInferenceBatch(shm.get(), slots, INFERENCE_SHM_SLOTS), 1u);
+  for (size_t i = 1; i < INFERENCE_SHM_SLOTS; ++i) {
+    ASSERT_TRUE(SubmitInferenceFrame(shm.get(), 3, frame.data(), frame.size()));
+  }
+  ASSERT_FALSE(SubmitInferenceFrame(shm.get(), 3, frame.data(), frame.size()));
+  ASSERT_EQ(shm->drops.load(), 1u);
+  ReleaseInferenceSlots(shm.get(), 3);
+  ASSERT_TRUE(SubmitInferenceFrame(shm.get(), 4, frame.data(), frame.size()));
+}
+#endif
+
+TEST(PacketRingShm, ReadAndOverrun) {
+  using namespace fastocloud;
+  std::unique_ptr<PacketRingShm> shm(new PacketRingShm());
+  shm->written = 0;
+  shm->truncated = 0;
+  uint64_t position = GetPacketRingPosition(shm.get());
+  std::vector<uint8_t> out(PACKET_RING_SHM_SLOT_SIZE);
+  size_t size = 0;
+  ASSERT_EQ(ReadPacketRing(shm.get(), &position, out.data(), &size), PACKET_RING_EMPTY);
+
+  const uint8_t datagram[] = {0x47, 1, 2, 3};
+  WritePacketRing(shm.get(), datagram, sizeof(datagram));
+  ASSERT_EQ(ReadPacketRing(shm.get(), &position, out.data(), &size), PACKET_RING_PACKET);
+  ASSERT_EQ(size, sizeof(datagram));
+  ASSERT_EQ(out[0], 0x47);
+  ASSERT_EQ(position, 1u);
+
+  const std::vector<uint8_t> jumbo(PACKET_RING_SHM_SLOT_SIZE + 1, 0x47);
+  WritePacketRing(shm.get(), jumbo.data(), jumbo.size());
+  ASSERT_EQ(shm->truncated.load(), 1u);
+  for (size_t i = 0; i < PACKET_RING_SHM_SLOTS; ++i) {
+    WritePacketRing(shm.get(), datagram, sizeof(datagram));
+  }
+  ASSERT_EQ(ReadPacketRing(shm.get(), &position, out.data(), &size), PACKET_RING_OVERRUN);
+  ASSERT_EQ(position, GetPacketRingPosition(shm.get()) - PACKET_RING_SHM_SLOTS / 2);
+  ASSERT_EQ(ReadPacketRing(shm.get(), &position, out.data(), &size), PACKET_RING_PACKET);
+  ASSERT_EQ(MakePacketRingShmName("239.0.0.1", 1234), PACKET_RING_SHM_NAME_PREFIX "239.0.0.1_1234");
+}
+
+TEST(LatencyHistogram, Buckets) {
+  ASSERT_EQ(fastocloud::LatencyHistogram::GetBucketIndex(-5), 0u);
+  ASSERT_EQ(fastocloud::LatencyHistogram::GetBucketIndex(0), 0u);
+  ASSERT_EQ(fastocloud::LatencyHistogram::GetBucketIndex(1), 1u);
+  ASSERT_EQ(fastocloud::LatencyHistogram::GetBucketIndex(3), 2u);
+  ASSERT_EQ(fastocloud::LatencyHistogram::GetBucketIndex(4), 3u);
+  ASSERT_EQ(fastocloud::LatencyHistogram::GetBucketIndex(1 << 30),
+            static_cast<size_t>(fastocloud::LatencyHistogram::buckets_count - 1));
+
+  fastocloud::LatencyHistogram hist;
+  ASSERT_EQ(hist.GetPercentile(50), 0);
+  for (int i = 0; i < 99; ++i) {
+    hist.Record(3);
+  }
+  hist.Record(100);
+  ASSERT_EQ(hist.GetCount(), 100u);
+  ASSERT_EQ(hist.GetPercentile(50), 4);
+  ASSERT_EQ(hist.GetPercentile(100), 128);
+
+  fastocloud::StreamStruct str;
+  str.id = "test";
+  str.latency[fastocloud::DECODE_LATENCY_STAGE] = hist;
+  fastocloud::StatisticInfo sinf(str, 0, 0, 0);
+  json_object* serialized = NULL;
+  common::Error err = sinf.Serialize(&serialized);
+  ASSERT_FALSE(err);
+  fastocloud::StatisticInfo dsinf;
+  err = dsinf.DeSerialize(serialized);
+  ASSERT_FALSE(err);
+  json_object_put(serialized);
+  fastocloud::StreamStruct dstr = dsinf.GetStreamStruct();
+  ASSERT_EQ(dstr.latency[fastocloud::DECODE_LATENCY_STAGE].GetBuckets(), hist.GetBuckets());
+  ASSERT_EQ(dstr.latency[fastocloud::INPUT_LATENCY_STAGE].GetCount(), 0u);
+}
+
+TEST(BinaryProtocol, EncodeDecode) {
+  fastotv::protocol::request_t req = fastotv::protocol::request_t::MakeNotification("statistic_stream", "{\"id\":1}");
+  std::string payload;
+  common::Error err = fastocloud::EncodeBinaryRequest(req, &payload);
+  ASSERT_FALSE(err);
+
+  fastotv::protocol::request_t* dreq = nullptr;
+  fastotv::protocol::response_t* dresp = nullptr;
+  err = fastocloud::DecodeBinaryCommand(payload, &dreq, &dresp);
+  ASSERT_FALSE(err);
+  ASSERT_TRUE(dreq);
+  ASSERT_FALSE(dresp);
+  ASSERT_EQ(dreq->method, req.method);
+  ASSERT_FALSE(dreq->id);
+  ASSERT_EQ(*dreq->params, *req.params);
+  delete dreq;
+
+  dreq = nullptr;
+  err = fastocloud::DecodeBinaryCommand(payload.substr(0, payload.size() - 1), &dreq, &dresp);
+  ASSERT_TRUE(err);
+  ASSERT_FALSE(dreq);
+}
+
+TEST(LlHlsPlaylist, BlockingReload) {
+  fastocloud::LlHlsPlaylist playlist(500, 3);
+  playlist.AddPart("0.0.ts", 500, true);
+  playlist.AddPart("0.1.ts", 500, false);
+  playlist.SetPreloadHint("0.2.ts");
+  std::string rendered = playlist.Render();
+  ASSERT_NE(rendered.find("#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"0.2.ts\""), std::string::npos);
+  ASSERT_TRUE(fastocloud::IsLlHlsPlaylistReady(rendered, 0, 1));
+  ASSERT_FALSE(fastocloud::IsLlHlsPlaylistReady(rendered, 0, 2));
+  ASSERT_FALSE(fastocloud::IsLlHlsPlaylistReady(rendered, 1, -1));
+
+  for (size_t i = 0; i < 5; ++i) {
+    playlist.CloseSegment(std::to_string(playlist.GetNextMediaSequence()) + ".ts", 1000);
+  }
+  ASSERT_EQ(playlist.GetMediaSequence(), 2u);
+  ASSERT_EQ(playlist.GetNextMediaSequence(), 5u);
+  rendered = playlist.Render();
+  ASSERT_TRUE(fastocloud::IsLlHlsPlaylistReady(rendered, 4, -1));
+  ASSERT_FALSE(fastocloud::IsLlHlsPlaylistReady(rendered, 5, 0));
+}
+
+#if defined(OS_POSIX)
+TEST(StreamAdoption, ParkPipes) {
+  int socks[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, socks), 0);
+  int pipes[2];
+  ASSERT_EQ(pipe(pipes), 0);
+
+  const fastocloud::AdoptMessage park = {fastocloud::ADOPT_PARK, 0};
+  ASSERT_FALSE(fastocloud::SendAdoptMessage(socks[0], park, pipes));
+  close(pipes[0]);
+  close(pipes[1]);
+
+  fastocloud::AdoptMessage received;
+  int fds[2];
+  ASSERT_FALSE(fastocloud::ReceiveAdoptMessage(socks[1], &received, fds));
+  ASSERT_EQ(received.command, fastocloud::ADOPT_PARK);
+  ASSERT_NE(fds[0], INVALID_DESCRIPTOR);
+  ASSERT_NE(fds[1], INVALID_DESCRIPTOR);
+  ASSERT_EQ(write(fds[1], "x", 1), 1);  // passed copies alive after sender closed own
+  char c = 0;
+  ASSERT_EQ(read(fds[0], &c, 1), 1);
+  ASSERT_EQ(c, 'x');
+  close(fds[0]);
+  close(fds[1]);
+
+  const fastocloud::AdoptMessage refused = {fastocloud::ADOPT_CLAIM, ENOENT};
+  ASSERT_FALSE(fastocloud::SendAdoptMessage(socks[1], refused, nullptr));
+  ASSERT_FALSE(fastocloud::ReceiveAdoptMessage(socks[0], &received, fds));
+  ASSERT_EQ(received.error, ENOENT);
+  ASSERT_EQ(fds[0], INVALID_DESCRIPTOR);
+
+  close(socks[1]);
+  ASSERT_TRUE(fastocloud::ReceiveAdoptMessage(socks[0], &received, fds));  // peer gone
+  close(socks[0]);
+}
+#endif
+
+TEST(InputUri, pipewire_display) {
+  const fastocloud::InputUri pipewire(0, common::uri::Url(PIPEWIRE_URL));
+  ASSERT_TRUE(fastocloud::IsPipeWireInputUrl(pipewire));
+  ASSERT_FALSE(fastocloud::IsDisplayInputUrl(pipewire));
+  ASSERT_TRUE(fastocloud::GetPipeWireTarget(pipewire).empty());
+
+  const fastocloud::InputUri node(0, common::uri::Url(PIPEWIRE_URL "://42"));
+  ASSERT_TRUE(fastocloud::IsPipeWireInputUrl(node));
+  ASSERT_EQ(fastocloud::GetPipeWireTarget(node), "42");
+
+  const fastocloud::InputUri display(0, common::uri::Url(DISPLAY_URL));
+  ASSERT_FALSE(fastocloud::IsPipeWireInputUrl(display));
+  ASSERT_TRUE(fastocloud::IsDisplayInputUrl(display));
+}
+
+TEST(InputUri, load_generator) {
+  fastocloud::LoadGenerator generator;
+  const fastocloud::InputUri plain(0, common::uri::Url(LOAD_URL));
+  ASSERT_TRUE(fastocloud::GetLoadGenerator(plain, &generator));
+  ASSERT_EQ(generator.pattern, "ball");
+  ASSERT_EQ(generator.speed, 0);
+  ASSERT_EQ(generator.wave, "sine");
+
+  const fastocloud::InputUri noise(0, common::uri::Url(LOAD_URL "://snow?speed=8&wave=white-noise"));
+  ASSERT_TRUE(fastocloud::GetLoadGenerator(noise, &generator));
+  ASSERT_EQ(generator.pattern, "snow");
+  ASSERT_EQ(generator.speed, 8);
+  ASSERT_EQ(generator.wave, "white-noise");
+
+  const fastocloud::InputUri invalid(0, common::uri::Url(LOAD_URL "://smpte?speed=-1"));
+  ASSERT_FALSE(fastocloud::GetLoadGenerator(invalid, &generator));
+  const fastocloud::InputUri test(0, common::uri::Url(TEST_URL));
+  ASSERT_FALSE(fastocloud::IsLoadInputUrl(test));
+}
+
+TEST(PriorityClass, defaults_by_type) {
+  ASSERT_EQ(fastocloud::GetDefaultPriorityClass(fastotv::RELAY), fastocloud::LIVE_PRIORITY);
+  ASSERT_EQ(fastocloud::GetDefaultPriorityClass(fastotv::COD_ENCODE), fastocloud::LIVE_PRIORITY);
+  ASSERT_EQ(fastocloud::GetDefaultPriorityClass(fastotv::VOD_ENCODE), fastocloud::BATCH_PRIORITY);
+  ASSERT_EQ(fastocloud::GetDefaultPriorityClass(fastotv::VOD_RELAY), fastocloud::BATCH_PRIORITY);
+  ASSERT_TRUE(fastocloud::IsValidPriorityClass(fastocloud::IDLE_PRIORITY));
+  ASSERT_FALSE(fastocloud::IsValidPriorityClass(4));
+
+  const fastocloud::PriorityTraits live = fastocloud::GetPriorityTraits(fastocloud::LIVE_PRIORITY);
+  const fastocloud::PriorityTraits batch = fastocloud::GetPriorityTraits(fastocloud::BATCH_PRIORITY);
+  ASSERT_LT(live.nice, batch.nice);
+  ASSERT_LT(live.io_level, batch.io_level);
+  ASSERT_GT(live.cgroup_weight, batch.cgroup_weight);
+  ASSERT_EQ(fastocloud::GetPriorityTraits(static_cast<fastocloud::PriorityClass>(7)).cgroup_weight, 100);
+}
@@ -12,11 +12,69 @@
     along with fastocloud.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <stdio.h>
+
 #include <gtest/gtest.h>
 
 #include "utils/chunk_info.h"
+#include "utils/m3u8_reader.h"
 
 TEST(ChunkInfo, double) {
   fastocloud::utils::ChunkInfo ch("1497615343667_segment10012.ts", 11.43 * fastocloud::utils::ChunkInfo::SECOND, 10012);
   ASSERT_EQ(ch.GetDurationInSecconds(), 11.43);
 }
+
+TEST(M3u8Reader, Parse) {
+  const std::string path = "/tmp/fastocloud_test_reader.m3u8";
+  FILE* file = fopen(path.c_str(), "wb");
+  ASSERT_TRUE(file);
+  fputs(
+      "#EXTM3U\n#EXT-X-MEDIA-SEQUENCE:7\n#EXT-X-ALLOW-CACHE:YES\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:10\n"
+      "#EXTINF:10.00,\n7.ts\n#EXTINF:9.50,\nsegment8.ts\n",
+      file);
+  fclose(file);
+
+  fastocloud::utils::M3u8Reader reader;
+  ASSERT_FALSE(fastocloud::utils::M3u8Reader::IsEndList(path));
+  ASSERT_TRUE(reader.Parse(path));
+  ASSERT_FALSE(reader.IsEnded());
+  ASSERT_EQ(reader.GetMediaSequence(), 7);
+  ASSERT_EQ(reader.GetTargetDuration(), 10);
+  ASSERT_EQ(reader.GetVersion(), 3);
+  ASSERT_TRUE(reader.IsAllowCache());
+  ASSERT_EQ(reader.GetChunks().size(), 2);
+  ASSERT_EQ(reader.GetChunks()[1].index, 8);
+  ASSERT_EQ(reader.GetChunks()[1].path, "segment8.ts");
+
+  file = fopen(path.c_str(), "ab");
+  ASSERT_TRUE(file);
+  fputs("#EXT-X-ENDLIST", file);
+  fclose(file);
+  ASSERT_TRUE(fastocloud::utils::M3u8Reader::IsEndList(path));
+  ASSERT_TRUE(reader.Parse(path));
+  ASSERT_TRUE(reader.IsEnded());
+  size_t count = 0;
+  for (const auto& chunk : reader) {
+    ASSERT_EQ(chunk.index, 7 + count);
+    count++;
+  }
+  ASSERT_EQ(count, 2);
+}
+
+TEST(M3u8Reader, ParseDiscontinuity) {
+  const std::string path = "/tmp/fastocloud_test_reader_parts.m3u8";
+  FILE* file = fopen(path.c_str(), "wb");
+  ASSERT_TRUE(file);
+  fputs(
+      "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-MEDIA-SEQUENCE:0\n#EXT-X-TARGETDURATION:10\n\n"
+      "#EXTINF:10.00,\npart0_00000.ts\n#EXT-X-DISCONTINUITY\n#EXTINF:9.50,\npart1_00000.ts\n#EXT-X-ENDLIST\n",
+      file);
+  fclose(file);
+
+  fastocloud::utils::M3u8Reader reader;
+  ASSERT_TRUE(reader.Parse(path));
+  ASSERT_TRUE(reader.IsEnded());
+  ASSERT_EQ(reader.GetChunks().size(), 2);
+  ASSERT_EQ(reader.GetChunks()[1].path, "part1_00000.ts");
+  remove(path.c_str());
+}